@@ -30,6 +30,7 @@
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Frontend/MultiplexConsumer.h"
+#include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Lex/PPCallbacks.h"
 #include "clang/Lex/Preprocessor.h"
@@ -44,6 +45,7 @@
 #include "clang/Tooling/Refactoring.h"
 #include "clang/Tooling/ReplacementsYaml.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
 #include <algorithm>
@@ -305,6 +307,89 @@ private:
   std::vector<std::unique_ptr<ClangTidyCheck>> Checks;
 };
 
+/// Shares the precompiled preamble (the leading #includes) of a file with the
+/// next files of the same directory which have the same flags and the same
+/// preamble, so that their headers are only parsed once.
+///
+/// The preprocessor callbacks of the checks don't see the preamble region of
+/// the files, nor the compiler diagnostics in it. Preambles with errors aren't
+/// shared, so that the errors are reported.
+class PreambleCache {
+public:
+  /// Records the flags of the file which is about to be checked, as the
+  /// CompilerInvocation can't be compared.
+  ArgumentsAdjuster flagsRecorder() {
+    return [this](const CommandLineArguments &Args, StringRef Filename) {
+      CurrentFlags.clear();
+      for (const std::string &Arg : Args) {
+        CurrentFlags += Arg == Filename ? "<main file>" : Arg;
+        CurrentFlags += '\0';
+      }
+      return Args;
+    };
+  }
+
+  /// Makes \p Invocation use the preamble of a previous file, or a new one.
+  void usePreamble(CompilerInvocation &Invocation, FileManager &Files,
+                   std::shared_ptr<PCHContainerOperations> PCHContainerOps) {
+    if (Invocation.getFrontendOpts().Inputs.size() != 1)
+      return;
+    IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS(&Files.getVirtualFileSystem());
+    StringRef MainFile = Invocation.getFrontendOpts().Inputs[0].getFile();
+    auto Buffer = FS->getBufferForFile(MainFile);
+    if (!Buffer)
+      return;
+    PreambleBounds Bounds =
+        ComputePreambleBounds(*Invocation.getLangOpts(), Buffer->get(), 0);
+    if (Bounds.Size == 0)
+      return;
+
+    // Quoted includes are looked up in the directory of the file.
+    SmallString<256> Directory(MainFile);
+    if (FS->makeAbsolute(Directory))
+      return;
+    llvm::sys::path::remove_filename(Directory);
+    if (Directory != LastDirectory) {
+      // The files of a directory are usually checked together, so the
+      // preambles of the previous directory are unlikely to be used again.
+      Preambles.clear();
+      LastDirectory = Directory.str();
+    }
+    auto WorkingDirectory = FS->getCurrentWorkingDirectory();
+    std::string Key = CurrentFlags;
+    Key += WorkingDirectory ? *WorkingDirectory : "";
+    Key += '\0';
+    Key += (*Buffer)->getBuffer().take_front(Bounds.Size);
+
+    std::unique_ptr<PrecompiledPreamble> &Preamble = Preambles[Key];
+    if (!Preamble ||
+        !Preamble->CanReuse(Invocation, Buffer->get(), Bounds, FS.get())) {
+      Preamble.reset();
+      IgnoringDiagConsumer IgnoreDiags;
+      IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+          CompilerInstance::createDiagnostics(&Invocation.getDiagnosticOpts(),
+                                              &IgnoreDiags,
+                                              /*ShouldOwnClient=*/false);
+      PreambleCallbacks Callbacks;
+      auto Built = PrecompiledPreamble::Build(
+          Invocation, Buffer->get(), Bounds, *Diags, FS, PCHContainerOps,
+          /*StoreInMemory=*/false, Callbacks);
+      // Parse the file with its preamble, so that the errors are reported.
+      if (!Built || Diags->hasErrorOccurred()) {
+        Preambles.erase(Key);
+        return;
+      }
+      Preamble = std::make_unique<PrecompiledPreamble>(std::move(*Built));
+    }
+    Preamble->AddImplicitPreamble(Invocation, FS, Buffer->get());
+  }
+
+private:
+  std::string CurrentFlags;
+  std::string LastDirectory;
+  llvm::StringMap<std::unique_ptr<PrecompiledPreamble>> Preambles;
+};
+
 } // namespace
 
 ClangTidyASTConsumerFactory::ClangTidyASTConsumerFactory(
@@ -393,6 +478,7 @@ ClangTidyASTConsumerFactory::CreateASTConsumer(
     Profiling = std::make_unique<ClangTidyProfiling>(
         Context.getProfileStorageParams());
     FinderOptions.CheckProfiling.emplace(Profiling->Records);
+    FinderOptions.CheckProfiling->PerMatcher = Context.getProfileMatchers();
   }
 
   std::unique_ptr<ast_matchers::MatchFinder> Finder(
@@ -492,7 +578,8 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
              const CompilationDatabase &Compilations,
              ArrayRef<std::string> InputFiles,
              llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
-             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
+             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile,
+             bool SharePreambles) {
   ClangTool Tool(Compilations, InputFiles,
                  std::make_shared<PCHContainerOperations>(), BaseFS);
 
@@ -516,6 +603,11 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
 
   Tool.appendArgumentsAdjuster(PerFileExtraArgumentsInserter);
   Tool.appendArgumentsAdjuster(getStripPluginsAdjuster());
+  llvm::Optional<PreambleCache> Preambles;
+  if (SharePreambles) {
+    Preambles.emplace();
+    Tool.appendArgumentsAdjuster(Preambles->flagsRecorder());
+  }
   Context.setEnableProfiling(EnableCheckProfile);
   Context.setProfileStoragePrefix(StoreCheckProfile);
 
@@ -528,8 +620,9 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   class ActionFactory : public FrontendActionFactory {
   public:
     ActionFactory(ClangTidyContext &Context,
-                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
-        : ConsumerFactory(Context, BaseFS) {}
+                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+                  PreambleCache *Preambles)
+        : ConsumerFactory(Context, BaseFS), Preambles(Preambles) {}
     FrontendAction *create() override { return new Action(&ConsumerFactory); }
 
     bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
@@ -540,6 +633,8 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
       // define __clang_analyzer__ macro. The frontend analyzer action will not
       // be called here.
       Invocation->getFrontendOpts().ProgramAction = frontend::RunAnalysis;
+      if (Preambles)
+        Preambles->usePreamble(*Invocation, *Files, PCHContainerOps);
       return FrontendActionFactory::runInvocation(
           Invocation, Files, PCHContainerOps, DiagConsumer);
     }
@@ -558,9 +653,10 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
     };
 
     ClangTidyASTConsumerFactory ConsumerFactory;
+    PreambleCache *Preambles;
   };
 
-  ActionFactory Factory(Context, BaseFS);
+  ActionFactory Factory(Context, BaseFS, Preambles.getPointer());
   Tool.run(&Factory);
   return DiagConsumer.take();
 }
@@ -169,6 +169,10 @@ public:
   void setEnableProfiling(bool Profile);
   bool getEnableProfiling() const { return Profile; }
 
+  /// \brief Profile each matcher of the checks separately.
+  void setProfileMatchers(bool P) { ProfileMatchers = P; }
+  bool getProfileMatchers() const { return ProfileMatchers; }
+
   /// \brief Control storage of profile date.
   void setProfileStoragePrefix(StringRef ProfilePrefix);
   llvm::Optional<ClangTidyProfiling::StorageParams>
@@ -221,6 +225,7 @@ private:
   llvm::DenseMap<unsigned, std::string> CheckNamesByDiagnosticID;
 
   bool Profile;
+  bool ProfileMatchers;
   std::string ProfilePrefix;
 
   bool AllowEnablingAnalyzerAlphaCheckers;
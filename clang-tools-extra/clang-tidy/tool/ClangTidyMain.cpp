@@ -182,6 +182,15 @@ report to stderr.
                                         cl::init(false),
                                         cl::cat(ClangTidyCategory));
 
+static cl::opt<bool> ProfileMatchers("profile-matchers", cl::desc(R"(
+With -enable-check-profile, time each AST
+matcher of the checks separately, as
+<check>.<node kind>.<n> for the n-th matcher
+of a check on nodes of that kind.
+)"),
+                                     cl::init(false),
+                                     cl::cat(ClangTidyCategory));
+
 static cl::opt<std::string> StoreCheckProfile("store-check-profile",
                                               cl::desc(R"(
 By default reports are printed in tabulated
@@ -191,6 +200,18 @@ these per-TU profiles are instead stored as JSON.
                                               cl::value_desc("prefix"),
                                               cl::cat(ClangTidyCategory));
 
+static cl::opt<bool> SharePreambles("share-preambles", cl::desc(R"(
+Reuse the precompiled preamble (the leading
+#includes) of a file for the next files of
+its directory with the same compile flags and
+the same preamble, so that their headers are
+parsed once. The checks working on the
+preprocessor don't see the preamble region.
+Experimental.
+)"),
+                                    cl::init(false),
+                                    cl::cat(ClangTidyCategory));
+
 /// This option allows enabling the experimental alpha checkers from the static
 /// analyzer. This option is set to false and not visible in help, because it is
 /// highly not recommended for users.
@@ -426,9 +447,10 @@ static int clangTidyMain(int argc, const char **argv) {
 
   ClangTidyContext Context(std::move(OwningOptionsProvider),
                            AllowEnablingAnalyzerAlphaCheckers);
+  Context.setProfileMatchers(ProfileMatchers);
   std::vector<ClangTidyError> Errors =
       runClangTidy(Context, OptionsParser.getCompilations(), PathList, BaseFS,
-                   EnableCheckProfile, ProfilePrefix);
+                   EnableCheckProfile, ProfilePrefix, SharePreambles);
   bool FoundErrors = llvm::find_if(Errors, [](const ClangTidyError &E) {
                        return E.DiagLevel == ClangTidyError::Error;
                      }) != Errors.end();
@@ -77,9 +77,9 @@ def make_absolute(f, directory):
   return os.path.normpath(os.path.join(directory, f))
 
 
-def get_tidy_invocation(f, clang_tidy_binary, checks, tmpdir, build_path,
+def get_tidy_invocation(files, clang_tidy_binary, checks, tmpdir, build_path,
                         header_filter, extra_arg, extra_arg_before, quiet,
-                        config):
+                        config, share_preambles):
   """Gets a command line for clang-tidy."""
   start = [clang_tidy_binary]
   if header_filter is not None:
@@ -102,7 +102,9 @@ def get_tidy_invocation(f, clang_tidy_binary, checks, tmpdir, build_path,
       start.append('-quiet')
   if config:
       start.append('-config=' + config)
-  start.append(f)
+  if share_preambles:
+      start.append('-share-preambles')
+  start.extend(files)
   return start
 
 
@@ -154,18 +156,19 @@ def apply_fixes(args, tmpdir):
 
 
 def run_tidy(args, tmpdir, build_path, queue, lock, failed_files):
-  """Takes filenames out of queue and runs clang-tidy on them."""
+  """Takes lists of filenames out of queue and runs clang-tidy on them."""
   while True:
-    name = queue.get()
-    invocation = get_tidy_invocation(name, args.clang_tidy_binary, args.checks,
+    names = queue.get()
+    invocation = get_tidy_invocation(names, args.clang_tidy_binary, args.checks,
                                      tmpdir, build_path, args.header_filter,
                                      args.extra_arg, args.extra_arg_before,
-                                     args.quiet, args.config)
+                                     args.quiet, args.config,
+                                     args.share_preambles)
 
     proc = subprocess.Popen(invocation, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
     output, err = proc.communicate()
     if proc.returncode != 0:
-      failed_files.append(name)
+      failed_files.extend(names)
     with lock:
       sys.stdout.write(' '.join(invocation) + '\n' + output.decode('utf-8'))
       if len(err) > 0:
@@ -226,6 +229,10 @@ def main():
                       'command line.')
   parser.add_argument('-quiet', action='store_true',
                       help='Run clang-tidy in quiet mode')
+  parser.add_argument('-share-preambles', action='store_true',
+                      help='Check the files of each directory in a single '
+                      'clang-tidy instance, which reuses the preambles '
+                      'of the files (see clang-tidy -share-preambles)')
   args = parser.parse_args()
 
   db_path = 'compile_commands.json'
@@ -282,10 +289,18 @@ def main():
       t.daemon = True
       t.start()
 
-    # Fill the queue with files.
-    for name in files:
-      if file_name_re.search(name):
-        task_queue.put(name)
+    # Fill the queue with files, grouped by directory if they share their
+    # preambles.
+    files = [name for name in files if file_name_re.search(name)]
+    if args.share_preambles:
+      by_directory = {}
+      for name in files:
+        by_directory.setdefault(os.path.dirname(name), []).append(name)
+      for names in by_directory.values():
+        task_queue.put(names)
+    else:
+      for name in files:
+        task_queue.put([name])
 
     # Wait for all threads to be done.
     task_queue.join()
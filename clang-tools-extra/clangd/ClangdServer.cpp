@@ -146,7 +146,8 @@ ClangdServer::ClangdServer(const GlobalCompilationDatabase &CDB,
         Context::current().clone(), FSProvider, CDB,
         BackgroundIndexStorage::createDiskBackedStorageFactory(
             [&CDB](llvm::StringRef File) { return CDB.getProjectInfo(File); }),
-        std::max(Opts.AsyncThreadsCount, 1u));
+        std::max(Opts.AsyncThreadsCount, 1u),
+        Opts.BackgroundIndexMemoryLimit, Opts.BackgroundIndexThrottle);
     AddIndex(BackgroundIdx.get());
   }
   if (DynamicIdx)
@@ -101,6 +101,12 @@ public:
     /// If true, ClangdServer automatically indexes files in the current project
     /// on background threads. The index is stored in the project root.
     bool BackgroundIndex = false;
+    /// If not 0, background indexing indexes one file at a time while clangd
+    /// allocates more bytes than this.
+    size_t BackgroundIndexMemoryLimit = 0;
+    /// If true, background indexing leaves the cores that the rest of the
+    /// machine is busy with to it, according to the load average.
+    bool BackgroundIndexThrottle = false;
 
     /// If set, use this index to augment code completion results.
     SymbolIndex *StaticIndex = nullptr;
@@ -406,6 +406,10 @@ ParsedAST::build(std::unique_ptr<CompilerInvocation> CI,
   // Copy over the includes from the preamble, then combine with the
   // non-preamble includes below.
   auto Includes = Preamble ? Preamble->Includes : IncludeStructure{};
+  // The includes of a preamble built for another file are recorded as that
+  // file's.
+  if (Preamble)
+    Includes.inheritIncludes(Preamble->MainFileName, MainInput.getFile());
   // Replay the preamble includes so that clang-tidy checks can see them.
   if (Preamble)
     ReplayPreamble::attach(Includes, *Clang);
@@ -631,17 +635,47 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
     vlog("Built preamble of size {0} for file {1}", BuiltPreamble->getSize(),
          FileName);
     std::vector<Diag> Diags = PreambleDiagnostics.take();
-    return std::make_shared<PreambleData>(
+    auto Result = std::make_shared<PreambleData>(
         std::move(*BuiltPreamble), std::move(Diags),
         SerializedDeclsCollector.takeIncludes(),
         SerializedDeclsCollector.takeMainFileMacros(), std::move(StatCache),
         SerializedDeclsCollector.takeCanonicalIncludes());
+    Result->MainFileName = CI.getFrontendOpts().Inputs[0].getFile();
+    return Result;
   } else {
     elog("Could not build a preamble for file {0}", FileName);
     return nullptr;
   }
 }
 
+bool isPreambleCompatible(const PreambleData &Preamble, PathRef FileName,
+                          const ParseInputs &Inputs,
+                          const CompilerInvocation &CI) {
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+  auto Bounds =
+      ComputePreambleBounds(*CI.getLangOpts(), ContentsBuffer.get(), 0);
+  return Preamble.Preamble.CanReuse(CI, ContentsBuffer.get(), Bounds,
+                                    Inputs.FS.get());
+}
+
+bool canPatchPreamble(const PreambleData &Preamble, PathRef FileName,
+                      const ParseInputs &Inputs, const CompilerInvocation &CI) {
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+  auto Bounds =
+      ComputePreambleBounds(*CI.getLangOpts(), ContentsBuffer.get(), 0);
+  PreambleBounds OldBounds = Preamble.Preamble.getBounds();
+  // The old preamble section must end on a line of its own, so that the rest
+  // of the file lexes the same.
+  if (Bounds.Size <= OldBounds.Size || !OldBounds.PreambleEndsAtStartOfLine)
+    return false;
+  // Checks that the file starts with the old preamble section, and that the
+  // included files have not changed.
+  return Preamble.Preamble.CanReuse(CI, ContentsBuffer.get(), OldBounds,
+                                    Inputs.FS.get());
+}
+
 llvm::Optional<ParsedAST>
 buildAST(PathRef FileName, std::unique_ptr<CompilerInvocation> Invocation,
          const ParseInputs &Inputs,
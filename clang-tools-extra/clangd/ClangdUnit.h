@@ -54,6 +54,9 @@ struct PreambleData {
                CanonicalIncludes CanonIncludes);
 
   tooling::CompileCommand CompileCommand;
+  // The main file the preamble was built for, as named by clang. Another file
+  // may reuse the preamble, see isPreambleCompatible().
+  std::string MainFileName;
   PrecompiledPreamble Preamble;
   std::vector<Diag> Diags;
   // Processes like code completions and go-to-definitions will need #include
@@ -169,6 +172,23 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
               const ParseInputs &Inputs, bool StoreInMemory,
               PreambleParsedCallback PreambleCallback);
 
+/// Returns true if \p Preamble, built for another file, can be used as the
+/// preamble of \p FileName with \p Inputs: the preamble section of the file
+/// must be the same, and the files it includes must not have changed. The
+/// caller is responsible for checking that both files have the same compile
+/// flags and resolve the includes the same way.
+bool isPreambleCompatible(const PreambleData &Preamble, PathRef FileName,
+                          const ParseInputs &Inputs,
+                          const CompilerInvocation &CI);
+
+/// Returns true if \p Preamble, built for an older version of \p FileName with
+/// the same compile command, covers the start of the preamble section of
+/// \p Inputs, i.e. directives were only appended to the preamble section, and
+/// the files it includes have not changed. An AST built on top of \p Preamble
+/// then parses the new directives as part of the main file.
+bool canPatchPreamble(const PreambleData &Preamble, PathRef FileName,
+                      const ParseInputs &Inputs, const CompilerInvocation &CI);
+
 /// Build an AST from provided user inputs. This function does not check if
 /// preamble can be reused, as this function expects that \p Preamble is the
 /// result of calling buildPreamble.
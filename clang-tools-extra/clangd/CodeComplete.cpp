@@ -1062,6 +1062,11 @@ bool semaCodeComplete(std::unique_ptr<CodeCompleteConsumer> Consumer,
   FrontendOpts.SkipFunctionBodies = true;
   // Disable typo correction in Sema.
   CI->getLangOpts()->SpellChecking = false;
+  // Delayed template bodies are only lexed, so completion won't trigger in them
+  // and they aren't skipped like the other bodies. It's on by default for
+  // Windows targets (to parse the SDK headers), but we only disable it for the
+  // main file: the preamble is built separately.
+  CI->getLangOpts()->DelayedTemplateParsing = false;
   // Setup code completion.
   FrontendOpts.CodeCompleteOpts = Options;
   FrontendOpts.CodeCompletionAt.FileName = Input.FileName;
@@ -1272,9 +1277,15 @@ public:
       // The per-result proximity scoring is (amortized) very cheap.
       FileDistanceOptions ProxOpts{}; // Use defaults.
       const auto &SM = Recorder->CCSema->getSourceManager();
+      llvm::StringRef MainFileName =
+          SM.getFileEntryForID(SM.getMainFileID())->getName();
+      // The includes of a preamble built for another file are recorded as
+      // that file's.
+      if (SemaCCInput.Preamble)
+        Includes.inheritIncludes(SemaCCInput.Preamble->MainFileName,
+                                 MainFileName);
       llvm::StringMap<SourceParams> ProxSources;
-      for (auto &Entry : Includes.includeDepth(
-               SM.getFileEntryForID(SM.getMainFileID())->getName())) {
+      for (auto &Entry : Includes.includeDepth(MainFileName)) {
         auto &Source = ProxSources[Entry.getKey()];
         Source.Cost = Entry.getValue() * ProxOpts.IncludeCost;
         // Symbols near our transitive includes are good, but only consider
@@ -125,6 +125,17 @@ void IncludeStructure::recordInclude(llvm::StringRef IncludingName,
   IncludeChildren[Parent].push_back(Child);
 }
 
+void IncludeStructure::inheritIncludes(llvm::StringRef From,
+                                       llvm::StringRef To) {
+  auto It = NameToIndex.find(From);
+  if (From == To || It == NameToIndex.end())
+    return;
+  // Copy the includes, as adding To may grow IncludeChildren.
+  SmallVector<unsigned, 8> Children = IncludeChildren.lookup(It->second);
+  auto &ToChildren = IncludeChildren[fileIndex(To)];
+  ToChildren.append(Children.begin(), Children.end());
+}
+
 unsigned IncludeStructure::fileIndex(llvm::StringRef Name) {
   auto R = NameToIndex.try_emplace(Name, RealPathNames.size());
   if (R.second)
@@ -122,6 +122,10 @@ public:
                      llvm::StringRef IncludedName,
                      llvm::StringRef IncludedRealName);
 
+  // Records the files included by \p From as included by \p To too, e.g. when
+  // \p To reuses a preamble built for \p From.
+  void inheritIncludes(llvm::StringRef From, llvm::StringRef To);
+
 private:
   // Identifying files in a way that persists from preamble build to subsequent
   // builds is surprisingly hard. FileID is unavailable in InclusionDirective(),
@@ -53,6 +53,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/Errc.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Threading.h"
 #include <algorithm>
@@ -66,6 +67,31 @@ using std::chrono::steady_clock;
 
 namespace {
 class ASTWorker;
+
+/// Returns the key of the preamble of \p FileName in the PreambleCache. The
+/// files which share a preamble are in the same directory, so that the quoted
+/// includes resolve to the same headers, have the same compile command apart
+/// from their name, and have the same preamble section.
+std::string sharedPreambleKey(PathRef FileName, const ParseInputs &Inputs,
+                              const CompilerInvocation &CI) {
+  const tooling::CompileCommand &Cmd = Inputs.CompileCommand;
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+  auto Bounds =
+      ComputePreambleBounds(*CI.getLangOpts(), ContentsBuffer.get(), 0);
+  std::string Key;
+  llvm::raw_string_ostream OS(Key);
+  OS << Cmd.Directory << '\0' << llvm::sys::path::parent_path(FileName)
+     << '\0';
+  for (const std::string &Arg : Cmd.CommandLine)
+    OS << (Arg == Cmd.Filename || Arg == FileName ? "<main file>" : Arg)
+       << '\0';
+  // The preamble itself checks that the preamble section is the same.
+  OS << static_cast<size_t>(
+            llvm::hash_value(Inputs.Contents.substr(0, Bounds.Size)))
+     << '\0' << Bounds.PreambleEndsAtStartOfLine;
+  return OS.str();
+}
 } // namespace
 
 static clang::clangd::Key<std::string> kFileBeingProcessed;
@@ -143,6 +169,60 @@ private:
   std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
 };
 
+/// Shares the preambles between the files which can use the same one, see
+/// sharedPreambleKey(). The preamble of an open file is available to the other
+/// files as long as it is in use, and the most recently built preambles are
+/// retained for the files opened later.
+class TUScheduler::PreambleCache {
+public:
+  PreambleCache(unsigned MaxRetainedPreambles)
+      : MaxRetainedPreambles(MaxRetainedPreambles) {}
+
+  /// Returns the preamble stored for \p Key, or null if there is none.
+  std::shared_ptr<const PreambleData> get(llvm::StringRef Key) {
+    std::lock_guard<std::mutex> Lock(Mut);
+    auto It = Preambles.find(Key);
+    if (It == Preambles.end())
+      return nullptr;
+    std::shared_ptr<const PreambleData> Preamble = It->second.lock();
+    if (!Preamble)
+      Preambles.erase(It);
+    return Preamble;
+  }
+
+  /// Stores \p Preamble for \p Key, replacing the previous one, and retains
+  /// it, possibly releasing the least recently built preamble.
+  void put(llvm::StringRef Key, std::shared_ptr<const PreambleData> Preamble) {
+    std::unique_lock<std::mutex> Lock(Mut);
+    // Drop the preambles which are not used anymore.
+    for (auto It = Preambles.begin(); It != Preambles.end();) {
+      auto Next = std::next(It);
+      if (It->second.expired())
+        Preambles.erase(It);
+      It = Next;
+    }
+    Preambles[Key] = Preamble;
+    Retained.insert(Retained.begin(), std::move(Preamble));
+    if (Retained.size() <= MaxRetainedPreambles)
+      return;
+    // Run the destructor, which may delete a preamble, outside the lock.
+    std::shared_ptr<const PreambleData> ForCleanup = std::move(Retained.back());
+    Retained.pop_back();
+    Lock.unlock();
+    ForCleanup.reset();
+  }
+
+private:
+  std::mutex Mut;
+  unsigned MaxRetainedPreambles;
+  /// The preambles which may still be in use, by key.
+  llvm::StringMap<std::weak_ptr<const PreambleData>>
+      Preambles; /* GUARDED_BY(Mut) */
+  /// The retained preambles, the most recently built first.
+  std::vector<std::shared_ptr<const PreambleData>>
+      Retained; /* GUARDED_BY(Mut) */
+};
+
 namespace {
 class ASTWorkerHandle;
 
@@ -159,9 +239,10 @@ class ASTWorkerHandle;
 class ASTWorker {
   friend class ASTWorkerHandle;
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
-            TUScheduler::ASTCache &LRUCache, Semaphore &Barrier, bool RunSync,
-            steady_clock::duration UpdateDebounce, bool StorePreamblesInMemory,
-            ParsingCallbacks &Callbacks);
+            TUScheduler::ASTCache &LRUCache,
+            TUScheduler::PreambleCache &Preambles, Semaphore &Barrier,
+            bool RunSync, steady_clock::duration UpdateDebounce,
+            bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
 
 public:
   /// Create a new ASTWorker and return a handle to it.
@@ -171,9 +252,10 @@ public:
   /// request, it is used to limit the number of actively running threads.
   static ASTWorkerHandle
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
-         TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
-         Semaphore &Barrier, steady_clock::duration UpdateDebounce,
-         bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
+         TUScheduler::ASTCache &IdleASTs, TUScheduler::PreambleCache &Preambles,
+         AsyncTaskRunner *Tasks, Semaphore &Barrier,
+         steady_clock::duration UpdateDebounce, bool StorePreamblesInMemory,
+         ParsingCallbacks &Callbacks);
   ~ASTWorker();
 
   void update(ParseInputs Inputs, WantDiagnostics);
@@ -210,6 +292,9 @@ private:
   /// Adds a new task to the end of the request queue.
   void startTask(llvm::StringRef Name, llvm::unique_function<void()> Task,
                  llvm::Optional<WantDiagnostics> UpdateType);
+  /// Runs the onMainAST callback, which may publish the results for \p AST.
+  /// Only called in the worker thread.
+  void runMainASTCallback(ParsedAST &AST);
   /// Updates the TUStatus and emits it. Only called in the worker thread.
   void emitTUStatus(TUAction FAction,
                     const TUStatus::BuildDetails *Detail = nullptr);
@@ -236,6 +321,8 @@ private:
 
   /// Handles retention of ASTs.
   TUScheduler::ASTCache &IdleASTs;
+  /// Shares the preambles with the other files.
+  TUScheduler::PreambleCache &Preambles;
   const bool RunSync;
   /// Time to wait after an update to see whether another update obsoletes it.
   const steady_clock::duration UpdateDebounce;
@@ -248,6 +335,9 @@ private:
   ParsingCallbacks &Callbacks;
   /// Only accessed by the worker thread.
   TUStatus Status;
+  /// The key of the last built preamble in Preambles. Only accessed by the
+  /// worker thread.
+  std::string LastPreambleKey;
 
   Semaphore &Barrier;
   /// Whether the 'onMainAST' callback ran for the current FileInputs.
@@ -321,12 +411,13 @@ private:
 
 ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
-                  TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
+                  TUScheduler::ASTCache &IdleASTs,
+                  TUScheduler::PreambleCache &Preambles, AsyncTaskRunner *Tasks,
                   Semaphore &Barrier, steady_clock::duration UpdateDebounce,
                   bool StorePreamblesInMemory, ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks,
-                    UpdateDebounce, StorePreamblesInMemory, Callbacks));
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, Preambles, Barrier, /*RunSync=*/!Tasks,
+      UpdateDebounce, StorePreamblesInMemory, Callbacks));
   if (Tasks)
     Tasks->runAsync("worker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -335,10 +426,12 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 }
 
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
-                     TUScheduler::ASTCache &LRUCache, Semaphore &Barrier,
+                     TUScheduler::ASTCache &LRUCache,
+                     TUScheduler::PreambleCache &Preambles, Semaphore &Barrier,
                      bool RunSync, steady_clock::duration UpdateDebounce,
                      bool StorePreamblesInMemory, ParsingCallbacks &Callbacks)
-    : IdleASTs(LRUCache), RunSync(RunSync), UpdateDebounce(UpdateDebounce),
+    : IdleASTs(LRUCache), Preambles(Preambles), RunSync(RunSync),
+      UpdateDebounce(UpdateDebounce),
       FileName(FileName), CDB(CDB),
       StorePreambleInMemory(StorePreamblesInMemory),
       Callbacks(Callbacks), Status{TUAction(TUAction::Idle, ""),
@@ -411,13 +504,61 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
 
     std::shared_ptr<const PreambleData> OldPreamble =
         getPossiblyStalePreamble();
-    std::shared_ptr<const PreambleData> NewPreamble = buildPreamble(
-        FileName, *Invocation, OldPreamble, OldCommand, Inputs,
-        StorePreambleInMemory,
-        [this](ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
-               const CanonicalIncludes &CanonIncludes) {
-          Callbacks.onPreambleAST(FileName, Ctx, std::move(PP), CanonIncludes);
-        });
+    // If directives were only appended to the preamble section, e.g. a new
+    // #include, build the AST on top of the old preamble right away, with the
+    // new directives parsed as part of the main file. The diagnostics are
+    // published before the (much slower) rebuild of the preamble below.
+    bool PatchedPreamble = false;
+    if (OldPreamble && WantDiags != WantDiagnostics::No &&
+        OldCommand == Inputs.CompileCommand &&
+        canPatchPreamble(*OldPreamble, FileName, Inputs, *Invocation)) {
+      std::lock_guard<std::mutex> Lock(PublishMu);
+      PatchedPreamble = CanPublishResults;
+    }
+    if (PatchedPreamble) {
+      vlog("Building the AST of {0} on the old preamble", FileName);
+      IdleASTs.take(this); // Remove the old AST if it's still in cache.
+      emitTUStatus({TUAction::BuildingFile, TaskName});
+      llvm::Optional<ParsedAST> NewAST =
+          buildAST(FileName, std::make_unique<CompilerInvocation>(*Invocation),
+                   Inputs, OldPreamble);
+      // The AST is kept, it stays valid with the old preamble.
+      if (NewAST) {
+        runMainASTCallback(*NewAST);
+        IdleASTs.put(this, std::make_unique<ParsedAST>(std::move(*NewAST)));
+      } else {
+        IdleASTs.put(this, nullptr);
+      }
+      emitTUStatus({TUAction::BuildingPreamble, TaskName});
+    }
+    std::shared_ptr<const PreambleData> NewPreamble;
+    std::string PreambleKey =
+        sharedPreambleKey(FileName, Inputs, *Invocation);
+    // Unless our own preamble may still be good, try the one of another file.
+    // Its symbols were indexed when it was built, so onPreambleAST() is not
+    // run again.
+    if (!OldPreamble || PreambleKey != LastPreambleKey) {
+      NewPreamble = Preambles.get(PreambleKey);
+      if (NewPreamble &&
+          isPreambleCompatible(*NewPreamble, FileName, Inputs, *Invocation))
+        vlog("Reusing the preamble of {0} for {1}", NewPreamble->MainFileName,
+             FileName);
+      else
+        NewPreamble = nullptr;
+    }
+    if (!NewPreamble) {
+      NewPreamble = buildPreamble(
+          FileName, *Invocation, OldPreamble, OldCommand, Inputs,
+          StorePreambleInMemory,
+          [this](ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
+                 const CanonicalIncludes &CanonIncludes) {
+            Callbacks.onPreambleAST(FileName, Ctx, std::move(PP),
+                                    CanonIncludes);
+          });
+      if (NewPreamble && NewPreamble != OldPreamble)
+        Preambles.put(PreambleKey, NewPreamble);
+    }
+    LastPreambleKey = std::move(PreambleKey);
 
     bool CanReuseAST = InputsAreTheSame && (OldPreamble == NewPreamble);
     {
@@ -429,6 +570,8 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
     // to it.
     OldPreamble.reset();
     PreambleWasBuilt.notify();
+    if (PatchedPreamble)
+      return;
     emitTUStatus({TUAction::BuildingFile, TaskName});
     if (!CanReuseAST) {
       IdleASTs.take(this); // Remove the old AST if it's still in cache.
@@ -485,25 +628,28 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
     // It seems more useful than making the clients wait indefinitely if they
     // spam us with updates.
     // Note *AST can still be null if buildAST fails.
-    if (*AST) {
-      trace::Span Span("Running main AST callback");
-      auto RunPublish = [&](llvm::function_ref<void()> Publish) {
-        // Ensure we only publish results from the worker if the file was not
-        // removed, making sure there are not race conditions.
-        std::lock_guard<std::mutex> Lock(PublishMu);
-        if (CanPublishResults)
-          Publish();
-      };
-
-      Callbacks.onMainAST(FileName, **AST, RunPublish);
-      RanASTCallback = true;
-    }
+    if (*AST)
+      runMainASTCallback(**AST);
     // Stash the AST in the cache for further use.
     IdleASTs.put(this, std::move(*AST));
   };
   startTask(TaskName, std::move(Task), WantDiags);
 }
 
+void ASTWorker::runMainASTCallback(ParsedAST &AST) {
+  trace::Span Span("Running main AST callback");
+  auto RunPublish = [&](llvm::function_ref<void()> Publish) {
+    // Ensure we only publish results from the worker if the file was not
+    // removed, making sure there are not race conditions.
+    std::lock_guard<std::mutex> Lock(PublishMu);
+    if (CanPublishResults)
+      Publish();
+  };
+
+  Callbacks.onMainAST(FileName, AST, RunPublish);
+  RanASTCallback = true;
+}
+
 void ASTWorker::runWithAST(
     llvm::StringRef Name,
     llvm::unique_function<void(llvm::Expected<InputsAndAST>)> Action) {
@@ -832,6 +978,8 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
                           : std::make_unique<ParsingCallbacks>()),
       Barrier(AsyncThreadsCount),
       IdleASTs(std::make_unique<ASTCache>(RetentionPolicy.MaxRetainedASTs)),
+      Preambles(std::make_unique<PreambleCache>(
+          RetentionPolicy.MaxRetainedPreambles)),
       UpdateDebounce(UpdateDebounce) {
   if (0 < AsyncThreadsCount) {
     PreambleTasks.emplace();
@@ -867,7 +1015,7 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
   if (!FD) {
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker = ASTWorker::create(
-        File, CDB, *IdleASTs,
+        File, CDB, *IdleASTs, *Preambles,
         WorkerThreads ? WorkerThreads.getPointer() : nullptr, Barrier,
         UpdateDebounce, StorePreamblesInMemory, *Callbacks);
     FD = std::unique_ptr<FileData>(
@@ -55,6 +55,11 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum number of preambles to be retained in memory for the files opened
+  /// later, on top of the preambles of the open files. The files of a
+  /// directory with the same compile flags and preamble section share their
+  /// preamble.
+  unsigned MaxRetainedPreambles = 3;
 };
 
 struct TUAction {
@@ -228,6 +233,8 @@ public:
   /// Responsible for retaining and rebuilding idle ASTs. An implementation is
   /// an LRU cache.
   class ASTCache;
+  /// Shares the preambles between the files which can use the same one.
+  class PreambleCache;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -243,6 +250,7 @@ private:
   Semaphore Barrier;
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
+  std::unique_ptr<PreambleCache> Preambles;
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
@@ -8,6 +8,7 @@
 
 #include "../index/Serialization.h"
 #include "../index/dex/Dex.h"
+#include "../index/dex/PostingList.h"
 #include "benchmark/benchmark.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -83,6 +84,27 @@ static void DexQueries(benchmark::State &State) {
 }
 BENCHMARK(DexQueries);
 
+// Intersects the posting lists of the trigrams of a short query, which have
+// millions of documents in large indexes.
+static void DexPostingListIntersection(benchmark::State &State) {
+  constexpr dex::DocID Size = 4000000;
+  std::vector<dex::DocID> Dense, Sparse;
+  for (dex::DocID Doc = 0; Doc < Size; ++Doc) {
+    if (Doc % 3 != 0)
+      Dense.push_back(Doc);
+    if (Doc % 7 == 0)
+      Sparse.push_back(Doc);
+  }
+  const dex::PostingList DenseList(Dense), SparseList(Sparse);
+  const dex::Corpus Corpus(Size);
+  for (auto _ : State) {
+    auto And = Corpus.intersect(DenseList.iterator(), SparseList.iterator());
+    for (; !And->reachedEnd(); And->advance())
+      benchmark::DoNotOptimize(And->peek());
+  }
+}
+BENCHMARK(DexPostingListIntersection);
+
 } // namespace
 } // namespace clangd
 } // namespace clang
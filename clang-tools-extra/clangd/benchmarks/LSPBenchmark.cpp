@@ -0,0 +1,237 @@
+//===--- LSPBenchmark.cpp - Clangd end-to-end benchmarks --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Replays an LSP session recorded with clangd -input-mirror-file against a
+// fresh ClangdLSPServer, and reports the latency of each method (p50 and p99,
+// in milliseconds) and the peak memory of the process.
+//
+// The session is replayed like an editor would send it: each request waits for
+// its reply before the next message is sent. The files of the session must be
+// on disk, along with their compile_commands.json.
+//
+//===----------------------------------------------------------------------===//
+
+#include "../ClangdLSPServer.h"
+#include "../FSProvider.h"
+#include "../Transport.h"
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef LLVM_ON_UNIX
+#include <sys/resource.h>
+#endif
+
+const char *SessionFilename;
+
+namespace clang {
+namespace clangd {
+namespace {
+
+// Splits the recording of a session into its messages. Panics if the file
+// couldn't be parsed.
+std::vector<llvm::json::Value> readSession() {
+  auto Buffer = llvm::MemoryBuffer::getFile(SessionFilename);
+  if (!Buffer) {
+    llvm::errs() << "Error when reading " << SessionFilename << ": "
+                 << Buffer.getError().message() << '\n';
+    exit(1);
+  }
+  llvm::StringRef Log = (*Buffer)->getBuffer();
+  const llvm::StringRef Header = "Content-Length:";
+  std::vector<llvm::json::Value> Messages;
+  for (size_t Pos = Log.find(Header); Pos != llvm::StringRef::npos;
+       Pos = Log.find(Header)) {
+    Log = Log.drop_front(Pos + Header.size()).ltrim();
+    unsigned long long Length;
+    size_t Body;
+    if (llvm::consumeUnsignedInteger(Log, 10, Length) ||
+        (Body = Log.find("\r\n\r\n")) == llvm::StringRef::npos) {
+      llvm::errs() << "Error: malformed header in " << SessionFilename << '\n';
+      exit(1);
+    }
+    Log = Log.drop_front(Body + 4);
+    auto Message = llvm::json::parse(Log.take_front(Length));
+    if (!Message) {
+      llvm::errs() << "Error when parsing message: "
+                   << llvm::toString(Message.takeError()) << '\n';
+      exit(1);
+    }
+    Messages.push_back(std::move(*Message));
+    Log = Log.drop_front(Length);
+  }
+  if (Messages.empty()) {
+    llvm::errs() << "Error: no messages in " << SessionFilename << '\n';
+    exit(1);
+  }
+  return Messages;
+}
+
+// Latencies in milliseconds, by method.
+using LatencyMap = llvm::StringMap<std::vector<double>>;
+
+// Sends the messages of a session to the server, and measures the time it
+// takes to reply to each request. The messages sent by the server are dropped.
+class ReplayTransport : public Transport {
+public:
+  ReplayTransport(const std::vector<llvm::json::Value> &Session,
+                  LatencyMap &Latencies)
+      : Session(Session), Latencies(Latencies) {}
+
+  void notify(llvm::StringRef Method, llvm::json::Value Params) override {}
+  void call(llvm::StringRef Method, llvm::json::Value Params,
+            llvm::json::Value ID) override {}
+
+  void reply(llvm::json::Value ID,
+             llvm::Expected<llvm::json::Value> Result) override {
+    auto Now = std::chrono::steady_clock::now();
+    // Failed requests are measured too.
+    if (!Result)
+      llvm::consumeError(Result.takeError());
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto It = Pending.find(key(ID));
+    if (It == Pending.end())
+      return;
+    Latencies[It->second.Method].push_back(
+        std::chrono::duration<double, std::milli>(Now - It->second.Start)
+            .count());
+    Pending.erase(It);
+    CV.notify_all();
+  }
+
+  llvm::Error loop(MessageHandler &Handler) override {
+    for (const llvm::json::Value &Message : Session) {
+      const llvm::json::Object *O = Message.getAsObject();
+      if (!O)
+        continue;
+      auto Method = O->getString("method");
+      // Replies of the client to the server's calls are dropped, as the
+      // server didn't send the same calls this time.
+      if (!Method)
+        continue;
+      const llvm::json::Value *Params = O->get("params");
+      llvm::json::Value ParamsCopy = Params ? *Params : nullptr;
+      const llvm::json::Value *ID = O->get("id");
+      if (!ID) {
+        if (!Handler.onNotify(*Method, std::move(ParamsCopy)))
+          return llvm::Error::success();
+        continue;
+      }
+      std::string Key = key(*ID);
+      {
+        std::lock_guard<std::mutex> Lock(Mu);
+        Pending[Key] = {Method->str(), std::chrono::steady_clock::now()};
+      }
+      bool Continue = Handler.onCall(*Method, std::move(ParamsCopy), *ID);
+      std::unique_lock<std::mutex> Lock(Mu);
+      CV.wait(Lock, [&] { return !Pending.count(Key); });
+      if (!Continue)
+        return llvm::Error::success();
+    }
+    return llvm::make_error<llvm::StringError>(
+        "the session ended without an exit notification",
+        llvm::inconvertibleErrorCode());
+  }
+
+private:
+  struct Request {
+    std::string Method;
+    std::chrono::steady_clock::time_point Start;
+  };
+
+  static std::string key(const llvm::json::Value &ID) {
+    return llvm::formatv("{0}", ID);
+  }
+
+  const std::vector<llvm::json::Value> &Session;
+  std::mutex Mu;
+  std::condition_variable CV;
+  LatencyMap &Latencies;            // GUARDED_BY(Mu)
+  llvm::StringMap<Request> Pending; // GUARDED_BY(Mu)
+};
+
+// Returns the value below which a fraction P of the sorted Values are.
+double percentile(const std::vector<double> &Values, double P) {
+  size_t Rank = std::ceil(P * Values.size());
+  return Values[std::max<size_t>(Rank, 1) - 1];
+}
+
+// Returns the peak resident memory of the process in MB, where available.
+llvm::Optional<double> peakMemoryMB() {
+#ifdef LLVM_ON_UNIX
+  rusage Usage;
+  if (::getrusage(RUSAGE_SELF, &Usage) == 0)
+#ifdef __APPLE__
+    return Usage.ru_maxrss / double(1 << 20); // In bytes.
+#else
+    return Usage.ru_maxrss / double(1 << 10); // In KB.
+#endif
+#endif
+  return llvm::None;
+}
+
+static void ReplaySession(benchmark::State &State) {
+  const auto Session = readSession();
+  LatencyMap Latencies;
+  for (auto _ : State) {
+    ReplayTransport Transport(Session, Latencies);
+    RealFileSystemProvider FSProvider;
+    // The background index is disabled, so that the runs are comparable.
+    ClangdServer::Options Opts;
+    Opts.BuildDynamicSymbolIndex = true;
+    ClangdLSPServer Server(Transport, FSProvider, CodeCompleteOptions(),
+                           /*CompileCommandsDir=*/llvm::None,
+                           /*UseDirBasedCDB=*/true,
+                           /*ForcedOffsetEncoding=*/llvm::None, Opts);
+    Server.run();
+  }
+  for (auto &Entry : Latencies) {
+    std::vector<double> &Values = Entry.getValue();
+    std::sort(Values.begin(), Values.end());
+    State.counters[(Entry.getKey() + " p50 ms").str()] =
+        percentile(Values, 0.5);
+    State.counters[(Entry.getKey() + " p99 ms").str()] =
+        percentile(Values, 0.99);
+  }
+  if (auto Peak = peakMemoryMB())
+    State.counters["peak memory MB"] = *Peak;
+}
+BENCHMARK(ReplaySession)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace clangd
+} // namespace clang
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    llvm::errs() << "Usage: " << argv[0]
+                 << " session.log BENCHMARK_OPTIONS...\n"
+                    "The session is recorded with clangd "
+                    "-input-mirror-file=session.log\n";
+    return -1;
+  }
+  SessionFilename = argv[1];
+  // Trim the first argument of the benchmark invocation and pretend no
+  // arguments were passed in the first place.
+  argv[1] = argv[0];
+  ++argv;
+  --argc;
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -38,8 +38,10 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/Threading.h"
 
 #include <algorithm>
@@ -57,6 +59,10 @@
 #include <utility>
 #include <vector>
 
+#ifdef LLVM_ON_UNIX
+#include <stdlib.h>
+#endif
+
 namespace clang {
 namespace clangd {
 namespace {
@@ -138,16 +144,56 @@ bool shardIsStale(const LoadedShard &LS, llvm::vfs::FileSystem *FS) {
   return digest(Buf->get()->getBuffer()) != LS.Digest;
 }
 
+// Returns the number of runnable processes, averaged over the last minute.
+llvm::Optional<double> loadAverage() {
+#ifdef LLVM_ON_UNIX
+  double Load;
+  if (::getloadavg(&Load, 1) == 1)
+    return Load;
+#endif
+  return llvm::None;
+}
+
+// Leaves the cores used by the rest of the machine to it, so that indexing
+// doesn't make the editor and the builds unresponsive. The load average lags
+// behind, which keeps the number of tasks from oscillating.
+// Over the memory limit, files are indexed one at a time. Stopping altogether
+// wouldn't do: the memory that clangd holds may never go back under the
+// limit, and the queue would then never become idle.
+BackgroundQueue::ConcurrencyPolicy adaptiveConcurrency(unsigned ThreadPoolSize,
+                                                       size_t MemoryLimit,
+                                                       bool ThrottleOnLoad) {
+  if (!MemoryLimit && !ThrottleOnLoad)
+    return nullptr;
+  unsigned Cores = llvm::heavyweight_hardware_concurrency();
+  return [=](unsigned NumActiveTasks) -> unsigned {
+    if (MemoryLimit && llvm::sys::Process::GetMallocUsage() > MemoryLimit)
+      return 1;
+    if (!ThrottleOnLoad)
+      return ThreadPoolSize;
+    llvm::Optional<double> Load = loadAverage();
+    if (!Load)
+      return ThreadPoolSize;
+    // The load includes our own tasks.
+    double OtherLoad = std::max(0.0, *Load - NumActiveTasks);
+    double IdleCores = std::max(0.0, Cores - OtherLoad);
+    // Always make some progress.
+    return std::max(1u, std::min(ThreadPoolSize, unsigned(IdleCores)));
+  };
+}
+
 } // namespace
 
 BackgroundIndex::BackgroundIndex(
     Context BackgroundContext, const FileSystemProvider &FSProvider,
     const GlobalCompilationDatabase &CDB,
-    BackgroundIndexStorage::Factory IndexStorageFactory, size_t ThreadPoolSize)
+    BackgroundIndexStorage::Factory IndexStorageFactory, size_t ThreadPoolSize,
+    size_t MemoryLimit, bool ThrottleOnLoad)
     : SwapIndex(std::make_unique<MemIndex>()), FSProvider(FSProvider),
       CDB(CDB), BackgroundContext(std::move(BackgroundContext)),
       Rebuilder(this, &IndexedSymbols, ThreadPoolSize),
       IndexStorageFactory(std::move(IndexStorageFactory)),
+      Queue(adaptiveConcurrency(ThreadPoolSize, MemoryLimit, ThrottleOnLoad)),
       CommandsChanged(
           CDB.watch([&](const std::vector<std::string> &ChangedFiles) {
             enqueue(ChangedFiles);
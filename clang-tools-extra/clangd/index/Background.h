@@ -78,6 +78,16 @@ public:
     bool operator<(const Task &O) const { return QueuePri < O.QueuePri; }
   };
 
+  /// Returns how many tasks may run at once, given the number of running ones.
+  /// Lets the workers back off while the machine is busy: a worker only starts
+  /// a task while fewer tasks are running, and checks again every second
+  /// otherwise. Returning 0 pauses the queue.
+  using ConcurrencyPolicy = std::function<unsigned(unsigned NumActiveTasks)>;
+
+  /// If \p Policy is null, every worker runs tasks.
+  explicit BackgroundQueue(ConcurrencyPolicy Policy = nullptr)
+      : Policy(std::move(Policy)) {}
+
   // Add tasks to the queue.
   void push(Task);
   void append(std::vector<Task>);
@@ -106,6 +116,7 @@ private:
   bool ShouldStop = false;
   std::vector<Task> Queue; // max-heap
   llvm::StringMap<unsigned> Boosts;
+  ConcurrencyPolicy Policy;
 };
 
 // Builds an in-memory index by by running the static indexer action over
@@ -117,11 +128,17 @@ public:
   /// If BuildIndexPeriodMs is greater than 0, the symbol index will only be
   /// rebuilt periodically (one per \p BuildIndexPeriodMs); otherwise, index is
   /// rebuilt for each indexed file.
+  ///
+  /// If \p ThrottleOnLoad is true, fewer than \p ThreadPoolSize files are
+  /// indexed at once while the load average shows that the rest of the machine
+  /// is busy. If \p MemoryLimit is not 0, files are indexed one at a time
+  /// while clangd allocates more bytes than that.
   BackgroundIndex(
       Context BackgroundContext, const FileSystemProvider &,
       const GlobalCompilationDatabase &CDB,
       BackgroundIndexStorage::Factory IndexStorageFactory,
-      size_t ThreadPoolSize = llvm::heavyweight_hardware_concurrency());
+      size_t ThreadPoolSize = llvm::heavyweight_hardware_concurrency(),
+      size_t MemoryLimit = 0, bool ThrottleOnLoad = false);
   ~BackgroundIndex(); // Blocks while the current task finishes.
 
   // Enqueue translation units for indexing.
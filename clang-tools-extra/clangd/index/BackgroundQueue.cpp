@@ -22,11 +22,18 @@ void BackgroundQueue::work(std::function<void()> OnIdle) {
     llvm::Optional<Task> Task;
     {
       std::unique_lock<std::mutex> Lock(Mu);
-      CV.wait(Lock, [&] { return ShouldStop || !Queue.empty(); });
-      if (ShouldStop) {
-        Queue.clear();
-        CV.notify_all();
-        return;
+      while (true) {
+        CV.wait(Lock, [&] { return ShouldStop || !Queue.empty(); });
+        if (ShouldStop) {
+          Queue.clear();
+          CV.notify_all();
+          return;
+        }
+        if (!Policy || NumActiveTasks < Policy(NumActiveTasks))
+          break;
+        // The policy may change its mind without notifying us, e.g. when the
+        // load goes down.
+        CV.wait_for(Lock, std::chrono::seconds(1));
       }
       ++NumActiveTasks;
       std::pop_heap(Queue.begin(), Queue.end());
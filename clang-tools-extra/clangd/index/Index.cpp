@@ -31,18 +31,49 @@ std::shared_ptr<SymbolIndex> SwapIndex::snapshot() const {
   return Index;
 }
 
+// Maps an optional limit, which is null when unset.
+static bool mapLimit(llvm::json::ObjectMapper &O,
+                     llvm::Optional<uint32_t> &Limit) {
+  llvm::Optional<int64_t> Value;
+  if (!O.map("Limit", Value))
+    return false;
+  if (Value && *Value >= 0 && *Value <= std::numeric_limits<uint32_t>::max())
+    Limit = *Value;
+  return true;
+}
+
+static bool fromJSON(const llvm::json::Value &Value,
+                     llvm::DenseSet<SymbolID> &IDs) {
+  std::vector<std::string> Strings;
+  if (!llvm::json::fromJSON(Value, Strings))
+    return false;
+  for (const std::string &Str : Strings) {
+    auto ID = SymbolID::fromStr(Str);
+    if (!ID) {
+      llvm::consumeError(ID.takeError());
+      return false;
+    }
+    IDs.insert(*ID);
+  }
+  return true;
+}
+
+static llvm::json::Value toJSON(const llvm::DenseSet<SymbolID> &IDs) {
+  llvm::json::Array Result;
+  for (const SymbolID &ID : IDs)
+    Result.push_back(ID.str());
+  return std::move(Result);
+}
+
 bool fromJSON(const llvm::json::Value &Parameters, FuzzyFindRequest &Request) {
   llvm::json::ObjectMapper O(Parameters);
-  int64_t Limit;
-  bool OK =
-      O && O.map("Query", Request.Query) && O.map("Scopes", Request.Scopes) &&
-      O.map("AnyScope", Request.AnyScope) && O.map("Limit", Limit) &&
-      O.map("RestrictForCodeCompletion", Request.RestrictForCodeCompletion) &&
-      O.map("ProximityPaths", Request.ProximityPaths) &&
-      O.map("PreferredTypes", Request.PreferredTypes);
-  if (OK && Limit <= std::numeric_limits<uint32_t>::max())
-    Request.Limit = Limit;
-  return OK;
+  return O && O.map("Query", Request.Query) &&
+         O.map("Scopes", Request.Scopes) &&
+         O.map("AnyScope", Request.AnyScope) && mapLimit(O, Request.Limit) &&
+         O.map("RestrictForCodeCompletion",
+               Request.RestrictForCodeCompletion) &&
+         O.map("ProximityPaths", Request.ProximityPaths) &&
+         O.map("PreferredTypes", Request.PreferredTypes);
 }
 
 llvm::json::Value toJSON(const FuzzyFindRequest &Request) {
@@ -57,6 +88,51 @@ llvm::json::Value toJSON(const FuzzyFindRequest &Request) {
   };
 }
 
+bool fromJSON(const llvm::json::Value &Parameters, LookupRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  return O && O.map("IDs", Request.IDs);
+}
+
+llvm::json::Value toJSON(const LookupRequest &Request) {
+  return llvm::json::Object{{"IDs", toJSON(Request.IDs)}};
+}
+
+bool fromJSON(const llvm::json::Value &Parameters, RefsRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  int64_t Filter;
+  if (!O || !O.map("IDs", Request.IDs) || !O.map("Filter", Filter) ||
+      !mapLimit(O, Request.Limit))
+    return false;
+  Request.Filter = static_cast<RefKind>(Filter) & RefKind::All;
+  return true;
+}
+
+llvm::json::Value toJSON(const RefsRequest &Request) {
+  return llvm::json::Object{
+      {"IDs", toJSON(Request.IDs)},
+      {"Filter", static_cast<int64_t>(Request.Filter)},
+      {"Limit", Request.Limit},
+  };
+}
+
+bool fromJSON(const llvm::json::Value &Parameters, RelationsRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  int64_t Predicate;
+  if (!O || !O.map("Subjects", Request.Subjects) ||
+      !O.map("Predicate", Predicate) || !mapLimit(O, Request.Limit))
+    return false;
+  Request.Predicate = static_cast<index::SymbolRole>(Predicate);
+  return true;
+}
+
+llvm::json::Value toJSON(const RelationsRequest &Request) {
+  return llvm::json::Object{
+      {"Subjects", toJSON(Request.Subjects)},
+      {"Predicate", static_cast<int64_t>(Request.Predicate)},
+      {"Limit", Request.Limit},
+  };
+}
+
 bool SwapIndex::fuzzyFind(const FuzzyFindRequest &R,
                           llvm::function_ref<void(const Symbol &)> CB) const {
   return snapshot()->fuzzyFind(R, CB);
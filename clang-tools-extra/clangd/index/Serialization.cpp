@@ -15,11 +15,15 @@
 #include "Trace.h"
 #include "dex/Dex.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
+#include <limits>
 #include <vector>
 
 namespace clang {
@@ -386,6 +390,46 @@ readRefs(Reader &Data, llvm::ArrayRef<llvm::StringRef> Strings) {
   return Result;
 }
 
+// REFS INDEX ENCODING
+// A refs index section locates the refs of each symbol in the refs section,
+// so that they can be read without decoding the whole section. It is an array
+// of fixed-size records sorted by SymbolID, each with:
+//  - SymbolID: 8 bytes
+//  - offset of the refs of the symbol in the refs section: 4 bytes
+
+constexpr static size_t RefsIndexRecordSize = SymbolID::RawSize + 4;
+
+void writeRefsIndex(std::vector<std::pair<SymbolID, uint32_t>> Offsets,
+                    llvm::raw_ostream &OS) {
+  llvm::sort(Offsets, [](const std::pair<SymbolID, uint32_t> &L,
+                         const std::pair<SymbolID, uint32_t> &R) {
+    return L.first.raw() < R.first.raw();
+  });
+  for (const auto &IDAndOffset : Offsets) {
+    OS << IDAndOffset.first.raw();
+    write32(IDAndOffset.second, OS);
+  }
+}
+
+// Returns the offset of the refs of \p ID in the refs section, if any.
+llvm::Optional<uint32_t> lookupRefsIndex(llvm::StringRef RefsIndex,
+                                         const SymbolID &ID) {
+  size_t Lo = 0, Hi = RefsIndex.size() / RefsIndexRecordSize;
+  llvm::StringRef Key = ID.raw();
+  while (Lo < Hi) {
+    size_t Mid = Lo + (Hi - Lo) / 2;
+    const char *Record = RefsIndex.data() + Mid * RefsIndexRecordSize;
+    int Cmp = llvm::StringRef(Record, SymbolID::RawSize).compare(Key);
+    if (Cmp == 0)
+      return llvm::support::endian::read32le(Record + SymbolID::RawSize);
+    if (Cmp < 0)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  return llvm::None;
+}
+
 // RELATIONS ENCODING
 // A relations section is a flat list of relations. Each relation has:
 //  - SymbolID (subject): 8 bytes
@@ -440,13 +484,35 @@ readCompileCommand(Reader CmdReader, llvm::ArrayRef<llvm::StringRef> Strings) {
 //   - stri: string table
 //   - symb: symbols
 //   - refs: references to symbols
+//   - rfix: index of the refs section, optional
 
 // The current versioning scheme is simple - non-current versions are rejected.
 // If you make a breaking change, bump this version number to invalidate stored
 // data. Later we may want to support some backward compatibility.
 constexpr static uint32_t Version = 12;
 
-llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
+// The refs of an index file, which are read from the file on demand rather
+// than decoded into a RefSlab.
+struct MappedRefs {
+  // The string table the refs point into.
+  StringTableIn Strings;
+  // The refs section, in the file.
+  llvm::StringRef Refs;
+  // The refs index section, in the file, or built when reading the file in
+  // RefsIndexStorage if the file has none.
+  llvm::StringRef RefsIndexInFile;
+  std::string RefsIndexStorage;
+
+  llvm::StringRef refsIndex() const {
+    return RefsIndexInFile.empty() ? llvm::StringRef(RefsIndexStorage)
+                                   : RefsIndexInFile;
+  }
+};
+
+// Reads an index file. If \p Mapped is not null, the refs are not decoded:
+// \p Mapped receives the data needed to read them from \p Data instead.
+llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data,
+                                     MappedRefs *Mapped = nullptr) {
   auto RIFF = riff::readFile(Data);
   if (!RIFF)
     return RIFF.takeError();
@@ -496,7 +562,28 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
       return makeError("malformed or truncated symbol");
     Result.Symbols = std::move(Symbols).build();
   }
-  if (Chunks.count("refs")) {
+  if (Mapped) {
+    Mapped->Refs = Chunks.lookup("refs");
+    if (Chunks.count("rfix")) {
+      Mapped->RefsIndexInFile = Chunks.lookup("rfix");
+      if (Mapped->RefsIndexInFile.size() % RefsIndexRecordSize != 0)
+        return makeError("malformed refs index");
+    } else {
+      // Older files have no refs index: build it by skipping over the refs.
+      std::vector<std::pair<SymbolID, uint32_t>> Offsets;
+      Reader RefsReader(Mapped->Refs);
+      while (!RefsReader.eof()) {
+        uint32_t Offset = Mapped->Refs.size() - RefsReader.rest().size();
+        Offsets.emplace_back(readRefs(RefsReader, Strings->Strings).first,
+                             Offset);
+      }
+      if (RefsReader.err())
+        return makeError("malformed or truncated refs");
+      llvm::raw_string_ostream RefsIndexOS(Mapped->RefsIndexStorage);
+      writeRefsIndex(std::move(Offsets), RefsIndexOS);
+      RefsIndexOS.flush();
+    }
+  } else if (Chunks.count("refs")) {
     Reader RefsReader(Chunks.lookup("refs"));
     RefSlab::Builder Refs;
     while (!RefsReader.eof()) {
@@ -531,6 +618,8 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
     for (llvm::StringRef C : Cmd.CommandLine)
       Result.Cmd->CommandLine.emplace_back(C);
   }
+  if (Mapped)
+    Mapped->Strings = std::move(*Strings);
   return std::move(Result);
 }
 
@@ -615,13 +704,22 @@ void writeRIFF(const IndexFileOut &Data, llvm::raw_ostream &OS) {
   RIFF.Chunks.push_back({riff::fourCC("symb"), SymbolSection});
 
   std::string RefsSection;
+  std::string RefsIndexSection;
   if (Data.Refs) {
+    std::vector<std::pair<SymbolID, uint32_t>> Offsets;
     {
       llvm::raw_string_ostream RefsOS(RefsSection);
-      for (const auto &Sym : Refs)
+      for (const auto &Sym : Refs) {
+        Offsets.emplace_back(Sym.first, RefsOS.tell());
         writeRefs(Sym.first, Sym.second, Strings, RefsOS);
+      }
     }
     RIFF.Chunks.push_back({riff::fourCC("refs"), RefsSection});
+    {
+      llvm::raw_string_ostream RefsIndexOS(RefsIndexSection);
+      writeRefsIndex(std::move(Offsets), RefsIndexOS);
+    }
+    RIFF.Chunks.push_back({riff::fourCC("rfix"), RefsIndexSection});
   }
 
   std::string RelationSection;
@@ -656,6 +754,70 @@ void writeRIFF(const IndexFileOut &Data, llvm::raw_ostream &OS) {
   OS << RIFF;
 }
 
+// An index that reads the refs from a mapping of the index file on each
+// request, rather than keeping them in memory. The other queries are served
+// by an in-memory index of the symbols and relations.
+class MappedRefsIndex : public SymbolIndex {
+public:
+  MappedRefsIndex(std::unique_ptr<SymbolIndex> Base,
+                  std::unique_ptr<llvm::MemoryBuffer> File, MappedRefs Refs)
+      : Base(std::move(Base)), File(std::move(File)), Refs(std::move(Refs)) {}
+
+  bool
+  fuzzyFind(const FuzzyFindRequest &Req,
+            llvm::function_ref<void(const Symbol &)> Callback) const override {
+    return Base->fuzzyFind(Req, Callback);
+  }
+
+  void lookup(const LookupRequest &Req,
+              llvm::function_ref<void(const Symbol &)> Callback) const override {
+    Base->lookup(Req, Callback);
+  }
+
+  void refs(const RefsRequest &Req,
+            llvm::function_ref<void(const Ref &)> Callback) const override {
+    trace::Span Tracer("MappedRefsIndex refs");
+    uint32_t Remaining =
+        Req.Limit.getValueOr(std::numeric_limits<uint32_t>::max());
+    for (const auto &ID : Req.IDs) {
+      llvm::Optional<uint32_t> Offset = lookupRefsIndex(Refs.refsIndex(), ID);
+      if (!Offset || *Offset >= Refs.Refs.size())
+        continue;
+      Reader RefsReader(Refs.Refs.drop_front(*Offset));
+      auto RefsBundle = readRefs(RefsReader, Refs.Strings.Strings);
+      if (RefsReader.err() || !(RefsBundle.first == ID)) {
+        elog("Malformed refs for {0} in the index file", ID);
+        continue;
+      }
+      for (const auto &Ref : RefsBundle.second) {
+        if (Remaining > 0 && static_cast<int>(Req.Filter & Ref.Kind)) {
+          --Remaining;
+          Callback(Ref);
+        }
+      }
+    }
+  }
+
+  void relations(const RelationsRequest &Req,
+                 llvm::function_ref<void(const SymbolID &, const Symbol &)>
+                     Callback) const override {
+    Base->relations(Req, Callback);
+  }
+
+  // The mapped refs are not counted: they are paged in from the file on
+  // demand, and shared with the other processes that map it.
+  size_t estimateMemoryUsage() const override {
+    return Base->estimateMemoryUsage() + Refs.Strings.Arena.getTotalMemory() +
+           Refs.Strings.Strings.capacity() * sizeof(llvm::StringRef) +
+           Refs.RefsIndexStorage.capacity();
+  }
+
+private:
+  std::unique_ptr<SymbolIndex> Base;
+  std::unique_ptr<llvm::MemoryBuffer> File;
+  MappedRefs Refs;
+};
+
 } // namespace
 
 // Defined in YAMLSerialization.cpp.
@@ -686,20 +848,26 @@ llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef Data) {
 }
 
 std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
-                                       bool UseDex) {
+                                       bool UseDex, bool MapRefs) {
   trace::Span OverallTracer("LoadIndex");
   auto Buffer = llvm::MemoryBuffer::getFile(SymbolFilename);
   if (!Buffer) {
     elog("Can't open {0}", SymbolFilename);
     return nullptr;
   }
+  // The refs can only be read in place from the binary format.
+  llvm::Optional<MappedRefs> Mapped;
+  if (MapRefs && Buffer->get()->getBuffer().startswith("RIFF"))
+    Mapped.emplace();
 
   SymbolSlab Symbols;
   RefSlab Refs;
   RelationSlab Relations;
   {
     trace::Span Tracer("ParseIndex");
-    if (auto I = readIndexFile(Buffer->get()->getBuffer())) {
+    auto I = Mapped ? readRIFF(Buffer->get()->getBuffer(), Mapped.getPointer())
+                    : readIndexFile(Buffer->get()->getBuffer());
+    if (I) {
       if (I->Symbols)
         Symbols = std::move(*I->Symbols);
       if (I->Refs)
@@ -721,6 +889,12 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
                                         std::move(Relations))
                       : MemIndex::build(std::move(Symbols), std::move(Refs),
                                         std::move(Relations));
+  if (Mapped) {
+    vlog("Mapped the refs of {0} symbols from {1}",
+         Mapped->refsIndex().size() / RefsIndexRecordSize, SymbolFilename);
+    Index = std::make_unique<MappedRefsIndex>(
+        std::move(Index), std::move(*Buffer), std::move(*Mapped));
+  }
   vlog("Loaded {0} from {1} with estimated memory usage {2} bytes\n"
        "  - number of symbols: {3}\n"
        "  - number of refs: {4}\n"
@@ -80,8 +80,13 @@ std::string toYAML(const Relation &);
 
 // Build an in-memory static index from an index file.
 // The size should be relatively small, so data can be managed in memory.
+// If MapRefs is set and the file is in the RIFF format, the refs are not
+// loaded: they are read from a mapping of the file for each request, which
+// is shared with the other processes using the file. The file must then not be
+// modified in place while the index is in use.
 std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef Filename,
-                                       bool UseDex = true);
+                                       bool UseDex = true,
+                                       bool MapRefs = false);
 
 // Used for serializing SymbolRole as used in Relation.
 enum class RelationKind : uint8_t { BaseOf };
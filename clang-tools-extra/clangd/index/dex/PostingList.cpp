@@ -26,7 +26,7 @@ public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
     if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -76,11 +76,14 @@ private:
       return OS << *Tok;
     OS << '[';
     const char *Sep = "";
-    for (const Chunk &C : Chunks)
-      for (const DocID Doc : C.decompress()) {
+    llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Docs;
+    for (const Chunk &C : Chunks) {
+      C.decompress(Docs);
+      for (const DocID Doc : Docs) {
         OS << Sep << Doc;
         Sep = " ";
       }
+    }
     return OS << ']';
   }
 
@@ -94,29 +97,39 @@ private:
     ++CurrentChunk;
     if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
       return;
-    DecompressedChunk = CurrentChunk->decompress();
+    CurrentChunk->decompress(DecompressedChunk);
     CurrentID = DecompressedChunk.begin();
   }
 
   /// Advances CurrentChunk to the chunk which might contain ID.
+  ///
+  /// Intersections mostly advance by a few chunks at a time, so the chunk is
+  /// found with an exponential search from the current one, and the chunks in
+  /// between aren't decompressed.
   void advanceToChunk(DocID ID) {
-    if ((CurrentChunk != Chunks.end() - 1) &&
-        ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
+    if ((CurrentChunk == Chunks.end() - 1) || ((CurrentChunk + 1)->Head > ID))
+      return;
+    // Invariant: Low->Head <= ID.
+    auto Low = CurrentChunk + 1;
+    size_t Step = 1;
+    while (Step < size_t(Chunks.end() - Low) && (Low + Step)->Head <= ID) {
+      Low += Step;
+      Step *= 2;
     }
+    auto High = Step < size_t(Chunks.end() - Low) ? Low + Step : Chunks.end();
+    CurrentChunk =
+        std::partition_point(Low + 1, High,
+                             [&](const Chunk &C) { return C.Head <= ID; }) -
+        1;
+    CurrentChunk->decompress(DecompressedChunk);
+    CurrentID = DecompressedChunk.begin();
   }
 
   const Token *Tok;
   llvm::ArrayRef<Chunk> Chunks;
   /// Iterator over chunks.
-  /// If CurrentChunk is valid, then DecompressedChunk is
-  /// CurrentChunk->decompress() and CurrentID is a valid (non-end) iterator
-  /// into it.
+  /// If CurrentChunk is valid, then DecompressedChunk holds its DocIDs and
+  /// CurrentID is a valid (non-end) iterator into it.
   decltype(Chunks)::const_iterator CurrentChunk;
   llvm::SmallVector<DocID, Chunk::PayloadSize + 1> DecompressedChunk;
   /// Iterator over DecompressedChunk.
@@ -182,38 +195,26 @@ std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
   return std::vector<Chunk>(Result); // no move, shrink-to-fit
 }
 
-/// Reads variable length DocID from the buffer and updates the buffer size. If
-/// the stream is terminated, return None.
-llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
-  if (Bytes.front() == 0 || Bytes.empty())
-    return None;
-  DocID Result = 0;
-  bool HasNextByte = true;
-  for (size_t Length = 0; HasNextByte && !Bytes.empty(); ++Length) {
-    assert(Length <= 5 && "Malformed VByte encoding sequence.");
-    // Write meaningful bits to the correct place in the document decoding.
-    Result |= (Bytes.front() & 0x7f) << (BitsPerEncodingByte * Length);
-    if ((Bytes.front() & 0x80) == 0)
-      HasNextByte = false;
-    Bytes = Bytes.drop_front();
-  }
-  return Result;
-}
-
 } // namespace
 
-llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
-  llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
-    auto MaybeDelta = readVByte(Bytes);
-    if (!MaybeDelta)
-      break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
+void Chunk::decompress(llvm::SmallVectorImpl<DocID> &Out) const {
+  Out.clear();
+  Out.push_back(Head);
+  DocID Current = Head;
+  // The payload is terminated by a zero byte, or by its end. No encoding
+  // starts with a zero byte, as the deltas are not 0.
+  for (size_t I = 0; I < PayloadSize && Payload[I] != 0;) {
+    uint8_t Byte = Payload[I++];
+    DocID Delta = Byte & 0x7f;
+    // Most deltas of the large posting lists fit in the first byte.
+    for (unsigned Shift = BitsPerEncodingByte; (Byte & 0x80) && I < PayloadSize;
+         Shift += BitsPerEncodingByte) {
+      Byte = Payload[I++];
+      Delta |= DocID(Byte & 0x7f) << Shift;
+    }
+    Current += Delta;
+    Out.push_back(Current);
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
@@ -43,7 +43,9 @@ struct Chunk {
   /// Keep sizeof(Chunk) == 32.
   static constexpr size_t PayloadSize = 32 - sizeof(DocID);
 
-  llvm::SmallVector<DocID, PayloadSize + 1> decompress() const;
+  /// Replaces the contents of \p Out with the DocIDs of the chunk, which
+  /// allows the iterators to reuse their buffer.
+  void decompress(llvm::SmallVectorImpl<DocID> &Out) const;
 
   /// The first element of decompressed Chunk.
   DocID Head;
@@ -0,0 +1,205 @@
+//===--- Client.cpp - Client of the remote index -----------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Client.h"
+#include "Connection.h"
+#include "Logger.h"
+#include "index/Serialization.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include <mutex>
+#include <vector>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+class IndexClient : public SymbolIndex {
+public:
+  explicit IndexClient(llvm::StringRef Address) : Address(Address) {}
+
+  bool
+  fuzzyFind(const FuzzyFindRequest &Req,
+            llvm::function_ref<void(const Symbol &)> Callback) const override {
+    return stream("fuzzyFind", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Symbols)
+        for (const Symbol &Sym : *Results.Symbols)
+          Callback(Sym);
+    });
+  }
+
+  void
+  lookup(const LookupRequest &Req,
+         llvm::function_ref<void(const Symbol &)> Callback) const override {
+    stream("lookup", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Symbols)
+        for (const Symbol &Sym : *Results.Symbols)
+          Callback(Sym);
+    });
+  }
+
+  void refs(const RefsRequest &Req,
+            llvm::function_ref<void(const Ref &)> Callback) const override {
+    stream("refs", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Refs)
+        for (const auto &IDAndRefs : *Results.Refs)
+          for (const Ref &R : IDAndRefs.second)
+            Callback(R);
+    });
+  }
+
+  void relations(const RelationsRequest &Req,
+                 llvm::function_ref<void(const SymbolID &, const Symbol &)>
+                     Callback) const override {
+    stream("relations", toJSON(Req), [&](const IndexFileIn &Results) {
+      // The objects of the relations are sent along with them.
+      if (!Results.Symbols || !Results.Relations)
+        return;
+      for (const Relation &R : *Results.Relations) {
+        auto Object = Results.Symbols->find(R.Object);
+        if (Object != Results.Symbols->end())
+          Callback(R.Subject, *Object);
+      }
+    });
+  }
+
+  // The index lives in the server.
+  size_t estimateMemoryUsage() const override { return 0; }
+
+private:
+  /// Sends a request, and calls \p HandleResults on each batch of results.
+  /// Returns true if there may be more results.
+  bool stream(llvm::StringRef Method, llvm::json::Value Params,
+              llvm::function_ref<void(const IndexFileIn &)> HandleResults)
+      const {
+    std::string Request = llvm::formatv(
+        "{0}", llvm::json::Value(llvm::json::Object{
+                   {"method", Method}, {"params", std::move(Params)}}));
+
+    // The server may have closed an idle connection, which then only fails
+    // once the answer is read. Nothing was received then, so the request is
+    // sent again on a new connection.
+    std::unique_ptr<Connection> Conn = takeIdleConnection();
+    llvm::Optional<Frame> Answer;
+    if (Conn) {
+      auto First = request(*Conn, Request);
+      if (First) {
+        Answer = std::move(*First);
+      } else {
+        vlog("Remote index: reconnecting to {0}: {1}", Address,
+             First.takeError());
+        Conn.reset();
+      }
+    }
+    if (!Conn) {
+      auto NewConn = Connection::connect(Address);
+      if (!NewConn) {
+        elog("Remote index: can't connect to {0}: {1}", Address,
+             NewConn.takeError());
+        return false;
+      }
+      Conn = std::move(*NewConn);
+      auto First = request(*Conn, Request);
+      if (!First) {
+        elog("Remote index: can't send a {0} request to {1}: {2}", Method,
+             Address, First.takeError());
+        return false;
+      }
+      Answer = std::move(*First);
+    }
+
+    // Until the answer is complete, any failure drops the connection.
+    while (true) {
+      switch (Answer->Kind) {
+      case FrameKind::Results: {
+        auto Results = readIndexFile(Answer->Payload);
+        if (!Results) {
+          elog("Remote index: bad results of {0} from {1}: {2}", Method,
+               Address, Results.takeError());
+          return false;
+        }
+        HandleResults(*Results);
+        break;
+      }
+      case FrameKind::Done: {
+        auto Done = llvm::json::parse(Answer->Payload);
+        if (!Done) {
+          llvm::consumeError(Done.takeError());
+          return false;
+        }
+        addIdleConnection(std::move(Conn));
+        const llvm::json::Object *O = Done->getAsObject();
+        return O && O->getBoolean("more").getValueOr(false);
+      }
+      case FrameKind::Error:
+        // The connection is not reused, as the server may close it after an
+        // error, e.g. when it is serving too many clients.
+        elog("Remote index: {0} failed on {1}: {2}", Method, Address,
+             Answer->Payload);
+        return false;
+      default:
+        elog("Remote index: unexpected answer to {0} from {1}", Method,
+             Address);
+        return false;
+      }
+
+      auto Next = Conn->read(MaxResultsSize);
+      if (!Next) {
+        elog("Remote index: can't read the results of {0} from {1}: {2}",
+             Method, Address, Next.takeError());
+        return false;
+      }
+      Answer = std::move(*Next);
+    }
+  }
+
+  /// Sends \p Request on \p Conn, and reads the first frame of the answer.
+  static llvm::Expected<Frame> request(Connection &Conn,
+                                       llvm::StringRef Request) {
+    if (llvm::Error E = Conn.write(FrameKind::Request, Request))
+      return std::move(E);
+    return Conn.read(MaxResultsSize);
+  }
+
+  std::unique_ptr<Connection> takeIdleConnection() const {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (IdleConnections.empty())
+      return nullptr;
+    std::unique_ptr<Connection> Conn = std::move(IdleConnections.back());
+    IdleConnections.pop_back();
+    return Conn;
+  }
+
+  void addIdleConnection(std::unique_ptr<Connection> Conn) const {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (IdleConnections.size() < MaxIdleConnections)
+      IdleConnections.push_back(std::move(Conn));
+  }
+
+  // The connections kept open beyond this are closed once their request is
+  // answered. The server serves a bounded number of connections.
+  static constexpr size_t MaxIdleConnections = 4;
+
+  std::string Address;
+  mutable std::mutex Mutex;
+  // The connections which are not in use by a request, so that concurrent
+  // requests are sent over different connections.
+  mutable std::vector<std::unique_ptr<Connection>>
+      IdleConnections; // GUARDED_BY(Mutex)
+};
+
+} // namespace
+
+std::unique_ptr<SymbolIndex> getRemoteIndex(llvm::StringRef Address) {
+  return std::make_unique<IndexClient>(Address);
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
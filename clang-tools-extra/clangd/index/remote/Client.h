@@ -0,0 +1,32 @@
+//===--- Client.h - Client of the remote index -------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_CLIENT_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_CLIENT_H
+
+#include "index/Index.h"
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+/// Returns an index which forwards the requests to the clangd-index-server at
+/// \p Address, of the form host:port. The callbacks are invoked as the
+/// batches of results arrive, so that the first results are processed while
+/// the server is still looking up the rest.
+///
+/// Concurrent requests are sent over separate connections, which are kept
+/// open for the next requests. The failed requests are logged and yield no
+/// results.
+std::unique_ptr<SymbolIndex> getRemoteIndex(llvm::StringRef Address);
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif
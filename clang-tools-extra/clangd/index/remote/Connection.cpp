@@ -0,0 +1,272 @@
+//===--- Connection.cpp - Connections of the remote index -------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Connection.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Errno.h"
+#include "llvm/Support/FormatVariadic.h"
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+llvm::Error makeError(const llvm::Twine &Msg) {
+  return llvm::make_error<llvm::StringError>(Msg,
+                                             llvm::inconvertibleErrorCode());
+}
+
+// The differences between POSIX sockets and Winsock.
+#ifdef _WIN32
+constexpr SocketHandle InvalidSocket = INVALID_SOCKET;
+// Windows lets another socket bind the same address with SO_REUSEADDR, so the
+// address is claimed exclusively instead. A listening socket that is closed
+// does not block the address there anyway.
+constexpr int ReuseAddressOption = SO_EXCLUSIVEADDRUSE;
+
+int lastSocketError() { return ::WSAGetLastError(); }
+bool isInterrupted(int Err) { return Err == WSAEINTR; }
+bool isAbortedConnection(int Err) { return Err == WSAECONNRESET; }
+void closeSocket(SocketHandle FD) { ::closesocket(FD); }
+
+std::string socketErrorMessage(int Err) {
+  return std::error_code(Err, std::system_category()).message();
+}
+
+// Winsock must be started once per process before any socket is used.
+llvm::Error initSockets() {
+  static int Err = [] {
+    WSADATA Data;
+    return ::WSAStartup(MAKEWORD(2, 2), &Data);
+  }();
+  if (Err)
+    return makeError("can't start Winsock: " + socketErrorMessage(Err));
+  return llvm::Error::success();
+}
+#else
+constexpr SocketHandle InvalidSocket = -1;
+constexpr int ReuseAddressOption = SO_REUSEADDR;
+
+int lastSocketError() { return errno; }
+bool isInterrupted(int Err) { return Err == EINTR; }
+bool isAbortedConnection(int Err) { return Err == ECONNABORTED; }
+void closeSocket(SocketHandle FD) { ::close(FD); }
+std::string socketErrorMessage(int Err) { return llvm::sys::StrError(Err); }
+llvm::Error initSockets() { return llvm::Error::success(); }
+#endif
+
+llvm::Error makeSocketError(const llvm::Twine &Msg) {
+  return makeError(Msg + ": " + socketErrorMessage(lastSocketError()));
+}
+
+// Writes to a connection that the peer has closed fail with EPIPE rather than
+// raise SIGPIPE: per send() where MSG_NOSIGNAL exists (Linux, the BSDs), per
+// socket with SO_NOSIGPIPE otherwise (Darwin). Windows has no SIGPIPE.
+#ifdef MSG_NOSIGNAL
+constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+constexpr int SendFlags = 0;
+#endif
+
+void disableSigPipe(SocketHandle FD) {
+#ifdef SO_NOSIGPIPE
+  int NoSigPipe = 1;
+  ::setsockopt(FD, SOL_SOCKET, SO_NOSIGPIPE, &NoSigPipe, sizeof(NoSigPipe));
+#endif
+}
+
+// Splits host:port at the last colon, so that the host may be an IPv6
+// address.
+llvm::Expected<std::pair<std::string, std::string>>
+splitAddress(llvm::StringRef Address) {
+  size_t Colon = Address.rfind(':');
+  if (Colon == llvm::StringRef::npos || Colon + 1 == Address.size())
+    return makeError("expected host:port, got '" + Address + "'");
+  llvm::StringRef Host = Address.take_front(Colon);
+  if (Host.startswith("[") && Host.endswith("]"))
+    Host = Host.drop_front().drop_back();
+  return std::make_pair(Host.str(), Address.drop_front(Colon + 1).str());
+}
+
+// Resolves Address, and returns the first socket for which Setup succeeds.
+template <typename SetupFn>
+llvm::Expected<SocketHandle> openSocket(llvm::StringRef Address, bool Passive,
+                                        SetupFn Setup) {
+  if (llvm::Error E = initSockets())
+    return std::move(E);
+  auto HostAndPort = splitAddress(Address);
+  if (!HostAndPort)
+    return HostAndPort.takeError();
+  addrinfo Hints = {};
+  Hints.ai_family = AF_UNSPEC;
+  Hints.ai_socktype = SOCK_STREAM;
+  if (Passive)
+    Hints.ai_flags = AI_PASSIVE;
+  addrinfo *Infos;
+  const char *Host =
+      HostAndPort->first.empty() ? nullptr : HostAndPort->first.c_str();
+  if (int Err = ::getaddrinfo(Host, HostAndPort->second.c_str(), &Hints,
+                              &Infos))
+    return makeError(llvm::formatv("can't resolve {0}: {1}", Address,
+                                   ::gai_strerror(Err)));
+  llvm::Error LastError = makeError("no address for " + Address);
+  for (addrinfo *Info = Infos; Info; Info = Info->ai_next) {
+    SocketHandle FD =
+        ::socket(Info->ai_family, Info->ai_socktype, Info->ai_protocol);
+    if (FD == InvalidSocket) {
+      LastError = makeSocketError("can't create a socket");
+      continue;
+    }
+    if (Setup(FD, *Info)) {
+      ::freeaddrinfo(Infos);
+      llvm::consumeError(std::move(LastError));
+      return FD;
+    }
+    LastError = makeSocketError("can't use " + Address);
+    closeSocket(FD);
+  }
+  ::freeaddrinfo(Infos);
+  return std::move(LastError);
+}
+
+// Reads exactly Size bytes to Buffer.
+llvm::Error readFully(SocketHandle FD, char *Buffer, size_t Size) {
+  while (Size > 0) {
+    auto Read = ::recv(FD, Buffer, Size, 0);
+    if (Read < 0) {
+      if (isInterrupted(lastSocketError()))
+        continue;
+      return makeSocketError("can't read from the connection");
+    }
+    if (Read == 0)
+      return makeError("connection closed");
+    Buffer += Read;
+    Size -= Read;
+  }
+  return llvm::Error::success();
+}
+
+} // namespace
+
+Connection::~Connection() { closeSocket(FD); }
+
+llvm::Expected<std::unique_ptr<Connection>>
+Connection::connect(llvm::StringRef Address) {
+  auto FD = openSocket(Address, /*Passive=*/false,
+                       [](SocketHandle FD, const addrinfo &Info) {
+                         return ::connect(FD, Info.ai_addr,
+                                          Info.ai_addrlen) == 0;
+                       });
+  if (!FD)
+    return FD.takeError();
+  disableSigPipe(*FD);
+  return std::unique_ptr<Connection>(new Connection(*FD));
+}
+
+llvm::Error Connection::write(FrameKind Kind, llvm::StringRef Payload) {
+  if (Payload.size() > MaxResultsSize)
+    return makeError("frame too large");
+  char Header[5];
+  Header[0] = static_cast<char>(Kind);
+  llvm::support::endian::write32le(Header + 1, Payload.size());
+  for (llvm::StringRef Data : {llvm::StringRef(Header, sizeof(Header)),
+                               Payload}) {
+    while (!Data.empty()) {
+      auto Written = ::send(FD, Data.data(), Data.size(), SendFlags);
+      if (Written < 0) {
+        if (isInterrupted(lastSocketError()))
+          continue;
+        return makeSocketError("can't write to the connection");
+      }
+      Data = Data.drop_front(Written);
+    }
+  }
+  return llvm::Error::success();
+}
+
+llvm::Expected<Frame> Connection::read(uint32_t MaxSize) {
+  char Header[5];
+  if (llvm::Error E = readFully(FD, Header, sizeof(Header)))
+    return std::move(E);
+  uint32_t Size = llvm::support::endian::read32le(Header + 1);
+  if (Size > MaxSize)
+    return makeError(llvm::formatv("frame of {0} bytes, expected at most {1}",
+                                   Size, MaxSize));
+  Frame Result;
+  Result.Kind = static_cast<FrameKind>(Header[0]);
+  Result.Payload.resize(Size);
+  if (llvm::Error E = readFully(FD, &Result.Payload[0], Size))
+    return std::move(E);
+  return std::move(Result);
+}
+
+Listener::~Listener() { closeSocket(FD); }
+
+llvm::Expected<std::unique_ptr<Listener>>
+Listener::listen(llvm::StringRef Address) {
+  auto FD = openSocket(Address, /*Passive=*/true,
+                       [](SocketHandle FD, const addrinfo &Info) {
+                         int Reuse = 1;
+                         ::setsockopt(FD, SOL_SOCKET, ReuseAddressOption,
+                                      reinterpret_cast<const char *>(&Reuse),
+                                      sizeof(Reuse));
+                         return ::bind(FD, Info.ai_addr, Info.ai_addrlen) ==
+                                    0 &&
+                                ::listen(FD, SOMAXCONN) == 0;
+                       });
+  if (!FD)
+    return FD.takeError();
+  return std::unique_ptr<Listener>(new Listener(*FD));
+}
+
+llvm::Expected<std::unique_ptr<Connection>> Listener::accept() {
+  while (true) {
+    SocketHandle ClientFD = ::accept(FD, nullptr, nullptr);
+    if (ClientFD != InvalidSocket) {
+      disableSigPipe(ClientFD);
+      return std::unique_ptr<Connection>(new Connection(ClientFD));
+    }
+    int Err = lastSocketError();
+    if (!isInterrupted(Err) && !isAbortedConnection(Err))
+      return makeSocketError("can't accept a connection");
+  }
+}
+
+llvm::Expected<unsigned> Listener::getPort() const {
+  sockaddr_storage Addr;
+  socklen_t Size = sizeof(Addr);
+  if (::getsockname(FD, reinterpret_cast<sockaddr *>(&Addr), &Size) != 0)
+    return makeSocketError("can't get the address of the listener");
+  if (Addr.ss_family == AF_INET)
+    return ntohs(reinterpret_cast<const sockaddr_in &>(Addr).sin_port);
+  if (Addr.ss_family == AF_INET6)
+    return ntohs(reinterpret_cast<const sockaddr_in6 &>(Addr).sin6_port);
+  return makeError("the listener is not bound to an IP address");
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
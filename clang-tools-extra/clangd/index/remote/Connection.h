@@ -0,0 +1,119 @@
+//===--- Connection.h - Connections of the remote index ----------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The remote index client and server talk over a TCP connection, with frames:
+//  - kind: 1 byte
+//  - size of the payload: 32 bit little-endian int
+//  - payload
+//
+// The client sends a Request frame, whose payload is a JSON object with the
+// "method" and the "params" of a SymbolIndex query. The server answers with
+// Results frames, each an index file (see Serialization.h) with a batch of
+// results, so that the client processes the first results while the server
+// is still looking up the rest. The answer ends with a Done frame, whose
+// payload is a JSON object which tells whether there may be more results of
+// a fuzzyFind request, or an Error frame with an error message.
+//
+// The connections use POSIX sockets, or Winsock on Windows.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_CONNECTION_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_CONNECTION_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+enum class FrameKind : char {
+  Request = 'Q',
+  Results = 'R',
+  Done = 'D',
+  Error = 'E',
+};
+
+struct Frame {
+  FrameKind Kind;
+  std::string Payload;
+};
+
+/// The largest request a server reads. Requests are JSON objects, the largest
+/// ones list the IDs of the symbols to look up.
+constexpr uint32_t MaxRequestSize = 16 << 20;
+
+/// The largest frame a client reads, and that may be written at all. A frame
+/// of results holds a batch of at most 1000 results.
+constexpr uint32_t MaxResultsSize = 64 << 20;
+
+/// A socket: a file descriptor, or a SOCKET on Windows.
+#ifdef _WIN32
+using SocketHandle = uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+
+/// A connection between the remote index client and server.
+class Connection {
+public:
+  ~Connection();
+  Connection(const Connection &) = delete;
+  Connection &operator=(const Connection &) = delete;
+
+  /// Connects to the server at \p Address, of the form host:port.
+  static llvm::Expected<std::unique_ptr<Connection>>
+  connect(llvm::StringRef Address);
+
+  llvm::Error write(FrameKind Kind, llvm::StringRef Payload);
+
+  /// Reads the next frame. Frames with a payload larger than \p MaxSize are
+  /// rejected, as the peer is not to be trusted with the allocation.
+  llvm::Expected<Frame> read(uint32_t MaxSize);
+
+private:
+  friend class Listener;
+  explicit Connection(SocketHandle FD) : FD(FD) {}
+
+  SocketHandle FD;
+};
+
+/// Accepts the connections of the clients to a server.
+class Listener {
+public:
+  ~Listener();
+  Listener(const Listener &) = delete;
+  Listener &operator=(const Listener &) = delete;
+
+  /// Listens on \p Address, of the form host:port. The host may be empty to
+  /// listen on all the interfaces.
+  static llvm::Expected<std::unique_ptr<Listener>>
+  listen(llvm::StringRef Address);
+
+  /// Waits for the next client.
+  llvm::Expected<std::unique_ptr<Connection>> accept();
+
+  /// Returns the port the listener is bound to, which the system picks when
+  /// the address has port 0.
+  llvm::Expected<unsigned> getPort() const;
+
+private:
+  explicit Listener(SocketHandle FD) : FD(FD) {}
+
+  SocketHandle FD;
+};
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif
@@ -0,0 +1,280 @@
+//===--- Server.cpp - Server of the remote index -----------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// clangd-index-server loads a static index file, and answers the requests of
+// the clangd instances which use it as their remote index (with the
+// -remote-index-address flag). The index is loaded once for all the clients,
+// which only keep their dynamic index in memory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "index/Serialization.h"
+#include "index/remote/Connection.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+#include <atomic>
+#include <limits>
+#include <thread>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+static const std::string Overview = R"(
+This is an **experimental** server which loads a static index file, produced
+e.g. by clangd-indexer, and serves it to the clangd instances started with
+-remote-index-address=<ADDRESS>.
+)";
+
+llvm::cl::opt<std::string> IndexPath(llvm::cl::desc("<INDEX FILE>"),
+                                     llvm::cl::Positional, llvm::cl::Required);
+
+llvm::cl::opt<std::string> ServerAddress(
+    llvm::cl::desc("<ADDRESS>, e.g. localhost:50051 or :50051. With port 0, "
+                   "the server picks a free port and prints it"),
+    llvm::cl::Positional, llvm::cl::Required);
+
+llvm::cl::opt<unsigned> MaxClients(
+    "max-clients",
+    llvm::cl::desc("The number of clients served at the same time, each on "
+                   "its own thread. Other clients are turned away until one "
+                   "of them disconnects"),
+    llvm::cl::init(64));
+
+// The number of results sent in each frame. Smaller batches let the client
+// process the first results sooner, larger ones have less overhead.
+constexpr size_t BatchSize = 1000;
+
+/// Sends the results of a request to the client, in batches.
+class ResultsWriter {
+public:
+  explicit ResultsWriter(Connection &Conn)
+      : Conn(Conn), Batch(std::make_unique<Builders>()) {}
+
+  void addSymbol(const Symbol &Sym) {
+    Batch->Symbols.insert(Sym);
+    added();
+  }
+
+  void addRef(const SymbolID &ID, const Ref &R) {
+    Batch->Refs.insert(ID, R);
+    added();
+  }
+
+  void addRelation(const SymbolID &Subject, index::SymbolRole Predicate,
+                   const Symbol &Object) {
+    Batch->Relations.insert(Relation{Subject, Predicate, Object.ID});
+    Batch->Symbols.insert(Object);
+    added();
+  }
+
+  /// Sends the last batch, and the end of the answer.
+  llvm::Error finish(bool More) {
+    flush();
+    if (Err)
+      return std::move(Err);
+    std::string Done = llvm::formatv(
+        "{0}", llvm::json::Value(llvm::json::Object{{"more", More}}));
+    return Conn.write(FrameKind::Done, Done);
+  }
+
+private:
+  struct Builders {
+    SymbolSlab::Builder Symbols;
+    RefSlab::Builder Refs;
+    RelationSlab::Builder Relations;
+  };
+
+  void added() {
+    if (++Size == BatchSize)
+      flush();
+  }
+
+  void flush() {
+    // After a write error, the remaining results are dropped.
+    if (Size == 0 || Err)
+      return;
+    SymbolSlab Symbols = std::move(Batch->Symbols).build();
+    RefSlab Refs = std::move(Batch->Refs).build();
+    RelationSlab Relations = std::move(Batch->Relations).build();
+    Batch = std::make_unique<Builders>();
+    Size = 0;
+
+    IndexFileOut Out;
+    Out.Symbols = &Symbols;
+    Out.Refs = &Refs;
+    Out.Relations = &Relations;
+    std::string Payload;
+    llvm::raw_string_ostream OS(Payload);
+    OS << Out;
+    OS.flush();
+    Err = Conn.write(FrameKind::Results, Payload);
+  }
+
+  Connection &Conn;
+  std::unique_ptr<Builders> Batch;
+  size_t Size = 0;
+  llvm::Error Err = llvm::Error::success();
+};
+
+template <typename RequestT>
+llvm::Expected<RequestT> parseParams(const llvm::json::Value *Params) {
+  RequestT Req;
+  if (!Params || !fromJSON(*Params, Req))
+    return llvm::make_error<llvm::StringError>("malformed request parameters",
+                                               llvm::inconvertibleErrorCode());
+  return std::move(Req);
+}
+
+/// Answers \p Request. Returns an error if the connection failed.
+llvm::Error answer(const SymbolIndex &Index, Connection &Conn,
+                   llvm::StringRef Request) {
+  auto reject = [&](const llvm::Twine &Message) {
+    return Conn.write(FrameKind::Error, Message.str());
+  };
+  auto JSON = llvm::json::parse(Request);
+  if (!JSON)
+    return reject(llvm::toString(JSON.takeError()));
+  const llvm::json::Object *O = JSON->getAsObject();
+  llvm::Optional<llvm::StringRef> Method;
+  if (O)
+    Method = O->getString("method");
+  if (!Method)
+    return reject("missing method");
+  const llvm::json::Value *Params = O->get("params");
+
+  ResultsWriter Results(Conn);
+  bool More = false;
+  if (*Method == "fuzzyFind") {
+    auto Req = parseParams<FuzzyFindRequest>(Params);
+    if (!Req)
+      return reject(llvm::toString(Req.takeError()));
+    More = Index.fuzzyFind(*Req,
+                           [&](const Symbol &Sym) { Results.addSymbol(Sym); });
+  } else if (*Method == "lookup") {
+    auto Req = parseParams<LookupRequest>(Params);
+    if (!Req)
+      return reject(llvm::toString(Req.takeError()));
+    Index.lookup(*Req, [&](const Symbol &Sym) { Results.addSymbol(Sym); });
+  } else if (*Method == "refs") {
+    auto Req = parseParams<RefsRequest>(Params);
+    if (!Req)
+      return reject(llvm::toString(Req.takeError()));
+    // The refs are looked up one symbol at a time, as they are serialized
+    // with the ID of their symbol.
+    uint32_t Remaining =
+        Req->Limit.getValueOr(std::numeric_limits<uint32_t>::max());
+    for (const SymbolID &ID : Req->IDs) {
+      if (Remaining == 0)
+        break;
+      RefsRequest SymbolReq;
+      SymbolReq.IDs.insert(ID);
+      SymbolReq.Filter = Req->Filter;
+      SymbolReq.Limit = Remaining;
+      Index.refs(SymbolReq, [&](const Ref &R) {
+        if (Remaining == 0)
+          return;
+        --Remaining;
+        Results.addRef(ID, R);
+      });
+    }
+  } else if (*Method == "relations") {
+    auto Req = parseParams<RelationsRequest>(Params);
+    if (!Req)
+      return reject(llvm::toString(Req.takeError()));
+    Index.relations(*Req, [&](const SymbolID &Subject, const Symbol &Object) {
+      Results.addRelation(Subject, Req->Predicate, Object);
+    });
+  } else {
+    return reject("unknown method " + *Method);
+  }
+  return Results.finish(More);
+}
+
+void serve(const SymbolIndex &Index, std::unique_ptr<Connection> Conn) {
+  while (true) {
+    auto Request = Conn->read(MaxRequestSize);
+    if (!Request) {
+      // Most likely the client is gone.
+      llvm::consumeError(Request.takeError());
+      return;
+    }
+    llvm::Error E = Request->Kind == FrameKind::Request
+                        ? answer(Index, *Conn, Request->Payload)
+                        : Conn->write(FrameKind::Error, "expected a request");
+    if (E) {
+      llvm::errs() << "Dropping a client: " << llvm::toString(std::move(E))
+                   << "\n";
+      return;
+    }
+  }
+}
+
+} // namespace
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+int main(int argc, const char *argv[]) {
+  using namespace clang::clangd;
+  using namespace clang::clangd::remote;
+
+  llvm::cl::ParseCommandLineOptions(argc, argv, Overview);
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+
+  // The refs are read from a mapping of the file, which is shared with the
+  // clangd instances that load the same file.
+  std::unique_ptr<SymbolIndex> Index =
+      loadIndex(IndexPath, /*UseDex=*/true, /*MapRefs=*/true);
+  if (!Index) {
+    llvm::errs() << "Failed to open the index " << IndexPath << "\n";
+    return 1;
+  }
+
+  auto Server = Listener::listen(ServerAddress);
+  if (!Server) {
+    llvm::errs() << "Failed to listen on " << ServerAddress << ": "
+                 << llvm::toString(Server.takeError()) << "\n";
+    return 1;
+  }
+  auto Port = (*Server)->getPort();
+  if (!Port) {
+    llvm::errs() << llvm::toString(Port.takeError()) << "\n";
+    return 1;
+  }
+  llvm::errs() << "Serving " << IndexPath << " on port " << *Port << "\n";
+
+  // The index is immutable, so the clients are served concurrently. The
+  // connections are kept open between the requests, so a client takes a
+  // thread until it disconnects.
+  static std::atomic<unsigned> NumClients(0);
+  while (true) {
+    auto Conn = (*Server)->accept();
+    if (!Conn) {
+      llvm::errs() << llvm::toString(Conn.takeError()) << "\n";
+      return 1;
+    }
+    if (NumClients >= MaxClients) {
+      llvm::consumeError(
+          (*Conn)->write(FrameKind::Error, "the server has too many clients"));
+      continue;
+    }
+    ++NumClients;
+    std::thread(
+        [&Index](std::unique_ptr<Connection> Conn) {
+          serve(*Index, std::move(Conn));
+          --NumClients;
+        },
+        std::move(*Conn))
+        .detach();
+  }
+}
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "SourceCode.h"
 #include "index/IndexAction.h"
 #include "index/Merge.h"
 #include "index/Ref.h"
@@ -20,6 +21,8 @@
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Execution.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Signals.h"
 
@@ -35,6 +38,13 @@ static llvm::cl::opt<IndexFileFormat>
                                        "binary RIFF format")),
            llvm::cl::init(IndexFileFormat::RIFF));
 
+static llvm::cl::opt<bool> IndexHeadersOnce(
+    "index-headers-once",
+    llvm::cl::desc("Index each header only in the first translation unit that "
+                   "includes it with the same content, and skip its symbols, "
+                   "references and function bodies in the others"),
+    llvm::cl::init(true));
+
 class IndexActionFactory : public tooling::FrontendActionFactory {
 public:
   IndexActionFactory(IndexFileIn &Result) : Result(Result) {}
@@ -42,6 +52,14 @@ public:
   clang::FrontendAction *create() override {
     SymbolCollector::Options Opts;
     Opts.CountReferences = true;
+    if (IndexHeadersOnce) {
+      // The files claimed by this translation unit, which it indexes each
+      // time they are included.
+      auto Claimed = std::make_shared<llvm::StringSet<>>();
+      Opts.FileFilter = [this, Claimed](const SourceManager &SM, FileID FID) {
+        return shouldIndexFile(SM, FID, *Claimed);
+      };
+    }
     return createStaticIndexingAction(
                Opts,
                [&](SymbolSlab S) {
@@ -81,7 +99,32 @@ public:
   }
 
 private:
+  // A file is indexed by the first translation unit which sees it with the
+  // given content. The others would find the same symbols and references in
+  // it, so they skip it.
+  bool shouldIndexFile(const SourceManager &SM, FileID FID,
+                       llvm::StringSet<> &Claimed) {
+    const auto *F = SM.getFileEntryForID(FID);
+    if (!F)
+      return true;
+    auto Digest = digestFile(SM, FID);
+    if (!Digest)
+      return true;
+    auto Path = getCanonicalPath(F, SM);
+    std::string Key =
+        (Path ? *Path : F->getName().str()) + ":" + llvm::toHex(*Digest);
+    if (Claimed.count(Key))
+      return true;
+    std::lock_guard<std::mutex> Lock(FilesMu);
+    if (!IndexedFiles.insert(Key).second)
+      return false;
+    Claimed.insert(Key);
+    return true;
+  }
+
   IndexFileIn &Result;
+  std::mutex FilesMu;
+  llvm::StringSet<> IndexedFiles;
   std::mutex SymbolsMu;
   SymbolSlab::Builder Symbols;
   RefSlab::Builder Refs;
@@ -0,0 +1,3 @@
+#include "header.h"
+
+int fromA() { return headerFunction(HeaderStruct{1}); }
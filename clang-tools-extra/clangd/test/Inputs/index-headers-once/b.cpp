@@ -0,0 +1,3 @@
+#include "header.h"
+
+int fromB() { return headerFunction(HeaderStruct{2}); }
@@ -0,0 +1,10 @@
+#ifndef HEADER_H
+#define HEADER_H
+
+struct HeaderStruct {
+  int Field;
+};
+
+inline int headerFunction(HeaderStruct S) { return S.Field; }
+
+#endif
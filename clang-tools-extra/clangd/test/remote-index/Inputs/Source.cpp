@@ -0,0 +1,8 @@
+namespace clang {
+namespace clangd {
+namespace remote {
+int getFoo(bool Argument) { return 42; }
+int getBar() { return 0; }
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+#
+#===- pipeline_helper.py - Remote index pipeline helper -------*- python -*--===#
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===------------------------------------------------------------------------===#
+
+# Starts clangd-index-server on a free port, runs clangd with the server as its
+# remote index on the requests in the input file, and prints the answers of
+# clangd.
+
+import argparse
+import re
+import subprocess
+import sys
+import threading
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument('--input-file-name', required=True)
+  parser.add_argument('--index-file', required=True)
+  args = parser.parse_args()
+
+  # The server picks a free port, and prints it once it listens.
+  server = subprocess.Popen(
+      ['clangd-index-server', args.index_file, 'localhost:0'],
+      stderr=subprocess.PIPE)
+  port = None
+  for line in iter(server.stderr.readline, b''):
+    sys.stderr.write(line.decode())
+    match = re.search(r'on port (\d+)', line.decode())
+    if match:
+      port = match.group(1)
+      break
+  if port is None:
+    server.wait()
+    sys.exit('clangd-index-server did not start')
+
+  # Keep the log of the server flowing, so that it never blocks on it.
+  def forward_log():
+    for line in iter(server.stderr.readline, b''):
+      sys.stderr.write(line.decode())
+
+  log_thread = threading.Thread(target=forward_log)
+  log_thread.daemon = True
+  log_thread.start()
+
+  with open(args.input_file_name, 'r') as input_file:
+    clangd = subprocess.Popen(
+        ['clangd', '--remote-index-address=localhost:' + port, '--lit-test',
+         '--sync'],
+        stdin=input_file,
+        stdout=subprocess.PIPE)
+    output, _ = clangd.communicate()
+
+  server.kill()
+  server.wait()
+  sys.stdout.write(output.decode())
+  sys.exit(clangd.returncode)
+
+
+if __name__ == '__main__':
+  main()
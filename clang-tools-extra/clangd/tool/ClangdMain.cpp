@@ -15,6 +15,7 @@
 #include "Transport.h"
 #include "index/Background.h"
 #include "index/Serialization.h"
+#include "index/remote/Client.h"
 #include "clang/Basic/Version.h"
 #include "clang/Format/Format.h"
 #include "llvm/ADT/Optional.h"
@@ -127,6 +128,24 @@ opt<bool> EnableBackgroundIndex{
     init(true),
 };
 
+opt<unsigned> BackgroundIndexMemoryLimit{
+    "background-index-memory-limit",
+    cat(Features),
+    desc("Index one file at a time while clangd uses more memory than this, "
+         "in MB. 0 means no limit"),
+    init(0),
+    Hidden,
+};
+
+opt<bool> BackgroundIndexThrottle{
+    "background-index-throttle",
+    cat(Features),
+    desc("Index fewer files at once while the load average shows that the "
+         "rest of the machine is busy"),
+    init(false),
+    Hidden,
+};
+
 opt<bool> EnableClangTidy{
     "clang-tidy",
     cat(Features),
@@ -284,6 +303,25 @@ opt<Path> IndexFile{
     Hidden,
 };
 
+opt<bool> MapIndexFileRefs{
+    "map-index-file-refs",
+    cat(Misc),
+    desc("Read the references of the static index from a mapping of the index "
+         "file on demand, rather than loading them in memory. The file must "
+         "not be modified in place while clangd runs"),
+    init(false),
+    Hidden,
+};
+
+opt<std::string> RemoteIndexAddress{
+    "remote-index-address",
+    cat(Misc),
+    desc("Address (host:port) of a clangd-index-server to query as the static "
+         "index, instead of loading an index file in each clangd instance"),
+    init(""),
+    Hidden,
+};
+
 opt<bool> Test{
     "lit-test",
     cat(Misc),
@@ -580,14 +618,20 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     Opts.ResourceDir = ResourceDir;
   Opts.BuildDynamicSymbolIndex = EnableIndex;
   Opts.BackgroundIndex = EnableBackgroundIndex;
+  Opts.BackgroundIndexMemoryLimit = size_t(BackgroundIndexMemoryLimit) << 20;
+  Opts.BackgroundIndexThrottle = BackgroundIndexThrottle;
   std::unique_ptr<SymbolIndex> StaticIdx;
   std::future<void> AsyncIndexLoad; // Block exit while loading the index.
-  if (EnableIndex && !IndexFile.empty()) {
+  if (EnableIndex && !RemoteIndexAddress.empty()) {
+    if (!IndexFile.empty())
+      elog("Ignoring -index-file, as -remote-index-address is set");
+    StaticIdx = remote::getRemoteIndex(RemoteIndexAddress);
+  } else if (EnableIndex && !IndexFile.empty()) {
     // Load the index asynchronously. Meanwhile SwapIndex returns no results.
     SwapIndex *Placeholder;
     StaticIdx.reset(Placeholder = new SwapIndex(std::make_unique<MemIndex>()));
     AsyncIndexLoad = runAsync<void>([Placeholder] {
-      if (auto Idx = loadIndex(IndexFile, /*UseDex=*/true))
+      if (auto Idx = loadIndex(IndexFile, /*UseDex=*/true, MapIndexFileRefs))
         Placeholder->reset(std::move(Idx));
     });
     if (Sync)
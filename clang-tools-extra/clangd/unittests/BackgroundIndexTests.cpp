@@ -104,6 +104,32 @@ TEST_F(BackgroundIndexTest, NoCrashOnErrorFile) {
   ASSERT_TRUE(Idx.blockUntilIdleForTest());
 }
 
+TEST_F(BackgroundIndexTest, IndexesOverMemoryLimit) {
+  MockFSProvider FS;
+  FS.Files[testPath("root/A.cc")] = "void a();";
+  FS.Files[testPath("root/B.cc")] = "void b();";
+  llvm::StringMap<std::string> Storage;
+  size_t CacheHits = 0;
+  MemoryShardStorage MSS(Storage, CacheHits);
+  OverlayCDB CDB(/*Base=*/nullptr);
+  // clangd always uses more than one byte, but indexing goes on.
+  BackgroundIndex Idx(Context::empty(), FS, CDB,
+                      [&](llvm::StringRef) { return &MSS; },
+                      /*ThreadPoolSize=*/2, /*MemoryLimit=*/1);
+
+  tooling::CompileCommand Cmd;
+  Cmd.Directory = testPath("root");
+  for (llvm::StringRef File : {"root/A.cc", "root/B.cc"}) {
+    Cmd.Filename = testPath(File);
+    Cmd.CommandLine = {"clang++", Cmd.Filename};
+    CDB.setCompileCommand(Cmd.Filename, Cmd);
+  }
+
+  ASSERT_TRUE(Idx.blockUntilIdleForTest(/*TimeoutSeconds=*/10));
+  EXPECT_THAT(runFuzzyFind(Idx, ""),
+              UnorderedElementsAre(Named("a"), Named("b")));
+}
+
 TEST_F(BackgroundIndexTest, IndexTwoFiles) {
   MockFSProvider FS;
   // a.h yields different symbols when included by A.cc vs B.cc.
@@ -713,5 +739,35 @@ TEST(BackgroundQueueTest, Boost) {
   }
 }
 
+TEST(BackgroundQueueTest, ConcurrencyPolicy) {
+  // The policy only lets one task run at a time, and none while Paused.
+  std::atomic<bool> Paused(true);
+  BackgroundQueue Q([&](unsigned) -> unsigned { return Paused ? 0 : 1; });
+  std::atomic<unsigned> Running(0), MaxRunning(0), Ran(0);
+  BackgroundQueue::Task T([&] {
+    unsigned Now = ++Running;
+    unsigned Max = MaxRunning;
+    while (Now > Max && !MaxRunning.compare_exchange_weak(Max, Now))
+      ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    --Running;
+    ++Ran;
+  });
+  Q.append(std::vector<BackgroundQueue::Task>(20, T));
+
+  AsyncTaskRunner ThreadPool;
+  for (unsigned I = 0; I < 5; ++I)
+    ThreadPool.runAsync("worker", [&] { Q.work(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(Ran, 0u) << "paused";
+
+  Paused = false;
+  ASSERT_TRUE(Q.blockUntilIdleForTest(/*TimeoutSeconds=*/10));
+  EXPECT_EQ(Ran, 20u);
+  EXPECT_EQ(MaxRunning, 1u);
+  Q.stop();
+  ThreadPool.wait();
+}
+
 } // namespace clangd
 } // namespace clang
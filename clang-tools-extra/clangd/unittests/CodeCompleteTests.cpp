@@ -1437,6 +1437,21 @@ TEST(CompletionTest, DocumentationFromChangedFileCrash) {
               Contains(AllOf(Not(IsDocumented()), Named("func"))));
 }
 
+TEST(CompletionTest, DelayedTemplateParsing) {
+  MockFSProvider FS;
+  MockCompilationDatabase CDB;
+  CDB.ExtraClangFlags = {"-fdelayed-template-parsing"};
+  IgnoreDiagnostics DiagConsumer;
+  ClangdServer Server(CDB, FS, DiagConsumer, ClangdServer::optsForTest());
+
+  auto Results = completions(Server,
+                             R"cpp(
+    int delayed_global;
+    template <typename T> void f() { delayed_^ }
+  )cpp");
+  EXPECT_THAT(Results.Completions, ElementsAre(Named("delayed_global")));
+}
+
 TEST(CompletionTest, NonDocComments) {
   MockFSProvider FS;
   auto FooCpp = testPath("foo.cpp");
@@ -1482,9 +1497,6 @@ TEST(CompletionTest, NonDocComments) {
       int a = comments^;
     }
   )cpp");
-  // FIXME: Auto-completion in a template requires disabling delayed template
-  // parsing.
-  CDB.ExtraClangFlags.push_back("-fno-delayed-template-parsing");
   runAddDocument(Server, FooCpp, Source.code(), WantDiagnostics::Yes);
   CodeCompleteResult Completions = cantFail(runCodeComplete(
       Server, FooCpp, Source.point(), clangd::CodeCompleteOptions()));
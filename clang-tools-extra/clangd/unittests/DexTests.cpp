@@ -68,6 +68,32 @@ TEST(DexIterators, DocumentIterator) {
   EXPECT_TRUE(DocIterator->reachedEnd());
 }
 
+TEST(DexIterators, DocumentIteratorManyChunks) {
+  // Mixes deltas which take one and two bytes, over a few hundred chunks.
+  std::vector<DocID> Docs;
+  for (DocID I = 0, Doc = 0; I < 5000; ++I)
+    Docs.push_back(Doc += (I % 3 == 0) ? 300 : 1);
+  const PostingList L(Docs);
+  auto DocIterator = L.iterator();
+  EXPECT_EQ(DocIterator->peek(), Docs.front());
+
+  // Short and long jumps, to documents which are in the list or not.
+  for (DocID Target : {DocID(302), DocID(303), DocID(1000), DocID(1001),
+                       DocID(5000), DocID(200000), Docs[3000], Docs[3001]}) {
+    DocIterator->advanceTo(Target);
+    ASSERT_FALSE(DocIterator->reachedEnd());
+    EXPECT_EQ(DocIterator->peek(),
+              *std::lower_bound(Docs.begin(), Docs.end(), Target));
+  }
+  DocIterator->advance();
+  EXPECT_EQ(DocIterator->peek(), Docs[3002]);
+
+  DocIterator->advanceTo(Docs.back());
+  EXPECT_EQ(DocIterator->peek(), Docs.back());
+  DocIterator->advance();
+  EXPECT_TRUE(DocIterator->reachedEnd());
+}
+
 TEST(DexIterators, AndTwoLists) {
   Corpus C{10000};
   const PostingList L0({0, 5, 7, 10, 42, 320, 9000});
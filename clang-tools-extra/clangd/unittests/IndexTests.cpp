@@ -115,6 +115,39 @@ TEST(RelationSlab, Duplicates) {
                         Relation{A, index::SymbolRole::RelationBaseOf, C}));
 }
 
+TEST(RequestTest, JSONRoundTrip) {
+  SymbolID A = SymbolID("A"), B = SymbolID("B");
+
+  RefsRequest Refs;
+  Refs.IDs = {A, B};
+  Refs.Filter = RefKind::Declaration | RefKind::Definition;
+  RefsRequest ParsedRefs;
+  ASSERT_TRUE(fromJSON(toJSON(Refs), ParsedRefs));
+  EXPECT_EQ(ParsedRefs.IDs, Refs.IDs);
+  EXPECT_EQ(ParsedRefs.Filter, Refs.Filter);
+  EXPECT_FALSE(ParsedRefs.Limit);
+
+  RelationsRequest Relations;
+  Relations.Subjects = {A};
+  Relations.Predicate = index::SymbolRole::RelationBaseOf;
+  Relations.Limit = 5;
+  RelationsRequest ParsedRelations;
+  ASSERT_TRUE(fromJSON(toJSON(Relations), ParsedRelations));
+  EXPECT_EQ(ParsedRelations.Subjects, Relations.Subjects);
+  EXPECT_EQ(ParsedRelations.Predicate, Relations.Predicate);
+  EXPECT_EQ(ParsedRelations.Limit, Relations.Limit);
+
+  FuzzyFindRequest Fuzzy;
+  Fuzzy.Query = "x";
+  Fuzzy.Scopes = {"ns::"};
+  FuzzyFindRequest ParsedFuzzy;
+  ASSERT_TRUE(fromJSON(toJSON(Fuzzy), ParsedFuzzy));
+  EXPECT_EQ(ParsedFuzzy, Fuzzy);
+
+  LookupRequest Lookup;
+  EXPECT_FALSE(fromJSON(llvm::json::Object{{"IDs", {"not an ID"}}}, Lookup));
+}
+
 TEST(SwapIndexTest, OldIndexRecycled) {
   auto Token = std::make_shared<int>();
   std::weak_ptr<int> WeakToken = Token;
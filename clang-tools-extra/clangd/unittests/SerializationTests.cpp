@@ -10,6 +10,8 @@
 #include "index/Index.h"
 #include "index/Serialization.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -270,6 +272,50 @@ TEST(SerializationTest, CmdlTest) {
     EXPECT_NE(SerializedCmd.Output, Cmd.Output);
   }
 }
+
+TEST(SerializationTest, MappedRefs) {
+  auto In = readIndexFile(YAML);
+  ASSERT_TRUE(bool(In)) << In.takeError();
+  IndexFileOut Out(*In);
+  Out.Format = IndexFileFormat::RIFF;
+
+  llvm::SmallString<128> Path;
+  int FD;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("mapped-refs", "idx", FD, Path));
+  llvm::FileRemover Remover(Path);
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Out;
+  }
+
+  auto Index = loadIndex(Path, /*UseDex=*/true, /*MapRefs=*/true);
+  ASSERT_TRUE(Index);
+
+  RefsRequest Req;
+  Req.IDs = {cantFail(SymbolID::fromStr("057557CEBF6E6B2D")),
+             cantFail(SymbolID::fromStr("057557CEBF6E6B2E"))};
+  std::vector<Ref> Refs;
+  Index->refs(Req, [&](const Ref &R) { Refs.push_back(R); });
+  ASSERT_EQ(Refs.size(), 1u);
+  EXPECT_STREQ(Refs[0].Location.FileURI, "file:///path/foo.cc");
+  EXPECT_EQ(Refs[0].Location.Start.line(), 5u);
+  EXPECT_EQ(Refs[0].Location.Start.column(), 3u);
+
+  // The refs that are not of the requested kind are filtered out.
+  Req.Filter = RefKind::Declaration;
+  Refs.clear();
+  Index->refs(Req, [&](const Ref &R) { Refs.push_back(R); });
+  EXPECT_THAT(Refs, ::testing::IsEmpty());
+
+  // The other queries are served from memory.
+  LookupRequest Lookup;
+  Lookup.IDs = {cantFail(SymbolID::fromStr("057557CEBF6E6B2E"))};
+  std::vector<std::string> Names;
+  Index->lookup(Lookup, [&](const Symbol &S) { Names.push_back(S.Name.str()); });
+  EXPECT_THAT(Names, UnorderedElementsAre("Foo2"));
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
@@ -28,6 +28,7 @@ namespace {
 using ::testing::AnyOf;
 using ::testing::Each;
 using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::Pointee;
 using ::testing::UnorderedElementsAre;
 
@@ -573,6 +574,110 @@ TEST_F(TUSchedulerTests, RunWaitsForPreamble) {
   ASSERT_THAT(Preambles, Each(Preambles[0]));
 }
 
+TEST_F(TUSchedulerTests, SharesPreambles) {
+  class CountPreambles : public ParsingCallbacks {
+  public:
+    CountPreambles(std::atomic<int> &Built) : Built(Built) {}
+
+    void onPreambleAST(PathRef Path, ASTContext &Ctx,
+                       std::shared_ptr<clang::Preprocessor> PP,
+                       const CanonicalIncludes &) override {
+      ++Built;
+    }
+
+  private:
+    std::atomic<int> &Built;
+  };
+  std::atomic<int> Built(0);
+  TUScheduler S(CDB,
+                /*AsyncThreadsCount=*/getDefaultAsyncThreadsCount(),
+                /*StorePreambleInMemory=*/true,
+                std::make_unique<CountPreambles>(Built),
+                /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(),
+                ASTRetentionPolicy());
+  auto getPreamble = [&](PathRef File) {
+    const PreambleData *Result = nullptr;
+    S.runWithPreamble("getPreamble", File, TUScheduler::Consistent,
+                      [&](Expected<InputsAndPreamble> IP) {
+                        Result = cantFail(std::move(IP)).Preamble;
+                      });
+    EXPECT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    return Result;
+  };
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  auto Other = testPath("sub/other.cpp");
+  Files[testPath("foo.h")] = "int x;";
+  S.update(Foo, getInputs(Foo, "#include \"foo.h\"\nint a;"),
+           WantDiagnostics::No);
+  const PreambleData *FooPreamble = getPreamble(Foo);
+  ASSERT_NE(FooPreamble, nullptr);
+  EXPECT_EQ(Built, 1);
+
+  // Same directory, flags and preamble: the preamble is reused.
+  S.update(Bar, getInputs(Bar, "#include \"foo.h\"\nint b;"),
+           WantDiagnostics::No);
+  EXPECT_EQ(getPreamble(Bar), FooPreamble);
+  EXPECT_EQ(Built, 1);
+
+  // The preamble is retained after the files are closed.
+  S.remove(Foo);
+  S.remove(Bar);
+  S.update(Foo, getInputs(Foo, "#include \"foo.h\"\nint a;"),
+           WantDiagnostics::No);
+  EXPECT_EQ(getPreamble(Foo), FooPreamble);
+  EXPECT_EQ(Built, 1);
+
+  // Another directory may resolve the includes differently.
+  Files[testPath("sub/foo.h")] = "int y;";
+  S.update(Other, getInputs(Other, "#include \"foo.h\"\nint a;"),
+           WantDiagnostics::No);
+  EXPECT_NE(getPreamble(Other), FooPreamble);
+  EXPECT_EQ(Built, 2);
+}
+
+TEST_F(TUSchedulerTests, PatchesPreambleWithAppendedIncludes) {
+  TUScheduler S(CDB,
+                /*AsyncThreadsCount=*/getDefaultAsyncThreadsCount(),
+                /*StorePreambleInMemory=*/true, captureDiags(),
+                /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(),
+                ASTRetentionPolicy());
+  auto Foo = testPath("foo.cpp");
+  Files[testPath("a.h")] = "int a;";
+  Files[testPath("b.h")] = "int b;";
+
+  std::vector<Diag> Diags;
+  updateWithDiags(S, Foo, "#include \"a.h\"\nint x = a;",
+                  WantDiagnostics::Yes,
+                  [&](std::vector<Diag> D) { Diags = std::move(D); });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_THAT(Diags, IsEmpty());
+
+  // The AST is built on the old preamble, and sees the appended include.
+  llvm::StringLiteral Patched = "#include \"a.h\"\n#include \"b.h\"\n"
+                                "int x = a + b;";
+  bool SeenDiags = false;
+  updateWithDiags(S, Foo, Patched, WantDiagnostics::Yes,
+                  [&](std::vector<Diag> D) {
+                    SeenDiags = true;
+                    Diags = std::move(D);
+                  });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_TRUE(SeenDiags);
+  EXPECT_THAT(Diags, IsEmpty());
+
+  // The preamble is rebuilt with the new include.
+  S.runWithPreamble("CheckPreamble", Foo, TUScheduler::Stale,
+                    [&](Expected<InputsAndPreamble> IP) {
+                      auto Preamble = cantFail(std::move(IP)).Preamble;
+                      ASSERT_TRUE(Preamble);
+                      EXPECT_EQ(Preamble->Preamble.getBounds().Size,
+                                Patched.find("int"));
+                    });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+}
+
 TEST_F(TUSchedulerTests, NoopOnEmptyChanges) {
   TUScheduler S(CDB,
                 /*AsyncThreadsCount=*/getDefaultAsyncThreadsCount(),
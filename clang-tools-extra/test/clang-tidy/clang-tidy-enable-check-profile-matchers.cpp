@@ -0,0 +1,17 @@
+// RUN: clang-tidy -enable-check-profile -profile-matchers -checks='-*,readability-function-size' %s -- 2>&1 | FileCheck --match-full-lines -implicit-check-not='{{warning:|error:}}' %s
+
+// CHECK: ===-------------------------------------------------------------------------===
+// CHECK-NEXT:                          clang-tidy checks profiling
+// CHECK-NEXT: ===-------------------------------------------------------------------------===
+// CHECK-NEXT: Total Execution Time: {{.*}} seconds ({{.*}} wall clock)
+
+// CHECK: {{.*}}  --- Name ---
+// The start and the end of the translation unit are still timed per check.
+// CHECK-DAG: {{.*}}  readability-function-size
+// CHECK-DAG: {{.*}}  readability-function-size.FunctionDecl.0
+// CHECK: {{.*}}  Total
+
+class A {
+  A() {}
+  ~A() {}
+};
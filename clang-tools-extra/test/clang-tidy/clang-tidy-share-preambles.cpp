@@ -0,0 +1,13 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: echo 'int *H = 0;' > %t/header.h
+// RUN: echo '#include "header.h"' > %t/a.cpp
+// RUN: echo 'int *A = 0;' >> %t/a.cpp
+// RUN: echo '#include "header.h"' > %t/b.cpp
+// RUN: echo 'int *B = 0;' >> %t/b.cpp
+// RUN: clang-tidy -share-preambles -checks=-*,modernize-use-nullptr -header-filter=.* %t/a.cpp %t/b.cpp -- 2>&1 | FileCheck %s
+
+// The second file reuses the preamble of the first one, and the declarations
+// of the preamble are still checked.
+// CHECK-DAG: a.cpp:2:10: warning: use nullptr [modernize-use-nullptr]
+// CHECK-DAG: b.cpp:2:10: warning: use nullptr [modernize-use-nullptr]
+// CHECK-DAG: header.h:1:10: warning: use nullptr [modernize-use-nullptr]
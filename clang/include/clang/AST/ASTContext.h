@@ -683,6 +683,12 @@ public:
     return BumpAlloc.getTotalMemory();
   }
 
+  /// Return the number of bytes allocated for representing AST nodes and type
+  /// information, which is finer-grained than getASTAllocatedMemory().
+  size_t getASTAllocatedBytes() const {
+    return BumpAlloc.getBytesAllocated();
+  }
+
   /// Return the total memory used for various side tables.
   size_t getSideTableAllocatedMemory() const;
 
@@ -126,6 +126,12 @@ public:
 
       /// Per bucket timing information.
       llvm::StringMap<llvm::TimeRecord> &Records;
+
+      /// If true, each matcher (with its callback's run()) is timed in its own
+      /// bucket, "ID.Kind.N" for the N-th matcher of nodes of that kind which
+      /// was added with the callback. Otherwise, there is one bucket per
+      /// callback ID.
+      bool PerMatcher = false;
     };
 
     /// Enables per-check timers.
@@ -188,8 +188,7 @@ private:
                                                      StringRef IndexName,
                                                      bool DisplayCTUProgress);
   template <typename T>
-  const T *findDefInDeclContext(const DeclContext *DC,
-                                StringRef LookupName);
+  const T *findDefInUnit(ASTUnit *Unit, StringRef LookupName);
   template <typename T>
   llvm::Expected<const T *> importDefinitionImpl(const T *D, ASTUnit *Unit);
 
@@ -198,6 +197,18 @@ private:
 
   ImporterMapTy ASTUnitImporterMap;
 
+  /// The definitions of the functions and variables of a loaded ASTUnit, by
+  /// lookup name.
+  using DefinitionMapTy = llvm::StringMap<const NamedDecl *>;
+
+  /// Returns the definitions of \p Unit, which are collected the first time a
+  /// definition is looked up in it, so that each lookup does not walk the
+  /// whole unit again.
+  const DefinitionMapTy &getDefinitionsInUnit(ASTUnit *Unit);
+
+  llvm::DenseMap<const TranslationUnitDecl *, DefinitionMapTy>
+      UnitDefinitions;
+
   ASTContext &Context;
   std::shared_ptr<ASTImporterSharedState> ImporterSharedSt;
   /// Map of imported FileID's (in "To" context) to FileID in "From" context
@@ -200,6 +200,13 @@ public:
   /// Whether the driver is generating diagnostics for debugging purposes.
   unsigned CCGenDiagnostics : 1;
 
+  /// The entry point of the -cc1 tools, if it is linked in the driver, and
+  /// null otherwise. It is passed the -cc1 command line, starting with the
+  /// executable, and used to execute the -cc1 commands in the driver process
+  /// under -fintegrated-cc1.
+  typedef int (*CC1ToolFunc)(SmallVectorImpl<const char *> &ArgV);
+  CC1ToolFunc CC1Main = nullptr;
+
 private:
   /// Raw target triple.
   std::string TargetTriple;
@@ -85,7 +85,15 @@ class Command {
   /// The results are the contents of a response file, written into a raw_ostream.
   void writeResponseFile(raw_ostream &OS) const;
 
+protected:
+  /// Prints the input filenames, if requested by setPrintInputFilenames().
+  void PrintFileNames() const;
+
 public:
+  /// Whether the command is executed in the driver process, rather than in a
+  /// new process.
+  bool InProcess = false;
+
   Command(const Action &Source, const Tool &Creator, const char *Executable,
           const llvm::opt::ArgStringList &Arguments,
           ArrayRef<InputInfo> Inputs);
@@ -125,6 +133,11 @@ public:
 
   const llvm::opt::ArgStringList &getArguments() const { return Arguments; }
 
+  /// Replaces the arguments of the command.
+  void replaceArguments(llvm::opt::ArgStringList List) {
+    Arguments = std::move(List);
+  }
+
   /// Print a command argument, and optionally quote it.
   static void printArg(llvm::raw_ostream &OS, StringRef Arg, bool Quote);
 
@@ -132,6 +145,24 @@ public:
   void setPrintInputFilenames(bool P) { PrintInputFilenames = P; }
 };
 
+/// Like Command, but executed in the driver process, through Driver::CC1Main,
+/// instead of in a new process. This saves the start-up of a compiler process
+/// for each -cc1 command. A crash of the command is caught by a
+/// CrashRecoveryContext and reported as if the process had crashed.
+class CC1Command : public Command {
+public:
+  CC1Command(const Action &Source, const Tool &Creator,
+             const char *Executable,
+             const llvm::opt::ArgStringList &Arguments,
+             ArrayRef<InputInfo> Inputs);
+
+  void Print(llvm::raw_ostream &OS, const char *Terminator, bool Quote,
+             CrashReportInfo *CrashInfo = nullptr) const override;
+
+  int Execute(ArrayRef<Optional<StringRef>> Redirects, std::string *ErrMsg,
+              bool *ExecutionFailed) const override;
+};
+
 /// Like Command, but with a fallback which is executed in case
 /// the primary command crashes.
 class FallbackCommand : public Command {
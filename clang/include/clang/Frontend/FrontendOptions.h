@@ -230,6 +230,9 @@ public:
   /// Disable memory freeing on exit.
   unsigned DisableFree : 1;
 
+  /// Back the AST and preprocessor arenas with huge pages.
+  unsigned UseHugePageArenas : 1;
+
   /// When generating PCH files, instruct the AST writer to create relocatable
   /// PCH files.
   unsigned RelocatablePCH : 1;
@@ -249,6 +252,12 @@ public:
   /// Output time trace profile.
   unsigned TimeTrace : 1;
 
+  /// Output a summary of the time trace profile instead of every event.
+  unsigned TimeTraceSummary : 1;
+
+  /// Output the cost of the template instantiations, by template.
+  unsigned TimeTraceTemplates : 1;
+
   /// Show the -version text.
   unsigned ShowVersion : 1;
 
@@ -435,11 +444,12 @@ public:
 
 public:
   FrontendOptions()
-      : DisableFree(false), RelocatablePCH(false), ShowHelp(false),
-        ShowStats(false), ShowTimers(false), TimeTrace(false),
-        ShowVersion(false), FixWhatYouCan(false), FixOnlyWarnings(false),
-        FixAndRecompile(false), FixToTemporaries(false),
-        ARCMTMigrateEmitARCErrors(false), SkipFunctionBodies(false),
+      : DisableFree(false), UseHugePageArenas(false), RelocatablePCH(false),
+        ShowHelp(false), ShowStats(false), ShowTimers(false), TimeTrace(false),
+        TimeTraceSummary(false), TimeTraceTemplates(false), ShowVersion(false),
+        FixWhatYouCan(false), FixOnlyWarnings(false), FixAndRecompile(false),
+        FixToTemporaries(false), ARCMTMigrateEmitARCErrors(false),
+        SkipFunctionBodies(false),
         UseGlobalModuleIndex(true), GenerateGlobalModuleIndex(true),
         ASTDumpDecls(false), ASTDumpLookups(false),
         BuildingImplicitModule(false), ModulesEmbedAllFiles(false),
@@ -0,0 +1,40 @@
+//===--- TemplateInstantiationProfiler.h - Profile instantiations -*- C++ -*-=//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_FRONTEND_TEMPLATEINSTANTIATIONPROFILER_H
+#define LLVM_CLANG_FRONTEND_TEMPLATEINSTANTIATIONPROFILER_H
+
+#include "clang/Basic/LLVM.h"
+#include <memory>
+
+namespace llvm {
+class raw_pwrite_stream;
+}
+
+namespace clang {
+
+class TemplateInstantiationCallback;
+
+/// Create a template instantiation callback that aggregates the cost of the
+/// instantiations of a translation unit by template, and writes it as JSON to
+/// \p OS once the translation unit is parsed.
+///
+/// Each template is reported with the number of times it was instantiated,
+/// the time spent in its instantiations, both including the nested ones
+/// ("total us") and excluding them ("self us"), and the AST memory they
+/// allocated, excluding the nested instantiations ("self bytes"). The self
+/// costs of all the templates add up to the cost of the instantiations of the
+/// translation unit, and the templates are identified by name and location, so
+/// the reports of several translation units can be summed up.
+std::unique_ptr<TemplateInstantiationCallback>
+createTemplateInstantiationProfiler(
+    std::unique_ptr<llvm::raw_pwrite_stream> OS);
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_FRONTEND_TEMPLATEINSTANTIATIONPROFILER_H
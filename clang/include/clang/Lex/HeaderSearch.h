@@ -43,6 +43,7 @@ class IdentifierInfo;
 class LangOptions;
 class Module;
 class Preprocessor;
+class SharedHeaderCache;
 class TargetInfo;
 
 /// The preprocessor keeps track of this information for each
@@ -226,7 +227,8 @@ class HeaderSearch {
   std::unique_ptr<IncludeAliasMap> IncludeAliases;
 
   /// This is a mapping from FileEntry -> HeaderMap, uniquing headermaps.
-  std::vector<std::pair<const FileEntry *, std::unique_ptr<HeaderMap>>> HeaderMaps;
+  std::vector<std::pair<const FileEntry *, std::shared_ptr<const HeaderMap>>>
+      HeaderMaps;
 
   /// The mapping between modules and headers.
   mutable ModuleMap ModMap;
@@ -250,6 +252,11 @@ class HeaderSearch {
   /// Entity used to look up stored header file information.
   ExternalHeaderFileInfoSource *ExternalSource = nullptr;
 
+  /// The hash of the language options that qualifies the controlling macros
+  /// shared through HeaderSearchOptions::SharedHeaders, or 0 if it is not
+  /// computed yet.
+  unsigned SharedHeadersLangOptsHash = 0;
+
   // Various statistics we track for performance analysis.
   unsigned NumIncluded = 0;
   unsigned NumMultiIncludeFileOptzn = 0;
@@ -470,6 +477,11 @@ public:
     getFileInfo(File).ControllingMacro = ControllingMacro;
   }
 
+  /// Share the controlling macro \p ControllingMacro of \p File, lexed by
+  /// \p PP, with the other users of HeaderSearchOptions::SharedHeaders.
+  void ShareFileControllingMacro(Preprocessor &PP, const FileEntry *File,
+                                 const IdentifierInfo *ControllingMacro);
+
   /// Return true if this is the first time encountering this header.
   bool FirstTimeLexingFile(const FileEntry *File) {
     return getFileInfo(File).NumIncludes == 1;
@@ -739,6 +751,11 @@ public:
   size_t getTotalMemory() const;
 
 private:
+  /// Returns the cache shared with other header searches, if one should be
+  /// used for the controlling macros of \p File.
+  SharedHeaderCache *getSharedControllingMacros(Preprocessor &PP,
+                                                const FileEntry *File);
+
   /// Describes what happened when we tried to load a module map file.
   enum LoadModuleMapResult {
     /// The module map file had already been loaded.
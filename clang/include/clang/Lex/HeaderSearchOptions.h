@@ -17,9 +17,12 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 
 namespace clang {
 
+class SharedHeaderCache;
+
 namespace frontend {
 
 /// IncludeDirGroup - Identifies the group an include Entry belongs to,
@@ -172,6 +175,10 @@ public:
   /// The set of user-provided virtual filesystem overlay files.
   std::vector<std::string> VFSOverlayFiles;
 
+  /// What the header searches of other translation units learned about
+  /// headers, shared with this one.
+  std::shared_ptr<SharedHeaderCache> SharedHeaders;
+
   /// Include the compiler builtin includes.
   unsigned UseBuiltinIncludes : 1;
 
@@ -131,6 +131,10 @@ class Lexer : public PreprocessorLexer {
   // CurrentConflictMarkerState - The kind of conflict marker we are handling.
   ConflictMarkerKind CurrentConflictMarkerState;
 
+  // ExcludedLinesStop - Where skipExcludedLines() last handed over to the
+  // lexer.  It is not called again before the lexer gets past that point.
+  const char *ExcludedLinesStop = nullptr;
+
   void InitLexer(const char *BufStart, const char *BufPtr, const char *BufEnd);
 
 public:
@@ -265,6 +269,12 @@ public:
   /// Return the current location in the buffer.
   const char *getBufferLocation() const { return BufferPtr; }
 
+  /// Returns the current lexing offset.
+  unsigned getCurrentBufferOffset() const {
+    assert(BufferPtr >= BufferStart && "Invalid buffer state");
+    return BufferPtr - BufferStart;
+  }
+
   /// Stringify - Convert the specified string into a C string by i) escaping
   /// '\\' and " characters and ii) replacing newline character(s) with "\\n".
   /// If Charify is true, this escapes the ' character instead of ".
@@ -676,6 +686,12 @@ private:
 
   void SetByteOffset(unsigned Offset, bool StartOfLine);
 
+  /// skipExcludedLines - Skip the lines of an excluded conditional block that
+  /// cannot hold a directive, without forming their tokens.  This stops at
+  /// the start of the first line with a '#', or with something that is left
+  /// to the lexer, such as an escaped newline or a raw string literal.
+  void skipExcludedLines();
+
   void PropagateLineStartLeadingSpaceInfo(Token &Result);
 
   const char *LexUDSuffix(Token &Result, const char *CurPtr,
@@ -809,6 +809,11 @@ private:
   /// Whether tokens are being skipped until the through header is seen.
   bool SkippingUntilPCHThroughHeader = false;
 
+  /// The hash of the language options under which the blocks of
+  /// PreprocessorOptions::SkippedConditionalBlocks are looked up, or 0 if it
+  /// has not been computed yet.
+  unsigned SkippedBlocksLangOptsHash = 0;
+
   /// \{
   /// Cache of macro expanders to reduce malloc traffic.
   enum { TokenLexerCacheSize = 8 };
@@ -26,6 +26,8 @@ class MemoryBuffer;
 
 namespace clang {
 
+class SkippedConditionalBlockCache;
+
 /// Enumerate the kinds of standard library that
 enum ObjCXXARCStandardLibraryKind {
   ARCXX_nolib,
@@ -76,6 +78,10 @@ public:
   /// Headers that will be converted to chained PCHs in memory.
   std::vector<std::string> ChainedIncludes;
 
+  /// The directory in which the chained PCHs are cached across compilations,
+  /// or empty to build them in memory every time.
+  std::string ChainedIncludesCachePath;
+
   /// When true, disables most of the normal validation performed on
   /// precompiled headers.
   bool DisablePCHValidation = false;
@@ -169,6 +175,14 @@ public:
   /// build it again.
   std::shared_ptr<FailedModulesSet> FailedModules;
 
+  /// Where the excluded conditional blocks of files end, if the preprocessor
+  /// is to remember it.
+  ///
+  /// This pointer may be shared among the compiler instances of several
+  /// translation units, so that the blocks that one of them skipped are jumped
+  /// over by the others, instead of being lexed again.
+  std::shared_ptr<SkippedConditionalBlockCache> SkippedConditionalBlocks;
+
 public:
   PreprocessorOptions() : PrecompiledPreambleBytes(0, false) {}
 
@@ -194,6 +208,7 @@ public:
     Includes.clear();
     MacroIncludes.clear();
     ChainedIncludes.clear();
+    ChainedIncludesCachePath.clear();
     DumpDeserializedPCHDecls = false;
     ImplicitPCHInclude.clear();
     SingleFileParseMode = false;
@@ -0,0 +1,85 @@
+//===--- SharedHeaderCache.h - Header facts shared by TUs -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the SharedHeaderCache class, which lets the header
+//  searches of several translation units share what they learn about headers.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LEX_SHAREDHEADERCACHE_H
+#define LLVM_CLANG_LEX_SHAREDHEADERCACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <utility>
+
+namespace clang {
+
+class FileEntry;
+class FileManager;
+class HeaderMap;
+
+/// Remembers facts about headers that only depend on their contents, so that
+/// the header searches of several translation units, through
+/// HeaderSearchOptions::SharedHeaders, need not work them out again:
+///
+/// - the parsed header maps, which are immutable once created;
+/// - the controlling macros of the headers wrapped in include guards, which
+///   let an \#include be skipped without even opening the header when its
+///   guard is already defined.
+///
+/// Files are identified by their unique ID, and what is known about them is
+/// forgotten when their size or modification time changes.  The cache may be
+/// used from several threads.
+class SharedHeaderCache {
+public:
+  /// Returns the header map in \p File, reading it with \p FileMgr if it is
+  /// not known yet, or null if \p File is not a valid header map.
+  std::shared_ptr<const HeaderMap> getHeaderMap(const FileEntry *File,
+                                                FileManager &FileMgr);
+
+  /// Returns the name of the controlling macro of \p File, as lexed with
+  /// language options of hash \p LangOptsHash, or an empty string if it is
+  /// not known.
+  std::string getControllingMacro(const FileEntry *File,
+                                  unsigned LangOptsHash);
+
+  /// Remembers that \p File, lexed with language options of hash
+  /// \p LangOptsHash, is guarded by the macro named \p Macro.
+  void setControllingMacro(const FileEntry *File, unsigned LangOptsHash,
+                           StringRef Macro);
+
+private:
+  /// What is known about a version of a file.
+  template <typename T> struct Versioned {
+    off_t Size = -1;
+    time_t ModTime = 0;
+    T Value = T();
+
+    bool matches(const FileEntry *File) const;
+    void reset(const FileEntry *File);
+  };
+
+  std::mutex Mutex;
+  std::map<llvm::sys::fs::UniqueID, Versioned<std::shared_ptr<const HeaderMap>>>
+      HeaderMaps;
+  std::map<std::pair<llvm::sys::fs::UniqueID, unsigned>,
+           Versioned<std::string>>
+      ControllingMacros;
+};
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_LEX_SHAREDHEADERCACHE_H
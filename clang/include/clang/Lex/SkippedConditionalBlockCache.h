@@ -0,0 +1,79 @@
+//===--- SkippedConditionalBlockCache.h - Excluded block bounds -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the SkippedConditionalBlockCache class, which remembers
+//  where the blocks that the preprocessor skipped in a file end, so that they
+//  need not be lexed again by the next translation unit that skips them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LEX_SKIPPEDCONDITIONALBLOCKCACHE_H
+#define LLVM_CLANG_LEX_SKIPPEDCONDITIONALBLOCKCACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/Support/FileSystem.h"
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <sys/types.h>
+#include <utility>
+
+namespace clang {
+
+class FileEntry;
+class LangOptions;
+
+/// Remembers the bounds of the excluded conditional blocks of files.
+///
+/// A block starts after the line of a conditional directive and ends at the
+/// '#' of the next one, whatever their nesting levels.  Where a block ends
+/// only depends on the text of the file and on how it is lexed, so the
+/// preprocessors of several translation units can share a cache, through
+/// PreprocessorOptions::SkippedConditionalBlocks, and jump straight to the
+/// end of the blocks that one of them skipped before.  Every conditional
+/// directive is still seen, so the diagnostics do not change.
+///
+/// Files are identified by their unique ID, and their blocks are forgotten
+/// when their size or modification time changes.  The cache may be used from
+/// several threads.
+class SkippedConditionalBlockCache {
+public:
+  /// A block, as the offsets at which it begins and ends in its file.
+  using Block = std::pair<unsigned, unsigned>;
+
+  /// Returns a hash of the options that may change how \p LangOpts lexes a
+  /// file, which qualifies the blocks that are looked up and added.
+  static unsigned hashLangOptions(const LangOptions &LangOpts);
+
+  /// Returns the end of the block of \p File lexed with options of hash
+  /// \p LangOptsHash that begins at offset \p Begin, if it is known.
+  Optional<unsigned> getBlockEnd(const FileEntry *File, unsigned LangOptsHash,
+                                 unsigned Begin);
+
+  /// Remembers the blocks \p Blocks of \p File lexed with options of hash
+  /// \p LangOptsHash.
+  void addBlocks(const FileEntry *File, unsigned LangOptsHash,
+                 ArrayRef<Block> Blocks);
+
+private:
+  struct FileBlocks {
+    off_t Size = -1;
+    time_t ModTime = 0;
+    llvm::DenseMap<unsigned, unsigned> Ends;
+  };
+
+  std::mutex Mutex;
+  std::map<std::pair<llvm::sys::fs::UniqueID, unsigned>, FileBlocks> Files;
+};
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_LEX_SKIPPEDCONDITIONALBLOCKCACHE_H
@@ -1169,6 +1169,11 @@ public:
   /// The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// The number of overload candidates that were found not viable by an
+  /// obviously impossible argument conversion, before computing the conversion
+  /// sequences of their other arguments.
+  unsigned NumPrefilteredOverloadCandidates;
+
   typedef llvm::DenseMap<ParmVarDecl *, llvm::TinyPtrVector<ParmVarDecl *>>
     UnparsedDefaultArgInstantiationsMap;
 
@@ -10,11 +10,13 @@
 #define LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_FILESYSTEM_H
 
 #include "clang/Basic/LLVM.h"
+#include "clang/Tooling/DependencyScanning/MinimizedSourceDiskCache.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include <atomic>
 #include <mutex>
 
 namespace clang {
@@ -45,9 +47,13 @@ public:
   /// mismatching size of the file. If file is not minimized, the full file is
   /// read and copied into memory to ensure that it's not memory mapped to avoid
   /// running out of file descriptors.
-  static CachedFileSystemEntry createFileEntry(StringRef Filename,
-                                               llvm::vfs::FileSystem &FS,
-                                               bool Minimize = true);
+  ///
+  /// When \p DiskCache is given, the minimized contents are read from it if
+  /// the file did not change since it was stored, and stored to it otherwise.
+  static CachedFileSystemEntry
+  createFileEntry(StringRef Filename, llvm::vfs::FileSystem &FS,
+                  bool Minimize = true,
+                  const MinimizedSourceDiskCache *DiskCache = nullptr);
 
   /// Create an entry that represents a directory on the filesystem.
   static CachedFileSystemEntry createDirectoryEntry(llvm::vfs::Status &&Stat);
@@ -83,6 +89,12 @@ public:
   CachedFileSystemEntry &operator=(const CachedFileSystemEntry &) = delete;
 
 private:
+  /// Create an entry with the null terminated \p MinimizedFileContents of the
+  /// source file of status \p Stat.
+  static CachedFileSystemEntry
+  createMinimizedEntry(const llvm::vfs::Status &Stat,
+                       llvm::SmallString<1024> &&MinimizedFileContents);
+
   llvm::ErrorOr<llvm::vfs::Status> MaybeStat;
   // Store the contents in a small string to allow a
   // move from the small string for the minimized contents.
@@ -103,7 +115,10 @@ public:
     CachedFileSystemEntry Value;
   };
 
-  DependencyScanningFilesystemSharedCache();
+  /// Create the cache. When \p DiskCachePath is not empty, the minimized
+  /// files are also cached on disk in that directory, across the runs of the
+  /// scanner.
+  DependencyScanningFilesystemSharedCache(StringRef DiskCachePath = "");
 
   /// Returns a cache entry for the corresponding key.
   ///
@@ -111,6 +126,21 @@ public:
   /// thread safe call.
   SharedFileSystemEntry &get(StringRef Key);
 
+  /// Drops the cache entry for the corresponding key, so that the file is
+  /// read again from the underlying file system the next time it's requested.
+  ///
+  /// This must not be called while a worker is using the cache. The workers
+  /// clear their local caches before their next query.
+  void invalidate(StringRef Key);
+
+  /// \returns A number that changes every time an entry is invalidated.
+  unsigned getGeneration() const { return Generation; }
+
+  /// \returns The on-disk cache of minimized files, or null if there is none.
+  const MinimizedSourceDiskCache *getDiskCache() const {
+    return DiskCache.get();
+  }
+
 private:
   struct CacheShard {
     std::mutex CacheLock;
@@ -118,6 +148,8 @@ private:
   };
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
+  std::atomic<unsigned> Generation{0};
+  std::unique_ptr<MinimizedSourceDiskCache> DiskCache;
 };
 
 /// A virtual file system optimized for the dependency discovery.
@@ -134,7 +166,8 @@ public:
   DependencyScanningWorkerFilesystem(
       DependencyScanningFilesystemSharedCache &SharedCache,
       IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS)
-      : ProxyFileSystem(std::move(FS)), SharedCache(SharedCache) {}
+      : ProxyFileSystem(std::move(FS)), SharedCache(SharedCache),
+        Generation(SharedCache.getGeneration()) {}
 
   llvm::ErrorOr<llvm::vfs::Status> status(const Twine &Path) override;
   llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
@@ -151,6 +184,12 @@ private:
   }
 
   const CachedFileSystemEntry *getCachedEntry(StringRef Filename) {
+    // The local entries may point to shared entries that were invalidated.
+    unsigned SharedGeneration = SharedCache.getGeneration();
+    if (Generation != SharedGeneration) {
+      Cache.clear();
+      Generation = SharedGeneration;
+    }
     auto It = Cache.find(Filename);
     return It == Cache.end() ? nullptr : It->getValue();
   }
@@ -159,6 +198,8 @@ private:
   /// The local cache is used by the worker thread to cache file system queries
   /// locally instead of querying the global cache every time.
   llvm::StringMap<const CachedFileSystemEntry *, llvm::BumpPtrAllocator> Cache;
+  /// The generation of the shared cache the local cache is consistent with.
+  unsigned Generation;
 };
 
 } // end namespace dependencies
@@ -34,7 +34,10 @@ enum class ScanningMode {
 /// the invidual dependency scanning workers.
 class DependencyScanningService {
 public:
-  DependencyScanningService(ScanningMode Mode);
+  /// Create the service. When \p DiskCachePath is not empty, the minimized
+  /// source files are cached in that directory across the runs of the
+  /// scanner.
+  DependencyScanningService(ScanningMode Mode, StringRef DiskCachePath = "");
 
   ScanningMode getMode() const { return Mode; }
 
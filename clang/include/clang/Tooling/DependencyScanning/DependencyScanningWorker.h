@@ -17,6 +17,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include <string>
+#include <vector>
 
 namespace clang {
 namespace tooling {
@@ -39,11 +40,15 @@ public:
   /// file format that is specified in the options (-MD is the default) and
   /// return it.
   ///
+  /// If \p Dependencies is not null, the names of the files the input
+  /// depends on are also stored into it, as they were opened by the compiler.
+  ///
   /// \returns A \c StringError with the diagnostic output if clang errors
   /// occurred, dependency file contents otherwise.
-  llvm::Expected<std::string> getDependencyFile(const std::string &Input,
-                                                StringRef WorkingDirectory,
-                                                const CompilationDatabase &CDB);
+  llvm::Expected<std::string>
+  getDependencyFile(const std::string &Input, StringRef WorkingDirectory,
+                    const CompilationDatabase &CDB,
+                    std::vector<std::string> *Dependencies = nullptr);
 
 private:
   IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts;
@@ -0,0 +1,66 @@
+//===- MinimizedSourceDiskCache.h - clang-scan-deps disk cache --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_MINIMIZEDSOURCEDISKCACHE_H
+#define LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_MINIMIZEDSOURCEDISKCACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include <string>
+
+namespace clang {
+namespace tooling {
+namespace dependencies {
+
+/// An on-disk cache of the minimized contents of source files, which lets
+/// successive runs of the dependency scanner skip minimizing the files that
+/// did not change.
+///
+/// Each file is stored in a separate entry of the cache directory, keyed by
+/// the absolute path, size and modification time of the source file, and
+/// mapped into memory when it is read. Entries are written to a temporary
+/// file that is then renamed, so several processes can share a directory.
+/// The entries are named like the ones of llvm::pruneCache(), which can keep
+/// the directory from growing without bounds.
+///
+/// Failing to read or write the cache is not an error: the file is then
+/// minimized as if it was not cached. The cache may be used from several
+/// threads.
+class MinimizedSourceDiskCache {
+public:
+  /// Use the cache in directory \p Path, creating it if needed.
+  explicit MinimizedSourceDiskCache(StringRef Path);
+
+  /// Read the cached minimized contents of the source file \p Filename of
+  /// status \p Stat into \p Contents.
+  ///
+  /// \returns True if the file was found in the cache.
+  bool lookup(StringRef Filename, const llvm::vfs::Status &Stat,
+              SmallVectorImpl<char> &Contents) const;
+
+  /// Store \p Contents as the minimized contents of the source file
+  /// \p Filename of status \p Stat.
+  void store(StringRef Filename, const llvm::vfs::Status &Stat,
+             StringRef Contents) const;
+
+  StringRef getPath() const { return Path; }
+
+private:
+  /// Returns the path of the entry for \p Key.
+  std::string getEntryPath(StringRef Key) const;
+
+  std::string Path;
+};
+
+} // end namespace dependencies
+} // end namespace tooling
+} // end namespace clang
+
+#endif // LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_MINIMIZEDSOURCEDISKCACHE_H
@@ -54,6 +54,8 @@ class CompilerInstance;
 class CompilerInvocation;
 class DiagnosticConsumer;
 class DiagnosticsEngine;
+class SharedHeaderCache;
+class SkippedConditionalBlockCache;
 class SourceManager;
 
 namespace driver {
@@ -265,6 +267,19 @@ public:
     this->DiagConsumer = DiagConsumer;
   }
 
+  /// Set the cache of the bounds of excluded conditional blocks to share with
+  /// the preprocessor of the invocation.
+  void setSkippedConditionalBlockCache(
+      std::shared_ptr<SkippedConditionalBlockCache> SkippedBlocks) {
+    this->SkippedBlocks = std::move(SkippedBlocks);
+  }
+
+  /// Set the cache of what is known about headers to share with the header
+  /// search of the invocation.
+  void setSharedHeaderCache(std::shared_ptr<SharedHeaderCache> SharedHeaders) {
+    this->SharedHeaders = std::move(SharedHeaders);
+  }
+
   /// Map a virtual file to be used while running the tool.
   ///
   /// \param FilePath The path at which the content will be mapped.
@@ -293,6 +308,8 @@ public:
   // Maps <file name> -> <file content>.
   llvm::StringMap<StringRef> MappedFileContents;
   DiagnosticConsumer *DiagConsumer = nullptr;
+  std::shared_ptr<SkippedConditionalBlockCache> SkippedBlocks;
+  std::shared_ptr<SharedHeaderCache> SharedHeaders;
 };
 
 /// Utility to run a FrontendAction over a set of files.
@@ -369,6 +386,33 @@ public:
   /// The file manager is shared between all translation units.
   FileManager &getFiles() { return *Files; }
 
+  /// Returns the cache of the bounds of excluded conditional blocks.
+  ///
+  /// The cache is shared between all translation units, so that the blocks
+  /// that the preprocessor skipped in one of them need not be lexed again.
+  std::shared_ptr<SkippedConditionalBlockCache> getSkippedConditionalBlocks() {
+    return SkippedBlocks;
+  }
+
+  /// Share \p SkippedBlocks with other tools, instead of the cache of this
+  /// tool.
+  void setSkippedConditionalBlocks(
+      std::shared_ptr<SkippedConditionalBlockCache> SkippedBlocks) {
+    this->SkippedBlocks = std::move(SkippedBlocks);
+  }
+
+  /// Returns the cache of what is known about headers, such as header maps
+  /// and include guards, shared between all translation units.
+  std::shared_ptr<SharedHeaderCache> getSharedHeaders() {
+    return SharedHeaders;
+  }
+
+  /// Share \p SharedHeaders with other tools, instead of the cache of this
+  /// tool.
+  void setSharedHeaders(std::shared_ptr<SharedHeaderCache> SharedHeaders) {
+    this->SharedHeaders = std::move(SharedHeaders);
+  }
+
   llvm::ArrayRef<std::string> getSourcePaths() const { return SourcePaths; }
 
 private:
@@ -379,6 +423,8 @@ private:
   llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> OverlayFileSystem;
   llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFileSystem;
   llvm::IntrusiveRefCntPtr<FileManager> Files;
+  std::shared_ptr<SkippedConditionalBlockCache> SkippedBlocks;
+  std::shared_ptr<SharedHeaderCache> SharedHeaders;
 
   // Contains a list of pairs (<file name>, <file content>).
   std::vector<std::pair<StringRef, StringRef>> MappedFileContents;
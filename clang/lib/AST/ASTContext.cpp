@@ -832,6 +832,7 @@ ASTContext::ASTContext(LangOptions &LOpts, SourceManager &SM,
       BuiltinInfo(builtins), DeclarationNames(*this), Comments(SM),
       CommentCommandTraits(BumpAlloc, LOpts.CommentOpts),
       CompCategories(this_()), LastSDM(nullptr, 0) {
+  BumpAlloc.setName("ASTContext");
   TUDecl = TranslationUnitDecl::Create(*this);
   TraversalScope = {TUDecl};
 }
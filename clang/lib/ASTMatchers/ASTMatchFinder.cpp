@@ -304,7 +304,10 @@ class MatchASTVisitor : public RecursiveASTVisitor<MatchASTVisitor>,
 public:
   MatchASTVisitor(const MatchFinder::MatchersByType *Matchers,
                   const MatchFinder::MatchFinderOptions &Options)
-      : Matchers(Matchers), Options(Options), ActiveASTContext(nullptr) {}
+      : Matchers(Matchers), Options(Options), ActiveASTContext(nullptr) {
+    if (Options.CheckProfiling && Options.CheckProfiling->PerMatcher)
+      nameMatcherBuckets();
+  }
 
   ~MatchASTVisitor() override {
     if (Options.CheckProfiling) {
@@ -541,6 +544,38 @@ private:
     llvm::TimeRecord *Bucket;
   };
 
+  /// Names the bucket of each matcher, see
+  /// \c MatchFinderOptions::Profiling::PerMatcher.
+  void nameMatcherBuckets() {
+    llvm::StringMap<unsigned> NumMatchers; // By ID.Kind.
+    auto Name = [&](const void *Matcher, MatchCallback *Callback,
+                    StringRef Kind) {
+      std::string Prefix = (Callback->getID() + "." + Kind).str();
+      MatcherBuckets[Matcher] =
+          Prefix + "." + std::to_string(NumMatchers[Prefix]++);
+    };
+    for (const auto &MP : Matchers->DeclOrStmt)
+      Name(&MP, MP.second, MP.first.getID().first.asStringRef());
+    for (const auto &MP : Matchers->Type)
+      Name(&MP, MP.second, "QualType");
+    for (const auto &MP : Matchers->NestedNameSpecifier)
+      Name(&MP, MP.second, "NestedNameSpecifier");
+    for (const auto &MP : Matchers->NestedNameSpecifierLoc)
+      Name(&MP, MP.second, "NestedNameSpecifierLoc");
+    for (const auto &MP : Matchers->TypeLoc)
+      Name(&MP, MP.second, "TypeLoc");
+    for (const auto &MP : Matchers->CtorInit)
+      Name(&MP, MP.second, "CXXCtorInitializer");
+  }
+
+  /// Returns the profiling bucket of \p MP, an element of \c Matchers.
+  template <typename MatcherAndCallback>
+  llvm::TimeRecord *getBucket(const MatcherAndCallback &MP) {
+    if (MatcherBuckets.empty())
+      return &TimeByBucket[MP.second->getID()];
+    return &TimeByBucket[MatcherBuckets.find(&MP)->second];
+  }
+
   /// Runs all the \p Matchers on \p Node.
   ///
   /// Used by \c matchDispatch() below.
@@ -550,7 +585,7 @@ private:
     TimeBucketRegion Timer;
     for (const auto &MP : Matchers) {
       if (EnableCheckProfiling)
-        Timer.setBucket(&TimeByBucket[MP.second->getID()]);
+        Timer.setBucket(getBucket(MP));
       BoundNodesTreeBuilder Builder;
       if (MP.first.matches(Node, this, &Builder)) {
         MatchVisitor Visitor(ActiveASTContext, MP.second);
@@ -574,7 +609,7 @@ private:
     for (unsigned short I : Filter) {
       auto &MP = Matchers[I];
       if (EnableCheckProfiling)
-        Timer.setBucket(&TimeByBucket[MP.second->getID()]);
+        Timer.setBucket(getBucket(MP));
       BoundNodesTreeBuilder Builder;
       if (MP.first.matchesNoKindCheck(DynNode, this, &Builder)) {
         MatchVisitor Visitor(ActiveASTContext, MP.second);
@@ -796,6 +831,10 @@ private:
   /// Used to get the appropriate bucket for each matcher.
   llvm::StringMap<llvm::TimeRecord> TimeByBucket;
 
+  /// Bucket names of the matchers, by the address of their element of
+  /// \c Matchers. Only set with per-matcher profiling.
+  llvm::DenseMap<const void *, std::string> MatcherBuckets;
+
   const MatchFinder::MatchersByType *Matchers;
 
   /// Filtered list of matcher indices for each matcher kind.
@@ -340,6 +340,7 @@ LineTableInfo &SourceManager::getLineTable() {
 SourceManager::SourceManager(DiagnosticsEngine &Diag, FileManager &FileMgr,
                              bool UserFilesAreVolatile)
   : Diag(Diag), FileMgr(FileMgr), UserFilesAreVolatile(UserFilesAreVolatile) {
+  ContentCacheAlloc.setName("SourceManager");
   clearIDTables();
   Diag.setSourceManager(this);
 }
@@ -2131,6 +2132,14 @@ void SourceManager::PrintStats() const {
                << llvm::capacity_in_bytes(LocalSLocEntryTable)
                << " bytes of capacity), "
                << NextLocalOffset << "B of Sloc address space used.\n";
+  unsigned NumLocalExpansions = llvm::count_if(
+      LocalSLocEntryTable,
+      [](const SrcMgr::SLocEntry &Entry) { return Entry.isExpansion(); });
+  llvm::errs() << NumLocalExpansions
+               << " local SLocEntry's are macro expansions ("
+               << NumLocalExpansions * sizeof(SrcMgr::SLocEntry) << " bytes), "
+               << LocalSLocEntryTable.size() - NumLocalExpansions
+               << " are files.\n";
   llvm::errs() << LoadedSLocEntryTable.size()
                << " loaded SLocEntries allocated, "
                << MaxLoadedOffset - CurrentLoadedOffset
@@ -201,29 +201,54 @@ CrossTranslationUnitContext::getLookupName(const NamedDecl *ND) {
   return std::string(DeclUSR.str());
 }
 
-/// Recursively visits the decls of a DeclContext, and returns one with the
-/// given USR.
-template <typename T>
-const T *
-CrossTranslationUnitContext::findDefInDeclContext(const DeclContext *DC,
-                                                  StringRef LookupName) {
+/// Recursively visits the decls of a DeclContext, and adds the definitions of
+/// functions and variables to \p Defs by lookup name. The first definition
+/// found for a name is kept.
+static void collectDefsInDeclContext(
+    const DeclContext *DC, llvm::StringMap<const NamedDecl *> &Defs) {
   assert(DC && "Declaration Context must not be null");
   for (const Decl *D : DC->decls()) {
     const auto *SubDC = dyn_cast<DeclContext>(D);
     if (SubDC)
-      if (const auto *ND = findDefInDeclContext<T>(SubDC, LookupName))
-        return ND;
-
-    const auto *ND = dyn_cast<T>(D);
-    const T *ResultDecl;
-    if (!ND || !hasBodyOrInit(ND, ResultDecl))
-      continue;
-    llvm::Optional<std::string> ResultLookupName = getLookupName(ResultDecl);
-    if (!ResultLookupName || *ResultLookupName != LookupName)
+      collectDefsInDeclContext(SubDC, Defs);
+
+    const NamedDecl *ResultDecl = nullptr;
+    if (const auto *FD = dyn_cast<FunctionDecl>(D)) {
+      const FunctionDecl *DefD;
+      if (hasBodyOrInit(FD, DefD))
+        ResultDecl = DefD;
+    } else if (const auto *VD = dyn_cast<VarDecl>(D)) {
+      const VarDecl *DefD;
+      if (hasBodyOrInit(VD, DefD))
+        ResultDecl = DefD;
+    }
+    if (!ResultDecl)
       continue;
-    return ResultDecl;
+    llvm::Optional<std::string> ResultLookupName =
+        CrossTranslationUnitContext::getLookupName(ResultDecl);
+    if (ResultLookupName)
+      Defs.try_emplace(*ResultLookupName, ResultDecl);
   }
-  return nullptr;
+}
+
+const CrossTranslationUnitContext::DefinitionMapTy &
+CrossTranslationUnitContext::getDefinitionsInUnit(ASTUnit *Unit) {
+  TranslationUnitDecl *TU = Unit->getASTContext().getTranslationUnitDecl();
+  auto Inserted = UnitDefinitions.try_emplace(TU);
+  if (Inserted.second)
+    collectDefsInDeclContext(TU, Inserted.first->second);
+  return Inserted.first->second;
+}
+
+/// Returns the definition in \p Unit with the given USR.
+template <typename T>
+const T *CrossTranslationUnitContext::findDefInUnit(ASTUnit *Unit,
+                                                    StringRef LookupName) {
+  const DefinitionMapTy &Defs = getDefinitionsInUnit(Unit);
+  auto It = Defs.find(LookupName);
+  if (It == Defs.end())
+    return nullptr;
+  return dyn_cast<T>(It->second);
 }
 
 template <typename T>
@@ -294,8 +319,7 @@ llvm::Expected<const T *> CrossTranslationUnitContext::getCrossTUDefinitionImpl(
         index_error_code::lang_dialect_mismatch);
   }
 
-  TranslationUnitDecl *TU = Unit->getASTContext().getTranslationUnitDecl();
-  if (const T *ResultDecl = findDefInDeclContext<T>(TU, *LookupName))
+  if (const T *ResultDecl = findDefInUnit<T>(Unit, *LookupName))
     return importDefinition(ResultDecl, Unit);
   return llvm::make_error<IndexError>(index_error_code::failed_import);
 }
@@ -3578,6 +3578,23 @@ void Driver::BuildJobs(Compilation &C) const {
                        /*TargetDeviceOffloadKind*/ Action::OFK_None);
   }
 
+  // The -cc1 commands normally exit without freeing their memory, which is
+  // released with the process. When several of them run in the driver process,
+  // they free it instead, so that the memory of all the translation units
+  // does not pile up.
+  if (llvm::count_if(C.getJobs(),
+                     [](const Command &J) { return J.InProcess; }) > 1) {
+    for (Command &J : C.getJobs()) {
+      if (!J.InProcess)
+        continue;
+      llvm::opt::ArgStringList Args = J.getArguments();
+      llvm::erase_if(Args, [](const char *A) {
+        return StringRef(A) == "-disable-free";
+      });
+      J.replaceArguments(std::move(Args));
+    }
+  }
+
   // If the user passed -Qunused-arguments or there were errors, don't warn
   // about any unused arguments.
   if (Diags.hasErrorOccurred() ||
@@ -3615,8 +3615,14 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
       CmdArgs.push_back(IsHeaderModulePrecompile
                             ? "-emit-header-module"
                             : "-emit-module-interface");
-    else
+    else {
       CmdArgs.push_back("-emit-pch");
+      // The inline functions of the PCH are emitted once, when the PCH is
+      // compiled to an object file, and only declared by its users.
+      if (Args.hasFlag(options::OPT_fpch_codegen, options::OPT_fno_pch_codegen,
+                       false))
+        CmdArgs.push_back("-fmodules-codegen");
+    }
   } else if (isa<VerifyPCHJobAction>(JA)) {
     CmdArgs.push_back("-verify-pch");
   } else {
@@ -4641,6 +4647,8 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   Args.AddLastArg(CmdArgs, options::OPT_ftime_report);
   Args.AddLastArg(CmdArgs, options::OPT_ftime_trace);
   Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_granularity_EQ);
+  Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_summary);
+  Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_templates);
   Args.AddLastArg(CmdArgs, options::OPT_ftrapv);
   Args.AddLastArg(CmdArgs, options::OPT_malign_double);
 
@@ -5535,6 +5543,13 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     // fails, so that the main compilation's fallback to cl.exe runs.
     C.addCommand(std::make_unique<ForceSuccessCommand>(JA, *this, Exec,
                                                         CmdArgs, Inputs));
+  } else if (D.CC1Main && !C.isForDiagnostics() &&
+             Args.hasFlag(options::OPT_fintegrated_cc1,
+                          options::OPT_fno_integrated_cc1, false)) {
+    // The crash reproducers are always compiled in a new process, so that
+    // they run in the same conditions as the user's compiler.
+    C.addCommand(
+        std::make_unique<CC1Command>(JA, *this, Exec, CmdArgs, Inputs));
   } else {
     C.addCommand(std::make_unique<Command>(JA, *this, Exec, CmdArgs, Inputs));
   }
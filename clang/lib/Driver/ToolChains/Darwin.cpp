@@ -1117,6 +1117,18 @@ void Darwin::addProfileRTLibs(const ArgList &Args,
   AddLinkRuntimeLib(Args, CmdArgs, "profile",
                     RuntimeLinkOptions(RLO_AlwaysLink | RLO_FirstLink));
 
+  // Page-align the counter and data sections, so that continuous mode can
+  // mmap() the profile file directly over the counters. The data section must
+  // be aligned too for the counters' section to end on a page boundary.
+  if (!needsGCovInstrumentation(Args)) {
+    for (const char *Section : {"__llvm_prf_cnts", "__llvm_prf_data"}) {
+      CmdArgs.push_back("-sectalign");
+      CmdArgs.push_back("__DATA");
+      CmdArgs.push_back(Section);
+      CmdArgs.push_back("0x4000");
+    }
+  }
+
   // If we have a symbol export directive and we're linking in the profile
   // runtime, automatically export symbols necessary to implement some of the
   // runtime's functionality.
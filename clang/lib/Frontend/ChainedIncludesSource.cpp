@@ -7,7 +7,9 @@
 //===----------------------------------------------------------------------===//
 //
 //  This file defines the ChainedIncludesSource class, which converts headers
-//  to chained PCHs in memory, mainly used for testing.
+//  to chained PCHs in memory, mainly used for testing. The PCHs can also be
+//  cached on disk, so that only the layers of the chain starting at the first
+//  header whose inputs changed are regenerated.
 //
 //===----------------------------------------------------------------------===//
 
@@ -21,7 +23,13 @@
 #include "clang/Sema/MultiplexExternalSemaSource.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/ASTWriter.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
 
@@ -109,6 +117,82 @@ createASTReader(CompilerInstance &CI, StringRef pchFile,
   return nullptr;
 }
 
+/// Writes the concatenation of \p Contents to \p Path through a temporary file,
+/// so that the other compilations sharing the cache never read a partially
+/// written file. Errors are ignored, as the cache is only an optimization.
+static void writeCacheFile(StringRef Path, ArrayRef<StringRef> Contents) {
+  Expected<llvm::sys::fs::TempFile> Temp = llvm::sys::fs::TempFile::create(
+      Path + "-%%%%%%.tmp",
+      llvm::sys::fs::owner_read | llvm::sys::fs::owner_write);
+  if (!Temp) {
+    llvm::consumeError(Temp.takeError());
+    return;
+  }
+
+  llvm::raw_fd_ostream OS(Temp->FD, /*ShouldClose=*/false);
+  for (StringRef Part : Contents)
+    OS << Part;
+  OS.flush();
+  if (OS.has_error()) {
+    OS.clear_error();
+    llvm::consumeError(Temp->discard());
+    return;
+  }
+  if (llvm::Error E = Temp->keep(Path))
+    llvm::consumeError(std::move(E));
+}
+
+/// Writes the layer built by \p Clang to \p Path. The file starts with the
+/// length of the list of the input files of the layer, and that list, with
+/// their size and modification time. The PCH follows. Both are in one file so
+/// that a compilation sharing the cache never sees the inputs of one version
+/// of the layer with the PCH of another.
+static void writeCachedLayer(CompilerInstance &Clang, StringRef Path,
+                             StringRef PCH) {
+  std::string Inputs;
+  llvm::raw_string_ostream OS(Inputs);
+  SourceManager &SM = Clang.getSourceManager();
+  for (auto I = SM.fileinfo_begin(), E = SM.fileinfo_end(); I != E; ++I)
+    OS << I->first->getSize() << ' ' << I->first->getModificationTime() << ' '
+       << I->first->getName() << '\n';
+  OS.flush();
+  std::string Length = llvm::utostr(Inputs.size()) + "\n";
+  writeCacheFile(Path, {Length, Inputs, PCH});
+}
+
+/// \returns The PCH cached in \p Path if none of its input files changed, and
+/// null otherwise.
+static std::unique_ptr<llvm::MemoryBuffer>
+readCachedLayer(llvm::vfs::FileSystem &FS, StringRef Path) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> File =
+      llvm::MemoryBuffer::getFile(Path);
+  if (!File)
+    return nullptr;
+
+  StringRef Length, Rest;
+  std::tie(Length, Rest) = (*File)->getBuffer().split('\n');
+  size_t InputsSize;
+  if (Length.getAsInteger(10, InputsSize) || InputsSize > Rest.size())
+    return nullptr;
+
+  SmallVector<StringRef, 64> Lines;
+  Rest.take_front(InputsSize).split(Lines, '\n', /*MaxSplit=*/-1,
+                                    /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    StringRef Size, ModTime, Name;
+    std::tie(Size, Line) = Line.split(' ');
+    std::tie(ModTime, Name) = Line.split(' ');
+    llvm::ErrorOr<llvm::vfs::Status> Status = FS.status(Name);
+    if (!Status || Size != llvm::utostr(Status->getSize()) ||
+        ModTime != llvm::itostr(llvm::sys::toTimeT(
+                       Status->getLastModificationTime())))
+      return nullptr;
+  }
+  // Copy the PCH, as the AST reader needs its own aligned buffer.
+  return llvm::MemoryBuffer::getMemBufferCopy(Rest.drop_front(InputsSize),
+                                              Path);
+}
+
 IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
     CompilerInstance &CI, IntrusiveRefCntPtr<ExternalSemaSource> &Reader) {
 
@@ -121,8 +205,46 @@ IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
   SmallVector<std::unique_ptr<llvm::MemoryBuffer>, 4> SerialBufs;
   SmallVector<std::string, 4> serialBufNames;
 
+  // The layers are cached by the compiler invocation and the headers they
+  // chain. Once a layer is regenerated, the layers after it are regenerated
+  // too, as they were built on top of the previous version.
+  StringRef CachePath = CI.getPreprocessorOpts().ChainedIncludesCachePath;
+  bool ReuseCachedLayers = !CachePath.empty();
+  if (ReuseCachedLayers)
+    llvm::sys::fs::create_directories(CachePath);
+  llvm::MD5 LayerHash;
+  LayerHash.update(CI.getInvocation().getModuleHash());
+
   for (unsigned i = 0, e = includes.size(); i != e; ++i) {
     bool firstInclude = (i == 0);
+    std::string pchName;
+    if (!firstInclude) {
+      pchName = includes[i-1];
+      llvm::raw_string_ostream os(pchName);
+      os << ".pch" << i-1;
+      serialBufNames.push_back(os.str());
+    }
+
+    SmallString<128> LayerPath;
+    if (!CachePath.empty()) {
+      LayerHash.update(includes[i]);
+      LayerHash.update(StringRef("\0", 1));
+      llvm::MD5 Hash = LayerHash;
+      llvm::MD5::MD5Result Result;
+      Hash.final(Result);
+      LayerPath = CachePath;
+      llvm::sys::path::append(LayerPath, llvm::sys::path::filename(includes[i]) +
+                                             "-" + Result.digest() + ".pch");
+    }
+    if (ReuseCachedLayers) {
+      if (std::unique_ptr<llvm::MemoryBuffer> CachedLayer =
+              readCachedLayer(CI.getVirtualFileSystem(), LayerPath)) {
+        SerialBufs.push_back(std::move(CachedLayer));
+        continue;
+      }
+      ReuseCachedLayers = false;
+    }
+
     std::unique_ptr<CompilerInvocation> CInvok;
     CInvok.reset(new CompilerInvocation(CI.getInvocation()));
 
@@ -177,10 +299,6 @@ IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
       // allocating new ones.
       for (auto &SB : SerialBufs)
         Bufs.push_back(llvm::MemoryBuffer::getMemBuffer(SB->getBuffer()));
-      std::string pchName = includes[i-1];
-      llvm::raw_string_ostream os(pchName);
-      os << ".pch" << i-1;
-      serialBufNames.push_back(os.str());
 
       IntrusiveRefCntPtr<ASTReader> Reader;
       Reader = createASTReader(
@@ -202,6 +320,9 @@ IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
     SerialBufs.push_back(llvm::MemoryBuffer::getMemBufferCopy(
         StringRef(serialAST.data(), serialAST.size())));
     serialAST.clear();
+    if (!LayerPath.empty() && !Clang->getDiagnostics().hasErrorOccurred()) {
+      writeCachedLayer(*Clang, LayerPath, SerialBufs.back()->getBuffer());
+    }
     CIs.push_back(std::move(Clang));
   }
 
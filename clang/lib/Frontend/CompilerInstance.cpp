@@ -383,6 +383,8 @@ void CompilerInstance::createPreprocessor(TranslationUnitKind TUKind) {
                                       getSourceManager(), *HeaderInfo, *this,
                                       /*IdentifierInfoLookup=*/nullptr,
                                       /*OwnsHeaderSearch=*/true, TUKind);
+  if (getFrontendOpts().UseHugePageArenas)
+    PP->getPreprocessorAllocator().enableHugePages();
   getTarget().adjust(getLangOpts());
   PP->Initialize(getTarget(), getAuxTarget());
 
@@ -476,6 +478,8 @@ void CompilerInstance::createASTContext() {
   auto *Context = new ASTContext(getLangOpts(), PP.getSourceManager(),
                                  PP.getIdentifierTable(), PP.getSelectorTable(),
                                  PP.getBuiltinInfo());
+  if (getFrontendOpts().UseHugePageArenas)
+    Context->getAllocator().enableHugePages();
   Context->InitBuiltinTypes(getTarget(), getAuxTarget());
   setASTContext(Context);
 }
@@ -935,6 +939,8 @@ bool CompilerInstance::ExecuteAction(FrontendAction &Act) {
 
   if (getFrontendOpts().ShowStats || !getFrontendOpts().StatsFile.empty())
     llvm::EnableStatistics(false);
+  if (getFrontendOpts().ShowStats)
+    llvm::enableAllocatorStats();
 
   for (const FrontendInputFile &FIF : getFrontendOpts().Inputs) {
     // Reset the ID tables if we are reusing the SourceManager and parsing
@@ -983,6 +989,8 @@ bool CompilerInstance::ExecuteAction(FrontendAction &Act) {
       getFileManager().PrintStats();
       OS << '\n';
     }
+    llvm::printAllocatorStats(OS);
+    OS << '\n';
     llvm::PrintStatistics(OS);
   }
   StringRef StatsFile = getFrontendOpts().StatsFile;
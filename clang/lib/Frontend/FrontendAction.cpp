@@ -17,12 +17,14 @@
 #include "clang/Frontend/FrontendPluginRegistry.h"
 #include "clang/Frontend/LayoutOverrideSource.h"
 #include "clang/Frontend/MultiplexConsumer.h"
+#include "clang/Frontend/TemplateInstantiationProfiler.h"
 #include "clang/Frontend/Utils.h"
 #include "clang/Lex/HeaderSearch.h"
 #include "clang/Lex/LiteralSupport.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Parse/ParseAST.h"
+#include "clang/Sema/TemplateInstCallback.h"
 #include "clang/Serialization/ASTDeserializationListener.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/GlobalModuleIndex.h"
@@ -1039,6 +1041,22 @@ void ASTFrontendAction::ExecuteAction() {
   if (!CI.hasSema())
     CI.createSema(getTranslationUnitKind(), CompletionConsumer);
 
+  // Write the template instantiation profile next to the output file, like the
+  // time trace, or next to the input file if there is no output file.
+  if (CI.getFrontendOpts().TimeTraceTemplates) {
+    SmallString<128> Path(CI.getFrontendOpts().OutputFile);
+    if (Path == "-")
+      Path.clear();
+    if (!Path.empty())
+      llvm::sys::path::replace_extension(Path, "templates.json");
+    if (std::unique_ptr<raw_pwrite_stream> OS = CI.createOutputFile(
+            Path, /*Binary=*/false, /*RemoveFileOnSignal=*/false,
+            getCurrentFile(), /*Extension=*/"templates.json",
+            /*UseTemporary=*/false))
+      CI.getSema().TemplateInstCallbacks.push_back(
+          createTemplateInstantiationProfiler(std::move(OS)));
+  }
+
   ParseAST(CI.getSema(), CI.getFrontendOpts().ShowStats,
            CI.getFrontendOpts().SkipFunctionBodies);
 }
@@ -0,0 +1,204 @@
+//===--- TemplateInstantiationProfiler.cpp - Profile instantiations -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/TemplateInstantiationProfiler.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Sema/TemplateInstCallback.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <tuple>
+
+using namespace clang;
+
+/// Returns the template that is instantiated to produce \p D, or \p D itself
+/// when it is not an instantiation.
+static const NamedDecl *getInstantiatedTemplate(const NamedDecl *D) {
+  const NamedDecl *Template = D;
+  if (const auto *FD = dyn_cast<FunctionDecl>(D)) {
+    if (FunctionTemplateDecl *Primary = FD->getPrimaryTemplate())
+      Template = Primary;
+    else if (FunctionDecl *Pattern = FD->getTemplateInstantiationPattern())
+      Template = Pattern;
+  } else if (const auto *RD = dyn_cast<CXXRecordDecl>(D)) {
+    if (const CXXRecordDecl *Pattern = RD->getTemplateInstantiationPattern()) {
+      Template = Pattern;
+      if (ClassTemplateDecl *Described = Pattern->getDescribedClassTemplate())
+        Template = Described;
+    }
+  } else if (const auto *VD = dyn_cast<VarDecl>(D)) {
+    if (VarDecl *Pattern = VD->getTemplateInstantiationPattern()) {
+      Template = Pattern;
+      if (VarTemplateDecl *Described = Pattern->getDescribedVarTemplate())
+        Template = Described;
+    }
+  } else if (const auto *ED = dyn_cast<EnumDecl>(D)) {
+    if (EnumDecl *Pattern = ED->getTemplateInstantiationPattern())
+      Template = Pattern;
+  }
+  return cast<NamedDecl>(Template->getCanonicalDecl());
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class TemplateInstantiationProfiler : public TemplateInstantiationCallback {
+  using CodeSynthesisContext = Sema::CodeSynthesisContext;
+
+  /// The aggregated cost of the instantiations of one template.
+  struct Cost {
+    unsigned Count = 0;
+    Clock::duration Total = Clock::duration::zero();
+    Clock::duration Self = Clock::duration::zero();
+    size_t SelfBytes = 0;
+  };
+
+  /// An instantiation in progress.
+  struct ActiveInstantiation {
+    const NamedDecl *Template;
+    Clock::time_point Start;
+    size_t StartBytes;
+    /// The cost of the instantiations nested in this one.
+    Clock::duration Nested = Clock::duration::zero();
+    size_t NestedBytes = 0;
+  };
+
+public:
+  explicit TemplateInstantiationProfiler(
+      std::unique_ptr<llvm::raw_pwrite_stream> OS)
+      : OS(std::move(OS)) {}
+
+  void initialize(const Sema &) override {}
+
+  void finalize(const Sema &TheSema) override {
+    writeReport(TheSema);
+    OS->flush();
+  }
+
+  void atTemplateBegin(const Sema &TheSema,
+                       const CodeSynthesisContext &Inst) override {
+    const NamedDecl *Template = getProfiledTemplate(Inst);
+    if (!Template)
+      return;
+    ActiveInstantiation Active{Template, Clock::now(), getASTBytes(TheSema)};
+    Stack.push_back(Active);
+    ++ActiveCounts[Template];
+  }
+
+  void atTemplateEnd(const Sema &TheSema,
+                     const CodeSynthesisContext &Inst) override {
+    const NamedDecl *Template = getProfiledTemplate(Inst);
+    if (!Template || Stack.empty())
+      return;
+    assert(Stack.back().Template == Template &&
+           "mismatched template instantiation events");
+    ActiveInstantiation Active = Stack.pop_back_val();
+    Clock::duration Duration = Clock::now() - Active.Start;
+    size_t Bytes = getASTBytes(TheSema) - Active.StartBytes;
+
+    Cost &C = Costs[Template];
+    ++C.Count;
+    C.Self += Duration - Active.Nested;
+    C.SelfBytes += Bytes - Active.NestedBytes;
+    // Only count the outermost of recursive instantiations in the total, which
+    // already includes the time of the nested ones.
+    if (--ActiveCounts[Template] == 0)
+      C.Total += Duration;
+
+    if (!Stack.empty()) {
+      Stack.back().Nested += Duration;
+      Stack.back().NestedBytes += Bytes;
+    }
+  }
+
+private:
+  /// Returns the template whose cost \p Inst is counted in, or null if \p Inst
+  /// is not profiled.
+  ///
+  /// Only the instantiations of definitions are profiled: the other synthesis
+  /// contexts, like template argument deduction, are accounted to the
+  /// instantiation they happen in.
+  static const NamedDecl *
+  getProfiledTemplate(const CodeSynthesisContext &Inst) {
+    if (Inst.Kind != CodeSynthesisContext::TemplateInstantiation)
+      return nullptr;
+    const auto *D = dyn_cast_or_null<NamedDecl>(Inst.Entity);
+    return D ? getInstantiatedTemplate(D) : nullptr;
+  }
+
+  static size_t getASTBytes(const Sema &TheSema) {
+    return TheSema.getASTContext().getASTAllocatedBytes();
+  }
+
+  void writeReport(const Sema &TheSema) {
+    struct Entry {
+      std::string Name;
+      std::string Location;
+      const Cost *C;
+    };
+    std::vector<Entry> Entries;
+    Entries.reserve(Costs.size());
+    for (const auto &TemplateAndCost : Costs) {
+      const NamedDecl *Template = TemplateAndCost.first;
+      Entry E;
+      E.Name = Template->getQualifiedNameAsString();
+      PresumedLoc Loc =
+          TheSema.getSourceManager().getPresumedLoc(Template->getLocation());
+      if (Loc.isValid())
+        E.Location = std::string(Loc.getFilename()) + ":" +
+                     std::to_string(Loc.getLine()) + ":" +
+                     std::to_string(Loc.getColumn());
+      E.C = &TemplateAndCost.second;
+      Entries.push_back(std::move(E));
+    }
+    // Report the most expensive templates first.
+    llvm::sort(Entries, [](const Entry &LHS, const Entry &RHS) {
+      return std::tie(RHS.C->Self, LHS.Name, LHS.Location) <
+             std::tie(LHS.C->Self, RHS.Name, RHS.Location);
+    });
+
+    auto toMicroseconds = [](Clock::duration D) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(D).count();
+    };
+    llvm::json::OStream J(*OS);
+    J.objectBegin();
+    J.attributeArray("templates", [&] {
+      for (const Entry &E : Entries) {
+        J.object([&] {
+          J.attribute("name", E.Name);
+          J.attribute("location", E.Location);
+          J.attribute("count", int64_t(E.C->Count));
+          J.attribute("total us", toMicroseconds(E.C->Total));
+          J.attribute("self us", toMicroseconds(E.C->Self));
+          J.attribute("self bytes", int64_t(E.C->SelfBytes));
+        });
+      }
+    });
+    J.objectEnd();
+  }
+
+  std::unique_ptr<llvm::raw_pwrite_stream> OS;
+  llvm::DenseMap<const NamedDecl *, Cost> Costs;
+  llvm::SmallVector<ActiveInstantiation, 16> Stack;
+  /// The number of instantiations of each template in the stack.
+  llvm::DenseMap<const NamedDecl *, unsigned> ActiveCounts;
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<TemplateInstantiationCallback>
+clang::createTemplateInstantiationProfiler(
+    std::unique_ptr<llvm::raw_pwrite_stream> OS) {
+  return std::make_unique<TemplateInstantiationProfiler>(std::move(OS));
+}
@@ -23,6 +23,8 @@
 #include "clang/Lex/LexDiagnostic.h"
 #include "clang/Lex/ModuleMap.h"
 #include "clang/Lex/Preprocessor.h"
+#include "clang/Lex/SharedHeaderCache.h"
+#include "clang/Lex/SkippedConditionalBlockCache.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/SmallString.h"
@@ -110,7 +112,12 @@ const HeaderMap *HeaderSearch::CreateHeaderMap(const FileEntry *FE) {
         return HeaderMaps[i].second.get();
   }
 
-  if (std::unique_ptr<HeaderMap> HM = HeaderMap::Create(FE, FileMgr)) {
+  std::shared_ptr<const HeaderMap> HM;
+  if (HSOpts->SharedHeaders)
+    HM = HSOpts->SharedHeaders->getHeaderMap(FE, FileMgr);
+  else
+    HM = HeaderMap::Create(FE, FileMgr);
+  if (HM) {
     HeaderMaps.emplace_back(FE, std::move(HM));
     return HeaderMaps.back().second.get();
   }
@@ -1298,6 +1305,18 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
       ++NumMultiIncludeFileOptzn;
       return false;
     }
+  } else if (!FileInfo.NumIncludes && !M) {
+    // A header that another translation unit found to be guarded need not
+    // be entered if its guard is already defined, as when it is included
+    // again.
+    if (SharedHeaderCache *Shared = getSharedControllingMacros(PP, File)) {
+      std::string Macro =
+          Shared->getControllingMacro(File, SharedHeadersLangOptsHash);
+      if (!Macro.empty() && PP.isMacroDefined(Macro)) {
+        ++NumMultiIncludeFileOptzn;
+        return false;
+      }
+    }
   }
 
   // Increment the number of times this file has been included.
@@ -1306,6 +1325,29 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
   return true;
 }
 
+SharedHeaderCache *
+HeaderSearch::getSharedControllingMacros(Preprocessor &PP,
+                                         const FileEntry *File) {
+  // Macros are not visible across modules the way the multiple-include
+  // optimization expects, and overridden files are not what others lexed.
+  SharedHeaderCache *Shared = HSOpts->SharedHeaders.get();
+  if (!Shared || PP.getLangOpts().Modules ||
+      PP.getSourceManager().isFileOverridden(File))
+    return nullptr;
+  if (!SharedHeadersLangOptsHash)
+    SharedHeadersLangOptsHash =
+        SkippedConditionalBlockCache::hashLangOptions(PP.getLangOpts());
+  return Shared;
+}
+
+void HeaderSearch::ShareFileControllingMacro(
+    Preprocessor &PP, const FileEntry *File,
+    const IdentifierInfo *ControllingMacro) {
+  if (SharedHeaderCache *Shared = getSharedControllingMacros(PP, File))
+    Shared->setControllingMacro(File, SharedHeadersLangOptsHash,
+                                ControllingMacro->getName());
+}
+
 size_t HeaderSearch::getTotalMemory() const {
   return SearchDirs.capacity()
     + llvm::capacity_in_bytes(FileInfo)
@@ -47,6 +47,10 @@
 #include <tuple>
 #include <utility>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace clang;
 
 //===----------------------------------------------------------------------===//
@@ -1625,9 +1629,79 @@ bool Lexer::tryConsumeIdentifierUTF8Char(const char *&CurPtr) {
   return true;
 }
 
+// The following helpers skip the common characters of a token 16 at a time.
+// They only look at whole 16-byte chunks before BufferEnd, and return where
+// the caller's scalar loop should pick up: at the first character that is not
+// skipped, or at most 16 bytes before BufferEnd.
+
+/// Skips [_A-Za-z0-9]* from CurPtr.
+static const char *fastSkipIdentifierBody(const char *CurPtr,
+                                          const char *BufferEnd) {
+#ifdef __SSE2__
+  while (BufferEnd - CurPtr >= 16) {
+    __m128i Chars = _mm_loadu_si128((const __m128i *)CurPtr);
+    // Bytes with the high bit set are negative, and never in range.
+    __m128i Lower = _mm_or_si128(Chars, _mm_set1_epi8(0x20));
+    __m128i IsAlpha =
+        _mm_and_si128(_mm_cmpgt_epi8(Lower, _mm_set1_epi8('a' - 1)),
+                      _mm_cmplt_epi8(Lower, _mm_set1_epi8('z' + 1)));
+    __m128i IsDigit =
+        _mm_and_si128(_mm_cmpgt_epi8(Chars, _mm_set1_epi8('0' - 1)),
+                      _mm_cmplt_epi8(Chars, _mm_set1_epi8('9' + 1)));
+    __m128i IsUnderscore = _mm_cmpeq_epi8(Chars, _mm_set1_epi8('_'));
+    unsigned Mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(IsAlpha, IsDigit), IsUnderscore));
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countTrailingOnes(Mask);
+    CurPtr += 16;
+  }
+#endif
+  return CurPtr;
+}
+
+/// Skips horizontal whitespace from CurPtr.
+static const char *fastSkipHorizontalWhitespace(const char *CurPtr,
+                                                const char *BufferEnd) {
+#ifdef __SSE2__
+  while (BufferEnd - CurPtr >= 16) {
+    __m128i Chars = _mm_loadu_si128((const __m128i *)CurPtr);
+    __m128i IsSpace =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8(' ')),
+                                  _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\t'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8('\f')),
+                                  _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\v'))));
+    unsigned Mask = _mm_movemask_epi8(IsSpace);
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countTrailingOnes(Mask);
+    CurPtr += 16;
+  }
+#endif
+  return CurPtr;
+}
+
+/// Skips to the first of C1, C2 or a nul character from CurPtr.
+static const char *fastFindFirstOf(const char *CurPtr, const char *BufferEnd,
+                                   char C1, char C2) {
+#ifdef __SSE2__
+  while (BufferEnd - CurPtr >= 16) {
+    __m128i Chars = _mm_loadu_si128((const __m128i *)CurPtr);
+    __m128i Found =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8(C1)),
+                                  _mm_cmpeq_epi8(Chars, _mm_set1_epi8(C2))),
+                     _mm_cmpeq_epi8(Chars, _mm_setzero_si128()));
+    unsigned Mask = _mm_movemask_epi8(Found);
+    if (Mask != 0)
+      return CurPtr + llvm::countTrailingZeros(Mask);
+    CurPtr += 16;
+  }
+#endif
+  return CurPtr;
+}
+
 bool Lexer::LexIdentifier(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched [_A-Za-z$]
   unsigned Size;
+  CurPtr = fastSkipIdentifierBody(CurPtr, BufferEnd);
   unsigned char C = *CurPtr++;
   while (isIdentifierBody(C))
     C = *CurPtr++;
@@ -2004,6 +2078,7 @@ bool Lexer::LexRawStringLiteral(Token &Result, const char *CurPtr,
   CurPtr += PrefixLen + 1; // skip over prefix and '('
 
   while (true) {
+    CurPtr = fastFindFirstOf(CurPtr, BufferEnd, ')', ')');
     char C = *CurPtr++;
 
     if (C == ')') {
@@ -2183,6 +2258,10 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr,
   // Skip consecutive spaces efficiently.
   while (true) {
     // Skip horizontal whitespace very aggressively.
+    if (isHorizontalWhitespace(Char)) {
+      CurPtr = fastSkipHorizontalWhitespace(CurPtr, BufferEnd);
+      Char = *CurPtr;
+    }
     while (isHorizontalWhitespace(Char))
       Char = *++CurPtr;
 
@@ -2252,6 +2331,7 @@ bool Lexer::SkipLineComment(Token &Result, const char *CurPtr,
   // character that ends the line comment.
   char C;
   while (true) {
+    CurPtr = fastFindFirstOf(CurPtr, BufferEnd, '\n', '\r');
     C = *CurPtr;
     // Skip over characters in the fast loop.
     while (C != 0 &&                // Potentially EOF.
@@ -2459,9 +2539,7 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
+#if !defined(__SSE2__) && __ALTIVEC__
 #include <altivec.h>
 #undef bool
 #endif
@@ -2637,6 +2715,138 @@ bool Lexer::SkipBlockComment(Token &Result, const char *CurPtr,
   return false;
 }
 
+//===----------------------------------------------------------------------===//
+// Excluded Block Skipping
+//===----------------------------------------------------------------------===//
+
+/// Returns true if C makes the text around it too unusual for the fast scan of
+/// excluded lines, which then leaves that text to the lexer.
+static bool isUnusualExcludedChar(char C, bool Trigraphs) {
+  return C == 0 || C == '\\' || (C == '?' && Trigraphs);
+}
+
+/// Returns a pointer past the closing Quote of the literal whose body starts
+/// at CurPtr, or null if the literal is not closed on this line, or has an
+/// escape.
+static const char *skipExcludedLiteral(const char *CurPtr, char Quote,
+                                       bool Trigraphs) {
+  while (true) {
+    char C = *CurPtr++;
+    if (C == Quote)
+      return CurPtr;
+    if (C == '\n' || C == '\r' || isUnusualExcludedChar(C, Trigraphs))
+      return nullptr;
+  }
+}
+
+/// Returns a pointer to the newline that ends the line comment whose body
+/// starts at CurPtr, or null if the line may be continued.
+static const char *skipExcludedLineComment(const char *CurPtr,
+                                           bool Trigraphs) {
+  for (; *CurPtr != '\n' && *CurPtr != '\r'; ++CurPtr)
+    if (isUnusualExcludedChar(*CurPtr, Trigraphs))
+      return nullptr;
+  return CurPtr;
+}
+
+/// Returns a pointer past the end of the block comment whose body starts at
+/// CurPtr, or null if its end may be spelled with an escaped newline.
+static const char *skipExcludedBlockComment(const char *CurPtr,
+                                            bool Trigraphs) {
+  while (true) {
+    char C = *CurPtr++;
+    if (C == '*' && *CurPtr == '/')
+      return CurPtr + 1;
+    if (isUnusualExcludedChar(C, Trigraphs))
+      return nullptr;
+  }
+}
+
+void Lexer::skipExcludedLines() {
+  assert(LexingRawMode && "Not skipping an excluded block?");
+  // The tokens that lead up to the last stop are left to the lexer.
+  if (BufferPtr < ExcludedLinesStop)
+    return;
+
+  const bool Trigraphs = LangOpts.Trigraphs;
+  const char *CurPtr = BufferPtr;
+  // The start of the last line that was reached outside of a comment, and
+  // whether a token comes before it.
+  const char *LineStart = nullptr;
+  bool SawToken = false;
+  bool SawTokenBeforeLine = false;
+  while (true) {
+    const char *TokStart = CurPtr;
+    char C = *CurPtr++;
+    if (C == '\n' || C == '\r') {
+      if (C == '\r' && *CurPtr == '\n')
+        ++CurPtr;
+      LineStart = CurPtr;
+      SawTokenBeforeLine = SawToken;
+      continue;
+    }
+    if (isHorizontalWhitespace(C))
+      continue;
+
+    const char *End = nullptr;
+    switch (C) {
+    case '/':
+      if (*CurPtr == '*') {
+        End = skipExcludedBlockComment(CurPtr + 1, Trigraphs);
+      } else if (*CurPtr == '/' && LangOpts.LineComment) {
+        End = skipExcludedLineComment(CurPtr + 1, Trigraphs);
+      } else {
+        End = CurPtr;
+        SawToken = true;
+      }
+      break;
+    case '"':
+      // Raw string literals can span lines.
+      if (TokStart == BufferStart || TokStart[-1] != 'R')
+        End = skipExcludedLiteral(CurPtr, C, Trigraphs);
+      SawToken = true;
+      break;
+    case '\'':
+      // Leave digit separators and prefixed character literals to the lexer.
+      if (TokStart == BufferStart || !isIdentifierBody(TokStart[-1]))
+        End = skipExcludedLiteral(CurPtr, C, Trigraphs);
+      SawToken = true;
+      break;
+    case '#':
+      break;
+    case '%':
+      // '%:' is a digraph for '#'.
+      if (*CurPtr != ':' || !LangOpts.Digraphs)
+        End = CurPtr;
+      SawToken = true;
+      break;
+    case 26: // An end of file with MicrosoftExt.
+      break;
+    default:
+      if (!isUnusualExcludedChar(C, Trigraphs) ||
+          (C == '?' && *CurPtr != '?'))
+        End = CurPtr;
+      SawToken = true;
+      break;
+    }
+    if (!End) {
+      ExcludedLinesStop = TokStart;
+      break;
+    }
+    CurPtr = End;
+  }
+
+  if (!LineStart)
+    return;
+  BufferPtr = LineStart;
+  IsAtStartOfLine = true;
+  IsAtPhysicalStartOfLine = true;
+  HasLeadingSpace = false;
+  // Note the tokens for the multiple-include optimization, as Lex() would.
+  if (SawTokenBeforeLine)
+    MIOpt.ReadToken();
+}
+
 //===----------------------------------------------------------------------===//
 // Primary Lexing Entry Points
 //===----------------------------------------------------------------------===//
@@ -30,6 +30,7 @@
 #include "clang/Lex/Pragma.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Lex/PreprocessorOptions.h"
+#include "clang/Lex/SkippedConditionalBlockCache.h"
 #include "clang/Lex/Token.h"
 #include "clang/Lex/VariadicMacroSupport.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -392,11 +393,45 @@ void Preprocessor::SkipExcludedConditionalBlock(SourceLocation HashTokenLoc,
     CurPPLexer->pushConditionalLevel(IfTokenLoc, /*isSkipping*/ false,
                                      FoundNonSkipPortion, FoundElse);
 
+  // Jump over the blocks that the cache knows the end of, and remember the
+  // others, unless the buffer may not be what is in the file.
+  SkippedConditionalBlockCache *BlockCache =
+      PPOpts->SkippedConditionalBlocks.get();
+  const FileEntry *BlockFile = nullptr;
+  if (BlockCache) {
+    BlockFile = SourceMgr.getFileEntryForID(CurPPLexer->getFileID());
+    if (BlockFile && (SourceMgr.isFileOverridden(BlockFile) ||
+                      CurLexer->getBuffer().size() !=
+                          (uint64_t)BlockFile->getSize()))
+      BlockFile = nullptr;
+    if (BlockFile && !SkippedBlocksLangOptsHash)
+      SkippedBlocksLangOptsHash =
+          SkippedConditionalBlockCache::hashLangOptions(LangOpts);
+  }
+  SmallVector<SkippedConditionalBlockCache::Block, 8> NewBlocks;
+  unsigned BlockBegin = BlockFile ? CurLexer->getCurrentBufferOffset() : 0;
+  bool AtBlockBegin = BlockFile;
+  bool JumpedOverBlock = false;
+
   // Enter raw mode to disable identifier lookup (and thus macro expansion),
   // disabling warnings, etc.
   CurPPLexer->LexingRawMode = true;
   Token Tok;
   while (true) {
+    if (AtBlockBegin) {
+      AtBlockBegin = false;
+      Optional<unsigned> BlockEnd = BlockCache->getBlockEnd(
+          BlockFile, SkippedBlocksLangOptsHash, BlockBegin);
+      if (BlockEnd && *BlockEnd > BlockBegin &&
+          *BlockEnd < CurLexer->getBuffer().size()) {
+        CurLexer->SetByteOffset(*BlockEnd, /*StartOfLine=*/true);
+        CurPPLexer->MIOpt.ReadToken();
+        JumpedOverBlock = true;
+      }
+    }
+
+    // Only the lines that may hold a directive need to be lexed.
+    CurLexer->skipExcludedLines();
     CurLexer->Lex(Tok);
 
     if (Tok.is(tok::code_completion)) {
@@ -421,6 +456,8 @@ void Preprocessor::SkipExcludedConditionalBlock(SourceLocation HashTokenLoc,
     if (Tok.isNot(tok::hash) || !Tok.isAtStartOfLine())
       continue;
 
+    unsigned HashOffset = CurLexer->getCurrentBufferOffset() - Tok.getLength();
+
     // We just parsed a # character at the start of a line, so we're in
     // directive mode.  Tell the lexer this so any newlines we see will be
     // converted into an EOD token (this terminates the macro).
@@ -476,6 +513,17 @@ void Preprocessor::SkipExcludedConditionalBlock(SourceLocation HashTokenLoc,
       Directive = StringRef(DirectiveBuf, IdLen);
     }
 
+    // A conditional directive ends the block that is being skipped, and
+    // starts another one after its line if the skipping goes on.
+    bool IsConditional = Directive == "if" || Directive == "ifdef" ||
+                         Directive == "ifndef" || Directive == "elif" ||
+                         Directive == "else" || Directive == "endif";
+    if (BlockFile && IsConditional) {
+      if (!JumpedOverBlock)
+        NewBlocks.emplace_back(BlockBegin, HashOffset);
+      JumpedOverBlock = false;
+    }
+
     if (Directive.startswith("if")) {
       StringRef Sub = Directive.substr(2);
       if (Sub.empty() ||   // "if"
@@ -574,8 +622,16 @@ void Preprocessor::SkipExcludedConditionalBlock(SourceLocation HashTokenLoc,
     CurPPLexer->ParsingPreprocessorDirective = false;
     // Restore comment saving mode.
     if (CurLexer) CurLexer->resetExtendedTokenMode();
+
+    if (BlockFile && IsConditional) {
+      BlockBegin = CurLexer->getCurrentBufferOffset();
+      AtBlockBegin = true;
+    }
   }
 
+  if (!NewBlocks.empty())
+    BlockCache->addBlocks(BlockFile, SkippedBlocksLangOptsHash, NewBlocks);
+
   // Finally, if we are out of the conditional (saw an #endif or ran off the end
   // of the file, just stop skipping and return to lexing whatever came after
   // the #if block.
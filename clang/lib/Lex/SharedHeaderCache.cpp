@@ -0,0 +1,60 @@
+//===--- SharedHeaderCache.cpp - Header facts shared by TUs ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the SharedHeaderCache class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/SharedHeaderCache.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Lex/HeaderMap.h"
+
+using namespace clang;
+
+template <typename T>
+bool SharedHeaderCache::Versioned<T>::matches(const FileEntry *File) const {
+  return Size == File->getSize() && ModTime == File->getModificationTime();
+}
+
+template <typename T>
+void SharedHeaderCache::Versioned<T>::reset(const FileEntry *File) {
+  Size = File->getSize();
+  ModTime = File->getModificationTime();
+  Value = T();
+}
+
+std::shared_ptr<const HeaderMap>
+SharedHeaderCache::getHeaderMap(const FileEntry *File, FileManager &FileMgr) {
+  // Header maps are few, so reading them under the lock does not matter, and
+  // saves reading one twice.
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto &HM = HeaderMaps[File->getUniqueID()];
+  if (!HM.matches(File)) {
+    HM.reset(File);
+    HM.Value = HeaderMap::Create(File, FileMgr);
+  }
+  return HM.Value;
+}
+
+std::string SharedHeaderCache::getControllingMacro(const FileEntry *File,
+                                                   unsigned LangOptsHash) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto It = ControllingMacros.find({File->getUniqueID(), LangOptsHash});
+  if (It == ControllingMacros.end() || !It->second.matches(File))
+    return std::string();
+  return It->second.Value;
+}
+
+void SharedHeaderCache::setControllingMacro(const FileEntry *File,
+                                            unsigned LangOptsHash,
+                                            StringRef Macro) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto &CM = ControllingMacros[{File->getUniqueID(), LangOptsHash}];
+  CM.reset(File);
+  CM.Value = Macro;
+}
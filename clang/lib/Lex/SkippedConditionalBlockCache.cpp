@@ -0,0 +1,59 @@
+//===--- SkippedConditionalBlockCache.cpp - Excluded block bounds ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the SkippedConditionalBlockCache class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/SkippedConditionalBlockCache.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/LangOptions.h"
+#include "llvm/ADT/Hashing.h"
+
+using namespace clang;
+
+unsigned
+SkippedConditionalBlockCache::hashLangOptions(const LangOptions &LangOpts) {
+  // Few options matter to the lexer, but keeping track of which is not worth
+  // the risk of sharing blocks that do not match.
+  llvm::hash_code Code = 0;
+#define LANGOPT(Name, Bits, Default, Description)                              \
+  Code = llvm::hash_combine(Code, LangOpts.Name);
+#define ENUM_LANGOPT(Name, Type, Bits, Default, Description)                   \
+  Code = llvm::hash_combine(Code, static_cast<unsigned>(LangOpts.get##Name()));
+#include "clang/Basic/LangOptions.def"
+  return Code;
+}
+
+Optional<unsigned> SkippedConditionalBlockCache::getBlockEnd(
+    const FileEntry *File, unsigned LangOptsHash, unsigned Begin) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto It = Files.find({File->getUniqueID(), LangOptsHash});
+  if (It == Files.end() || It->second.Size != File->getSize() ||
+      It->second.ModTime != File->getModificationTime())
+    return None;
+  auto End = It->second.Ends.find(Begin);
+  if (End == It->second.Ends.end())
+    return None;
+  return End->second;
+}
+
+void SkippedConditionalBlockCache::addBlocks(const FileEntry *File,
+                                             unsigned LangOptsHash,
+                                             ArrayRef<Block> Blocks) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  FileBlocks &FB = Files[{File->getUniqueID(), LangOptsHash}];
+  if (FB.Size != File->getSize() ||
+      FB.ModTime != File->getModificationTime()) {
+    FB.Size = File->getSize();
+    FB.ModTime = File->getModificationTime();
+    FB.Ends.clear();
+  }
+  for (const Block &B : Blocks)
+    FB.Ends.insert(B);
+}
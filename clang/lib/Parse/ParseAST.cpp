@@ -15,6 +15,8 @@
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/ExternalASTSource.h"
 #include "clang/AST/Stmt.h"
+#include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/PreprocessingRecord.h"
 #include "clang/Parse/ParseDiagnostic.h"
 #include "clang/Parse/Parser.h"
 #include "clang/Sema/CodeCompleteConsumer.h"
@@ -88,6 +90,44 @@ void PrettyStackTraceParserEntry::print(raw_ostream &OS) const {
 
 }  // namespace
 
+/// Print how much memory the data structures of the translation unit use, by
+/// allocator.
+static void PrintMemoryStats(Sema &S) {
+  ASTContext &Context = S.getASTContext();
+  SourceManager &SM = S.getSourceManager();
+  Preprocessor &PP = S.getPreprocessor();
+
+  size_t Total = 0;
+  auto Print = [&](StringRef Name, size_t Bytes) {
+    llvm::errs() << "  " << Bytes << " bytes for " << Name << "\n";
+    Total += Bytes;
+  };
+
+  llvm::errs() << "\n*** Memory Usage:\n";
+  Print("AST nodes and types", Context.getASTAllocatedMemory());
+  llvm::errs() << "    (" << Context.getASTAllocatedBytes()
+               << " bytes allocated)\n";
+  Print("AST side tables", Context.getSideTableAllocatedMemory());
+  Print("identifiers", Context.Idents.getAllocator().getTotalMemory());
+  Print("selectors", Context.Selectors.getTotalMemory());
+  Print("source manager content cache", SM.getContentCacheSize());
+  Print("source manager tables", SM.getDataStructureSizes());
+  SourceManager::MemoryBufferSizes Buffers = SM.getMemoryBufferSizes();
+  Print("source buffers (malloc)", Buffers.malloc_bytes);
+  Print("source buffers (mmap)", Buffers.mmap_bytes);
+  if (ExternalASTSource *Source = Context.getExternalSource()) {
+    ExternalASTSource::MemoryBufferSizes Sizes =
+        Source->getMemoryBufferSizes();
+    Print("external AST source buffers (malloc)", Sizes.malloc_bytes);
+    Print("external AST source buffers (mmap)", Sizes.mmap_bytes);
+  }
+  Print("preprocessor", PP.getTotalMemory());
+  if (PreprocessingRecord *Record = PP.getPreprocessingRecord())
+    Print("preprocessing record", Record->getTotalMemory());
+  Print("header search", PP.getHeaderSearchInfo().getTotalMemory());
+  llvm::errs() << "Total bytes = " << Total << "\n";
+}
+
 //===----------------------------------------------------------------------===//
 // Public interface to the file
 //===----------------------------------------------------------------------===//
@@ -185,5 +225,6 @@ void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
     Decl::PrintStats();
     Stmt::PrintStats();
     Consumer->PrintStats();
+    PrintMemoryStats(S);
   }
 }
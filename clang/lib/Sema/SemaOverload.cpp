@@ -5986,6 +5986,65 @@ static bool IsAcceptableNonMemberOperatorCandidate(ASTContext &Context,
   return false;
 }
 
+/// Determine whether the argument \p Arg obviously cannot be converted to a
+/// parameter of type \p ParamType: an object of a complete class type without
+/// conversion functions cannot initialize a parameter of scalar type, or a
+/// reference to one.
+static bool isObviouslyNotConvertible(Sema &S, Expr *Arg, QualType ParamType) {
+  if (isa<InitListExpr>(Arg) || ParamType->isDependentType() ||
+      !ParamType.getNonReferenceType()->isScalarType())
+    return false;
+
+  // Don't look at the classes that are not defined yet, which would require a
+  // template instantiation.
+  CXXRecordDecl *Record = Arg->getType()->getAsCXXRecordDecl();
+  if (!Record || Arg->getType()->isDependentType())
+    return false;
+  Record = Record->getDefinition();
+  if (!Record || Record->isBeingDefined())
+    return false;
+  auto Conversions = Record->getVisibleConversionFunctions();
+  return Conversions.begin() == Conversions.end();
+}
+
+/// Compute first the conversion sequences of the arguments in \p Args that
+/// obviously cannot be converted to their parameter in \p ParamTypes, storing
+/// them in \p Conversions from index \p ConvOffset on. This lets overload
+/// resolution reject the candidates with such an argument without computing
+/// the conversion sequences of the arguments that precede it, which may
+/// involve looking for user-defined conversions. The sequences that are
+/// skipped are computed if the candidate is diagnosed.
+///
+/// \returns true if one of the conversions is bad.
+static bool prefilterArgumentConversions(Sema &S, ArrayRef<Expr *> Args,
+                                         ArrayRef<QualType> ParamTypes,
+                                         ConversionSequenceList Conversions,
+                                         unsigned ConvOffset,
+                                         bool SuppressUserConversions,
+                                         bool AllowExplicit = false) {
+  if (!S.getLangOpts().CPlusPlus)
+    return false;
+
+  for (unsigned I = 0, N = std::min(ParamTypes.size(), Args.size()); I != N;
+       ++I) {
+    ImplicitConversionSequence &Conversion = Conversions[ConvOffset + I];
+    if (Conversion.isInitialized() ||
+        !isObviouslyNotConvertible(S, Args[I], ParamTypes[I]))
+      continue;
+    Conversion = TryCopyInitialization(S, Args[I], ParamTypes[I],
+                                       SuppressUserConversions,
+                                       /*InOverloadResolution=*/true,
+                                       /*AllowObjCWritebackConversion=*/
+                                       S.getLangOpts().ObjCAutoRefCount,
+                                       AllowExplicit);
+    if (Conversion.isBad()) {
+      ++S.NumPrefilteredOverloadCandidates;
+      return true;
+    }
+  }
+  return false;
+}
+
 /// AddOverloadCandidate - Adds the given function to the set of
 /// candidate functions, using the given function call arguments.  If
 /// @p SuppressUserConversions, then don't allow user-defined
@@ -6152,6 +6211,15 @@ void Sema::AddOverloadCandidate(
         return;
       }
 
+  if (prefilterArgumentConversions(*this, Args, Proto->getParamTypes(),
+                                   Candidate.Conversions, /*ConvOffset=*/0,
+                                   SuppressUserConversions,
+                                   AllowExplicitConversions)) {
+    Candidate.Viable = false;
+    Candidate.FailureKind = ovl_fail_bad_conversion;
+    return;
+  }
+
   // Determine the implicit conversion sequences for each of the
   // arguments.
   for (unsigned ArgIdx = 0; ArgIdx < Args.size(); ++ArgIdx) {
@@ -6661,6 +6729,14 @@ Sema::AddMethodCandidate(CXXMethodDecl *Method, DeclAccessPair FoundDecl,
         return;
       }
 
+  if (prefilterArgumentConversions(*this, Args, Proto->getParamTypes(),
+                                   Candidate.Conversions, /*ConvOffset=*/1,
+                                   SuppressUserConversions)) {
+    Candidate.Viable = false;
+    Candidate.FailureKind = ovl_fail_bad_conversion;
+    return;
+  }
+
   // Determine the implicit conversion sequences for each of the
   // arguments.
   for (unsigned ArgIdx = 0; ArgIdx < Args.size(); ++ArgIdx) {
@@ -6874,10 +6950,16 @@ bool Sema::CheckNonDependentConversions(
       return true;
   }
 
+  if (prefilterArgumentConversions(*this, Args, ParamTypes, Conversions,
+                                   ThisConversions, SuppressUserConversions,
+                                   AllowExplicit))
+    return true;
+
   for (unsigned I = 0, N = std::min(ParamTypes.size(), Args.size()); I != N;
        ++I) {
     QualType ParamType = ParamTypes[I];
-    if (!ParamType->isDependentType()) {
+    if (!ParamType->isDependentType() &&
+        !Conversions[ThisConversions + I].isInitialized()) {
       Conversions[ThisConversions + I]
         = TryCopyInitialization(*this, Args[I], ParamType,
                                 SuppressUserConversions,
@@ -8074,20 +8074,18 @@ void ASTReader::StartTranslationUnit(ASTConsumer *Consumer) {
 void ASTReader::PrintStats() {
   std::fprintf(stderr, "*** AST File Statistics:\n");
 
-  unsigned NumTypesLoaded
-    = TypesLoaded.size() - std::count(TypesLoaded.begin(), TypesLoaded.end(),
-                                      QualType());
-  unsigned NumDeclsLoaded
-    = DeclsLoaded.size() - std::count(DeclsLoaded.begin(), DeclsLoaded.end(),
-                                      (Decl *)nullptr);
-  unsigned NumIdentifiersLoaded
-    = IdentifiersLoaded.size() - std::count(IdentifiersLoaded.begin(),
-                                            IdentifiersLoaded.end(),
-                                            (IdentifierInfo *)nullptr);
-  unsigned NumMacrosLoaded
-    = MacrosLoaded.size() - std::count(MacrosLoaded.begin(),
-                                       MacrosLoaded.end(),
-                                       (MacroInfo *)nullptr);
+  unsigned NumTypesLoaded =
+      llvm::count_if(TypesLoaded.materialized(),
+                     [](const QualType &T) { return !T.isNull(); });
+  unsigned NumDeclsLoaded =
+      llvm::count_if(DeclsLoaded.materialized(),
+                     [](const Decl *D) { return D != nullptr; });
+  unsigned NumIdentifiersLoaded =
+      llvm::count_if(IdentifiersLoaded.materialized(),
+                     [](const IdentifierInfo *II) { return II != nullptr; });
+  unsigned NumMacrosLoaded =
+      llvm::count_if(MacrosLoaded.materialized(),
+                     [](const MacroInfo *MI) { return MI != nullptr; });
   unsigned NumSelectorsLoaded
     = SelectorsLoaded.size() - std::count(SelectorsLoaded.begin(),
                                           SelectorsLoaded.end(),
@@ -7,6 +7,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/AllTUsExecution.h"
+#include "clang/Lex/SharedHeaderCache.h"
+#include "clang/Lex/SkippedConditionalBlockCache.h"
 #include "clang/Tooling/ToolExecutorPluginRegistry.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/VirtualFileSystem.h"
@@ -112,6 +114,15 @@ llvm::Error AllTUsToolExecutor::execute(
 
   auto &Action = Actions.front();
 
+  // Translation units share most of their headers, and files don't change
+  // during the run, so let all threads share one cache of file system
+  // lookups.
+  IntrusiveRefCntPtr<llvm::vfs::CachingFileSystemCache> FSCache(
+      new llvm::vfs::CachingFileSystemCache());
+  // Likewise for what the preprocessors learn about the headers.
+  auto SkippedBlocks = std::make_shared<SkippedConditionalBlockCache>();
+  auto SharedHeaders = std::make_shared<SharedHeaderCache>();
+
   {
     llvm::ThreadPool Pool(ThreadCount == 0 ? llvm::hardware_concurrency()
                                            : ThreadCount);
@@ -122,10 +133,13 @@ llvm::Error AllTUsToolExecutor::execute(
                 "] Processing file " + Path);
             // Each thread gets an indepent copy of a VFS to allow different
             // concurrent working directories.
-            IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS =
-                llvm::vfs::createPhysicalFileSystem().release();
+            IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS(
+                new llvm::vfs::CachingFileSystem(
+                    llvm::vfs::createPhysicalFileSystem().release(), FSCache));
             ClangTool Tool(Compilations, {Path},
                            std::make_shared<PCHContainerOperations>(), FS);
+            Tool.setSkippedConditionalBlocks(SkippedBlocks);
+            Tool.setSharedHeaders(SharedHeaders);
             Tool.appendArgumentsAdjuster(Action.second);
             Tool.appendArgumentsAdjuster(getDefaultArgumentsAdjusters());
             for (const auto &FileAndContent : OverlayFiles)
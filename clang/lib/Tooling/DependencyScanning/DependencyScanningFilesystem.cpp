@@ -15,8 +15,34 @@ using namespace clang;
 using namespace tooling;
 using namespace dependencies;
 
+CachedFileSystemEntry CachedFileSystemEntry::createMinimizedEntry(
+    const llvm::vfs::Status &Stat,
+    llvm::SmallString<1024> &&MinimizedFileContents) {
+  CachedFileSystemEntry Result;
+  size_t Size = MinimizedFileContents.size();
+  Result.MaybeStat = llvm::vfs::Status(Stat.getName(), Stat.getUniqueID(),
+                                       Stat.getLastModificationTime(),
+                                       Stat.getUser(), Stat.getGroup(), Size,
+                                       Stat.getType(), Stat.getPermissions());
+  // The contents produced by the minimizer, or read from the disk cache, must
+  // be null terminated.
+  assert(MinimizedFileContents.data()[MinimizedFileContents.size()] == '\0' &&
+         "not null terminated contents");
+  // Even though there's an implicit null terminator in the minimized contents,
+  // we want to temporarily make it explicit. This will ensure that the
+  // std::move will preserve it even if it needs to do a copy if the
+  // SmallString still has the small capacity.
+  MinimizedFileContents.push_back('\0');
+  Result.Contents = std::move(MinimizedFileContents);
+  // Now make the null terminator implicit again, so that Clang's lexer can find
+  // it right where the buffer ends.
+  Result.Contents.pop_back();
+  return Result;
+}
+
 CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
-    StringRef Filename, llvm::vfs::FileSystem &FS, bool Minimize) {
+    StringRef Filename, llvm::vfs::FileSystem &FS, bool Minimize,
+    const MinimizedSourceDiskCache *DiskCache) {
   // Load the file and its content from the file system.
   llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> MaybeFile =
       FS.openFileForRead(Filename);
@@ -26,13 +52,28 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
   if (!Stat)
     return Stat.getError();
 
+  // The disk cache is shared by the scans of different working directories,
+  // so it is keyed by the absolute path.
+  SmallString<256> AbsoluteFilename(Filename);
+  if (!Minimize || FS.makeAbsolute(AbsoluteFilename))
+    DiskCache = nullptr;
+
+  llvm::SmallString<1024> MinimizedFileContents;
+  // Reuse the minimized contents of a file that did not change since an
+  // earlier scan, without reading the file.
+  if (DiskCache &&
+      DiskCache->lookup(AbsoluteFilename, *Stat, MinimizedFileContents)) {
+    MinimizedFileContents.push_back('\0');
+    MinimizedFileContents.pop_back();
+    return createMinimizedEntry(*Stat, std::move(MinimizedFileContents));
+  }
+
   llvm::vfs::File &F = **MaybeFile;
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> MaybeBuffer =
       F.getBuffer(Stat->getName());
   if (!MaybeBuffer)
     return MaybeBuffer.getError();
 
-  llvm::SmallString<1024> MinimizedFileContents;
   // Minimize the file down to directives that might affect the dependencies.
   const auto &Buffer = *MaybeBuffer;
   SmallVector<minimize_source_to_dependency_directives::Token, 64> Tokens;
@@ -51,25 +92,9 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
     return Result;
   }
 
-  CachedFileSystemEntry Result;
-  size_t Size = MinimizedFileContents.size();
-  Result.MaybeStat = llvm::vfs::Status(Stat->getName(), Stat->getUniqueID(),
-                                       Stat->getLastModificationTime(),
-                                       Stat->getUser(), Stat->getGroup(), Size,
-                                       Stat->getType(), Stat->getPermissions());
-  // The contents produced by the minimizer must be null terminated.
-  assert(MinimizedFileContents.data()[MinimizedFileContents.size()] == '\0' &&
-         "not null terminated contents");
-  // Even though there's an implicit null terminator in the minimized contents,
-  // we want to temporarily make it explicit. This will ensure that the
-  // std::move will preserve it even if it needs to do a copy if the
-  // SmallString still has the small capacity.
-  MinimizedFileContents.push_back('\0');
-  Result.Contents = std::move(MinimizedFileContents);
-  // Now make the null terminator implicit again, so that Clang's lexer can find
-  // it right where the buffer ends.
-  Result.Contents.pop_back();
-  return Result;
+  if (DiskCache)
+    DiskCache->store(AbsoluteFilename, *Stat, MinimizedFileContents);
+  return createMinimizedEntry(*Stat, std::move(MinimizedFileContents));
 }
 
 CachedFileSystemEntry
@@ -81,7 +106,7 @@ CachedFileSystemEntry::createDirectoryEntry(llvm::vfs::Status &&Stat) {
 }
 
 DependencyScanningFilesystemSharedCache::
-    DependencyScanningFilesystemSharedCache() {
+    DependencyScanningFilesystemSharedCache(StringRef DiskCachePath) {
   // This heuristic was chosen using a empirical testing on a
   // reasonably high core machine (iMacPro 18 cores / 36 threads). The cache
   // sharding gives a performance edge by reducing the lock contention.
@@ -89,6 +114,8 @@ DependencyScanningFilesystemSharedCache::
   // the different cost of lock contention on different OSes.
   NumShards = std::max(2u, llvm::hardware_concurrency() / 4);
   CacheShards = std::make_unique<CacheShard[]>(NumShards);
+  if (!DiskCachePath.empty())
+    DiskCache = std::make_unique<MinimizedSourceDiskCache>(DiskCachePath);
 }
 
 /// Returns a cache entry for the corresponding key.
@@ -103,6 +130,17 @@ DependencyScanningFilesystemSharedCache::get(StringRef Key) {
   return It.first->getValue();
 }
 
+void DependencyScanningFilesystemSharedCache::invalidate(StringRef Key) {
+  CacheShard &Shard = CacheShards[llvm::hash_value(Key) % NumShards];
+  std::unique_lock<std::mutex> LockGuard(Shard.CacheLock);
+  auto It = Shard.Cache.find(Key);
+  if (It == Shard.Cache.end())
+    return;
+  std::unique_lock<std::mutex> ValueLockGuard(It->getValue().ValueLock);
+  It->getValue().Value = CachedFileSystemEntry();
+  ++Generation;
+}
+
 llvm::ErrorOr<llvm::vfs::Status>
 DependencyScanningWorkerFilesystem::status(const Twine &Path) {
   SmallString<256> OwnedFilename;
@@ -133,7 +171,7 @@ DependencyScanningWorkerFilesystem::status(const Twine &Path) {
             std::move(*MaybeStatus));
       else
         CacheEntry = CachedFileSystemEntry::createFileEntry(
-            Filename, FS, !KeepOriginalSource);
+            Filename, FS, !KeepOriginalSource, SharedCache.getDiskCache());
     }
 
     Result = &CacheEntry;
@@ -206,7 +244,8 @@ DependencyScanningWorkerFilesystem::openFileForRead(const Twine &Path) {
 
     if (!CacheEntry.isValid()) {
       CacheEntry = CachedFileSystemEntry::createFileEntry(
-          Filename, getUnderlyingFS(), !KeepOriginalSource);
+          Filename, getUnderlyingFS(), !KeepOriginalSource,
+          SharedCache.getDiskCache());
     }
 
     Result = &CacheEntry;
@@ -25,17 +25,21 @@ namespace {
 class DependencyPrinter : public DependencyFileGenerator {
 public:
   DependencyPrinter(std::unique_ptr<DependencyOutputOptions> Opts,
-                    std::string &S)
-      : DependencyFileGenerator(*Opts), Opts(std::move(Opts)), S(S) {}
+                    std::string &S, std::vector<std::string> *Dependencies)
+      : DependencyFileGenerator(*Opts), Opts(std::move(Opts)), S(S),
+        Dependencies(Dependencies) {}
 
   void finishedMainFile(DiagnosticsEngine &Diags) override {
     llvm::raw_string_ostream OS(S);
     outputDependencyFile(OS);
+    if (Dependencies)
+      Dependencies->assign(getDependencies().begin(), getDependencies().end());
   }
 
 private:
   std::unique_ptr<DependencyOutputOptions> Opts;
   std::string &S;
+  std::vector<std::string> *Dependencies;
 };
 
 /// A proxy file system that doesn't call `chdir` when changing the working
@@ -66,10 +70,11 @@ class DependencyScanningAction : public tooling::ToolAction {
 public:
   DependencyScanningAction(
       StringRef WorkingDirectory, std::string &DependencyFileContents,
+      std::vector<std::string> *Dependencies,
       llvm::IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> DepFS)
       : WorkingDirectory(WorkingDirectory),
         DependencyFileContents(DependencyFileContents),
-        DepFS(std::move(DepFS)) {}
+        Dependencies(Dependencies), DepFS(std::move(DepFS)) {}
 
   bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
                      FileManager *FileMgr,
@@ -122,7 +127,7 @@ public:
     if (Opts->Targets.empty())
       Opts->Targets = {"clang-scan-deps dependency"};
     Compiler.addDependencyCollector(std::make_shared<DependencyPrinter>(
-        std::move(Opts), DependencyFileContents));
+        std::move(Opts), DependencyFileContents, Dependencies));
 
     auto Action = std::make_unique<PreprocessOnlyAction>();
     const bool Result = Compiler.ExecuteAction(*Action);
@@ -135,6 +140,8 @@ private:
   StringRef WorkingDirectory;
   /// The dependency file will be written to this string.
   std::string &DependencyFileContents;
+  /// The names of the dependencies will be stored here, if not null.
+  std::vector<std::string> *Dependencies;
   llvm::IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> DepFS;
 };
 
@@ -150,10 +157,9 @@ DependencyScanningWorker::DependencyScanningWorker(
                                                    RealFS);
 }
 
-llvm::Expected<std::string>
-DependencyScanningWorker::getDependencyFile(const std::string &Input,
-                                            StringRef WorkingDirectory,
-                                            const CompilationDatabase &CDB) {
+llvm::Expected<std::string> DependencyScanningWorker::getDependencyFile(
+    const std::string &Input, StringRef WorkingDirectory,
+    const CompilationDatabase &CDB, std::vector<std::string> *Dependencies) {
   // Capture the emitted diagnostics and report them to the client
   // in the case of a failure.
   std::string DiagnosticOutput;
@@ -170,7 +176,8 @@ DependencyScanningWorker::getDependencyFile(const std::string &Input,
   Tool.setPrintErrorMessage(false);
   Tool.setDiagnosticConsumer(&DiagPrinter);
   std::string Output;
-  DependencyScanningAction Action(WorkingDirectory, Output, DepFS);
+  DependencyScanningAction Action(WorkingDirectory, Output, Dependencies,
+                                  DepFS);
   if (Tool.run(&Action)) {
     return llvm::make_error<llvm::StringError>(DiagnosticsOS.str(),
                                                llvm::inconvertibleErrorCode());
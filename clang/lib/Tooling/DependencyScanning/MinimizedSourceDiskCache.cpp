@@ -0,0 +1,115 @@
+//===- MinimizedSourceDiskCache.cpp - clang-scan-deps disk cache ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Tooling/DependencyScanning/MinimizedSourceDiskCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+using namespace tooling;
+using namespace dependencies;
+
+/// Returns the string identifying the version of the source file \p Filename
+/// of status \p Stat. The key is written at the start of the entry so that a
+/// collision of the entry names is detected when the entry is read.
+static std::string getEntryKey(StringRef Filename,
+                               const llvm::vfs::Status &Stat) {
+  std::string Key;
+  llvm::raw_string_ostream OS(Key);
+  OS << "minimized-source-v1\n"
+     << Filename << '\0' << Stat.getSize() << '\0'
+     << Stat.getLastModificationTime().time_since_epoch().count() << '\0';
+  return OS.str();
+}
+
+MinimizedSourceDiskCache::MinimizedSourceDiskCache(StringRef Path)
+    : Path(Path) {
+  // A failure is detected when the entries are read or written.
+  llvm::sys::fs::create_directories(Path);
+}
+
+std::string MinimizedSourceDiskCache::getEntryPath(StringRef Key) const {
+  llvm::MD5 Hash;
+  Hash.update(Key);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+
+  // This choice of file name allows the cache to be pruned (see pruneCache()
+  // in include/llvm/Support/CachePruning.h).
+  SmallString<128> EntryPath(Path);
+  llvm::sys::path::append(EntryPath, "llvmcache-" + Result.digest());
+  return EntryPath.str();
+}
+
+bool MinimizedSourceDiskCache::lookup(StringRef Filename,
+                                      const llvm::vfs::Status &Stat,
+                                      SmallVectorImpl<char> &Contents) const {
+  std::string Key = getEntryKey(Filename, Stat);
+  std::string EntryPath = getEntryPath(Key);
+
+  // Update the access time of the entry so that the pruner sees it as
+  // recently used.
+  Expected<llvm::sys::fs::file_t> FDOrErr =
+      llvm::sys::fs::openNativeFileForRead(EntryPath,
+                                           llvm::sys::fs::OF_UpdateAtime);
+  if (!FDOrErr) {
+    llvm::consumeError(FDOrErr.takeError());
+    return false;
+  }
+  // The entry is mapped when it is large enough, and copied out right away so
+  // that the scanner does not keep a file descriptor per cached file.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> MaybeBuffer =
+      llvm::MemoryBuffer::getOpenFile(*FDOrErr, EntryPath, /*FileSize=*/-1,
+                                      /*RequiresNullTerminator=*/false);
+  llvm::sys::fs::closeFile(*FDOrErr);
+  if (!MaybeBuffer)
+    return false;
+
+  StringRef Buffer = (*MaybeBuffer)->getBuffer();
+  if (!Buffer.consume_front(Key))
+    return false;
+  Contents.assign(Buffer.begin(), Buffer.end());
+  return true;
+}
+
+void MinimizedSourceDiskCache::store(StringRef Filename,
+                                     const llvm::vfs::Status &Stat,
+                                     StringRef Contents) const {
+  std::string Key = getEntryKey(Filename, Stat);
+
+  // Write to a temporary file and rename it, so that the other scanners never
+  // see a partially written entry. Errors are ignored, as the cache is only an
+  // optimization.
+  SmallString<128> TempFilenameModel(Path);
+  llvm::sys::path::append(TempFilenameModel, "Minimized-%%%%%%.tmp");
+  Expected<llvm::sys::fs::TempFile> Temp = llvm::sys::fs::TempFile::create(
+      TempFilenameModel,
+      llvm::sys::fs::owner_read | llvm::sys::fs::owner_write);
+  if (!Temp) {
+    llvm::consumeError(Temp.takeError());
+    return;
+  }
+
+  llvm::raw_fd_ostream OS(Temp->FD, /*ShouldClose=*/false);
+  OS << Key << Contents;
+  OS.flush();
+  if (OS.has_error()) {
+    OS.clear_error();
+    llvm::consumeError(Temp->discard());
+    return;
+  }
+
+  // Another scanner may have stored the same entry in the meantime. Its
+  // contents are the same, so failing to replace it is harmless.
+  if (llvm::Error E = Temp->keep(getEntryPath(Key)))
+    llvm::consumeError(std::move(E));
+}
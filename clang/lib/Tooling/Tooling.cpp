@@ -32,6 +32,8 @@
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Lex/HeaderSearchOptions.h"
 #include "clang/Lex/PreprocessorOptions.h"
+#include "clang/Lex/SharedHeaderCache.h"
+#include "clang/Lex/SkippedConditionalBlockCache.h"
 #include "clang/Tooling/ArgumentsAdjusters.h"
 #include "clang/Tooling/CompilationDatabase.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -326,6 +328,10 @@ bool ToolInvocation::run() {
     Invocation->getPreprocessorOpts().addRemappedFile(It.getKey(),
                                                       Input.release());
   }
+  if (SkippedBlocks)
+    Invocation->getPreprocessorOpts().SkippedConditionalBlocks = SkippedBlocks;
+  if (SharedHeaders)
+    Invocation->getHeaderSearchOpts().SharedHeaders = SharedHeaders;
   return runInvocation(BinaryName, Compilation.get(), std::move(Invocation),
                        std::move(PCHContainerOps));
 }
@@ -380,7 +386,9 @@ ClangTool::ClangTool(const CompilationDatabase &Compilations,
       PCHContainerOps(std::move(PCHContainerOps)),
       OverlayFileSystem(new llvm::vfs::OverlayFileSystem(std::move(BaseFS))),
       InMemoryFileSystem(new llvm::vfs::InMemoryFileSystem),
-      Files(new FileManager(FileSystemOptions(), OverlayFileSystem)) {
+      Files(new FileManager(FileSystemOptions(), OverlayFileSystem)),
+      SkippedBlocks(std::make_shared<SkippedConditionalBlockCache>()),
+      SharedHeaders(std::make_shared<SharedHeaderCache>()) {
   OverlayFileSystem->pushOverlay(InMemoryFileSystem);
   appendArgumentsAdjuster(getClangStripOutputAdjuster());
   appendArgumentsAdjuster(getClangSyntaxOnlyAdjuster());
@@ -514,6 +522,8 @@ int ClangTool::run(ToolAction *Action) {
       ToolInvocation Invocation(std::move(CommandLine), Action, Files.get(),
                                 PCHContainerOps);
       Invocation.setDiagnosticConsumer(DiagConsumer);
+      Invocation.setSkippedConditionalBlockCache(SkippedBlocks);
+      Invocation.setSharedHeaderCache(SharedHeaders);
 
       if (!Invocation.run()) {
         // FIXME: Diagnostics should be used instead.
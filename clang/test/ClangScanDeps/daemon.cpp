@@ -0,0 +1,32 @@
+// The second scan of the daemon picks up the header that a.h includes since
+// the first one, and the input that failed for lack of b.h.
+// REQUIRES: shell
+// RUN: rm -rf %t.dir
+// RUN: rm -rf %t.cdb
+// RUN: mkdir -p %t.dir/Inputs
+// RUN: cp %s %t.dir/main.cpp
+// RUN: echo '#include "b.h"' > %t.dir/missing.cpp
+// RUN: echo '' > %t.dir/Inputs/a.h
+// RUN: sed -e "s|DIR|%/t.dir|g" %S/Inputs/daemon_cdb.json > %t.cdb
+// RUN: (echo scan; sleep 2; echo '#include "b.h"' > %t.dir/Inputs/a.h; \
+// RUN:  echo '' > %t.dir/Inputs/b.h; sleep 2; echo scan; echo quit) \
+// RUN:   | clang-scan-deps -compilation-database %t.cdb -j 1 -daemon \
+// RUN:     2> %t.err | FileCheck %s
+// RUN: FileCheck %s --check-prefix=ERR < %t.err
+
+#include "a.h"
+
+// CHECK:      dependency: {{.*}}main.cpp
+// CHECK-NEXT:   {{.*}}Inputs{{/|\\}}a.h
+// CHECK-NEXT: # end of scan
+// CHECK-NEXT: dependency: {{.*}}main.cpp
+// CHECK-NEXT:   {{.*}}Inputs{{/|\\}}a.h
+// CHECK-NEXT:   {{.*}}Inputs{{/|\\}}b.h
+// CHECK-NEXT: dependency: {{.*}}missing.cpp
+// CHECK-NEXT:   {{.*}}Inputs{{/|\\}}b.h
+// CHECK-NEXT: # end of scan
+// CHECK-NOT:  {{.}}
+
+// ERR:     Error while scanning dependencies for {{.*}}missing.cpp:
+// ERR:     'b.h' file not found
+// ERR-NOT: Error while scanning
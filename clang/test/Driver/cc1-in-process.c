@@ -0,0 +1,30 @@
+// RUN: %clang -fintegrated-cc1 -fsyntax-only -### %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=IN-PROCESS
+// IN-PROCESS: (in-process)
+// IN-PROCESS-NEXT: "-cc1"
+// IN-PROCESS-SAME: "-disable-free"
+
+// RUN: %clang -fsyntax-only -### %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=NEW-PROCESS
+// RUN: %clang -fintegrated-cc1 -fno-integrated-cc1 -fsyntax-only -### %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=NEW-PROCESS
+// NEW-PROCESS-NOT: (in-process)
+// NEW-PROCESS: "-cc1"
+
+// The -cc1 commands that share the driver process free their memory.
+// RUN: %clang -fintegrated-cc1 -fsyntax-only -### %s %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=SHARED
+// SHARED: (in-process)
+// SHARED-NOT: "-disable-free"
+// SHARED: (in-process)
+// SHARED-NOT: "-disable-free"
+
+// The commands run in the driver process, and report their errors.
+// RUN: %clang -fintegrated-cc1 -fsyntax-only %s %s
+// RUN: not %clang -fintegrated-cc1 -fsyntax-only -DERROR %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=ERROR
+// ERROR: error: in-process error
+
+#ifdef ERROR
+#error in-process error
+#endif
@@ -0,0 +1,26 @@
+// REQUIRES: shell
+// RUN: %clangxx -S -ftime-trace-summary -o %T/check-time-trace-summary %s
+// RUN: cat %T/check-time-trace-summary.json \
+// RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
+// RUN:   | FileCheck %s
+
+// CHECK: "processName": "clang",
+// CHECK: "scopes": [
+// CHECK: "count": 1,
+// CHECK-NEXT: "max us":
+// CHECK-NEXT: "name": "ExecuteCompiler",
+// CHECK-NEXT: "p50 us":
+// CHECK-NEXT: "p99 us":
+// CHECK-NEXT: "total us":
+// CHECK-NOT: "traceEvents"
+
+template <typename T>
+struct Struct {
+  T Num;
+};
+
+int main() {
+  Struct<int> S;
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+// REQUIRES: shell
+// RUN: %clangxx -S -ftime-trace-templates -o %T/check-time-trace-templates %s
+// RUN: cat %T/check-time-trace-templates.templates.json \
+// RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
+// RUN:   > %t.json
+// RUN: FileCheck --check-prefix=CLASS %s < %t.json
+// RUN: FileCheck --check-prefix=FUNCTION %s < %t.json
+
+// CLASS: "templates": [
+// CLASS: "count": 2,
+// CLASS-NEXT: "location": "{{.*}}check-time-trace-templates.cpp:[[@LINE+12]]:8",
+// CLASS-NEXT: "name": "Struct",
+// CLASS-NEXT: "self bytes":
+// CLASS-NEXT: "self us":
+// CLASS-NEXT: "total us":
+
+// FUNCTION: "templates": [
+// FUNCTION: "count": 1,
+// FUNCTION-NEXT: "location": "{{.*}}check-time-trace-templates.cpp:[[@LINE+9]]:3",
+// FUNCTION-NEXT: "name": "get",
+
+template <typename T>
+struct Struct {
+  T Num;
+};
+
+template <typename T>
+T get(Struct<T> S) { return S.Num; }
+
+int main() {
+  Struct<int> S;
+  Struct<long> L;
+
+  return get(S);
+}
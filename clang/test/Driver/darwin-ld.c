@@ -158,6 +158,12 @@
 // LINK_IOSSIM_PROFILE: libclang_rt.profile_iossim.a
 // LINK_IOSSIM_PROFILE: libclang_rt.ios.a
 
+// RUN: %clang -target x86_64-apple-darwin12 -fprofile-instr-generate -resource-dir=%S/Inputs/resource_dir -### %t.o 2> %t.log
+// RUN: FileCheck -check-prefix=LINK_PROFILE_SECTALIGN %s < %t.log
+// LINK_PROFILE_SECTALIGN: {{ld(.exe)?"}}
+// LINK_PROFILE_SECTALIGN-SAME: "-sectalign" "__DATA" "__llvm_prf_cnts" "0x4000"
+// LINK_PROFILE_SECTALIGN-SAME: "-sectalign" "__DATA" "__llvm_prf_data" "0x4000"
+
 // RUN: %clang -target arm64-apple-tvos8.3 -mtvos-version-min=8.3 -resource-dir=%S/Inputs/resource_dir -### %t.o 2> %t.log
 // RUN: FileCheck -check-prefix=LINK_TVOS_ARM64 %s < %t.log
 // LINK_TVOS_ARM64: {{ld(.exe)?"}}
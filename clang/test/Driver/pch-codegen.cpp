@@ -0,0 +1,16 @@
+// RUN: %clang -x c++-header %s -o %t.pch -fpch-codegen -### 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=CODEGEN
+// CODEGEN: "-emit-pch"
+// CODEGEN-SAME: "-fmodules-codegen"
+
+// RUN: %clang -x c++-header %s -o %t.pch -### 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=NOCODEGEN
+// RUN: %clang -x c++-header %s -o %t.pch -fpch-codegen -fno-pch-codegen \
+// RUN:   -### 2>&1 | FileCheck %s --check-prefix=NOCODEGEN
+// NOCODEGEN: "-emit-pch"
+// NOCODEGEN-NOT: "-fmodules-codegen"
+
+// The flag only affects the compilation of the PCH.
+// RUN: %clang -c %s -o %t.o -fpch-codegen -### 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=COMPILE
+// COMPILE-NOT: "-fmodules-codegen"
@@ -0,0 +1,15 @@
+// RUN: %clang_cc1 -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+#define TWICE(x) ((x) + (x))
+int i = TWICE(1);
+
+// CHECK: *** Memory Usage:
+// CHECK-NEXT: bytes for AST nodes and types
+// CHECK-NEXT: bytes allocated)
+// CHECK-NEXT: bytes for AST side tables
+// CHECK: bytes for source manager tables
+// CHECK: bytes for header search
+// CHECK-NEXT: Total bytes =
+
+// CHECK: *** Source Manager Stats:
+// CHECK: {{[1-9][0-9]*}} local SLocEntry's are macro expansions ({{[0-9]+}} bytes), {{[0-9]+}} are files.
@@ -0,0 +1,9 @@
+inline int foo() { return 1; }
+
+template <typename T> T bar(T t) { return t; }
+
+struct S {
+  int get() { return 2; }
+};
+
+static inline int internal() { return 3; }
@@ -0,0 +1,38 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: echo 'int f1(void);' > %t/h1.h
+// RUN: echo 'int f2(void);' > %t/h2.h
+// RUN: %clang_cc1 -chain-include %t/h1.h -chain-include %t/h2.h \
+// RUN:   -chain-include-cache %t/cache -fsyntax-only -verify %s
+// RUN: ls %t/cache | FileCheck --check-prefix=LAYERS %s
+
+// The cached layers are used, and not written again, when the headers did not
+// change. Date the layers and a stamp in the past to tell the layers written
+// by a later compilation.
+// RUN: touch -m -a -t 200001010000 %t/cache/*
+// RUN: touch -m -a -t 200101010000 %t/stamp
+// RUN: %clang_cc1 -chain-include %t/h1.h -chain-include %t/h2.h \
+// RUN:   -chain-include-cache %t/cache -fsyntax-only -verify %s
+// RUN: find %t/cache -type f -newer %t/stamp | count 0
+
+// Only the layer of the header that changed, and the layers after it, are
+// regenerated.
+// RUN: echo 'int f2(void); int f3(void);' > %t/h2.h
+// RUN: %clang_cc1 -chain-include %t/h1.h -chain-include %t/h2.h \
+// RUN:   -chain-include-cache %t/cache -fsyntax-only -verify -DUSE_F3 %s
+// RUN: find %t/cache -type f -newer %t/stamp | FileCheck --check-prefix=REBUILT %s
+
+// LAYERS: h1.h-{{[0-9a-f]+}}.pch
+// LAYERS-NEXT: h2.h-{{[0-9a-f]+}}.pch
+// LAYERS-NOT: {{.}}
+
+// REBUILT-NOT: h1.h-
+// REBUILT: h2.h-{{[0-9a-f]+}}.pch
+// REBUILT-NOT: h1.h-
+
+// expected-no-diagnostics
+
+int g(void) { return f1() + f2(); }
+
+#ifdef USE_F3
+int h(void) { return f3(); }
+#endif
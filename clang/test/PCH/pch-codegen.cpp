@@ -0,0 +1,41 @@
+// REQUIRES: x86-registered-target
+//
+// With -fmodules-codegen, the inline functions of a PCH are emitted when the
+// PCH itself is compiled, and its users only declare them.
+//
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -fmodules-codegen -x c++-header \
+// RUN:   -emit-pch %S/Inputs/pch-codegen.h -o %t.pch
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm -x ast -o - %t.pch \
+// RUN:   | FileCheck --check-prefix=PCH %s
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm -include-pch %t.pch \
+// RUN:   -o - %s | FileCheck --check-prefix=USE-O0 %s
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm -include-pch %t.pch \
+// RUN:   -O2 -disable-llvm-passes -o - %s \
+// RUN:   | FileCheck --check-prefix=USE-O2 %s
+//
+// Without -fmodules-codegen, the users emit the functions they use.
+//
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -x c++-header \
+// RUN:   -emit-pch %S/Inputs/pch-codegen.h -o %t.nocodegen.pch
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm \
+// RUN:   -include-pch %t.nocodegen.pch -o - %s \
+// RUN:   | FileCheck --check-prefix=NOCODEGEN %s
+
+// PCH-DAG: define weak_odr {{.*}}i32 @_Z3foov()
+// PCH-DAG: define weak_odr {{.*}}i32 @_ZN1S3getEv(
+
+// Function templates are only instantiated by their users.
+// PCH-NOT: @_Z3barIiET_S0_
+
+int use(S &s) { return foo() + s.get() + bar(4) + internal(); }
+
+// USE-O0-DAG: declare {{.*}}i32 @_Z3foov()
+// USE-O0-DAG: declare {{.*}}i32 @_ZN1S3getEv(
+// USE-O0-DAG: define linkonce_odr {{.*}}i32 @_Z3barIiET_S0_(
+// USE-O0-DAG: define internal {{.*}}i32 @_ZL8internalv()
+
+// USE-O2-DAG: define available_externally {{.*}}i32 @_Z3foov()
+// USE-O2-DAG: define available_externally {{.*}}i32 @_ZN1S3getEv(
+
+// NOCODEGEN-DAG: define linkonce_odr {{.*}}i32 @_Z3foov()
+// NOCODEGEN-DAG: define linkonce_odr {{.*}}i32 @_ZN1S3getEv(
@@ -0,0 +1,37 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -fsyntax-only -DSTATS -print-stats %s 2>&1 | FileCheck %s
+
+// Overload candidates with an argument of class type without conversion
+// functions for a parameter of scalar type are rejected before the conversions
+// of their other arguments are computed. The diagnostics are unchanged.
+
+struct A {};
+struct B { B(int); };
+
+void g(B, int);
+void g(A, A);
+
+struct S {
+  void m(int);
+  void m(A);
+};
+
+void valid(S s) {
+  g(A(), A());
+  s.m(A());
+}
+
+// CHECK: 2 overload candidates rejected before full conversion checking.
+
+#ifndef STATS
+void f(B, int); // expected-note {{candidate function not viable: no known conversion from 'A' to 'B' for 1st argument}}
+void f(int, int, int); // expected-note {{candidate function not viable: requires 3 arguments, but 2 were provided}}
+
+template <typename T>
+void h(T, int); // expected-note {{no known conversion from 'A' to 'int' for 2nd argument}}
+
+void invalid() {
+  f(A(), A()); // expected-error {{no matching function for call to 'f'}}
+  h(1, A()); // expected-error {{no matching function for call to 'h'}}
+}
+#endif
@@ -6,16 +6,23 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "clang/DirectoryWatcher/DirectoryWatcher.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningService.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
 #include "clang/Tooling/JSONCompilationDatabase.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Options.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/Threading.h"
+#include <iostream>
 #include <mutex>
 #include <thread>
 
@@ -77,6 +84,290 @@ private:
   SharedStream &Errs;
 };
 
+/// Keeps the dependency scanning service warm between the scans of the
+/// compilation database, and rescans only the inputs for which one of the
+/// files they depend on changed since the previous scan.
+///
+/// The changes are found by watching the directories of the dependencies.
+/// Only changes to the files that were opened by the previous scan of an input
+/// are detected: a header that is added in a directory that is searched before
+/// the directory of the header it shadows does not trigger a rescan.
+class DependencyScanningDaemon {
+public:
+  DependencyScanningDaemon(
+      DependencyScanningService &Service,
+      const tooling::CompilationDatabase &Compilations,
+      const std::vector<std::pair<std::string, std::string>> &Inputs,
+      unsigned NumWorkers)
+      : Service(Service), Compilations(Compilations) {
+    for (const auto &Input : Inputs)
+      States.emplace_back(Input.first, Input.second);
+    for (unsigned I = 0; I < NumWorkers; ++I)
+      Workers.push_back(std::make_unique<DependencyScanningWorker>(Service));
+  }
+
+  /// Rescans the inputs whose dependencies changed and prints out the
+  /// dependencies of every input.
+  ///
+  /// \returns True on error.
+  bool scan(raw_ostream &OS, raw_ostream &Errs);
+
+private:
+  struct InputState {
+    InputState(StringRef Filename, StringRef Directory)
+        : Filename(Filename), Directory(Directory) {}
+
+    std::string Filename;
+    std::string Directory;
+    /// The dependency file, or the diagnostics if the scan failed.
+    std::string Output;
+    bool Failed = false;
+    /// Whether the input must be scanned again.
+    bool Dirty = true;
+    /// The files the input depends on, as opened by the compiler.
+    std::vector<std::string> Dependencies;
+  };
+
+  /// Marks the inputs that depend on the changed files as dirty, and drops
+  /// the changed files from the shared cache.
+  void invalidateChangedFiles();
+
+  /// Scans the dirty inputs in parallel.
+  void scanDirtyInputs();
+
+  /// Records the dependencies of the input \p Index and watches their
+  /// directories.
+  void updateDependencies(unsigned Index,
+                          const std::vector<std::string> &OldDependencies);
+
+  /// \returns The absolute path of the dependency \p Name of \p State.
+  static std::string getAbsolutePath(const InputState &State, StringRef Name);
+
+  /// Starts watching the directory \p Dir.
+  ///
+  /// \returns False if the directory cannot be watched.
+  bool watchDirectory(StringRef Dir);
+
+  DependencyScanningService &Service;
+  const tooling::CompilationDatabase &Compilations;
+  std::vector<InputState> States;
+  std::vector<std::unique_ptr<DependencyScanningWorker>> Workers;
+
+  /// The inputs that depend on each file, by absolute path.
+  llvm::StringMap<llvm::DenseSet<unsigned>> Dependents;
+  /// The names under which each file, by absolute path, was opened and is
+  /// cached in the shared cache.
+  llvm::StringMap<llvm::StringSet<>> CacheKeys;
+  /// The watchers of the directories of the dependencies. A directory that
+  /// cannot be watched is mapped to null.
+  llvm::StringMap<std::unique_ptr<DirectoryWatcher>> Watchers;
+
+  /// Protects the state below, which is updated by the watcher threads.
+  std::mutex Lock;
+  llvm::StringSet<> ChangedFiles;
+  bool WatchersInvalidated = false;
+};
+
+std::string DependencyScanningDaemon::getAbsolutePath(const InputState &State,
+                                                      StringRef Name) {
+  SmallString<256> Path(Name);
+  llvm::sys::fs::make_absolute(State.Directory, Path);
+  llvm::sys::path::remove_dots(Path, /*remove_dot_dot=*/true);
+  return Path.str();
+}
+
+bool DependencyScanningDaemon::watchDirectory(StringRef Dir) {
+  auto It = Watchers.find(Dir);
+  if (It != Watchers.end())
+    return It->second != nullptr;
+
+  // The watcher cannot be created for a directory that does not exist.
+  if (!llvm::sys::fs::is_directory(Dir)) {
+    Watchers[Dir] = nullptr;
+    return false;
+  }
+
+  std::string WatchedDir = Dir;
+  llvm::Expected<std::unique_ptr<DirectoryWatcher>> Watcher =
+      DirectoryWatcher::create(
+          Dir,
+          [this, WatchedDir](ArrayRef<DirectoryWatcher::Event> Events,
+                             bool IsInitial) {
+            std::unique_lock<std::mutex> LockGuard(Lock);
+            for (const DirectoryWatcher::Event &Event : Events) {
+              switch (Event.Kind) {
+              case DirectoryWatcher::Event::EventKind::Removed:
+              case DirectoryWatcher::Event::EventKind::Modified: {
+                // The initial scan reports the files that already exist.
+                if (IsInitial)
+                  break;
+                SmallString<256> Path(WatchedDir);
+                llvm::sys::path::append(Path, Event.Filename);
+                ChangedFiles.insert(Path);
+                break;
+              }
+              case DirectoryWatcher::Event::EventKind::WatchedDirRemoved:
+              case DirectoryWatcher::Event::EventKind::WatcherGotInvalidated:
+                WatchersInvalidated = true;
+                break;
+              }
+            }
+          },
+          /*WaitForInitialSync=*/true);
+  if (!Watcher) {
+    llvm::consumeError(Watcher.takeError());
+    Watchers[Dir] = nullptr;
+    return false;
+  }
+  Watchers[Dir] = std::move(*Watcher);
+  return true;
+}
+
+void DependencyScanningDaemon::invalidateChangedFiles() {
+  llvm::StringSet<> Changed;
+  llvm::StringMap<std::unique_ptr<DirectoryWatcher>> InvalidWatchers;
+  {
+    std::unique_lock<std::mutex> LockGuard(Lock);
+    std::swap(Changed, ChangedFiles);
+    if (WatchersInvalidated) {
+      std::swap(InvalidWatchers, Watchers);
+      WatchersInvalidated = false;
+    }
+  }
+  // Destroy the invalidated watchers without holding the lock, as they may
+  // still deliver events.
+  if (!InvalidWatchers.empty()) {
+    InvalidWatchers.clear();
+    // The changes may have been missed, so everything is scanned again.
+    for (const auto &Entry : CacheKeys)
+      Changed.insert(Entry.getKey());
+    for (InputState &State : States)
+      State.Dirty = true;
+  }
+
+  DependencyScanningFilesystemSharedCache &SharedCache =
+      Service.getSharedCache();
+  for (const auto &Entry : Changed) {
+    StringRef Path = Entry.getKey();
+    // Also drop the file if it was looked up but not found.
+    SharedCache.invalidate(Path);
+    auto Keys = CacheKeys.find(Path);
+    if (Keys != CacheKeys.end())
+      for (const auto &Key : Keys->second)
+        SharedCache.invalidate(Key.getKey());
+    auto Inputs = Dependents.find(Path);
+    if (Inputs != Dependents.end())
+      for (unsigned Index : Inputs->second)
+        States[Index].Dirty = true;
+  }
+}
+
+void DependencyScanningDaemon::updateDependencies(
+    unsigned Index, const std::vector<std::string> &OldDependencies) {
+  InputState &State = States[Index];
+  for (const std::string &Name : OldDependencies) {
+    auto It = Dependents.find(getAbsolutePath(State, Name));
+    if (It != Dependents.end())
+      It->second.erase(Index);
+  }
+
+  for (const std::string &Name : State.Dependencies) {
+    std::string Path = getAbsolutePath(State, Name);
+    Dependents[Path].insert(Index);
+    CacheKeys[Path].insert(Name);
+    // Scan the input every time if its changes cannot be detected.
+    if (!watchDirectory(llvm::sys::path::parent_path(Path)))
+      State.Dirty = true;
+  }
+}
+
+void DependencyScanningDaemon::scanDirtyInputs() {
+  std::vector<unsigned> DirtyInputs;
+  for (unsigned I = 0, E = States.size(); I != E; ++I)
+    if (States[I].Dirty)
+      DirtyInputs.push_back(I);
+
+  std::vector<std::thread> WorkerThreads;
+  std::mutex IndexLock;
+  size_t Next = 0;
+  for (unsigned I = 0; I < Workers.size(); ++I) {
+    auto Worker = [this, I, &IndexLock, &Next, &DirtyInputs]() {
+      while (true) {
+        unsigned Index;
+        // Take the next input.
+        {
+          std::unique_lock<std::mutex> LockGuard(IndexLock);
+          if (Next >= DirtyInputs.size())
+            return;
+          Index = DirtyInputs[Next++];
+        }
+        // Run the worker on it. The inputs are only updated by the thread
+        // that scans them.
+        InputState &State = States[Index];
+        State.Dependencies.clear();
+        auto MaybeFile = Workers[I]->getDependencyFile(
+            State.Filename, State.Directory, Compilations,
+            &State.Dependencies);
+        State.Failed = !MaybeFile;
+        if (MaybeFile) {
+          State.Output = std::move(*MaybeFile);
+          continue;
+        }
+        State.Output.clear();
+        llvm::handleAllErrors(MaybeFile.takeError(),
+                              [&State](llvm::StringError &Err) {
+                                State.Output = Err.getMessage();
+                              });
+      }
+    };
+#if LLVM_ENABLE_THREADS
+    WorkerThreads.emplace_back(std::move(Worker));
+#else
+    // Run the worker without spawning a thread when threads are disabled.
+    Worker();
+#endif
+  }
+  for (auto &W : WorkerThreads)
+    W.join();
+}
+
+bool DependencyScanningDaemon::scan(raw_ostream &OS, raw_ostream &Errs) {
+  invalidateChangedFiles();
+
+  std::vector<std::vector<std::string>> OldDependencies(States.size());
+  for (unsigned I = 0, E = States.size(); I != E; ++I)
+    if (States[I].Dirty)
+      OldDependencies[I] = States[I].Dependencies;
+
+  scanDirtyInputs();
+
+  for (unsigned I = 0, E = States.size(); I != E; ++I) {
+    if (!States[I].Dirty)
+      continue;
+    States[I].Dirty = false;
+    updateDependencies(I, OldDependencies[I]);
+    // A failed input is scanned again, as the failure may be caused by a file
+    // that does not exist yet.
+    if (States[I].Failed)
+      States[I].Dirty = true;
+  }
+
+  bool HadErrors = false;
+  for (const InputState &State : States) {
+    if (State.Failed) {
+      Errs << "Error while scanning dependencies for " << State.Filename
+           << ":\n";
+      Errs << State.Output;
+      HadErrors = true;
+      continue;
+    }
+    OS << State.Output;
+  }
+  OS.flush();
+  Errs.flush();
+  return HadErrors;
+}
+
 llvm::cl::opt<bool> Help("h", llvm::cl::desc("Alias for -help"),
                          llvm::cl::Hidden);
 
@@ -102,6 +393,21 @@ llvm::cl::opt<unsigned>
                               "all concurrent threads)"),
                llvm::cl::init(0));
 
+llvm::cl::opt<bool> Daemon(
+    "daemon",
+    llvm::cl::desc("Keep running, and scan the files each time a 'scan' line "
+                   "is read from the standard input, until 'quit' is read. "
+                   "Only the files whose dependencies changed since the "
+                   "previous scan are scanned again"),
+    llvm::cl::cat(DependencyScannerCategory));
+
+llvm::cl::opt<std::string> MinimizedSourceCache(
+    "minimized-source-cache",
+    llvm::cl::desc("Directory in which the minimized source files are cached "
+                   "across runs. The directory may be shared by concurrent "
+                   "runs and pruned like the ThinLTO cache"),
+    llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<std::string>
     CompilationDB("compilation-database",
                   llvm::cl::desc("Compilation database"), llvm::cl::Required,
@@ -153,13 +459,34 @@ int main(int argc, const char **argv) {
   // Print out the dependency results to STDOUT by default.
   SharedStream DependencyOS(llvm::outs());
 
-  DependencyScanningService Service(ScanMode);
+  DependencyScanningService Service(ScanMode, MinimizedSourceCache);
 #if LLVM_ENABLE_THREADS
   unsigned NumWorkers =
       NumThreads == 0 ? llvm::hardware_concurrency() : NumThreads;
 #else
   unsigned NumWorkers = 1;
 #endif
+
+  if (Daemon) {
+    DependencyScanningDaemon ScanningDaemon(Service, *AdjustingCompilations,
+                                            Inputs, NumWorkers);
+    std::string Line;
+    while (std::getline(std::cin, Line)) {
+      StringRef Command = StringRef(Line).trim();
+      if (Command == "quit")
+        break;
+      if (Command != "scan") {
+        llvm::errs() << "error: unknown command '" << Command << "'\n";
+        continue;
+      }
+      ScanningDaemon.scan(llvm::outs(), llvm::errs());
+      // Mark the end of the output with a comment line for the client.
+      llvm::outs() << "# end of scan\n";
+      llvm::outs().flush();
+    }
+    return 0;
+  }
+
   std::vector<std::unique_ptr<DependencyScanningTool>> WorkerTools;
   for (unsigned I = 0; I < NumWorkers; ++I)
     WorkerTools.push_back(std::make_unique<DependencyScanningTool>(
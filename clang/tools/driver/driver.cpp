@@ -318,6 +318,18 @@ static int ExecuteCC1Tool(ArrayRef<const char *> argv, StringRef Tool) {
   return 1;
 }
 
+/// Executes the -cc1 command line \p ArgV in the driver process, for
+/// -fintegrated-cc1.
+static int ExecuteCC1ToolInProcess(SmallVectorImpl<const char *> &ArgV) {
+  // The LLVM options are global, and may have been set by the previous -cc1
+  // commands: forget their occurrences so that -mllvm options can be passed
+  // again.
+  llvm::cl::ResetAllOptionOccurrences();
+  assert(ArgV.size() >= 2 && StringRef(ArgV[1]).startswith("-cc1") &&
+         "not a -cc1 command line");
+  return ExecuteCC1Tool(ArgV, ArgV[1] + 4);
+}
+
 int main(int argc_, const char **argv_) {
   llvm::InitLLVM X(argc_, argv_);
   SmallVector<const char *, 256> argv(argv_, argv_ + argc_);
@@ -449,6 +461,7 @@ int main(int argc_, const char **argv_) {
   Driver TheDriver(Path, llvm::sys::getDefaultTargetTriple(), Diags);
   SetInstallDir(argv, TheDriver, CanonicalPrefixes);
   TheDriver.setTargetAndMode(TargetAndMode);
+  TheDriver.CC1Main = &ExecuteCC1ToolInProcess;
 
   insertTargetAndModeArgs(TargetAndMode, argv, SavedStrings);
 
@@ -111,6 +111,34 @@ TEST(MatchFinder, CheckProfiling) {
   EXPECT_EQ("MyID", Records.begin()->getKey());
 }
 
+TEST(MatchFinder, CheckProfilingPerMatcher) {
+  MatchFinder::MatchFinderOptions Options;
+  llvm::StringMap<llvm::TimeRecord> Records;
+  Options.CheckProfiling.emplace(Records);
+  Options.CheckProfiling->PerMatcher = true;
+  MatchFinder Finder(std::move(Options));
+
+  struct NamedCallback : public MatchFinder::MatchCallback {
+    void run(const MatchFinder::MatchResult &Result) override {}
+    StringRef getID() const override { return "MyID"; }
+  } Callback;
+  Finder.addMatcher(decl(), &Callback);
+  Finder.addMatcher(varDecl(), &Callback);
+  Finder.addMatcher(varDecl(hasName("x")), &Callback);
+  std::unique_ptr<FrontendActionFactory> Factory(
+      newFrontendActionFactory(&Finder));
+  ASSERT_TRUE(tooling::runToolOnCode(Factory->create(), "int x;"));
+
+  std::vector<std::string> Buckets;
+  for (const auto &Record : Records)
+    Buckets.push_back(Record.getKey());
+  llvm::sort(Buckets);
+  // The start and the end of the translation unit are timed under the ID.
+  EXPECT_EQ((std::vector<std::string>{"MyID", "MyID.Decl.0", "MyID.VarDecl.0",
+                                      "MyID.VarDecl.1"}),
+            Buckets);
+}
+
 class VerifyStartOfTranslationUnit : public MatchFinder::MatchCallback {
 public:
   VerifyStartOfTranslationUnit() : Called(false) {}
@@ -0,0 +1,150 @@
+//===- unittests/Lex/SharedHeaderCacheTest.cpp ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/SharedHeaderCache.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TargetOptions.h"
+#include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/HeaderSearchOptions.h"
+#include "clang/Lex/ModuleLoader.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "clang/Lex/Preprocessor.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "gtest/gtest.h"
+
+using namespace clang;
+
+namespace {
+
+class SkippedFileCounter : public PPCallbacks {
+  unsigned &Count;
+
+public:
+  SkippedFileCounter(unsigned &Count) : Count(Count) {}
+
+  void FileSkipped(const FileEntry &SkippedFile, const Token &FilenameTok,
+                   SrcMgr::CharacteristicKind FileType) override {
+    ++Count;
+  }
+};
+
+// The test fixture.
+class SharedHeaderCacheTest : public ::testing::Test {
+protected:
+  SharedHeaderCacheTest()
+      : InMemoryFileSystem(new llvm::vfs::InMemoryFileSystem),
+        FileMgr(FileSystemOptions(), InMemoryFileSystem),
+        Cache(std::make_shared<SharedHeaderCache>()) {
+    LangOpts.CPlusPlus = LangOpts.LineComment = true;
+  }
+
+  const FileEntry *addFile(StringRef Name, StringRef Contents) {
+    InMemoryFileSystem->addFile(Name, 0,
+                                llvm::MemoryBuffer::getMemBuffer(Contents));
+    llvm::ErrorOr<const FileEntry *> File = FileMgr.getFile(Name);
+    return File ? *File : nullptr;
+  }
+
+  // Preprocesses File and returns its tokens, and the number of includes
+  // that were skipped in NumSkipped.
+  std::vector<std::string> preprocess(const FileEntry *File,
+                                      std::shared_ptr<SharedHeaderCache> Cache,
+                                      unsigned &NumSkipped) {
+    IntrusiveRefCntPtr<DiagnosticIDs> DiagID(new DiagnosticIDs());
+    DiagnosticsEngine Diags(DiagID, new DiagnosticOptions,
+                            new IgnoringDiagConsumer);
+    SourceManager SourceMgr(Diags, FileMgr);
+    auto TargetOpts = std::make_shared<TargetOptions>();
+    TargetOpts->Triple = "x86_64-unknown-linux-gnu";
+    IntrusiveRefCntPtr<TargetInfo> Target =
+        TargetInfo::CreateTargetInfo(Diags, TargetOpts);
+    SourceMgr.setMainFileID(
+        SourceMgr.createFileID(File, SourceLocation(), SrcMgr::C_User));
+
+    auto HSOpts = std::make_shared<HeaderSearchOptions>();
+    HSOpts->SharedHeaders = std::move(Cache);
+    TrivialModuleLoader ModLoader;
+    HeaderSearch HeaderInfo(HSOpts, SourceMgr, Diags, LangOpts, Target.get());
+    Preprocessor PP(std::make_shared<PreprocessorOptions>(), Diags, LangOpts,
+                    SourceMgr, HeaderInfo, ModLoader, /*IILookup =*/nullptr,
+                    /*OwnsHeaderSearch =*/false);
+    PP.Initialize(*Target);
+    NumSkipped = 0;
+    PP.addPPCallbacks(std::make_unique<SkippedFileCounter>(NumSkipped));
+    PP.EnterMainSourceFile();
+    std::vector<std::string> Tokens;
+    while (true) {
+      Token Tok;
+      PP.Lex(Tok);
+      if (Tok.is(tok::eof))
+        break;
+      Tokens.push_back(PP.getSpelling(Tok));
+    }
+    return Tokens;
+  }
+
+  IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFileSystem;
+  FileManager FileMgr;
+  LangOptions LangOpts;
+  std::shared_ptr<SharedHeaderCache> Cache;
+};
+
+TEST_F(SharedHeaderCacheTest, ControllingMacros) {
+  const FileEntry *Guarded = addFile("/guarded.h",
+                                     "// Comment\n"
+                                     "#ifndef GUARDED_H\n"
+                                     "#define GUARDED_H\n"
+                                     "guarded\n"
+                                     "#endif\n");
+  const FileEntry *Unguarded = addFile("/unguarded.h",
+                                       "#ifndef UNGUARDED_H\n"
+                                       "#define UNGUARDED_H\n"
+                                       "#endif\n"
+                                       "unguarded\n");
+  const FileEntry *First = addFile("/first.cpp",
+                                   "#include \"/guarded.h\"\n"
+                                   "#include \"/unguarded.h\"\n");
+  const FileEntry *Second = addFile("/second.cpp",
+                                    "#define GUARDED_H\n"
+                                    "#define UNGUARDED_H\n"
+                                    "#include \"/guarded.h\"\n"
+                                    "#include \"/unguarded.h\"\n"
+                                    "#include \"/guarded.h\"\n");
+  ASSERT_TRUE(Guarded && Unguarded && First && Second);
+
+  unsigned NumSkipped;
+  EXPECT_EQ(std::vector<std::string>({"guarded", "unguarded"}),
+            preprocess(First, Cache, NumSkipped));
+  EXPECT_EQ(0U, NumSkipped);
+
+  // A header whose guard is defined before it is entered is not known to be
+  // guarded, so without the cache it is entered every time.
+  EXPECT_EQ(std::vector<std::string>({"unguarded"}),
+            preprocess(Second, nullptr, NumSkipped));
+  EXPECT_EQ(0U, NumSkipped);
+
+  // With it, it is never entered.
+  EXPECT_EQ(std::vector<std::string>({"unguarded"}),
+            preprocess(Second, Cache, NumSkipped));
+  EXPECT_EQ(2U, NumSkipped);
+}
+
+TEST_F(SharedHeaderCacheTest, HeaderMaps) {
+  const FileEntry *File = addFile("/not-a-header-map.hmap", "garbage");
+  ASSERT_TRUE(File);
+  EXPECT_FALSE(Cache->getHeaderMap(File, FileMgr));
+  EXPECT_FALSE(Cache->getHeaderMap(File, FileMgr));
+}
+
+} // anonymous namespace
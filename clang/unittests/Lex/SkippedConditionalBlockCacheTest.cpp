@@ -0,0 +1,181 @@
+//===- unittests/Lex/SkippedConditionalBlockCacheTest.cpp -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/SkippedConditionalBlockCache.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TargetOptions.h"
+#include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/HeaderSearchOptions.h"
+#include "clang/Lex/ModuleLoader.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "clang/Lex/Preprocessor.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "gtest/gtest.h"
+
+using namespace clang;
+
+namespace {
+
+// Everything that the preprocessor reports about a file.
+struct PPResult {
+  std::vector<std::string> Tokens;
+  std::vector<std::pair<unsigned, unsigned>> SkippedRanges;
+  std::vector<std::pair<unsigned, unsigned>> Diagnostics;
+
+  bool operator==(const PPResult &RHS) const {
+    return Tokens == RHS.Tokens && SkippedRanges == RHS.SkippedRanges &&
+           Diagnostics == RHS.Diagnostics;
+  }
+};
+
+class RecordingDiagConsumer : public DiagnosticConsumer {
+  PPResult &Result;
+
+public:
+  RecordingDiagConsumer(PPResult &Result) : Result(Result) {}
+
+  void HandleDiagnostic(DiagnosticsEngine::Level Level,
+                        const Diagnostic &Info) override {
+    SourceManager &SM = Info.getSourceManager();
+    Result.Diagnostics.emplace_back(Info.getID(),
+                                    SM.getFileOffset(Info.getLocation()));
+  }
+};
+
+class SkippedRangeRecorder : public PPCallbacks {
+  SourceManager &SourceMgr;
+  PPResult &Result;
+
+public:
+  SkippedRangeRecorder(SourceManager &SourceMgr, PPResult &Result)
+      : SourceMgr(SourceMgr), Result(Result) {}
+
+  void SourceRangeSkipped(SourceRange Range, SourceLocation EndifLoc) override {
+    Result.SkippedRanges.emplace_back(SourceMgr.getFileOffset(Range.getBegin()),
+                                      SourceMgr.getFileOffset(Range.getEnd()));
+  }
+};
+
+// The test fixture.
+class SkippedConditionalBlockCacheTest : public ::testing::Test {
+protected:
+  SkippedConditionalBlockCacheTest()
+      : InMemoryFileSystem(new llvm::vfs::InMemoryFileSystem),
+        FileMgr(FileSystemOptions(), InMemoryFileSystem),
+        Cache(std::make_shared<SkippedConditionalBlockCache>()) {
+    LangOpts.CPlusPlus = LangOpts.CPlusPlus11 = LangOpts.CPlusPlus14 = true;
+    LangOpts.LineComment = LangOpts.Digraphs = true;
+  }
+
+  const FileEntry *addFile(StringRef Name, StringRef Contents) {
+    InMemoryFileSystem->addFile(Name, 0,
+                                llvm::MemoryBuffer::getMemBuffer(Contents));
+    llvm::ErrorOr<const FileEntry *> File = FileMgr.getFile(Name);
+    return File ? *File : nullptr;
+  }
+
+  PPResult preprocess(const FileEntry *File,
+                      std::shared_ptr<SkippedConditionalBlockCache> Cache) {
+    PPResult Result;
+    IntrusiveRefCntPtr<DiagnosticIDs> DiagID(new DiagnosticIDs());
+    RecordingDiagConsumer DiagConsumer(Result);
+    DiagnosticsEngine Diags(DiagID, new DiagnosticOptions, &DiagConsumer,
+                            /*ShouldOwnClient=*/false);
+    SourceManager SourceMgr(Diags, FileMgr);
+    auto TargetOpts = std::make_shared<TargetOptions>();
+    TargetOpts->Triple = "x86_64-unknown-linux-gnu";
+    IntrusiveRefCntPtr<TargetInfo> Target =
+        TargetInfo::CreateTargetInfo(Diags, TargetOpts);
+    SourceMgr.setMainFileID(
+        SourceMgr.createFileID(File, SourceLocation(), SrcMgr::C_User));
+
+    auto PPOpts = std::make_shared<PreprocessorOptions>();
+    PPOpts->SkippedConditionalBlocks = std::move(Cache);
+    TrivialModuleLoader ModLoader;
+    HeaderSearch HeaderInfo(std::make_shared<HeaderSearchOptions>(), SourceMgr,
+                            Diags, LangOpts, Target.get());
+    Preprocessor PP(PPOpts, Diags, LangOpts, SourceMgr, HeaderInfo, ModLoader,
+                    /*IILookup =*/nullptr,
+                    /*OwnsHeaderSearch =*/false);
+    PP.Initialize(*Target);
+    PP.addPPCallbacks(
+        std::make_unique<SkippedRangeRecorder>(SourceMgr, Result));
+    PP.EnterMainSourceFile();
+    while (true) {
+      Token Tok;
+      PP.Lex(Tok);
+      if (Tok.is(tok::eof))
+        break;
+      Result.Tokens.push_back(PP.getSpelling(Tok));
+    }
+    return Result;
+  }
+
+  IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFileSystem;
+  FileManager FileMgr;
+  LangOptions LangOpts;
+  std::shared_ptr<SkippedConditionalBlockCache> Cache;
+};
+
+const char *const Source = "#if 0\n"
+                           "int a; // #endif\n"
+                           "/* #else\n"
+                           "#endif */\n"
+                           "const char *s = \"#endif\"; char c = '#';\n"
+                           "int x = 1'000 /* spans\n"
+                           "#endif\n"
+                           "lines */;\n"
+                           "auto r = R\"(\n"
+                           "#endif\n"
+                           ")\";\n"
+                           "#if 1\n"
+                           "#else\n"
+                           "#else\n"
+                           "#endif\n"
+                           "#elif 1\n"
+                           "good1\n"
+                           "#endif\n"
+                           "#ifdef NOPE\n"
+                           "a b c\n"
+                           "  %:  else\n"
+                           "good2\n"
+                           "#endif\n";
+
+TEST_F(SkippedConditionalBlockCacheTest, MatchesLexing) {
+  const FileEntry *File = addFile("/main.cpp", Source);
+  ASSERT_TRUE(File);
+
+  PPResult Expected = preprocess(File, nullptr);
+  EXPECT_EQ(std::vector<std::string>({"good1", "good2"}), Expected.Tokens);
+  ASSERT_EQ(2U, Expected.SkippedRanges.size());
+  // The #else after #else of the nested block is still diagnosed.
+  ASSERT_EQ(1U, Expected.Diagnostics.size());
+
+  // Fills the cache.
+  EXPECT_TRUE(Expected == preprocess(File, Cache));
+  StringRef Text = Source;
+  unsigned LangOptsHash = SkippedConditionalBlockCache::hashLangOptions(
+      LangOpts);
+  EXPECT_EQ(Optional<unsigned>(Text.find("#if 1")),
+            Cache->getBlockEnd(File, LangOptsHash, Text.find("int a;")));
+  EXPECT_EQ(Optional<unsigned>(Text.find("%:")),
+            Cache->getBlockEnd(File, LangOptsHash, Text.find("a b c")));
+  EXPECT_FALSE(
+      Cache->getBlockEnd(File, LangOptsHash + 1, Text.find("int a;")));
+
+  // Jumps over the blocks.
+  EXPECT_TRUE(Expected == preprocess(File, Cache));
+}
+
+} // anonymous namespace
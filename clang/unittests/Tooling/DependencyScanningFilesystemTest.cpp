@@ -0,0 +1,61 @@
+//===- unittest/Tooling/DependencyScanningFilesystemTest.cpp --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace clang;
+using namespace tooling;
+using namespace dependencies;
+
+namespace {
+
+std::string readFile(llvm::vfs::FileSystem &FS, StringRef Name) {
+  auto File = FS.openFileForRead(Name);
+  if (!File)
+    return "<error>";
+  auto Buffer = (*File)->getBuffer(Name);
+  if (!Buffer)
+    return "<error>";
+  return (*Buffer)->getBuffer();
+}
+
+TEST(DependencyScanningFilesystem, InvalidatedEntryIsReadAgain) {
+  IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFS(
+      new llvm::vfs::InMemoryFileSystem);
+  InMemoryFS->addFile("/a.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("#define A 1\n"));
+
+  DependencyScanningFilesystemSharedCache SharedCache;
+  IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> DepFS(
+      new DependencyScanningWorkerFilesystem(SharedCache, InMemoryFS));
+  EXPECT_EQ("#define A 1\n", readFile(*DepFS, "/a.h"));
+  EXPECT_FALSE(bool(DepFS->status("/b.h")));
+
+  // Replace the file, the cached contents are still used.
+  InMemoryFS = new llvm::vfs::InMemoryFileSystem;
+  InMemoryFS->addFile("/a.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("#define B 1\n"));
+  InMemoryFS->addFile("/b.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("#define C 1\n"));
+  DepFS = new DependencyScanningWorkerFilesystem(SharedCache, InMemoryFS);
+  IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> OtherDepFS(
+      new DependencyScanningWorkerFilesystem(SharedCache, InMemoryFS));
+  EXPECT_EQ("#define A 1\n", readFile(*DepFS, "/a.h"));
+  EXPECT_FALSE(bool(DepFS->status("/b.h")));
+
+  // Both the shared cache and the local caches of the workers are updated.
+  SharedCache.invalidate("/a.h");
+  SharedCache.invalidate("/b.h");
+  EXPECT_EQ("#define B 1\n", readFile(*DepFS, "/a.h"));
+  EXPECT_TRUE(bool(DepFS->status("/b.h")));
+  EXPECT_EQ("#define B 1\n", readFile(*OtherDepFS, "/a.h"));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,104 @@
+//===- unittest/Tooling/MinimizedSourceDiskCacheTest.cpp ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Tooling/DependencyScanning/MinimizedSourceDiskCache.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace clang;
+using namespace tooling;
+using namespace dependencies;
+
+namespace {
+
+class MinimizedSourceDiskCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(
+        llvm::sys::fs::createUniqueDirectory("minimized-source-cache", Dir));
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(Dir); }
+
+  static llvm::vfs::Status getStatus(StringRef Name, uint64_t Size,
+                                     time_t ModTime) {
+    return llvm::vfs::Status(Name, llvm::sys::fs::UniqueID(1, 1),
+                             llvm::sys::toTimePoint(ModTime), 0, 0, Size,
+                             llvm::sys::fs::file_type::regular_file,
+                             llvm::sys::fs::perms::all_all);
+  }
+
+  static IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem>
+  createFS(StringRef Name, StringRef Contents) {
+    IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> FS(
+        new llvm::vfs::InMemoryFileSystem);
+    FS->setCurrentWorkingDirectory("/");
+    FS->addFile(Name, 42, llvm::MemoryBuffer::getMemBufferCopy(Contents));
+    return FS;
+  }
+
+  SmallString<128> Dir;
+};
+
+TEST_F(MinimizedSourceDiskCacheTest, LookupStoredEntry) {
+  MinimizedSourceDiskCache Cache(Dir);
+  llvm::vfs::Status Stat = getStatus("/a.h", 100, 42);
+  SmallString<64> Contents;
+  EXPECT_FALSE(Cache.lookup("/a.h", Stat, Contents));
+
+  Cache.store("/a.h", Stat, "#pragma once\n");
+  ASSERT_TRUE(Cache.lookup("/a.h", Stat, Contents));
+  EXPECT_EQ("#pragma once\n", Contents.str());
+
+  // A second cache in the same directory, like in a later run, sees the entry.
+  MinimizedSourceDiskCache OtherCache(Dir);
+  Contents.clear();
+  ASSERT_TRUE(OtherCache.lookup("/a.h", Stat, Contents));
+  EXPECT_EQ("#pragma once\n", Contents.str());
+}
+
+TEST_F(MinimizedSourceDiskCacheTest, ChangedFileIsNotFound) {
+  MinimizedSourceDiskCache Cache(Dir);
+  Cache.store("/a.h", getStatus("/a.h", 100, 42), "#pragma once\n");
+
+  SmallString<64> Contents;
+  EXPECT_FALSE(Cache.lookup("/a.h", getStatus("/a.h", 101, 42), Contents));
+  EXPECT_FALSE(Cache.lookup("/a.h", getStatus("/a.h", 100, 43), Contents));
+  EXPECT_FALSE(Cache.lookup("/b.h", getStatus("/b.h", 100, 42), Contents));
+}
+
+TEST_F(MinimizedSourceDiskCacheTest, FileEntryUsesCache) {
+  MinimizedSourceDiskCache Cache(Dir);
+  {
+    auto FS = createFS("/a.h", "#define A 1\nint a;\n");
+    CachedFileSystemEntry Entry = CachedFileSystemEntry::createFileEntry(
+        "a.h", *FS, /*Minimize=*/true, &Cache);
+    ASSERT_TRUE(bool(Entry.getContents()));
+    EXPECT_EQ("#define A 1\n", *Entry.getContents());
+  }
+
+  // The file has the same size and modification time, so its minimized
+  // contents are taken from the cache without reading it.
+  auto FS = createFS("/a.h", "#define B 1\nint b;\n");
+  CachedFileSystemEntry Entry = CachedFileSystemEntry::createFileEntry(
+      "/a.h", *FS, /*Minimize=*/true, &Cache);
+  ASSERT_TRUE(bool(Entry.getContents()));
+  EXPECT_EQ("#define A 1\n", *Entry.getContents());
+  EXPECT_EQ(Entry.getContents()->size(), Entry.getStatus()->getSize());
+
+  // Original sources are not cached.
+  CachedFileSystemEntry Original = CachedFileSystemEntry::createFileEntry(
+      "/a.h", *FS, /*Minimize=*/false, &Cache);
+  ASSERT_TRUE(bool(Original.getContents()));
+  EXPECT_EQ("#define B 1\nint b;\n", *Original.getContents());
+}
+
+} // end anonymous namespace
@@ -312,7 +312,9 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &ClangTableGenMain);
+  return TableGenMain(argv[0], &ClangTableGenMain, [](StringRef Name) {
+    return selectTableGenAction(Action, Name);
+  });
 }
 
 #ifdef __has_feature
@@ -133,7 +133,8 @@ struct AsanChunk: ChunkBase {
 struct QuarantineCallback {
   QuarantineCallback(AllocatorCache *cache, BufferedStackTrace *stack)
       : cache_(cache),
-        stack_(stack) {
+        stack_(stack),
+        thread_stats_(nullptr) {
   }
 
   void Recycle(AsanChunk *m) {
@@ -154,10 +155,12 @@ struct QuarantineCallback {
       CHECK_EQ(alloc_magic[1], reinterpret_cast<uptr>(m));
     }
 
-    // Statistics.
-    AsanStats &thread_stats = GetCurrentThreadStats();
-    thread_stats.real_frees++;
-    thread_stats.really_freed += m->UsedSize();
+    // Statistics. The chunks of a batch are recycled by the same thread, so
+    // its stats are only looked up once.
+    if (!thread_stats_)
+      thread_stats_ = &GetCurrentThreadStats();
+    thread_stats_->real_frees++;
+    thread_stats_->really_freed += m->UsedSize();
 
     get_allocator().Deallocate(cache_, p);
   }
@@ -177,6 +180,7 @@ struct QuarantineCallback {
  private:
   AllocatorCache* const cache_;
   BufferedStackTrace* const stack_;
+  AsanStats *thread_stats_;
 };
 
 typedef Quarantine<QuarantineCallback, AsanChunk> AsanQuarantine;
@@ -518,7 +522,7 @@ struct Allocator {
       *shadow = fl.poison_partial ? (size & (SHADOW_GRANULARITY - 1)) : 0;
     }
 
-    AsanStats &thread_stats = GetCurrentThreadStats();
+    AsanStats &thread_stats = GetThreadStats(t);
     thread_stats.mallocs++;
     thread_stats.malloced += size;
     thread_stats.malloced_redzones += needed_size - size;
@@ -586,7 +590,7 @@ struct Allocator {
                  RoundUpTo(m->UsedSize(), SHADOW_GRANULARITY),
                  kAsanHeapFreeMagic);
 
-    AsanStats &thread_stats = GetCurrentThreadStats();
+    AsanStats &thread_stats = GetThreadStats(t);
     thread_stats.frees++;
     thread_stats.freed += m->UsedSize();
 
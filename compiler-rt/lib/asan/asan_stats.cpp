@@ -116,7 +116,10 @@ void FillMallocStatistics(AsanMallocStats *malloc_stats) {
 }
 
 AsanStats &GetCurrentThreadStats() {
-  AsanThread *t = GetCurrentThread();
+  return GetThreadStats(GetCurrentThread());
+}
+
+AsanStats &GetThreadStats(AsanThread *t) {
   return (t) ? t->stats() : unknown_thread_stats;
 }
 
@@ -53,6 +53,8 @@ struct AsanStats {
 // Returns stats for GetCurrentThread(), or stats for fake "unknown thread"
 // if GetCurrentThread() returns 0.
 AsanStats &GetCurrentThreadStats();
+// Same as above, for callers which already looked up the current thread.
+AsanStats &GetThreadStats(AsanThread *t);
 // Flushes a given stats into accumulated stats of dead threads.
 void FlushToDeadThreadStats(AsanStats *stats);
 
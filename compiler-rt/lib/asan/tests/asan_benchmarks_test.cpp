@@ -78,6 +78,35 @@ TEST(AddressSanitizer, FakeStackBenchmark) {
     Ident(&FunctionWithLargeStack)();
 }
 
+// Small allocations of varying sizes, freed in a different order than they
+// were allocated, so that the quarantine is recycled continuously.
+__attribute__((noinline))
+static void *MallocFreeFunc(void *arg) {
+  const size_t kLiveChunks = 64;
+  void *chunks[kLiveChunks] = {};
+  for (size_t i = 0; i < (1 << 22); i++) {
+    size_t slot = (i * 7) % kLiveChunks;
+    free(chunks[slot]);
+    chunks[slot] = Ident(malloc(16 + (i % 16) * 8));
+  }
+  for (size_t i = 0; i < kLiveChunks; i++)
+    free(chunks[i]);
+  return arg;
+}
+
+TEST(AddressSanitizer, MallocFreeBenchmark) {
+  MallocFreeFunc(nullptr);
+}
+
+TEST(AddressSanitizer, ThreadedMallocFreeBenchmark) {
+  const int kNumThreads = 8;
+  pthread_t t[kNumThreads];
+  for (int i = 0; i < kNumThreads; i++)
+    PTHREAD_CREATE(&t[i], 0, MallocFreeFunc, 0);
+  for (int i = 0; i < kNumThreads; i++)
+    PTHREAD_JOIN(t[i], 0);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
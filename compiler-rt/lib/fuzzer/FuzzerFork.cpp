@@ -68,7 +68,6 @@ struct FuzzJob {
   std::string FeaturesDir;
   std::string LogPath;
   std::string SeedListPath;
-  std::string CFPath;
   size_t      JobId;
 
   int         DftTimeInSeconds = 0;
@@ -77,7 +76,6 @@ struct FuzzJob {
   int ExitCode;
 
   ~FuzzJob() {
-    RemoveFile(CFPath);
     RemoveFile(LogPath);
     RemoveFile(SeedListPath);
     RmDirRecursive(CorpusDir);
@@ -106,6 +104,17 @@ struct GlobalEnv {
 
   size_t NumRuns = 0;
 
+  // The jobs which finished since the last merge. They are kept, along with
+  // their corpus, until their merge candidates are merged all at once.
+  Vector<std::unique_ptr<FuzzJob>> JobsToMerge;
+  Vector<SizedFile> MergeCandidates;
+
+  // The time spent coordinating the jobs rather than running them.
+  size_t NumMerges = 0;
+  size_t MergeMs = 0;
+  std::atomic<size_t> WorkerBusyMs{0};
+  std::atomic<size_t> WorkerIdleMs{0};
+
   std::string StopFile() { return DirPlusFile(TempDir, "STOP"); }
 
   size_t secondsSinceProcessStartUp() const {
@@ -119,6 +128,7 @@ struct GlobalEnv {
     Cmd.removeFlag("fork");
     Cmd.removeFlag("runs");
     Cmd.removeFlag("collect_data_flow");
+    Cmd.removeFlag("feature_index");
     for (auto &C : CorpusDirs) // Remove all corpora from the args.
       Cmd.removeArgument(C);
     Cmd.addFlag("reload", "0");  // working in an isolated dir, no reload.
@@ -153,7 +163,6 @@ struct GlobalEnv {
     Job->LogPath = DirPlusFile(TempDir, std::to_string(JobId) + ".log");
     Job->CorpusDir = DirPlusFile(TempDir, "C" + std::to_string(JobId));
     Job->FeaturesDir = DirPlusFile(TempDir, "F" + std::to_string(JobId));
-    Job->CFPath = DirPlusFile(TempDir, std::to_string(JobId) + ".merge");
     Job->JobId = JobId;
 
 
@@ -177,11 +186,13 @@ struct GlobalEnv {
     return Job;
   }
 
-  void RunOneMergeJob(FuzzJob *Job) {
+  // Collects the inputs of a finished job which have features the corpus
+  // doesn't have yet, for the next call to MergeJobs().
+  void CollectMergeCandidates(FuzzJob *Job) {
     auto Stats = ParseFinalStatsFromLog(Job->LogPath);
     NumRuns += Stats.number_of_executed_units;
 
-    Vector<SizedFile> TempFiles, MergeCandidates;
+    Vector<SizedFile> TempFiles;
     // Read all newly created inputs and their feature sets.
     // Choose only those inputs that have new features.
     GetSizedFilesFromDir(Job->CorpusDir, &TempFiles);
@@ -206,13 +217,23 @@ struct GlobalEnv {
            NumRuns, Cov.size(), Features.size(), Files.size(),
            Stats.average_exec_per_sec, NumOOMs, NumTimeouts, NumCrashes,
            secondsSinceProcessStartUp(), Job->JobId, Job->DftTimeInSeconds);
+  }
 
-    if (MergeCandidates.empty()) return;
-
+  // Merges the candidates of all the jobs which finished since the last
+  // merge into the main corpus. The inputs are executed once more, but only
+  // the candidates are: the features of the corpus are known already.
+  void MergeJobs() {
+    if (MergeCandidates.empty()) {
+      JobsToMerge.clear();
+      return;
+    }
+    auto Time1 = std::chrono::system_clock::now();
     Vector<std::string> FilesToAdd;
     Set<uint32_t> NewFeatures, NewCov;
+    auto CFPath = DirPlusFile(TempDir, "merge.txt");
     CrashResistantMerge(Args, {}, MergeCandidates, &FilesToAdd, Features,
-                        &NewFeatures, Cov, &NewCov, Job->CFPath, false);
+                        &NewFeatures, Cov, &NewCov, CFPath, false);
+    RemoveFile(CFPath);
     for (auto &Path : FilesToAdd) {
       auto U = FileToVector(Path);
       auto NewPath = DirPlusFile(MainCorpusDir, Hash(U));
@@ -227,6 +248,25 @@ struct GlobalEnv {
           PrintPC("  NEW_FUNC: %p %F %L\n", "",
                   TPC.GetNextInstructionPc(TE->PC));
 
+    MergeCandidates.clear();
+    JobsToMerge.clear();
+    NumMerges++;
+    MergeMs += duration_cast<milliseconds>(std::chrono::system_clock::now() -
+                                           Time1)
+                   .count();
+  }
+
+  void PrintCoordinationStats(int NumJobs) {
+    size_t BusyMs = WorkerBusyMs, IdleMs = WorkerIdleMs;
+    // The executions the workers would have done while they were waiting
+    // for a new job, at the rate of the jobs.
+    size_t LostExecPerSec =
+        BusyMs ? NumRuns * IdleMs / BusyMs /
+                     std::max(secondsSinceProcessStartUp(), (size_t)1)
+               : 0;
+    Printf("INFO: -fork=%d: %zd merges took %zds, the workers waited for "
+           "jobs %zds (%zd exec/s lost to coordination)\n",
+           NumJobs, NumMerges, MergeMs / 1000, IdleMs / 1000, LostExecPerSec);
   }
 
 
@@ -260,6 +300,10 @@ struct JobQueue {
     }
     Cv.notify_one();
   }
+  bool Empty() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    return Qu.empty();
+  }
   FuzzJob *Pop() {
     std::unique_lock<std::mutex> Lk(Mu);
     // std::lock_guard<std::mutex> Lock(Mu);
@@ -271,10 +315,16 @@ struct JobQueue {
   }
 };
 
-void WorkerThread(JobQueue *FuzzQ, JobQueue *MergeQ) {
+void WorkerThread(JobQueue *FuzzQ, JobQueue *MergeQ, GlobalEnv *Env) {
+  auto Time1 = std::chrono::system_clock::now();
   while (auto Job = FuzzQ->Pop()) {
     // Printf("WorkerThread: job %p\n", Job);
+    auto Time2 = std::chrono::system_clock::now();
     Job->ExitCode = ExecuteCommand(Job->Cmd);
+    auto Time3 = std::chrono::system_clock::now();
+    Env->WorkerIdleMs += duration_cast<milliseconds>(Time2 - Time1).count();
+    Env->WorkerBusyMs += duration_cast<milliseconds>(Time3 - Time2).count();
+    Time1 = Time3;
     MergeQ->Push(Job);
   }
 }
@@ -331,23 +381,25 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
   size_t JobId = 1;
   Vector<std::thread> Threads;
   for (int t = 0; t < NumJobs; t++) {
-    Threads.push_back(std::thread(WorkerThread, &FuzzQ, &MergeQ));
+    Threads.push_back(std::thread(WorkerThread, &FuzzQ, &MergeQ, &Env));
     FuzzQ.Push(Env.CreateNewJob(JobId++));
   }
 
   while (true) {
-    std::unique_ptr<FuzzJob> Job(MergeQ.Pop());
+    FuzzJob *Job = MergeQ.Pop();
     if (!Job)
       break;
     ExitCode = Job->ExitCode;
     if (ExitCode == Options.InterruptExitCode) {
       Printf("==%lu== libFuzzer: a child was interrupted; exiting\n", GetPid());
+      delete Job;
       StopJobs();
       break;
     }
     Fuzzer::MaybeExitGracefully();
 
-    Env.RunOneMergeJob(Job.get());
+    Env.CollectMergeCandidates(Job);
+    Env.JobsToMerge.emplace_back(Job);
 
     // Continue if our crash is one of the ignorred ones.
     if (Options.IgnoreTimeouts && ExitCode == Options.TimeoutExitCode)
@@ -390,12 +442,21 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
       break;
     }
 
+    // The jobs which finished meanwhile are merged together, with a single
+    // merge process, unless the other workers would wait too long for them.
+    if (MergeQ.Empty() || Env.JobsToMerge.size() >= (size_t)NumJobs)
+      Env.MergeJobs();
     FuzzQ.Push(Env.CreateNewJob(JobId++));
   }
 
   for (auto &T : Threads)
     T.join();
 
+  if (ExitCode != Options.InterruptExitCode)
+    Env.MergeJobs();
+  Env.JobsToMerge.clear();
+  Env.PrintCoordinationStats(NumJobs);
+
   // The workers have terminated. Don't try to remove the directory before they
   // terminate to avoid a race condition preventing cleanup on Windows.
   RmDirRecursive(Env.TempDir);
@@ -93,6 +93,8 @@ private:
   void ExitCallback();
   void CrashOnOverwrittenData();
   void InterruptCallback();
+  bool AddIndexedInputToCorpus(const Unit &U, const Vector<uint32_t> &Features,
+                               const Vector<uint32_t> &PCs);
   void MutateAndTestOne();
   void PurgeAllocator();
   void ReportNewCoverage(InputInfo *II, const Unit &U);
@@ -19,6 +19,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <unordered_map>
 
 #if defined(__has_include)
 #if __has_include(<sanitizer / lsan_interface.h>)
@@ -506,6 +507,31 @@ bool Fuzzer::RunOne(const uint8_t *Data, size_t Size, bool MayDeleteFile,
   return false;
 }
 
+// Adds an input to the corpus without executing it, from the features and the
+// PCs it had when it was executed with the same binary. Returns true like
+// RunOne() if the input was added.
+bool Fuzzer::AddIndexedInputToCorpus(const Unit &U,
+                                     const Vector<uint32_t> &Features,
+                                     const Vector<uint32_t> &PCs) {
+  if (U.empty())
+    return false;
+  UniqFeatureSetTmp.clear();
+  size_t NumUpdatesBefore = Corpus.NumFeatureUpdates();
+  for (uint32_t Feature : Features)
+    if (Corpus.AddFeature(Feature, U.size(), Options.Shrink))
+      UniqFeatureSetTmp.push_back(Feature);
+  size_t NumNewFeatures = Corpus.NumFeatureUpdates() - NumUpdatesBefore;
+  if (!NumNewFeatures)
+    return false;
+  TPC.ObservePCs(PCs);
+  auto NewII = Corpus.AddToCorpus(U, NumNewFeatures, /*MayDeleteFile=*/false,
+                                  /*HasFocusFunction=*/false,
+                                  UniqFeatureSetTmp, DFT, nullptr);
+  WriteFeatureSetToFile(Options.FeaturesDir, Sha1ToString(NewII->Sha1),
+                        NewII->UniqFeatureSet);
+  return true;
+}
+
 size_t Fuzzer::GetCurrentUnitInFuzzingThead(const uint8_t **Data) const {
   assert(InFuzzingThread());
   *Data = CurrentUnitData;
@@ -721,6 +747,102 @@ void Fuzzer::PurgeAllocator() {
   LastAllocatorPurgeAttemptTime = system_clock::now();
 }
 
+// The feature index saves, for each input of the seed corpus, the features it
+// added to the corpus and the PCs it observed first when it was executed, so
+// that the next startups don't need to execute it again (-feature_index).
+//
+// An input only records the features that the inputs executed before it
+// didn't have, which keeps the index small. So the index is valid for the
+// corpus it was built with, plus new inputs; it is dropped when an input it
+// knows is removed, or when the binary changes.
+//
+// The file starts with "FEATURE_INDEX <id>\n", where <id> is the
+// TracePC::FeatureSpaceId() of the binary. Each entry is then:
+//   the SHA1 of the input (40 hex digits), the uint32_t sizes of its file
+//   name, of its features and of its PCs, followed by the three of them.
+struct FeatureIndexEntry {
+  std::string File;
+  Vector<uint32_t> Features, PCs;
+};
+typedef std::unordered_map<std::string, FeatureIndexEntry> FeatureIndex;
+
+static const char kFeatureIndexMagic[] = "FEATURE_INDEX ";
+
+static bool ReadFeatureIndex(const std::string &Path, const std::string &Id,
+                             const Vector<SizedFile> &CorporaFiles,
+                             FeatureIndex *Index) {
+  Unit Data = FileToVector(Path, 0, /*ExitOnError=*/false);
+  std::string Header = kFeatureIndexMagic + Id + "\n";
+  if (Data.size() < Header.size() ||
+      memcmp(Data.data(), Header.data(), Header.size())) {
+    Printf("INFO: feature index %s is missing or was built for another "
+           "binary; executing all the inputs\n", Path.c_str());
+    return false;
+  }
+  const size_t kSha1Len = 2 * kSHA1NumBytes;
+  Set<std::string> Files;
+  for (auto &SF : CorporaFiles)
+    Files.insert(SF.File);
+  size_t Pos = Header.size();
+  while (Pos < Data.size()) {
+    uint32_t Sizes[3];
+    if (Data.size() - Pos < kSha1Len + sizeof(Sizes))
+      break;
+    std::string Sha1(reinterpret_cast<const char *>(&Data[Pos]), kSha1Len);
+    memcpy(Sizes, &Data[Pos + kSha1Len], sizeof(Sizes));
+    Pos += kSha1Len + sizeof(Sizes);
+    size_t Len = Sizes[0] + (Sizes[1] + Sizes[2]) * sizeof(uint32_t);
+    if (Data.size() - Pos < Len)
+      break;
+    FeatureIndexEntry &E = (*Index)[Sha1];
+    E.File.assign(reinterpret_cast<const char *>(&Data[Pos]), Sizes[0]);
+    Pos += Sizes[0];
+    E.Features.resize(Sizes[1]);
+    memcpy(E.Features.data(), &Data[Pos], Sizes[1] * sizeof(uint32_t));
+    Pos += Sizes[1] * sizeof(uint32_t);
+    E.PCs.resize(Sizes[2]);
+    memcpy(E.PCs.data(), &Data[Pos], Sizes[2] * sizeof(uint32_t));
+    Pos += Sizes[2] * sizeof(uint32_t);
+    // The other inputs may rely on this one for some of their features.
+    if (!E.Features.empty() && !Files.count(E.File)) {
+      Printf("INFO: %s was removed from the corpus since the feature index "
+             "%s was built; executing all the inputs\n",
+             E.File.c_str(), Path.c_str());
+      Index->clear();
+      return false;
+    }
+  }
+  if (Pos != Data.size()) {
+    Printf("INFO: feature index %s is truncated; executing all the inputs\n",
+           Path.c_str());
+    Index->clear();
+    return false;
+  }
+  return true;
+}
+
+static void WriteFeatureIndex(const std::string &Path, const std::string &Id,
+                              const FeatureIndex &Index) {
+  std::string Data = kFeatureIndexMagic + Id + "\n";
+  for (auto &It : Index) {
+    const FeatureIndexEntry &E = It.second;
+    uint32_t Sizes[3] = {static_cast<uint32_t>(E.File.size()),
+                         static_cast<uint32_t>(E.Features.size()),
+                         static_cast<uint32_t>(E.PCs.size())};
+    Data += It.first;
+    Data.append(reinterpret_cast<const char *>(Sizes), sizeof(Sizes));
+    Data += E.File;
+    Data.append(reinterpret_cast<const char *>(E.Features.data()),
+                E.Features.size() * sizeof(uint32_t));
+    Data.append(reinterpret_cast<const char *>(E.PCs.data()),
+                E.PCs.size() * sizeof(uint32_t));
+  }
+  // The index is replaced at once: other processes may be reading it.
+  std::string TmpPath = Path + ".tmp" + std::to_string(GetPid());
+  WriteToFile(Data, TmpPath);
+  RenameFile(TmpPath, Path);
+}
+
 void Fuzzer::ReadAndExecuteSeedCorpora(Vector<SizedFile> &CorporaFiles) {
   const size_t kMaxSaneLen = 1 << 20;
   const size_t kMinDefaultLen = 4096;
@@ -760,15 +882,59 @@ void Fuzzer::ReadAndExecuteSeedCorpora(Vector<SizedFile> &CorporaFiles) {
       assert(CorporaFiles.front().Size <= CorporaFiles.back().Size);
     }
 
+    // The features of the inputs which touch the focus function, or trigger
+    // the lazy counters, depend on more than the input.
+    bool UseFeatureIndex = !Options.FeatureIndex.empty() &&
+                           Options.FocusFunction.empty() &&
+                           !Options.LazyCounters;
+    std::string FeatureSpaceId;
+    FeatureIndex OldIndex, NewIndex;
+    if (UseFeatureIndex) {
+      FeatureSpaceId = TPC.FeatureSpaceId();
+      ReadFeatureIndex(Options.FeatureIndex, FeatureSpaceId, CorporaFiles,
+                       &OldIndex);
+    }
+
     // Load and execute inputs one by one.
+    size_t NumIndexedInputs = 0;
     for (auto &SF : CorporaFiles) {
       auto U = FileToVector(SF.File, MaxInputLen, /*ExitOnError=*/false);
       assert(U.size() <= MaxInputLen);
-      RunOne(U.data(), U.size());
+      if (!UseFeatureIndex) {
+        RunOne(U.data(), U.size());
+        CheckExitOnSrcPosOrItem();
+        TryDetectingAMemoryLeak(U.data(), U.size(),
+                                /*DuringInitialCorpusExecution*/ true);
+        continue;
+      }
+      std::string Sha1 = Hash(U);
+      // The copies of an input are only executed once.
+      if (NewIndex.count(Sha1))
+        continue;
+      FeatureIndexEntry &E = NewIndex[Sha1];
+      E.File = SF.File;
+      auto It = OldIndex.find(Sha1);
+      if (It != OldIndex.end()) {
+        E.Features = std::move(It->second.Features);
+        E.PCs = std::move(It->second.PCs);
+        AddIndexedInputToCorpus(U, E.Features, E.PCs);
+        NumIndexedInputs++;
+        CheckExitOnSrcPosOrItem();
+        continue;
+      }
+      if (RunOne(U.data(), U.size())) {
+        E.Features = UniqFeatureSetTmp;
+        E.PCs = TPC.NewObservedPCs();
+      }
       CheckExitOnSrcPosOrItem();
       TryDetectingAMemoryLeak(U.data(), U.size(),
                               /*DuringInitialCorpusExecution*/ true);
     }
+    if (UseFeatureIndex) {
+      Printf("INFO: feature index: %zd inputs not executed, %zd executed\n",
+             NumIndexedInputs, NewIndex.size() - NumIndexedInputs);
+      WriteFeatureIndex(Options.FeatureIndex, FeatureSpaceId, NewIndex);
+    }
   }
 
   PrintStats("INITED");
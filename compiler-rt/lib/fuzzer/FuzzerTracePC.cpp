@@ -187,8 +187,12 @@ ALWAYS_INLINE uintptr_t TracePC::GetNextInstructionPc(uintptr_t PC) {
 
 void TracePC::UpdateObservedPCs() {
   Vector<uintptr_t> CoveredFuncs;
+  NewObservedPCIdxs.clear();
   auto ObservePC = [&](const PCTableEntry *TE) {
-    if (ObservedPCs.insert(TE).second && DoPrintNewPCs) {
+    if (!ObservedPCs.insert(TE).second)
+      return;
+    NewObservedPCIdxs.push_back(PCTableEntryIdx(TE));
+    if (DoPrintNewPCs) {
       PrintPC("\tNEW_PC: %p %F %L", "\tNEW_PC: %p",
               GetNextInstructionPc(TE->PC));
       Printf("\n");
@@ -227,6 +231,40 @@ void TracePC::UpdateObservedPCs() {
   }
 }
 
+void TracePC::ObservePCs(const Vector<uint32_t> &PCIdxs) {
+  for (uint32_t Idx : PCIdxs) {
+    auto *TE = PCTableEntryByIdx(Idx);
+    if (!TE || !ObservedPCs.insert(TE).second)
+      continue;
+    if (PcIsFuncEntry(TE))
+      ++ObservedFuncs[TE->PC];
+  }
+}
+
+std::string TracePC::FeatureSpaceId() const {
+  // The PCs are taken relative to the start of their module, which moves
+  // from a run to the next.
+  Vector<uintptr_t> Id = {UseCounters, UseValueProfileMask, NumModules,
+                          NumPCTables,
+                          (uintptr_t)(ExtraCountersEnd() - ExtraCountersBegin())};
+  for (size_t i = 0; i < NumModules; i++) {
+    auto &M = Modules[i];
+    Id.push_back(M.Regions[M.NumRegions - 1].Stop - M.Regions[0].Start);
+  }
+  for (size_t i = 0; i < NumPCTables; i++) {
+    auto &M = ModulePCTable[i];
+    Id.push_back(M.Stop - M.Start);
+    for (auto *TE = M.Start; TE < M.Stop; TE++) {
+      Id.push_back(TE->PC - M.Start->PC);
+      Id.push_back(TE->PCFlags);
+    }
+  }
+  uint8_t Hash[kSHA1NumBytes];
+  ComputeSHA1(reinterpret_cast<const uint8_t *>(Id.data()),
+              Id.size() * sizeof(Id[0]), Hash);
+  return Sha1ToString(Hash);
+}
+
 uintptr_t TracePC::PCTableEntryIdx(const PCTableEntry *TE) {
   size_t TotalTEs = 0;
   for (size_t i = 0; i < NumPCTables; i++) {
@@ -469,6 +507,14 @@ void __sanitizer_cov_8bit_counters_init(uint8_t *Start, uint8_t *Stop) {
   fuzzer::TPC.HandleInline8bitCountersInit(Start, Stop);
 }
 
+// The flags are bytes which are 0 or 1: they are handled like counters, which
+// never get past the first bucket.
+ATTRIBUTE_INTERFACE
+void __sanitizer_cov_bool_flag_init(bool *Start, bool *Stop) {
+  fuzzer::TPC.HandleInline8bitCountersInit(reinterpret_cast<uint8_t *>(Start),
+                                           reinterpret_cast<uint8_t *>(Stop));
+}
+
 ATTRIBUTE_INTERFACE
 void __sanitizer_cov_pcs_init(const uintptr_t *pcs_beg,
                               const uintptr_t *pcs_end) {
@@ -79,6 +79,15 @@ class TracePC {
   void SetPrintNewPCs(bool P) { DoPrintNewPCs = P; }
   void SetPrintNewFuncs(size_t P) { NumPrintNewFuncs = P; }
   void UpdateObservedPCs();
+  // The PCTableEntryIdx of the PCs that the last call to UpdateObservedPCs()
+  // observed for the first time.
+  const Vector<uint32_t> &NewObservedPCs() const { return NewObservedPCIdxs; }
+  // Observes the PCs with these PCTableEntryIdx, e.g. the NewObservedPCs() of
+  // an input which isn't executed again.
+  void ObservePCs(const Vector<uint32_t> &PCIdxs);
+  // Identifies the instrumentation of the binary and the options which the
+  // features depend on: it changes when the features of an input may change.
+  std::string FeatureSpaceId() const;
   template <class Callback> void CollectFeatures(Callback CB) const;
 
   void ResetMaps() {
@@ -173,6 +182,7 @@ private:
   size_t NumPCsInPCTables;
 
   Set<const PCTableEntry*> ObservedPCs;
+  Vector<uint32_t> NewObservedPCIdxs;
   std::unordered_map<uintptr_t, uintptr_t> ObservedFuncs;  // PC => Counter.
 
   uint8_t *FocusFunctionCounterPtr = nullptr;
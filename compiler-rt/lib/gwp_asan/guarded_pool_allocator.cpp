@@ -66,40 +66,32 @@ void GuardedPoolAllocator::AllocationMetadata::RecordAllocation(
   Size = AllocSize;
   IsDeallocated = false;
 
-  // TODO(hctim): Ask the caller to provide the thread ID, so we don't waste
-  // other thread's time getting the thread ID under lock.
-  AllocationTrace.ThreadID = getThreadID();
-  AllocationTrace.TraceSize = 0;
   DeallocationTrace.TraceSize = 0;
   DeallocationTrace.ThreadID = kInvalidThreadID;
-
-  if (Backtrace) {
-    uintptr_t UncompressedBuffer[kMaxTraceLengthToCollect];
-    size_t BacktraceLength =
-        Backtrace(UncompressedBuffer, kMaxTraceLengthToCollect);
-    AllocationTrace.TraceSize = compression::pack(
-        UncompressedBuffer, BacktraceLength, AllocationTrace.CompressedTrace,
-        kStackFrameStorageBytes);
-  }
+  CollectTrace(&AllocationTrace, Backtrace);
 }
 
 void GuardedPoolAllocator::AllocationMetadata::RecordDeallocation(
-    options::Backtrace_t Backtrace) {
+    const CallSiteInfo &Trace) {
   IsDeallocated = true;
-  // Ensure that the unwinder is not called if the recursive flag is set,
-  // otherwise non-reentrant unwinders may deadlock.
-  DeallocationTrace.TraceSize = 0;
-  if (Backtrace && !ThreadLocals.RecursiveGuard) {
-    ScopedBoolean B(ThreadLocals.RecursiveGuard);
+  DeallocationTrace.ThreadID = Trace.ThreadID;
+  DeallocationTrace.TraceSize = Trace.TraceSize;
+  memcpy(DeallocationTrace.CompressedTrace, Trace.CompressedTrace,
+         Trace.TraceSize);
+}
 
-    uintptr_t UncompressedBuffer[kMaxTraceLengthToCollect];
-    size_t BacktraceLength =
-        Backtrace(UncompressedBuffer, kMaxTraceLengthToCollect);
-    DeallocationTrace.TraceSize = compression::pack(
-        UncompressedBuffer, BacktraceLength, DeallocationTrace.CompressedTrace,
-        kStackFrameStorageBytes);
-  }
-  DeallocationTrace.ThreadID = getThreadID();
+void GuardedPoolAllocator::AllocationMetadata::CollectTrace(
+    CallSiteInfo *Trace, options::Backtrace_t Backtrace) {
+  Trace->ThreadID = getThreadID();
+  Trace->TraceSize = 0;
+  if (!Backtrace)
+    return;
+  uintptr_t UncompressedBuffer[kMaxTraceLengthToCollect];
+  size_t BacktraceLength =
+      Backtrace(UncompressedBuffer, kMaxTraceLengthToCollect);
+  Trace->TraceSize =
+      compression::pack(UncompressedBuffer, BacktraceLength,
+                        Trace->CompressedTrace, kStackFrameStorageBytes);
 }
 
 void GuardedPoolAllocator::init(const options::Options &Opts) {
@@ -155,10 +147,12 @@ void GuardedPoolAllocator::init(const options::Options &Opts) {
   Metadata = reinterpret_cast<AllocationMetadata *>(mapMemory(BytesRequired));
   markReadWrite(Metadata, BytesRequired);
 
-  // Allocate memory and set up the free pages queue.
-  BytesRequired = MaxSimultaneousAllocations * sizeof(*FreeSlots);
-  FreeSlots = reinterpret_cast<size_t *>(mapMemory(BytesRequired));
-  markReadWrite(FreeSlots, BytesRequired);
+  // Allocate memory and set up the free slots bitmap, in which no slot is free
+  // to be reused yet.
+  BytesRequired =
+      ((MaxSimultaneousAllocations + 63) / 64) * sizeof(*FreeSlotsBitmap);
+  FreeSlotsBitmap = reinterpret_cast<uint64_t *>(mapMemory(BytesRequired));
+  markReadWrite(FreeSlotsBitmap, BytesRequired);
 
   // Multiply the sample rate by 2 to give a good, fast approximation for (1 /
   // SampleRate) chance of sampling.
@@ -192,12 +186,7 @@ void *GuardedPoolAllocator::allocate(size_t Size) {
   if (Size == 0 || Size > maximumAllocationSize())
     return nullptr;
 
-  size_t Index;
-  {
-    ScopedLock L(PoolMutex);
-    Index = reserveSlot();
-  }
-
+  size_t Index = reserveSlot();
   if (Index == kInvalidSlotID)
     return nullptr;
 
@@ -225,6 +214,17 @@ void GuardedPoolAllocator::deallocate(void *Ptr) {
     exit(EXIT_FAILURE);
   }
 
+  // Unwind before taking the mutex, so that the other threads don't wait for
+  // it. Ensure that the unwinder is not called if the recursive flag is set,
+  // otherwise non-reentrant unwinders may deadlock.
+  AllocationMetadata::CallSiteInfo Trace;
+  if (!ThreadLocals.RecursiveGuard) {
+    ScopedBoolean B(ThreadLocals.RecursiveGuard);
+    AllocationMetadata::CollectTrace(&Trace, Backtrace);
+  } else {
+    AllocationMetadata::CollectTrace(&Trace, nullptr);
+  }
+
   // Intentionally scope the mutex here, so that other threads can access the
   // pool during the expensive markInaccessible() call.
   {
@@ -237,14 +237,13 @@ void GuardedPoolAllocator::deallocate(void *Ptr) {
     // Ensure that the deallocation is recorded before marking the page as
     // inaccessible. Otherwise, a racy use-after-free will have inconsistent
     // metadata.
-    Meta->RecordDeallocation(Backtrace);
+    Meta->RecordDeallocation(Trace);
   }
 
   markInaccessible(reinterpret_cast<void *>(SlotStart),
                    maximumAllocationSize());
 
-  // And finally, lock again to release the slot back into the pool.
-  ScopedLock L(PoolMutex);
+  // And finally, release the slot back into the pool.
   freeSlot(addrToSlot(UPtr));
 }
 
@@ -287,21 +286,46 @@ bool GuardedPoolAllocator::isGuardPage(uintptr_t Ptr) const {
 size_t GuardedPoolAllocator::reserveSlot() {
   // Avoid potential reuse of a slot before we have made at least a single
   // allocation in each slot. Helps with our use-after-free detection.
-  if (NumSampledAllocations < MaxSimultaneousAllocations)
-    return NumSampledAllocations++;
-
-  if (FreeSlotsLength == 0)
-    return kInvalidSlotID;
+  size_t Sampled = __atomic_load_n(&NumSampledAllocations, __ATOMIC_RELAXED);
+  while (Sampled < MaxSimultaneousAllocations) {
+    if (__atomic_compare_exchange_n(&NumSampledAllocations, &Sampled,
+                                    Sampled + 1, /*weak=*/true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      return Sampled;
+  }
 
-  size_t ReservedIndex = getRandomUnsigned32() % FreeSlotsLength;
-  size_t SlotIndex = FreeSlots[ReservedIndex];
-  FreeSlots[ReservedIndex] = FreeSlots[--FreeSlotsLength];
-  return SlotIndex;
+  // Start from a random word of the bitmap, and from a random bit in each
+  // word, so that the reused slot is hard to predict.
+  const size_t NumWords = (MaxSimultaneousAllocations + 63) / 64;
+  const uint32_t Random = getRandomUnsigned32();
+  const unsigned Rotation = (Random >> 16) % 64;
+  size_t WordIndex = Random % NumWords;
+  for (size_t I = 0; I < NumWords; ++I) {
+    uint64_t *Word = &FreeSlotsBitmap[WordIndex];
+    uint64_t Bits = __atomic_load_n(Word, __ATOMIC_RELAXED);
+    while (Bits) {
+      const uint64_t Rotated =
+          Rotation ? (Bits >> Rotation) | (Bits << (64 - Rotation)) : Bits;
+      const unsigned Bit = (__builtin_ctzll(Rotated) + Rotation) % 64;
+      const uint64_t Mask = 1ULL << Bit;
+      // Pairs with the release in freeSlot(), so that the previous use of the
+      // slot is complete.
+      Bits = __atomic_fetch_and(Word, ~Mask, __ATOMIC_ACQUIRE);
+      if (Bits & Mask)
+        return WordIndex * 64 + Bit;
+    }
+    if (++WordIndex == NumWords)
+      WordIndex = 0;
+  }
+  return kInvalidSlotID;
 }
 
 void GuardedPoolAllocator::freeSlot(size_t SlotIndex) {
-  assert(FreeSlotsLength < MaxSimultaneousAllocations);
-  FreeSlots[FreeSlotsLength++] = SlotIndex;
+  assert(SlotIndex < MaxSimultaneousAllocations);
+  uint64_t *Word = &FreeSlotsBitmap[SlotIndex / 64];
+  const uint64_t Mask = 1ULL << (SlotIndex % 64);
+  assert(!(__atomic_load_n(Word, __ATOMIC_RELAXED) & Mask));
+  __atomic_fetch_or(Word, Mask, __ATOMIC_RELEASE);
 }
 
 uintptr_t GuardedPoolAllocator::allocationSlotOffset(size_t Size) const {
@@ -489,9 +513,11 @@ void GuardedPoolAllocator::reportErrorInternal(uintptr_t AccessPtr, Error E) {
     return;
   }
 
-  // Attempt to prevent races to re-use the same slot that triggered this error.
-  // This does not guarantee that there are no races, because another thread can
-  // take the locks during the time that the signal handler is being called.
+  // Attempt to prevent races to re-use the same slot that triggered this error:
+  // the deallocations block before they release their slot. This does not
+  // guarantee that there are no races, because another thread can take the
+  // locks during the time that the signal handler is being called, and the
+  // slots freed earlier are reserved without the lock.
   PoolMutex.tryLock();
   ThreadLocals.RecursiveGuard = true;
 
@@ -50,13 +50,6 @@ public:
     // frames are compressed into a fixed memory range.
     static constexpr size_t kMaxTraceLengthToCollect = 128;
 
-    // Records the given allocation metadata into this struct.
-    void RecordAllocation(uintptr_t Addr, size_t Size,
-                          options::Backtrace_t Backtrace);
-
-    // Record that this allocation is now deallocated.
-    void RecordDeallocation(options::Backtrace_t Backtrace);
-
     struct CallSiteInfo {
       // The compressed backtrace to the allocation/deallocation.
       uint8_t CompressedTrace[kStackFrameStorageBytes];
@@ -67,6 +60,20 @@ public:
       size_t TraceSize = 0;
     };
 
+    // Records the given allocation metadata into this struct.
+    void RecordAllocation(uintptr_t Addr, size_t Size,
+                          options::Backtrace_t Backtrace);
+
+    // Record that this allocation is now deallocated, along with the trace of
+    // the deallocation.
+    void RecordDeallocation(const CallSiteInfo &Trace);
+
+    // Collects the compressed backtrace and the ID of the calling thread into
+    // Trace. This doesn't touch the metadata, so that the unwinding happens
+    // outside of the pool lock.
+    static void CollectTrace(CallSiteInfo *Trace,
+                             options::Backtrace_t Backtrace);
+
     // The address of this allocation.
     uintptr_t Addr = 0;
     // Represents the actual size of the allocation.
@@ -192,10 +199,10 @@ private:
   bool isGuardPage(uintptr_t Ptr) const;
 
   // Reserve a slot for a new guarded allocation. Returns kInvalidSlotID if no
-  // slot is available to be reserved.
+  // slot is available to be reserved. Lock-free.
   size_t reserveSlot();
 
-  // Unreserve the guarded slot.
+  // Unreserve the guarded slot. Lock-free.
   void freeSlot(size_t SlotIndex);
 
   // Returns the offset (in bytes) between the start of a guarded slot and where
@@ -213,13 +220,14 @@ private:
   // Cached page size for this system in bytes.
   size_t PageSize = 0;
 
-  // A mutex to protect the guarded slot and metadata pool for this class.
+  // A mutex to protect the metadata pool for this class. The slots are managed
+  // without it.
   Mutex PoolMutex;
   // The number of guarded slots that this pool holds.
   size_t MaxSimultaneousAllocations = 0;
   // Record the number allocations that we've sampled. We store this amount so
   // that we don't randomly choose to recycle a slot that previously had an
-  // allocation before all the slots have been utilised.
+  // allocation before all the slots have been utilised. Accessed atomically.
   size_t NumSampledAllocations = 0;
   // Pointer to the pool of guarded slots. Note that this points to the start of
   // the pool (which is a guard page), not a pointer to the first guarded page.
@@ -229,10 +237,10 @@ private:
   // if any.
   AllocationMetadata *Metadata = nullptr;
 
-  // Pointer to an array of free slot indexes.
-  size_t *FreeSlots = nullptr;
-  // The current length of the list of free slots.
-  size_t FreeSlotsLength = 0;
+  // Pointer to a bitmap of the free slots, which is accessed atomically. A set
+  // bit marks a slot that was used and freed, and can be reserved again. The
+  // slots which were never used are handed out with NumSampledAllocations.
+  uint64_t *FreeSlotsBitmap = nullptr;
 
   // See options.{h, inc} for more information.
   bool PerfectlyRightAlign = false;
@@ -70,3 +70,31 @@ TEST_F(CustomGuardedPoolAllocator, NoReuseBeforeNecessary129) {
   InitNumSlots(kPoolSize);
   runNoReuseBeforeNecessary(&GPA, kPoolSize);
 }
+
+// Once all the slots are used, the freed slots are all available for reuse.
+void runReuseAllSlots(gwp_asan::GuardedPoolAllocator *GPA, unsigned PoolSize) {
+  for (unsigned Round = 0; Round < 3; ++Round) {
+    std::set<void *> Ptrs;
+    for (unsigned i = 0; i < PoolSize; ++i) {
+      void *Ptr = GPA->allocate(1);
+      EXPECT_TRUE(GPA->pointerIsMine(Ptr));
+      EXPECT_EQ(0u, Ptrs.count(Ptr));
+      Ptrs.insert(Ptr);
+    }
+    EXPECT_EQ(nullptr, GPA->allocate(1));
+    for (void *Ptr : Ptrs)
+      GPA->deallocate(Ptr);
+  }
+}
+
+TEST_F(CustomGuardedPoolAllocator, ReuseAllSlots1) {
+  constexpr unsigned kPoolSize = 1;
+  InitNumSlots(kPoolSize);
+  runReuseAllSlots(&GPA, kPoolSize);
+}
+
+TEST_F(CustomGuardedPoolAllocator, ReuseAllSlots129) {
+  constexpr unsigned kPoolSize = 129;
+  InitNumSlots(kPoolSize);
+  runReuseAllSlots(&GPA, kPoolSize);
+}
@@ -36,6 +36,8 @@ using namespace __sanitizer;
 // Globals.
 static THREADLOCAL int msan_expect_umr = 0;
 static THREADLOCAL int msan_expected_umr_found = 0;
+// Counts the uninitialized stores of the thread, for origin_history_sample_rate.
+static THREADLOCAL u32 msan_store_origin_count = 0;
 
 // Function argument shadow. Each argument starts at the next available 8-byte
 // aligned address.
@@ -217,6 +219,7 @@ static void InitializeFlags() {
     Die();
   }
   if (f->store_context_size < 1) f->store_context_size = 1;
+  if (f->origin_history_sample_rate < 1) f->origin_history_sample_rate = 1;
 }
 
 void PrintWarning(uptr pc, uptr bp) {
@@ -286,6 +289,11 @@ const char *GetStackOriginDescr(u32 id, uptr *pc) {
   return StackOriginDescr[id];
 }
 
+bool ShouldChainStoreOrigin() {
+  int rate = flags()->origin_history_sample_rate;
+  return rate == 1 || msan_store_origin_count++ % rate == 0;
+}
+
 u32 ChainOrigin(u32 id, StackTrace *stack) {
   MsanThread *t = GetCurrentThread();
   if (t && t->InSignalHandler())
@@ -339,7 +347,8 @@ MSAN_MAYBE_WARNING(u64, 8)
 #define MSAN_MAYBE_STORE_ORIGIN(type, size)                       \
   void __msan_maybe_store_origin_##size(type s, void *p, u32 o) { \
     if (UNLIKELY(s)) {                                            \
-      if (__msan_get_track_origins() > 1) {                       \
+      if (__msan_get_track_origins() > 1 &&                       \
+          ShouldChainStoreOrigin()) {                             \
         GET_CALLER_PC_BP_SP;                                      \
         (void) sp;                                                \
         GET_STORE_STACK_TRACE_PC_BP(pc, bp);                      \
@@ -587,6 +596,8 @@ void __msan_set_alloca_origin4(void *a, uptr size, char *descr, uptr pc) {
 }
 
 u32 __msan_chain_origin(u32 id) {
+  if (!ShouldChainStoreOrigin())
+    return id;
   GET_CALLER_PC_BP_SP;
   (void)sp;
   GET_STORE_STACK_TRACE_PC_BP(pc, bp);
@@ -321,6 +321,10 @@ void UnpoisonThreadLocalState();
 // the previous origin id.
 u32 ChainOrigin(u32 id, StackTrace *stack);
 
+// Returns false for the uninitialized stores which are left out of the origin
+// history by origin_history_sample_rate. Their origin is stored unchanged.
+bool ShouldChainStoreOrigin();
+
 const int STACK_TRACE_TAG_POISON = StackTrace::TAG_CUSTOM + 1;
 
 #define GET_MALLOC_STACK_TRACE                                            \
@@ -27,6 +27,9 @@ COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_magic(void) {
 
 static unsigned ProfileDumped = 0;
 
+COMPILER_RT_VISIBILITY ProfCounterShard *lprofCounterShards = NULL;
+static void *CounterShardsLock = NULL;
+
 COMPILER_RT_VISIBILITY unsigned lprofProfileDumped() {
   return ProfileDumped;
 }
@@ -57,6 +60,14 @@ COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
 
   memset(I, 0, sizeof(uint64_t) * (E - I));
 
+  /* Drop what the shards have counted so far, without writing to the
+   * counters of running threads. */
+  ProfCounterShard *Shard;
+  lprofLockCounterShards();
+  for (Shard = lprofCounterShards; Shard; Shard = Shard->Next)
+    memcpy(Shard->Reported, Shard->Counters, sizeof(uint64_t) * (E - I));
+  lprofUnlockCounterShards();
+
   const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
   const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
   const __llvm_profile_data *DI;
@@ -82,3 +93,36 @@ COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
   }
   ProfileDumped = 0;
 }
+
+COMPILER_RT_VISIBILITY void lprofLockCounterShards(void) {
+  while (!COMPILER_RT_BOOL_CMPXCHG(&CounterShardsLock, NULL, (void *)1))
+    ;
+}
+
+COMPILER_RT_VISIBILITY void lprofUnlockCounterShards(void) {
+  COMPILER_RT_BOOL_CMPXCHG(&CounterShardsLock, (void *)1, NULL);
+}
+
+COMPILER_RT_VISIBILITY void lprofFoldCounterShard(ProfCounterShard *Shard) {
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t *CountersEnd = __llvm_profile_end_counters();
+  size_t NumCounters = CountersEnd - CountersBegin;
+  size_t I;
+
+  for (I = 0; I != NumCounters; ++I) {
+    uint64_t Count = ((volatile uint64_t *)Shard->Counters)[I];
+    if (Count == Shard->Reported[I])
+      continue;
+    COMPILER_RT_U64_FETCH_ADD(&CountersBegin[I], Count - Shard->Reported[I]);
+    Shard->Reported[I] = Count;
+  }
+}
+
+COMPILER_RT_VISIBILITY void lprofFoldCounterShards(void) {
+  ProfCounterShard *Shard;
+
+  lprofLockCounterShards();
+  for (Shard = lprofCounterShards; Shard; Shard = Shard->Next)
+    lprofFoldCounterShard(Shard);
+  lprofUnlockCounterShards();
+}
@@ -44,6 +44,19 @@ typedef struct ValueProfNode {
  */
 uint8_t __llvm_profile_get_num_padding_bytes(uint64_t SizeInBytes);
 
+/*!
+ * \brief Get the number of padding bytes before and after the counters, and
+ * after the names, in the raw profile.
+ *
+ * \p DataSize is the number of profile data entries, \p CountersSize the
+ * number of counters and \p NamesSize the size of the names in bytes. The
+ * counters are only padded out to a page boundary in continuous mode.
+ */
+void __llvm_profile_get_padding_sizes_for_counters(
+    uint64_t DataSize, uint64_t CountersSize, uint64_t NamesSize,
+    uint64_t *PaddingBytesBeforeCounters, uint64_t *PaddingBytesAfterCounters,
+    uint64_t *PaddingBytesAfterNames);
+
 /*!
  * \brief Get required size for profile buffer.
  */
@@ -200,6 +213,40 @@ const char *__llvm_profile_get_path_prefix();
  */
 const char *__llvm_profile_get_filename();
 
+/*!
+ * \brief Return non-zero if continuous mode is enabled.
+ *
+ * In continuous mode, which the \c %c filename specifier enables, the
+ * counters are mapped from the profile file when the program starts, so that
+ * the file is always up to date and nothing needs to be written at exit. The
+ * counters are mapped in place if their section is page-aligned, as it is on
+ * Darwin. Elsewhere the program must be instrumented with
+ * \c -mllvm \c -runtime-counter-relocation, which lets the runtime move the
+ * counters to the mapping. Value profile data is not kept in the file. If
+ * the counters cannot be mapped, the profile is written at exit as usual.
+ */
+int __llvm_profile_is_continuous_mode_enabled(void);
+
+/*!
+ * \brief Enable continuous mode.
+ *
+ * See \ref __llvm_profile_is_continuous_mode_enabled. This only takes effect
+ * before the profile file is initialized, which is why it is normally
+ * requested with the \c %c filename specifier.
+ */
+void __llvm_profile_enable_continuous_mode(void);
+
+/*!
+ * \brief Give the calling thread its own copy of the counters.
+ *
+ * Code instrumented with \c -mllvm \c -instrprof-counter-shards calls this
+ * on the first call of each thread into it, and from then on updates the
+ * returned shard rather than the counters shared by all threads. Shards are
+ * added to the counters when the profile is written. Returns the offset from
+ * the counters to the shard, or zero if the shard cannot be allocated.
+ */
+intptr_t INSTR_PROF_ACQUIRE_COUNTER_SHARD_FUNC(void);
+
 /*! \brief Get the magic token for the file format. */
 uint64_t __llvm_profile_get_magic(void);
 
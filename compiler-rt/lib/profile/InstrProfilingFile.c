@@ -99,8 +99,24 @@ static FILE *ProfileFile = NULL;
 static FILE *getProfileFile() { return ProfileFile; }
 static void setProfileFile(FILE *File) { ProfileFile = File; }
 
+/* Set once the counters live in a shared mapping of the profile file, after
+ * which there is nothing left to write at exit. */
+static int ProfileCountersMapped = 0;
+
+#if !defined(_WIN32)
+/* The compiler defines this variable, and adds it to the address of every
+ * counter it updates, when the program is instrumented with
+ * -runtime-counter-relocation. Otherwise the weak reference is null. */
+COMPILER_RT_WEAK extern intptr_t INSTR_PROF_PROFILE_COUNTER_BIAS_VAR;
+#endif
+
 COMPILER_RT_VISIBILITY void __llvm_profile_set_file_object(FILE *File,
                                                            int EnableMerge) {
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    PROF_WARN("%s\n", "__llvm_profile_set_file_object is not supported in "
+                      "continuous mode (%c).");
+    return;
+  }
   setProfileFile(File);
   setProfileMergeRequested(EnableMerge);
 }
@@ -121,6 +137,17 @@ static uint32_t fileWriter(ProfDataWriter *This, ProfDataIOVec *IOVecs,
       if (fwrite(IOVecs[I].Data, IOVecs[I].ElmSize, IOVecs[I].NumElm, File) !=
           IOVecs[I].NumElm)
         return 1;
+    } else if (IOVecs[I].UseZeroPadding) {
+      static const char Zeroes[64] = {0};
+      size_t BytesToWrite = IOVecs[I].ElmSize * IOVecs[I].NumElm;
+      while (BytesToWrite > 0) {
+        size_t PartialWriteLen =
+            BytesToWrite < sizeof(Zeroes) ? BytesToWrite : sizeof(Zeroes);
+        if (fwrite(Zeroes, sizeof(uint8_t), PartialWriteLen, File) !=
+            PartialWriteLen)
+          return 1;
+        BytesToWrite -= PartialWriteLen;
+      }
     } else {
       if (fseek(File, IOVecs[I].ElmSize * IOVecs[I].NumElm, SEEK_CUR) == -1)
         return 1;
@@ -357,6 +384,110 @@ static void truncateCurrentFile(void) {
   fclose(File);
 }
 
+/* Write the profile, except for the value profile data, to the profile file
+ * and map the counters from the file, so that the counts in the file stay up
+ * to date while the program runs. The counters are mapped in place if their
+ * section is page-aligned. Otherwise the program must be instrumented with
+ * runtime counter relocation, and the counters are moved to the mapping by
+ * setting the counter bias. */
+static void initializeProfileForContinuousMode(void) {
+#if defined(_WIN32)
+  PROF_ERR("%s\n", "Continuous mode is not supported on Windows.");
+#else
+  const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
+  const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t *CountersEnd = __llvm_profile_end_counters();
+  const char *NamesBegin = __llvm_profile_begin_names();
+  const char *NamesEnd = __llvm_profile_end_names();
+  const uint64_t DataSize = __llvm_profile_get_data_size(DataBegin, DataEnd);
+  const uint64_t CountersSize = CountersEnd - CountersBegin;
+  const uint64_t NamesSize = NamesEnd - NamesBegin;
+  const int UseCounterBias = &INSTR_PROF_PROFILE_COUNTER_BIAS_VAR != NULL;
+  const uintptr_t PageSize = lprofGetPageSize();
+  uint64_t PaddingBytesBeforeCounters, PaddingBytesAfterCounters,
+      PaddingBytesAfterNames;
+  uint64_t CountersOffset, CountersLength;
+  const char *Filename;
+  char *FilenameBuf;
+  FILE *File;
+  int Length, MergeDone = 0;
+  void *Mapping;
+
+  if (ProfileCountersMapped || !DataSize || !CountersSize)
+    return;
+
+  __llvm_profile_get_padding_sizes_for_counters(
+      DataSize, CountersSize, NamesSize, &PaddingBytesBeforeCounters,
+      &PaddingBytesAfterCounters, &PaddingBytesAfterNames);
+  CountersOffset = sizeof(__llvm_profile_header) +
+                   DataSize * sizeof(__llvm_profile_data) +
+                   PaddingBytesBeforeCounters;
+  CountersLength = CountersSize * sizeof(uint64_t) + PaddingBytesAfterCounters;
+
+  /* Mapping the counters in place must not clobber whatever follows them in
+   * the last page: either they end on a page boundary, or the page-aligned
+   * data section starts right after that page. */
+  if (!UseCounterBias &&
+      ((uintptr_t)CountersBegin % PageSize != 0 ||
+       ((uintptr_t)CountersEnd % PageSize != 0 &&
+        (uintptr_t)DataBegin != (uintptr_t)CountersBegin + CountersLength))) {
+    PROF_ERR("Continuous mode requires a page-aligned counter section, or "
+             "instrumentation with -runtime-counter-relocation (counters = "
+             "%p, page size = %u).\n",
+             (void *)CountersBegin, (unsigned)PageSize);
+    return;
+  }
+
+  Length = getCurFilenameLength();
+  FilenameBuf = (char *)COMPILER_RT_ALLOCA(Length + 1);
+  Filename = getCurFilename(FilenameBuf, 0);
+  if (!Filename)
+    return;
+
+  /* When merging, the counts in the file are added to the in-memory counters
+   * first, so that they carry over into the mapping. */
+  if (doMerging())
+    File = openFileForMerging(Filename, &MergeDone);
+  else {
+    createProfileDir(Filename);
+    File = fopen(Filename, "w+b");
+  }
+  if (!File) {
+    PROF_ERR("Continuous mode failed to open \"%s\": %s\n", Filename,
+             strerror(errno));
+    return;
+  }
+
+  /* Write the profile, which also makes the file large enough to map. */
+  ProfDataWriter FileWriter;
+  initFileWriter(&FileWriter, File);
+  if (lprofWriteData(&FileWriter, NULL, MergeDone) || fflush(File)) {
+    PROF_ERR("Continuous mode failed to write \"%s\": %s\n", Filename,
+             strerror(errno));
+  } else {
+    Mapping = mmap(UseCounterBias ? NULL : (void *)CountersBegin,
+                   CountersLength, PROT_READ | PROT_WRITE,
+                   UseCounterBias ? MAP_SHARED : MAP_SHARED | MAP_FIXED,
+                   fileno(File), CountersOffset);
+    if (Mapping == MAP_FAILED) {
+      PROF_ERR("Continuous mode failed to map \"%s\": %s\n", Filename,
+               strerror(errno));
+    } else {
+      if (UseCounterBias)
+        INSTR_PROF_PROFILE_COUNTER_BIAS_VAR =
+            (intptr_t)Mapping - (intptr_t)CountersBegin;
+      ProfileCountersMapped = 1;
+    }
+  }
+
+  if (doMerging())
+    lprofUnlockFileHandle(File);
+  /* The mapping outlives the file handle. */
+  fclose(File);
+#endif
+}
+
 static const char *DefaultProfileName = "default.profraw";
 static void resetFilenameToDefault(void) {
   if (lprofCurFilename.FilenamePat && lprofCurFilename.OwnsFilenamePat) {
@@ -383,6 +514,7 @@ static int parseFilenamePattern(const char *FilenamePat,
   char *PidChars = &lprofCurFilename.PidChars[0];
   char *Hostname = &lprofCurFilename.Hostname[0];
   int MergingEnabled = 0;
+  int ContinuousModeRequested = 0;
 
   /* Clean up cached prefix and filename.  */
   if (lprofCurFilename.ProfilePathPrefix)
@@ -435,11 +567,20 @@ static int parseFilenamePattern(const char *FilenamePat,
           lprofCurFilename.MergePoolSize = FilenamePat[I] - '0';
           I++; /* advance to 'm' */
         }
+      } else if (FilenamePat[I] == 'c') {
+        if (ContinuousModeRequested) {
+          PROF_WARN("%%c specifier can only be specified once in %s.\n",
+                    FilenamePat);
+          return -1;
+        }
+        ContinuousModeRequested = 1;
       }
     }
 
   lprofCurFilename.NumPids = NumPids;
   lprofCurFilename.NumHosts = NumHosts;
+  if (ContinuousModeRequested)
+    __llvm_profile_enable_continuous_mode();
   return 0;
 }
 
@@ -478,6 +619,8 @@ static void parseAndSetFilename(const char *FilenamePat,
   }
 
   truncateCurrentFile();
+  if (__llvm_profile_is_continuous_mode_enabled())
+    initializeProfileForContinuousMode();
 }
 
 /* Return buffer length that is required to store the current profile
@@ -490,7 +633,8 @@ static int getCurFilenameLength() {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize))
+        lprofCurFilename.MergePoolSize ||
+        __llvm_profile_is_continuous_mode_enabled()))
     return strlen(lprofCurFilename.FilenamePat);
 
   Len = strlen(lprofCurFilename.FilenamePat) +
@@ -514,7 +658,8 @@ static const char *getCurFilename(char *FilenameBuf, int ForceUseBuf) {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize)) {
+        lprofCurFilename.MergePoolSize ||
+        __llvm_profile_is_continuous_mode_enabled())) {
     if (!ForceUseBuf)
       return lprofCurFilename.FilenamePat;
 
@@ -653,6 +798,12 @@ void __llvm_profile_initialize_file(void) {
  */
 COMPILER_RT_VISIBILITY
 void __llvm_profile_set_filename(const char *FilenamePat) {
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    PROF_WARN("Profile file name \"%s\" ignored: the counters are already "
+              "synced to a file in continuous mode.\n",
+              FilenamePat ? FilenamePat : "");
+    return;
+  }
   parseAndSetFilename(FilenamePat, PNS_runtime_api, 1);
 }
 
@@ -672,6 +823,13 @@ int __llvm_profile_write_file(void) {
     return 0;
   }
 
+  /* The file is already up to date, once the counter shards are added to
+   * the mapped counters. */
+  if (ProfileCountersMapped) {
+    lprofFoldCounterShards();
+    return 0;
+  }
+
   Length = getCurFilenameLength();
   FilenameBuf = (char *)COMPILER_RT_ALLOCA(Length + 1);
   Filename = getCurFilename(FilenameBuf, 0);
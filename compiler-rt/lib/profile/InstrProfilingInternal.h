@@ -46,6 +46,9 @@ typedef struct ProfDataIOVec {
   const void *Data;
   size_t ElmSize;
   size_t NumElm;
+  /* If Data is null, the writer either writes zeroes (UseZeroPadding is set)
+   * or skips over space of the given size. */
+  int UseZeroPadding;
 } ProfDataIOVec;
 
 struct ProfDataWriter;
@@ -177,6 +180,33 @@ uint64_t lprofGetLoadModuleSignature();
 unsigned lprofProfileDumped();
 void lprofSetProfileDumped();
 
+/* The counters of one thread of a program instrumented with per-thread
+ * counter shards. Only the owning thread writes Counters. Reported holds the
+ * part of each count that has already been added to the shared counters, so
+ * the runtime never has to modify the counters of a running thread. When the
+ * thread exits, the rest of its counts are added to the shared counters and
+ * the shard is freed (not on Windows, where shards live until exit). */
+typedef struct ProfCounterShard {
+  struct ProfCounterShard *Next;
+  uint64_t *Counters;
+  uint64_t *Reported;
+} ProfCounterShard;
+
+/* The list of the counter shards of the live threads. Access it with the
+ * shard lock held. */
+COMPILER_RT_VISIBILITY extern ProfCounterShard *lprofCounterShards;
+void lprofLockCounterShards(void);
+void lprofUnlockCounterShards(void);
+
+/* Add the counts of Shard not reported yet to the shared counters, with
+ * atomic adds. Called with the shard lock held. */
+void lprofFoldCounterShard(ProfCounterShard *Shard);
+
+/* Fold every counter shard, so that the shared counters hold the counts of
+ * all threads. This is safe while other threads keep counting: whatever they
+ * add afterwards is reported by the next fold, or when they exit. */
+void lprofFoldCounterShards(void);
+
 COMPILER_RT_VISIBILITY extern void (*FreeHook)(void *);
 COMPILER_RT_VISIBILITY extern uint8_t *DynamicBufferIOBuffer;
 COMPILER_RT_VISIBILITY extern uint32_t VPBufferSize;
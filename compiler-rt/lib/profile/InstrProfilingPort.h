@@ -22,6 +22,7 @@
 /* Need to include <stdio.h> and <io.h> */
 #define COMPILER_RT_FTRUNCATE(f,l) _chsize(_fileno(f),l)
 #define COMPILER_RT_ALWAYS_INLINE __forceinline
+#define COMPILER_RT_THREAD_LOCAL __declspec(thread)
 #elif __GNUC__
 #define COMPILER_RT_ALIGNAS(x) __attribute__((aligned(x)))
 #define COMPILER_RT_VISIBILITY __attribute__((visibility("hidden")))
@@ -29,6 +30,7 @@
 #define COMPILER_RT_ALLOCA __builtin_alloca
 #define COMPILER_RT_FTRUNCATE(f,l) ftruncate(fileno(f),l)
 #define COMPILER_RT_ALWAYS_INLINE inline __attribute((always_inline))
+#define COMPILER_RT_THREAD_LOCAL __thread
 #endif
 
 #if defined(__APPLE__)
@@ -63,6 +65,8 @@
 #define COMPILER_RT_PTR_FETCH_ADD(DomType, PtrVar, PtrIncr)                    \
   (DomType *)InterlockedExchangeAdd64((LONGLONG volatile *)&PtrVar,            \
                                       (LONGLONG)sizeof(DomType) * PtrIncr)
+#define COMPILER_RT_U64_FETCH_ADD(Ptr, Incr)                                   \
+  InterlockedExchangeAdd64((LONGLONG volatile *)Ptr, (LONGLONG)Incr)
 #else /* !defined(_WIN64) */
 #define COMPILER_RT_BOOL_CMPXCHG(Ptr, OldV, NewV)                              \
   (InterlockedCompareExchange((LONG volatile *)Ptr, (LONG)NewV, (LONG)OldV) == \
@@ -70,12 +74,15 @@
 #define COMPILER_RT_PTR_FETCH_ADD(DomType, PtrVar, PtrIncr)                    \
   (DomType *)InterlockedExchangeAdd((LONG volatile *)&PtrVar,                  \
                                     (LONG)sizeof(DomType) * PtrIncr)
+#define COMPILER_RT_U64_FETCH_ADD(Ptr, Incr)                                   \
+  InterlockedExchangeAdd64((LONGLONG volatile *)Ptr, (LONGLONG)Incr)
 #endif
 #else /* !defined(_MSC_VER) */
 #define COMPILER_RT_BOOL_CMPXCHG(Ptr, OldV, NewV)                              \
   __sync_bool_compare_and_swap(Ptr, OldV, NewV)
 #define COMPILER_RT_PTR_FETCH_ADD(DomType, PtrVar, PtrIncr)                    \
   (DomType *)__sync_fetch_and_add((long *)&PtrVar, sizeof(DomType) * PtrIncr)
+#define COMPILER_RT_U64_FETCH_ADD(Ptr, Incr) __sync_fetch_and_add(Ptr, Incr)
 #endif
 #else /* COMPILER_RT_HAS_ATOMICS != 1 */
 #include "InstrProfilingUtil.h"
@@ -83,6 +90,7 @@
   lprofBoolCmpXchg((void **)Ptr, OldV, NewV)
 #define COMPILER_RT_PTR_FETCH_ADD(DomType, PtrVar, PtrIncr)                    \
   (DomType *)lprofPtrFetchAdd((void **)&PtrVar, sizeof(DomType) * PtrIncr)
+#define COMPILER_RT_U64_FETCH_ADD(Ptr, Incr) (*(Ptr) += (Incr))
 #endif
 
 #if defined(_WIN32)
@@ -0,0 +1,82 @@
+/*===- InstrProfilingShards.c - Per-thread profile counters ---------------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* This lives in its own object file, so that only the programs instrumented
+ * with -instrprof-counter-shards need thread-local storage. */
+
+#include <stdint.h>
+#include <stdlib.h>
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+
+/* The offset from the counters to the counter shard of the current thread,
+ * which instrumented code adds to the address of every counter it updates. */
+COMPILER_RT_VISIBILITY COMPILER_RT_THREAD_LOCAL intptr_t
+    INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR = 0;
+
+#if !defined(_WIN32)
+static pthread_key_t CounterShardKey;
+static pthread_once_t CounterShardKeyOnce = PTHREAD_ONCE_INIT;
+
+/* Hand the counts of an exiting thread over to the shared counters. */
+static void releaseCounterShard(void *Ptr) {
+  ProfCounterShard *Shard = (ProfCounterShard *)Ptr;
+  ProfCounterShard **I;
+
+  /* Anything this thread still counts goes to the shared counters. */
+  INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR = 0;
+
+  lprofLockCounterShards();
+  for (I = &lprofCounterShards; *I; I = &(*I)->Next) {
+    if (*I == Shard) {
+      *I = Shard->Next;
+      break;
+    }
+  }
+  lprofFoldCounterShard(Shard);
+  lprofUnlockCounterShards();
+  free(Shard);
+}
+
+static void createCounterShardKey(void) {
+  pthread_key_create(&CounterShardKey, releaseCounterShard);
+}
+#endif
+
+COMPILER_RT_VISIBILITY intptr_t INSTR_PROF_ACQUIRE_COUNTER_SHARD_FUNC(void) {
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t *CountersEnd = __llvm_profile_end_counters();
+  size_t NumCounters = CountersEnd - CountersBegin;
+  ProfCounterShard *Shard;
+
+  Shard = (ProfCounterShard *)calloc(1, sizeof(ProfCounterShard) +
+                                            2 * NumCounters * sizeof(uint64_t));
+  /* Count into the shared counters, and try again on the next call. */
+  if (!Shard)
+    return 0;
+  Shard->Counters = (uint64_t *)(Shard + 1);
+  Shard->Reported = Shard->Counters + NumCounters;
+
+#if !defined(_WIN32)
+  pthread_once(&CounterShardKeyOnce, createCounterShardKey);
+  pthread_setspecific(CounterShardKey, Shard);
+#endif
+
+  lprofLockCounterShards();
+  Shard->Next = lprofCounterShards;
+  lprofCounterShards = Shard;
+  lprofUnlockCounterShards();
+
+  INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR =
+      (intptr_t)Shard->Counters - (intptr_t)CountersBegin;
+  return INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR;
+}
@@ -307,6 +307,16 @@ COMPILER_RT_VISIBILITY const char *lprofFindLastDirSeparator(const char *Path) {
   return Sep;
 }
 
+COMPILER_RT_VISIBILITY int lprofGetPageSize() {
+#if defined(_WIN32)
+  SYSTEM_INFO SystemInfo;
+  GetNativeSystemInfo(&SystemInfo);
+  return SystemInfo.dwPageSize;
+#else
+  return sysconf(_SC_PAGESIZE);
+#endif
+}
+
 COMPILER_RT_VISIBILITY int lprofSuspendSigKill() {
 #if defined(__linux__)
   int PDeachSig = 0;
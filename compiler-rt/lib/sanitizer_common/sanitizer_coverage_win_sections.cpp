@@ -45,13 +45,20 @@ __declspec(allocate(".SCOV$CA")) uint64_t __start___sancov_cntrs = 0;
 __declspec(allocate(".SCOV$CZ")) __declspec(align(1)) uint8_t
     __stop___sancov_cntrs = 0;
 
+// Same for the bool flags, which are 1 byte each too.
+#pragma section(".SCOV$BA", read, write)  // NOLINT
+__declspec(allocate(".SCOV$BA")) uint64_t __start___sancov_bools = 0;
+#pragma section(".SCOV$BZ", read, write)  // NOLINT
+__declspec(allocate(".SCOV$BZ")) __declspec(align(1)) uint8_t
+    __stop___sancov_bools = 0;
+
 #pragma section(".SCOV$GA", read, write)  // NOLINT
 __declspec(allocate(".SCOV$GA")) uint64_t __start___sancov_guards = 0;
 #pragma section(".SCOV$GZ", read, write)  // NOLINT
 __declspec(allocate(".SCOV$GZ")) __declspec(align(1)) uint8_t
     __stop___sancov_guards = 0;
 
-// The guard array and counter array should both be merged into the .data
+// The guard, counter and bool flag arrays should all be merged into the .data
 // section to reduce the number of PE sections. However, because PCTable is
 // constant it should be merged with the .rdata section.
 #pragma comment(linker, "/MERGE:.SCOV=.data")
@@ -39,17 +39,22 @@ class StackDepotBase {
   static Node *find(Node *s, args_type args, u32 hash);
   static Node *lock(atomic_uintptr_t *p);
   static void unlock(atomic_uintptr_t *p, Node *s);
+  atomic_uintptr_t *id_slot(u32 id, bool create);
 
   static const int kTabSize = 1 << kTabSizeLog;  // Hash table size.
-  static const int kPartBits = 8;
-  static const int kPartShift = sizeof(u32) * 8 - kPartBits - kReservedBits;
-  static const int kPartCount =
-      1 << kPartBits;  // Number of subparts in the table.
-  static const int kPartSize = kTabSize / kPartCount;
-  static const int kMaxId = 1 << kPartShift;
-
-  atomic_uintptr_t tab[kTabSize];   // Hash table of Node's.
-  atomic_uint32_t seq[kPartCount];  // Unique id generators.
+  static const u32 kMaxId = 1u << (sizeof(u32) * 8 - kReservedBits);
+  // The nodes are also indexed by id, so that Get() doesn't have to search the
+  // hash table. The index has two levels, and the chunks of the second level
+  // are allocated as the ids are handed out.
+  static const int kIdChunkSizeLog = 12;
+  static const uptr kIdChunkSize = 1 << kIdChunkSizeLog;
+  static const uptr kIdChunkCount = kMaxId >> kIdChunkSizeLog;
+
+  atomic_uintptr_t tab[kTabSize];  // Hash table of Node's.
+  atomic_uint32_t seq;             // Unique id generator.
+  // Chunks of kIdChunkSize Node pointers, by id.
+  atomic_uintptr_t id_tab[kIdChunkCount];
+  StaticSpinMutex id_tab_mtx;  // Protects the allocation of the chunks.
 
   StackDepotStats stats;
 
@@ -92,6 +97,27 @@ void StackDepotBase<Node, kReservedBits, kTabSizeLog>::unlock(
   atomic_store(p, (uptr)s, memory_order_release);
 }
 
+template <class Node, int kReservedBits, int kTabSizeLog>
+atomic_uintptr_t *StackDepotBase<Node, kReservedBits, kTabSizeLog>::id_slot(
+    u32 id, bool create) {
+  atomic_uintptr_t *p = &id_tab[id >> kIdChunkSizeLog];
+  uptr chunk = atomic_load(p, memory_order_acquire);
+  if (!chunk) {
+    if (!create) return nullptr;
+    SpinMutexLock l(&id_tab_mtx);
+    chunk = atomic_load(p, memory_order_relaxed);
+    if (!chunk) {
+      // The persistent allocator hands out fresh mmap'ed memory, which is
+      // zeroed.
+      uptr memsz = kIdChunkSize * sizeof(atomic_uintptr_t);
+      chunk = (uptr)PersistentAlloc(memsz);
+      stats.allocated += memsz;
+      atomic_store(p, chunk, memory_order_release);
+    }
+  }
+  return &((atomic_uintptr_t *)chunk)[id & (kIdChunkSize - 1)];
+}
+
 template <class Node, int kReservedBits, int kTabSizeLog>
 typename StackDepotBase<Node, kReservedBits, kTabSizeLog>::handle_type
 StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
@@ -114,12 +140,9 @@ StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
       return node->get_handle();
     }
   }
-  uptr part = (h % kTabSize) / kPartSize;
-  u32 id = atomic_fetch_add(&seq[part], 1, memory_order_relaxed) + 1;
+  u32 id = atomic_fetch_add(&seq, 1, memory_order_relaxed) + 1;
   stats.n_uniq_ids++;
   CHECK_LT(id, kMaxId);
-  id |= part << kPartShift;
-  CHECK_NE(id, 0);
   CHECK_EQ(id & (((u32)-1) >> kReservedBits), id);
   uptr memsz = Node::storage_size(args);
   s = (Node *)PersistentAlloc(memsz);
@@ -127,6 +150,9 @@ StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
   s->id = id;
   s->store(args, h);
   s->link = s2;
+  // This is done while holding the bucket lock, so LockAll() also waits for
+  // id_tab_mtx to be released.
+  atomic_store(id_slot(id, /*create=*/true), (uptr)s, memory_order_release);
   unlock(p, s);
   if (inserted) *inserted = true;
   return s->get_handle();
@@ -139,21 +165,11 @@ StackDepotBase<Node, kReservedBits, kTabSizeLog>::Get(u32 id) {
     return args_type();
   }
   CHECK_EQ(id & (((u32)-1) >> kReservedBits), id);
-  // High kPartBits contain part id, so we need to scan at most kPartSize lists.
-  uptr part = id >> kPartShift;
-  for (int i = 0; i != kPartSize; i++) {
-    uptr idx = part * kPartSize + i;
-    CHECK_LT(idx, kTabSize);
-    atomic_uintptr_t *p = &tab[idx];
-    uptr v = atomic_load(p, memory_order_consume);
-    Node *s = (Node *)(v & ~1);
-    for (; s; s = s->link) {
-      if (s->id == id) {
-        return s->load();
-      }
-    }
-  }
-  return args_type();
+  atomic_uintptr_t *p = id_slot(id, /*create=*/false);
+  if (!p) return args_type();
+  Node *s = (Node *)atomic_load(p, memory_order_consume);
+  if (!s) return args_type();
+  return s->load();
 }
 
 template <class Node, int kReservedBits, int kTabSizeLog>
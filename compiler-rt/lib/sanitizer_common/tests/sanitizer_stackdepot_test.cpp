@@ -64,6 +64,25 @@ TEST(SanitizerCommon, StackDepotSeveral) {
   EXPECT_NE(i1, i2);
 }
 
+TEST(SanitizerCommon, StackDepotMany) {
+  // Enough stacks for their ids to span several chunks of the id index.
+  static const uptr kCount = 10000;
+  static uptr arrays[kCount][3];
+  static u32 ids[kCount];
+  for (uptr i = 0; i < kCount; i++) {
+    arrays[i][0] = 100;
+    arrays[i][1] = 200;
+    arrays[i][2] = 300 + i;
+    ids[i] = StackDepotPut(StackTrace(arrays[i], 3));
+  }
+  for (uptr i = 0; i < kCount; i++) {
+    EXPECT_EQ(ids[i], StackDepotPut(StackTrace(arrays[i], 3)));
+    StackTrace stack = StackDepotGet(ids[i]);
+    ASSERT_EQ(3U, stack.size);
+    EXPECT_EQ(0, internal_memcmp(stack.trace, arrays[i], sizeof(arrays[i])));
+  }
+}
+
 TEST(SanitizerCommon, StackDepotReverseMap) {
   uptr array1[] = {1, 2, 3, 4, 5};
   uptr array2[] = {7, 1, 3, 0};
@@ -0,0 +1,265 @@
+//===-- malloc_benchmark.cpp ------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the throughput and the memory usage of the allocator with each of
+// its configurations, on synthetic patterns and optionally on a recorded
+// allocation trace.
+//
+// A trace is a text file with one operation per line:
+//   m <id> <size>    allocates size bytes, with a unique (live) id;
+//   f <id>           frees the block allocated with that id.
+// The sizes of a trace can be turned into a size class map proposal with
+// tools/compute_size_class_config.cpp.
+//
+//===----------------------------------------------------------------------===//
+
+#include "allocator_config.h"
+#include "combined.h"
+
+#include "benchmark/benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <unordered_map>
+#include <vector>
+
+static constexpr scudo::Chunk::Origin Origin = scudo::Chunk::Origin::Malloc;
+
+// The TSDs of a thread are tied to the allocator of their configuration, so
+// there is a single allocator per configuration, which lives as long as the
+// process. As a result, the memory counters of a benchmark include what the
+// previous benchmarks of the same configuration mapped: use --benchmark_filter
+// to look at one benchmark at a time.
+template <typename Config> static scudo::Allocator<Config> *getAllocator() {
+  static scudo::Allocator<Config> Allocator;
+  static bool Initialized = (Allocator.reset(), true);
+  (void)Initialized;
+  return &Allocator;
+}
+
+// Reports the bytes mapped by the allocator, and the fraction of them which
+// isn't used by allocated blocks.
+static void reportMemory(benchmark::State &State, scudo::uptr PeakAllocated,
+                         scudo::uptr PeakMapped) {
+  State.counters["mapped_bytes"] = static_cast<double>(PeakMapped);
+  State.counters["fragmentation"] =
+      PeakMapped ? 1.0 - static_cast<double>(PeakAllocated) / PeakMapped : 0.0;
+}
+
+template <typename Config>
+static void BM_malloc_free(benchmark::State &State) {
+  auto *Allocator = getAllocator<Config>();
+  const size_t NBytes = State.range(0);
+  size_t PageSize = scudo::getPageSizeCached();
+
+  for (auto _ : State) {
+    void *Ptr = Allocator->allocate(NBytes, Origin);
+    for (size_t I = 0; I < NBytes; I += PageSize)
+      reinterpret_cast<volatile char *>(Ptr)[I] = 0;
+    benchmark::DoNotOptimize(Ptr);
+    Allocator->deallocate(Ptr, Origin);
+  }
+
+  State.SetBytesProcessed(uint64_t(State.iterations()) * uint64_t(NBytes));
+}
+
+static const size_t MinSize = 8;
+static const size_t MaxSize = 128 * 1024;
+
+BENCHMARK_TEMPLATE(BM_malloc_free, scudo::DefaultConfig)
+    ->Range(MinSize, MaxSize);
+BENCHMARK_TEMPLATE(BM_malloc_free, scudo::AndroidConfig)
+    ->Range(MinSize, MaxSize);
+BENCHMARK_TEMPLATE(BM_malloc_free, scudo::AndroidSvelteConfig)
+    ->Range(MinSize, MaxSize);
+#if SCUDO_CAN_USE_PRIMARY64
+BENCHMARK_TEMPLATE(BM_malloc_free, scudo::FuchsiaConfig)
+    ->Range(MinSize, MaxSize);
+#endif
+
+// Allocates a number of blocks of the same size, and frees them in a mixed
+// order, so that the free lists of the size class are shuffled.
+template <typename Config>
+static void BM_malloc_free_loop(benchmark::State &State) {
+  auto *Allocator = getAllocator<Config>();
+  const size_t NumIters = State.range(0);
+  std::vector<void *> Ptrs(NumIters);
+  scudo::uptr PeakAllocated = 0, PeakMapped = 0;
+
+  for (auto _ : State) {
+    for (void *&Ptr : Ptrs) {
+      Ptr = Allocator->allocate(8192, Origin);
+      reinterpret_cast<volatile char *>(Ptr)[0] = 0;
+    }
+    scudo::StatCounters Stats;
+    Allocator->getStats(Stats);
+    PeakAllocated = scudo::Max(PeakAllocated, Stats[scudo::StatAllocated]);
+    PeakMapped = scudo::Max(PeakMapped, Stats[scudo::StatMapped]);
+    for (size_t I = 0; I < NumIters; I += 2)
+      Allocator->deallocate(Ptrs[I], Origin);
+    for (size_t I = 1; I < NumIters; I += 2)
+      Allocator->deallocate(Ptrs[I], Origin);
+  }
+
+  State.SetBytesProcessed(uint64_t(State.iterations()) * uint64_t(NumIters) *
+                          8192);
+  reportMemory(State, PeakAllocated, PeakMapped);
+}
+
+static const size_t MinIters = 8;
+static const size_t MaxIters = 32 * 1024;
+
+BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::DefaultConfig)
+    ->Range(MinIters, MaxIters);
+BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::AndroidConfig)
+    ->Range(MinIters, MaxIters);
+BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::AndroidSvelteConfig)
+    ->Range(MinIters, MaxIters);
+#if SCUDO_CAN_USE_PRIMARY64
+BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::FuchsiaConfig)
+    ->Range(MinIters, MaxIters);
+#endif
+
+struct TraceOp {
+  bool IsAlloc;
+  scudo::u32 Slot;
+  scudo::uptr Size;
+};
+
+// The operations of the trace given on the command line, with the ids mapped
+// to consecutive slots.
+static std::vector<TraceOp> Trace;
+static scudo::u32 TraceSlots;
+
+static bool loadTrace(const char *Path) {
+  FILE *F = fopen(Path, "r");
+  if (!F) {
+    fprintf(stderr, "Error: can't open %s\n", Path);
+    return false;
+  }
+  std::unordered_map<unsigned long long, scudo::u32> Live;
+  std::vector<scudo::u32> FreeSlots;
+  char Kind;
+  unsigned long long Id, Size;
+  int Line = 0;
+  while (fscanf(F, " %c %llu", &Kind, &Id) == 2) {
+    Line++;
+    if (Kind == 'm' && fscanf(F, "%llu", &Size) == 1) {
+      scudo::u32 Slot;
+      if (FreeSlots.empty()) {
+        Slot = TraceSlots++;
+      } else {
+        Slot = FreeSlots.back();
+        FreeSlots.pop_back();
+      }
+      Live[Id] = Slot;
+      Trace.push_back({true, Slot, static_cast<scudo::uptr>(Size)});
+    } else if (Kind == 'f') {
+      auto It = Live.find(Id);
+      // Frees of blocks allocated before the trace started are ignored.
+      if (It == Live.end())
+        continue;
+      Trace.push_back({false, It->second, 0});
+      FreeSlots.push_back(It->second);
+      Live.erase(It);
+    } else {
+      fprintf(stderr, "Error: %s:%d: malformed operation\n", Path, Line);
+      fclose(F);
+      return false;
+    }
+  }
+  fclose(F);
+  return true;
+}
+
+// Replays the trace once, and returns the peaks of the bytes requested and of
+// the bytes mapped by the allocator. The mapped bytes are sampled after each
+// allocation, since the Secondary unmaps the blocks that it frees.
+template <typename Config>
+static void measureTrace(scudo::Allocator<Config> *Allocator,
+                         scudo::uptr *PeakAllocated, scudo::uptr *PeakMapped) {
+  std::vector<void *> Slots(TraceSlots);
+  std::vector<scudo::uptr> Sizes(TraceSlots);
+  scudo::uptr Allocated = 0;
+  *PeakAllocated = *PeakMapped = 0;
+  for (const TraceOp &Op : Trace) {
+    if (Op.IsAlloc) {
+      Slots[Op.Slot] = Allocator->allocate(Op.Size, Origin);
+      Sizes[Op.Slot] = Op.Size;
+      Allocated += Op.Size;
+      *PeakAllocated = scudo::Max(*PeakAllocated, Allocated);
+      scudo::StatCounters Stats;
+      Allocator->getStats(Stats);
+      *PeakMapped = scudo::Max(*PeakMapped, Stats[scudo::StatMapped]);
+    } else {
+      Allocator->deallocate(Slots[Op.Slot], Origin);
+      Allocated -= Sizes[Op.Slot];
+      Slots[Op.Slot] = nullptr;
+    }
+  }
+  for (void *Ptr : Slots)
+    if (Ptr)
+      Allocator->deallocate(Ptr, Origin);
+}
+
+template <typename Config>
+static void BM_replay_trace(benchmark::State &State) {
+  auto *Allocator = getAllocator<Config>();
+  // Reading the stats in the timed loop would slow down the replay, so the
+  // memory is measured on a replay of its own.
+  scudo::uptr PeakAllocated, PeakMapped;
+  measureTrace(Allocator, &PeakAllocated, &PeakMapped);
+
+  std::vector<void *> Slots(TraceSlots);
+  for (auto _ : State) {
+    for (const TraceOp &Op : Trace) {
+      void *&Ptr = Slots[Op.Slot];
+      if (Op.IsAlloc) {
+        Ptr = Allocator->allocate(Op.Size, Origin);
+      } else {
+        Allocator->deallocate(Ptr, Origin);
+        Ptr = nullptr;
+      }
+    }
+    // The blocks still live at the end of the trace are freed, so that each
+    // iteration starts from the same state.
+    for (void *&Ptr : Slots) {
+      if (Ptr)
+        Allocator->deallocate(Ptr, Origin);
+      Ptr = nullptr;
+    }
+  }
+
+  State.SetItemsProcessed(uint64_t(State.iterations()) * Trace.size());
+  reportMemory(State, PeakAllocated, PeakMapped);
+}
+
+int main(int argc, char **argv) {
+  // An optional trace comes first, before the options of the benchmark
+  // library.
+  if (argc > 1 && argv[1][0] != '-') {
+    if (!loadTrace(argv[1]))
+      return 1;
+    benchmark::RegisterBenchmark("BM_replay_trace<DefaultConfig>",
+                                 BM_replay_trace<scudo::DefaultConfig>);
+    benchmark::RegisterBenchmark("BM_replay_trace<AndroidConfig>",
+                                 BM_replay_trace<scudo::AndroidConfig>);
+    benchmark::RegisterBenchmark("BM_replay_trace<AndroidSvelteConfig>",
+                                 BM_replay_trace<scudo::AndroidSvelteConfig>);
+#if SCUDO_CAN_USE_PRIMARY64
+    benchmark::RegisterBenchmark("BM_replay_trace<FuchsiaConfig>",
+                                 BM_replay_trace<scudo::FuchsiaConfig>);
+#endif
+    argv[1] = argv[0];
+    ++argv;
+    --argc;
+  }
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
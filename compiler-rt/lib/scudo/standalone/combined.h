@@ -20,6 +20,8 @@
 #include "secondary.h"
 #include "tsd.h"
 
+#include <pthread.h>
+
 namespace scudo {
 
 template <class Params> class Allocator {
@@ -125,9 +127,15 @@ public:
     Options.DeleteSizeMismatch = getFlags()->delete_size_mismatch;
     Options.QuarantineMaxChunkSize =
         static_cast<u32>(getFlags()->quarantine_max_chunk_size);
+    Options.ReleaseInBackground = getFlags()->release_to_os_in_background &&
+                                  getFlags()->release_to_os_interval_ms > 0;
+    ReleaseIntervalMs = static_cast<u32>(getFlags()->release_to_os_interval_ms);
+    ReleaseRssTarget =
+        static_cast<uptr>(getFlags()->release_to_os_rss_target_kb) << 10;
 
     Stats.initLinkerInitialized();
-    Primary.initLinkerInitialized(getFlags()->release_to_os_interval_ms);
+    Primary.initLinkerInitialized(getFlags()->release_to_os_interval_ms,
+                                  Options.ReleaseInBackground);
     Secondary.initLinkerInitialized(&Stats);
 
     Quarantine.init(
@@ -138,12 +146,24 @@ public:
   void reset() { memset(this, 0, sizeof(*this)); }
 
   void unmapTestOnly() {
+    if (ForkHandled) {
+      ScopedLock L(ForkHandledMutex);
+      ThisT **I = &ForkHandledInstances;
+      while (*I != this)
+        I = &(*I)->NextForkHandled;
+      *I = NextForkHandled;
+      ForkHandled = false;
+    }
     TSDRegistry.unmapTestOnly();
     Primary.unmapTestOnly();
   }
 
   TSDRegistryT *getTSDRegistry() { return &TSDRegistry; }
 
+  bool isReleaseThreadStartedTestOnly() {
+    return atomic_load_relaxed(&ReleaseThreadStarted);
+  }
+
   void initCache(CacheT *Cache) { Cache->init(&Stats, &Primary); }
 
   // Release the resources used by a TSD, which involves:
@@ -284,6 +304,12 @@ public:
     }
 
     quarantineOrDeallocateChunk(Ptr, &Header, Size);
+
+    // The thread is started on a deallocation rather than during the
+    // initialization, since pthread_create may allocate.
+    if (UNLIKELY(Options.ReleaseInBackground) &&
+        UNLIKELY(!atomic_load_relaxed(&ReleaseThreadStarted)))
+      startReleaseThread();
   }
 
   void *reallocate(void *OldPtr, uptr NewSize, uptr Alignment = MinAlignment) {
@@ -444,9 +470,82 @@ private:
     u8 ZeroContents : 1;        // zero_contents
     u8 DeallocTypeMismatch : 1; // dealloc_type_mismatch
     u8 DeleteSizeMismatch : 1;  // delete_size_mismatch
+    u8 ReleaseInBackground : 1; // release_to_os_in_background
     u32 QuarantineMaxChunkSize; // quarantine_max_chunk_size
   } Options;
 
+  u32 ReleaseIntervalMs;  // release_to_os_interval_ms
+  uptr ReleaseRssTarget;  // release_to_os_rss_target_kb, in bytes
+  atomic_u8 ReleaseThreadStarted;
+
+  // The allocators that started a release thread, linked through
+  // NextForkHandled, for the fork handlers.
+  static ThisT *ForkHandledInstances;
+  static HybridMutex ForkHandledMutex;
+  static bool ForkHandlersRegistered;
+  ThisT *NextForkHandled;
+  bool ForkHandled;
+
+  NOINLINE void startReleaseThread() {
+    if (atomic_exchange(&ReleaseThreadStarted, 1U, memory_order_acq_rel))
+      return;
+    // The child of a fork doesn't inherit the release thread, so it starts its
+    // own on its first deallocation. The allocator is disabled across the fork
+    // so that the child doesn't inherit a region locked by the thread.
+    {
+      ScopedLock L(ForkHandledMutex);
+      if (!ForkHandled) {
+        if (!SCUDO_FUCHSIA && !ForkHandlersRegistered) {
+          pthread_atfork(disableForFork, enableInParent, enableInChild);
+          ForkHandlersRegistered = true;
+        }
+        NextForkHandled = ForkHandledInstances;
+        ForkHandledInstances = this;
+        ForkHandled = true;
+      }
+    }
+    // If the thread can't be created, the memory is not released at all: we
+    // don't go back to releasing on the deallocation path.
+    pthread_t Thread;
+    if (pthread_create(&Thread, nullptr, releaseThread, this) == 0)
+      pthread_detach(Thread);
+  }
+
+  static void disableForFork() {
+    ForkHandledMutex.lock();
+    for (ThisT *I = ForkHandledInstances; I; I = I->NextForkHandled)
+      I->disable();
+  }
+
+  static void enableInParent() {
+    for (ThisT *I = ForkHandledInstances; I; I = I->NextForkHandled)
+      I->enable();
+    ForkHandledMutex.unlock();
+  }
+
+  static void enableInChild() {
+    for (ThisT *I = ForkHandledInstances; I; I = I->NextForkHandled) {
+      atomic_store_relaxed(&I->ReleaseThreadStarted, 0U);
+      I->enable();
+    }
+    ForkHandledMutex.unlock();
+  }
+
+  // The thread lives as long as the process, and doesn't use the allocator.
+  static void *releaseThread(void *Arg) {
+    ThisT *Instance = reinterpret_cast<ThisT *>(Arg);
+    while (true) {
+      sleepMs(Instance->ReleaseIntervalMs);
+      if (Instance->ReleaseRssTarget) {
+        const uptr Rss = getResidentMemorySize();
+        if (Rss && Rss <= Instance->ReleaseRssTarget)
+          continue;
+      }
+      Instance->Primary.releaseToOSInBackground();
+    }
+    return nullptr;
+  }
+
   // The following might get optimized out by the compiler.
   NOINLINE void performSanityChecks() {
     // Verify that the header offset field can hold the maximum offset. In the
@@ -552,6 +651,11 @@ private:
   }
 };
 
+template <class Params>
+Allocator<Params> *Allocator<Params>::ForkHandledInstances = nullptr;
+template <class Params> HybridMutex Allocator<Params>::ForkHandledMutex;
+template <class Params> bool Allocator<Params>::ForkHandlersRegistered = false;
+
 } // namespace scudo
 
 #endif // SCUDO_COMBINED_H_
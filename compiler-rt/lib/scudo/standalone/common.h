@@ -128,10 +128,19 @@ INLINE uptr getPageSizeCached() {
 
 u32 getNumberOfCPUs();
 
+// Returns the index of the CPU the calling thread is running on, or 0 if it
+// can't be determined. The thread may have migrated by the time this returns.
+u32 getCurrentCPU();
+
 const char *getEnv(const char *Name);
 
 u64 getMonotonicTime();
 
+void sleepMs(u32 Milliseconds);
+
+// Returns the resident memory of the process in bytes, or 0 if unknown.
+uptr getResidentMemorySize();
+
 // Our randomness gathering function is limited to 256 bytes to ensure we get
 // as many bytes as requested, and avoid interruptions (on Linux).
 constexpr uptr MaxRandomLength = 256U;
@@ -168,8 +168,25 @@ void HybridMutex::unlock() __TA_NO_THREAD_SAFETY_ANALYSIS {
 
 u64 getMonotonicTime() { return _zx_clock_get_monotonic(); }
 
+void sleepMs(u32 Milliseconds) {
+  _zx_nanosleep(_zx_deadline_after(ZX_MSEC(Milliseconds)));
+}
+
+// The memory committed to the process, whether private or shared with other
+// processes.
+uptr getResidentMemorySize() {
+  zx_info_task_stats_t Info;
+  if (_zx_object_get_info(_zx_process_self(), ZX_INFO_TASK_STATS, &Info,
+                          sizeof(Info), nullptr, nullptr) != ZX_OK)
+    return 0;
+  return static_cast<uptr>(Info.mem_private_bytes + Info.mem_shared_bytes);
+}
+
 u32 getNumberOfCPUs() { return _zx_system_get_num_cpus(); }
 
+// Zircon doesn't expose the current CPU to userspace.
+u32 getCurrentCPU() { return 0; }
+
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
   COMPILER_CHECK(MaxRandomLength <= ZX_CPRNG_DRAW_MAX_LEN);
   if (UNLIKELY(!Buffer || !Length || Length > MaxRandomLength))
@@ -122,12 +122,46 @@ u64 getMonotonicTime() {
          static_cast<u64>(TS.tv_nsec);
 }
 
+void sleepMs(u32 Milliseconds) {
+  timespec TS;
+  TS.tv_sec = Milliseconds / 1000;
+  TS.tv_nsec = static_cast<long>(Milliseconds % 1000) * 1000000L;
+  while (nanosleep(&TS, &TS) != 0 && errno == EINTR) {
+  }
+}
+
+uptr getResidentMemorySize() {
+  // The second field of statm is the number of resident pages.
+  const int Fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+  if (Fd < 0)
+    return 0;
+  char Buffer[64];
+  const ssize_t Length = read(Fd, Buffer, sizeof(Buffer) - 1);
+  close(Fd);
+  if (Length <= 0)
+    return 0;
+  Buffer[Length] = '\0';
+  const char *P = strchr(Buffer, ' ');
+  if (!P)
+    return 0;
+  uptr Pages = 0;
+  for (P++; *P >= '0' && *P <= '9'; P++)
+    Pages = Pages * 10 + static_cast<uptr>(*P - '0');
+  return Pages * getPageSizeCached();
+}
+
 u32 getNumberOfCPUs() {
   cpu_set_t CPUs;
   CHECK_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &CPUs), 0);
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+u32 getCurrentCPU() {
+  // On most architectures, this goes through the vDSO instead of a syscall.
+  const int CPU = sched_getcpu();
+  return CPU < 0 ? 0U : static_cast<u32>(CPU);
+}
+
 // Blocking is possibly unused if the getrandom block is not compiled in.
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
   if (!Buffer || !Length || Length > MaxRandomLength)
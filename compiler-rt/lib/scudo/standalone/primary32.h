@@ -55,7 +55,8 @@ public:
 
   static bool canAllocate(uptr Size) { return Size <= SizeClassMap::MaxSize; }
 
-  void initLinkerInitialized(s32 ReleaseToOsInterval) {
+  void initLinkerInitialized(s32 ReleaseToOsInterval,
+                             bool ReleaseInBackground = false) {
     if (SCUDO_FUCHSIA)
       reportError("SizeClassAllocator32 is not supported on Fuchsia");
 
@@ -77,10 +78,11 @@ public:
                         (getSizeByClassId(I) >= (PageSize / 16));
     }
     ReleaseToOsIntervalMs = ReleaseToOsInterval;
+    ReleaseOnPush = !ReleaseInBackground;
   }
-  void init(s32 ReleaseToOsInterval) {
+  void init(s32 ReleaseToOsInterval, bool ReleaseInBackground = false) {
     memset(this, 0, sizeof(*this));
-    initLinkerInitialized(ReleaseToOsInterval);
+    initLinkerInitialized(ReleaseToOsInterval, ReleaseInBackground);
   }
 
   void unmapTestOnly() {
@@ -118,7 +120,7 @@ public:
     ScopedLock L(Sci->Mutex);
     Sci->FreeList.push_front(B);
     Sci->Stats.PushedBlocks += B->getCount();
-    if (Sci->CanRelease)
+    if (Sci->CanRelease && ReleaseOnPush)
       releaseToOSMaybe(Sci, ClassId);
   }
 
@@ -171,6 +173,19 @@ public:
     }
   }
 
+  // See the 64-bit primary.
+  uptr releaseToOSInBackground() {
+    uptr TotalReleasedBytes = 0;
+    for (uptr I = 0; I < NumClasses; I++) {
+      SizeClassInfo *Sci = getSizeClassInfo(I);
+      if (!Sci->CanRelease || !Sci->Mutex.tryLock())
+        continue;
+      TotalReleasedBytes += releaseToOSMaybe(Sci, I);
+      Sci->Mutex.unlock();
+    }
+    return TotalReleasedBytes;
+  }
+
 private:
   static const uptr NumClasses = SizeClassMap::NumClasses;
   static const uptr RegionSize = 1UL << RegionSizeLog;
@@ -339,7 +354,7 @@ private:
            AvailableChunks, Rss >> 10);
   }
 
-  NOINLINE void releaseToOSMaybe(SizeClassInfo *Sci, uptr ClassId,
+  NOINLINE uptr releaseToOSMaybe(SizeClassInfo *Sci, uptr ClassId,
                                  bool Force = false) {
     const uptr BlockSize = getSizeByClassId(ClassId);
     const uptr PageSize = getPageSizeCached();
@@ -347,24 +362,25 @@ private:
     CHECK_GE(Sci->Stats.PoppedBlocks, Sci->Stats.PushedBlocks);
     const uptr N = Sci->Stats.PoppedBlocks - Sci->Stats.PushedBlocks;
     if (N * BlockSize < PageSize)
-      return; // No chance to release anything.
+      return 0; // No chance to release anything.
     if ((Sci->Stats.PushedBlocks - Sci->ReleaseInfo.PushedBlocksAtLastRelease) *
             BlockSize <
         PageSize) {
-      return; // Nothing new to release.
+      return 0; // Nothing new to release.
     }
 
     if (!Force) {
       const s32 IntervalMs = ReleaseToOsIntervalMs;
       if (IntervalMs < 0)
-        return;
+        return 0;
       if (Sci->ReleaseInfo.LastReleaseAtNs +
               static_cast<uptr>(IntervalMs) * 1000000ULL >
           getMonotonicTime()) {
-        return; // Memory was returned recently.
+        return 0; // Memory was returned recently.
       }
     }
 
+    uptr TotalReleasedBytes = 0;
     // TODO(kostyak): currently not ideal as we loop over all regions and
     // iterate multiple times over the same freelist if a ClassId spans multiple
     // regions. But it will have to do for now.
@@ -378,9 +394,11 @@ private:
           Sci->ReleaseInfo.RangesReleased += Recorder.getReleasedRangesCount();
           Sci->ReleaseInfo.LastReleasedBytes = Recorder.getReleasedBytes();
         }
+        TotalReleasedBytes += Recorder.getReleasedBytes();
       }
     }
     Sci->ReleaseInfo.LastReleaseAtNs = getMonotonicTime();
+    return TotalReleasedBytes;
   }
 
   SizeClassInfo SizeClassInfoArray[NumClasses];
@@ -391,6 +409,7 @@ private:
   uptr MinRegionIndex;
   uptr MaxRegionIndex;
   s32 ReleaseToOsIntervalMs;
+  bool ReleaseOnPush;
   // Unless several threads request regions simultaneously from different size
   // classes, the stash rarely contains more than 1 entry.
   static constexpr uptr MaxStashedRegions = 4;
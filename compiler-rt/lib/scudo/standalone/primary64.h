@@ -53,7 +53,8 @@ public:
 
   static bool canAllocate(uptr Size) { return Size <= SizeClassMap::MaxSize; }
 
-  void initLinkerInitialized(s32 ReleaseToOsInterval) {
+  void initLinkerInitialized(s32 ReleaseToOsInterval,
+                             bool ReleaseInBackground = false) {
     // Reserve the space required for the Primary.
     PrimaryBase = reinterpret_cast<uptr>(
         map(nullptr, PrimarySize, "scudo:primary", MAP_NOACCESS, &Data));
@@ -85,10 +86,11 @@ public:
       Region->RandState = getRandomU32(&Seed);
     }
     ReleaseToOsIntervalMs = ReleaseToOsInterval;
+    ReleaseOnPush = !ReleaseInBackground;
   }
-  void init(s32 ReleaseToOsInterval) {
+  void init(s32 ReleaseToOsInterval, bool ReleaseInBackground = false) {
     memset(this, 0, sizeof(*this));
-    initLinkerInitialized(ReleaseToOsInterval);
+    initLinkerInitialized(ReleaseToOsInterval, ReleaseInBackground);
   }
 
   void unmapTestOnly() {
@@ -120,7 +122,7 @@ public:
     ScopedLock L(Region->Mutex);
     Region->FreeList.push_front(B);
     Region->Stats.PushedBlocks += B->getCount();
-    if (Region->CanRelease)
+    if (Region->CanRelease && ReleaseOnPush)
       releaseToOSMaybe(Region, ClassId);
   }
 
@@ -177,6 +179,22 @@ public:
     }
   }
 
+  // Releases the regions which are due for it, like pushBatch would have. The
+  // regions in use by other threads are skipped until the next call, so that
+  // this never makes them wait. To be called periodically when releasing in
+  // the background. Returns the number of bytes released.
+  uptr releaseToOSInBackground() {
+    uptr TotalReleasedBytes = 0;
+    for (uptr I = 0; I < NumClasses; I++) {
+      RegionInfo *Region = getRegionInfo(I);
+      if (!Region->CanRelease || !Region->Mutex.tryLock())
+        continue;
+      TotalReleasedBytes += releaseToOSMaybe(Region, I);
+      Region->Mutex.unlock();
+    }
+    return TotalReleasedBytes;
+  }
+
 private:
   static const uptr RegionSize = 1UL << RegionSizeLog;
   static const uptr NumClasses = SizeClassMap::NumClasses;
@@ -216,6 +234,7 @@ private:
   RegionInfo *RegionInfoArray;
   MapPlatformData Data;
   s32 ReleaseToOsIntervalMs;
+  bool ReleaseOnPush;
 
   RegionInfo *getRegionInfo(uptr ClassId) const {
     DCHECK_LT(ClassId, NumClasses);
@@ -338,7 +357,7 @@ private:
            getRegionBaseByClassId(ClassId));
   }
 
-  NOINLINE void releaseToOSMaybe(RegionInfo *Region, uptr ClassId,
+  NOINLINE uptr releaseToOSMaybe(RegionInfo *Region, uptr ClassId,
                                  bool Force = false) {
     const uptr BlockSize = getSizeByClassId(ClassId);
     const uptr PageSize = getPageSizeCached();
@@ -346,22 +365,22 @@ private:
     CHECK_GE(Region->Stats.PoppedBlocks, Region->Stats.PushedBlocks);
     const uptr N = Region->Stats.PoppedBlocks - Region->Stats.PushedBlocks;
     if (N * BlockSize < PageSize)
-      return; // No chance to release anything.
+      return 0; // No chance to release anything.
     if ((Region->Stats.PushedBlocks -
          Region->ReleaseInfo.PushedBlocksAtLastRelease) *
             BlockSize <
         PageSize) {
-      return; // Nothing new to release.
+      return 0; // Nothing new to release.
     }
 
     if (!Force) {
       const s32 IntervalMs = ReleaseToOsIntervalMs;
       if (IntervalMs < 0)
-        return;
+        return 0;
       if (Region->ReleaseInfo.LastReleaseAtNs +
               static_cast<uptr>(IntervalMs) * 1000000ULL >
           getMonotonicTime()) {
-        return; // Memory was returned recently.
+        return 0; // Memory was returned recently.
       }
     }
 
@@ -377,6 +396,7 @@ private:
       Region->ReleaseInfo.LastReleasedBytes = Recorder.getReleasedBytes();
     }
     Region->ReleaseInfo.LastReleaseAtNs = getMonotonicTime();
+    return Recorder.getReleasedBytes();
   }
 };
 
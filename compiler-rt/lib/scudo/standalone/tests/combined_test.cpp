@@ -15,6 +15,11 @@
 #include <mutex>
 #include <thread>
 
+#if SCUDO_LINUX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 static std::mutex Mutex;
 static std::condition_variable Cv;
 static bool Ready = false;
@@ -25,7 +30,10 @@ static constexpr scudo::Chunk::Origin Origin = scudo::Chunk::Origin::Malloc;
 // parameters are on the low end, to avoid having to loop excessively in some
 // tests.
 static bool UseQuarantine = false;
+static bool UseBackgroundRelease = false;
 extern "C" const char *__scudo_default_options() {
+  if (UseBackgroundRelease)
+    return "release_to_os_in_background=true:release_to_os_interval_ms=1";
   if (!UseQuarantine)
     return "";
   return "quarantine_size_kb=256:thread_local_quarantine_size_kb=128:"
@@ -190,6 +198,46 @@ TEST(ScudoCombinedTest, ThreadedCombined) {
   testAllocatorThreaded<scudo::AndroidSvelteConfig>();
 }
 
+#if SCUDO_LINUX
+// The child of a fork doesn't inherit the release thread, and starts its own.
+// Forking while the thread runs must not leave a region locked in the child.
+// A configuration of its own, so that the thread-local state of the other tests
+// isn't shared with this allocator.
+struct BackgroundReleaseConfig {
+  typedef scudo::DefaultConfig::Primary Primary;
+  template <class A> using TSDRegistryT = scudo::TSDRegistrySharedT<A, 1U>;
+};
+
+TEST(ScudoCombinedTest, BackgroundReleaseFork) {
+  using AllocatorT = scudo::Allocator<BackgroundReleaseConfig>;
+  // The release thread lives as long as the process, and so must the
+  // allocator it uses.
+  static AllocatorT Allocator;
+  Allocator.reset();
+  UseBackgroundRelease = true;
+  Allocator.deallocate(Allocator.allocate(1U << 12, Origin), Origin);
+  UseBackgroundRelease = false;
+  EXPECT_TRUE(Allocator.isReleaseThreadStartedTestOnly());
+
+  for (int I = 0; I < 16; I++) {
+    const pid_t Pid = fork();
+    ASSERT_GE(Pid, 0);
+    if (Pid == 0) {
+      if (Allocator.isReleaseThreadStartedTestOnly())
+        _exit(1);
+      for (scudo::uptr SizeLog = 4U; SizeLog <= 16U; SizeLog++)
+        Allocator.deallocate(Allocator.allocate(1U << SizeLog, Origin),
+                             Origin);
+      _exit(Allocator.isReleaseThreadStartedTestOnly() ? 0 : 2);
+    }
+    int Status;
+    ASSERT_EQ(waitpid(Pid, &Status, 0), Pid);
+    EXPECT_TRUE(WIFEXITED(Status));
+    EXPECT_EQ(WEXITSTATUS(Status), 0);
+  }
+}
+#endif
+
 struct DeathConfig {
   // Tiny allocator, its Primary only serves chunks of 1024 bytes.
   using DeathSizeClassMap = scudo::SizeClassMap<1U, 10U, 10U, 10U, 1U, 10U>;
@@ -12,6 +12,8 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
@@ -188,3 +190,47 @@ TEST(ScudoPrimaryTest, PrimaryThreaded) {
   testPrimaryThreaded<scudo::SizeClassAllocator32<SizeClassMap, 18U>>();
   testPrimaryThreaded<scudo::SizeClassAllocator64<SizeClassMap, 24U>>();
 }
+
+// The regions are released by another thread while they are in use.
+template <typename Primary> static void testPrimaryReleaseInBackground() {
+  auto Deleter = [](Primary *P) {
+    P->unmapTestOnly();
+    delete P;
+  };
+  std::unique_ptr<Primary, decltype(Deleter)> Allocator(new Primary, Deleter);
+  Allocator->init(/*ReleaseToOsInterval=*/1, /*ReleaseInBackground=*/true);
+  std::atomic<bool> Done(false);
+  std::atomic<scudo::uptr> ReleasedBytes(0);
+  std::thread Releaser([&]() {
+    while (!Done)
+      ReleasedBytes += Allocator->releaseToOSInBackground();
+  });
+  std::thread Threads[8];
+  for (scudo::uptr I = 0; I < ARRAY_SIZE(Threads); I++)
+    Threads[I] = std::thread(performAllocations<Primary>, Allocator.get());
+  {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    Ready = true;
+    Cv.notify_all();
+  }
+  for (auto &T : Threads)
+    T.join();
+  Done = true;
+  Releaser.join();
+  // All the blocks are free now. The releases are at least 1ms apart, so the
+  // last ones may only happen on a later pass.
+  for (scudo::uptr I = 0; I < 1000U && ReleasedBytes == 0; I++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ReleasedBytes += Allocator->releaseToOSInBackground();
+  }
+  EXPECT_GT(ReleasedBytes, 0U);
+  Allocator->printStats();
+}
+
+TEST(ScudoPrimaryTest, PrimaryReleaseInBackground) {
+  using SizeClassMap = scudo::DefaultSizeClassMap;
+  testPrimaryReleaseInBackground<
+      scudo::SizeClassAllocator32<SizeClassMap, 18U>>();
+  testPrimaryReleaseInBackground<
+      scudo::SizeClassAllocator64<SizeClassMap, 24U>>();
+}
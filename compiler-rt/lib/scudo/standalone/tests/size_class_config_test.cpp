@@ -0,0 +1,61 @@
+//===-- size_class_config_test.cpp ------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "scudo/standalone/size_class_map.h"
+#include "scudo/standalone/tools/size_class_config.h"
+#include "gtest/gtest.h"
+
+using size_class_config::MapParams;
+
+// The class sizes computed by the tool must be the ones of SizeClassMap.
+template <class SizeClassMap> void testMapParams(const MapParams &P) {
+  const scudo::uptr NumClasses = SizeClassMap::NumClasses;
+  const scudo::uptr MaxSize = SizeClassMap::MaxSize;
+  EXPECT_EQ(P.numClasses(), NumClasses);
+  for (scudo::uptr Size = 1; Size <= MaxSize; Size++)
+    ASSERT_EQ(P.classSize(Size),
+              SizeClassMap::getSizeByClassId(
+                  SizeClassMap::getClassIdBySize(Size)))
+        << "Size " << Size;
+}
+
+#if SCUDO_WORDSIZE == 64U
+TEST(ScudoSizeClassConfigTest, PredefinedMaps) {
+  testMapParams<scudo::DefaultSizeClassMap>(size_class_config::DefaultMap);
+  testMapParams<scudo::SvelteSizeClassMap>(size_class_config::SvelteMap);
+}
+#endif
+
+TEST(ScudoSizeClassConfigTest, OtherMaps) {
+  testMapParams<scudo::SizeClassMap<1, 5, 5, 5, 0, 0>>({1, 5, 5, 5});
+  testMapParams<scudo::SizeClassMap<2, 4, 6, 12, 0, 0>>({2, 4, 6, 12});
+  testMapParams<scudo::SizeClassMap<4, 4, 10, 16, 0, 0>>({4, 4, 10, 16});
+}
+
+TEST(ScudoSizeClassConfigTest, BestMap) {
+  size_class_config::Options Opts;
+  Opts.MaxClasses = 64;
+  // The chunk header takes 16 bytes, and the default map rounds the 40 bytes
+  // of the first size up to 64, where a map with 16 bytes steps doesn't.
+  std::map<size_class_config::u64, size_class_config::u64> Histogram = {
+      {24, 1000}, {112, 10}};
+  size_class_config::Cost C;
+  const MapParams Best = size_class_config::findBestMap(Opts, Histogram, &C);
+  ASSERT_NE(Best.NumBits, 0U);
+  EXPECT_LE(Best.numClasses(), 64U);
+  EXPECT_EQ(Best.MinSizeLog, 4U);
+  EXPECT_EQ(C.Requested, 24U * 1000 + 112U * 10);
+  EXPECT_EQ(C.Wasted, 24U * 1000 + 16U * 10);
+  EXPECT_EQ(size_class_config::computeCost(size_class_config::DefaultMap, Opts,
+                                           Histogram)
+                .Wasted,
+            40U * 1000 + 16U * 10);
+  // No map has a single class.
+  Opts.MaxClasses = 1;
+  EXPECT_EQ(size_class_config::findBestMap(Opts, Histogram, &C).NumBits, 0U);
+}
@@ -0,0 +1,126 @@
+//===-- compute_size_class_config.cpp -------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Proposes the parameters of a SizeClassMap (see size_class_map.h) for the
+// allocation sizes of a workload, by picking the map with the fewest bytes
+// lost to rounding up to a class size, under a maximum number of classes.
+//
+// The inputs are histograms, with one "<size> <count>" pair per line, or
+// allocation traces in the format of benchmarks/malloc_benchmark.cpp.
+//
+// This is a host tool with no dependency, built as the
+// compute_size_class_config target, or by hand with:
+//   c++ -O2 compute_size_class_config.cpp -o compute_size_class_config
+//
+//===----------------------------------------------------------------------===//
+
+#include "size_class_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+using namespace size_class_config;
+
+static void usage(const char *Name) {
+  fprintf(stderr,
+          "Usage: %s [options] <histogram or trace>...\n"
+          "  -min-alignment-log=N  log2 of the minimum alignment (4)\n"
+          "  -header-size=N        size of the chunk header (16)\n"
+          "  -max-size-log=N       log2 of the largest class (17)\n"
+          "  -max-classes=N        maximum number of classes (the count of "
+          "DefaultSizeClassMap)\n"
+          "  -max-num-cached-hint=N, -max-bytes-cached-log=N\n"
+          "                        copied to the proposed map (8, 10)\n",
+          Name);
+  exit(1);
+}
+
+static bool parseOption(const char *Arg, const char *Name, unsigned *Value) {
+  const size_t Len = strlen(Name);
+  if (strncmp(Arg, Name, Len) != 0 || Arg[Len] != '=')
+    return false;
+  *Value = static_cast<unsigned>(strtoul(Arg + Len + 1, nullptr, 10));
+  return true;
+}
+
+// Adds the sizes of File to Histogram.
+static void readSizes(const char *File, std::map<u64, u64> *Histogram) {
+  FILE *F = fopen(File, "r");
+  if (!F) {
+    fprintf(stderr, "Error: can't open %s\n", File);
+    exit(1);
+  }
+  char Line[256];
+  while (fgets(Line, sizeof(Line), F)) {
+    u64 Id, Size, Count;
+    if (Line[0] == 'f' || Line[0] == '\n' || Line[0] == '#')
+      continue;
+    if (sscanf(Line, "m %llu %llu", &Id, &Size) == 2)
+      (*Histogram)[Size]++;
+    else if (sscanf(Line, "%llu %llu", &Size, &Count) == 2)
+      (*Histogram)[Size] += Count;
+    else
+      fprintf(stderr, "Warning: %s: ignoring line: %s", File, Line);
+  }
+  fclose(F);
+}
+
+static void printCost(const char *Name, const MapParams &P, const Cost &C) {
+  printf("%-22s SizeClassMap<%u, %u, %u, %u>: %llu classes, %.2f%% "
+         "overhead\n",
+         Name, P.NumBits, P.MinSizeLog, P.MidSizeLog, P.MaxSizeLog,
+         P.numClasses(), C.Requested ? 100.0 * C.Wasted / C.Requested : 0.0);
+}
+
+int main(int argc, char **argv) {
+  Options Opts;
+  std::vector<const char *> Files;
+  for (int I = 1; I < argc; I++) {
+    const char *Arg = argv[I];
+    if (Arg[0] != '-') {
+      Files.push_back(Arg);
+      continue;
+    }
+    if (!parseOption(Arg, "-min-alignment-log", &Opts.MinAlignmentLog) &&
+        !parseOption(Arg, "-header-size", &Opts.HeaderSize) &&
+        !parseOption(Arg, "-max-size-log", &Opts.MaxSizeLog) &&
+        !parseOption(Arg, "-max-classes", &Opts.MaxClasses) &&
+        !parseOption(Arg, "-max-num-cached-hint", &Opts.MaxNumCachedHint) &&
+        !parseOption(Arg, "-max-bytes-cached-log", &Opts.MaxBytesCachedLog))
+      usage(argv[0]);
+  }
+  if (Files.empty() || Opts.MaxSizeLog > 40 ||
+      Opts.MinAlignmentLog > Opts.MaxSizeLog)
+    usage(argv[0]);
+
+  std::map<u64, u64> Histogram;
+  for (const char *File : Files)
+    readSizes(File, &Histogram);
+
+  if (!Opts.MaxClasses)
+    Opts.MaxClasses = static_cast<unsigned>(DefaultMap.numClasses());
+  printCost("DefaultSizeClassMap", DefaultMap,
+            computeCost(DefaultMap, Opts, Histogram));
+  printCost("SvelteSizeClassMap", SvelteMap,
+            computeCost(SvelteMap, Opts, Histogram));
+
+  Cost BestCost;
+  const MapParams Best = findBestMap(Opts, Histogram, &BestCost);
+  if (!Best.NumBits) {
+    fprintf(stderr, "Error: no map has at most %u classes\n", Opts.MaxClasses);
+    return 1;
+  }
+  printCost("Proposed", Best, BestCost);
+  printf("\ntypedef SizeClassMap<%u, %u, %u, %u, %u, %u> CustomSizeClassMap;\n",
+         Best.NumBits, Best.MinSizeLog, Best.MidSizeLog, Best.MaxSizeLog,
+         Opts.MaxNumCachedHint, Opts.MaxBytesCachedLog);
+  return 0;
+}
@@ -0,0 +1,112 @@
+//===-- size_class_config.h -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The search of compute_size_class_config.cpp, shared with its unit test.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SCUDO_TOOLS_SIZE_CLASS_CONFIG_H_
+#define SCUDO_TOOLS_SIZE_CLASS_CONFIG_H_
+
+#include <map>
+
+namespace size_class_config {
+
+typedef unsigned long long u64;
+
+struct Options {
+  unsigned MinAlignmentLog = 4; // SCUDO_MIN_ALIGNMENT_LOG on 64-bit.
+  unsigned HeaderSize = 16;     // Chunk::getHeaderSize() on 64-bit.
+  unsigned MaxSizeLog = 17;
+  unsigned MaxClasses = 0; // Defaults to the count of DefaultSizeClassMap.
+  unsigned MaxNumCachedHint = 8;
+  unsigned MaxBytesCachedLog = 10;
+};
+
+// The runtime equivalent of the computations of SizeClassMap.
+struct MapParams {
+  unsigned NumBits, MinSizeLog, MidSizeLog, MaxSizeLog;
+
+  u64 numClasses() const {
+    return (1ULL << (MidSizeLog - MinSizeLog)) +
+           (u64(MaxSizeLog - MidSizeLog) << (NumBits - 1)) + 1;
+  }
+
+  u64 classSize(u64 Size) const {
+    const u64 MinSize = 1ULL << MinSizeLog;
+    const u64 MidSize = 1ULL << MidSizeLog;
+    if (Size <= MidSize)
+      return (Size + MinSize - 1) & ~(MinSize - 1);
+    const unsigned S = NumBits - 1;
+    unsigned L = 63 - __builtin_clzll(Size);
+    const u64 Unit = L >= S ? 1ULL << (L - S) : 1;
+    return (Size + Unit - 1) & ~(Unit - 1);
+  }
+};
+
+// The predefined maps, from size_class_map.h (64-bit).
+static const MapParams DefaultMap = {3, 5, 8, 17};
+static const MapParams SvelteMap = {3, 5, 8, 15};
+
+struct Cost {
+  u64 Requested = 0; // Bytes requested from the Primary.
+  u64 Wasted = 0;    // Bytes lost to the rounding to a class size.
+};
+
+// Histogram maps each requested size to its number of allocations.
+inline Cost computeCost(const MapParams &P, const Options &Opts,
+                        const std::map<u64, u64> &Histogram) {
+  Cost C;
+  const u64 Alignment = 1ULL << Opts.MinAlignmentLog;
+  for (const auto &Entry : Histogram) {
+    const u64 Needed =
+        ((Entry.first + Alignment - 1) & ~(Alignment - 1)) + Opts.HeaderSize;
+    // Larger chunks are served by the Secondary.
+    if (Needed > (1ULL << P.MaxSizeLog))
+      continue;
+    C.Requested += Entry.first * Entry.second;
+    C.Wasted += (P.classSize(Needed) - Entry.first) * Entry.second;
+  }
+  return C;
+}
+
+// Returns the map with the fewest wasted bytes, and then the fewest classes,
+// of at most Opts.MaxClasses classes, or a map with NumBits == 0 if there is
+// none. The search space is small enough to be walked entirely.
+inline MapParams findBestMap(const Options &Opts,
+                             const std::map<u64, u64> &Histogram,
+                             Cost *BestCost) {
+  MapParams Best = {0, 0, 0, 0};
+  for (unsigned NumBits = 1; NumBits <= 6; NumBits++) {
+    for (unsigned MinSizeLog = Opts.MinAlignmentLog;
+         MinSizeLog <= Opts.MaxSizeLog; MinSizeLog++) {
+      for (unsigned MidSizeLog = MinSizeLog; MidSizeLog <= Opts.MaxSizeLog;
+           MidSizeLog++) {
+        // The classes after MidSize must stay multiples of MinSize.
+        if (MidSizeLog < MinSizeLog + NumBits - 1)
+          continue;
+        const MapParams P = {NumBits, MinSizeLog, MidSizeLog, Opts.MaxSizeLog};
+        // SizeClassMap supports at most 256 classes.
+        if (P.numClasses() > Opts.MaxClasses || P.numClasses() > 256)
+          continue;
+        const Cost C = computeCost(P, Opts, Histogram);
+        if (!Best.NumBits || C.Wasted < BestCost->Wasted ||
+            (C.Wasted == BestCost->Wasted &&
+             P.numClasses() < Best.numClasses())) {
+          Best = P;
+          *BestCost = C;
+        }
+      }
+    }
+  }
+  return Best;
+}
+
+} // namespace size_class_config
+
+#endif // SCUDO_TOOLS_SIZE_CLASS_CONFIG_H_
@@ -109,6 +109,14 @@ private:
 
   NOINLINE TSD<Allocator> *getTSDAndLockSlow(TSD<Allocator> *CurrentTSD) {
     if (MaxTSDCount > 1U && NumberOfTSDs > 1U) {
+      // Try the TSD of the CPU we are running on first. Only one thread runs
+      // on a CPU at a time, so the threads which end up using the TSD of their
+      // CPU rarely contend with each other, and a TSD acts as a per-CPU cache.
+      TSD<Allocator> *CPUTSD = &TSDs[getCurrentCPU() % NumberOfTSDs];
+      if (CPUTSD != CurrentTSD && CPUTSD->tryLock()) {
+        setCurrentTSD(CPUTSD);
+        return CPUTSD;
+      }
       // Use the Precedence of the current TSD as our random seed. Since we are
       // in the slow path, it means that tryLock failed, and as a result it's
       // very likely that said Precedence is non-zero.
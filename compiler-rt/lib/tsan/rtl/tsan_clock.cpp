@@ -211,19 +211,18 @@ void ThreadClock::release(ClockCache *c, SyncClock *dst) {
   bool acquired = IsAlreadyAcquired(dst);
   if (acquired)
     CPP_STAT_INC(StatClockReleaseAcquired);
-  // Update dst->clk_.
+  // Update dst->clk_, and clear 'acquired' flag in all its elements.
+  // Note: dst can be larger than this ThreadClock, the loop covers the tail
+  // as well since clk_ beyond size is all zeros.
   dst->FlushDirty();
+  if (nclk_ < dst->size_)
+    CPP_STAT_INC(StatClockReleaseClearTail);
   uptr i = 0;
   for (ClockElem &ce : *dst) {
     ce.epoch = max(ce.epoch, clk_[i]);
     ce.reused = 0;
     i++;
   }
-  // Clear 'acquired' flag in the remaining elements.
-  if (nclk_ < dst->size_)
-    CPP_STAT_INC(StatClockReleaseClearTail);
-  for (uptr i = nclk_; i < dst->size_; i++)
-    dst->elem(i).reused = 0;
   dst->release_store_tid_ = kInvalidTid;
   dst->release_store_reused_ = 0;
   // If we've acquired dst, remember this fact,
@@ -332,8 +331,8 @@ void ThreadClock::UpdateCurrentThread(ClockCache *c, SyncClock *dst) const {
   dst->Unshare(c);
   CPP_STAT_INC(StatClockReleaseSlow);
   dst->elem(tid_).epoch = clk_[tid_];
-  for (uptr i = 0; i < dst->size_; i++)
-    dst->elem(i).reused = 0;
+  for (ClockElem &ce : *dst)
+    ce.reused = 0;
   dst->FlushDirty();
 }
 
@@ -917,10 +917,20 @@ static void MemoryRangeSet(ThreadState *thr, uptr pc, uptr addr, uptr size,
     CHECK(IsShadowMem((uptr)p));
     CHECK(IsShadowMem((uptr)(p + size * kShadowCnt / kShadowCell - 1)));
     // FIXME: may overwrite a part outside the region
-    for (uptr i = 0; i < size / kShadowCell * kShadowCnt;) {
-      p[i++] = val;
-      for (uptr j = 1; j < kShadowCnt; j++)
-        p[i++] = 0;
+    if (val == 0) {
+      // Writing to shadow which was never touched would make it resident,
+      // while reading it only maps the zero page. This keeps the shadow of
+      // fresh mappings and of memory reset by the allocator uncommitted.
+      for (uptr i = 0; i < size / kShadowCell * kShadowCnt; i++) {
+        if (p[i])
+          p[i] = 0;
+      }
+    } else {
+      for (uptr i = 0; i < size / kShadowCell * kShadowCnt;) {
+        p[i++] = val;
+        for (uptr j = 1; j < kShadowCnt; j++)
+          p[i++] = 0;
+      }
     }
   } else {
     // The region is big, reset only beginning and end.
@@ -106,6 +106,40 @@ TEST(BufferQueueTest, MultiThreaded) {
   F();
 }
 
+TEST(BufferQueueTest, MultiThreadedKeepsAllBuffers) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 8, Success);
+  ASSERT_TRUE(Success);
+  auto F = [&] {
+    BufferQueue::Buffer B[2];
+    for (int I = 0; I < 10000; ++I) {
+      for (auto &Buf : B)
+        if (Buffers.getBuffer(Buf) != BufferQueue::ErrorCode::Ok)
+          Buf = {};
+      for (auto &Buf : B)
+        if (Buf.Data != nullptr)
+          ASSERT_EQ(Buffers.releaseBuffer(Buf), BufferQueue::ErrorCode::Ok);
+    }
+  };
+  auto T0 = std::async(std::launch::async, F);
+  auto T1 = std::async(std::launch::async, F);
+  auto T2 = std::async(std::launch::async, F);
+  F();
+  T0.get();
+  T1.get();
+  T2.get();
+
+  // Every buffer must have made it back to the queue, exactly once.
+  BufferQueue::Buffer B[8];
+  for (auto &Buf : B)
+    ASSERT_EQ(Buffers.getBuffer(Buf), BufferQueue::ErrorCode::Ok);
+  BufferQueue::Buffer Extra;
+  ASSERT_EQ(Buffers.getBuffer(Extra), BufferQueue::ErrorCode::NotEnoughMemory);
+  for (int I = 0; I < 8; ++I)
+    for (int J = I + 1; J < 8; ++J)
+      ASSERT_NE(B[I].Data, B[J].Data);
+}
+
 TEST(BufferQueueTest, Apply) {
   bool Success = false;
   BufferQueue Buffers(kSize, 10, Success);
@@ -231,5 +231,48 @@ TEST(profileCollectorServiceTest, PostSerializeCollectMultipleThread) {
   ValidateBlock(B);
 }
 
+TEST(profileCollectorServiceTest, PostMergeSerializeCollectMultipleThread) {
+  profilingFlags()->setDefaults();
+  profilingFlags()->merge_threads = true;
+
+  profileCollectorService::reset();
+
+  std::thread t1(threadProcessing);
+  std::thread t2(threadProcessing);
+
+  t1.join();
+  t2.join();
+
+  profileCollectorService::serialize();
+
+  // Ensure that we see a single block, for thread 0, with the profiles of both
+  // threads summed up.
+  auto B = profileCollectorService::nextBuffer({nullptr, 0});
+  ValidateFileHeaderBlock(B);
+
+  B = profileCollectorService::nextBuffer(B);
+  ASSERT_NE(static_cast<const void *>(B.Data), nullptr);
+  u32 BlockSize;
+  u32 BlockNum;
+  u64 ThreadId;
+  std::tie(BlockSize, BlockNum, ThreadId) = ParseBlockHeader(B);
+  ASSERT_EQ(ThreadId, 0u);
+
+  auto DStart = static_cast<const char *>(B.Data) + kHeaderSize;
+  std::vector<char> D(DStart, DStart + BlockSize);
+  B = profileCollectorService::nextBuffer(B);
+  ASSERT_EQ(B.Data, nullptr);
+
+  Profile Profile1, Profile2;
+  auto P = static_cast<const char *>(D.data());
+  std::tie(Profile1, P) = ParseProfile(P);
+  std::tie(Profile2, P) = ParseProfile(P);
+  ASSERT_EQ(Profile1.CallCount, 2);
+  ASSERT_EQ(Profile2.CallCount, 2);
+
+  profilingFlags()->setDefaults();
+  profileCollectorService::reset();
+}
+
 } // namespace
 } // namespace __xray
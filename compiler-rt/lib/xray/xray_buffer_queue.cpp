@@ -132,11 +132,13 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
     Buf.ExtentsBackingStore = ExtentsBackingStore;
     Buf.Count = BufferCount;
     T.Used = false;
+    // All the buffers start out available, as if they had been released at
+    // positions [0, BufferCount).
+    atomic_store(&T.Sequence, i + 1, memory_order_relaxed);
   }
 
-  Next = Buffers;
-  First = Buffers;
-  LiveBuffers = 0;
+  atomic_store(&GetPosition, 0, memory_order_relaxed);
+  atomic_store(&ReleasePosition, BufferCount, memory_order_relaxed);
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
@@ -151,9 +153,8 @@ BufferQueue::BufferQueue(size_t B, size_t N,
       BackingStore(nullptr),
       ExtentsBackingStore(nullptr),
       Buffers(nullptr),
-      Next(Buffers),
-      First(Buffers),
-      LiveBuffers(0),
+      GetPosition{0},
+      ReleasePosition{0},
       Generation{0} {
   Success = init(B, N) == BufferQueue::ErrorCode::Ok;
 }
@@ -162,15 +163,22 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   if (atomic_load(&Finalizing, memory_order_acquire))
     return ErrorCode::QueueFinalizing;
 
+  // Claim the slot at the get position, unless it has not been released yet,
+  // in which case all the buffers are live.
   BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
+  u64 Pos = atomic_load(&GetPosition, memory_order_relaxed);
+  while (true) {
+    B = &Buffers[Pos % BufferCount];
+    u64 Seq = atomic_load(&B->Sequence, memory_order_acquire);
+    if (Seq == Pos + 1) {
+      if (atomic_compare_exchange_weak(&GetPosition, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+    } else if (static_cast<s64>(Seq - (Pos + 1)) < 0) {
       return ErrorCode::NotEnoughMemory;
-    B = Next++;
-    if (Next == (Buffers + BufferCount))
-      Next = Buffers;
-    ++LiveBuffers;
+    } else {
+      Pos = atomic_load(&GetPosition, memory_order_relaxed);
+    }
   }
 
   incRefCount(BackingStore);
@@ -178,30 +186,44 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   Buf = B->Buff;
   Buf.Generation = generation();
   B->Used = true;
+
+  // Hand the slot over to the release that is a full round behind.
+  atomic_store(&B->Sequence, Pos + BufferCount, memory_order_release);
   return ErrorCode::Ok;
 }
 
 BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
+  // Buffers of a previous generation, and buffers beyond the ones that were
+  // handed out, are dropped without being placed in the queue.
+  auto DropBuffer = [&Buf] {
+    decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
+    decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
+    Buf = {};
+    return BufferQueue::ErrorCode::Ok;
+  };
+  if (Buf.Generation != generation())
+    return DropBuffer();
+
   // Check whether the buffer being referred to is within the bounds of the
   // backing store's range.
+  if (Buf.Data < &BackingStore->Data ||
+      Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
+    return BufferQueue::ErrorCode::UnrecognizedBuffer;
+
   BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (Buf.Generation != generation() || LiveBuffers == 0) {
-      Buf = {};
-      decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
-      decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-      return BufferQueue::ErrorCode::Ok;
+  u64 Pos = atomic_load(&ReleasePosition, memory_order_relaxed);
+  while (true) {
+    B = &Buffers[Pos % BufferCount];
+    u64 Seq = atomic_load(&B->Sequence, memory_order_acquire);
+    if (Seq == Pos) {
+      if (atomic_compare_exchange_weak(&ReleasePosition, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+    } else if (static_cast<s64>(Seq - Pos) < 0) {
+      return DropBuffer();
+    } else {
+      Pos = atomic_load(&ReleasePosition, memory_order_relaxed);
     }
-
-    if (Buf.Data < &BackingStore->Data ||
-        Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
-      return BufferQueue::ErrorCode::UnrecognizedBuffer;
-
-    --LiveBuffers;
-    B = First++;
-    if (First == (Buffers + BufferCount))
-      First = Buffers;
   }
 
   // Now that the buffer has been released, we mark it as "used".
@@ -212,6 +234,9 @@ BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
   atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
                memory_order_release);
   Buf = {};
+
+  // Make the slot available to the get at this position.
+  atomic_store(&B->Sequence, Pos + 1, memory_order_release);
   return ErrorCode::Ok;
 }
 
@@ -28,6 +28,14 @@ namespace __xray {
 /// get from or return buffers to the queue. This is one key component of the
 /// "flight data recorder" (FDR) mode to support ongoing XRay function call
 /// trace collection.
+///
+/// Getting and releasing buffers does not take a lock: every slot of the queue
+/// carries a sequence number that tells whether it holds a buffer that can be
+/// handed out or whether it is waiting for a released buffer, and threads
+/// claim slots by advancing the get and release positions with a
+/// compare-and-swap. Only initialisation and iteration over the buffers take
+/// the mutex, and callers must make sure that no thread is still getting or
+/// releasing buffers of the previous generation when they call init(...).
 class BufferQueue {
 public:
   /// ControlBlock represents the memory layout of how we interpret the backing
@@ -71,6 +79,11 @@ public:
     // This is true if the buffer has been returned to the available queue, and
     // is considered "used" by another thread.
     bool Used = false;
+
+    // The position in the queue of the next operation that may use this slot:
+    // a getBuffer(...) at position P when this is P + 1, or a
+    // releaseBuffer(...) at position P when this is P.
+    atomic_uint64_t Sequence;
   };
 
 private:
@@ -149,15 +162,14 @@ private:
   // A dynamically allocated array of BufferRep instances.
   BufferRep *Buffers;
 
-  // Pointer to the next buffer to be handed out.
-  BufferRep *Next;
+  // Position of the next buffer to be handed out, which lives in
+  // Buffers[GetPosition % BufferCount]. Positions only ever increase within a
+  // generation.
+  atomic_uint64_t GetPosition;
 
-  // Pointer to the entry in the array where the next released buffer will be
+  // Position of the entry in the array where the next released buffer will be
   // placed.
-  BufferRep *First;
-
-  // Count of buffers that have been handed out through 'getBuffer'.
-  size_t LiveBuffers;
+  atomic_uint64_t ReleasePosition;
 
   // We use a generation number to identify buffers and which generation they're
   // associated with.
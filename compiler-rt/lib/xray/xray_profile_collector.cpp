@@ -99,10 +99,36 @@ static typename std::aligned_storage<sizeof(ProfileBufferArrayAllocator)>::type
 static ProfileBufferArrayAllocator *ProfileBuffersAllocator = nullptr;
 static ProfileBufferArray *ProfileBuffers = nullptr;
 
+// With the merge_threads flag, the tries that threads post are merged into
+// this trie, backed by its own allocators.
+static typename std::aligned_storage<
+    sizeof(FunctionCallTrie::Allocators),
+    alignof(FunctionCallTrie::Allocators)>::type MergedAllocatorsStorage;
+static typename std::aligned_storage<sizeof(FunctionCallTrie),
+                                     alignof(FunctionCallTrie)>::type
+    MergedTrieStorage;
+
+static FunctionCallTrie::Allocators *MergedAllocators = nullptr;
+static FunctionCallTrie *MergedTrie = nullptr;
+
 // Use a global flag to determine whether the collector implementation has been
 // initialized.
 static atomic_uint8_t CollectorInitialized{0};
 
+// Destroys the data that a thread handed us, returning its buffers to Q.
+static void releaseThreadData(BufferQueue *Q, FunctionCallTrie &T,
+                              FunctionCallTrie::Allocators &A,
+                              FunctionCallTrie::Allocators::Buffers &B)
+    XRAY_NEVER_INSTRUMENT {
+  T.~FunctionCallTrie();
+  A.~Allocators();
+  Q->releaseBuffer(B.NodeBuffer);
+  Q->releaseBuffer(B.RootsBuffer);
+  Q->releaseBuffer(B.ShadowStackBuffer);
+  Q->releaseBuffer(B.NodeIdPairBuffer);
+  B.~Buffers();
+}
+
 } // namespace
 
 void post(BufferQueue *Q, FunctionCallTrie &&T,
@@ -113,13 +139,7 @@ void post(BufferQueue *Q, FunctionCallTrie &&T,
 
   // Bail out early if the collector has not been initialized.
   if (!atomic_load(&CollectorInitialized, memory_order_acquire)) {
-    T.~FunctionCallTrie();
-    A.~Allocators();
-    Q->releaseBuffer(B.NodeBuffer);
-    Q->releaseBuffer(B.RootsBuffer);
-    Q->releaseBuffer(B.ShadowStackBuffer);
-    Q->releaseBuffer(B.NodeIdPairBuffer);
-    B.~Buffers();
+    releaseThreadData(Q, T, A, B);
     return;
   }
 
@@ -128,17 +148,19 @@ void post(BufferQueue *Q, FunctionCallTrie &&T,
     DCHECK_NE(TDAllocator, nullptr);
     DCHECK_NE(TDArray, nullptr);
 
+    // When merging, the thread's data is folded into the merged trie now, so
+    // that its buffers can be reused by the threads that come after it.
+    if (MergedTrie != nullptr) {
+      T.mergeInto(*MergedTrie);
+      releaseThreadData(Q, T, A, B);
+      return;
+    }
+
     if (TDArray->AppendEmplace(Q, std::move(B), std::move(A), std::move(T),
                                TId) == nullptr) {
       // If we fail to add the data to the array, we should destroy the objects
       // handed us.
-      T.~FunctionCallTrie();
-      A.~Allocators();
-      Q->releaseBuffer(B.NodeBuffer);
-      Q->releaseBuffer(B.RootsBuffer);
-      Q->releaseBuffer(B.ShadowStackBuffer);
-      Q->releaseBuffer(B.NodeIdPairBuffer);
-      B.~Buffers();
+      releaseThreadData(Q, T, A, B);
     }
   }
 }
@@ -241,7 +263,8 @@ void serialize() XRAY_NEVER_INSTRUMENT {
   ProfileBuffers->trim(ProfileBuffers->size());
 
   DCHECK_NE(TDArray, nullptr);
-  if (TDArray->empty())
+  if (TDArray->empty() &&
+      (MergedTrie == nullptr || MergedTrie->getRoots().empty()))
     return;
 
   // Then repopulate the global ProfileBuffers.
@@ -261,7 +284,8 @@ void serialize() XRAY_NEVER_INSTRUMENT {
   auto PathArenaCleanup = at_scope_exit(
       [&]() XRAY_NEVER_INSTRUMENT { deallocateBuffer(PathArena, MaxSize); });
 
-  for (const auto &ThreadTrie : *TDArray) {
+  auto SerializeTrie = [&](const FunctionCallTrie &FCT,
+                           tid_t TId) XRAY_NEVER_INSTRUMENT {
     using ProfileRecordAllocator = typename ProfileRecordArray::AllocatorType;
     ProfileRecordAllocator PRAlloc(ProfileArena,
                                    profilingFlags()->global_allocator_max);
@@ -273,11 +297,11 @@ void serialize() XRAY_NEVER_INSTRUMENT {
     // use a local allocator and an __xray::Array<...> to store the intermediary
     // data, then compute the size as we're going along. Then we'll allocate the
     // contiguous space to contain the thread buffer data.
-    if (ThreadTrie.FCT.getRoots().empty())
-      continue;
+    if (FCT.getRoots().empty())
+      return;
 
-    populateRecords(ProfileRecords, PathAlloc, ThreadTrie.FCT);
-    DCHECK(!ThreadTrie.FCT.getRoots().empty());
+    populateRecords(ProfileRecords, PathAlloc, FCT);
+    DCHECK(!FCT.getRoots().empty());
     DCHECK(!ProfileRecords.empty());
 
     // Go through each record, to compute the sizes.
@@ -293,13 +317,18 @@ void serialize() XRAY_NEVER_INSTRUMENT {
     for (const auto &Record : ProfileRecords)
       CumulativeSizes += 20 + (4 * Record.Path.size());
 
-    BlockHeader Header{16 + CumulativeSizes, I++, ThreadTrie.TId};
+    BlockHeader Header{16 + CumulativeSizes, I++, TId};
     auto B = ProfileBuffers->Append({});
     B->Size = sizeof(Header) + CumulativeSizes;
     B->Data = allocateBuffer(B->Size);
     DCHECK_NE(B->Data, nullptr);
     serializeRecords(B, Header, ProfileRecords);
-  }
+  };
+
+  for (const auto &ThreadTrie : *TDArray)
+    SerializeTrie(ThreadTrie.FCT, ThreadTrie.TId);
+  if (MergedTrie != nullptr)
+    SerializeTrie(*MergedTrie, 0);
 }
 
 void reset() XRAY_NEVER_INSTRUMENT {
@@ -334,6 +363,13 @@ void reset() XRAY_NEVER_INSTRUMENT {
     TDAllocator = nullptr;
   }
 
+  if (MergedTrie != nullptr) {
+    MergedTrie->~FunctionCallTrie();
+    MergedTrie = nullptr;
+    MergedAllocators->~Allocators();
+    MergedAllocators = nullptr;
+  }
+
   if (Buffer.Data != nullptr) {
     BQ->releaseBuffer(Buffer);
   }
@@ -372,6 +408,16 @@ void reset() XRAY_NEVER_INSTRUMENT {
   new (&ThreadDataArrayStorage) ThreadDataArray(*TDAllocator);
   TDArray = reinterpret_cast<ThreadDataArray *>(&ThreadDataArrayStorage);
 
+  if (profilingFlags()->merge_threads) {
+    new (&MergedAllocatorsStorage)
+        FunctionCallTrie::Allocators(FunctionCallTrie::InitAllocatorsCustom(
+            profilingFlags()->global_allocator_max));
+    MergedAllocators = reinterpret_cast<FunctionCallTrie::Allocators *>(
+        &MergedAllocatorsStorage);
+    new (&MergedTrieStorage) FunctionCallTrie(*MergedAllocators);
+    MergedTrie = reinterpret_cast<FunctionCallTrie *>(&MergedTrieStorage);
+  }
+
   atomic_store(&CollectorInitialized, 1, memory_order_release);
 }
 
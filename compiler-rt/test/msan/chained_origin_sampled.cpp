@@ -0,0 +1,45 @@
+// RUN: %clangxx_msan -fsanitize-memory-track-origins=2 -O3 %s -o %t
+
+// RUN: MSAN_OPTIONS=origin_history_sample_rate=1 not %run %t >%t.out 2>&1
+// RUN: FileCheck %s --check-prefix=CHECK --check-prefix=CHECK-ALL < %t.out
+
+// The first uninitialized store of the thread is recorded, the second one is
+// not.
+// RUN: MSAN_OPTIONS=origin_history_sample_rate=2 not %run %t >%t.out 2>&1
+// RUN: FileCheck %s --check-prefix=CHECK --check-prefix=CHECK-SAMPLED < %t.out
+
+// RUN: %clangxx_msan -mllvm -msan-instrumentation-with-call-threshold=0 -fsanitize-memory-track-origins=2 -O3 %s -o %t
+
+// RUN: MSAN_OPTIONS=origin_history_sample_rate=2 not %run %t >%t.out 2>&1
+// RUN: FileCheck %s --check-prefix=CHECK --check-prefix=CHECK-SAMPLED < %t.out
+
+volatile int x, y;
+
+__attribute__((noinline))
+void fn_g(int a) {
+  x = a;
+}
+
+__attribute__((noinline))
+void fn_h() {
+  y = x;
+}
+
+int main(int argc, char *argv[]) {
+  int volatile z;
+  fn_g(z);
+  fn_h();
+  return y;
+}
+
+// CHECK: WARNING: MemorySanitizer: use-of-uninitialized-value
+
+// CHECK-ALL: Uninitialized value was stored to memory at
+// CHECK-ALL: in fn_h
+
+// CHECK-SAMPLED-NOT: in fn_h
+// CHECK: Uninitialized value was stored to memory at
+// CHECK: in fn_g
+// CHECK-NOT: Uninitialized value was stored to memory at
+
+// CHECK: Uninitialized value was created by an allocation of 'z' in the stack frame of function 'main'
@@ -0,0 +1,27 @@
+// RUN: %clang_profgen -mllvm -runtime-counter-relocation -o %t %s
+// RUN: rm -f %t.profraw
+// RUN: env LLVM_PROFILE_FILE="%c%t.profraw" %run %t
+// RUN: llvm-profdata show --all-functions --counts %t.profraw | FileCheck %s
+
+// The program leaves through _exit(), so the counters only reach the profile
+// through the mapping set up for continuous mode.
+
+// CHECK-LABEL: foo:
+// CHECK: Function count: 3
+// CHECK-LABEL: main:
+// CHECK: Function count: 1
+
+#include <unistd.h>
+
+int __llvm_profile_is_continuous_mode_enabled(void);
+
+void foo() {}
+
+int main() {
+  if (!__llvm_profile_is_continuous_mode_enabled())
+    return 1;
+  foo();
+  foo();
+  foo();
+  _exit(0);
+}
@@ -0,0 +1,56 @@
+// RUN: %clang_profgen -mllvm -instrprof-counter-shards -o %t %s -lpthread
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --all-functions --counts %t.profraw | FileCheck %s
+
+// Writing the profile while a thread still counts into its shard neither
+// loses nor repeats its counts in the profile written at exit.
+
+// CHECK-LABEL: work:
+// CHECK: Function count: 3
+// CHECK: Block counts: [3000]
+
+#include <pthread.h>
+
+int __llvm_profile_write_file(void);
+
+void work(void) {
+  for (int I = 0; I < 1000; ++I)
+    ;
+}
+
+static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t Cond = PTHREAD_COND_INITIALIZER;
+static int Step = 0;
+
+static void waitFor(int S) {
+  pthread_mutex_lock(&Mutex);
+  while (Step < S)
+    pthread_cond_wait(&Cond, &Mutex);
+  pthread_mutex_unlock(&Mutex);
+}
+
+static void advance(void) {
+  pthread_mutex_lock(&Mutex);
+  ++Step;
+  pthread_cond_broadcast(&Cond);
+  pthread_mutex_unlock(&Mutex);
+}
+
+void *thread(void *Arg) {
+  work();
+  work();
+  advance();
+  waitFor(2);
+  work();
+  return 0;
+}
+
+int main() {
+  pthread_t T;
+  pthread_create(&T, 0, thread, 0);
+  waitFor(1);
+  __llvm_profile_write_file();
+  advance();
+  pthread_join(T, 0);
+  return 0;
+}
@@ -0,0 +1,29 @@
+// RUN: %clang_profgen -mllvm -instrprof-counter-shards -o %t %s -lpthread
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --all-functions --counts %t.profraw | FileCheck %s
+
+// Every thread counts into its own shard, and no count is lost when the
+// shards are added up, also for the threads that have already exited.
+
+// CHECK-LABEL: work:
+// CHECK: Function count: 8
+// CHECK: Block counts: [8000000]
+// CHECK-LABEL: main:
+// CHECK: Function count: 1
+
+#include <pthread.h>
+
+void *work(void *Arg) {
+  for (int I = 0; I < 1000000; ++I)
+    ;
+  return 0;
+}
+
+int main() {
+  pthread_t Threads[8];
+  for (int I = 0; I < 8; ++I)
+    pthread_create(&Threads[I], 0, work, 0);
+  for (int I = 0; I < 8; ++I)
+    pthread_join(Threads[I], 0);
+  return 0;
+}
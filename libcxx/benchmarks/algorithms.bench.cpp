@@ -248,6 +248,92 @@ struct PopHeap {
   };
 };
 
+enum class IntegerType { Uint8, Uint32, Uint64 };
+struct AllIntegerTypes : EnumValuesAsTuple<AllIntegerTypes, IntegerType, 3> {
+  static constexpr const char* Names[] = {"uint8", "uint32", "uint64"};
+};
+
+template <class I>
+using Integer = std::conditional_t<
+    I() == IntegerType::Uint8, uint8_t,
+    std::conditional_t<I() == IntegerType::Uint32, uint32_t, uint64_t> >;
+
+// The searches run to the last element, which is the only one to differ.
+template <class IntegerType>
+struct Find {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<Integer<IntegerType> > V(Quantity, 1);
+    V.back() = 2;
+    while (state.KeepRunningBatch(Quantity)) {
+      benchmark::DoNotOptimize(V.data());
+      benchmark::DoNotOptimize(std::find(V.data(), V.data() + V.size(), 2));
+    }
+  }
+
+  std::string name() const {
+    return "BM_Find" + IntegerType::name() + "_" + std::to_string(Quantity);
+  };
+};
+
+template <class IntegerType>
+struct Count {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<Integer<IntegerType> > V(Quantity, 1);
+    V.back() = 2;
+    while (state.KeepRunningBatch(Quantity)) {
+      benchmark::DoNotOptimize(V.data());
+      benchmark::DoNotOptimize(std::count(V.data(), V.data() + V.size(), 2));
+    }
+  }
+
+  std::string name() const {
+    return "BM_Count" + IntegerType::name() + "_" + std::to_string(Quantity);
+  };
+};
+
+template <class IntegerType>
+struct Mismatch {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<Integer<IntegerType> > A(Quantity, 1), B(Quantity, 1);
+    B.back() = 2;
+    while (state.KeepRunningBatch(Quantity)) {
+      benchmark::DoNotOptimize(A.data());
+      benchmark::DoNotOptimize(
+          std::mismatch(A.data(), A.data() + A.size(), B.data()).first);
+    }
+  }
+
+  std::string name() const {
+    return "BM_Mismatch" + IntegerType::name() + "_" +
+           std::to_string(Quantity);
+  };
+};
+
+template <class IntegerType>
+struct Equal {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<Integer<IntegerType> > A(Quantity, 1), B(Quantity, 1);
+    B.back() = 2;
+    while (state.KeepRunningBatch(Quantity)) {
+      benchmark::DoNotOptimize(A.data());
+      benchmark::DoNotOptimize(
+          std::equal(A.data(), A.data() + A.size(), B.data()));
+    }
+  }
+
+  std::string name() const {
+    return "BM_Equal" + IntegerType::name() + "_" + std::to_string(Quantity);
+  };
+};
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -266,5 +352,9 @@ int main(int argc, char** argv) {
       Quantities);
   makeCartesianProductBenchmark<PushHeap, AllValueTypes, AllOrders>(Quantities);
   makeCartesianProductBenchmark<PopHeap, AllValueTypes>(Quantities);
+  makeCartesianProductBenchmark<Find, AllIntegerTypes>(Quantities);
+  makeCartesianProductBenchmark<Count, AllIntegerTypes>(Quantities);
+  makeCartesianProductBenchmark<Mismatch, AllIntegerTypes>(Quantities);
+  makeCartesianProductBenchmark<Equal, AllIntegerTypes>(Quantities);
   benchmark::RunSpecifiedBenchmarks();
 }
@@ -0,0 +1,195 @@
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "GenerateInput.hpp"
+#include "test_macros.h"
+
+// Compares std::__flat_hash_map, the open addressing libc++ extension, with
+// std::unordered_map.
+#if defined(_LIBCPP_VERSION) && TEST_STD_VER > 14
+
+#include <__flat_hash_map>
+
+constexpr std::size_t TestNumInputs = 1024;
+
+template <class Container, class GenInputs>
+void BM_InsertValue(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  const auto end = in.end();
+  while (st.KeepRunning()) {
+    c.clear();
+    for (auto it = in.begin(); it != end; ++it) {
+      benchmark::DoNotOptimize(&(*c.emplace(*it, *it).first));
+    }
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+void BM_InsertDuplicate(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  const auto end = in.end();
+  for (auto it = in.begin(); it != end; ++it)
+    c.emplace(*it, *it);
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    for (auto it = in.begin(); it != end; ++it) {
+      benchmark::DoNotOptimize(&(*c.emplace(*it, *it).first));
+    }
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+void BM_Find(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  for (auto it = in.begin(); it != in.end(); ++it)
+    c.emplace(*it, *it);
+  benchmark::DoNotOptimize(&(*c.begin()));
+  const auto end = in.data() + in.size();
+  while (st.KeepRunning()) {
+    for (auto it = in.data(); it != end; ++it) {
+      benchmark::DoNotOptimize(&(*c.find(*it)));
+    }
+    benchmark::ClobberMemory();
+  }
+}
+
+// Looks up keys which aren't in the map: every probe sequence runs to its end.
+template <class Container, class GenInputs>
+void BM_FindMiss(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(2 * st.range(0));
+  const auto mid = in.begin() + in.size() / 2;
+  for (auto it = in.begin(); it != mid; ++it)
+    c.emplace(*it, *it);
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    for (auto it = mid; it != in.end(); ++it) {
+      benchmark::DoNotOptimize(c.find(*it) == c.end());
+    }
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+void BM_EraseInsert(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  const auto end = in.end();
+  for (auto it = in.begin(); it != end; ++it)
+    c.emplace(*it, *it);
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    for (auto it = in.begin(); it != end; ++it) {
+      c.erase(*it);
+      benchmark::DoNotOptimize(&(*c.emplace(*it, *it).first));
+    }
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+void BM_Iterate(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  for (auto it = in.begin(); it != in.end(); ++it)
+    c.emplace(*it, *it);
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    for (auto& v : c)
+      benchmark::DoNotOptimize(&v.second);
+    benchmark::ClobberMemory();
+  }
+}
+
+// Builds a map and then looks up each of its keys and as many absent ones, as
+// a program which fills a table once and then queries it does.
+template <class Container, class GenInputs>
+void BM_InsertFindMiss(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(2 * st.range(0));
+  const auto mid = in.begin() + in.size() / 2;
+  while (st.KeepRunning()) {
+    c.clear();
+    for (auto it = in.begin(); it != mid; ++it)
+      benchmark::DoNotOptimize(&(*c.emplace(*it, *it).first));
+    for (auto it = in.begin(); it != mid; ++it)
+      benchmark::DoNotOptimize(&(*c.find(*it)));
+    for (auto it = mid; it != in.end(); ++it)
+      benchmark::DoNotOptimize(c.find(*it) == c.end());
+    benchmark::ClobberMemory();
+  }
+}
+
+#define MAP_BENCHMARKS(BM, Name, Key, Gen)                                     \
+  BENCHMARK_CAPTURE(BM, unordered_map_##Name,                                  \
+                    std::unordered_map<Key, Key>{}, Gen)                       \
+      ->Arg(TestNumInputs)->Arg(TestNumInputs * 64);                           \
+  BENCHMARK_CAPTURE(BM, flat_hash_map_##Name,                                  \
+                    std::__flat_hash_map<Key, Key>{}, Gen)                     \
+      ->Arg(TestNumInputs)->Arg(TestNumInputs * 64)
+
+//----------------------------------------------------------------------------//
+//                       BM_InsertValue
+// ---------------------------------------------------------------------------//
+
+MAP_BENCHMARKS(BM_InsertValue, random_uint32, uint32_t,
+               getRandomIntegerInputs<uint32_t>);
+MAP_BENCHMARKS(BM_InsertValue, sorted_uint32, uint32_t,
+               getSortedIntegerInputs<uint32_t>);
+MAP_BENCHMARKS(BM_InsertValue, top_bits_uint32, uint32_t,
+               getSortedTopBitsIntegerInputs<uint32_t>);
+MAP_BENCHMARKS(BM_InsertValue, string, std::string, getRandomStringInputs);
+
+//----------------------------------------------------------------------------//
+//                       BM_InsertDuplicate
+// ---------------------------------------------------------------------------//
+
+MAP_BENCHMARKS(BM_InsertDuplicate, random_uint64, uint64_t,
+               getRandomIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(BM_InsertDuplicate, string, std::string, getRandomStringInputs);
+
+//----------------------------------------------------------------------------//
+//                         BM_Find
+// ---------------------------------------------------------------------------//
+
+MAP_BENCHMARKS(BM_Find, random_uint64, uint64_t,
+               getRandomIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(BM_Find, sorted_uint64, uint64_t,
+               getSortedIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(BM_Find, string, std::string, getRandomStringInputs);
+MAP_BENCHMARKS(BM_FindMiss, random_uint64, uint64_t,
+               getRandomIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(BM_FindMiss, string, std::string, getRandomStringInputs);
+
+//----------------------------------------------------------------------------//
+//                       BM_EraseInsert, BM_Iterate
+// ---------------------------------------------------------------------------//
+
+MAP_BENCHMARKS(BM_EraseInsert, random_uint64, uint64_t,
+               getRandomIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(BM_Iterate, random_uint64, uint64_t,
+               getRandomIntegerInputs<uint64_t>);
+
+//----------------------------------------------------------------------------//
+//                       BM_InsertFindMiss
+// ---------------------------------------------------------------------------//
+
+// A million keys, which don't fit in the caches.
+BENCHMARK_CAPTURE(BM_InsertFindMiss, unordered_map_random_uint64,
+                  std::unordered_map<uint64_t, uint64_t>{},
+                  getRandomIntegerInputs<uint64_t>)
+    ->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_InsertFindMiss, flat_hash_map_random_uint64,
+                  std::__flat_hash_map<uint64_t, uint64_t>{},
+                  getRandomIntegerInputs<uint64_t>)
+    ->Arg(1 << 20);
+
+BENCHMARK_MAIN();
+
+#else
+
+int main() { return 0; }
+
+#endif
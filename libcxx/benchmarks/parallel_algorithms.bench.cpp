@@ -0,0 +1,145 @@
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CartesianBenchmarks.hpp"
+#include "benchmark/benchmark.h"
+#include "test_macros.h"
+
+// libc++ has the policy overloads when it is built with
+// LIBCXX_ENABLE_PARALLEL_ALGORITHMS.
+#if defined(_LIBCPP_HAS_PARALLEL_ALGORITHMS) ||                                \
+    (!defined(_LIBCPP_VERSION) && defined(__cpp_lib_execution))
+
+namespace {
+
+enum class Policy { Seq, Par };
+struct AllPolicies : EnumValuesAsTuple<AllPolicies, Policy, 2> {
+  static constexpr const char* Names[] = {"Seq", "Par"};
+};
+
+template <class P, class F>
+TEST_ALWAYS_INLINE void withPolicy(F f) {
+  if constexpr (P() == Policy::Seq)
+    f(std::execution::seq);
+  else
+    f(std::execution::par);
+}
+
+std::vector<uint32_t> makeRandomValues(size_t N) {
+  std::mt19937 M(N);
+  std::vector<uint32_t> V(N);
+  for (uint32_t& X : V)
+    X = M();
+  return V;
+}
+
+template <class P>
+struct Sort {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    const auto Orig = makeRandomValues(Quantity);
+    auto Copy = Orig;
+    while (state.KeepRunningBatch(Quantity)) {
+      state.PauseTiming();
+      Copy = Orig;
+      state.ResumeTiming();
+      withPolicy<P>([&](auto&& Exec) {
+        std::sort(Exec, Copy.begin(), Copy.end());
+      });
+      benchmark::DoNotOptimize(Copy.data());
+    }
+  }
+
+  std::string name() const {
+    return "BM_ParallelSort" + P::name() + "_" + std::to_string(Quantity);
+  }
+};
+
+template <class P>
+struct ForEach {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<double> V(Quantity, 1.0);
+    while (state.KeepRunningBatch(Quantity)) {
+      withPolicy<P>([&](auto&& Exec) {
+        std::for_each(Exec, V.begin(), V.end(),
+                      [](double& X) { X = X * 0.5 + 1.0; });
+      });
+      benchmark::DoNotOptimize(V.data());
+    }
+  }
+
+  std::string name() const {
+    return "BM_ParallelForEach" + P::name() + "_" + std::to_string(Quantity);
+  }
+};
+
+template <class P>
+struct TransformReduce {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<double> A(Quantity, 1.5), B(Quantity, 2.0);
+    while (state.KeepRunningBatch(Quantity)) {
+      withPolicy<P>([&](auto&& Exec) {
+        benchmark::DoNotOptimize(
+            std::transform_reduce(Exec, A.begin(), A.end(), B.begin(), 0.0));
+      });
+    }
+  }
+
+  std::string name() const {
+    return "BM_ParallelTransformReduce" + P::name() + "_" +
+           std::to_string(Quantity);
+  }
+};
+
+template <class P>
+struct InclusiveScan {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<uint64_t> In(Quantity, 3), Out(Quantity);
+    while (state.KeepRunningBatch(Quantity)) {
+      withPolicy<P>([&](auto&& Exec) {
+        std::inclusive_scan(Exec, In.begin(), In.end(), Out.begin());
+      });
+      benchmark::DoNotOptimize(Out.data());
+    }
+  }
+
+  std::string name() const {
+    return "BM_ParallelInclusiveScan" + P::name() + "_" +
+           std::to_string(Quantity);
+  }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  const std::vector<size_t> Quantities = {1 << 10, 1 << 14, 1 << 18, 1 << 22};
+  makeCartesianProductBenchmark<Sort, AllPolicies>(Quantities);
+  makeCartesianProductBenchmark<ForEach, AllPolicies>(Quantities);
+  makeCartesianProductBenchmark<TransformReduce, AllPolicies>(Quantities);
+  makeCartesianProductBenchmark<InclusiveScan, AllPolicies>(Quantities);
+  benchmark::RunSpecifiedBenchmarks();
+}
+
+#else
+
+int main() { return 0; }
+
+#endif
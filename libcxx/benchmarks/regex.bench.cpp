@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "test_macros.h"
+
+// Compares regex_search and regex_match without match_results, which may run
+// the DFA of the pattern, with the overloads with match_results, which
+// backtrack, on lines of a log.
+#if TEST_STD_VER > 14
+
+constexpr std::size_t TestNumInputs = 1024;
+
+std::vector<std::string> getLogLines() {
+  static const char* const levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+  static const char* const paths[] = {"/index.html", "/api/v1/users",
+                                      "/static/app.js", "/login"};
+  std::mt19937 gen(42);
+  std::vector<std::string> lines;
+  for (std::size_t i = 0; i != TestNumInputs; ++i) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "2020-%02u-%02u %02u:%02u:%02u [%s] 10.%u.%u.%u GET %s "
+                  "took %u ms, user=user%u@example.com",
+                  gen() % 12 + 1, gen() % 28 + 1, gen() % 24, gen() % 60,
+                  gen() % 60, levels[gen() % 4], gen() % 256, gen() % 256,
+                  gen() % 256, paths[gen() % 4], gen() % 5000, gen() % 1000);
+    lines.push_back(buf);
+  }
+  return lines;
+}
+
+enum class Overload { NoResults, Results };
+
+template <bool Match>
+void BM_Regex(benchmark::State& st, const char* pattern, Overload overload) {
+  std::vector<std::string> lines = getLogLines();
+  std::regex re(pattern);
+  std::smatch m;
+  while (st.KeepRunning()) {
+    for (const std::string& line : lines) {
+      if (overload == Overload::NoResults)
+        benchmark::DoNotOptimize(Match ? std::regex_match(line, re)
+                                       : std::regex_search(line, re));
+      else
+        benchmark::DoNotOptimize(Match ? std::regex_match(line, m, re)
+                                       : std::regex_search(line, m, re));
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * lines.size());
+}
+
+#define REGEX_BENCHMARKS(BM, Name, Pattern)                                    \
+  BENCHMARK_CAPTURE(BM, Name##_no_results, Pattern, Overload::NoResults);     \
+  BENCHMARK_CAPTURE(BM, Name##_results, Pattern, Overload::Results)
+
+REGEX_BENCHMARKS(BM_Regex<false>, search_literal, "ERROR");
+REGEX_BENCHMARKS(BM_Regex<false>, search_alternatives, "\\[(WARN|ERROR)\\]");
+REGEX_BENCHMARKS(BM_Regex<false>, search_repeats, "took [0-9]{4,} ms");
+REGEX_BENCHMARKS(BM_Regex<false>, search_email, "[\\w.]+@[\\w.]+\\.(com|org)$");
+REGEX_BENCHMARKS(BM_Regex<false>, search_missing, "\\d+\\.\\d+ POST");
+REGEX_BENCHMARKS(BM_Regex<true>, match_line,
+                 "\\d{4}-\\d\\d-\\d\\d .*\\[INFO\\].*");
+
+BENCHMARK_MAIN();
+
+#else
+
+int main() { return 0; }
+
+#endif
@@ -37,4 +37,25 @@ static void BM_Istream_numbers(benchmark::State &state) {
 }
 
 BENCHMARK(BM_Istream_numbers)->RangeMultiplier(2)->Range(1024, 4096);
+
+TEST_NOINLINE std::size_t ostream_numbers();
+
+// A line of a log, in the classic locale.
+std::size_t ostream_numbers() {
+  std::ostringstream s;
+  for (int i = 0; i < 16; i++) {
+    s << "id=" << i * 7919 << " size=" << 1234567u + i << " offset="
+      << -98765432101LL * i << " ratio=" << 0.125 * i << " load=" << 1.5e-3f
+      << " flags=" << std::hex << 0xbeef + i << std::dec << '\n';
+  }
+  return s.str().size();
+}
+
+static void BM_Ostream_numbers(benchmark::State &state) {
+  std::size_t n = 0;
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(n += ostream_numbers());
+}
+
+BENCHMARK(BM_Ostream_numbers);
 BENCHMARK_MAIN();
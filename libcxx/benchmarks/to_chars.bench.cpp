@@ -0,0 +1,129 @@
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "test_macros.h"
+
+// Compares the floating point to_chars and from_chars with the printf and
+// strtod which they replace, on the values of random bits.
+#if TEST_STD_VER > 14
+
+constexpr std::size_t TestNumInputs = 1024;
+
+template <class T>
+std::vector<T> getRandomInputs() {
+  std::mt19937_64 gen(42);
+  std::vector<T> inputs;
+  while (inputs.size() != TestNumInputs) {
+    std::uint64_t bits = gen();
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    if (value == value && value - value == 0)
+      inputs.push_back(value);
+  }
+  return inputs;
+}
+
+// 17 and 9 digits read back as the same double and float.
+template <class T>
+std::vector<std::string> getRandomStrings() {
+  std::vector<std::string> strings;
+  for (T value : getRandomInputs<T>()) {
+    char buf[64];
+    int n = std::snprintf(buf, sizeof(buf), "%.*g", sizeof(T) == 4 ? 9 : 17,
+                          static_cast<double>(value));
+    strings.emplace_back(buf, n);
+  }
+  return strings;
+}
+
+template <class T>
+void BM_ToChars(benchmark::State& st) {
+  auto in = getRandomInputs<T>();
+  char buf[64];
+  for (auto _ : st) {
+    for (T value : in) {
+      benchmark::DoNotOptimize(std::to_chars(buf, buf + sizeof(buf), value).ptr);
+      benchmark::ClobberMemory();
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_ToChars, float);
+BENCHMARK_TEMPLATE(BM_ToChars, double);
+
+template <class T>
+void BM_ToCharsScientific(benchmark::State& st) {
+  auto in = getRandomInputs<T>();
+  char buf[64];
+  for (auto _ : st) {
+    for (T value : in) {
+      benchmark::DoNotOptimize(
+          std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific).ptr);
+      benchmark::ClobberMemory();
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_ToCharsScientific, float);
+BENCHMARK_TEMPLATE(BM_ToCharsScientific, double);
+
+// The precision which always reads back as the same value.
+template <class T>
+void BM_Snprintf(benchmark::State& st) {
+  auto in = getRandomInputs<T>();
+  char buf[64];
+  for (auto _ : st) {
+    for (T value : in) {
+      benchmark::DoNotOptimize(std::snprintf(buf, sizeof(buf), "%.*g", sizeof(T) == 4 ? 9 : 17,
+                                             static_cast<double>(value)));
+      benchmark::ClobberMemory();
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_Snprintf, float);
+BENCHMARK_TEMPLATE(BM_Snprintf, double);
+
+template <class T>
+void BM_FromChars(benchmark::State& st) {
+  auto in = getRandomStrings<T>();
+  for (auto _ : st) {
+    for (const std::string& s : in) {
+      T value;
+      benchmark::DoNotOptimize(std::from_chars(s.data(), s.data() + s.size(), value).ptr);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_FromChars, float);
+BENCHMARK_TEMPLATE(BM_FromChars, double);
+
+void BM_Strtod(benchmark::State& st) {
+  auto in = getRandomStrings<double>();
+  for (auto _ : st) {
+    for (const std::string& s : in)
+      benchmark::DoNotOptimize(std::strtod(s.c_str(), nullptr));
+  }
+}
+BENCHMARK(BM_Strtod);
+
+void BM_Strtof(benchmark::State& st) {
+  auto in = getRandomStrings<float>();
+  for (auto _ : st) {
+    for (const std::string& s : in)
+      benchmark::DoNotOptimize(std::strtof(s.c_str(), nullptr));
+  }
+}
+BENCHMARK(BM_Strtof);
+
+BENCHMARK_MAIN();
+
+#else
+
+int main() { return 0; }
+
+#endif
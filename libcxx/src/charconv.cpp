@@ -7,8 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "charconv"
+#include "bit"
+#include "locale"
+#include "string"
 #include <string.h>
 
+#include "include/charconv_tables.h"
+
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 namespace __itoa
@@ -157,4 +162,987 @@ __u64toa(uint64_t value, char* buffer)
 
 }  // namespace __itoa
 
+namespace __floating_point
+{
+
+// The shortest decimal forms of float and double come from Ryu (Ulf Adams,
+// "Ryu: fast float-to-string conversion", PLDI 2018), the parsing of decimal
+// numbers from the Eisel-Lemire algorithm (Daniel Lemire, "Number parsing at
+// a gigabyte per second", 2021), with strtod in the "C" locale for the rare
+// numbers of more than 19 digits which it can't round.
+
+inline uint64_t
+__umul128(uint64_t __a, uint64_t __b, uint64_t* __high)
+{
+#ifndef _LIBCPP_HAS_NO_INT128
+    __uint128_t __r = static_cast<__uint128_t>(__a) * __b;
+    *__high = static_cast<uint64_t>(__r >> 64);
+    return static_cast<uint64_t>(__r);
+#else
+    const uint64_t __a_lo = static_cast<uint32_t>(__a), __a_hi = __a >> 32;
+    const uint64_t __b_lo = static_cast<uint32_t>(__b), __b_hi = __b >> 32;
+    const uint64_t __lo_lo = __a_lo * __b_lo;
+    const uint64_t __hi_lo = __a_hi * __b_lo;
+    const uint64_t __lo_hi = __a_lo * __b_hi;
+    const uint64_t __cross = (__lo_lo >> 32) + static_cast<uint32_t>(__hi_lo) + __lo_hi;
+    *__high = (__hi_lo >> 32) + (__cross >> 32) + __a_hi * __b_hi;
+    return (__cross << 32) | static_cast<uint32_t>(__lo_lo);
+#endif
+}
+
+// The bit length of 5^__e, for 0 <= __e <= 3528.
+inline int32_t
+__pow5bits(int32_t __e)
+{
+    return static_cast<int32_t>((static_cast<uint32_t>(__e) * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^__e)), for 0 <= __e <= 1650.
+inline uint32_t
+__log10_pow2(int32_t __e)
+{
+    return (static_cast<uint32_t>(__e) * 78913) >> 18;
+}
+
+// floor(log10(5^__e)), for 0 <= __e <= 2620.
+inline uint32_t
+__log10_pow5(int32_t __e)
+{
+    return (static_cast<uint32_t>(__e) * 732923) >> 20;
+}
+
+template <class _Uint>
+inline bool
+__multiple_of_pow5(_Uint __value, uint32_t __p)
+{
+    uint32_t __count = 0;
+    for (; __value % 5 == 0; __value /= 5)
+        ++__count;
+    return __count >= __p;
+}
+
+template <class _Uint>
+inline bool
+__multiple_of_pow2(_Uint __value, uint32_t __p)
+{
+    return (__value & ((_Uint(1) << __p) - 1)) == 0;
+}
+
+// (__m * __mul) >> __j, where __mul is {low, high} and 64 < __j < 128.
+inline uint64_t
+__mul_shift64(uint64_t __m, const uint64_t* __mul, int32_t __j)
+{
+    uint64_t __high0, __high1;
+    __umul128(__m, __mul[0], &__high0);
+    const uint64_t __low1 = __umul128(__m, __mul[1], &__high1);
+    const uint64_t __sum = __high0 + __low1;
+    if (__sum < __high0)
+        ++__high1;
+    const int32_t __dist = __j - 64;
+    return (__high1 << (64 - __dist)) | (__sum >> __dist);
+}
+
+// (__m * __factor) >> __shift, where 32 < __shift < 96.
+inline uint32_t
+__mul_shift32(uint32_t __m, uint64_t __factor, int32_t __shift)
+{
+    const uint64_t __bits0 = static_cast<uint64_t>(__m) * static_cast<uint32_t>(__factor);
+    const uint64_t __bits1 = static_cast<uint64_t>(__m) * (__factor >> 32);
+    return static_cast<uint32_t>(((__bits0 >> 32) + __bits1) >> (__shift - 32));
+}
+
+// __digits * 10^__exponent.
+struct __decimal
+{
+    uint64_t __digits;
+    int32_t __exponent;
+};
+
+// The shortest decimal in the interval of the reals which round to the double
+// of these fields, the closest one to it if there are several.
+__decimal
+__d2d(uint64_t __ieee_mantissa, uint32_t __ieee_exponent)
+{
+    const int32_t __mantissa_bits = 52, __bias = 1023;
+    int32_t __e2;
+    uint64_t __m2;
+    if (__ieee_exponent == 0)
+    {
+        __e2 = 1 - __bias - __mantissa_bits - 2;
+        __m2 = __ieee_mantissa;
+    }
+    else
+    {
+        __e2 = static_cast<int32_t>(__ieee_exponent) - __bias - __mantissa_bits - 2;
+        __m2 = (uint64_t(1) << __mantissa_bits) | __ieee_mantissa;
+    }
+    const bool __accept_bounds = (__m2 & 1) == 0;
+
+    // The interval is [__mm, __mp] / 4 * 2^(__e2 + 2), converted to decimal
+    // as [__vm, __vp] * 10^__e10.
+    const uint64_t __mv = 4 * __m2;
+    const uint32_t __mm_shift = __ieee_mantissa != 0 || __ieee_exponent <= 1;
+    uint64_t __vr, __vp, __vm;
+    int32_t __e10;
+    bool __vm_is_trailing_zeros = false;
+    bool __vr_is_trailing_zeros = false;
+    if (__e2 >= 0)
+    {
+        const uint32_t __q = __log10_pow2(__e2) - (__e2 > 3);
+        __e10 = static_cast<int32_t>(__q);
+        const int32_t __k = 125 + __pow5bits(static_cast<int32_t>(__q)) - 1;
+        const int32_t __i = -__e2 + static_cast<int32_t>(__q) + __k;
+        __vr = __mul_shift64(__mv, __pow5_inv_split[__q], __i);
+        __vp = __mul_shift64(__mv + 2, __pow5_inv_split[__q], __i);
+        __vm = __mul_shift64(__mv - 1 - __mm_shift, __pow5_inv_split[__q], __i);
+        if (__q <= 21)
+        {
+            // At most one of __mv, __mp and __mm is a multiple of 5.
+            if (__mv % 5 == 0)
+                __vr_is_trailing_zeros = __multiple_of_pow5(__mv, __q);
+            else if (__accept_bounds)
+                __vm_is_trailing_zeros = __multiple_of_pow5(__mv - 1 - __mm_shift, __q);
+            else
+                __vp -= __multiple_of_pow5(__mv + 2, __q);
+        }
+    }
+    else
+    {
+        const uint32_t __q = __log10_pow5(-__e2) - (-__e2 > 1);
+        __e10 = static_cast<int32_t>(__q) + __e2;
+        const int32_t __i = -__e2 - static_cast<int32_t>(__q);
+        const int32_t __k = __pow5bits(__i) - 125;
+        const int32_t __j = static_cast<int32_t>(__q) - __k;
+        __vr = __mul_shift64(__mv, __pow5_split[__i], __j);
+        __vp = __mul_shift64(__mv + 2, __pow5_split[__i], __j);
+        __vm = __mul_shift64(__mv - 1 - __mm_shift, __pow5_split[__i], __j);
+        if (__q <= 1)
+        {
+            // __mv has at least two trailing zero bits, __mp one, and __mm
+            // one if __mm_shift is 1.
+            __vr_is_trailing_zeros = true;
+            if (__accept_bounds)
+                __vm_is_trailing_zeros = __mm_shift == 1;
+            else
+                --__vp;
+        }
+        else if (__q < 63)
+            __vr_is_trailing_zeros = __multiple_of_pow2(__mv, __q);
+    }
+
+    // Remove the digits which keep the decimal in the interval.
+    int32_t __removed = 0;
+    uint32_t __last_removed_digit = 0;
+    uint64_t __output;
+    if (__vm_is_trailing_zeros || __vr_is_trailing_zeros)
+    {
+        for (; __vp / 10 > __vm / 10; ++__removed)
+        {
+            __vm_is_trailing_zeros &= __vm % 10 == 0;
+            __vr_is_trailing_zeros &= __last_removed_digit == 0;
+            __last_removed_digit = static_cast<uint32_t>(__vr % 10);
+            __vr /= 10;
+            __vp /= 10;
+            __vm /= 10;
+        }
+        if (__vm_is_trailing_zeros)
+        {
+            for (; __vm % 10 == 0; ++__removed)
+            {
+                __vr_is_trailing_zeros &= __last_removed_digit == 0;
+                __last_removed_digit = static_cast<uint32_t>(__vr % 10);
+                __vr /= 10;
+                __vp /= 10;
+                __vm /= 10;
+            }
+        }
+        // Round ...50..0 to even.
+        if (__vr_is_trailing_zeros && __last_removed_digit == 5 && __vr % 2 == 0)
+            __last_removed_digit = 4;
+        __output = __vr + ((__vr == __vm && (!__accept_bounds || !__vm_is_trailing_zeros)) ||
+                           __last_removed_digit >= 5);
+    }
+    else
+    {
+        // The common case, without the bounds.
+        bool __round_up = false;
+        if (__vp / 100 > __vm / 100)
+        {
+            __round_up = __vr % 100 >= 50;
+            __vr /= 100;
+            __vp /= 100;
+            __vm /= 100;
+            __removed += 2;
+        }
+        for (; __vp / 10 > __vm / 10; ++__removed)
+        {
+            __round_up = __vr % 10 >= 5;
+            __vr /= 10;
+            __vp /= 10;
+            __vm /= 10;
+        }
+        __output = __vr + (__vr == __vm || __round_up);
+    }
+    __decimal __r = {__output, __e10 + __removed};
+    return __r;
+}
+
+// __d2d for floats, using the high halves of the tables of doubles.
+__decimal
+__f2d(uint32_t __ieee_mantissa, uint32_t __ieee_exponent)
+{
+    const int32_t __mantissa_bits = 23, __bias = 127, __pow5_bitcount = 125 - 64;
+    int32_t __e2;
+    uint32_t __m2;
+    if (__ieee_exponent == 0)
+    {
+        __e2 = 1 - __bias - __mantissa_bits - 2;
+        __m2 = __ieee_mantissa;
+    }
+    else
+    {
+        __e2 = static_cast<int32_t>(__ieee_exponent) - __bias - __mantissa_bits - 2;
+        __m2 = (1u << __mantissa_bits) | __ieee_mantissa;
+    }
+    const bool __accept_bounds = (__m2 & 1) == 0;
+
+    const uint32_t __mv = 4 * __m2;
+    const uint32_t __mp = 4 * __m2 + 2;
+    const uint32_t __mm_shift = __ieee_mantissa != 0 || __ieee_exponent <= 1;
+    const uint32_t __mm = 4 * __m2 - 1 - __mm_shift;
+    uint32_t __vr, __vp, __vm;
+    int32_t __e10;
+    bool __vm_is_trailing_zeros = false;
+    bool __vr_is_trailing_zeros = false;
+    uint32_t __last_removed_digit = 0;
+    if (__e2 >= 0)
+    {
+        // The tables hold 2^x / 5^y + 1 in 128 bits: their high halves are
+        // 2^x / 5^y without the + 1.
+        const uint32_t __q = __log10_pow2(__e2);
+        __e10 = static_cast<int32_t>(__q);
+        const int32_t __k = __pow5_bitcount + __pow5bits(static_cast<int32_t>(__q)) - 1;
+        const int32_t __i = -__e2 + static_cast<int32_t>(__q) + __k;
+        const uint64_t __factor = __pow5_inv_split[__q][1] + 1;
+        __vr = __mul_shift32(__mv, __factor, __i);
+        __vp = __mul_shift32(__mp, __factor, __i);
+        __vm = __mul_shift32(__mm, __factor, __i);
+        if (__q != 0 && (__vp - 1) / 10 <= __vm / 10)
+        {
+            // The digit after the ones kept below decides the rounding.
+            const int32_t __l = __pow5_bitcount + __pow5bits(static_cast<int32_t>(__q - 1)) - 1;
+            __last_removed_digit =
+                __mul_shift32(__mv, __pow5_inv_split[__q - 1][1] + 1, -__e2 + static_cast<int32_t>(__q) - 1 + __l) % 10;
+        }
+        if (__q <= 9)
+        {
+            if (__mv % 5 == 0)
+                __vr_is_trailing_zeros = __multiple_of_pow5(__mv, __q);
+            else if (__accept_bounds)
+                __vm_is_trailing_zeros = __multiple_of_pow5(__mm, __q);
+            else
+                __vp -= __multiple_of_pow5(__mp, __q);
+        }
+    }
+    else
+    {
+        const uint32_t __q = __log10_pow5(-__e2);
+        __e10 = static_cast<int32_t>(__q) + __e2;
+        const int32_t __i = -__e2 - static_cast<int32_t>(__q);
+        const int32_t __k = __pow5bits(__i) - __pow5_bitcount;
+        const int32_t __j = static_cast<int32_t>(__q) - __k;
+        const uint64_t __factor = __pow5_split[__i][1];
+        __vr = __mul_shift32(__mv, __factor, __j);
+        __vp = __mul_shift32(__mp, __factor, __j);
+        __vm = __mul_shift32(__mm, __factor, __j);
+        if (__q != 0 && (__vp - 1) / 10 <= __vm / 10)
+        {
+            const int32_t __l = static_cast<int32_t>(__q) - 1 - (__pow5bits(__i + 1) - __pow5_bitcount);
+            __last_removed_digit = __mul_shift32(__mv, __pow5_split[__i + 1][1], __l) % 10;
+        }
+        if (__q <= 1)
+        {
+            __vr_is_trailing_zeros = true;
+            if (__accept_bounds)
+                __vm_is_trailing_zeros = __mm_shift == 1;
+            else
+                --__vp;
+        }
+        else if (__q < 31)
+            __vr_is_trailing_zeros = __multiple_of_pow2(__mv, __q - 1);
+    }
+
+    int32_t __removed = 0;
+    uint32_t __output;
+    if (__vm_is_trailing_zeros || __vr_is_trailing_zeros)
+    {
+        for (; __vp / 10 > __vm / 10; ++__removed)
+        {
+            __vm_is_trailing_zeros &= __vm % 10 == 0;
+            __vr_is_trailing_zeros &= __last_removed_digit == 0;
+            __last_removed_digit = __vr % 10;
+            __vr /= 10;
+            __vp /= 10;
+            __vm /= 10;
+        }
+        if (__vm_is_trailing_zeros)
+        {
+            for (; __vm % 10 == 0; ++__removed)
+            {
+                __vr_is_trailing_zeros &= __last_removed_digit == 0;
+                __last_removed_digit = __vr % 10;
+                __vr /= 10;
+                __vp /= 10;
+                __vm /= 10;
+            }
+        }
+        if (__vr_is_trailing_zeros && __last_removed_digit == 5 && __vr % 2 == 0)
+            __last_removed_digit = 4;
+        __output = __vr + ((__vr == __vm && (!__accept_bounds || !__vm_is_trailing_zeros)) ||
+                           __last_removed_digit >= 5);
+    }
+    else
+    {
+        for (; __vp / 10 > __vm / 10; ++__removed)
+        {
+            __last_removed_digit = __vr % 10;
+            __vr /= 10;
+            __vp /= 10;
+            __vm /= 10;
+        }
+        __output = __vr + (__vr == __vm || __last_removed_digit >= 5);
+    }
+    __decimal __r = {__output, __e10 + __removed};
+    return __r;
+}
+
+// The formats of to_chars, and __plain for the overloads without one.
+enum __format
+{
+    __plain = 0,
+    __scientific = static_cast<int>(chars_format::scientific),
+    __fixed = static_cast<int>(chars_format::fixed),
+    __hex = static_cast<int>(chars_format::hex),
+    __general = static_cast<int>(chars_format::general)
+};
+
+inline to_chars_result
+__too_large(char* __last)
+{
+    to_chars_result __r = {__last, errc::value_too_large};
+    return __r;
+}
+
+inline to_chars_result
+__write_string(char* __first, char* __last, const char* __s, size_t __n)
+{
+    if (static_cast<size_t>(__last - __first) < __n)
+        return __too_large(__last);
+    memcpy(__first, __s, __n);
+    to_chars_result __r = {__first + __n, errc()};
+    return __r;
+}
+
+// Writes the 9 digits of __v, with leading zeros.
+inline void
+__write9(char* __first, uint32_t __v)
+{
+    for (char* __p = __first + 9; __p != __first; __v /= 10)
+        *--__p = static_cast<char>('0' + __v % 10);
+}
+
+// Writes __m2 * 2^__e2 in full, for the fixed form of the integers whose
+// shortest digits, padded with zeros, would be another integer.
+to_chars_result
+__write_integer(char* __first, char* __last, uint64_t __m2, int32_t __e2)
+{
+    // Base 10^9 limbs, the least significant first, enough for 2^1024.
+    const uint32_t __base = 1000000000;
+    uint32_t __limbs[36];
+    int __n = 0;
+    for (; __m2 != 0; __m2 /= __base)
+        __limbs[__n++] = static_cast<uint32_t>(__m2 % __base);
+    for (; __e2 > 0; __e2 -= 28)
+    {
+        const int __shift = __e2 < 28 ? __e2 : 28;
+        uint64_t __carry = 0;
+        for (int __i = 0; __i != __n; ++__i)
+        {
+            const uint64_t __v = (static_cast<uint64_t>(__limbs[__i]) << __shift) + __carry;
+            __limbs[__i] = static_cast<uint32_t>(__v % __base);
+            __carry = __v / __base;
+        }
+        for (; __carry != 0; __carry /= __base)
+            __limbs[__n++] = static_cast<uint32_t>(__carry % __base);
+    }
+    char __top[10];
+    const size_t __top_length = static_cast<size_t>(__itoa::__u32toa(__limbs[__n - 1], __top) - __top);
+    if (static_cast<size_t>(__last - __first) < __top_length + 9 * static_cast<size_t>(__n - 1))
+        return __too_large(__last);
+    memcpy(__first, __top, __top_length);
+    __first += __top_length;
+    for (int __i = __n - 2; __i >= 0; --__i, __first += 9)
+        __write9(__first, __limbs[__i]);
+    to_chars_result __r = {__first, errc()};
+    return __r;
+}
+
+// Writes __d in __fmt. __m2 * 2^__e2 is its exact binary value.
+to_chars_result
+__write_decimal(char* __first, char* __last, __decimal __d, __format __fmt,
+                uint64_t __m2, int32_t __e2)
+{
+    char __digits[24];
+    const int32_t __olength = static_cast<int32_t>(__itoa::__u64toa(__d.__digits, __digits) - __digits);
+    const int32_t __e10 = __d.__exponent;
+    const int32_t __sci_exponent = __e10 + __olength - 1;
+    const int32_t __abs_exponent = __sci_exponent < 0 ? -__sci_exponent : __sci_exponent;
+    const int32_t __sci_length = __olength + (__olength > 1) + 2 + (__abs_exponent >= 100 ? 3 : 2);
+    const int32_t __fixed_length = __e10 >= 0 ? __olength + __e10
+                                   : __olength > -__e10 ? __olength + 1
+                                   : 2 - __e10;
+
+    bool __use_fixed;
+    switch (__fmt)
+    {
+    case __scientific:
+        __use_fixed = false;
+        break;
+    case __fixed:
+        __use_fixed = true;
+        break;
+    case __plain:
+        __use_fixed = __fixed_length <= __sci_length;
+        break;
+    default:
+        // As printf's %g, with its default precision of 6.
+        __use_fixed = -4 <= __sci_exponent && __sci_exponent < 6;
+        break;
+    }
+
+    if (!__use_fixed)
+    {
+        if (__last - __first < __sci_length)
+            return __too_large(__last);
+        *__first++ = __digits[0];
+        if (__olength > 1)
+        {
+            *__first++ = '.';
+            memcpy(__first, __digits + 1, static_cast<size_t>(__olength - 1));
+            __first += __olength - 1;
+        }
+        *__first++ = 'e';
+        *__first++ = __sci_exponent < 0 ? '-' : '+';
+        if (__abs_exponent >= 100)
+        {
+            *__first++ = static_cast<char>('0' + __abs_exponent / 100);
+            *__first++ = static_cast<char>('0' + __abs_exponent / 10 % 10);
+        }
+        else
+            *__first++ = static_cast<char>('0' + __abs_exponent / 10);
+        *__first++ = static_cast<char>('0' + __abs_exponent % 10);
+        to_chars_result __r = {__first, errc()};
+        return __r;
+    }
+
+    if (__e10 > 0 && __e2 > 0)
+        return __write_integer(__first, __last, __m2, __e2);
+    if (__last - __first < __fixed_length)
+        return __too_large(__last);
+    if (__e10 >= 0)
+    {
+        memcpy(__first, __digits, static_cast<size_t>(__olength));
+        memset(__first + __olength, '0', static_cast<size_t>(__e10));
+    }
+    else if (__olength > -__e10)
+    {
+        const int32_t __int_length = __olength + __e10;
+        memcpy(__first, __digits, static_cast<size_t>(__int_length));
+        __first[__int_length] = '.';
+        memcpy(__first + __int_length + 1, __digits + __int_length, static_cast<size_t>(-__e10));
+    }
+    else
+    {
+        __first[0] = '0';
+        __first[1] = '.';
+        memset(__first + 2, '0', static_cast<size_t>(-__e10 - __olength));
+        memcpy(__first + 2 - __e10 - __olength, __digits, static_cast<size_t>(__olength));
+    }
+    to_chars_result __r = {__first + __fixed_length, errc()};
+    return __r;
+}
+
+// Writes the form of printf's %a without the 0x, and without the trailing
+// zeros: 1.8p+1 for 3.
+to_chars_result
+__write_hex(char* __first, char* __last, uint64_t __ieee_mantissa, uint32_t __ieee_exponent,
+            int __mantissa_bits, int32_t __bias)
+{
+    int __nibbles = (__mantissa_bits + 3) / 4;
+    uint64_t __m = __ieee_mantissa << (4 * __nibbles - __mantissa_bits);
+    int32_t __e;
+    char __lead;
+    if (__ieee_exponent == 0)
+    {
+        __lead = '0';
+        __e = __m == 0 ? 0 : 1 - __bias;
+    }
+    else
+    {
+        __lead = '1';
+        __e = static_cast<int32_t>(__ieee_exponent) - __bias;
+    }
+    for (; __nibbles != 0 && (__m & 0xf) == 0; --__nibbles)
+        __m >>= 4;
+    char __exponent[12];
+    const uint32_t __abs_e = static_cast<uint32_t>(__e < 0 ? -__e : __e);
+    const size_t __exponent_length = static_cast<size_t>(__itoa::__u32toa(__abs_e, __exponent) - __exponent);
+    const size_t __length = 1 + (__nibbles ? 1 + __nibbles : 0) + 2 + __exponent_length;
+    if (static_cast<size_t>(__last - __first) < __length)
+        return __too_large(__last);
+    *__first++ = __lead;
+    if (__nibbles)
+    {
+        *__first++ = '.';
+        for (int __i = __nibbles - 1; __i >= 0; --__i)
+            *__first++ = "0123456789abcdef"[(__m >> (4 * __i)) & 0xf];
+    }
+    *__first++ = 'p';
+    *__first++ = __e < 0 ? '-' : '+';
+    memcpy(__first, __exponent, __exponent_length);
+    to_chars_result __r = {__first + __exponent_length, errc()};
+    return __r;
+}
+
+template <class _Fp> struct __traits;
+
+template <>
+struct __traits<double>
+{
+    typedef uint64_t __bits_type;
+    static const int __mantissa_bits = 52;
+    static const int32_t __bias = 1023;
+    static const int32_t __infinite_power = 0x7ff;
+    // The range of the decimal exponents of the nonzero finite values.
+    static const int32_t __smallest_power_of_ten = -342;
+    static const int32_t __largest_power_of_ten = 308;
+    // The decimal exponents of the numbers which may be halfway.
+    static const int32_t __min_exponent_round_to_even = -4;
+    static const int32_t __max_exponent_round_to_even = 23;
+
+    static __decimal __to_decimal(uint64_t __mantissa, uint32_t __exponent)
+    {
+        return __d2d(__mantissa, __exponent);
+    }
+};
+
+template <>
+struct __traits<float>
+{
+    typedef uint32_t __bits_type;
+    static const int __mantissa_bits = 23;
+    static const int32_t __bias = 127;
+    static const int32_t __infinite_power = 0xff;
+    static const int32_t __smallest_power_of_ten = -65;
+    static const int32_t __largest_power_of_ten = 38;
+    static const int32_t __min_exponent_round_to_even = -17;
+    static const int32_t __max_exponent_round_to_even = 10;
+
+    static __decimal __to_decimal(uint64_t __mantissa, uint32_t __exponent)
+    {
+        return __f2d(static_cast<uint32_t>(__mantissa), __exponent);
+    }
+};
+
+template <class _Fp>
+to_chars_result
+__to_chars(char* __first, char* __last, _Fp __value, __format __fmt)
+{
+    typedef __traits<_Fp> _Traits;
+    typename _Traits::__bits_type __bits;
+    memcpy(&__bits, &__value, sizeof(__bits));
+    const int __mantissa_bits = _Traits::__mantissa_bits;
+    const uint64_t __ieee_mantissa = __bits & ((uint64_t(1) << __mantissa_bits) - 1);
+    const uint32_t __ieee_exponent = static_cast<uint32_t>(__bits >> __mantissa_bits) & _Traits::__infinite_power;
+
+    if (__bits >> (sizeof(__bits) * 8 - 1))
+    {
+        if (__first == __last)
+            return __too_large(__last);
+        *__first++ = '-';
+    }
+    if (__ieee_exponent == static_cast<uint32_t>(_Traits::__infinite_power))
+        return __ieee_mantissa ? __write_string(__first, __last, "nan", 3)
+                               : __write_string(__first, __last, "inf", 3);
+    if (__fmt == __hex)
+        return __write_hex(__first, __last, __ieee_mantissa, __ieee_exponent, __mantissa_bits, _Traits::__bias);
+
+    uint64_t __m2 = __ieee_mantissa;
+    int32_t __e2 = 1 - _Traits::__bias - __mantissa_bits;
+    if (__ieee_exponent != 0)
+    {
+        __m2 |= uint64_t(1) << __mantissa_bits;
+        __e2 += static_cast<int32_t>(__ieee_exponent) - 1;
+    }
+    __decimal __d = {0, 0};
+    if (__m2 != 0)
+        __d = _Traits::__to_decimal(__ieee_mantissa, __ieee_exponent);
+    return __write_decimal(__first, __last, __d, __fmt, __m2, __e2);
+}
+
+inline bool
+__is_digit(char __c)
+{
+    return static_cast<unsigned char>(__c - '0') < 10;
+}
+
+inline int
+__hex_value(char __c)
+{
+    if (__is_digit(__c))
+        return __c - '0';
+    if (__c >= 'a' && __c <= 'f')
+        return __c - 'a' + 10;
+    if (__c >= 'A' && __c <= 'F')
+        return __c - 'A' + 10;
+    return -1;
+}
+
+// Whether [__first, __last) starts with __s, ignoring the case.
+inline bool
+__starts_with(const char* __first, const char* __last, const char* __s)
+{
+    for (; *__s; ++__first, ++__s)
+        if (__first == __last || (*__first | 0x20) != *__s)
+            return false;
+    return true;
+}
+
+// Adds the exponent at __p, if any, to __exponent. The exponents beyond any
+// of the values saturate.
+const char*
+__parse_exponent(const char* __p, const char* __last, char __marker, int64_t& __exponent)
+{
+    if (__p == __last || (*__p | 0x20) != __marker)
+        return __p;
+    const char* __q = __p + 1;
+    bool __negative = false;
+    if (__q != __last && (*__q == '+' || *__q == '-'))
+        __negative = *__q++ == '-';
+    if (__q == __last || !__is_digit(*__q))
+        return __p;
+    int64_t __e = 0;
+    for (; __q != __last && __is_digit(*__q); ++__q)
+        if (__e < 100000000)
+            __e = __e * 10 + (*__q - '0');
+    __exponent += __negative ? -__e : __e;
+    return __q;
+}
+
+// The parts of a float: its bits are __mantissa | __power2 << __mantissa_bits.
+struct __adjusted_mantissa
+{
+    uint64_t __mantissa;
+    int32_t __power2;
+};
+
+// The 128 high bits of __w * 5^__q, of which the __precision high bits are
+// exact: the low word of 5^__q is only needed when they may not be.
+inline void
+__compute_product(int64_t __q, uint64_t __w, int __precision, uint64_t& __high, uint64_t& __low)
+{
+    const uint64_t* __pow5 = __pow5_128[__q + 342];
+    const uint64_t __mask = ~uint64_t(0) >> __precision;
+    __low = __umul128(__w, __pow5[0], &__high);
+    if ((__high & __mask) == __mask)
+    {
+        uint64_t __second_high;
+        __umul128(__w, __pow5[1], &__second_high);
+        __low += __second_high;
+        if (__second_high > __low)
+            ++__high;
+    }
+}
+
+// The float nearest to __w * 10^__q.
+template <class _Fp>
+__adjusted_mantissa
+__compute_float(int64_t __q, uint64_t __w)
+{
+    typedef __traits<_Fp> _Traits;
+    const int __mantissa_bits = _Traits::__mantissa_bits;
+    __adjusted_mantissa __r = {0, 0};
+    if (__w == 0 || __q < _Traits::__smallest_power_of_ten)
+        return __r;
+    if (__q > _Traits::__largest_power_of_ten)
+    {
+        __r.__power2 = _Traits::__infinite_power;
+        return __r;
+    }
+    const int __lz = __libcpp_clz(__w);
+    __w <<= __lz;
+    uint64_t __high, __low;
+    __compute_product(__q, __w, __mantissa_bits + 3, __high, __low);
+    const int __upper_bit = static_cast<int>(__high >> 63);
+    const int __shift = __upper_bit + 64 - __mantissa_bits - 3;
+    __r.__mantissa = __high >> __shift;
+    // floor(log2(10^__q)) + 63, with the exponent of the biased mantissa.
+    __r.__power2 = static_cast<int32_t>((((152170 + 65536) * __q) >> 16) + 63) + __upper_bit - __lz + _Traits::__bias;
+    if (__r.__power2 <= 0)
+    {
+        // A subnormal, or zero.
+        if (-__r.__power2 + 1 >= 64)
+        {
+            __r.__mantissa = 0;
+            __r.__power2 = 0;
+            return __r;
+        }
+        __r.__mantissa >>= -__r.__power2 + 1;
+        __r.__mantissa += __r.__mantissa & 1;
+        __r.__mantissa >>= 1;
+        __r.__power2 = __r.__mantissa < (uint64_t(1) << __mantissa_bits) ? 0 : 1;
+        return __r;
+    }
+    // The product is exact for the halfway cases, which are rounded to even.
+    if (__low <= 1 && __q >= _Traits::__min_exponent_round_to_even &&
+        __q <= _Traits::__max_exponent_round_to_even && (__r.__mantissa & 3) == 1 &&
+        (__r.__mantissa << __shift) == __high)
+        __r.__mantissa &= ~uint64_t(1);
+    __r.__mantissa += __r.__mantissa & 1;
+    __r.__mantissa >>= 1;
+    if (__r.__mantissa >= (uint64_t(2) << __mantissa_bits))
+    {
+        __r.__mantissa = uint64_t(1) << __mantissa_bits;
+        ++__r.__power2;
+    }
+    __r.__mantissa &= ~(uint64_t(1) << __mantissa_bits);
+    if (__r.__power2 >= _Traits::__infinite_power)
+    {
+        __r.__mantissa = 0;
+        __r.__power2 = _Traits::__infinite_power;
+    }
+    return __r;
+}
+
+// The float nearest to (__m + __sticky / 2) * 2^__e2, where __sticky stands
+// for the nonzero bits below those of __m.
+template <class _Fp>
+__adjusted_mantissa
+__round_binary(uint64_t __m, bool __sticky, int64_t __e2)
+{
+    typedef __traits<_Fp> _Traits;
+    const int __mantissa_bits = _Traits::__mantissa_bits;
+    __adjusted_mantissa __r = {0, 0};
+    if (__m == 0)
+        return __r;
+    // The value is in [2^__e, 2^(__e + 1)).
+    const int64_t __e = 63 - __libcpp_clz(__m) + __e2;
+    if (__e + _Traits::__bias >= _Traits::__infinite_power)
+    {
+        __r.__power2 = _Traits::__infinite_power;
+        return __r;
+    }
+    // The weight of the last bit of the result.
+    const int64_t __lsb = __e + _Traits::__bias <= 0 ? 1 - _Traits::__bias - __mantissa_bits : __e - __mantissa_bits;
+    const int64_t __shift = __lsb - __e2;
+    uint64_t __kept;
+    if (__shift <= 0)
+        __kept = __m << -__shift;
+    else
+    {
+        bool __half, __below;
+        if (__shift > 64)
+        {
+            __kept = 0;
+            __half = false;
+            __below = true;
+        }
+        else
+        {
+            __kept = __shift == 64 ? 0 : __m >> __shift;
+            __half = (__m >> (__shift - 1)) & 1;
+            __below = __sticky || (__m & ((uint64_t(1) << (__shift - 1)) - 1)) != 0;
+        }
+        __kept += __half && (__below || (__kept & 1));
+    }
+    // The implicit bit of __kept, or its carry, adds one to the exponent.
+    const uint64_t __bits = (__e + _Traits::__bias <= 0 ? 0 : static_cast<uint64_t>(__e + _Traits::__bias - 1) << __mantissa_bits) + __kept;
+    __r.__mantissa = __bits & ((uint64_t(1) << __mantissa_bits) - 1);
+    __r.__power2 = static_cast<int32_t>(__bits >> __mantissa_bits);
+    return __r;
+}
+
+template <class _Fp>
+inline _Fp
+__to_float(__adjusted_mantissa __a, bool __negative)
+{
+    typedef __traits<_Fp> _Traits;
+    typename _Traits::__bits_type __bits = static_cast<typename _Traits::__bits_type>(
+        __a.__mantissa | static_cast<uint64_t>(__a.__power2) << _Traits::__mantissa_bits);
+    if (__negative)
+        __bits |= static_cast<typename _Traits::__bits_type>(1) << (sizeof(__bits) * 8 - 1);
+    _Fp __value;
+    memcpy(&__value, &__bits, sizeof(__value));
+    return __value;
+}
+
+template <class _Fp>
+from_chars_result
+__from_chars(const char* __first, const char* __last, _Fp& __value, chars_format __fmt)
+{
+    typedef __traits<_Fp> _Traits;
+    from_chars_result __r = {__first, errc::invalid_argument};
+    const char* __p = __first;
+    const bool __negative = __p != __last && *__p == '-';
+    __p += __negative;
+
+    if (__starts_with(__p, __last, "inf"))
+    {
+        __p += 3;
+        if (__starts_with(__p, __last, "inity"))
+            __p += 5;
+        __value = __to_float<_Fp>(__adjusted_mantissa{0, _Traits::__infinite_power}, __negative);
+        __r.ptr = __p;
+        __r.ec = errc();
+        return __r;
+    }
+    if (__starts_with(__p, __last, "nan"))
+    {
+        __p += 3;
+        if (__p != __last && *__p == '(')
+        {
+            const char* __q = __p + 1;
+            for (; __q != __last && (__is_digit(*__q) || *__q == '_' || ((*__q | 0x20) >= 'a' && (*__q | 0x20) <= 'z')); ++__q)
+                ;
+            if (__q != __last && *__q == ')')
+                __p = __q + 1;
+        }
+        __value = __to_float<_Fp>(__adjusted_mantissa{uint64_t(1) << (_Traits::__mantissa_bits - 1),
+                                                      _Traits::__infinite_power}, __negative);
+        __r.ptr = __p;
+        __r.ec = errc();
+        return __r;
+    }
+
+    // The significant digits, the first 19 in __w and whether the others
+    // aren't all zeros, and the power of the base of the last one kept.
+    const char* const __start = __p;
+    const bool __is_hex = __fmt == chars_format::hex;
+    const int __max_digits = __is_hex ? 16 : 19;
+    uint64_t __w = 0;
+    int __digits = 0;
+    int64_t __exponent = 0;
+    bool __truncated = false;
+    bool __any = false;
+    for (bool __fraction = false;; ++__p)
+    {
+        if (__p != __last && *__p == '.' && !__fraction)
+        {
+            __fraction = true;
+            continue;
+        }
+        const int __d = __p == __last ? -1 : __is_hex ? __hex_value(*__p) : __is_digit(*__p) ? *__p - '0' : -1;
+        if (__d < 0)
+            break;
+        __any = true;
+        if (__digits == 0 && __d == 0)
+            __exponent -= __fraction;
+        else if (__digits < __max_digits)
+        {
+            __w = __w * (__is_hex ? 16 : 10) + static_cast<unsigned>(__d);
+            ++__digits;
+            __exponent -= __fraction;
+        }
+        else
+        {
+            __exponent += !__fraction;
+            __truncated |= __d != 0;
+        }
+    }
+    if (!__any)
+        return __r;
+
+    __adjusted_mantissa __a;
+    if (__is_hex)
+    {
+        __exponent *= 4;
+        __p = __parse_exponent(__p, __last, 'p', __exponent);
+        __a = __round_binary<_Fp>(__w, __truncated, __exponent);
+    }
+    else
+    {
+        const char* const __end_of_digits = __p;
+        if (static_cast<int>(__fmt) & static_cast<int>(chars_format::scientific))
+            __p = __parse_exponent(__p, __last, 'e', __exponent);
+        if (__fmt == chars_format::scientific && __p == __end_of_digits)
+            return __r;
+        __a = __compute_float<_Fp>(__exponent, __w);
+        if (__truncated)
+        {
+            // Between __w and __w + 1: the digits after the first 19 only
+            // matter when those two round to different floats.
+            const __adjusted_mantissa __up = __compute_float<_Fp>(__exponent, __w + 1);
+            if (__up.__mantissa != __a.__mantissa || __up.__power2 != __a.__power2)
+            {
+                const string __s(__start, __p);
+                _Fp __v = __do_strtod<_Fp>(__s.c_str(), nullptr);
+                typename _Traits::__bits_type __bits;
+                memcpy(&__bits, &__v, sizeof(__bits));
+                __a.__mantissa = __bits & ((uint64_t(1) << _Traits::__mantissa_bits) - 1);
+                __a.__power2 = static_cast<int32_t>(__bits >> _Traits::__mantissa_bits);
+            }
+        }
+    }
+
+    __r.ptr = __p;
+    if (__a.__power2 == _Traits::__infinite_power || (__w != 0 && __a.__power2 == 0 && __a.__mantissa == 0))
+    {
+        __r.ec = errc::result_out_of_range;
+        return __r;
+    }
+    __value = __to_float<_Fp>(__a, __negative);
+    __r.ec = errc();
+    return __r;
+}
+
+}  // namespace __floating_point
+
+to_chars_result
+to_chars(char* __first, char* __last, float __value)
+{
+    return __floating_point::__to_chars(__first, __last, __value, __floating_point::__plain);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, double __value)
+{
+    return __floating_point::__to_chars(__first, __last, __value, __floating_point::__plain);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, float __value, chars_format __fmt)
+{
+    return __floating_point::__to_chars(__first, __last, __value,
+                                        static_cast<__floating_point::__format>(__fmt));
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, double __value, chars_format __fmt)
+{
+    return __floating_point::__to_chars(__first, __last, __value,
+                                        static_cast<__floating_point::__format>(__fmt));
+}
+
+from_chars_result
+from_chars(const char* __first, const char* __last, float& __value, chars_format __fmt)
+{
+    return __floating_point::__from_chars(__first, __last, __value, __fmt);
+}
+
+from_chars_result
+from_chars(const char* __first, const char* __last, double& __value, chars_format __fmt)
+{
+    return __floating_point::__from_chars(__first, __last, __value, __fmt);
+}
+
 _LIBCPP_END_NAMESPACE_STD
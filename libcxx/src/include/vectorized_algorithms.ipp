@@ -0,0 +1,114 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The loops of vectorized_algorithms.cpp, included once per instruction set in
+// a namespace which defines __vec, the vectors of __vec_size bytes, and:
+//   __load(p):        the vector at p, which needn't be aligned;
+//   __set1<T>(x):     the vector of copies of x;
+//   __cmpeq<S>(a, b): the vector whose elements of S bytes are all ones where
+//                     those of a and b are equal, and zeros elsewhere;
+//   __or(a, b):       the bitwise or of a and b;
+//   __mask(v):        the high bit of each byte of v.
+// _LIBCPP_VECTOR_TARGET is the attribute which enables the instruction set.
+//
+// A range of at least one vector ends with a vector which overlaps the one
+// before it, instead of a loop over the last elements.
+
+static const unsigned __full_mask = __vec_size == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+
+template <class _Tp>
+_LIBCPP_VECTOR_TARGET
+static const _Tp* __find(const _Tp* __first, const _Tp* __last, _Tp __value) {
+  const char* __p = reinterpret_cast<const char*>(__first);
+  size_t __bytes = static_cast<size_t>(__last - __first) * sizeof(_Tp);
+  if (__bytes < __vec_size) {
+    for (; __first != __last; ++__first)
+      if (*__first == __value)
+        break;
+    return __first;
+  }
+  __vec __v = __set1<_Tp>(__value);
+  size_t __i = 0;
+  for (; __i + 4 * __vec_size <= __bytes; __i += 4 * __vec_size) {
+    __vec __c0 = __cmpeq<sizeof(_Tp)>(__load(__p + __i), __v);
+    __vec __c1 = __cmpeq<sizeof(_Tp)>(__load(__p + __i + __vec_size), __v);
+    __vec __c2 = __cmpeq<sizeof(_Tp)>(__load(__p + __i + 2 * __vec_size), __v);
+    __vec __c3 = __cmpeq<sizeof(_Tp)>(__load(__p + __i + 3 * __vec_size), __v);
+    if (__mask(__or(__or(__c0, __c1), __or(__c2, __c3)))) {
+      // The first of the four vectors with a match has it.
+      unsigned __m;
+      if ((__m = __mask(__c0)) == 0) {
+        __i += __vec_size;
+        if ((__m = __mask(__c1)) == 0) {
+          __i += __vec_size;
+          if ((__m = __mask(__c2)) == 0) {
+            __i += __vec_size;
+            __m = __mask(__c3);
+          }
+        }
+      }
+      return __first + (__i + __builtin_ctz(__m)) / sizeof(_Tp);
+    }
+  }
+  for (;; __i += __vec_size) {
+    if (__i + __vec_size > __bytes)
+      __i = __bytes - __vec_size;
+    unsigned __m = __mask(__cmpeq<sizeof(_Tp)>(__load(__p + __i), __v));
+    if (__m)
+      return __first + (__i + __builtin_ctz(__m)) / sizeof(_Tp);
+    if (__i + __vec_size == __bytes)
+      return __last;
+  }
+}
+
+template <class _Tp>
+_LIBCPP_VECTOR_TARGET
+static size_t __count(const _Tp* __first, const _Tp* __last, _Tp __value) {
+  const char* __p = reinterpret_cast<const char*>(__first);
+  size_t __bytes = static_cast<size_t>(__last - __first) * sizeof(_Tp);
+  size_t __r = 0;
+  if (__bytes < __vec_size) {
+    for (; __first != __last; ++__first)
+      if (*__first == __value)
+        ++__r;
+    return __r;
+  }
+  __vec __v = __set1<_Tp>(__value);
+  size_t __i = 0;
+  for (; __i + __vec_size <= __bytes; __i += __vec_size)
+    __r += __builtin_popcount(__mask(__cmpeq<sizeof(_Tp)>(__load(__p + __i), __v)));
+  if (__i != __bytes) {
+    // Only the bytes after those counted above.
+    unsigned __m = __mask(__cmpeq<sizeof(_Tp)>(__load(__p + __bytes - __vec_size), __v));
+    __r += __builtin_popcount(__m >> (__vec_size - (__bytes - __i)));
+  }
+  return __r / sizeof(_Tp);
+}
+
+_LIBCPP_VECTOR_TARGET
+static size_t __mismatch(const void* __a, const void* __b, size_t __n) {
+  const unsigned char* __p = static_cast<const unsigned char*>(__a);
+  const unsigned char* __q = static_cast<const unsigned char*>(__b);
+  if (__n < __vec_size) {
+    size_t __i = 0;
+    for (; __i != __n; ++__i)
+      if (__p[__i] != __q[__i])
+        break;
+    return __i;
+  }
+  for (size_t __i = 0;; __i += __vec_size) {
+    if (__i + __vec_size > __n)
+      __i = __n - __vec_size;
+    unsigned __m = __mask(__cmpeq<1>(__load(__p + __i), __load(__q + __i))) ^ __full_mask;
+    if (__m)
+      return __i + __builtin_ctz(__m);
+    if (__i + __vec_size == __n)
+      return __n;
+  }
+}
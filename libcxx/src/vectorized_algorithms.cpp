@@ -0,0 +1,195 @@
+//===------------------- vectorized_algorithms.cpp ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "algorithm"
+#include "cstring"
+
+// The loops of find, count, mismatch and equal over the ranges of integers and
+// pointers of <algorithm>. On x86, the widest vectors of the processor are
+// chosen at run time.
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#  define _LIBCPP_VECTORIZED_X86
+#  include <immintrin.h>
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace __vectorized {
+namespace {
+
+#if defined(_LIBCPP_VECTORIZED_X86)
+
+namespace __sse2 {
+
+typedef __m128i __vec;
+static const size_t __vec_size = 16;
+
+inline __vec __load(const void* __p) {
+  return _mm_loadu_si128(static_cast<const __vec*>(__p));
+}
+
+inline __vec __or(__vec __a, __vec __b) { return _mm_or_si128(__a, __b); }
+
+inline unsigned __mask(__vec __v) {
+  return static_cast<unsigned>(_mm_movemask_epi8(__v));
+}
+
+template <class _Tp> __vec __set1(_Tp);
+template <> inline __vec __set1(uint8_t __x) { return _mm_set1_epi8(static_cast<char>(__x)); }
+template <> inline __vec __set1(uint16_t __x) { return _mm_set1_epi16(static_cast<short>(__x)); }
+template <> inline __vec __set1(uint32_t __x) { return _mm_set1_epi32(static_cast<int>(__x)); }
+template <> inline __vec __set1(uint64_t __x) { return _mm_set1_epi64x(static_cast<long long>(__x)); }
+
+template <size_t _Size> __vec __cmpeq(__vec, __vec);
+template <> inline __vec __cmpeq<1>(__vec __a, __vec __b) { return _mm_cmpeq_epi8(__a, __b); }
+template <> inline __vec __cmpeq<2>(__vec __a, __vec __b) { return _mm_cmpeq_epi16(__a, __b); }
+template <> inline __vec __cmpeq<4>(__vec __a, __vec __b) { return _mm_cmpeq_epi32(__a, __b); }
+// SSE2 has no comparison of 64 bit elements: both their halves must be equal.
+template <> inline __vec __cmpeq<8>(__vec __a, __vec __b) {
+  __vec __c = _mm_cmpeq_epi32(__a, __b);
+  return _mm_and_si128(__c, _mm_shuffle_epi32(__c, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+#define _LIBCPP_VECTOR_TARGET
+#include "include/vectorized_algorithms.ipp"
+#undef _LIBCPP_VECTOR_TARGET
+
+} // namespace __sse2
+
+namespace __avx2 {
+
+#define _LIBCPP_VECTOR_TARGET __attribute__((__target__("avx2,popcnt")))
+
+typedef __m256i __vec;
+static const size_t __vec_size = 32;
+
+_LIBCPP_VECTOR_TARGET inline __vec __load(const void* __p) {
+  return _mm256_loadu_si256(static_cast<const __vec*>(__p));
+}
+
+_LIBCPP_VECTOR_TARGET inline __vec __or(__vec __a, __vec __b) { return _mm256_or_si256(__a, __b); }
+
+_LIBCPP_VECTOR_TARGET inline unsigned __mask(__vec __v) {
+  return static_cast<unsigned>(_mm256_movemask_epi8(__v));
+}
+
+template <class _Tp> __vec __set1(_Tp);
+template <> _LIBCPP_VECTOR_TARGET inline __vec __set1(uint8_t __x) { return _mm256_set1_epi8(static_cast<char>(__x)); }
+template <> _LIBCPP_VECTOR_TARGET inline __vec __set1(uint16_t __x) { return _mm256_set1_epi16(static_cast<short>(__x)); }
+template <> _LIBCPP_VECTOR_TARGET inline __vec __set1(uint32_t __x) { return _mm256_set1_epi32(static_cast<int>(__x)); }
+template <> _LIBCPP_VECTOR_TARGET inline __vec __set1(uint64_t __x) { return _mm256_set1_epi64x(static_cast<long long>(__x)); }
+
+template <size_t _Size> __vec __cmpeq(__vec, __vec);
+template <> _LIBCPP_VECTOR_TARGET inline __vec __cmpeq<1>(__vec __a, __vec __b) { return _mm256_cmpeq_epi8(__a, __b); }
+template <> _LIBCPP_VECTOR_TARGET inline __vec __cmpeq<2>(__vec __a, __vec __b) { return _mm256_cmpeq_epi16(__a, __b); }
+template <> _LIBCPP_VECTOR_TARGET inline __vec __cmpeq<4>(__vec __a, __vec __b) { return _mm256_cmpeq_epi32(__a, __b); }
+template <> _LIBCPP_VECTOR_TARGET inline __vec __cmpeq<8>(__vec __a, __vec __b) { return _mm256_cmpeq_epi64(__a, __b); }
+
+#include "include/vectorized_algorithms.ipp"
+#undef _LIBCPP_VECTOR_TARGET
+
+} // namespace __avx2
+
+// The check is done once: the processor doesn't change under the program.
+bool __has_avx2() {
+  static const bool __r = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") &&
+                                                 __builtin_cpu_supports("popcnt"));
+  return __r;
+}
+
+template <class _Tp>
+const _Tp* __find(const _Tp* __first, const _Tp* __last, _Tp __value) {
+  return __has_avx2() ? __avx2::__find(__first, __last, __value)
+                      : __sse2::__find(__first, __last, __value);
+}
+
+template <class _Tp>
+size_t __count(const _Tp* __first, const _Tp* __last, _Tp __value) {
+  return __has_avx2() ? __avx2::__count(__first, __last, __value)
+                      : __sse2::__count(__first, __last, __value);
+}
+
+size_t __mismatch(const void* __a, const void* __b, size_t __n) {
+  return __has_avx2() ? __avx2::__mismatch(__a, __b, __n)
+                      : __sse2::__mismatch(__a, __b, __n);
+}
+
+#else // _LIBCPP_VECTORIZED_X86
+
+template <class _Tp>
+const _Tp* __find(const _Tp* __first, const _Tp* __last, _Tp __value) {
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      break;
+  return __first;
+}
+
+template <class _Tp>
+size_t __count(const _Tp* __first, const _Tp* __last, _Tp __value) {
+  size_t __r = 0;
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      ++__r;
+  return __r;
+}
+
+// Compares words, then the bytes of the first word which differs.
+size_t __mismatch(const void* __a, const void* __b, size_t __n) {
+  const unsigned char* __p = static_cast<const unsigned char*>(__a);
+  const unsigned char* __q = static_cast<const unsigned char*>(__b);
+  size_t __i = 0;
+  for (; __i + sizeof(uint64_t) <= __n; __i += sizeof(uint64_t)) {
+    uint64_t __x, __y;
+    memcpy(&__x, __p + __i, sizeof(__x));
+    memcpy(&__y, __q + __i, sizeof(__y));
+    if (__x != __y)
+      break;
+  }
+  for (; __i != __n; ++__i)
+    if (__p[__i] != __q[__i])
+      break;
+  return __i;
+}
+
+#endif // _LIBCPP_VECTORIZED_X86
+
+} // namespace
+} // namespace __vectorized
+
+const uint8_t* __vectorized_find(const uint8_t* __first, const uint8_t* __last, uint8_t __value) _NOEXCEPT {
+  return __vectorized::__find(__first, __last, __value);
+}
+const uint16_t* __vectorized_find(const uint16_t* __first, const uint16_t* __last, uint16_t __value) _NOEXCEPT {
+  return __vectorized::__find(__first, __last, __value);
+}
+const uint32_t* __vectorized_find(const uint32_t* __first, const uint32_t* __last, uint32_t __value) _NOEXCEPT {
+  return __vectorized::__find(__first, __last, __value);
+}
+const uint64_t* __vectorized_find(const uint64_t* __first, const uint64_t* __last, uint64_t __value) _NOEXCEPT {
+  return __vectorized::__find(__first, __last, __value);
+}
+
+size_t __vectorized_count(const uint8_t* __first, const uint8_t* __last, uint8_t __value) _NOEXCEPT {
+  return __vectorized::__count(__first, __last, __value);
+}
+size_t __vectorized_count(const uint16_t* __first, const uint16_t* __last, uint16_t __value) _NOEXCEPT {
+  return __vectorized::__count(__first, __last, __value);
+}
+size_t __vectorized_count(const uint32_t* __first, const uint32_t* __last, uint32_t __value) _NOEXCEPT {
+  return __vectorized::__count(__first, __last, __value);
+}
+size_t __vectorized_count(const uint64_t* __first, const uint64_t* __last, uint64_t __value) _NOEXCEPT {
+  return __vectorized::__count(__first, __last, __value);
+}
+
+size_t __vectorized_mismatch(const void* __a, const void* __b, size_t __n) _NOEXCEPT {
+  return __vectorized::__mismatch(__a, __b, __n);
+}
+
+_LIBCPP_END_NAMESPACE_STD
@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// find, count, mismatch and equal call the vectorized loops of the dylib for
+// the ranges of integers and pointers. Check them against plain loops for all
+// the lengths of a few vectors, from unaligned starts.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "test_macros.h"
+
+// The values are compared to elements of other types on purpose.
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#endif
+
+namespace {
+
+const std::size_t N = 300;
+
+template <class T, class U>
+std::ptrdiff_t naive_find(const T* first, const T* last, U value) {
+  for (const T* i = first; i != last; ++i)
+    if (*i == value)
+      return i - first;
+  return last - first;
+}
+
+template <class T, class U>
+std::ptrdiff_t naive_count(const T* first, const T* last, U value) {
+  std::ptrdiff_t r = 0;
+  for (const T* i = first; i != last; ++i)
+    if (*i == value)
+      ++r;
+  return r;
+}
+
+template <class T, class U>
+void check_find(const T* first, const T* last, U value) {
+  assert(std::find(first, last, value) - first == naive_find(first, last, value));
+  assert(std::count(first, last, value) == naive_count(first, last, value));
+}
+
+template <class T>
+void test_find_count() {
+  T buf[N + 8];
+  for (std::size_t offset = 0; offset != 4; ++offset) {
+    T* a = buf + offset;
+    for (std::size_t n = 0; n <= N; n += (n < 80 ? 1 : 13)) {
+      for (std::size_t i = 0; i != n; ++i)
+        a[i] = T(i % 7 + 1);
+      check_find(a, a + n, T(0));
+      check_find(a, a + n, T(3));
+      check_find(a, a + n, 3);
+      if (n == 0)
+        continue;
+      // A single match at a few positions, among values with other bytes.
+      T* positions[] = {a, a + n / 3, a + n / 2, a + n - 1};
+      for (std::size_t p = 0; p != 4; ++p) {
+        T old = *positions[p];
+        *positions[p] = T(-1);
+        check_find(a, a + n, T(-1));
+        check_find(a, a + n, T(0xff));
+        check_find(a, a + n, -1);
+        *positions[p] = old;
+      }
+      check_find(a, a + n, static_cast<long long>(1) << 40);
+
+      assert(std::mismatch(a, a + n, a).first == a + n);
+      assert(std::equal(a, a + n, const_cast<const T*>(a)));
+      T b[N];
+      std::copy(a, a + n, b);
+      for (std::size_t p = 0; p != 4; ++p) {
+        std::size_t i = positions[p] - a;
+        b[i] = T(b[i] ^ (T(1) << (sizeof(T) * 8 - 1)));
+        std::pair<T*, T*> r = std::mismatch(a, a + n, b);
+        assert(r.first == a + i && r.second == b + i);
+        assert(std::equal(a, a + i, b));
+        assert(!std::equal(a, a + n, b));
+#if TEST_STD_VER > 11
+        assert(std::mismatch(a, a + n, b, b + i).first == a + i);
+        assert(std::mismatch(a, a + i, b, b + n).first == a + i);
+        assert(!std::equal(a, a + n, b, b + n));
+#endif
+        b[i] = a[i];
+      }
+    }
+  }
+}
+
+void test_pointers() {
+  int objects[N];
+  const int* o = objects;
+  const int* ptrs[N];
+  for (std::size_t i = 0; i != N; ++i)
+    ptrs[i] = o + i % 10;
+  const int** last = ptrs + N;
+  assert(std::find(ptrs, last, o + 9) == ptrs + 9);
+  assert(std::find(ptrs + 10, last, o) == ptrs + 10);
+  assert(std::find(ptrs, last, o + N) == last);
+  assert(std::find(ptrs, last, objects + 9) == ptrs + 9);
+  assert(std::count(ptrs, last, o + 3) == N / 10);
+  const int* copy[N];
+  std::copy(ptrs, last, copy);
+  assert(std::equal(ptrs, last, copy));
+  copy[N - 1] = 0;
+  assert(std::mismatch(ptrs, last, copy).first == last - 1);
+}
+
+// The value is compared to the elements as integers, not as their bytes.
+void test_conversions() {
+  signed char s[N];
+  unsigned char u[N];
+  std::fill(s, s + N, static_cast<signed char>(-1));
+  std::fill(u, u + N, static_cast<unsigned char>(0xff));
+  assert(std::find(s, s + N, 0xff) == s + N);
+  assert(std::find(s, s + N, -1) == s);
+  assert(std::find(u, u + N, -1) == u + N);
+  assert(std::find(u, u + N, 0xff) == u);
+  assert(std::count(u, u + N, 0x1ff) == 0);
+  assert(std::count(s, s + N, static_cast<char>(-1)) == N);
+
+  int i[N];
+  std::fill(i, i + N, -1);
+  assert(std::find(i, i + N, 0xffffffffu) == i);
+  assert(std::find(i, i + N, 0xffffffffLL) == i + N);
+  assert(std::count(i, i + N, -1LL) == N);
+
+  bool b[N] = {};
+  b[N - 1] = true;
+  assert(std::find(b, b + N, 1) == b + N - 1);
+  assert(std::find(b, b + N, 2) == b + N);
+}
+
+#if TEST_STD_VER > 17
+constexpr bool test_constexpr() {
+  int a[100] = {};
+  a[70] = 1;
+  int b[100] = {};
+  return std::find(a, a + 100, 1) == a + 70 && std::count(a, a + 100, 0) == 99 &&
+         std::mismatch(a, a + 100, b).first == a + 70 && !std::equal(a, a + 100, b);
+}
+static_assert(test_constexpr());
+#endif
+
+} // namespace
+
+int main(int, char**) {
+  test_find_count<std::uint8_t>();
+  test_find_count<std::int8_t>();
+  test_find_count<std::uint16_t>();
+  test_find_count<std::int16_t>();
+  test_find_count<std::uint32_t>();
+  test_find_count<std::int32_t>();
+  test_find_count<std::uint64_t>();
+  test_find_count<std::int64_t>();
+  test_pointers();
+  test_conversions();
+
+  return 0;
+}
@@ -0,0 +1,233 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// Not a portable test
+
+// <__flat_hash_map>
+
+// The open addressing hash map extension, checked against unordered_map.
+
+#include <__flat_hash_map>
+#include <unordered_map>
+#include <string>
+#include <cassert>
+
+#include "test_macros.h"
+#include "Counter.h"
+#include "test_allocator.h"
+
+// All the keys in a few groups, to exercise the probing and the deleted slots.
+struct BadHash {
+  std::size_t operator()(int x) const { return x % 7; }
+};
+
+template <class Map, class Ref>
+void check_equal(const Map& m, const Ref& ref) {
+  assert(m.size() == ref.size());
+  std::size_t n = 0;
+  for (typename Map::const_iterator i = m.begin(); i != m.end(); ++i, ++n) {
+    typename Ref::const_iterator j = ref.find(i->first);
+    assert(j != ref.end());
+    assert(i->second == j->second);
+  }
+  assert(n == ref.size());
+  for (typename Ref::const_iterator j = ref.begin(); j != ref.end(); ++j) {
+    typename Map::const_iterator i = m.find(j->first);
+    assert(i != m.end());
+    assert(i->second == j->second);
+  }
+  assert(m.load_factor() <= m.max_load_factor());
+}
+
+template <class Hash>
+void test_random_operations() {
+  std::__flat_hash_map<int, int, Hash> m;
+  std::unordered_map<int, int> ref;
+  unsigned state = 1;
+  for (int step = 0; step < 20000; ++step) {
+    state = state * 1103515245u + 12345u;
+    int key = (state >> 8) % 600;
+    switch ((state >> 4) % 4) {
+    case 0:
+    case 1: {
+      bool inserted = m.insert(std::make_pair(key, step)).second;
+      assert(inserted == ref.insert(std::make_pair(key, step)).second);
+      break;
+    }
+    case 2:
+      assert(m.erase(key) == ref.erase(key));
+      break;
+    case 3:
+      m[key] += 1;
+      ref[key] += 1;
+      break;
+    }
+    if (step % 1000 == 0)
+      check_equal(m, ref);
+  }
+  check_equal(m, ref);
+  while (!m.empty()) {
+    int key = m.begin()->first;
+    m.erase(m.begin());
+    ref.erase(key);
+  }
+  check_equal(m, ref);
+}
+
+void test_basic() {
+  typedef std::__flat_hash_map<int, std::string> M;
+  M m;
+  assert(m.empty());
+  assert(m.begin() == m.end());
+  assert(m.find(1) == m.end());
+  assert(m.count(1) == 0);
+  assert(m.bucket_count() == 0);
+
+  assert(m.emplace(1, "one").second);
+  assert(!m.emplace(1, "uno").second);
+  assert(m.try_emplace(2, 3, 'x').second);
+  assert(m.at(2) == "xxx");
+  assert(!m.insert_or_assign(2, "two").second);
+  assert(m[2] == "two");
+  assert(m.emplace(std::piecewise_construct, std::forward_as_tuple(3),
+                   std::forward_as_tuple("three")).second);
+  assert(m.size() == 3);
+  assert(m.contains(3));
+  assert(m.equal_range(3).first == m.find(3));
+  assert(std::next(m.equal_range(3).first) == m.equal_range(3).second);
+  assert(m.equal_range(4).first == m.end());
+
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  try {
+    m.at(4);
+    assert(false);
+  } catch (std::out_of_range&) {
+  }
+#endif
+
+  M copy(m);
+  assert(copy == m);
+  copy[4] = "four";
+  assert(copy != m);
+  M moved(std::move(copy));
+  assert(copy.empty());
+  assert(moved.size() == 4);
+  copy = moved;
+  assert(copy == moved);
+  m = {{5, "five"}};
+  assert(m.size() == 1 && m[5] == "five");
+  swap(m, copy);
+  assert(m.size() == 4 && copy.size() == 1);
+
+  // Erasing doesn't invalidate the other iterators.
+  M::iterator i = m.find(2);
+  m.erase(1);
+  m.erase(3);
+  assert(i->second == "two");
+  m.erase(m.begin(), m.end());
+  assert(m.empty());
+
+  m.rehash(100);
+  assert(m.bucket_count() >= 100);
+  m.rehash(0);
+  assert(m.bucket_count() == 0);
+  m.reserve(1000);
+  std::size_t buckets = m.bucket_count();
+  for (int k = 0; k < 1000; ++k)
+    m[k];
+  assert(m.bucket_count() == buckets);
+  m.clear();
+  assert(m.empty() && m.bucket_count() == buckets);
+}
+
+void test_node_handles() {
+  typedef std::__flat_hash_map<int, Counter<int> > M;
+  typedef std::unordered_map<int, Counter<int> > U;
+  static_assert(std::is_same<M::node_type, U::node_type>::value, "");
+  {
+    M m;
+    for (int k = 0; k < 100; ++k)
+      m.emplace(k, k);
+    assert(Counter_base::gConstructed == 100);
+
+    M::node_type nh = m.extract(7);
+    assert(!nh.empty());
+    assert(nh.key() == 7 && nh.mapped().get() == 7);
+    assert(m.size() == 99 && m.count(7) == 0);
+    assert(m.extract(7).empty());
+
+    // Nodes move between the two containers.
+    U u;
+    U::insert_return_type ur = u.insert(std::move(nh));
+    assert(ur.inserted && nh.empty());
+    assert(u.at(7).get() == 7);
+    U::node_type back = u.extract(7);
+    nh = m.extract(m.find(8));
+    M::insert_return_type r = m.insert(std::move(back));
+    assert(r.inserted && r.position->first == 7 && back.empty());
+    r = m.insert(M::node_type());
+    assert(!r.inserted && r.position == m.end());
+
+    // A node with a key already in the map is given back.
+    nh.key() = 9;
+    r = m.insert(std::move(nh));
+    assert(!r.inserted && r.position == m.find(9));
+    assert(!r.node.empty() && r.node.key() == 9);
+    assert(m.size() == 99);
+    assert(Counter_base::gConstructed == 100);
+  }
+  assert(Counter_base::gConstructed == 0);
+}
+
+void test_allocators() {
+  typedef test_allocator<std::pair<const int, int> > A;
+  typedef std::__flat_hash_map<int, int, std::hash<int>, std::equal_to<int>, A> M;
+  {
+    M m(0, std::hash<int>(), std::equal_to<int>(), A(1));
+    for (int k = 0; k < 50; ++k)
+      m[k] = k;
+    M same(std::move(m), A(1));
+    assert(same.size() == 50 && m.empty());
+    M other(std::move(same), A(2));
+    assert(other.size() == 50 && same.empty());
+    assert(other.get_allocator() == A(2));
+    M::node_type nh = other.extract(3);
+    assert(nh.get_allocator() == A(2));
+    other.insert(std::move(nh));
+    assert(other.size() == 50);
+    M copy(other);
+    assert(copy == other);
+  }
+  assert(test_alloc_base::alloc_count == 0);
+}
+
+void test_strings() {
+  std::__flat_hash_map<std::string, int> m;
+  std::unordered_map<std::string, int> ref;
+  for (int k = 0; k < 3000; ++k) {
+    std::string s = "key" + std::to_string(k * 7919 % 1000);
+    m[s] += k;
+    ref[s] += k;
+  }
+  check_equal(m, ref);
+  std::__flat_hash_map<std::string, int> moved = std::move(m);
+  check_equal(moved, ref);
+}
+
+int main(int, char**) {
+  test_basic();
+  test_random_operations<std::hash<int> >();
+  test_random_operations<BadHash>();
+  test_node_handles();
+  test_allocators();
+  test_strings();
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// <ostream>
+
+// The arithmetic inserters of the streams of char format the numbers without
+// num_put in the classic locale. Check them against num_put, for all the
+// flags, and check that the facets of the other locales are still used.
+
+#include <ostream>
+#include <sstream>
+#include <locale>
+#include <iterator>
+#include <climits>
+#include <cassert>
+
+#include "test_macros.h"
+
+namespace {
+
+const std::ios_base::fmtflags flags[] = {
+    std::ios_base::dec,
+    std::ios_base::hex,
+    std::ios_base::oct,
+    std::ios_base::fmtflags(0),
+    std::ios_base::hex | std::ios_base::showbase,
+    std::ios_base::hex | std::ios_base::showbase | std::ios_base::uppercase,
+    std::ios_base::oct | std::ios_base::showbase,
+    std::ios_base::dec | std::ios_base::showpos,
+    std::ios_base::hex | std::ios_base::showpos,
+    std::ios_base::dec | std::ios_base::showbase | std::ios_base::showpos,
+    std::ios_base::fixed,
+    std::ios_base::scientific | std::ios_base::uppercase,
+    std::ios_base::fixed | std::ios_base::scientific,
+    std::ios_base::showpoint | std::ios_base::showpos,
+};
+
+const std::ios_base::fmtflags adjustments[] = {
+    std::ios_base::fmtflags(0), std::ios_base::left, std::ios_base::right,
+    std::ios_base::internal,
+};
+
+// The values the inserters give to num_put.
+bool unsigned_base(std::ios_base::fmtflags f) {
+  f &= std::ios_base::basefield;
+  return f == std::ios_base::oct || f == std::ios_base::hex;
+}
+long put_value(short v, std::ios_base::fmtflags f) {
+  return unsigned_base(f) ? static_cast<long>(static_cast<unsigned short>(v)) : v;
+}
+long put_value(int v, std::ios_base::fmtflags f) {
+  return unsigned_base(f) ? static_cast<long>(static_cast<unsigned int>(v)) : v;
+}
+unsigned long put_value(unsigned short v, std::ios_base::fmtflags) { return v; }
+unsigned long put_value(unsigned int v, std::ios_base::fmtflags) { return v; }
+long put_value(long v, std::ios_base::fmtflags) { return v; }
+unsigned long put_value(unsigned long v, std::ios_base::fmtflags) { return v; }
+long long put_value(long long v, std::ios_base::fmtflags) { return v; }
+unsigned long long put_value(unsigned long long v, std::ios_base::fmtflags) { return v; }
+double put_value(float v, std::ios_base::fmtflags) { return v; }
+double put_value(double v, std::ios_base::fmtflags) { return v; }
+long double put_value(long double v, std::ios_base::fmtflags) { return v; }
+
+template <class T>
+void check(T value) {
+  for (std::ios_base::fmtflags f : flags) {
+    for (std::ios_base::fmtflags a : adjustments) {
+      for (int width = 0; width < 30; width += 7) {
+        std::ostringstream os;
+        os.flags(f | a);
+        os.fill('*');
+        os.width(width);
+        os << value;
+        assert(os.good());
+        assert(os.width() == 0);
+
+        std::ostringstream expected;
+        expected.flags(f | a);
+        expected.fill('*');
+        expected.width(width);
+        typedef std::num_put<char, std::ostreambuf_iterator<char> > F;
+        std::use_facet<F>(std::locale::classic())
+            .put(std::ostreambuf_iterator<char>(expected), expected, '*',
+                 put_value(value, f));
+        assert(os.str() == expected.str());
+      }
+    }
+  }
+}
+
+void test_classic() {
+  const long long integers[] = {0, 1, -1, 7, 8, 9, 10, 15, 16, 255, -255,
+                                2147483647, -2147483647 - 1, LLONG_MAX,
+                                LLONG_MIN};
+  for (long long i : integers) {
+    check(static_cast<short>(i));
+    check(static_cast<unsigned short>(i));
+    check(static_cast<int>(i));
+    check(static_cast<unsigned int>(i));
+    check(static_cast<long>(i));
+    check(static_cast<unsigned long>(i));
+    check(i);
+    check(static_cast<unsigned long long>(i));
+  }
+
+  const double floats[] = {0.0, -0.0, 1.0, -1.5, 0.1, 1e300, -1e-300, 123456789.0};
+  for (double d : floats) {
+    check(d);
+    check(static_cast<float>(d));
+    check(static_cast<long double>(d));
+  }
+}
+
+struct Grouping : std::numpunct<char> {
+  std::string do_grouping() const { return "\3"; }
+  char do_thousands_sep() const { return ','; }
+  char do_decimal_point() const { return ';'; }
+};
+
+struct Put : std::num_put<char> {
+  iter_type do_put(iter_type s, std::ios_base&, char, long) const {
+    *s++ = 'L';
+    return s;
+  }
+};
+
+void test_other_locales() {
+  std::ostringstream os;
+  os.imbue(std::locale(std::locale::classic(), new Grouping));
+  os << 1234567 << ' ' << -1234567LL << ' ' << 1234.5;
+  assert(os.str() == "1,234,567 -1,234,567 1,234;5");
+
+  std::ostringstream put;
+  put.imbue(std::locale(std::locale::classic(), new Put));
+  put << 1 << ' ' << 2LL;
+  assert(put.str() == "L 2");
+
+  // A copy of the classic locale.
+  std::ostringstream copy;
+  copy.imbue(std::locale("C"));
+  copy << 1234567 << ' ' << 0.5;
+  assert(copy.str() == "1234567 0.5");
+}
+
+struct Full : std::streambuf {
+  int_type overflow(int_type) { return traits_type::eof(); }
+};
+
+void test_failure() {
+  Full sb;
+  std::ostream os(&sb);
+  os << 12345;
+  assert(os.bad() && os.fail());
+  os.clear();
+  os << 1.5;
+  assert(os.bad() && os.fail());
+}
+
+} // namespace
+
+int main(int, char**) {
+  test_classic();
+  test_other_locales();
+  test_failure();
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <regex>
+
+// regex_search and regex_match without match_results run a DFA built by the
+// constructor of basic_regex when the pattern allows it. Check them against the
+// overloads with match_results, which backtrack, for patterns with and without
+// a DFA.
+
+#include <regex>
+#include <cassert>
+#include <cstddef>
+#include <string>
+
+#include "test_macros.h"
+
+namespace {
+
+const char* const patterns[] = {
+    // Patterns with a DFA.
+    "abc", "a|b|c", "ab*c", "a(bc)+d", "(?:ab|cd)*e", "a.c", "[a-c]+x",
+    "[^ab]*", "\\d{2,4}", "x{3}", "x{2,}", "a?b??c*?d+?", "\\w+@\\w+\\.com",
+    "\\s*$", "^$", "^abc", "abc$", "^a|b$", "^(a|b)*$", "[[:digit:][:upper:]]+",
+    "\\.\\*", "\\x41\\u0042", "(a*)*b", "c*$", "()", "a{0}b", "[\\d\\s]x",
+    // Patterns with an assertion or an anchor inside a group, which are run
+    // by the backtracking matcher.
+    "a(?=b)", "a(?!b)", "\\bab", "a\\B", "(^a|b)c", "(a$)", "a^",
+};
+
+const char* const texts[] = {
+    "", "a", "b", "abc", "abbbc", "xabcx", "abcd", "aabcdcde", "ab\nc", "xxx",
+    "xx", "12", "12345", "john@example.com", "  ", "x  \t", "AB", "a9Zb", ".*",
+    "aaab", "ba", "abb", "aba ab", "ABC", "5 x",
+};
+
+const std::regex_constants::match_flag_type match_flags[] = {
+    std::regex_constants::match_default,
+    std::regex_constants::match_not_bol,
+    std::regex_constants::match_not_eol,
+    std::regex_constants::match_continuous,
+    std::regex_constants::match_not_bol | std::regex_constants::match_not_eol,
+    std::regex_constants::match_not_null,
+    std::regex_constants::match_any,
+};
+
+void check(const std::regex& r, const std::string& s,
+           std::regex_constants::match_flag_type f) {
+  std::smatch m;
+  bool search = std::regex_search(s, m, r, f);
+  assert(std::regex_search(s, r, f) == search);
+  assert(std::regex_search(s.c_str(), r, f) == search);
+  assert(std::regex_search(s.begin(), s.end(), r, f) == search);
+  bool match = std::regex_match(s, m, r, f);
+  assert(std::regex_match(s, r, f) == match);
+  assert(std::regex_match(s.c_str(), r, f) == match);
+  assert(std::regex_match(s.begin(), s.end(), r, f) == match);
+}
+
+void test_patterns() {
+  const std::regex::flag_type syntax[] = {
+      std::regex::ECMAScript, std::regex::ECMAScript | std::regex::icase,
+      std::regex::ECMAScript | std::regex::nosubs,
+      std::regex::ECMAScript | std::regex::optimize};
+  for (std::regex::flag_type fl : syntax) {
+    for (const char* p : patterns) {
+      std::regex r(p, fl);
+      // The DFA is invisible in the flags.
+      assert(r.flags() == fl);
+      for (const char* t : texts)
+        for (std::regex_constants::match_flag_type f : match_flags)
+          check(r, t, f);
+    }
+  }
+}
+
+void test_examples() {
+  std::regex r("^(GET|POST) /[a-z/]*\\.html HTTP/1\\.[01]$");
+  assert(std::regex_search("GET /index.html HTTP/1.1", r));
+  assert(std::regex_match("POST /a/b.html HTTP/1.0", r));
+  assert(!std::regex_search("PUT /index.html HTTP/1.1", r));
+  assert(!std::regex_search("GET /index.html HTTP/1.1 ", r));
+  assert(!std::regex_search("GET /index.html HTTP/1.1", r,
+                            std::regex_constants::match_not_bol));
+
+  std::regex backref("(a|b)x\\1");
+  assert(std::regex_search("xaxab", backref));
+  assert(!std::regex_search("axbaxb", backref));
+
+  std::regex icase("error: [a-z]+", std::regex::icase);
+  assert(std::regex_search("12:00 ERROR: Disk full", icase));
+  assert(!std::regex_search("12:00 ERROR: 42", icase));
+
+  // A copy and a move keep the DFA.
+  std::regex copy = r;
+  assert(std::regex_match("GET /.html HTTP/1.1", copy));
+  std::regex moved = std::move(copy);
+  assert(std::regex_match("GET /.html HTTP/1.1", moved));
+  moved.assign("b+");
+  assert(std::regex_search("abbc", moved));
+  assert(!std::regex_match("abbc", moved));
+
+  // Hundreds of states, and a pattern whose backtracking would overflow the
+  // stack.
+  std::regex many("[ab]*a[ab]{8}");
+  std::string s(200, 'b');
+  assert(!std::regex_search(s, many));
+  s[180] = 'a';
+  assert(std::regex_search(s, many));
+  assert(!std::regex_search(s.substr(0, 188), many));
+  assert(std::regex_match(s.substr(0, 189), many));
+
+  // Too many states for a DFA.
+  std::regex too_many("[ab]*a[ab]{12}");
+  assert(std::regex_search("abbbbbbbbbbbb", too_many));
+  assert(!std::regex_search("bbbbbbbbbbbbb", too_many));
+}
+
+void test_wide() {
+  std::wregex r(L"a[0-9]+\\u00e9?");
+  assert(std::regex_search(L"xa12\u00e9", r));
+  assert(std::regex_match(L"a1", r));
+  assert(!std::regex_search(L"a", r));
+}
+
+} // namespace
+
+int main(int, char**) {
+  test_patterns();
+  test_examples();
+  test_wide();
+
+  return 0;
+}
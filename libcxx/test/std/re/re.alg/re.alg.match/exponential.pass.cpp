@@ -28,8 +28,9 @@ int main(int, char**) {
        {std::regex::ECMAScript, std::regex::extended, std::regex::egrep,
         std::regex::awk}) {
     try {
+      std::cmatch m;
       bool b = std::regex_match(
-          "aaaaaaaaaaaaaaaaaaaa",
+          "aaaaaaaaaaaaaaaaaaaa", m,
           std::regex(
               "a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?aaaaaaaaaaaaaaaaaaaa",
               op));
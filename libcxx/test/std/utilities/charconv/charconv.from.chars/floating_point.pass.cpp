@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// XFAIL: with_system_cxx_lib=macosx10.15
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// from_chars_result from_chars(const char* first, const char* last,
+//                              float& value,
+//                              chars_format fmt = chars_format::general);
+// from_chars_result from_chars(const char* first, const char* last,
+//                              double& value,
+//                              chars_format fmt = chars_format::general);
+
+#include <charconv>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "test_macros.h"
+
+template <class T>
+void test(const char* s, T expected, std::size_t length,
+          std::chars_format fmt = std::chars_format::general) {
+  T value = 0;
+  std::from_chars_result r = std::from_chars(s, s + std::strlen(s), value, fmt);
+  assert(r.ec == std::errc());
+  assert(r.ptr == s + length);
+  assert(std::memcmp(&value, &expected, sizeof(T)) == 0);
+}
+
+template <class T>
+void test_error(const char* s, std::errc ec, std::size_t length = 0,
+                std::chars_format fmt = std::chars_format::general) {
+  T value = 42;
+  std::from_chars_result r = std::from_chars(s, s + std::strlen(s), value, fmt);
+  assert(r.ec == ec);
+  assert(r.ptr == s + length);
+  assert(value == 42);
+}
+
+void test_decimal() {
+  test("0", 0.0, 1);
+  test("-0", -0.0, 2);
+  test("1", 1.0, 1);
+  test("1.5e3x", 1500.0, 5);
+  test(".25", 0.25, 3);
+  test("5.", 5.0, 2);
+  test("0.1", 0.1, 3);
+  test("1e23", 1e23, 4);
+  test("4.9e-324", 5e-324, 8);
+  test("1.7976931348623157e308", std::numeric_limits<double>::max(), 22);
+  test("2.2250738585072011e-308", 2.2250738585072011e-308, 23);
+  // Halfway between two doubles, and just above: the 20th and later
+  // digits decide.
+  test("9007199254740993", 9007199254740992.0, 16);
+  test("9007199254740993.0000000000001", 9007199254740994.0, 30);
+  test("9007199254740992.9999999999999", 9007199254740992.0, 30);
+  test("0.000000000000000000000000000000000000000000000000001", 1e-51, 53);
+  test("1e", 1.0, 1);
+  test("1e+", 1.0, 1);
+  test("1e5", 1.0, 1, std::chars_format::fixed);
+  test("1e5", 1e5, 3, std::chars_format::scientific);
+  test("0x10", 0.0, 1);
+
+  test("0.1", 0.1f, 3);
+  test("3.4028235e38", std::numeric_limits<float>::max(), 12);
+  test("1e-45", std::numeric_limits<float>::denorm_min(), 5);
+  test("16777217", 16777216.0f, 8);
+  test("16777217.000000000000000001", 16777218.0f, 27);
+}
+
+void test_hex() {
+  std::chars_format hex = std::chars_format::hex;
+  test("1p0", 1.0, 3, hex);
+  test("1.8p+1", 3.0, 6, hex);
+  test("-A", -10.0, 2, hex);
+  test("1.999999999999ap-4", 0.1, 18, hex);
+  test("0.0000000000001p-1022", 5e-324, 21, hex);
+  test("1.fffffffffffff8p0", 2.0, 18, hex);
+  test("1.fffffffffffff7ffffp0", 1.9999999999999998, 22, hex);
+  test("1p", 1.0, 1, hex);
+  test("0x1", 0.0, 1, hex);
+  test("1.000001p0", 1.0f, 10, hex);
+  test("1.0000018p0", 1.00000012f, 11, hex);
+  test("1p-149", std::numeric_limits<float>::denorm_min(), 6, hex);
+}
+
+void test_special() {
+  double inf = std::numeric_limits<double>::infinity();
+  test("inf", inf, 3);
+  test("-Infinity", -inf, 9);
+  test("INFINITE", inf, 3);
+  test("infx", inf, 3);
+  test("inf", std::numeric_limits<float>::infinity(), 3, std::chars_format::hex);
+
+  double nan = 0;
+  const char* s = "nan(abc_123)x";
+  std::from_chars_result r = std::from_chars(s, s + std::strlen(s), nan);
+  assert(r.ec == std::errc() && r.ptr == s + 12 && nan != nan);
+  s = "-NaN(";
+  r = std::from_chars(s, s + std::strlen(s), nan);
+  assert(r.ec == std::errc() && r.ptr == s + 4 && nan != nan);
+}
+
+void test_errors() {
+  test_error<double>("", std::errc::invalid_argument);
+  test_error<double>("-", std::errc::invalid_argument);
+  test_error<double>("+1", std::errc::invalid_argument);
+  test_error<double>(".", std::errc::invalid_argument);
+  test_error<double>("e5", std::errc::invalid_argument);
+  test_error<double>(" 1", std::errc::invalid_argument);
+  test_error<double>("1", std::errc::invalid_argument, 0, std::chars_format::scientific);
+  test_error<double>("g", std::errc::invalid_argument, 0, std::chars_format::hex);
+
+  test_error<double>("1e309", std::errc::result_out_of_range, 5);
+  test_error<double>("-1e-400", std::errc::result_out_of_range, 7);
+  test_error<double>("1p1024", std::errc::result_out_of_range, 6, std::chars_format::hex);
+  test_error<double>("1p-1080", std::errc::result_out_of_range, 7, std::chars_format::hex);
+  test_error<float>("3.5e38", std::errc::result_out_of_range, 6);
+  test_error<float>("1e-46", std::errc::result_out_of_range, 5);
+}
+
+template <class T, class U>
+void test_round_trip(U step) {
+  char buf[100];
+  for (U bits = 0; bits < (U(0x7F) << (sizeof(U) * 8 - 8)); bits += step) {
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    const std::chars_format formats[] = {std::chars_format::general, std::chars_format::scientific,
+                                         std::chars_format::hex};
+    for (std::chars_format fmt : formats) {
+      std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value, fmt);
+      assert(r.ec == std::errc());
+      T parsed;
+      std::from_chars_result p = std::from_chars(buf, r.ptr, parsed, fmt);
+      assert(p.ec == std::errc() && p.ptr == r.ptr);
+      assert(std::memcmp(&parsed, &value, sizeof(T)) == 0);
+    }
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+    T parsed;
+    std::from_chars(buf, r.ptr, parsed);
+    assert(std::memcmp(&parsed, &value, sizeof(T)) == 0);
+  }
+}
+
+int main(int, char**) {
+  test_decimal();
+  test_hex();
+  test_special();
+  test_errors();
+  test_round_trip<float>(std::uint32_t(0x7331));
+  test_round_trip<double>(std::uint64_t(0x1357924680ACE1ull) * 0x10);
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// XFAIL: with_system_cxx_lib=macosx10.15
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// to_chars_result to_chars(char* first, char* last, float value);
+// to_chars_result to_chars(char* first, char* last, double value);
+// to_chars_result to_chars(char* first, char* last, float value,
+//                          chars_format fmt);
+// to_chars_result to_chars(char* first, char* last, double value,
+//                          chars_format fmt);
+
+#include <charconv>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "test_macros.h"
+
+template <class T>
+void test(T value, const char* expected) {
+  char buf[400];
+  std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+  assert(r.ec == std::errc());
+  assert(std::strncmp(buf, expected, r.ptr - buf) == 0 && expected[r.ptr - buf] == '\0');
+
+  // The buffer of the exact length is enough, and one less isn't.
+  std::size_t n = std::strlen(expected);
+  r = std::to_chars(buf, buf + n, value);
+  assert(r.ec == std::errc() && r.ptr == buf + n);
+  r = std::to_chars(buf, buf + n - 1, value);
+  assert(r.ec == std::errc::value_too_large && r.ptr == buf + n - 1);
+}
+
+template <class T>
+void test(T value, std::chars_format fmt, const char* expected) {
+  char buf[400];
+  std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value, fmt);
+  assert(r.ec == std::errc());
+  assert(std::strncmp(buf, expected, r.ptr - buf) == 0 && expected[r.ptr - buf] == '\0');
+
+  std::size_t n = std::strlen(expected);
+  r = std::to_chars(buf, buf + n - 1, value, fmt);
+  assert(r.ec == std::errc::value_too_large && r.ptr == buf + n - 1);
+}
+
+// The shortest form: the fewest digits which read back as the same value, in
+// the shorter of the fixed and scientific notations.
+void test_shortest() {
+  test(0.0, "0");
+  test(-0.0, "-0");
+  test(1.0, "1");
+  test(-1.5, "-1.5");
+  test(0.1, "0.1");
+  test(0.3, "0.3");
+  test(1.0 / 3, "0.3333333333333333");
+  test(123456.0, "123456");
+  test(1e22, "1e+22");
+  test(1e23, "1e+23");
+  test(1e-7, "1e-07");
+  test(0.001, "0.001");
+  test(9007199254740993.0, "9007199254740992");
+  test(5e-324, "5e-324");
+  test(2.2250738585072014e-308, "2.2250738585072014e-308");
+  test(std::numeric_limits<double>::max(), "1.7976931348623157e+308");
+  test(std::numeric_limits<double>::infinity(), "inf");
+  test(-std::numeric_limits<double>::infinity(), "-inf");
+  test(std::numeric_limits<double>::quiet_NaN(), "nan");
+
+  test(0.0f, "0");
+  test(0.1f, "0.1");
+  test(1.0f / 3, "0.33333334");
+  test(16777216.0f, "16777216");
+  test(1e10f, "1e+10");
+  test(1e-45f, "1e-45");
+  test(std::numeric_limits<float>::min(), "1.1754944e-38");
+  test(std::numeric_limits<float>::max(), "3.4028235e+38");
+  test(std::numeric_limits<float>::infinity(), "inf");
+}
+
+void test_formats() {
+  test(1.0, std::chars_format::scientific, "1e+00");
+  test(123.25, std::chars_format::scientific, "1.2325e+02");
+  test(5e-324, std::chars_format::scientific, "5e-324");
+  test(0.0, std::chars_format::scientific, "0e+00");
+
+  // The fixed form of the large integers has all their digits.
+  test(1e23, std::chars_format::fixed, "99999999999999991611392");
+  test(1e22, std::chars_format::fixed, "10000000000000000000000");
+  test(1e-5, std::chars_format::fixed, "0.00001");
+  test(123.25, std::chars_format::fixed, "123.25");
+  test(3e10f, std::chars_format::fixed, "30000001024");
+
+  // As %g, but with the shortest digits.
+  test(123456.0, std::chars_format::general, "123456");
+  test(1234567.0, std::chars_format::general, "1.234567e+06");
+  test(0.0001, std::chars_format::general, "0.0001");
+  test(0.00001, std::chars_format::general, "1e-05");
+
+  // As %a, without 0x and the trailing zeros.
+  test(1.0, std::chars_format::hex, "1p+0");
+  test(3.0, std::chars_format::hex, "1.8p+1");
+  test(-0.0, std::chars_format::hex, "-0p+0");
+  test(0.1, std::chars_format::hex, "1.999999999999ap-4");
+  test(5e-324, std::chars_format::hex, "0.0000000000001p-1022");
+  test(3.0f, std::chars_format::hex, "1.8p+1");
+  test(0.1f, std::chars_format::hex, "1.99999ap-4");
+  test(std::numeric_limits<float>::denorm_min(), std::chars_format::hex, "0.000002p-126");
+  test(std::numeric_limits<double>::infinity(), std::chars_format::hex, "inf");
+}
+
+int main(int, char**) {
+  test_shortest();
+  test_formats();
+
+  return 0;
+}
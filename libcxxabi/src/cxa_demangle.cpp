@@ -249,13 +249,25 @@ class BumpPointerAllocator {
   static constexpr size_t AllocSize = 4096;
   static constexpr size_t UsableAllocSize = AllocSize - sizeof(BlockMeta);
 
+  // The Current of the blocks of allocateMassive, which are freed by reset()
+  // rather than kept for the next names.
+  static constexpr size_t MassiveBlock = static_cast<size_t>(-1);
+
   alignas(long double) char InitialBuffer[AllocSize];
   BlockMeta* BlockList = nullptr;
+  // The blocks that reset() kept, reused by grow() before it mallocs.
+  BlockMeta* FreeList = nullptr;
 
   void grow() {
-    char* NewMeta = static_cast<char *>(std::malloc(AllocSize));
-    if (NewMeta == nullptr)
-      std::terminate();
+    char* NewMeta;
+    if (FreeList) {
+      NewMeta = reinterpret_cast<char*>(FreeList);
+      FreeList = FreeList->Next;
+    } else {
+      NewMeta = static_cast<char *>(std::malloc(AllocSize));
+      if (NewMeta == nullptr)
+        std::terminate();
+    }
     BlockList = new (NewMeta) BlockMeta{BlockList, 0};
   }
 
@@ -264,7 +276,7 @@ class BumpPointerAllocator {
     BlockMeta* NewMeta = reinterpret_cast<BlockMeta*>(std::malloc(NBytes));
     if (NewMeta == nullptr)
       std::terminate();
-    BlockList->Next = new (NewMeta) BlockMeta{BlockList->Next, 0};
+    BlockList->Next = new (NewMeta) BlockMeta{BlockList->Next, MassiveBlock};
     return static_cast<void*>(NewMeta + 1);
   }
 
@@ -284,17 +296,33 @@ public:
                               BlockList->Current - N);
   }
 
+  // Frees the nodes. The blocks of AllocSize are kept for the nodes of the
+  // next name, so that a parser which demangles many names stops calling
+  // malloc once its arena is as large as the largest name needs.
   void reset() {
     while (BlockList) {
       BlockMeta* Tmp = BlockList;
       BlockList = BlockList->Next;
-      if (reinterpret_cast<char*>(Tmp) != InitialBuffer)
+      if (reinterpret_cast<char*>(Tmp) == InitialBuffer)
+        continue;
+      if (Tmp->Current == MassiveBlock) {
         std::free(Tmp);
+        continue;
+      }
+      Tmp->Next = FreeList;
+      FreeList = Tmp;
     }
     BlockList = new (InitialBuffer) BlockMeta{nullptr, 0};
   }
 
-  ~BumpPointerAllocator() { reset(); }
+  ~BumpPointerAllocator() {
+    reset();
+    while (FreeList) {
+      BlockMeta* Tmp = FreeList;
+      FreeList = FreeList->Next;
+      std::free(Tmp);
+    }
+  }
 };
 
 class DefaultAllocator {
@@ -1391,6 +1391,10 @@ void LinkerDriver::link(ArrayRef<const char *> argsArr) {
   if (auto *arg = args.getLastArg(OPT_lldltocache))
     config->ltoCache = arg->getValue();
 
+  // Handle /lldghashcache
+  if (auto *arg = args.getLastArg(OPT_lldghashcache))
+    config->ghashCacheDir = arg->getValue();
+
   // Handle /lldsavecachepolicy
   if (auto *arg = args.getLastArg(OPT_lldltocachepolicy))
     config->ltoCachePolicy = CHECK(
@@ -281,9 +281,10 @@ void ICF::run(ArrayRef<Chunk *> vec) {
 
   // From now on, sections in Chunks are ordered so that sections in
   // the same group are consecutive in the vector.
-  llvm::stable_sort(chunks, [](const SectionChunk *a, const SectionChunk *b) {
-    return a->eqClass[0] < b->eqClass[0];
-  });
+  parallelStableSort(chunks,
+                     [](const SectionChunk *a, const SectionChunk *b) {
+                       return a->eqClass[0] < b->eqClass[0];
+                     });
 
   // Compare static contents and assign unique IDs for each static content.
   forEachClass([&](size_t begin, size_t end) { segregate(begin, end, true); });
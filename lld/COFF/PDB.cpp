@@ -18,6 +18,7 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Timer.h"
 #include "lld/Common/Threads.h"
+#include "lld/Common/Version.h"
 #include "llvm/DebugInfo/CodeView/DebugFrameDataSubsection.h"
 #include "llvm/DebugInfo/CodeView/DebugSubsectionRecord.h"
 #include "llvm/DebugInfo/CodeView/GlobalTypeTableBuilder.h"
@@ -53,10 +54,14 @@
 #include "llvm/Support/BinaryByteStream.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Errc.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/JamCRC.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include <atomic>
 #include <memory>
 
 using namespace lld;
@@ -80,6 +85,17 @@ static Timer diskCommitTimer("Commit to Disk", totalPdbLinkTimer);
 namespace {
 class DebugSHandler;
 
+/// Global type hashes of an object file. They are either computed in this
+/// link or read from a file in the /lldghashcache directory.
+struct GHashes {
+  std::vector<GloballyHashedType> owned;
+  ArrayRef<GloballyHashedType> cached;
+
+  ArrayRef<GloballyHashedType> get() const {
+    return owned.empty() ? cached : makeArrayRef(owned);
+  }
+};
+
 class PDBLinker {
   friend DebugSHandler;
 
@@ -104,6 +120,10 @@ public:
   /// Link info for each import file in the symbol table into the PDB.
   void addImportFilesToPDB(ArrayRef<OutputSection *> outputSections);
 
+  /// Compute global type hashes in parallel for objects which need them but
+  /// don't have a .debug$H section.
+  void computeGHashes();
+
   /// Link CodeView from a single object file into the target (output) PDB.
   /// When a precompiled headers object is linked, its TPI map might be provided
   /// externally.
@@ -184,6 +204,13 @@ private:
   /// far.
   std::map<uint32_t, CVIndexMap> precompTypeIndexMappings;
 
+  /// Global type hashes computed by computeGHashes(). Each entry is released
+  /// once the types of the object are merged.
+  DenseMap<ObjFile *, GHashes> ghashes;
+
+  /// Files of /lldghashcache that the hashes in ghashes may point into.
+  std::vector<std::unique_ptr<MemoryBuffer>> ghashCacheBuffers;
+
   // For statistics
   uint64_t globalSymbols = 0;
   uint64_t moduleSymbols = 0;
@@ -323,13 +350,28 @@ static void addTypeInfo(pdb::TpiStreamBuilder &tpiBuilder,
   // Start the TPI or IPI stream header.
   tpiBuilder.setVersionHeader(pdb::PdbTpiV80);
 
-  // Flatten the in memory type table and hash each type.
-  typeTable.ForEachRecord([&](TypeIndex ti, const CVType &type) {
-    auto hash = pdb::hashTypeRecord(type);
-    if (auto e = hash.takeError())
-      fatal("type hashing error");
-    tpiBuilder.addTypeRecord(type.RecordData, *hash);
+  // Flatten the in memory type table and hash each type. Hashing is done
+  // in parallel because there can be millions of records.
+  std::vector<CVType> records;
+  typeTable.ForEachRecord(
+      [&](TypeIndex ti, const CVType &type) { records.push_back(type); });
+
+  std::vector<uint32_t> hashes(records.size());
+  std::atomic<bool> failed(false);
+  parallelForEachN(0, records.size(), [&](size_t i) {
+    Expected<uint32_t> hash = pdb::hashTypeRecord(records[i]);
+    if (!hash) {
+      consumeError(hash.takeError());
+      failed = true;
+      return;
+    }
+    hashes[i] = *hash;
   });
+  if (failed)
+    fatal("type hashing error");
+
+  for (size_t i = 0, e = records.size(); i != e; ++i)
+    tpiBuilder.addTypeRecord(records[i].RecordData, hashes[i]);
 }
 
 Expected<const CVIndexMap &>
@@ -393,11 +435,19 @@ PDBLinker::mergeDebugT(ObjFile *file, CVIndexMap *objectIndexMap) {
   if (config->debugGHashes) {
     ArrayRef<GloballyHashedType> hashes;
     std::vector<GloballyHashedType> ownedHashes;
-    if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(file))
+    if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(file)) {
       hashes = getHashesFromDebugH(*debugH);
-    else {
-      ownedHashes = GloballyHashedType::hashTypes(types);
-      hashes = ownedHashes;
+    } else {
+      auto it = ghashes.find(file);
+      if (it != ghashes.end()) {
+        ownedHashes = std::move(it->second.owned);
+        hashes = it->second.cached;
+        ghashes.erase(it);
+      } else {
+        ownedHashes = GloballyHashedType::hashTypes(types);
+      }
+      if (!ownedHashes.empty())
+        hashes = ownedHashes;
     }
 
     if (auto err = mergeTypeAndIdRecords(
@@ -1275,6 +1325,134 @@ static PublicSym32 createPublic(Defined *def) {
   return pub;
 }
 
+static ArrayRef<uint8_t> getTypeStreamData(const CVTypeArray &types) {
+  BinaryStreamRef stream = types.getUnderlyingStream();
+  ArrayRef<uint8_t> data;
+  cantFail(stream.readBytes(0, stream.getLength(), data));
+  return data;
+}
+
+static std::string getGHashCacheHeader() {
+  return "lld-ghash-cache " + getLLDVersion() + "\n";
+}
+
+// Global hashes only depend on the type records, so /lldghashcache files are
+// keyed by a hash of the type stream rather than of the whole object file.
+static std::string getGHashCachePath(ArrayRef<uint8_t> data) {
+  SmallString<128> path(config->ghashCacheDir);
+  sys::path::append(path, "ghash-" + utohexstr(xxHash64(data)) + "-" +
+                              Twine(data.size()));
+  return path.str();
+}
+
+// Reads a /lldghashcache file. The file is mapped into memory, so reading
+// it doesn't copy its contents. Returns nullptr if there is no usable file.
+static std::unique_ptr<MemoryBuffer> readGHashCache(StringRef path,
+                                                    uint64_t numTypes) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr = MemoryBuffer::getFile(
+      path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (!mbOrErr)
+    return nullptr;
+
+  StringRef buf = (*mbOrErr)->getBuffer();
+  std::string header = getGHashCacheHeader();
+  if (!buf.consume_front(header) || buf.size() < 8 ||
+      support::endian::read64le(buf.data()) != numTypes ||
+      buf.size() - 8 != numTypes * sizeof(GloballyHashedType))
+    return nullptr;
+  return std::move(*mbOrErr);
+}
+
+static ArrayRef<GloballyHashedType> getGHashesFromCache(MemoryBuffer &mb) {
+  StringRef buf = mb.getBuffer().drop_front(getGHashCacheHeader().size() + 8);
+  return {reinterpret_cast<const GloballyHashedType *>(buf.data()),
+          buf.size() / sizeof(GloballyHashedType)};
+}
+
+static void writeGHashCache(StringRef path,
+                            ArrayRef<GloballyHashedType> hashes) {
+  // Write to a temporary file and rename it so that concurrent links
+  // using the same cache directory never see a partially written file.
+  int fd;
+  SmallString<128> tmpPath;
+  if (std::error_code ec =
+          sys::fs::createUniqueFile(path + ".tmp%%%%%%%", fd, tmpPath)) {
+    warn("cannot create " + path + ": " + ec.message());
+    return;
+  }
+
+  raw_fd_ostream os(fd, /*shouldClose=*/true);
+  char count[8];
+  support::endian::write64le(count, hashes.size());
+  os << getGHashCacheHeader();
+  os.write(count, sizeof(count));
+  os.write(reinterpret_cast<const char *>(hashes.data()),
+           hashes.size() * sizeof(GloballyHashedType));
+  os.close();
+
+  std::error_code ec = os.error();
+  os.clear_error();
+  if (!ec)
+    ec = sys::fs::rename(tmpPath, path);
+  if (ec) {
+    warn("cannot create " + path + ": " + ec.message());
+    sys::fs::remove(tmpPath);
+  }
+}
+
+// Hashing type records with SHA1 is expensive, and each object's hashes
+// only depend on its own records. So, before merging types one object at a
+// time, compute the hashes of all objects in parallel. Objects using
+// precompiled headers are skipped because their type stream is rewritten
+// before merging.
+//
+// With /lldghashcache, hashes of objects that were seen by a previous link
+// are read from the cache directory instead, and newly computed hashes are
+// saved there. This helps with objects which are never rebuilt, such as
+// third-party libraries built by compilers that don't emit .debug$H.
+void PDBLinker::computeGHashes() {
+  std::vector<ObjFile *> files;
+  for (ObjFile *file : ObjFile::instances)
+    if (file->debugTypesObj && !getDebugH(file) &&
+        (file->debugTypesObj->kind == TpiSource::Regular ||
+         file->debugTypesObj->kind == TpiSource::PCH))
+      files.push_back(file);
+
+  bool useCache = !config->ghashCacheDir.empty();
+  if (useCache) {
+    if (std::error_code ec =
+            sys::fs::create_directories(config->ghashCacheDir)) {
+      warn("cannot create " + config->ghashCacheDir + ": " + ec.message());
+      useCache = false;
+    }
+  }
+
+  std::vector<GHashes> hashes(files.size());
+  std::vector<std::unique_ptr<MemoryBuffer>> buffers(files.size());
+  parallelForEachN(0, files.size(), [&](size_t i) {
+    const CVTypeArray &types = *files[i]->debugTypes;
+    if (!useCache) {
+      hashes[i].owned = GloballyHashedType::hashTypes(types);
+      return;
+    }
+
+    std::string path = getGHashCachePath(getTypeStreamData(types));
+    uint64_t numTypes = std::distance(types.begin(), types.end());
+    if ((buffers[i] = readGHashCache(path, numTypes))) {
+      hashes[i].cached = getGHashesFromCache(*buffers[i]);
+      return;
+    }
+    hashes[i].owned = GloballyHashedType::hashTypes(types);
+    writeGHashCache(path, hashes[i].owned);
+  });
+
+  for (size_t i = 0, e = files.size(); i != e; ++i) {
+    ghashes[files[i]] = std::move(hashes[i]);
+    if (buffers[i])
+      ghashCacheBuffers.push_back(std::move(buffers[i]));
+  }
+}
+
 // Add all object files to the PDB. Merge .debug$T sections into IpiData and
 // TpiData.
 void PDBLinker::addObjectsToPDB() {
@@ -1282,6 +1460,11 @@ void PDBLinker::addObjectsToPDB() {
 
   createModuleDBI(builder);
 
+  if (config->debugGHashes) {
+    ScopedTimer t(typeMergingTimer);
+    computeGHashes();
+  }
+
   for (ObjFile *file : ObjFile::instances)
     addObjFile(file);
 
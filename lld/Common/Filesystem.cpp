@@ -15,6 +15,7 @@
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #if LLVM_ON_UNIX
 #include <unistd.h>
 #endif
@@ -97,3 +98,15 @@ std::error_code lld::tryCreateFile(StringRef path) {
     return std::error_code();
   return errorToErrorCode(FileOutputBuffer::create(path, 1).takeError());
 }
+
+// Returns false if the file at Path would be created on a network
+// filesystem. If that cannot be determined, returns true.
+bool lld::isOnLocalFilesystem(StringRef path) {
+  if (path == "-")
+    return true;
+  StringRef dir = sys::path::parent_path(path);
+  bool result;
+  if (sys::fs::is_local(dir.empty() ? "." : dir, result))
+    return true;
+  return result;
+}
@@ -14,9 +14,26 @@ using namespace lld;
 BumpPtrAllocator lld::bAlloc;
 StringSaver lld::saver{bAlloc};
 std::vector<SpecificAllocBase *> lld::SpecificAllocBase::instances;
+bool lld::SpecificAllocBase::hugePages = false;
 
 void lld::freeArena() {
   for (SpecificAllocBase *alloc : SpecificAllocBase::instances)
     alloc->reset();
   bAlloc.Reset();
+
+  // Huge pages are an option of a single link. Start the next link in the
+  // same process with arenas that use normal pages.
+  if (SpecificAllocBase::hugePages) {
+    SpecificAllocBase::hugePages = false;
+    for (SpecificAllocBase *alloc : SpecificAllocBase::instances)
+      alloc->disableHugePages();
+    bAlloc = BumpPtrAllocator();
+  }
+}
+
+void lld::enableHugePageArenas() {
+  SpecificAllocBase::hugePages = true;
+  for (SpecificAllocBase *alloc : SpecificAllocBase::instances)
+    alloc->enableHugePages();
+  bAlloc.enableHugePages();
 }
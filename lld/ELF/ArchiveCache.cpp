@@ -0,0 +1,185 @@
+//===- ArchiveCache.cpp ---------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements --archive-cache-dir.
+//
+// An archive without a symbol table is accepted if all of its members are
+// bitcode files. In that case, every member is parsed as an lto::InputFile
+// on every link just to find the names of the symbols it defines, which is
+// slow for large archives. With --archive-cache-dir, lld saves the names in
+// a file in the given directory and reads them in later links instead of
+// parsing the members again. Cache files are keyed by a hash of the archive
+// contents, so a rebuilt archive gets a new cache file.
+//
+// Archives with a symbol table don't need this, as the symbol table is
+// already an on-disk index that lld reads directly.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ArchiveCache.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Memory.h"
+#include "lld/Common/Version.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::support;
+
+using namespace lld;
+using namespace lld::elf;
+
+namespace {
+struct PendingEntry {
+  std::string path;
+  uint64_t archiveSize;
+  std::vector<LazyObjFile *> members;
+};
+} // namespace
+
+// Archives that were not found in the cache.
+static std::vector<PendingEntry> pending;
+
+static std::string getCacheHeader() {
+  return "lld-archive-cache " + getLLDVersion() + "\n";
+}
+
+static std::string getCachePath(MemoryBufferRef mb) {
+  SmallString<128> path(config->archiveCacheDir);
+  sys::path::append(path, "archive-" + utohexstr(xxHash64(mb.getBuffer())));
+  return path.str();
+}
+
+// Parses a cache file. A cache file consists of the header, the size of the
+// archive and the number of members, followed by the number of symbols and
+// the symbol names of each member. Integers are little-endian.
+static bool parseCache(StringRef data, uint64_t archiveSize,
+                       ArrayRef<LazyObjFile *> members,
+                       std::vector<std::vector<StringRef>> &names) {
+  if (!data.consume_front(getCacheHeader()))
+    return false;
+
+  auto read = [&](size_t size, uint64_t &v) {
+    if (data.size() < size)
+      return false;
+    v = size == 4 ? endian::read32le(data.data())
+                  : endian::read64le(data.data());
+    data = data.drop_front(size);
+    return true;
+  };
+
+  uint64_t size, numMembers;
+  if (!read(8, size) || size != archiveSize || !read(8, numMembers) ||
+      numMembers != members.size())
+    return false;
+
+  names.resize(numMembers);
+  for (std::vector<StringRef> &v : names) {
+    uint64_t numSymbols;
+    if (!read(4, numSymbols))
+      return false;
+    for (uint64_t i = 0; i < numSymbols; ++i) {
+      uint64_t len;
+      if (!read(4, len) || data.size() < len)
+        return false;
+      v.push_back(data.take_front(len));
+      data = data.drop_front(len);
+    }
+  }
+  return data.empty();
+}
+
+void elf::readArchiveCache(MemoryBufferRef mb,
+                           ArrayRef<LazyObjFile *> members) {
+  if (config->archiveCacheDir.empty())
+    return;
+
+  std::string path = getCachePath(mb);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(path, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  std::vector<std::vector<StringRef>> names;
+  if (!mbOrErr || !parseCache((*mbOrErr)->getBuffer(), mb.getBufferSize(),
+                              members, names)) {
+    for (LazyObjFile *file : members)
+      file->recordSymbols = true;
+    pending.push_back({path, mb.getBufferSize(), members});
+    return;
+  }
+
+  // Symbol names refer to the cache file, so keep it alive.
+  make<std::unique_ptr<MemoryBuffer>>(std::move(*mbOrErr));
+  for (size_t i = 0, e = members.size(); i != e; ++i) {
+    members[i]->definedSymbols = std::move(names[i]);
+    members[i]->symbolsFromCache = true;
+  }
+  log("found " + mb.getBufferIdentifier() + " in the archive cache");
+}
+
+static void writeEntry(const PendingEntry &entry) {
+  auto write = [](raw_ostream &os, size_t size, uint64_t v) {
+    char buf[8];
+    if (size == 4)
+      endian::write32le(buf, v);
+    else
+      endian::write64le(buf, v);
+    os.write(buf, size);
+  };
+
+  // Write to a temporary file and rename it so that concurrent links
+  // using the same cache directory never see a partially written file.
+  int fd;
+  SmallString<128> tmpPath;
+  if (std::error_code ec =
+          sys::fs::createUniqueFile(entry.path + ".tmp%%%%%%%", fd, tmpPath)) {
+    warn("cannot create " + entry.path + ": " + ec.message());
+    return;
+  }
+
+  raw_fd_ostream os(fd, /*shouldClose=*/true);
+  os << getCacheHeader();
+  write(os, 8, entry.archiveSize);
+  write(os, 8, entry.members.size());
+  for (LazyObjFile *file : entry.members) {
+    write(os, 4, file->definedSymbols.size());
+    for (StringRef name : file->definedSymbols) {
+      write(os, 4, name.size());
+      os << name;
+    }
+  }
+  os.close();
+
+  std::error_code ec = os.error();
+  os.clear_error();
+  if (!ec)
+    ec = sys::fs::rename(tmpPath, entry.path);
+  if (ec) {
+    warn("cannot create " + entry.path + ": " + ec.message());
+    sys::fs::remove(tmpPath);
+  }
+}
+
+void elf::writeArchiveCache() {
+  if (pending.empty())
+    return;
+
+  if (std::error_code ec =
+          sys::fs::create_directories(config->archiveCacheDir)) {
+    warn("cannot create " + config->archiveCacheDir + ": " + ec.message());
+    return;
+  }
+  for (const PendingEntry &entry : pending)
+    writeEntry(entry);
+  pending.clear();
+}
@@ -0,0 +1,32 @@
+//===- ArchiveCache.h -------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_ARCHIVE_CACHE_H
+#define LLD_ELF_ARCHIVE_CACHE_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace lld {
+namespace elf {
+
+class LazyObjFile;
+
+// Looks up an archive without a symbol table in --archive-cache-dir. If it
+// is found, stores the names of the symbols defined by each member to the
+// member's LazyObjFile so that the member is not parsed. Otherwise, arranges
+// for the names to be recorded when the members are parsed.
+void readArchiveCache(MemoryBufferRef mb, ArrayRef<LazyObjFile *> members);
+
+// Writes cache files for the archives that were not found in the cache.
+void writeArchiveCache();
+
+} // namespace elf
+} // namespace lld
+
+#endif
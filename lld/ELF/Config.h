@@ -84,6 +84,7 @@ struct Configuration {
   uint32_t andFeatures = 0;
   llvm::CachePruningPolicy thinLTOCachePolicy;
   llvm::StringMap<uint64_t> sectionStartMap;
+  llvm::StringRef archiveCacheDir;
   llvm::StringRef chroot;
   llvm::StringRef dynamicLinker;
   llvm::StringRef dwoDir;
@@ -107,6 +108,7 @@ struct Configuration {
   llvm::StringRef sysroot;
   llvm::StringRef thinLTOCacheDir;
   llvm::StringRef thinLTOIndexOnlyArg;
+  llvm::StringRef thinLTOSharedCacheDir;
   std::pair<llvm::StringRef, llvm::StringRef> thinLTOObjectSuffixReplace;
   std::pair<llvm::StringRef, llvm::StringRef> thinLTOPrefixReplace;
   std::string rpath;
@@ -154,13 +156,17 @@ struct Configuration {
   bool gnuUnique;
   bool hasDynamicList = false;
   bool hasDynSymTab;
+  bool hugePageArenas;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool incremental;
   bool ltoCSProfileGenerate;
   bool ltoDebugPassManager;
   bool ltoNewPassManager;
+  bool ltoParallelFunctionPasses;
   bool mergeArmExidx;
   bool mipsN32Abi = false;
+  bool mmapOutputFile;
   bool nmagic;
   bool noinhibitExec;
   bool nostdlib;
@@ -170,6 +176,7 @@ struct Configuration {
   bool pacPlt;
   bool picThunk;
   bool pie;
+  bool printArenaStats;
   bool printGcSections;
   bool printIcfSections;
   bool relocatable;
@@ -180,6 +187,8 @@ struct Configuration {
   bool isStatic = false;
   bool sysvHash = false;
   bool target1Rel;
+  bool timeTraceEnabled;
+  bool timeTraceSummary;
   bool trace;
   bool thinLTOEmitImportsFiles;
   bool thinLTOIndexOnly;
@@ -200,6 +209,7 @@ struct Configuration {
   bool zIfuncNoplt;
   bool zInitfirst;
   bool zInterpose;
+  bool zGroupTextSectionPrefix;
   bool zKeepTextSectionPrefix;
   bool zNodefaultlib;
   bool zNodelete;
@@ -232,6 +242,7 @@ struct Configuration {
   unsigned ltoo;
   unsigned optimize;
   unsigned thinLTOJobs;
+  unsigned timeTraceGranularity;
   int32_t splitStackAdjustSize;
 
   // The following config options do not directly correspond to any
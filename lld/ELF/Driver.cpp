@@ -23,6 +23,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "Driver.h"
+#include "ArchiveCache.h"
 #include "Config.h"
 #include "ICF.h"
 #include "InputFiles.h"
@@ -45,9 +46,12 @@
 #include "lld/Common/TargetOptionsCommandFlags.h"
 #include "lld/Common/Threads.h"
 #include "lld/Common/Version.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSwitch.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/ProfileData/SampleProfReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/GlobPattern.h"
@@ -55,6 +59,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TarWriter.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdlib>
 #include <utility>
@@ -228,9 +233,12 @@ void LinkerDriver::addFile(StringRef path, bool withLOption) {
           return;
         }
 
+      std::vector<LazyObjFile *> members;
       for (const std::pair<MemoryBufferRef, uint64_t> &p :
            getArchiveMembers(mbref))
-        files.push_back(make<LazyObjFile>(p.first, path, p.second));
+        members.push_back(make<LazyObjFile>(p.first, path, p.second));
+      readArchiveCache(mbref, members);
+      files.insert(files.end(), members.begin(), members.end());
       return;
     }
 
@@ -317,6 +325,10 @@ static void checkOptions() {
   if (config->zText && config->zIfuncNoplt)
     error("-z text and -z ifunc-noplt may not be used together");
 
+  if (!config->thinLTOSharedCacheDir.empty() && config->thinLTOCacheDir.empty())
+    error("--thinlto-shared-cache-dir may not be used without "
+          "--thinlto-cache-dir");
+
   if (config->relocatable) {
     if (config->shared)
       error("-r and -shared may not be used together");
@@ -326,6 +338,8 @@ static void checkOptions() {
       error("-r and --gdb-index may not be used together");
     if (config->icf != ICFLevel::None)
       error("-r and --icf may not be used together");
+    if (config->incremental)
+      error("-r and --incremental may not be used together");
     if (config->pie)
       error("-r and -pie may not be used together");
   }
@@ -375,12 +389,14 @@ static bool getZFlag(opt::InputArgList &args, StringRef k1, StringRef k2,
 
 static bool isKnownZFlag(StringRef s) {
   return s == "combreloc" || s == "copyreloc" || s == "defs" ||
-         s == "execstack" || s == "global" || s == "hazardplt" ||
-         s == "ifunc-noplt" || s == "initfirst" || s == "interpose" ||
-         s == "keep-text-section-prefix" || s == "lazy" || s == "muldefs" ||
-         s == "separate-code" || s == "nocombreloc" || s == "nocopyreloc" ||
-         s == "nodefaultlib" || s == "nodelete" || s == "nodlopen" ||
-         s == "noexecstack" || s == "nokeep-text-section-prefix" ||
+         s == "execstack" || s == "global" || s == "group-text-section-prefix" ||
+         s == "hazardplt" || s == "ifunc-noplt" || s == "initfirst" ||
+         s == "interpose" || s == "keep-text-section-prefix" || s == "lazy" ||
+         s == "muldefs" || s == "separate-code" || s == "nocombreloc" ||
+         s == "nocopyreloc" || s == "nodefaultlib" || s == "nodelete" ||
+         s == "nodlopen" || s == "noexecstack" ||
+         s == "nogroup-text-section-prefix" ||
+         s == "nokeep-text-section-prefix" ||
          s == "norelro" || s == "noseparate-code" || s == "notext" ||
          s == "now" || s == "origin" || s == "relro" || s == "retpolineplt" ||
          s == "rodynamic" || s == "text" || s == "wxneeded" ||
@@ -395,6 +411,22 @@ static void checkZOptions(opt::InputArgList &args) {
       error("unknown -z value: " + StringRef(arg->getValue()));
 }
 
+// Writes the time trace to <output>.time-trace unless told otherwise. Only
+// the main thread is traced: the work of the threads of parallelForEach and
+// friends is accounted to the scope on the main thread that waits for it.
+static void writeTimeTrace(opt::InputArgList &args) {
+  std::string path = args.getLastArgValue(OPT_time_trace_file);
+  if (path.empty())
+    path = (config->outputFile + ".time-trace").str();
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, sys::fs::OF_Text);
+  if (ec)
+    error("cannot open " + path + ": " + ec.message());
+  else
+    timeTraceProfilerWrite(os);
+  timeTraceProfilerCleanup();
+}
+
 void LinkerDriver::main(ArrayRef<const char *> argsArr) {
   ELFOptTable parser;
   opt::InputArgList args = parser.parse(argsArr.slice(1));
@@ -443,6 +475,13 @@ void LinkerDriver::main(ArrayRef<const char *> argsArr) {
 
   readConfigs(args);
 
+  if (config->printArenaStats) {
+    enableAllocatorStats();
+    bAlloc.setName("bAlloc");
+  }
+  if (config->hugePageArenas)
+    enableHugePageArenas();
+
   // The behavior of -v or --version is a bit strange, but this is
   // needed for compatibility with GNU linkers.
   if (args.hasArg(OPT_v) && !args.hasArg(OPT_INPUT))
@@ -450,37 +489,59 @@ void LinkerDriver::main(ArrayRef<const char *> argsArr) {
   if (args.hasArg(OPT_version))
     return;
 
-  initLLVM();
-  createFiles(args);
-  if (errorCount())
-    return;
+  if (config->timeTraceSummary)
+    timeTraceProfilerInitializeSummary(config->progName);
+  else if (config->timeTraceEnabled)
+    timeTraceProfilerInitialize(config->timeTraceGranularity,
+                                config->progName);
 
-  inferMachineType();
-  setConfigs(args);
-  checkOptions();
-  if (errorCount())
-    return;
+  // Write the trace however the link ends, once the scope below is closed.
+  auto traceWriter = llvm::make_scope_exit([&] {
+    if (config->timeTraceEnabled)
+      writeTimeTrace(args);
+  });
 
-  // The Target instance handles target-specific stuff, such as applying
-  // relocations or writing a PLT section. It also contains target-dependent
-  // values such as a default image base address.
-  target = getTarget();
+  {
+    llvm::TimeTraceScope timeScope("ExecuteLinker", StringRef(""));
+    initLLVM();
+    createFiles(args);
+    if (errorCount())
+      return;
 
-  switch (config->ekind) {
-  case ELF32LEKind:
-    link<ELF32LE>(args);
-    return;
-  case ELF32BEKind:
-    link<ELF32BE>(args);
-    return;
-  case ELF64LEKind:
-    link<ELF64LE>(args);
-    return;
-  case ELF64BEKind:
-    link<ELF64BE>(args);
-    return;
-  default:
-    llvm_unreachable("unknown Config->EKind");
+    inferMachineType();
+    setConfigs(args);
+    checkOptions();
+    if (errorCount())
+      return;
+
+    // The Target instance handles target-specific stuff, such as applying
+    // relocations or writing a PLT section. It also contains target-dependent
+    // values such as a default image base address.
+    target = getTarget();
+
+    switch (config->ekind) {
+    case ELF32LEKind:
+      link<ELF32LE>(args);
+      break;
+    case ELF32BEKind:
+      link<ELF32BE>(args);
+      break;
+    case ELF64LEKind:
+      link<ELF64LE>(args);
+      break;
+    case ELF64BEKind:
+      link<ELF64BE>(args);
+      break;
+    default:
+      llvm_unreachable("unknown Config->EKind");
+    }
+  }
+
+  if (config->printArenaStats) {
+    std::string s;
+    raw_string_ostream os(s);
+    printAllocatorStats(os);
+    message(os.str());
   }
 }
 
@@ -719,6 +780,92 @@ static void readCallGraph(MemoryBufferRef mb) {
   }
 }
 
+// Adds calls made by the code described by fs to the call graph profile as
+// calls from section `from`. Call sites of inlined functions are visited
+// recursively, because the inlined code is laid out in `from`.
+static void
+addSampleProfileCalls(InputSectionBase *from,
+                      const sampleprof::FunctionSamples &fs,
+                      function_ref<InputSectionBase *(StringRef)> findSection) {
+  for (const auto &bs : fs.getBodySamples())
+    for (const auto &target : bs.second.getCallTargets())
+      if (InputSectionBase *to = findSection(target.getKey()))
+        config->callGraphProfile[std::make_pair(from, to)] += target.getValue();
+
+  for (const auto &cs : fs.getCallsiteSamples())
+    for (const auto &callee : cs.second)
+      addSampleProfileCalls(from, callee.second, findSection);
+}
+
+// Reads a sample profile, e.g. one created from perf LBR samples with
+// create_llvm_prof, and adds the calls recorded in it to the call graph
+// profile, so that sections can be ordered without recompiling the program.
+static void readCallGraphFromSampleProfile(MemoryBufferRef mb) {
+  LLVMContext ctx;
+  std::unique_ptr<MemoryBuffer> buf =
+      MemoryBuffer::getMemBuffer(mb, /*RequiresNullTerminator=*/false);
+  ErrorOr<std::unique_ptr<sampleprof::SampleProfileReader>> readerOrErr =
+      sampleprof::SampleProfileReader::create(buf, ctx);
+  if (std::error_code ec = readerOrErr.getError()) {
+    error(mb.getBufferIdentifier() + ": " + ec.message());
+    return;
+  }
+  sampleprof::SampleProfileReader &reader = **readerOrErr;
+  if (std::error_code ec = reader.read()) {
+    error(mb.getBufferIdentifier() + ": " + ec.message());
+    return;
+  }
+
+  // Profiles refer to functions by names without suffixes such as
+  // ".llvm.<hash>" added by the compiler, or by their GUIDs in the compact
+  // binary format.
+  bool useGUID = reader.getFormat() == sampleprof::SPF_Compact_Binary;
+  DenseMap<StringRef, Symbol *> map;
+  for (InputFile *file : objectFiles) {
+    for (Symbol *sym : file->getSymbols()) {
+      StringRef name = sym->getName().split('.').first;
+      bool hasSuffix = name.size() != sym->getName().size();
+      if (useGUID)
+        name = saver.save(Twine(GlobalValue::getGUID(name)));
+      // Prefer a symbol whose name has no suffix, e.g. "foo" over "foo.cold".
+      if (hasSuffix)
+        map.insert({name, sym});
+      else
+        map[name] = sym;
+    }
+  }
+
+  // Unlike --call-graph-ordering-file, profiles usually contain functions
+  // that are not in the output, e.g. those in shared libraries, so we don't
+  // warn about unknown names.
+  auto findSection = [&](StringRef name) -> InputSectionBase * {
+    if (Defined *dr = dyn_cast_or_null<Defined>(map.lookup(name)))
+      return dyn_cast_or_null<InputSectionBase>(dr->section);
+    return nullptr;
+  };
+
+  std::vector<std::pair<InputSectionBase *, uint64_t>> hot;
+  for (const auto &entry : reader.getProfiles()) {
+    const sampleprof::FunctionSamples &fs = entry.second;
+    if (InputSectionBase *from = findSection(fs.getName())) {
+      addSampleProfileCalls(from, fs, findSection);
+      hot.push_back({from, fs.getTotalSamples()});
+    }
+  }
+
+  // Functions that have samples but neither call nor are called by other
+  // sampled functions are still hot. Give them self edges so that they are
+  // placed with the other hot sections rather than with the cold ones.
+  DenseSet<const InputSectionBase *> seen;
+  for (const auto &edge : config->callGraphProfile) {
+    seen.insert(edge.first.first);
+    seen.insert(edge.first.second);
+  }
+  for (std::pair<InputSectionBase *, uint64_t> &p : hot)
+    if (p.second && seen.insert(p.first).second)
+      config->callGraphProfile[std::make_pair(p.first, p.first)] += p.second;
+}
+
 template <class ELFT> static void readCallGraphsFromObjectFiles() {
   for (auto file : objectFiles) {
     auto *obj = cast<ObjFile<ELFT>>(file);
@@ -791,6 +938,7 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasArg(OPT_visual_studio_diagnostics_format, false);
   threadsEnabled = args.hasFlag(OPT_threads, OPT_no_threads, true);
 
+  config->archiveCacheDir = args.getLastArgValue(OPT_archive_cache_dir);
   config->allowMultipleDefinition =
       args.hasFlag(OPT_allow_multiple_definition,
                    OPT_no_allow_multiple_definition, false) ||
@@ -835,11 +983,15 @@ static void readConfigs(opt::InputArgList &args) {
   config->gcSections = args.hasFlag(OPT_gc_sections, OPT_no_gc_sections, false);
   config->gnuUnique = args.hasFlag(OPT_gnu_unique, OPT_no_gnu_unique, true);
   config->gdbIndex = args.hasFlag(OPT_gdb_index, OPT_no_gdb_index, false);
+  config->hugePageArenas =
+      args.hasFlag(OPT_huge_page_arenas, OPT_no_huge_page_arenas, false);
   config->icf = getICF(args);
   config->ignoreDataAddressEquality =
       args.hasArg(OPT_ignore_data_address_equality);
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  config->incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false);
   config->init = args.getLastArgValue(OPT_init, "_init");
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
@@ -849,6 +1001,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->ltoNewPmPasses = args.getLastArgValue(OPT_lto_newpm_passes);
   config->ltoo = args::getInteger(args, OPT_lto_O, 2);
   config->ltoObjPath = args.getLastArgValue(OPT_plugin_opt_obj_path_eq);
+  config->ltoParallelFunctionPasses =
+      args.hasArg(OPT_lto_parallel_function_passes);
   config->ltoPartitions = args::getInteger(args, OPT_lto_partitions, 1);
   config->ltoSampleProfile = args.getLastArgValue(OPT_lto_sample_profile);
   config->mapFile = args.getLastArgValue(OPT_Map);
@@ -869,6 +1023,7 @@ static void readConfigs(opt::InputArgList &args) {
   config->outputFile = args.getLastArgValue(OPT_o);
   config->pacPlt = args.hasArg(OPT_pac_plt);
   config->pie = args.hasFlag(OPT_pie, OPT_no_pie, false);
+  config->printArenaStats = args.hasArg(OPT_print_arena_stats);
   config->printIcfSections =
       args.hasFlag(OPT_print_icf_sections, OPT_no_print_icf_sections, false);
   config->printGcSections =
@@ -890,6 +1045,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->target1Rel = args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
   config->target2 = getTarget2(args);
   config->thinLTOCacheDir = args.getLastArgValue(OPT_thinlto_cache_dir);
+  config->thinLTOSharedCacheDir =
+      args.getLastArgValue(OPT_thinlto_shared_cache_dir);
   config->thinLTOCachePolicy = CHECK(
       parseCachePruningPolicy(args.getLastArgValue(OPT_thinlto_cache_policy)),
       "--thinlto-cache-policy: invalid cache policy");
@@ -904,6 +1061,11 @@ static void readConfigs(opt::InputArgList &args) {
       getOldNewOptions(args, OPT_plugin_opt_thinlto_object_suffix_replace_eq);
   config->thinLTOPrefixReplace =
       getOldNewOptions(args, OPT_plugin_opt_thinlto_prefix_replace_eq);
+  config->timeTraceSummary = args.hasArg(OPT_time_trace_summary);
+  config->timeTraceEnabled =
+      args.hasArg(OPT_time_trace) || config->timeTraceSummary;
+  config->timeTraceGranularity =
+      args::getInteger(args, OPT_time_trace_granularity, 500);
   config->trace = args.hasArg(OPT_trace);
   config->undefined = args::getStrings(args, OPT_undefined);
   config->undefinedVersion =
@@ -926,6 +1088,9 @@ static void readConfigs(opt::InputArgList &args) {
   config->zIfuncNoplt = hasZOption(args, "ifunc-noplt");
   config->zInitfirst = hasZOption(args, "initfirst");
   config->zInterpose = hasZOption(args, "interpose");
+  config->zGroupTextSectionPrefix =
+      getZFlag(args, "group-text-section-prefix",
+               "nogroup-text-section-prefix", false);
   config->zKeepTextSectionPrefix = getZFlag(
       args, "keep-text-section-prefix", "nokeep-text-section-prefix", false);
   config->zNodefaultlib = hasZOption(args, "nodefaultlib");
@@ -1003,6 +1168,9 @@ static void readConfigs(opt::InputArgList &args) {
     if (args.hasArg(OPT_call_graph_ordering_file))
       error("--symbol-ordering-file and --call-graph-order-file "
             "may not be used together");
+    if (args.hasArg(OPT_call_graph_sample_profile))
+      error("--symbol-ordering-file and --call-graph-sample-profile "
+            "may not be used together");
     if (Optional<MemoryBufferRef> buffer = readFile(arg->getValue())){
       config->symbolOrderingFile = getSymbolOrderingFile(*buffer);
       // Also need to disable CallGraphProfileSort to prevent
@@ -1118,6 +1286,16 @@ void LinkerDriver::createFiles(opt::InputArgList &args) {
   // For --{push,pop}-state.
   std::vector<std::tuple<bool, bool, bool>> stack;
 
+  // Reading input files one by one is slow on network filesystems, so start
+  // reading all files named on the command line while we parse the first
+  // ones.
+  if (threadsEnabled) {
+    std::vector<std::string> paths;
+    for (auto *arg : args.filtered(OPT_INPUT))
+      paths.push_back(arg->getValue());
+    prefetchFiles(paths);
+  }
+
   // Iterate over argv to process input files and positional arguments.
   for (auto *arg : args) {
     switch (arg->getOption().getID()) {
@@ -1663,6 +1841,19 @@ template <class ELFT> static uint32_t getAndFeatures() {
   return ret;
 }
 
+// Precomputes symbol table keys of object files so that parseFile() only
+// needs to look them up in the symbol table.
+template <class ELFT>
+static void computeSymbolKeys(ArrayRef<InputFile *> files) {
+  if (!threadsEnabled)
+    return;
+  parallelForEach(files, [](InputFile *file) {
+    if (file->ekind == config->ekind)
+      if (auto *f = dyn_cast<ObjFile<ELFT>>(file))
+        f->computeSymbolKeys();
+  });
+}
+
 static const char *libcallRoutineNames[] = {
 #define HANDLE_LIBCALL(code, name) name,
 #include "llvm/IR/RuntimeLibcalls.def"
@@ -1695,6 +1886,13 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   if (errorCount())
     return;
 
+  // Writing an output file through mmap is slow on network filesystems
+  // because dirty pages are written back in small, random-order chunks.
+  // Unless told otherwise, write the output sequentially in that case.
+  config->mmapOutputFile =
+      args.hasFlag(OPT_mmap_output_file, OPT_no_mmap_output_file,
+                   isOnLocalFilesystem(config->outputFile));
+
   // Use default entry point name if no name was given via the command
   // line nor linker scripts. For some reason, MIPS entry point name is
   // different from others.
@@ -1711,8 +1909,21 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   // symbols that we need to the symbol table. This process might
   // add files to the link, via autolinking, these files are always
   // appended to the Files vector.
-  for (size_t i = 0; i < files.size(); ++i)
-    parseFile(files[i]);
+  //
+  // Symbol resolution depends on the order of files, but hashing symbol
+  // names does not, so names of each batch of object files are hashed in
+  // parallel before their symbols are resolved one file at a time.
+  {
+    llvm::TimeTraceScope timeScope("Parse input files", StringRef(""));
+    const size_t batchSize = 256;
+    for (size_t i = 0; i < files.size(); ++i) {
+      if (i % batchSize == 0)
+        computeSymbolKeys<ELFT>(makeArrayRef(files).slice(
+            i, std::min(batchSize, files.size() - i)));
+      parseFile(files[i]);
+    }
+    writeArchiveCache();
+  }
 
   // Now that we have every file, we can decide if we will need a
   // dynamic symbol table.
@@ -1804,7 +2015,10 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   //
   // With this the symbol table should be complete. After this, no new names
   // except a few linker-synthesized ones will be added to the symbol table.
-  compileBitcodeFiles<ELFT>();
+  {
+    llvm::TimeTraceScope timeScope("LTO", StringRef(""));
+    compileBitcodeFiles<ELFT>();
+  }
   if (errorCount())
     return;
 
@@ -1894,11 +2108,21 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
 
   // Do size optimizations: garbage collection, merging of SHF_MERGE sections
   // and identical code folding.
-  splitSections<ELFT>();
-  markLive<ELFT>();
+  {
+    llvm::TimeTraceScope timeScope("Split sections", StringRef(""));
+    splitSections<ELFT>();
+  }
+  {
+    llvm::TimeTraceScope timeScope("Mark live", StringRef(""));
+    markLive<ELFT>();
+  }
   demoteSharedSymbols();
-  mergeSections();
+  {
+    llvm::TimeTraceScope timeScope("Merge sections", StringRef(""));
+    mergeSections();
+  }
   if (config->icf != ICFLevel::None) {
+    llvm::TimeTraceScope timeScope("ICF", StringRef(""));
     findKeepUniqueSections<ELFT>(args);
     doIcf<ELFT>();
   }
@@ -1908,9 +2132,13 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
     if (auto *arg = args.getLastArg(OPT_call_graph_ordering_file))
       if (Optional<MemoryBufferRef> buffer = readFile(arg->getValue()))
         readCallGraph(*buffer);
+    if (auto *arg = args.getLastArg(OPT_call_graph_sample_profile))
+      if (Optional<MemoryBufferRef> buffer = readFile(arg->getValue()))
+        readCallGraphFromSampleProfile(*buffer);
     readCallGraphsFromObjectFiles<ELFT>();
   }
 
   // Write the result to the file.
+  llvm::TimeTraceScope timeScope("Write output file", StringRef(""));
   writeResult<ELFT>();
 }
@@ -33,9 +33,9 @@
 // terminates are considered identical. Here are details:
 //
 // 1. First, we partition sections using their hash values as keys. Hash
-//    values contain section types, section contents and numbers of
-//    relocations. During this step, relocation targets are not taken into
-//    account. We just put sections that apparently differ into different
+//    values contain section flags, section contents and relocation types,
+//    offsets and addends, mixed with hash values of relocation target
+//    sections. We just put sections that apparently differ into different
 //    equivalence classes.
 //
 // 2. Next, for each equivalence class, we visit sections to compare
@@ -118,6 +118,8 @@ private:
 
   void forEachClass(llvm::function_ref<void(size_t, size_t)> fn);
 
+  void logClasses(const Twine &msg);
+
   std::vector<InputSection *> sections;
 
   // We repeat the main loop while `Repeat` is true.
@@ -422,6 +424,40 @@ void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> fn) {
   ++cnt;
 }
 
+// Computes a hash of everything equalsConstant compares, i.e. section
+// attributes, contents and relocations except for the equivalence classes
+// of relocation targets, so that sections that can never be identical are
+// put into different classes before we start segregating them. Sections
+// that are equal in terms of equalsConstant always get the same hash. The
+// hash doesn't depend on addresses of objects in memory to keep the output
+// deterministic.
+template <class ELFT, class RelTy>
+static uint32_t computeFingerprint(InputSection *isec, ArrayRef<RelTy> rels) {
+  SmallVector<uint64_t, 32> v = {isec->flags, isec->getSize(),
+                                 xxHash64(isec->data())};
+  for (const RelTy &rel : rels) {
+    uint64_t addend = getAddend<ELFT>(rel);
+    v.push_back(rel.r_offset);
+    v.push_back(rel.getType(config->isMips64EL));
+
+    // Relocations referring to undefined, shared and linker-script-defined
+    // symbols are constant-equal only if they refer to the same symbol.
+    // Relocations referring to absolute symbols and InputSections are
+    // constant-equal if the sums of symbol values and addends are equal.
+    // We don't hash anything for MergeInputSections.
+    Symbol &sym = isec->template getFile<ELFT>()->getRelocTargetSym(rel);
+    auto *d = dyn_cast<Defined>(&sym);
+    if (!d || d->scriptDefined) {
+      v.push_back(xxHash64(sym.getName()));
+      v.push_back(addend);
+    } else if (!d->section || isa<InputSection>(d->section)) {
+      v.push_back(d->value + addend);
+    }
+  }
+  return xxHash64(StringRef(reinterpret_cast<const char *>(v.data()),
+                            v.size() * sizeof(uint64_t)));
+}
+
 // Combine the hashes of the sections referenced by the given section into its
 // hash.
 template <class ELFT, class RelTy>
@@ -443,6 +479,18 @@ static void print(const Twine &s) {
     message(s);
 }
 
+// Logs the number of equivalence classes for --verbose.
+template <class ELFT> void ICF<ELFT>::logClasses(const Twine &msg) {
+  if (!errorHandler().verbose)
+    return;
+  // `next` is the slot that the last round wrote to.
+  size_t numClasses = 0;
+  for (size_t i = 0, e = sections.size(); i != e; ++i)
+    if (i == 0 || sections[i]->eqClass[next] != sections[i - 1]->eqClass[next])
+      ++numClasses;
+  log("ICF: " + Twine(numClasses) + " classes " + msg);
+}
+
 // The main function of ICF.
 template <class ELFT> void ICF<ELFT>::run() {
   // Collect sections to merge.
@@ -453,7 +501,10 @@ template <class ELFT> void ICF<ELFT>::run() {
 
   // Initially, we use hash values to partition sections.
   parallelForEach(sections, [&](InputSection *s) {
-    s->eqClass[0] = xxHash64(s->data());
+    if (s->areRelocsRela)
+      s->eqClass[0] = computeFingerprint<ELFT>(s, s->template relas<ELFT>());
+    else
+      s->eqClass[0] = computeFingerprint<ELFT>(s, s->template rels<ELFT>());
   });
 
   for (unsigned cnt = 0; cnt != 2; ++cnt) {
@@ -467,12 +518,17 @@ template <class ELFT> void ICF<ELFT>::run() {
 
   // From now on, sections in Sections vector are ordered so that sections
   // in the same equivalence class are consecutive in the vector.
-  llvm::stable_sort(sections, [](const InputSection *a, const InputSection *b) {
-    return a->eqClass[0] < b->eqClass[0];
-  });
+  parallelStableSort(sections,
+                     [](const InputSection *a, const InputSection *b) {
+                       return a->eqClass[0] < b->eqClass[0];
+                     });
+
+  log("ICF: " + Twine(sections.size()) + " eligible sections");
+  logClasses("after hashing");
 
   // Compare static contents and assign unique IDs for each static content.
   forEachClass([&](size_t begin, size_t end) { segregate(begin, end, true); });
+  logClasses("after comparing contents");
 
   // Split groups by comparing relocations until convergence is obtained.
   do {
@@ -482,6 +538,7 @@ template <class ELFT> void ICF<ELFT>::run() {
   } while (repeat);
 
   log("ICF needed " + Twine(cnt) + " iterations");
+  logClasses("after comparing relocation targets");
 
   // Merge sections by the equivalence class.
   forEachClassRange(0, sections.size(), [&](size_t begin, size_t end) {
@@ -0,0 +1,375 @@
+//===- Incremental.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements --incremental. With the option, lld records the layout
+// of the output and a digest of each input object file in a state file next
+// to the output file (<output>.lld-incr).
+//
+// Each allocated input section of an object file is followed by padding of a
+// quarter of its size (at least 16 bytes), and the next link reuses the
+// previous size of the section with its padding as long as the section still
+// fits. So a section may grow or shrink without moving the sections after it.
+//
+// In the next link, if every output section and every input section is at the
+// same place as before, lld updates the previous output file in place instead
+// of creating a new one. A section is not written again if its object file
+// is unchanged and every symbol the file refers to has the same address, GOT
+// and PLT entries as before. File headers and synthetic sections are always
+// rewritten.
+//
+// Layout is computed from scratch in each link, so this saves the time to
+// write and commit the output but not the time for symbol resolution or
+// relocation scanning. If a section outgrew its padding or anything else
+// moved, it falls back to a regular link.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Incremental.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "OutputSections.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
+#include "lld/Common/Version.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::ELF;
+using namespace llvm::object;
+
+using namespace lld;
+using namespace lld::elf;
+
+namespace {
+struct FileState {
+  std::string name;
+  // A digest of the contents of the file.
+  uint64_t contentDigest = 0;
+  // A digest of the addresses of everything the file refers to.
+  uint64_t referenceDigest = 0;
+  // The Nth element is the size with the padding of the Nth section, or 0 if
+  // the section is not padded.
+  std::vector<uint64_t> slotSizes;
+};
+
+struct IncrementalState {
+  uint64_t fileSize = 0;
+  int64_t mtime = 0;
+  std::string layoutDigest;
+  // The Nth element is the state of the Nth element of objectFiles.
+  std::vector<FileState> files;
+};
+} // namespace
+
+// The state of the previous link, if any, and of the current one. The current
+// state is computed before the output is written and saved after the output
+// is committed.
+static Optional<IncrementalState> previous;
+static IncrementalState current;
+
+// The sizes with padding of the input sections of the current link.
+static DenseMap<const InputSectionBase *, uint64_t> slotSizes;
+
+static std::string getStatePath() {
+  return (config->outputFile + ".lld-incr").str();
+}
+
+static std::string getStateHeader() {
+  return "lld-incremental " + getLLDVersion();
+}
+
+static int64_t getModificationTime(const sys::fs::file_status &st) {
+  return st.getLastModificationTime().time_since_epoch().count();
+}
+
+static Optional<IncrementalState> readState() {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(getStatePath());
+  if (!mbOrErr)
+    return None;
+
+  SmallVector<StringRef, 0> lines;
+  (*mbOrErr)->getBuffer().split(lines, '\n', -1, /*KeepEmpty=*/false);
+  if (lines.size() < 2 || lines[0] != getStateHeader())
+    return None;
+
+  IncrementalState state;
+  SmallVector<StringRef, 4> fields;
+  lines[1].split(fields, ' ');
+  if (fields.size() != 3 || fields[0].getAsInteger(10, state.fileSize) ||
+      fields[1].getAsInteger(10, state.mtime))
+    return None;
+  state.layoutDigest = fields[2];
+
+  // Each file is "<content digest> <reference digest> <slot sizes> <name>",
+  // where the slot sizes are separated by commas.
+  for (StringRef line : makeArrayRef(lines).slice(2)) {
+    FileState file;
+    fields.clear();
+    line.split(fields, ' ', /*MaxSplit=*/3);
+    if (fields.size() != 4 || fields[0].getAsInteger(16, file.contentDigest) ||
+        fields[1].getAsInteger(16, file.referenceDigest))
+      return None;
+    if (fields[2] != "-") {
+      SmallVector<StringRef, 0> slots;
+      fields[2].split(slots, ',');
+      for (StringRef slot : slots) {
+        uint64_t size;
+        if (slot.getAsInteger(10, size))
+          return None;
+        file.slotSizes.push_back(size);
+      }
+    }
+    file.name = fields[3];
+    state.files.push_back(std::move(file));
+  }
+  return state;
+}
+
+static void update(SHA1 &hasher, uint64_t v) {
+  uint8_t buf[8];
+  support::endian::write64le(buf, v);
+  hasher.update(buf);
+}
+
+// Returns true if padding after isec can't change the meaning of the output.
+// Sections that are concatenated into arrays or into one piece of code, and
+// the sections that may be enumerated with __start_ and __stop_ symbols, are
+// not padded.
+static bool canPad(const InputSection *isec) {
+  if (!isec->file || isec->file->kind() != InputFile::ObjKind ||
+      !(isec->flags & SHF_ALLOC) ||
+      (isec->type != SHT_PROGBITS && isec->type != SHT_NOBITS) ||
+      isec->getSize() == 0)
+    return false;
+  StringRef name = isec->name;
+  return name != ".init" && name != ".fini" && !name.startswith(".ctors") &&
+         !name.startswith(".dtors") && !isValidCIdentifier(name);
+}
+
+void elf::reserveIncrementalPadding() {
+  previous = readState();
+  for (size_t i = 0, e = objectFiles.size(); i != e; ++i) {
+    InputFile *file = objectFiles[i];
+    const FileState *prev = nullptr;
+    if (previous && i < previous->files.size() &&
+        previous->files[i].name == toString(file))
+      prev = &previous->files[i];
+
+    ArrayRef<InputSectionBase *> sections = file->getSections();
+    for (size_t j = 0, f = sections.size(); j != f; ++j) {
+      auto *isec = dyn_cast_or_null<InputSection>(sections[j]);
+      if (!isec || !isec->isLive() || !canPad(isec))
+        continue;
+      uint64_t size = isec->getSize();
+      uint64_t prevSlot =
+          prev && j < prev->slotSizes.size() ? prev->slotSizes[j] : 0;
+      slotSizes[isec] = size <= prevSlot
+                            ? prevSlot
+                            : size + std::max<uint64_t>(size / 4, 16);
+    }
+  }
+}
+
+uint64_t elf::getIncrementalSlotSize(const InputSection *isec) {
+  auto it = slotSizes.find(isec);
+  return it == slotSizes.end() ? isec->getSize() : it->second;
+}
+
+static void hashSymbol(SHA1 &hasher, Symbol &sym) {
+  update(hasher, sym.kind());
+  update(hasher, sym.isPreemptible);
+  update(hasher, sym.gotIndex);
+  update(hasher, sym.pltIndex);
+  update(hasher, sym.globalDynIndex);
+  update(hasher, sym.dynsymIndex);
+  if (auto *d = dyn_cast<Defined>(&sym)) {
+    if (!d->section || d->section->isLive()) {
+      update(hasher, d->getVA());
+      update(hasher, d->size);
+    }
+  }
+}
+
+// Computes a digest of the placement of the output sections and of the input
+// sections in them. If this is the same as in the previous link, the previous
+// output file can be updated in place.
+static std::string computeLayoutDigest(uint64_t fileSize) {
+  SHA1 hasher;
+  hasher.update(getStateHeader());
+  update(hasher, fileSize);
+
+  for (OutputSection *os : outputSections) {
+    hasher.update(os->name);
+    update(hasher, os->addr);
+    update(hasher, os->offset);
+    update(hasher, os->size);
+    update(hasher, os->type);
+    update(hasher, os->flags);
+    for (InputSection *isec : getInputSections(os)) {
+      hasher.update(isec->file ? isec->file->getName() : "");
+      hasher.update(isec->name);
+      update(hasher, isec->outSecOff);
+    }
+  }
+  return toHex(hasher.final());
+}
+
+// Computes a digest of the addresses of everything the sections of a file may
+// refer to: the symbols, including the local ones, and the pieces of the
+// mergeable sections. If this and the contents of the file are the same as in
+// the previous link, its sections are relocated to the same bytes as before.
+static uint64_t computeReferenceDigest(InputFile *file) {
+  SHA1 hasher;
+  update(hasher, file->getSymbols().size());
+  for (Symbol *sym : file->getSymbols())
+    if (sym)
+      hashSymbol(hasher, *sym);
+  for (InputSectionBase *sec : file->getSections())
+    if (auto *ms = dyn_cast_or_null<MergeInputSection>(sec))
+      if (ms->isLive())
+        for (const SectionPiece &piece : ms->pieces)
+          update(hasher, piece.outputOff);
+  return support::endian::read64le(hasher.final().data());
+}
+
+// Computes a digest of the input contents of an object file.
+template <class ELFT> static uint64_t computeFileDigest(InputFile *file) {
+  std::vector<uint64_t> v;
+  for (InputSectionBase *sec : file->getSections()) {
+    if (!sec || sec == &InputSection::discarded) {
+      v.push_back(0);
+      continue;
+    }
+    size_t relSize = sec->areRelocsRela ? sizeof(typename ELFT::Rela)
+                                        : sizeof(typename ELFT::Rel);
+    v.push_back(sec->isLive());
+    v.push_back(xxHash64(toStringRef(sec->data())));
+    v.push_back(xxHash64(
+        StringRef(static_cast<const char *>(sec->firstRelocation),
+                  sec->numRelocations * relSize)));
+  }
+  return xxHash64(StringRef(reinterpret_cast<const char *>(v.data()),
+                            v.size() * sizeof(uint64_t)));
+}
+
+template <class ELFT>
+std::unique_ptr<WriteThroughMemoryBuffer>
+elf::openPreviousOutput(uint64_t fileSize) {
+  // MIPS GOTs are built per input file, and with these options the output
+  // contains data that is not covered by the digests.
+  if (config->emachine == EM_MIPS || config->oFormatBinary ||
+      config->emitRelocs)
+    return nullptr;
+
+  current.fileSize = fileSize;
+  current.layoutDigest = computeLayoutDigest(fileSize);
+  current.files.resize(objectFiles.size());
+  parallelForEachN(0, objectFiles.size(), [&](size_t i) {
+    InputFile *file = objectFiles[i];
+    FileState &state = current.files[i];
+    state.name = toString(file);
+    state.contentDigest = computeFileDigest<ELFT>(file);
+    state.referenceDigest = computeReferenceDigest(file);
+    ArrayRef<InputSectionBase *> sections = file->getSections();
+    state.slotSizes.resize(sections.size());
+    for (size_t j = 0, e = sections.size(); j != e; ++j) {
+      auto it = slotSizes.find(sections[j]);
+      if (it != slotSizes.end())
+        state.slotSizes[j] = it->second;
+    }
+  });
+
+  if (!previous || previous->layoutDigest != current.layoutDigest ||
+      previous->files.size() != current.files.size())
+    return nullptr;
+  for (size_t i = 0, e = current.files.size(); i != e; ++i)
+    if (previous->files[i].name != current.files[i].name)
+      return nullptr;
+
+  // The output file must be the one that the previous link created.
+  sys::fs::file_status st;
+  if (sys::fs::status(config->outputFile, st) || st.getSize() != fileSize ||
+      getModificationTime(st) != previous->mtime)
+    return nullptr;
+
+  ErrorOr<std::unique_ptr<WriteThroughMemoryBuffer>> mbOrErr =
+      WriteThroughMemoryBuffer::getFile(config->outputFile, fileSize);
+  if (!mbOrErr)
+    return nullptr;
+
+  // If this link fails halfway, the output is partially updated. Remove the
+  // state file so that the next link doesn't trust it.
+  sys::fs::remove(getStatePath());
+
+  size_t numChanged = 0;
+  for (size_t i = 0, e = objectFiles.size(); i != e; ++i) {
+    const FileState &prev = previous->files[i];
+    const FileState &cur = current.files[i];
+    if (prev.contentDigest == cur.contentDigest &&
+        prev.referenceDigest == cur.referenceDigest)
+      objectFiles[i]->unchangedSinceLastLink = true;
+    else
+      ++numChanged;
+  }
+
+  log("--incremental: updating " + config->outputFile + " in place (" +
+      Twine(numChanged) + " of " + Twine(objectFiles.size()) +
+      " object files changed)");
+  return std::move(*mbOrErr);
+}
+
+void elf::writeIncrementalState() {
+  if (current.layoutDigest.empty())
+    return;
+
+  sys::fs::file_status st;
+  if (sys::fs::status(config->outputFile, st))
+    return;
+  current.mtime = getModificationTime(st);
+
+  std::string path = getStatePath();
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, sys::fs::OF_None);
+  if (ec) {
+    warn("cannot open " + path + ": " + ec.message());
+    return;
+  }
+
+  os << getStateHeader() << "\n";
+  os << current.fileSize << " " << current.mtime << " "
+     << current.layoutDigest << "\n";
+  for (const FileState &file : current.files) {
+    os << format_hex_no_prefix(file.contentDigest, 16) << " "
+       << format_hex_no_prefix(file.referenceDigest, 16) << " ";
+    if (file.slotSizes.empty())
+      os << "-";
+    for (size_t i = 0, e = file.slotSizes.size(); i != e; ++i)
+      os << (i ? "," : "") << file.slotSizes[i];
+    os << " " << file.name << "\n";
+  }
+}
+
+template std::unique_ptr<WriteThroughMemoryBuffer>
+elf::openPreviousOutput<ELF32LE>(uint64_t);
+template std::unique_ptr<WriteThroughMemoryBuffer>
+elf::openPreviousOutput<ELF32BE>(uint64_t);
+template std::unique_ptr<WriteThroughMemoryBuffer>
+elf::openPreviousOutput<ELF64LE>(uint64_t);
+template std::unique_ptr<WriteThroughMemoryBuffer>
+elf::openPreviousOutput<ELF64BE>(uint64_t);
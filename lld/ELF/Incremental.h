@@ -0,0 +1,42 @@
+//===- Incremental.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_INCREMENTAL_H
+#define LLD_ELF_INCREMENTAL_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+
+namespace lld {
+namespace elf {
+
+class InputSection;
+
+// Reads the state of the previous --incremental link and reserves padding
+// after the input sections, reusing the previous sizes where they still fit.
+// Must be called before the sections are assigned addresses.
+void reserveIncrementalPadding();
+
+// Returns the size of an input section with its padding.
+uint64_t getIncrementalSlotSize(const InputSection *isec);
+
+// If the output of the previous --incremental link can be updated in place,
+// opens it for writing and marks unchanged input files so that their
+// sections are not written again. Returns nullptr otherwise.
+template <class ELFT>
+std::unique_ptr<llvm::WriteThroughMemoryBuffer>
+openPreviousOutput(uint64_t fileSize);
+
+// Records the state of the output file for the next --incremental link.
+void writeIncrementalState();
+
+} // namespace elf
+} // namespace lld
+
+#endif
@@ -28,6 +28,7 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TarWriter.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
@@ -88,15 +89,50 @@ InputFile::InputFile(Kind k, MemoryBufferRef m)
     ++nextGroupId;
 }
 
-Optional<MemoryBufferRef> elf::readFile(StringRef path) {
+static StringRef applyChroot(StringRef path) {
   // The --chroot option changes our virtual root directory.
   // This is useful when you are dealing with files created by --reproduce.
   if (!config->chroot.empty() && path.startswith("/"))
-    path = saver.save(config->chroot + path);
+    return saver.save(config->chroot + path);
+  return path;
+}
+
+static std::unique_ptr<ThreadPool> prefetchPool;
+static StringMap<std::future<ErrorOr<std::unique_ptr<MemoryBuffer>>>>
+    prefetched;
+
+void elf::prefetchFiles(ArrayRef<std::string> paths) {
+  if (!prefetchPool)
+    prefetchPool = std::make_unique<ThreadPool>();
+
+  // Drop files that a previous link prefetched but never used, because
+  // they may have changed since.
+  prefetched.clear();
+
+  std::vector<std::string> v;
+  for (const std::string &path : paths)
+    v.push_back(applyChroot(path));
 
+  auto futures = MemoryBuffer::getFilesAsync(*prefetchPool, v,
+                                             /*RequiresNullTerminator=*/false);
+  for (size_t i = 0, e = v.size(); i != e; ++i)
+    prefetched[v[i]] = std::move(futures[i]);
+}
+
+static ErrorOr<std::unique_ptr<MemoryBuffer>> openFile(StringRef path) {
+  auto it = prefetched.find(path);
+  if (it == prefetched.end())
+    return MemoryBuffer::getFile(path, -1, false);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr = it->second.get();
+  prefetched.erase(it);
+  return mbOrErr;
+}
+
+Optional<MemoryBufferRef> elf::readFile(StringRef path) {
+  path = applyChroot(path);
   log(path);
 
-  auto mbOrErr = MemoryBuffer::getFile(path, -1, false);
+  auto mbOrErr = openFile(path);
   if (auto ec = mbOrErr.getError()) {
     error("cannot open " + path + ": " + ec.message());
     return None;
@@ -1044,6 +1080,24 @@ StringRef ObjFile<ELFT>::getSectionName(const Elf_Shdr &sec) {
   return CHECK(getObj().getSectionName(&sec, sectionStringTable), this);
 }
 
+template <class ELFT> void ObjFile<ELFT>::computeSymbolKeys() {
+  ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
+  if (eSyms.empty())
+    return;
+
+  symbolKeys.reserve(eSyms.size() - this->firstGlobal);
+  for (const Elf_Sym &eSym : eSyms.slice(this->firstGlobal)) {
+    Expected<StringRef> name = eSym.getName(this->stringTable);
+    // Leave malformed symbol tables to initializeSymbols() to report.
+    if (!name) {
+      consumeError(name.takeError());
+      symbolKeys.clear();
+      return;
+    }
+    symbolKeys.push_back(SymbolTable::getKey(*name));
+  }
+}
+
 // Initialize this->Symbols. this->Symbols is a parallel array as
 // its corresponding ELF symbol table.
 template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
@@ -1052,10 +1106,16 @@ template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
 
   // Our symbol table may have already been partially initialized
   // because of LazyObjFile.
-  for (size_t i = 0, end = eSyms.size(); i != end; ++i)
-    if (!this->symbols[i] && eSyms[i].getBinding() != STB_LOCAL)
+  for (size_t i = 0, end = eSyms.size(); i != end; ++i) {
+    if (this->symbols[i] || eSyms[i].getBinding() == STB_LOCAL)
+      continue;
+    if (!symbolKeys.empty() && i >= this->firstGlobal)
+      this->symbols[i] = symtab->insert(symbolKeys[i - this->firstGlobal]);
+    else
       this->symbols[i] =
           symtab->insert(CHECK(eSyms[i].getName(this->stringTable), this));
+  }
+  symbolKeys = {};
 
   // Fill this->Symbols. A symbol is either local or global.
   for (size_t i = 0, end = eSyms.size(); i != end; ++i) {
@@ -1566,6 +1626,12 @@ void LazyObjFile::fetch() {
 template <class ELFT> void LazyObjFile::parse() {
   using Elf_Sym = typename ELFT::Sym;
 
+  if (symbolsFromCache) {
+    for (StringRef name : definedSymbols)
+      symtab->addSymbol(LazyObject{*this, name});
+    return;
+  }
+
   // A lazy object file wraps either a bitcode file or an ELF file.
   if (isBitcode(this->mb)) {
     std::unique_ptr<lto::InputFile> obj =
@@ -1573,7 +1639,10 @@ template <class ELFT> void LazyObjFile::parse() {
     for (const lto::InputFile::Symbol &sym : obj->symbols()) {
       if (sym.isUndefined())
         continue;
-      symtab->addSymbol(LazyObject{*this, saver.save(sym.getName())});
+      StringRef name = saver.save(sym.getName());
+      if (recordSymbols)
+        definedSymbols.push_back(name);
+      symtab->addSymbol(LazyObject{*this, name});
     }
     return;
   }
@@ -54,6 +54,10 @@ extern std::unique_ptr<llvm::TarWriter> tar;
 // Opens a given file.
 llvm::Optional<MemoryBufferRef> readFile(StringRef path);
 
+// Starts reading the given files in the background. A later readFile() of
+// one of these paths waits for and uses the result.
+void prefetchFiles(ArrayRef<std::string> paths);
+
 // Add symbols in File to the symbol table.
 void parseFile(InputFile *file);
 
@@ -117,6 +121,10 @@ public:
   // True if this is an argument for --just-symbols. Usually false.
   bool justSymbols = false;
 
+  // True if --incremental found that this file has not changed since the
+  // previous link, so its sections are already in the output file.
+  bool unchangedSinceLastLink = false;
+
   // outSecOff of .got2 in the current file. This is used by PPC32 -fPIC/-fPIE
   // to compute offsets in PLT call stubs.
   uint32_t ppc32Got2OutSecOff = 0;
@@ -207,6 +215,10 @@ public:
 
   void parse(bool ignoreComdats = false);
 
+  // Computes symbol table keys of global symbols ahead of parse(). This does
+  // not touch any global state, so it can run for many files in parallel.
+  void computeSymbolKeys();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -280,6 +292,10 @@ private:
   // .shstrtab contents.
   StringRef sectionStringTable;
 
+  // Symbol table keys of global symbols computed by computeSymbolKeys().
+  // The Nth element corresponds to the (firstGlobal + N)th ELF symbol.
+  std::vector<llvm::CachedHashStringRef> symbolKeys;
+
   // Debugging information to retrieve source file and line for error
   // reporting. Linker may find reasonable number of errors in a
   // single object file, so we cache debugging information in order to
@@ -315,6 +331,13 @@ public:
   template <class ELFT> void parse();
   void fetch();
 
+  // Names of the symbols defined by this file, used for --archive-cache-dir.
+  // If symbolsFromCache is true, they were read from the cache and parse()
+  // doesn't read the file. If recordSymbols is true, parse() fills them.
+  std::vector<StringRef> definedSymbols;
+  bool symbolsFromCache = false;
+  bool recordSymbols = false;
+
 private:
   uint64_t offsetInArchive;
 };
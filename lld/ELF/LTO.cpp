@@ -31,6 +31,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 #include <algorithm>
 #include <cstddef>
 #include <memory>
@@ -105,6 +106,7 @@ static lto::Config createConfig() {
 
   c.SampleProfile = config->ltoSampleProfile;
   c.UseNewPM = config->ltoNewPassManager;
+  c.ParallelFunctionPasses = config->ltoParallelFunctionPasses;
   c.DebugPassManager = config->ltoDebugPassManager;
   c.DwoDir = config->dwoDir;
 
@@ -136,7 +138,9 @@ BitcodeCompiler::BitcodeCompiler() {
     auto onIndexWrite = [&](StringRef s) { thinIndices.erase(s); };
     backend = lto::createWriteIndexesThinBackend(
         config->thinLTOPrefixReplace.first, config->thinLTOPrefixReplace.second,
-        config->thinLTOEmitImportsFiles, indexFile.get(), onIndexWrite);
+        config->thinLTOEmitImportsFiles, indexFile.get(), onIndexWrite,
+        config->thinLTOJobs != -1U ? config->thinLTOJobs
+                                   : llvm::heavyweight_hardware_concurrency());
   } else if (config->thinLTOJobs != -1U) {
     backend = lto::createInProcessThinBackend(config->thinLTOJobs);
   }
@@ -240,13 +244,16 @@ std::vector<InputFile *> BitcodeCompiler::compile() {
   // The --thinlto-cache-dir option specifies the path to a directory in which
   // to cache native object files for ThinLTO incremental builds. If a path was
   // specified, configure LTO to use it as the cache directory.
+  // --thinlto-shared-cache-dir adds a second level of cache, typically on a
+  // network file system, which is shared by the links on many machines.
   lto::NativeObjectCache cache;
   if (!config->thinLTOCacheDir.empty())
     cache = check(
         lto::localCache(config->thinLTOCacheDir,
                         [&](size_t task, std::unique_ptr<MemoryBuffer> mb) {
                           files[task] = std::move(mb);
-                        }));
+                        },
+                        config->thinLTOSharedCacheDir));
 
   if (!bitcodeFiles.empty())
     checkError(ltoObj->run(
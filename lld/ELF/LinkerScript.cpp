@@ -12,6 +12,7 @@
 
 #include "LinkerScript.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "InputSection.h"
 #include "OutputSections.h"
 #include "SymbolTable.h"
@@ -700,8 +701,10 @@ uint64_t LinkerScript::advance(uint64_t size, unsigned alignment) {
 void LinkerScript::output(InputSection *s) {
   assert(ctx->outSec == s->getParent());
   uint64_t before = advance(0, 1);
-  uint64_t pos = advance(s->getSize(), s->alignment);
-  s->outSecOff = pos - s->getSize() - ctx->outSec->addr;
+  uint64_t size =
+      config->incremental ? getIncrementalSlotSize(s) : s->getSize();
+  uint64_t pos = advance(size, s->alignment);
+  s->outSecOff = pos - size - ctx->outSec->addr;
 
   // Update output section size after adding each section. This is so that
   // SIZEOF works correctly in the case below:
@@ -191,11 +191,45 @@ template <class ELFT> void OutputSection::maybeCompress() {
   hdr->ch_size = size;
   hdr->ch_addralign = alignment;
 
-  // Write section contents to a temporary buffer and compress it.
+  // Write section contents to a temporary buffer.
   std::vector<uint8_t> buf(size);
   writeTo<ELFT>(buf.data());
-  if (Error e = zlib::compress(toStringRef(buf), compressedData))
-    fatal("compress failed: " + llvm::toString(std::move(e)));
+
+  // Split the contents into shards and compress them in parallel. Each shard
+  // is compressed into a raw deflate stream that ends with a sync flush (the
+  // last one with a final block), so that their concatenation, preceded by a
+  // zlib header and followed by the combined Adler-32 checksum, is a valid
+  // zlib stream.
+  const size_t shardSize = 1 << 20;
+  StringRef in = toStringRef(buf);
+  size_t numShards =
+      std::max<size_t>(1, (in.size() + shardSize - 1) / shardSize);
+  std::vector<SmallVector<char, 0>> shards(numShards);
+  std::vector<uint32_t> checksums(numShards);
+  parallelForEachN(0, numShards, [&](size_t i) {
+    StringRef shard = in.substr(i * shardSize, shardSize);
+    if (Error e = zlib::compressRaw(shard, shards[i], zlib::DefaultCompression,
+                                    /*IsLast=*/i == numShards - 1))
+      fatal("compress failed: " + llvm::toString(std::move(e)));
+    checksums[i] = zlib::adler32(shard);
+  });
+
+  // Concatenate the shards. 0x78 0x9c is the zlib header for the deflate
+  // method with a 32 KiB window and the default compression level.
+  size_t compressedSize = 6;
+  for (const SmallVector<char, 0> &shard : shards)
+    compressedSize += shard.size();
+  compressedData.reserve(compressedSize);
+  compressedData.push_back(0x78);
+  compressedData.push_back(0x9c);
+  uint32_t checksum = zlib::adler32("");
+  for (size_t i = 0; i != numShards; ++i) {
+    compressedData.append(shards[i].begin(), shards[i].end());
+    checksum = zlib::adler32Combine(
+        checksum, checksums[i], std::min(shardSize, in.size() - i * shardSize));
+  }
+  compressedData.resize(compressedData.size() + 4);
+  write32be(compressedData.end() - 4, checksum);
 
   // Update section headers.
   size = sizeof(Elf_Chdr) + compressedData.size();
@@ -238,10 +272,13 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
 
   parallelForEachN(0, sections.size(), [&](size_t i) {
     InputSection *isec = sections[i];
-    isec->writeTo<ELFT>(buf);
+    bool rewrite = !isec->file || !isec->file->unchangedSinceLastLink;
+    if (rewrite)
+      isec->writeTo<ELFT>(buf);
 
-    // Fill gaps between sections.
-    if (nonZeroFiller) {
+    // Fill gaps between sections. With --incremental, the gap after a section
+    // that shrank may hold stale bytes of the previous output.
+    if (nonZeroFiller || (config->incremental && rewrite)) {
       uint8_t *start = buf + isec->outSecOff + isec->getSize();
       uint8_t *end;
       if (i + 1 == sections.size())
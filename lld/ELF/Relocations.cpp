@@ -52,6 +52,7 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/raw_ostream.h"
@@ -1081,9 +1082,23 @@ static void processRelocAux(InputSectionBase &sec, RelExpr expr, RelType type,
               getLocation(sec, sym, offset));
 }
 
+namespace {
+// The part of a relocation scan that does not depend on the state mutated by
+// the scan itself (GOT/PLT entries, symbol kinds, dynamic relocations). It is
+// computed for many sections in parallel and consumed by the serial scan.
+struct PreScannedReloc {
+  uint64_t offset;
+  int64_t addend;
+  RelExpr expr;
+  // False if the target symbol may be reported as undefined. In that case
+  // the expression and the addend are computed by the serial scan.
+  bool hasExpr;
+};
+} // namespace
+
 template <class ELFT, class RelTy>
 static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
-                      RelTy *end) {
+                      RelTy *end, const PreScannedReloc *pre) {
   const RelTy &rel = *i;
   uint32_t symIndex = rel.getSymbol(config->isMips64EL);
   Symbol &sym = sec.getFile<ELFT>()->getSymbol(symIndex);
@@ -1098,7 +1113,7 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
   }
 
   // Get an offset in an output section this relocation is applied to.
-  uint64_t offset = getOffset.get(rel.r_offset);
+  uint64_t offset = pre ? pre->offset : getOffset.get(rel.r_offset);
   if (offset == uint64_t(-1))
     return;
 
@@ -1108,7 +1123,9 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
     return;
 
   const uint8_t *relocatedAddr = sec.data().begin() + rel.r_offset;
-  RelExpr expr = target->getRelExpr(type, sym, relocatedAddr);
+  RelExpr expr = (pre && pre->hasExpr)
+                     ? pre->expr
+                     : target->getRelExpr(type, sym, relocatedAddr);
 
   // Ignore "hint" relocations because they are only markers for relaxation.
   if (oneof<R_HINT, R_NONE>(expr))
@@ -1136,7 +1153,9 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
   }
 
   // Read an addend.
-  int64_t addend = computeAddend<ELFT>(rel, end, sec, expr, sym.isLocal());
+  int64_t addend = (pre && pre->hasExpr)
+                       ? pre->addend
+                       : computeAddend<ELFT>(rel, end, sec, expr, sym.isLocal());
 
   // Relax relocations.
   //
@@ -1305,14 +1324,16 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
 }
 
 template <class ELFT, class RelTy>
-static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
+static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                       ArrayRef<PreScannedReloc> pre) {
   OffsetGetter getOffset(sec);
 
   // Not all relocations end up in Sec.Relocations, but a lot do.
   sec.relocations.reserve(rels.size());
 
   for (auto i = rels.begin(), end = rels.end(); i != end;)
-    scanReloc<ELFT>(sec, getOffset, i, end);
+    scanReloc<ELFT>(sec, getOffset, i, end,
+                    pre.empty() ? nullptr : &pre[i - rels.begin()]);
 
   // Sort relocations by offset for more efficient searching for
   // R_RISCV_PCREL_HI20 and R_PPC64_ADDR64.
@@ -1326,9 +1347,89 @@ static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
 
 template <class ELFT> void elf::scanRelocations(InputSectionBase &s) {
   if (s.areRelocsRela)
-    scanRelocs<ELFT>(s, s.relas<ELFT>());
+    scanRelocs<ELFT>(s, s.relas<ELFT>(), {});
   else
-    scanRelocs<ELFT>(s, s.rels<ELFT>());
+    scanRelocs<ELFT>(s, s.rels<ELFT>(), {});
+}
+
+// Decodes relocations of a section without touching any state other than
+// the section itself, so that this can run for many sections in parallel.
+template <class ELFT, class RelTy>
+static void preScanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                          MutableArrayRef<PreScannedReloc> out) {
+  OffsetGetter getOffset(sec);
+  const uint8_t *buf = sec.data().data();
+
+  for (size_t i = 0, e = rels.size(); i != e; ++i) {
+    const RelTy &rel = rels[i];
+    PreScannedReloc &pre = out[i];
+    pre.hasExpr = false;
+    pre.offset = getOffset.get(rel.r_offset);
+    if (pre.offset == uint64_t(-1))
+      continue;
+
+    // Whether an undefined symbol is reported depends on the order in which
+    // relocations are visited, so leave such relocations to the serial scan.
+    uint32_t symIndex = rel.getSymbol(config->isMips64EL);
+    Symbol &sym = sec.getFile<ELFT>()->getSymbol(symIndex);
+    if (symIndex != 0 && sym.isUndefined() && !sym.isWeak())
+      continue;
+
+    RelType type = rel.getType(config->isMips64EL);
+    pre.expr = target->getRelExpr(type, sym, buf + rel.r_offset);
+    pre.addend = oneof<R_HINT, R_NONE>(pre.expr)
+                     ? 0
+                     : computeAddend<ELFT>(rel, rels.end(), sec, pre.expr,
+                                           sym.isLocal());
+    pre.hasExpr = true;
+  }
+}
+
+template <class ELFT>
+void elf::scanRelocations(ArrayRef<InputSectionBase *> sections) {
+  // MIPS computes addends from paired relocations and the N32 ABI combines
+  // consecutive relocation records, so MIPS always uses the serial scan.
+  if (!threadsEnabled || config->emachine == EM_MIPS) {
+    for (InputSectionBase *sec : sections)
+      scanRelocations<ELFT>(*sec);
+    return;
+  }
+
+  // Sections are processed in batches to bound the memory used to hold
+  // decoded relocations. Within a batch, relocations are decoded in parallel
+  // and then applied in the original order, which keeps GOT, PLT and dynamic
+  // relocation layouts identical to the serial scan.
+  const size_t maxBatchRelocs = 1 << 20;
+  std::vector<std::vector<PreScannedReloc>> pre;
+
+  for (size_t begin = 0, e = sections.size(); begin != e;) {
+    size_t end = begin;
+    size_t numRelocs = 0;
+    while (end != e && (end == begin || numRelocs < maxBatchRelocs))
+      numRelocs += sections[end++]->numRelocations;
+
+    if (pre.size() < end - begin)
+      pre.resize(end - begin);
+
+    parallelForEachN(begin, end, [&](size_t i) {
+      InputSectionBase &sec = *sections[i];
+      std::vector<PreScannedReloc> &v = pre[i - begin];
+      v.resize(sec.numRelocations);
+      if (sec.areRelocsRela)
+        preScanRelocs<ELFT>(sec, sec.relas<ELFT>(), v);
+      else
+        preScanRelocs<ELFT>(sec, sec.rels<ELFT>(), v);
+    });
+
+    for (size_t i = begin; i != end; ++i) {
+      InputSectionBase &sec = *sections[i];
+      if (sec.areRelocsRela)
+        scanRelocs<ELFT>(sec, sec.relas<ELFT>(), pre[i - begin]);
+      else
+        scanRelocs<ELFT>(sec, sec.rels<ELFT>(), pre[i - begin]);
+    }
+    begin = end;
+  }
 }
 
 static bool mergeCmp(const InputSection *a, const InputSection *b) {
@@ -1760,6 +1861,10 @@ template void elf::scanRelocations<ELF32LE>(InputSectionBase &);
 template void elf::scanRelocations<ELF32BE>(InputSectionBase &);
 template void elf::scanRelocations<ELF64LE>(InputSectionBase &);
 template void elf::scanRelocations<ELF64BE>(InputSectionBase &);
+template void elf::scanRelocations<ELF32LE>(ArrayRef<InputSectionBase *>);
+template void elf::scanRelocations<ELF32BE>(ArrayRef<InputSectionBase *>);
+template void elf::scanRelocations<ELF64LE>(ArrayRef<InputSectionBase *>);
+template void elf::scanRelocations<ELF64BE>(ArrayRef<InputSectionBase *>);
 template void elf::reportUndefinedSymbols<ELF32LE>();
 template void elf::reportUndefinedSymbols<ELF32BE>();
 template void elf::reportUndefinedSymbols<ELF64LE>();
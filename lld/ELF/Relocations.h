@@ -113,6 +113,13 @@ struct Relocation {
 // the diagnostics.
 template <class ELFT> void scanRelocations(InputSectionBase &);
 
+// Scans relocations of all given sections. If threads are enabled, relocation
+// records are decoded concurrently and the results are then applied serially
+// in the given order, so the output is identical to calling
+// scanRelocations() for each section.
+template <class ELFT>
+void scanRelocations(ArrayRef<InputSectionBase *> sections);
+
 template <class ELFT> void reportUndefinedSymbols();
 
 void addIRelativeRelocs();
@@ -41,7 +41,12 @@ public:
         fn(sym);
   }
 
-  Symbol *insert(StringRef name);
+  // Returns the key under which a symbol with a given name is stored.
+  // This is thread-safe, so keys can be computed ahead of insert().
+  static llvm::CachedHashStringRef getKey(StringRef name);
+
+  Symbol *insert(StringRef name) { return insert(getKey(name)); }
+  Symbol *insert(llvm::CachedHashStringRef key);
 
   Symbol *addSymbol(const Symbol &newSym);
 
@@ -36,6 +36,7 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <cstdlib>
 #include <thread>
 
@@ -2303,7 +2304,7 @@ void GnuHashTableSection::addSymbols(std::vector<SymbolTableEntry> &v) {
     symbols.push_back({b, ent.strTabOffset, hash, bucketIdx});
   }
 
-  llvm::stable_sort(symbols, [](const Entry &l, const Entry &r) {
+  parallelStableSort(symbols, [](const Entry &l, const Entry &r) {
     return l.bucketIdx < r.bucketIdx;
   });
 
@@ -2533,11 +2534,22 @@ readPubNamesAndTypes(const LLDDwarfObj<ELFT> &obj,
   return ret;
 }
 
+// The number of shards to split .gdb_index symbols into by name hash. Each
+// shard is uniquified by a single thread.
+static const size_t numGdbShards = 32;
+
+static size_t getGdbShardId(CachedHashStringRef name) {
+  return name.hash() >> (32 - countTrailingZeros(numGdbShards));
+}
+
 // Create a list of symbols from a given list of symbol names and types
-// by uniquifying them by name.
-static std::vector<GdbIndexSection::GdbSymbol>
-createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> nameAttrs,
-              const std::vector<GdbIndexSection::GdbChunk> &chunks) {
+// by uniquifying them by name. nameAttrs[shardId][i] contains the names of
+// the i-th chunk that belong to the shard. They are freed as they are
+// consumed to reduce peak memory usage.
+static std::vector<GdbIndexSection::GdbSymbol> createSymbols(
+    MutableArrayRef<std::vector<std::vector<GdbIndexSection::NameAttrEntry>>>
+        nameAttrs,
+    const std::vector<GdbIndexSection::GdbChunk> &chunks) {
   using GdbSymbol = GdbIndexSection::GdbSymbol;
   using NameAttrEntry = GdbIndexSection::NameAttrEntry;
 
@@ -2551,39 +2563,32 @@ createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> nameAttrs,
 
   // The number of symbols we will handle in this function is of the order
   // of millions for very large executables, so we use multi-threading to
-  // speed it up.
-  size_t numShards = 32;
-  size_t concurrency = 1;
-  if (threadsEnabled)
-    concurrency =
-        std::min<size_t>(PowerOf2Floor(hardware_concurrency()), numShards);
-
-  // A sharded map to uniquify symbols by name.
-  std::vector<DenseMap<CachedHashStringRef, size_t>> map(numShards);
-  size_t shift = 32 - countTrailingZeros(numShards);
-
-  // Instantiate GdbSymbols while uniqufying them by name.
-  std::vector<std::vector<GdbSymbol>> symbols(numShards);
-  parallelForEachN(0, concurrency, [&](size_t threadId) {
-    uint32_t i = 0;
-    for (ArrayRef<NameAttrEntry> entries : nameAttrs) {
+  // speed it up. Names were already distributed to shards, so each thread
+  // only visits the names of its own shard.
+  std::vector<std::vector<GdbSymbol>> symbols(numGdbShards);
+  parallelForEachN(0, numGdbShards, [&](size_t shardId) {
+    // A map to uniquify symbols by name.
+    DenseMap<CachedHashStringRef, size_t> map;
+    std::vector<GdbSymbol> &syms = symbols[shardId];
+
+    for (size_t i = 0, e = chunks.size(); i != e; ++i) {
+      std::vector<NameAttrEntry> entries = std::move(nameAttrs[shardId][i]);
       for (const NameAttrEntry &ent : entries) {
-        size_t shardId = ent.name.hash() >> shift;
-        if ((shardId & (concurrency - 1)) != threadId)
-          continue;
-
         uint32_t v = ent.cuIndexAndAttrs + cuIdxs[i];
-        size_t &idx = map[shardId][ent.name];
+        size_t &idx = map[ent.name];
         if (idx) {
-          symbols[shardId][idx - 1].cuVector.push_back(v);
+          syms[idx - 1].cuVector.push_back(v);
           continue;
         }
 
-        idx = symbols[shardId].size() + 1;
-        symbols[shardId].push_back({ent.name, {v}, 0, 0});
+        idx = syms.size() + 1;
+        syms.push_back({ent.name, {v}, 0, 0});
       }
-      ++i;
     }
+
+    // The names of the shard are merged; release what is left of its lists
+    // rather than keeping them until the section is created.
+    std::vector<std::vector<NameAttrEntry>>().swap(nameAttrs[shardId]);
   });
 
   size_t numSymbols = 0;
@@ -2591,12 +2596,14 @@ createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> nameAttrs,
     numSymbols += v.size();
 
   // The return type is a flattened vector, so we'll copy each vector
-  // contents to Ret.
+  // contents to Ret. Each shard is freed as soon as it is copied.
   std::vector<GdbSymbol> ret;
   ret.reserve(numSymbols);
-  for (std::vector<GdbSymbol> &vec : symbols)
+  for (std::vector<GdbSymbol> &v : symbols) {
+    std::vector<GdbSymbol> vec = std::move(v);
     for (GdbSymbol &sym : vec)
       ret.push_back(std::move(sym));
+  }
 
   // CU vectors and symbol names are adjacent in the output file.
   // We can compute their offsets in the output file now.
@@ -2615,6 +2622,7 @@ createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> nameAttrs,
 
 // Returns a newly-created .gdb_index section.
 template <class ELFT> GdbIndexSection *GdbIndexSection::create() {
+  llvm::TimeTraceScope timeScope("Create gdb index", StringRef(""));
   std::vector<InputSection *> sections = getDebugInfoSections();
 
   // .debug_gnu_pub{names,types} are useless in executables.
@@ -2625,23 +2633,34 @@ template <class ELFT> GdbIndexSection *GdbIndexSection::create() {
       s->markDead();
 
   std::vector<GdbChunk> chunks(sections.size());
-  std::vector<std::vector<NameAttrEntry>> nameAttrs(sections.size());
-
-  parallelForEachN(0, sections.size(), [&](size_t i) {
-    ObjFile<ELFT> *file = sections[i]->getFile<ELFT>();
-    DWARFContext dwarf(std::make_unique<LLDDwarfObj<ELFT>>(file));
-
-    chunks[i].sec = sections[i];
-    chunks[i].compilationUnits = readCuList(dwarf);
-    chunks[i].addressAreas = readAddressAreas(dwarf, sections[i]);
-    nameAttrs[i] = readPubNamesAndTypes<ELFT>(
-        static_cast<const LLDDwarfObj<ELFT> &>(dwarf.getDWARFObj()),
-        chunks[i].compilationUnits);
-  });
+  std::vector<std::vector<std::vector<NameAttrEntry>>> nameAttrs(
+      numGdbShards, std::vector<std::vector<NameAttrEntry>>(sections.size()));
+
+  {
+    llvm::TimeTraceScope timeScope("Read debug info", StringRef(""));
+    parallelForEachN(0, sections.size(), [&](size_t i) {
+      ObjFile<ELFT> *file = sections[i]->getFile<ELFT>();
+      DWARFContext dwarf(std::make_unique<LLDDwarfObj<ELFT>>(file));
+
+      chunks[i].sec = sections[i];
+      chunks[i].compilationUnits = readCuList(dwarf);
+      chunks[i].addressAreas = readAddressAreas(dwarf, sections[i]);
+
+      // Distribute the names to shards so that createSymbols doesn't need
+      // to visit every name in every thread.
+      for (const NameAttrEntry &ent : readPubNamesAndTypes<ELFT>(
+               static_cast<const LLDDwarfObj<ELFT> &>(dwarf.getDWARFObj()),
+               chunks[i].compilationUnits))
+        nameAttrs[getGdbShardId(ent.name)][i].push_back(ent);
+    });
+  }
 
   auto *ret = make<GdbIndexSection>();
   ret->chunks = std::move(chunks);
-  ret->symbols = createSymbols(nameAttrs, ret->chunks);
+  {
+    llvm::TimeTraceScope timeScope("Create gdb index symbols", StringRef(""));
+    ret->symbols = createSymbols(nameAttrs, ret->chunks);
+  }
   ret->initOutputSize();
   return ret;
 }
@@ -10,6 +10,7 @@
 #include "AArch64ErrataFix.h"
 #include "CallGraphSort.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "LinkerScript.h"
 #include "MapFile.h"
 #include "OutputSections.h"
@@ -26,6 +27,7 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/RandomNumberGenerator.h"
 #include "llvm/Support/SHA1.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 #include <climits>
 
@@ -571,11 +573,19 @@ template <class ELFT> void Writer<ELFT>::run() {
   if (config->copyRelocs)
     addSectionSymbols();
 
+  // With --incremental, input sections are followed by padding so that they
+  // can grow in the next link without moving other sections.
+  if (config->incremental)
+    reserveIncrementalPadding();
+
   // Now that we have a complete set of output sections. This function
   // completes section contents. For example, we need to add strings
   // to the string table, and add entries to .got and .plt.
   // finalizeSections does that.
-  finalizeSections();
+  {
+    llvm::TimeTraceScope timeScope("Finalize sections", StringRef(""));
+    finalizeSections();
+  }
   checkExecuteOnly();
   if (errorCount())
     return;
@@ -585,8 +595,11 @@ template <class ELFT> void Writer<ELFT>::run() {
   // If -compressed-debug-sections is specified, we need to compress
   // .debug_* sections. Do it right now because it changes the size of
   // output sections.
-  for (OutputSection *sec : outputSections)
-    sec->maybeCompress<ELFT>();
+  {
+    llvm::TimeTraceScope timeScope("Compress debug sections", StringRef(""));
+    for (OutputSection *sec : outputSections)
+      sec->maybeCompress<ELFT>();
+  }
 
   script->allocateHeaders(mainPart->phdrs);
 
@@ -614,17 +627,29 @@ template <class ELFT> void Writer<ELFT>::run() {
   // It does not make sense try to open the file if we have error already.
   if (errorCount())
     return;
-  // Write the result down to a file.
-  openFile();
+
+  // Write the result down to a file. With --incremental, the output of the
+  // previous link may be updated in place instead.
+  std::unique_ptr<WriteThroughMemoryBuffer> prevOutput;
+  if (config->incremental)
+    prevOutput = openPreviousOutput<ELFT>(fileSize);
+  if (prevOutput)
+    Out::bufferStart =
+        reinterpret_cast<uint8_t *>(prevOutput->getBufferStart());
+  else
+    openFile();
   if (errorCount())
     return;
 
-  if (!config->oFormatBinary) {
-    writeTrapInstr();
-    writeHeader();
-    writeSections();
-  } else {
-    writeSectionsBinary();
+  {
+    llvm::TimeTraceScope timeScope("Write sections", StringRef(""));
+    if (!config->oFormatBinary) {
+      writeTrapInstr();
+      writeHeader();
+      writeSections();
+    } else {
+      writeSectionsBinary();
+    }
   }
 
   // Backfill .note.gnu.build-id section content. This is done at last
@@ -639,8 +664,16 @@ template <class ELFT> void Writer<ELFT>::run() {
   if (errorCount())
     return;
 
-  if (auto e = buffer->commit())
-    error("failed to write to the output file: " + toString(std::move(e)));
+  {
+    llvm::TimeTraceScope timeScope("Commit output file", StringRef(""));
+    if (prevOutput)
+      prevOutput.reset();
+    else if (auto e = buffer->commit())
+      error("failed to write to the output file: " + toString(std::move(e)));
+  }
+
+  if (config->incremental && !errorCount())
+    writeIncrementalState();
 }
 
 static bool shouldKeepInSymtab(const Defined &sym) {
@@ -1370,6 +1403,29 @@ static void sortSection(OutputSection *sec,
   if (name == ".init" || name == ".fini")
     return;
 
+  // This is for -z group-text-section-prefix. Without a linker script, input
+  // sections with the prefixes that -z keep-text-section-prefix would move to
+  // separate output sections are grouped at the start of .text instead, in
+  // the order of GNU ld's default linker script. Cold code such as split
+  // functions then doesn't share pages with hot code.
+  if (config->zGroupTextSectionPrefix && name == ".text" &&
+      !script->hasSectionsCommand) {
+    auto getRank = [](const InputSection *isec) {
+      StringRef prefixes[] = {".text.unlikely.", ".text.exit.",
+                              ".text.startup.", ".text.hot."};
+      for (size_t i = 0; i != array_lengthof(prefixes); ++i)
+        if (isSectionPrefix(prefixes[i], isec->name))
+          return i;
+      return array_lengthof(prefixes);
+    };
+    for (BaseCommand *b : sec->sectionCommands)
+      if (auto *isd = dyn_cast<InputSectionDescription>(b))
+        llvm::stable_sort(isd->sections,
+                          [&](const InputSection *a, const InputSection *b) {
+                            return getRank(a) < getRank(b);
+                          });
+  }
+
   // .toc is allocated just after .got and is accessed using GOT-relative
   // relocations. Object files compiled with small code model have an
   // addressable range of [.got, .got + 0xFFFC] for GOT-relative relocations.
@@ -1734,7 +1790,10 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
   // Scan relocations. This must be done after every symbol is declared so that
   // we can correctly decide if a dynamic relocation is needed.
   if (!config->relocatable) {
-    forEachRelSec(scanRelocations<ELFT>);
+    std::vector<InputSectionBase *> relSecs;
+    llvm::TimeTraceScope timeScope("Scan relocations", StringRef(""));
+    forEachRelSec([&](InputSectionBase &sec) { relSecs.push_back(&sec); });
+    scanRelocations<ELFT>(relSecs);
     reportUndefinedSymbols<ELFT>();
   }
 
@@ -1921,7 +1980,11 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
   // 3) Assign the final values for the linker script symbols. Linker scripts
   //    sometimes using forward symbol declarations. We want to set the correct
   //    values. They also might change after adding the thunks.
-  finalizeAddressDependentContent();
+  {
+    llvm::TimeTraceScope timeScope("Finalize address dependent content",
+                                   StringRef(""));
+    finalizeAddressDependentContent();
+  }
 
   // finalizeAddressDependentContent may have added local symbols to the static symbol table.
   finalizeSynthetic(in.symTab);
@@ -2575,7 +2638,9 @@ template <class ELFT> void Writer<ELFT>::openFile() {
   unlinkAsync(config->outputFile);
   unsigned flags = 0;
   if (!config->relocatable)
-    flags = FileOutputBuffer::F_executable;
+    flags |= FileOutputBuffer::F_executable;
+  if (!config->mmapOutputFile)
+    flags |= FileOutputBuffer::F_no_mmap;
   Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
       FileOutputBuffer::create(config->outputFile, fileSize, flags);
 
@@ -2697,7 +2762,7 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
   switch (config->buildId) {
   case BuildIdKind::Fast:
     computeHash(buildId, buf, [](uint8_t *dest, ArrayRef<uint8_t> arr) {
-      write64le(dest, xxHash64(arr));
+      write64le(dest, xxh3_64bits(arr));
     });
     break;
   case BuildIdKind::Md5:
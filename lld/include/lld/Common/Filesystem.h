@@ -15,6 +15,7 @@
 namespace lld {
 void unlinkAsync(StringRef path);
 std::error_code tryCreateFile(StringRef path);
+bool isOnLocalFilesystem(StringRef path);
 } // namespace lld
 
 #endif
@@ -23,6 +23,7 @@
 
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/StringSaver.h"
+#include "llvm/Support/TypeName.h"
 #include <vector>
 
 namespace lld {
@@ -33,17 +34,39 @@ extern llvm::StringSaver saver;
 
 void freeArena();
 
+// Back all arenas, including ones created later, with huge pages, until the
+// next freeArena().
+void enableHugePageArenas();
+
 // These two classes are hack to keep track of all
 // SpecificBumpPtrAllocator instances.
 struct SpecificAllocBase {
   SpecificAllocBase() { instances.push_back(this); }
   virtual ~SpecificAllocBase() = default;
   virtual void reset() = 0;
+  virtual void enableHugePages() = 0;
+  virtual void disableHugePages() = 0;
   static std::vector<SpecificAllocBase *> instances;
+  static bool hugePages;
 };
 
 template <class T> struct SpecificAlloc : public SpecificAllocBase {
+  SpecificAlloc() {
+    setName();
+    if (hugePages)
+      alloc.enableHugePages();
+  }
   void reset() override { alloc.DestroyAll(); }
+  void enableHugePages() override { alloc.enableHugePages(); }
+  // Replaces the allocator, which must be empty, so that the slab it kept
+  // after reset() is released and new slabs use normal pages.
+  void disableHugePages() override {
+    alloc = llvm::SpecificBumpPtrAllocator<T>();
+    setName();
+  }
+  void setName() {
+    alloc.setName(("make<" + llvm::getTypeName<T>() + ">").str());
+  }
   llvm::SpecificBumpPtrAllocator<T> alloc;
 };
 
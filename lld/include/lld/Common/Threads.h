@@ -87,6 +87,14 @@ template <typename R, class FuncTy> void parallelSort(R &&range, FuncTy fn) {
     sort(llvm::parallel::seq, std::begin(range), std::end(range), fn);
 }
 
+template <typename R, class FuncTy>
+void parallelStableSort(R &&range, FuncTy fn) {
+  if (threadsEnabled)
+    stable_sort(llvm::parallel::par, std::begin(range), std::end(range), fn);
+  else
+    stable_sort(llvm::parallel::seq, std::begin(range), std::end(range), fn);
+}
+
 } // namespace lld
 
 #endif
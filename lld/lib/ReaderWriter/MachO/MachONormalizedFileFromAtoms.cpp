@@ -24,6 +24,7 @@
 #include "MachONormalizedFile.h"
 #include "MachONormalizedFileBinaryUtils.h"
 #include "lld/Common/LLVM.h"
+#include "lld/Common/Threads.h"
 #include "lld/Core/Error.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSwitch.h"
@@ -660,14 +661,25 @@ void Util::copySectionContent(NormalizedFile &file) {
     return pos->second;
   };
 
-  auto sectionAddrForAtom = [&] (const Atom &atom) -> uint64_t {
+  // Utility function for ArchHandler to find address of the section of atom
+  // in output file. Only fix-ups of relocatable output need it.
+  AtomToAddress atomToSectionAddress;
+  if (r)
     for (const SectionInfo *sectInfo : _sectionInfos)
       for (const AtomInfo &atomInfo : sectInfo->atomsAndOffsets)
-        if (atomInfo.atom == &atom)
-          return sectInfo->address;
-    llvm_unreachable("atom not assigned to section");
+        atomToSectionAddress.try_emplace(atomInfo.atom, sectInfo->address);
+  auto sectionAddrForAtom = [&] (const Atom &atom) -> uint64_t {
+    auto pos = atomToSectionAddress.find(&atom);
+    if (pos == atomToSectionAddress.end())
+      llvm_unreachable("atom not assigned to section");
+    return pos->second;
   };
 
+  struct AtomContent {
+    const DefinedAtom *atom;
+    llvm::MutableArrayRef<uint8_t> content;
+  };
+  std::vector<AtomContent> atomContents;
   for (SectionInfo *si : _sectionInfos) {
     Section *normSect = &file.sections[si->normalizedSectionIndex];
     if (isZeroFillSection(si->type)) {
@@ -688,13 +700,18 @@ void Util::copySectionContent(NormalizedFile &file) {
                "Cannot have references without content");
         continue;
       }
-      auto atomContent = sectionContent.slice(ai.offsetInSection,
-                                              ai.atom->size());
-      _archHandler.generateAtomContent(*ai.atom, r, addrForAtom,
-                                       sectionAddrForAtom, _ctx.baseAddress(),
-                                       atomContent);
+      atomContents.push_back(
+          {ai.atom, sectionContent.slice(ai.offsetInSection, ai.atom->size())});
     }
   }
+
+  // Each atom is copied and fixed up in its own part of its section, and the
+  // address maps are only read, so the atoms are written in parallel.
+  parallelForEach(atomContents, [&](const AtomContent &ac) {
+    _archHandler.generateAtomContent(*ac.atom, r, addrForAtom,
+                                     sectionAddrForAtom, _ctx.baseAddress(),
+                                     ac.content);
+  });
 }
 
 void Util::copySectionInfo(NormalizedFile &file) {
@@ -0,0 +1,53 @@
+# REQUIRES: x86
+# RUN: llvm-mc -filetype=obj -triple=x86_64-windows-msvc %s -o %t.obj
+# RUN: rm -rf %t.cache
+
+## The object has no .debug$H, so the first link hashes its types and saves
+## the hashes in the cache directory.
+# RUN: lld-link /entry:main /nodefaultlib /subsystem:console /debug:ghash \
+# RUN:   /lldghashcache:%t.cache /out:%t1.exe /pdb:%t1.pdb %t.obj
+# RUN: llvm-pdbutil dump -types %t1.pdb | FileCheck %s
+# RUN: ls %t.cache | FileCheck %s --check-prefix=CACHE
+
+## The next link reads the hashes back.
+# RUN: lld-link /entry:main /nodefaultlib /subsystem:console /debug:ghash \
+# RUN:   /lldghashcache:%t.cache /out:%t2.exe /pdb:%t2.pdb %t.obj
+# RUN: llvm-pdbutil dump -types %t2.pdb | FileCheck %s
+
+## A corrupted cache file is ignored and written again.
+# RUN: cp %t.obj %t.cache/ghash-*
+# RUN: lld-link /entry:main /nodefaultlib /subsystem:console /debug:ghash \
+# RUN:   /lldghashcache:%t.cache /out:%t3.exe /pdb:%t3.pdb %t.obj
+# RUN: llvm-pdbutil dump -types %t3.pdb | FileCheck %s
+# RUN: ls %t.cache | FileCheck %s --check-prefix=CACHE
+
+# CHECK:      Types (TPI Stream)
+# CHECK:      Showing 2 records
+# CHECK-NEXT: 0x1000 | LF_ARGLIST [size = 8]
+# CHECK-NEXT: 0x1001 | LF_PROCEDURE [size = 16]
+# CHECK-NEXT:          return type = 0x0003 (void), # args = 0, param list = 0x1000
+
+## The name has the size of the type stream, which is 24 bytes.
+# CACHE:     {{^ghash-[0-9A-F]+-24$}}
+# CACHE-NOT: {{.}}
+
+.text
+.globl main
+main:
+  retq
+
+.section .debug$T,"dr"
+.p2align 2
+.long 4
+# LF_ARGLIST with no arguments.
+.short 6
+.short 0x1201
+.long 0
+# LF_PROCEDURE returning void.
+.short 14
+.short 0x1008
+.long 3
+.byte 0
+.byte 0
+.short 0
+.long 0x1000
@@ -0,0 +1,71 @@
+# REQUIRES: x86
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux %s -o %t.o
+
+## A calls B, F (as F.llvm.123) and, from inlined code, C. D has samples but
+## no calls. _start and E have no samples, so they stay after the others.
+# RUN: ld.lld -e A %t.o -o %t \
+# RUN:   --call-graph-sample-profile=%p/Inputs/call-graph-sample-profile.prof \
+# RUN:   --print-symbol-order=%t.order
+# RUN: FileCheck %s --check-prefix=ORDER < %t.order
+# RUN: llvm-nm --numeric-sort %t | FileCheck %s
+
+# ORDER:      A
+# ORDER-NEXT: B
+# ORDER-NEXT: C
+# ORDER-NEXT: F.llvm.123
+# ORDER-NEXT: D
+# ORDER-NOT:  {{.}}
+
+# CHECK:      T A
+# CHECK-NEXT: T B
+# CHECK-NEXT: T C
+# CHECK-NEXT: T F.llvm.123
+# CHECK-NEXT: T D
+# CHECK-NEXT: T _start
+# CHECK-NEXT: T E
+
+# RUN: echo A > %t.symbols
+# RUN: not ld.lld -e A %t.o -o /dev/null --symbol-ordering-file=%t.symbols \
+# RUN:   --call-graph-sample-profile=%p/Inputs/call-graph-sample-profile.prof \
+# RUN:   2>&1 | FileCheck %s --check-prefix=CONFLICT
+# CONFLICT: error: --symbol-ordering-file and --call-graph-sample-profile may not be used together
+
+# RUN: echo garbage > %t.prof
+# RUN: not ld.lld -e A %t.o -o /dev/null --call-graph-sample-profile=%t.prof \
+# RUN:   2>&1 | FileCheck %s --check-prefix=INVALID
+# INVALID: error: {{.*}}.prof:{{.+}}
+
+.section .text._start,"ax",@progbits
+.globl _start
+_start:
+  ret
+
+.section .text.A,"ax",@progbits
+.globl A
+A:
+  ret
+
+.section .text.B,"ax",@progbits
+.globl B
+B:
+  ret
+
+.section .text.C,"ax",@progbits
+.globl C
+C:
+  ret
+
+.section .text.D,"ax",@progbits
+.globl D
+D:
+  ret
+
+.section .text.E,"ax",@progbits
+.globl E
+E:
+  ret
+
+.section .text.F,"ax",@progbits
+.globl F.llvm.123
+F.llvm.123:
+  ret
@@ -0,0 +1,98 @@
+# REQUIRES: x86
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux --defsym MAIN=1 %s -o %tmain.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux --defsym SIZE=16 %s -o %t16.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux --defsym SIZE=24 %s -o %t24.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux --defsym SIZE=8 %s -o %t8.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux --defsym SIZE=64 %s -o %t64.o
+# RUN: rm -f %t.out %t.out.lld-incr
+
+## The first link has no previous output to update.
+# RUN: cp %t16.o %tfoo.o
+# RUN: ld.lld --incremental --verbose %tfoo.o %tmain.o -o %t.out 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=FULL
+# RUN: llvm-readelf -x .data %t.out | FileCheck %s --check-prefix=DATA16
+# RUN: FileCheck %s --check-prefix=STATE < %t.out.lld-incr
+
+## If nothing changed, the output is updated in place and no input section is
+## written again.
+# RUN: ld.lld --incremental --verbose %tfoo.o %tmain.o -o %t.out 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=UNCHANGED
+
+## A section may grow into the padding after it without moving anything else,
+## so only the file that changed is written again.
+# RUN: cp %t24.o %tfoo.o
+# RUN: ld.lld --incremental --verbose %tfoo.o %tmain.o -o %t.out 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=CHANGED
+# RUN: llvm-readelf -x .data %t.out | FileCheck %s --check-prefix=DATA24
+
+## A section that shrinks keeps its slot, and the bytes it no longer covers
+## are cleared.
+# RUN: cp %t8.o %tfoo.o
+# RUN: ld.lld --incremental --verbose %tfoo.o %tmain.o -o %t.out 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=CHANGED
+# RUN: llvm-readelf -x .data %t.out | FileCheck %s --check-prefix=DATA8
+# RUN: llvm-objdump -d --no-show-raw-insn %t.out | FileCheck %s --check-prefix=TEXT8
+
+## A section that outgrows its padding moves the sections after it, so the
+## output is linked again from scratch.
+# RUN: cp %t64.o %tfoo.o
+# RUN: ld.lld --incremental --verbose %tfoo.o %tmain.o -o %t.out 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=FULL
+
+## The next link reuses the new slots.
+# RUN: ld.lld --incremental --verbose %tfoo.o %tmain.o -o %t.out 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=UNCHANGED
+
+## Each slot is the size of the section plus a quarter of it, but at least 16
+## bytes.
+# DATA16:      Hex dump of section '.data':
+# DATA16-NEXT: 0x{{[0-9a-f]+}} aaaaaaaa aaaaaaaa aaaaaaaa aaaaaaaa
+# DATA16-NEXT: 0x{{[0-9a-f]+}} 00000000 00000000 00000000 00000000
+# DATA16-NOT:  0x
+
+# DATA24:      Hex dump of section '.data':
+# DATA24-NEXT: 0x{{[0-9a-f]+}} aaaaaaaa aaaaaaaa aaaaaaaa aaaaaaaa
+# DATA24-NEXT: 0x{{[0-9a-f]+}} aaaaaaaa aaaaaaaa 00000000 00000000
+# DATA24-NOT:  0x
+
+# DATA8:      Hex dump of section '.data':
+# DATA8-NEXT: 0x{{[0-9a-f]+}} aaaaaaaa aaaaaaaa 00000000 00000000
+# DATA8-NEXT: 0x{{[0-9a-f]+}} 00000000 00000000 00000000 00000000
+# DATA8-NOT:  0x
+
+# TEXT8:      <foo>:
+# TEXT8-COUNT-8: nop
+# TEXT8-NEXT: retq
+# TEXT8-NEXT: int3
+# TEXT8:      <_start>:
+
+## The state file has the size, the modification time and the layout digest of
+## the output, and a line per object file with its digests and slot sizes.
+# STATE:      {{^}}lld-incremental LLD {{.*}}
+# STATE-NEXT: {{^[0-9]+ -?[0-9]+ [0-9a-f]+$}}
+# STATE-NEXT: {{^[0-9a-f]+ [0-9a-f]+ [0-9,]+ .*foo.o$}}
+# STATE-NEXT: {{^[0-9a-f]+ [0-9a-f]+ [0-9,]+ .*main.o$}}
+# STATE-NOT:  {{.}}
+
+# FULL-NOT:  --incremental: updating
+# UNCHANGED: --incremental: updating {{.*}}.out in place (0 of 2 object files changed)
+# CHANGED:   --incremental: updating {{.*}}.out in place (1 of 2 object files changed)
+
+.ifdef MAIN
+.globl _start
+_start:
+  call foo
+  ret
+.else
+.globl foo
+foo:
+  .rept SIZE
+  nop
+  .endr
+  ret
+
+.data
+  .rept SIZE
+  .byte 0xaa
+  .endr
+.endif
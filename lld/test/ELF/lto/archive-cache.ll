@@ -0,0 +1,50 @@
+; REQUIRES: x86
+;; The names of the symbols of an archive without a symbol table are saved in
+;; the cache directory by the first link, and read back by the next ones.
+
+; RUN: rm -rf %t.dir %t.cache && mkdir -p %t.dir
+; RUN: llvm-as %s -o %t.dir/main.o
+; RUN: llvm-as %p/Inputs/archive-cache.ll -o %t.dir/foo.o
+; RUN: llvm-ar rcS %t.dir/foo.a %t.dir/foo.o
+
+; RUN: ld.lld --archive-cache-dir=%t.cache --verbose %t.dir/main.o \
+; RUN:   %t.dir/foo.a -o %t.dir/out1 2>&1 | FileCheck %s --check-prefix=MISS
+; RUN: ls %t.cache | FileCheck %s --check-prefix=FILES
+; RUN: ld.lld --archive-cache-dir=%t.cache --verbose %t.dir/main.o \
+; RUN:   %t.dir/foo.a -o %t.dir/out2 2>&1 | FileCheck %s --check-prefix=HIT
+; RUN: cmp %t.dir/out1 %t.dir/out2
+; RUN: llvm-nm %t.dir/out2 | FileCheck %s --check-prefix=SYMS
+
+;; A corrupted cache file is ignored, and written again.
+; RUN: cp %t.dir/foo.o %t.cache/archive-*
+; RUN: ld.lld --archive-cache-dir=%t.cache --verbose %t.dir/main.o \
+; RUN:   %t.dir/foo.a -o %t.dir/out3 2>&1 | FileCheck %s --check-prefix=MISS
+; RUN: cmp %t.dir/out1 %t.dir/out3
+; RUN: ld.lld --archive-cache-dir=%t.cache --verbose %t.dir/main.o \
+; RUN:   %t.dir/foo.a -o %t.dir/out4 2>&1 | FileCheck %s --check-prefix=HIT
+
+;; A rebuilt archive gets a cache file of its own.
+; RUN: llvm-ar rcS %t.dir/foo.a %t.dir/main.o
+; RUN: ld.lld --archive-cache-dir=%t.cache --verbose %t.dir/main.o \
+; RUN:   %t.dir/foo.a -o %t.dir/out5 2>&1 | FileCheck %s --check-prefix=MISS
+; RUN: ls %t.cache | FileCheck %s --check-prefixes=FILES,FILES2
+
+; MISS-NOT: in the archive cache
+; HIT:      found {{.*}}foo.a in the archive cache
+
+; FILES:      {{^archive-[0-9A-F]+$}}
+; FILES2-NEXT: {{^archive-[0-9A-F]+$}}
+; FILES-NOT:  {{.}}
+
+; SYMS:     T foo
+; SYMS-NOT: unused
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @foo()
+
+define void @_start() {
+  call void @foo()
+  ret void
+}
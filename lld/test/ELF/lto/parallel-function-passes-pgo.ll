@@ -0,0 +1,64 @@
+; REQUIRES: x86
+;; The function passes that run on the codegen partitions in parallel, and the
+;; code generation of each partition, must see the profile loaded in the
+;; whole-module pipeline.
+
+; RUN: llvm-as %s -o %t.o
+; RUN: ld.lld -shared %t.o -o %t.so --save-temps --lto-new-pass-manager \
+; RUN:   --lto-parallel-function-passes --lto-partitions=2 \
+; RUN:   --lto-sample-profile=%p/Inputs/parallel-function-passes-pgo.prof \
+; RUN:   -z keep-text-section-prefix \
+; RUN:   --lto-debug-pass-manager 2>&1 | FileCheck %s --check-prefix=PM
+; RUN: llvm-dis %t.so.0.5.precodegen.bc -o %t.0.ll
+; RUN: llvm-dis %t.so.1.5.precodegen.bc -o %t.1.ll
+; RUN: cat %t.0.ll %t.1.ll | FileCheck %s
+; RUN: FileCheck %s --check-prefix=SUMMARY < %t.0.ll
+; RUN: FileCheck %s --check-prefix=SUMMARY < %t.1.ll
+; RUN: llvm-objdump -d -j .text.hot %t.so | FileCheck %s --check-prefix=HOT
+
+; PM: Running pass: SampleProfileLoaderPass
+; PM: Running pass: GVN on foo
+; PM: Running pass: JumpThreadingPass on foo
+
+; CHECK: define {{.*}}i32 @foo(i32 %x) {{.*}}!prof ![[ENTRY:[0-9]+]]
+; CHECK: ![[ENTRY]] = !{!"function_entry_count", i64 1001}
+
+;; Each partition carries the profile summary, so the code generation of the
+;; partition of foo finds foo hot and places it in .text.hot.
+; SUMMARY: !{i32 1, !"ProfileSummary", !{{[0-9]+}}}
+; HOT: Disassembly of section .text.hot:
+; HOT: <foo>:
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @foo(i32 %x) !dbg !6 {
+entry:
+  %c = icmp sgt i32 %x, 0, !dbg !8
+  br i1 %c, label %then, label %else, !dbg !8
+
+then:
+  ret i32 1, !dbg !9
+
+else:
+  ret i32 2, !dbg !10
+}
+
+define i32 @bar(i32 %x) {
+  %r = add i32 %x, 1
+  ret i32 %r
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: true, runtimeVersion: 0, emissionKind: LineTablesOnly, enums: !2)
+!1 = !DIFile(filename: "foo.c", directory: "/")
+!2 = !{}
+!3 = !{i32 2, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!6 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 1, type: !7, scopeLine: 1, spFlags: DISPFlagDefinition | DISPFlagOptimized, unit: !0, retainedNodes: !2)
+!7 = !DISubroutineType(types: !2)
+!8 = !DILocation(line: 2, column: 7, scope: !6)
+!9 = !DILocation(line: 3, column: 5, scope: !6)
+!10 = !DILocation(line: 5, column: 5, scope: !6)
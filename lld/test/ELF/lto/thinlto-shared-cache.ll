@@ -0,0 +1,45 @@
+; REQUIRES: x86
+;; A ThinLTO cache entry created by one link is published to the shared cache
+;; directory, and a link with an empty local cache picks it up from there.
+
+; RUN: opt -module-hash -module-summary %s -o %t.o
+; RUN: rm -rf %t.local1 %t.local2 %t.local3 %t.shared
+
+; RUN: ld.lld --thinlto-cache-dir=%t.local1 \
+; RUN:   --thinlto-shared-cache-dir=%t.shared %t.o -o %t1
+; RUN: ls %t.shared | FileCheck %s --check-prefix=SHARED
+
+; RUN: ld.lld --thinlto-cache-dir=%t.local2 \
+; RUN:   --thinlto-shared-cache-dir=%t.shared %t.o -o %t2
+; RUN: cmp %t1 %t2
+; RUN: ls %t.local2 | FileCheck %s --check-prefix=LOCAL
+
+;; The object of a shared hit is read from the shared directory, which shows
+;; if the entry there is broken. A local hit doesn't look at it.
+; RUN: echo garbage > %t.garbage
+; RUN: cp %t.garbage %t.shared/llvmcache-*
+; RUN: not ld.lld --thinlto-cache-dir=%t.local3 \
+; RUN:   --thinlto-shared-cache-dir=%t.shared %t.o -o %t3 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=GARBAGE
+; RUN: ld.lld --thinlto-cache-dir=%t.local1 \
+; RUN:   --thinlto-shared-cache-dir=%t.shared %t.o -o %t4
+; RUN: cmp %t1 %t4
+
+; RUN: not ld.lld --thinlto-shared-cache-dir=%t.shared %t.o -o %t5 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NOLOCAL
+
+; SHARED:     {{^llvmcache-[0-9A-F]+$}}
+; SHARED-NOT: {{.}}
+
+; LOCAL: {{^llvmcache-[0-9A-F]+$}}
+
+; GARBAGE: error: {{.*}}.shared{{/|\\}}llvmcache-{{[0-9A-F]+}}: not an ELF file
+
+; NOLOCAL: error: --thinlto-shared-cache-dir may not be used without --thinlto-cache-dir
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @_start() {
+  ret void
+}
@@ -0,0 +1,28 @@
+# REQUIRES: x86
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux %s -o %t.o
+
+## The output written in one go on commit is the same as the one written
+## through a mapping.
+# RUN: ld.lld %t.o -o %t.mmap --mmap-output-file
+# RUN: ld.lld %t.o -o %t.nommap --no-mmap-output-file
+# RUN: cmp %t.mmap %t.nommap
+# RUN: llvm-readelf -x .data %t.nommap | FileCheck %s
+
+## The last option wins.
+# RUN: ld.lld %t.o -o %t.last --mmap-output-file --no-mmap-output-file
+# RUN: cmp %t.mmap %t.last
+
+## An existing output is replaced.
+# RUN: echo garbage > %t.existing
+# RUN: ld.lld %t.o -o %t.existing --no-mmap-output-file
+# RUN: cmp %t.mmap %t.existing
+
+# CHECK:      Hex dump of section '.data':
+# CHECK-NEXT: 0x{{[0-9a-f]+}} 01234567 89abcdef
+
+.globl _start
+_start:
+  ret
+
+.data
+  .quad 0xefcdab8967452301
@@ -0,0 +1,79 @@
+# REQUIRES: x86
+## Test -z group-text-section-prefix, which groups the input sections of .text
+## by prefix in the order of GNU ld's default linker script.
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64 %s -o %t.o
+
+## Without the option, input sections keep their input order.
+# RUN: ld.lld %t.o -o %t
+# RUN: llvm-nm -n %t | FileCheck --check-prefix=INPUT %s
+# RUN: ld.lld -z group-text-section-prefix -z nogroup-text-section-prefix \
+# RUN:   %t.o -o %t.no
+# RUN: llvm-nm -n %t.no | FileCheck --check-prefix=INPUT %s
+
+# INPUT:      T _start
+# INPUT-NEXT: t hot
+# INPUT-NEXT: t unlikely
+# INPUT-NEXT: t startup
+# INPUT-NEXT: t exit
+# INPUT-NEXT: t unlikely2
+
+## With it, .text.unlikely comes first, then .text.exit, .text.startup,
+## .text.hot and the rest. Sections with the same rank keep their order.
+# RUN: ld.lld -z group-text-section-prefix %t.o -o %t.group
+# RUN: llvm-nm -n %t.group | FileCheck --check-prefix=GROUP %s
+# RUN: llvm-readelf -S %t.group | FileCheck --check-prefix=SECTIONS %s
+
+# GROUP:      t unlikely
+# GROUP-NEXT: t unlikely2
+# GROUP-NEXT: t exit
+# GROUP-NEXT: t startup
+# GROUP-NEXT: t hot
+# GROUP-NEXT: T _start
+
+## Everything is still in the one .text output section.
+# SECTIONS:     .text
+# SECTIONS-NOT: .text.
+
+## --symbol-ordering-file is applied afterwards and takes precedence.
+# RUN: echo "hot" > %t.order
+# RUN: ld.lld -z group-text-section-prefix --symbol-ordering-file %t.order \
+# RUN:   %t.o -o %t.order.out
+# RUN: llvm-nm -n %t.order.out | FileCheck --check-prefix=ORDER %s
+
+# ORDER:      t hot
+# ORDER-NEXT: t unlikely
+# ORDER-NEXT: t unlikely2
+# ORDER-NEXT: t exit
+# ORDER-NEXT: t startup
+# ORDER-NEXT: T _start
+
+## A linker script decides the order itself.
+# RUN: echo "SECTIONS { .text : { *(.text*) } }" > %t.script
+# RUN: ld.lld -z group-text-section-prefix -T %t.script %t.o -o %t.script.out
+# RUN: llvm-nm -n %t.script.out | FileCheck --check-prefix=INPUT %s
+
+.text
+.globl _start
+_start:
+  nop
+
+.section .text.hot.f,"ax",@progbits
+hot:
+  nop
+
+.section .text.unlikely.f,"ax",@progbits
+unlikely:
+  nop
+
+.section .text.startup.f,"ax",@progbits
+startup:
+  nop
+
+.section .text.exit.f,"ax",@progbits
+exit:
+  nop
+
+.section .text.unlikely,"ax",@progbits
+unlikely2:
+  nop
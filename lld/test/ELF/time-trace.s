@@ -0,0 +1,27 @@
+# REQUIRES: x86
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux %s -o %t.o
+
+## The trace goes to <output>.time-trace by default.
+# RUN: ld.lld --time-trace --time-trace-granularity=0 %t.o -o %t.out
+# RUN: FileCheck %s < %t.out.time-trace
+
+## It is also written when the link stops early on an error.
+# RUN: not ld.lld --time-trace --time-trace-granularity=0 \
+# RUN:   --time-trace-file=%t.fail.json %t.o %t.missing -o %t.out 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=ERR
+# RUN: FileCheck %s --check-prefix=FAIL < %t.fail.json
+# RUN: not grep "Parse input files" %t.fail.json
+
+# ERR: cannot open {{.*}}.missing
+
+# CHECK: "traceEvents"
+# CHECK-DAG: "name":"ExecuteLinker"
+# CHECK-DAG: "name":"Parse input files"
+# CHECK-DAG: "name":"Write output file"
+
+# FAIL: "traceEvents"
+# FAIL: "name":"ExecuteLinker"
+
+.globl _start
+_start:
+  ret
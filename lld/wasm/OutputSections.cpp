@@ -85,9 +85,14 @@ void CodeSection::finalizeContents() {
   os.flush();
   bodySize = codeSectionHeader.size();
 
+  // With --compress-relocations, computing the size of a function requires
+  // computing the values of all of its relocations, so do that in parallel
+  // before assigning offsets.
+  parallelForEach(functions,
+                  [](InputFunction *func) { func->calculateSize(); });
+
   for (InputFunction *func : functions) {
     func->outputOffset = bodySize;
-    func->calculateSize();
     bodySize += func->getSize();
   }
 
@@ -109,8 +114,8 @@ void CodeSection::writeTo(uint8_t *buf) {
   memcpy(buf, codeSectionHeader.data(), codeSectionHeader.size());
 
   // Write code section bodies
-  for (const InputChunk *chunk : functions)
-    chunk->writeTo(buf);
+  parallelForEach(functions,
+                  [&](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t CodeSection::getNumRelocations() const {
@@ -179,15 +184,18 @@ void DataSection::writeTo(uint8_t *buf) {
   // Write data section headers
   memcpy(buf, dataSectionHeader.data(), dataSectionHeader.size());
 
+  std::vector<const InputChunk *> chunks;
   for (const OutputSegment *segment : segments) {
     // Write data segment header
     uint8_t *segStart = buf + segment->sectionOffset;
     memcpy(segStart, segment->header.data(), segment->header.size());
-
-    // Write segment data payload
-    for (const InputChunk *chunk : segment->inputSegments)
-      chunk->writeTo(buf);
+    chunks.insert(chunks.end(), segment->inputSegments.begin(),
+                  segment->inputSegments.end());
   }
+
+  // Write segment data payloads
+  parallelForEach(chunks,
+                  [&](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t DataSection::getNumRelocations() const {
@@ -233,8 +241,8 @@ void CustomSection::writeTo(uint8_t *buf) {
   buf += nameData.size();
 
   // Write custom sections payload
-  for (const InputSection *section : inputSections)
-    section->writeTo(buf);
+  parallelForEach(inputSections,
+                  [&](const InputSection *section) { section->writeTo(buf); });
 }
 
 uint32_t CustomSection::getNumRelocations() const {
@@ -42,6 +42,10 @@ public:
   // then call wait() on each returned future.
   template <typename... T> static void RunTasks(T &&... tasks);
 
+  // Return true if the calling thread is one of the worker threads of the
+  // task pool.
+  static bool IsWorkerThread();
+
 private:
   TaskPool() = delete;
 
@@ -81,7 +85,8 @@ template <> struct TaskPool::RunTaskImpl<> {
 
 // Run 'func' on every value from begin .. end-1.  Each worker will grab
 // 'batch_size' numbers at a time to work on, so for very fast functions, batch
-// should be large enough to avoid too much cache line contention.
+// should be large enough to avoid too much cache line contention. When called
+// from a task of the task pool, 'func' runs serially on the calling thread.
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func);
 
@@ -189,10 +189,23 @@ private:
   void SymbolIndicesToSymbolContextList(std::vector<uint32_t> &symbol_indexes,
                                         SymbolContextList &sc_list);
 
-  void RegisterMangledNameEntry(
-      uint32_t value, std::set<const char *> &class_contexts,
-      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-      RichManglingContext &rmc);
+  /// The name indexes of a range of symbols. The ranges are indexed in
+  /// parallel, and their indexes are merged into the ones of the symbol table.
+  struct NameIndexes {
+    NameToIndexMap name_to_index;
+    NameToIndexMap basename_to_index;
+    NameToIndexMap method_to_index;
+    NameToIndexMap selector_to_index;
+    // The "const char *" in "class_contexts" and backlog::value_type::second
+    // must come from a ConstString::GetCString()
+    std::set<const char *> class_contexts;
+    std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
+  };
+
+  void IndexSymbolNames(uint32_t begin, uint32_t end, NameIndexes &indexes);
+
+  void RegisterMangledNameEntry(uint32_t value, NameIndexes &indexes,
+                                RichManglingContext &rmc);
 
   void RegisterBacklogEntry(const NameToIndexMap::Entry &entry,
                             const char *decl_context,
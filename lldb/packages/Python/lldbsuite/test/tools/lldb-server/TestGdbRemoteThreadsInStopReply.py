@@ -309,3 +309,45 @@ class TestGdbRemoteThreadsInStopReply(
         self.build()
         self.set_inferior_startup_launch()
         self.stop_reply_contains_thread_pcs(5)
+
+    def threads_info_memory_matches_inferior(self, thread_count):
+        self.gather_stop_reply_pcs(
+                self.ENABLE_THREADS_IN_STOP_REPLY_ENTRIES, thread_count)
+
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+                [
+                    "read packet: $jThreadsInfo#c1",
+                    {
+                        "direction": "send",
+                        "regex": r"^\$(.*)#[0-9a-fA-F]{2}$",
+                        "capture": {
+                            1: "threads_info"}},
+                ],
+                True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        jthreads_info = json.loads(
+                re.sub(r"}]", "}", context.get("threads_info")))
+
+        # The expedited frame records must be the contents of the memory.
+        for thread_info in jthreads_info:
+            for memory in thread_info.get("memory", []):
+                address = memory["address"]
+                contents = memory["bytes"]
+                self.assertTrue(len(contents) in (16, 32))
+                self.reset_test_sequence()
+                self.test_sequence.add_log_lines(
+                        ["read packet: $m{0:x},{1:x}#00".format(
+                            address, len(contents) // 2),
+                         "send packet: ${0}#00".format(contents)],
+                        True)
+                self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @expectedFailureAll(oslist=["windows"])
+    @llgs_test
+    def test_threads_info_memory_matches_inferior_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.threads_info_memory_matches_inferior(5)
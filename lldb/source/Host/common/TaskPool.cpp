@@ -37,6 +37,11 @@ private:
 
 } // end of anonymous namespace
 
+// Set on the worker threads of the task pool.
+static thread_local bool g_is_worker_thread = false;
+
+bool TaskPool::IsWorkerThread() { return g_is_worker_thread; }
+
 TaskPoolImpl &TaskPoolImpl::GetInstance() {
   static TaskPoolImpl g_task_pool_impl;
   return g_task_pool_impl;
@@ -85,6 +90,7 @@ lldb::thread_result_t TaskPoolImpl::WorkerPtr(void *pool) {
 }
 
 void TaskPoolImpl::Worker(TaskPoolImpl *pool) {
+  g_is_worker_thread = true;
   while (true) {
     std::unique_lock<std::mutex> lock(pool->m_tasks_mutex);
     if (pool->m_tasks.empty()) {
@@ -102,6 +108,14 @@ void TaskPoolImpl::Worker(TaskPoolImpl *pool) {
 
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func) {
+  // A worker waiting for tasks queued behind it can deadlock the pool once
+  // every worker is waiting, so run them on this thread instead.
+  if (TaskPool::IsWorkerThread()) {
+    for (size_t i = begin; i < end; ++i)
+      func(i);
+    return;
+  }
+
   const size_t num_workers = std::min<size_t>(end, GetHardwareConcurrencyHint());
   std::atomic<size_t> idx{begin};
   
@@ -344,7 +344,9 @@ void ClangASTSource::CompleteType(TagDecl *tag_decl) {
           if (!type)
             continue;
 
-          CompilerType clang_type(type->GetFullCompilerType());
+          // CompleteTagDeclWithOrigin completes the candidate, so only the
+          // candidate which is used is completed.
+          CompilerType clang_type(type->GetForwardCompilerType());
 
           if (!ClangUtil::IsClangType(clang_type))
             continue;
@@ -382,7 +384,10 @@ void ClangASTSource::CompleteType(TagDecl *tag_decl) {
         if (!type)
           continue;
 
-        CompilerType clang_type(type->GetFullCompilerType());
+        // Completing the candidates can import whole class hierarchies into
+        // their modules, so only the equivalent one is completed, by
+        // CompleteTagDeclWithOrigin.
+        CompilerType clang_type(type->GetForwardCompilerType());
 
         if (!ClangUtil::IsClangType(clang_type))
           continue;
@@ -31,6 +31,7 @@
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Utility/Args.h"
 #include "lldb/Utility/DataBuffer.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Endian.h"
 #include "lldb/Utility/JSON.h"
 #include "lldb/Utility/LLDBAssert.h"
@@ -468,6 +469,55 @@ static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread) {
   return register_object_sp;
 }
 
+// Reads the frame records of a thread, i.e. the saved frame pointer and the
+// return address which its frame pointer chain points to, so that the client
+// can backtrace without reading them one packet at a time.
+static JSONArray::SP GetStackMemoryAsJSON(NativeProcessProtocol &process,
+                                          NativeThreadProtocol &thread) {
+  const uint32_t k_max_frames = 128;
+  const uint32_t addr_size = process.GetAddressByteSize();
+  if (addr_size != 4 && addr_size != 8)
+    return nullptr;
+
+  NativeRegisterContext &reg_ctx = thread.GetRegisterContext();
+  lldb::addr_t fp = reg_ctx.GetFP(0);
+  const lldb::addr_t sp = reg_ctx.GetSP(0);
+  if (fp == 0 || fp < sp)
+    return nullptr;
+
+  JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+  for (uint32_t i = 0; i < k_max_frames; ++i) {
+    uint8_t frame_record[16];
+    size_t bytes_read = 0;
+    Status error = process.ReadMemoryWithoutTrap(fp, frame_record,
+                                                 2 * addr_size, bytes_read);
+    if (error.Fail() || bytes_read != 2 * addr_size)
+      break;
+
+    StreamString bytes;
+    bytes.PutBytesAsRawHex8(frame_record, bytes_read);
+    JSONObject::SP memory_sp = std::make_shared<JSONObject>();
+    memory_sp->SetObject("address", std::make_shared<JSONNumber>(fp));
+    memory_sp->SetObject("bytes",
+                         std::make_shared<JSONString>(bytes.GetString()));
+    memory_array_sp->AppendObject(memory_sp);
+
+    DataExtractor data(frame_record, bytes_read, process.GetByteOrder(),
+                       addr_size);
+    lldb::offset_t offset = 0;
+    const lldb::addr_t caller_fp = data.GetAddress(&offset);
+    // The stack grows down, so the frames of the callers are at higher
+    // addresses. Anything else is the end of the chain, or garbage.
+    if (caller_fp <= fp)
+      break;
+    fp = caller_fp;
+  }
+
+  if (memory_array_sp->GetNumElements() == 0)
+    return nullptr;
+  return memory_array_sp;
+}
+
 static const char *GetStopReasonString(StopReason stop_reason) {
   switch (stop_reason) {
   case eStopReasonTrace:
@@ -562,7 +612,10 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
       thread_obj_sp->SetObject("medata", medata_array_sp);
     }
 
-    // TODO: Expedite interesting regions of inferior memory
+    if (!abridged) {
+      if (JSONArray::SP memory_sp = GetStackMemoryAsJSON(process, *thread))
+        thread_obj_sp->SetObject("memory", memory_sp);
+    }
   }
 
   return threads_array_sp;
@@ -296,7 +296,8 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp,
       m_async_listener_sp(
           Listener::MakeListener("lldb.process.gdb-remote.async-listener")),
       m_async_thread_state_mutex(), m_thread_ids(), m_thread_pcs(),
-      m_jstopinfo_sp(), m_jthreadsinfo_sp(), m_continue_c_tids(),
+      m_jstopinfo_sp(), m_jthreadsinfo_sp(), m_jstopinfo_by_tid(),
+      m_jthreadsinfo_by_tid(), m_continue_c_tids(),
       m_continue_C_tids(), m_continue_s_tids(), m_continue_S_tids(),
       m_max_memory_size(0), m_remote_stub_max_memory_size(0),
       m_addr_to_mmap_size(), m_thread_create_bp_sp(),
@@ -1319,7 +1320,9 @@ Status ProcessGDBRemote::WillResume() {
   m_continue_s_tids.clear();
   m_continue_S_tids.clear();
   m_jstopinfo_sp.reset();
+  m_jstopinfo_by_tid.clear();
   m_jthreadsinfo_sp.reset();
+  m_jthreadsinfo_by_tid.clear();
   return Status();
 }
 
@@ -1740,34 +1743,40 @@ void ProcessGDBRemote::SetThreadPc(const ThreadSP &thread_sp, uint64_t index) {
 }
 
 bool ProcessGDBRemote::GetThreadStopInfoFromJSON(
-    ThreadGDBRemote *thread, const StructuredData::ObjectSP &thread_infos_sp) {
-  // See if we got thread stop infos for all threads via the "jThreadsInfo"
-  // packet
-  if (thread_infos_sp) {
+    ThreadGDBRemote *thread, const StructuredData::ObjectSP &thread_infos_sp,
+    ThreadInfoMap &thread_infos_by_tid) {
+  if (!thread_infos_sp)
+    return false;
+
+  if (thread_infos_by_tid.empty()) {
     StructuredData::Array *thread_infos = thread_infos_sp->GetAsArray();
-    if (thread_infos) {
+    if (!thread_infos)
+      return false;
+    const size_t n = thread_infos->GetSize();
+    for (size_t i = 0; i < n; ++i) {
+      StructuredData::Dictionary *thread_dict =
+          thread_infos->GetItemAtIndex(i)->GetAsDictionary();
       lldb::tid_t tid;
-      const size_t n = thread_infos->GetSize();
-      for (size_t i = 0; i < n; ++i) {
-        StructuredData::Dictionary *thread_dict =
-            thread_infos->GetItemAtIndex(i)->GetAsDictionary();
-        if (thread_dict) {
-          if (thread_dict->GetValueForKeyAsInteger<lldb::tid_t>(
-                  "tid", tid, LLDB_INVALID_THREAD_ID)) {
-            if (tid == thread->GetID())
-              return (bool)SetThreadStopInfo(thread_dict);
-          }
-        }
-      }
+      if (thread_dict &&
+          thread_dict->GetValueForKeyAsInteger<lldb::tid_t>(
+              "tid", tid, LLDB_INVALID_THREAD_ID) &&
+          tid != LLDB_INVALID_THREAD_ID)
+        // Like before the map, the first info of a thread is used.
+        thread_infos_by_tid.try_emplace(tid, thread_dict);
     }
   }
-  return false;
+
+  auto pos = thread_infos_by_tid.find(thread->GetID());
+  if (pos == thread_infos_by_tid.end())
+    return false;
+  return (bool)SetThreadStopInfo(pos->second);
 }
 
 bool ProcessGDBRemote::CalculateThreadStopInfo(ThreadGDBRemote *thread) {
   // See if we got thread stop infos for all threads via the "jThreadsInfo"
   // packet
-  if (GetThreadStopInfoFromJSON(thread, m_jthreadsinfo_sp))
+  if (GetThreadStopInfoFromJSON(thread, m_jthreadsinfo_sp,
+                                m_jthreadsinfo_by_tid))
     return true;
 
   // See if we got thread stop info for any threads valid stop info reasons
@@ -1777,7 +1786,8 @@ bool ProcessGDBRemote::CalculateThreadStopInfo(ThreadGDBRemote *thread) {
     // that have stop reasons, and if there is no entry for a thread, then it
     // has no stop reason.
     thread->GetRegisterContext()->InvalidateIfNeeded(true);
-    if (!GetThreadStopInfoFromJSON(thread, m_jstopinfo_sp)) {
+    if (!GetThreadStopInfoFromJSON(thread, m_jstopinfo_sp,
+                                   m_jstopinfo_by_tid)) {
       thread->SetStopInfo(StopInfoSP());
     }
     return true;
@@ -2285,6 +2295,7 @@ StateType ProcessGDBRemote::SetThreadStopInfo(StringExtractor &stop_packet) {
         // This JSON contains thread IDs and thread stop info for all threads.
         // It doesn't contain expedited registers, memory or queue info.
         m_jstopinfo_sp = StructuredData::ParseJSON(json);
+        m_jstopinfo_by_tid.clear();
       } else if (key.compare("hexname") == 0) {
         StringExtractor name_extractor(value);
         std::string name;
@@ -2739,6 +2750,7 @@ void ProcessGDBRemote::WillPublicStop() {
   // memory will help stack backtracing be much faster. Expediting registers
   // will make sure we don't have to read the thread registers for GPRs.
   m_jthreadsinfo_sp = m_gdb_comm.GetThreadsInfo();
+  m_jthreadsinfo_by_tid.clear();
 
   if (m_jthreadsinfo_sp) {
     // Now set the stop info for each thread and also expedite any registers
@@ -268,6 +268,13 @@ protected:
                                               // registers and memory for all
                                               // threads if "jThreadsInfo"
                                               // packet is supported
+  // The thread infos of m_jstopinfo_sp and m_jthreadsinfo_sp by thread ID, so
+  // that processes with many threads don't scan them for every thread. They
+  // are built on first use.
+  typedef llvm::DenseMap<lldb::tid_t, StructuredData::Dictionary *>
+      ThreadInfoMap;
+  ThreadInfoMap m_jstopinfo_by_tid;
+  ThreadInfoMap m_jthreadsinfo_by_tid;
   tid_collection m_continue_c_tids;           // 'c' for continue
   tid_sig_collection m_continue_C_tids;       // 'C' for continue with signal
   tid_collection m_continue_s_tids;           // 's' for step
@@ -351,9 +358,9 @@ protected:
 
   lldb::StateType SetThreadStopInfo(StringExtractor &stop_packet);
 
-  bool
-  GetThreadStopInfoFromJSON(ThreadGDBRemote *thread,
-                            const StructuredData::ObjectSP &thread_infos_sp);
+  bool GetThreadStopInfoFromJSON(ThreadGDBRemote *thread,
+                                 const StructuredData::ObjectSP &thread_infos_sp,
+                                 ThreadInfoMap &thread_infos_by_tid);
 
   lldb::ThreadSP SetThreadStopInfo(StructuredData::Dictionary *thread_dict);
 
@@ -322,11 +322,12 @@ const MinidumpExceptionStream *MinidumpParser::GetExceptionStream() {
   return MinidumpExceptionStream::Parse(data);
 }
 
-llvm::Optional<minidump::Range>
-MinidumpParser::FindMemoryRange(lldb::addr_t addr) {
-  llvm::ArrayRef<uint8_t> data64 = GetStream(StreamType::Memory64List);
-  Log *log = GetLogIfAnyCategoriesSet(LIBLLDB_LOG_MODULES);
+const std::vector<minidump::Range> &MinidumpParser::GetMemoryRanges() {
+  if (m_parsed_memory_ranges)
+    return m_sorted_memory_ranges;
+  m_parsed_memory_ranges = true;
 
+  Log *log = GetLogIfAnyCategoriesSet(LIBLLDB_LOG_MODULES);
   auto ExpectedMemory = GetMinidumpFile().getMemoryList();
   if (!ExpectedMemory) {
     LLDB_LOG_ERROR(log, ExpectedMemory.takeError(),
@@ -334,21 +335,15 @@ MinidumpParser::FindMemoryRange(lldb::addr_t addr) {
   } else {
     for (const auto &memory_desc : *ExpectedMemory) {
       const LocationDescriptor &loc_desc = memory_desc.Memory;
-      const lldb::addr_t range_start = memory_desc.StartOfMemoryRange;
-      const size_t range_size = loc_desc.DataSize;
-
-      if (loc_desc.RVA + loc_desc.DataSize > GetData().size())
-        return llvm::None;
-
-      if (range_start <= addr && addr < range_start + range_size) {
-        auto ExpectedSlice = GetMinidumpFile().getRawData(loc_desc);
-        if (!ExpectedSlice) {
-          LLDB_LOG_ERROR(log, ExpectedSlice.takeError(),
-                         "Failed to get memory slice: {0}");
-          return llvm::None;
-        }
-        return minidump::Range(range_start, *ExpectedSlice);
+      auto ExpectedSlice = GetMinidumpFile().getRawData(loc_desc);
+      if (!ExpectedSlice) {
+        LLDB_LOG_ERROR(log, ExpectedSlice.takeError(),
+                       "Failed to get memory slice: {0}");
+        continue;
       }
+      if (!ExpectedSlice->empty())
+        m_memory_ranges.emplace_back(memory_desc.StartOfMemoryRange,
+                                     *ExpectedSlice);
     }
   }
 
@@ -356,40 +351,81 @@ MinidumpParser::FindMemoryRange(lldb::addr_t addr) {
   // (full-memory Minidumps).  We can't exactly use the same loop as above,
   // because the Minidump uses slightly different data structures to describe
   // those
-
+  llvm::ArrayRef<uint8_t> data64 = GetStream(StreamType::Memory64List);
   if (!data64.empty()) {
     llvm::ArrayRef<MinidumpMemoryDescriptor64> memory64_list;
     uint64_t base_rva;
     std::tie(memory64_list, base_rva) =
         MinidumpMemoryDescriptor64::ParseMemory64List(data64);
 
-    if (memory64_list.empty())
-      return llvm::None;
-
     for (const auto &memory_desc64 : memory64_list) {
-      const lldb::addr_t range_start = memory_desc64.start_of_memory_range;
       const size_t range_size = memory_desc64.data_size;
-
+      // The ranges are laid out contiguously from base_rva, so none of the
+      // following ones are in the file either.
       if (base_rva + range_size > GetData().size())
-        return llvm::None;
-
-      if (range_start <= addr && addr < range_start + range_size) {
-        return minidump::Range(range_start,
-                               GetData().slice(base_rva, range_size));
-      }
+        break;
+      if (range_size != 0)
+        m_memory_ranges.emplace_back(memory_desc64.start_of_memory_range,
+                                     GetData().slice(base_rva, range_size));
       base_rva += range_size;
     }
   }
 
-  return llvm::None;
+  // The ranges point into the mapped file, so the sorted copy only
+  // duplicates the descriptors.
+  m_sorted_memory_ranges = m_memory_ranges;
+  llvm::sort(m_sorted_memory_ranges,
+             [](const minidump::Range &lhs, const minidump::Range &rhs) {
+               return lhs.start < rhs.start;
+             });
+
+  // A binary search only finds the range that starts last before an address,
+  // so it can't be used if the ranges overlap.
+  lldb::addr_t prev_end = 0;
+  for (const minidump::Range &range : m_sorted_memory_ranges) {
+    if (range.start < prev_end) {
+      LLDB_LOG(log, "Memory range at {0:x} overlaps a previous range",
+               range.start);
+      m_memory_ranges_overlap = true;
+      break;
+    }
+    prev_end = range.start + range.range_ref.size();
+  }
+  return m_sorted_memory_ranges;
+}
+
+llvm::Optional<minidump::Range>
+MinidumpParser::FindMemoryRange(lldb::addr_t addr) {
+  const std::vector<minidump::Range> &ranges = GetMemoryRanges();
+  auto contains = [addr](const minidump::Range &range) {
+    return range.start <= addr && addr - range.start < range.range_ref.size();
+  };
+
+  // Overlapping ranges are looked up in the order of the streams, so that
+  // the first one containing addr wins, MemoryList ranges before
+  // Memory64List ones.
+  if (m_memory_ranges_overlap) {
+    auto pos = llvm::find_if(m_memory_ranges, contains);
+    if (pos == m_memory_ranges.end())
+      return llvm::None;
+    return *pos;
+  }
+
+  // Find the last range which starts at or before addr.
+  auto pos = std::upper_bound(
+      ranges.begin(), ranges.end(), addr,
+      [](lldb::addr_t addr, const minidump::Range &range) {
+        return addr < range.start;
+      });
+  if (pos == ranges.begin() || !contains(*--pos))
+    return llvm::None;
+  return *pos;
 }
 
 llvm::ArrayRef<uint8_t> MinidumpParser::GetMemory(lldb::addr_t addr,
                                                   size_t size) {
-  // I don't have a sense of how frequently this is called or how many memory
-  // ranges a Minidump typically has, so I'm not sure if searching for the
-  // appropriate range linearly each time is stupid.  Perhaps we should build
-  // an index for faster lookups.
+  // The ranges are indexed by address the first time memory is read, so that
+  // reading from a full-memory Minidump doesn't scan all of its ranges.
   llvm::Optional<minidump::Range> range = FindMemoryRange(addr);
   if (!range)
     return {};
@@ -28,6 +28,7 @@
 // C++ includes
 #include <cstring>
 #include <unordered_map>
+#include <vector>
 
 namespace lldb_private {
 
@@ -102,12 +103,21 @@ private:
 
   MemoryRegionInfo FindMemoryRegion(lldb::addr_t load_addr) const;
 
+  /// Returns the non-empty memory ranges of the MemoryList and Memory64List
+  /// streams, sorted by address.
+  const std::vector<Range> &GetMemoryRanges();
+
 private:
   lldb::DataBufferSP m_data_sp;
   std::unique_ptr<llvm::object::MinidumpFile> m_file;
   ArchSpec m_arch;
   MemoryRegionInfos m_regions;
   bool m_parsed_regions = false;
+  /// The memory ranges in the order of the streams, and sorted by address.
+  std::vector<Range> m_memory_ranges;
+  std::vector<Range> m_sorted_memory_ranges;
+  bool m_memory_ranges_overlap = false;
+  bool m_parsed_memory_ranges = false;
 };
 
 } // end namespace minidump
@@ -10,6 +10,7 @@
 #include "Plugins/SymbolFile/DWARF/DWARFDebugInfo.h"
 #include "Plugins/SymbolFile/DWARF/DWARFDeclContext.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARFDwo.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 
@@ -39,13 +40,19 @@ DebugNamesDWARFIndex::GetUnits(const DebugNames &debug_names) {
   for (const DebugNames::NameIndex &ni : debug_names) {
     for (uint32_t cu = 0; cu < ni.getCUCount(); ++cu)
       result.insert(ni.getCUOffset(cu));
+    for (uint32_t tu = 0; tu < ni.getLocalTUCount(); ++tu)
+      result.insert(ni.getLocalTUOffset(tu));
   }
   return result;
 }
 
 llvm::Optional<DIERef>
 DebugNamesDWARFIndex::ToDIERef(const DebugNames::Entry &entry) {
-  llvm::Optional<uint64_t> cu_offset = entry.getCUOffset();
+  // Entries in local type units refer to the type unit in .debug_info. The
+  // foreign type units live in the .dwo files and are not supported.
+  llvm::Optional<uint64_t> cu_offset = entry.getLocalTUOffset();
+  if (!cu_offset)
+    cu_offset = entry.getCUOffset();
   if (!cu_offset)
     return llvm::None;
 
@@ -83,6 +90,38 @@ void DebugNamesDWARFIndex::MaybeLogLookupError(llvm::Error error,
       ni.getUnitOffset(), name);
 }
 
+void DebugNamesDWARFIndex::GetEntriesMatching(
+    const RegularExpression &regex, llvm::function_ref<bool(dw_tag_t)> tag_pred,
+    llvm::function_ref<void(const DebugNames::Entry &)> callback) {
+  std::vector<const DebugNames::NameIndex *> name_indexes;
+  for (const DebugNames::NameIndex &ni : *m_debug_names_up)
+    name_indexes.push_back(&ni);
+
+  // Matching the names is the expensive part, and only reads the index, so the
+  // name indexes are searched in parallel. The entries are resolved
+  // afterwards, as that may parse units.
+  std::vector<std::vector<DebugNames::Entry>> matches(name_indexes.size());
+  TaskMapOverInt(0, name_indexes.size(), [&](size_t i) {
+    const DebugNames::NameIndex &ni = *name_indexes[i];
+    for (DebugNames::NameTableEntry nte : ni) {
+      if (!regex.Execute(nte.getString()))
+        continue;
+
+      uint64_t entry_offset = nte.getEntryOffset();
+      llvm::Expected<DebugNames::Entry> entry_or = ni.getEntry(&entry_offset);
+      for (; entry_or; entry_or = ni.getEntry(&entry_offset)) {
+        if (tag_pred(entry_or->tag()))
+          matches[i].push_back(std::move(*entry_or));
+      }
+      MaybeLogLookupError(entry_or.takeError(), ni, nte.getString());
+    }
+  });
+
+  for (const std::vector<DebugNames::Entry> &entries : matches)
+    for (const DebugNames::Entry &entry : entries)
+      callback(entry);
+}
+
 void DebugNamesDWARFIndex::GetGlobalVariables(ConstString basename,
                                               DIEArray &offsets) {
   m_fallback.GetGlobalVariables(basename, offsets);
@@ -100,22 +139,9 @@ void DebugNamesDWARFIndex::GetGlobalVariables(const RegularExpression &regex,
                                               DIEArray &offsets) {
   m_fallback.GetGlobalVariables(regex, offsets);
 
-  for (const DebugNames::NameIndex &ni: *m_debug_names_up) {
-    for (DebugNames::NameTableEntry nte: ni) {
-      if (!regex.Execute(nte.getString()))
-        continue;
-
-      uint64_t entry_offset = nte.getEntryOffset();
-      llvm::Expected<DebugNames::Entry> entry_or = ni.getEntry(&entry_offset);
-      for (; entry_or; entry_or = ni.getEntry(&entry_offset)) {
-        if (entry_or->tag() != DW_TAG_variable)
-          continue;
-
-        Append(*entry_or, offsets);
-      }
-      MaybeLogLookupError(entry_or.takeError(), ni, nte.getString());
-    }
-  }
+  GetEntriesMatching(
+      regex, [](dw_tag_t tag) { return tag == DW_TAG_variable; },
+      [&](const DebugNames::Entry &entry) { Append(entry, offsets); });
 }
 
 void DebugNamesDWARFIndex::GetGlobalVariables(const DWARFUnit &cu,
@@ -124,6 +150,14 @@ void DebugNamesDWARFIndex::GetGlobalVariables(const DWARFUnit &cu,
 
   uint64_t cu_offset = cu.GetOffset();
   for (const DebugNames::NameIndex &ni: *m_debug_names_up) {
+    // Only the name indexes which list the unit can have entries in it. With
+    // one name index per unit, as the linker produces, this skips all others.
+    bool has_cu = false;
+    for (uint32_t i = 0; i < ni.getCUCount() && !has_cu; ++i)
+      has_cu = ni.getCUOffset(i) == cu_offset;
+    if (!has_cu)
+      continue;
+
     for (DebugNames::NameTableEntry nte: ni) {
       uint64_t entry_offset = nte.getEntryOffset();
       llvm::Expected<DebugNames::Entry> entry_or = ni.getEntry(&entry_offset);
@@ -243,23 +277,12 @@ void DebugNamesDWARFIndex::GetFunctions(const RegularExpression &regex,
                                         DIEArray &offsets) {
   m_fallback.GetFunctions(regex, offsets);
 
-  for (const DebugNames::NameIndex &ni: *m_debug_names_up) {
-    for (DebugNames::NameTableEntry nte: ni) {
-      if (!regex.Execute(nte.getString()))
-        continue;
-
-      uint64_t entry_offset = nte.getEntryOffset();
-      llvm::Expected<DebugNames::Entry> entry_or = ni.getEntry(&entry_offset);
-      for (; entry_or; entry_or = ni.getEntry(&entry_offset)) {
-        Tag tag = entry_or->tag();
-        if (tag != DW_TAG_subprogram && tag != DW_TAG_inlined_subroutine)
-          continue;
-
-        Append(*entry_or, offsets);
-      }
-      MaybeLogLookupError(entry_or.takeError(), ni, nte.getString());
-    }
-  }
+  GetEntriesMatching(
+      regex,
+      [](dw_tag_t tag) {
+        return tag == DW_TAG_subprogram || tag == DW_TAG_inlined_subroutine;
+      },
+      [&](const DebugNames::Entry &entry) { Append(entry, offsets); });
 }
 
 void DebugNamesDWARFIndex::Dump(Stream &s) {
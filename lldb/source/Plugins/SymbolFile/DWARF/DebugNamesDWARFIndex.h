@@ -69,6 +69,13 @@ private:
   llvm::Optional<DIERef> ToDIERef(const DebugNames::Entry &entry);
   void Append(const DebugNames::Entry &entry, DIEArray &offsets);
 
+  /// Calls \p callback on the entries whose name matches \p regex and whose
+  /// tag satisfies \p tag_pred, in the order of the name indexes.
+  void GetEntriesMatching(
+      const RegularExpression &regex,
+      llvm::function_ref<bool(dw_tag_t)> tag_pred,
+      llvm::function_ref<void(const DebugNames::Entry &)> callback);
+
   static void MaybeLogLookupError(llvm::Error error,
                                   const DebugNames::NameIndex &ni,
                                   llvm::StringRef name);
@@ -13,14 +13,29 @@
 #include "Plugins/SymbolFile/DWARF/LogChannelDWARF.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARFDwo.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Host/FileSystem.h"
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataBufferLLVM.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Log.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb_private;
 using namespace lldb;
 
+// Identifies the index cache files. The version must be bumped whenever the
+// format of the files or the contents of the index change.
+static const uint32_t g_index_cache_magic = 0x5844574c; // "LWDX"
+static const uint32_t g_index_cache_version = 2;
+
 void ManualDWARFIndex::Index() {
   if (!m_debug_info)
     return;
@@ -31,6 +46,15 @@ void ManualDWARFIndex::Index() {
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(func_cat, "%p", static_cast<void *>(&debug_info));
 
+  llvm::Optional<FileSpec> cache_file = GetCacheFile();
+  llvm::Optional<uint64_t> cache_signature;
+  if (cache_file)
+    cache_signature = GetCacheSignature(debug_info);
+  if (!cache_signature)
+    cache_file = llvm::None;
+  if (cache_file && LoadFromCache(*cache_file, *cache_signature))
+    return;
+
   std::vector<DWARFUnit *> units_to_index;
   units_to_index.reserve(debug_info.GetNumUnits());
   for (size_t U = 0; U < debug_info.GetNumUnits(); ++U) {
@@ -85,6 +109,151 @@ void ManualDWARFIndex::Index() {
                      [&]() { finalize_fn(&IndexSet::globals); },
                      [&]() { finalize_fn(&IndexSet::types); },
                      [&]() { finalize_fn(&IndexSet::namespaces); });
+
+  if (cache_file)
+    SaveToCache(*cache_file, *cache_signature);
+}
+
+void ManualDWARFIndex::IndexSet::Encode(llvm::raw_ostream &os) const {
+  function_basenames.Encode(os);
+  function_fullnames.Encode(os);
+  function_methods.Encode(os);
+  function_selectors.Encode(os);
+  objc_class_selectors.Encode(os);
+  globals.Encode(os);
+  types.Encode(os);
+  namespaces.Encode(os);
+}
+
+bool ManualDWARFIndex::IndexSet::Decode(const DataExtractor &data,
+                                        lldb::offset_t *offset_ptr) {
+  return function_basenames.Decode(data, offset_ptr) &&
+         function_fullnames.Decode(data, offset_ptr) &&
+         function_methods.Decode(data, offset_ptr) &&
+         function_selectors.Decode(data, offset_ptr) &&
+         objc_class_selectors.Decode(data, offset_ptr) &&
+         globals.Decode(data, offset_ptr) && types.Decode(data, offset_ptr) &&
+         namespaces.Decode(data, offset_ptr);
+}
+
+llvm::Optional<FileSpec> ManualDWARFIndex::GetCacheFile() {
+  // The units to avoid are indexed elsewhere, so only the indexes of whole
+  // modules are cached.
+  if (!m_units_to_avoid.empty())
+    return llvm::None;
+  FileSpec file = SymbolFileDWARF::GetIndexCachePath();
+  const UUID &uuid = m_module.GetUUID();
+  if (!file || !uuid.IsValid())
+    return llvm::None;
+  file.AppendPathComponent(uuid.GetAsString("") + ".dwarf-index");
+  return file;
+}
+
+llvm::Optional<uint64_t>
+ManualDWARFIndex::GetCacheSignature(DWARFDebugInfo &debug_info) {
+  llvm::MD5 hash;
+  auto add_file = [&hash](const FileSpec &file) {
+    hash.update(file.GetPath());
+    hash.update(llvm::utostr(FileSystem::Instance()
+                                 .GetModificationTime(file)
+                                 .time_since_epoch()
+                                 .count()));
+    hash.update(llvm::StringRef("\0", 1));
+  };
+  add_file(m_module.GetFileSpec());
+  if (const FileSpec &symfile = m_module.GetSymbolFileFileSpec())
+    add_file(symfile);
+
+  // The index also holds the DIEs of the .dwo files of the skeleton units.
+  for (size_t U = 0; U < debug_info.GetNumUnits(); ++U) {
+    DWARFUnit *unit = debug_info.GetUnitAtIndex(U);
+    if (!unit)
+      continue;
+    DWARFBaseDIE unit_die = unit->GetUnitDIEOnly();
+    if (!unit_die.GetAttributeValueAsString(DW_AT_GNU_dwo_name, nullptr))
+      continue;
+    SymbolFileDWARFDwo *dwo_symbol_file = unit->GetDwoSymbolFile();
+    if (!dwo_symbol_file || !dwo_symbol_file->GetObjectFile()) {
+      Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS);
+      LLDB_LOG(log,
+               "not caching the DWARF index of {0}: the .dwo file of the unit "
+               "at .debug_info[{1:x8}] was not loaded",
+               m_module.GetFileSpec(), unit->GetOffset());
+      return llvm::None;
+    }
+    hash.update(llvm::utostr(
+        unit_die.GetAttributeValueAsUnsigned(DW_AT_GNU_dwo_id, 0)));
+    add_file(dwo_symbol_file->GetObjectFile()->GetFileSpec());
+  }
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  return result.low();
+}
+
+bool ManualDWARFIndex::LoadFromCache(const FileSpec &file,
+                                     uint64_t signature) {
+  if (!FileSystem::Instance().Exists(file))
+    return false;
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS);
+  auto data_sp = FileSystem::Instance().CreateDataBuffer(file);
+  if (!data_sp) {
+    LLDB_LOG(log, "failed to read the DWARF index cache file {0}", file);
+    return false;
+  }
+  DataExtractor data(data_sp, eByteOrderLittle, 4);
+  lldb::offset_t offset = 0;
+  if (data.ValidOffsetForDataOfSize(0, 16) &&
+      data.GetU32(&offset) == g_index_cache_magic &&
+      data.GetU32(&offset) == g_index_cache_version &&
+      data.GetU64(&offset) == signature &&
+      m_set.Decode(data, &offset) && offset == data.GetByteSize()) {
+    LLDB_LOG(log, "loaded the DWARF index of {0} from {1}",
+             m_module.GetFileSpec(), file);
+    return true;
+  }
+  // Index the DWARF again, and overwrite the stale or corrupted file.
+  LLDB_LOG(log, "ignoring the DWARF index cache file {0}", file);
+  m_set = IndexSet();
+  return false;
+}
+
+void ManualDWARFIndex::SaveToCache(const FileSpec &file, uint64_t signature) {
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS);
+  const std::string path = file.GetPath();
+  // The index is written to a temporary file which is renamed, so that the
+  // other debugger sessions never read a partial file.
+  llvm::SmallString<128> temp_path;
+  int fd;
+  std::error_code ec =
+      llvm::sys::fs::create_directories(llvm::sys::path::parent_path(path));
+  if (!ec)
+    ec = llvm::sys::fs::createUniqueFile(path + "-%%%%%%.tmp", fd, temp_path);
+  if (ec) {
+    LLDB_LOG(log, "failed to save the DWARF index to {0}: {1}", path,
+             ec.message());
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    llvm::support::endian::Writer writer(os, llvm::support::little);
+    writer.write<uint32_t>(g_index_cache_magic);
+    writer.write<uint32_t>(g_index_cache_version);
+    writer.write<uint64_t>(signature);
+    m_set.Encode(os);
+    os.close();
+    if (os.has_error()) {
+      ec = os.error();
+      os.clear_error();
+    }
+  }
+  if (!ec)
+    ec = llvm::sys::fs::rename(temp_path, path);
+  if (ec) {
+    LLDB_LOG(log, "failed to save the DWARF index to {0}: {1}", path,
+             ec.message());
+    llvm::sys::fs::remove(temp_path);
+  }
 }
 
 void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, IndexSet &set) {
@@ -11,7 +11,9 @@
 
 #include "Plugins/SymbolFile/DWARF/DWARFIndex.h"
 #include "Plugins/SymbolFile/DWARF/NameToDIE.h"
+#include "lldb/Utility/FileSpec.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Optional.h"
 
 class DWARFDebugInfo;
 
@@ -54,8 +56,25 @@ private:
     NameToDIE globals;
     NameToDIE types;
     NameToDIE namespaces;
+
+    void Encode(llvm::raw_ostream &os) const;
+    bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr);
   };
   void Index();
+
+  /// Returns the file where the index of the module is cached, or None if the
+  /// index isn't cached.
+  llvm::Optional<FileSpec> GetCacheFile();
+  /// Returns a hash of the path and modification time of the files the index
+  /// is built from: the module, its separate symbol file, and the .dwo or .dwp
+  /// file of each skeleton unit, with its DWO id. A cache file is only loaded
+  /// if it was saved with the same signature. Returns None, and the index
+  /// isn't cached, if the .dwo file of a skeleton unit wasn't loaded, as the
+  /// index would then miss its DIEs.
+  llvm::Optional<uint64_t> GetCacheSignature(DWARFDebugInfo &debug_info);
+  bool LoadFromCache(const FileSpec &file, uint64_t signature);
+  void SaveToCache(const FileSpec &file, uint64_t signature);
+
   void IndexUnit(DWARFUnit &unit, IndexSet &set);
 
   static void IndexUnitImpl(DWARFUnit &unit,
@@ -10,9 +10,11 @@
 #include "DWARFUnit.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/Support/EndianStream.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -76,3 +78,73 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+// The entries are encoded by name, as the finalized map keeps the entries of a
+// name together:
+//   uint32_t name count
+//   for each name:
+//     null-terminated name
+//     uint32_t DIE count
+//     for each DIE:
+//       uint32_t dwo number, or UINT32_MAX if the DIE is in the main file
+//       uint8_t section
+//       uint32_t DIE offset
+void NameToDIE::Encode(llvm::raw_ostream &os) const {
+  llvm::support::endian::Writer writer(os, llvm::support::little);
+  const uint32_t size = m_map.GetSize();
+  uint32_t num_names = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    if (i == 0 || m_map.GetCStringAtIndexUnchecked(i) !=
+                      m_map.GetCStringAtIndexUnchecked(i - 1))
+      ++num_names;
+  }
+  writer.write<uint32_t>(num_names);
+  for (uint32_t i = 0; i < size;) {
+    ConstString name = m_map.GetCStringAtIndexUnchecked(i);
+    uint32_t end = i + 1;
+    while (end < size && m_map.GetCStringAtIndexUnchecked(end) == name)
+      ++end;
+    os << name.GetStringRef() << '\0';
+    writer.write<uint32_t>(end - i);
+    for (; i < end; ++i) {
+      const DIERef &die_ref = m_map.GetValueAtIndexUnchecked(i);
+      writer.write<uint32_t>(die_ref.dwo_num().getValueOr(UINT32_MAX));
+      writer.write<uint8_t>(die_ref.section());
+      writer.write<uint32_t>(die_ref.die_offset());
+    }
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr) {
+  const uint32_t entry_size = 9;
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 4))
+    return false;
+  const uint32_t num_names = data.GetU32(offset_ptr);
+  for (uint32_t i = 0; i < num_names; ++i) {
+    const char *name = data.GetCStr(offset_ptr);
+    if (!name || !data.ValidOffsetForDataOfSize(*offset_ptr, 4))
+      return false;
+    const uint32_t num_dies = data.GetU32(offset_ptr);
+    if (!data.ValidOffsetForDataOfSize(*offset_ptr,
+                                       lldb::offset_t(num_dies) * entry_size))
+      return false;
+    ConstString name_cstr(name);
+    for (uint32_t j = 0; j < num_dies; ++j) {
+      const uint32_t dwo_num = data.GetU32(offset_ptr);
+      const uint8_t section = data.GetU8(offset_ptr);
+      const dw_offset_t die_offset = data.GetU32(offset_ptr);
+      // DIERef keeps 30 bits of the dwo number.
+      if (section > DIERef::DebugTypes ||
+          (dwo_num != UINT32_MAX && dwo_num >= (1u << 30)))
+        return false;
+      llvm::Optional<uint32_t> dwo;
+      if (dwo_num != UINT32_MAX)
+        dwo = dwo_num;
+      m_map.Append(name_cstr,
+                   DIERef(dwo, static_cast<DIERef::Section>(section),
+                          die_offset));
+    }
+  }
+  Finalize();
+  return true;
+}
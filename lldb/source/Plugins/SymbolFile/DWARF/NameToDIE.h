@@ -15,9 +15,18 @@
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/dwarf.h"
 #include "lldb/lldb-defines.h"
+#include "lldb/lldb-types.h"
 
 class DWARFUnit;
 
+namespace lldb_private {
+class DataExtractor;
+}
+
+namespace llvm {
+class raw_ostream;
+}
+
 class NameToDIE {
 public:
   NameToDIE() : m_map() {}
@@ -46,6 +55,15 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  /// Writes the entries of the map to \p os, in the format read by Decode.
+  /// The map must be finalized.
+  void Encode(llvm::raw_ostream &os) const;
+
+  /// Appends the entries encoded at \p *offset_ptr in \p data, and finalizes
+  /// the map. Returns false if the data is malformed.
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
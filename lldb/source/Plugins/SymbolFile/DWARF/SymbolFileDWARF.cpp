@@ -144,6 +144,11 @@ public:
     return m_collection_sp->GetPropertyAtIndexAsBoolean(
         nullptr, ePropertyIgnoreIndexes, false);
   }
+
+  FileSpec GetIndexCachePath() const {
+    return m_collection_sp->GetPropertyAtIndexAsFileSpec(
+        nullptr, ePropertyIndexCachePath);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -218,6 +223,10 @@ FileSpecList SymbolFileDWARF::GetSymlinkPaths() {
   return GetGlobalPluginProperties()->GetSymLinkPaths();
 }
 
+FileSpec SymbolFileDWARF::GetIndexCachePath() {
+  return GetGlobalPluginProperties()->GetIndexCachePath();
+}
+
 void SymbolFileDWARF::Initialize() {
   LogChannelDWARF::Initialize();
   PluginManager::RegisterPlugin(GetPluginNameStatic(),
@@ -83,6 +83,8 @@ public:
 
   static lldb_private::FileSpecList GetSymlinkPaths();
 
+  static lldb_private::FileSpec GetIndexCachePath();
+
   // Constructors and Destructors
 
   SymbolFileDWARF(lldb::ObjectFileSP objfile_sp,
@@ -15,6 +15,7 @@
 #include "lldb/Core/RichManglingContext.h"
 #include "lldb/Core/STLUtils.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -250,6 +251,18 @@ static bool lldb_skip_name(llvm::StringRef mangled,
   llvm_unreachable("unknown scheme!");
 }
 
+// The number of symbols indexed by each task of InitNameIndexes. Each task
+// instantiates its own demangler, so the chunks shouldn't be too small.
+static const uint32_t g_index_chunk_size = 16 * 1024;
+
+static void AppendEntries(Symtab::NameToIndexMap &to,
+                          const Symtab::NameToIndexMap &from) {
+  const size_t size = from.GetSize();
+  for (size_t i = 0; i < size; ++i)
+    to.Append(from.GetCStringAtIndexUnchecked(i),
+              from.GetValueAtIndexUnchecked(i));
+}
+
 void Symtab::InitNameIndexes() {
   // Protected function, no need to lock mutex...
   if (!m_name_indexes_computed) {
@@ -260,72 +273,43 @@ void Symtab::InitNameIndexes() {
     const size_t num_symbols = m_symbols.size();
     m_name_to_index.Reserve(num_symbols);
 
-    // The "const char *" in "class_contexts" and backlog::value_type::second
-    // must come from a ConstString::GetCString()
+    // Demangling the names dominates, so the symbols are indexed in chunks in
+    // parallel. The indexes of the chunks are merged in the order of the
+    // symbols, so that the result doesn't depend on the scheduling. When the
+    // symbol table is loaded from a task of the pool, e.g. while indexing
+    // DWARF, the chunks are indexed serially so that the pool can't deadlock.
+    const size_t num_chunks =
+        (num_symbols + g_index_chunk_size - 1) / g_index_chunk_size;
+    std::vector<NameIndexes> chunks(num_chunks);
+    auto index_chunk = [&](size_t chunk) {
+      const uint32_t begin = chunk * g_index_chunk_size;
+      const uint32_t end =
+          std::min<size_t>(num_symbols, begin + g_index_chunk_size);
+      IndexSymbolNames(begin, end, chunks[chunk]);
+    };
+    if (num_chunks == 1 || TaskPool::IsWorkerThread()) {
+      for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+        index_chunk(chunk);
+    } else {
+      TaskMapOverInt(0, num_chunks, index_chunk);
+    }
+
     std::set<const char *> class_contexts;
     std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
-    backlog.reserve(num_symbols / 2);
-
-    // Instantiation of the demangler is expensive, so better use a single one
-    // for all entries during batch processing.
-    RichManglingContext rmc;
-    for (uint32_t value = 0; value < num_symbols; ++value) {
-      Symbol *symbol = &m_symbols[value];
-
-      // Don't let trampolines get into the lookup by name map If we ever need
-      // the trampoline symbols to be searchable by name we can remove this and
-      // then possibly add a new bool to any of the Symtab functions that
-      // lookup symbols by name to indicate if they want trampolines.
-      if (symbol->IsTrampoline())
-        continue;
-
-      // If the symbol's name string matched a Mangled::ManglingScheme, it is
-      // stored in the mangled field.
-      Mangled &mangled = symbol->GetMangled();
-      if (ConstString name = mangled.GetMangledName()) {
-        m_name_to_index.Append(name, value);
-
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          ConstString stripped = ConstString(
-              m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
-          m_name_to_index.Append(stripped, value);
-        }
-
-        const SymbolType type = symbol->GetType();
-        if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
-          if (mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
-            RegisterMangledNameEntry(value, class_contexts, backlog, rmc);
-        }
-      }
-
-      // Symbol name strings that didn't match a Mangled::ManglingScheme, are
-      // stored in the demangled field.
-      if (ConstString name = mangled.GetDemangledName(symbol->GetLanguage())) {
-        m_name_to_index.Append(name, value);
-
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          name = ConstString(
-              m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
-          m_name_to_index.Append(name, value);
-        }
-
-        // If the demangled name turns out to be an ObjC name, and is a category
-        // name, add the version without categories to the index too.
-        ObjCLanguage::MethodName objc_method(name.GetStringRef(), true);
-        if (objc_method.IsValid(true)) {
-          m_selector_to_index.Append(objc_method.GetSelector(), value);
-
-          if (ConstString objc_method_no_category =
-                  objc_method.GetFullNameWithoutCategory(true))
-            m_name_to_index.Append(objc_method_no_category, value);
-        }
-      }
+    for (NameIndexes &chunk : chunks) {
+      AppendEntries(m_name_to_index, chunk.name_to_index);
+      AppendEntries(m_basename_to_index, chunk.basename_to_index);
+      AppendEntries(m_method_to_index, chunk.method_to_index);
+      AppendEntries(m_selector_to_index, chunk.selector_to_index);
+      class_contexts.insert(chunk.class_contexts.begin(),
+                            chunk.class_contexts.end());
+      backlog.insert(backlog.end(), chunk.backlog.begin(),
+                     chunk.backlog.end());
+      chunk = NameIndexes();
     }
 
+    // The methods whose class context was only known by another chunk are in
+    // the backlog too.
     for (const auto &record : backlog) {
       RegisterBacklogEntry(record.first, record.second, class_contexts);
     }
@@ -341,10 +325,73 @@ void Symtab::InitNameIndexes() {
   }
 }
 
-void Symtab::RegisterMangledNameEntry(
-    uint32_t value, std::set<const char *> &class_contexts,
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-    RichManglingContext &rmc) {
+void Symtab::IndexSymbolNames(uint32_t begin, uint32_t end,
+                              NameIndexes &indexes) {
+  indexes.backlog.reserve((end - begin) / 2);
+
+  // Instantiation of the demangler is expensive, so better use a single one
+  // for all entries during batch processing.
+  RichManglingContext rmc;
+  for (uint32_t value = begin; value < end; ++value) {
+    Symbol *symbol = &m_symbols[value];
+
+    // Don't let trampolines get into the lookup by name map If we ever need
+    // the trampoline symbols to be searchable by name we can remove this and
+    // then possibly add a new bool to any of the Symtab functions that
+    // lookup symbols by name to indicate if they want trampolines.
+    if (symbol->IsTrampoline())
+      continue;
+
+    // If the symbol's name string matched a Mangled::ManglingScheme, it is
+    // stored in the mangled field.
+    Mangled &mangled = symbol->GetMangled();
+    if (ConstString name = mangled.GetMangledName()) {
+      indexes.name_to_index.Append(name, value);
+
+      if (symbol->ContainsLinkerAnnotations()) {
+        // If the symbol has linker annotations, also add the version without
+        // the annotations.
+        ConstString stripped = ConstString(
+            m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
+        indexes.name_to_index.Append(stripped, value);
+      }
+
+      const SymbolType type = symbol->GetType();
+      if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
+        if (mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
+          RegisterMangledNameEntry(value, indexes, rmc);
+      }
+    }
+
+    // Symbol name strings that didn't match a Mangled::ManglingScheme, are
+    // stored in the demangled field.
+    if (ConstString name = mangled.GetDemangledName(symbol->GetLanguage())) {
+      indexes.name_to_index.Append(name, value);
+
+      if (symbol->ContainsLinkerAnnotations()) {
+        // If the symbol has linker annotations, also add the version without
+        // the annotations.
+        name = ConstString(
+            m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
+        indexes.name_to_index.Append(name, value);
+      }
+
+      // If the demangled name turns out to be an ObjC name, and is a category
+      // name, add the version without categories to the index too.
+      ObjCLanguage::MethodName objc_method(name.GetStringRef(), true);
+      if (objc_method.IsValid(true)) {
+        indexes.selector_to_index.Append(objc_method.GetSelector(), value);
+
+        if (ConstString objc_method_no_category =
+                objc_method.GetFullNameWithoutCategory(true))
+          indexes.name_to_index.Append(objc_method_no_category, value);
+      }
+    }
+  }
+}
+
+void Symtab::RegisterMangledNameEntry(uint32_t value, NameIndexes &indexes,
+                                      RichManglingContext &rmc) {
   // Only register functions that have a base name.
   rmc.ParseFunctionBaseName();
   llvm::StringRef base_name = rmc.GetBufferRef();
@@ -360,36 +407,36 @@ void Symtab::RegisterMangledNameEntry(
   // Register functions with no context.
   if (decl_context.empty()) {
     // This has to be a basename
-    m_basename_to_index.Append(entry);
+    indexes.basename_to_index.Append(entry);
     // If there is no context (no namespaces or class scopes that come before
     // the function name) then this also could be a fullname.
-    m_name_to_index.Append(entry);
+    indexes.name_to_index.Append(entry);
     return;
   }
 
   // Make sure we have a pool-string pointer and see if we already know the
   // context name.
   const char *decl_context_ccstr = ConstString(decl_context).GetCString();
-  auto it = class_contexts.find(decl_context_ccstr);
+  auto it = indexes.class_contexts.find(decl_context_ccstr);
 
   // Register constructors and destructors. They are methods and create
   // declaration contexts.
   if (rmc.IsCtorOrDtor()) {
-    m_method_to_index.Append(entry);
-    if (it == class_contexts.end())
-      class_contexts.insert(it, decl_context_ccstr);
+    indexes.method_to_index.Append(entry);
+    if (it == indexes.class_contexts.end())
+      indexes.class_contexts.insert(it, decl_context_ccstr);
     return;
   }
 
   // Register regular methods with a known declaration context.
-  if (it != class_contexts.end()) {
-    m_method_to_index.Append(entry);
+  if (it != indexes.class_contexts.end()) {
+    indexes.method_to_index.Append(entry);
     return;
   }
 
   // Regular methods in unknown declaration contexts are put to the backlog. We
   // will revisit them once we processed all remaining symbols.
-  backlog.push_back(std::make_pair(entry, decl_context_ccstr));
+  indexes.backlog.push_back(std::make_pair(entry, decl_context_ccstr));
 }
 
 void Symtab::RegisterBacklogEntry(
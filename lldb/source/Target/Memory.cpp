@@ -13,6 +13,7 @@
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/State.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
 
@@ -224,17 +225,46 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_up->GetBytes(),
-            data_buffer_heap_up->GetByteSize(), error);
+        // Read all the missing cache lines that the request spans at once, as
+        // every read is a round trip for remote processes.
+        const addr_t end_addr = curr_addr + cache_offset + bytes_left;
+        size_t num_lines = 1;
+        for (addr_t line_addr = curr_addr + cache_line_byte_size;
+             line_addr < end_addr; line_addr += cache_line_byte_size) {
+          if (m_L2_cache.count(line_addr) ||
+              m_invalid_ranges.FindEntryThatContains(line_addr))
+            break;
+          ++num_lines;
+        }
+
+        DataBufferHeap data_buffer(num_lines * cache_line_byte_size, 0);
+        size_t process_bytes_read = 0;
+        if (num_lines > 1) {
+          process_bytes_read = m_process.ReadMemoryFromInferior(
+              curr_addr, data_buffer.GetBytes(), data_buffer.GetByteSize(),
+              error);
+          // Some stubs fail the whole read if any of it is unreadable, so
+          // retry with the first line only.
+          if (process_bytes_read == 0) {
+            error.Clear();
+            num_lines = 1;
+          }
+        }
+        if (num_lines == 1)
+          process_bytes_read = m_process.ReadMemoryFromInferior(
+              curr_addr, data_buffer.GetBytes(), cache_line_byte_size, error);
         if (process_bytes_read == 0)
           return dst_len - bytes_left;
 
-        if (process_bytes_read != cache_line_byte_size)
-          data_buffer_heap_up->SetByteSize(process_bytes_read);
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_up.release());
+        // A line that was only partially read is the last one, and it keeps
+        // the bytes that could be read.
+        for (size_t offset = 0; offset < process_bytes_read;
+             offset += cache_line_byte_size) {
+          const size_t line_size = std::min<size_t>(
+              cache_line_byte_size, process_bytes_read - offset);
+          m_L2_cache[curr_addr + offset] = std::make_shared<DataBufferHeap>(
+              data_buffer.GetBytes() + offset, line_size);
+        }
         // We have read data and put it into the cache, continue through the
         // loop again to get the data out of the cache...
       }
@@ -0,0 +1,45 @@
+# Check the report of lldb-test benchmark, with a target whose path would
+# need quoting on a command line.
+
+# REQUIRES: x86
+
+# RUN: rm -rf %t && mkdir -p '%t/a "quoted" dir'
+# RUN: llvm-mc -triple x86_64-pc-linux %s -filetype=obj \
+# RUN:   -o '%t/a "quoted" dir/main.o'
+# RUN: echo '# Comments and blank lines are skipped.' > %t/commands
+# RUN: echo '' >> %t/commands
+# RUN: echo 'breakpoint set -n main' >> %t/commands
+# RUN: echo 'not-a-command' >> %t/commands
+# RUN: not lldb-test benchmark '%t/a "quoted" dir/main.o' %t/commands \
+# RUN:   | FileCheck %s
+
+# CHECK:      {
+# CHECK-NEXT:   "target": "{{.*}}/a \"quoted\" dir/main.o",
+# CHECK-NEXT:   "commands": [
+# CHECK-NEXT:     {
+# CHECK-NEXT:       "command": "target create",
+# CHECK-NEXT:       "seconds": {{[0-9.e+-]+}},
+# CHECK-NEXT:       "malloc_bytes": {{[0-9]+}}
+# CHECK-NEXT:     },
+# CHECK-NEXT:     {
+# CHECK-NEXT:       "command": "breakpoint set -n main",
+# CHECK-NEXT:       "seconds": {{[0-9.e+-]+}},
+# CHECK-NEXT:       "malloc_bytes": {{[0-9]+}}
+# CHECK-NEXT:     },
+# CHECK-NEXT:     {
+# CHECK-NEXT:       "command": "not-a-command",
+# CHECK-NEXT:       "seconds": {{[0-9.e+-]+}},
+# CHECK-NEXT:       "malloc_bytes": {{[0-9]+}},
+# CHECK-NEXT:       "error": "error: {{.*}}not-a-command{{.*}}"
+# CHECK-NEXT:     }
+# CHECK-NEXT:   ]
+# CHECK-NEXT: }
+
+        .text
+        .globl  main
+        .type   main,@function
+main:
+        xorl    %eax, %eax
+        retq
+.Lmain_end:
+        .size   main, .Lmain_end-main
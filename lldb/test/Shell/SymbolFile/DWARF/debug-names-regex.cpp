@@ -0,0 +1,38 @@
+// REQUIRES: lld
+
+// Check that a regular expression lookup finds the functions of every name
+// index of a linked .debug_names section. The name indexes are searched in
+// parallel.
+
+// RUN: %clang %s -g -c -o %t-1.o --target=x86_64-pc-linux -mllvm \
+// RUN:   -accel-tables=Dwarf -DFIRST
+// RUN: %clang %s -g -c -o %t-2.o --target=x86_64-pc-linux -mllvm \
+// RUN:   -accel-tables=Dwarf
+// RUN: ld.lld %t-1.o %t-2.o -o %t
+// RUN: llvm-dwarfdump --debug-names %t | FileCheck --check-prefix=NAMES %s
+// RUN: lldb-test symbols --find=function --regex --name='^fo+$' %t | \
+// RUN:   FileCheck %s
+// RUN: lldb-test symbols --find=variable --regex --name='^va[rl]$' %t | \
+// RUN:   FileCheck --check-prefix=VAR %s
+
+// NAMES-COUNT-2: Name Index @
+
+// CHECK: Found 2 functions:
+// CHECK-DAG: name = "foo"
+// CHECK-DAG: name = "foooo"
+
+// VAR: Found 2 variables:
+// VAR-DAG: name = "var"
+// VAR-DAG: name = "val"
+
+extern "C" {
+#ifdef FIRST
+int var;
+void foo() {}
+void bar() {}
+#else
+int val;
+void foooo() {}
+int main() {}
+#endif
+}
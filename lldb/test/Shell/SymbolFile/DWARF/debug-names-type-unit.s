@@ -0,0 +1,133 @@
+# Check that the type units listed in a .debug_names index are found through
+# it, and not by indexing them manually as well.
+
+# REQUIRES: x86
+
+# RUN: llvm-mc -triple x86_64-pc-linux %s -filetype=obj -o %t
+# RUN: lldb-test symbols --find=type --name=bar %t | FileCheck %s
+
+# CHECK: Found 1 types:
+# CHECK: name = "bar", size = 4
+
+        .section .debug_str,"MS",@progbits,1
+.Lstr_bar:
+        .asciz "bar"
+.Lstr_foo:
+        .asciz "foo"
+
+        .section .debug_abbrev,"",@progbits
+        .byte 1                         # Abbreviation Code
+        .byte 17                        # DW_TAG_compile_unit
+        .byte 1                         # DW_CHILDREN_yes
+        .byte 3                         # DW_AT_name
+        .byte 8                         # DW_FORM_string
+        .byte 19                        # DW_AT_language
+        .byte 5                         # DW_FORM_data2
+        .byte 0                         # EOM(1)
+        .byte 0                         # EOM(2)
+        .byte 2                         # Abbreviation Code
+        .byte 52                        # DW_TAG_variable
+        .byte 0                         # DW_CHILDREN_no
+        .byte 3                         # DW_AT_name
+        .byte 8                         # DW_FORM_string
+        .byte 0                         # EOM(1)
+        .byte 0                         # EOM(2)
+        .byte 3                         # Abbreviation Code
+        .byte 65                        # DW_TAG_type_unit
+        .byte 1                         # DW_CHILDREN_yes
+        .byte 19                        # DW_AT_language
+        .byte 5                         # DW_FORM_data2
+        .byte 0                         # EOM(1)
+        .byte 0                         # EOM(2)
+        .byte 4                         # Abbreviation Code
+        .byte 19                        # DW_TAG_structure_type
+        .byte 0                         # DW_CHILDREN_no
+        .byte 3                         # DW_AT_name
+        .byte 8                         # DW_FORM_string
+        .byte 11                        # DW_AT_byte_size
+        .byte 11                        # DW_FORM_data1
+        .byte 0                         # EOM(1)
+        .byte 0                         # EOM(2)
+        .byte 0                         # EOM(3)
+
+        .section .debug_info,"",@progbits
+.Lcu_begin0:
+        .long .Lcu_end0-.Lcu_start0     # Length of Unit
+.Lcu_start0:
+        .short 5                        # DWARF version number
+        .byte 1                         # DWARF Unit Type
+        .byte 8                         # Address Size (in bytes)
+        .long .debug_abbrev             # Offset Into Abbrev. Section
+        .byte 1                         # Abbrev [1] DW_TAG_compile_unit
+        .asciz "a.cpp"                  # DW_AT_name
+        .short 4                        # DW_AT_language
+.Lfoo_die:
+        .byte 2                         # Abbrev [2] DW_TAG_variable
+        .asciz "foo"                    # DW_AT_name
+        .byte 0                         # End Of Children Mark
+.Lcu_end0:
+
+.Ltu_begin0:
+        .long .Ltu_end0-.Ltu_start0     # Length of Unit
+.Ltu_start0:
+        .short 5                        # DWARF version number
+        .byte 2                         # DWARF Unit Type
+        .byte 8                         # Address Size (in bytes)
+        .long .debug_abbrev             # Offset Into Abbrev. Section
+        .quad 0x1122334455667788        # Type Signature
+        .long .Lbar_die-.Ltu_begin0     # Type DIE Offset
+        .byte 3                         # Abbrev [3] DW_TAG_type_unit
+        .short 4                        # DW_AT_language
+.Lbar_die:
+        .byte 4                         # Abbrev [4] DW_TAG_structure_type
+        .asciz "bar"                    # DW_AT_name
+        .byte 4                         # DW_AT_byte_size
+        .byte 0                         # End Of Children Mark
+.Ltu_end0:
+
+        .section .debug_names,"",@progbits
+        .long .Lnames_end0-.Lnames_start0 # Header: unit length
+.Lnames_start0:
+        .short 5                        # Header: version
+        .short 0                        # Header: padding
+        .long 1                         # Header: compilation unit count
+        .long 1                         # Header: local type unit count
+        .long 0                         # Header: foreign type unit count
+        .long 0                         # Header: bucket count
+        .long 2                         # Header: name count
+        .long .Lnames_abbrev_end0-.Lnames_abbrev_start0 # Header: abbreviation table size
+        .long 0                         # Header: augmentation string size
+        .long .Lcu_begin0               # Compilation unit 0
+        .long .Ltu_begin0               # Local type unit 0
+        .long .Lstr_bar                 # String: bar
+        .long .Lstr_foo                 # String: foo
+        .long .Lnames0-.Lnames_entries0 # Entry offset
+        .long .Lnames1-.Lnames_entries0 # Entry offset
+.Lnames_abbrev_start0:
+        .byte 1                         # Abbrev code
+        .byte 52                        # DW_TAG_variable
+        .byte 3                         # DW_IDX_die_offset
+        .byte 19                        # DW_FORM_ref4
+        .byte 0                         # End of abbrev
+        .byte 0                         # End of abbrev
+        .byte 2                         # Abbrev code
+        .byte 19                        # DW_TAG_structure_type
+        .byte 2                         # DW_IDX_type_unit
+        .byte 11                        # DW_FORM_data1
+        .byte 3                         # DW_IDX_die_offset
+        .byte 19                        # DW_FORM_ref4
+        .byte 0                         # End of abbrev
+        .byte 0                         # End of abbrev
+        .byte 0                         # End of abbrev list
+.Lnames_abbrev_end0:
+.Lnames_entries0:
+.Lnames0:
+        .byte 2                         # Abbreviation code
+        .byte 0                         # DW_IDX_type_unit
+        .long .Lbar_die-.Ltu_begin0     # DW_IDX_die_offset
+        .byte 0                         # End of list: bar
+.Lnames1:
+        .byte 1                         # Abbreviation code
+        .long .Lfoo_die-.Lcu_begin0     # DW_IDX_die_offset
+        .byte 0                         # End of list: foo
+.Lnames_end0:
@@ -36,12 +36,15 @@
 #include "llvm/ADT/IntervalMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/WithColor.h"
+#include <chrono>
 #include <cstdio>
 #include <thread>
 
@@ -56,12 +59,15 @@ cl::SubCommand ObjectFileSubcommand("object-file",
                                     "Display LLDB object file information");
 cl::SubCommand SymbolsSubcommand("symbols", "Dump symbols for an object file");
 cl::SubCommand IRMemoryMapSubcommand("ir-memory-map", "Test IRMemoryMap");
+cl::SubCommand BenchmarkSubcommand("benchmark",
+                                   "Measure the latency of debugger commands");
 
 cl::opt<std::string> Log("log", cl::desc("Path to a log file"), cl::init(""),
                          cl::sub(BreakpointSubcommand),
                          cl::sub(ObjectFileSubcommand),
                          cl::sub(SymbolsSubcommand),
-                         cl::sub(IRMemoryMapSubcommand));
+                         cl::sub(IRMemoryMapSubcommand),
+                         cl::sub(BenchmarkSubcommand));
 
 /// Create a target using the file pointed to by \p Filename, or abort.
 TargetSP createTarget(Debugger &Dbg, const std::string &Filename);
@@ -223,6 +229,17 @@ bool evalFree(StringRef Line, IRMemoryMapTestState &State);
 int evaluateMemoryMapCommands(Debugger &Dbg);
 } // namespace irmemorymap
 
+namespace benchmark {
+static cl::opt<std::string> Target(cl::Positional, cl::desc("<target>"),
+                                   cl::Required, cl::sub(BenchmarkSubcommand));
+static cl::opt<std::string> CommandFile(cl::Positional,
+                                        cl::desc("<command-file>"),
+                                        cl::init("-"),
+                                        cl::sub(BenchmarkSubcommand));
+
+static int runBenchmark(Debugger &Dbg);
+} // namespace benchmark
+
 } // namespace opts
 
 std::vector<CompilerContext> parseCompilerContext() {
@@ -378,6 +395,82 @@ int opts::breakpoint::evaluateBreakpoints(Debugger &Dbg) {
   return HadErrors;
 }
 
+/// Creates a target for benchmark::Target, then runs the commands of
+/// benchmark::CommandFile, one per line, and prints a JSON report of the
+/// wall-clock time each of them took and of the heap usage after it ran. The
+/// target creation is reported as the first command.
+int opts::benchmark::runBenchmark(Debugger &Dbg) {
+  const std::string &TargetPath = benchmark::Target;
+  std::unique_ptr<MemoryBuffer> MB = opts::openFile(benchmark::CommandFile);
+
+  std::vector<std::string> Commands;
+  StringRef Rest = MB->getBuffer();
+  while (!Rest.empty()) {
+    StringRef Line;
+    std::tie(Line, Rest) = Rest.split('\n');
+    Line = Line.ltrim().rtrim();
+    if (Line.empty() || Line[0] == '#')
+      continue;
+    Commands.push_back(Line.str());
+  }
+
+  int HadErrors = 0;
+  json::OStream JOS(outs(), /*IndentSize=*/2);
+  // Runs Action, which returns the error message of a failure or None, and
+  // reports it as Command.
+  auto Measure = [&](StringRef Command,
+                     function_ref<Optional<std::string>()> Action) {
+    auto Start = std::chrono::steady_clock::now();
+    Optional<std::string> Error = Action();
+    std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+
+    JOS.object([&] {
+      JOS.attribute("command", Command);
+      JOS.attribute("seconds", Elapsed.count());
+      JOS.attribute("malloc_bytes", int64_t(sys::Process::GetMallocUsage()));
+      if (Error)
+        JOS.attribute("error", *Error);
+    });
+    if (Error)
+      HadErrors = 1;
+  };
+
+  JOS.object([&] {
+    JOS.attribute("target", TargetPath);
+    JOS.attributeArray("commands", [&] {
+      // The target is created through the target list rather than by a
+      // "target create" command, so that no path needs quoting for the
+      // command interpreter.
+      Measure("target create", [&]() -> Optional<std::string> {
+        TargetSP Target;
+        Status ST = Dbg.GetTargetList().CreateTarget(
+            Dbg, TargetPath, /*triple*/ "", eLoadDependentsYes,
+            /*platform_options*/ nullptr, Target);
+        if (ST.Fail())
+          return std::string(ST.AsCString("unknown error"));
+        Dbg.GetTargetList().SetSelectedTarget(Target.get());
+        return None;
+      });
+      for (const std::string &Command : Commands)
+        Measure(Command, [&]() -> Optional<std::string> {
+          CommandReturnObject Result;
+          if (Dbg.GetCommandInterpreter().HandleCommand(
+                  Command.c_str(), /*add_to_history*/ eLazyBoolNo, Result))
+            return None;
+          return Result.GetErrorData().rtrim().str();
+        });
+    });
+  });
+  outs() << "\n";
+
+  // Don't leave behind the processes launched by the commands.
+  if (TargetSP Selected = Dbg.GetSelectedTarget())
+    if (ProcessSP Process = Selected->GetProcessSP())
+      Process->Destroy(/*force_kill*/ true);
+  return HadErrors;
+}
+
 Expected<CompilerDeclContext>
 opts::symbols::getDeclContext(SymbolFile &Symfile) {
   if (Context.empty())
@@ -1044,6 +1137,8 @@ int main(int argc, const char *argv[]) {
     return opts::symbols::dumpSymbols(*Dbg);
   if (opts::IRMemoryMapSubcommand)
     return opts::irmemorymap::evaluateMemoryMapCommands(*Dbg);
+  if (opts::BenchmarkSubcommand)
+    return opts::benchmark::runBenchmark(*Dbg);
 
   WithColor::error() << "No command specified.\n";
   return 1;
@@ -43,3 +43,26 @@ TEST(TaskPoolTest, TaskMap) {
   ASSERT_EQ(data[2], 4);
   ASSERT_EQ(data[3], 9);
 }
+
+TEST(TaskPoolTest, IsWorkerThread) {
+  ASSERT_FALSE(TaskPool::IsWorkerThread());
+  ASSERT_TRUE(TaskPool::AddTask([] { return TaskPool::IsWorkerThread(); })
+                  .get());
+}
+
+TEST(TaskPoolTest, NestedTaskMap) {
+  // Every worker waits for a nested map. The nested maps must not queue tasks
+  // behind their callers.
+  const size_t num_outer = 2 * GetHardwareConcurrencyHint();
+  std::vector<int> data(num_outer * 4);
+  auto fn = [&data](size_t outer) {
+    TaskMapOverInt(0, 4, [&data, outer](size_t inner) {
+      data[outer * 4 + inner] = outer * 4 + inner;
+    });
+  };
+
+  TaskMapOverInt(0, num_outer, fn);
+
+  for (size_t i = 0; i < data.size(); ++i)
+    ASSERT_EQ(data[i], static_cast<int>(i));
+}
@@ -290,6 +290,65 @@ Streams:
   EXPECT_EQ(llvm::None, parser->FindMemoryRange(0x7ffceb34a000 + 5));
 }
 
+TEST_F(MinidumpParserTest, FindMemoryRangeAdjacentAndEmpty) {
+  ASSERT_THAT_ERROR(SetUpFromYaml(R"(
+--- !minidump
+Streams:
+  - Type:            MemoryList
+    Memory Ranges:
+      - Start of Memory Range: 0x0000000000001004
+        Content:         '05060708'
+      - Start of Memory Range: 0x0000000000001004
+        Content:         ''
+      - Start of Memory Range: 0x0000000000001000
+        Content:         '01020304'
+...
+)"),
+                    llvm::Succeeded());
+  EXPECT_EQ(llvm::None, parser->FindMemoryRange(0xfff));
+  EXPECT_EQ((minidump::Range{0x1000, llvm::ArrayRef<uint8_t>{1, 2, 3, 4}}),
+            parser->FindMemoryRange(0x1003));
+  // The empty range at the same address doesn't hide the one with contents.
+  EXPECT_EQ((minidump::Range{0x1004, llvm::ArrayRef<uint8_t>{5, 6, 7, 8}}),
+            parser->FindMemoryRange(0x1004));
+  EXPECT_EQ(llvm::None, parser->FindMemoryRange(0x1008));
+}
+
+TEST_F(MinidumpParserTest, FindMemoryRangeOverlapping) {
+  ASSERT_THAT_ERROR(SetUpFromYaml(R"(
+--- !minidump
+Streams:
+  - Type:            MemoryList
+    Memory Ranges:
+      - Start of Memory Range: 0x0000000000001000
+        Content:         '0102030405060708'
+      - Start of Memory Range: 0x0000000000001002
+        Content:         'A3A4'
+      - Start of Memory Range: 0x0000000000001000
+        Content:         'B0'
+      - Start of Memory Range: 0x0000000000001006
+        Content:         'C6C7C8C9'
+...
+)"),
+                    llvm::Succeeded());
+  // The first range in the stream containing the address is found, even if
+  // a range nested in it, or one with the same start, comes later.
+  EXPECT_EQ((minidump::Range{0x1000, llvm::ArrayRef<uint8_t>{1, 2, 3, 4, 5, 6,
+                                                             7, 8}}),
+            parser->FindMemoryRange(0x1000));
+  EXPECT_EQ(0x1000u, parser->FindMemoryRange(0x1003)->start);
+  EXPECT_EQ(0x1000u, parser->FindMemoryRange(0x1007)->start);
+  EXPECT_EQ((llvm::ArrayRef<uint8_t>{4, 5}), parser->GetMemory(0x1003, 2));
+
+  // Past the end of the outer range, the overlapping one is found.
+  EXPECT_EQ((minidump::Range{0x1006, llvm::ArrayRef<uint8_t>{0xc6, 0xc7, 0xc8,
+                                                             0xc9}}),
+            parser->FindMemoryRange(0x1008));
+  EXPECT_EQ((llvm::ArrayRef<uint8_t>{0xc8, 0xc9}),
+            parser->GetMemory(0x1008, 4));
+  EXPECT_EQ(llvm::None, parser->FindMemoryRange(0x100a));
+}
+
 TEST_F(MinidumpParserTest, GetMemory) {
   ASSERT_THAT_ERROR(SetUpFromYaml(R"(
 --- !minidump
@@ -13,11 +13,13 @@
 #include "llvm/DebugInfo/PDB/PDBSymbolExe.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "Plugins/ObjectFile/PECOFF/ObjectFilePECOFF.h"
 #include "Plugins/SymbolFile/DWARF/DWARFAbbreviationDeclaration.h"
 #include "Plugins/SymbolFile/DWARF/DWARFDataExtractor.h"
 #include "Plugins/SymbolFile/DWARF/DWARFDebugAbbrev.h"
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "Plugins/SymbolFile/PDB/SymbolFilePDB.h"
 #include "TestingSupport/TestUtilities.h"
@@ -31,6 +33,7 @@
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/DataEncoder.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/FileSpec.h"
 #include "lldb/Utility/StreamString.h"
 
@@ -326,3 +329,36 @@ TEST_F(SymbolFileDWARFTests, TestAbbrevMissingTerminator) {
   EXPECT_EQ("abbreviation declaration attribute list not terminated with a "
             "null entry", llvm::toString(std::move(error)));
 }
+
+TEST_F(SymbolFileDWARFTests, TestNameToDIEEncodeDecode) {
+  NameToDIE map;
+  map.Insert(ConstString("foo"), DIERef(llvm::None, DIERef::DebugInfo, 0x10));
+  map.Insert(ConstString("bar"), DIERef(1, DIERef::DebugInfo, 0x20));
+  map.Insert(ConstString("foo"), DIERef(llvm::None, DIERef::DebugTypes, 0x30));
+  map.Finalize();
+
+  std::string buffer;
+  llvm::raw_string_ostream os(buffer);
+  map.Encode(os);
+  os.flush();
+
+  DataExtractor data(buffer.data(), buffer.size(), eByteOrderLittle, 4);
+  lldb::offset_t data_offset = 0;
+  NameToDIE decoded;
+  ASSERT_TRUE(decoded.Decode(data, &data_offset));
+  EXPECT_EQ(buffer.size(), data_offset);
+
+  DIEArray foo;
+  EXPECT_EQ(2u, decoded.Find(ConstString("foo"), foo));
+  DIEArray bar;
+  ASSERT_EQ(1u, decoded.Find(ConstString("bar"), bar));
+  EXPECT_EQ(llvm::Optional<uint32_t>(1), bar[0].dwo_num());
+  EXPECT_EQ(0x20u, bar[0].die_offset());
+
+  // Truncated data is rejected.
+  DataExtractor truncated(buffer.data(), buffer.size() - 1, eByteOrderLittle,
+                          4);
+  data_offset = 0;
+  NameToDIE partial;
+  EXPECT_FALSE(partial.Decode(truncated, &data_offset));
+}
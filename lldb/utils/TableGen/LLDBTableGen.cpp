@@ -70,7 +70,9 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &LLDBTableGenMain);
+  return TableGenMain(argv[0], &LLDBTableGenMain, [](StringRef Name) {
+    return selectTableGenAction(Action, Name);
+  });
 }
 
 #ifdef __has_feature
@@ -0,0 +1,68 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Demangle/Demangle.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Compares demangling the names of a symbol table one by one with
+// itaniumDemangle, which sets up a parser and an output buffer for each name,
+// against itaniumDemangleBatch, which reuses them across the names.
+
+// Names in the shapes of the symbols of a C++ binary: nested names, templates,
+// the std namespace, lambdas, special names and some which need a large AST.
+static const char *const SymbolShapes[] = {
+    "_Z3fooi",
+    "_ZN4llvm5TwineC2EPKc",
+    "_ZNK4llvm9StringRef4findEcm",
+    "_ZN4llvm8DenseMapIPKNS_5ValueEjNS_12DenseMapInfoIS3_EENS_6detail12DenseMapPa"
+    "irIS3_jEEE4growEj",
+    "_ZNSt6vectorINSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEEESaIS5_EE17_"
+    "M_realloc_insertIJRKS5_EEEvN9__gnu_cxx17__normal_iteratorIPS5_S7_EEDpOT_",
+    "_ZNSt3__110unique_ptrIN4llvm6ModuleENS_14default_deleteIS2_EEED2Ev",
+    "_ZZN4llvm3sys7Process6GetEnvEvENKUlvE_clEv",
+    "_ZTVN4llvm11raw_ostreamE",
+    "_ZTIN4llvm11raw_ostreamE",
+    "_ZGVZN4llvm2cl18getGeneralCategoryEvE15GeneralCategory",
+    "_ZN4llvm12function_refIFvRNS_8FunctionEEE11callback_fnIZNS_11PassManagerI"
+    "NS_6ModuleENS_15AnalysisManagerIS6_JEEEJEE3runERS6_RS8_EUlS2_E_EEvlS2_",
+    "main",
+};
+
+static std::vector<std::string> getSymbols() {
+  std::vector<std::string> Symbols;
+  for (int I = 0; I < 64; ++I)
+    for (const char *S : SymbolShapes)
+      Symbols.push_back(S);
+  return Symbols;
+}
+
+static void BM_ItaniumDemangle(benchmark::State &State) {
+  std::vector<std::string> Symbols = getSymbols();
+  for (auto _ : State) {
+    for (const std::string &S : Symbols) {
+      int Status;
+      char *Demangled = llvm::itaniumDemangle(S.c_str(), nullptr, nullptr,
+                                              &Status);
+      benchmark::DoNotOptimize(Demangled);
+      std::free(Demangled);
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * Symbols.size());
+}
+BENCHMARK(BM_ItaniumDemangle);
+
+static void BM_ItaniumDemangleBatch(benchmark::State &State) {
+  std::vector<std::string> Symbols = getSymbols();
+  std::vector<const char *> Names;
+  for (const std::string &S : Symbols)
+    Names.push_back(S.c_str());
+  std::vector<std::string> Results(Names.size());
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(
+        llvm::itaniumDemangleBatch(Names.data(), Names.size(), Results.data()));
+  }
+  State.SetItemsProcessed(State.iterations() * Symbols.size());
+}
+BENCHMARK(BM_ItaniumDemangleBatch);
+
+BENCHMARK_MAIN();
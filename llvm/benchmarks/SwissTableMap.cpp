@@ -0,0 +1,79 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SwissTableMap.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Compares DenseMap and SwissTableMap on pointer keys, which are the most
+// common keys of hot maps in LLVM. The argument is the number of entries.
+
+// Keys point to objects of a typical IR object size.
+struct Object {
+  int Data[16];
+};
+
+static std::vector<Object *> getKeys(std::vector<Object> &Storage, size_t N) {
+  Storage.resize(N * 2);
+  std::vector<Object *> Keys;
+  for (size_t I = 0; I < N * 2; ++I)
+    Keys.push_back(&Storage[I]);
+  std::shuffle(Keys.begin(), Keys.end(), std::mt19937(0));
+  return Keys;
+}
+
+template <typename MapT> static void BM_Insert(benchmark::State &State) {
+  std::vector<Object> Storage;
+  std::vector<Object *> Keys = getKeys(Storage, State.range(0));
+  Keys.resize(State.range(0));
+  for (auto _ : State) {
+    MapT M;
+    for (Object *K : Keys)
+      M[K] = 1;
+    benchmark::DoNotOptimize(M);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+// Looks up keys of which half are in the map.
+template <typename MapT> static void BM_Find(benchmark::State &State) {
+  std::vector<Object> Storage;
+  std::vector<Object *> Keys = getKeys(Storage, State.range(0));
+  MapT M;
+  for (size_t I = 0; I < Keys.size(); I += 2)
+    M[Keys[I]] = 1;
+  for (auto _ : State) {
+    unsigned Found = 0;
+    for (Object *K : Keys)
+      Found += M.count(K);
+    benchmark::DoNotOptimize(Found);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_EraseInsert(benchmark::State &State) {
+  std::vector<Object> Storage;
+  std::vector<Object *> Keys = getKeys(Storage, State.range(0));
+  MapT M;
+  for (size_t I = 0; I < Keys.size() / 2; ++I)
+    M[Keys[I]] = 1;
+  size_t Next = Keys.size() / 2;
+  for (auto _ : State) {
+    M.erase(Keys[Next - Keys.size() / 2]);
+    M[Keys[Next]] = 1;
+    Next = Next + 1 == Keys.size() ? Keys.size() / 2 : Next + 1;
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+
+using DenseMapT = llvm::DenseMap<Object *, int>;
+using SwissTableMapT = llvm::SwissTableMap<Object *, int>;
+
+BENCHMARK_TEMPLATE(BM_Insert, DenseMapT)->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Insert, SwissTableMapT)->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Find, DenseMapT)->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Find, SwissTableMapT)->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_EraseInsert, DenseMapT)->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_EraseInsert, SwissTableMapT)->Range(16, 1 << 20);
+
+BENCHMARK_MAIN();
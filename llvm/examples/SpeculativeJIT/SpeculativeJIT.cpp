@@ -12,6 +12,7 @@
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
@@ -34,6 +35,12 @@ static cl::opt<unsigned> NumThreads("num-threads", cl::Optional,
                                     cl::desc("Number of compile threads"),
                                     cl::init(4));
 
+static cl::opt<std::string> SpeculationProfile(
+    "speculation-profile", cl::Optional,
+    cl::desc("Speculate from the call sequences recorded in this file, and "
+             "update it on exit"),
+    cl::value_desc("filename"));
+
 ExitOnError ExitOnErr;
 
 // Add Layers
@@ -84,6 +91,8 @@ public:
     return ES->lookup({&ES->getMainJITDylib()}, Mangle(UnmangledName));
   }
 
+  Error saveProfile(StringRef Path) { return ProfileS.writeProfile(Path); }
+
   ~SpeculativeJIT() { CompileThreads.wait(); }
 
 private:
@@ -104,13 +113,18 @@ private:
       : ES(std::move(ES)), DL(std::move(DL)), LCTMgr(std::move(LCTMgr)),
         CompileLayer(*this->ES, ObjLayer,
                      ConcurrentIRCompiler(std::move(JTMB))),
-        S(Imps, *this->ES),
+        S(Imps, *this->ES), ProfileS(Imps, *this->ES),
         SpeculateLayer(*this->ES, CompileLayer, S, Mangle, BlockFreqQuery()),
         CODLayer(*this->ES, SpeculateLayer, *this->LCTMgr,
                  std::move(ISMBuilder)) {
     this->ES->getMainJITDylib().addGenerator(
         std::move(ProcessSymbolsGenerator));
     this->CODLayer.setImplMap(&Imps);
+    if (!SpeculationProfile.empty()) {
+      if (sys::fs::exists(SpeculationProfile))
+        ExitOnErr(ProfileS.readProfile(SpeculationProfile));
+      ProfileS.attach(*this->LCTMgr);
+    }
     this->ES->setDispatchMaterialization(
 
         [this](JITDylib &JD, std::unique_ptr<MaterializationUnit> MU) {
@@ -141,6 +155,7 @@ private:
   IRCompileLayer CompileLayer;
   ImplSymbolMap Imps;
   Speculator S;
+  CallSequenceSpeculator ProfileS;
   RTDyldObjectLinkingLayer ObjLayer{*ES, createMemMgr};
   IRSpeculationLayer SpeculateLayer;
   CompileOnDemandLayer CODLayer;
@@ -194,5 +209,8 @@ int main(int argc, char *argv[]) {
 
   Main(ArgV.size() - 1, ArgV.data());
 
+  if (!SpeculationProfile.empty())
+    ExitOnErr(SJ->saveProfile(SpeculationProfile));
+
   return 0;
 }
@@ -0,0 +1,142 @@
+//===- llvm/ADT/PagedVector.h - 'Lazily allocated' vectors ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the PagedVector class, a vector whose elements are
+// allocated in pages, on the first access to one element of the page.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_PAGEDVECTOR_H
+#define LLVM_ADT_PAGEDVECTOR_H
+
+#include "llvm/ADT/iterator.h"
+#include "llvm/ADT/iterator_range.h"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace llvm {
+
+/// A vector that allocates its elements in pages of \p PageSize elements.
+///
+/// The memory of a page is allocated, and all the elements of the page are
+/// value-initialized, only when one of its elements is accessed. This adds a
+/// level of indirection to every access, but makes resizing proportional to
+/// the number of pages rather than to the number of elements. It is meant for
+/// large vectors that are sized upfront and only sparsely accessed, like the
+/// tables of entities that are loaded lazily from a file.
+template <typename T, size_t PageSize = 1024 / sizeof(T)> class PagedVector {
+  static_assert(PageSize > 1, "PageSize must be greater than 1, otherwise use "
+                              "a vector of pointers");
+
+  /// The pages of the vector, null for the pages that were never accessed.
+  /// Accessing an element of a const vector allocates its page.
+  mutable std::vector<std::unique_ptr<T[]>> Pages;
+  size_t Size = 0;
+
+  T *getPage(size_t PageIndex) const {
+    std::unique_ptr<T[]> &Page = Pages[PageIndex];
+    if (!Page)
+      Page.reset(new T[PageSize]());
+    return Page.get();
+  }
+
+public:
+  using value_type = T;
+
+  /// Returns the element at \p Index, allocating its page if needed.
+  T &operator[](size_t Index) const {
+    assert(Index < Size && "index out of bounds");
+    return getPage(Index / PageSize)[Index % PageSize];
+  }
+
+  size_t size() const { return Size; }
+  bool empty() const { return Size == 0; }
+
+  /// Returns the capacity of the vector, which is the size of the allocated
+  /// pages if they were all allocated.
+  size_t capacity() const { return Pages.size() * PageSize; }
+
+  /// Resizes the vector to \p NewSize elements. The new elements are
+  /// value-initialized, and the pages they belong to are not allocated.
+  void resize(size_t NewSize) {
+    if (NewSize < Size) {
+      // Reset the dropped elements of the last page that is kept, so that they
+      // are value-initialized if the vector grows again.
+      size_t End =
+          std::min(Size, (NewSize + PageSize - 1) / PageSize * PageSize);
+      if (NewSize % PageSize != 0 && Pages[NewSize / PageSize])
+        for (size_t I = NewSize; I != End; ++I)
+          Pages[I / PageSize][I % PageSize] = T();
+    }
+    Pages.resize((NewSize + PageSize - 1) / PageSize);
+    Size = NewSize;
+  }
+
+  void clear() {
+    Pages.clear();
+    Size = 0;
+  }
+
+  /// Iterates over the elements of the allocated pages, which are the only
+  /// ones that may have been assigned.
+  class materialized_iterator
+      : public iterator_facade_base<materialized_iterator,
+                                    std::forward_iterator_tag, T> {
+    const PagedVector *PV;
+    size_t Index;
+
+    /// Moves to the first allocated element at or after the current one.
+    void skipUnallocated() {
+      while (Index < PV->Size && !PV->Pages[Index / PageSize])
+        Index = (Index / PageSize + 1) * PageSize;
+      if (Index > PV->Size)
+        Index = PV->Size;
+    }
+
+  public:
+    materialized_iterator(const PagedVector *PV, size_t Index)
+        : PV(PV), Index(Index) {
+      skipUnallocated();
+    }
+
+    materialized_iterator &operator++() {
+      ++Index;
+      if (Index % PageSize == 0)
+        skipUnallocated();
+      return *this;
+    }
+
+    T &operator*() const {
+      return PV->Pages[Index / PageSize][Index % PageSize];
+    }
+
+    bool operator==(const materialized_iterator &Other) const {
+      assert(PV == Other.PV && "comparing iterators of different vectors");
+      return Index == Other.Index;
+    }
+
+    /// Returns the index of the element in the vector.
+    size_t getIndex() const { return Index; }
+  };
+
+  materialized_iterator materialized_begin() const {
+    return materialized_iterator(this, 0);
+  }
+  materialized_iterator materialized_end() const {
+    return materialized_iterator(this, Size);
+  }
+  iterator_range<materialized_iterator> materialized() const {
+    return make_range(materialized_begin(), materialized_end());
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_PAGEDVECTOR_H
@@ -28,7 +28,9 @@
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Compiler.h"
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 // Determine whether statistics should be enabled. We must do it here rather
@@ -44,6 +46,9 @@ class raw_ostream;
 class raw_fd_ostream;
 class StringRef;
 
+/// The number of live StatisticScope objects on all threads.
+extern std::atomic<unsigned> NumActiveStatisticScopes;
+
 class Statistic {
 public:
   const char *DebugType;
@@ -77,21 +82,25 @@ public:
 
   const Statistic &operator++() {
     Value.fetch_add(1, std::memory_order_relaxed);
+    noteUpdate(1);
     return init();
   }
 
   unsigned operator++(int) {
     init();
+    noteUpdate(1);
     return Value.fetch_add(1, std::memory_order_relaxed);
   }
 
   const Statistic &operator--() {
     Value.fetch_sub(1, std::memory_order_relaxed);
+    noteUpdate(-1);
     return init();
   }
 
   unsigned operator--(int) {
     init();
+    noteUpdate(-1);
     return Value.fetch_sub(1, std::memory_order_relaxed);
   }
 
@@ -99,6 +108,7 @@ public:
     if (V == 0)
       return *this;
     Value.fetch_add(V, std::memory_order_relaxed);
+    noteUpdate(V);
     return init();
   }
 
@@ -106,6 +116,7 @@ public:
     if (V == 0)
       return *this;
     Value.fetch_sub(V, std::memory_order_relaxed);
+    noteUpdate(-int64_t(V));
     return init();
   }
 
@@ -161,6 +172,16 @@ protected:
   }
 
   void RegisterStatistic();
+
+#if LLVM_ENABLE_STATS
+  /// Attribute an update to the innermost StatisticScope of this thread.
+  void noteUpdate(int64_t Delta) {
+    if (LLVM_UNLIKELY(NumActiveStatisticScopes.load(std::memory_order_relaxed)))
+      noteScopedUpdate(Delta);
+  }
+
+  void noteScopedUpdate(int64_t Delta);
+#endif
 };
 
 // STATISTIC - A macro to make definition of statistics really simple.  This
@@ -168,6 +189,29 @@ protected:
 #define STATISTIC(VARNAME, DESC)                                               \
   static llvm::Statistic VARNAME = {DEBUG_TYPE, #VARNAME, DESC, {0}, {false}}
 
+/// Attributes the statistic updates made on the current thread while it is
+/// alive to a named scope, e.g. the module being compiled by a ThinLTO backend
+/// thread. PrintStatisticsJSON() then reports the updates of each scope and the
+/// sum of the scopes of each thread, in addition to the totals. Scopes on the
+/// same thread nest, attributing updates to the innermost scope. Assignments
+/// and updateMax() are only counted in the totals.
+class StatisticScope {
+public:
+  explicit StatisticScope(StringRef Name);
+  ~StatisticScope();
+
+  StatisticScope(const StatisticScope &) = delete;
+  StatisticScope &operator=(const StatisticScope &) = delete;
+
+private:
+  friend class Statistic;
+  struct Counters;
+
+  std::string Name;
+  StatisticScope *Parent;
+  std::unique_ptr<Counters> Updates;
+};
+
 /// Enable the collection and printing of statistics.
 void EnableStatistics(bool PrintOnExit = true);
 
@@ -0,0 +1,727 @@
+//===- llvm/ADT/SwissTableMap.h - Group probed hash table -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines SwissTableMap, an open addressing hash map in the style of
+// Abseil's "Swiss tables".
+//
+// In addition to the buckets, the table keeps one control byte per bucket
+// holding either a marker for an empty or erased bucket, or 7 bits of the
+// hash of the key in the bucket. Lookups compare a group of control bytes
+// (16 with SSE2, 8 otherwise) against the hash at once and only touch the
+// buckets whose control byte matches, so a lookup usually reads one cache
+// line of control bytes and one bucket. Unlike DenseMap, keys are never
+// compared against empty or tombstone keys.
+//
+// SwissTableMap supports the commonly used parts of the DenseMap interface,
+// and uses DenseMapInfo for hashing and comparing keys. The empty and
+// tombstone keys of the DenseMapInfo are not used.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_SWISSTABLEMAP_H
+#define LLVM_ADT_SWISSTABLEMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/EpochTracker.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LLVM_SWISSTABLE_SSE2 1
+#endif
+
+namespace llvm {
+
+namespace detail {
+
+/// Control byte values. Full buckets have a control byte in [0, 127].
+enum SwissCtrl : int8_t {
+  SwissEmpty = -128,
+  SwissDeleted = -2,
+  SwissSentinel = -1,
+};
+
+/// A bit mask with one bit (or one byte) set for each matching control byte
+/// of a group. Iterating yields the indices of the matches.
+template <typename T, unsigned Shift> class SwissBitMask {
+  T Mask;
+
+public:
+  explicit SwissBitMask(T Mask) : Mask(Mask) {}
+
+  explicit operator bool() const { return Mask != 0; }
+  unsigned lowestBitSet() const { return countTrailingZeros(Mask) >> Shift; }
+
+  unsigned operator*() const { return lowestBitSet(); }
+  SwissBitMask &operator++() {
+    Mask &= Mask - 1;
+    return *this;
+  }
+  SwissBitMask begin() const { return *this; }
+  SwissBitMask end() const { return SwissBitMask(0); }
+  bool operator!=(const SwissBitMask &RHS) const { return Mask != RHS.Mask; }
+};
+
+#if defined(LLVM_SWISSTABLE_SSE2)
+/// A group of 16 control bytes, matched with SSE2.
+struct SwissGroup {
+  static constexpr unsigned Width = 16;
+  __m128i Ctrl;
+
+  explicit SwissGroup(const int8_t *Pos)
+      : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Pos))) {}
+
+  SwissBitMask<uint32_t, 0> match(int8_t H2) const {
+    return SwissBitMask<uint32_t, 0>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl)));
+  }
+  SwissBitMask<uint32_t, 0> matchEmpty() const { return match(SwissEmpty); }
+  SwissBitMask<uint32_t, 0> matchEmptyOrDeleted() const {
+    // Empty and deleted are the only values less than the sentinel.
+    return SwissBitMask<uint32_t, 0>(_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_set1_epi8(SwissSentinel), Ctrl)));
+  }
+};
+#else
+/// A group of 8 control bytes, matched with arithmetic on a 64-bit word.
+struct SwissGroup {
+  static constexpr unsigned Width = 8;
+  static constexpr uint64_t LSBs = 0x0101010101010101ULL;
+  static constexpr uint64_t MSBs = 0x8080808080808080ULL;
+  uint64_t Ctrl;
+
+  explicit SwissGroup(const int8_t *Pos)
+      : Ctrl(support::endian::read64le(Pos)) {}
+
+  // This may report a false positive for a byte following a true match,
+  // which is harmless because keys are compared anyway.
+  SwissBitMask<uint64_t, 3> match(int8_t H2) const {
+    uint64_t X = Ctrl ^ (LSBs * uint8_t(H2));
+    return SwissBitMask<uint64_t, 3>((X - LSBs) & ~X & MSBs);
+  }
+  // Empty is the only value with the high bit set and bit 1 clear.
+  SwissBitMask<uint64_t, 3> matchEmpty() const {
+    return SwissBitMask<uint64_t, 3>((Ctrl & (~Ctrl << 6)) & MSBs);
+  }
+  // Empty and deleted are the only values with the high bit set and bit 0
+  // clear.
+  SwissBitMask<uint64_t, 3> matchEmptyOrDeleted() const {
+    return SwissBitMask<uint64_t, 3>((Ctrl & (~Ctrl << 7)) & MSBs);
+  }
+};
+#endif
+
+} // end namespace detail
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT,
+          bool IsConst = false>
+class SwissTableMapIterator;
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>,
+          typename BucketT = llvm::detail::DenseMapPair<KeyT, ValueT>>
+class SwissTableMap : public DebugEpochBase {
+  using Group = detail::SwissGroup;
+  template <typename T>
+  using const_arg_type_t = typename const_pointer_or_const_ref<T>::type;
+
+  // Ctrl has Capacity + Group::Width bytes: one per bucket, a sentinel, and
+  // a copy of the first Group::Width - 1 bytes so that a group can be loaded
+  // at any bucket without wrapping around. Buckets follows it in the same
+  // allocation. Capacity is zero or a power of two minus one.
+  int8_t *Ctrl = nullptr;
+  BucketT *Buckets = nullptr;
+  unsigned Capacity = 0;
+  unsigned NumEntries = 0;
+  // The number of entries that can be added before the table must be
+  // rehashed. Erased buckets are only reclaimed by a rehash or by inserting
+  // into them.
+  unsigned GrowthLeft = 0;
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = BucketT;
+
+  using iterator = SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT>;
+  using const_iterator =
+      SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT, true>;
+
+  /// Create a SwissTableMap that can hold at least \p NumInitEntries entries
+  /// without growing.
+  explicit SwissTableMap(unsigned NumInitEntries = 0) {
+    if (NumInitEntries)
+      rehash(getCapacityForEntries(NumInitEntries));
+  }
+
+  SwissTableMap(const SwissTableMap &Other) : DebugEpochBase() {
+    copyFrom(Other);
+  }
+
+  SwissTableMap(SwissTableMap &&Other) : DebugEpochBase() { swap(Other); }
+
+  template <typename InputIt> SwissTableMap(const InputIt &I, const InputIt &E) {
+    reserve(std::distance(I, E));
+    insert(I, E);
+  }
+
+  SwissTableMap(std::initializer_list<value_type> Vals) {
+    reserve(Vals.size());
+    insert(Vals.begin(), Vals.end());
+  }
+
+  ~SwissTableMap() {
+    destroyAll();
+    deallocate();
+  }
+
+  SwissTableMap &operator=(const SwissTableMap &Other) {
+    if (&Other != this) {
+      destroyAll();
+      deallocate();
+      copyFrom(Other);
+    }
+    return *this;
+  }
+
+  SwissTableMap &operator=(SwissTableMap &&Other) {
+    destroyAll();
+    deallocate();
+    swap(Other);
+    return *this;
+  }
+
+  void swap(SwissTableMap &RHS) {
+    incrementEpoch();
+    RHS.incrementEpoch();
+    std::swap(Ctrl, RHS.Ctrl);
+    std::swap(Buckets, RHS.Buckets);
+    std::swap(Capacity, RHS.Capacity);
+    std::swap(NumEntries, RHS.NumEntries);
+    std::swap(GrowthLeft, RHS.GrowthLeft);
+  }
+
+  iterator begin() {
+    if (empty())
+      return end();
+    return makeIterator(0, /*NoAdvance=*/false);
+  }
+  iterator end() { return makeIterator(Capacity, /*NoAdvance=*/true); }
+  const_iterator begin() const {
+    if (empty())
+      return end();
+    return makeConstIterator(0, /*NoAdvance=*/false);
+  }
+  const_iterator end() const {
+    return makeConstIterator(Capacity, /*NoAdvance=*/true);
+  }
+
+  LLVM_NODISCARD bool empty() const { return NumEntries == 0; }
+  unsigned size() const { return NumEntries; }
+
+  /// Grow the table so that it can hold at least \p NumEntries entries
+  /// without rehashing.
+  void reserve(size_type NumEntries) {
+    unsigned NewCapacity = getCapacityForEntries(NumEntries);
+    if (NewCapacity > Capacity) {
+      incrementEpoch();
+      rehash(NewCapacity);
+    }
+  }
+
+  void clear() {
+    incrementEpoch();
+    if (Capacity == 0)
+      return;
+    // Release the memory of a table that was much larger than it is now.
+    if (NumEntries * 4 < Capacity && Capacity > 127) {
+      destroyAll();
+      deallocate();
+      return;
+    }
+    destroyAll();
+    resetCtrl();
+    NumEntries = 0;
+    GrowthLeft = getMaxEntries(Capacity);
+  }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const_arg_type_t<KeyT> Val) const {
+    return findIndex(Val) != Capacity ? 1 : 0;
+  }
+
+  iterator find(const_arg_type_t<KeyT> Val) {
+    return makeIterator(findIndex(Val), /*NoAdvance=*/true);
+  }
+  const_iterator find(const_arg_type_t<KeyT> Val) const {
+    return makeConstIterator(findIndex(Val), /*NoAdvance=*/true);
+  }
+
+  /// Alternate version of find() which allows a different, and possibly
+  /// less expensive, key type.
+  /// The DenseMapInfo is responsible for supplying methods
+  /// getHashValue(LookupKeyT) and isEqual(LookupKeyT, KeyT) for each key
+  /// type used.
+  template <class LookupKeyT> iterator find_as(const LookupKeyT &Val) {
+    return makeIterator(findIndex(Val), /*NoAdvance=*/true);
+  }
+  template <class LookupKeyT>
+  const_iterator find_as(const LookupKeyT &Val) const {
+    return makeConstIterator(findIndex(Val), /*NoAdvance=*/true);
+  }
+
+  /// lookup - Return the entry for the specified key, or a default
+  /// constructed value if no such entry exists.
+  ValueT lookup(const_arg_type_t<KeyT> Val) const {
+    unsigned I = findIndex(Val);
+    if (I != Capacity)
+      return Buckets[I].getSecond();
+    return ValueT();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyT &&Key, Ts &&... Args) {
+    std::pair<unsigned, bool> R = findOrPrepareInsert(Key);
+    if (R.second) {
+      BucketT &B = Buckets[R.first];
+      ::new (&B.getFirst()) KeyT(std::move(Key));
+      ::new (&B.getSecond()) ValueT(std::forward<Ts>(Args)...);
+    }
+    return std::make_pair(makeIterator(R.first, /*NoAdvance=*/true), R.second);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(const KeyT &Key, Ts &&... Args) {
+    std::pair<unsigned, bool> R = findOrPrepareInsert(Key);
+    if (R.second) {
+      BucketT &B = Buckets[R.first];
+      ::new (&B.getFirst()) KeyT(Key);
+      ::new (&B.getSecond()) ValueT(std::forward<Ts>(Args)...);
+    }
+    return std::make_pair(makeIterator(R.first, /*NoAdvance=*/true), R.second);
+  }
+
+  /// insert - Range insertion of pairs.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  bool erase(const KeyT &Val) {
+    unsigned I = findIndex(Val);
+    if (I == Capacity)
+      return false;
+    eraseIndex(I);
+    return true;
+  }
+
+  void erase(iterator I) {
+    assert(I.Ctrl >= Ctrl && I.Ctrl < Ctrl + Capacity && *I.Ctrl >= 0 &&
+           "erasing an invalid iterator");
+    eraseIndex(I.Ctrl - Ctrl);
+  }
+
+  value_type &FindAndConstruct(const KeyT &Key) {
+    return *try_emplace(Key).first;
+  }
+
+  ValueT &operator[](const KeyT &Key) { return FindAndConstruct(Key).second; }
+
+  value_type &FindAndConstruct(KeyT &&Key) {
+    return *try_emplace(std::move(Key)).first;
+  }
+
+  ValueT &operator[](KeyT &&Key) {
+    return FindAndConstruct(std::move(Key)).second;
+  }
+
+  /// Return the approximate size (in bytes) of the actual map.
+  /// This is just the raw memory used by SwissTableMap.
+  /// If entries are pointers to objects, the size of the referenced objects
+  /// are not included.
+  size_t getMemorySize() const {
+    return Capacity ? getAllocSize(Capacity) : 0;
+  }
+
+private:
+  friend class SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT, false>;
+  friend class SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT, true>;
+
+  iterator makeIterator(unsigned I, bool NoAdvance) {
+    return iterator(Ctrl + I, Buckets + I, *this, NoAdvance);
+  }
+  const_iterator makeConstIterator(unsigned I, bool NoAdvance) const {
+    return const_iterator(Ctrl + I, Buckets + I, *this, NoAdvance);
+  }
+
+  // The hash codes of DenseMapInfo are often weak in the high bits, so
+  // scramble them before splitting them into the probe start (H1) and the
+  // control byte (H2).
+  template <typename LookupKeyT> static uint64_t getHash(const LookupKeyT &Val) {
+    return uint64_t(KeyInfoT::getHashValue(Val)) * 0x9E3779B97F4A7C15ULL;
+  }
+  static unsigned getH1(uint64_t Hash) { return unsigned(Hash >> 32); }
+  static int8_t getH2(uint64_t Hash) { return int8_t(Hash >> 57); }
+
+  // Groups are probed quadratically (triangular numbers of groups), which
+  // visits every group of a power of two sized table.
+  class ProbeSeq {
+    unsigned Mask;
+    unsigned Offset;
+    unsigned Index = 0;
+
+  public:
+    ProbeSeq(unsigned H1, unsigned Mask) : Mask(Mask), Offset(H1 & Mask) {}
+    unsigned offset() const { return Offset; }
+    unsigned offset(unsigned I) const { return (Offset + I) & Mask; }
+    void next() {
+      Index += Group::Width;
+      Offset = (Offset + Index) & Mask;
+    }
+  };
+
+  template <typename LookupKeyT>
+  unsigned findIndex(const LookupKeyT &Val) const {
+    if (Capacity == 0)
+      return 0;
+    uint64_t Hash = getHash(Val);
+    ProbeSeq Seq(getH1(Hash), Capacity);
+    while (true) {
+      Group G(Ctrl + Seq.offset());
+      for (unsigned I : G.match(getH2(Hash))) {
+        unsigned Idx = Seq.offset(I);
+        if (LLVM_LIKELY(KeyInfoT::isEqual(Val, Buckets[Idx].getFirst())))
+          return Idx;
+      }
+      if (LLVM_LIKELY(G.matchEmpty()))
+        return Capacity;
+      Seq.next();
+    }
+  }
+
+  // Returns the first empty or deleted bucket in the probe sequence of Hash.
+  unsigned findFirstNonFull(uint64_t Hash) const {
+    ProbeSeq Seq(getH1(Hash), Capacity);
+    while (true) {
+      Group G(Ctrl + Seq.offset());
+      if (auto Mask = G.matchEmptyOrDeleted())
+        return Seq.offset(Mask.lowestBitSet());
+      Seq.next();
+    }
+  }
+
+  // Returns the index of Key and false if it is in the map. Otherwise,
+  // claims a bucket for it and returns its index and true; the caller must
+  // construct the bucket.
+  std::pair<unsigned, bool> findOrPrepareInsert(const KeyT &Key) {
+    unsigned I = findIndex(Key);
+    if (I != Capacity)
+      return std::make_pair(I, false);
+
+    incrementEpoch();
+    uint64_t Hash = getHash(Key);
+    if (Capacity == 0) {
+      rehash(Group::Width - 1);
+      I = findFirstNonFull(Hash);
+    } else {
+      I = findFirstNonFull(Hash);
+      if (LLVM_UNLIKELY(GrowthLeft == 0 && Ctrl[I] == detail::SwissEmpty)) {
+        rehashForInsert();
+        I = findFirstNonFull(Hash);
+      }
+    }
+    if (Ctrl[I] == detail::SwissEmpty)
+      --GrowthLeft;
+    ++NumEntries;
+    setCtrl(I, getH2(Hash));
+    return std::make_pair(I, true);
+  }
+
+  void eraseIndex(unsigned I) {
+    incrementEpoch();
+    Buckets[I].getSecond().~ValueT();
+    Buckets[I].getFirst().~KeyT();
+    setCtrl(I, detail::SwissDeleted);
+    --NumEntries;
+  }
+
+  void setCtrl(unsigned I, int8_t H) {
+    Ctrl[I] = H;
+    // Keep the copy of the first group past the sentinel in sync.
+    if (I < Group::Width - 1)
+      Ctrl[Capacity + 1 + I] = H;
+  }
+
+  // Tables are at most 7/8 full.
+  static unsigned getMaxEntries(unsigned Capacity) {
+    return Capacity - Capacity / 8;
+  }
+
+  static unsigned getCapacityForEntries(unsigned NumEntries) {
+    if (NumEntries == 0)
+      return 0;
+    // Capacity is at least Group::Width - 1 so that no group load reads
+    // past the copied control bytes.
+    unsigned Capacity = Group::Width - 1;
+    while (getMaxEntries(Capacity) < NumEntries)
+      Capacity = Capacity * 2 + 1;
+    return Capacity;
+  }
+
+  // If erased buckets take up much of the table, rehash in place to reclaim
+  // them rather than growing.
+  void rehashForInsert() {
+    if (uint64_t(NumEntries) * 32 <= uint64_t(Capacity) * 25)
+      rehash(Capacity);
+    else
+      rehash(Capacity * 2 + 1);
+  }
+
+  static size_t getBucketsOffset(unsigned Capacity) {
+    return alignTo(Capacity + Group::Width, alignof(BucketT));
+  }
+  static size_t getAllocSize(unsigned Capacity) {
+    return getBucketsOffset(Capacity) + sizeof(BucketT) * Capacity;
+  }
+
+  void resetCtrl() {
+    std::memset(Ctrl, detail::SwissEmpty, Capacity + Group::Width);
+    Ctrl[Capacity] = detail::SwissSentinel;
+  }
+
+  void allocate(unsigned NewCapacity) {
+    Capacity = NewCapacity;
+    char *Mem = static_cast<char *>(operator new(getAllocSize(Capacity)));
+    Ctrl = reinterpret_cast<int8_t *>(Mem);
+    Buckets = reinterpret_cast<BucketT *>(Mem + getBucketsOffset(Capacity));
+    resetCtrl();
+    NumEntries = 0;
+    GrowthLeft = getMaxEntries(Capacity);
+  }
+
+  void deallocate() {
+    if (Capacity)
+      operator delete(Ctrl);
+    Ctrl = nullptr;
+    Buckets = nullptr;
+    Capacity = NumEntries = GrowthLeft = 0;
+  }
+
+  void destroyAll() {
+    if (std::is_trivially_destructible<KeyT>::value &&
+        std::is_trivially_destructible<ValueT>::value)
+      return;
+    for (unsigned I = 0; I != Capacity; ++I) {
+      if (Ctrl[I] >= 0) {
+        Buckets[I].getSecond().~ValueT();
+        Buckets[I].getFirst().~KeyT();
+      }
+    }
+  }
+
+  // Moves all entries into a new table of NewCapacity buckets.
+  void rehash(unsigned NewCapacity) {
+    int8_t *OldCtrl = Ctrl;
+    BucketT *OldBuckets = Buckets;
+    unsigned OldCapacity = Capacity;
+    unsigned OldNumEntries = NumEntries;
+    allocate(NewCapacity);
+
+    for (unsigned I = 0; I != OldCapacity; ++I) {
+      if (OldCtrl[I] < 0)
+        continue;
+      uint64_t Hash = getHash(OldBuckets[I].getFirst());
+      unsigned J = findFirstNonFull(Hash);
+      setCtrl(J, getH2(Hash));
+      ::new (&Buckets[J].getFirst()) KeyT(std::move(OldBuckets[I].getFirst()));
+      ::new (&Buckets[J].getSecond())
+          ValueT(std::move(OldBuckets[I].getSecond()));
+      OldBuckets[I].getSecond().~ValueT();
+      OldBuckets[I].getFirst().~KeyT();
+    }
+    NumEntries = OldNumEntries;
+    GrowthLeft -= NumEntries;
+
+    if (OldCapacity)
+      operator delete(OldCtrl);
+  }
+
+  void copyFrom(const SwissTableMap &Other) {
+    if (Other.Capacity == 0)
+      return;
+    allocate(Other.Capacity);
+    std::memcpy(Ctrl, Other.Ctrl, Capacity + Group::Width);
+    for (unsigned I = 0; I != Capacity; ++I) {
+      if (Ctrl[I] >= 0) {
+        ::new (&Buckets[I].getFirst()) KeyT(Other.Buckets[I].getFirst());
+        ::new (&Buckets[I].getSecond()) ValueT(Other.Buckets[I].getSecond());
+      }
+    }
+    NumEntries = Other.NumEntries;
+    GrowthLeft = Other.GrowthLeft;
+  }
+};
+
+/// Equality comparison for SwissTableMap.
+///
+/// Iterates over elements of LHS confirming that each (key, value) pair in LHS
+/// is also in RHS, and that no additional pairs are in RHS.
+/// Equivalent to N calls to RHS.find and N value comparisons. Amortized
+/// complexity is linear, worst case is O(N^2) (if every hash collides).
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT>
+bool operator==(const SwissTableMap<KeyT, ValueT, KeyInfoT, BucketT> &LHS,
+                const SwissTableMap<KeyT, ValueT, KeyInfoT, BucketT> &RHS) {
+  if (LHS.size() != RHS.size())
+    return false;
+
+  for (auto &KV : LHS) {
+    auto I = RHS.find(KV.first);
+    if (I == RHS.end() || I->second != KV.second)
+      return false;
+  }
+
+  return true;
+}
+
+/// Inequality comparison for SwissTableMap.
+///
+/// Equivalent to !(LHS == RHS). See operator== for performance notes.
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT>
+bool operator!=(const SwissTableMap<KeyT, ValueT, KeyInfoT, BucketT> &LHS,
+                const SwissTableMap<KeyT, ValueT, KeyInfoT, BucketT> &RHS) {
+  return !(LHS == RHS);
+}
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT,
+          bool IsConst>
+class SwissTableMapIterator : DebugEpochBase::HandleBase {
+  friend class SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT, true>;
+  friend class SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT, false>;
+  friend class SwissTableMap<KeyT, ValueT, KeyInfoT, BucketT>;
+
+  using ConstIterator =
+      SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT, true>;
+
+public:
+  using difference_type = ptrdiff_t;
+  using value_type =
+      typename std::conditional<IsConst, const BucketT, BucketT>::type;
+  using pointer = value_type *;
+  using reference = value_type &;
+  using iterator_category = std::forward_iterator_tag;
+
+private:
+  const int8_t *Ctrl = nullptr;
+  pointer Ptr = nullptr;
+
+public:
+  SwissTableMapIterator() = default;
+
+  SwissTableMapIterator(const int8_t *Ctrl, pointer Pos,
+                        const DebugEpochBase &Epoch, bool NoAdvance = false)
+      : DebugEpochBase::HandleBase(&Epoch), Ctrl(Ctrl), Ptr(Pos) {
+    assert(isHandleInSync() && "invalid construction!");
+    if (!NoAdvance)
+      AdvancePastEmptyBuckets();
+  }
+
+  // Converting ctor from non-const iterators to const iterators. SFINAE'd out
+  // for const iterator destinations so it doesn't end up as a user defined copy
+  // constructor.
+  template <bool IsConstSrc,
+            typename = typename std::enable_if<!IsConstSrc && IsConst>::type>
+  SwissTableMapIterator(
+      const SwissTableMapIterator<KeyT, ValueT, KeyInfoT, BucketT, IsConstSrc>
+          &I)
+      : DebugEpochBase::HandleBase(I), Ctrl(I.Ctrl), Ptr(I.Ptr) {}
+
+  reference operator*() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    return *Ptr;
+  }
+  pointer operator->() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    return Ptr;
+  }
+
+  bool operator==(const ConstIterator &RHS) const {
+    assert((!Ptr || isHandleInSync()) && "handle not in sync!");
+    assert((!RHS.Ptr || RHS.isHandleInSync()) && "handle not in sync!");
+    assert(getEpochAddress() == RHS.getEpochAddress() &&
+           "comparing incomparable iterators!");
+    return Ptr == RHS.Ptr;
+  }
+  bool operator!=(const ConstIterator &RHS) const { return !(*this == RHS); }
+
+  inline SwissTableMapIterator &operator++() { // Preincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    ++Ctrl;
+    ++Ptr;
+    AdvancePastEmptyBuckets();
+    return *this;
+  }
+  SwissTableMapIterator operator++(int) { // Postincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    SwissTableMapIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+private:
+  // Stops at a full bucket or at the sentinel that follows the last bucket.
+  void AdvancePastEmptyBuckets() {
+    while (*Ctrl < detail::SwissSentinel) {
+      ++Ctrl;
+      ++Ptr;
+    }
+  }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT>
+inline size_t capacity_in_bytes(const SwissTableMap<KeyT, ValueT, KeyInfoT> &X) {
+  return X.getMemorySize();
+}
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_SWISSTABLEMAP_H
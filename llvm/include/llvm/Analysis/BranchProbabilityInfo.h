@@ -17,6 +17,8 @@
 #include "llvm/ADT/DenseMapInfo.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CFG.h"
 #include "llvm/IR/PassManager.h"
@@ -133,6 +135,16 @@ public:
   void calculate(const Function &F, const LoopInfo &LI,
                  const TargetLibraryInfo *TLI = nullptr);
 
+  /// Like calculate(), but first looks in the directory \p CacheDir for the
+  /// probabilities of a function with the same hash, which this or another
+  /// compile job stored there, and stores them there if they have to be
+  /// computed. \p GetLI is only called in that case. The hash covers the
+  /// structure of F, without value names, and everything outside of it that
+  /// the heuristics look at.
+  void calculateCached(const Function &F,
+                       function_ref<const LoopInfo &()> GetLI,
+                       const TargetLibraryInfo *TLI, StringRef CacheDir);
+
   /// Forget analysis results for the given basic block.
   void eraseBlock(const BasicBlock *BB);
 
@@ -198,6 +210,9 @@ private:
   bool calcZeroHeuristics(const BasicBlock *BB, const TargetLibraryInfo *TLI);
   bool calcFloatingPointHeuristics(const BasicBlock *BB);
   bool calcInvokeHeuristics(const BasicBlock *BB);
+
+  bool readCachedProbabilities(const Function &F, StringRef Path);
+  void writeCachedProbabilities(const Function &F, StringRef Path) const;
 };
 
 /// Analysis pass which computes \c BranchProbabilityInfo.
@@ -998,6 +998,11 @@ public:
 
   void print(raw_ostream &OS) const;
   void verify() const;
+
+  /// Print the number of entries in the caches of this instance and the
+  /// memory used by its SCEV nodes.
+  void printCacheStats(raw_ostream &OS) const;
+
   bool invalidate(Function &F, const PreservedAnalyses &PA,
                   FunctionAnalysisManager::Invalidator &Inv);
 
@@ -1200,6 +1205,15 @@ private:
   /// Memoized values for the GetMinTrailingZeros
   DenseMap<const SCEV *, uint32_t> MinTrailingZerosCache;
 
+  /// Number of times the memoized per-SCEV results were dropped because they
+  /// exceeded -scalar-evolution-max-derived-cache-entries.
+  unsigned NumDerivedCacheTrims = 0;
+
+  /// Drop the memoized per-SCEV results (ranges, dispositions, values at
+  /// scopes and trailing zeros) if there are more of them than allowed. They
+  /// are recomputed on demand.
+  void trimDerivedCaches();
+
   /// Return the Value set from which the SCEV expr is generated.
   SetVector<ValueOffsetPair> *getSCEVValues(const SCEV *S);
 
@@ -19,6 +19,7 @@
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Analysis/LoopInfo.h"
@@ -79,6 +80,10 @@ private:
   using BaseT = TargetTransformInfoImplCRTPBase<T>;
   using TTI = TargetTransformInfo;
 
+  /// The legalization costs of the types queried so far. A TTI is built for
+  /// one function, so they cannot change while it lives.
+  mutable DenseMap<Type *, std::pair<int, MVT>> TypeLegalizationCosts;
+
   /// Estimate a cost of Broadcast as an extract and sequence of insert
   /// operations.
   unsigned getBroadcastShuffleOverhead(Type *Ty) {
@@ -193,6 +198,17 @@ protected:
 
   using TargetTransformInfoImplBase::DL;
 
+  /// TLI->getTypeLegalizationCost, memoized. The cost models of the
+  /// vectorizers ask it about the same few types many times per function.
+  std::pair<int, MVT> getTypeLegalizationCost(Type *Ty) const {
+    auto It = TypeLegalizationCosts.find(Ty);
+    if (It != TypeLegalizationCosts.end())
+      return It->second;
+    std::pair<int, MVT> LT = getTLI()->getTypeLegalizationCost(DL, Ty);
+    TypeLegalizationCosts.try_emplace(Ty, LT);
+    return LT;
+  }
+
 public:
   /// \name Scalar TTI Implementations
   /// @{
@@ -602,7 +618,7 @@ public:
     int ISD = TLI->InstructionOpcodeToISD(Opcode);
     assert(ISD && "Invalid opcode");
 
-    std::pair<unsigned, MVT> LT = TLI->getTypeLegalizationCost(DL, Ty);
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(Ty);
 
     bool IsFloat = Ty->isFPOrFPVectorTy();
     // Assume that floating point arithmetic operations cost twice as much as
@@ -661,8 +677,8 @@ public:
     const TargetLoweringBase *TLI = getTLI();
     int ISD = TLI->InstructionOpcodeToISD(Opcode);
     assert(ISD && "Invalid opcode");
-    std::pair<unsigned, MVT> SrcLT = TLI->getTypeLegalizationCost(DL, Src);
-    std::pair<unsigned, MVT> DstLT = TLI->getTypeLegalizationCost(DL, Dst);
+    std::pair<unsigned, MVT> SrcLT = getTypeLegalizationCost(Src);
+    std::pair<unsigned, MVT> DstLT = getTypeLegalizationCost(Dst);
 
     // Check for NOOP conversions.
     if (SrcLT.first == DstLT.first &&
@@ -806,7 +822,7 @@ public:
       if (CondTy->isVectorTy())
         ISD = ISD::VSELECT;
     }
-    std::pair<unsigned, MVT> LT = TLI->getTypeLegalizationCost(DL, ValTy);
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(ValTy);
 
     if (!(ValTy->isVectorTy() && !LT.second.isVector()) &&
         !TLI->isOperationExpand(ISD, LT.second)) {
@@ -835,8 +851,7 @@ public:
   }
 
   unsigned getVectorInstrCost(unsigned Opcode, Type *Val, unsigned Index) {
-    std::pair<unsigned, MVT> LT =
-        getTLI()->getTypeLegalizationCost(DL, Val->getScalarType());
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(Val->getScalarType());
 
     return LT.first;
   }
@@ -844,7 +859,7 @@ public:
   unsigned getMemoryOpCost(unsigned Opcode, Type *Src, unsigned Alignment,
                        unsigned AddressSpace, const Instruction *I = nullptr) {
     assert(!Src->isVoidTy() && "Invalid type");
-    std::pair<unsigned, MVT> LT = getTLI()->getTypeLegalizationCost(DL, Src);
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(Src);
 
     // Assuming that all loads of legal types cost 1.
     unsigned Cost = LT.first;
@@ -898,7 +913,7 @@ public:
 
     // Legalize the vector type, and get the legalized and unlegalized type
     // sizes.
-    MVT VecTyLT = getTLI()->getTypeLegalizationCost(DL, VecTy).second;
+    MVT VecTyLT = getTypeLegalizationCost(VecTy).second;
     unsigned VecTySize =
         static_cast<T *>(this)->getDataLayout().getTypeStoreSize(VecTy);
     unsigned VecTyLTSize = VecTyLT.getStoreSize();
@@ -1440,7 +1455,7 @@ public:
     }
 
     const TargetLoweringBase *TLI = getTLI();
-    std::pair<unsigned, MVT> LT = TLI->getTypeLegalizationCost(DL, RetTy);
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(RetTy);
 
     SmallVector<unsigned, 2> LegalCost;
     SmallVector<unsigned, 2> CustomCost;
@@ -1530,7 +1545,7 @@ public:
   }
 
   unsigned getNumberOfParts(Type *Tp) {
-    std::pair<unsigned, MVT> LT = getTLI()->getTypeLegalizationCost(DL, Tp);
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(Tp);
     return LT.first;
   }
 
@@ -1583,8 +1598,7 @@ public:
     unsigned ArithCost = 0;
     unsigned ShuffleCost = 0;
     auto *ConcreteTTI = static_cast<T *>(this);
-    std::pair<unsigned, MVT> LT =
-        ConcreteTTI->getTLI()->getTypeLegalizationCost(DL, Ty);
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(Ty);
     unsigned LongVectorCount = 0;
     unsigned MVTLen =
         LT.second.isVector() ? LT.second.getVectorNumElements() : 1;
@@ -1642,8 +1656,7 @@ public:
     unsigned MinMaxCost = 0;
     unsigned ShuffleCost = 0;
     auto *ConcreteTTI = static_cast<T *>(this);
-    std::pair<unsigned, MVT> LT =
-        ConcreteTTI->getTLI()->getTypeLegalizationCost(DL, Ty);
+    std::pair<unsigned, MVT> LT = getTypeLegalizationCost(Ty);
     unsigned LongVectorCount = 0;
     unsigned MVTLen =
         LT.second.isVector() ? LT.second.getVectorNumElements() : 1;
@@ -153,6 +153,15 @@ public:
   /// owned by this class.
   DIEAbbrev &uniqueAbbreviation(DIE &Die);
 
+  /// Unique an abbreviation declaration that is owned by another set.
+  ///
+  /// \returns A reference to the uniqued abbreviation declaration that is
+  /// owned by this class.
+  DIEAbbrev &uniqueAbbreviation(const DIEAbbrev &Abbrev);
+
+  /// The unique abbreviations, in the order they were numbered.
+  ArrayRef<DIEAbbrev *> getAbbreviations() const { return Abbreviations; }
+
   /// Print all abbreviations using the specified asm printer.
   void Emit(const AsmPrinter *AP, MCSection *Section) const;
 };
@@ -786,6 +795,12 @@ public:
   unsigned computeOffsetsAndAbbrevs(const AsmPrinter *AP,
                                     DIEAbbrevSet &AbbrevSet, unsigned CUOffset);
 
+  /// Compute the offset of this DIE and all its children, like
+  /// computeOffsetsAndAbbrevs(), for DIEs whose abbreviation numbers have
+  /// already been set. This doesn't touch any shared state, so it may run for
+  /// several units at once.
+  unsigned computeOffsets(const AsmPrinter *AP, unsigned CUOffset);
+
   /// Climb up the parent chain to get the compile unit or type unit DIE that
   /// this DIE belongs to.
   ///
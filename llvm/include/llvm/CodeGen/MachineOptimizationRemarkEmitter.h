@@ -157,12 +157,7 @@ public:
   /// that are normally too noisy.  In this mode, we can use the extra analysis
   /// (1) to filter trivial false positives or (2) to provide more context so
   /// that non-trivial false positives can be quickly detected by the user.
-  bool allowExtraAnalysis(StringRef PassName) const {
-    return (
-        MF.getFunction().getContext().getRemarkStreamer() ||
-        MF.getFunction().getContext().getDiagHandlerPtr()->isAnyRemarkEnabled(
-            PassName));
-  }
+  bool allowExtraAnalysis(StringRef PassName) const;
 
   /// Take a lambda that returns a remark which will be emitted.  Second
   /// argument is only used to restrict this to functions.
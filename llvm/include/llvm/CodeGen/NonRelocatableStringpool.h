@@ -1,4 +1,4 @@
-//===- NonRelocatableStringpool.h - A simple stringpool  --------*- C++ -*-===//
+//===- NonRelocatableStringpool.h - A simple stringpool ---------*- C++ -*-===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,20 +6,19 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef LLVM_TOOLS_DSYMUTIL_NONRELOCATABLESTRINGPOOL_H
-#define LLVM_TOOLS_DSYMUTIL_NONRELOCATABLESTRINGPOOL_H
-
-#include "SymbolMap.h"
+#ifndef LLVM_CODEGEN_NONRELOCATABLESTRINGPOOL_H
+#define LLVM_CODEGEN_NONRELOCATABLESTRINGPOOL_H
 
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/CodeGen/DwarfStringPoolEntry.h"
 #include "llvm/Support/Allocator.h"
 #include <cstdint>
+#include <functional>
+#include <mutex>
 #include <vector>
 
 namespace llvm {
-namespace dsymutil {
 
 /// A string table that doesn't need relocations.
 ///
@@ -33,9 +32,12 @@ public:
   /// order.
   using MapTy = StringMap<DwarfStringPoolEntry, BumpPtrAllocator>;
 
-  NonRelocatableStringpool(
-      SymbolMapTranslator Translator = SymbolMapTranslator())
-      : Translator(Translator) {
+  /// Callable applied to every string before it is added to the pool, e.g.
+  /// to unobfuscate symbol names.
+  using TranslatorTy = std::function<StringRef(StringRef)>;
+
+  NonRelocatableStringpool(TranslatorTy Translator = nullptr)
+      : Translator(std::move(Translator)) {
     // Legacy dsymutil puts an empty string at the start of the line table.
     EmptyString = getEntry("");
   }
@@ -65,7 +67,7 @@ private:
   uint32_t CurrentEndOffset = 0;
   unsigned NumEntries = 0;
   DwarfStringPoolEntryRef EmptyString;
-  SymbolMapTranslator Translator;
+  TranslatorTy Translator;
 };
 
 /// Helper for making strong types.
@@ -75,15 +77,35 @@ public:
   explicit StrongType(Args... A) : T(std::forward<Args>(A)...) {}
 };
 
+/// A string pool that is only used for uniquing: equal strings are given the
+/// same permanent storage, which is what the ODR DeclContext uniquing compares.
+/// It never assigns offsets, so unlike NonRelocatableStringpool it can be
+/// shared by the threads analyzing different object files. The strings are
+/// spread over independently locked shards to keep contention low.
+class UniquingStringPool {
+public:
+  /// Get permanent storage for \p S.
+  ///
+  /// \returns The StringRef that points to permanent storage to use
+  /// in place of \p S.
+  StringRef internString(StringRef S);
+
+private:
+  static constexpr unsigned NumShards = 32;
+
+  struct Shard {
+    std::mutex Mutex;
+    StringMap<char, BumpPtrAllocator> Strings;
+  };
+  Shard Shards[NumShards];
+};
+
 /// It's very easy to introduce bugs by passing the wrong string pool in the
 /// dwarf linker. By using strong types the interface enforces that the right
 /// kind of pool is used.
-struct UniqueTag {};
 struct OffsetsTag {};
-using UniquingStringPool = StrongType<NonRelocatableStringpool, UniqueTag>;
 using OffsetsStringPool = StrongType<NonRelocatableStringpool, OffsetsTag>;
 
-} // end namespace dsymutil
 } // end namespace llvm
 
-#endif // LLVM_TOOLS_DSYMUTIL_NONRELOCATABLESTRINGPOOL_H
+#endif // LLVM_CODEGEN_NONRELOCATABLESTRINGPOOL_H
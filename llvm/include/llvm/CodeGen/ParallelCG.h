@@ -22,6 +22,7 @@ namespace llvm {
 
 template <typename T> class ArrayRef;
 class Module;
+class TargetLibraryInfoImpl;
 class TargetOptions;
 class raw_pwrite_stream;
 
@@ -34,13 +35,17 @@ class raw_pwrite_stream;
 /// Writes bitcode for individual partitions into output streams in BCOSs, if
 /// BCOSs is not empty.
 ///
+/// If TLII is not null, code generation of every partition uses a copy of it
+/// as its TargetLibraryInfo.
+///
 /// \returns M if OSs.size() == 1, otherwise returns std::unique_ptr<Module>().
 std::unique_ptr<Module>
 splitCodeGen(std::unique_ptr<Module> M, ArrayRef<raw_pwrite_stream *> OSs,
              ArrayRef<llvm::raw_pwrite_stream *> BCOSs,
              const std::function<std::unique_ptr<TargetMachine>()> &TMFactory,
              TargetMachine::CodeGenFileType FileType = TargetMachine::CGFT_ObjectFile,
-             bool PreserveLocals = false);
+             bool PreserveLocals = false,
+             const TargetLibraryInfoImpl *TLII = nullptr);
 
 } // namespace llvm
 
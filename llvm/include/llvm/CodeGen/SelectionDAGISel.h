@@ -132,7 +132,16 @@ public:
     OPC_CheckChild0Same, OPC_CheckChild1Same,
     OPC_CheckChild2Same, OPC_CheckChild3Same,
     OPC_CheckPatternPredicate,
+    // Space-optimized forms that implicitly encode the predicate index.
+    OPC_CheckPatternPredicate0, OPC_CheckPatternPredicate1,
+    OPC_CheckPatternPredicate2, OPC_CheckPatternPredicate3,
+    OPC_CheckPatternPredicate4, OPC_CheckPatternPredicate5,
+    OPC_CheckPatternPredicate6, OPC_CheckPatternPredicate7,
     OPC_CheckPredicate,
+    // Space-optimized forms that implicitly encode the predicate index.
+    OPC_CheckPredicate0, OPC_CheckPredicate1, OPC_CheckPredicate2,
+    OPC_CheckPredicate3, OPC_CheckPredicate4, OPC_CheckPredicate5,
+    OPC_CheckPredicate6, OPC_CheckPredicate7,
     OPC_CheckPredicateWithOperands,
     OPC_CheckOpcode,
     OPC_SwitchOpcode,
@@ -167,9 +176,17 @@ public:
     OPC_EmitNode,
     // Space-optimized forms that implicitly encode number of result VTs.
     OPC_EmitNode0, OPC_EmitNode1, OPC_EmitNode2,
+    // Space-optimized forms that implicitly encode number of result VTs and
+    // the OPFL_None flags.
+    OPC_EmitNode0None, OPC_EmitNode1None, OPC_EmitNode2None,
     OPC_MorphNodeTo,
     // Space-optimized forms that implicitly encode number of result VTs.
     OPC_MorphNodeTo0, OPC_MorphNodeTo1, OPC_MorphNodeTo2,
+    // Space-optimized forms that implicitly encode number of result VTs and
+    // either the OPFL_None or the OPFL_Chain|OPFL_MemRefs flags.
+    OPC_MorphNodeTo0None, OPC_MorphNodeTo1None, OPC_MorphNodeTo2None,
+    OPC_MorphNodeTo0ChainMemRefs, OPC_MorphNodeTo1ChainMemRefs,
+    OPC_MorphNodeTo2ChainMemRefs,
     OPC_CompleteMatch,
     // Contains offset in table for pattern being selected
     OPC_Coverage
@@ -328,6 +345,37 @@ private:
   /// Perform instruction selection on all basic blocks in the function.
   void SelectAllBasicBlocks(const Function &Fn);
 
+  /// Phases of selecting a basic block, as reported by
+  /// -isel-report-expensive-blocks. The combines that run after type and
+  /// vector legalization are accounted to the legalization phases.
+  enum ISelPhase {
+    ISP_Build,
+    ISP_Combine1,
+    ISP_LegalizeTypes,
+    ISP_Legalize,
+    ISP_Combine2,
+    ISP_Select,
+    ISP_Schedule,
+    ISP_NumPhases
+  };
+
+  /// Wall time, in seconds, spent in each phase of selecting a basic block.
+  struct BlockISelTime {
+    const BasicBlock *BB;
+    double Phases[ISP_NumPhases];
+  };
+
+  /// Times of the blocks selected so far in the current function. Only
+  /// recorded with -isel-report-expensive-blocks.
+  SmallVector<BlockISelTime, 0> BlockISelTimes;
+
+  /// Return where the time spent in phase \p P of the current block is
+  /// accumulated, or null if block times are not recorded.
+  double *getPhaseTimeAccumulator(ISelPhase P);
+
+  /// Report the most expensive blocks of the current function.
+  void reportExpensiveBlocks(const Function &Fn);
+
   /// Perform instruction selection on a single basic block, for
   /// instructions between \p Begin and \p End.  \p HadTailCall will be set
   /// to true if a call in the block was translated as a tail call.
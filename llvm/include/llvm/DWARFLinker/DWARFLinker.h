@@ -0,0 +1,65 @@
+//===- DWARFLinker.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the interfaces a DWARF linker uses to learn which parts
+// of the input debug info describe code that made it into the output.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DWARFLINKER_DWARFLINKER_H
+#define LLVM_DWARFLINKER_DWARFLINKER_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
+#include <cstdint>
+
+namespace llvm {
+
+/// AddressesMap represents information about the valid addresses used by the
+/// debug info of one input object. Valid addresses are those which point into
+/// live code or data, i.e. whose relocations target sections that are placed
+/// in the linked output.
+///
+/// This is what decouples the DIE selection and cloning from the container
+/// format and from how the linked addresses are known: dsymutil gets them from
+/// the Mach-O debug map, a linker from its own symbol resolution.
+class AddressesMap {
+public:
+  virtual ~AddressesMap();
+
+  /// \returns true if there are valid relocations in the debug_info section
+  /// of the object.
+  virtual bool hasValidRelocs() const = 0;
+
+  /// Rewind the cursor over the relocations, before walking the debug_info
+  /// section again.
+  virtual void resetValidRelocs() = 0;
+
+  /// Check whether there is a valid relocation in the debug_info section
+  /// between \p StartOffset and \p EndOffset. If there is one, record the
+  /// address adjustment in \p Info and set its InDebugMap bit.
+  ///
+  /// The offsets must be queried in ascending order, the map is allowed not
+  /// to look back at the relocations it already went past.
+  ///
+  /// \returns true if a valid relocation was found.
+  virtual bool hasValidRelocation(uint64_t StartOffset, uint64_t EndOffset,
+                                  CompileUnit::DIEInfo &Info) = 0;
+
+  /// Apply the valid relocations to \p Data, which is at \p BaseOffset in the
+  /// debug_info section. Like hasValidRelocation(), this must be called with
+  /// ascending offsets.
+  ///
+  /// \returns true if any relocation was applied.
+  virtual bool applyValidRelocs(MutableArrayRef<char> Data, uint64_t BaseOffset,
+                                bool IsLittleEndian) = 0;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_DWARFLINKER_DWARFLINKER_H
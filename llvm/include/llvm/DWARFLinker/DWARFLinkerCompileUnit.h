@@ -1,4 +1,4 @@
-//===- tools/dsymutil/CompileUnit.h - Dwarf debug info linker ---*- C++ -*-===//
+//===- DWARFLinkerCompileUnit.h - Dwarf compile unit ------------*- C++ -*-===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,17 +6,16 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef LLVM_TOOLS_DSYMUTIL_COMPILEUNIT_H
-#define LLVM_TOOLS_DSYMUTIL_COMPILEUNIT_H
+#ifndef LLVM_DWARFLINKER_DWARFLINKERCOMPILEUNIT_H
+#define LLVM_DWARFLINKER_DWARFLINKERCOMPILEUNIT_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/IntervalMap.h"
 #include "llvm/CodeGen/DIE.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
 
 namespace llvm {
-namespace dsymutil {
-
-class DeclContext;
 
 template <typename KeyT, typename ValT>
 using HalfOpenIntervalMap =
@@ -74,6 +73,10 @@ public:
 
     /// Does DIE transitively refer an incomplete decl?
     bool Incomplete : 1;
+
+    /// Is the DIE in a clang module? This is recorded on Ctxt when the unit
+    /// gets cloned.
+    bool InClangModule : 1;
   };
 
   CompileUnit(DWARFUnit &OrigUnit, unsigned ID, bool CanUseODR,
@@ -248,6 +251,17 @@ public:
     ResolvedPaths[FileNum] = Path;
   }
 
+  /// Remember that the DIE at index \a Idx is in the ODR context \a Ctxt.
+  /// \returns the index of the first DIE of this unit in \a Ctxt, which is
+  /// \a Idx if no other DIE was seen in it.
+  uint32_t noteDeclContext(const DeclContext *Ctxt, uint32_t Idx) {
+    return FirstDIEInContext.try_emplace(Ctxt, Idx).first->second;
+  }
+
+  /// Drop the information gathered by noteDeclContext() once the unit has
+  /// been analyzed.
+  void clearDeclContexts() { FirstDIEInContext.shrink_and_clear(); }
+
   MCSymbol *getLabelBegin() { return LabelBegin; }
   void setLabelBegin(MCSymbol *S) { LabelBegin = S; }
 
@@ -312,6 +326,10 @@ private:
   /// for the purposes of getting a unique address for each string.
   std::vector<StringRef> ResolvedPaths;
 
+  /// The index of the first DIE of this unit found in each ODR context, used
+  /// to detect ambiguous contexts.
+  DenseMap<const DeclContext *, uint32_t> FirstDIEInContext;
+
   /// Is this unit subject to the ODR rule?
   bool HasODR;
 
@@ -325,7 +343,6 @@ private:
   std::string ClangModuleName;
 };
 
-} // end namespace dsymutil
 } // end namespace llvm
 
-#endif // LLVM_TOOLS_DSYMUTIL_COMPILEUNIT_H
+#endif // LLVM_DWARFLINKER_DWARFLINKERCOMPILEUNIT_H
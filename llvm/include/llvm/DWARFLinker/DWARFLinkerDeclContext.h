@@ -1,4 +1,4 @@
-//===- tools/dsymutil/DeclContext.h - Dwarf debug info linker ---*- C++ -*-===//
+//===- DWARFLinkerDeclContext.h - Dwarf debug info linker -------*- C++ -*-===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,50 +6,57 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef LLVM_TOOLS_DSYMUTIL_DECLCONTEXT_H
-#define LLVM_TOOLS_DSYMUTIL_DECLCONTEXT_H
+#ifndef LLVM_DWARFLINKER_DWARFLINKERDECLCONTEXT_H
+#define LLVM_DWARFLINKER_DWARFLINKERDECLCONTEXT_H
 
-#include "CompileUnit.h"
-#include "NonRelocatableStringpool.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseMapInfo.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
 #include "llvm/DebugInfo/DWARF/DWARFDie.h"
 #include "llvm/Support/Path.h"
+#include <mutex>
 
 namespace llvm {
-namespace dsymutil {
 
+class CompileUnit;
 struct DeclMapInfo;
 
 /// Small helper that resolves and caches file paths. This helps reduce the
 /// number of calls to realpath which is expensive. We assume the input are
 /// files, and cache the realpath of their parent. This way we can quickly
-/// resolve different files under the same path.
+/// resolve different files under the same path. It is safe to use from
+/// several threads.
 class CachedPathResolver {
 public:
   /// Resolve a path by calling realpath and cache its result. The returned
   /// StringRef is interned in the given \p StringPool.
-  StringRef resolve(std::string Path, NonRelocatableStringpool &StringPool) {
+  StringRef resolve(std::string Path, UniquingStringPool &StringPool) {
     StringRef FileName = sys::path::filename(Path);
     SmallString<256> ParentPath = sys::path::parent_path(Path);
-
-    // If the ParentPath has not yet been resolved, resolve and cache it for
-    // future look-ups.
-    if (!ResolvedPaths.count(ParentPath)) {
-      SmallString<256> RealPath;
-      sys::fs::real_path(ParentPath, RealPath);
-      ResolvedPaths.insert({ParentPath, StringRef(RealPath).str()});
+    SmallString<256> ResolvedPath;
+
+    {
+      std::lock_guard<std::mutex> Lock(ResolvedPathsMutex);
+      // If the ParentPath has not yet been resolved, resolve and cache it for
+      // future look-ups.
+      if (!ResolvedPaths.count(ParentPath)) {
+        SmallString<256> RealPath;
+        sys::fs::real_path(ParentPath, RealPath);
+        ResolvedPaths.insert({ParentPath, StringRef(RealPath).str()});
+      }
+      ResolvedPath = ResolvedPaths[ParentPath];
     }
 
     // Join the file name again with the resolved path.
-    SmallString<256> ResolvedPath(ResolvedPaths[ParentPath]);
     sys::path::append(ResolvedPath, FileName);
     return StringPool.internString(ResolvedPath);
   }
 
 private:
+  std::mutex ResolvedPathsMutex;
   StringMap<std::string> ResolvedPaths;
 };
 
@@ -78,11 +85,9 @@ public:
   DeclContext() : DefinedInClangModule(0), Parent(*this) {}
 
   DeclContext(unsigned Hash, uint32_t Line, uint32_t ByteSize, uint16_t Tag,
-              StringRef Name, StringRef File, const DeclContext &Parent,
-              DWARFDie LastSeenDIE = DWARFDie(), unsigned CUId = 0)
+              StringRef Name, StringRef File, const DeclContext &Parent)
       : QualifiedNameHash(Hash), Line(Line), ByteSize(ByteSize), Tag(Tag),
-        DefinedInClangModule(0), Name(Name), File(File), Parent(Parent),
-        LastSeenDIE(LastSeenDIE), LastSeenCompileUnitID(CUId) {}
+        DefinedInClangModule(0), Name(Name), File(File), Parent(Parent) {}
 
   uint32_t getQualifiedNameHash() const { return QualifiedNameHash; }
 
@@ -108,14 +113,16 @@ private:
   StringRef Name;
   StringRef File;
   const DeclContext &Parent;
-  DWARFDie LastSeenDIE;
-  uint32_t LastSeenCompileUnitID = 0;
   uint32_t CanonicalDIEOffset = 0;
 };
 
 /// This class gives a tree-like API to the DenseMap that stores the
 /// DeclContext objects. It holds the BumpPtrAllocator where these objects will
 /// be allocated.
+///
+/// The tree is shared by the threads analyzing the object files of a link.
+/// The contexts are spread over independently locked shards keyed on their
+/// qualified name hash, so that lookups of unrelated contexts don't contend.
 class DeclContextTree {
 public:
   /// Get the child of \a Context described by \a DIE in \a Unit. The
@@ -137,9 +144,16 @@ public:
   DeclContext &getRoot() { return Root; }
 
 private:
-  BumpPtrAllocator Allocator;
+  static constexpr unsigned NumShards = 64;
+
+  struct Shard {
+    std::mutex Mutex;
+    BumpPtrAllocator Allocator;
+    DeclContext::Map Contexts;
+  };
+
   DeclContext Root;
-  DeclContext::Map Contexts;
+  Shard Shards[NumShards];
 
   /// Cache resolved paths from the line table.
   CachedPathResolver PathResolver;
@@ -165,7 +179,6 @@ struct DeclMapInfo : private DenseMapInfo<DeclContext *> {
   }
 };
 
-} // end namespace dsymutil
 } // end namespace llvm
 
-#endif // LLVM_TOOLS_DSYMUTIL_DECLCONTEXT_H
+#endif // LLVM_DWARFLINKER_DWARFLINKERDECLCONTEXT_H
@@ -181,6 +181,10 @@ struct DIDumpOptions {
   bool SummarizeTypes = false;
   bool Verbose = false;
   bool DisplayRawContents = false;
+  /// Number of threads verify() may use to check the units of a DWARF
+  /// context that was created thread-safe. The errors are reported in unit
+  /// order regardless.
+  unsigned VerifyThreads = 1;
 
   /// Return default option set for printing a single DIE without children.
   static DIDumpOptions getForSingleDIE() {
@@ -205,7 +209,8 @@ class DIContext {
 public:
   enum DIContextKind {
     CK_DWARF,
-    CK_PDB
+    CK_PDB,
+    CK_SymbolizerIndex
   };
 
   DIContext(DIContextKind K) : Kind(K) {}
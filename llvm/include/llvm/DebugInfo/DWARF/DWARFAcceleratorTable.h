@@ -294,9 +294,19 @@ public:
     /// handle that check itself). Note that entries in NameIndexes which index
     /// just a single Compilation Unit are implicitly associated with that unit,
     /// so this function will return 0 even without an explicit
-    /// DW_IDX_compile_unit attribute.
+    /// DW_IDX_compile_unit attribute, unless the entry refers to a Type Unit.
     Optional<uint64_t> getCUIndex() const;
 
+    /// Returns the Index into the Local Type Unit list of the owning Name Index
+    /// or None if this Accelerator Entry does not refer to a Type Unit. The
+    /// returned Index may refer to a Foreign Type Unit, in which case it is
+    /// past the end of the Local Type Unit list.
+    Optional<uint64_t> getLocalTUIndex() const;
+
+    /// Returns the Offset of the Local Type Unit of this Accelerator Entry, or
+    /// None if it does not refer to a Local Type Unit.
+    Optional<uint64_t> getLocalTUOffset() const;
+
     /// .debug_names-specific getter, which always succeeds (DWARF v5 index
     /// entries always have a tag).
     dwarf::Tag tag() const { return Abbr->Tag; }
@@ -36,10 +36,12 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Host.h"
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 
@@ -91,6 +93,19 @@ class DWARFContext : public DIContext {
 
   std::unique_ptr<MCRegisterInfo> RegInfo;
 
+  /// True if the context may be queried from several threads at once.
+  bool ThreadSafe;
+  /// Guards the lazily built members of a thread-safe context. Recursive, as
+  /// building one member sometimes needs another one.
+  std::recursive_mutex Mutex;
+  /// Set once the units have been parsed, so that the unit getters of a
+  /// thread-safe context don't have to take the lock.
+  std::atomic<bool> NormalUnitsParsed{false};
+  std::atomic<bool> DWOUnitsParsed{false};
+
+  /// Lock Mutex if the context is thread-safe, return an empty lock otherwise.
+  std::unique_lock<std::recursive_mutex> lockIfThreadSafe();
+
   /// Read compile units from the debug_info section (if necessary)
   /// and type units from the debug_types sections (if necessary)
   /// and store them in NormalUnits.
@@ -106,8 +121,11 @@ class DWARFContext : public DIContext {
   std::unique_ptr<const DWARFObject> DObj;
 
 public:
+  /// If \p ThreadSafe is true, the context and its units can be queried
+  /// from several threads at once. The DIEs of a unit are then parsed as a
+  /// whole the first time any of them is needed.
   DWARFContext(std::unique_ptr<const DWARFObject> DObj,
-               std::string DWPName = "");
+               std::string DWPName = "", bool ThreadSafe = false);
   ~DWARFContext();
 
   DWARFContext(DWARFContext &) = delete;
@@ -115,6 +133,8 @@ public:
 
   const DWARFObject &getDWARFObj() const { return *DObj; }
 
+  bool isThreadSafe() const { return ThreadSafe; }
+
   static bool classof(const DIContext *DICtx) {
     return DICtx->getKind() == CK_DWARF;
   }
@@ -349,11 +369,12 @@ public:
   static std::unique_ptr<DWARFContext>
   create(const object::ObjectFile &Obj, const LoadedObjectInfo *L = nullptr,
          function_ref<ErrorPolicy(Error)> HandleError = defaultErrorHandler,
-         std::string DWPName = "");
+         std::string DWPName = "", bool ThreadSafe = false);
 
   static std::unique_ptr<DWARFContext>
   create(const StringMap<std::unique_ptr<MemoryBuffer>> &Sections,
-         uint8_t AddrSize, bool isLittleEndian = sys::IsLittleEndianHost);
+         uint8_t AddrSize, bool isLittleEndian = sys::IsLittleEndianHost,
+         bool ThreadSafe = false);
 
   /// Loads register info for the architecture of the provided object file.
   /// Improves readability of dumped DWARF expressions. Requires the caller to
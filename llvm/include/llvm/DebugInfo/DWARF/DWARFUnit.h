@@ -25,11 +25,13 @@
 #include "llvm/DebugInfo/DWARF/DWARFUnitIndex.h"
 #include "llvm/Support/DataExtractor.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -236,6 +238,19 @@ class DWARFUnit {
 
   std::shared_ptr<DWARFUnit> DWO;
 
+  /// Guards the lazily built state of the unit (its DIEs, the address to DIE
+  /// map, the base address and the DWO unit) when the context is thread-safe.
+  /// Recursive, as extracting the DIEs reads the unit DIE back.
+  mutable std::recursive_mutex Mutex;
+  /// Set once all the DIEs are extracted, so that the DIE getters of a
+  /// thread-safe unit don't have to take the lock.
+  std::atomic<bool> AllDIEsExtracted{false};
+  /// Set while this thread extracts the DIEs of a thread-safe unit.
+  bool ExtractingDIEs = false;
+
+  /// Lock Mutex if the context is thread-safe, return an empty lock otherwise.
+  std::unique_lock<std::recursive_mutex> lockIfThreadSafe() const;
+
   uint32_t getDIEIndex(const DWARFDebugInfoEntry *Die) {
     auto First = DieArray.data();
     assert(Die >= First && Die < First + DieArray.size());
@@ -499,6 +514,11 @@ public:
 
   Error tryExtractDIEsIfNeeded(bool CUDieOnly);
 
+  /// clearDIEs - Clear parsed DIEs to keep memory usage low. They are parsed
+  /// again on demand. This invalidates all the DWARFDies of the unit, which
+  /// in a thread-safe context means that no other thread may be using them.
+  void clearDIEs(bool KeepCUDie);
+
 private:
   /// Size in bytes of the .debug_info data associated with this compile unit.
   size_t getDebugInfoSize() const {
@@ -510,13 +530,13 @@ private:
   /// hasn't already been done
   void extractDIEsIfNeeded(bool CUDieOnly);
 
+  /// Parse the DIEs, without any locking.
+  Error extractDIEs(bool CUDieOnly);
+
   /// extractDIEsToVector - Appends all parsed DIEs to a vector.
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
 
-  /// clearDIEs - Clear parsed DIEs to keep memory usage low.
-  void clearDIEs(bool KeepCUDie);
-
   /// parseDWO - Parses .dwo file for current compile unit. Returns true if
   /// it was actually constructed.
   bool parseDWO();
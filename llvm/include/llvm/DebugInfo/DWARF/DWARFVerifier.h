@@ -161,6 +161,10 @@ private:
   /// Verifies the unit headers and contents in a .debug_info or .debug_types
   /// section.
   ///
+  /// If DumpOpts.VerifyThreads allows it and the context is thread-safe, the
+  /// unit contents are verified concurrently, each unit by its own verifier
+  /// writing to a buffer. The buffers are then printed in unit order.
+  ///
   /// \param S           The DWARF Section to verify.
   /// \param SectionKind The object-file section kind that S comes from.
   ///
@@ -13,19 +13,28 @@
 #ifndef LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 #define LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/simple_ilist.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/Error.h"
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace llvm {
+namespace object {
+class ELFObjectFileBase;
+} // end namespace object
+
 namespace symbolize {
 
 using namespace object;
@@ -44,6 +53,22 @@ public:
     std::vector<std::string> DsymHints;
     std::string FallbackDebugPath;
     std::string DWPName;
+    /// Directories searched for separate debug files by build ID, in the
+    /// /usr/lib/debug/.build-id/ab/cdef.debug layout. No lookup by build ID
+    /// is done when this is empty.
+    std::vector<std::string> DebugFileDirectory;
+    /// Upper bound, in bytes, on the binaries pruneCache() keeps open. Zero
+    /// means the cache is never pruned.
+    uint64_t MaxCacheSize = 0;
+    /// Directory of SymbolizerIndex files, named after the build ID or UUID
+    /// of the binaries they index. Binaries with an index there are
+    /// symbolized from it rather than from their DWARF, and a missing index
+    /// is built the first time its binary is loaded.
+    std::string IndexDirectory;
+    /// Allow the symbolize* methods to be called from several threads at
+    /// once. The caches are then guarded by a lock, and the DWARF contexts
+    /// are created in thread-safe mode.
+    bool ThreadSafe = false;
   };
 
   LLVMSymbolizer() = default;
@@ -67,6 +92,15 @@ public:
                  object::SectionedAddress ModuleOffset);
   void flush();
 
+  /// Evict the least recently used binaries, and everything created from
+  /// them, until the binaries left open fit in Options::MaxCacheSize. This
+  /// must not run concurrently with the symbolize* methods.
+  void pruneCache();
+
+  /// Look for a binary with the given build ID in the debug file
+  /// directories. \returns the path of the first match, or an empty string.
+  std::string lookUpBuildIDPath(ArrayRef<uint8_t> BuildID) const;
+
   static std::string
   DemangleName(const std::string &Name,
                const SymbolizableModule *DbiModuleDescriptor);
@@ -76,6 +110,43 @@ private:
   // corresponding debug info. These objects can be the same.
   using ObjectPair = std::pair<const ObjectFile *, const ObjectFile *>;
 
+  /// A binary opened by the symbolizer, linked into the LRU list of the
+  /// cache. Evicting it runs the evictors of all the cache entries that were
+  /// built from it; the first one registered erases the binary itself.
+  class CachedBinary : public ilist_node<CachedBinary> {
+  public:
+    CachedBinary(OwningBinary<Binary> Bin) : Bin(std::move(Bin)) {}
+
+    OwningBinary<Binary> &operator*() { return Bin; }
+    OwningBinary<Binary> *operator->() { return &Bin; }
+
+    /// Register \p Evictor to run when this binary leaves the cache.
+    void pushEvictor(std::function<void()> Evictor) {
+      Evictors.push_back(std::move(Evictor));
+    }
+
+    /// Run the registered evictors, in reverse order of registration. This
+    /// may destroy the binary.
+    void evict() {
+      SmallVector<std::function<void()>, 2> ToRun = std::move(Evictors);
+      for (auto &Evictor : llvm::reverse(ToRun))
+        Evictor();
+    }
+
+    uint64_t size() const;
+
+  private:
+    OwningBinary<Binary> Bin;
+    SmallVector<std::function<void()>, 2> Evictors;
+  };
+
+  /// A module along with the binaries it was created from, touched in the
+  /// LRU list whenever the module is used.
+  struct CachedModule {
+    std::unique_ptr<SymbolizableModule> Module;
+    SmallVector<CachedBinary *, 2> Binaries;
+  };
+
   Expected<DILineInfo>
   symbolizeCodeCommon(SymbolizableModule *Info,
                       object::SectionedAddress ModuleOffset);
@@ -92,12 +163,20 @@ private:
                    std::unique_ptr<DIContext> Context,
                    StringRef ModuleName);
 
+  /// Returns the index of \p Obj in Options::IndexDirectory, building it if
+  /// needed. The DWARF context it was built from is returned in that case,
+  /// and null if \p Obj cannot be indexed.
+  std::unique_ptr<DIContext> getOrCreateIndex(const ObjectFile &Obj);
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
   ObjectFile *lookUpDebuglinkObject(const std::string &Path,
                                     const ObjectFile *Obj,
                                     const std::string &ArchName);
+  ObjectFile *lookUpBuildIDObject(const std::string &Path,
+                                  const ELFObjectFileBase *Obj,
+                                  const std::string &ArchName);
 
   /// Returns pair of pointers to object and debug object.
   Expected<ObjectPair> getOrCreateObjectPair(const std::string &Path,
@@ -109,14 +188,30 @@ private:
   Expected<ObjectFile *> getOrCreateObject(const std::string &Path,
                                           const std::string &ArchName);
 
-  std::map<std::string, std::unique_ptr<SymbolizableModule>> Modules;
+  /// Move \p Bin to the most recently used end of the LRU list.
+  void recordAccess(CachedBinary &Bin);
+
+  std::unique_lock<std::mutex> lockIfThreadSafe();
+
+  std::map<std::string, CachedModule> Modules;
 
   /// Contains cached results of getOrCreateObjectPair().
   std::map<std::pair<std::string, std::string>, ObjectPair>
       ObjectPairForPathArch;
 
   /// Contains parsed binary for each path, or parsing error.
-  std::map<std::string, OwningBinary<Binary>> BinaryForPath;
+  std::map<std::string, CachedBinary> BinaryForPath;
+
+  /// The cached binary each object file of the caches above comes from.
+  std::map<const ObjectFile *, CachedBinary *> BinaryForObject;
+
+  /// The binaries of BinaryForPath, least recently used first.
+  simple_ilist<CachedBinary> LRUBinaries;
+  /// The total size of the binaries in LRUBinaries.
+  uint64_t CacheSize = 0;
+
+  /// Guards the caches above in thread-safe mode.
+  std::mutex Mutex;
 
   /// Parsed object file for path/architecture pair, where "path" refers
   /// to Mach-O universal binary.
@@ -0,0 +1,142 @@
+//===- SymbolizerIndex.h ----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares SymbolizerIndex, a precomputed address to source location
+// table that answers symbolizer queries without parsing DWARF.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZERINDEX_H
+#define LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZERINDEX_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstdint>
+#include <memory>
+
+namespace llvm {
+class DWARFContext;
+
+namespace symbolize {
+
+/// A DIContext answering line and inlining queries from an index file.
+///
+/// The index splits the address space of a linked binary into ranges over
+/// which DWARFContext::getInliningInfoForAddress() gives the same answer, and
+/// stores that answer for each range. It is built once from the DWARF of the
+/// binary, then mapped by later symbolizer runs, which then need neither the
+/// aranges nor the line tables of the binary.
+///
+/// Answers are identical to the DWARF ones for absolute file paths, including
+/// the names of all inlined frames. The index does not record local
+/// variables, embedded sources, or section indices, which makes it fit for
+/// linked binaries only.
+///
+/// The file is little-endian and laid out as a header, the identity bytes of
+/// the binary padded to 8 bytes, the Range array sorted by address, the Frame
+/// array and a string table.
+class SymbolizerIndex : public DIContext {
+public:
+  static constexpr uint32_t Magic = 0x58535953; // "SYSX"
+  static constexpr uint32_t Version = 1;
+
+  struct Header {
+    support::ulittle32_t Magic;
+    support::ulittle32_t Version;
+    support::ulittle32_t IdentitySize;
+    support::ulittle32_t NumRanges;
+    support::ulittle32_t NumFrames;
+    support::ulittle32_t StringTableSize;
+  };
+
+  /// A range starts at Start and ends where the next one starts. Its answer
+  /// is the NumFrames frames from FirstFrame, innermost first. Ranges without
+  /// frames are holes in the debug info.
+  struct Range {
+    support::ulittle64_t Start;
+    support::ulittle32_t FirstFrame;
+    support::ulittle32_t NumFrames;
+  };
+
+  /// One frame of an inlining chain. Names are string table offsets.
+  struct Frame {
+    support::ulittle32_t LinkageName;
+    support::ulittle32_t ShortName;
+    support::ulittle32_t FileName;
+    support::ulittle32_t Line;
+    support::ulittle32_t Column;
+    support::ulittle32_t StartLine;
+    support::ulittle32_t Discriminator;
+  };
+
+  /// Index the debug info of \p DICtx into \p OS. \p Identity is the build ID
+  /// or UUID of the binary, which create() checks the index against.
+  static Error write(DWARFContext &DICtx, ArrayRef<uint8_t> Identity,
+                     raw_ostream &OS);
+
+  /// Read the index in \p Buffer, and check that it was built for the binary
+  /// with the given \p Identity.
+  static Expected<std::unique_ptr<SymbolizerIndex>>
+  create(std::unique_ptr<MemoryBuffer> Buffer, ArrayRef<uint8_t> Identity);
+
+  /// Map the index file at \p Path, see create() above.
+  static Expected<std::unique_ptr<SymbolizerIndex>>
+  create(StringRef Path, ArrayRef<uint8_t> Identity);
+
+  static bool classof(const DIContext *DICtx) {
+    return DICtx->getKind() == CK_SymbolizerIndex;
+  }
+
+  ArrayRef<Range> ranges() const { return Ranges; }
+
+  void dump(raw_ostream &OS, DIDumpOptions DumpOpts) override;
+
+  DILineInfo getLineInfoForAddress(
+      object::SectionedAddress Address,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+  DILineInfoTable getLineInfoForAddressRange(
+      object::SectionedAddress Address, uint64_t Size,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+  DIInliningInfo getInliningInfoForAddress(
+      object::SectionedAddress Address,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+
+  std::vector<DILocal>
+  getLocalsForAddress(object::SectionedAddress Address) override {
+    return {};
+  }
+
+private:
+  SymbolizerIndex(std::unique_ptr<MemoryBuffer> Buffer, ArrayRef<Range> Ranges,
+                  ArrayRef<Frame> Frames, StringRef Strings)
+      : DIContext(CK_SymbolizerIndex), Buffer(std::move(Buffer)),
+        Ranges(Ranges), Frames(Frames), Strings(Strings) {}
+
+  /// \returns the range containing \p Address, or null if it is in a hole.
+  const Range *findRange(uint64_t Address) const;
+
+  DILineInfo getLineInfo(const Frame &F, DILineInfoSpecifier Specifier) const;
+
+  StringRef getString(uint32_t Offset) const {
+    return Offset < Strings.size() ? Strings.data() + Offset : StringRef();
+  }
+
+  std::unique_ptr<MemoryBuffer> Buffer;
+  ArrayRef<Range> Ranges;
+  ArrayRef<Frame> Frames;
+  StringRef Strings;
+};
+
+} // end namespace symbolize
+} // end namespace llvm
+
+#endif // LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZERINDEX_H
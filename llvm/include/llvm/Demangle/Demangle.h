@@ -31,6 +31,15 @@ enum : int {
 char *itaniumDemangle(const char *mangled_name, char *buf, size_t *n,
                       int *status);
 
+/// Demangle the Itanium names MangledNames[0, Count) with a single parser and
+/// output buffer, so that the memory of the ASTs and of the output is reused
+/// across the names instead of being allocated for each. Results[I] is set to
+/// the demangled MangledNames[I], or to the empty string if it is not a valid
+/// mangled name. Calls share no state, so threads may demangle the parts of a
+/// batch concurrently.
+/// \returns the number of names that were demangled.
+size_t itaniumDemangleBatch(const char *const *MangledNames, size_t Count,
+                            std::string *Results);
 
 enum MSDemangleFlags { MSDF_None = 0, MSDF_DumpBackrefs = 1 << 0 };
 char *microsoftDemangle(const char *mangled_name, char *buf, size_t *n,
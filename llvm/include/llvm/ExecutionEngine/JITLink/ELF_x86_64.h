@@ -0,0 +1,66 @@
+//===----- ELF_x86_64.h - JIT link functions for ELF/x86-64 -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// jit-link functions for ELF/x86-64.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_JITLINK_ELF_X86_64_H
+#define LLVM_EXECUTIONENGINE_JITLINK_ELF_X86_64_H
+
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+
+namespace llvm {
+namespace jitlink {
+
+namespace ELF_x86_64_Edges {
+
+/// ELF/x86-64 edge kinds. Unlike the MachO kinds, the addend of every edge
+/// is the full RELA addend, so PC-relative fixups are computed as
+/// Target + Addend - FixupAddress.
+enum ELFX86RelocationKind : Edge::Kind {
+  Branch32 = Edge::FirstRelocation,
+  Pointer32,
+  Pointer32Signed,
+  Pointer64,
+  PCRel32,
+  PCRel32GOTLoad,
+  PCRel32GOTLoadRelaxable,
+  PCRel32REXGOTLoadRelaxable,
+  // A relaxable GOT load after GOT construction: points at the GOT entry.
+  PCRel32GOTEntryRelaxable,
+  Delta64,
+  // The CIE pointer of an eh-frame FDE: Fixup - Target + Addend.
+  NegDelta32,
+};
+
+} // namespace ELF_x86_64_Edges
+
+/// jit-link the given object buffer, which must be an ELF x86-64 relocatable
+/// object file.
+///
+/// If PrePrunePasses is empty then a default mark-live pass will be inserted
+/// that will mark all atoms live. If PrePrunePasses is not empty, the caller
+/// is responsible for including a pass to mark atoms as live.
+///
+/// If PostPrunePasses is empty then a default GOT-and-stubs insertion pass will
+/// be inserted. If PostPrunePasses is not empty then the caller is responsible
+/// for including a pass to insert GOT and stub edges. The default pass keeps
+/// relaxable GOT loads (R_X86_64_GOTPCRELX and R_X86_64_REX_GOTPCRELX)
+/// relaxable: if the target turns out to be within 2Gb of the load, a 'mov'
+/// from the GOT entry is rewritten to a 'lea' of the target, and an indirect
+/// call or jmp through it to a direct one.
+void jitLink_ELF_x86_64(std::unique_ptr<JITLinkContext> Ctx);
+
+/// Return the string name of the given ELF x86-64 edge kind.
+StringRef getELFX86RelocationKindName(Edge::Kind R);
+
+} // end namespace jitlink
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_JITLINK_ELF_X86_64_H
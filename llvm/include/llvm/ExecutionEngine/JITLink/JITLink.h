@@ -717,9 +717,10 @@ public:
     // The atom we're looking for is the one before the atom we found.
     --I;
 
-    // Otherwise range check the atom that was found.
-    assert(!I->second->getContent().empty() && "Atom content not set");
-    if (Address >= I->second->getAddress() + I->second->getContent().size())
+    // Otherwise range check the atom that was found. Use the size rather
+    // than the content so that zero-fill atoms can be found too. Empty atoms
+    // (e.g. aliases) cover no address.
+    if (Address >= I->second->getAddress() + I->second->getSize())
       return nullptr;
 
     return I->second;
@@ -753,9 +754,11 @@ public:
   /// Remove the given defined atom from the graph.
   void removeDefinedAtom(DefinedAtom &DA) {
     if (AddrToAtomCache) {
-      assert(AddrToAtomCache->count(DA.getAddress()) &&
-             "Cache exists, but does not contain atom");
-      AddrToAtomCache->erase(DA.getAddress());
+      // Atoms that share an address (e.g. aliases) share an entry, which
+      // need not be this atom's.
+      auto I = AddrToAtomCache->find(DA.getAddress());
+      if (I != AddrToAtomCache->end() && I->second == &DA)
+        AddrToAtomCache->erase(I);
     }
     if (DA.hasName()) {
       assert(NamedAtoms.count(DA.getName()) && "Named atom not in map");
@@ -791,8 +794,13 @@ private:
   void refreshAddrToAtomCache() const {
     if (!AddrToAtomCache) {
       AddrToAtomCache = AddressToAtomMap();
-      for (auto *DA : defined_atoms())
-        (*AddrToAtomCache)[DA->getAddress()] = const_cast<DefinedAtom *>(DA);
+      // Where there are several atoms at one address, some of them empty,
+      // prefer the one that covers it.
+      for (auto *DA : defined_atoms()) {
+        auto *&Entry = (*AddrToAtomCache)[DA->getAddress()];
+        if (!Entry || !Entry->getSize())
+          Entry = const_cast<DefinedAtom *>(DA);
+      }
     }
   }
 
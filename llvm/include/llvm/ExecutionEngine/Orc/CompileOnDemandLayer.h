@@ -94,6 +94,13 @@ public:
 
   /// Sets the ImplSymbolMap
   void setImplMap(ImplSymbolMap *Imp);
+
+  /// Returns the IndirectStubsManager that holds the stubs for the functions
+  /// whose bodies are emitted into ImplD, or null if ImplD is not one of this
+  /// layer's implementation dylibs. Clients may repoint the stubs, e.g. at
+  /// re-optimized bodies.
+  IndirectStubsManager *getImplDylibStubsManager(const JITDylib &ImplD);
+
   /// Emits the given module. This should not be called by clients: it will be
   /// called by the JIT when a definition added via the add method is requested.
   void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
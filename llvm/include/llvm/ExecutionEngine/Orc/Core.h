@@ -287,6 +287,17 @@ public:
                                               std::move(K)));
   }
 
+  /// Called by materialization dispatchers that decide not to materialize
+  /// \p MU now, e.g. because it was cancelled. Hands it back to \p JD
+  /// unmaterialized, so that a later lookup of its symbols dispatches it
+  /// again. If queries are still waiting on any of its symbols, it is
+  /// dispatched again right away.
+  static void doReturnToJITDylib(JITDylib &JD,
+                                 std::unique_ptr<MaterializationUnit> MU) {
+    MaterializationResponsibility R(JD, MU->SymbolFlags, MU->K);
+    R.replace(std::move(MU));
+  }
+
   /// Called by JITDylibs to notify MaterializationUnits that the given symbol
   /// has been overridden.
   void doDiscard(const JITDylib &JD, const SymbolStringPtr &Name) {
@@ -19,8 +19,10 @@
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/MaterializationDispatcher.h"
 #include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/ExecutionEngine/Orc/TieredCompilation.h"
 #include "llvm/Support/ThreadPool.h"
 
 namespace llvm {
@@ -39,7 +41,7 @@ public:
   static Expected<std::unique_ptr<LLJIT>> Create(LLJITBuilderState &S);
 
   /// Destruct this instance. If a multi-threaded instance, waits for all
-  /// compile threads to complete.
+  /// compile threads or the materialization dispatcher to complete.
   ~LLJIT();
 
   /// Returns the ExecutionSession for this instance.
@@ -138,6 +140,7 @@ protected:
 
   DataLayout DL;
   std::unique_ptr<ThreadPool> CompileThreads;
+  std::unique_ptr<MaterializationDispatcher> Dispatcher;
 
   std::unique_ptr<ObjectLayer> ObjLinkingLayer;
   std::unique_ptr<IRCompileLayer> CompileLayer;
@@ -153,7 +156,8 @@ class LLLazyJIT : public LLJIT {
 public:
 
   /// Set an IR transform (e.g. pass manager pipeline) to run on each function
-  /// when it is compiled.
+  /// when it is compiled. With tiered compilation, it only runs when a hot
+  /// function is recompiled.
   void setLazyCompileTransform(IRTransformLayer::TransformFunction Transform) {
     TransformLayer->setTransform(std::move(Transform));
   }
@@ -172,14 +176,23 @@ public:
     return addLazyIRModule(Main, std::move(M));
   }
 
+  /// Returns the tiered compilation manager, or null if tiered compilation
+  /// was not enabled.
+  TieredCompilationManager *getTieredCompilationManager() {
+    return TieredCompilation.get();
+  }
+
 private:
 
   // Create a single-threaded LLLazyJIT instance.
   LLLazyJIT(LLLazyJITBuilderState &S, Error &Err);
 
   std::unique_ptr<LazyCallThroughManager> LCTMgr;
+  std::unique_ptr<IRCompileLayer> OptimizingCompileLayer;
   std::unique_ptr<IRTransformLayer> TransformLayer;
+  std::unique_ptr<IRTransformLayer> InstrumentLayer;
   std::unique_ptr<CompileOnDemandLayer> CODLayer;
+  std::unique_ptr<TieredCompilationManager> TieredCompilation;
 };
 
 class LLJITBuilderState {
@@ -196,9 +209,15 @@ public:
   ObjectLinkingLayerCreator CreateObjectLinkingLayer;
   CompileFunctionCreator CreateCompileFunction;
   unsigned NumCompileThreads = 0;
+  std::unique_ptr<MaterializationDispatcher> Dispatcher;
+  ObjectCache *ObjCache = nullptr;
 
   /// Called prior to JIT class construcion to fix up defaults.
   Error prepareForConstruction();
+
+  /// Returns true if materialization may happen on other threads than the
+  /// one that requested it.
+  bool isConcurrent() const { return NumCompileThreads > 0 || Dispatcher; }
 };
 
 template <typename JITType, typename SetterImpl, typename State>
@@ -241,6 +260,16 @@ public:
     return impl();
   }
 
+  /// Set an ObjectCache for the default compile function to query before
+  /// compiling, e.g. a PersistentObjectCache.
+  ///
+  /// The cache is not owned by the JIT and must outlive it. It is ignored if
+  /// a CompileFunctionCreator is set.
+  SetterImpl &setObjectCache(ObjectCache *ObjCache) {
+    impl().ObjCache = ObjCache;
+    return impl();
+  }
+
   /// Set the number of compile threads to use.
   ///
   /// If set to zero, compilation will be performed on the execution thread when
@@ -254,6 +283,18 @@ public:
     return impl();
   }
 
+  /// Set the MaterializationDispatcher to use, e.g. a
+  /// PriorityMaterializationDispatcher.
+  ///
+  /// If set, the dispatcher decides where and in which order compilation
+  /// happens, and the number of compile threads is ignored. The JIT owns the
+  /// dispatcher and waits for it to finish before it is destroyed.
+  SetterImpl &setMaterializationDispatcher(
+      std::unique_ptr<MaterializationDispatcher> Dispatcher) {
+    impl().Dispatcher = std::move(Dispatcher);
+    return impl();
+  }
+
   /// Create an instance of the JIT.
   Expected<std::unique_ptr<JITType>> create() {
     if (auto Err = impl().prepareForConstruction())
@@ -286,6 +327,9 @@ public:
   JITTargetAddress LazyCompileFailureAddr = 0;
   std::unique_ptr<LazyCallThroughManager> LCTMgr;
   IndirectStubsManagerBuilderFunction ISMBuilder;
+  Optional<TieredCompilationManager::Options> TieredCompilation;
+  Optional<JITTargetMachineBuilder> OptimizingJTMB;
+  CompileFunctionCreator CreateOptimizingCompileFunction;
 
   Error prepareForConstruction();
 };
@@ -321,6 +365,21 @@ public:
     this->impl().ISMBuilder = std::move(ISMBuilder);
     return this->impl();
   }
+
+  /// Enable tiered compilation.
+  ///
+  /// Functions are first compiled at -O0, which uses FastISel where the
+  /// target supports it, and count their calls. Hot functions are then
+  /// recompiled in the background at the JITTargetMachineBuilder's
+  /// optimization level, after the lazy compile transform, and their stubs
+  /// are pointed at the new code. Tiered compilation requires in-process
+  /// execution. Only second-tier code goes to the object cache, since
+  /// first-tier code embeds the addresses of its call counters.
+  SetterImpl &
+  setTieredCompilation(TieredCompilationManager::Options TieredCompilation) {
+    this->impl().TieredCompilation = std::move(TieredCompilation);
+    return this->impl();
+  }
 };
 
 /// Constructs LLLazyJIT instances.
@@ -75,12 +75,24 @@ public:
         std::move(NotifyResolved));
   }
 
+  /// Called each time a call-through trampoline is taken, before the target
+  /// symbol is looked up.
+  using NotifyCallThroughFunction = std::function<void(
+      JITDylib &SourceJD, const SymbolStringPtr &SymbolName)>;
+
   // Return a free call-through trampoline and bind it to look up and call
   // through to the given symbol.
   Expected<JITTargetAddress> getCallThroughTrampoline(
       JITDylib &SourceJD, SymbolStringPtr SymbolName,
       std::shared_ptr<NotifyResolvedFunction> NotifyResolved);
 
+  /// Observe every call through, e.g. to record the order in which lazily
+  /// compiled functions are first called. Must be set before any trampoline
+  /// is taken.
+  void setNotifyCallThrough(NotifyCallThroughFunction NotifyCallThrough) {
+    this->NotifyCallThrough = std::move(NotifyCallThrough);
+  }
+
 protected:
   LazyCallThroughManager(ExecutionSession &ES,
                          JITTargetAddress ErrorHandlerAddr,
@@ -105,6 +117,7 @@ private:
   std::unique_ptr<TrampolinePool> TP;
   ReexportsMap Reexports;
   NotifiersMap Notifiers;
+  NotifyCallThroughFunction NotifyCallThrough;
 };
 
 /// A lazy call-through manager that builds trampolines in the current process.
@@ -0,0 +1,169 @@
+//===- MaterializationDispatcher.h - Dispatch materialization ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Pluggable dispatchers for ExecutionSession::setDispatchMaterialization.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_MATERIALIZATIONDISPATCHER_H
+#define LLVM_EXECUTIONENGINE_ORC_MATERIALIZATIONDISPATCHER_H
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// Materializes the MaterializationUnits handed out by an ExecutionSession.
+class MaterializationDispatcher {
+public:
+  virtual ~MaterializationDispatcher();
+
+  /// Arrange for MU to be materialized in JD.
+  virtual void dispatch(JITDylib &JD,
+                        std::unique_ptr<MaterializationUnit> MU) = 0;
+
+  /// Block until every unit dispatched so far has been materialized or
+  /// dropped. Must not be called from a materializing thread.
+  virtual void wait() = 0;
+
+  /// Return a function that forwards to dispatch, for use with
+  /// ExecutionSession::setDispatchMaterialization. This dispatcher must
+  /// outlive any use of the returned function.
+  ExecutionSession::DispatchMaterializationFunction getDispatchFunction();
+};
+
+/// Materializes units on a fixed set of threads, highest priority first.
+///
+/// Units are ordered by the priority that the PriorityFunction assigns to
+/// them when they are dispatched, and then in dispatch order. A unit that
+/// has been cancelled or whose deadline has passed by the time a thread picks
+/// it up is not materialized: it is handed back to its JITDylib, so that a
+/// later lookup of its symbols dispatches it again. Queries can't be
+/// withdrawn, so if any are still waiting on its symbols it is materialized
+/// anyway.
+///
+/// If MaxQueueDepth units are already waiting, a newly dispatched unit is
+/// materialized on the dispatching thread. That bounds the outstanding work
+/// without the deadlock that blocking would risk when materializers dispatch
+/// units themselves.
+class PriorityMaterializationDispatcher : public MaterializationDispatcher {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Returns the priority of MU. Higher priorities are materialized first.
+  using PriorityFunction =
+      std::function<int(const JITDylib &JD, const MaterializationUnit &MU)>;
+
+  /// Returns the point in time after which MU should no longer be
+  /// materialized, or None if it has no deadline.
+  using DeadlineFunction = std::function<Optional<Clock::time_point>(
+      const JITDylib &JD, const MaterializationUnit &MU)>;
+
+  /// Returns true if MU should not be materialized now, e.g. because the
+  /// queries that needed it have already failed.
+  using CancelFunction =
+      std::function<bool(const JITDylib &JD, const MaterializationUnit &MU)>;
+
+  struct Options {
+    /// The number of materialization threads.
+    unsigned NumThreads = 1;
+
+    /// The maximum number of units waiting for a thread, or zero for no
+    /// limit.
+    size_t MaxQueueDepth = 0;
+
+    /// If not set, all units have the same priority.
+    PriorityFunction GetPriority;
+
+    /// If not set, units have no deadline.
+    DeadlineFunction GetDeadline;
+
+    /// If not set, units are never cancelled.
+    CancelFunction IsCancelled;
+  };
+
+  struct Statistics {
+    uint64_t NumDispatched = 0;
+    uint64_t NumMaterialized = 0;
+    /// Units that were materialized on the dispatching thread because the
+    /// queue was full.
+    uint64_t NumMaterializedInline = 0;
+    /// Units that were handed back to their JITDylib unmaterialized.
+    uint64_t NumCancelled = 0;
+    uint64_t NumExpired = 0;
+    size_t QueueDepth = 0;
+    size_t MaxQueueDepth = 0;
+    /// Time between dispatch and the start of materialization.
+    Clock::duration TotalQueueTime = Clock::duration::zero();
+    Clock::duration MaxQueueTime = Clock::duration::zero();
+    /// Time spent in MaterializationUnit::materialize.
+    Clock::duration TotalMaterializeTime = Clock::duration::zero();
+    Clock::duration MaxMaterializeTime = Clock::duration::zero();
+  };
+
+  PriorityMaterializationDispatcher(Options Opts);
+
+  /// Waits for all dispatched units, then joins the threads.
+  ~PriorityMaterializationDispatcher() override;
+
+  void dispatch(JITDylib &JD, std::unique_ptr<MaterializationUnit> MU) override;
+  void wait() override;
+
+  /// Return a snapshot of the statistics.
+  Statistics getStatistics() const;
+
+private:
+  struct Task {
+    JITDylib *JD;
+    std::unique_ptr<MaterializationUnit> MU;
+    int Priority;
+    uint64_t Seq;
+    Clock::time_point DispatchTime;
+    Optional<Clock::time_point> Deadline;
+    /// Set for units that were handed back while queries were waiting on
+    /// them, which must not be cancelled again.
+    bool MustMaterialize = false;
+  };
+
+  static bool runsAfter(const Task &LHS, const Task &RHS);
+  void runTask(Task &T, bool Inline);
+  void runWorker();
+
+  Options Opts;
+
+  mutable std::mutex QueueMutex;
+  std::condition_variable QueueCondition;
+  std::condition_variable DoneCondition;
+  std::vector<Task> Queue;
+  /// Units that are being handed back to their JITDylib.
+  DenseSet<const MaterializationUnit *> Returning;
+  unsigned NumActive = 0;
+  uint64_t NextSeq = 0;
+  bool Stopping = false;
+  Statistics Stats;
+
+#if LLVM_ENABLE_THREADS
+  std::vector<std::thread> Threads;
+#endif
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_MATERIALIZATIONDISPATCHER_H
@@ -19,6 +19,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
 #include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
 #include "llvm/ExecutionEngine/Orc/OrcRemoteTargetRPCAPI.h"
@@ -26,14 +27,19 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -329,6 +335,170 @@ public:
     std::vector<EHFrame> RegisteredEHFrames;
   };
 
+  /// JITLink memory manager backed by a file that is mapped into both this
+  /// process and the remote. Linked sections are written through the local
+  /// mapping, so their contents never cross the RPC channel: finalizing an
+  /// allocation is a single call that sets protections on the remote.
+  ///
+  /// The arena has a fixed size, chosen when the manager is created. Freed
+  /// allocations are returned to it for reuse. Both processes must be on the
+  /// same host and able to open the file.
+  class SharedMemoryJITLinkMemoryManager
+      : public jitlink::JITLinkMemoryManager {
+    friend class OrcRemoteTargetClient;
+
+  public:
+    ~SharedMemoryJITLinkMemoryManager() {
+      Client.destroyRemoteAllocator(Id);
+      LLVM_DEBUG(dbgs() << "Destroyed remote allocator " << Id << "\n");
+    }
+
+    SharedMemoryJITLinkMemoryManager(const SharedMemoryJITLinkMemoryManager &) =
+        delete;
+    SharedMemoryJITLinkMemoryManager &
+    operator=(const SharedMemoryJITLinkMemoryManager &) = delete;
+
+    Expected<std::unique_ptr<Allocation>>
+    allocate(const SegmentsRequestMap &Request) override {
+      uint64_t PageSize = Client.getPageSize();
+      DenseMap<unsigned, Range> Segs;
+
+      for (auto &KV : Request) {
+        auto &Seg = KV.second;
+
+        if (Seg.getContentAlignment() > PageSize ||
+            PageSize % Seg.getContentAlignment() != 0) {
+          releaseRanges(Segs);
+          return make_error<StringError>("Cannot request higher than page "
+                                         "alignment",
+                                         inconvertibleErrorCode());
+        }
+
+        uint64_t ZeroFillStart =
+            alignTo(Seg.getContentSize(), Seg.getZeroFillAlignment());
+        uint64_t SegmentSize = ZeroFillStart + Seg.getZeroFillSize();
+
+        auto R = reserve(alignTo(SegmentSize, PageSize));
+        if (!R) {
+          releaseRanges(Segs);
+          return R.takeError();
+        }
+
+        // Pages may be reused from an earlier allocation.
+        memset(LocalMapping->data() + R->Offset + ZeroFillStart, 0,
+               Seg.getZeroFillSize());
+        Segs[KV.first] = *R;
+      }
+
+      return std::unique_ptr<Allocation>(
+          new SharedMemoryAllocation(*this, std::move(Segs)));
+    }
+
+  private:
+    struct Range {
+      uint64_t Offset = 0;
+      uint64_t Size = 0;
+    };
+
+    class SharedMemoryAllocation : public Allocation {
+    public:
+      SharedMemoryAllocation(SharedMemoryJITLinkMemoryManager &Parent,
+                             DenseMap<unsigned, Range> Segs)
+          : Parent(Parent), Segs(std::move(Segs)) {}
+
+      MutableArrayRef<char> getWorkingMemory(ProtectionFlags Seg) override {
+        assert(Segs.count(Seg) && "No allocation for segment");
+        auto &R = Segs[Seg];
+        return {Parent.LocalMapping->data() + R.Offset,
+                static_cast<size_t>(R.Size)};
+      }
+
+      JITTargetAddress getTargetMemory(ProtectionFlags Seg) override {
+        assert(Segs.count(Seg) && "No allocation for segment");
+        return Parent.RemoteBase + Segs[Seg].Offset;
+      }
+
+      void finalizeAsync(FinalizeContinuation OnFinalize) override {
+        std::vector<std::tuple<JITTargetAddress, uint64_t, uint32_t>> Ranges;
+        for (auto &KV : Segs)
+          Ranges.push_back(std::make_tuple(Parent.RemoteBase + KV.second.Offset,
+                                           KV.second.Size, KV.first));
+        OnFinalize(Parent.Client.protectSharedMemory(Parent.Id, Ranges));
+      }
+
+      Error deallocate() override {
+        Parent.releaseRanges(Segs);
+        Segs.clear();
+        return Error::success();
+      }
+
+    private:
+      SharedMemoryJITLinkMemoryManager &Parent;
+      DenseMap<unsigned, Range> Segs;
+    };
+
+    SharedMemoryJITLinkMemoryManager(
+        OrcRemoteTargetClient &Client, ResourceIdMgr::ResourceId Id,
+        std::unique_ptr<sys::fs::mapped_file_region> LocalMapping,
+        JITTargetAddress RemoteBase)
+        : Client(Client), Id(Id), LocalMapping(std::move(LocalMapping)),
+          RemoteBase(RemoteBase) {
+      FreeRanges[0] = this->LocalMapping->size();
+    }
+
+    /// Carve Size bytes (a multiple of the page size) out of the arena using
+    /// a first-fit search of the free ranges.
+    Expected<Range> reserve(uint64_t Size) {
+      std::lock_guard<std::mutex> Lock(FreeRangesMutex);
+      for (auto I = FreeRanges.begin(), E = FreeRanges.end(); I != E; ++I) {
+        if (I->second < Size)
+          continue;
+        Range R;
+        R.Offset = I->first;
+        R.Size = Size;
+        uint64_t Remaining = I->second - Size;
+        FreeRanges.erase(I);
+        if (Remaining)
+          FreeRanges[R.Offset + Size] = Remaining;
+        return R;
+      }
+      return make_error<StringError>(
+          "Shared memory arena exhausted (requested " + Twine(Size) +
+              " bytes)",
+          inconvertibleErrorCode());
+    }
+
+    /// Return the given ranges to the arena, merging them with their free
+    /// neighbours.
+    void releaseRanges(const DenseMap<unsigned, Range> &Segs) {
+      std::lock_guard<std::mutex> Lock(FreeRangesMutex);
+      for (auto &KV : Segs) {
+        uint64_t Offset = KV.second.Offset;
+        uint64_t Size = KV.second.Size;
+        auto Next = FreeRanges.lower_bound(Offset);
+        if (Next != FreeRanges.end() && Offset + Size == Next->first) {
+          Size += Next->second;
+          Next = FreeRanges.erase(Next);
+        }
+        if (Next != FreeRanges.begin()) {
+          auto Prev = std::prev(Next);
+          if (Prev->first + Prev->second == Offset) {
+            Prev->second += Size;
+            continue;
+          }
+        }
+        FreeRanges[Offset] = Size;
+      }
+    }
+
+    OrcRemoteTargetClient &Client;
+    ResourceIdMgr::ResourceId Id;
+    std::unique_ptr<sys::fs::mapped_file_region> LocalMapping;
+    JITTargetAddress RemoteBase;
+    std::mutex FreeRangesMutex;
+    std::map<uint64_t, uint64_t> FreeRanges;
+  };
+
   /// Remote indirect stubs manager.
   class RemoteIndirectStubsManager : public IndirectStubsManager {
   public:
@@ -546,6 +716,58 @@ public:
         new RemoteRTDyldMemoryManager(*this, Id));
   }
 
+  /// Create a SharedMemoryJITLinkMemoryManager with an arena of Size bytes.
+  /// The file backing the arena is created in SharedMemDir (the system
+  /// temporary directory if empty), which must allow its pages to be mapped
+  /// executable. The file is unlinked once both processes have mapped it.
+  Expected<std::unique_ptr<SharedMemoryJITLinkMemoryManager>>
+  createSharedMemoryJITLinkMemoryManager(uint64_t Size,
+                                         StringRef SharedMemDir = "") {
+    Size = alignTo(Size, getPageSize());
+
+    SmallString<128> Model;
+    if (SharedMemDir.empty())
+      sys::path::system_temp_directory(true, Model);
+    else
+      Model = SharedMemDir;
+    sys::path::append(Model, "orc-shared-mem-%%%%%%");
+
+    int FD;
+    SmallString<128> Path;
+    if (auto EC = sys::fs::createUniqueFile(Model, FD, Path))
+      return errorCodeToError(EC);
+    std::error_code EC = sys::fs::resize_file(FD, Size);
+    std::unique_ptr<sys::fs::mapped_file_region> LocalMapping;
+    if (!EC)
+      LocalMapping = std::make_unique<sys::fs::mapped_file_region>(
+          sys::fs::convertFDToNativeFile(FD),
+          sys::fs::mapped_file_region::readwrite, Size, 0, EC);
+    sys::Process::SafelyCloseFileDescriptor(FD);
+    if (EC) {
+      sys::fs::remove(Path);
+      return errorCodeToError(EC);
+    }
+
+    auto Id = AllocatorIds.getNext();
+    if (auto Err = callB<mem::CreateRemoteAllocator>(Id)) {
+      sys::fs::remove(Path);
+      return std::move(Err);
+    }
+    auto RemoteBase = callB<mem::MapSharedMemory>(Id, Path.str(), Size);
+    sys::fs::remove(Path);
+    if (!RemoteBase) {
+      destroyRemoteAllocator(Id);
+      return RemoteBase.takeError();
+    }
+
+    LLVM_DEBUG(dbgs() << "Allocator " << Id << " mapped " << Size
+                      << " bytes of shared memory at "
+                      << format("0x%016" PRIx64, *RemoteBase) << "\n");
+    return std::unique_ptr<SharedMemoryJITLinkMemoryManager>(
+        new SharedMemoryJITLinkMemoryManager(*this, Id, std::move(LocalMapping),
+                                             *RemoteBase));
+  }
+
   /// Create an RCIndirectStubsManager that will allocate stubs on the remote
   /// target.
   Expected<std::unique_ptr<RemoteIndirectStubsManager>>
@@ -644,6 +866,13 @@ private:
     return callB<mem::ReadMem>(Src, Size);
   }
 
+  Error protectSharedMemory(
+      ResourceIdMgr::ResourceId Id,
+      const std::vector<std::tuple<JITTargetAddress, uint64_t, uint32_t>>
+          &Ranges) {
+    return callB<mem::ProtectSharedMemory>(Id, Ranges);
+  }
+
   Error registerEHFrames(JITTargetAddress &RAddr, uint32_t Size) {
     // FIXME: Duplicate error and report it via ReportError too?
     return callB<eh::RegisterEHFrames>(RAddr, Size);
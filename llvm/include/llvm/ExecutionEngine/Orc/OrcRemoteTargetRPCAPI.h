@@ -234,6 +234,30 @@ namespace mem {
     static const char *getName() { return "DestroyRemoteAllocator"; }
   };
 
+  /// Map the file at Path, created and sized by the client, into the remote's
+  /// address space on behalf of the given allocator. Returns the address of
+  /// the mapping, which is released when the allocator is destroyed.
+  class MapSharedMemory
+      : public rpc::Function<MapSharedMemory,
+                             JITTargetAddress(ResourceIdMgr::ResourceId AllocID,
+                                              std::string Path,
+                                              uint64_t Size)> {
+  public:
+    static const char *getName() { return "MapSharedMemory"; }
+  };
+
+  /// Set the memory protections on ranges of an allocator's shared memory
+  /// mappings. Each range is (Addr, Size, ProtFlags).
+  class ProtectSharedMemory
+      : public rpc::Function<
+            ProtectSharedMemory,
+            void(ResourceIdMgr::ResourceId AllocID,
+                 std::vector<std::tuple<JITTargetAddress, uint64_t, uint32_t>>
+                     Ranges)> {
+  public:
+    static const char *getName() { return "ProtectSharedMemory"; }
+  };
+
   /// Read a remote memory block.
   class ReadMem
       : public rpc::Function<ReadMem, std::vector<uint8_t>(JITTargetAddress Src,
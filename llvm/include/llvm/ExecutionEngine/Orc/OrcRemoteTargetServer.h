@@ -19,6 +19,7 @@
 #include "llvm/ExecutionEngine/Orc/OrcRemoteTargetRPCAPI.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/Memory.h"
@@ -68,6 +69,9 @@ public:
                                            &ThisT::handleCreateRemoteAllocator);
     addHandler<mem::DestroyRemoteAllocator>(
         *this, &ThisT::handleDestroyRemoteAllocator);
+    addHandler<mem::MapSharedMemory>(*this, &ThisT::handleMapSharedMemory);
+    addHandler<mem::ProtectSharedMemory>(*this,
+                                         &ThisT::handleProtectSharedMemory);
     addHandler<mem::ReadMem>(*this, &ThisT::handleReadMem);
     addHandler<mem::ReserveMem>(*this, &ThisT::handleReserveMem);
     addHandler<mem::SetProtections>(*this, &ThisT::handleSetProtections);
@@ -106,10 +110,13 @@ public:
 private:
   struct Allocator {
     Allocator() = default;
-    Allocator(Allocator &&Other) : Allocs(std::move(Other.Allocs)) {}
+    Allocator(Allocator &&Other)
+        : Allocs(std::move(Other.Allocs)),
+          SharedMappings(std::move(Other.SharedMappings)) {}
 
     Allocator &operator=(Allocator &&Other) {
       Allocs = std::move(Other.Allocs);
+      SharedMappings = std::move(Other.SharedMappings);
       return *this;
     }
 
@@ -139,8 +146,48 @@ private:
           sys::Memory::protectMappedMemory(I->second, Flags));
     }
 
+    Error mapSharedMemory(void *&Addr, const std::string &Path, size_t Size) {
+      int FD;
+      if (auto EC = sys::fs::openFileForReadWrite(
+              Path, FD, sys::fs::CD_OpenExisting, sys::fs::OF_None))
+        return errorCodeToError(EC);
+
+      std::error_code EC;
+      auto Mapping = std::make_unique<sys::fs::mapped_file_region>(
+          sys::fs::convertFDToNativeFile(FD),
+          sys::fs::mapped_file_region::readwrite, Size, 0, EC);
+      sys::Process::SafelyCloseFileDescriptor(FD);
+      if (EC)
+        return errorCodeToError(EC);
+
+      Addr = Mapping->data();
+      SharedMappings.push_back(std::move(Mapping));
+      return Error::success();
+    }
+
+    Error setSharedMemoryProtections(void *Addr, size_t Size, unsigned Flags) {
+      char *Start = static_cast<char *>(Addr);
+      auto I = std::find_if(
+          SharedMappings.begin(), SharedMappings.end(),
+          [&](const std::unique_ptr<sys::fs::mapped_file_region> &M) {
+            return Start >= M->data() &&
+                   Start + Size <= M->data() + M->size();
+          });
+      if (I == SharedMappings.end())
+        return errorCodeToError(
+            orcError(OrcErrorCode::RemoteMProtectAddrUnrecognized));
+
+      sys::MemoryBlock MB(Addr, Size);
+      if (auto EC = sys::Memory::protectMappedMemory(MB, Flags))
+        return errorCodeToError(EC);
+      if (Flags & sys::Memory::MF_EXEC)
+        sys::Memory::InvalidateInstructionCache(Addr, Size);
+      return Error::success();
+    }
+
   private:
     std::map<void *, sys::MemoryBlock> Allocs;
+    std::vector<std::unique_ptr<sys::fs::mapped_file_region>> SharedMappings;
   };
 
   static Error doNothing() { return Error::success(); }
@@ -349,6 +396,50 @@ private:
                            IndirectStubSize);
   }
 
+  Expected<JITTargetAddress> handleMapSharedMemory(ResourceIdMgr::ResourceId Id,
+                                                   std::string Path,
+                                                   uint64_t Size) {
+    auto I = Allocators.find(Id);
+    if (I == Allocators.end())
+      return errorCodeToError(
+               orcError(OrcErrorCode::RemoteAllocatorDoesNotExist));
+    auto &Allocator = I->second;
+    void *LocalAddr = nullptr;
+    if (auto Err = Allocator.mapSharedMemory(LocalAddr, Path, Size))
+      return std::move(Err);
+
+    LLVM_DEBUG(dbgs() << "  Allocator " << Id << " mapped '" << Path
+                      << "' at " << LocalAddr << " (" << Size << " bytes)\n");
+
+    return static_cast<JITTargetAddress>(
+        reinterpret_cast<uintptr_t>(LocalAddr));
+  }
+
+  Error handleProtectSharedMemory(
+      ResourceIdMgr::ResourceId Id,
+      std::vector<std::tuple<JITTargetAddress, uint64_t, uint32_t>> Ranges) {
+    auto I = Allocators.find(Id);
+    if (I == Allocators.end())
+      return errorCodeToError(
+               orcError(OrcErrorCode::RemoteAllocatorDoesNotExist));
+    auto &Allocator = I->second;
+    for (auto &R : Ranges) {
+      void *LocalAddr =
+          reinterpret_cast<void *>(static_cast<uintptr_t>(std::get<0>(R)));
+      uint64_t Size = std::get<1>(R);
+      uint32_t Flags = std::get<2>(R);
+      LLVM_DEBUG(dbgs() << "  Allocator " << Id << " set permissions on "
+                        << LocalAddr << " (" << Size << " bytes) to "
+                        << (Flags & sys::Memory::MF_READ ? 'R' : '-')
+                        << (Flags & sys::Memory::MF_WRITE ? 'W' : '-')
+                        << (Flags & sys::Memory::MF_EXEC ? 'X' : '-') << "\n");
+      if (auto Err =
+              Allocator.setSharedMemoryProtections(LocalAddr, Size, Flags))
+        return Err;
+    }
+    return Error::success();
+  }
+
   Expected<std::vector<uint8_t>> handleReadMem(JITTargetAddress RSrc,
                                                uint64_t Size) {
     uint8_t *Src = reinterpret_cast<uint8_t *>(static_cast<uintptr_t>(RSrc));
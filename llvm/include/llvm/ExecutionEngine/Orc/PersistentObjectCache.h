@@ -0,0 +1,87 @@
+//===- PersistentObjectCache.h - On-disk JIT object cache -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps compiled objects in a directory, so that they can
+// be reused by later processes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+/// Caches relocatable objects in a directory, keyed by a hash of the IR and
+/// of the target configuration that compiled it.
+///
+/// Pass the cache to SimpleCompiler or ConcurrentIRCompiler (or to
+/// LLJITBuilder::setObjectCache) to skip compiling modules that an earlier
+/// process already compiled. The key covers the module's bitcode, so IR that
+/// embeds process-specific addresses never hits. Entries are named like
+/// those of the ThinLTO cache, so the directory is pruned with pruneCache.
+///
+/// The cache is best-effort: entries that can not be read or written are
+/// treated as misses. It is safe to use from several compile threads and
+/// from several processes sharing the directory.
+class PersistentObjectCache : public ObjectCache {
+public:
+  struct Statistics {
+    uint64_t NumHits = 0;
+    uint64_t NumMisses = 0;
+    uint64_t NumStored = 0;
+  };
+
+  /// Create a cache in CacheDir, creating the directory if needed, for
+  /// objects compiled by target machines built from JTMB. The directory is
+  /// pruned with Policy when the cache is created and when prune is called.
+  static Expected<std::unique_ptr<PersistentObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+
+  /// Prune the cache directory according to the policy.
+  void prune();
+
+  /// Return a snapshot of the statistics.
+  Statistics getStatistics() const;
+
+private:
+  PersistentObjectCache(std::string CacheDir, std::string TargetKey,
+                        CachePruningPolicy Policy);
+
+  std::string getEntryPath(const Module &M) const;
+
+  std::string CacheDir;
+  /// The target configuration, hashed into every key.
+  std::string TargetKey;
+  CachePruningPolicy Policy;
+
+  mutable std::mutex CacheMutex;
+  /// Paths computed by getObject for modules that missed, so that
+  /// notifyObjectCompiled does not have to hash them again.
+  DenseMap<const Module *, std::string> MissedEntries;
+  Statistics Stats;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
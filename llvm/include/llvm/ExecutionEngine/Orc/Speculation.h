@@ -16,11 +16,14 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Passes/PassBuilder.h"
 
+#include <deque>
 #include <mutex>
 #include <type_traits>
 #include <utility>
@@ -29,6 +32,8 @@
 namespace llvm {
 namespace orc {
 
+class CallSequenceSpeculator;
+class LazyCallThroughManager;
 class Speculator;
 
 // Track the Impls (JITDylib,Symbols) of Symbols while lazy call through
@@ -36,6 +41,7 @@ class Speculator;
 // stays in consistent state after read/write
 
 class ImplSymbolMap {
+  friend class CallSequenceSpeculator;
   friend class Speculator;
 
 public:
@@ -148,6 +154,64 @@ private:
   DenseSet<TargetFAddr> AlreadyExecuted;
   StubAddrLikelies GlobalSpecMap;
 };
+/// Speculates from the order in which functions were first called on earlier
+/// runs.
+///
+/// Attach the speculator to the LazyCallThroughManager of a
+/// CompileOnDemandLayer whose implementation symbols are tracked in Impl.
+/// Each time a call-through trampoline is taken, i.e. the first time a lazily
+/// compiled function is called, the speculator records the call and looks up
+/// the implementations of the functions that the profile says are first
+/// called soon after it. With a concurrent materialization dispatcher those
+/// functions are compiled on the compile threads while the caller runs.
+///
+/// The profile is a call graph summary: for each function, how often each
+/// other function was among the next Lookahead functions to be first called.
+/// A profile read with readProfile is merged with the calls recorded in this
+/// session when it is written back with writeProfile, so profiles improve
+/// across runs.
+class CallSequenceSpeculator {
+public:
+  CallSequenceSpeculator(ImplSymbolMap &Impl, ExecutionSession &ES,
+                         unsigned Lookahead = 4, unsigned MaxCandidates = 4)
+      : AliaseeImplTable(Impl), ES(ES), Lookahead(Lookahead),
+        MaxCandidates(MaxCandidates) {}
+  CallSequenceSpeculator(const CallSequenceSpeculator &) = delete;
+  CallSequenceSpeculator &operator=(const CallSequenceSpeculator &) = delete;
+
+  /// Record and speculate on the call throughs of LCTMgr. The speculator must
+  /// outlive LCTMgr.
+  void attach(LazyCallThroughManager &LCTMgr);
+
+  /// Record the first call of Name and speculatively compile the functions
+  /// that are likely to be called next.
+  void notifyCallThrough(const SymbolStringPtr &Name);
+
+  /// Merge the profile at Path into this speculator's profile.
+  Error readProfile(StringRef Path);
+
+  /// Write this speculator's profile, including the calls recorded so far,
+  /// to Path.
+  Error writeProfile(StringRef Path);
+
+private:
+  std::vector<SymbolStringPtr> getCandidates(StringRef Name);
+
+  std::mutex ConcurrentAccess;
+  ImplSymbolMap &AliaseeImplTable;
+  ExecutionSession &ES;
+  unsigned Lookahead;
+  unsigned MaxCandidates;
+  /// Caller -> (successor -> count).
+  StringMap<StringMap<uint64_t>> Profile;
+  /// The last Lookahead functions to be first called.
+  std::deque<std::string> Recent;
+  /// Functions that have been first called in this session.
+  StringSet<> Called;
+  /// Functions that have been speculatively compiled in this session.
+  StringSet<> Speculated;
+};
+
 // replace DenseMap with Pair
 class IRSpeculationLayer : public IRLayer {
 public:
@@ -0,0 +1,132 @@
+//===- TieredCompilation.h - Re-optimize hot lazy code ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Counts calls into code compiled by a CompileOnDemandLayer and recompiles
+// hot code with a second, optimizing, layer.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILATION_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILATION_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// Re-optimizes hot code emitted through a CompileOnDemandLayer.
+///
+/// The instrument transform is meant to sit between the CompileOnDemandLayer
+/// and a fast, first-tier, compile layer. It keeps an uninstrumented copy of
+/// each partition and makes every function in the partition count its calls.
+/// Once a partition has been called HotCallCount times the copy is added to
+/// the optimizing layer, and the CompileOnDemandLayer stubs of its functions
+/// are pointed at the new bodies. Calls that are already running finish in
+/// the first-tier code.
+///
+/// The call counters live in this process, so the instrumented code has to
+/// run in it too. Partitions that still contain local symbols (e.g. whole
+/// modules emitted by CompileOnDemandLayer::compileWholeModule) can not be
+/// recompiled separately and are left at the first tier.
+class TieredCompilationManager {
+public:
+  struct Options {
+    /// The number of calls into a partition after which it is re-optimized.
+    uint64_t HotCallCount = 1000;
+
+    /// How often a background thread looks for hot partitions. If zero,
+    /// or if LLVM was built without threads, clients call
+    /// reoptimizeHotPartitions themselves.
+    std::chrono::milliseconds PollInterval = std::chrono::milliseconds(10);
+  };
+
+  struct Statistics {
+    uint64_t NumInstrumented = 0;
+    uint64_t NumReoptimized = 0;
+    uint64_t NumFailed = 0;
+  };
+
+  /// Construct a manager that recompiles partitions emitted by CODLayer with
+  /// OptimizingLayer, and starts the background thread if one is requested.
+  TieredCompilationManager(ExecutionSession &ES,
+                           CompileOnDemandLayer &CODLayer,
+                           IRLayer &OptimizingLayer, Options Opts);
+
+  /// Stops the background thread.
+  ~TieredCompilationManager();
+
+  /// Instrument TSM, a partition being emitted by the CompileOnDemandLayer,
+  /// and remember it for re-optimization.
+  Expected<ThreadSafeModule> instrument(ThreadSafeModule TSM,
+                                        const MaterializationResponsibility &R);
+
+  /// Return a function that forwards to instrument, for use with an
+  /// IRTransformLayer. This manager must outlive any use of the returned
+  /// function.
+  IRTransformLayer::TransformFunction getInstrumentFunction();
+
+  /// Re-optimize every partition whose call count has reached HotCallCount.
+  /// Partitions that fail to re-optimize stay at the first tier.
+  Error reoptimizeHotPartitions();
+
+  /// Return a snapshot of the statistics.
+  Statistics getStatistics() const;
+
+private:
+  struct Partition {
+    JITDylib *ImplD = nullptr;
+    /// The uninstrumented copy, on its own context.
+    ThreadSafeModule TSM;
+    SymbolNameSet Functions;
+    std::atomic<uint64_t> Calls{0};
+  };
+
+  static bool isTierable(const Function &F);
+  void addCallCounter(Function &F, std::atomic<uint64_t> &Calls);
+  JITDylib &getOptimizedDylib(JITDylib &ImplD);
+  Error reoptimize(Partition &P);
+  void runPollLoop();
+
+  ExecutionSession &ES;
+  CompileOnDemandLayer &CODLayer;
+  IRLayer &OptimizingLayer;
+  Options Opts;
+
+  mutable std::mutex StateMutex;
+  /// Partitions are never freed: first-tier code may still be running and
+  /// updating their counters.
+  std::vector<std::unique_ptr<Partition>> Partitions;
+  std::vector<Partition *> Pending;
+  DenseMap<JITDylib *, JITDylib *> OptimizedDylibs;
+  Statistics Stats;
+
+#if LLVM_ENABLE_THREADS
+  std::condition_variable PollCondition;
+  bool StopPolling = false;
+  std::thread PollThread;
+#endif
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILATION_H
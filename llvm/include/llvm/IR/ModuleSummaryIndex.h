@@ -1315,13 +1315,14 @@ public:
   }
 
   /// For the given \p TypeId, this returns the TypeIdCompatibleVtableMap
-  /// entry if present in the summary map. This may be used when importing.
-  Optional<TypeIdCompatibleVtableInfo>
+  /// entry if present in the summary map, or null otherwise. This may be used
+  /// when importing.
+  const TypeIdCompatibleVtableInfo *
   getTypeIdCompatibleVtableSummary(StringRef TypeId) const {
     auto I = TypeIdCompatibleVtableMap.find(TypeId);
     if (I == TypeIdCompatibleVtableMap.end())
-      return None;
-    return I->second;
+      return nullptr;
+    return &I->second;
   }
 
   /// Collect for the given module the list of functions it defines
@@ -13,6 +13,7 @@
 #ifndef LLVM_IR_REMARKSTREAMER_H
 #define LLVM_IR_REMARKSTREAMER_H
 
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/Remarks/RemarkSerializer.h"
 #include "llvm/Support/Error.h"
@@ -29,6 +30,9 @@ class RemarkStreamer {
   const std::string Filename;
   /// The regex used to filter remarks based on the passes that emit them.
   Optional<Regex> PassFilter;
+  /// The result of PassFilter for the pass names seen so far. A compilation
+  /// emits many remarks from few passes.
+  StringMap<bool> PassFilterResults;
   /// The object used to serialize the remarks to a specific format.
   std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer;
 
@@ -49,6 +53,8 @@ public:
   /// Set a pass filter based on a regex \p Filter.
   /// Returns an error if the regex is invalid.
   Error setFilter(StringRef Filter);
+  /// Return true if the remarks of the pass \p PassName pass the filter.
+  bool matchesFilter(StringRef PassName);
   /// Emit a diagnostic through the streamer.
   void emit(const DiagnosticInfoOptimizationBase &Diag);
 };
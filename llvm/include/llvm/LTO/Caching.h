@@ -30,8 +30,16 @@ using AddBufferFn =
 /// Create a local file system cache which uses the given cache directory and
 /// file callback. This function also creates the cache directory if it does not
 /// already exist.
-Expected<NativeObjectCache> localCache(StringRef CacheDirectoryPath,
-                                       AddBufferFn AddBuffer);
+///
+/// If SharedCacheDirectoryPath is not empty, it names a second cache
+/// directory, e.g. on a network file system, that is shared with other
+/// machines. Entries missing from the local directory are looked up there
+/// and copied into the local directory, and newly created entries are copied
+/// there. Errors accessing the shared directory are ignored. The shared
+/// directory is not pruned; run pruneCache() on it separately.
+Expected<NativeObjectCache>
+localCache(StringRef CacheDirectoryPath, AddBufferFn AddBuffer,
+           StringRef SharedCacheDirectoryPath = StringRef());
 
 } // namespace lto
 } // namespace llvm
@@ -55,6 +55,13 @@ struct Config {
   /// Disable entirely the optimizer, including importing for ThinLTO
   bool CodeGenOnly = false;
 
+  /// When the regular LTO module is split for parallel code generation, run
+  /// the function simplification passes that follow interprocedural
+  /// optimization on each partition in its own thread instead of on the whole
+  /// module. Only works with the new pass manager. Note that PostOptModuleHook
+  /// then sees the module before these passes have run.
+  bool ParallelFunctionPasses = false;
+
   /// Run PGO context sensitive IR instrumentation.
   bool RunCSIRInstr = false;
 
@@ -240,12 +240,18 @@ ThinBackend createInProcessThinBackend(unsigned ParallelismLevel);
 /// the final ThinLTO linking. Can be nullptr.
 /// OnWrite is callback which receives module identifier and notifies LTO user
 /// that index file for the module (and optionally imports file) was created.
+/// It is called as soon as the files of each module are written, so a build
+/// system can start the backend job for that module while the index files of
+/// other modules are still being written. Calls are serialized, but modules
+/// are not reported in any particular order.
+/// ParallelismLevel is the number of threads used to write index files.
 using IndexWriteCallback = std::function<void(const std::string &)>;
 ThinBackend createWriteIndexesThinBackend(std::string OldPrefix,
                                           std::string NewPrefix,
                                           bool ShouldEmitImportsFiles,
                                           raw_fd_ostream *LinkedObjectsFile,
-                                          IndexWriteCallback OnWrite);
+                                          IndexWriteCallback OnWrite,
+                                          unsigned ParallelismLevel = 1);
 
 /// This class implements a resolution-based interface to LLVM's LTO
 /// functionality. It supports regular LTO, parallel LTO code generation and
@@ -144,6 +144,16 @@ public:
                                     const MCRelaxableFragment *DF,
                                     const MCAsmLayout &Layout) const = 0;
 
+  /// Check whether an instruction whose only fixup is pc-relative with the
+  /// final value \p Value, already known when the instruction is emitted,
+  /// fits without relaxation. The streamer then emits it as data instead of
+  /// keeping a relaxable fragment for it. Only targets whose relaxation
+  /// decision doesn't depend on the layout should override this.
+  virtual bool fixupFitsWithoutRelaxation(const MCFixup &Fixup,
+                                          int64_t Value) const {
+    return false;
+  }
+
   /// Relax the instruction in the given fragment to the next wider instruction.
   ///
   /// \param Inst The instruction to relax, which may be the same as the
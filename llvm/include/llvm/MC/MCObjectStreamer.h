@@ -54,6 +54,11 @@ class MCObjectStreamer : public MCStreamer {
   void EmitInstructionImpl(const MCInst &Inst, const MCSubtargetInfo &STI);
   void resolvePendingFixups();
 
+  /// If the relaxable instruction \p Inst doesn't need to be relaxed because
+  /// its target is already known and in range, append it to the current data
+  /// fragment and return true.
+  bool tryEmitResolvedRelaxable(const MCInst &Inst, const MCSubtargetInfo &STI);
+
 protected:
   MCObjectStreamer(MCContext &Context, std::unique_ptr<MCAsmBackend> TAB,
                    std::unique_ptr<MCObjectWriter> OW,
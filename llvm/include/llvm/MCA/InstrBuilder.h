@@ -47,6 +47,8 @@ class InstrBuilder {
 
   bool FirstCallInst;
   bool FirstReturnInst;
+  // True if instructions that are not correctly modeled are diagnosed.
+  bool WarnUnmodeled = true;
 
   Expected<const InstrDesc &> createInstrDescImpl(const MCInst &MCI);
   Expected<const InstrDesc &> getOrCreateInstrDesc(const MCInst &MCI);
@@ -68,6 +70,10 @@ public:
     FirstReturnInst = true;
   }
 
+  /// Clients other than llvm-mca may have nobody to show warnings about
+  /// calls and returns to.
+  void setWarnUnmodeled(bool Enable) { WarnUnmodeled = Enable; }
+
   Expected<std::unique_ptr<Instruction>> createInstruction(const MCInst &MCI);
 };
 } // namespace mca
@@ -0,0 +1,96 @@
+//===--------------------- ThroughputEstimator.h ----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines class ThroughputEstimator, which runs sequences of MCInst
+/// through the default pipeline and reports how many cycles they take. It is
+/// meant for clients, such as cost models in the compiler, that need many
+/// estimates and no views.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_MCA_THROUGHPUTESTIMATOR_H
+#define LLVM_MCA_THROUGHPUTESTIMATOR_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrAnalysis.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MCA/Context.h"
+#include "llvm/MCA/InstrBuilder.h"
+#include "llvm/Support/Error.h"
+
+namespace llvm {
+namespace mca {
+
+/// The result of simulating a sequence of instructions in a loop.
+struct ThroughputEstimate {
+  /// The number of iterations of the sequence that were simulated.
+  unsigned Iterations = 0;
+  /// The number of cycles it took to retire all of them.
+  unsigned TotalCycles = 0;
+  /// The number of micro opcodes of one iteration.
+  unsigned NumMicroOps = 0;
+  /// The static bound on the reciprocal throughput of the sequence, see
+  /// computeBlockRThroughput().
+  double BlockRThroughput = 0.0;
+
+  /// The average number of cycles that one iteration takes.
+  double getCyclesPerIteration() const {
+    return Iterations ? (double)TotalCycles / Iterations : 0.0;
+  }
+};
+
+/// Estimates the throughput of instruction sequences with the default
+/// out-of-order pipeline, like llvm-mca does for a code region.
+///
+/// Instruction descriptors are shared by all the sequences, and the estimate
+/// of every sequence is cached under its opcodes and operands, so that asking
+/// again for the same sequence only costs a lookup. Instructions that are not
+/// correctly modeled, such as calls, are not diagnosed.
+class ThroughputEstimator {
+  const MCSubtargetInfo &STI;
+  const MCRegisterInfo &MRI;
+  InstrBuilder IB;
+  PipelineOptions PO;
+  unsigned Iterations;
+
+  // Used to map resource indices to processor resource IDs.
+  SmallVector<unsigned, 8> ResIdx2ProcResID;
+
+  StringMap<ThroughputEstimate> Cache;
+
+  ThroughputEstimator(const ThroughputEstimator &) = delete;
+  ThroughputEstimator &operator=(const ThroughputEstimator &) = delete;
+
+  Expected<ThroughputEstimate> simulate(ArrayRef<MCInst> Insts);
+
+public:
+  /// \p MCIA may be null, in which case no zero idioms or dependency breaking
+  /// instructions are recognized. \p Iterations is the number of iterations
+  /// to simulate, 0 for llvm-mca's default.
+  ThroughputEstimator(const MCSubtargetInfo &STI, const MCInstrInfo &MCII,
+                      const MCRegisterInfo &MRI, const MCInstrAnalysis *MCIA,
+                      const PipelineOptions &PO, unsigned Iterations = 0);
+
+  /// Estimate the throughput of \p Insts, which must not be empty, run in a
+  /// loop.
+  Expected<ThroughputEstimate> estimate(ArrayRef<MCInst> Insts);
+
+  /// Forget all the cached estimates.
+  void clearCache() { Cache.clear(); }
+};
+
+} // namespace mca
+} // namespace llvm
+
+#endif // LLVM_MCA_THROUGHPUTESTIMATOR_H
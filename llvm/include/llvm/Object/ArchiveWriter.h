@@ -13,6 +13,7 @@
 #ifndef LLVM_OBJECT_ARCHIVEWRITER_H
 #define LLVM_OBJECT_ARCHIVEWRITER_H
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Support/Error.h"
@@ -25,6 +26,11 @@ struct NewArchiveMember {
   StringRef MemberName;
   sys::TimePoint<std::chrono::seconds> ModTime;
   unsigned UID = 0, GID = 0, Perms = 0644;
+  /// The NUL-terminated names of the symbols this member adds to the archive
+  /// symbol table, if already known, e.g. from the symbol table of the archive
+  /// the member is taken from. writeArchive() then doesn't read the member,
+  /// unless the list is empty.
+  Optional<std::string> SymbolNames;
 
   NewArchiveMember() = default;
   NewArchiveMember(MemoryBufferRef BufRef);
@@ -171,6 +171,10 @@ public:
   static Expected<OwningBinary<SymbolicFile>>
   createSymbolicFile(StringRef ObjectPath);
 
+  /// Return true if createSymbolicFile can read a file of type \p Type. A
+  /// bitcode file needs a \p Context.
+  static bool isSymbolicFile(file_magic Type, const LLVMContext *Context);
+
   static bool classof(const Binary *v) {
     return v->isSymbolic();
   }
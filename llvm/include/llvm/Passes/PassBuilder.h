@@ -99,6 +99,23 @@ public:
   /// Tuning option to disable promotion to scalars in LICM with MemorySSA, if
   /// the number of access is too large.
   unsigned LicmMssaNoAccForPromotionCap;
+
+  /// Tuning option to leave the function simplification passes built by
+  /// \c buildLTOFunctionSimplificationPipeline out of the LTO default
+  /// pipeline, so that the caller can run them separately, e.g. on each
+  /// partition of a split module in its own context. Its default value is
+  /// false.
+  bool DeferLTOFunctionSimplification;
+
+  /// Tuning option to run the O1 function simplification pipeline instead of
+  /// the one for the requested level on functions that the profile shows are
+  /// cold in the call graph. Only has an effect at O2 and O3 with a profile.
+  /// Its default value is that of the flag: `-npm-cold-functions-at-o1`.
+  bool ColdFunctionsAtO1;
+
+  /// Tuning option to enable/disable function merging. Its default value is
+  /// false.
+  bool MergeFunctions;
 };
 
 /// This class provides access to building LLVM's passes.
@@ -403,6 +420,19 @@ public:
                                             bool DebugLogging,
                                             ModuleSummaryIndex *ExportSummary);
 
+  /// Build the function simplification pipeline that the LTO default pipeline
+  /// runs after interprocedural optimization.
+  ///
+  /// These passes only look at one function at a time, so when
+  /// \c PipelineTuningOptions::DeferLTOFunctionSimplification is set they can
+  /// be run independently on the partitions of the module after it has been
+  /// split for parallel code generation.
+  ///
+  /// Note that \p Level cannot be `O0` here.
+  FunctionPassManager
+  buildLTOFunctionSimplificationPipeline(OptimizationLevel Level,
+                                         bool DebugLogging = false);
+
   /// Build the default `AAManager` with the default alias analysis pipeline
   /// registered.
   AAManager buildDefaultAAPipeline();
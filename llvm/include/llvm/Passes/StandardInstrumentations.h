@@ -19,8 +19,11 @@
 #include "llvm/IR/PassInstrumentation.h"
 #include "llvm/IR/PassTimingInfo.h"
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace llvm {
 
@@ -53,11 +56,70 @@ private:
   bool StoreModuleDesc = false;
 };
 
+/// Instrumentation to verify the IR after passes.
+///
+/// Only the IR unit that a pass ran on is verified, so function, loop and
+/// CGSCC passes cost a verification of the functions they could have changed
+/// rather than of the whole module. Pass managers and adaptors are skipped,
+/// as the passes they contain have already been verified.
+class VerifyInstrumentation {
+public:
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+
+private:
+  void verifyAfterPass(StringRef PassID, Any IR);
+};
+
+/// Instrumentation to profile passes per IR unit.
+///
+/// Records the time and the change in instruction count of every run of a
+/// pass on a function, loop, SCC or module, and keeps the slowest ones. They
+/// are written in the Chrome trace format used by -ftime-trace, so that single
+/// pathological functions show up without bisecting.
+///
+/// The profilers of a process, e.g. those of the threads of a parallel LTO
+/// backend, share their records. The file is written with the records of all
+/// of them whenever the last live profiler is destroyed.
+class PassProfilingInstrumentation {
+public:
+  using ClockType = std::chrono::steady_clock;
+
+  struct Record {
+    std::string PassID;
+    std::string IRName;
+    uint64_t ThreadID;
+    ClockType::time_point Start;
+    ClockType::duration Duration;
+    int64_t InstsBefore;
+    int64_t InstsAfter;
+  };
+
+  PassProfilingInstrumentation() = default;
+  ~PassProfilingInstrumentation();
+
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+
+private:
+  bool runBeforePass(StringRef PassID, Any IR);
+  void runBeforeSkippedPass(StringRef PassID);
+  void runAfterPass(StringRef PassID, Any IR);
+  void runAfterPassInvalidated(StringRef PassID);
+  void finishRecord(int64_t InstsAfter);
+
+  /// Records of the passes that are currently running, innermost last.
+  SmallVector<Record, 4> Stack;
+  /// The slowest finished records, kept as a heap with the fastest on top.
+  std::vector<Record> Slowest;
+  bool Enabled = false;
+};
+
 /// This class provides an interface to register all the standard pass
 /// instrumentations and manages their state (if any).
 class StandardInstrumentations {
   PrintIRInstrumentation PrintIR;
   TimePassesHandler TimePasses;
+  VerifyInstrumentation Verify;
+  PassProfilingInstrumentation PassProfiling;
 
 public:
   StandardInstrumentations() = default;
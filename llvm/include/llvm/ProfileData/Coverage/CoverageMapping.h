@@ -19,6 +19,7 @@
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/None.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/iterator.h"
@@ -328,6 +329,10 @@ class FunctionRecordIterator
   ArrayRef<FunctionRecord> Records;
   ArrayRef<FunctionRecord>::iterator Current;
   StringRef Filename;
+  /// When filtering by a file using an index, the indices into Records of the
+  /// remaining candidates, the first of which is Current.
+  ArrayRef<unsigned> RecordIndices;
+  bool UseRecordIndices = false;
 
   /// Skip records whose primary file is not \c Filename.
   void skipOtherFiles();
@@ -339,6 +344,15 @@ public:
     skipOtherFiles();
   }
 
+  /// Iterate over the records for \p Filename among those at the increasing
+  /// \p RecordIndices_ into \p Records_.
+  FunctionRecordIterator(ArrayRef<FunctionRecord> Records_,
+                         ArrayRef<unsigned> RecordIndices_, StringRef Filename)
+      : Records(Records_), Filename(Filename), RecordIndices(RecordIndices_),
+        UseRecordIndices(true) {
+    skipOtherFiles();
+  }
+
   FunctionRecordIterator() : Current(Records.begin()) {}
 
   bool operator==(const FunctionRecordIterator &RHS) const {
@@ -349,7 +363,10 @@ public:
 
   FunctionRecordIterator &operator++() {
     assert(Current != Records.end() && "incremented past end");
-    ++Current;
+    if (UseRecordIndices)
+      RecordIndices = RecordIndices.drop_front();
+    else
+      ++Current;
     skipOtherFiles();
     return *this;
   }
@@ -508,28 +525,41 @@ public:
 class CoverageMapping {
   DenseMap<size_t, DenseSet<size_t>> RecordProvenance;
   std::vector<FunctionRecord> Functions;
+  /// Maps the hash of each filename to the increasing indices of the records
+  /// in Functions which have regions in a file of that name.
+  DenseMap<size_t, SmallVector<unsigned, 0>> FilenameHash2RecordIndices;
   std::vector<std::pair<std::string, uint64_t>> FuncHashMismatches;
 
   CoverageMapping() = default;
 
-  /// Add a function record corresponding to \p Record.
-  Error loadFunctionRecord(const CoverageMappingRecord &Record,
-                           IndexedInstrProfReader &ProfileReader);
+  /// Add \p Function unless a record for the same function and files has
+  /// already been added.
+  void addFunctionRecord(FunctionRecord &&Function);
+
+  /// Get the indices of the function records which may have regions in
+  /// \p Filename. Hash collisions make this a superset of the exact answer.
+  ArrayRef<unsigned> getImpreciseRecordIndicesForFilename(
+      StringRef Filename) const;
 
 public:
   CoverageMapping(const CoverageMapping &) = delete;
   CoverageMapping &operator=(const CoverageMapping &) = delete;
 
   /// Load the coverage mapping using the given readers.
+  ///
+  /// The records of up to \p NumThreads readers are decoded and evaluated
+  /// concurrently, where zero picks a default from the hardware. The result
+  /// does not depend on the number of threads.
   static Expected<std::unique_ptr<CoverageMapping>>
   load(ArrayRef<std::unique_ptr<CoverageMappingReader>> CoverageReaders,
-       IndexedInstrProfReader &ProfileReader);
+       IndexedInstrProfReader &ProfileReader, unsigned NumThreads = 1);
 
   /// Load the coverage mapping from the given object files and profile. If
   /// \p Arches is non-empty, it must specify an architecture for each object.
+  /// Up to \p NumThreads objects are read concurrently, see above.
   static Expected<std::unique_ptr<CoverageMapping>>
   load(ArrayRef<StringRef> ObjectFilenames, StringRef ProfileFilename,
-       ArrayRef<StringRef> Arches = None);
+       ArrayRef<StringRef> Arches = None, unsigned NumThreads = 1);
 
   /// The number of functions that couldn't have their profiles mapped.
   ///
@@ -571,8 +601,11 @@ public:
   /// Gets all of the functions in a particular file.
   iterator_range<FunctionRecordIterator>
   getCoveredFunctions(StringRef Filename) const {
-    return make_range(FunctionRecordIterator(Functions, Filename),
-                      FunctionRecordIterator());
+    return make_range(
+        FunctionRecordIterator(
+            Functions, getImpreciseRecordIndicesForFilename(Filename),
+            Filename),
+        FunctionRecordIterator());
   }
 
   /// Get the list of function instantiation groups in a particular file.
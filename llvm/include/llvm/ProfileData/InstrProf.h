@@ -157,6 +157,27 @@ inline StringRef getInstrProfRuntimeHookVarUseFuncName() {
   return "__llvm_profile_runtime_user";
 }
 
+/// Return the name of the variable holding the offset that counter updates
+/// are relocated by when the program is instrumented with runtime counter
+/// relocation. The runtime sets it when it maps the counters of a profile
+/// file.
+inline StringRef getInstrProfCounterBiasVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_BIAS_VAR);
+}
+
+/// Return the name of the thread-local variable that holds the offset of the
+/// current thread's counter shard when the program is instrumented with
+/// per-thread counter shards.
+inline StringRef getInstrProfCounterShardBiasVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARD_BIAS_VAR);
+}
+
+/// Return the name of the runtime function that allocates the counter shard
+/// of the calling thread and returns its offset from the counters.
+inline StringRef getInstrProfAcquireCounterShardFuncName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_ACQUIRE_COUNTER_SHARD_FUNC);
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
@@ -1095,7 +1116,8 @@ namespace RawInstrProf {
 // Version 4: ValueDataBegin and ValueDataSizes fields are removed from the
 // raw header.
 // Version 5: Bit 60 of FuncHash is reserved for the flag for the context
-// sensitive records.
+// sensitive records. The raw header has the padding around the counters,
+// which lets the counters be page-aligned in the file in continuous mode.
 const uint64_t Version = INSTR_PROF_RAW_VERSION;
 
 template <class IntPtrT> inline uint64_t getMagic();
@@ -421,6 +421,9 @@ class IndexedInstrProfReader : public InstrProfReader {
 private:
   /// The profile data file contents.
   std::unique_ptr<MemoryBuffer> DataBuffer;
+  /// The mapping of the profile file that DataBuffer refers to, if it is
+  /// shared with the other readers of the file in the process.
+  std::shared_ptr<MemoryBuffer> SharedDataBuffer;
   /// The profile remapping file contents.
   std::unique_ptr<MemoryBuffer> RemappingBuffer;
   /// The index into the profile data.
@@ -484,7 +487,9 @@ public:
     }
   }
 
-  /// Factory method to create an indexed reader.
+  /// Factory method to create an indexed reader. The readers of a file in
+  /// the process share one mapping of it, and decode its records only when
+  /// they are looked up.
   static Expected<std::unique_ptr<IndexedInstrProfReader>>
   create(const Twine &Path, const Twine &RemappingPath = "");
 
@@ -106,6 +106,10 @@ static inline StringRef getRepInFormat(StringRef Name,
 
 static inline uint64_t SPVersion() { return 103; }
 
+/// The version of the compact binary format, whose name and function offset
+/// tables are fixed-width so that readers can search them in place.
+static inline uint64_t SPCompactVersion() { return 104; }
+
 /// Represents the relative location of an instruction.
 ///
 /// Instruction locations are specified by the line offset from the
@@ -203,6 +203,37 @@
 //          in the text format documentation above).
 //        FUNCTION BODY
 //          A FUNCTION BODY entry describing the inlined function.
+//
+// Compact binary format
+// ---------------------
+//
+// Profiles of version SPVersion() in this format have ULEB128-encoded name
+// and function offset tables, the latter with name table indices instead of
+// MD5s, in no particular order. They are still read.
+//
+// This is the binary format with function names replaced by their MD5, and
+// with an index of the top-level functions, so that a ThinLTO backend only
+// decodes the profiles of the functions in its module. Its magic is computed
+// by SPMagic(SPF_Compact_Binary) and its version by SPCompactVersion(). It
+// differs from the binary format in the following sections:
+//
+// NAME TABLE
+//    SIZE (uint64_t)
+//        Number of entries in the name table.
+//    NAMES
+//        SIZE unencoded little-endian uint64_t MD5s of the function names.
+//
+// FUNCTION OFFSET TABLE OFFSET (unencoded uint64_t)
+//    Follows the name table. Offset of the function offset table from the
+//    start of the file, which is after the last function body.
+//
+// FUNCTION OFFSET TABLE
+//    SIZE (uint64_t)
+//        Number of top-level functions.
+//    ENTRIES
+//        SIZE pairs of unencoded little-endian uint64_t, the MD5 of the name
+//        of a function and the offset of its body from the start of the
+//        file, sorted by MD5.
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_PROFILEDATA_SAMPLEPROFREADER_H
@@ -218,9 +249,12 @@
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/GCOV.h"
 #include "llvm/ProfileData/SampleProf.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SymbolRemappingReader.h"
 #include <algorithm>
 #include <cstdint>
@@ -425,6 +459,7 @@ protected:
 private:
   std::error_code readSummaryEntry(std::vector<ProfileSummaryEntry> &Entries);
   virtual std::error_code verifySPMagic(uint64_t Magic) = 0;
+  virtual std::error_code verifySPVersion(uint64_t Version);
 
   /// Read profile summary.
   std::error_code readSummary();
@@ -455,16 +490,33 @@ public:
 
 class SampleProfileReaderCompactBinary : public SampleProfileReaderBinary {
 private:
-  /// Function name table.
-  std::vector<std::string> NameTable;
-  /// The table mapping from function name to the offset of its FunctionSample
-  /// towards file start.
-  DenseMap<StringRef, uint64_t> FuncOffsetTable;
+  /// An entry of the function offset table.
+  struct FuncOffsetEntry {
+    support::ulittle64_t GUID;
+    support::ulittle64_t Offset;
+  };
+  /// Function name table, the MD5s of the names.
+  ArrayRef<support::ulittle64_t> NameTable;
+  /// The names of the name table entries that were read so far.
+  DenseMap<uint32_t, StringRef> Names;
+  BumpPtrAllocator NameAllocator;
+  StringSaver NameSaver{NameAllocator};
+  /// The table mapping from the MD5 of a function name to the offset of its
+  /// FunctionSample towards file start, sorted by MD5.
+  ArrayRef<FuncOffsetEntry> FuncOffsetTable;
+  /// Whether the profile has the fixed-width tables of SPCompactVersion(),
+  /// rather than the ULEB128-encoded ones of SPVersion().
+  bool HasFixedWidthTables = true;
+  /// The tables of an SPVersion() profile, decoded for NameTable and
+  /// FuncOffsetTable to refer to.
+  std::vector<support::ulittle64_t> DecodedNameTable;
+  std::vector<FuncOffsetEntry> DecodedFuncOffsetTable;
   /// The set containing the functions to use when compiling a module.
   DenseSet<StringRef> FuncsToUse;
   /// Use all functions from the input profile.
   bool UseAllFuncs = true;
   virtual std::error_code verifySPMagic(uint64_t Magic) override;
+  virtual std::error_code verifySPVersion(uint64_t Version) override;
   virtual std::error_code readNameTable() override;
   /// Read a string indirectly via the name table.
   virtual ErrorOr<StringRef> readStringFromTable() override;
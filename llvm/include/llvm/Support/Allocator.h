@@ -22,6 +22,7 @@
 
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MathExtras.h"
@@ -37,6 +38,8 @@
 
 namespace llvm {
 
+class raw_ostream;
+
 /// CRTP base class providing obvious overloads for the core \c
 /// Allocate() methods of LLVM-style allocators.
 ///
@@ -119,8 +122,46 @@ namespace detail {
 void printBumpPtrAllocatorStats(unsigned NumSlabs, size_t BytesAllocated,
                                 size_t TotalMemory);
 
+// Returns a copy of Name that lives until the end of the program.
+const char *getAllocatorStatsName(StringRef Name);
+
+// Record that a named allocator allocated a slab of Size bytes from Site and
+// left Wasted bytes unused at the end of its previous slab.
+void recordAllocatorSlab(const char *Name, const void *Site, size_t Size,
+                         size_t Wasted);
+
+// Record that a named allocator freed a slab of Size bytes.
+void recordAllocatorSlabFree(const char *Name, size_t Size);
+
+// The minimum slab size of allocators that use huge pages.
+constexpr size_t HugePageSlabSize = 2 * 1024 * 1024;
+
+// Map Size bytes, a multiple of HugePageSlabSize, to be backed by huge pages
+// if the system supports them.
+LLVM_ATTRIBUTE_RETURNS_NONNULL void *allocateHugePageSlab(size_t Size);
+void deallocateHugePageSlab(void *Slab, size_t Size);
+
 } // end namespace detail
 
+/// Start recording slab allocations of named bump pointer allocators (see
+/// BumpPtrAllocatorImpl::setName) for printAllocatorStats(). This should be
+/// called before the allocators of interest allocate memory.
+void enableAllocatorStats();
+
+/// Print the peak and current memory usage of each named allocator, the
+/// bytes lost at the end of slabs, and the code addresses that allocated the
+/// most slabs. The addresses can be symbolized with llvm-symbolizer.
+void printAllocatorStats(raw_ostream &OS);
+
+// The code address that made a slab allocation, for printAllocatorStats().
+// This must be used in a function that is not inlined, or it gives the return
+// address of the function it was inlined into.
+#if defined(__GNUC__)
+#define LLVM_ALLOCATOR_STATS_SITE() __builtin_return_address(0)
+#else
+#define LLVM_ALLOCATOR_STATS_SITE() nullptr
+#endif
+
 /// Allocate memory in an ever growing pool, as if by bump-pointer.
 ///
 /// This isn't strictly a bump-pointer allocator as it uses backing slabs of
@@ -158,6 +199,7 @@ public:
       : CurPtr(Old.CurPtr), End(Old.End), Slabs(std::move(Old.Slabs)),
         CustomSizedSlabs(std::move(Old.CustomSizedSlabs)),
         BytesAllocated(Old.BytesAllocated), RedZoneSize(Old.RedZoneSize),
+        Name(Old.Name), HugePageSlabsBegin(Old.HugePageSlabsBegin),
         Allocator(std::move(Old.Allocator)) {
     Old.CurPtr = Old.End = nullptr;
     Old.BytesAllocated = 0;
@@ -178,6 +220,8 @@ public:
     End = RHS.End;
     BytesAllocated = RHS.BytesAllocated;
     RedZoneSize = RHS.RedZoneSize;
+    Name = RHS.Name;
+    HugePageSlabsBegin = RHS.HugePageSlabsBegin;
     Slabs = std::move(RHS.Slabs);
     CustomSizedSlabs = std::move(RHS.CustomSizedSlabs);
     Allocator = std::move(RHS.Allocator);
@@ -202,7 +246,7 @@ public:
     // Reset the state.
     BytesAllocated = 0;
     CurPtr = (char *)Slabs.front();
-    End = CurPtr + SlabSize;
+    End = CurPtr + computeSlabSize(0);
 
     __asan_poison_memory_region(*Slabs.begin(), computeSlabSize(0));
     DeallocateSlabs(std::next(Slabs.begin()), Slabs.end());
@@ -239,9 +283,27 @@ public:
       return AlignedPtr;
     }
 
+    void *Ptr = AllocateSlow(Size, SizeToAllocate, Alignment);
+#if defined(__GNUC__)
+    // Keep the call out of tail position. A tail call would return to the
+    // caller of the function that Allocate() was inlined into, and the site
+    // that AllocateSlow() records would be that caller.
+    __asm__ volatile("" : "+r"(Ptr));
+#endif
+    return Ptr;
+  }
+
+  // The slow path of Allocate(), which gets a new slab. It is kept out of line
+  // so that the return address it records for printAllocatorStats() is in the
+  // function that Allocate() was inlined into, the allocation site.
+  LLVM_ATTRIBUTE_NOINLINE LLVM_ATTRIBUTE_RETURNS_NONNULL void *
+  AllocateSlow(size_t Size, size_t SizeToAllocate, size_t Alignment) {
     // If Size is really big, allocate a separate slab for it.
     size_t PaddedSize = SizeToAllocate + Alignment - 1;
     if (PaddedSize > SizeThreshold) {
+      if (LLVM_UNLIKELY(Name))
+        detail::recordAllocatorSlab(Name, LLVM_ALLOCATOR_STATS_SITE(),
+                                    PaddedSize, 0);
       void *NewSlab = Allocator.Allocate(PaddedSize, 0);
       // We own the new slab and don't want anyone reading anyting other than
       // pieces returned from this method.  So poison the whole slab.
@@ -257,6 +319,10 @@ public:
     }
 
     // Otherwise, start a new slab and try again.
+    if (LLVM_UNLIKELY(Name))
+      detail::recordAllocatorSlab(Name, LLVM_ALLOCATOR_STATS_SITE(),
+                                  computeSlabSize(Slabs.size()),
+                                  size_t(End - CurPtr));
     StartNewSlab();
     uintptr_t AlignedAddr = alignAddr(CurPtr, Alignment);
     assert(AlignedAddr + SizeToAllocate <= (uintptr_t)End &&
@@ -357,6 +423,22 @@ public:
                                        getTotalMemory());
   }
 
+  /// Name this allocator in the output of printAllocatorStats(). Unnamed
+  /// allocators are not tracked. Tracking happens only when slabs are
+  /// allocated or freed, so it does not slow down most allocations.
+  void setName(StringRef NewName) {
+    Name = detail::getAllocatorStatsName(NewName);
+  }
+
+  /// Allocate all future slabs, which are at least 2 MiB, directly from the
+  /// operating system and ask for them to be backed by huge pages. This
+  /// reduces TLB misses for large, long-lived arenas at the cost of up to
+  /// 2 MiB of unused memory. Objects larger than the slab size still get
+  /// their own allocation from the underlying allocator.
+  void enableHugePages() {
+    HugePageSlabsBegin = std::min<size_t>(HugePageSlabsBegin, Slabs.size());
+  }
+
 private:
   /// The current pointer into the current slab.
   ///
@@ -381,15 +463,25 @@ private:
   /// a sanitizer.
   size_t RedZoneSize = 1;
 
+  /// The name of this allocator for printAllocatorStats(), or null.
+  const char *Name = nullptr;
+
+  /// The index of the first slab allocated with huge pages. Slabs before it
+  /// are allocated with Allocator.
+  size_t HugePageSlabsBegin = SIZE_MAX;
+
   /// The allocator instance we use to get slabs of memory.
   AllocatorT Allocator;
 
-  static size_t computeSlabSize(unsigned SlabIdx) {
+  size_t computeSlabSize(unsigned SlabIdx) const {
     // Scale the actual allocated slab size based on the number of slabs
     // allocated. Every 128 slabs allocated, we double the allocated size to
     // reduce allocation frequency, but saturate at multiplying the slab size by
     // 2^30.
-    return SlabSize * ((size_t)1 << std::min<size_t>(30, SlabIdx / 128));
+    size_t Size = SlabSize * ((size_t)1 << std::min<size_t>(30, SlabIdx / 128));
+    if (SlabIdx >= HugePageSlabsBegin)
+      return alignTo(Size, detail::HugePageSlabSize);
+    return Size;
   }
 
   /// Allocate a new slab and move the bump pointers over into the new
@@ -397,7 +489,9 @@ private:
   void StartNewSlab() {
     size_t AllocatedSlabSize = computeSlabSize(Slabs.size());
 
-    void *NewSlab = Allocator.Allocate(AllocatedSlabSize, 0);
+    void *NewSlab = Slabs.size() >= HugePageSlabsBegin
+                        ? detail::allocateHugePageSlab(AllocatedSlabSize)
+                        : Allocator.Allocate(AllocatedSlabSize, 0);
     // We own the new slab and don't want anyone reading anything other than
     // pieces returned from this method.  So poison the whole slab.
     __asan_poison_memory_region(NewSlab, AllocatedSlabSize);
@@ -411,9 +505,14 @@ private:
   void DeallocateSlabs(SmallVectorImpl<void *>::iterator I,
                        SmallVectorImpl<void *>::iterator E) {
     for (; I != E; ++I) {
-      size_t AllocatedSlabSize =
-          computeSlabSize(std::distance(Slabs.begin(), I));
-      Allocator.Deallocate(*I, AllocatedSlabSize);
+      size_t Idx = std::distance(Slabs.begin(), I);
+      size_t AllocatedSlabSize = computeSlabSize(Idx);
+      if (LLVM_UNLIKELY(Name))
+        detail::recordAllocatorSlabFree(Name, AllocatedSlabSize);
+      if (Idx >= HugePageSlabsBegin)
+        detail::deallocateHugePageSlab(*I, AllocatedSlabSize);
+      else
+        Allocator.Deallocate(*I, AllocatedSlabSize);
     }
   }
 
@@ -422,6 +521,8 @@ private:
     for (auto &PtrAndSize : CustomSizedSlabs) {
       void *Ptr = PtrAndSize.first;
       size_t Size = PtrAndSize.second;
+      if (LLVM_UNLIKELY(Name))
+        detail::recordAllocatorSlabFree(Name, Size);
       Allocator.Deallocate(Ptr, Size);
     }
   }
@@ -468,7 +569,7 @@ public:
 
     for (auto I = Allocator.Slabs.begin(), E = Allocator.Slabs.end(); I != E;
          ++I) {
-      size_t AllocatedSlabSize = BumpPtrAllocator::computeSlabSize(
+      size_t AllocatedSlabSize = Allocator.computeSlabSize(
           std::distance(Allocator.Slabs.begin(), I));
       char *Begin = (char *)alignAddr(*I, alignof(T));
       char *End = *I == Allocator.Slabs.back() ? Allocator.CurPtr
@@ -488,6 +589,13 @@ public:
 
   /// Allocate space for an array of objects without constructing them.
   T *Allocate(size_t num = 1) { return Allocator.Allocate<T>(num); }
+
+  /// Name this allocator in the output of printAllocatorStats().
+  void setName(StringRef Name) { Allocator.setName(Name); }
+
+  /// Back future slabs with huge pages. See
+  /// BumpPtrAllocatorImpl::enableHugePages().
+  void enableHugePages() { Allocator.enableHugePages(); }
 };
 
 } // end namespace llvm
@@ -41,6 +41,22 @@ Error uncompress(StringRef InputBuffer,
 
 uint32_t crc32(StringRef Buffer);
 
+/// Compresses \p InputBuffer into a raw deflate stream, which has neither the
+/// zlib header nor the trailing checksum. Unless \p IsLast is true, the stream
+/// ends with a sync flush instead of a final block, so that the results of
+/// compressing consecutive pieces of data can be concatenated into a single
+/// deflate stream. This allows compressing pieces of a buffer in parallel.
+Error compressRaw(StringRef InputBuffer,
+                  SmallVectorImpl<char> &CompressedBuffer, int Level,
+                  bool IsLast);
+
+/// Returns the Adler-32 checksum of \p Buffer, as stored in zlib streams.
+uint32_t adler32(StringRef Buffer);
+
+/// Returns the Adler-32 checksum of the concatenation of two buffers, given
+/// their checksums and the length of the second buffer.
+uint32_t adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Len2);
+
 }  // End of namespace zlib
 
 } // End of namespace llvm
@@ -77,7 +77,12 @@ public:
   operator LockFileState() const { return getState(); }
 
   /// For a shared lock, wait until the owner releases the lock.
-  WaitForUnlockResult waitForUnlock();
+  ///
+  /// The lock file is checked at increasing intervals, which are capped so
+  /// that the waiter notices promptly that a long-held lock was released.
+  ///
+  /// \param MaxSeconds the maximum total wait time in seconds.
+  WaitForUnlockResult waitForUnlock(const unsigned MaxSeconds = 90);
 
   /// Remove the lock file.  This may delete a different lock file than
   /// the one previously read if there is a race.
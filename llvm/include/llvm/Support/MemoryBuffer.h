@@ -22,11 +22,15 @@
 #include "llvm/Support/FileSystem.h"
 #include <cstddef>
 #include <cstdint>
+#include <future>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace llvm {
 
 class MemoryBufferRef;
+class ThreadPool;
 
 /// This interface provides simple read-only access to a block of memory, and
 /// provides simple methods for reading files and standard input into a memory
@@ -80,6 +84,16 @@ public:
   getFile(const Twine &Filename, int64_t FileSize = -1,
           bool RequiresNullTerminator = true, bool IsVolatile = false);
 
+  /// Start opening the specified files on \p Pool and return a future for
+  /// each of them, in the same order. A future becomes ready once its file has
+  /// been opened with getFile() and all of its contents have been read into
+  /// memory, so the latency of opening and reading many files overlaps even
+  /// if the files are mapped rather than read. If threads are disabled, the
+  /// files are read before this returns.
+  static std::vector<std::future<ErrorOr<std::unique_ptr<MemoryBuffer>>>>
+  getFilesAsync(ThreadPool &Pool, ArrayRef<std::string> Filenames,
+                bool RequiresNullTerminator = true, bool IsVolatile = false);
+
   /// Read all of the specified file into a MemoryBuffer as a stream
   /// (i.e. until EOF reached). This is useful for special files that
   /// look like a regular file but have 0 size (e.g. /proc/cpuinfo on Linux).
@@ -17,6 +17,7 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 #if defined(_MSC_VER) && LLVM_ENABLE_THREADS
 #pragma warning(push)
@@ -65,6 +66,11 @@ public:
       Cond.notify_all();
   }
 
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
+
   void sync() const {
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
@@ -81,9 +87,14 @@ public:
 
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  /// Waits for all spawned tasks to finish. While waiting, the calling thread
+  /// runs queued tasks, so nested task groups don't deadlock or leave
+  /// threads idle.
+  void sync() const;
 };
 
+const ptrdiff_t MinParallelSize = 1024;
+
 #if defined(_MSC_VER)
 template <class RandomAccessIterator, class Comparator>
 void parallel_sort(RandomAccessIterator Start, RandomAccessIterator End,
@@ -101,8 +112,6 @@ void parallel_for_each_n(IndexTy Begin, IndexTy End, FuncTy Fn) {
 }
 
 #else
-const ptrdiff_t MinParallelSize = 1024;
-
 /// Inclusive median.
 template <class RandomAccessIterator, class Comparator>
 RandomAccessIterator medianOf3(RandomAccessIterator Start,
@@ -188,6 +197,129 @@ void parallel_for_each_n(IndexTy Begin, IndexTy End, FuncTy Fn) {
 
 #endif
 
+/// Returns the number of elements each task processes when [0, N) is split
+/// into at most 1024 tasks of at least GrainSize elements.
+inline size_t getChunkSize(size_t N, size_t GrainSize) {
+  return std::max<size_t>(std::max<size_t>((N + 1023) / 1024, 1), GrainSize);
+}
+
+template <class IterTy, class FuncTy>
+void parallel_for_each_chunk(IterTy Begin, IterTy End, size_t GrainSize,
+                             FuncTy Fn) {
+  ptrdiff_t ChunkSize = getChunkSize(std::distance(Begin, End), GrainSize);
+  TaskGroup TG;
+  while (ChunkSize < std::distance(Begin, End)) {
+    TG.spawn([=, &Fn] { Fn(Begin, Begin + ChunkSize); });
+    Begin += ChunkSize;
+  }
+  if (Begin != End)
+    Fn(Begin, End);
+}
+
+template <class RandomAccessIterator, class Comparator>
+void parallel_stable_sort(RandomAccessIterator Start, RandomAccessIterator End,
+                          const Comparator &Comp) {
+  ptrdiff_t N = std::distance(Start, End);
+  if (N < 2 * MinParallelSize) {
+    std::stable_sort(Start, End, Comp);
+    return;
+  }
+
+  // Sort runs independently, then merge adjacent runs pairwise until a
+  // single run is left. Merging only adjacent runs keeps the sort stable.
+  ptrdiff_t RunSize = getChunkSize(N, MinParallelSize);
+  parallel_for_each_chunk(Start, End, RunSize,
+                          [&](RandomAccessIterator B, RandomAccessIterator E) {
+                            std::stable_sort(B, E, Comp);
+                          });
+
+  for (; RunSize < N; RunSize *= 2) {
+    TaskGroup TG;
+    for (ptrdiff_t I = 0; I + RunSize < N; I += 2 * RunSize) {
+      RandomAccessIterator B = Start + I;
+      RandomAccessIterator M = B + RunSize;
+      RandomAccessIterator E = Start + std::min(I + 2 * RunSize, N);
+      TG.spawn([=, &Comp] { std::inplace_merge(B, M, E, Comp); });
+    }
+  }
+}
+
+template <class IterTy, class ResultTy, class ReduceFuncTy,
+          class TransformFuncTy>
+ResultTy parallel_transform_reduce(IterTy Begin, IterTy End, ResultTy Init,
+                                   ReduceFuncTy Reduce,
+                                   TransformFuncTy Transform) {
+  size_t N = std::distance(Begin, End);
+  if (N == 0)
+    return Init;
+
+  // Each task reduces one chunk starting from Init, and the partial results
+  // are combined in order, so Reduce doesn't have to be commutative.
+  size_t ChunkSize = getChunkSize(N, 1);
+  std::vector<ResultTy> Results((N + ChunkSize - 1) / ChunkSize, Init);
+  {
+    TaskGroup TG;
+    for (size_t I = 0; I != Results.size(); ++I) {
+      IterTy B = Begin + I * ChunkSize;
+      IterTy E = Begin + std::min(N, (I + 1) * ChunkSize);
+      TG.spawn([=, &Reduce, &Transform, &Results] {
+        ResultTy R = Init;
+        for (IterTy It = B; It != E; ++It)
+          R = Reduce(std::move(R), Transform(*It));
+        Results[I] = std::move(R);
+      });
+    }
+  }
+
+  ResultTy Result = std::move(Results[0]);
+  for (size_t I = 1; I != Results.size(); ++I)
+    Result = Reduce(std::move(Result), std::move(Results[I]));
+  return Result;
+}
+
+template <class InIterTy, class OutIterTy, class ValueTy, class BinaryOpTy>
+OutIterTy parallel_exclusive_scan(InIterTy Begin, InIterTy End, OutIterTy Out,
+                                  ValueTy Init, BinaryOpTy Op) {
+  size_t N = std::distance(Begin, End);
+  if (N == 0)
+    return Out;
+
+  // The first pass computes the sum of each chunk, and the second pass
+  // writes the prefix sums of each chunk starting from the sum of all
+  // chunks before it. Out may be the same as Begin.
+  size_t ChunkSize = getChunkSize(N, MinParallelSize);
+  size_t NumChunks = (N + ChunkSize - 1) / ChunkSize;
+  std::vector<ValueTy> Sums(NumChunks, Init);
+  parallel_for_each_n(size_t(0), NumChunks, [&](size_t I) {
+    InIterTy It = Begin + I * ChunkSize;
+    InIterTy E = Begin + std::min(N, (I + 1) * ChunkSize);
+    ValueTy Sum = *It;
+    for (++It; It != E; ++It)
+      Sum = Op(std::move(Sum), *It);
+    Sums[I] = std::move(Sum);
+  });
+
+  ValueTy Acc = std::move(Init);
+  for (ValueTy &Sum : Sums) {
+    ValueTy Next = Op(Acc, std::move(Sum));
+    Sum = std::move(Acc);
+    Acc = std::move(Next);
+  }
+
+  parallel_for_each_n(size_t(0), NumChunks, [&](size_t I) {
+    InIterTy It = Begin + I * ChunkSize;
+    InIterTy E = Begin + std::min(N, (I + 1) * ChunkSize);
+    OutIterTy O = Out + I * ChunkSize;
+    ValueTy Sum = std::move(Sums[I]);
+    for (; It != E; ++It, ++O) {
+      ValueTy V = *It;
+      *O = Sum;
+      Sum = Op(std::move(Sum), std::move(V));
+    }
+  });
+  return Out + N;
+}
+
 #endif
 
 template <typename Iter>
@@ -221,6 +353,64 @@ void for_each_n(Policy policy, IndexTy Begin, IndexTy End, FuncTy Fn) {
     Fn(I);
 }
 
+template <class Policy, class RandomAccessIterator,
+          class Comparator = detail::DefComparator<RandomAccessIterator>>
+void stable_sort(Policy policy, RandomAccessIterator Start,
+                 RandomAccessIterator End,
+                 const Comparator &Comp = Comparator()) {
+  static_assert(is_execution_policy<Policy>::value,
+                "Invalid execution policy!");
+  std::stable_sort(Start, End, Comp);
+}
+
+/// Calls Fn(ChunkBegin, ChunkEnd) for consecutive chunks of [Begin, End).
+/// The parallel version splits the range into chunks of the same size, which
+/// is at least GrainSize and large enough for at most 1024 chunks, except for
+/// the last chunk, which holds the remaining elements and may be smaller than
+/// GrainSize. The sequential version calls Fn once for the whole range. Fn is
+/// not called for an empty range.
+template <class Policy, class IterTy, class FuncTy>
+void for_each_chunk(Policy policy, IterTy Begin, IterTy End, size_t GrainSize,
+                    FuncTy Fn) {
+  static_assert(is_execution_policy<Policy>::value,
+                "Invalid execution policy!");
+  if (Begin != End)
+    Fn(Begin, End);
+}
+
+/// Returns Reduce(...Reduce(Reduce(Init, Transform(E0)), Transform(E1))...).
+/// Reduce must be associative and Init must be its identity, because the
+/// parallel version starts every chunk from Init.
+template <class Policy, class IterTy, class ResultTy, class ReduceFuncTy,
+          class TransformFuncTy>
+ResultTy transform_reduce(Policy policy, IterTy Begin, IterTy End,
+                          ResultTy Init, ReduceFuncTy Reduce,
+                          TransformFuncTy Transform) {
+  static_assert(is_execution_policy<Policy>::value,
+                "Invalid execution policy!");
+  for (IterTy It = Begin; It != End; ++It)
+    Init = Reduce(std::move(Init), Transform(*It));
+  return Init;
+}
+
+/// Writes Init, Op(Init, E0), Op(Op(Init, E0), E1), ... to Out, one value
+/// for each input, like std::exclusive_scan. Op must be associative. Out may
+/// be the same as Begin.
+template <class Policy, class InIterTy, class OutIterTy, class ValueTy,
+          class BinaryOpTy = std::plus<ValueTy>>
+OutIterTy exclusive_scan(Policy policy, InIterTy Begin, InIterTy End,
+                         OutIterTy Out, ValueTy Init,
+                         BinaryOpTy Op = BinaryOpTy()) {
+  static_assert(is_execution_policy<Policy>::value,
+                "Invalid execution policy!");
+  for (; Begin != End; ++Begin, ++Out) {
+    ValueTy V = *Begin;
+    *Out = Init;
+    Init = Op(std::move(Init), std::move(V));
+  }
+  return Out;
+}
+
 // Parallel algorithm implementations, only available when LLVM_ENABLE_THREADS
 // is true.
 #if LLVM_ENABLE_THREADS
@@ -242,6 +432,37 @@ void for_each_n(parallel_execution_policy policy, IndexTy Begin, IndexTy End,
                 FuncTy Fn) {
   detail::parallel_for_each_n(Begin, End, Fn);
 }
+
+template <class RandomAccessIterator,
+          class Comparator = detail::DefComparator<RandomAccessIterator>>
+void stable_sort(parallel_execution_policy policy, RandomAccessIterator Start,
+                 RandomAccessIterator End,
+                 const Comparator &Comp = Comparator()) {
+  detail::parallel_stable_sort(Start, End, Comp);
+}
+
+template <class IterTy, class FuncTy>
+void for_each_chunk(parallel_execution_policy policy, IterTy Begin,
+                    IterTy End, size_t GrainSize, FuncTy Fn) {
+  detail::parallel_for_each_chunk(Begin, End, GrainSize, Fn);
+}
+
+template <class IterTy, class ResultTy, class ReduceFuncTy,
+          class TransformFuncTy>
+ResultTy transform_reduce(parallel_execution_policy policy, IterTy Begin,
+                          IterTy End, ResultTy Init, ReduceFuncTy Reduce,
+                          TransformFuncTy Transform) {
+  return detail::parallel_transform_reduce(Begin, End, std::move(Init),
+                                           Reduce, Transform);
+}
+
+template <class InIterTy, class OutIterTy, class ValueTy,
+          class BinaryOpTy = std::plus<ValueTy>>
+OutIterTy exclusive_scan(parallel_execution_policy policy, InIterTy Begin,
+                         InIterTy End, OutIterTy Out, ValueTy Init,
+                         BinaryOpTy Op = BinaryOpTy()) {
+  return detail::parallel_exclusive_scan(Begin, End, Out, std::move(Init), Op);
+}
 #endif
 
 } // namespace parallel
@@ -9,10 +9,13 @@
 #ifndef LLVM_SUPPORT_STRINGSAVER_H
 #define LLVM_SUPPORT_STRINGSAVER_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Allocator.h"
+#include <memory>
+#include <mutex>
 
 namespace llvm {
 
@@ -53,5 +56,38 @@ public:
   StringRef save(const std::string &S) { return save(StringRef(S)); }
 };
 
+/// A thread-safe UniqueStringSaver. Saving the same string yields the same
+/// StringRef, regardless of the thread that saves it.
+///
+/// Strings are distributed to shards by hash. Each shard has its own lock,
+/// allocator and set of saved strings, so threads saving different strings
+/// rarely wait for each other.
+class ConcurrentUniqueStringSaver final {
+  struct Shard {
+    std::mutex Mutex;
+    BumpPtrAllocator Alloc;
+    UniqueStringSaver Saver{Alloc};
+  };
+
+  unsigned NumShards;
+  std::unique_ptr<Shard[]> Shards;
+
+  unsigned getShardIndex(StringRef S) const;
+
+public:
+  explicit ConcurrentUniqueStringSaver(unsigned NumShards = 64);
+
+  // All returned strings are null-terminated: *save(S).end() == 0.
+  StringRef save(const char *S) { return save(StringRef(S)); }
+  StringRef save(StringRef S);
+  StringRef save(const Twine &S) { return save(StringRef(S.str())); }
+  StringRef save(const std::string &S) { return save(StringRef(S)); }
+
+  /// Saves each string in Strings and replaces it with the saved copy. This
+  /// takes each shard's lock once rather than once per string, so it is
+  /// faster than calling save() for each string.
+  void save(MutableArrayRef<StringRef> Strings);
+};
+
 }
 #endif
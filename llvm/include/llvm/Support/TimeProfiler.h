@@ -18,8 +18,18 @@ extern TimeTraceProfiler *TimeTraceProfilerInstance;
 
 /// Initialize the time trace profiler.
 /// This sets up the global \p TimeTraceProfilerInstance
-/// variable to be the profiler instance.
-void timeTraceProfilerInitialize(unsigned TimeTraceGranularity);
+/// variable to be the profiler instance. \p ProcName is the process name
+/// shown in the trace. Only sections begun and ended on the thread that
+/// initialized the profiler are recorded.
+void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
+                                 StringRef ProcName);
+
+/// Initialize the time trace profiler in summary mode. Instead of recording
+/// every section, the profiler keeps the count, the total and a histogram of
+/// the durations of each section name, which is cheap enough to leave on in
+/// production builds. Section details are never computed. Sections on all
+/// threads are recorded, in per-thread buffers.
+void timeTraceProfilerInitializeSummary(StringRef ProcName);
 
 /// Cleanup the time trace profiler, if it was initialized.
 void timeTraceProfilerCleanup();
@@ -32,6 +42,10 @@ inline bool timeTraceProfilerEnabled() {
 /// Write profiling data to output file.
 /// Data produced is JSON, in Chrome "Trace Event" format, see
 /// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
+/// In summary mode, the JSON object instead has a "scopes" array with the
+/// count, total, median, 99th percentile and maximum duration in
+/// microseconds of each section name, sorted from the longest total. The
+/// percentiles are rounded up to a power of two.
 void timeTraceProfilerWrite(raw_pwrite_stream &OS);
 
 /// Manually begin a time section, with the given \p Name and \p Detail.
@@ -404,6 +404,66 @@ private:
   virtual void anchor();
 };
 
+/// A thread-safe cache of file statuses, directory listings and the contents
+/// of small files, shared by one or more CachingFileSystem instances.
+///
+/// Entries are keyed by absolute path and never expire on their own. Clients
+/// that expect the underlying files to change must call invalidate(), for
+/// example from the events of a clang::DirectoryWatcher. The cache is split
+/// into shards with a lock each, so threads looking up different paths rarely
+/// contend.
+class CachingFileSystemCache
+    : public llvm::ThreadSafeRefCountedBase<CachingFileSystemCache> {
+public:
+  /// \param MaxFileSize The largest file whose contents are cached.
+  explicit CachingFileSystemCache(uint64_t MaxFileSize = 64 * 1024);
+  ~CachingFileSystemCache();
+
+  /// Forget everything about the absolute path \p Path and the listing of
+  /// its parent directory. Call this when a file is added, removed or
+  /// modified.
+  void invalidate(StringRef Path);
+
+  /// Forget everything.
+  void invalidateAll();
+
+private:
+  friend class CachingFileSystem;
+  struct Entry;
+  struct Shard;
+
+  /// Calls \p F with the entry for \p Path while holding its shard's lock.
+  void withEntry(StringRef Path, llvm::function_ref<void(Entry &)> F);
+
+  std::unique_ptr<Shard[]> Shards;
+  uint64_t MaxFileSize;
+};
+
+/// A file system that answers status(), dir_begin() and openFileForRead()
+/// from a CachingFileSystemCache when possible, and fills the cache from the
+/// underlying file system otherwise. Failed lookups are cached too, which
+/// makes repeated header searches cheap.
+///
+/// Like other file systems, an instance has its own working directory and
+/// should only be used by one thread at a time. Instances on different
+/// threads can share one cache, as long as their underlying file systems see
+/// the same files.
+class CachingFileSystem : public ProxyFileSystem {
+public:
+  CachingFileSystem(IntrusiveRefCntPtr<FileSystem> FS,
+                    IntrusiveRefCntPtr<CachingFileSystemCache> Cache);
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+  llvm::ErrorOr<std::unique_ptr<File>>
+  openFileForRead(const Twine &Path) override;
+  directory_iterator dir_begin(const Twine &Dir, std::error_code &EC) override;
+
+  CachingFileSystemCache &getCache() { return *Cache; }
+
+private:
+  IntrusiveRefCntPtr<CachingFileSystemCache> Cache;
+};
+
 namespace detail {
 
 class InMemoryDirectory;
@@ -44,6 +44,14 @@
 namespace llvm {
 uint64_t xxHash64(llvm::StringRef Data);
 uint64_t xxHash64(llvm::ArrayRef<uint8_t> Data);
+
+/// XXH3_64bits with the default seed and secret. It gives different results
+/// than xxHash64, and it is faster, especially for short inputs and on
+/// targets where its inner loop is vectorized.
+uint64_t xxh3_64bits(llvm::ArrayRef<uint8_t> Data);
+inline uint64_t xxh3_64bits(llvm::StringRef Data) {
+  return xxh3_64bits(llvm::makeArrayRef(Data.bytes_begin(), Data.size()));
+}
 }
 
 #endif
@@ -13,6 +13,9 @@
 #ifndef LLVM_TABLEGEN_MAIN_H
 #define LLVM_TABLEGEN_MAIN_H
 
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+
 namespace llvm {
 
 class raw_ostream;
@@ -22,7 +25,28 @@ class RecordKeeper;
 /// Returns true on error, false otherwise.
 using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
-int TableGenMain(char *argv0, TableGenMainFn *MainFn);
+/// Select the action that the next call to the TableGenMainFn performs, by
+/// the name of its option without the leading dash. This is used for
+/// -extra-output. Returns true on error, false otherwise.
+using TableGenSelectActionFn = bool (StringRef Name);
+
+int TableGenMain(char *argv0, TableGenMainFn *MainFn,
+                 TableGenSelectActionFn *SelectActionFn = nullptr);
+
+/// Set \p Action to the value of its option named \p Name, as if that option
+/// had been given on the command line. A tool whose actions are the values of
+/// \p Action can implement its TableGenSelectActionFn with this.
+template <typename ActionT>
+bool selectTableGenAction(cl::opt<ActionT> &Action, StringRef Name) {
+  auto &Parser = Action.getParser();
+  if (Parser.findOption(Name) == Parser.getNumOptions())
+    return true;
+  ActionT Value;
+  if (Parser.parse(Action, Name, Name, Value))
+    return true;
+  Action.setValue(Value);
+  return false;
+}
 
 } // end namespace llvm
 
@@ -601,17 +601,14 @@ struct Attributor {
         AAMap.lookup(const_cast<IRPosition &>(IRP));
     if (AAType *AA = static_cast<AAType *>(
             KindToAbstractAttributeMap.lookup(&AAType::ID))) {
-      // Do not registr a dependence on an attribute with an invalid state.
-      if (AA->getState().isValidState())
-        QueryMap[AA].insert(const_cast<AbstractAttribute *>(&QueryingAA));
+      recordDependence(*AA, QueryingAA);
       return *AA;
     }
 
     // No matching attribute found, create one.
     auto &AA = AAType::createForPosition(IRP, *this);
     registerAA(AA);
-    if (AA.getState().isValidState())
-      QueryMap[&AA].insert(const_cast<AbstractAttribute *>(&QueryingAA));
+    recordDependence(AA, QueryingAA);
     return AA;
   }
 
@@ -731,8 +728,16 @@ private:
   DenseMap<IRPosition, KindToAbstractAttributeMap> AAMap;
   ///}
 
+  /// Record that \p QueryingAA queried \p AA and needs to be updated again if
+  /// \p AA changes. No dependence is recorded on an attribute with an invalid
+  /// state or at a fixpoint, as it cannot change anymore.
+  void recordDependence(const AbstractAttribute &AA,
+                        const AbstractAttribute &QueryingAA);
+
   /// A map from abstract attributes to the ones that queried them through calls
-  /// to the getAAFor<...>(...) method.
+  /// to the getAAFor<...>(...) method. The entry of an attribute is cleared
+  /// when it changes, the attributes in it are updated and record their
+  /// dependences again.
   ///{
   using QueryMapTy =
       DenseMap<AbstractAttribute *, SetVector<AbstractAttribute *>>;
@@ -56,6 +56,7 @@ private:
     }
   };
   DenseMap<GlobalVariable *, PerFunctionProfileData> ProfileDataMap;
+  DenseMap<const Function *, Value *> FunctionToProfileBiasMap;
   std::vector<GlobalValue *> UsedVars;
   std::vector<GlobalVariable *> ReferencedNames;
   GlobalVariable *NamesVar;
@@ -90,6 +91,16 @@ private:
   /// Replace instrprof_value_profile with a call to runtime library.
   void lowerValueProfileInst(InstrProfValueProfileInst *Ins);
 
+  /// Compute the address of the counter value that this profiling instruction
+  /// acts on, adding the runtime counter bias if counters are relocated or
+  /// sharded.
+  Value *getCounterAddress(InstrProfIncrementInst *I);
+
+  /// With per-thread counter shards, compute the offset of the counter shard
+  /// of the current thread at the start of \p F, acquiring the shard on the
+  /// thread's first call into instrumented code.
+  void emitCounterShardBias(Function *F);
+
   /// Replace instrprof_increment with an increment of the appropriate value.
   void lowerIncrement(InstrProfIncrementInst *Inc);
 
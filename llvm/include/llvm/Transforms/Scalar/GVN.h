@@ -188,6 +188,10 @@ private:
   // of BlockRPONumber prior to accessing the contents of BlockRPONumber.
   bool InvalidBlockRPONumbers = true;
 
+  // Number of non-local dependences found for loads in the function being
+  // analyzed, which is bounded by -gvn-max-nonlocal-load-deps.
+  uint64_t NumNonLocalLoadDeps = 0;
+
   using LoadDepVect = SmallVector<NonLocalDepResult, 64>;
   using AvailValInBlkVect = SmallVector<gvn::AvailableValueInBlock, 64>;
   using UnavailBlkVect = SmallVector<BasicBlock *, 64>;
@@ -152,7 +152,14 @@ struct LoopVectorizePass : public PassInfoMixin<LoopVectorizePass> {
                std::function<const LoopAccessInfo &(Loop &)> &GetLAA_,
                OptimizationRemarkEmitter &ORE_, ProfileSummaryInfo *PSI_);
 
-  bool processLoop(Loop *L);
+  /// Vectorize \p L if legal and profitable. A non-zero \p EpilogueMaxVF
+  /// means \p L is the scalar remainder of a loop vectorized earlier, to be
+  /// vectorized again with a VF of at most \p EpilogueMaxVF.
+  bool processLoop(Loop *L, unsigned EpilogueMaxVF = 0);
+
+  /// Set by processLoop when the scalar remainder of the loop it vectorized
+  /// is worth vectorizing again; the maximum VF to use for it.
+  unsigned NextEpilogueMaxVF = 0;
 };
 
 /// Reports a vectorization failure: print \p DebugMsg for debugging
@@ -35,13 +35,20 @@ class FileBasedRecordProducer : public RecordProducer {
   Expected<std::unique_ptr<Record>> findNextBufferExtent();
 
 public:
+  /// |BufferBytes| is the number of bytes left in the buffer at |OP|, as
+  /// returned by currentBufferBytes(), to resume reading in the middle of a
+  /// log.
   FileBasedRecordProducer(const XRayFileHeader &FH, DataExtractor &DE,
-                          uint64_t &OP)
-      : Header(FH), E(DE), OffsetPtr(OP) {}
+                          uint64_t &OP, uint32_t BufferBytes = 0)
+      : Header(FH), E(DE), OffsetPtr(OP), CurrentBufferBytes(BufferBytes) {}
 
   /// This producer encapsulates the logic for loading a File-backed
   /// RecordProducer hidden behind a DataExtractor.
   Expected<std::unique_ptr<Record>> produce() override;
+
+  /// The number of bytes left in the current buffer, in FDR logs version 3 and
+  /// later.
+  uint32_t currentBufferBytes() const { return CurrentBufferBytes; }
 };
 
 } // namespace xray
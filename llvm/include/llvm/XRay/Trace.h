@@ -15,6 +15,8 @@
 #include <cstdint>
 #include <vector>
 
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
@@ -74,6 +76,25 @@ Expected<Trace> loadTraceFile(StringRef Filename, bool Sort = false);
 /// DataExtractor.
 Expected<Trace> loadTrace(const DataExtractor &Extractor, bool Sort = false);
 
+/// The callback of loadTraceFileByThread, which gets the trace file header and
+/// a chunk of the records.
+using TraceChunkCallback =
+    function_ref<Error(const XRayFileHeader &, ArrayRef<XRayRecord>)>;
+
+/// This function will load the XRay trace records from the provided
+/// |Filename| a piece at a time, for traces too large to be expanded in memory
+/// all at once.
+///
+/// For FDR mode traces, |Callback| is called once for each process+thread
+/// pair with the records of that thread. Threads are expanded in parallel, a
+/// few at a time, but |Callback| is called from one thread at a time and in an
+/// order that only depends on the trace. Other traces are loaded whole and
+/// handed to |Callback| in a single call. If |Sort| is true, the records of
+/// each chunk are sorted by TSC. |Callback| is not called if there are no
+/// records, and loading stops at the first error it returns.
+Error loadTraceFileByThread(StringRef Filename, TraceChunkCallback Callback,
+                            bool Sort = false);
+
 } // namespace xray
 } // namespace llvm
 
@@ -15,6 +15,7 @@
 #include "llvm/ADT/SCCIterator.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/IR/Attributes.h"
@@ -28,6 +29,7 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Value.h"
@@ -35,6 +37,11 @@
 #include "llvm/Support/BranchProbability.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 #include <cstdint>
@@ -54,6 +61,11 @@ cl::opt<std::string> PrintBranchProbFuncName(
     cl::desc("The option to specify the name of the function "
              "whose branch probability info is printed."));
 
+static cl::opt<std::string> BPICacheDir(
+    "bpi-cache-dir", cl::Hidden,
+    cl::desc("Directory where the branch probabilities of the functions are "
+             "cached across compile jobs, keyed by a hash of each function"));
+
 INITIALIZE_PASS_BEGIN(BranchProbabilityInfoWrapperPass, "branch-prob",
                       "Branch Probability Analysis", false, true)
 INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
@@ -1001,6 +1013,233 @@ void BranchProbabilityInfo::calculate(const Function &F, const LoopInfo &LI,
   }
 }
 
+// The first line of the cache files, to be bumped when the heuristics change.
+static const char BPICacheVersion[] = "BPI 1";
+
+namespace {
+// Computes the cache key of a function from its structure rather than from
+// its printed IR, so that it costs a walk over the instructions and doesn't
+// depend on value names, slot numbers or unrelated metadata. Blocks,
+// arguments and instructions are hashed by their position in the function.
+class BPICacheKeyBuilder {
+  MD5 Hash;
+  DenseMap<const Value *, uint64_t> Numbers;
+  const TargetLibraryInfo *TLI;
+
+  void add(uint64_t V) {
+    uint8_t Buf[8];
+    support::endian::write64le(Buf, V);
+    Hash.update(Buf);
+  }
+
+  void add(StringRef S) {
+    add(S.size());
+    Hash.update(S);
+  }
+
+  void addType(const Type *Ty) {
+    add(Ty->getTypeID());
+    if (Ty->isIntOrIntVectorTy() || Ty->isFPOrFPVectorTy())
+      add(Ty->getScalarSizeInBits());
+  }
+
+  void addAPInt(const APInt &V) {
+    add(V.getBitWidth());
+    for (unsigned I = 0, E = V.getNumWords(); I != E; ++I)
+      add(V.getRawData()[I]);
+  }
+
+  void addValue(const Value *V, unsigned Depth = 0) {
+    auto It = Numbers.find(V);
+    if (It != Numbers.end()) {
+      add('v');
+      add(It->second);
+      return;
+    }
+    add(V->getValueID());
+    addType(V->getType());
+    if (const auto *GV = dyn_cast<GlobalValue>(V)) {
+      // Cold and library functions are recognized by their declarations.
+      add(GV->getName());
+      if (const auto *Callee = dyn_cast<Function>(GV)) {
+        LibFunc Func;
+        add(Callee->hasFnAttribute(Attribute::Cold));
+        add(Callee->hasFnAttribute(Attribute::NoReturn));
+        add(TLI && TLI->getLibFunc(*Callee, Func) ? Func + 1 : 0);
+      }
+      return;
+    }
+    if (const auto *CI = dyn_cast<ConstantInt>(V)) {
+      addAPInt(CI->getValue());
+      return;
+    }
+    if (const auto *CFP = dyn_cast<ConstantFP>(V)) {
+      addAPInt(CFP->getValueAPF().bitcastToAPInt());
+      return;
+    }
+    // Constant expressions and aggregates are rarely compared by the
+    // heuristics, so only their first levels are hashed.
+    if (const auto *C = dyn_cast<Constant>(V)) {
+      if (const auto *CE = dyn_cast<ConstantExpr>(C))
+        add(CE->getOpcode());
+      add(C->getNumOperands());
+      if (Depth < 2)
+        for (const Use &Op : C->operands())
+          addValue(Op.get(), Depth + 1);
+    }
+  }
+
+  void addMetadata(const MDNode *MD) {
+    add(MD->getNumOperands());
+    for (const MDOperand &Op : MD->operands()) {
+      if (const auto *S = dyn_cast_or_null<MDString>(Op.get()))
+        add(S->getString());
+      else if (const auto *C = dyn_cast_or_null<ConstantAsMetadata>(Op.get()))
+        addValue(C->getValue());
+      else
+        add(0);
+    }
+  }
+
+public:
+  explicit BPICacheKeyBuilder(const TargetLibraryInfo *TLI) : TLI(TLI) {}
+
+  std::string build(const Function &F) {
+    add(BPICacheVersion);
+    add(F.getParent()->getTargetTriple());
+    add(F.getAttributes().getAsString(AttributeList::FunctionIndex));
+    add(TLI != nullptr);
+
+    uint64_t N = 0;
+    for (const Argument &A : F.args())
+      Numbers[&A] = N++;
+    for (const BasicBlock &BB : F) {
+      Numbers[&BB] = N++;
+      for (const Instruction &I : BB)
+        Numbers[&I] = N++;
+    }
+
+    add(F.arg_size());
+    for (const Argument &A : F.args())
+      addType(A.getType());
+    for (const BasicBlock &BB : F) {
+      add(BB.size());
+      for (const Instruction &I : BB) {
+        add(I.getOpcode());
+        addType(I.getType());
+        if (const auto *Cmp = dyn_cast<CmpInst>(&I))
+          add(Cmp->getPredicate());
+        if (const auto *Call = dyn_cast<CallBase>(&I)) {
+          add(Call->hasFnAttr(Attribute::Cold));
+          add(Call->hasFnAttr(Attribute::NoReturn));
+        }
+        add(I.getNumOperands());
+        for (const Use &Op : I.operands())
+          addValue(Op.get());
+        if (const MDNode *Weights = I.getMetadata(LLVMContext::MD_prof))
+          addMetadata(Weights);
+        else
+          add(0);
+      }
+    }
+
+    MD5::MD5Result Result;
+    Hash.final(Result);
+    return Result.digest().str().str();
+  }
+};
+} // end anonymous namespace
+
+// Hashes what the heuristics look at: the target, the structure of F, and
+// the parts of it the IR only refers to, namely the attributes of F, of its
+// calls and of their callees, which decide cold calls and library functions,
+// and the branch weights.
+static std::string getCacheKey(const Function &F,
+                               const TargetLibraryInfo *TLI) {
+  return BPICacheKeyBuilder(TLI).build(F);
+}
+
+// The cache files hold a line for each edge with a probability, with the
+// number of its source block in F, its successor index and the numerator of
+// its probability.
+bool BranchProbabilityInfo::readCachedProbabilities(const Function &F,
+                                                    StringRef Path) {
+  auto BufOrErr = MemoryBuffer::getFile(Path);
+  if (!BufOrErr)
+    return false;
+  SmallVector<const BasicBlock *, 32> Blocks;
+  for (const BasicBlock &BB : F)
+    Blocks.push_back(&BB);
+
+  SmallVector<StringRef, 32> Lines;
+  (*BufOrErr)->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  if (Lines.empty() || Lines[0] != BPICacheVersion)
+    return false;
+  SmallVector<std::pair<Edge, BranchProbability>, 32> Edges;
+  for (StringRef Line : makeArrayRef(Lines).drop_front()) {
+    SmallVector<StringRef, 3> Fields;
+    Line.split(Fields, ' ');
+    unsigned Block, Succ;
+    uint32_t Numerator;
+    if (Fields.size() != 3 || Fields[0].getAsInteger(10, Block) ||
+        Fields[1].getAsInteger(10, Succ) ||
+        Fields[2].getAsInteger(10, Numerator) || Block >= Blocks.size() ||
+        Succ >= Blocks[Block]->getTerminator()->getNumSuccessors() ||
+        Numerator > BranchProbability::getDenominator())
+      return false;
+    Edges.push_back(
+        {{Blocks[Block], Succ}, BranchProbability::getRaw(Numerator)});
+  }
+  for (const auto &E : Edges)
+    setEdgeProbability(E.first.first, E.first.second, E.second);
+  return true;
+}
+
+void BranchProbabilityInfo::writeCachedProbabilities(const Function &F,
+                                                     StringRef Path) const {
+  // Write to a unique file and rename it, so that other jobs see either no
+  // file or a whole one.
+  int FD;
+  SmallString<128> TempPath;
+  if (sys::fs::createUniqueFile(Path + "-%%%%%%.tmp", FD, TempPath))
+    return;
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << BPICacheVersion << '\n';
+    unsigned Block = 0;
+    for (const BasicBlock &BB : F) {
+      for (unsigned Succ = 0, E = BB.getTerminator()->getNumSuccessors();
+           Succ != E; ++Succ) {
+        auto It = Probs.find(std::make_pair(&BB, Succ));
+        if (It != Probs.end())
+          OS << Block << ' ' << Succ << ' ' << It->second.getNumerator()
+             << '\n';
+      }
+      ++Block;
+    }
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath);
+      return;
+    }
+  }
+  if (sys::fs::rename(TempPath, Path))
+    sys::fs::remove(TempPath);
+}
+
+void BranchProbabilityInfo::calculateCached(
+    const Function &F, function_ref<const LoopInfo &()> GetLI,
+    const TargetLibraryInfo *TLI, StringRef CacheDir) {
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, "bpi-" + getCacheKey(F, TLI));
+  if (readCachedProbabilities(F, Path)) {
+    LastF = &F;
+    return;
+  }
+  calculate(F, GetLI(), TLI);
+  writeCachedProbabilities(F, Path);
+}
+
 void BranchProbabilityInfoWrapperPass::getAnalysisUsage(
     AnalysisUsage &AU) const {
   // We require DT so it's available when LI is available. The LI updating code
@@ -1015,7 +1254,11 @@ void BranchProbabilityInfoWrapperPass::getAnalysisUsage(
 bool BranchProbabilityInfoWrapperPass::runOnFunction(Function &F) {
   const LoopInfo &LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
   const TargetLibraryInfo &TLI = getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
-  BPI.calculate(F, LI, &TLI);
+  if (!BPICacheDir.empty())
+    BPI.calculateCached(F, [&]() -> const LoopInfo & { return LI; }, &TLI,
+                        BPICacheDir);
+  else
+    BPI.calculate(F, LI, &TLI);
   return false;
 }
 
@@ -1030,7 +1273,13 @@ AnalysisKey BranchProbabilityAnalysis::Key;
 BranchProbabilityInfo
 BranchProbabilityAnalysis::run(Function &F, FunctionAnalysisManager &AM) {
   BranchProbabilityInfo BPI;
-  BPI.calculate(F, AM.getResult<LoopAnalysis>(F), &AM.getResult<TargetLibraryAnalysis>(F));
+  if (!BPICacheDir.empty())
+    BPI.calculateCached(
+        F, [&]() -> const LoopInfo & { return AM.getResult<LoopAnalysis>(F); },
+        &AM.getResult<TargetLibraryAnalysis>(F), BPICacheDir);
+  else
+    BPI.calculate(F, AM.getResult<LoopAnalysis>(F),
+                  &AM.getResult<TargetLibraryAnalysis>(F));
   return BPI;
 }
 
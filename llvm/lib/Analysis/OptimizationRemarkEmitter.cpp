@@ -18,6 +18,7 @@
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/RemarkStreamer.h"
 
 using namespace llvm;
 
@@ -83,6 +84,15 @@ void OptimizationRemarkEmitter::emit(
   F->getContext().diagnose(OptDiag);
 }
 
+bool OptimizationRemarkEmitter::allowExtraAnalysis(StringRef PassName) const {
+  // Remarks filtered out of the remark file do not need the extra analysis.
+  LLVMContext &Ctx = F->getContext();
+  if (RemarkStreamer *RS = Ctx.getRemarkStreamer())
+    if (RS->matchesFilter(PassName))
+      return true;
+  return Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
+}
+
 OptimizationRemarkEmitterWrapperPass::OptimizationRemarkEmitterWrapperPass()
     : FunctionPass(ID) {
   initializeOptimizationRemarkEmitterWrapperPassPass(
@@ -145,6 +145,8 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumSCEVCacheTrims,
+          "Number of times memoized SCEV results were dropped to save memory");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -211,6 +213,19 @@ static cl::opt<unsigned>
                   cl::desc("Max coefficients in AddRec during evolving"),
                   cl::init(8));
 
+static cl::opt<unsigned> MaxDerivedCacheEntries(
+    "scalar-evolution-max-derived-cache-entries", cl::Hidden,
+    cl::desc("Maximum number of memoized ranges, dispositions, values at "
+             "scopes and trailing zeros before they are dropped (0 = "
+             "unlimited)"),
+    cl::init(0));
+
+static cl::opt<bool>
+    PrintCacheStats("scev-stats", cl::Hidden,
+                    cl::desc("Print the cache sizes of ScalarEvolution for "
+                             "each function when it is destroyed"),
+                    cl::init(false));
+
 static cl::opt<unsigned>
     HugeExprThreshold("scalar-evolution-huge-expr-threshold", cl::Hidden,
                   cl::desc("Size of the expression which is considered huge"),
@@ -3897,6 +3912,7 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
 
   const SCEV *S = getExistingSCEV(V);
   if (S == nullptr) {
+    trimDerivedCaches();
     S = createSCEV(V);
     // During PHI resolution, it is possible to create two SCEVs for the same
     // V, so it is needed to double check whether V->S is inserted into
@@ -6759,6 +6775,29 @@ void ScalarEvolution::forgetAllLoops() {
   PredicatedSCEVRewrites.clear();
 }
 
+void ScalarEvolution::trimDerivedCaches() {
+  if (!MaxDerivedCacheEntries)
+    return;
+
+  size_t NumEntries = ValuesAtScopes.size() + LoopDispositions.size() +
+                      BlockDispositions.size() + UnsignedRanges.size() +
+                      SignedRanges.size() + MinTrailingZerosCache.size();
+  if (NumEntries <= MaxDerivedCacheEntries)
+    return;
+
+  // These only memoize results that are derived from the SCEV nodes, and
+  // their users look them up again after any nested query, so they can be
+  // dropped at any point.
+  ValuesAtScopes.clear();
+  LoopDispositions.clear();
+  BlockDispositions.clear();
+  UnsignedRanges.clear();
+  SignedRanges.clear();
+  MinTrailingZerosCache.clear();
+  ++NumDerivedCacheTrims;
+  ++NumSCEVCacheTrims;
+}
+
 void ScalarEvolution::forgetLoop(const Loop *L) {
   // Drop any stored trip count value.
   auto RemoveLoopFromBackedgeMap =
@@ -11356,6 +11395,7 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
       PendingPhiRanges(std::move(Arg.PendingPhiRanges)),
       PendingMerges(std::move(Arg.PendingMerges)),
       MinTrailingZerosCache(std::move(Arg.MinTrailingZerosCache)),
+      NumDerivedCacheTrims(Arg.NumDerivedCacheTrims),
       BackedgeTakenCounts(std::move(Arg.BackedgeTakenCounts)),
       PredicatedBackedgeTakenCounts(
           std::move(Arg.PredicatedBackedgeTakenCounts)),
@@ -11377,6 +11417,9 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
 }
 
 ScalarEvolution::~ScalarEvolution() {
+  if (PrintCacheStats && !UniqueSCEVs.empty())
+    printCacheStats(errs());
+
   // Iterate through all the SCEVUnknown instances and call their
   // destructors, so that they release their references to their values.
   for (SCEVUnknown *U = FirstUnknown; U;) {
@@ -11482,6 +11525,24 @@ static StringRef loopDispositionToStr(ScalarEvolution::LoopDisposition LD) {
   llvm_unreachable("Unknown ScalarEvolution::LoopDisposition kind!");
 }
 
+void ScalarEvolution::printCacheStats(raw_ostream &OS) const {
+  OS << "ScalarEvolution cache stats for function '" << F.getName() << "':\n";
+  OS << "  SCEV nodes: " << UniqueSCEVs.size() << " ("
+     << SCEVAllocator.getTotalMemory() << " bytes allocated)\n";
+  OS << "  Predicates: " << UniquePreds.size() << "\n";
+  OS << "  Value to SCEV entries: " << ValueExprMap.size() << "\n";
+  OS << "  SCEV to value entries: " << ExprValueMap.size() << "\n";
+  OS << "  Backedge-taken counts: " << BackedgeTakenCounts.size() << " ("
+     << PredicatedBackedgeTakenCounts.size() << " predicated)\n";
+  OS << "  Values at scopes: " << ValuesAtScopes.size() << "\n";
+  OS << "  Loop dispositions: " << LoopDispositions.size() << "\n";
+  OS << "  Block dispositions: " << BlockDispositions.size() << "\n";
+  OS << "  Ranges: " << UnsignedRanges.size() << " unsigned, "
+     << SignedRanges.size() << " signed\n";
+  OS << "  Trailing zeros: " << MinTrailingZerosCache.size() << "\n";
+  OS << "  Derived cache trims: " << NumDerivedCacheTrims << "\n";
+}
+
 void ScalarEvolution::print(raw_ostream &OS) const {
   // ScalarEvolution's implementation of the print method is to print
   // out SCEV values of all instructions that are interesting. Doing
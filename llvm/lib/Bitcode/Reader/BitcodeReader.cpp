@@ -70,6 +70,7 @@
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -92,6 +93,11 @@ static cl::opt<bool> PrintSummaryGUIDs(
     cl::desc(
         "Print the global id for each value when reading the module summary"));
 
+static cl::opt<bool> ParallelFunctionParsing(
+    "bitcode-parallel-function-parsing", cl::init(false), cl::Hidden,
+    cl::desc("Decode function blocks on multiple threads when materializing "
+             "a whole module"));
+
 namespace {
 
 enum {
@@ -480,6 +486,93 @@ BitcodeReaderBase::readNameFromStrtab(ArrayRef<uint64_t> Record) {
 
 namespace {
 
+/// The contents of a function block, decoded ahead of time by
+/// BitcodeReader::preparseFunctionBodies. This is done on worker threads, so
+/// it doesn't touch the LLVMContext: records are decoded into plain operand
+/// lists, and nested blocks are only located so that they can be read from
+/// the reader's stream when the function is materialized.
+class PreparsedFunctionBody {
+  struct Entry {
+    bool IsSubBlock;
+    // The block ID for nested blocks, or the code of a record.
+    unsigned ID;
+    // The bit position just after the block ID for nested blocks, or the
+    // index to the first operand of a record.
+    uint64_t Pos;
+    unsigned NumOps;
+  };
+
+  std::vector<Entry> Entries;
+  std::vector<uint64_t> Ops;
+  size_t NextEntry = 0;
+
+public:
+  /// Decodes the function block at \p Bit.
+  Error read(BitstreamCursor &Stream, uint64_t Bit);
+
+  /// Like BitstreamCursor::advance(). Returns an EndBlock entry after the
+  /// last record.
+  BitstreamEntry advance() {
+    if (NextEntry == Entries.size())
+      return BitstreamEntry::getEndBlock();
+    const Entry &E = Entries[NextEntry++];
+    return E.IsSubBlock ? BitstreamEntry::getSubBlock(E.ID)
+                        : BitstreamEntry::getRecord(0);
+  }
+
+  /// Returns the position of the nested block returned by the last advance().
+  uint64_t getSubBlockBit() const { return Entries[NextEntry - 1].Pos; }
+
+  /// Like BitstreamCursor::readRecord() for the record returned by the last
+  /// advance().
+  unsigned readRecord(SmallVectorImpl<uint64_t> &Vals) const {
+    const Entry &E = Entries[NextEntry - 1];
+    Vals.append(Ops.begin() + E.Pos, Ops.begin() + E.Pos + E.NumOps);
+    return E.ID;
+  }
+};
+
+} // end anonymous namespace
+
+Error PreparsedFunctionBody::read(BitstreamCursor &Stream, uint64_t Bit) {
+  if (Error Err = Stream.JumpToBit(Bit))
+    return Err;
+  if (Error Err = Stream.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
+    return Err;
+
+  SmallVector<uint64_t, 64> Record;
+  while (true) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    BitstreamEntry Entry = MaybeEntry.get();
+
+    switch (Entry.Kind) {
+    case BitstreamEntry::Error:
+      return error("Malformed block");
+    case BitstreamEntry::EndBlock:
+      return Error::success();
+    case BitstreamEntry::SubBlock:
+      Entries.push_back({true, Entry.ID, Stream.GetCurrentBitNo(), 0});
+      if (Error Err = Stream.SkipBlock())
+        return Err;
+      break;
+    case BitstreamEntry::Record: {
+      Record.clear();
+      Expected<unsigned> MaybeCode = Stream.readRecord(Entry.ID, Record);
+      if (!MaybeCode)
+        return MaybeCode.takeError();
+      Entries.push_back({false, MaybeCode.get(), Ops.size(),
+                         static_cast<unsigned>(Record.size())});
+      Ops.insert(Ops.end(), Record.begin(), Record.end());
+      break;
+    }
+    }
+  }
+}
+
+namespace {
+
 class BitcodeReader : public BitcodeReaderBase, public GVMaterializer {
   LLVMContext &Context;
   Module *TheModule = nullptr;
@@ -537,6 +630,10 @@ class BitcodeReader : public BitcodeReaderBase, public GVMaterializer {
   /// where to find deferred function body in the stream.
   DenseMap<Function*, uint64_t> DeferredFunctionInfo;
 
+  /// Function bodies decoded by preparseFunctionBodies that have not been
+  /// materialized yet.
+  DenseMap<Function *, PreparsedFunctionBody> PreparsedFunctionBodies;
+
   /// When Metadata block is initially scanned when parsing the module, we may
   /// choose to defer parsing of the metadata. This vector contains info about
   /// which Metadata blocks are deferred.
@@ -751,7 +848,9 @@ private:
   /// Save the positions of the Metadata blocks and skip parsing the blocks.
   Error rememberAndSkipMetadata();
   Error typeCheckLoadStoreInst(Type *ValType, Type *PtrType);
-  Error parseFunctionBody(Function *F);
+  Error parseFunctionBody(Function *F,
+                          PreparsedFunctionBody *Preparsed = nullptr);
+  Module::iterator preparseFunctionBodies(Module::iterator Begin);
   Error globalCleanup();
   Error resolveGlobalAndIndirectSymbolInits();
   Error parseUseLists();
@@ -3684,9 +3783,13 @@ void BitcodeReader::propagateByValTypes(CallBase *CB,
 }
 
 /// Lazily parse the specified function body block.
-Error BitcodeReader::parseFunctionBody(Function *F) {
-  if (Error Err = Stream.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
-    return Err;
+Error BitcodeReader::parseFunctionBody(Function *F,
+                                       PreparsedFunctionBody *Preparsed) {
+  // A preparsed body is read from memory, except for nested blocks, so the
+  // stream doesn't enter the function block.
+  if (!Preparsed)
+    if (Error Err = Stream.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
+      return Err;
 
   // Unexpected unresolved metadata when parsing function.
   if (MDLoader->hasFwdRefs())
@@ -3724,10 +3827,15 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
   SmallVector<uint64_t, 64> Record;
 
   while (true) {
-    Expected<llvm::BitstreamEntry> MaybeEntry = Stream.advance();
-    if (!MaybeEntry)
-      return MaybeEntry.takeError();
-    llvm::BitstreamEntry Entry = MaybeEntry.get();
+    llvm::BitstreamEntry Entry;
+    if (Preparsed) {
+      Entry = Preparsed->advance();
+    } else {
+      Expected<llvm::BitstreamEntry> MaybeEntry = Stream.advance();
+      if (!MaybeEntry)
+        return MaybeEntry.takeError();
+      Entry = MaybeEntry.get();
+    }
 
     switch (Entry.Kind) {
     case BitstreamEntry::Error:
@@ -3736,6 +3844,9 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
       goto OutOfRecordLoop;
 
     case BitstreamEntry::SubBlock:
+      if (Preparsed)
+        if (Error JumpFailed = Stream.JumpToBit(Preparsed->getSubBlockBit()))
+          return JumpFailed;
       switch (Entry.ID) {
       default:  // Skip unknown content.
         if (Error Err = Stream.SkipBlock())
@@ -3776,7 +3887,9 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
     Record.clear();
     Instruction *I = nullptr;
     Type *FullTy = nullptr;
-    Expected<unsigned> MaybeBitCode = Stream.readRecord(Entry.ID, Record);
+    Expected<unsigned> MaybeBitCode =
+        Preparsed ? Preparsed->readRecord(Record)
+                  : Stream.readRecord(Entry.ID, Record);
     if (!MaybeBitCode)
       return MaybeBitCode.takeError();
     switch (unsigned BitCode = MaybeBitCode.get()) {
@@ -5182,6 +5295,48 @@ Error BitcodeReader::findFunctionInStream(
   return Error::success();
 }
 
+/// Decodes the bodies of the next functions in the module starting at \p Begin
+/// on multiple threads, and returns the iterator to the first function that
+/// was not looked at. The bodies are built into IR later, one at a time in the
+/// usual order, by materialize().
+Module::iterator BitcodeReader::preparseFunctionBodies(Module::iterator Begin) {
+  // Limit the number of bodies in memory at a time.
+  const size_t BatchSize = 1024;
+
+  std::vector<std::pair<Function *, uint64_t>> Bodies;
+  Module::iterator I = Begin, E = TheModule->end();
+  for (; I != E && Bodies.size() < BatchSize; ++I) {
+    // Bodies whose position is not known yet are found by scanning the
+    // stream, which can't be done on multiple threads.
+    uint64_t Bit = I->isMaterializable() ? DeferredFunctionInfo.lookup(&*I) : 0;
+    if (Bit)
+      Bodies.push_back({&*I, Bit});
+  }
+
+  std::vector<PreparsedFunctionBody> Preparsed(Bodies.size());
+  std::vector<uint8_t> Failed(Bodies.size());
+  auto Read = [&](size_t J) {
+    BitstreamCursor Cursor(Stream.getBitcodeBytes());
+    Cursor.setBlockInfo(&BlockInfo);
+    // Malformed bodies are parsed again without preparsing to report the
+    // error at the usual point.
+    if (Error Err = Preparsed[J].read(Cursor, Bodies[J].second)) {
+      consumeError(std::move(Err));
+      Failed[J] = true;
+    }
+  };
+#if LLVM_ENABLE_THREADS
+  parallel::for_each_n(parallel::par, size_t(0), Bodies.size(), Read);
+#else
+  parallel::for_each_n(parallel::seq, size_t(0), Bodies.size(), Read);
+#endif
+
+  for (size_t J = 0; J != Bodies.size(); ++J)
+    if (!Failed[J])
+      PreparsedFunctionBodies[Bodies[J].first] = std::move(Preparsed[J]);
+  return I;
+}
+
 SyncScope::ID BitcodeReader::getDecodedSyncScopeID(unsigned Val) {
   if (Val == SyncScope::SingleThread || Val == SyncScope::System)
     return SyncScope::ID(Val);
@@ -5195,6 +5350,13 @@ SyncScope::ID BitcodeReader::getDecodedSyncScopeID(unsigned Val) {
 //===----------------------------------------------------------------------===//
 
 Error BitcodeReader::materialize(GlobalValue *GV) {
+  // The debug info attached to a global variable may be loaded lazily.
+  if (auto *GVar = dyn_cast<GlobalVariable>(GV)) {
+    if (Error Err = materializeMetadata())
+      return Err;
+    return MDLoader->loadGlobalVariableAttachments(*GVar);
+  }
+
   Function *F = dyn_cast<Function>(GV);
   // If it's not a function or is already material, ignore the request.
   if (!F || !F->isMaterializable())
@@ -5212,11 +5374,20 @@ Error BitcodeReader::materialize(GlobalValue *GV) {
   if (Error Err = materializeMetadata())
     return Err;
 
-  // Move the bit stream to the saved position of the deferred function body.
-  if (Error JumpFailed = Stream.JumpToBit(DFII->second))
-    return JumpFailed;
-  if (Error Err = parseFunctionBody(F))
-    return Err;
+  auto PFI = PreparsedFunctionBodies.find(F);
+  if (PFI != PreparsedFunctionBodies.end()) {
+    PreparsedFunctionBody Body = std::move(PFI->second);
+    PreparsedFunctionBodies.erase(PFI);
+    if (Error Err = parseFunctionBody(F, &Body))
+      return Err;
+  } else {
+    // Move the bit stream to the saved position of the deferred function
+    // body.
+    if (Error JumpFailed = Stream.JumpToBit(DFII->second))
+      return JumpFailed;
+    if (Error Err = parseFunctionBody(F))
+      return Err;
+  }
   F->setIsMaterializable(false);
 
   if (StripDebugInfo)
@@ -5268,11 +5439,21 @@ Error BitcodeReader::materializeModule() {
   WillMaterializeAllForwardRefs = true;
 
   // Iterate over the module, deserializing any functions that are still on
-  // disk.
+  // disk. With -bitcode-parallel-function-parsing, the bodies are decoded
+  // ahead in batches on multiple threads, but are still built into IR here in
+  // module order because the LLVMContext is not thread-safe.
+  Module::iterator NextToPreparse = TheModule->begin();
   for (Function &F : *TheModule) {
+    if (ParallelFunctionParsing && PreparsedFunctionBodies.empty() &&
+        NextToPreparse != TheModule->end())
+      NextToPreparse = preparseFunctionBodies(NextToPreparse);
     if (Error Err = materialize(&F))
       return Err;
   }
+  PreparsedFunctionBodies.clear();
+  for (GlobalVariable &GV : TheModule->globals())
+    if (Error Err = materialize(&GV))
+      return Err;
   // At this point, if there are any function bodies, parse the rest of
   // the bits in the module past the last function block we have recorded
   // through either lazy scanning or the VST.
@@ -5614,8 +5795,18 @@ std::vector<FunctionSummary::EdgeTy>
 ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
                                               bool IsOldProfileFormat,
                                               bool HasProfile, bool HasRelBF) {
+  // Each edge is encoded as the callee followed by zero or more fields, so
+  // reserve space for the number of edges rather than the number of fields.
+  // The call lists of all modules are kept alive during the thin link, so
+  // overallocating them is a significant part of its memory usage.
+  unsigned FieldsPerEdge = 1;
+  if (IsOldProfileFormat)
+    FieldsPerEdge += HasProfile ? 2 : 1;
+  else if (HasProfile || HasRelBF)
+    FieldsPerEdge += 1;
+
   std::vector<FunctionSummary::EdgeTy> Ret;
-  Ret.reserve(Record.size());
+  Ret.reserve(Record.size() / FieldsPerEdge);
   for (unsigned I = 0, E = Record.size(); I != E; ++I) {
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
     uint64_t RelBF = 0;
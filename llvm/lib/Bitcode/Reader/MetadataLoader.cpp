@@ -450,6 +450,12 @@ class MetadataLoader::MetadataLoaderImpl {
   /// populated.
   void lazyLoadOneMetadata(unsigned Idx, PlaceholderQueue &Placeholders);
 
+  /// Attachments of global variables that are loaded only when the variable
+  /// is materialized, when lazy-loading. The debug info of a variable refers
+  /// to its whole type graph, and the importer links only a few variables.
+  DenseMap<GlobalVariable *, SmallVector<uint64_t, 2>>
+      DeferredGlobalVariableAttachments;
+
   // Keep mapping of seens pair of old-style CU <-> SP, and update pointers to
   // point from SP to CU after a block is completly parsed.
   std::vector<std::pair<DICompileUnit *, Metadata *>> CUSubprograms;
@@ -510,18 +516,21 @@ class MetadataLoader::MetadataLoaderImpl {
       }
 
     // Upgrade variables attached to globals.
-    for (auto &GV : TheModule.globals()) {
-      SmallVector<MDNode *, 1> MDs;
-      GV.getMetadata(LLVMContext::MD_dbg, MDs);
-      GV.eraseMetadata(LLVMContext::MD_dbg);
-      for (auto *MD : MDs)
-        if (auto *DGV = dyn_cast_or_null<DIGlobalVariable>(MD)) {
-          auto *DGVE = DIGlobalVariableExpression::getDistinct(
-              Context, DGV, DIExpression::get(Context, {}));
-          GV.addMetadata(LLVMContext::MD_dbg, *DGVE);
-        } else
-          GV.addMetadata(LLVMContext::MD_dbg, *MD);
-    }
+    for (auto &GV : TheModule.globals())
+      upgradeGlobalVariable(GV);
+  }
+
+  void upgradeGlobalVariable(GlobalVariable &GV) {
+    SmallVector<MDNode *, 1> MDs;
+    GV.getMetadata(LLVMContext::MD_dbg, MDs);
+    GV.eraseMetadata(LLVMContext::MD_dbg);
+    for (auto *MD : MDs)
+      if (auto *DGV = dyn_cast_or_null<DIGlobalVariable>(MD)) {
+        auto *DGVE = DIGlobalVariableExpression::getDistinct(
+            Context, DGV, DIExpression::get(Context, {}));
+        GV.addMetadata(LLVMContext::MD_dbg, *DGVE);
+      } else
+        GV.addMetadata(LLVMContext::MD_dbg, *MD);
   }
 
   /// Remove a leading DW_OP_deref from DIExpressions in a dbg.declare that
@@ -672,6 +681,8 @@ public:
 
   Error parseMetadataKinds();
 
+  Error loadGlobalVariableAttachments(GlobalVariable &GV);
+
   void setStripTBAA(bool Value) { StripTBAA = Value; }
   bool isStrippingTBAA() { return StripTBAA; }
 
@@ -835,6 +846,11 @@ MetadataLoader::MetadataLoaderImpl::lazyLoadModuleMetadataBlock() {
         unsigned ValueID = Record[0];
         if (ValueID >= ValueList.size())
           return error("Invalid record");
+        if (auto *GV = dyn_cast<GlobalVariable>(ValueList[ValueID])) {
+          DeferredGlobalVariableAttachments[GV].assign(Record.begin() + 1,
+                                                       Record.end());
+          break;
+        }
         if (auto *GO = dyn_cast<GlobalObject>(ValueList[ValueID]))
           if (Error Err = parseGlobalObjectAttachment(
                   *GO, ArrayRef<uint64_t>(Record).slice(1)))
@@ -879,6 +895,7 @@ MetadataLoader::MetadataLoaderImpl::lazyLoadModuleMetadataBlock() {
         // lazy-loading and fallback.
         MDStringRef.clear();
         GlobalMetadataBitPosIndex.clear();
+        DeferredGlobalVariableAttachments.clear();
         return false;
       }
       break;
@@ -1463,12 +1480,22 @@ Error MetadataLoader::MetadataLoaderImpl::parseOneMetadata(
     // Ignore Record[0], which indicates whether this compile unit is
     // distinct.  It's always distinct.
     IsDistinct = true;
+
+    // When lazy-loading for importing, don't load the enums, retained types,
+    // global variables and macros listed on the compile unit. The IRMover
+    // doesn't import them (see IRLinker::prepareCompileUnitsForImport), and
+    // they would pull in most of the type graph of the module.
+    bool IsLazyImport = IsImporting && !GlobalMetadataBitPosIndex.empty();
+    auto getCUListOrNull = [&](unsigned ID) -> Metadata * {
+      return IsLazyImport ? nullptr : getMDOrNull(ID);
+    };
+
     auto *CU = DICompileUnit::getDistinct(
         Context, Record[1], getMDOrNull(Record[2]), getMDString(Record[3]),
         Record[4], getMDString(Record[5]), Record[6], getMDString(Record[7]),
-        Record[8], getMDOrNull(Record[9]), getMDOrNull(Record[10]),
-        getMDOrNull(Record[12]), getMDOrNull(Record[13]),
-        Record.size() <= 15 ? nullptr : getMDOrNull(Record[15]),
+        Record[8], getCUListOrNull(Record[9]), getCUListOrNull(Record[10]),
+        getCUListOrNull(Record[12]), getMDOrNull(Record[13]),
+        Record.size() <= 15 ? nullptr : getCUListOrNull(Record[15]),
         Record.size() <= 14 ? 0 : Record[14],
         Record.size() <= 16 ? true : Record[16],
         Record.size() <= 17 ? false : Record[17],
@@ -1973,6 +2000,25 @@ Error MetadataLoader::MetadataLoaderImpl::parseGlobalObjectAttachment(
   return Error::success();
 }
 
+Error MetadataLoader::MetadataLoaderImpl::loadGlobalVariableAttachments(
+    GlobalVariable &GV) {
+  auto I = DeferredGlobalVariableAttachments.find(&GV);
+  if (I == DeferredGlobalVariableAttachments.end())
+    return Error::success();
+  SmallVector<uint64_t, 2> Record = std::move(I->second);
+  DeferredGlobalVariableAttachments.erase(I);
+
+  // This creates forward references to the attached nodes, which are then
+  // loaded on demand along with their operands.
+  PlaceholderQueue Placeholders;
+  if (Error Err = parseGlobalObjectAttachment(GV, Record))
+    return Err;
+  resolveForwardRefsAndPlaceholders(Placeholders);
+  if (NeedUpgradeToDIGlobalVariableExpression)
+    upgradeGlobalVariable(GV);
+  return Error::success();
+}
+
 /// Parse metadata attachments.
 Error MetadataLoader::MetadataLoaderImpl::parseMetadataAttachment(
     Function &F, const SmallVectorImpl<Instruction *> &InstructionList) {
@@ -2161,6 +2207,10 @@ Error MetadataLoader::parseMetadataKinds() {
   return Pimpl->parseMetadataKinds();
 }
 
+Error MetadataLoader::loadGlobalVariableAttachments(GlobalVariable &GV) {
+  return Pimpl->loadGlobalVariableAttachments(GV);
+}
+
 void MetadataLoader::setStripTBAA(bool StripTBAA) {
   return Pimpl->setStripTBAA(StripTBAA);
 }
@@ -25,6 +25,7 @@ class BitstreamCursor;
 class DISubprogram;
 class Error;
 class Function;
+class GlobalVariable;
 class Instruction;
 class Metadata;
 class MDNode;
@@ -74,6 +75,10 @@ public:
   /// Parse a `METADATA_KIND` block for the current module.
   Error parseMetadataKinds();
 
+  /// Load the metadata attachments of \p GV if they were deferred while
+  /// lazy-loading the module-level metadata for importing.
+  Error loadGlobalVariableAttachments(GlobalVariable &GV);
+
   unsigned size() const;
   void shrinkTo(unsigned N);
 
@@ -167,6 +167,29 @@ DIEAbbrev &DIEAbbrevSet::uniqueAbbreviation(DIE &Die) {
   return *New;
 }
 
+DIEAbbrev &DIEAbbrevSet::uniqueAbbreviation(const DIEAbbrev &Abbrev) {
+  FoldingSetNodeID ID;
+  Abbrev.Profile(ID);
+
+  void *InsertPos;
+  if (DIEAbbrev *Existing =
+          AbbreviationsSet.FindNodeOrInsertPos(ID, InsertPos))
+    return *Existing;
+
+  DIEAbbrev *New = new (Alloc) DIEAbbrev(Abbrev.getTag(), Abbrev.hasChildren());
+  for (const DIEAbbrevData &Data : Abbrev.getData()) {
+    if (Data.getForm() == dwarf::DW_FORM_implicit_const)
+      New->AddImplicitConstAttribute(Data.getAttribute(), Data.getValue());
+    else
+      New->AddAttribute(Data.getAttribute(), Data.getForm());
+  }
+  Abbreviations.push_back(New);
+  New->setNumber(Abbreviations.size());
+
+  AbbreviationsSet.InsertNode(New, InsertPos);
+  return *New;
+}
+
 void DIEAbbrevSet::Emit(const AsmPrinter *AP, MCSection *Section) const {
   if (!Abbreviations.empty()) {
     // Start the debug abbrev section.
@@ -310,6 +333,24 @@ unsigned DIE::computeOffsetsAndAbbrevs(const AsmPrinter *AP,
   return CUOffset;
 }
 
+unsigned DIE::computeOffsets(const AsmPrinter *AP, unsigned CUOffset) {
+  assert(AbbrevNumber != ~0u && "Abbreviation number not set");
+  setOffset(CUOffset);
+  CUOffset += getULEB128Size(getAbbrevNumber());
+
+  for (const auto &V : values())
+    CUOffset += V.SizeOf(AP);
+
+  if (hasChildren()) {
+    for (auto &Child : children())
+      CUOffset = Child.computeOffsets(AP, CUOffset);
+    CUOffset += sizeof(int8_t);
+  }
+
+  setSize(CUOffset - getOffset());
+  return CUOffset;
+}
+
 //===----------------------------------------------------------------------===//
 // DIEUnit Implementation
 //===----------------------------------------------------------------------===//
@@ -15,11 +15,19 @@
 #include "llvm/CodeGen/DIE.h"
 #include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/MC/MCStreamer.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Parallel.h"
 #include <algorithm>
 #include <cstdint>
 
 using namespace llvm;
 
+static cl::opt<bool> ParallelUnitLayout(
+    "dwarf-parallel-unit-layout", cl::Hidden,
+    cl::desc("Compute the abbreviations and DIE offsets of compile units in "
+             "parallel"),
+    cl::init(false));
+
 DwarfFile::DwarfFile(AsmPrinter *AP, StringRef Pref, BumpPtrAllocator &DA)
     : Asm(AP), Abbrevs(AbbrevAllocator), StrPool(DA, *Asm, Pref) {}
 
@@ -56,13 +64,27 @@ void DwarfFile::emitUnit(DwarfUnit *TheU, bool UseOffsets) {
     Asm->OutStreamer->EmitLabel(EndLabel);
 }
 
+// Unique the abbreviations of Die and its children into Abbrevs.
+static void uniqueAbbreviations(DIE &Die, DIEAbbrevSet &Abbrevs) {
+  Abbrevs.uniqueAbbreviation(Die);
+  for (DIE &Child : Die.children())
+    uniqueAbbreviations(Child, Abbrevs);
+}
+
+// Replace the abbreviation numbers of Die and its children, which were
+// assigned by a unit-local abbreviation set, by the numbers in Numbers.
+static void renumberAbbreviations(DIE &Die, ArrayRef<unsigned> Numbers) {
+  Die.setAbbrevNumber(Numbers[Die.getAbbrevNumber() - 1]);
+  for (DIE &Child : Die.children())
+    renumberAbbreviations(Child, Numbers);
+}
+
 // Compute the size and offset for each DIE.
 void DwarfFile::computeSizeAndOffsets() {
   // Offset from the first CU in the debug info section is 0 initially.
   unsigned SecOffset = 0;
 
-  // Iterate over each compile unit and set the size and offsets for each
-  // DIE within each compile unit. All offsets are CU relative.
+  SmallVector<DwarfUnit *, 8> Units;
   for (const auto &TheU : CUs) {
     if (TheU->getCUNode()->isDebugDirectivesOnly())
       continue;
@@ -70,10 +92,51 @@ void DwarfFile::computeSizeAndOffsets() {
     // Skip CUs that ended up not being needed (split CUs that were abandoned
     // because they added no information beyond the non-split CU)
     if (llvm::empty(TheU->getUnitDie().values()))
-      return;
+      break;
+
+    Units.push_back(TheU.get());
+  }
+
+  // Iterate over each compile unit and set the size and offsets for each
+  // DIE within each compile unit. All offsets are CU relative.
+  if (!ParallelUnitLayout || Units.size() < 2) {
+    for (DwarfUnit *TheU : Units) {
+      TheU->setDebugSectionOffset(SecOffset);
+      SecOffset += computeSizeAndOffsetsForUnit(TheU);
+    }
+    return;
+  }
 
-    TheU->setDebugSectionOffset(SecOffset);
-    SecOffset += computeSizeAndOffsetsForUnit(TheU.get());
+  // Otherwise unique the abbreviations of each unit in a set of its own, in
+  // parallel. Merging those sets in unit order numbers the abbreviations
+  // exactly like the serial walk above, so the output doesn't change. The
+  // offsets can then be computed for all units in parallel.
+  size_t NumUnits = Units.size();
+  std::vector<BumpPtrAllocator> LocalAllocators(NumUnits);
+  std::vector<std::unique_ptr<DIEAbbrevSet>> LocalAbbrevs(NumUnits);
+  parallel::for_each_n(parallel::par, size_t(0), NumUnits, [&](size_t I) {
+    LocalAbbrevs[I] = std::make_unique<DIEAbbrevSet>(LocalAllocators[I]);
+    uniqueAbbreviations(Units[I]->getUnitDie(), *LocalAbbrevs[I]);
+  });
+
+  std::vector<SmallVector<unsigned, 64>> Numbers(NumUnits);
+  for (size_t I = 0; I != NumUnits; ++I)
+    for (const DIEAbbrev *Abbrev : LocalAbbrevs[I]->getAbbreviations())
+      Numbers[I].push_back(Abbrevs.uniqueAbbreviation(*Abbrev).getNumber());
+  LocalAbbrevs.clear();
+
+  std::vector<unsigned> UnitSizes(NumUnits);
+  parallel::for_each_n(parallel::par, size_t(0), NumUnits, [&](size_t I) {
+    DwarfUnit *TheU = Units[I];
+    renumberAbbreviations(TheU->getUnitDie(), Numbers[I]);
+    unsigned Offset = sizeof(int32_t) +      // Length of Unit Info
+                      TheU->getHeaderSize(); // Unit-specific headers
+    UnitSizes[I] = TheU->getUnitDie().computeOffsets(Asm, Offset);
+  });
+
+  for (size_t I = 0; I != NumUnits; ++I) {
+    Units[I]->setDebugSectionOffset(SecOffset);
+    SecOffset += UnitSizes[I];
   }
 }
 
@@ -17,6 +17,7 @@
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/RemarkStreamer.h"
 
 using namespace llvm;
 
@@ -61,6 +62,16 @@ void MachineOptimizationRemarkEmitter::emit(
   Ctx.diagnose(OptDiag);
 }
 
+bool MachineOptimizationRemarkEmitter::allowExtraAnalysis(
+    StringRef PassName) const {
+  // Remarks filtered out of the remark file do not need the extra analysis.
+  LLVMContext &Ctx = MF.getFunction().getContext();
+  if (RemarkStreamer *RS = Ctx.getRemarkStreamer())
+    if (RS->matchesFilter(PassName))
+      return true;
+  return Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
+}
+
 MachineOptimizationRemarkEmitterPass::MachineOptimizationRemarkEmitterPass()
     : MachineFunctionPass(ID) {
   initializeMachineOptimizationRemarkEmitterPassPass(
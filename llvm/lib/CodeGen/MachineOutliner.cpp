@@ -71,6 +71,7 @@
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
 #include <tuple>
@@ -96,6 +97,14 @@ static cl::opt<bool> EnableLinkOnceODROutlining(
     cl::desc("Enable the machine outliner on linkonceodr functions"),
     cl::init(false));
 
+// Set to true to evaluate the candidates for each repeated sequence on
+// multiple threads. This requires the target's getOutliningCandidateInfo to
+// only modify the candidates it is given.
+static cl::opt<bool> ParallelCandidateSearch(
+    "machine-outliner-parallel-search", cl::Hidden,
+    cl::desc("Evaluate outlining candidates on multiple threads"),
+    cl::init(false));
+
 namespace {
 
 /// Represents an undefined index in the suffix tree.
@@ -1011,6 +1020,8 @@ MachineOutliner::findCandidates(InstructionMapper &Mapper,
 
   // First, find dall of the repeated substrings in the tree of minimum length
   // 2.
+  std::vector<std::vector<Candidate>> RepeatedSeqs;
+  std::vector<unsigned> RepeatedSeqLens;
   std::vector<Candidate> CandidatesForRepeatedSeq;
   for (auto It = ST.begin(), Et = ST.end(); It != Et; ++It) {
     CandidatesForRepeatedSeq.clear();
@@ -1052,25 +1063,43 @@ MachineOutliner::findCandidates(InstructionMapper &Mapper,
         MachineBasicBlock::iterator EndIt = Mapper.InstrList[EndIdx];
         MachineBasicBlock *MBB = StartIt->getParent();
 
+        // The index of the OutlinedFunction is set once it is known to be
+        // beneficial.
         CandidatesForRepeatedSeq.emplace_back(StartIdx, StringLen, StartIt,
-                                              EndIt, MBB, FunctionList.size(),
+                                              EndIt, MBB, /*FunctionIdx=*/0,
                                               Mapper.MBBFlagsMap[MBB]);
       }
     }
 
     // We've found something we might want to outline.
-    // Create an OutlinedFunction to store it and check if it'd be beneficial
-    // to outline.
     if (CandidatesForRepeatedSeq.size() < 2)
       continue;
+    RepeatedSeqs.push_back(CandidatesForRepeatedSeq);
+    RepeatedSeqLens.push_back(StringLen);
+  }
 
+  // Create an OutlinedFunction for each repeated sequence to check if it'd be
+  // beneficial to outline. The sequences are independent of each other, so
+  // this can be done in parallel.
+  std::vector<OutlinedFunction> OutlinedFunctions(RepeatedSeqs.size());
+  auto ComputeOutlinedFunction = [&](size_t I) {
     // Arbitrarily choose a TII from the first candidate.
     // FIXME: Should getOutliningCandidateInfo move to TargetMachine?
     const TargetInstrInfo *TII =
-        CandidatesForRepeatedSeq[0].getMF()->getSubtarget().getInstrInfo();
-
-    OutlinedFunction OF =
-        TII->getOutliningCandidateInfo(CandidatesForRepeatedSeq);
+        RepeatedSeqs[I][0].getMF()->getSubtarget().getInstrInfo();
+    OutlinedFunctions[I] = TII->getOutliningCandidateInfo(RepeatedSeqs[I]);
+  };
+  if (ParallelCandidateSearch)
+    parallel::for_each_n(parallel::par, size_t(0), RepeatedSeqs.size(),
+                         ComputeOutlinedFunction);
+  else
+    for (size_t I = 0, E = RepeatedSeqs.size(); I != E; ++I)
+      ComputeOutlinedFunction(I);
+
+  // Filter the sequences in the order they were found, so that the result
+  // doesn't depend on the number of threads.
+  for (size_t I = 0, E = RepeatedSeqs.size(); I != E; ++I) {
+    OutlinedFunction &OF = OutlinedFunctions[I];
 
     // If we deleted too many candidates, then there's nothing worth outlining.
     // FIXME: This should take target-specified instruction sizes into account.
@@ -1079,11 +1108,13 @@ MachineOutliner::findCandidates(InstructionMapper &Mapper,
 
     // Is it better to outline this candidate than not?
     if (OF.getBenefit() < 1) {
-      emitNotOutliningCheaperRemark(StringLen, CandidatesForRepeatedSeq, OF);
+      emitNotOutliningCheaperRemark(RepeatedSeqLens[I], RepeatedSeqs[I], OF);
       continue;
     }
 
-    FunctionList.push_back(OF);
+    for (Candidate &C : OF.Candidates)
+      C.FunctionIdx = FunctionList.size();
+    FunctionList.push_back(std::move(OF));
   }
 }
 
@@ -15,9 +15,11 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/PriorityQueue.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/CodeGen/LiveInterval.h"
@@ -72,6 +74,9 @@ using namespace llvm;
 
 #define DEBUG_TYPE "machine-scheduler"
 
+STATISTIC(NumSplitSchedRegions,
+          "Number of scheduling regions split for being too large");
+
 namespace llvm {
 
 cl::opt<bool> ForceTopDown("misched-topdown", cl::Hidden,
@@ -112,6 +117,18 @@ static const bool PrintDAGs = false;
 static cl::opt<unsigned> ReadyListLimit("misched-limit", cl::Hidden,
   cl::desc("Limit ready list to N instructions"), cl::init(256));
 
+/// Avoid the quadratic cost of building the DAG for huge basic blocks by
+/// splitting scheduling regions larger than this.
+static cl::opt<unsigned> MaxRegionSize("misched-max-region-size", cl::Hidden,
+  cl::desc("Split scheduling regions with more than N instructions "
+           "(0 = unlimited)"), cl::init(8192));
+
+static cl::opt<unsigned> RegionSplitWindow("misched-region-split-window",
+  cl::Hidden,
+  cl::desc("Number of instructions at the top of an oversized region among "
+           "which the split point with the fewest live values is chosen"),
+  cl::init(256));
+
 static cl::opt<bool> EnableRegPressure("misched-regpressure", cl::Hidden,
   cl::desc("Enable register pressure scheduling."), cl::init(true));
 
@@ -482,15 +499,53 @@ getSchedRegions(MachineBasicBlock *MBB,
     // instruction stream until we find the nearest boundary.
     unsigned NumRegionInstrs = 0;
     I = RegionEnd;
+
+    // When the region grows beyond MaxRegionSize, an instruction near its top
+    // is turned into an artificial boundary. Among the last RegionSplitWindow
+    // candidates, the one with the fewest registers that are used below it
+    // but defined above it is chosen, so that few dependencies are cut.
+    bool MaySplit = MaxRegionSize && MBB->size() > MaxRegionSize;
+    unsigned SplitWindow = std::min<unsigned>(RegionSplitWindow, MaxRegionSize);
+    DenseSet<unsigned> LiveIn;
+    MachineBasicBlock::iterator BestSplit;
+    unsigned BestSplitCost = ~0u;
+    unsigned NumInstrsBelowBestSplit = 0;
+
     for (;I != MBB->begin(); --I) {
       MachineInstr &MI = *std::prev(I);
       if (isSchedBoundary(&MI, &*MBB, MF, TII))
         break;
-      if (!MI.isDebugInstr()) {
-        // MBB::size() uses instr_iterator to count. Here we need a bundle to
-        // count as a single instruction.
-        ++NumRegionInstrs;
+      if (MI.isDebugInstr())
+        continue;
+
+      if (MaySplit) {
+        if (NumRegionInstrs >= MaxRegionSize - SplitWindow &&
+            LiveIn.size() <= BestSplitCost) {
+          BestSplit = std::prev(I);
+          BestSplitCost = LiveIn.size();
+          NumInstrsBelowBestSplit = NumRegionInstrs;
+        }
+        if (NumRegionInstrs == MaxRegionSize) {
+          LLVM_DEBUG(dbgs() << "Splitting scheduling region in "
+                            << printMBBReference(*MBB) << " at " << *BestSplit
+                            << "  with " << BestSplitCost
+                            << " live values\n");
+          ++NumSplitSchedRegions;
+          I = std::next(BestSplit);
+          NumRegionInstrs = NumInstrsBelowBestSplit;
+          break;
+        }
+        for (const MachineOperand &MO : MI.operands())
+          if (MO.isReg() && MO.getReg() && MO.isDef())
+            LiveIn.erase(MO.getReg());
+        for (const MachineOperand &MO : MI.operands())
+          if (MO.isReg() && MO.getReg() && MO.readsReg())
+            LiveIn.insert(MO.getReg());
       }
+
+      // MBB::size() uses instr_iterator to count. Here we need a bundle to
+      // count as a single instruction.
+      ++NumRegionInstrs;
     }
 
     // It's possible we found a scheduling region that only has debug
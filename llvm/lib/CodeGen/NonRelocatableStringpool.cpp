@@ -1,4 +1,4 @@
-//===- NonRelocatableStringpool.cpp - A simple stringpool  ----------------===//
+//===- NonRelocatableStringpool.cpp - A simple stringpool -----------------===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,10 +6,10 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "NonRelocatableStringpool.h"
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
+#include "llvm/Support/DJB.h"
 
 namespace llvm {
-namespace dsymutil {
 
 DwarfStringPoolEntryRef NonRelocatableStringpool::getEntry(StringRef S) {
   if (S.empty() && !Strings.empty())
@@ -38,6 +38,14 @@ StringRef NonRelocatableStringpool::internString(StringRef S) {
   return InsertResult.first->getKey();
 }
 
+StringRef UniquingStringPool::internString(StringRef S) {
+  // Use the high bits of the hash, the StringMap already buckets on the low
+  // ones.
+  Shard &Owner = Shards[(djbHash(S) >> 27) % NumShards];
+  std::lock_guard<std::mutex> Lock(Owner.Mutex);
+  return Owner.Strings.try_emplace(S, 0).first->getKey();
+}
+
 std::vector<DwarfStringPoolEntryRef>
 NonRelocatableStringpool::getEntriesForEmission() const {
   std::vector<DwarfStringPoolEntryRef> Result;
@@ -52,5 +60,4 @@ NonRelocatableStringpool::getEntriesForEmission() const {
   return Result;
 }
 
-} // namespace dsymutil
 } // namespace llvm
@@ -84,6 +84,9 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumHugeFunctions, "Number of functions allocated in huge mode");
+STATISTIC(NumEvictChainCutoffs,
+          "Number of evictions skipped because of the eviction chain limit");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -130,6 +133,18 @@ static cl::opt<unsigned>
                               "high compile time cost in global splitting."),
                      cl::init(5000));
 
+static cl::opt<unsigned> HugeFunctionVRegs(
+    "regalloc-huge-function-vregs", cl::Hidden,
+    cl::desc("Number of virtual registers above which a function is "
+             "allocated with cheaper splitting and eviction heuristics "
+             "(0 = disable, the default)"),
+    cl::init(0));
+
+static cl::opt<unsigned> HugeFunctionMaxEvictionDepth(
+    "regalloc-huge-function-max-eviction-depth", cl::Hidden,
+    cl::desc("Maximum length of an eviction chain in a huge function"),
+    cl::init(4));
+
 // FIXME: Find a good default for this flag and remove the flag.
 static cl::opt<unsigned>
 CSRFirstTimeCost("regalloc-csr-first-time-cost",
@@ -247,6 +262,10 @@ class RAGreedy : public MachineFunctionPass,
     // Cascade - Eviction loop prevention. See canEvictInterference().
     unsigned Cascade = 0;
 
+    // EvictDepth - Number of evictions that led to this live range being
+    // evicted. Only used to cap eviction chains in huge functions.
+    unsigned EvictDepth = 0;
+
     RegInfo() = default;
   };
 
@@ -408,6 +427,13 @@ class RAGreedy : public MachineFunctionPass,
   /// by a split candidate when choosing the best split candidate.
   bool EnableAdvancedRASplitCost;
 
+  /// True if the function has so many virtual registers that region splitting
+  /// and long eviction chains would make the compile time explode.
+  bool IsHugeFunction;
+
+  /// Number of evictions skipped because of HugeFunctionMaxEvictionDepth.
+  unsigned NumEvictChainCutoffsInFunction;
+
   /// Set of broken hints that may be reconciled later because of eviction.
   SmallSetVector<LiveInterval *, 8> SetOfBrokenHints;
 
@@ -553,6 +579,9 @@ private:
                                    FoldedSpills);
     }
   }
+
+  /// Explain why a huge function was allocated with cheaper heuristics.
+  void reportHugeFunction();
 };
 
 } // end anonymous namespace
@@ -1084,6 +1113,8 @@ void RAGreedy::evictInterference(LiveInterval &VirtReg, unsigned PhysReg,
             VirtReg.isSpillable() < Intf->isSpillable()) &&
            "Cannot decrease cascade number, illegal eviction");
     ExtraRegInfo[Intf->reg].Cascade = Cascade;
+    ExtraRegInfo[Intf->reg].EvictDepth =
+        ExtraRegInfo[VirtReg.reg].EvictDepth + 1;
     ++NumEvicted;
     NewVRegs.push_back(Intf->reg);
   }
@@ -1111,6 +1142,16 @@ unsigned RAGreedy::tryEvict(LiveInterval &VirtReg,
   NamedRegionTimer T("evict", "Evict", TimerGroupName, TimerGroupDescription,
                      TimePassesIsEnabled);
 
+  // In huge functions, don't let a spillable range that was itself evicted
+  // continue the chain indefinitely. Unspillable ranges must still be able to
+  // evict, or they may not get a register at all.
+  if (IsHugeFunction && VirtReg.isSpillable() &&
+      ExtraRegInfo[VirtReg.reg].EvictDepth >= HugeFunctionMaxEvictionDepth) {
+    ++NumEvictChainCutoffs;
+    ++NumEvictChainCutoffsInFunction;
+    return 0;
+  }
+
   // Keep track of the cheapest interference seen so far.
   EvictionCost BestCost;
   BestCost.setMax();
@@ -2493,8 +2534,9 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
 
   // First try to split around a region spanning multiple blocks. RS_Split2
   // ranges already made dubious progress with region splitting, so they go
-  // straight to single block splitting.
-  if (getStage(VirtReg) < RS_Split2) {
+  // straight to single block splitting. Region splitting is skipped entirely
+  // in huge functions, where its cost grows with the number of bundles.
+  if (getStage(VirtReg) < RS_Split2 && !IsHugeFunction) {
     unsigned PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
     if (PhysReg || !NewVRegs.empty())
       return PhysReg;
@@ -3207,6 +3249,26 @@ void RAGreedy::reportNumberOfSplillsReloads(MachineLoop *L, unsigned &Reloads,
   }
 }
 
+void RAGreedy::reportHugeFunction() {
+  using namespace ore;
+
+  ORE->emit([&]() {
+    const MachineBasicBlock &Entry = MF->front();
+    MachineOptimizationRemarkAnalysis R(
+        DEBUG_TYPE, "HugeFunction",
+        DiagnosticLocation(MF->getFunction().getSubprogram()), &Entry);
+    R << "function has more than "
+      << NV("NumVirtRegs", unsigned(HugeFunctionVRegs))
+      << " virtual registers; region splitting and local reassignment were "
+         "disabled and eviction chains were limited to "
+      << NV("MaxEvictionDepth", unsigned(HugeFunctionMaxEvictionDepth));
+    if (NumEvictChainCutoffsInFunction)
+      R << " (" << NV("NumEvictChainCutoffs", NumEvictChainCutoffsInFunction)
+        << " evictions skipped)";
+    return R;
+  });
+}
+
 bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   LLVM_DEBUG(dbgs() << "********** GREEDY REGISTER ALLOCATION **********\n"
                     << "********** Function: " << mf.getName() << '\n');
@@ -3223,6 +3285,16 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   EnableAdvancedRASplitCost = ConsiderLocalIntervalCost ||
                               MF->getSubtarget().enableAdvancedRASplitCost();
 
+  IsHugeFunction = HugeFunctionVRegs &&
+                   mf.getRegInfo().getNumVirtRegs() > HugeFunctionVRegs;
+  NumEvictChainCutoffsInFunction = 0;
+  if (IsHugeFunction) {
+    LLVM_DEBUG(dbgs() << "Huge function, using cheaper heuristics\n");
+    ++NumHugeFunctions;
+    EnableLocalReassign = false;
+    EnableAdvancedRASplitCost = false;
+  }
+
   if (VerifyEnabled)
     MF->verify(this, "Before greedy register allocator");
 
@@ -3260,6 +3332,8 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   tryHintsRecoloring();
   postOptimization();
   reportNumberOfSplillsReloads();
+  if (IsHugeFunction)
+    reportHugeFunction();
 
   releaseMemory();
   return true;
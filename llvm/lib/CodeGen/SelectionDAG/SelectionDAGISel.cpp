@@ -86,6 +86,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/MachineValueType.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetIntrinsicInfo.h"
@@ -97,6 +98,7 @@
 #include <cstdint>
 #include <iterator>
 #include <limits>
+#include <numeric>
 #include <memory>
 #include <string>
 #include <utility>
@@ -128,6 +130,18 @@ static cl::opt<bool> EnableFastISelFallbackReport(
     cl::desc("Emit a diagnostic when \"fast\" instruction selection "
              "falls back to SelectionDAG."));
 
+static cl::opt<bool> FastISelTrivialBlocks(
+    "fast-isel-trivial-blocks", cl::Hidden,
+    cl::desc("When optimizing, select the blocks that only contain simple "
+             "scalar instructions with \"fast\" instruction selection"),
+    cl::init(false));
+
+static cl::opt<unsigned> ReportExpensiveBlocks(
+    "isel-report-expensive-blocks", cl::Hidden,
+    cl::desc("Emit a remark with the time of each SelectionDAG phase for the "
+             "N blocks of each function that took the longest to select"),
+    cl::init(0));
+
 static cl::opt<bool>
 UseMBPI("use-mbpi",
         cl::desc("use Machine Branch Probability Info"),
@@ -710,6 +724,78 @@ static void reportFastISelFailure(MachineFunction &MF,
   ORE.emit(R);
 }
 
+namespace {
+
+/// Time one phase of selecting a DAG: in the "sdag" timer group with
+/// -time-passes, as a time trace event with -ftime-trace, and into \p Accum
+/// for -isel-report-expensive-blocks.
+class ISelPhaseTimer {
+  NamedRegionTimer T;
+  TimeTraceScope Trace;
+  double *Accum;
+  double Start = 0;
+
+public:
+  ISelPhaseTimer(StringRef Name, StringRef Description,
+                 const MachineBasicBlock *MBB, double *Accum)
+      : T(Name, Description, "sdag", "Instruction Selection and Scheduling",
+          TimePassesIsEnabled),
+        Trace(Description, MBB->getBasicBlock()->getName()), Accum(Accum) {
+    if (Accum)
+      Start = TimeRecord::getCurrentTime(true).getWallTime();
+  }
+
+  ~ISelPhaseTimer() {
+    if (Accum)
+      *Accum += TimeRecord::getCurrentTime(false).getWallTime() - Start;
+  }
+};
+
+} // end anonymous namespace
+
+double *SelectionDAGISel::getPhaseTimeAccumulator(ISelPhase P) {
+  if (BlockISelTimes.empty())
+    return nullptr;
+  return &BlockISelTimes.back().Phases[P];
+}
+
+void SelectionDAGISel::reportExpensiveBlocks(const Function &Fn) {
+  static const char *const PhaseNames[ISP_NumPhases] = {
+      "Build", "Combine1", "LegalizeTypes", "Legalize",
+      "Combine2", "Select", "Schedule"};
+  auto TotalTime = [](const BlockISelTime &T) {
+    return std::accumulate(std::begin(T.Phases), std::end(T.Phases), 0.0);
+  };
+  auto InMicroseconds = [](double Seconds) {
+    return static_cast<unsigned long long>(Seconds * 1e6);
+  };
+
+  size_t NumReported =
+      std::min<size_t>(ReportExpensiveBlocks, BlockISelTimes.size());
+  std::partial_sort(BlockISelTimes.begin(),
+                    BlockISelTimes.begin() + NumReported, BlockISelTimes.end(),
+                    [&](const BlockISelTime &A, const BlockISelTime &B) {
+                      return TotalTime(A) > TotalTime(B);
+                    });
+
+  for (const BlockISelTime &T :
+       makeArrayRef(BlockISelTimes).take_front(NumReported)) {
+    OptimizationRemarkAnalysis R("sdagisel", "ExpensiveBlock",
+                                 T.BB->getTerminator()->getDebugLoc(), T.BB);
+    R << "selecting block took "
+      << ore::NV("TotalTime", InMicroseconds(TotalTime(T))) << "us (";
+    for (unsigned P = 0; P != ISP_NumPhases; ++P) {
+      if (P)
+        R << ", ";
+      R << PhaseNames[P] << ": "
+        << ore::NV(PhaseNames[P], InMicroseconds(T.Phases[P])) << "us";
+    }
+    R << ")";
+    ORE->emit(R);
+  }
+  BlockISelTimes.clear();
+}
+
 void SelectionDAGISel::SelectBasicBlock(BasicBlock::const_iterator Begin,
                                         BasicBlock::const_iterator End,
                                         bool &HadTailCall) {
@@ -718,9 +804,14 @@ void SelectionDAGISel::SelectBasicBlock(BasicBlock::const_iterator Begin,
 
   // Lower the instructions. If a call is emitted as a tail call, cease emitting
   // nodes for this block.
-  for (BasicBlock::const_iterator I = Begin; I != End && !SDB->HasTailCall; ++I) {
-    if (!ElidedArgCopyInstrs.count(&*I))
-      SDB->visit(*I);
+  {
+    ISelPhaseTimer T("build", "DAG Building", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Build));
+    for (BasicBlock::const_iterator I = Begin; I != End && !SDB->HasTailCall;
+         ++I) {
+      if (!ElidedArgCopyInstrs.count(&*I))
+        SDB->visit(*I);
+    }
   }
 
   // Make sure the root of the DAG is up-to-date.
@@ -774,8 +865,6 @@ void SelectionDAGISel::ComputeLiveOutVRegInfo() {
 }
 
 void SelectionDAGISel::CodeGenAndEmitDAG() {
-  StringRef GroupName = "sdag";
-  StringRef GroupDescription = "Instruction Selection and Scheduling";
   std::string BlockName;
   bool MatchFilterBB = false; (void)MatchFilterBB;
 #ifndef NDEBUG
@@ -810,8 +899,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
   // Run the DAG combiner in pre-legalize mode.
   {
-    NamedRegionTimer T("combine1", "DAG Combining 1", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("combine1", "DAG Combining 1", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Combine1));
     CurDAG->Combine(BeforeLegalizeTypes, AA, OptLevel);
   }
 
@@ -832,8 +921,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
   bool Changed;
   {
-    NamedRegionTimer T("legalize_types", "Type Legalization", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("legalize_types", "Type Legalization", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_LegalizeTypes));
     Changed = CurDAG->LegalizeTypes();
   }
 
@@ -856,8 +945,9 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
     // Run the DAG combiner in post-type-legalize mode.
     {
-      NamedRegionTimer T("combine_lt", "DAG Combining after legalize types",
-                         GroupName, GroupDescription, TimePassesIsEnabled);
+      ISelPhaseTimer T("combine_lt", "DAG Combining after legalize types",
+                       FuncInfo->MBB,
+                       getPhaseTimeAccumulator(ISP_LegalizeTypes));
       CurDAG->Combine(AfterLegalizeTypes, AA, OptLevel);
     }
 
@@ -873,8 +963,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   }
 
   {
-    NamedRegionTimer T("legalize_vec", "Vector Legalization", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("legalize_vec", "Vector Legalization", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Legalize));
     Changed = CurDAG->LegalizeVectors();
   }
 
@@ -885,8 +975,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
                CurDAG->dump());
 
     {
-      NamedRegionTimer T("legalize_types2", "Type Legalization 2", GroupName,
-                         GroupDescription, TimePassesIsEnabled);
+      ISelPhaseTimer T("legalize_types2", "Type Legalization 2", FuncInfo->MBB,
+                       getPhaseTimeAccumulator(ISP_LegalizeTypes));
       CurDAG->LegalizeTypes();
     }
 
@@ -900,8 +990,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
     // Run the DAG combiner in post-type-legalize mode.
     {
-      NamedRegionTimer T("combine_lv", "DAG Combining after legalize vectors",
-                         GroupName, GroupDescription, TimePassesIsEnabled);
+      ISelPhaseTimer T("combine_lv", "DAG Combining after legalize vectors",
+                       FuncInfo->MBB, getPhaseTimeAccumulator(ISP_Legalize));
       CurDAG->Combine(AfterLegalizeVectorOps, AA, OptLevel);
     }
 
@@ -920,8 +1010,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     CurDAG->viewGraph("legalize input for " + BlockName);
 
   {
-    NamedRegionTimer T("legalize", "DAG Legalization", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("legalize", "DAG Legalization", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Legalize));
     CurDAG->Legalize();
   }
 
@@ -940,8 +1030,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
   // Run the DAG combiner in post-legalize mode.
   {
-    NamedRegionTimer T("combine2", "DAG Combining 2", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("combine2", "DAG Combining 2", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Combine2));
     CurDAG->Combine(AfterLegalizeDAG, AA, OptLevel);
   }
 
@@ -964,8 +1054,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // Third, instruction select all of the operations to machine code, adding the
   // code to the MachineBasicBlock.
   {
-    NamedRegionTimer T("isel", "Instruction Selection", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("isel", "Instruction Selection", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Select));
     DoInstructionSelection();
   }
 
@@ -980,8 +1070,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // Schedule machine code.
   ScheduleDAGSDNodes *Scheduler = CreateScheduler();
   {
-    NamedRegionTimer T("sched", "Instruction Scheduling", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("sched", "Instruction Scheduling", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Schedule));
     Scheduler->Run(CurDAG, FuncInfo->MBB);
   }
 
@@ -992,8 +1082,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // inserted into.
   MachineBasicBlock *FirstMBB = FuncInfo->MBB, *LastMBB;
   {
-    NamedRegionTimer T("emit", "Instruction Creation", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("emit", "Instruction Creation", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Schedule));
 
     // FuncInfo->InsertPt is passed by reference and set to the end of the
     // scheduled instructions.
@@ -1007,8 +1097,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
 
   // Free the scheduler state.
   {
-    NamedRegionTimer T("cleanup", "Instruction Scheduling Cleanup", GroupName,
-                       GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer T("cleanup", "Instruction Scheduling Cleanup", FuncInfo->MBB,
+                     getPhaseTimeAccumulator(ISP_Schedule));
     delete Scheduler;
   }
 
@@ -1332,15 +1422,67 @@ static void processDbgDeclares(FunctionLoweringInfo *FuncInfo) {
   }
 }
 
+/// Return true if \p BB only contains simple scalar instructions, for which
+/// FastISel is expected to produce about the same code as SelectionDAG.
+static bool isTriviallyFastISelable(const BasicBlock &BB) {
+  if (BB.isEHPad())
+    return false;
+
+  auto IsSimpleType = [](Type *Ty) {
+    return Ty->isVoidTy() || Ty->isPointerTy() || Ty->isFloatTy() ||
+           Ty->isDoubleTy() ||
+           (Ty->isIntegerTy() && Ty->getIntegerBitWidth() <= 64);
+  };
+
+  for (const Instruction &I : BB) {
+    if (isa<DbgInfoIntrinsic>(I))
+      continue;
+    if (!IsSimpleType(I.getType()))
+      return false;
+    for (const Value *Op : I.operands())
+      if (!isa<BasicBlock>(Op) && !IsSimpleType(Op->getType()))
+        return false;
+
+    if (const auto *LI = dyn_cast<LoadInst>(&I)) {
+      if (!LI->isSimple())
+        return false;
+    } else if (const auto *SI = dyn_cast<StoreInst>(&I)) {
+      if (!SI->isSimple())
+        return false;
+    } else if (!isa<PHINode>(I) && !isa<BinaryOperator>(I) &&
+               !isa<CmpInst>(I) && !isa<CastInst>(I) &&
+               !isa<GetElementPtrInst>(I) && !isa<SelectInst>(I) &&
+               !isa<BranchInst>(I) && !isa<ReturnInst>(I)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
   FastISelFailed = false;
   // Initialize the Fast-ISel state, if needed.
   FastISel *FastIS = nullptr;
+  // When optimizing with -fast-isel-trivial-blocks, FastISel only selects the
+  // blocks accepted by isTriviallyFastISelable. The arguments and all other
+  // blocks go through SelectionDAG.
+  bool FastISelTrivialBlocksOnly = false;
   if (TM.Options.EnableFastISel) {
     LLVM_DEBUG(dbgs() << "Enabling fast-isel\n");
     FastIS = TLI->createFastISel(*FuncInfo, LibInfo);
+  } else if (FastISelTrivialBlocks && OptLevel != CodeGenOpt::None) {
+    LLVM_DEBUG(dbgs() << "Enabling fast-isel for trivial blocks\n");
+    FastIS = TLI->createFastISel(*FuncInfo, LibInfo);
+    FastISelTrivialBlocksOnly = FastIS != nullptr;
   }
 
+  BlockISelTimes.clear();
+  auto StartBlockTimes = [&](const BasicBlock *BB) {
+    if (ReportExpensiveBlocks &&
+        (BlockISelTimes.empty() || BlockISelTimes.back().BB != BB))
+      BlockISelTimes.push_back({BB, {}});
+  };
+
   ReversePostOrderTraversal<const Function*> RPOT(&Fn);
 
   // Lower arguments up front. An RPO iteration always visits the entry block
@@ -1353,8 +1495,9 @@ void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
   FuncInfo->InsertPt = FuncInfo->MBB->begin();
 
   CurDAG->setFunctionLoweringInfo(FuncInfo);
+  StartBlockTimes(&Fn.getEntryBlock());
 
-  if (!FastIS) {
+  if (!FastIS || FastISelTrivialBlocksOnly) {
     LowerArguments(Fn);
   } else {
     // See if fast isel can lower the arguments.
@@ -1437,8 +1580,15 @@ void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
       if (!PrepareEHLandingPad())
         continue;
 
+    StartBlockTimes(LLVMBB);
+
+    bool UseFastISel =
+        FastIS && (!FastISelTrivialBlocksOnly ||
+                   (LLVMBB != &Fn.getEntryBlock() &&
+                    isTriviallyFastISelable(*LLVMBB)));
+
     // Before doing SelectionDAG ISel, see if FastISel has been requested.
-    if (FastIS) {
+    if (UseFastISel) {
       if (LLVMBB != &Fn.getEntryBlock())
         FastIS->startNewBlock();
 
@@ -1592,7 +1742,7 @@ void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
         FastIS->removeDeadCode(FuncInfo->InsertPt, FuncInfo->MBB->end());
     }
 
-    if (FastIS)
+    if (UseFastISel)
       FastIS->finishBasicBlock();
     FinishBasicBlock();
     FuncInfo->PHINodesToUpdate.clear();
@@ -1604,6 +1754,8 @@ void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
   SwiftError->propagateVRegs();
 
   delete FastIS;
+  if (ReportExpensiveBlocks)
+    reportExpensiveBlocks(Fn);
   SDB->clearDanglingDebugInfo();
   SDB->SPDescriptor.resetPerFunctionState();
 }
@@ -2479,18 +2631,27 @@ CheckChildSame(const unsigned char *MatcherTable, unsigned &MatcherIndex,
                      RecordedNodes);
 }
 
-/// CheckPatternPredicate - Implements OP_CheckPatternPredicate.
+/// CheckPatternPredicate - Implements OP_CheckPatternPredicate and its
+/// compressed forms.
 LLVM_ATTRIBUTE_ALWAYS_INLINE static inline bool
-CheckPatternPredicate(const unsigned char *MatcherTable, unsigned &MatcherIndex,
-                      const SelectionDAGISel &SDISel) {
-  return SDISel.CheckPatternPredicate(MatcherTable[MatcherIndex++]);
+CheckPatternPredicate(unsigned Opcode, const unsigned char *MatcherTable,
+                      unsigned &MatcherIndex, const SelectionDAGISel &SDISel) {
+  unsigned PredNo = Opcode == SelectionDAGISel::OPC_CheckPatternPredicate
+                        ? MatcherTable[MatcherIndex++]
+                        : Opcode - SelectionDAGISel::OPC_CheckPatternPredicate0;
+  return SDISel.CheckPatternPredicate(PredNo);
 }
 
-/// CheckNodePredicate - Implements OP_CheckNodePredicate.
+/// CheckNodePredicate - Implements OP_CheckNodePredicate and its compressed
+/// forms.
 LLVM_ATTRIBUTE_ALWAYS_INLINE static inline bool
-CheckNodePredicate(const unsigned char *MatcherTable, unsigned &MatcherIndex,
-                   const SelectionDAGISel &SDISel, SDNode *N) {
-  return SDISel.CheckNodePredicate(N, MatcherTable[MatcherIndex++]);
+CheckNodePredicate(unsigned Opcode, const unsigned char *MatcherTable,
+                   unsigned &MatcherIndex, const SelectionDAGISel &SDISel,
+                   SDNode *N) {
+  unsigned PredNo = Opcode == SelectionDAGISel::OPC_CheckPredicate
+                        ? MatcherTable[MatcherIndex++]
+                        : Opcode - SelectionDAGISel::OPC_CheckPredicate0;
+  return SDISel.CheckNodePredicate(N, PredNo);
 }
 
 LLVM_ATTRIBUTE_ALWAYS_INLINE static inline bool
@@ -2618,10 +2779,27 @@ static unsigned IsPredicateKnownToFail(const unsigned char *Table,
                         Table[Index-1] - SelectionDAGISel::OPC_CheckChild0Same);
     return Index;
   case SelectionDAGISel::OPC_CheckPatternPredicate:
-    Result = !::CheckPatternPredicate(Table, Index, SDISel);
+  case SelectionDAGISel::OPC_CheckPatternPredicate0:
+  case SelectionDAGISel::OPC_CheckPatternPredicate1:
+  case SelectionDAGISel::OPC_CheckPatternPredicate2:
+  case SelectionDAGISel::OPC_CheckPatternPredicate3:
+  case SelectionDAGISel::OPC_CheckPatternPredicate4:
+  case SelectionDAGISel::OPC_CheckPatternPredicate5:
+  case SelectionDAGISel::OPC_CheckPatternPredicate6:
+  case SelectionDAGISel::OPC_CheckPatternPredicate7:
+    Result = !::CheckPatternPredicate(Table[Index-1], Table, Index, SDISel);
     return Index;
   case SelectionDAGISel::OPC_CheckPredicate:
-    Result = !::CheckNodePredicate(Table, Index, SDISel, N.getNode());
+  case SelectionDAGISel::OPC_CheckPredicate0:
+  case SelectionDAGISel::OPC_CheckPredicate1:
+  case SelectionDAGISel::OPC_CheckPredicate2:
+  case SelectionDAGISel::OPC_CheckPredicate3:
+  case SelectionDAGISel::OPC_CheckPredicate4:
+  case SelectionDAGISel::OPC_CheckPredicate5:
+  case SelectionDAGISel::OPC_CheckPredicate6:
+  case SelectionDAGISel::OPC_CheckPredicate7:
+    Result = !::CheckNodePredicate(Table[Index-1], Table, Index, SDISel,
+                                   N.getNode());
     return Index;
   case SelectionDAGISel::OPC_CheckOpcode:
     Result = !::CheckOpcode(Table, Index, N.getNode());
@@ -3012,10 +3190,19 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
       continue;
 
     case OPC_CheckPatternPredicate:
-      if (!::CheckPatternPredicate(MatcherTable, MatcherIndex, *this)) break;
+    case OPC_CheckPatternPredicate0: case OPC_CheckPatternPredicate1:
+    case OPC_CheckPatternPredicate2: case OPC_CheckPatternPredicate3:
+    case OPC_CheckPatternPredicate4: case OPC_CheckPatternPredicate5:
+    case OPC_CheckPatternPredicate6: case OPC_CheckPatternPredicate7:
+      if (!::CheckPatternPredicate(Opcode, MatcherTable, MatcherIndex, *this))
+        break;
       continue;
     case OPC_CheckPredicate:
-      if (!::CheckNodePredicate(MatcherTable, MatcherIndex, *this,
+    case OPC_CheckPredicate0: case OPC_CheckPredicate1:
+    case OPC_CheckPredicate2: case OPC_CheckPredicate3:
+    case OPC_CheckPredicate4: case OPC_CheckPredicate5:
+    case OPC_CheckPredicate6: case OPC_CheckPredicate7:
+      if (!::CheckNodePredicate(Opcode, MatcherTable, MatcherIndex, *this,
                                 N.getNode()))
         break;
       continue;
@@ -3359,18 +3546,38 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
 
     case OPC_EmitNode:     case OPC_MorphNodeTo:
     case OPC_EmitNode0:    case OPC_EmitNode1:    case OPC_EmitNode2:
-    case OPC_MorphNodeTo0: case OPC_MorphNodeTo1: case OPC_MorphNodeTo2: {
+    case OPC_EmitNode0None: case OPC_EmitNode1None: case OPC_EmitNode2None:
+    case OPC_MorphNodeTo0: case OPC_MorphNodeTo1: case OPC_MorphNodeTo2:
+    case OPC_MorphNodeTo0None: case OPC_MorphNodeTo1None:
+    case OPC_MorphNodeTo2None: case OPC_MorphNodeTo0ChainMemRefs:
+    case OPC_MorphNodeTo1ChainMemRefs: case OPC_MorphNodeTo2ChainMemRefs: {
       uint16_t TargetOpc = MatcherTable[MatcherIndex++];
       TargetOpc |= (unsigned short)MatcherTable[MatcherIndex++] << 8;
-      unsigned EmitNodeInfo = MatcherTable[MatcherIndex++];
+      // Get the flags, unless the opcode implies them.
+      unsigned EmitNodeInfo;
+      if ((Opcode >= OPC_EmitNode0None && Opcode <= OPC_EmitNode2None) ||
+          (Opcode >= OPC_MorphNodeTo0None && Opcode <= OPC_MorphNodeTo2None))
+        EmitNodeInfo = OPFL_None;
+      else if (Opcode >= OPC_MorphNodeTo0ChainMemRefs &&
+               Opcode <= OPC_MorphNodeTo2ChainMemRefs)
+        EmitNodeInfo = OPFL_Chain | OPFL_MemRefs;
+      else
+        EmitNodeInfo = MatcherTable[MatcherIndex++];
       // Get the result VT list.
       unsigned NumVTs;
       // If this is one of the compressed forms, get the number of VTs based
       // on the Opcode. Otherwise read the next byte from the table.
       if (Opcode >= OPC_MorphNodeTo0 && Opcode <= OPC_MorphNodeTo2)
         NumVTs = Opcode - OPC_MorphNodeTo0;
+      else if (Opcode >= OPC_MorphNodeTo0None && Opcode <= OPC_MorphNodeTo2None)
+        NumVTs = Opcode - OPC_MorphNodeTo0None;
+      else if (Opcode >= OPC_MorphNodeTo0ChainMemRefs &&
+               Opcode <= OPC_MorphNodeTo2ChainMemRefs)
+        NumVTs = Opcode - OPC_MorphNodeTo0ChainMemRefs;
       else if (Opcode >= OPC_EmitNode0 && Opcode <= OPC_EmitNode2)
         NumVTs = Opcode - OPC_EmitNode0;
+      else if (Opcode >= OPC_EmitNode0None && Opcode <= OPC_EmitNode2None)
+        NumVTs = Opcode - OPC_EmitNode0None;
       else
         NumVTs = MatcherTable[MatcherIndex++];
       SmallVector<EVT, 4> VTs;
@@ -3434,8 +3641,8 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
 
       // Create the node.
       MachineSDNode *Res = nullptr;
-      bool IsMorphNodeTo = Opcode == OPC_MorphNodeTo ||
-                     (Opcode >= OPC_MorphNodeTo0 && Opcode <= OPC_MorphNodeTo2);
+      bool IsMorphNodeTo = Opcode >= OPC_MorphNodeTo &&
+                           Opcode <= OPC_MorphNodeTo2ChainMemRefs;
       if (!IsMorphNodeTo) {
         // If this is a normal EmitNode command, just create the new node and
         // add the results to the RecordedNodes list.
@@ -13,10 +13,24 @@
 
 #include "llvm/CodeGen/MachineJumpTableInfo.h"
 #include "llvm/CodeGen/SwitchLoweringUtils.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
 
 using namespace llvm;
 using namespace SwitchCG;
 
+#define DEBUG_TYPE "switch-lowering"
+
+STATISTIC(NumJumpTables, "Number of jump tables built for switches");
+STATISTIC(NumBitTestClusters, "Number of bit test clusters built for switches");
+STATISTIC(NumJumpTableSearchesLimited,
+          "Number of switches whose jump table search was limited");
+
+static cl::opt<unsigned> JumpTableSearchLimit(
+    "jump-table-search-limit", cl::init(1024), cl::Hidden,
+    cl::desc("The maximum number of case clusters that the search for the "
+             "jump tables of a switch tries to put in one partition"));
+
 uint64_t SwitchCG::getJumpTableRange(const CaseClusterVector &Clusters,
                                      unsigned First, unsigned Last) {
   assert(Last >= First);
@@ -122,6 +136,14 @@ void SwitchCG::SwitchLowering::findJumpTables(CaseClusterVector &Clusters,
   LastElement[N - 1] = N - 1;
   PartitionsScore[N - 1] = PartitionScores::SingleCase;
 
+  // The search is quadratic in the number of clusters, so for huge switches
+  // it only tries partitions of up to JumpTableSearchLimit clusters. A
+  // partition the full search would find is then split into tables of at
+  // least that many clusters, which costs a range check per table.
+  const int64_t Limit = std::max(2u, (unsigned)JumpTableSearchLimit);
+  if (N > Limit)
+    ++NumJumpTableSearchesLimited;
+
   // Note: loop indexes are signed to avoid underflow.
   for (int64_t i = N - 2; i >= 0; i--) {
     // Find optimal partitioning of Clusters[i..N-1].
@@ -131,7 +153,7 @@ void SwitchCG::SwitchLowering::findJumpTables(CaseClusterVector &Clusters,
     PartitionsScore[i] = PartitionsScore[i + 1] + PartitionScores::SingleCase;
 
     // Search for a solution that results in fewer partitions.
-    for (int64_t j = N - 1; j > i; j--) {
+    for (int64_t j = std::min(N - 1, i + Limit - 1); j > i; j--) {
       // Try building a partition from Clusters[i..j].
       Range = getJumpTableRange(Clusters, i, j);
       NumCases = getJumpTableNumCases(TotalCases, i, j);
@@ -254,6 +276,7 @@ bool SwitchCG::SwitchLowering::buildJumpTable(const CaseClusterVector &Clusters,
 
   JTCluster = CaseCluster::jumpTable(Clusters[First].Low, Clusters[Last].High,
                                      JTCases.size() - 1, Prob);
+  ++NumJumpTables;
   return true;
 }
 
@@ -304,28 +327,38 @@ void SwitchCG::SwitchLowering::findBitTestClusters(CaseClusterVector &Clusters,
 
     // Search for a solution that results in fewer partitions.
     // Note: the search is limited by BitWidth, reducing time complexity.
-    for (int64_t j = std::min(N - 1, i + BitWidth - 1); j > i; --j) {
-      // Try building a partition from Clusters[i..j].
-
-      // Check the range.
-      if (!TLI->rangeFitsInWord(Clusters[i].Low->getValue(),
-                                Clusters[j].High->getValue(), *DL))
-        continue;
+    // The range of Clusters[i..j] and its destinations only grow with j, so
+    // the partitions are all suitable up to the last j whose range fits in a
+    // word if that one has at most 3 destinations and no jump table, and none
+    // are otherwise.
+    int64_t LastFit = std::min(N - 1, i + BitWidth - 1);
+    while (LastFit > i &&
+           !TLI->rangeFitsInWord(Clusters[i].Low->getValue(),
+                                 Clusters[LastFit].High->getValue(), *DL))
+      --LastFit;
+    if (LastFit == i)
+      continue;
 
-      // Check nbr of destinations and cluster types.
-      // FIXME: This works, but doesn't seem very efficient.
-      bool RangesOnly = true;
-      BitVector Dests(FuncInfo.MF->getNumBlockIDs());
-      for (int64_t k = i; k <= j; k++) {
-        if (Clusters[k].Kind != CC_Range) {
-          RangesOnly = false;
-          break;
-        }
-        Dests.set(Clusters[k].MBB->getNumber());
+    // Check nbr of destinations and cluster types.
+    SmallVector<const MachineBasicBlock *, 3> Dests;
+    bool Suitable = true;
+    for (int64_t k = i; k <= LastFit; k++) {
+      if (Clusters[k].Kind != CC_Range) {
+        Suitable = false;
+        break;
       }
-      if (!RangesOnly || Dests.count() > 3)
+      if (is_contained(Dests, Clusters[k].MBB))
+        continue;
+      if (Dests.size() == 3) {
+        Suitable = false;
         break;
+      }
+      Dests.push_back(Clusters[k].MBB);
+    }
+    if (!Suitable)
+      continue;
 
+    for (int64_t j = LastFit; j > i; --j) {
       // Check if it's a better partition.
       unsigned NumPartitions = 1 + (j == N - 1 ? 0 : MinPartitions[j + 1]);
       if (NumPartitions < MinPartitions[i]) {
@@ -453,6 +486,7 @@ bool SwitchCG::SwitchLowering::buildBitTests(CaseClusterVector &Clusters,
 
   BTCluster = CaseCluster::bitTests(Clusters[First].Low, Clusters[Last].High,
                                     BitTestCases.size() - 1, TotalProb);
+  ++NumBitTestClusters;
   return true;
 }
 
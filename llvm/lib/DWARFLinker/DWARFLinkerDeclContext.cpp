@@ -1,4 +1,4 @@
-//===- tools/dsymutil/DeclContext.cpp - Declaration context ---------------===//
+//===- DWARFLinkerDeclContext.cpp - Declaration context -------------------===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,16 +6,16 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "DeclContext.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
+#include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFDie.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
 
 namespace llvm {
-namespace dsymutil {
 
-/// Set the last DIE/CU a context was seen in and, possibly invalidate the
-/// context if it is ambiguous.
+/// Record that a context was seen in a CU and, possibly invalidate the context
+/// if it is ambiguous.
 ///
 /// In the current implementation, we don't handle overloaded functions well,
 /// because the argument types are not taken into account when computing the
@@ -27,18 +27,16 @@ namespace dsymutil {
 /// we are not able to distinguish.
 ///
 /// If a context that is not a namespace appears twice in the same CU, we know
-/// it is ambiguous. Make it invalid.
+/// it is ambiguous. Make it invalid. This is tracked by the CU rather than by
+/// the context, which is shared with the threads analyzing other objects.
 bool DeclContext::setLastSeenDIE(CompileUnit &U, const DWARFDie &Die) {
-  if (LastSeenCompileUnitID == U.getUniqueID()) {
-    DWARFUnit &OrigUnit = U.getOrigUnit();
-    uint32_t FirstIdx = OrigUnit.getDIEIndex(LastSeenDIE);
-    U.getInfo(FirstIdx).Ctxt = nullptr;
-    return false;
-  }
+  uint32_t Idx = U.getOrigUnit().getDIEIndex(Die);
+  uint32_t FirstIdx = U.noteDeclContext(this, Idx);
+  if (FirstIdx == Idx)
+    return true;
 
-  LastSeenCompileUnitID = U.getUniqueID();
-  LastSeenDIE = Die;
-  return true;
+  U.getInfo(FirstIdx).Ctxt = nullptr;
+  return false;
 }
 
 PointerIntPair<DeclContext *, 1> DeclContextTree::getChildDeclContext(
@@ -175,36 +173,39 @@ PointerIntPair<DeclContext *, 1> DeclContextTree::getChildDeclContext(
   if (Tag == dwarf::DW_TAG_namespace && NameRef == "(anonymous namespace)")
     Hash = hash_combine(Hash, FileRef);
 
-  // Now look if this context already exists.
+  // Now look if this context already exists. The shard is picked from the high
+  // bits of the hash, the DenseSet already buckets on the low ones.
   DeclContext Key(Hash, Line, ByteSize, Tag, NameRef, FileRef, Context);
-  auto ContextIter = Contexts.find(&Key);
-
-  if (ContextIter == Contexts.end()) {
-    // The context wasn't found.
-    bool Inserted;
-    DeclContext *NewContext =
-        new (Allocator) DeclContext(Hash, Line, ByteSize, Tag, NameRef, FileRef,
-                                    Context, DIE, U.getUniqueID());
-    std::tie(ContextIter, Inserted) = Contexts.insert(NewContext);
-    assert(Inserted && "Failed to insert DeclContext");
-    (void)Inserted;
-  } else if (Tag != dwarf::DW_TAG_namespace &&
-             !(*ContextIter)->setLastSeenDIE(U, DIE)) {
+  Shard &Owner = Shards[(Hash >> 26) % NumShards];
+  DeclContext *Found;
+  {
+    std::lock_guard<std::mutex> Lock(Owner.Mutex);
+    auto ContextIter = Owner.Contexts.find(&Key);
+    if (ContextIter == Owner.Contexts.end()) {
+      // The context wasn't found.
+      ContextIter =
+          Owner.Contexts
+              .insert(new (Owner.Allocator) DeclContext(
+                  Hash, Line, ByteSize, Tag, NameRef, FileRef, Context))
+              .first;
+    }
+    Found = *ContextIter;
+  }
+
+  if (Tag != dwarf::DW_TAG_namespace && !Found->setLastSeenDIE(U, DIE)) {
     // The context was found, but it is ambiguous with another context
     // in the same file. Mark it invalid.
-    return PointerIntPair<DeclContext *, 1>(*ContextIter, /* Invalid= */ 1);
+    return PointerIntPair<DeclContext *, 1>(Found, /* Invalid= */ 1);
   }
 
-  assert(ContextIter != Contexts.end());
   // FIXME: dsymutil-classic compatibility. Union types aren't
   // uniques, but their children might be.
   if ((Tag == dwarf::DW_TAG_subprogram &&
        Context.getTag() != dwarf::DW_TAG_structure_type &&
        Context.getTag() != dwarf::DW_TAG_class_type) ||
       (Tag == dwarf::DW_TAG_union_type))
-    return PointerIntPair<DeclContext *, 1>(*ContextIter, /* Invalid= */ 1);
+    return PointerIntPair<DeclContext *, 1>(Found, /* Invalid= */ 1);
 
-  return PointerIntPair<DeclContext *, 1>(*ContextIter);
+  return PointerIntPair<DeclContext *, 1>(Found);
 }
-} // namespace dsymutil
 } // namespace llvm
@@ -548,12 +548,25 @@ Optional<uint64_t> DWARFDebugNames::Entry::getCUIndex() const {
   if (Optional<DWARFFormValue> Off = lookup(dwarf::DW_IDX_compile_unit))
     return Off->getAsUnsignedConstant();
   // In a per-CU index, the entries without a DW_IDX_compile_unit attribute
-  // implicitly refer to the single CU.
-  if (NameIdx->getCUCount() == 1)
+  // implicitly refer to the single CU, unless they are in a type unit.
+  if (NameIdx->getCUCount() == 1 && !lookup(dwarf::DW_IDX_type_unit))
     return 0;
   return None;
 }
 
+Optional<uint64_t> DWARFDebugNames::Entry::getLocalTUIndex() const {
+  if (Optional<DWARFFormValue> Off = lookup(dwarf::DW_IDX_type_unit))
+    return Off->getAsUnsignedConstant();
+  return None;
+}
+
+Optional<uint64_t> DWARFDebugNames::Entry::getLocalTUOffset() const {
+  Optional<uint64_t> Index = getLocalTUIndex();
+  if (!Index || *Index >= NameIdx->getLocalTUCount())
+    return None;
+  return NameIdx->getLocalTUOffset(*Index);
+}
+
 Optional<uint64_t> DWARFDebugNames::Entry::getCUOffset() const {
   Optional<uint64_t> Index = getCUIndex();
   if (!Index || *Index >= NameIdx->getCUCount())
@@ -66,11 +66,18 @@ using FileLineInfoKind = DILineInfoSpecifier::FileLineInfoKind;
 using FunctionNameKind = DILineInfoSpecifier::FunctionNameKind;
 
 DWARFContext::DWARFContext(std::unique_ptr<const DWARFObject> DObj,
-                           std::string DWPName)
-    : DIContext(CK_DWARF), DWPName(std::move(DWPName)), DObj(std::move(DObj)) {}
+                           std::string DWPName, bool ThreadSafe)
+    : DIContext(CK_DWARF), DWPName(std::move(DWPName)), ThreadSafe(ThreadSafe),
+      DObj(std::move(DObj)) {}
 
 DWARFContext::~DWARFContext() = default;
 
+std::unique_lock<std::recursive_mutex> DWARFContext::lockIfThreadSafe() {
+  if (!ThreadSafe)
+    return std::unique_lock<std::recursive_mutex>();
+  return std::unique_lock<std::recursive_mutex>(Mutex);
+}
+
 /// Dump the UUID load command.
 static void dumpUUID(raw_ostream &OS, const ObjectFile &Obj) {
   auto *MachO = dyn_cast<MachOObjectFile>(&Obj);
@@ -605,6 +612,7 @@ void DWARFContext::dump(
 }
 
 DWARFCompileUnit *DWARFContext::getDWOCompileUnitForHash(uint64_t Hash) {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   parseDWOUnits(LazyParse);
 
   if (const auto &CUI = getCUIndex()) {
@@ -655,6 +663,7 @@ bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts) {
 }
 
 const DWARFUnitIndex &DWARFContext::getCUIndex() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (CUIndex)
     return *CUIndex;
 
@@ -666,6 +675,7 @@ const DWARFUnitIndex &DWARFContext::getCUIndex() {
 }
 
 const DWARFUnitIndex &DWARFContext::getTUIndex() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (TUIndex)
     return *TUIndex;
 
@@ -677,6 +687,7 @@ const DWARFUnitIndex &DWARFContext::getTUIndex() {
 }
 
 DWARFGdbIndex &DWARFContext::getGdbIndex() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (GdbIndex)
     return *GdbIndex;
 
@@ -687,6 +698,7 @@ DWARFGdbIndex &DWARFContext::getGdbIndex() {
 }
 
 const DWARFDebugAbbrev *DWARFContext::getDebugAbbrev() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (Abbrev)
     return Abbrev.get();
 
@@ -698,6 +710,7 @@ const DWARFDebugAbbrev *DWARFContext::getDebugAbbrev() {
 }
 
 const DWARFDebugAbbrev *DWARFContext::getDebugAbbrevDWO() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (AbbrevDWO)
     return AbbrevDWO.get();
 
@@ -708,6 +721,7 @@ const DWARFDebugAbbrev *DWARFContext::getDebugAbbrevDWO() {
 }
 
 const DWARFDebugLoc *DWARFContext::getDebugLoc() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (Loc)
     return Loc.get();
 
@@ -722,6 +736,7 @@ const DWARFDebugLoc *DWARFContext::getDebugLoc() {
 }
 
 const DWARFDebugLoclists *DWARFContext::getDebugLocDWO() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (LocDWO)
     return LocDWO.get();
 
@@ -738,6 +753,7 @@ const DWARFDebugLoclists *DWARFContext::getDebugLocDWO() {
 }
 
 const DWARFDebugAranges *DWARFContext::getDebugAranges() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (Aranges)
     return Aranges.get();
 
@@ -747,6 +763,7 @@ const DWARFDebugAranges *DWARFContext::getDebugAranges() {
 }
 
 const DWARFDebugFrame *DWARFContext::getDebugFrame() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (DebugFrame)
     return DebugFrame.get();
 
@@ -767,6 +784,7 @@ const DWARFDebugFrame *DWARFContext::getDebugFrame() {
 }
 
 const DWARFDebugFrame *DWARFContext::getEHFrame() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (EHFrame)
     return EHFrame.get();
 
@@ -778,6 +796,7 @@ const DWARFDebugFrame *DWARFContext::getEHFrame() {
 }
 
 const DWARFDebugMacro *DWARFContext::getDebugMacro() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (Macro)
     return Macro.get();
 
@@ -802,27 +821,32 @@ static T &getAccelTable(std::unique_ptr<T> &Cache, const DWARFObject &Obj,
 }
 
 const DWARFDebugNames &DWARFContext::getDebugNames() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   return getAccelTable(Names, *DObj, DObj->getNamesSection(),
                        DObj->getStrSection(), isLittleEndian());
 }
 
 const AppleAcceleratorTable &DWARFContext::getAppleNames() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   return getAccelTable(AppleNames, *DObj, DObj->getAppleNamesSection(),
                        DObj->getStrSection(), isLittleEndian());
 }
 
 const AppleAcceleratorTable &DWARFContext::getAppleTypes() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   return getAccelTable(AppleTypes, *DObj, DObj->getAppleTypesSection(),
                        DObj->getStrSection(), isLittleEndian());
 }
 
 const AppleAcceleratorTable &DWARFContext::getAppleNamespaces() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   return getAccelTable(AppleNamespaces, *DObj,
                        DObj->getAppleNamespacesSection(),
                        DObj->getStrSection(), isLittleEndian());
 }
 
 const AppleAcceleratorTable &DWARFContext::getAppleObjC() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   return getAccelTable(AppleObjC, *DObj, DObj->getAppleObjCSection(),
                        DObj->getStrSection(), isLittleEndian());
 }
@@ -840,6 +864,7 @@ DWARFContext::getLineTableForUnit(DWARFUnit *U) {
 
 Expected<const DWARFDebugLine::LineTable *> DWARFContext::getLineTableForUnit(
     DWARFUnit *U, std::function<void(Error)> RecoverableErrorCallback) {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (!Line)
     Line.reset(new DWARFDebugLine);
 
@@ -868,6 +893,9 @@ Expected<const DWARFDebugLine::LineTable *> DWARFContext::getLineTableForUnit(
 }
 
 void DWARFContext::parseNormalUnits() {
+  if (NormalUnitsParsed.load(std::memory_order_acquire))
+    return;
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (!NormalUnits.empty())
     return;
   DObj->forEachInfoSections([&](const DWARFSection &S) {
@@ -877,11 +905,19 @@ void DWARFContext::parseNormalUnits() {
   DObj->forEachTypesSections([&](const DWARFSection &S) {
     NormalUnits.addUnitsForSection(*this, S, DW_SECT_TYPES);
   });
+  NormalUnitsParsed.store(true, std::memory_order_release);
 }
 
 void DWARFContext::parseDWOUnits(bool Lazy) {
+  if (DWOUnitsParsed.load(std::memory_order_acquire))
+    return;
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (!DWOUnits.empty())
     return;
+  // Lazily parsed units are later inserted in the middle of DWOUnits, which
+  // would invalidate the iterators other threads hold.
+  if (ThreadSafe)
+    Lazy = false;
   DObj->forEachInfoDWOSections([&](const DWARFSection &S) {
     DWOUnits.addUnitsForDWOSection(*this, S, DW_SECT_INFO, Lazy);
   });
@@ -889,6 +925,7 @@ void DWARFContext::parseDWOUnits(bool Lazy) {
   DObj->forEachTypesDWOSections([&](const DWARFSection &S) {
     DWOUnits.addUnitsForDWOSection(*this, S, DW_SECT_TYPES, Lazy);
   });
+  DWOUnitsParsed.store(true, std::memory_order_release);
 }
 
 DWARFCompileUnit *DWARFContext::getCompileUnitForOffset(uint64_t Offset) {
@@ -1219,6 +1256,7 @@ DWARFContext::getInliningInfoForAddress(object::SectionedAddress Address,
 
 std::shared_ptr<DWARFContext>
 DWARFContext::getDWOContext(StringRef AbsolutePath) {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (auto S = DWP.lock()) {
     DWARFContext *Ctxt = S->Context.get();
     return std::shared_ptr<DWARFContext>(std::move(S), Ctxt);
@@ -1260,7 +1298,8 @@ DWARFContext::getDWOContext(StringRef AbsolutePath) {
 
   auto S = std::make_shared<DWOFile>();
   S->File = std::move(Obj.get());
-  S->Context = DWARFContext::create(*S->File.getBinary());
+  S->Context = DWARFContext::create(*S->File.getBinary(), nullptr,
+                                    defaultErrorHandler, "", ThreadSafe);
   *Entry = S;
   auto *Ctxt = S->Context.get();
   return std::shared_ptr<DWARFContext>(std::move(S), Ctxt);
@@ -1802,17 +1841,18 @@ public:
 std::unique_ptr<DWARFContext>
 DWARFContext::create(const object::ObjectFile &Obj, const LoadedObjectInfo *L,
                      function_ref<ErrorPolicy(Error)> HandleError,
-                     std::string DWPName) {
+                     std::string DWPName, bool ThreadSafe) {
   auto DObj = std::make_unique<DWARFObjInMemory>(Obj, L, HandleError);
-  return std::make_unique<DWARFContext>(std::move(DObj), std::move(DWPName));
+  return std::make_unique<DWARFContext>(std::move(DObj), std::move(DWPName),
+                                        ThreadSafe);
 }
 
 std::unique_ptr<DWARFContext>
 DWARFContext::create(const StringMap<std::unique_ptr<MemoryBuffer>> &Sections,
-                     uint8_t AddrSize, bool isLittleEndian) {
+                     uint8_t AddrSize, bool isLittleEndian, bool ThreadSafe) {
   auto DObj =
       std::make_unique<DWARFObjInMemory>(Sections, AddrSize, isLittleEndian);
-  return std::make_unique<DWARFContext>(std::move(DObj), "");
+  return std::make_unique<DWARFContext>(std::move(DObj), "", ThreadSafe);
 }
 
 Error DWARFContext::loadRegisterInfo(const object::ObjectFile &Obj) {
@@ -179,6 +179,11 @@ DWARFUnit::DWARFUnit(DWARFContext &DC, const DWARFSection &Section,
       StringSection(SS), StringOffsetSection(SOS), AddrOffsetSection(AOS),
       isLittleEndian(LE), IsDWO(IsDWO), UnitVector(UnitVector) {
   clear();
+  // The abbreviation tables are shared by all the units of the context,
+  // which may be extracted concurrently. Look this unit's up now, while the
+  // context builds its units under its lock.
+  if (DC.isThreadSafe())
+    getAbbreviations();
   // For split DWARF we only need to keep track of the location list section's
   // data (no relocations), and if we are reading a package file, we need to
   // adjust the location list data based on the index entries.
@@ -192,6 +197,12 @@ DWARFUnit::DWARFUnit(DWARFContext &DC, const DWARFSection &Section,
 
 DWARFUnit::~DWARFUnit() = default;
 
+std::unique_lock<std::recursive_mutex> DWARFUnit::lockIfThreadSafe() const {
+  if (!Context.isThreadSafe())
+    return std::unique_lock<std::recursive_mutex>();
+  return std::unique_lock<std::recursive_mutex>(Mutex);
+}
+
 DWARFDataExtractor DWARFUnit::getDebugInfoExtractor() const {
   return DWARFDataExtractor(Context.getDWARFObj(), InfoSection, isLittleEndian,
                             getAddressByteSize());
@@ -407,6 +418,25 @@ void DWARFUnit::extractDIEsIfNeeded(bool CUDieOnly) {
 }
 
 Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
+  if (!Context.isThreadSafe())
+    return extractDIEs(CUDieOnly);
+
+  if (AllDIEsExtracted.load(std::memory_order_acquire))
+    return Error::success();
+  std::lock_guard<std::recursive_mutex> Lock(Mutex);
+  // The unit DIE is read back from this thread while the unit is extracted.
+  if (AllDIEsExtracted.load(std::memory_order_relaxed) || ExtractingDIEs)
+    return Error::success();
+  // Extract the whole unit at once: extending DieArray later on would move
+  // the unit DIE under the feet of the threads using it.
+  ExtractingDIEs = true;
+  Error Err = extractDIEs(/*CUDieOnly=*/false);
+  ExtractingDIEs = false;
+  AllDIEsExtracted.store(true, std::memory_order_release);
+  return Err;
+}
+
+Error DWARFUnit::extractDIEs(bool CUDieOnly) {
   if ((CUDieOnly && !DieArray.empty()) ||
       DieArray.size() > 1)
     return Error::success(); // Already parsed.
@@ -493,8 +523,11 @@ Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
 bool DWARFUnit::parseDWO() {
   if (IsDWO)
     return false;
-  if (DWO.get())
-    return false;
+  {
+    std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
+    if (DWO.get())
+      return false;
+  }
   DWARFDie UnitDie = getUnitDIE();
   if (!UnitDie)
     return false;
@@ -518,6 +551,11 @@ bool DWARFUnit::parseDWO() {
   DWARFCompileUnit *DWOCU = DWOContext->getDWOCompileUnitForHash(*DWOId);
   if (!DWOCU)
     return false;
+  // Looking the DWO unit up locks the contexts, so it is done with this unit
+  // unlocked, and another thread may have set the DWO unit up meanwhile.
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
+  if (DWO.get())
+    return false;
   DWO = std::shared_ptr<DWARFCompileUnit>(std::move(DWOContext), DWOCU);
   // Share .debug_addr and .debug_ranges section with compile unit in .dwo
   DWO->setAddrOffsetSection(AddrOffsetSection, AddrOffsetSectionBase);
@@ -542,10 +580,20 @@ bool DWARFUnit::parseDWO() {
 }
 
 void DWARFUnit::clearDIEs(bool KeepCUDie) {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
+  // The address map points into DieArray.
+  AddrDieMap.clear();
   if (DieArray.size() > (unsigned)KeepCUDie) {
     DieArray.resize((unsigned)KeepCUDie);
     DieArray.shrink_to_fit();
   }
+  // The section bases are read again from the unit DIE when it is extracted.
+  // Those of a DWO unit are set up by its skeleton unit and must be kept.
+  if (!KeepCUDie && !IsDWO) {
+    AddrOffsetSectionBase = 0;
+    RangeSectionBase = 0;
+  }
+  AllDIEsExtracted.store(false, std::memory_order_release);
 }
 
 Expected<DWARFAddressRangesVector>
@@ -629,6 +677,7 @@ void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
 
 DWARFDie DWARFUnit::getSubroutineForAddress(uint64_t Address) {
   extractDIEsIfNeeded(false);
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (AddrDieMap.empty())
     updateAddressDieMap(getUnitDIE());
   auto R = AddrDieMap.upper_bound(Address);
@@ -762,6 +811,7 @@ const DWARFAbbreviationDeclarationSet *DWARFUnit::getAbbreviations() const {
 }
 
 llvm::Optional<object::SectionedAddress> DWARFUnit::getBaseAddress() {
+  std::unique_lock<std::recursive_mutex> Lock = lockIfThreadSafe();
   if (BaseAddr)
     return BaseAddr;
 
@@ -16,6 +16,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFSection.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -268,6 +269,21 @@ bool DWARFVerifier::handleDebugAbbrev() {
   return NumErrors == 0;
 }
 
+namespace {
+/// The verification of one unit, in a parallel verifyUnitSection().
+struct UnitVerification {
+  std::string Output;
+  raw_string_ostream OS;
+  std::unique_ptr<DWARFVerifier> Verifier;
+  DWARFUnit *Unit = nullptr;
+  unsigned NumErrors = 0;
+
+  UnitVerification(DWARFContext &DCtx, DIDumpOptions DumpOpts)
+      : OS(Output),
+        Verifier(std::make_unique<DWARFVerifier>(OS, DCtx, DumpOpts)) {}
+};
+} // end anonymous namespace
+
 unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
                                           DWARFSectionKind SectionKind) {
   const DWARFObject &DObj = DCtx.getDWARFObj();
@@ -280,10 +296,19 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
   bool hasDIE = DebugInfoData.isValidOffset(Offset);
   DWARFUnitVector TypeUnitVector;
   DWARFUnitVector CompileUnitVector;
+  // The header chain has to be walked in order, but the contents of the
+  // units can then be verified concurrently.
+  bool Parallel = DumpOpts.VerifyThreads > 1 && DCtx.isThreadSafe();
+  std::vector<std::unique_ptr<UnitVerification>> Units;
   while (hasDIE) {
     OffsetStart = Offset;
-    if (!verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
-                          isUnitDWARF64)) {
+    DWARFVerifier *Verifier = this;
+    if (Parallel) {
+      Units.push_back(std::make_unique<UnitVerification>(DCtx, DumpOpts));
+      Verifier = Units.back()->Verifier.get();
+    }
+    if (!Verifier->verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
+                                    isUnitDWARF64)) {
       isHeaderChainValid = false;
       if (isUnitDWARF64)
         break;
@@ -318,11 +343,30 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
       }
       default: { llvm_unreachable("Invalid UnitType."); }
       }
-      NumDebugInfoErrors += verifyUnitContents(*Unit);
+      if (Parallel)
+        Units.back()->Unit = Unit;
+      else
+        NumDebugInfoErrors += verifyUnitContents(*Unit);
     }
     hasDIE = DebugInfoData.isValidOffset(Offset);
     ++UnitIdx;
   }
+  if (!Units.empty()) {
+    ThreadPool Pool(std::min<size_t>(DumpOpts.VerifyThreads, Units.size()));
+    for (auto &U : Units)
+      if (U->Unit)
+        Pool.async([&U]() {
+          U->NumErrors = U->Verifier->verifyUnitContents(*U->Unit);
+        });
+    Pool.wait();
+    for (auto &U : Units) {
+      OS << U->OS.str();
+      NumDebugInfoErrors += U->NumErrors;
+      for (auto &Ref : U->Verifier->ReferenceToDIEOffsets)
+        ReferenceToDIEOffsets[Ref.first].insert(Ref.second.begin(),
+                                                Ref.second.end());
+    }
+  }
   if (UnitIdx == 0 && !hasDIE) {
     warn() << "Section is empty.\n";
     isHeaderChainValid = true;
@@ -20,6 +20,7 @@
 #include "llvm/DebugInfo/PDB/Native/Hash.h"
 #include "llvm/Support/BinaryItemStream.h"
 #include "llvm/Support/BinaryStreamWriter.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <vector>
@@ -131,30 +132,70 @@ static bool gsiRecordLess(StringRef S1, StringRef S2) {
 }
 
 void GSIHashStreamBuilder::finalizeBuckets(uint32_t RecordZeroOffset) {
-  std::array<std::vector<std::pair<StringRef, PSHashRecord>>, IPHR_HASH + 1>
-      TmpBuckets;
+  // Compute the offset of each record. This is a prefix sum of the record
+  // lengths, so it is done serially.
+  std::vector<uint32_t> SymOffsets(Records.size());
   uint32_t SymOffset = RecordZeroOffset;
-  for (const CVSymbol &Sym : Records) {
+  for (size_t I = 0, E = Records.size(); I != E; ++I) {
+    SymOffsets[I] = SymOffset;
+    SymOffset += Records[I].length();
+  }
+
+  // Finding and hashing symbol names requires deserializing each record,
+  // which is the most expensive part, so do it in parallel.
+  std::vector<StringRef> Names(Records.size());
+  std::vector<uint32_t> BucketIdxs(Records.size());
+  parallel::for_each_n(parallel::par, size_t(0), Records.size(),
+                       [&](size_t I) {
+                         Names[I] = getSymbolName(Records[I]);
+                         BucketIdxs[I] = hashStringV1(Names[I]) % IPHR_HASH;
+                       });
+
+  // Distribute the records to buckets with a counting sort, which keeps
+  // records with the same bucket in their original order.
+  std::vector<uint32_t> BucketStarts(IPHR_HASH + 2, 0);
+  for (uint32_t BucketIdx : BucketIdxs)
+    ++BucketStarts[BucketIdx + 1];
+  for (size_t BucketIdx = 0; BucketIdx < IPHR_HASH + 1; ++BucketIdx)
+    BucketStarts[BucketIdx + 1] += BucketStarts[BucketIdx];
+
+  std::vector<std::pair<StringRef, PSHashRecord>> Entries(Records.size());
+  std::vector<uint32_t> BucketCursors(BucketStarts.begin(),
+                                      BucketStarts.end() - 1);
+  for (size_t I = 0, E = Records.size(); I != E; ++I) {
     PSHashRecord HR;
     // Add one when writing symbol offsets to disk. See GSI1::fixSymRecs.
-    HR.Off = SymOffset + 1;
+    HR.Off = SymOffsets[I] + 1;
     HR.CRef = 1; // Always use a refcount of 1.
-
-    // Hash the name to figure out which bucket this goes into.
-    StringRef Name = getSymbolName(Sym);
-    size_t BucketIdx = hashStringV1(Name) % IPHR_HASH;
-    TmpBuckets[BucketIdx].push_back(std::make_pair(Name, HR));
-    SymOffset += Sym.length();
+    Entries[BucketCursors[BucketIdxs[I]]++] = std::make_pair(Names[I], HR);
   }
 
+  // Sort each bucket by memcmp of the symbol's name.  It's important that
+  // we use the same sorting algorithm as is used by the reference
+  // implementation to ensure that the search for a record within a bucket
+  // can properly early-out when it detects the record won't be found.  The
+  // algorithm used here corredsponds to the function
+  // caseInsensitiveComparePchPchCchCch in the reference implementation.
+  // Buckets are independent of each other, so sort them in parallel.
+  parallel::for_each_n(
+      parallel::par, size_t(0), size_t(IPHR_HASH + 1), [&](size_t BucketIdx) {
+        llvm::sort(Entries.begin() + BucketStarts[BucketIdx],
+                   Entries.begin() + BucketStarts[BucketIdx + 1],
+                   [](const std::pair<StringRef, PSHashRecord> &Left,
+                      const std::pair<StringRef, PSHashRecord> &Right) {
+                     return gsiRecordLess(Left.first, Right.first);
+                   });
+      });
+
   // Compute the three tables: the hash records in bucket and chain order, the
   // bucket presence bitmap, and the bucket chain start offsets.
   HashRecords.reserve(Records.size());
   for (ulittle32_t &Word : HashBitmap)
     Word = 0;
   for (size_t BucketIdx = 0; BucketIdx < IPHR_HASH + 1; ++BucketIdx) {
-    auto &Bucket = TmpBuckets[BucketIdx];
-    if (Bucket.empty())
+    uint32_t Begin = BucketStarts[BucketIdx];
+    uint32_t End = BucketStarts[BucketIdx + 1];
+    if (Begin == End)
       continue;
     HashBitmap[BucketIdx / 32] |= 1U << (BucketIdx % 32);
 
@@ -166,19 +207,8 @@ void GSIHashStreamBuilder::finalizeBuckets(uint32_t RecordZeroOffset) {
         ulittle32_t(HashRecords.size() * SizeOfHROffsetCalc);
     HashBuckets.push_back(ChainStartOff);
 
-    // Sort each bucket by memcmp of the symbol's name.  It's important that
-    // we use the same sorting algorithm as is used by the reference
-    // implementation to ensure that the search for a record within a bucket
-    // can properly early-out when it detects the record won't be found.  The
-    // algorithm used here corredsponds to the function
-    // caseInsensitiveComparePchPchCchCch in the reference implementation.
-    llvm::sort(Bucket, [](const std::pair<StringRef, PSHashRecord> &Left,
-                          const std::pair<StringRef, PSHashRecord> &Right) {
-      return gsiRecordLess(Left.first, Right.first);
-    });
-
-    for (const auto &Entry : Bucket)
-      HashRecords.push_back(Entry.second);
+    for (uint32_t I = Begin; I != End; ++I)
+      HashRecords.push_back(Entries[I].second);
   }
 }
 
@@ -236,8 +266,12 @@ static bool comparePubSymByAddrAndName(
     return LS.second->Segment < RS.second->Segment;
   if (LS.second->Offset != RS.second->Offset)
     return LS.second->Offset < RS.second->Offset;
+  if (LS.second->Name != RS.second->Name)
+    return LS.second->Name < RS.second->Name;
 
-  return LS.second->Name < RS.second->Name;
+  // Break ties by record order so that the order is total and the result
+  // doesn't depend on the sort algorithm.
+  return LS.first < RS.first;
 }
 
 /// Compute the address map. The address map is an array of symbol offsets
@@ -246,23 +280,28 @@ static std::vector<ulittle32_t> computeAddrMap(ArrayRef<CVSymbol> Records) {
   // Make a vector of pointers to the symbols so we can sort it by address.
   // Also gather the symbol offsets while we're at it.
 
-  std::vector<PublicSym32> DeserializedPublics;
-  std::vector<std::pair<const CVSymbol *, const PublicSym32 *>> PublicsByAddr;
-  std::vector<uint32_t> SymOffsets;
-  DeserializedPublics.reserve(Records.size());
-  PublicsByAddr.reserve(Records.size());
-  SymOffsets.reserve(Records.size());
+  std::vector<PublicSym32> DeserializedPublics(Records.size());
+  std::vector<std::pair<const CVSymbol *, const PublicSym32 *>> PublicsByAddr(
+      Records.size());
+  std::vector<uint32_t> SymOffsets(Records.size());
 
   uint32_t SymOffset = 0;
-  for (const CVSymbol &Sym : Records) {
-    assert(Sym.kind() == SymbolKind::S_PUB32);
-    DeserializedPublics.push_back(
-        cantFail(SymbolDeserializer::deserializeAs<PublicSym32>(Sym)));
-    PublicsByAddr.emplace_back(&Sym, &DeserializedPublics.back());
-    SymOffsets.push_back(SymOffset);
-    SymOffset += Sym.length();
+  for (size_t I = 0, E = Records.size(); I != E; ++I) {
+    SymOffsets[I] = SymOffset;
+    SymOffset += Records[I].length();
   }
-  llvm::stable_sort(PublicsByAddr, comparePubSymByAddrAndName);
+
+  parallel::for_each_n(parallel::par, size_t(0), Records.size(),
+                       [&](size_t I) {
+                         const CVSymbol &Sym = Records[I];
+                         assert(Sym.kind() == SymbolKind::S_PUB32);
+                         DeserializedPublics[I] = cantFail(
+                             SymbolDeserializer::deserializeAs<PublicSym32>(
+                                 Sym));
+                         PublicsByAddr[I] = {&Sym, &DeserializedPublics[I]};
+                       });
+  parallel::sort(parallel::par, PublicsByAddr.begin(), PublicsByAddr.end(),
+                 comparePubSymByAddrAndName);
 
   // Fill in the symbol offsets in the appropriate order.
   std::vector<ulittle32_t> AddrMap;
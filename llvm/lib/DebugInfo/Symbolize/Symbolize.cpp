@@ -13,20 +13,24 @@
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 
 #include "SymbolizableObjectFile.h"
+#include "llvm/DebugInfo/Symbolize/SymbolizerIndex.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/PDB/PDB.h"
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Object/COFF.h"
+#include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/MachO.h"
 #include "llvm/Object/MachOUniversal.h"
 #include "llvm/Support/CRC.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/Debug.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -48,6 +52,8 @@
 #endif
 #endif
 
+#define DEBUG_TYPE "symbolize"
+
 namespace llvm {
 namespace symbolize {
 
@@ -75,17 +81,24 @@ Expected<DILineInfo>
 LLVMSymbolizer::symbolizeCode(const ObjectFile &Obj,
                               object::SectionedAddress ModuleOffset) {
   StringRef ModuleName = Obj.getFileName();
-  auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
-    return symbolizeCodeCommon(I->second.get(), ModuleOffset);
-
-  std::unique_ptr<DIContext> Context =
-        DWARFContext::create(Obj, nullptr, DWARFContext::defaultErrorHandler);
-  Expected<SymbolizableModule *> InfoOrErr =
-                     createModuleInfo(&Obj, std::move(Context), ModuleName);
-  if (!InfoOrErr)
-    return InfoOrErr.takeError();
-  return symbolizeCodeCommon(*InfoOrErr, ModuleOffset);
+  SymbolizableModule *Info;
+  {
+    std::unique_lock<std::mutex> Lock = lockIfThreadSafe();
+    auto I = Modules.find(ModuleName);
+    if (I != Modules.end()) {
+      Info = I->second.Module.get();
+    } else {
+      std::unique_ptr<DIContext> Context =
+          DWARFContext::create(Obj, nullptr, DWARFContext::defaultErrorHandler,
+                               "", Opts.ThreadSafe);
+      Expected<SymbolizableModule *> InfoOrErr =
+          createModuleInfo(&Obj, std::move(Context), ModuleName);
+      if (!InfoOrErr)
+        return InfoOrErr.takeError();
+      Info = *InfoOrErr;
+    }
+  }
+  return symbolizeCodeCommon(Info, ModuleOffset);
 }
 
 Expected<DILineInfo>
@@ -177,12 +190,45 @@ LLVMSymbolizer::symbolizeFrame(const std::string &ModuleName,
 }
 
 void LLVMSymbolizer::flush() {
+  LRUBinaries.clear();
+  CacheSize = 0;
+  BinaryForObject.clear();
   ObjectForUBPathAndArch.clear();
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
 }
 
+void LLVMSymbolizer::pruneCache() {
+  if (!Opts.MaxCacheSize)
+    return;
+  while (CacheSize > Opts.MaxCacheSize && !LRUBinaries.empty()) {
+    CachedBinary &Bin = LRUBinaries.front();
+    LLVM_DEBUG(dbgs() << "symbolize: evicting "
+                      << Bin->getBinary()->getFileName() << "\n");
+    CacheSize -= Bin.size();
+    LRUBinaries.pop_front();
+    Bin.evict();
+  }
+}
+
+uint64_t LLVMSymbolizer::CachedBinary::size() const {
+  if (const Binary *B = Bin.getBinary())
+    return B->getData().size();
+  return 0;
+}
+
+void LLVMSymbolizer::recordAccess(CachedBinary &Bin) {
+  if (Bin->getBinary())
+    LRUBinaries.splice(LRUBinaries.end(), LRUBinaries, Bin.getIterator());
+}
+
+std::unique_lock<std::mutex> LLVMSymbolizer::lockIfThreadSafe() {
+  if (!Opts.ThreadSafe)
+    return std::unique_lock<std::mutex>();
+  return std::unique_lock<std::mutex>(Mutex);
+}
+
 namespace {
 
 // For Path="/path/to/foo" and Basename="foo" assume that debug info is in
@@ -288,6 +334,44 @@ bool getGNUDebuglinkContents(const ObjectFile *Obj, std::string &DebugName,
   return false;
 }
 
+template <typename ELFT>
+Optional<ArrayRef<uint8_t>> getBuildID(const ELFFile<ELFT> *Obj) {
+  auto PhdrsOrErr = Obj->program_headers();
+  if (!PhdrsOrErr) {
+    consumeError(PhdrsOrErr.takeError());
+    return None;
+  }
+  for (const auto &P : *PhdrsOrErr) {
+    if (P.p_type != ELF::PT_NOTE)
+      continue;
+    Optional<ArrayRef<uint8_t>> BuildID;
+    Error Err = Error::success();
+    for (auto N : Obj->notes(P, Err)) {
+      if (N.getType() == ELF::NT_GNU_BUILD_ID &&
+          N.getName() == ELF::ELF_NOTE_GNU) {
+        BuildID = N.getDesc();
+        break;
+      }
+    }
+    consumeError(std::move(Err));
+    if (BuildID)
+      return BuildID;
+  }
+  return None;
+}
+
+Optional<ArrayRef<uint8_t>> getBuildID(const ELFObjectFileBase *Obj) {
+  if (auto *O = dyn_cast<ELF32LEObjectFile>(Obj))
+    return getBuildID(O->getELFFile());
+  if (auto *O = dyn_cast<ELF32BEObjectFile>(Obj))
+    return getBuildID(O->getELFFile());
+  if (auto *O = dyn_cast<ELF64LEObjectFile>(Obj))
+    return getBuildID(O->getELFFile());
+  if (auto *O = dyn_cast<ELF64BEObjectFile>(Obj))
+    return getBuildID(O->getELFFile());
+  return None;
+}
+
 bool darwinDsymMatchesBinary(const MachOObjectFile *DbgObj,
                              const MachOObjectFile *Obj) {
   ArrayRef<uint8_t> dbg_uuid = DbgObj->getUuid();
@@ -297,6 +381,47 @@ bool darwinDsymMatchesBinary(const MachOObjectFile *DbgObj,
   return !memcmp(dbg_uuid.data(), bin_uuid.data(), dbg_uuid.size());
 }
 
+// Runs the queries of a module one at a time. The PDB readers keep state
+// across calls, so a module symbolized from a PDB must not be queried from
+// several threads at once, unlike the thread-safe DWARF contexts.
+class SerializedSymbolizableModule : public SymbolizableModule {
+public:
+  explicit SerializedSymbolizableModule(
+      std::unique_ptr<SymbolizableModule> Module)
+      : Module(std::move(Module)) {}
+
+  DILineInfo symbolizeCode(object::SectionedAddress ModuleOffset,
+                           FunctionNameKind FNKind,
+                           bool UseSymbolTable) const override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Module->symbolizeCode(ModuleOffset, FNKind, UseSymbolTable);
+  }
+  DIInliningInfo symbolizeInlinedCode(object::SectionedAddress ModuleOffset,
+                                      FunctionNameKind FNKind,
+                                      bool UseSymbolTable) const override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Module->symbolizeInlinedCode(ModuleOffset, FNKind, UseSymbolTable);
+  }
+  DIGlobal symbolizeData(object::SectionedAddress ModuleOffset) const override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Module->symbolizeData(ModuleOffset);
+  }
+  std::vector<DILocal>
+  symbolizeFrame(object::SectionedAddress ModuleOffset) const override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Module->symbolizeFrame(ModuleOffset);
+  }
+
+  bool isWin32Module() const override { return Module->isWin32Module(); }
+  uint64_t getModulePreferredBase() const override {
+    return Module->getModulePreferredBase();
+  }
+
+private:
+  std::unique_ptr<SymbolizableModule> Module;
+  mutable std::mutex Mutex;
+};
+
 } // end anonymous namespace
 
 ObjectFile *LLVMSymbolizer::lookUpDsymFile(const std::string &ExePath,
@@ -348,12 +473,56 @@ ObjectFile *LLVMSymbolizer::lookUpDebuglinkObject(const std::string &Path,
   return DbgObjOrErr.get();
 }
 
+std::string
+LLVMSymbolizer::lookUpBuildIDPath(ArrayRef<uint8_t> BuildID) const {
+  if (BuildID.size() < 2)
+    return std::string();
+  // The first byte of the build ID names a subdirectory, the rest the file.
+  std::string Subdirectory = toHex(BuildID.take_front(), /*LowerCase=*/true);
+  std::string Filename =
+      toHex(BuildID.drop_front(), /*LowerCase=*/true) + ".debug";
+  for (const auto &Directory : Opts.DebugFileDirectory) {
+    SmallString<128> Path(Directory);
+    sys::path::append(Path, ".build-id", Subdirectory, Filename);
+    if (sys::fs::exists(Path))
+      return Path.str();
+  }
+  return std::string();
+}
+
+ObjectFile *LLVMSymbolizer::lookUpBuildIDObject(const std::string &Path,
+                                                const ELFObjectFileBase *Obj,
+                                                const std::string &ArchName) {
+  if (Opts.DebugFileDirectory.empty())
+    return nullptr;
+  Optional<ArrayRef<uint8_t>> BuildID = getBuildID(Obj);
+  if (!BuildID)
+    return nullptr;
+  std::string DebugBinaryPath = lookUpBuildIDPath(*BuildID);
+  // The binary may have been found by its build ID in the first place.
+  if (DebugBinaryPath.empty() || DebugBinaryPath == Path)
+    return nullptr;
+  auto DbgObjOrErr = getOrCreateObject(DebugBinaryPath, ArchName);
+  if (!DbgObjOrErr) {
+    // Ignore errors, the file might not be an object file.
+    consumeError(DbgObjOrErr.takeError());
+    return nullptr;
+  }
+  return DbgObjOrErr.get();
+}
+
 Expected<LLVMSymbolizer::ObjectPair>
 LLVMSymbolizer::getOrCreateObjectPair(const std::string &Path,
                                       const std::string &ArchName) {
   auto I = ObjectPairForPathArch.find(std::make_pair(Path, ArchName));
-  if (I != ObjectPairForPathArch.end())
+  if (I != ObjectPairForPathArch.end()) {
+    for (const ObjectFile *Obj : {I->second.first, I->second.second}) {
+      auto BinI = BinaryForObject.find(Obj);
+      if (BinI != BinaryForObject.end())
+        recordAccess(*BinI->second);
+    }
     return I->second;
+  }
 
   auto ObjOrErr = getOrCreateObject(Path, ArchName);
   if (!ObjOrErr) {
@@ -368,12 +537,19 @@ LLVMSymbolizer::getOrCreateObjectPair(const std::string &Path,
 
   if (auto MachObj = dyn_cast<const MachOObjectFile>(Obj))
     DbgObj = lookUpDsymFile(Path, MachObj, ArchName);
+  else if (auto ELFObj = dyn_cast<const ELFObjectFileBase>(Obj))
+    DbgObj = lookUpBuildIDObject(Path, ELFObj, ArchName);
   if (!DbgObj)
     DbgObj = lookUpDebuglinkObject(Path, Obj, ArchName);
   if (!DbgObj)
     DbgObj = Obj;
   ObjectPair Res = std::make_pair(Obj, DbgObj);
-  ObjectPairForPathArch.emplace(std::make_pair(Path, ArchName), Res);
+  auto Key = std::make_pair(Path, ArchName);
+  ObjectPairForPathArch.emplace(Key, Res);
+  CachedBinary *Bin = BinaryForObject[Obj], *DbgBin = BinaryForObject[DbgObj];
+  Bin->pushEvictor([this, Key]() { ObjectPairForPathArch.erase(Key); });
+  if (DbgBin != Bin)
+    DbgBin->pushEvictor([this, Key]() { ObjectPairForPathArch.erase(Key); });
   return Res;
 }
 
@@ -382,64 +558,132 @@ LLVMSymbolizer::getOrCreateObject(const std::string &Path,
                                   const std::string &ArchName) {
   Binary *Bin;
   auto Pair = BinaryForPath.emplace(Path, OwningBinary<Binary>());
+  CachedBinary &CachedBin = Pair.first->second;
   if (!Pair.second) {
-    Bin = Pair.first->second.getBinary();
+    Bin = CachedBin->getBinary();
+    recordAccess(CachedBin);
   } else {
     Expected<OwningBinary<Binary>> BinOrErr = createBinary(Path);
     if (!BinOrErr)
       return BinOrErr.takeError();
-    Pair.first->second = std::move(BinOrErr.get());
-    Bin = Pair.first->second.getBinary();
+    *CachedBin = std::move(BinOrErr.get());
+    Bin = CachedBin->getBinary();
+    CachedBin.pushEvictor([this, Path]() { BinaryForPath.erase(Path); });
+    LRUBinaries.push_back(CachedBin);
+    CacheSize += CachedBin.size();
   }
 
   if (!Bin)
     return static_cast<ObjectFile *>(nullptr);
 
   if (MachOUniversalBinary *UB = dyn_cast_or_null<MachOUniversalBinary>(Bin)) {
-    auto I = ObjectForUBPathAndArch.find(std::make_pair(Path, ArchName));
+    auto Key = std::make_pair(Path, ArchName);
+    auto I = ObjectForUBPathAndArch.find(Key);
     if (I != ObjectForUBPathAndArch.end())
       return I->second.get();
 
     Expected<std::unique_ptr<ObjectFile>> ObjOrErr =
         UB->getObjectForArch(ArchName);
     if (!ObjOrErr) {
-      ObjectForUBPathAndArch.emplace(std::make_pair(Path, ArchName),
-                                     std::unique_ptr<ObjectFile>());
+      ObjectForUBPathAndArch.emplace(Key, std::unique_ptr<ObjectFile>());
+      CachedBin.pushEvictor(
+          [this, Key]() { ObjectForUBPathAndArch.erase(Key); });
       return ObjOrErr.takeError();
     }
     ObjectFile *Res = ObjOrErr->get();
-    ObjectForUBPathAndArch.emplace(std::make_pair(Path, ArchName),
-                                   std::move(ObjOrErr.get()));
+    ObjectForUBPathAndArch.emplace(Key, std::move(ObjOrErr.get()));
+    BinaryForObject[Res] = &CachedBin;
+    CachedBin.pushEvictor([this, Key, Res]() {
+      BinaryForObject.erase(Res);
+      ObjectForUBPathAndArch.erase(Key);
+    });
     return Res;
   }
   if (Bin->isObject()) {
-    return cast<ObjectFile>(Bin);
+    ObjectFile *Res = cast<ObjectFile>(Bin);
+    if (BinaryForObject.emplace(Res, &CachedBin).second)
+      CachedBin.pushEvictor([this, Res]() { BinaryForObject.erase(Res); });
+    return Res;
   }
   return errorCodeToError(object_error::arch_not_found);
 }
 
+std::unique_ptr<DIContext>
+LLVMSymbolizer::getOrCreateIndex(const ObjectFile &Obj) {
+  ArrayRef<uint8_t> Identity;
+  if (auto MachObj = dyn_cast<const MachOObjectFile>(&Obj))
+    Identity = MachObj->getUuid();
+  else if (auto ELFObj = dyn_cast<const ELFObjectFileBase>(&Obj))
+    Identity = getBuildID(ELFObj).getValueOr(ArrayRef<uint8_t>());
+  // Without an identity there is no telling a stale index from a good one.
+  if (Identity.empty())
+    return nullptr;
+
+  SmallString<128> Path(Opts.IndexDirectory);
+  sys::path::append(Path, toHex(Identity, /*LowerCase=*/true) + ".symidx");
+  auto IndexOrErr = SymbolizerIndex::create(Path, Identity);
+  if (IndexOrErr)
+    return std::move(*IndexOrErr);
+  // A missing or unusable index is rebuilt.
+  consumeError(IndexOrErr.takeError());
+
+  std::unique_ptr<DWARFContext> Context =
+      DWARFContext::create(Obj, nullptr, DWARFContext::defaultErrorHandler,
+                           Opts.DWPName, Opts.ThreadSafe);
+  // Write the index under a temporary name and rename it into place, so
+  // that symbolizers running concurrently never map a partial index. Failing
+  // to write it only costs the next run the DWARF parsing.
+  sys::fs::create_directories(Opts.IndexDirectory);
+  Expected<sys::fs::TempFile> TempOrErr =
+      sys::fs::TempFile::create(Path + "-%%%%%%.tmp");
+  if (!TempOrErr) {
+    consumeError(TempOrErr.takeError());
+    return std::move(Context);
+  }
+  raw_fd_ostream OS(TempOrErr->FD, /*shouldClose=*/false);
+  Error Err = SymbolizerIndex::write(*Context, Identity, OS);
+  OS.flush();
+  if (OS.has_error()) {
+    OS.clear_error();
+    Err = joinErrors(std::move(Err),
+                     createStringError(errc::io_error,
+                                       "cannot write symbolizer index"));
+  }
+  if (Err) {
+    consumeError(std::move(Err));
+    consumeError(TempOrErr->discard());
+  } else {
+    consumeError(TempOrErr->keep(Path));
+  }
+  return std::move(Context);
+}
+
 Expected<SymbolizableModule *>
 LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
                                  std::unique_ptr<DIContext> Context,
                                  StringRef ModuleName) {
   auto InfoOrErr = SymbolizableObjectFile::create(Obj, std::move(Context),
                                                   Opts.UntagAddresses);
-  std::unique_ptr<SymbolizableModule> SymMod;
+  CachedModule Entry;
   if (InfoOrErr)
-    SymMod = std::move(*InfoOrErr);
+    Entry.Module = std::move(*InfoOrErr);
   auto InsertResult =
-      Modules.insert(std::make_pair(ModuleName, std::move(SymMod)));
+      Modules.insert(std::make_pair(ModuleName, std::move(Entry)));
   assert(InsertResult.second);
   if (std::error_code EC = InfoOrErr.getError())
     return errorCodeToError(EC);
-  return InsertResult.first->second.get();
+  return InsertResult.first->second.Module.get();
 }
 
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
+  std::unique_lock<std::mutex> Lock = lockIfThreadSafe();
   auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
-    return I->second.get();
+  if (I != Modules.end()) {
+    for (CachedBinary *Bin : I->second.Binaries)
+      recordAccess(*Bin);
+    return I->second.Module.get();
+  }
 
   std::string BinaryName = ModuleName;
   std::string ArchName = Opts.DefaultArch;
@@ -455,12 +699,13 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   auto ObjectsOrErr = getOrCreateObjectPair(BinaryName, ArchName);
   if (!ObjectsOrErr) {
     // Failed to find valid object file.
-    Modules.emplace(ModuleName, std::unique_ptr<SymbolizableModule>());
+    Modules.emplace(ModuleName, CachedModule());
     return ObjectsOrErr.takeError();
   }
   ObjectPair Objects = ObjectsOrErr.get();
 
   std::unique_ptr<DIContext> Context;
+  bool SerializeQueries = false;
   // If this is a COFF object containing PDB info, use a PDBContext to
   // symbolize. Otherwise, use DWARF.
   if (auto CoffObject = dyn_cast<COFFObjectFile>(Objects.first)) {
@@ -472,18 +717,39 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
       std::unique_ptr<IPDBSession> Session;
       if (auto Err = loadDataForEXE(PDB_ReaderType::DIA,
                                     Objects.first->getFileName(), Session)) {
-        Modules.emplace(ModuleName, std::unique_ptr<SymbolizableModule>());
+        Modules.emplace(ModuleName, CachedModule());
         // Return along the PDB filename to provide more context
         return createFileError(PDBFileName, std::move(Err));
       }
       Context.reset(new PDBContext(*CoffObject, std::move(Session)));
+      SerializeQueries = Opts.ThreadSafe;
     }
   }
+  if (!Context && !Opts.IndexDirectory.empty())
+    Context = getOrCreateIndex(*Objects.second);
   if (!Context)
-    Context =
-        DWARFContext::create(*Objects.second, nullptr,
-                             DWARFContext::defaultErrorHandler, Opts.DWPName);
-  return createModuleInfo(Objects.first, std::move(Context), ModuleName);
+    Context = DWARFContext::create(*Objects.second, nullptr,
+                                   DWARFContext::defaultErrorHandler,
+                                   Opts.DWPName, Opts.ThreadSafe);
+  auto InfoOrErr =
+      createModuleInfo(Objects.first, std::move(Context), ModuleName);
+
+  // Tie the module to the binaries it was created from, so that it is
+  // evicted along with either of them.
+  CachedModule &Entry = Modules.find(ModuleName)->second;
+  if (InfoOrErr && SerializeQueries) {
+    Entry.Module = std::make_unique<SerializedSymbolizableModule>(
+        std::move(Entry.Module));
+    InfoOrErr = Entry.Module.get();
+  }
+  for (const ObjectFile *Obj : {Objects.first, Objects.second}) {
+    CachedBinary *Bin = BinaryForObject[Obj];
+    if (is_contained(Entry.Binaries, Bin))
+      continue;
+    Entry.Binaries.push_back(Bin);
+    Bin->pushEvictor([this, ModuleName]() { Modules.erase(ModuleName); });
+  }
+  return InfoOrErr;
 }
 
 namespace {
@@ -0,0 +1,344 @@
+//===- SymbolizerIndex.cpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementation of the symbolizer index, see SymbolizerIndex.h.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/Symbolize/SymbolizerIndex.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/DebugInfo/DWARF/DWARFCompileUnit.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFDie.h"
+#include "llvm/Support/Errc.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <array>
+#include <map>
+
+using namespace llvm;
+using namespace symbolize;
+
+static_assert(sizeof(SymbolizerIndex::Header) == 24, "unexpected header size");
+static_assert(sizeof(SymbolizerIndex::Range) == 16, "unexpected range size");
+static_assert(sizeof(SymbolizerIndex::Frame) == 28, "unexpected frame size");
+
+constexpr uint32_t SymbolizerIndex::Magic;
+constexpr uint32_t SymbolizerIndex::Version;
+
+namespace {
+
+/// Deduplicates the strings of the index and hands out their offsets.
+class StringTableWriter {
+  StringMap<uint32_t> Offsets;
+  std::string Data;
+
+public:
+  uint32_t add(StringRef S) {
+    auto Pair = Offsets.insert(std::make_pair(S, Data.size()));
+    if (Pair.second) {
+      Data += S;
+      Data += '\0';
+    }
+    return Pair.first->second;
+  }
+
+  StringRef data() const { return Data; }
+};
+
+/// The fields of a Frame, in a form that can be compared and be a map key.
+using FrameTuple = std::array<uint32_t, 7>;
+
+} // end anonymous namespace
+
+/// Collect the addresses at which the inlining chain may change: the bounds
+/// of the units, subprograms and inlined subroutines, and of the line table
+/// rows. The answer of DWARFContext is the same between two such addresses.
+static void collectBoundaries(DWARFContext &DICtx,
+                              std::vector<uint64_t> &Boundaries) {
+  for (const auto &CU : DICtx.compile_units()) {
+    if (const DWARFDebugLine::LineTable *LT =
+            DICtx.getLineTableForUnit(CU.get()))
+      for (const DWARFDebugLine::Row &Row : LT->Rows)
+        Boundaries.push_back(Row.Address.Address);
+
+    DWARFDie UnitDie = CU->getNonSkeletonUnitDIE(false);
+    if (!UnitDie)
+      continue;
+    DWARFUnit *U = UnitDie.getDwarfUnit();
+    for (const DWARFDebugInfoEntry &Entry : U->dies()) {
+      DWARFDie Die(U, &Entry);
+      dwarf::Tag Tag = Die.getTag();
+      if (Tag != dwarf::DW_TAG_compile_unit &&
+          Tag != dwarf::DW_TAG_subprogram &&
+          Tag != dwarf::DW_TAG_inlined_subroutine)
+        continue;
+      auto RangesOrErr = Die.getAddressRanges();
+      if (!RangesOrErr) {
+        consumeError(RangesOrErr.takeError());
+        continue;
+      }
+      for (const DWARFAddressRange &R : *RangesOrErr) {
+        Boundaries.push_back(R.LowPC);
+        Boundaries.push_back(R.HighPC);
+      }
+    }
+  }
+  llvm::sort(Boundaries);
+  Boundaries.erase(std::unique(Boundaries.begin(), Boundaries.end()),
+                   Boundaries.end());
+}
+
+Error SymbolizerIndex::write(DWARFContext &DICtx, ArrayRef<uint8_t> Identity,
+                             raw_ostream &OS) {
+  std::vector<uint64_t> Boundaries;
+  collectBoundaries(DICtx, Boundaries);
+
+  using FileLineInfoKind = DILineInfoSpecifier::FileLineInfoKind;
+  DILineInfoSpecifier LinkageSpec(FileLineInfoKind::AbsoluteFilePath,
+                                  DINameKind::LinkageName);
+  DILineInfoSpecifier ShortSpec(FileLineInfoKind::AbsoluteFilePath,
+                                DINameKind::ShortName);
+  StringTableWriter Strings;
+  std::vector<Range> Ranges;
+  std::vector<Frame> Frames;
+  // Ranges with the same chain, e.g. the pieces of a function around an
+  // inlined call, share its frames.
+  std::map<std::vector<FrameTuple>, uint32_t> Chains;
+  std::vector<FrameTuple> Prev;
+  for (size_t I = 0, E = Boundaries.size(); I + 1 < E; ++I) {
+    object::SectionedAddress Address = {
+        Boundaries[I], object::SectionedAddress::UndefSection};
+    DIInliningInfo Linkage = DICtx.getInliningInfoForAddress(Address,
+                                                             LinkageSpec);
+    DIInliningInfo Short = DICtx.getInliningInfoForAddress(Address, ShortSpec);
+    assert(Linkage.getNumberOfFrames() == Short.getNumberOfFrames());
+
+    std::vector<FrameTuple> Chain;
+    for (uint32_t J = 0, N = Linkage.getNumberOfFrames(); J != N; ++J) {
+      const DILineInfo &Info = Linkage.getFrame(J);
+      Chain.push_back({{Strings.add(Info.FunctionName),
+                        Strings.add(Short.getFrame(J).FunctionName),
+                        Strings.add(Info.FileName), Info.Line, Info.Column,
+                        Info.StartLine, Info.Discriminator}});
+    }
+    // Merge with the previous range when the answer does not change, and
+    // drop the holes before the first range.
+    if (Ranges.empty() ? Chain.empty() : Chain == Prev)
+      continue;
+
+    Range R;
+    R.Start = Address.Address;
+    R.FirstFrame = 0;
+    R.NumFrames = Chain.size();
+    if (!Chain.empty()) {
+      auto Pair = Chains.insert(std::make_pair(Chain, Frames.size()));
+      if (Pair.second) {
+        for (const FrameTuple &T : Chain) {
+          Frame F;
+          F.LinkageName = T[0];
+          F.ShortName = T[1];
+          F.FileName = T[2];
+          F.Line = T[3];
+          F.Column = T[4];
+          F.StartLine = T[5];
+          F.Discriminator = T[6];
+          Frames.push_back(F);
+        }
+      }
+      R.FirstFrame = Pair.first->second;
+    }
+    Ranges.push_back(R);
+    Prev = std::move(Chain);
+  }
+  // Close the last range.
+  if (!Ranges.empty() && Ranges.back().NumFrames) {
+    Range R;
+    R.Start = Boundaries.back();
+    R.FirstFrame = 0;
+    R.NumFrames = 0;
+    Ranges.push_back(R);
+  }
+
+  if (!isUInt<32>(Strings.data().size()) || !isUInt<32>(Frames.size()) ||
+      !isUInt<32>(Ranges.size()) || !isUInt<32>(Identity.size()))
+    return createStringError(errc::file_too_large,
+                             "symbolizer index does not fit 32-bit offsets");
+
+  Header H;
+  H.Magic = Magic;
+  H.Version = Version;
+  H.IdentitySize = Identity.size();
+  H.NumRanges = Ranges.size();
+  H.NumFrames = Frames.size();
+  H.StringTableSize = Strings.data().size();
+  OS.write(reinterpret_cast<const char *>(&H), sizeof(H));
+  OS.write(reinterpret_cast<const char *>(Identity.data()), Identity.size());
+  uint64_t IdentityEnd = sizeof(H) + Identity.size();
+  OS.write_zeros(alignTo(IdentityEnd, 8) - IdentityEnd);
+  OS.write(reinterpret_cast<const char *>(Ranges.data()),
+           Ranges.size() * sizeof(Range));
+  OS.write(reinterpret_cast<const char *>(Frames.data()),
+           Frames.size() * sizeof(Frame));
+  OS << Strings.data();
+  return Error::success();
+}
+
+Expected<std::unique_ptr<SymbolizerIndex>>
+SymbolizerIndex::create(std::unique_ptr<MemoryBuffer> Buffer,
+                        ArrayRef<uint8_t> Identity) {
+  auto Malformed = [&](const Twine &Msg) {
+    return createStringError(errc::invalid_argument,
+                             "malformed symbolizer index %s: %s",
+                             Buffer->getBufferIdentifier().str().c_str(),
+                             Msg.str().c_str());
+  };
+
+  StringRef Data = Buffer->getBuffer();
+  if (Data.size() < sizeof(Header))
+    return Malformed("truncated header");
+  const Header &H = *reinterpret_cast<const Header *>(Data.data());
+  if (H.Magic != Magic)
+    return Malformed("bad magic");
+  if (H.Version != Version)
+    return Malformed("unsupported version " + Twine(H.Version));
+
+  uint64_t RangesOffset = alignTo(sizeof(Header) + H.IdentitySize, 8);
+  uint64_t FramesOffset = RangesOffset + uint64_t(H.NumRanges) * sizeof(Range);
+  uint64_t StringsOffset =
+      FramesOffset + uint64_t(H.NumFrames) * sizeof(Frame);
+  if (StringsOffset + H.StringTableSize != Data.size())
+    return Malformed("size does not match the header");
+  StringRef Strings = Data.substr(StringsOffset);
+  if (!Strings.empty() && Strings.back() != '\0')
+    return Malformed("unterminated string table");
+
+  ArrayRef<uint8_t> IndexIdentity(
+      reinterpret_cast<const uint8_t *>(Data.data()) + sizeof(Header),
+      H.IdentitySize);
+  if (IndexIdentity != Identity)
+    return createStringError(errc::invalid_argument,
+                             "symbolizer index %s was built for another "
+                             "binary",
+                             Buffer->getBufferIdentifier().str().c_str());
+
+  ArrayRef<Range> Ranges(
+      reinterpret_cast<const Range *>(Data.data() + RangesOffset),
+      H.NumRanges);
+  ArrayRef<Frame> Frames(
+      reinterpret_cast<const Frame *>(Data.data() + FramesOffset),
+      H.NumFrames);
+  return std::unique_ptr<SymbolizerIndex>(
+      new SymbolizerIndex(std::move(Buffer), Ranges, Frames, Strings));
+}
+
+Expected<std::unique_ptr<SymbolizerIndex>>
+SymbolizerIndex::create(StringRef Path, ArrayRef<uint8_t> Identity) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+      MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!BufferOrErr)
+    return createFileError(Path, errorCodeToError(BufferOrErr.getError()));
+  return create(std::move(*BufferOrErr), Identity);
+}
+
+const SymbolizerIndex::Range *
+SymbolizerIndex::findRange(uint64_t Address) const {
+  auto It = std::upper_bound(
+      Ranges.begin(), Ranges.end(), Address,
+      [](uint64_t Address, const Range &R) { return Address < R.Start; });
+  if (It == Ranges.begin())
+    return nullptr;
+  --It;
+  // Ranges pointing out of the frame array are treated as holes, so that a
+  // corrupt index cannot make lookups read past the mapping.
+  if (!It->NumFrames ||
+      uint64_t(It->FirstFrame) + It->NumFrames > Frames.size())
+    return nullptr;
+  return &*It;
+}
+
+DILineInfo SymbolizerIndex::getLineInfo(const Frame &F,
+                                        DILineInfoSpecifier Specifier) const {
+  DILineInfo Info;
+  if (Specifier.FNKind == DINameKind::LinkageName)
+    Info.FunctionName = getString(F.LinkageName);
+  else if (Specifier.FNKind == DINameKind::ShortName)
+    Info.FunctionName = getString(F.ShortName);
+  Info.StartLine = F.StartLine;
+  if (Specifier.FLIKind != DILineInfoSpecifier::FileLineInfoKind::None) {
+    Info.FileName = getString(F.FileName);
+    Info.Line = F.Line;
+    Info.Column = F.Column;
+    Info.Discriminator = F.Discriminator;
+  }
+  return Info;
+}
+
+DILineInfo
+SymbolizerIndex::getLineInfoForAddress(object::SectionedAddress Address,
+                                       DILineInfoSpecifier Specifier) {
+  const Range *R = findRange(Address.Address);
+  if (!R)
+    return DILineInfo();
+  return getLineInfo(Frames[R->FirstFrame], Specifier);
+}
+
+DILineInfoTable
+SymbolizerIndex::getLineInfoForAddressRange(object::SectionedAddress Address,
+                                            uint64_t Size,
+                                            DILineInfoSpecifier Specifier) {
+  DILineInfoTable Lines;
+  uint64_t End = Address.Address + Size;
+  for (uint64_t Start = Address.Address; Start < End;) {
+    if (const Range *R = findRange(Start))
+      Lines.push_back(std::make_pair(
+          Start, getLineInfo(Frames[R->FirstFrame], Specifier)));
+    // Move on to the start of the next range.
+    auto Next = std::upper_bound(
+        Ranges.begin(), Ranges.end(), Start,
+        [](uint64_t Address, const Range &R) { return Address < R.Start; });
+    if (Next == Ranges.end())
+      break;
+    Start = Next->Start;
+  }
+  return Lines;
+}
+
+DIInliningInfo
+SymbolizerIndex::getInliningInfoForAddress(object::SectionedAddress Address,
+                                           DILineInfoSpecifier Specifier) {
+  DIInliningInfo InliningInfo;
+  if (const Range *R = findRange(Address.Address))
+    for (const Frame &F : Frames.slice(R->FirstFrame, R->NumFrames))
+      InliningInfo.addFrame(getLineInfo(F, Specifier));
+  return InliningInfo;
+}
+
+void SymbolizerIndex::dump(raw_ostream &OS, DIDumpOptions DumpOpts) {
+  OS << "symbolizer index: " << Ranges.size() << " ranges, " << Frames.size()
+     << " frames\n";
+  for (const Range &R : Ranges) {
+    OS << format_hex(R.Start, 18);
+    if (!R.NumFrames) {
+      OS << " <no debug info>\n";
+      continue;
+    }
+    OS << '\n';
+    if (uint64_t(R.FirstFrame) + R.NumFrames > Frames.size())
+      continue;
+    for (const Frame &F : Frames.slice(R.FirstFrame, R.NumFrames))
+      OS << "  " << getString(F.LinkageName) << " at "
+         << getString(F.FileName) << ':' << F.Line << ':' << F.Column << '\n';
+  }
+}
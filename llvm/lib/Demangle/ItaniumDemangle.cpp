@@ -252,13 +252,25 @@ class BumpPointerAllocator {
   static constexpr size_t AllocSize = 4096;
   static constexpr size_t UsableAllocSize = AllocSize - sizeof(BlockMeta);
 
+  // The Current of the blocks of allocateMassive, which are freed by reset()
+  // rather than kept for the next names.
+  static constexpr size_t MassiveBlock = static_cast<size_t>(-1);
+
   alignas(long double) char InitialBuffer[AllocSize];
   BlockMeta* BlockList = nullptr;
+  // The blocks that reset() kept, reused by grow() before it mallocs.
+  BlockMeta* FreeList = nullptr;
 
   void grow() {
-    char* NewMeta = static_cast<char *>(std::malloc(AllocSize));
-    if (NewMeta == nullptr)
-      std::terminate();
+    char* NewMeta;
+    if (FreeList) {
+      NewMeta = reinterpret_cast<char*>(FreeList);
+      FreeList = FreeList->Next;
+    } else {
+      NewMeta = static_cast<char *>(std::malloc(AllocSize));
+      if (NewMeta == nullptr)
+        std::terminate();
+    }
     BlockList = new (NewMeta) BlockMeta{BlockList, 0};
   }
 
@@ -267,7 +279,7 @@ class BumpPointerAllocator {
     BlockMeta* NewMeta = reinterpret_cast<BlockMeta*>(std::malloc(NBytes));
     if (NewMeta == nullptr)
       std::terminate();
-    BlockList->Next = new (NewMeta) BlockMeta{BlockList->Next, 0};
+    BlockList->Next = new (NewMeta) BlockMeta{BlockList->Next, MassiveBlock};
     return static_cast<void*>(NewMeta + 1);
   }
 
@@ -287,17 +299,33 @@ public:
                               BlockList->Current - N);
   }
 
+  // Frees the nodes. The blocks of AllocSize are kept for the nodes of the
+  // next name, so that a parser which demangles many names stops calling
+  // malloc once its arena is as large as the largest name needs.
   void reset() {
     while (BlockList) {
       BlockMeta* Tmp = BlockList;
       BlockList = BlockList->Next;
-      if (reinterpret_cast<char*>(Tmp) != InitialBuffer)
+      if (reinterpret_cast<char*>(Tmp) == InitialBuffer)
+        continue;
+      if (Tmp->Current == MassiveBlock) {
         std::free(Tmp);
+        continue;
+      }
+      Tmp->Next = FreeList;
+      FreeList = Tmp;
     }
     BlockList = new (InitialBuffer) BlockMeta{nullptr, 0};
   }
 
-  ~BumpPointerAllocator() { reset(); }
+  ~BumpPointerAllocator() {
+    reset();
+    while (FreeList) {
+      BlockMeta* Tmp = FreeList;
+      FreeList = FreeList->Next;
+      std::free(Tmp);
+    }
+  }
 };
 
 class DefaultAllocator {
@@ -355,6 +383,38 @@ char *llvm::itaniumDemangle(const char *MangledName, char *Buf,
   return InternalStatus == demangle_success ? Buf : nullptr;
 }
 
+size_t llvm::itaniumDemangleBatch(const char *const *MangledNames,
+                                  size_t Count, std::string *Results) {
+  Demangler Parser(nullptr, nullptr);
+  OutputStream S;
+  size_t BufSize = 0;
+  char *Buf = nullptr;
+  size_t NumDemangled = 0;
+
+  for (size_t I = 0; I != Count; ++I) {
+    const char *MangledName = MangledNames[I];
+    Results[I].clear();
+    if (MangledName == nullptr)
+      continue;
+    Parser.reset(MangledName, MangledName + std::strlen(MangledName));
+    Node *AST = Parser.parse();
+    if (AST == nullptr)
+      continue;
+    if (!initializeOutputStream(Buf, &BufSize, S, 1024))
+      continue;
+    assert(Parser.ForwardTemplateRefs.empty());
+    AST->print(S);
+    // The stream may have grown the buffer; keep it for the next names.
+    Buf = S.getBuffer();
+    BufSize = S.getBufferCapacity();
+    Results[I].assign(Buf, S.getCurrentPosition());
+    ++NumDemangled;
+  }
+
+  std::free(Buf);
+  return NumDemangled;
+}
+
 ItaniumPartialDemangler::ItaniumPartialDemangler()
     : RootNode(nullptr), Context(new Demangler{nullptr, nullptr}) {}
 
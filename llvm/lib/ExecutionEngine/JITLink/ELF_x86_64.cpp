@@ -0,0 +1,880 @@
+//===----- ELF_x86_64.cpp - JIT linker implementation for ELF/x86-64 ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// ELF/x86-64 jit-link implementation.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/ELF_x86_64.h"
+
+#include "BasicGOTAndStubsBuilder.h"
+#include "JITLinkGeneric.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <map>
+#include <set>
+
+#define DEBUG_TYPE "jitlink"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::jitlink::ELF_x86_64_Edges;
+
+namespace {
+
+// The eh-frame section of a relocatable object has no terminator: the static
+// linker gets it from crtend.o. The section is registered whole with
+// __register_frame, which reads up to a zero length field, so one is added
+// after it.
+const char EHFrameTerminator[4] = {0, 0, 0, 0};
+
+class ELFAtomGraphBuilder_x86_64 {
+public:
+  ELFAtomGraphBuilder_x86_64(const object::ELF64LEObjectFile &Obj)
+      : Obj(Obj), G(std::make_unique<AtomGraph>(Obj.getFileName(), 8,
+                                                 support::little)) {}
+
+  Expected<std::unique_ptr<AtomGraph>> buildGraph() {
+    if (auto Err = parseSections())
+      return std::move(Err);
+
+    if (auto Err = addAtoms())
+      return std::move(Err);
+
+    if (auto Err = addRelocations())
+      return std::move(Err);
+
+    addFDEKeepAliveEdges();
+
+    return std::move(G);
+  }
+
+private:
+  struct ELFSection {
+    Section *GenericSection = nullptr;
+    JITTargetAddress Address = 0;
+    uint64_t Size = 0;
+    StringRef Content;
+    bool IsZeroFill = false;
+    bool IsCode = false;
+    bool IsNoDeadStrip = false;
+    bool IsEHFrame = false;
+  };
+
+  // Symbols defined at one section offset. The first is the atom that owns
+  // the content, the rest are aliases for it.
+  using SectionSymbolMap =
+      std::map<uint64_t, SmallVector<object::SymbolRef, 1>>;
+
+  static Expected<ELFX86RelocationKind> getRelocationKind(uint32_t Type) {
+    switch (Type) {
+    case ELF::R_X86_64_PLT32:
+      return Branch32;
+    case ELF::R_X86_64_32:
+      return Pointer32;
+    case ELF::R_X86_64_32S:
+      return Pointer32Signed;
+    case ELF::R_X86_64_64:
+      return Pointer64;
+    case ELF::R_X86_64_PC32:
+      return PCRel32;
+    case ELF::R_X86_64_GOTPCREL:
+      return PCRel32GOTLoad;
+    case ELF::R_X86_64_GOTPCRELX:
+      return PCRel32GOTLoadRelaxable;
+    case ELF::R_X86_64_REX_GOTPCRELX:
+      return PCRel32REXGOTLoadRelaxable;
+    case ELF::R_X86_64_PC64:
+      return Delta64;
+    }
+
+    return make_error<JITLinkError>("Unsupported x86-64 relocation: type=" +
+                                    formatv("{0:d}", Type));
+  }
+
+  static unsigned getFixupSize(ELFX86RelocationKind Kind) {
+    return (Kind == Pointer64 || Kind == Delta64) ? 8 : 4;
+  }
+
+  static bool isGOTLoad(ELFX86RelocationKind Kind) {
+    return Kind == PCRel32GOTLoad || Kind == PCRel32GOTLoadRelaxable ||
+           Kind == PCRel32REXGOTLoadRelaxable;
+  }
+
+  Error parseSections() {
+    // Every section of a relocatable object starts at address zero, so lay
+    // the allocatable ones out one after another. The rest (debug info,
+    // symbol and relocation tables) are not part of the graph.
+    for (auto &SecRef : Obj.sections()) {
+      object::ELFSectionRef ESecRef(SecRef);
+      uint64_t Flags = ESecRef.getFlags();
+      if (!(Flags & ELF::SHF_ALLOC))
+        continue;
+
+      auto Name = SecRef.getName();
+      if (!Name)
+        return Name.takeError();
+
+
+      if (Flags & ELF::SHF_TLS)
+        return make_error<JITLinkError>("Thread-local section " + *Name +
+                                        " not supported");
+
+      unsigned Prot = sys::Memory::MF_READ;
+      if (Flags & ELF::SHF_WRITE)
+        Prot |= sys::Memory::MF_WRITE;
+      if (Flags & ELF::SHF_EXECINSTR)
+        Prot |= sys::Memory::MF_EXEC;
+
+      uint32_t Align = std::max<uint64_t>(SecRef.getAlignment(), 1);
+      uint32_t Type = ESecRef.getType();
+
+      ELFSection S;
+      S.IsZeroFill = Type == ELF::SHT_NOBITS;
+      S.IsCode = Flags & ELF::SHF_EXECINSTR;
+      S.IsEHFrame = *Name == ".eh_frame";
+      S.IsNoDeadStrip = Type == ELF::SHT_INIT_ARRAY ||
+                        Type == ELF::SHT_FINI_ARRAY ||
+                        Type == ELF::SHT_PREINIT_ARRAY;
+      S.GenericSection =
+          &G->createSection(*Name, Align,
+                            static_cast<sys::Memory::ProtectionFlags>(Prot),
+                            S.IsZeroFill);
+      S.Address = allocateAddress(
+          SecRef.getSize() + (S.IsEHFrame ? sizeof(EHFrameTerminator) : 0),
+          Align);
+      S.Size = SecRef.getSize();
+      if (!S.IsZeroFill) {
+        auto Content = SecRef.getContents();
+        if (!Content)
+          return Content.takeError();
+        S.Content = *Content;
+      }
+
+      LLVM_DEBUG({
+        dbgs() << "Adding section " << *Name << ": "
+               << format("0x%016" PRIx64, S.Address)
+               << ", size: " << format("0x%016" PRIx64, S.Size)
+               << ", align: " << Align << "\n";
+      });
+
+      Sections[SecRef.getIndex()] = S;
+    }
+
+    return Error::success();
+  }
+
+  Error addAtoms() {
+    std::map<unsigned, SectionSymbolMap> SectionSymbols;
+    DenseSet<StringRef> UsedNames;
+
+    for (auto &Sym : Obj.symbols()) {
+      object::ELFSymbolRef ESym(Sym);
+      if (ESym.getELFType() == ELF::STT_SECTION ||
+          ESym.getELFType() == ELF::STT_FILE)
+        continue;
+
+      auto Name = Sym.getName();
+      if (!Name)
+        return Name.takeError();
+
+      // Skip unnamed symbols.
+      if (Name->empty())
+        continue;
+
+      uint32_t Flags = Sym.getFlags();
+
+      // Local symbols may share a name (e.g. two static variables of the
+      // same name in different functions). Relocations find their targets by
+      // symbol rather than by name, so such duplicates become anonymous
+      // atoms.
+      bool IsAnonymous = false;
+      if (!UsedNames.insert(*Name).second) {
+        if (Flags & (object::SymbolRef::SF_Global |
+                     object::SymbolRef::SF_Undefined |
+                     object::SymbolRef::SF_Absolute |
+                     object::SymbolRef::SF_Common))
+          return make_error<JITLinkError>("Duplicate symbol " + *Name);
+        IsAnonymous = true;
+      }
+
+      if (Flags & object::SymbolRef::SF_Undefined) {
+        // The GOT is built by the linker and only referenced as a whole by
+        // relocations that are not supported (e.g. R_X86_64_GOTPC64), so the
+        // symbol for it is not needed.
+        if (*Name == "_GLOBAL_OFFSET_TABLE_")
+          continue;
+        LLVM_DEBUG(dbgs() << "Adding undef atom \"" << *Name << "\"\n");
+        SymbolAtoms[Sym] = &G->addExternalAtom(*Name);
+        continue;
+      } else if (Flags & object::SymbolRef::SF_Absolute) {
+        LLVM_DEBUG(dbgs() << "Adding absolute \"" << *Name << "\" addr: "
+                          << format("0x%016" PRIx64, Sym.getValue()) << "\n");
+        auto &A = G->addAbsoluteAtom(*Name, Sym.getValue());
+        A.setGlobal(Flags & object::SymbolRef::SF_Global);
+        A.setExported(Flags & object::SymbolRef::SF_Exported);
+        A.setWeak(Flags & object::SymbolRef::SF_Weak);
+        SymbolAtoms[Sym] = &A;
+        continue;
+      } else if (Flags & object::SymbolRef::SF_Common) {
+        uint32_t Align = std::max(Sym.getAlignment(), 1U);
+        auto &A = G->addCommonAtom(
+            getCommonSection(), *Name,
+            allocateAddress(Sym.getCommonSize(), Align), Align,
+            Sym.getCommonSize());
+        LLVM_DEBUG(dbgs() << "Adding common \"" << *Name << "\" addr: "
+                          << format("0x%016" PRIx64, A.getAddress()) << "\n");
+        A.setGlobal(Flags & object::SymbolRef::SF_Global);
+        A.setExported(Flags & object::SymbolRef::SF_Exported);
+        SymbolAtoms[Sym] = &A;
+        continue;
+      }
+
+      auto SecItr = Sym.getSection();
+      if (!SecItr)
+        return SecItr.takeError();
+
+      // Symbols in sections that are not loaded (e.g. debug info) have no
+      // atom. Nor do symbols in the eh-frame section, which is split into
+      // its records instead.
+      unsigned SectionIndex = (*SecItr)->getIndex();
+      auto SI = Sections.find(SectionIndex);
+      if (SI == Sections.end() || SI->second.IsEHFrame)
+        continue;
+
+      if (Sym.getValue() > SI->second.Size)
+        return make_error<JITLinkError>("Symbol " + *Name +
+                                        " lies outside its section");
+
+      if (IsAnonymous)
+        AnonymousSymbols.insert(Sym);
+      SectionSymbols[SectionIndex][Sym.getValue()].push_back(Sym);
+    }
+
+    for (auto &KV : Sections) {
+      auto &S = KV.second;
+      if (S.IsEHFrame) {
+        if (auto Err = addEHFrameAtoms(S))
+          return Err;
+        continue;
+      }
+
+      auto &SecSymbols = SectionSymbols[KV.first];
+
+      // The atoms of the section in address order, and the atoms that own
+      // the content by offset. If no symbol covers the start of the section
+      // then add an anonymous atom for it.
+      std::vector<DefinedAtom *> SecLayout;
+      std::map<uint64_t, DefinedAtom *> SecAtoms;
+      if (S.Size && !SecSymbols.count(0)) {
+        SecAtoms[0] = &G->addAnonymousAtom(*S.GenericSection, S.Address,
+                                           S.GenericSection->getAlignment());
+        SecLayout.push_back(SecAtoms[0]);
+      }
+
+      for (auto &SymKV : SecSymbols) {
+        uint64_t Offset = SymKV.first;
+        auto &Syms = SymKV.second;
+        auto Align = getAtomAlignment(S, Offset);
+
+        // Aliases are empty atoms laid out immediately before the atom that
+        // owns the content. Address lookups always find the owner, since
+        // empty atoms cover no address.
+        for (auto &Sym : make_range(std::next(Syms.begin()), Syms.end())) {
+          auto &Alias = addDefinedAtom(S, Sym, Offset, Align);
+          if (S.IsZeroFill)
+            Alias.setZeroFill(0);
+          else
+            Alias.setContent(StringRef());
+          SecLayout.push_back(&Alias);
+        }
+
+        auto &DA = addDefinedAtom(S, Syms.front(), Offset, Align);
+        SecAtoms[Offset] = &DA;
+        SecLayout.push_back(&DA);
+      }
+
+      // Iterate the atoms in reverse order and set up their contents.
+      uint64_t LastAtomOffset = S.Size;
+      for (auto I = SecAtoms.rbegin(), E = SecAtoms.rend(); I != E; ++I) {
+        auto Offset = I->first;
+        auto &A = *I->second;
+        LLVM_DEBUG({
+          dbgs() << "  " << A << " to [ " << S.Address + Offset << " .. "
+                 << S.Address + LastAtomOffset << " ]\n";
+        });
+
+        if (S.IsZeroFill)
+          A.setZeroFill(LastAtomOffset - Offset);
+        else
+          A.setContent(S.Content.substr(Offset, LastAtomOffset - Offset));
+
+        if (S.IsNoDeadStrip)
+          A.setLive(true);
+
+        LastAtomOffset = Offset;
+      }
+
+      // The assembler resolves references within a section without leaving
+      // relocations behind, so the atoms of a section must be laid out, and
+      // kept alive, together. Chain them up: layout-next edges keep their
+      // targets alive, and keep-alive edges point back along the chain.
+      // Dead-stripping is therefore per section, as for static linkers.
+      for (size_t I = 1; I < SecLayout.size(); ++I) {
+        SecLayout[I - 1]->setLayoutNext(*SecLayout[I]);
+        SecLayout[I]->addEdge(Edge::KeepAlive, 0, *SecLayout[I - 1], 0);
+      }
+    }
+
+    return Error::success();
+  }
+
+  // Split the eh-frame section into one atom per CIE and FDE record, plus a
+  // terminator. The records are not chained: each FDE gets an edge to its
+  // CIE, so that the CIE pointer is fixed up after layout, and is kept alive
+  // by the function that it describes (see addFDEKeepAliveEdges). The
+  // eh-frame therefore does not keep dead functions alive.
+  Error addEHFrameAtoms(ELFSection &S) {
+    using namespace support;
+
+    DenseMap<uint64_t, DefinedAtom *> CIEs;
+    uint64_t Offset = 0;
+    while (Offset != S.Size) {
+      if (S.Size - Offset < 4)
+        return make_error<JITLinkError>("Truncated eh-frame record");
+      uint32_t Length = endian::read32le(S.Content.data() + Offset);
+
+      // A zero length terminates the section. The eh-frame of a relocatable
+      // object does not normally have one, and one is added below anyway.
+      if (Length == 0)
+        break;
+      if (Length == 0xffffffff)
+        return make_error<JITLinkError>("64-bit DWARF eh-frame records are "
+                                        "not supported");
+      if (Length < 4 || Length > S.Size - Offset - 4)
+        return make_error<JITLinkError>("Malformed eh-frame record");
+
+      auto &Record =
+          G->addAnonymousAtom(*S.GenericSection, S.Address + Offset, 1);
+      Record.setContent(S.Content.substr(Offset, Length + 4));
+
+      uint64_t CIEPointerOffset = Offset + 4;
+      uint32_t CIEPointer =
+          endian::read32le(S.Content.data() + CIEPointerOffset);
+      if (CIEPointer == 0) {
+        LLVM_DEBUG(dbgs() << "Adding CIE " << Record << "\n");
+        CIEs[Offset] = &Record;
+      } else {
+        auto CIEItr = CIEPointer <= CIEPointerOffset
+                          ? CIEs.find(CIEPointerOffset - CIEPointer)
+                          : CIEs.end();
+        if (CIEItr == CIEs.end())
+          return make_error<JITLinkError>("eh-frame FDE at offset " +
+                                          formatv("{0:x}", Offset) +
+                                          " does not point at a CIE");
+        LLVM_DEBUG(dbgs() << "Adding FDE " << Record << " for CIE "
+                          << *CIEItr->second << "\n");
+        Record.addEdge(NegDelta32, 4, *CIEItr->second, 0);
+        FDEs.push_back(&Record);
+      }
+
+      Offset += Length + 4;
+    }
+
+    auto &Terminator =
+        G->addAnonymousAtom(*S.GenericSection, S.Address + S.Size, 1);
+    Terminator.setContent(
+        StringRef(EHFrameTerminator, sizeof(EHFrameTerminator)));
+    Terminator.setLive(true);
+    return Error::success();
+  }
+
+  // Keep each FDE alive from the function that its pc-begin field refers
+  // to. FDEs without a defined pc-begin target are kept alive outright.
+  void addFDEKeepAliveEdges() {
+    for (auto *FDE : FDEs) {
+      auto PCBeginItr =
+          std::find_if(FDE->edges().begin(), FDE->edges().end(),
+                       [](const Edge &E) {
+                         return E.isRelocation() && E.getOffset() == 8;
+                       });
+      if (PCBeginItr != FDE->edges().end() &&
+          PCBeginItr->getTarget().isDefined())
+        static_cast<DefinedAtom &>(PCBeginItr->getTarget())
+            .addEdge(Edge::KeepAlive, 0, *FDE, 0);
+      else
+        FDE->setLive(true);
+    }
+  }
+
+  DefinedAtom &addDefinedAtom(ELFSection &S, const object::SymbolRef &Sym,
+                              uint64_t Offset, uint32_t Align) {
+    StringRef Name = cantFail(Sym.getName());
+    uint32_t Flags = Sym.getFlags();
+
+    LLVM_DEBUG({
+      dbgs() << "Adding defined atom \"" << Name
+             << "\" addr: " << format("0x%016" PRIx64, S.Address + Offset)
+             << ", align: " << Align
+             << ", section: " << S.GenericSection->getName() << "\n";
+    });
+
+    auto &DA = AnonymousSymbols.count(Sym)
+                   ? G->addAnonymousAtom(*S.GenericSection,
+                                         S.Address + Offset, Align)
+                   : G->addDefinedAtom(*S.GenericSection, Name,
+                                       S.Address + Offset, Align);
+    DA.setGlobal(Flags & object::SymbolRef::SF_Global);
+    DA.setExported(Flags & object::SymbolRef::SF_Exported);
+    DA.setWeak(Flags & object::SymbolRef::SF_Weak);
+    DA.setCallable(object::ELFSymbolRef(Sym).getELFType() == ELF::STT_FUNC);
+    SymbolAtoms[Sym] = &DA;
+    return DA;
+  }
+
+  Error addRelocations() {
+    using namespace support;
+
+    for (auto &RelSec : Obj.sections()) {
+      auto TargetSecItr = RelSec.getRelocatedSection();
+      if (TargetSecItr == Obj.section_end())
+        continue;
+
+      // Relocations for sections that are not loaded are ignored.
+      auto SI = Sections.find(TargetSecItr->getIndex());
+      if (SI == Sections.end())
+        continue;
+      auto &S = SI->second;
+
+      if (object::ELFSectionRef(RelSec).getType() != ELF::SHT_RELA)
+        return make_error<JITLinkError>(
+            "x86-64 relocations must use SHT_RELA sections");
+
+      for (auto &Rel : RelSec.relocations()) {
+        if (Rel.getType() == ELF::R_X86_64_NONE)
+          continue;
+
+        auto Kind = getRelocationKind(Rel.getType());
+        if (!Kind)
+          return Kind.takeError();
+
+        auto Addend = object::ELFRelocationRef(Rel).getAddend();
+        if (!Addend)
+          return Addend.takeError();
+
+        JITTargetAddress FixupAddress = S.Address + Rel.getOffset();
+
+        LLVM_DEBUG({
+          dbgs() << "Processing relocation at "
+                 << format("0x%016" PRIx64, FixupAddress) << "\n";
+        });
+
+        auto AtomToFix = G->findAtomByAddress(FixupAddress);
+        if (!AtomToFix)
+          return AtomToFix.takeError();
+
+        if (FixupAddress + getFixupSize(*Kind) >
+            AtomToFix->getAddress() + AtomToFix->getSize())
+          return make_error<JITLinkError>(
+              "Relocation content extends past end of fixup atom");
+
+        Atom *TargetAtom = nullptr;
+        Edge::AddendT EdgeAddend = *Addend;
+        if (auto Err =
+                findTarget(Rel, *Kind, S.IsCode, TargetAtom, EdgeAddend))
+          return Err;
+
+        if (isGOTLoad(*Kind) && !TargetAtom->hasName())
+          return make_error<JITLinkError>(
+              "GOT load from an anonymous atom not supported");
+
+        LLVM_DEBUG({
+          Edge GE(*Kind, FixupAddress - AtomToFix->getAddress(), *TargetAtom,
+                  EdgeAddend);
+          printEdge(dbgs(), *AtomToFix, GE, getELFX86RelocationKindName(*Kind));
+          dbgs() << "\n";
+        });
+        AtomToFix->addEdge(*Kind, FixupAddress - AtomToFix->getAddress(),
+                           *TargetAtom, EdgeAddend);
+      }
+    }
+
+    return Error::success();
+  }
+
+  // Find the target atom of Rel and rebase Addend onto it. InCode is true if
+  // the fixup is in an instruction.
+  Error findTarget(const object::RelocationRef &Rel, ELFX86RelocationKind Kind,
+                   bool InCode, Atom *&TargetAtom, Edge::AddendT &Addend) {
+    auto SymI = Rel.getSymbol();
+    if (SymI == Obj.symbol_end())
+      return make_error<JITLinkError>("Relocation has no symbol");
+
+    if (object::ELFSymbolRef(*SymI).getELFType() != ELF::STT_SECTION) {
+      auto SAI = SymbolAtoms.find(*SymI);
+      if (SAI == SymbolAtoms.end()) {
+        auto Name = SymI->getName();
+        if (!Name)
+          return Name.takeError();
+        return make_error<JITLinkError>("Relocation refers to symbol " +
+                                        *Name + ", which has no atom");
+      }
+      TargetAtom = SAI->second;
+      return Error::success();
+    }
+
+    // References to static data and functions are usually made relative to
+    // the section symbol. Find the atom that holds the referenced location
+    // and rebase the addend onto it.
+    auto SecItr = SymI->getSection();
+    if (!SecItr)
+      return SecItr.takeError();
+    auto SI = Sections.find((*SecItr)->getIndex());
+    if (SI == Sections.end() || !SI->second.Size)
+      return make_error<JITLinkError>(
+          "Relocation refers to a section that is not loaded");
+    auto &TargetSec = SI->second;
+
+    JITTargetAddress TargetAddress = TargetSec.Address + Addend;
+
+    // In an instruction, a PC-relative addend is biased by the distance from
+    // the fixup to the end of the instruction, which is usually the fixup
+    // size. PC-relative data (e.g. an FDE's pc-begin) is not biased.
+    JITTargetAddress LookupAddress = TargetAddress;
+    if (InCode && (Kind == PCRel32 || Kind == Branch32))
+      LookupAddress += 4;
+    LookupAddress =
+        std::min(std::max(LookupAddress, TargetSec.Address),
+                 TargetSec.Address + TargetSec.Size - 1);
+
+    auto TargetAtomOrErr = G->findAtomByAddress(LookupAddress);
+    if (!TargetAtomOrErr)
+      return TargetAtomOrErr.takeError();
+    TargetAtom = &*TargetAtomOrErr;
+    Addend = TargetAddress - TargetAtom->getAddress();
+    return Error::success();
+  }
+
+  static uint32_t getAtomAlignment(const ELFSection &S, uint64_t Offset) {
+    // ELF symbols carry no alignment: use the strictest alignment that keeps
+    // the symbol at its offset from the (aligned) start of the section.
+    uint32_t SectionAlign = S.GenericSection->getAlignment();
+    if (Offset == 0)
+      return SectionAlign;
+    return std::min<uint64_t>(SectionAlign, 1ULL << countTrailingZeros(Offset));
+  }
+
+  JITTargetAddress allocateAddress(uint64_t Size, uint64_t Align) {
+    JITTargetAddress Addr = alignTo(NextAddress, Align);
+    // Give empty sections a distinct address too.
+    NextAddress = Addr + std::max<uint64_t>(Size, 1);
+    return Addr;
+  }
+
+  Section &getCommonSection() {
+    if (!CommonSection) {
+      auto Prot = static_cast<sys::Memory::ProtectionFlags>(
+          sys::Memory::MF_READ | sys::Memory::MF_WRITE);
+      CommonSection = &G->createSection("<common>", 1, Prot, true);
+    }
+    return *CommonSection;
+  }
+
+  const object::ELF64LEObjectFile &Obj;
+  std::unique_ptr<AtomGraph> G;
+  std::map<unsigned, ELFSection> Sections;
+  std::map<object::SymbolRef, Atom *> SymbolAtoms;
+  std::set<object::SymbolRef> AnonymousSymbols;
+  std::vector<DefinedAtom *> FDEs;
+  Section *CommonSection = nullptr;
+  JITTargetAddress NextAddress = 0;
+};
+
+class ELF_x86_64_GOTAndStubsBuilder
+    : public BasicGOTAndStubsBuilder<ELF_x86_64_GOTAndStubsBuilder> {
+public:
+  ELF_x86_64_GOTAndStubsBuilder(AtomGraph &G)
+      : BasicGOTAndStubsBuilder<ELF_x86_64_GOTAndStubsBuilder>(G) {}
+
+  bool isGOTEdge(Edge &E) const {
+    return E.getKind() == PCRel32GOTLoad ||
+           E.getKind() == PCRel32GOTLoadRelaxable ||
+           E.getKind() == PCRel32REXGOTLoadRelaxable;
+  }
+
+  DefinedAtom &createGOTEntry(Atom &Target) {
+    auto &GOTEntryAtom = G.addAnonymousAtom(getGOTSection(), 0x0, 8);
+    GOTEntryAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(NullGOTEntryContent), 8));
+    GOTEntryAtom.addEdge(Pointer64, 0, Target, 0);
+    return GOTEntryAtom;
+  }
+
+  void fixGOTEdge(Edge &E, Atom &GOTEntry) {
+    assert(isGOTEdge(E) && "Not a GOT edge?");
+    // Relaxable loads keep a kind of their own, so that the fixup can bypass
+    // the GOT entry once the target address is known.
+    E.setKind(E.getKind() == PCRel32GOTLoad ? PCRel32
+                                            : PCRel32GOTEntryRelaxable);
+    E.setTarget(GOTEntry);
+    // Leave the edge addend as-is.
+  }
+
+  bool isExternalBranchEdge(Edge &E) {
+    return E.getKind() == Branch32 && !E.getTarget().isDefined();
+  }
+
+  DefinedAtom &createStub(Atom &Target) {
+    auto &StubAtom = G.addAnonymousAtom(getStubsSection(), 0x0, 2);
+    StubAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(StubContent), 6));
+
+    // Re-use GOT entries for stub targets.
+    auto &GOTEntryAtom = getGOTEntryAtom(Target);
+    StubAtom.addEdge(PCRel32, 2, GOTEntryAtom, -4);
+
+    return StubAtom;
+  }
+
+  void fixExternalBranchEdge(Edge &E, Atom &Stub) {
+    assert(E.getKind() == Branch32 && "Not a Branch32 edge?");
+    E.setTarget(Stub);
+  }
+
+private:
+  Section &getGOTSection() {
+    if (!GOTSection)
+      GOTSection = &G.createSection("$__GOT", 8, sys::Memory::MF_READ, false);
+    return *GOTSection;
+  }
+
+  Section &getStubsSection() {
+    if (!StubsSection) {
+      auto StubsProt = static_cast<sys::Memory::ProtectionFlags>(
+          sys::Memory::MF_READ | sys::Memory::MF_EXEC);
+      StubsSection = &G.createSection("$__STUBS", 8, StubsProt, false);
+    }
+    return *StubsSection;
+  }
+
+  static const uint8_t NullGOTEntryContent[8];
+  static const uint8_t StubContent[6];
+  Section *GOTSection = nullptr;
+  Section *StubsSection = nullptr;
+};
+
+const uint8_t ELF_x86_64_GOTAndStubsBuilder::NullGOTEntryContent[8] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+const uint8_t ELF_x86_64_GOTAndStubsBuilder::StubContent[6] = {
+    0xFF, 0x25, 0x00, 0x00, 0x00, 0x00};
+} // namespace
+
+namespace llvm {
+namespace jitlink {
+
+class ELFJITLinker_x86_64 : public JITLinker<ELFJITLinker_x86_64> {
+  friend class JITLinker<ELFJITLinker_x86_64>;
+
+public:
+  ELFJITLinker_x86_64(std::unique_ptr<JITLinkContext> Ctx,
+                      PassConfiguration PassConfig)
+      : JITLinker(std::move(Ctx), std::move(PassConfig)) {}
+
+private:
+  StringRef getEdgeKindName(Edge::Kind R) const override {
+    return getELFX86RelocationKindName(R);
+  }
+
+  Expected<std::unique_ptr<AtomGraph>>
+  buildGraph(MemoryBufferRef ObjBuffer) override {
+    auto ELFObj = object::ObjectFile::createELFObjectFile(ObjBuffer);
+    if (!ELFObj)
+      return ELFObj.takeError();
+    auto *ELF64LEObj = dyn_cast<object::ELF64LEObjectFile>(ELFObj->get());
+    if (!ELF64LEObj)
+      return make_error<JITLinkError>("Object is not ELF64 little-endian");
+    return ELFAtomGraphBuilder_x86_64(*ELF64LEObj).buildGraph();
+  }
+
+  static Error targetOutOfRangeError(const Atom &A, const Edge &E) {
+    std::string ErrMsg;
+    {
+      raw_string_ostream ErrStream(ErrMsg);
+      ErrStream << "Relocation target out of range: ";
+      printEdge(ErrStream, A, E, getELFX86RelocationKindName(E.getKind()));
+      ErrStream << "\n";
+    }
+    return make_error<JITLinkError>(std::move(ErrMsg));
+  }
+
+  // Rewrite the instruction whose GOT-relative displacement is at FixupPtr
+  // to refer to the target directly, where Value is the displacement from
+  // the fixup to the target. Returns false if the instruction can not be
+  // rewritten.
+  static bool relaxGOTLoad(uint8_t *FixupPtr, int64_t Value) {
+    using namespace support;
+
+    uint8_t &Op = FixupPtr[-2];
+    uint8_t &ModRM = FixupPtr[-1];
+    if (Op == 0x8b) {
+      Op = 0x8d;
+      *(little32_t *)FixupPtr = Value;
+      return true;
+    }
+    if (Op == 0xff && ModRM == 0x15) {
+      // The addr32 prefix pads the call to its original size.
+      Op = 0x67;
+      ModRM = 0xe8;
+      *(little32_t *)FixupPtr = Value;
+      return true;
+    }
+    if (Op == 0xff && ModRM == 0x25) {
+      // The jmp is one byte shorter, so its displacement starts one byte
+      // earlier and is one larger. A nop pads it to its original size.
+      Op = 0xe9;
+      *(little32_t *)(FixupPtr - 1) = Value + 1;
+      FixupPtr[3] = 0x90;
+      return true;
+    }
+    return false;
+  }
+
+  Error applyFixup(DefinedAtom &A, const Edge &E, char *AtomWorkingMem) const {
+    using namespace support;
+
+    char *FixupPtr = AtomWorkingMem + E.getOffset();
+    JITTargetAddress FixupAddress = A.getAddress() + E.getOffset();
+
+    switch (E.getKind()) {
+    case PCRel32GOTEntryRelaxable: {
+      // If the target is close enough, bypass the GOT entry and leave it
+      // unused. The rewrites are those of the x86-64 psABI:
+      //   mov foo@GOTPCREL(%rip), %reg  ->  lea foo(%rip), %reg
+      //   call *foo@GOTPCREL(%rip)      ->  addr32 call foo
+      //   jmp *foo@GOTPCREL(%rip)       ->  jmp foo; nop
+      // Other instructions (e.g. test and the ALU instructions) could only
+      // be relaxed to an absolute immediate, so they keep using the GOT.
+      auto &GOTEntry = static_cast<DefinedAtom &>(E.getTarget());
+      assert(!GOTEntry.edges_empty() && "GOT entry has no target");
+      auto &GOTEdge = *GOTEntry.edges().begin();
+      int64_t Value = GOTEdge.getTarget().getAddress() + GOTEdge.getAddend() -
+                      FixupAddress + E.getAddend();
+      if (E.getOffset() >= 2 && isInt<32>(Value) &&
+          relaxGOTLoad(reinterpret_cast<uint8_t *>(FixupPtr), Value))
+        break;
+      LLVM_FALLTHROUGH;
+    }
+    case Branch32:
+    case PCRel32: {
+      int64_t Value =
+          E.getTarget().getAddress() - FixupAddress + E.getAddend();
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer64: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      *(ulittle64_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer32: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      if (!isUInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(ulittle32_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer32Signed: {
+      int64_t Value = E.getTarget().getAddress() + E.getAddend();
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case Delta64: {
+      int64_t Value =
+          E.getTarget().getAddress() - FixupAddress + E.getAddend();
+      *(little64_t *)FixupPtr = Value;
+      break;
+    }
+    case NegDelta32: {
+      int64_t Value =
+          FixupAddress - E.getTarget().getAddress() + E.getAddend();
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    default:
+      llvm_unreachable("Unrecognized edge kind");
+    }
+
+    return Error::success();
+  }
+};
+
+void jitLink_ELF_x86_64(std::unique_ptr<JITLinkContext> Ctx) {
+  PassConfiguration Config;
+  Triple TT("x86_64-unknown-linux");
+
+  if (Ctx->shouldAddDefaultTargetPasses(TT)) {
+    // Add a mark-live pass.
+    if (auto MarkLive = Ctx->getMarkLivePass(TT))
+      Config.PrePrunePasses.push_back(std::move(MarkLive));
+    else
+      Config.PrePrunePasses.push_back(markAllAtomsLive);
+
+    // Add an in-place GOT/Stubs pass.
+    Config.PostPrunePasses.push_back([](AtomGraph &G) -> Error {
+      ELF_x86_64_GOTAndStubsBuilder(G).run();
+      return Error::success();
+    });
+  }
+
+  if (auto Err = Ctx->modifyPassConfig(TT, Config))
+    return Ctx->notifyFailed(std::move(Err));
+
+  // Construct a JITLinker and run the link function.
+  ELFJITLinker_x86_64::link(std::move(Ctx), std::move(Config));
+}
+
+StringRef getELFX86RelocationKindName(Edge::Kind R) {
+  switch (R) {
+  case Branch32:
+    return "Branch32";
+  case Pointer32:
+    return "Pointer32";
+  case Pointer32Signed:
+    return "Pointer32Signed";
+  case Pointer64:
+    return "Pointer64";
+  case PCRel32:
+    return "PCRel32";
+  case PCRel32GOTLoad:
+    return "PCRel32GOTLoad";
+  case PCRel32GOTLoadRelaxable:
+    return "PCRel32GOTLoadRelaxable";
+  case PCRel32REXGOTLoadRelaxable:
+    return "PCRel32REXGOTLoadRelaxable";
+  case PCRel32GOTEntryRelaxable:
+    return "PCRel32GOTEntryRelaxable";
+  case Delta64:
+    return "Delta64";
+  case NegDelta32:
+    return "NegDelta32";
+  default:
+    return getGenericEdgeKindName(static_cast<Edge::Kind>(R));
+  }
+}
+
+} // end namespace jitlink
+} // end namespace llvm
@@ -121,6 +121,16 @@ void CompileOnDemandLayer::setPartitionFunction(PartitionFunction Partition) {
 void CompileOnDemandLayer::setImplMap(ImplSymbolMap *Imp) {
   this->AliaseeImpls = Imp;
 }
+
+IndirectStubsManager *
+CompileOnDemandLayer::getImplDylibStubsManager(const JITDylib &ImplD) {
+  std::lock_guard<std::mutex> Lock(CODLayerMutex);
+  for (auto &KV : DylibResources)
+    if (&KV.second.getImplDylib() == &ImplD)
+      return &KV.second.getISManager();
+  return nullptr;
+}
+
 void CompileOnDemandLayer::emit(MaterializationResponsibility R,
                                 ThreadSafeModule TSM) {
   assert(TSM && "Null module");
@@ -169,6 +179,7 @@ void CompileOnDemandLayer::emit(MaterializationResponsibility R,
 
 CompileOnDemandLayer::PerDylibResources &
 CompileOnDemandLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(CODLayerMutex);
   auto I = DylibResources.find(&TargetD);
   if (I == DylibResources.end()) {
     auto &ImplD = getExecutionSession().createJITDylib(
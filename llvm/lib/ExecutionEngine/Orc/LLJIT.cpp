@@ -30,6 +30,8 @@ Error LLJITBuilderState::prepareForConstruction() {
 LLJIT::~LLJIT() {
   if (CompileThreads)
     CompileThreads->wait();
+  if (Dispatcher)
+    Dispatcher->wait();
 }
 
 Error LLJIT::defineAbsolute(StringRef Name, JITEvaluatedSymbol Sym) {
@@ -91,14 +93,14 @@ LLJIT::createCompileFunction(LLJITBuilderState &S,
 
   // Otherwise default to creating a SimpleCompiler, or ConcurrentIRCompiler,
   // depending on the number of threads requested.
-  if (S.NumCompileThreads > 0)
-    return ConcurrentIRCompiler(std::move(JTMB));
+  if (S.isConcurrent())
+    return ConcurrentIRCompiler(std::move(JTMB), S.ObjCache);
 
   auto TM = JTMB.createTargetMachine();
   if (!TM)
     return TM.takeError();
 
-  return TMOwningSimpleCompiler(std::move(*TM));
+  return TMOwningSimpleCompiler(std::move(*TM), S.ObjCache);
 }
 
 LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
@@ -127,7 +129,11 @@ LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
         *ES, *ObjLinkingLayer, std::move(*CompileFunction));
   }
 
-  if (S.NumCompileThreads > 0) {
+  if (S.Dispatcher) {
+    CompileLayer->setCloneToNewContextOnEmit(true);
+    Dispatcher = std::move(S.Dispatcher);
+    ES->setDispatchMaterialization(Dispatcher->getDispatchFunction());
+  } else if (S.NumCompileThreads > 0) {
     CompileLayer->setCloneToNewContextOnEmit(true);
     CompileThreads = std::make_unique<ThreadPool>(S.NumCompileThreads);
     ES->setDispatchMaterialization(
@@ -170,6 +176,26 @@ Error LLLazyJITBuilderState::prepareForConstruction() {
   if (auto Err = LLJITBuilderState::prepareForConstruction())
     return Err;
   TT = JTMB->getTargetTriple();
+
+  if (TieredCompilation) {
+    // The configured target machine compiles the second tier. Both tiers may
+    // compile at the same time, since the second compiles in the background.
+    OptimizingJTMB = *JTMB;
+    JTMB->setCodeGenOptLevel(CodeGenOpt::None);
+    if (!CreateCompileFunction) {
+      auto *Cache = ObjCache;
+      CreateOptimizingCompileFunction = [Cache](JITTargetMachineBuilder JTMB)
+          -> Expected<IRCompileLayer::CompileFunction> {
+        return ConcurrentIRCompiler(std::move(JTMB), Cache);
+      };
+      CreateCompileFunction = [](JITTargetMachineBuilder JTMB)
+          -> Expected<IRCompileLayer::CompileFunction> {
+        return ConcurrentIRCompiler(std::move(JTMB));
+      };
+    } else
+      CreateOptimizingCompileFunction = CreateCompileFunction;
+  }
+
   return Error::success();
 }
 
@@ -225,15 +251,44 @@ LLLazyJIT::LLLazyJIT(LLLazyJITBuilderState &S, Error &Err) : LLJIT(S, Err) {
     return;
   }
 
-  // Create the transform layer.
-  TransformLayer = std::make_unique<IRTransformLayer>(*ES, *CompileLayer);
+  if (!S.TieredCompilation) {
+    // Create the transform layer.
+    TransformLayer = std::make_unique<IRTransformLayer>(*ES, *CompileLayer);
+
+    // Create the COD layer.
+    CODLayer = std::make_unique<CompileOnDemandLayer>(
+        *ES, *TransformLayer, *LCTMgr, std::move(ISMBuilder));
+
+    if (S.NumCompileThreads > 0 || Dispatcher)
+      CODLayer->setCloneToNewContextOnEmit(true);
+    return;
+  }
+
+  // With tiered compilation the COD layer emits instrumented code straight
+  // to the -O0 compile layer, and hot code goes through the transform layer
+  // to the optimizing compile layer.
+  auto OptimizingCompileFunction =
+      S.CreateOptimizingCompileFunction(std::move(*S.OptimizingJTMB));
+  if (!OptimizingCompileFunction) {
+    Err = OptimizingCompileFunction.takeError();
+    return;
+  }
+  OptimizingCompileLayer = std::make_unique<IRCompileLayer>(
+      *ES, *ObjLinkingLayer, std::move(*OptimizingCompileFunction));
+  CompileLayer->setCloneToNewContextOnEmit(true);
+  OptimizingCompileLayer->setCloneToNewContextOnEmit(true);
+
+  TransformLayer =
+      std::make_unique<IRTransformLayer>(*ES, *OptimizingCompileLayer);
+  InstrumentLayer = std::make_unique<IRTransformLayer>(*ES, *CompileLayer);
 
-  // Create the COD layer.
   CODLayer = std::make_unique<CompileOnDemandLayer>(
-      *ES, *TransformLayer, *LCTMgr, std::move(ISMBuilder));
+      *ES, *InstrumentLayer, *LCTMgr, std::move(ISMBuilder));
+  CODLayer->setCloneToNewContextOnEmit(true);
 
-  if (S.NumCompileThreads > 0)
-    CODLayer->setCloneToNewContextOnEmit(true);
+  TieredCompilation = std::make_unique<TieredCompilationManager>(
+      *ES, *CODLayer, *TransformLayer, std::move(*S.TieredCompilation));
+  InstrumentLayer->setTransform(TieredCompilation->getInstrumentFunction());
 }
 
 } // End namespace orc.
@@ -50,6 +50,10 @@ LazyCallThroughManager::callThroughToSymbol(JITTargetAddress TrampolineAddr) {
     SourceJD = I->second.first;
     SymbolName = I->second.second;
   }
+
+  if (NotifyCallThrough)
+    NotifyCallThrough(*SourceJD, SymbolName);
+
   auto LookupResult =
       ES.lookup(JITDylibSearchList({{SourceJD, true}}), SymbolName);
 
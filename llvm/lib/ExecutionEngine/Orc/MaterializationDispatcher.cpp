@@ -0,0 +1,177 @@
+//===- MaterializationDispatcher.cpp - Dispatch MU materialization --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/MaterializationDispatcher.h"
+
+#include <algorithm>
+
+namespace llvm {
+namespace orc {
+
+MaterializationDispatcher::~MaterializationDispatcher() {}
+
+ExecutionSession::DispatchMaterializationFunction
+MaterializationDispatcher::getDispatchFunction() {
+  return [this](JITDylib &JD, std::unique_ptr<MaterializationUnit> MU) {
+    dispatch(JD, std::move(MU));
+  };
+}
+
+PriorityMaterializationDispatcher::PriorityMaterializationDispatcher(
+    Options Opts)
+    : Opts(std::move(Opts)) {
+#if LLVM_ENABLE_THREADS
+  unsigned NumThreads = std::max(this->Opts.NumThreads, 1U);
+  Threads.reserve(NumThreads);
+  for (unsigned I = 0; I != NumThreads; ++I)
+    Threads.emplace_back([this]() { runWorker(); });
+#endif
+}
+
+PriorityMaterializationDispatcher::~PriorityMaterializationDispatcher() {
+  wait();
+#if LLVM_ENABLE_THREADS
+  {
+    std::lock_guard<std::mutex> Lock(QueueMutex);
+    Stopping = true;
+  }
+  QueueCondition.notify_all();
+  for (std::thread &T : Threads)
+    T.join();
+#endif
+}
+
+// The queue is a max-heap, so the task that "runs after" every other one is
+// at the bottom: lower priorities run later, and equal priorities run in
+// dispatch order.
+bool PriorityMaterializationDispatcher::runsAfter(const Task &LHS,
+                                                  const Task &RHS) {
+  if (LHS.Priority != RHS.Priority)
+    return LHS.Priority < RHS.Priority;
+  return LHS.Seq > RHS.Seq;
+}
+
+void PriorityMaterializationDispatcher::dispatch(
+    JITDylib &JD, std::unique_ptr<MaterializationUnit> MU) {
+  Task T;
+  T.JD = &JD;
+  T.Priority = Opts.GetPriority ? Opts.GetPriority(JD, *MU) : 0;
+  T.DispatchTime = Clock::now();
+  if (Opts.GetDeadline)
+    T.Deadline = Opts.GetDeadline(JD, *MU);
+  T.MU = std::move(MU);
+
+  bool Inline;
+  {
+    std::lock_guard<std::mutex> Lock(QueueMutex);
+    ++Stats.NumDispatched;
+    T.MustMaterialize = Returning.erase(T.MU.get());
+#if LLVM_ENABLE_THREADS
+    Inline = Opts.MaxQueueDepth && Queue.size() >= Opts.MaxQueueDepth;
+#else
+    Inline = true;
+#endif
+    if (!Inline) {
+      T.Seq = NextSeq++;
+      Queue.push_back(std::move(T));
+      std::push_heap(Queue.begin(), Queue.end(), runsAfter);
+      Stats.MaxQueueDepth = std::max(Stats.MaxQueueDepth, Queue.size());
+    }
+  }
+
+  if (Inline)
+    runTask(T, /*Inline=*/true);
+  else
+    QueueCondition.notify_one();
+}
+
+void PriorityMaterializationDispatcher::wait() {
+#if LLVM_ENABLE_THREADS
+  std::unique_lock<std::mutex> Lock(QueueMutex);
+  DoneCondition.wait(Lock, [&]() { return Queue.empty() && !NumActive; });
+#endif
+}
+
+PriorityMaterializationDispatcher::Statistics
+PriorityMaterializationDispatcher::getStatistics() const {
+  std::lock_guard<std::mutex> Lock(QueueMutex);
+  Statistics Result = Stats;
+  Result.QueueDepth = Queue.size();
+  return Result;
+}
+
+void PriorityMaterializationDispatcher::runTask(Task &T, bool Inline) {
+  Clock::time_point Start = Clock::now();
+  bool Expired = !T.MustMaterialize && T.Deadline && Start > *T.Deadline;
+  bool Cancelled = !T.MustMaterialize && !Expired && Opts.IsCancelled &&
+                   Opts.IsCancelled(*T.JD, *T.MU);
+
+  // A unit that is handed back while queries are waiting on it is dispatched
+  // again right away, which clears its entry in Returning. It is counted when
+  // that dispatch runs.
+  bool Redispatched = false;
+  if (Expired || Cancelled) {
+    const MaterializationUnit *MU = T.MU.get();
+    {
+      std::lock_guard<std::mutex> Lock(QueueMutex);
+      Returning.insert(MU);
+    }
+    MaterializationUnit::doReturnToJITDylib(*T.JD, std::move(T.MU));
+    std::lock_guard<std::mutex> Lock(QueueMutex);
+    Redispatched = !Returning.erase(MU);
+  } else {
+    T.MU->doMaterialize(*T.JD);
+    T.MU.reset();
+  }
+
+  Clock::duration QueueTime = Start - T.DispatchTime;
+  Clock::duration MaterializeTime = Clock::now() - Start;
+
+  std::lock_guard<std::mutex> Lock(QueueMutex);
+  Stats.TotalQueueTime += QueueTime;
+  Stats.MaxQueueTime = std::max(Stats.MaxQueueTime, QueueTime);
+  if (Redispatched)
+    return;
+  if (Expired) {
+    ++Stats.NumExpired;
+  } else if (Cancelled) {
+    ++Stats.NumCancelled;
+  } else {
+    ++Stats.NumMaterialized;
+    if (Inline)
+      ++Stats.NumMaterializedInline;
+    Stats.TotalMaterializeTime += MaterializeTime;
+    Stats.MaxMaterializeTime =
+        std::max(Stats.MaxMaterializeTime, MaterializeTime);
+  }
+}
+
+void PriorityMaterializationDispatcher::runWorker() {
+  std::unique_lock<std::mutex> Lock(QueueMutex);
+  while (true) {
+    QueueCondition.wait(Lock, [&]() { return Stopping || !Queue.empty(); });
+    if (Queue.empty())
+      return;
+
+    std::pop_heap(Queue.begin(), Queue.end(), runsAfter);
+    Task T = std::move(Queue.back());
+    Queue.pop_back();
+    ++NumActive;
+
+    Lock.unlock();
+    runTask(T, /*Inline=*/false);
+    Lock.lock();
+
+    --NumActive;
+    if (Queue.empty() && !NumActive)
+      DoneCondition.notify_all();
+  }
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -0,0 +1,166 @@
+//===------- PersistentObjectCache.cpp - On-disk cache for JIT'd objects --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace orc {
+
+// Describe everything about the target machine that changes the code it
+// generates, other than the module itself.
+static std::string getTargetKey(const JITTargetMachineBuilder &JTMB) {
+  std::string Key;
+  raw_string_ostream OS(Key);
+  const TargetOptions &Options = JTMB.getOptions();
+  OS << LLVM_VERSION_STRING << ';' << JTMB.getTargetTriple().str() << ';'
+     << JTMB.getCPU() << ';' << JTMB.getFeatures().getString() << ';'
+     << (JTMB.getRelocationModel() ? int(*JTMB.getRelocationModel()) : -1)
+     << ';' << (JTMB.getCodeModel() ? int(*JTMB.getCodeModel()) : -1) << ';'
+     << int(JTMB.getCodeGenOptLevel()) << ';' << Options.EmulatedTLS
+     << Options.ExplicitEmulatedTLS << Options.UnsafeFPMath
+     << Options.NoInfsFPMath << Options.NoNaNsFPMath
+     << Options.NoSignedZerosFPMath << Options.FunctionSections
+     << Options.DataSections << ';' << int(Options.FloatABIType) << ';'
+     << int(Options.AllowFPOpFusion) << ';' << int(Options.ThreadModel) << ';'
+     << int(Options.ExceptionModel);
+  return OS.str();
+}
+
+Expected<std::unique_ptr<PersistentObjectCache>>
+PersistentObjectCache::Create(StringRef CacheDir,
+                              const JITTargetMachineBuilder &JTMB,
+                              CachePruningPolicy Policy) {
+  if (auto EC = sys::fs::create_directories(CacheDir))
+    return make_error<StringError>("Could not create object cache directory " +
+                                       CacheDir + ": " + EC.message(),
+                                   EC);
+
+  std::unique_ptr<PersistentObjectCache> Cache(new PersistentObjectCache(
+      CacheDir, getTargetKey(JTMB), std::move(Policy)));
+  Cache->prune();
+  return std::move(Cache);
+}
+
+PersistentObjectCache::PersistentObjectCache(std::string CacheDir,
+                                             std::string TargetKey,
+                                             CachePruningPolicy Policy)
+    : CacheDir(std::move(CacheDir)), TargetKey(std::move(TargetKey)),
+      Policy(std::move(Policy)) {}
+
+std::string PersistentObjectCache::getEntryPath(const Module &M) const {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(TargetKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+
+  // This choice of file name allows the cache to be pruned (see pruneCache()
+  // in include/llvm/Support/CachePruning.h).
+  SmallString<128> EntryPath(CacheDir);
+  sys::path::append(EntryPath, "llvmcache-" + toHex(Hasher.result()));
+  return EntryPath.str();
+}
+
+std::unique_ptr<MemoryBuffer>
+PersistentObjectCache::getObject(const Module *M) {
+  // Hash the module now: the code generator may still change it before
+  // notifyObjectCompiled is called.
+  std::string EntryPath = getEntryPath(*M);
+
+  std::unique_ptr<MemoryBuffer> Obj;
+  if (auto ObjOrErr = MemoryBuffer::getFile(EntryPath, /*FileSize=*/-1,
+                                            /*RequiresNullTerminator=*/false)) {
+    auto ObjFile =
+        object::ObjectFile::createObjectFile((*ObjOrErr)->getMemBufferRef());
+    if (ObjFile)
+      Obj = std::move(*ObjOrErr);
+    else
+      consumeError(ObjFile.takeError());
+  }
+
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  if (Obj) {
+    ++Stats.NumHits;
+    return Obj;
+  }
+  ++Stats.NumMisses;
+  MissedEntries[M] = std::move(EntryPath);
+  return nullptr;
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const Module *M,
+                                                 MemoryBufferRef Obj) {
+  std::string EntryPath;
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    auto I = MissedEntries.find(M);
+    if (I != MissedEntries.end()) {
+      EntryPath = std::move(I->second);
+      MissedEntries.erase(I);
+    }
+  }
+  if (EntryPath.empty())
+    EntryPath = getEntryPath(*M);
+
+  // Write to a temporary file and rename it into place, so that concurrent
+  // readers never see a partial entry.
+  SmallString<128> TempFileModel(CacheDir);
+  sys::path::append(TempFileModel, "Orc-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFileModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+
+  bool WriteFailed;
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    OS << Obj.getBuffer();
+    OS.flush();
+    WriteFailed = OS.has_error();
+    OS.clear_error();
+  }
+  if (WriteFailed) {
+    consumeError(Temp->discard());
+    return;
+  }
+  if (auto Err = Temp->keep(EntryPath)) {
+    consumeError(std::move(Err));
+    consumeError(Temp->discard());
+    return;
+  }
+
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  ++Stats.NumStored;
+}
+
+void PersistentObjectCache::prune() { pruneCache(CacheDir, Policy); }
+
+PersistentObjectCache::Statistics
+PersistentObjectCache::getStatistics() const {
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  return Stats;
+}
+
+} // end namespace orc
+} // end namespace llvm
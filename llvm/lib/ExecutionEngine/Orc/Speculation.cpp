@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ExecutionEngine/Orc/Speculation.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
 
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Function.h"
@@ -17,6 +18,9 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include <vector>
 
@@ -87,6 +91,120 @@ void IRSpeculationLayer::emit(MaterializationResponsibility R,
   NextLayer.emit(std::move(R), std::move(TSM));
 }
 
+// CallSequenceSpeculator methods
+void CallSequenceSpeculator::attach(LazyCallThroughManager &LCTMgr) {
+  LCTMgr.setNotifyCallThrough(
+      [this](JITDylib &SourceJD, const SymbolStringPtr &SymbolName) {
+        notifyCallThrough(SymbolName);
+      });
+}
+
+void CallSequenceSpeculator::notifyCallThrough(const SymbolStringPtr &Name) {
+  std::vector<SymbolStringPtr> Candidates;
+  {
+    std::lock_guard<std::mutex> Lockit(ConcurrentAccess);
+    // Several threads may race through the same trampoline.
+    if (!Called.insert(*Name).second)
+      return;
+
+    for (auto &Caller : Recent)
+      ++Profile[Caller][*Name];
+    Recent.push_back(*Name);
+    if (Recent.size() > Lookahead)
+      Recent.pop_front();
+
+    Candidates = getCandidates(*Name);
+  }
+
+  for (auto &Candidate : Candidates) {
+    auto ImplSymbol = AliaseeImplTable.getImplFor(Candidate);
+    if (!ImplSymbol.hasValue())
+      continue;
+    const auto &ImplSymbolName = ImplSymbol.getPointer()->first;
+    auto *ImplJD = ImplSymbol.getPointer()->second;
+    ES.lookup(JITDylibSearchList({{ImplJD, true}}),
+              SymbolNameSet({ImplSymbolName}), SymbolState::Ready,
+              [this](Expected<SymbolMap> Result) {
+                if (auto Err = Result.takeError())
+                  ES.reportError(std::move(Err));
+              },
+              NoDependenciesToRegister);
+  }
+}
+
+std::vector<SymbolStringPtr>
+CallSequenceSpeculator::getCandidates(StringRef Name) {
+  auto I = Profile.find(Name);
+  if (I == Profile.end())
+    return {};
+
+  std::vector<std::pair<StringRef, uint64_t>> Successors;
+  for (auto &KV : I->second)
+    if (!Called.count(KV.first()) && !Speculated.count(KV.first()))
+      Successors.push_back({KV.first(), KV.second});
+
+  // Most frequent first, then by name so that runs are reproducible.
+  llvm::sort(Successors, [](const std::pair<StringRef, uint64_t> &LHS,
+                            const std::pair<StringRef, uint64_t> &RHS) {
+    if (LHS.second != RHS.second)
+      return LHS.second > RHS.second;
+    return LHS.first < RHS.first;
+  });
+  if (Successors.size() > MaxCandidates)
+    Successors.resize(MaxCandidates);
+
+  std::vector<SymbolStringPtr> Candidates;
+  for (auto &S : Successors) {
+    Speculated.insert(S.first);
+    Candidates.push_back(ES.intern(S.first));
+  }
+  return Candidates;
+}
+
+// The profile is a text file with one "caller<TAB>callee<TAB>count" line per
+// edge of the summary.
+Error CallSequenceSpeculator::readProfile(StringRef Path) {
+  auto Buffer = MemoryBuffer::getFile(Path);
+  if (!Buffer)
+    return createFileError(Path, errorCodeToError(Buffer.getError()));
+
+  std::lock_guard<std::mutex> Lockit(ConcurrentAccess);
+  for (line_iterator I(**Buffer, /*SkipBlanks=*/true); !I.is_at_eof(); ++I) {
+    SmallVector<StringRef, 3> Fields;
+    I->split(Fields, '\t');
+    uint64_t Count;
+    if (Fields.size() != 3 || Fields[0].empty() || Fields[1].empty() ||
+        Fields[2].getAsInteger(10, Count))
+      return make_error<StringError>(
+          "Malformed speculation profile " + Path + " at line " +
+              Twine(I.line_number()),
+          inconvertibleErrorCode());
+    Profile[Fields[0]][Fields[1]] += Count;
+  }
+  return Error::success();
+}
+
+Error CallSequenceSpeculator::writeProfile(StringRef Path) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_Text);
+  if (EC)
+    return createFileError(Path, errorCodeToError(EC));
+
+  std::lock_guard<std::mutex> Lockit(ConcurrentAccess);
+  for (auto &Caller : Profile)
+    for (auto &Callee : Caller.second)
+      OS << Caller.first() << '\t' << Callee.first() << '\t' << Callee.second
+         << '\n';
+
+  OS.close();
+  if (OS.has_error()) {
+    EC = OS.error();
+    OS.clear_error();
+    return createFileError(Path, errorCodeToError(EC));
+  }
+  return Error::success();
+}
+
 // Runtime Function Implementation
 extern "C" void __orc_speculate_for(Speculator *Ptr, uint64_t StubId) {
   assert(Ptr && " Null Address Received in orc_speculate_for ");
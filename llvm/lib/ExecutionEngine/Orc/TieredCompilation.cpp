@@ -0,0 +1,211 @@
+//===--- TieredCompilation.cpp - Re-optimize hot lazily compiled code -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompilation.h"
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Mangler.h"
+#include "llvm/IR/Module.h"
+
+#include <algorithm>
+
+namespace llvm {
+namespace orc {
+
+TieredCompilationManager::TieredCompilationManager(
+    ExecutionSession &ES, CompileOnDemandLayer &CODLayer,
+    IRLayer &OptimizingLayer, Options Opts)
+    : ES(ES), CODLayer(CODLayer), OptimizingLayer(OptimizingLayer),
+      Opts(std::move(Opts)) {
+#if LLVM_ENABLE_THREADS
+  if (this->Opts.PollInterval.count())
+    PollThread = std::thread([this]() { runPollLoop(); });
+#endif
+}
+
+TieredCompilationManager::~TieredCompilationManager() {
+#if LLVM_ENABLE_THREADS
+  if (PollThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> Lock(StateMutex);
+      StopPolling = true;
+    }
+    PollCondition.notify_all();
+    PollThread.join();
+  }
+#endif
+}
+
+bool TieredCompilationManager::isTierable(const Function &F) {
+  return !F.isDeclaration() && !F.hasLocalLinkage() &&
+         !F.hasAvailableExternallyLinkage();
+}
+
+Expected<ThreadSafeModule>
+TieredCompilationManager::instrument(ThreadSafeModule TSM,
+                                     const MaterializationResponsibility &R) {
+  JITDylib &ImplD = R.getTargetJITDylib();
+  if (!CODLayer.getImplDylibStubsManager(ImplD))
+    return std::move(TSM);
+
+  auto P = std::make_unique<Partition>();
+  P->ImplD = &ImplD;
+  bool Tierable = TSM.withModuleDo([&](Module &M) {
+    // The optimized copy only defines the functions, so everything else it
+    // refers to has to be reachable by name.
+    for (auto &GV : M.global_values())
+      if (GV.hasLocalLinkage())
+        return false;
+
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    for (auto &F : M)
+      if (isTierable(F))
+        P->Functions.insert(Mangle(F.getName()));
+    return !P->Functions.empty();
+  });
+  if (!Tierable)
+    return std::move(TSM);
+
+  P->TSM = cloneToNewContext(TSM, [](const GlobalValue &GV) {
+    return isa<Function>(GV) && isTierable(cast<Function>(GV));
+  });
+  P->TSM.withModuleDo([](Module &M) {
+    // Static constructors have already been recorded by the JIT.
+    for (auto I = M.global_begin(), E = M.global_end(); I != E;) {
+      GlobalVariable &G = *I++;
+      if (G.hasAppendingLinkage())
+        G.eraseFromParent();
+    }
+  });
+
+  TSM.withModuleDo([&](Module &M) {
+    for (auto &F : M)
+      if (isTierable(F))
+        addCallCounter(F, P->Calls);
+  });
+
+  std::lock_guard<std::mutex> Lock(StateMutex);
+  Pending.push_back(P.get());
+  Partitions.push_back(std::move(P));
+  ++Stats.NumInstrumented;
+  return std::move(TSM);
+}
+
+IRTransformLayer::TransformFunction
+TieredCompilationManager::getInstrumentFunction() {
+  return [this](ThreadSafeModule TSM, const MaterializationResponsibility &R) {
+    return instrument(std::move(TSM), R);
+  };
+}
+
+void TieredCompilationManager::addCallCounter(Function &F,
+                                              std::atomic<uint64_t> &Calls) {
+  // The counter is only ever read as a hint, so a monotonic increment of the
+  // host object is all the first tier pays per call.
+  const DataLayout &DL = F.getParent()->getDataLayout();
+  LLVMContext &Ctx = F.getContext();
+  Type *CounterTy = Type::getInt64Ty(Ctx);
+  Constant *CounterAddr = ConstantInt::get(
+      DL.getIntPtrType(Ctx), static_cast<uint64_t>(pointerToJITTargetAddress(
+                                 static_cast<void *>(&Calls))));
+
+  IRBuilder<> Builder(&*F.getEntryBlock().getFirstInsertionPt());
+  Builder.CreateAtomicRMW(
+      AtomicRMWInst::Add,
+      ConstantExpr::getIntToPtr(CounterAddr, CounterTy->getPointerTo()),
+      ConstantInt::get(CounterTy, 1), AtomicOrdering::Monotonic);
+}
+
+JITDylib &TieredCompilationManager::getOptimizedDylib(JITDylib &ImplD) {
+  std::lock_guard<std::mutex> Lock(StateMutex);
+  auto I = OptimizedDylibs.find(&ImplD);
+  if (I != OptimizedDylibs.end())
+    return *I->second;
+
+  // Search the implementation dylib's order, which starts with the stubs, so
+  // that calls out of the optimized code can reach other optimized code.
+  auto &OptD = ES.createJITDylib(ImplD.getName() + ".opt", false);
+  ImplD.withSearchOrderDo([&](const JITDylibSearchList &ImplSearchOrder) {
+    OptD.setSearchOrder(ImplSearchOrder);
+  });
+  OptimizedDylibs[&ImplD] = &OptD;
+  return OptD;
+}
+
+Error TieredCompilationManager::reoptimize(Partition &P) {
+  auto *ISMgr = CODLayer.getImplDylibStubsManager(*P.ImplD);
+  assert(ISMgr && "Partition was not emitted by the CompileOnDemandLayer");
+
+  auto &OptD = getOptimizedDylib(*P.ImplD);
+  if (auto Err = OptimizingLayer.add(OptD, std::move(P.TSM),
+                                     ES.allocateVModule()))
+    return Err;
+
+  auto Bodies = ES.lookup(JITDylibSearchList({{&OptD, true}}), P.Functions);
+  if (!Bodies)
+    return Bodies.takeError();
+
+  // Functions that were never requested from the CompileOnDemandLayer have
+  // no stub yet. When they are, the stub resolves to the first-tier body.
+  for (auto &KV : *Bodies)
+    if (ISMgr->findStub(*KV.first, false))
+      if (auto Err = ISMgr->updatePointer(*KV.first, KV.second.getAddress()))
+        return Err;
+  return Error::success();
+}
+
+Error TieredCompilationManager::reoptimizeHotPartitions() {
+  std::vector<Partition *> Hot;
+  {
+    std::lock_guard<std::mutex> Lock(StateMutex);
+    auto I = std::stable_partition(
+        Pending.begin(), Pending.end(), [&](const Partition *P) {
+          return P->Calls.load(std::memory_order_relaxed) < Opts.HotCallCount;
+        });
+    Hot.assign(I, Pending.end());
+    Pending.erase(I, Pending.end());
+  }
+
+  Error Err = Error::success();
+  for (auto *P : Hot) {
+    Error PErr = reoptimize(*P);
+    std::lock_guard<std::mutex> Lock(StateMutex);
+    if (PErr)
+      ++Stats.NumFailed;
+    else
+      ++Stats.NumReoptimized;
+    Err = joinErrors(std::move(Err), std::move(PErr));
+  }
+  return Err;
+}
+
+TieredCompilationManager::Statistics
+TieredCompilationManager::getStatistics() const {
+  std::lock_guard<std::mutex> Lock(StateMutex);
+  return Stats;
+}
+
+void TieredCompilationManager::runPollLoop() {
+#if LLVM_ENABLE_THREADS
+  std::unique_lock<std::mutex> Lock(StateMutex);
+  while (true) {
+    PollCondition.wait_for(Lock, Opts.PollInterval,
+                           [&]() { return StopPolling; });
+    if (StopPolling)
+      return;
+
+    Lock.unlock();
+    if (auto Err = reoptimizeHotPartitions())
+      ES.reportError(std::move(Err));
+    Lock.lock();
+  }
+#endif
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -26,6 +26,7 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Mutex.h"
+#include "llvm/Support/RWMutex.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <memory>
@@ -89,7 +90,7 @@ private:
   Timer *newPassTimer(StringRef PassID, StringRef PassDesc);
 };
 
-static ManagedStatic<sys::SmartMutex<true>> TimingInfoMutex;
+static ManagedStatic<sys::SmartRWMutex<true>> TimingInfoMutex;
 
 PassTimingInfo::PassTimingInfo()
     : TG("pass", "... Pass execution timing report ...") {}
@@ -130,7 +131,16 @@ Timer *PassTimingInfo::getPassTimer(Pass *P, PassInstanceID Pass) {
     return nullptr;
 
   init();
-  sys::SmartScopedLock<true> Lock(*TimingInfoMutex);
+  // Every pass execution looks up its timer, possibly on many threads at
+  // once, but only the first one creates it.
+  {
+    sys::SmartScopedReader<true> Lock(*TimingInfoMutex);
+    auto It = TimingData.find(Pass);
+    if (It != TimingData.end())
+      return It->second.get();
+  }
+
+  sys::SmartScopedWriter<true> Lock(*TimingInfoMutex);
   std::unique_ptr<Timer> &T = TimingData[Pass];
 
   if (!T) {
@@ -36,9 +36,20 @@ Error RemarkStreamer::setFilter(StringRef Filter) {
     return createStringError(std::make_error_code(std::errc::invalid_argument),
                              RegexError.data());
   PassFilter = std::move(R);
+  PassFilterResults.clear();
   return Error::success();
 }
 
+bool RemarkStreamer::matchesFilter(StringRef PassName) {
+  if (!PassFilter)
+    return true;
+
+  auto It = PassFilterResults.try_emplace(PassName, false);
+  if (It.second)
+    It.first->second = PassFilter->match(PassName);
+  return It.first->second;
+}
+
 /// DiagnosticKind -> remarks::Type
 static remarks::Type toRemarkType(enum DiagnosticKind Kind) {
   switch (Kind) {
@@ -96,9 +107,8 @@ RemarkStreamer::toRemark(const DiagnosticInfoOptimizationBase &Diag) {
 }
 
 void RemarkStreamer::emit(const DiagnosticInfoOptimizationBase &Diag) {
-  if (Optional<Regex> &Filter = PassFilter)
-    if (!Filter->match(Diag.getPassName()))
-      return;
+  if (!matchesFilter(Diag.getPassName()))
+    return;
 
   // First, convert the diagnostic to a remark.
   remarks::Remark R = toRemark(Diag);
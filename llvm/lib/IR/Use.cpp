@@ -13,6 +13,12 @@
 
 namespace llvm {
 
+// Every operand of every User is a Use, so their size dominates the memory of
+// large modules. The User is recovered by waymarking rather than stored, so a
+// Use is just the value and the two use-list links. Add an assert to prevent
+// people from accidentally growing it.
+static_assert(sizeof(Use) == 3 * sizeof(void *), "unexpected Use size growth");
+
 void Use::swap(Use &RHS) {
   if (Val == RHS.Val)
     return;
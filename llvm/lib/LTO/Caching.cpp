@@ -27,35 +27,77 @@
 using namespace llvm;
 using namespace llvm::lto;
 
-Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
-                                            AddBufferFn AddBuffer) {
+// Opens a cache entry, updating its access time so that the pruner sees it
+// as recently used. A volatile file is read into memory instead of being
+// mapped, because it may be truncated or removed by another machine.
+static ErrorOr<std::unique_ptr<MemoryBuffer>>
+openCacheEntry(const Twine &EntryPath, bool IsVolatile) {
+  SmallString<64> ResultPath;
+  Expected<sys::fs::file_t> FDOrErr = sys::fs::openNativeFileForRead(
+      EntryPath, sys::fs::OF_UpdateAtime, &ResultPath);
+  if (!FDOrErr)
+    return errorToErrorCode(FDOrErr.takeError());
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getOpenFile(*FDOrErr, EntryPath,
+                                /*FileSize=*/-1,
+                                /*RequiresNullTerminator=*/false, IsVolatile);
+  sys::fs::closeFile(*FDOrErr);
+  return MBOrErr;
+}
+
+// Copies a cache entry into another cache directory. Like the regular cache
+// stream, this writes a temporary file and renames it so that readers never
+// see a partially written entry. Errors are ignored, as the copy is only an
+// optimization.
+static void copyCacheEntry(StringRef CacheDirectoryPath, StringRef Key,
+                           StringRef Contents) {
+  SmallString<64> TempFilenameModel;
+  sys::path::append(TempFilenameModel, CacheDirectoryPath, "Thin-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFilenameModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+
+  raw_fd_ostream OS(Temp->FD, /* ShouldClose */ false);
+  OS << Contents;
+  OS.flush();
+  if (OS.has_error()) {
+    OS.clear_error();
+    consumeError(Temp->discard());
+    return;
+  }
+
+  SmallString<64> EntryPath;
+  sys::path::append(EntryPath, CacheDirectoryPath, "llvmcache-" + Key);
+  if (Error E = Temp->keep(EntryPath))
+    consumeError(std::move(E));
+}
+
+Expected<NativeObjectCache>
+lto::localCache(StringRef CacheDirectoryPath, AddBufferFn AddBuffer,
+                StringRef SharedCacheDirectoryPath) {
   if (std::error_code EC = sys::fs::create_directories(CacheDirectoryPath))
     return errorCodeToError(EC);
 
+  std::string SharedDir = SharedCacheDirectoryPath;
+  if (!SharedDir.empty() && sys::fs::create_directories(SharedDir))
+    SharedDir.clear();
+
   return [=](unsigned Task, StringRef Key) -> AddStreamFn {
     // This choice of file name allows the cache to be pruned (see pruneCache()
     // in include/llvm/Support/CachePruning.h).
     SmallString<64> EntryPath;
     sys::path::append(EntryPath, CacheDirectoryPath, "llvmcache-" + Key);
     // First, see if we have a cache hit.
-    SmallString<64> ResultPath;
-    Expected<sys::fs::file_t> FDOrErr = sys::fs::openNativeFileForRead(
-        Twine(EntryPath), sys::fs::OF_UpdateAtime, &ResultPath);
-    std::error_code EC;
-    if (FDOrErr) {
-      ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
-          MemoryBuffer::getOpenFile(*FDOrErr, EntryPath,
-                                    /*FileSize=*/-1,
-                                    /*RequiresNullTerminator=*/false);
-      sys::fs::closeFile(*FDOrErr);
-      if (MBOrErr) {
-        AddBuffer(Task, std::move(*MBOrErr));
-        return AddStreamFn();
-      }
-      EC = MBOrErr.getError();
-    } else {
-      EC = errorToErrorCode(FDOrErr.takeError());
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        openCacheEntry(EntryPath, /*IsVolatile=*/false);
+    if (MBOrErr) {
+      AddBuffer(Task, std::move(*MBOrErr));
+      return AddStreamFn();
     }
+    std::error_code EC = MBOrErr.getError();
 
     // On Windows we can fail to open a cache file with a permission denied
     // error. This generally means that another process has requested to delete
@@ -67,20 +109,36 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
       report_fatal_error(Twine("Failed to open cache file ") + EntryPath +
                          ": " + EC.message() + "\n");
 
+    // If another machine has already created this entry in the shared cache
+    // directory, copy it into the local one so that later links don't need
+    // to access the shared directory again.
+    if (!SharedDir.empty()) {
+      SmallString<64> SharedEntryPath;
+      sys::path::append(SharedEntryPath, SharedDir, "llvmcache-" + Key);
+      if (ErrorOr<std::unique_ptr<MemoryBuffer>> SharedMBOrErr =
+              openCacheEntry(SharedEntryPath, /*IsVolatile=*/true)) {
+        copyCacheEntry(CacheDirectoryPath, Key, (*SharedMBOrErr)->getBuffer());
+        AddBuffer(Task, std::move(*SharedMBOrErr));
+        return AddStreamFn();
+      }
+    }
+
     // This native object stream is responsible for commiting the resulting
     // file to the cache and calling AddBuffer to add it to the link.
     struct CacheStream : NativeObjectStream {
       AddBufferFn AddBuffer;
       sys::fs::TempFile TempFile;
       std::string EntryPath;
+      std::string SharedDir;
+      std::string Key;
       unsigned Task;
 
       CacheStream(std::unique_ptr<raw_pwrite_stream> OS, AddBufferFn AddBuffer,
                   sys::fs::TempFile TempFile, std::string EntryPath,
-                  unsigned Task)
+                  std::string SharedDir, std::string Key, unsigned Task)
           : NativeObjectStream(std::move(OS)), AddBuffer(std::move(AddBuffer)),
             TempFile(std::move(TempFile)), EntryPath(std::move(EntryPath)),
-            Task(Task) {}
+            SharedDir(std::move(SharedDir)), Key(std::move(Key)), Task(Task) {}
 
       ~CacheStream() {
         // Make sure the stream is closed before committing it.
@@ -126,11 +184,17 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
                              TempFile.TmpName + " to " + EntryPath + ": " +
                              toString(std::move(E)) + "\n");
 
+        // Publish the new entry to the other machines using the shared cache
+        // directory.
+        if (!SharedDir.empty())
+          copyCacheEntry(SharedDir, Key, (*MBOrErr)->getBuffer());
+
         AddBuffer(Task, std::move(*MBOrErr));
       }
     };
 
-    return [=](size_t Task) -> std::unique_ptr<NativeObjectStream> {
+    return [=, Key = Key.str()](size_t Task)
+               -> std::unique_ptr<NativeObjectStream> {
       // Write to a temporary to avoid race condition
       SmallString<64> TempFilenameModel;
       sys::path::append(TempFilenameModel, CacheDirectoryPath, "Thin-%%%%%%.tmp.o");
@@ -144,7 +208,7 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
       // This CacheStream will move the temporary file into the cache when done.
       return std::make_unique<CacheStream>(
           std::make_unique<raw_fd_ostream>(Temp->FD, /* ShouldClose */ false),
-          AddBuffer, std::move(*Temp), EntryPath.str(), Task);
+          AddBuffer, std::move(*Temp), EntryPath.str(), SharedDir, Key, Task);
     };
   };
 }
@@ -1175,16 +1175,26 @@ class WriteIndexesThinBackend : public ThinBackendProc {
   raw_fd_ostream *LinkedObjectsFile;
   lto::IndexWriteCallback OnWrite;
 
+  Optional<Error> Err;
+  std::mutex ErrMu;
+  std::mutex OnWriteMu;
+
+  // Declared last so that it is destroyed, and its threads are joined,
+  // before the members used by the threads.
+  ThreadPool BackendThreadPool;
+
 public:
   WriteIndexesThinBackend(
       Config &Conf, ModuleSummaryIndex &CombinedIndex,
       const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
       std::string OldPrefix, std::string NewPrefix, bool ShouldEmitImportsFiles,
-      raw_fd_ostream *LinkedObjectsFile, lto::IndexWriteCallback OnWrite)
+      raw_fd_ostream *LinkedObjectsFile, lto::IndexWriteCallback OnWrite,
+      unsigned ParallelismLevel)
       : ThinBackendProc(Conf, CombinedIndex, ModuleToDefinedGVSummaries),
         OldPrefix(OldPrefix), NewPrefix(NewPrefix),
         ShouldEmitImportsFiles(ShouldEmitImportsFiles),
-        LinkedObjectsFile(LinkedObjectsFile), OnWrite(OnWrite) {}
+        LinkedObjectsFile(LinkedObjectsFile), OnWrite(OnWrite),
+        BackendThreadPool(ParallelismLevel) {}
 
   Error start(
       unsigned Task, BitcodeModule BM,
@@ -1196,9 +1206,31 @@ public:
     std::string NewModulePath =
         getThinLTOOutputFile(ModulePath, OldPrefix, NewPrefix);
 
+    // Write the list of objects in the order of the modules so that it
+    // doesn't depend on the order in which the index files are written.
     if (LinkedObjectsFile)
       *LinkedObjectsFile << NewModulePath << '\n';
 
+    // The import lists of all modules are final at this point, and each
+    // module's index only depends on its own import list, so the index files
+    // are written in parallel.
+    BackendThreadPool.async(
+        [this, ModulePath, &ImportList](std::string NewModulePath) {
+          Error E = writeIndexFiles(ModulePath, NewModulePath, ImportList);
+          if (E) {
+            std::unique_lock<std::mutex> L(ErrMu);
+            if (Err)
+              Err = joinErrors(std::move(*Err), std::move(E));
+            else
+              Err = std::move(E);
+          }
+        },
+        std::move(NewModulePath));
+    return Error::success();
+  }
+
+  Error writeIndexFiles(StringRef ModulePath, const std::string &NewModulePath,
+                        const FunctionImporter::ImportMapTy &ImportList) {
     std::map<std::string, GVSummaryMapTy> ModuleToSummariesForIndex;
     gatherImportedSummariesForModule(ModulePath, ModuleToDefinedGVSummaries,
                                      ImportList, ModuleToSummariesForIndex);
@@ -1217,24 +1249,32 @@ public:
         return errorCodeToError(EC);
     }
 
-    if (OnWrite)
+    if (OnWrite) {
+      std::unique_lock<std::mutex> L(OnWriteMu);
       OnWrite(ModulePath);
+    }
     return Error::success();
   }
 
-  Error wait() override { return Error::success(); }
+  Error wait() override {
+    BackendThreadPool.wait();
+    if (Err)
+      return std::move(*Err);
+    return Error::success();
+  }
 };
 } // end anonymous namespace
 
 ThinBackend lto::createWriteIndexesThinBackend(
     std::string OldPrefix, std::string NewPrefix, bool ShouldEmitImportsFiles,
-    raw_fd_ostream *LinkedObjectsFile, IndexWriteCallback OnWrite) {
+    raw_fd_ostream *LinkedObjectsFile, IndexWriteCallback OnWrite,
+    unsigned ParallelismLevel) {
   return [=](Config &Conf, ModuleSummaryIndex &CombinedIndex,
              const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
              AddStreamFn AddStream, NativeObjectCache Cache) {
     return std::make_unique<WriteIndexesThinBackend>(
         Conf, CombinedIndex, ModuleToDefinedGVSummaries, OldPrefix, NewPrefix,
-        ShouldEmitImportsFiles, LinkedObjectsFile, OnWrite);
+        ShouldEmitImportsFiles, LinkedObjectsFile, OnWrite, ParallelismLevel);
   };
 }
 
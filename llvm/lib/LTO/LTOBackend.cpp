@@ -14,6 +14,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/LTO/LTOBackend.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
@@ -150,26 +151,51 @@ createTargetMachine(Config &Conf, const Target *TheTarget, Module &M) {
       CodeModel, Conf.CGOptLevel));
 }
 
+static PassBuilder::OptimizationLevel getOptimizationLevel(unsigned OptLevel) {
+  switch (OptLevel) {
+  default:
+    llvm_unreachable("Invalid optimization level");
+  case 0:
+    return PassBuilder::O0;
+  case 1:
+    return PassBuilder::O1;
+  case 2:
+    return PassBuilder::O2;
+  case 3:
+    return PassBuilder::O3;
+  }
+}
+
+static Optional<PGOOptions> getPGOOptions(const Config &Conf) {
+  if (!Conf.SampleProfile.empty())
+    return PGOOptions(Conf.SampleProfile, "", Conf.ProfileRemapping,
+                      PGOOptions::SampleUse, PGOOptions::NoCSAction, true);
+  if (Conf.RunCSIRInstr)
+    return PGOOptions("", Conf.CSIRProfile, Conf.ProfileRemapping,
+                      PGOOptions::IRUse, PGOOptions::CSIRInstr);
+  if (!Conf.CSIRProfile.empty())
+    return PGOOptions(Conf.CSIRProfile, "", Conf.ProfileRemapping,
+                      PGOOptions::IRUse, PGOOptions::CSIRUse);
+  return None;
+}
+
+static PipelineTuningOptions
+getPipelineTuningOptions(bool DeferFunctionSimplification) {
+  PipelineTuningOptions PTO;
+  PTO.DeferLTOFunctionSimplification = DeferFunctionSimplification;
+  return PTO;
+}
+
 static void runNewPMPasses(Config &Conf, Module &Mod, TargetMachine *TM,
                            unsigned OptLevel, bool IsThinLTO,
                            ModuleSummaryIndex *ExportSummary,
-                           const ModuleSummaryIndex *ImportSummary) {
-  Optional<PGOOptions> PGOOpt;
-  if (!Conf.SampleProfile.empty())
-    PGOOpt = PGOOptions(Conf.SampleProfile, "", Conf.ProfileRemapping,
-                        PGOOptions::SampleUse, PGOOptions::NoCSAction, true);
-  else if (Conf.RunCSIRInstr) {
-    PGOOpt = PGOOptions("", Conf.CSIRProfile, Conf.ProfileRemapping,
-                        PGOOptions::IRUse, PGOOptions::CSIRInstr);
-  } else if (!Conf.CSIRProfile.empty()) {
-    PGOOpt = PGOOptions(Conf.CSIRProfile, "", Conf.ProfileRemapping,
-                        PGOOptions::IRUse, PGOOptions::CSIRUse);
-  }
-
+                           const ModuleSummaryIndex *ImportSummary,
+                           bool DeferFunctionSimplification) {
   PassInstrumentationCallbacks PIC;
   StandardInstrumentations SI;
   SI.registerCallbacks(PIC);
-  PassBuilder PB(TM, PipelineTuningOptions(),PGOOpt, &PIC);
+  PassBuilder PB(TM, getPipelineTuningOptions(DeferFunctionSimplification),
+                 getPGOOptions(Conf), &PIC);
   AAManager AA;
 
   // Parse a custom AA pipeline if asked to.
@@ -194,24 +220,7 @@ static void runNewPMPasses(Config &Conf, Module &Mod, TargetMachine *TM,
   ModulePassManager MPM(Conf.DebugPassManager);
   // FIXME (davide): verify the input.
 
-  PassBuilder::OptimizationLevel OL;
-
-  switch (OptLevel) {
-  default:
-    llvm_unreachable("Invalid optimization level");
-  case 0:
-    OL = PassBuilder::O0;
-    break;
-  case 1:
-    OL = PassBuilder::O1;
-    break;
-  case 2:
-    OL = PassBuilder::O2;
-    break;
-  case 3:
-    OL = PassBuilder::O3;
-    break;
-  }
+  PassBuilder::OptimizationLevel OL = getOptimizationLevel(OptLevel);
 
   if (IsThinLTO)
     MPM = PB.buildThinLTODefaultPipeline(OL, Conf.DebugPassManager,
@@ -223,6 +232,46 @@ static void runNewPMPasses(Config &Conf, Module &Mod, TargetMachine *TM,
   // FIXME (davide): verify the output.
 }
 
+// Runs the function simplification passes that runNewPMPasses left out of the
+// regular LTO pipeline on one partition of the module. This is called from the
+// code generation threads, each of which has its own context. The pass builder
+// is set up as in runNewPMPasses, so the passes see the same profile and
+// tuning options as in the whole-module pipeline.
+static void runNewPMFunctionSimplificationPasses(Config &Conf, Module &Mod,
+                                                 TargetMachine *TM) {
+  PassInstrumentationCallbacks PIC;
+  StandardInstrumentations SI;
+  SI.registerCallbacks(PIC);
+  PassBuilder PB(TM,
+                 getPipelineTuningOptions(/*DeferFunctionSimplification=*/true),
+                 getPGOOptions(Conf), &PIC);
+  AAManager AA;
+
+  if (auto Err = PB.parseAAPipeline(AA, "default"))
+    report_fatal_error("Error parsing default AA pipeline");
+
+  LoopAnalysisManager LAM(Conf.DebugPassManager);
+  FunctionAnalysisManager FAM(Conf.DebugPassManager);
+  CGSCCAnalysisManager CGAM(Conf.DebugPassManager);
+  ModuleAnalysisManager MAM(Conf.DebugPassManager);
+
+  FAM.registerPass([&] { return std::move(AA); });
+
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  ModulePassManager MPM(Conf.DebugPassManager);
+  MPM.addPass(createModuleToFunctionPassAdaptor(
+      PB.buildLTOFunctionSimplificationPipeline(
+          getOptimizationLevel(Conf.OptLevel), Conf.DebugPassManager)));
+  if (!Conf.DisableVerify)
+    MPM.addPass(VerifierPass());
+  MPM.run(Mod, MAM);
+}
+
 static void runNewPMCustomPasses(Module &Mod, TargetMachine *TM,
                                  std::string PipelineDesc,
                                  std::string AAPipelineDesc,
@@ -299,14 +348,15 @@ static void runOldPMPasses(Config &Conf, Module &Mod, TargetMachine *TM,
 
 bool opt(Config &Conf, TargetMachine *TM, unsigned Task, Module &Mod,
          bool IsThinLTO, ModuleSummaryIndex *ExportSummary,
-         const ModuleSummaryIndex *ImportSummary) {
+         const ModuleSummaryIndex *ImportSummary,
+         bool DeferFunctionSimplification = false) {
   // FIXME: Plumb the combined index into the new pass manager.
   if (!Conf.OptPipeline.empty())
     runNewPMCustomPasses(Mod, TM, Conf.OptPipeline, Conf.AAPipeline,
                          Conf.DisableVerify);
   else if (Conf.UseNewPM)
     runNewPMPasses(Conf, Mod, TM, Conf.OptLevel, IsThinLTO, ExportSummary,
-                   ImportSummary);
+                   ImportSummary, DeferFunctionSimplification);
   else
     runOldPMPasses(Conf, Mod, TM, IsThinLTO, ExportSummary, ImportSummary);
   return !Conf.PostOptModuleHook || Conf.PostOptModuleHook(Task, Mod);
@@ -352,7 +402,8 @@ void codegen(Config &Conf, TargetMachine *TM, AddStreamFn AddStream,
 
 void splitCodeGen(Config &C, TargetMachine *TM, AddStreamFn AddStream,
                   unsigned ParallelCodeGenParallelismLevel,
-                  std::unique_ptr<Module> Mod) {
+                  std::unique_ptr<Module> Mod,
+                  bool RunFunctionSimplification = false) {
   ThreadPool CodegenThreadPool(ParallelCodeGenParallelismLevel);
   unsigned ThreadCount = 0;
   const Target *T = &TM->getTarget();
@@ -384,6 +435,9 @@ void splitCodeGen(Config &C, TargetMachine *TM, AddStreamFn AddStream,
               std::unique_ptr<TargetMachine> TM =
                   createTargetMachine(C, T, *MPartInCtx);
 
+              if (RunFunctionSimplification)
+                runNewPMFunctionSimplificationPasses(C, *MPartInCtx, TM.get());
+
               codegen(C, TM.get(), AddStream, ThreadId, *MPartInCtx);
             },
             // Pass BC using std::move to ensure that it get moved rather than
@@ -442,9 +496,18 @@ Error lto::backend(Config &C, AddStreamFn AddStream,
     return DiagFileOrErr.takeError();
   auto DiagnosticOutputFile = std::move(*DiagFileOrErr);
 
+  // An LLVMContext can't be shared between threads, so the function passes of
+  // the regular LTO pipeline can only run in parallel on the partitions that
+  // splitCodeGen creates in separate contexts.
+  bool ParallelFunctionPasses = C.ParallelFunctionPasses && C.UseNewPM &&
+                                C.OptPipeline.empty() && !C.CodeGenOnly &&
+                                C.OptLevel != 0 &&
+                                ParallelCodeGenParallelismLevel > 1;
+
   if (!C.CodeGenOnly) {
     if (!opt(C, TM.get(), 0, *Mod, /*IsThinLTO=*/false,
-             /*ExportSummary=*/&CombinedIndex, /*ImportSummary=*/nullptr))
+             /*ExportSummary=*/&CombinedIndex, /*ImportSummary=*/nullptr,
+             ParallelFunctionPasses))
       return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
   }
 
@@ -452,7 +515,7 @@ Error lto::backend(Config &C, AddStreamFn AddStream,
     codegen(C, TM.get(), AddStream, 0, *Mod);
   } else {
     splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel,
-                 std::move(Mod));
+                 std::move(Mod), ParallelFunctionPasses);
   }
   return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
 }
@@ -483,6 +546,12 @@ Error lto::thinBackend(Config &Conf, unsigned Task, AddStreamFn AddStream,
                        const FunctionImporter::ImportMapTy &ImportList,
                        const GVSummaryMapTy &DefinedGlobals,
                        MapVector<StringRef, BitcodeModule> &ModuleMap) {
+  // Backends run concurrently, so attribute statistics to the module to be
+  // able to tell them apart.
+  Optional<StatisticScope> StatsScope;
+  if (AreStatisticsEnabled())
+    StatsScope.emplace(Mod.getModuleIdentifier());
+
   Expected<const Target *> TOrErr = initAndLookupTarget(Conf, Mod);
   if (!TOrErr)
     return TOrErr.takeError();
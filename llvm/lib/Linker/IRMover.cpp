@@ -16,12 +16,17 @@
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/IR/GVMaterializer.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/PassTimingInfo.h"
 #include "llvm/IR/TypeFinder.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include <utility>
 using namespace llvm;
 
+static const char *const TimeIRLinkingGroupName = "irlink";
+static const char *const TimeIRLinkingGroupDescription = "LLVM IR Linking";
+
 //===----------------------------------------------------------------------===//
 // TypeMap implementation.
 //===----------------------------------------------------------------------===//
@@ -985,6 +990,12 @@ Expected<Constant *> IRLinker::linkGlobalValueProto(GlobalValue *SGV,
     if (DoneLinkingBodies)
       return nullptr;
 
+    // The metadata of global variables is copied with the prototype, and
+    // may not be loaded until the variable is materialized.
+    if (isa<GlobalVariable>(SGV))
+      if (Error Err = SGV->materialize())
+        return std::move(Err);
+
     NewGV = copyGlobalValueProto(SGV, ShouldLink || ForIndirectSymbol);
     if (ShouldLink || !ForIndirectSymbol)
       forceRenaming(NewGV, SGV->getName());
@@ -1414,23 +1425,31 @@ Error IRLinker::run() {
   }
 
   // Loop over all of the linked values to compute type mappings.
-  computeTypeMapping();
-
-  std::reverse(Worklist.begin(), Worklist.end());
-  while (!Worklist.empty()) {
-    GlobalValue *GV = Worklist.back();
-    Worklist.pop_back();
+  {
+    NamedRegionTimer T("types", "Map types", TimeIRLinkingGroupName,
+                       TimeIRLinkingGroupDescription, TimePassesIsEnabled);
+    computeTypeMapping();
+  }
 
-    // Already mapped.
-    if (ValueMap.find(GV) != ValueMap.end() ||
-        IndirectSymbolValueMap.find(GV) != IndirectSymbolValueMap.end())
-      continue;
+  {
+    NamedRegionTimer T("globals", "Link global values", TimeIRLinkingGroupName,
+                       TimeIRLinkingGroupDescription, TimePassesIsEnabled);
+    std::reverse(Worklist.begin(), Worklist.end());
+    while (!Worklist.empty()) {
+      GlobalValue *GV = Worklist.back();
+      Worklist.pop_back();
+
+      // Already mapped.
+      if (ValueMap.find(GV) != ValueMap.end() ||
+          IndirectSymbolValueMap.find(GV) != IndirectSymbolValueMap.end())
+        continue;
 
-    assert(!GV->isDeclaration());
-    Mapper.mapValue(*GV);
-    if (FoundError)
-      return std::move(*FoundError);
-    flushRAUWWorklist();
+      assert(!GV->isDeclaration());
+      Mapper.mapValue(*GV);
+      if (FoundError)
+        return std::move(*FoundError);
+      flushRAUWWorklist();
+    }
   }
 
   // Note that we are done linking global value bodies. This prevents
@@ -1438,6 +1457,9 @@ Error IRLinker::run() {
   DoneLinkingBodies = true;
   Mapper.addFlags(RF_NullMapMissingGlobalValues);
 
+  NamedRegionTimer T("metadata", "Link metadata", TimeIRLinkingGroupName,
+                     TimeIRLinkingGroupDescription, TimePassesIsEnabled);
+
   // Remap all of the named MDNodes in Src into the DstM module. We do this
   // after linking GlobalValues so that MDNodes that reference GlobalValues
   // are properly remapped.
@@ -1550,6 +1572,9 @@ Error IRMover::move(
                        std::move(Src), ValuesToLink, std::move(AddLazyFor),
                        IsPerformingImport);
   Error E = TheIRLinker.run();
+  NamedRegionTimer T("constants", "Drop dead constant arrays",
+                     TimeIRLinkingGroupName, TimeIRLinkingGroupDescription,
+                     TimePassesIsEnabled);
   Composite.dropTriviallyDeadConstantArrays();
   return E;
 }
@@ -38,6 +38,7 @@
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
@@ -45,6 +46,7 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SwapByteOrder.h"
@@ -64,6 +66,12 @@ using namespace llvm;
 #undef  DEBUG_TYPE
 #define DEBUG_TYPE "reloc-info"
 
+static cl::opt<bool> ParallelSectionData(
+    "mc-parallel-section-data", cl::Hidden,
+    cl::desc("Encode and compress the contents of all ELF sections in "
+             "parallel before writing them out"),
+    cl::init(false));
+
 namespace {
 
 using SectionIndexMapTy = DenseMap<const MCSectionELF *, uint32_t>;
@@ -161,6 +169,21 @@ struct ELFWriter {
                              SmallVectorImpl<char> &CompressedContents,
                              bool ZLibStyle, unsigned Alignment);
 
+  /// The contents of a section, encoded before it is written out.
+  struct EncodedSectionData {
+    SmallVector<char, 0> Data;
+    SmallVector<char, 0> CompressedData;
+    bool IsCompressed = false;
+  };
+
+  /// Encode, and compress if requested, the contents of \p Sec. This only
+  /// reads the assembler state, so it may run for several sections at once.
+  void encodeSectionData(const MCAssembler &Asm, MCSection &Sec,
+                         const MCAsmLayout &Layout, EncodedSectionData &Out);
+
+  void writeEncodedSectionData(MCContext &MC, MCSectionELF &Section,
+                               EncodedSectionData &Encoded);
+
 public:
   ELFWriter(ELFObjectWriter &OWriter, raw_pwrite_stream &OS,
             bool IsLittleEndian, DwoMode Mode)
@@ -847,45 +870,66 @@ bool ELFWriter::maybeWriteCompression(
   return true;
 }
 
-void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
-                                 const MCAsmLayout &Layout) {
-  MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
-  StringRef SectionName = Section.getSectionName();
-
-  auto &MC = Asm.getContext();
-  const auto &MAI = MC.getAsmInfo();
-
+static bool shouldCompressSection(const MCAsmInfo &MAI,
+                                  const MCSectionELF &Section) {
   // Compressing debug_frame requires handling alignment fragments which is
   // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
   // for writing to arbitrary buffers) for little benefit.
-  bool CompressionEnabled =
-      MAI->compressDebugSections() != DebugCompressionType::None;
-  if (!CompressionEnabled || !SectionName.startswith(".debug_") ||
-      SectionName == ".debug_frame") {
-    Asm.writeSectionData(W.OS, &Section, Layout);
+  StringRef SectionName = Section.getSectionName();
+  return MAI.compressDebugSections() != DebugCompressionType::None &&
+         SectionName.startswith(".debug_") && SectionName != ".debug_frame";
+}
+
+void ELFWriter::encodeSectionData(const MCAssembler &Asm, MCSection &Sec,
+                                  const MCAsmLayout &Layout,
+                                  EncodedSectionData &Out) {
+  MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
+  raw_svector_ostream VecOS(Out.Data);
+  Asm.writeSectionData(VecOS, &Section, Layout);
+
+  const MCAsmInfo *MAI = Asm.getContext().getAsmInfo();
+  if (!shouldCompressSection(*MAI, Section))
     return;
-  }
 
   assert((MAI->compressDebugSections() == DebugCompressionType::Z ||
           MAI->compressDebugSections() == DebugCompressionType::GNU) &&
          "expected zlib or zlib-gnu style compression");
 
-  SmallVector<char, 128> UncompressedData;
-  raw_svector_ostream VecOS(UncompressedData);
-  Asm.writeSectionData(VecOS, &Section, Layout);
-
-  SmallVector<char, 128> CompressedContents;
-  if (Error E = zlib::compress(
-          StringRef(UncompressedData.data(), UncompressedData.size()),
-          CompressedContents)) {
+  if (Error E = zlib::compress(StringRef(Out.Data.data(), Out.Data.size()),
+                               Out.CompressedData)) {
     consumeError(std::move(E));
+    return;
+  }
+  Out.IsCompressed = true;
+}
+
+void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
+                                 const MCAsmLayout &Layout) {
+  MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
+  if (!shouldCompressSection(*Asm.getContext().getAsmInfo(), Section)) {
+    Asm.writeSectionData(W.OS, &Section, Layout);
+    return;
+  }
+
+  EncodedSectionData Encoded;
+  encodeSectionData(Asm, Section, Layout, Encoded);
+  writeEncodedSectionData(Asm.getContext(), Section, Encoded);
+}
+
+void ELFWriter::writeEncodedSectionData(MCContext &MC, MCSectionELF &Section,
+                                        EncodedSectionData &Encoded) {
+  SmallVectorImpl<char> &UncompressedData = Encoded.Data;
+  SmallVectorImpl<char> &CompressedContents = Encoded.CompressedData;
+  if (!Encoded.IsCompressed) {
     W.OS << UncompressedData;
     return;
   }
 
-  bool ZlibStyle = MAI->compressDebugSections() == DebugCompressionType::Z;
+  StringRef SectionName = Section.getSectionName();
+  bool ZlibStyle =
+      MC.getAsmInfo()->compressDebugSections() == DebugCompressionType::Z;
   if (!maybeWriteCompression(UncompressedData.size(), CompressedContents,
-                             ZlibStyle, Sec.getAlignment())) {
+                             ZlibStyle, Section.getAlignment())) {
     W.OS << UncompressedData;
     return;
   }
@@ -1089,15 +1133,44 @@ uint64_t ELFWriter::writeObject(MCAssembler &Asm, const MCAsmLayout &Layout) {
   // Write out the ELF header ...
   writeHeader(Asm);
 
+  auto IsWritten = [&](const MCSectionELF &Section) {
+    if (Mode == NonDwoOnly && isDwoSection(Section))
+      return false;
+    if (Mode == DwoOnly && !isDwoSection(Section))
+      return false;
+    return true;
+  };
+
+  // With -mc-parallel-section-data, the contents of all sections are encoded
+  // and compressed up front, in parallel, and then written out in order. The
+  // layout is final at this point, so only make sure that every fragment
+  // offset is cached before the threads start reading them.
+  std::vector<MCSectionELF *> ParallelSections;
+  std::vector<EncodedSectionData> EncodedSections;
+  if (ParallelSectionData) {
+    for (MCSection &Sec : Asm) {
+      MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
+      if (!IsWritten(Section))
+        continue;
+      Layout.getFragmentOffset(&*Section.rbegin());
+      ParallelSections.push_back(&Section);
+    }
+    EncodedSections.resize(ParallelSections.size());
+    parallel::for_each_n(parallel::par, size_t(0), ParallelSections.size(),
+                         [&](size_t I) {
+                           encodeSectionData(Asm, *ParallelSections[I], Layout,
+                                             EncodedSections[I]);
+                         });
+  }
+
   // ... then the sections ...
   SectionOffsetsTy SectionOffsets;
   std::vector<MCSectionELF *> Groups;
   std::vector<MCSectionELF *> Relocations;
+  unsigned NumWrittenSections = 0;
   for (MCSection &Sec : Asm) {
     MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
-    if (Mode == NonDwoOnly && isDwoSection(Section))
-      continue;
-    if (Mode == DwoOnly && !isDwoSection(Section))
+    if (!IsWritten(Section))
       continue;
 
     align(Section.getAlignment());
@@ -1106,7 +1179,13 @@ uint64_t ELFWriter::writeObject(MCAssembler &Asm, const MCAsmLayout &Layout) {
     uint64_t SecStart = W.OS.tell();
 
     const MCSymbolELF *SignatureSymbol = Section.getGroup();
-    writeSectionData(Asm, Section, Layout);
+    if (ParallelSectionData) {
+      EncodedSectionData &Encoded = EncodedSections[NumWrittenSections++];
+      writeEncodedSectionData(Ctx, Section, Encoded);
+      Encoded = EncodedSectionData();
+    } else {
+      writeSectionData(Asm, Section, Layout);
+    }
 
     uint64_t SecEnd = W.OS.tell();
     SectionOffsets[&Section] = std::make_pair(SecStart, SecEnd);
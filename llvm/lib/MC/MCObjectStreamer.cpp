@@ -8,6 +8,7 @@
 
 #include "llvm/MC/MCObjectStreamer.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/MC/MCAsmBackend.h"
 #include "llvm/MC/MCAssembler.h"
 #include "llvm/MC/MCCodeEmitter.h"
@@ -15,13 +16,29 @@
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCDwarf.h"
 #include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCFixupKindInfo.h"
+#include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCObjectWriter.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCSymbol.h"
+#include "llvm/MC/MCValue.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/SourceMgr.h"
 using namespace llvm;
 
+#define DEBUG_TYPE "mc"
+
+STATISTIC(NumResolvedRelaxableInsts,
+          "Number of relaxable instructions emitted as data because their "
+          "target was already known");
+
+static cl::opt<bool> EmitResolvedRelaxableAsData(
+    "mc-emit-resolved-relaxable-as-data", cl::Hidden,
+    cl::desc("Don't create relaxable fragments for instructions whose "
+             "pc-relative target is already known to be in range"),
+    cl::init(true));
+
 MCObjectStreamer::MCObjectStreamer(MCContext &Context,
                                    std::unique_ptr<MCAsmBackend> TAB,
                                    std::unique_ptr<MCObjectWriter> OW,
@@ -353,10 +370,83 @@ void MCObjectStreamer::EmitInstructionImpl(const MCInst &Inst,
     return;
   }
 
+  // A backward branch to a label earlier in the current data fragment has a
+  // final displacement, so if it already fits there is no point in keeping a
+  // relaxable fragment, with its copy of the MCInst, around for it.
+  if (EmitResolvedRelaxableAsData && tryEmitResolvedRelaxable(Inst, STI)) {
+    ++NumResolvedRelaxableInsts;
+    return;
+  }
+
   // Otherwise emit to a separate fragment.
   EmitInstToFragment(Inst, STI);
 }
 
+bool MCObjectStreamer::tryEmitResolvedRelaxable(const MCInst &Inst,
+                                                const MCSubtargetInfo &STI) {
+  // With bundling, each streamer places instructions in fragments of its
+  // own, so leave those to EmitInstToFragment.
+  if (Assembler->isBundlingEnabled())
+    return false;
+  auto *DF = dyn_cast_or_null<MCDataFragment>(getCurrentFragment());
+  if (!DF || !CanReuseDataFragment(*DF, *Assembler, &STI))
+    return false;
+
+  // Most relaxable instructions are forward branches. Find those from the
+  // operands so they aren't encoded here and again in EmitInstToFragment.
+  const MCExpr *Expr = nullptr;
+  for (const MCOperand &Op : Inst) {
+    if (!Op.isExpr())
+      continue;
+    if (Expr)
+      return false;
+    Expr = Op.getExpr();
+  }
+  MCValue Target;
+  if (!Expr || !Expr->evaluateAsRelocatable(Target, nullptr, nullptr) ||
+      !Target.getSymA() || Target.getSymB() ||
+      Target.getSymA()->getKind() != MCSymbolRefExpr::VK_None)
+    return false;
+  // Only temporary labels in the same fragment can't be preempted or moved
+  // relative to the instruction.
+  const MCSymbol &Sym = Target.getSymA()->getSymbol();
+  if (!Sym.isTemporary() || Sym.isVariable() || Sym.getFragment() != DF)
+    return false;
+
+  SmallString<16> Code;
+  SmallVector<MCFixup, 4> Fixups;
+  raw_svector_ostream VecOS(Code);
+  getAssembler().getEmitter().encodeInstruction(Inst, VecOS, Fixups, STI);
+  if (Fixups.size() != 1)
+    return false;
+
+  MCFixup &Fixup = Fixups[0];
+  const MCAsmBackend &Backend = getAssembler().getBackend();
+  if (Backend.getFixupKindInfo(Fixup.getKind()).Flags !=
+      MCFixupKindInfo::FKF_IsPCRel)
+    return false;
+
+  // The fixup may add a target-specific bias to the operand, so evaluate it
+  // rather than the operand.
+  if (!Fixup.getValue()->evaluateAsRelocatable(Target, nullptr, &Fixup) ||
+      !Target.getSymA() || Target.getSymB() ||
+      &Target.getSymA()->getSymbol() != &Sym)
+    return false;
+
+  int64_t Value = int64_t(Sym.getOffset()) + Target.getConstant() -
+                  int64_t(DF->getContents().size() + Fixup.getOffset());
+  if (!Backend.fixupFitsWithoutRelaxation(Fixup, Value))
+    return false;
+
+  // Append the encoding we already have, the same way EmitInstToData does
+  // without bundling, instead of encoding the instruction a second time.
+  Fixup.setOffset(Fixup.getOffset() + DF->getContents().size());
+  DF->getFixups().push_back(Fixup);
+  DF->setHasInstructions(STI);
+  DF->getContents().append(Code.begin(), Code.end());
+  return true;
+}
+
 void MCObjectStreamer::EmitInstToFragment(const MCInst &Inst,
                                           const MCSubtargetInfo &STI) {
   if (getAssembler().getRelaxAll() && getAssembler().isBundlingEnabled())
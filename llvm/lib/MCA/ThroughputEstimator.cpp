@@ -0,0 +1,132 @@
+//===--------------------- ThroughputEstimator.cpp --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file implements the ThroughputEstimator interface.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/MCA/ThroughputEstimator.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/MCA/Instruction.h"
+#include "llvm/MCA/SourceMgr.h"
+#include "llvm/MCA/Support.h"
+#include <cstring>
+
+namespace llvm {
+namespace mca {
+
+ThroughputEstimator::ThroughputEstimator(const MCSubtargetInfo &STI,
+                                         const MCInstrInfo &MCII,
+                                         const MCRegisterInfo &MRI,
+                                         const MCInstrAnalysis *MCIA,
+                                         const PipelineOptions &PO,
+                                         unsigned Iterations)
+    : STI(STI), MRI(MRI), IB(STI, MCII, MRI, MCIA), PO(PO),
+      Iterations(Iterations) {
+  IB.setWarnUnmodeled(false);
+
+  const MCSchedModel &SM = STI.getSchedModel();
+  SmallVector<uint64_t, 8> ProcResourceMasks(SM.getNumProcResourceKinds());
+  computeProcResourceMasks(SM, ProcResourceMasks);
+  ResIdx2ProcResID.resize(SM.getNumProcResourceKinds());
+  for (unsigned I = 1, E = SM.getNumProcResourceKinds(); I < E; ++I)
+    ResIdx2ProcResID[getResourceStateIndex(ProcResourceMasks[I])] = I;
+}
+
+// Serialize everything about Insts that the simulation depends on. Operands
+// that refer to expressions or nested instructions only contribute their
+// kind, as InstrBuilder does not look at them.
+static void computeCacheKey(ArrayRef<MCInst> Insts,
+                            SmallVectorImpl<char> &Key) {
+  auto Append = [&Key](uint64_t V) {
+    char Bytes[sizeof(V)];
+    std::memcpy(Bytes, &V, sizeof(V));
+    Key.append(Bytes, Bytes + sizeof(V));
+  };
+
+  for (const MCInst &MCI : Insts) {
+    Append(MCI.getOpcode());
+    Append(MCI.getNumOperands());
+    for (const MCOperand &Op : MCI) {
+      if (Op.isReg()) {
+        Append(0);
+        Append(Op.getReg());
+      } else if (Op.isImm()) {
+        Append(1);
+        Append(Op.getImm());
+      } else if (Op.isFPImm()) {
+        Append(2);
+        double FP = Op.getFPImm();
+        uint64_t Bits;
+        std::memcpy(&Bits, &FP, sizeof(Bits));
+        Append(Bits);
+      } else {
+        Append(Op.isExpr() ? 3 : 4);
+      }
+    }
+  }
+}
+
+Expected<ThroughputEstimate>
+ThroughputEstimator::simulate(ArrayRef<MCInst> Insts) {
+  const MCSchedModel &SM = STI.getSchedModel();
+  ThroughputEstimate Estimate;
+  SmallVector<unsigned, 8> ProcResourceUsage(SM.getNumProcResourceKinds(), 0);
+
+  std::vector<std::unique_ptr<Instruction>> LoweredSequence;
+  for (const MCInst &MCI : Insts) {
+    Expected<std::unique_ptr<Instruction>> Inst = IB.createInstruction(MCI);
+    if (!Inst)
+      return Inst.takeError();
+
+    // Accumulate the resource cycles of one iteration like SummaryView does.
+    const InstrDesc &Desc = (*Inst)->getDesc();
+    Estimate.NumMicroOps += Desc.NumMicroOps;
+    for (const std::pair<uint64_t, const ResourceUsage> &RU : Desc.Resources)
+      if (RU.second.size())
+        ProcResourceUsage[ResIdx2ProcResID[getResourceStateIndex(RU.first)]] +=
+            RU.second.size();
+    LoweredSequence.emplace_back(std::move(Inst.get()));
+  }
+
+  SourceMgr S(LoweredSequence, Iterations);
+  Context MCA(MRI, STI);
+  std::unique_ptr<Pipeline> P = MCA.createDefaultPipeline(PO, S);
+  Expected<unsigned> Cycles = P->run();
+  if (!Cycles)
+    return Cycles.takeError();
+
+  Estimate.Iterations = S.getNumIterations();
+  Estimate.TotalCycles = *Cycles;
+  Estimate.BlockRThroughput = computeBlockRThroughput(
+      SM, PO.DispatchWidth ? PO.DispatchWidth : SM.IssueWidth,
+      Estimate.NumMicroOps, ProcResourceUsage);
+  return Estimate;
+}
+
+Expected<ThroughputEstimate>
+ThroughputEstimator::estimate(ArrayRef<MCInst> Insts) {
+  assert(!Insts.empty() && "Cannot estimate an empty sequence!");
+  SmallString<256> Key;
+  computeCacheKey(Insts, Key);
+  auto It = Cache.find(Key);
+  if (It != Cache.end())
+    return It->second;
+
+  Expected<ThroughputEstimate> Estimate = simulate(Insts);
+  // The variant descriptors are keyed by the address of the MCInst, which the
+  // next sequence may reuse for another instruction.
+  IB.clear();
+  if (Estimate)
+    Cache[Key] = *Estimate;
+  return Estimate;
+}
+
+} // namespace mca
+} // namespace llvm
@@ -14,20 +14,24 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Object/Error.h"
+#include "llvm/Object/IRSymtab.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Object/SymbolicFile.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <map>
+#include <mutex>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -345,49 +349,109 @@ static void writeSymbolTable(raw_ostream &Out, object::Archive::Kind Kind,
     Out.write(uint8_t(0));
 }
 
-static Expected<std::vector<unsigned>>
-getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
-  std::vector<unsigned> Ret;
+namespace {
+/// The archive symbols of one member: their NUL-terminated names, and the
+/// offset of each name in Names.
+struct MemberSymbols {
+  std::string Names;
+  std::vector<unsigned> Offsets;
+  bool HasObject = false;
+};
+} // end anonymous namespace
+
+static Error getSymbols(const NewArchiveMember &M, MemberSymbols &Syms) {
+  // A member with known symbols parsed as a symbolic file when they were
+  // read. One without any may or may not be an object, which decides whether
+  // an empty symbol table is written, so it is read again.
+  if (M.SymbolNames && !M.SymbolNames->empty()) {
+    Syms.Names = *M.SymbolNames;
+    for (size_t I = 0, E = Syms.Names.size(); I < E;
+         I = Syms.Names.find('\0', I) + 1)
+      Syms.Offsets.push_back(I);
+    Syms.HasObject = true;
+    return Error::success();
+  }
 
+  MemoryBufferRef Buf = M.Buf->getMemBufferRef();
+  raw_string_ostream SymNames(Syms.Names);
   // In the scenario when LLVMContext is populated SymbolicFile will contain a
   // reference to it, thus SymbolicFile should be destroyed first.
   LLVMContext Context;
-  std::unique_ptr<object::SymbolicFile> Obj;
-  if (identify_magic(Buf.getBuffer()) == file_magic::bitcode) {
-    auto ObjOrErr = object::SymbolicFile::createSymbolicFile(
-        Buf, file_magic::bitcode, &Context);
-    if (!ObjOrErr) {
-      // FIXME: check only for "not an object file" errors.
-      consumeError(ObjOrErr.takeError());
-      return Ret;
-    }
-    Obj = std::move(*ObjOrErr);
-  } else {
-    auto ObjOrErr = object::SymbolicFile::createSymbolicFile(Buf);
-    if (!ObjOrErr) {
-      // FIXME: check only for "not an object file" errors.
-      consumeError(ObjOrErr.takeError());
-      return Ret;
+  file_magic Type = identify_magic(Buf.getBuffer());
+  // Members that are not object files, such as text files, have no symbols.
+  if (!object::SymbolicFile::isSymbolicFile(Type, &Context))
+    return Error::success();
+
+  if (Type == file_magic::bitcode) {
+    // Take the symbols from the irsymtab, which spares parsing the modules
+    // unless the symbol table is missing or out of date. Modules for which no
+    // irsymtab can be built are left to the IRObjectFile below.
+    Expected<BitcodeFileContents> BFCOrErr = getBitcodeFileContents(Buf);
+    Expected<irsymtab::FileContents> FCOrErr =
+        BFCOrErr ? irsymtab::readBitcode(*BFCOrErr)
+                 : Expected<irsymtab::FileContents>(BFCOrErr.takeError());
+    if (FCOrErr) {
+      Syms.HasObject = true;
+      for (const irsymtab::Symbol &S : FCOrErr->TheReader.symbols()) {
+        // The same test as isArchiveSymbol().
+        if (S.isFormatSpecific() || !S.isGlobal() || S.isUndefined())
+          continue;
+        Syms.Offsets.push_back(SymNames.tell());
+        SymNames << S.getName() << '\0';
+      }
+      return Error::success();
     }
-    Obj = std::move(*ObjOrErr);
+    consumeError(FCOrErr.takeError());
   }
 
-  HasObject = true;
-  for (const object::BasicSymbolRef &S : Obj->symbols()) {
+  auto ObjOrErr = object::SymbolicFile::createSymbolicFile(Buf, Type, &Context);
+  if (!ObjOrErr)
+    return ObjOrErr.takeError();
+
+  Syms.HasObject = true;
+  for (const object::BasicSymbolRef &S : (*ObjOrErr)->symbols()) {
     if (!isArchiveSymbol(S))
       continue;
-    Ret.push_back(SymNames.tell());
+    Syms.Offsets.push_back(SymNames.tell());
     if (Error E = S.printName(SymNames))
-      return std::move(E);
+      return E;
     SymNames << '\0';
   }
-  return Ret;
+  return Error::success();
+}
+
+/// Read the symbols of all the members. This dominates the time it takes to
+/// write archives of many members, and is independent for each member, so it
+/// is done in parallel. Reports the error of the first failing member.
+static Expected<std::vector<MemberSymbols>>
+getAllSymbols(ArrayRef<NewArchiveMember> NewMembers) {
+  std::vector<MemberSymbols> Ret(NewMembers.size());
+  std::mutex ErrMutex;
+  size_t ErrIndex = NewMembers.size();
+  Error Err = Error::success();
+  parallel::for_each_n(
+      parallel::par, size_t(0), NewMembers.size(), [&](size_t I) {
+        Error E = getSymbols(NewMembers[I], Ret[I]);
+        if (!E)
+          return;
+        std::lock_guard<std::mutex> Lock(ErrMutex);
+        if (I < ErrIndex) {
+          consumeError(std::move(Err));
+          Err = std::move(E);
+          ErrIndex = I;
+        } else {
+          consumeError(std::move(E));
+        }
+      });
+  if (Err)
+    return std::move(Err);
+  return std::move(Ret);
 }
 
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, bool Deterministic,
-                  ArrayRef<NewArchiveMember> NewMembers) {
+                  bool NeedSymbols, ArrayRef<NewArchiveMember> NewMembers) {
   static char PaddingData[8] = {'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n'};
 
   // This ignores the symbol table, but we only need the value mod 8 and the
@@ -397,6 +461,13 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
   std::vector<MemberData> Ret;
   bool HasObject = false;
 
+  // Without a symbol table, the members need not be read at all.
+  Expected<std::vector<MemberSymbols>> SymbolsOrErr =
+      NeedSymbols ? getAllSymbols(NewMembers)
+                  : std::vector<MemberSymbols>(NewMembers.size());
+  if (!SymbolsOrErr)
+    return SymbolsOrErr.takeError();
+
   // Deduplicate long member names in the string table and reuse earlier name
   // offsets. This especially saves space for COFF Import libraries where all
   // members have the same name.
@@ -452,7 +523,8 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -487,13 +559,16 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       ModTime, Size);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    const MemberSymbols &Syms = (*SymbolsOrErr)[I];
+    HasObject |= Syms.HasObject;
+    std::vector<unsigned> Symbols;
+    Symbols.reserve(Syms.Offsets.size());
+    for (unsigned Offset : Syms.Offsets)
+      Symbols.push_back(SymNames.tell() + Offset);
+    SymNames << Syms.Names;
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back({std::move(Symbols), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
@@ -558,7 +633,7 @@ Error writeArchive(StringRef ArcName, ArrayRef<NewArchiveMember> NewMembers,
   raw_svector_ostream StringTable(StringTableBuf);
 
   Expected<std::vector<MemberData>> DataOrErr = computeMemberData(
-      StringTable, SymNames, Kind, Thin, Deterministic, NewMembers);
+      StringTable, SymNames, Kind, Thin, Deterministic, WriteSymtab, NewMembers);
   if (Error E = DataOrErr.takeError())
     return E;
   std::vector<MemberData> &Data = *DataOrErr;
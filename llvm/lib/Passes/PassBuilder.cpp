@@ -83,6 +83,7 @@
 #include "llvm/Transforms/IPO/Inliner.h"
 #include "llvm/Transforms/IPO/Internalize.h"
 #include "llvm/Transforms/IPO/LowerTypeTests.h"
+#include "llvm/Transforms/IPO/MergeFunctions.h"
 #include "llvm/Transforms/IPO/PartialInlining.h"
 #include "llvm/Transforms/IPO/SCCP.h"
 #include "llvm/Transforms/IPO/SampleProfile.h"
@@ -208,6 +209,11 @@ static cl::opt<bool> EnableSyntheticCounts(
     cl::desc("Run synthetic function entry count generation "
              "pass"));
 
+static cl::opt<bool> EnableColdFunctionsAtO1(
+    "npm-cold-functions-at-o1", cl::init(false), cl::Hidden,
+    cl::desc("Run the O1 function simplification pipeline on functions that "
+             "the profile shows are cold (default = off)"));
+
 static Regex DefaultAliasRegex(
     "^(default|thinlto-pre-link|thinlto|lto-pre-link|lto)<(O[0123sz])>$");
 
@@ -225,6 +231,9 @@ PipelineTuningOptions::PipelineTuningOptions() {
   ForgetAllSCEVInLoopUnroll = ForgetSCEVInLoopUnroll;
   LicmMssaOptCap = SetLicmMssaOptCap;
   LicmMssaNoAccForPromotionCap = SetLicmMssaNoAccForPromotionCap;
+  DeferLTOFunctionSimplification = false;
+  ColdFunctionsAtO1 = EnableColdFunctionsAtO1;
+  MergeFunctions = false;
 }
 
 extern cl::opt<bool> EnableHotColdSplit;
@@ -336,6 +345,34 @@ AnalysisKey NoOpCGSCCAnalysis::Key;
 AnalysisKey NoOpFunctionAnalysis::Key;
 AnalysisKey NoOpLoopAnalysis::Key;
 
+/// Runs \c ColdFPM instead of \c FPM on functions that are cold in the call
+/// graph according to the profile summary, so that compile time is spent on
+/// the code that matters at run time.
+class ColdFunctionPipelineSelector
+    : public PassInfoMixin<ColdFunctionPipelineSelector> {
+  FunctionPassManager FPM;
+  FunctionPassManager ColdFPM;
+
+public:
+  ColdFunctionPipelineSelector(FunctionPassManager FPM,
+                               FunctionPassManager ColdFPM)
+      : FPM(std::move(FPM)), ColdFPM(std::move(ColdFPM)) {}
+
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM) {
+    // The profile summary must have been computed at the module level, as
+    // it can't be computed from here.
+    const ModuleAnalysisManager &MAM =
+        AM.getResult<ModuleAnalysisManagerFunctionProxy>(F).getManager();
+    ProfileSummaryInfo *PSI =
+        MAM.getCachedResult<ProfileSummaryAnalysis>(*F.getParent());
+    if (PSI && PSI->hasProfileSummary() &&
+        PSI->isFunctionColdInCallGraph(&F,
+                                       AM.getResult<BlockFrequencyAnalysis>(F)))
+      return ColdFPM.run(F, AM);
+    return FPM.run(F, AM);
+  }
+};
+
 } // End anonymous namespace.
 
 void PassBuilder::invokePeepholeEPCallbacks(
@@ -805,9 +842,16 @@ PassBuilder::buildModuleSimplificationPipeline(OptimizationLevel Level,
     MainCGPipeline.addPass(ArgumentPromotionPass());
 
   // Lastly, add the core function simplification pipeline nested inside the
-  // CGSCC walk.
-  MainCGPipeline.addPass(createCGSCCToFunctionPassAdaptor(
-      buildFunctionSimplificationPipeline(Level, Phase, DebugLogging)));
+  // CGSCC walk. With a profile, cold functions may get the cheaper O1 one.
+  if (PTO.ColdFunctionsAtO1 && PGOOpt &&
+      PGOOpt->Action != PGOOptions::IRInstr && (Level == O2 || Level == O3))
+    MainCGPipeline.addPass(
+        createCGSCCToFunctionPassAdaptor(ColdFunctionPipelineSelector(
+            buildFunctionSimplificationPipeline(Level, Phase, DebugLogging),
+            buildFunctionSimplificationPipeline(O1, Phase, DebugLogging))));
+  else
+    MainCGPipeline.addPass(createCGSCCToFunctionPassAdaptor(
+        buildFunctionSimplificationPipeline(Level, Phase, DebugLogging)));
 
   for (auto &C : CGSCCOptimizerLateEPCallbacks)
     C(MainCGPipeline, Level);
@@ -966,6 +1010,10 @@ ModulePassManager PassBuilder::buildModuleOptimizationPipeline(
   if (EnableHotColdSplit && !LTOPreLink)
     MPM.addPass(HotColdSplittingPass());
 
+  // Merge functions if requested.
+  if (PTO.MergeFunctions)
+    MPM.addPass(MergeFunctionsPass());
+
   // LoopSink pass sinks instructions hoisted by LICM, which serves as a
   // canonicalization pass that enables other optimizations. As a result,
   // LoopSink pass needs to be a very late IR pass to avoid undoing LICM
@@ -1276,7 +1324,48 @@ PassBuilder::buildLTODefaultPipeline(OptimizationLevel Level, bool DebugLogging,
               PostOrderFunctionAttrsPass()));
   // FIXME: here we run IP alias analysis in the legacy PM.
 
-  FunctionPassManager MainFPM;
+  if (!PTO.DeferLTOFunctionSimplification)
+    MPM.addPass(createModuleToFunctionPassAdaptor(
+        buildLTOFunctionSimplificationPipeline(Level, DebugLogging)));
+
+  // Create a function that performs CFI checks for cross-DSO calls with
+  // targets in the current module.
+  MPM.addPass(CrossDSOCFIPass());
+
+  // Lower type metadata and the type.test intrinsic. This pass supports
+  // clang's control flow integrity mechanisms (-fsanitize=cfi*) and needs
+  // to be run at link time if CFI is enabled. This pass does nothing if
+  // CFI is disabled.
+  MPM.addPass(LowerTypeTestsPass(ExportSummary, nullptr));
+
+  // Enable splitting late in the FullLTO post-link pipeline. This is done in
+  // the same stage in the old pass manager (\ref addLateLTOOptimizationPasses).
+  if (EnableHotColdSplit)
+    MPM.addPass(HotColdSplittingPass());
+
+  // Add late LTO optimization passes.
+  // Delete basic blocks, which optimization passes may have killed.
+  MPM.addPass(createModuleToFunctionPassAdaptor(SimplifyCFGPass()));
+
+  // Drop bodies of available eternally objects to improve GlobalDCE.
+  MPM.addPass(EliminateAvailableExternallyPass());
+
+  // Now that we have optimized the program, discard unreachable functions.
+  MPM.addPass(GlobalDCEPass());
+
+  // Merge functions if requested.
+  if (PTO.MergeFunctions)
+    MPM.addPass(MergeFunctionsPass());
+
+  return MPM;
+}
+
+FunctionPassManager
+PassBuilder::buildLTOFunctionSimplificationPipeline(OptimizationLevel Level,
+                                                   bool DebugLogging) {
+  assert(Level != O0 && "Must request optimizations for this pipeline!");
+
+  FunctionPassManager MainFPM(DebugLogging);
 
   // FIXME: once we fix LoopPass Manager, add LICM here.
   // FIXME: once we provide support for enabling MLSM, add it here.
@@ -1315,35 +1404,7 @@ PassBuilder::buildLTODefaultPipeline(OptimizationLevel Level, bool DebugLogging,
   MainFPM.addPass(InstCombinePass());
   invokePeepholeEPCallbacks(MainFPM, Level);
   MainFPM.addPass(JumpThreadingPass());
-  MPM.addPass(createModuleToFunctionPassAdaptor(std::move(MainFPM)));
-
-  // Create a function that performs CFI checks for cross-DSO calls with
-  // targets in the current module.
-  MPM.addPass(CrossDSOCFIPass());
-
-  // Lower type metadata and the type.test intrinsic. This pass supports
-  // clang's control flow integrity mechanisms (-fsanitize=cfi*) and needs
-  // to be run at link time if CFI is enabled. This pass does nothing if
-  // CFI is disabled.
-  MPM.addPass(LowerTypeTestsPass(ExportSummary, nullptr));
-
-  // Enable splitting late in the FullLTO post-link pipeline. This is done in
-  // the same stage in the old pass manager (\ref addLateLTOOptimizationPasses).
-  if (EnableHotColdSplit)
-    MPM.addPass(HotColdSplittingPass());
-
-  // Add late LTO optimization passes.
-  // Delete basic blocks, which optimization passes may have killed.
-  MPM.addPass(createModuleToFunctionPassAdaptor(SimplifyCFGPass()));
-
-  // Drop bodies of available eternally objects to improve GlobalDCE.
-  MPM.addPass(EliminateAvailableExternallyPass());
-
-  // Now that we have optimized the program, discard unreachable functions.
-  MPM.addPass(GlobalDCEPass());
-
-  // FIXME: Maybe enable MergeFuncs conditionally after it's ported.
-  return MPM;
+  return MainFPM;
 }
 
 AAManager PassBuilder::buildDefaultAAPipeline() {
@@ -7,12 +7,14 @@
 //===----------------------------------------------------------------------===//
 /// \file
 ///
-/// This file defines IR-printing pass instrumentation callbacks as well as
-/// StandardInstrumentations class that manages standard pass instrumentations.
+/// This file defines IR-printing, IR-verifying and profiling pass
+/// instrumentation callbacks as well as StandardInstrumentations class that
+/// manages standard pass instrumentations.
 ///
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/LazyCallGraph.h"
@@ -21,12 +23,39 @@
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <mutex>
 
 using namespace llvm;
 
+#define DEBUG_TYPE "verify-each-incremental"
+
+static cl::opt<bool> VerifyEachIncremental(
+    "verify-each-incremental", cl::init(false), cl::Hidden,
+    cl::desc("Verify the IR after each new pass manager pass, re-verifying "
+             "only the functions that a function, loop or CGSCC pass ran on"));
+
+static cl::opt<std::string> PassProfileOutput(
+    "pass-profile-output", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Profile the time and instruction count change of each new pass "
+             "manager pass on each IR unit, and write the slowest runs to "
+             "<filename> in the -ftime-trace format"));
+
+static cl::opt<unsigned> PassProfileTop(
+    "pass-profile-top", cl::init(100), cl::Hidden,
+    cl::desc("Number of the slowest pass runs that -pass-profile-output "
+             "keeps (0 keeps all of them)"));
+
 namespace {
 
 /// Extracting Module out of \p IR unit. Also fills a textual description
@@ -235,8 +264,269 @@ void PrintIRInstrumentation::registerCallbacks(
   }
 }
 
+void VerifyInstrumentation::verifyAfterPass(StringRef PassID, Any IR) {
+  if (PassID.startswith("PassManager<") || PassID.contains("PassAdaptor<"))
+    return;
+
+  auto VerifyFunction = [&](const Function &F) {
+    if (F.isDeclaration())
+      return;
+    LLVM_DEBUG(dbgs() << "Verifying function " << F.getName() << " after "
+                      << PassID << "\n");
+    if (verifyFunction(F, &dbgs()))
+      report_fatal_error("Broken function " + F.getName() +
+                         " found after pass " + PassID +
+                         ", compilation aborted!");
+  };
+
+  if (any_isa<const Module *>(IR)) {
+    LLVM_DEBUG(dbgs() << "Verifying module after " << PassID << "\n");
+    if (verifyModule(*any_cast<const Module *>(IR), &dbgs()))
+      report_fatal_error("Broken module found after pass " + PassID +
+                         ", compilation aborted!");
+    return;
+  }
+
+  if (any_isa<const Function *>(IR)) {
+    VerifyFunction(*any_cast<const Function *>(IR));
+    return;
+  }
+
+  if (any_isa<const LazyCallGraph::SCC *>(IR)) {
+    for (const LazyCallGraph::Node &N :
+         *any_cast<const LazyCallGraph::SCC *>(IR))
+      VerifyFunction(N.getFunction());
+    return;
+  }
+
+  if (any_isa<const Loop *>(IR)) {
+    VerifyFunction(*any_cast<const Loop *>(IR)->getHeader()->getParent());
+    return;
+  }
+
+  llvm_unreachable("Unknown IR unit");
+}
+
+void VerifyInstrumentation::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (!VerifyEachIncremental)
+    return;
+
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any IR) { this->verifyAfterPass(P, IR); });
+}
+
+static const Function *getLoopFunction(const Loop *L) {
+  return L->getHeader()->getParent();
+}
+
+static int64_t getInstructionCount(Any IR) {
+  if (any_isa<const Module *>(IR)) {
+    int64_t Count = 0;
+    for (const Function &F : *any_cast<const Module *>(IR))
+      Count += F.getInstructionCount();
+    return Count;
+  }
+
+  if (any_isa<const Function *>(IR))
+    return any_cast<const Function *>(IR)->getInstructionCount();
+
+  if (any_isa<const LazyCallGraph::SCC *>(IR)) {
+    int64_t Count = 0;
+    for (const LazyCallGraph::Node &N :
+         *any_cast<const LazyCallGraph::SCC *>(IR))
+      Count += N.getFunction().getInstructionCount();
+    return Count;
+  }
+
+  if (any_isa<const Loop *>(IR))
+    return getLoopFunction(any_cast<const Loop *>(IR))->getInstructionCount();
+
+  llvm_unreachable("Unknown IR unit");
+}
+
+static std::string getIRName(Any IR) {
+  if (any_isa<const Module *>(IR))
+    return any_cast<const Module *>(IR)->getName();
+
+  if (any_isa<const Function *>(IR))
+    return any_cast<const Function *>(IR)->getName();
+
+  if (any_isa<const LazyCallGraph::SCC *>(IR))
+    return any_cast<const LazyCallGraph::SCC *>(IR)->getName();
+
+  if (any_isa<const Loop *>(IR)) {
+    const Loop *L = any_cast<const Loop *>(IR);
+    std::string LoopName;
+    raw_string_ostream ss(LoopName);
+    L->getHeader()->printAsOperand(ss, false);
+    return formatv("{0} (loop: {1})", getLoopFunction(L)->getName(), ss.str());
+  }
+
+  llvm_unreachable("Unknown IR unit");
+}
+
+static bool isPassManagerOrAdaptor(StringRef PassID) {
+  return PassID.startswith("PassManager<") || PassID.contains("PassAdaptor<");
+}
+
+using PassProfileRecord = PassProfilingInstrumentation::Record;
+
+static bool isSlowerPassRun(const PassProfileRecord &A,
+                            const PassProfileRecord &B) {
+  return A.Duration > B.Duration;
+}
+
+// Adds R to the heap of the PassProfileTop slowest records in Records.
+static void addSlowPassRun(std::vector<PassProfileRecord> &Records,
+                           PassProfileRecord R) {
+  Records.push_back(std::move(R));
+  std::push_heap(Records.begin(), Records.end(), isSlowerPassRun);
+  if (PassProfileTop && Records.size() > PassProfileTop) {
+    std::pop_heap(Records.begin(), Records.end(), isSlowerPassRun);
+    Records.pop_back();
+  }
+}
+
+namespace {
+/// The records of all the pass profilers of the process.
+struct PassProfileCollector {
+  std::mutex Mutex;
+  unsigned NumLive = 0;
+  PassProfilingInstrumentation::ClockType::time_point StartTime;
+  std::vector<PassProfileRecord> Slowest;
+
+  void write();
+};
+} // namespace
+
+static ManagedStatic<PassProfileCollector> PassProfiles;
+
+void PassProfileCollector::write() {
+  std::error_code EC;
+  raw_fd_ostream OS(PassProfileOutput, EC, sys::fs::OF_Text);
+  if (EC) {
+    errs() << "Could not open " << PassProfileOutput << ": " << EC.message()
+           << "\n";
+    return;
+  }
+
+  // Emit the records in start order. They were properly nested in each thread
+  // when they were recorded, and any subset of them still is.
+  std::vector<PassProfileRecord> Records = Slowest;
+  llvm::sort(Records, [](const PassProfileRecord &A,
+                         const PassProfileRecord &B) {
+    if (A.Start != B.Start)
+      return A.Start < B.Start;
+    return A.Duration > B.Duration;
+  });
+
+  // Number the threads in the order of their first record.
+  DenseMap<uint64_t, unsigned> ThreadNumbers;
+  for (const PassProfileRecord &R : Records)
+    ThreadNumbers.insert({R.ThreadID, ThreadNumbers.size()});
+
+  using namespace std::chrono;
+  json::OStream J(OS);
+  J.object([&] {
+    J.attributeArray("traceEvents", [&] {
+      for (const PassProfileRecord &R : Records) {
+        J.object([&] {
+          J.attribute("pid", 1);
+          J.attribute("tid", int64_t(ThreadNumbers[R.ThreadID]));
+          J.attribute("ph", "X");
+          J.attribute(
+              "ts", int64_t(duration_cast<microseconds>(R.Start - StartTime)
+                                .count()));
+          J.attribute("dur",
+                      int64_t(duration_cast<microseconds>(R.Duration).count()));
+          J.attribute("name", R.PassID);
+          J.attributeObject("args", [&] {
+            J.attribute("detail", R.IRName);
+            J.attribute("instructions", R.InstsBefore);
+            J.attribute("instruction delta", R.InstsAfter - R.InstsBefore);
+          });
+        });
+      }
+    });
+  });
+}
+
+PassProfilingInstrumentation::~PassProfilingInstrumentation() {
+  if (!Enabled)
+    return;
+  std::lock_guard<std::mutex> Lock(PassProfiles->Mutex);
+  for (Record &R : Slowest)
+    addSlowPassRun(PassProfiles->Slowest, std::move(R));
+  if (--PassProfiles->NumLive == 0)
+    PassProfiles->write();
+}
+
+bool PassProfilingInstrumentation::runBeforePass(StringRef PassID, Any IR) {
+  if (isPassManagerOrAdaptor(PassID))
+    return true;
+
+  Stack.push_back({PassID.str(), getIRName(IR), get_threadid(),
+                   ClockType::now(), ClockType::duration(),
+                   getInstructionCount(IR), 0});
+  return true;
+}
+
+void PassProfilingInstrumentation::runBeforeSkippedPass(StringRef PassID) {
+  if (isPassManagerOrAdaptor(PassID))
+    return;
+  assert(!Stack.empty() && "Unbalanced pass instrumentation callbacks");
+  Stack.pop_back();
+}
+
+void PassProfilingInstrumentation::runAfterPass(StringRef PassID, Any IR) {
+  if (isPassManagerOrAdaptor(PassID))
+    return;
+  finishRecord(getInstructionCount(IR));
+}
+
+void PassProfilingInstrumentation::runAfterPassInvalidated(StringRef PassID) {
+  if (isPassManagerOrAdaptor(PassID))
+    return;
+  // The IR unit is gone, so its instruction count can't be taken. Report it
+  // as unchanged.
+  finishRecord(Stack.back().InstsBefore);
+}
+
+void PassProfilingInstrumentation::finishRecord(int64_t InstsAfter) {
+  assert(!Stack.empty() && "Unbalanced pass instrumentation callbacks");
+  Record R = std::move(Stack.back());
+  Stack.pop_back();
+  R.Duration = ClockType::now() - R.Start;
+  R.InstsAfter = InstsAfter;
+  addSlowPassRun(Slowest, std::move(R));
+}
+
+void PassProfilingInstrumentation::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (PassProfileOutput.empty() || Enabled)
+    return;
+
+  Enabled = true;
+  {
+    std::lock_guard<std::mutex> Lock(PassProfiles->Mutex);
+    if (PassProfiles->NumLive++ == 0 && PassProfiles->Slowest.empty())
+      PassProfiles->StartTime = ClockType::now();
+  }
+  PIC.registerBeforePassCallback(
+      [this](StringRef P, Any IR) { return this->runBeforePass(P, IR); });
+  PIC.registerBeforeSkippedPassCallback(
+      [this](StringRef P, Any) { this->runBeforeSkippedPass(P); });
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any IR) { this->runAfterPass(P, IR); });
+  PIC.registerAfterPassInvalidatedCallback(
+      [this](StringRef P) { this->runAfterPassInvalidated(P); });
+}
+
 void StandardInstrumentations::registerCallbacks(
     PassInstrumentationCallbacks &PIC) {
   PrintIR.registerCallbacks(PIC);
   TimePasses.registerCallbacks(PIC);
+  Verify.registerCallbacks(PIC);
+  PassProfiling.registerCallbacks(PIC);
 }
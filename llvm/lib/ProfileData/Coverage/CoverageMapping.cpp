@@ -27,6 +27,8 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -34,6 +36,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -187,6 +190,16 @@ Expected<int64_t> CounterMappingContext::evaluate(const Counter &C) const {
 }
 
 void FunctionRecordIterator::skipOtherFiles() {
+  if (UseRecordIndices) {
+    while (!RecordIndices.empty() &&
+           Filename != Records[RecordIndices.front()].Filenames[0])
+      RecordIndices = RecordIndices.drop_front();
+    if (RecordIndices.empty())
+      *this = FunctionRecordIterator();
+    else
+      Current = &Records[RecordIndices.front()];
+    return;
+  }
   while (Current != Records.end() && !Filename.empty() &&
          Filename != Current->Filenames[0])
     ++Current;
@@ -194,9 +207,44 @@ void FunctionRecordIterator::skipOtherFiles() {
     *this = FunctionRecordIterator();
 }
 
-Error CoverageMapping::loadFunctionRecord(
-    const CoverageMappingRecord &Record,
-    IndexedInstrProfReader &ProfileReader) {
+ArrayRef<unsigned> CoverageMapping::getImpreciseRecordIndicesForFilename(
+    StringRef Filename) const {
+  auto RecordIt = FilenameHash2RecordIndices.find(hash_value(Filename));
+  if (RecordIt == FilenameHash2RecordIndices.end())
+    return {};
+  return RecordIt->second;
+}
+
+namespace {
+
+/// The function records evaluated from the records of one coverage reader.
+struct ReaderFunctionRecords {
+  std::vector<FunctionRecord> Functions;
+  std::vector<std::pair<std::string, uint64_t>> FuncHashMismatches;
+  /// Guards against adding a record twice for the same (filenames, function)
+  /// pair, which happens for inline functions used in many TUs.
+  DenseMap<size_t, DenseSet<size_t>> RecordProvenance;
+  Optional<Error> Err;
+};
+
+} // end anonymous namespace
+
+/// Record that \p Function has been seen.
+///
+/// \returns false if a function of the same name and files was seen before.
+static bool insertProvenance(DenseMap<size_t, DenseSet<size_t>> &Provenance,
+                             const FunctionRecord &Function) {
+  auto FilenamesHash = hash_combine_range(Function.Filenames.begin(),
+                                          Function.Filenames.end());
+  return Provenance[FilenamesHash].insert(hash_value(Function.Name)).second;
+}
+
+/// Evaluate the counters of \p Record and add the resulting function record to
+/// \p Result. Lookups in \p ProfileReader are serialized by \p ProfileLock.
+static Error evaluateFunctionRecord(const CoverageMappingRecord &Record,
+                                    IndexedInstrProfReader &ProfileReader,
+                                    std::mutex &ProfileLock,
+                                    ReaderFunctionRecords &Result) {
   StringRef OrigFuncName = Record.FunctionName;
   if (OrigFuncName.empty())
     return make_error<CoverageMapError>(coveragemap_error::malformed);
@@ -209,11 +257,15 @@ Error CoverageMapping::loadFunctionRecord(
   CounterMappingContext Ctx(Record.Expressions);
 
   std::vector<uint64_t> Counts;
-  if (Error E = ProfileReader.getFunctionCounts(Record.FunctionName,
-                                                Record.FunctionHash, Counts)) {
-    instrprof_error IPE = InstrProfError::take(std::move(E));
+  std::unique_lock<std::mutex> ProfileGuard(ProfileLock);
+  Error CountsErr = ProfileReader.getFunctionCounts(
+      Record.FunctionName, Record.FunctionHash, Counts);
+  ProfileGuard.unlock();
+  if (CountsErr) {
+    instrprof_error IPE = InstrProfError::take(std::move(CountsErr));
     if (IPE == instrprof_error::hash_mismatch) {
-      FuncHashMismatches.emplace_back(Record.FunctionName, Record.FunctionHash);
+      Result.FuncHashMismatches.emplace_back(Record.FunctionName,
+                                             Record.FunctionHash);
       return Error::success();
     } else if (IPE != instrprof_error::unknown_function)
       return make_error<InstrProfError>(IPE);
@@ -243,59 +295,169 @@ Error CoverageMapping::loadFunctionRecord(
   }
 
   // Don't create records for (filenames, function) pairs we've already seen.
-  auto FilenamesHash = hash_combine_range(Record.Filenames.begin(),
-                                          Record.Filenames.end());
-  if (!RecordProvenance[FilenamesHash].insert(hash_value(OrigFuncName)).second)
-    return Error::success();
+  if (insertProvenance(Result.RecordProvenance, Function))
+    Result.Functions.push_back(std::move(Function));
+  return Error::success();
+}
+
+static void loadReaderRecords(CoverageMappingReader &CoverageReader,
+                              IndexedInstrProfReader &ProfileReader,
+                              std::mutex &ProfileLock,
+                              ReaderFunctionRecords &Result) {
+  for (auto RecordOrErr : CoverageReader) {
+    if (Error E = RecordOrErr.takeError()) {
+      Result.Err = std::move(E);
+      return;
+    }
+    if (Error E = evaluateFunctionRecord(*RecordOrErr, ProfileReader,
+                                         ProfileLock, Result)) {
+      Result.Err = std::move(E);
+      return;
+    }
+  }
+}
+
+/// \returns the number of threads to use for \p NumTasks tasks when asked for
+/// \p NumThreads, where zero means the hardware default.
+static unsigned getLoadThreads(unsigned NumThreads, size_t NumTasks) {
+  if (NumThreads == 0)
+    NumThreads = heavyweight_hardware_concurrency();
+  return std::max(1U, std::min(NumThreads, unsigned(NumTasks)));
+}
+
+/// \returns the error of the first of \p Results which failed, if any, and
+/// consumes the errors of the others.
+template <typename ResultT>
+static Optional<Error> takeFirstError(MutableArrayRef<ResultT> Results) {
+  Optional<Error> FirstErr;
+  for (ResultT &Result : Results) {
+    if (!Result.Err)
+      continue;
+    if (FirstErr)
+      consumeError(std::move(*Result.Err));
+    else
+      FirstErr = std::move(*Result.Err);
+  }
+  return FirstErr;
+}
+
+void CoverageMapping::addFunctionRecord(FunctionRecord &&Function) {
+  if (!insertProvenance(RecordProvenance, Function))
+    return;
+
+  // Index the record under each of its distinct filenames.
+  unsigned RecordIndex = Functions.size();
+  for (StringRef Filename : Function.Filenames) {
+    auto &RecordIndices = FilenameHash2RecordIndices[hash_value(Filename)];
+    if (RecordIndices.empty() || RecordIndices.back() != RecordIndex)
+      RecordIndices.push_back(RecordIndex);
+  }
 
   Functions.push_back(std::move(Function));
-  return Error::success();
 }
 
 Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
     ArrayRef<std::unique_ptr<CoverageMappingReader>> CoverageReaders,
-    IndexedInstrProfReader &ProfileReader) {
+    IndexedInstrProfReader &ProfileReader, unsigned NumThreads) {
   auto Coverage = std::unique_ptr<CoverageMapping>(new CoverageMapping());
 
-  for (const auto &CoverageReader : CoverageReaders) {
-    for (auto RecordOrErr : *CoverageReader) {
-      if (Error E = RecordOrErr.takeError())
-        return std::move(E);
-      const auto &Record = *RecordOrErr;
-      if (Error E = Coverage->loadFunctionRecord(Record, ProfileReader))
-        return std::move(E);
-    }
+  // Decode and evaluate the records of each reader independently, then merge
+  // the results in reader order so that they don't depend on scheduling.
+  std::vector<ReaderFunctionRecords> Results(CoverageReaders.size());
+  std::mutex ProfileLock;
+  NumThreads = getLoadThreads(NumThreads, CoverageReaders.size());
+  if (NumThreads == 1) {
+    for (unsigned I = 0, E = CoverageReaders.size(); I < E; ++I)
+      loadReaderRecords(*CoverageReaders[I], ProfileReader, ProfileLock,
+                        Results[I]);
+  } else {
+    ThreadPool Pool(NumThreads);
+    for (unsigned I = 0, E = CoverageReaders.size(); I < E; ++I)
+      Pool.async(loadReaderRecords, std::ref(*CoverageReaders[I]),
+                 std::ref(ProfileReader), std::ref(ProfileLock),
+                 std::ref(Results[I]));
+    Pool.wait();
+  }
+
+  if (Optional<Error> E = takeFirstError<ReaderFunctionRecords>(Results))
+    return std::move(*E);
+
+  for (ReaderFunctionRecords &Result : Results) {
+    for (FunctionRecord &Function : Result.Functions)
+      Coverage->addFunctionRecord(std::move(Function));
+    Coverage->FuncHashMismatches.insert(
+        Coverage->FuncHashMismatches.end(),
+        std::make_move_iterator(Result.FuncHashMismatches.begin()),
+        std::make_move_iterator(Result.FuncHashMismatches.end()));
+    Result = ReaderFunctionRecords();
   }
 
   return std::move(Coverage);
 }
 
+namespace {
+
+/// The coverage readers for one object file, and the buffers they refer to.
+struct ObjectCoverageReaders {
+  std::unique_ptr<MemoryBuffer> ObjectBuffer;
+  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
+  std::vector<std::unique_ptr<BinaryCoverageReader>> Readers;
+  Optional<Error> Err;
+};
+
+} // end anonymous namespace
+
+static void createObjectReaders(StringRef ObjectFilename, StringRef Arch,
+                                ObjectCoverageReaders &Result) {
+  auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(ObjectFilename);
+  if (std::error_code EC = CovMappingBufOrErr.getError()) {
+    Result.Err = errorCodeToError(EC);
+    return;
+  }
+  Result.ObjectBuffer = std::move(CovMappingBufOrErr.get());
+  auto CoverageReadersOrErr = BinaryCoverageReader::create(
+      Result.ObjectBuffer->getMemBufferRef(), Arch, Result.Buffers);
+  if (Error E = CoverageReadersOrErr.takeError()) {
+    Result.Err = std::move(E);
+    return;
+  }
+  Result.Readers = std::move(CoverageReadersOrErr.get());
+}
+
 Expected<std::unique_ptr<CoverageMapping>>
 CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
-                      StringRef ProfileFilename, ArrayRef<StringRef> Arches) {
+                      StringRef ProfileFilename, ArrayRef<StringRef> Arches,
+                      unsigned NumThreads) {
   auto ProfileReaderOrErr = IndexedInstrProfReader::create(ProfileFilename);
   if (Error E = ProfileReaderOrErr.takeError())
     return std::move(E);
   auto ProfileReader = std::move(ProfileReaderOrErr.get());
 
+  // Parse the objects concurrently, keeping their readers in input order.
+  std::vector<ObjectCoverageReaders> Objects(ObjectFilenames.size());
+  auto getArch = [&](size_t I) {
+    return Arches.empty() ? StringRef() : Arches[I];
+  };
+  unsigned ObjectThreads = getLoadThreads(NumThreads, ObjectFilenames.size());
+  if (ObjectThreads == 1) {
+    for (unsigned I = 0, E = ObjectFilenames.size(); I < E; ++I)
+      createObjectReaders(ObjectFilenames[I], getArch(I), Objects[I]);
+  } else {
+    ThreadPool Pool(ObjectThreads);
+    for (unsigned I = 0, E = ObjectFilenames.size(); I < E; ++I)
+      Pool.async(createObjectReaders, ObjectFilenames[I], getArch(I),
+                 std::ref(Objects[I]));
+    Pool.wait();
+  }
+
+  if (Optional<Error> E = takeFirstError<ObjectCoverageReaders>(Objects))
+    return std::move(*E);
+
   SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
-  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
-  for (const auto &File : llvm::enumerate(ObjectFilenames)) {
-    auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(File.value());
-    if (std::error_code EC = CovMappingBufOrErr.getError())
-      return errorCodeToError(EC);
-    StringRef Arch = Arches.empty() ? StringRef() : Arches[File.index()];
-    MemoryBufferRef CovMappingBufRef =
-        CovMappingBufOrErr.get()->getMemBufferRef();
-    auto CoverageReadersOrErr =
-        BinaryCoverageReader::create(CovMappingBufRef, Arch, Buffers);
-    if (Error E = CoverageReadersOrErr.takeError())
-      return std::move(E);
-    for (auto &Reader : CoverageReadersOrErr.get())
+  for (ObjectCoverageReaders &Object : Objects)
+    for (auto &Reader : Object.Readers)
       Readers.push_back(std::move(Reader));
-    Buffers.push_back(std::move(CovMappingBufOrErr.get()));
-  }
-  return load(Readers, *ProfileReader);
+  return load(Readers, *ProfileReader, NumThreads);
 }
 
 namespace {
@@ -607,7 +769,11 @@ CoverageData CoverageMapping::getCoverageForFile(StringRef Filename) const {
   CoverageData FileCoverage(Filename);
   std::vector<CountedRegion> Regions;
 
-  for (const auto &Function : Functions) {
+  // Look up the function records for the filename to avoid a linear scan.
+  ArrayRef<unsigned> RecordIndices =
+      getImpreciseRecordIndicesForFilename(Filename);
+  for (unsigned RecordIndex : RecordIndices) {
+    const FunctionRecord &Function = Functions[RecordIndex];
     auto MainFileID = findMainViewFileID(Filename, Function);
     auto FileIDs = gatherFileIDs(Filename, Function);
     for (const auto &CR : Function.CountedRegions)
@@ -627,7 +793,11 @@ CoverageData CoverageMapping::getCoverageForFile(StringRef Filename) const {
 std::vector<InstantiationGroup>
 CoverageMapping::getInstantiationGroups(StringRef Filename) const {
   FunctionInstantiationSetCollector InstantiationSetCollector;
-  for (const auto &Function : Functions) {
+  // Look up the function records for the filename to avoid a linear scan.
+  ArrayRef<unsigned> RecordIndices =
+      getImpreciseRecordIndicesForFilename(Filename);
+  for (unsigned RecordIndex : RecordIndices) {
+    const FunctionRecord &Function = Functions[RecordIndex];
     auto MainFileID = findMainViewFileID(Filename, Function);
     if (!MainFileID)
       continue;
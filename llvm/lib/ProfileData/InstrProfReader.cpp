@@ -15,6 +15,8 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/InstrProf.h"
@@ -22,6 +24,8 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SymbolRemappingReader.h"
 #include "llvm/Support/SwapByteOrder.h"
@@ -31,6 +35,7 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <system_error>
 #include <utility>
 #include <vector>
@@ -46,6 +51,57 @@ setupMemoryBuffer(const Twine &Path) {
   return std::move(BufferOrErr.get());
 }
 
+namespace {
+/// The indexed profiles mapped by the readers of this process. The readers of
+/// one file, like those of clang's frontend and of the ThinLTO backends that
+/// run in the same process, share a single read-only mapping of it, which
+/// lives as long as any of them.
+class IndexedProfileMappings {
+  struct Mapping {
+    sys::fs::UniqueID ID;
+    sys::TimePoint<> ModTime;
+    uint64_t Size = 0;
+    std::weak_ptr<MemoryBuffer> Buffer;
+  };
+
+  std::mutex Lock;
+  StringMap<Mapping> Mappings;
+
+public:
+  /// \returns the mapping of \p Path, which is shared with the other readers
+  /// unless the file changed since they mapped it.
+  Expected<std::shared_ptr<MemoryBuffer>> get(StringRef Path) {
+    sys::fs::file_status Status;
+    if (std::error_code EC = sys::fs::status(Path, Status))
+      return errorCodeToError(EC);
+
+    std::lock_guard<std::mutex> Guard(Lock);
+    Mapping &M = Mappings[Path];
+    if (std::shared_ptr<MemoryBuffer> Buffer = M.Buffer.lock())
+      if (M.ID == Status.getUniqueID() &&
+          M.ModTime == Status.getLastModificationTime() &&
+          M.Size == Status.getSize())
+        return Buffer;
+
+    // The reader does not need the null terminator, which would prevent
+    // mapping the files whose size is a multiple of the page size.
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+        MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                              /*RequiresNullTerminator=*/false);
+    if (std::error_code EC = BufferOrErr.getError())
+      return errorCodeToError(EC);
+    std::shared_ptr<MemoryBuffer> Buffer = std::move(BufferOrErr.get());
+    M.ID = Status.getUniqueID();
+    M.ModTime = Status.getLastModificationTime();
+    M.Size = Status.getSize();
+    M.Buffer = Buffer;
+    return Buffer;
+  }
+};
+} // end anonymous namespace
+
+static ManagedStatic<IndexedProfileMappings> ProfileMappings;
+
 static Error initializeReader(InstrProfReader &Reader) {
   return Reader.readHeader();
 }
@@ -90,10 +146,24 @@ InstrProfReader::create(std::unique_ptr<MemoryBuffer> Buffer) {
 
 Expected<std::unique_ptr<IndexedInstrProfReader>>
 IndexedInstrProfReader::create(const Twine &Path, const Twine &RemappingPath) {
-  // Set up the buffer to read.
-  auto BufferOrError = setupMemoryBuffer(Path);
-  if (Error E = BufferOrError.takeError())
-    return std::move(E);
+  // Set up the buffer to read. Profiles read from stdin cannot be shared.
+  SmallString<256> PathStr;
+  StringRef PathRef = Path.toStringRef(PathStr);
+  std::shared_ptr<MemoryBuffer> SharedBuffer;
+  std::unique_ptr<MemoryBuffer> Buffer;
+  if (PathRef == "-") {
+    auto BufferOrError = setupMemoryBuffer(PathRef);
+    if (Error E = BufferOrError.takeError())
+      return std::move(E);
+    Buffer = std::move(BufferOrError.get());
+  } else {
+    auto SharedOrError = ProfileMappings->get(PathRef);
+    if (Error E = SharedOrError.takeError())
+      return std::move(E);
+    SharedBuffer = std::move(SharedOrError.get());
+    Buffer = MemoryBuffer::getMemBuffer(SharedBuffer->getMemBufferRef(),
+                                        /*RequiresNullTerminator=*/false);
+  }
 
   // Set up the remapping buffer if requested.
   std::unique_ptr<MemoryBuffer> RemappingBuffer;
@@ -105,8 +175,11 @@ IndexedInstrProfReader::create(const Twine &Path, const Twine &RemappingPath) {
     RemappingBuffer = std::move(RemappingBufferOrError.get());
   }
 
-  return IndexedInstrProfReader::create(std::move(BufferOrError.get()),
-                                        std::move(RemappingBuffer));
+  auto Result = IndexedInstrProfReader::create(std::move(Buffer),
+                                               std::move(RemappingBuffer));
+  if (Result)
+    (*Result)->SharedDataBuffer = std::move(SharedBuffer);
+  return Result;
 }
 
 Expected<std::unique_ptr<IndexedInstrProfReader>>
@@ -362,7 +435,9 @@ Error RawInstrProfReader<IntPtrT>::readHeader(
   CountersDelta = swap(Header.CountersDelta);
   NamesDelta = swap(Header.NamesDelta);
   auto DataSize = swap(Header.DataSize);
+  auto PaddingBytesBeforeCounters = swap(Header.PaddingBytesBeforeCounters);
   auto CountersSize = swap(Header.CountersSize);
+  auto PaddingBytesAfterCounters = swap(Header.PaddingBytesAfterCounters);
   NamesSize = swap(Header.NamesSize);
   ValueKindLast = swap(Header.ValueKindLast);
 
@@ -370,8 +445,10 @@ Error RawInstrProfReader<IntPtrT>::readHeader(
   auto PaddingSize = getNumPaddingBytes(NamesSize);
 
   ptrdiff_t DataOffset = sizeof(RawInstrProf::Header);
-  ptrdiff_t CountersOffset = DataOffset + DataSizeInBytes;
-  ptrdiff_t NamesOffset = CountersOffset + sizeof(uint64_t) * CountersSize;
+  ptrdiff_t CountersOffset =
+      DataOffset + DataSizeInBytes + PaddingBytesBeforeCounters;
+  ptrdiff_t NamesOffset = CountersOffset + sizeof(uint64_t) * CountersSize +
+                          PaddingBytesAfterCounters;
   ptrdiff_t ValueDataOffset = NamesOffset + NamesSize + PaddingSize;
 
   auto *Start = reinterpret_cast<const char *>(&Header);
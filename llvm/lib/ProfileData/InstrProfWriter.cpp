@@ -254,6 +254,7 @@ void InstrProfWriter::mergeRecordsFromWriter(InstrProfWriter &&IPW,
   for (auto &I : IPW.FunctionData)
     for (auto &Func : I.getValue())
       addRecord(I.getKey(), Func.first, std::move(Func.second), 1, Warn);
+  IPW.FunctionData.clear();
 }
 
 bool InstrProfWriter::shouldEncodeData(const ProfilingData &PD) {
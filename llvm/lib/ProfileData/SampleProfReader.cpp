@@ -358,7 +358,11 @@ ErrorOr<StringRef> SampleProfileReaderCompactBinary::readStringFromTable() {
   if (std::error_code EC = Idx.getError())
     return EC;
 
-  return StringRef(NameTable[*Idx]);
+  // Only the names the profiles to use refer to are turned into strings.
+  StringRef &Name = Names[*Idx];
+  if (Name.empty())
+    Name = NameSaver.save(std::to_string(uint64_t(NameTable[*Idx])));
+  return Name;
 }
 
 std::error_code
@@ -470,24 +474,27 @@ std::error_code SampleProfileReaderBinary::read() {
 std::error_code SampleProfileReaderCompactBinary::read() {
   std::vector<uint64_t> OffsetsToUse;
   if (UseAllFuncs) {
-    for (auto FuncEntry : FuncOffsetTable) {
-      OffsetsToUse.push_back(FuncEntry.second);
-    }
-  }
-  else {
+    for (const FuncOffsetEntry &Entry : FuncOffsetTable)
+      OffsetsToUse.push_back(Entry.Offset);
+  } else {
     for (auto Name : FuncsToUse) {
-      auto GUID = std::to_string(MD5Hash(Name));
-      auto iter = FuncOffsetTable.find(StringRef(GUID));
-      if (iter == FuncOffsetTable.end())
+      uint64_t GUID = MD5Hash(Name);
+      auto Entry = llvm::partition_point(
+          FuncOffsetTable,
+          [&](const FuncOffsetEntry &Entry) { return Entry.GUID < GUID; });
+      if (Entry == FuncOffsetTable.end() || Entry->GUID != GUID)
         continue;
-      OffsetsToUse.push_back(iter->second);
+      OffsetsToUse.push_back(Entry->Offset);
     }
   }
 
+  const uint8_t *Start =
+      reinterpret_cast<const uint8_t *>(Buffer->getBufferStart());
   for (auto Offset : OffsetsToUse) {
+    if (Offset >= uint64_t(End - Start))
+      return sampleprof_error::truncated;
     const uint8_t *SavedData = Data;
-    Data = reinterpret_cast<const uint8_t *>(Buffer->getBufferStart()) +
-           Offset;
+    Data = Start + Offset;
     if (std::error_code EC = readFuncProfile())
       return EC;
     Data = SavedData;
@@ -508,6 +515,20 @@ SampleProfileReaderCompactBinary::verifySPMagic(uint64_t Magic) {
   return sampleprof_error::bad_magic;
 }
 
+std::error_code SampleProfileReaderBinary::verifySPVersion(uint64_t Version) {
+  if (Version == SPVersion())
+    return sampleprof_error::success;
+  return sampleprof_error::unsupported_version;
+}
+
+std::error_code
+SampleProfileReaderCompactBinary::verifySPVersion(uint64_t Version) {
+  if (Version != SPCompactVersion() && Version != SPVersion())
+    return sampleprof_error::unsupported_version;
+  HasFixedWidthTables = Version == SPCompactVersion();
+  return sampleprof_error::success;
+}
+
 std::error_code SampleProfileReaderRawBinary::readNameTable() {
   auto Size = readNumber<uint32_t>();
   if (std::error_code EC = Size.getError())
@@ -527,13 +548,23 @@ std::error_code SampleProfileReaderCompactBinary::readNameTable() {
   auto Size = readNumber<uint64_t>();
   if (std::error_code EC = Size.getError())
     return EC;
-  NameTable.reserve(*Size);
-  for (uint32_t I = 0; I < *Size; ++I) {
-    auto FID = readNumber<uint64_t>();
-    if (std::error_code EC = FID.getError())
-      return EC;
-    NameTable.push_back(std::to_string(*FID));
+  if (!HasFixedWidthTables) {
+    DecodedNameTable.reserve(*Size);
+    for (uint64_t I = 0; I < *Size; ++I) {
+      auto FID = readNumber<uint64_t>();
+      if (std::error_code EC = FID.getError())
+        return EC;
+      DecodedNameTable.push_back(support::ulittle64_t(*FID));
+    }
+    NameTable = DecodedNameTable;
+    return sampleprof_error::success;
   }
+
+  if (*Size > uint64_t(End - Data) / sizeof(uint64_t))
+    return sampleprof_error::truncated_name_table;
+  NameTable = makeArrayRef(
+      reinterpret_cast<const support::ulittle64_t *>(Data), *Size);
+  Data += *Size * sizeof(uint64_t);
   return sampleprof_error::success;
 }
 
@@ -552,8 +583,8 @@ std::error_code SampleProfileReaderBinary::readHeader() {
   auto Version = readNumber<uint64_t>();
   if (std::error_code EC = Version.getError())
     return EC;
-  else if (*Version != SPVersion())
-    return sampleprof_error::unsupported_version;
+  else if (std::error_code EC = verifySPVersion(*Version))
+    return EC;
 
   if (std::error_code EC = readSummary())
     return EC;
@@ -564,7 +595,8 @@ std::error_code SampleProfileReaderBinary::readHeader() {
 }
 
 std::error_code SampleProfileReaderCompactBinary::readHeader() {
-  SampleProfileReaderBinary::readHeader();
+  if (std::error_code EC = SampleProfileReaderBinary::readHeader())
+    return EC;
   if (std::error_code EC = readFuncOffsetTable())
     return EC;
   return sampleprof_error::success;
@@ -575,27 +607,47 @@ std::error_code SampleProfileReaderCompactBinary::readFuncOffsetTable() {
   if (std::error_code EC = TableOffset.getError())
     return EC;
 
+  const uint8_t *Start =
+      reinterpret_cast<const uint8_t *>(Buffer->getBufferStart());
+  if (*TableOffset >= uint64_t(End - Start))
+    return sampleprof_error::truncated;
   const uint8_t *SavedData = Data;
-  const uint8_t *TableStart =
-      reinterpret_cast<const uint8_t *>(Buffer->getBufferStart()) +
-      *TableOffset;
+  const uint8_t *TableStart = Start + *TableOffset;
   Data = TableStart;
 
   auto Size = readNumber<uint64_t>();
   if (std::error_code EC = Size.getError())
     return EC;
 
-  FuncOffsetTable.reserve(*Size);
-  for (uint32_t I = 0; I < *Size; ++I) {
-    auto FName(readStringFromTable());
-    if (std::error_code EC = FName.getError())
-      return EC;
+  if (!HasFixedWidthTables) {
+    // Decode the entries into the form of the fixed-width table.
+    DecodedFuncOffsetTable.reserve(*Size);
+    for (uint64_t I = 0; I < *Size; ++I) {
+      auto Idx = readStringIndex(NameTable);
+      if (std::error_code EC = Idx.getError())
+        return EC;
 
-    auto Offset = readNumber<uint64_t>();
-    if (std::error_code EC = Offset.getError())
-      return EC;
+      auto Offset = readNumber<uint64_t>();
+      if (std::error_code EC = Offset.getError())
+        return EC;
+
+      FuncOffsetEntry Entry;
+      Entry.GUID = NameTable[*Idx];
+      Entry.Offset = *Offset;
+      DecodedFuncOffsetTable.push_back(Entry);
+    }
+    llvm::sort(DecodedFuncOffsetTable,
+               [](const FuncOffsetEntry &A, const FuncOffsetEntry &B) {
+                 return A.GUID < B.GUID;
+               });
+    FuncOffsetTable = DecodedFuncOffsetTable;
+  } else {
+    if (*Size > uint64_t(End - Data) / sizeof(FuncOffsetEntry))
+      return sampleprof_error::truncated;
 
-    FuncOffsetTable[*FName] = *Offset;
+    // The table is searched in place, rather than decoded.
+    FuncOffsetTable = makeArrayRef(
+        reinterpret_cast<const FuncOffsetEntry *>(Data), *Size);
   }
   End = TableStart;
   Data = SavedData;
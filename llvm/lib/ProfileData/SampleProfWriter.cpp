@@ -190,13 +190,18 @@ std::error_code SampleProfileWriterCompactBinary::writeFuncOffsetTable() {
   if (OFS.seek(FuncOffsetTableStart) == (uint64_t)-1)
     return sampleprof_error::ostream_seek_unsupported;
 
-  // Write out the table size.
-  encodeULEB128(FuncOffsetTable.size(), OS);
+  // Write out FuncOffsetTable sorted by the MD5 of the names, for the reader
+  // to search it in place.
+  std::vector<std::pair<uint64_t, uint64_t>> Entries;
+  Entries.reserve(FuncOffsetTable.size());
+  for (auto Entry : FuncOffsetTable)
+    Entries.emplace_back(MD5Hash(Entry.first), Entry.second);
+  llvm::sort(Entries);
 
-  // Write out FuncOffsetTable.
-  for (auto entry : FuncOffsetTable) {
-    writeNameIdx(entry.first);
-    encodeULEB128(entry.second, OS);
+  encodeULEB128(Entries.size(), OS);
+  for (const auto &Entry : Entries) {
+    Writer.write(Entry.first);
+    Writer.write(Entry.second);
   }
   return sampleprof_error::success;
 }
@@ -206,11 +211,12 @@ std::error_code SampleProfileWriterCompactBinary::writeNameTable() {
   std::set<StringRef> V;
   stablizeNameTable(V);
 
-  // Write out the name table.
+  // Write out the name table, with fixed-width entries that the reader can
+  // index without decoding the whole table.
+  support::endian::Writer Writer(OS, support::little);
   encodeULEB128(NameTable.size(), OS);
-  for (auto N : V) {
-    encodeULEB128(MD5Hash(N), OS);
-  }
+  for (auto N : V)
+    Writer.write(MD5Hash(N));
   return sampleprof_error::success;
 }
 
@@ -226,7 +232,7 @@ std::error_code SampleProfileWriterCompactBinary::writeMagicIdent() {
   auto &OS = *OutputStream;
   // Write file magic identifier.
   encodeULEB128(SPMagic(SPF_Compact_Binary), OS);
-  encodeULEB128(SPVersion(), OS);
+  encodeULEB128(SPCompactVersion(), OS);
   return sampleprof_error::success;
 }
 
@@ -11,12 +11,135 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Memory.h"
 #include "llvm/Support/raw_ostream.h"
+#include <atomic>
+#include <mutex>
 
 namespace llvm {
 
+namespace {
+struct AllocatorStats {
+  size_t CurrentBytes = 0;
+  size_t PeakBytes = 0;
+  size_t NumSlabs = 0;
+  size_t WastedBytes = 0;
+  // Bytes of slabs allocated from each code address.
+  DenseMap<const void *, size_t> SiteBytes;
+};
+
+struct AllocatorStatsRegistry {
+  std::mutex Mu;
+  std::atomic<bool> Enabled{false};
+  StringMap<AllocatorStats> Stats;
+};
+} // namespace
+
+// Allocators with static storage duration may free their slabs after
+// llvm_shutdown and static destructors have run, so this is never destroyed.
+static AllocatorStatsRegistry &getRegistry() {
+  static AllocatorStatsRegistry *Registry = new AllocatorStatsRegistry;
+  return *Registry;
+}
+
+void enableAllocatorStats() {
+  getRegistry().Enabled.store(true, std::memory_order_relaxed);
+}
+
+void printAllocatorStats(raw_ostream &OS) {
+  AllocatorStatsRegistry &R = getRegistry();
+  std::lock_guard<std::mutex> Lock(R.Mu);
+
+  std::vector<StringMapEntry<AllocatorStats> *> Entries;
+  for (StringMapEntry<AllocatorStats> &E : R.Stats)
+    if (E.second.PeakBytes)
+      Entries.push_back(&E);
+  llvm::sort(Entries, [](StringMapEntry<AllocatorStats> *A,
+                         StringMapEntry<AllocatorStats> *B) {
+    if (A->second.PeakBytes != B->second.PeakBytes)
+      return A->second.PeakBytes > B->second.PeakBytes;
+    return A->first() < B->first();
+  });
+
+  OS << "===" << std::string(73, '-') << "===\n"
+     << "                           Allocator Statistics\n"
+     << "===" << std::string(73, '-') << "===\n"
+     << "   Peak bytes  Current bytes    Slabs  Wasted bytes  Name\n";
+  for (StringMapEntry<AllocatorStats> *E : Entries) {
+    const AllocatorStats &S = E->second;
+    OS << format("%13zu  %13zu  %7zu  %12zu  ", S.PeakBytes, S.CurrentBytes,
+                 S.NumSlabs, S.WastedBytes)
+       << E->first() << '\n';
+
+    // Show the code that allocated the most memory.
+    std::vector<std::pair<const void *, size_t>> Sites(S.SiteBytes.begin(),
+                                                        S.SiteBytes.end());
+    llvm::sort(Sites, [](const std::pair<const void *, size_t> &A,
+                         const std::pair<const void *, size_t> &B) {
+      if (A.second != B.second)
+        return A.second > B.second;
+      return A.first < B.first;
+    });
+    if (Sites.size() > 5)
+      Sites.resize(5);
+    for (const std::pair<const void *, size_t> &Site : Sites)
+      if (Site.first)
+        OS << format("%13zu  from %p\n", Site.second, Site.first);
+  }
+}
+
 namespace detail {
 
+const char *getAllocatorStatsName(StringRef Name) {
+  AllocatorStatsRegistry &R = getRegistry();
+  std::lock_guard<std::mutex> Lock(R.Mu);
+  return R.Stats.try_emplace(Name).first->getKeyData();
+}
+
+void recordAllocatorSlab(const char *Name, const void *Site, size_t Size,
+                         size_t Wasted) {
+  AllocatorStatsRegistry &R = getRegistry();
+  if (!R.Enabled.load(std::memory_order_relaxed))
+    return;
+  std::lock_guard<std::mutex> Lock(R.Mu);
+  AllocatorStats &S = R.Stats[Name];
+  S.CurrentBytes += Size;
+  S.PeakBytes = std::max(S.PeakBytes, S.CurrentBytes);
+  S.WastedBytes += Wasted;
+  ++S.NumSlabs;
+  S.SiteBytes[Site] += Size;
+}
+
+void *allocateHugePageSlab(size_t Size) {
+  std::error_code EC;
+  sys::MemoryBlock MB = sys::Memory::allocateMappedMemory(
+      Size, nullptr,
+      sys::Memory::MF_READ | sys::Memory::MF_WRITE |
+          sys::Memory::MF_HUGE_HINT,
+      EC);
+  if (EC)
+    report_bad_alloc_error("Allocation failed");
+  return MB.base();
+}
+
+void deallocateHugePageSlab(void *Slab, size_t Size) {
+  sys::MemoryBlock MB(Slab, Size);
+  sys::Memory::releaseMappedMemory(MB);
+}
+
+void recordAllocatorSlabFree(const char *Name, size_t Size) {
+  AllocatorStatsRegistry &R = getRegistry();
+  if (!R.Enabled.load(std::memory_order_relaxed))
+    return;
+  std::lock_guard<std::mutex> Lock(R.Mu);
+  AllocatorStats &S = R.Stats[Name];
+  // Slabs allocated before stats were enabled were not counted.
+  S.CurrentBytes -= std::min(S.CurrentBytes, Size);
+}
+
 void printBumpPtrAllocatorStats(unsigned NumSlabs, size_t BytesAllocated,
                                 size_t TotalMemory) {
   errs() << "\nNumber of memory regions: " << NumSlabs << '\n'
@@ -20,6 +20,8 @@
 #if LLVM_ENABLE_ZLIB == 1 && HAVE_ZLIB_H
 #include <zlib.h>
 #endif
+#include <algorithm>
+#include <limits>
 
 using namespace llvm;
 
@@ -85,6 +87,56 @@ uint32_t zlib::crc32(StringRef Buffer) {
   return ::crc32(0, (const Bytef *)Buffer.data(), Buffer.size());
 }
 
+Error zlib::compressRaw(StringRef InputBuffer,
+                        SmallVectorImpl<char> &CompressedBuffer, int Level,
+                        bool IsLast) {
+  assert(InputBuffer.size() <= std::numeric_limits<uInt>::max() &&
+         "input is too large to compress in one piece");
+  z_stream Stream = {};
+  // A negative window size makes zlib omit the header and the checksum.
+  int Res = ::deflateInit2(&Stream, Level, Z_DEFLATED, /*windowBits=*/-15,
+                           /*memLevel=*/8, Z_DEFAULT_STRATEGY);
+  if (Res != Z_OK)
+    return createError(convertZlibCodeToString(Res));
+
+  Stream.next_in = (Bytef *)InputBuffer.data();
+  Stream.avail_in = InputBuffer.size();
+  CompressedBuffer.clear();
+  int Flush = IsLast ? Z_FINISH : Z_SYNC_FLUSH;
+  do {
+    size_t Pos = CompressedBuffer.size();
+    CompressedBuffer.resize(
+        Pos + std::max<size_t>(::deflateBound(&Stream, Stream.avail_in), 64));
+    Stream.next_out = (Bytef *)CompressedBuffer.data() + Pos;
+    Stream.avail_out = CompressedBuffer.size() - Pos;
+    Res = ::deflate(&Stream, Flush);
+    // Tell MemorySanitizer that zlib output buffer is fully initialized.
+    // This avoids a false report when running LLVM with uninstrumented ZLib.
+    __msan_unpoison(CompressedBuffer.data() + Pos,
+                    CompressedBuffer.size() - Pos - Stream.avail_out);
+    CompressedBuffer.resize(CompressedBuffer.size() - Stream.avail_out);
+  } while (Res == Z_OK && Stream.avail_out == 0);
+  ::deflateEnd(&Stream);
+
+  // If a sync flush exactly filled the output, the next call may have nothing
+  // left to write, which zlib reports as Z_BUF_ERROR. That is not an error
+  // once all of the input has been consumed.
+  if (!IsLast && Res == Z_BUF_ERROR && Stream.avail_in == 0)
+    Res = Z_OK;
+
+  if (Res == (IsLast ? Z_STREAM_END : Z_OK))
+    return Error::success();
+  return createError(convertZlibCodeToString(Res));
+}
+
+uint32_t zlib::adler32(StringRef Buffer) {
+  return ::adler32(1, (const Bytef *)Buffer.data(), Buffer.size());
+}
+
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Len2) {
+  return ::adler32_combine(Adler1, Adler2, Len2);
+}
+
 #else
 bool zlib::isAvailable() { return false; }
 Error zlib::compress(StringRef InputBuffer,
@@ -103,4 +155,15 @@ Error zlib::uncompress(StringRef InputBuffer,
 uint32_t zlib::crc32(StringRef Buffer) {
   llvm_unreachable("zlib::crc32 is unavailable");
 }
+Error zlib::compressRaw(StringRef InputBuffer,
+                        SmallVectorImpl<char> &CompressedBuffer, int Level,
+                        bool IsLast) {
+  llvm_unreachable("zlib::compressRaw is unavailable");
+}
+uint32_t zlib::adler32(StringRef Buffer) {
+  llvm_unreachable("zlib::adler32 is unavailable");
+}
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Len2) {
+  llvm_unreachable("zlib::adler32Combine is unavailable");
+}
 #endif
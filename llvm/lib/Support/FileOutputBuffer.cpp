@@ -76,9 +76,9 @@ private:
 class InMemoryBuffer : public FileOutputBuffer {
 public:
   InMemoryBuffer(StringRef Path, MemoryBlock Buf, std::size_t BufSize,
-                 unsigned Mode)
-      : FileOutputBuffer(Path), Buffer(Buf), BufferSize(BufSize),
-        Mode(Mode) {}
+                 unsigned Mode, bool Atomic)
+      : FileOutputBuffer(Path), Buffer(Buf), BufferSize(BufSize), Mode(Mode),
+        Atomic(Atomic) {}
 
   uint8_t *getBufferStart() const override { return (uint8_t *)Buffer.base(); }
 
@@ -95,6 +95,10 @@ public:
       return Error::success();
     }
 
+    StringRef Data((const char *)Buffer.base(), BufferSize);
+    if (Atomic)
+      return commitAtomically(Data);
+
     using namespace sys::fs;
     int FD;
     std::error_code EC;
@@ -102,30 +106,60 @@ public:
             openFileForWrite(FinalPath, FD, CD_CreateAlways, OF_None, Mode))
       return errorCodeToError(EC);
     raw_fd_ostream OS(FD, /*shouldClose=*/true, /*unbuffered=*/true);
-    OS << StringRef((const char *)Buffer.base(), BufferSize);
+    OS << Data;
     return Error::success();
   }
 
 private:
+  // Writes the buffer to a temporary file with a single sequential write
+  // and renames it to the final path, just like OnDiskBuffer does.
+  Error commitAtomically(StringRef Data) {
+    Expected<fs::TempFile> FileOrErr =
+        fs::TempFile::create(FinalPath + ".tmp%%%%%%%", Mode);
+    if (!FileOrErr)
+      return FileOrErr.takeError();
+    fs::TempFile File = std::move(*FileOrErr);
+
+    raw_fd_ostream OS(File.FD, /*shouldClose=*/false, /*unbuffered=*/true);
+    OS << Data;
+    OS.flush();
+    if (OS.has_error()) {
+      std::error_code EC = OS.error();
+      OS.clear_error();
+      consumeError(File.discard());
+      return errorCodeToError(EC);
+    }
+    return File.keep(FinalPath);
+  }
+
   // Buffer may actually contain a larger memory block than BufferSize
   OwningMemoryBlock Buffer;
   size_t BufferSize;
   unsigned Mode;
+  // True if the final file should be replaced atomically by rename(2).
+  bool Atomic;
 };
 } // namespace
 
 static Expected<std::unique_ptr<InMemoryBuffer>>
-createInMemoryBuffer(StringRef Path, size_t Size, unsigned Mode) {
+createInMemoryBuffer(StringRef Path, size_t Size, unsigned Mode,
+                     bool Atomic = false) {
   std::error_code EC;
   MemoryBlock MB = Memory::allocateMappedMemory(
       Size, nullptr, sys::Memory::MF_READ | sys::Memory::MF_WRITE, EC);
   if (EC)
     return errorCodeToError(EC);
-  return std::make_unique<InMemoryBuffer>(Path, MB, Size, Mode);
+  return std::make_unique<InMemoryBuffer>(Path, MB, Size, Mode, Atomic);
 }
 
 static Expected<std::unique_ptr<FileOutputBuffer>>
-createOnDiskBuffer(StringRef Path, size_t Size, unsigned Mode) {
+createOnDiskBuffer(StringRef Path, size_t Size, unsigned Mode, bool NoMmap) {
+  // Writing through a memory mapping may be slow, e.g. on network filesystems
+  // where dirty pages are written back in small chunks in random order. If
+  // requested, keep the contents in memory and write them out on commit().
+  if (NoMmap)
+    return createInMemoryBuffer(Path, Size, Mode, /*Atomic=*/true);
+
   Expected<fs::TempFile> FileOrErr =
       fs::TempFile::create(Path + ".tmp%%%%%%%", Mode);
   if (!FileOrErr)
@@ -189,7 +223,7 @@ FileOutputBuffer::create(StringRef Path, size_t Size, unsigned Flags) {
   case fs::file_type::regular_file:
   case fs::file_type::file_not_found:
   case fs::file_type::status_error:
-    return createOnDiskBuffer(Path, Size, Mode);
+    return createOnDiskBuffer(Path, Size, Mode, Flags & F_no_mmap);
   default:
     return createInMemoryBuffer(Path, Size, Mode);
   }
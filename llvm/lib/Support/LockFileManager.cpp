@@ -16,7 +16,9 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <ctime>
 #include <memory>
 #include <sys/stat.h>
@@ -290,29 +292,30 @@ LockFileManager::~LockFileManager() {
   sys::DontRemoveFileOnSignal(UniqueLockFileName);
 }
 
-LockFileManager::WaitForUnlockResult LockFileManager::waitForUnlock() {
+LockFileManager::WaitForUnlockResult
+LockFileManager::waitForUnlock(const unsigned MaxSeconds) {
   if (getState() != LFS_Shared)
     return Res_Success;
 
-#ifdef _WIN32
-  unsigned long Interval = 1;
-#else
-  struct timespec Interval;
-  Interval.tv_sec = 0;
-  Interval.tv_nsec = 1000000;
-#endif
-  // Don't wait more than 40s per iteration. Total timeout for the file
-  // to appear is ~1.5 minutes.
-  const unsigned MaxSeconds = 40;
+  // Start with a short interval, as most locks are held briefly, and double
+  // it up to a cap: an exponential backoff without a cap makes the waiters of
+  // a long build of the locked file sleep up to twice as long as the build.
+  const std::chrono::milliseconds MaxInterval(100);
+  std::chrono::milliseconds Interval(1);
+  const auto Deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(MaxSeconds);
   do {
     // Sleep for the designated interval, to allow the owning process time to
     // finish up and remove the lock file.
     // FIXME: Should we hook in to system APIs to get a notification when the
     // lock file is deleted?
 #ifdef _WIN32
-    Sleep(Interval);
+    Sleep(static_cast<DWORD>(Interval.count()));
 #else
-    nanosleep(&Interval, nullptr);
+    struct timespec Duration;
+    Duration.tv_sec = Interval.count() / 1000;
+    Duration.tv_nsec = (Interval.count() % 1000) * 1000000;
+    nanosleep(&Duration, nullptr);
 #endif
 
     if (sys::fs::access(LockFileName.c_str(), sys::fs::AccessMode::Exist) ==
@@ -327,24 +330,8 @@ LockFileManager::WaitForUnlockResult LockFileManager::waitForUnlock() {
     if (!processStillExecuting((*Owner).first, (*Owner).second))
       return Res_OwnerDied;
 
-    // Exponentially increase the time we wait for the lock to be removed.
-#ifdef _WIN32
-    Interval *= 2;
-#else
-    Interval.tv_sec *= 2;
-    Interval.tv_nsec *= 2;
-    if (Interval.tv_nsec >= 1000000000) {
-      ++Interval.tv_sec;
-      Interval.tv_nsec -= 1000000000;
-    }
-#endif
-  } while (
-#ifdef _WIN32
-           Interval < MaxSeconds * 1000
-#else
-           Interval.tv_sec < (time_t)MaxSeconds
-#endif
-           );
+    Interval = std::min(Interval * 2, MaxInterval);
+  } while (std::chrono::steady_clock::now() < Deadline);
 
   // Give up.
   return Res_Timeout;
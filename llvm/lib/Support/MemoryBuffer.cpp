@@ -21,6 +21,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include <cassert>
 #include <cerrno>
 #include <cstring>
@@ -232,6 +233,39 @@ MemoryBuffer::getFile(const Twine &Filename, int64_t FileSize,
                                   RequiresNullTerminator, IsVolatile);
 }
 
+std::vector<std::future<ErrorOr<std::unique_ptr<MemoryBuffer>>>>
+MemoryBuffer::getFilesAsync(ThreadPool &Pool, ArrayRef<std::string> Filenames,
+                            bool RequiresNullTerminator, bool IsVolatile) {
+  using ResultTy = ErrorOr<std::unique_ptr<MemoryBuffer>>;
+  std::vector<std::future<ResultTy>> Futures;
+  Futures.reserve(Filenames.size());
+  for (const std::string &Filename : Filenames) {
+    auto Task = std::make_shared<std::packaged_task<ResultTy()>>(
+        [=]() -> ResultTy {
+          ResultTy MB = getFile(Filename, -1, RequiresNullTerminator,
+                                IsVolatile);
+          if (!MB || (*MB)->getBufferKind() != MemoryBuffer_MMap)
+            return MB;
+          // Touch every page of a mapped file so that it is read now, on
+          // this thread, rather than by the first access of the caller.
+          size_t PageSize = sys::Process::getPageSizeEstimate();
+          const volatile char *Data = (*MB)->getBufferStart();
+          for (size_t I = 0, E = (*MB)->getBufferSize(); I < E; I += PageSize)
+            (void)Data[I];
+          return MB;
+        });
+    Futures.push_back(Task->get_future());
+#if LLVM_ENABLE_THREADS
+    Pool.async([Task] { (*Task)(); });
+#else
+    // Tasks only run when the pool is waited on, so run them now instead
+    // of blocking forever in the caller's future.
+    (*Task)();
+#endif
+  }
+  return Futures;
+}
+
 template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getOpenFileImpl(sys::fs::file_t FD, const Twine &Filename, uint64_t FileSize,
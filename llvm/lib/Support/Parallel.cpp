@@ -11,11 +11,13 @@
 
 #if LLVM_ENABLE_THREADS
 
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/Threading.h"
 
 #include <atomic>
-#include <stack>
+#include <deque>
 #include <thread>
+#include <vector>
 
 namespace llvm {
 namespace parallel {
@@ -29,6 +31,11 @@ public:
   virtual ~Executor() = default;
   virtual void add(std::function<void()> func) = 0;
 
+  /// Runs one queued task on the calling thread, if there is one. Returns
+  /// false if no task was run, and always returns false for executors that
+  /// can't run tasks on arbitrary threads.
+  virtual bool runTask() { return false; }
+
   static Executor *getDefaultExecutor();
 };
 
@@ -60,19 +67,27 @@ Executor *Executor::getDefaultExecutor() {
 }
 
 #else
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a thread pool with
+/// work stealing.
+///
+/// Each worker thread has its own queue. Tasks added by a worker go to the
+/// back of its queue and the worker takes them from the back, in filo order,
+/// which keeps the data of nested tasks in cache. Tasks added by other
+/// threads go to a shared queue. A worker whose queue is empty takes tasks
+/// from the shared queue and then steals from the front of the queues of
+/// other workers, so workers only contend for a lock when they run out of
+/// work of their own.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(unsigned ThreadCount = hardware_concurrency())
-      : Done(ThreadCount) {
+      : Queues(ThreadCount), Done(ThreadCount) {
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     std::thread([&, ThreadCount] {
-      for (size_t i = 1; i < ThreadCount; ++i) {
-        std::thread([=] { work(); }).detach();
+      for (unsigned I = 1; I < ThreadCount; ++I) {
+        std::thread([=] { work(I); }).detach();
       }
-      work();
+      work(0);
     }).detach();
   }
 
@@ -85,34 +100,98 @@ public:
   }
 
   void add(std::function<void()> F) override {
-    std::unique_lock<std::mutex> Lock(Mutex);
-    WorkStack.push(F);
-    Lock.unlock();
+    WorkQueue &Q = CurrentExecutor == this ? Queues[CurrentWorker] : Shared;
+    {
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      Q.Tasks.push_back(std::move(F));
+    }
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      ++NumQueued;
+    }
     Cond.notify_one();
   }
 
+  bool runTask() override {
+    std::function<void()> Task;
+    if (!takeTask(CurrentExecutor == this ? CurrentWorker : Queues.size(),
+                  Task))
+      return false;
+    Task();
+    return true;
+  }
+
 private:
-  void work() {
+  struct WorkQueue {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Tasks;
+  };
+
+  static bool popBack(WorkQueue &Q, std::function<void()> &Task) {
+    std::lock_guard<std::mutex> Lock(Q.Mutex);
+    if (Q.Tasks.empty())
+      return false;
+    Task = std::move(Q.Tasks.back());
+    Q.Tasks.pop_back();
+    return true;
+  }
+
+  static bool popFront(WorkQueue &Q, std::function<void()> &Task) {
+    std::lock_guard<std::mutex> Lock(Q.Mutex);
+    if (Q.Tasks.empty())
+      return false;
+    Task = std::move(Q.Tasks.front());
+    Q.Tasks.pop_front();
+    return true;
+  }
+
+  // Takes a task for worker Self, which is Queues.size() for threads that
+  // aren't workers of this executor.
+  bool takeTask(size_t Self, std::function<void()> &Task) {
+    size_t N = Queues.size();
+    bool Found = (Self < N && popBack(Queues[Self], Task)) ||
+                 popFront(Shared, Task);
+    for (size_t I = 1; !Found && I <= N; ++I)
+      Found = popFront(Queues[(Self + I) % N], Task);
+    if (Found)
+      --NumQueued;
+    return Found;
+  }
+
+  void work(unsigned Self) {
+    CurrentExecutor = this;
+    CurrentWorker = Self;
     while (true) {
+      std::function<void()> Task;
+      if (takeTask(Self, Task)) {
+        Task();
+        continue;
+      }
       std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
+      Cond.wait(Lock, [&] { return Stop || NumQueued > 0; });
       if (Stop)
         break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
-      Lock.unlock();
-      Task();
     }
     Done.dec();
   }
 
+  static LLVM_THREAD_LOCAL ThreadPoolExecutor *CurrentExecutor;
+  static LLVM_THREAD_LOCAL unsigned CurrentWorker;
+
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
+  std::vector<WorkQueue> Queues;
+  WorkQueue Shared;
+  // The number of tasks in all queues. It is incremented after a task is
+  // queued, so it may briefly be negative.
+  std::atomic<int64_t> NumQueued{0};
   std::mutex Mutex;
   std::condition_variable Cond;
   parallel::detail::Latch Done;
 };
 
+LLVM_THREAD_LOCAL ThreadPoolExecutor *ThreadPoolExecutor::CurrentExecutor;
+LLVM_THREAD_LOCAL unsigned ThreadPoolExecutor::CurrentWorker;
+
 Executor *Executor::getDefaultExecutor() {
   static ThreadPoolExecutor exec;
   return &exec;
@@ -122,12 +201,23 @@ Executor *Executor::getDefaultExecutor() {
 
 static std::atomic<int> TaskGroupInstances;
 
+#if defined(_MSC_VER)
 // Latch::sync() called by the dtor may cause one thread to block. If is a dead
 // lock if all threads in the default executor are blocked. To prevent the dead
 // lock, only allow the first TaskGroup to run tasks parallelly. In the scenario
 // of nested parallel_for_each(), only the outermost one runs parallelly.
 TaskGroup::TaskGroup() : Parallel(TaskGroupInstances++ == 0) {}
-TaskGroup::~TaskGroup() { --TaskGroupInstances; }
+#else
+// Threads waiting for a TaskGroup run other queued tasks, so blocking in
+// sync() can't starve the thread pool, and nested TaskGroups run in parallel
+// too.
+TaskGroup::TaskGroup() : Parallel(true) { ++TaskGroupInstances; }
+#endif
+
+TaskGroup::~TaskGroup() {
+  sync();
+  --TaskGroupInstances;
+}
 
 void TaskGroup::spawn(std::function<void()> F) {
   if (Parallel) {
@@ -141,6 +231,17 @@ void TaskGroup::spawn(std::function<void()> F) {
   }
 }
 
+void TaskGroup::sync() const {
+  // Help run queued tasks until ours are done. If there are no queued tasks,
+  // the remaining tasks of this group are running on other threads.
+  Executor *E = Executor::getDefaultExecutor();
+  while (!L.isDone())
+    if (!E->runTask()) {
+      L.sync();
+      break;
+    }
+}
+
 } // namespace detail
 } // namespace parallel
 } // namespace llvm
@@ -21,11 +21,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/Timer.h"
@@ -33,6 +35,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cstring>
+#include <map>
 using namespace llvm;
 
 /// -stats - Command line option to cause transformations to emit stats about
@@ -50,6 +53,21 @@ static cl::opt<bool> StatsAsJSON("stats-json",
 static bool Enabled;
 static bool PrintOnExit;
 
+std::atomic<unsigned> llvm::NumActiveStatisticScopes;
+
+struct StatisticScope::Counters {
+  DenseMap<const Statistic *, int64_t> Values;
+};
+
+namespace {
+/// The updates made in a StatisticScope that has ended.
+struct ScopeRecord {
+  std::string Name;
+  unsigned Thread;
+  std::vector<std::pair<const Statistic *, int64_t>> Values;
+};
+} // end anonymous namespace
+
 namespace {
 /// This class is used in a ManagedStatic so that it is created on demand (when
 /// the first statistic is bumped) and destroyed only when llvm_shutdown is
@@ -58,7 +76,9 @@ namespace {
 /// use LLVM.
 class StatisticInfo {
   std::vector<Statistic*> Stats;
+  std::vector<ScopeRecord> Scopes;
 
+  friend class llvm::StatisticScope;
   friend void llvm::PrintStatistics();
   friend void llvm::PrintStatistics(raw_ostream &OS);
   friend void llvm::PrintStatisticsJSON(raw_ostream &OS);
@@ -134,6 +154,38 @@ bool llvm::AreStatisticsEnabled() {
   return Enabled || Stats;
 }
 
+static LLVM_THREAD_LOCAL StatisticScope *CurrentScope = nullptr;
+static LLVM_THREAD_LOCAL unsigned CurrentThread = 0;
+static std::atomic<unsigned> NumThreads;
+
+StatisticScope::StatisticScope(StringRef Name)
+    : Name(Name), Parent(CurrentScope), Updates(new Counters) {
+  if (!CurrentThread)
+    CurrentThread = ++NumThreads;
+  CurrentScope = this;
+  ++NumActiveStatisticScopes;
+}
+
+StatisticScope::~StatisticScope() {
+  assert(CurrentScope == this && "Statistic scopes must nest");
+  CurrentScope = Parent;
+  --NumActiveStatisticScopes;
+
+  ScopeRecord R{std::move(Name), CurrentThread, {}};
+  R.Values.assign(Updates->Values.begin(), Updates->Values.end());
+  sys::SmartMutex<true> &Lock = *StatLock;
+  StatisticInfo &SI = *StatInfo;
+  sys::SmartScopedLock<true> Writer(Lock);
+  SI.Scopes.push_back(std::move(R));
+}
+
+#if LLVM_ENABLE_STATS
+void Statistic::noteScopedUpdate(int64_t Delta) {
+  if (CurrentScope)
+    CurrentScope->Updates->Values[this] += Delta;
+}
+#endif
+
 void StatisticInfo::sort() {
   llvm::stable_sort(Stats, [](const Statistic *LHS, const Statistic *RHS) {
     if (int Cmp = std::strcmp(LHS->getDebugType(), RHS->getDebugType()))
@@ -166,6 +218,7 @@ void StatisticInfo::reset() {
   // but it's their responsibility to prevent concurrent compilations to make
   // a single compilation measurable.
   Stats.clear();
+  Scopes.clear();
 }
 
 void llvm::PrintStatistics(raw_ostream &OS) {
@@ -217,6 +270,53 @@ void llvm::PrintStatisticsJSON(raw_ostream &OS) {
        << Stat->getValue();
     delim = ",\n";
   }
+
+  // Print the updates of each StatisticScope and their sums per thread.
+  if (!Stats.Scopes.empty()) {
+    auto PrintValues = [&](ArrayRef<std::pair<const Statistic *, int64_t>> V) {
+      std::vector<std::pair<const Statistic *, int64_t>> Sorted(V.begin(),
+                                                                V.end());
+      llvm::sort(Sorted, [](const std::pair<const Statistic *, int64_t> &A,
+                            const std::pair<const Statistic *, int64_t> &B) {
+        if (int Cmp = std::strcmp(A.first->getDebugType(),
+                                  B.first->getDebugType()))
+          return Cmp < 0;
+        return std::strcmp(A.first->getName(), B.first->getName()) < 0;
+      });
+      OS << "{";
+      const char *D = "";
+      for (const auto &E : Sorted) {
+        OS << D << "\"" << E.first->getDebugType() << '.' << E.first->getName()
+           << "\": " << E.second;
+        D = ", ";
+      }
+      OS << "}";
+    };
+
+    std::map<unsigned, DenseMap<const Statistic *, int64_t>> Threads;
+    OS << delim << "\t\"scopes\": [";
+    delim = "\n";
+    for (const ScopeRecord &R : Stats.Scopes) {
+      OS << delim << "\t\t{\"name\": " << json::Value(R.Name)
+         << ", \"thread\": " << R.Thread << ", \"stats\": ";
+      PrintValues(R.Values);
+      OS << "}";
+      delim = ",\n";
+      for (const auto &E : R.Values)
+        Threads[R.Thread][E.first] += E.second;
+    }
+    OS << "\n\t],\n\t\"threads\": {";
+    delim = "\n";
+    for (const auto &T : Threads) {
+      OS << delim << "\t\t\"" << T.first << "\": ";
+      std::vector<std::pair<const Statistic *, int64_t>> V(T.second.begin(),
+                                                           T.second.end());
+      PrintValues(V);
+      delim = ",\n";
+    }
+    OS << "\n\t}";
+    delim = ",\n";
+  }
   // Print timers.
   TimerGroup::printAllJSONValues(OS, delim);
 
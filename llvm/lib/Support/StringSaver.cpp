@@ -7,6 +7,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/StringSaver.h"
+#include "llvm/Support/xxhash.h"
+#include <cassert>
+#include <vector>
 
 using namespace llvm;
 
@@ -24,3 +27,47 @@ StringRef UniqueStringSaver::save(StringRef S) {
     *R.first = Strings.save(S); // safe replacement with equal value
   return *R.first;
 }
+
+ConcurrentUniqueStringSaver::ConcurrentUniqueStringSaver(unsigned NumShards)
+    : NumShards(NumShards), Shards(new Shard[NumShards]) {
+  assert(NumShards > 0 && "need at least one shard");
+}
+
+// The shard is selected by a different hash than the one DenseSet uses, so
+// that strings in the same shard are still spread over the buckets of its
+// set.
+unsigned ConcurrentUniqueStringSaver::getShardIndex(StringRef S) const {
+  return xxHash64(S) % NumShards;
+}
+
+StringRef ConcurrentUniqueStringSaver::save(StringRef S) {
+  Shard &Sh = Shards[getShardIndex(S)];
+  std::lock_guard<std::mutex> Lock(Sh.Mutex);
+  return Sh.Saver.save(S);
+}
+
+void ConcurrentUniqueStringSaver::save(MutableArrayRef<StringRef> Strings) {
+  // Group the strings by shard with a counting sort.
+  std::vector<unsigned> ShardIndices(Strings.size());
+  std::vector<size_t> ShardStarts(NumShards + 1);
+  for (size_t I = 0, E = Strings.size(); I != E; ++I) {
+    ShardIndices[I] = getShardIndex(Strings[I]);
+    ++ShardStarts[ShardIndices[I] + 1];
+  }
+  for (unsigned I = 0; I != NumShards; ++I)
+    ShardStarts[I + 1] += ShardStarts[I];
+
+  std::vector<size_t> Order(Strings.size());
+  std::vector<size_t> Cursors(ShardStarts.begin(), ShardStarts.end() - 1);
+  for (size_t I = 0, E = Strings.size(); I != E; ++I)
+    Order[Cursors[ShardIndices[I]]++] = I;
+
+  for (unsigned I = 0; I != NumShards; ++I) {
+    if (ShardStarts[I] == ShardStarts[I + 1])
+      continue;
+    Shard &Sh = Shards[I];
+    std::lock_guard<std::mutex> Lock(Sh.Mutex);
+    for (size_t J = ShardStarts[I]; J != ShardStarts[I + 1]; ++J)
+      Strings[Order[J]] = Sh.Saver.save(Strings[Order[J]]);
+  }
+}
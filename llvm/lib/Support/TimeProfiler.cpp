@@ -15,9 +15,14 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/MathExtras.h"
+#include <array>
 #include <cassert>
 #include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std::chrono;
@@ -43,17 +48,153 @@ struct Entry {
         Detail(std::move(Dt)){};
 };
 
+// The durations of all sections with the same name, for summary mode.
+struct ScopeSummary {
+  size_t Count = 0;
+  // Like CountAndTotalPerName, this only includes topmost sections.
+  DurationType Total{};
+  DurationType Max{};
+  // Buckets[0] counts sections shorter than a microsecond, and Buckets[I]
+  // counts sections of [2^(I-1), 2^I) microseconds.
+  std::array<size_t, 64> Buckets{};
+
+  void add(DurationType D, bool Topmost) {
+    ++Count;
+    if (Topmost)
+      Total += D;
+    Max = std::max(Max, D);
+    uint64_t Us = duration_cast<microseconds>(D).count();
+    ++Buckets[Us ? Log2_64(Us) + 1 : 0];
+  }
+
+  void merge(const ScopeSummary &Other) {
+    Count += Other.Count;
+    Total += Other.Total;
+    Max = std::max(Max, Other.Max);
+    for (size_t I = 0; I < Buckets.size(); ++I)
+      Buckets[I] += Other.Buckets[I];
+  }
+
+  // Returns an upper bound of the given quantile in microseconds.
+  uint64_t quantile(double Q) const {
+    uint64_t MaxUs = duration_cast<microseconds>(Max).count();
+    size_t Seen = 0;
+    for (size_t I = 0; I < Buckets.size(); ++I) {
+      Seen += Buckets[I];
+      if (Seen >= Q * Count)
+        return std::min(uint64_t(1) << I, MaxUs);
+    }
+    return MaxUs;
+  }
+};
+
+// The open sections and finished summaries of one thread.
+struct ThreadSummary {
+  SmallVector<std::pair<time_point<steady_clock>, std::string>, 16> Stack;
+  StringMap<ScopeSummary> Scopes;
+};
+
+// Identifies the current profiler so that threads can tell whether their
+// ThreadSummary belongs to it.
+static unsigned ProfilerGeneration = 0;
+static LLVM_THREAD_LOCAL ThreadSummary *CurrentThreadSummary = nullptr;
+static LLVM_THREAD_LOCAL unsigned CurrentThreadGeneration = 0;
+
 struct TimeTraceProfiler {
-  TimeTraceProfiler() {
-    StartTime = steady_clock::now();
+  TimeTraceProfiler(unsigned TimeTraceGranularity, StringRef ProcName,
+                    bool Summary = false)
+      : StartTime(steady_clock::now()), ProcName(ProcName),
+        Tid(std::this_thread::get_id()),
+        TimeTraceGranularity(TimeTraceGranularity), Summary(Summary),
+        Generation(++ProfilerGeneration) {}
+
+  ThreadSummary &getThreadSummary() {
+    if (CurrentThreadGeneration != Generation) {
+      std::lock_guard<std::mutex> Lock(SummariesLock);
+      Summaries.push_back(std::make_unique<ThreadSummary>());
+      CurrentThreadSummary = Summaries.back().get();
+      CurrentThreadGeneration = Generation;
+    }
+    return *CurrentThreadSummary;
+  }
+
+  void beginSummary(std::string Name) {
+    getThreadSummary().Stack.emplace_back(steady_clock::now(),
+                                          std::move(Name));
+  }
+
+  void endSummary() {
+    ThreadSummary &T = getThreadSummary();
+    assert(!T.Stack.empty() && "Must call begin() first");
+    auto &E = T.Stack.back();
+    DurationType D = steady_clock::now() - E.first;
+    bool Topmost = std::find_if(++T.Stack.rbegin(), T.Stack.rend(),
+                                [&](const std::pair<time_point<steady_clock>,
+                                                    std::string> &Val) {
+                                  return Val.second == E.second;
+                                }) == T.Stack.rend();
+    T.Scopes[E.second].add(D, Topmost);
+    T.Stack.pop_back();
+  }
+
+  void writeSummary(raw_pwrite_stream &OS) {
+    StringMap<ScopeSummary> Scopes;
+    {
+      std::lock_guard<std::mutex> Lock(SummariesLock);
+      for (const std::unique_ptr<ThreadSummary> &T : Summaries)
+        for (const auto &E : T->Scopes)
+          Scopes[E.getKey()].merge(E.getValue());
+    }
+
+    std::vector<const StringMapEntry<ScopeSummary> *> Sorted;
+    Sorted.reserve(Scopes.size());
+    for (const auto &E : Scopes)
+      Sorted.push_back(&E);
+    llvm::sort(Sorted, [](const StringMapEntry<ScopeSummary> *A,
+                          const StringMapEntry<ScopeSummary> *B) {
+      if (A->getValue().Total != B->getValue().Total)
+        return A->getValue().Total > B->getValue().Total;
+      return A->getKey() < B->getKey();
+    });
+
+    json::OStream J(OS);
+    J.object([&] {
+      J.attribute("processName", ProcName);
+      J.attributeArray("scopes", [&] {
+        for (const StringMapEntry<ScopeSummary> *E : Sorted) {
+          const ScopeSummary &S = E->getValue();
+          J.object([&] {
+            J.attribute("name", E->getKey());
+            J.attribute("count", int64_t(S.Count));
+            J.attribute("total us",
+                        int64_t(duration_cast<microseconds>(S.Total).count()));
+            J.attribute("p50 us", int64_t(S.quantile(0.5)));
+            J.attribute("p99 us", int64_t(S.quantile(0.99)));
+            J.attribute("max us",
+                        int64_t(duration_cast<microseconds>(S.Max).count()));
+          });
+        }
+      });
+    });
   }
 
   void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
+    if (Summary)
+      return beginSummary(std::move(Name));
+    // The profiler is not thread-safe, so sections on other threads, e.g.
+    // worker threads of a parallel loop, are ignored. They are accounted
+    // for by the enclosing section on the main thread.
+    if (std::this_thread::get_id() != Tid)
+      return;
     Stack.emplace_back(steady_clock::now(), DurationType{}, std::move(Name),
                        Detail());
   }
 
   void end() {
+    if (Summary)
+      return endSummary();
+    if (std::this_thread::get_id() != Tid)
+      return;
     assert(!Stack.empty() && "Must call begin() first");
     auto &E = Stack.back();
     E.Duration = steady_clock::now() - E.Start;
@@ -79,6 +220,8 @@ struct TimeTraceProfiler {
   }
 
   void Write(raw_pwrite_stream &OS) {
+    if (Summary)
+      return writeSummary(OS);
     assert(Stack.empty() &&
            "All profiler sections should be ended when calling Write");
     json::OStream J(OS);
@@ -143,7 +286,7 @@ struct TimeTraceProfiler {
       J.attribute("ts", 0);
       J.attribute("ph", "M");
       J.attribute("name", "process_name");
-      J.attributeObject("args", [&] { J.attribute("name", "clang"); });
+      J.attributeObject("args", [&] { J.attribute("name", ProcName); });
     });
 
     J.arrayEnd();
@@ -155,16 +298,35 @@ struct TimeTraceProfiler {
   SmallVector<Entry, 128> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
   time_point<steady_clock> StartTime;
+  std::string ProcName;
+
+  // The thread that sections are recorded for.
+  std::thread::id Tid;
 
   // Minimum time granularity (in microseconds)
   unsigned TimeTraceGranularity;
+
+  // Whether to record summaries instead of events.
+  bool Summary;
+  unsigned Generation;
+  std::mutex SummariesLock;
+  std::vector<std::unique_ptr<ThreadSummary>> Summaries;
 };
 
-void timeTraceProfilerInitialize(unsigned TimeTraceGranularity) {
+void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
+                                 StringRef ProcName) {
+  assert(TimeTraceProfilerInstance == nullptr &&
+         "Profiler should not be initialized");
+  TimeTraceProfilerInstance =
+      new TimeTraceProfiler(TimeTraceGranularity, ProcName);
+}
+
+void timeTraceProfilerInitializeSummary(StringRef ProcName) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
-  TimeTraceProfilerInstance = new TimeTraceProfiler();
-  TimeTraceProfilerInstance->TimeTraceGranularity = TimeTraceGranularity;
+  TimeTraceProfilerInstance =
+      new TimeTraceProfiler(/*TimeTraceGranularity=*/0, ProcName,
+                            /*Summary=*/true);
 }
 
 void timeTraceProfilerCleanup() {
@@ -520,6 +520,230 @@ directory_iterator OverlayFileSystem::dir_begin(const Twine &Dir,
 
 void ProxyFileSystem::anchor() {}
 
+//===-----------------------------------------------------------------------===/
+// CachingFileSystem implementation
+//===-----------------------------------------------------------------------===/
+
+struct CachingFileSystemCache::Entry {
+  Optional<ErrorOr<Status>> Stat;
+  /// The contents of a small regular file, if it has been read.
+  std::shared_ptr<MemoryBuffer> Contents;
+  /// The names and types of the entries of a directory, if it has been
+  /// listed successfully.
+  Optional<std::vector<std::pair<std::string, sys::fs::file_type>>> Listing;
+};
+
+struct CachingFileSystemCache::Shard {
+  std::mutex Lock;
+  StringMap<Entry> Entries;
+};
+
+static constexpr unsigned NumCacheShards = 64;
+
+CachingFileSystemCache::CachingFileSystemCache(uint64_t MaxFileSize)
+    : Shards(new Shard[NumCacheShards]), MaxFileSize(MaxFileSize) {}
+
+CachingFileSystemCache::~CachingFileSystemCache() = default;
+
+void CachingFileSystemCache::withEntry(StringRef Path,
+                                       function_ref<void(Entry &)> F) {
+  Shard &S = Shards[hash_value(Path) % NumCacheShards];
+  std::lock_guard<std::mutex> Lock(S.Lock);
+  F(S.Entries[Path]);
+}
+
+void CachingFileSystemCache::invalidate(StringRef Path) {
+  for (StringRef P : {Path, sys::path::parent_path(Path)}) {
+    if (P.empty())
+      continue;
+    Shard &S = Shards[hash_value(P) % NumCacheShards];
+    std::lock_guard<std::mutex> Lock(S.Lock);
+    if (P == Path)
+      S.Entries.erase(P);
+    else if (S.Entries.count(P))
+      S.Entries[P].Listing.reset();
+  }
+}
+
+void CachingFileSystemCache::invalidateAll() {
+  for (unsigned I = 0; I != NumCacheShards; ++I) {
+    std::lock_guard<std::mutex> Lock(Shards[I].Lock);
+    Shards[I].Entries.clear();
+  }
+}
+
+namespace {
+
+/// A MemoryBuffer that shares the contents of a cached file.
+class SharedMemoryBuffer : public MemoryBuffer {
+  std::shared_ptr<MemoryBuffer> Contents;
+  std::string Name;
+
+public:
+  SharedMemoryBuffer(std::shared_ptr<MemoryBuffer> Contents,
+                     const Twine &Name)
+      : Contents(std::move(Contents)), Name(Name.str()) {
+    init(this->Contents->getBufferStart(), this->Contents->getBufferEnd(),
+         /*RequiresNullTerminator=*/true);
+  }
+
+  StringRef getBufferIdentifier() const override { return Name; }
+  BufferKind getBufferKind() const override {
+    return Contents->getBufferKind();
+  }
+};
+
+/// A file whose status and contents come from a CachingFileSystemCache.
+class CachedFile : public File {
+  Status S;
+  std::shared_ptr<MemoryBuffer> Contents;
+
+public:
+  CachedFile(Status S, std::shared_ptr<MemoryBuffer> Contents)
+      : S(std::move(S)), Contents(std::move(Contents)) {}
+
+  ErrorOr<Status> status() override { return S; }
+  ErrorOr<std::unique_ptr<MemoryBuffer>>
+  getBuffer(const Twine &Name, int64_t FileSize, bool RequiresNullTerminator,
+            bool IsVolatile) override {
+    return std::make_unique<SharedMemoryBuffer>(Contents, Name);
+  }
+  std::error_code close() override { return {}; }
+};
+
+/// Iterates over a cached directory listing.
+class CachedDirIterImpl : public llvm::vfs::detail::DirIterImpl {
+  std::string Dir;
+  std::vector<std::pair<std::string, sys::fs::file_type>> Listing;
+  size_t Next = 0;
+
+public:
+  CachedDirIterImpl(
+      const Twine &Dir,
+      std::vector<std::pair<std::string, sys::fs::file_type>> Listing)
+      : Dir(Dir.str()), Listing(std::move(Listing)) {
+    increment();
+  }
+
+  std::error_code increment() override {
+    if (Next == Listing.size()) {
+      CurrentEntry = directory_entry();
+      return {};
+    }
+    SmallString<256> Path(Dir);
+    sys::path::append(Path, Listing[Next].first);
+    CurrentEntry = directory_entry(Path.str(), Listing[Next].second);
+    ++Next;
+    return {};
+  }
+};
+
+} // namespace
+
+CachingFileSystem::CachingFileSystem(
+    IntrusiveRefCntPtr<FileSystem> FS,
+    IntrusiveRefCntPtr<CachingFileSystemCache> Cache)
+    : ProxyFileSystem(std::move(FS)), Cache(std::move(Cache)) {}
+
+ErrorOr<Status> CachingFileSystem::status(const Twine &Path) {
+  SmallString<256> AbsPath;
+  Path.toVector(AbsPath);
+  if (makeAbsolute(AbsPath))
+    return getUnderlyingFS().status(Path);
+
+  Optional<ErrorOr<Status>> Cached;
+  Cache->withEntry(AbsPath, [&](CachingFileSystemCache::Entry &E) {
+    Cached = E.Stat;
+  });
+  if (!Cached) {
+    Cached = getUnderlyingFS().status(AbsPath);
+    Cache->withEntry(AbsPath, [&](CachingFileSystemCache::Entry &E) {
+      E.Stat = *Cached;
+    });
+  }
+  if (!*Cached)
+    return Cached->getError();
+  return Status::copyWithNewName(**Cached, Path);
+}
+
+ErrorOr<std::unique_ptr<File>>
+CachingFileSystem::openFileForRead(const Twine &Path) {
+  SmallString<256> AbsPath;
+  Path.toVector(AbsPath);
+  if (makeAbsolute(AbsPath))
+    return getUnderlyingFS().openFileForRead(Path);
+
+  Optional<ErrorOr<Status>> CachedStat;
+  std::shared_ptr<MemoryBuffer> Contents;
+  Cache->withEntry(AbsPath, [&](CachingFileSystemCache::Entry &E) {
+    CachedStat = E.Stat;
+    Contents = E.Contents;
+  });
+  if (CachedStat && !*CachedStat)
+    return CachedStat->getError();
+  if (Contents)
+    return std::make_unique<CachedFile>(
+        Status::copyWithNewName(**CachedStat, Path), std::move(Contents));
+
+  ErrorOr<std::unique_ptr<File>> F = getUnderlyingFS().openFileForRead(Path);
+  if (!F)
+    return F;
+  ErrorOr<Status> S = (*F)->status();
+  if (!S)
+    return F;
+
+  // Read small files now so that later opens don't need the underlying file
+  // system at all.
+  if (S->isRegularFile() && S->getSize() <= Cache->MaxFileSize) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
+        (*F)->getBuffer(AbsPath, S->getSize());
+    if (MB) {
+      Contents = std::move(*MB);
+      Cache->withEntry(AbsPath, [&](CachingFileSystemCache::Entry &E) {
+        E.Stat = *S;
+        E.Contents = Contents;
+      });
+      return std::make_unique<CachedFile>(Status::copyWithNewName(*S, Path),
+                                          std::move(Contents));
+    }
+  }
+
+  Cache->withEntry(AbsPath,
+                   [&](CachingFileSystemCache::Entry &E) { E.Stat = *S; });
+  return F;
+}
+
+directory_iterator CachingFileSystem::dir_begin(const Twine &Dir,
+                                                std::error_code &EC) {
+  SmallString<256> AbsPath;
+  Dir.toVector(AbsPath);
+  if (makeAbsolute(AbsPath))
+    return getUnderlyingFS().dir_begin(Dir, EC);
+
+  Optional<std::vector<std::pair<std::string, sys::fs::file_type>>> Listing;
+  Cache->withEntry(AbsPath, [&](CachingFileSystemCache::Entry &E) {
+    Listing = E.Listing;
+  });
+
+  if (!Listing) {
+    // Read the whole directory. Errors are not cached, so a directory that
+    // fails to list is listed again next time.
+    Listing.emplace();
+    directory_iterator I = getUnderlyingFS().dir_begin(AbsPath, EC), End;
+    for (; !EC && I != End; I.increment(EC))
+      Listing->emplace_back(sys::path::filename(I->path()), I->type());
+    if (EC)
+      return getUnderlyingFS().dir_begin(Dir, EC);
+    Cache->withEntry(AbsPath, [&](CachingFileSystemCache::Entry &E) {
+      E.Listing = *Listing;
+    });
+  }
+
+  EC = std::error_code();
+  return directory_iterator(
+      std::make_shared<CachedDirIterImpl>(Dir, std::move(*Listing)));
+}
+
 namespace llvm {
 namespace vfs {
 
@@ -49,6 +49,12 @@ static cl::list<std::string>
 MacroNames("D", cl::desc("Name of the macro to be defined"),
             cl::value_desc("macro name"), cl::Prefix);
 
+static cl::list<std::string>
+ExtraOutputs("extra-output",
+             cl::desc("Also perform <action> on the parsed records and write "
+                      "its output to <file>"),
+             cl::value_desc("action=file"), cl::ZeroOrMore);
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
@@ -68,7 +74,10 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   if (EC)
     return reportError(argv0, "error opening " + DependFilename + ":" +
                                   EC.message() + "\n");
-  DepOut.os() << OutputFilename << ":";
+  DepOut.os() << OutputFilename;
+  for (StringRef Output : ExtraOutputs)
+    DepOut.os() << ' ' << Output.split('=').second;
+  DepOut.os() << ":";
   for (const auto &Dep : Parser.getDependencies()) {
     DepOut.os() << ' ' << Dep.first;
   }
@@ -77,7 +86,70 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
-int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
+/// Write Contents to Filename.
+///
+/// The file is only updated if there are any differences. This prevents
+/// recompilation of all the files depending on it if there aren't any.
+static int writeOutputFile(const char *argv0, StringRef Filename,
+                           StringRef Contents) {
+  if (auto ExistingOrErr = MemoryBuffer::getFile(Filename))
+    if (std::move(ExistingOrErr.get())->getBuffer() == Contents)
+      return 0;
+
+  std::error_code EC;
+  ToolOutputFile OutFile(Filename, EC, sys::fs::OF_Text);
+  if (EC)
+    return reportError(argv0, "error opening " + Filename + ":" +
+                                  EC.message() + "\n");
+  OutFile.os() << Contents;
+
+  if (ErrorsPrinted > 0)
+    return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
+
+  // Declare success.
+  OutFile.keep();
+  return 0;
+}
+
+/// Perform each action given with -extra-output on Records and store the
+/// output in Outputs.
+///
+/// SelectActionFn selects each action in turn through the tool's own option
+/// for it. They run one after the other: the records are only parsed once,
+/// but the backends are not thread-safe, since all of them share the uniqued
+/// Init pools.
+static int
+performExtraActions(const char *argv0, TableGenMainFn *MainFn,
+                    TableGenSelectActionFn *SelectActionFn,
+                    RecordKeeper &Records,
+                    std::vector<std::pair<std::string, std::string>> &Outputs) {
+  if (ExtraOutputs.empty())
+    return 0;
+  if (!SelectActionFn)
+    return reportError(argv0, "-extra-output is not supported by this tool\n");
+
+  for (StringRef Output : ExtraOutputs) {
+    StringRef Action, Filename;
+    std::tie(Action, Filename) = Output.split('=');
+    Action = Action.ltrim('-');
+    if (Action.empty() || Filename.empty())
+      return reportError(argv0, "invalid -extra-output '" + Output +
+                                    "', expected <action>=<file>\n");
+
+    if (SelectActionFn(Action))
+      return reportError(argv0, "unknown action '" + Action + "'\n");
+
+    std::string OutString;
+    raw_string_ostream Out(OutString);
+    if (MainFn(Out, Records))
+      return 1;
+    Outputs.emplace_back(Filename, std::move(Out.str()));
+  }
+  return 0;
+}
+
+int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn,
+                       TableGenSelectActionFn *SelectActionFn) {
   RecordKeeper Records;
 
   // Parse the input file.
@@ -105,6 +177,11 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
   if (MainFn(Out, Records))
     return 1;
 
+  std::vector<std::pair<std::string, std::string>> ExtraOuts;
+  if (int Ret = performExtraActions(argv0, MainFn, SelectActionFn, Records,
+                                    ExtraOuts))
+    return Ret;
+
   // Always write the depfile, even if the main output hasn't changed.
   // If it's missing, Ninja considers the output dirty.  If this was below
   // the early exit below and someone deleted the .inc.d file but not the .inc
@@ -114,24 +191,10 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
       return Ret;
   }
 
-  // Only updates the real output file if there are any differences.
-  // This prevents recompilation of all the files depending on it if there
-  // aren't any.
-  if (auto ExistingOrErr = MemoryBuffer::getFile(OutputFilename))
-    if (std::move(ExistingOrErr.get())->getBuffer() == Out.str())
-      return 0;
-
-  std::error_code EC;
-  ToolOutputFile OutFile(OutputFilename, EC, sys::fs::OF_Text);
-  if (EC)
-    return reportError(argv0, "error opening " + OutputFilename + ":" +
-                                  EC.message() + "\n");
-  OutFile.os() << Out.str();
-
-  if (ErrorsPrinted > 0)
-    return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
-
-  // Declare success.
-  OutFile.keep();
+  if (int Ret = writeOutputFile(argv0, OutputFilename, Out.str()))
+    return Ret;
+  for (const auto &Output : ExtraOuts)
+    if (int Ret = writeOutputFile(argv0, Output.first, Output.second))
+      return Ret;
   return 0;
 }
@@ -132,6 +132,9 @@ public:
                             const MCRelaxableFragment *DF,
                             const MCAsmLayout &Layout) const override;
 
+  bool fixupFitsWithoutRelaxation(const MCFixup &Fixup,
+                                  int64_t Value) const override;
+
   void relaxInstruction(const MCInst &Inst, const MCSubtargetInfo &STI,
                         MCInst &Res) const override;
 
@@ -290,6 +293,11 @@ bool X86AsmBackend::fixupNeedsRelaxation(const MCFixup &Fixup,
   return !isInt<8>(Value);
 }
 
+bool X86AsmBackend::fixupFitsWithoutRelaxation(const MCFixup &Fixup,
+                                               int64_t Value) const {
+  return isInt<8>(Value);
+}
+
 // FIXME: Can tblgen help at all here to verify there aren't other instructions
 // we can relax?
 void X86AsmBackend::relaxInstruction(const MCInst &Inst,
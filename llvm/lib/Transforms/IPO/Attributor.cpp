@@ -53,6 +53,14 @@ STATISTIC(NumAttributesValidFixpoint,
           "Number of abstract attributes in a valid fixpoint state");
 STATISTIC(NumAttributesManifested,
           "Number of abstract attributes manifested in IR");
+STATISTIC(NumAttributesUpdated, "Number of abstract attribute updates");
+STATISTIC(NumAttributeQueries,
+          "Number of queries of an abstract attribute by another one");
+STATISTIC(NumAttributeDependences,
+          "Number of dependences recorded between abstract attributes");
+STATISTIC(NumFixpointIterations, "Number of fixpoint iterations");
+STATISTIC(NumFixpointTimedOut,
+          "Number of fixpoint iterations stopped at the iteration limit");
 
 // Some helper macros to deal with statistics tracking.
 //
@@ -2405,6 +2413,20 @@ bool Attributor::checkForAllReadWriteInstructions(
   return true;
 }
 
+void Attributor::recordDependence(const AbstractAttribute &AA,
+                                  const AbstractAttribute &QueryingAA) {
+  NumAttributeQueries++;
+
+  // Neither an attribute with an invalid state nor one at a fixpoint will
+  // change again. Do not register a dependence on them.
+  const AbstractState &State = AA.getState();
+  if (!State.isValidState() || State.isAtFixpoint())
+    return;
+  if (QueryMap[const_cast<AbstractAttribute *>(&AA)].insert(
+          const_cast<AbstractAttribute *>(&QueryingAA)))
+    NumAttributeDependences++;
+}
+
 ChangeStatus Attributor::run() {
   // Initialize all abstract attributes, allow new ones to be created.
   for (unsigned u = 0; u < AllAbstractAttributes.size(); u++)
@@ -2430,10 +2452,12 @@ ChangeStatus Attributor::run() {
                       << ", Worklist size: " << Worklist.size() << "\n");
 
     // Add all abstract attributes that are potentially dependent on one that
-    // changed to the work list.
+    // changed to the work list. Their updates record the dependences that
+    // still exist, the others are dropped.
     for (AbstractAttribute *ChangedAA : ChangedAAs) {
       auto &QuerriedAAs = QueryMap[ChangedAA];
       Worklist.insert(QuerriedAAs.begin(), QuerriedAAs.end());
+      QuerriedAAs.clear();
     }
 
     // Reset the changed set.
@@ -2442,9 +2466,11 @@ ChangeStatus Attributor::run() {
     // Update all abstract attribute in the work list and record the ones that
     // changed.
     for (AbstractAttribute *AA : Worklist)
-      if (!isAssumedDead(*AA, nullptr))
+      if (!isAssumedDead(*AA, nullptr)) {
+        NumAttributesUpdated++;
         if (AA->update(*this) == ChangeStatus::CHANGED)
           ChangedAAs.push_back(AA);
+      }
 
     // Reset the work list and repopulate with the changed abstract attributes.
     // Note that dependent ones are added above.
@@ -2465,6 +2491,9 @@ ChangeStatus Attributor::run() {
                     << " iterations\n");
 
   bool FinishedAtFixpoint = Worklist.empty();
+  NumFixpointIterations += IterationCounter;
+  if (!FinishedAtFixpoint)
+    NumFixpointTimedOut++;
 
   // Reset abstract arguments not settled in a sound fixpoint by now. This
   // happens when we stopped the fixpoint iteration early. Note that only the
@@ -41,6 +41,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -621,13 +622,43 @@ void llvm::ComputeCrossModuleImport(
     StringMap<FunctionImporter::ImportMapTy> &ImportLists,
     StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
   // For each module that has function defined, compute the import/export lists.
+  // The import list of a module only depends on the (read-only) index, so
+  // modules are processed in parallel. Each module records the exports it
+  // causes in its own map, and the maps are merged afterwards.
+  std::vector<const StringMapEntry<GVSummaryMapTy> *> Modules;
   for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first()];
-    LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first() << "'\n");
-    ComputeImportForModule(DefinedGVSummaries.second, Index,
-                           DefinedGVSummaries.first(), ImportList,
-                           &ExportLists);
+    Modules.push_back(&DefinedGVSummaries);
+    ImportLists[DefinedGVSummaries.first()];
+  }
+
+  std::vector<StringMap<FunctionImporter::ExportSetTy>> ModuleExportLists(
+      Modules.size());
+  auto ComputeForModule = [&](size_t I) {
+    StringRef ModulePath = Modules[I]->first();
+    auto &ImportList = ImportLists.find(ModulePath)->second;
+    LLVM_DEBUG(dbgs() << "Computing import for Module '" << ModulePath
+                      << "'\n");
+    ComputeImportForModule(Modules[I]->second, Index, ModulePath, ImportList,
+                           &ModuleExportLists[I]);
+  };
+
+  // -import-cutoff counts the imports of all modules in the order they are
+  // computed, and the debug output and import failures are printed as they
+  // are found, so modules are processed in order if either is requested.
+  bool Serial = ImportCutoff >= 0 || PrintImportFailures;
+  LLVM_DEBUG(Serial = true);
+  if (Serial) {
+    for (size_t I = 0, E = Modules.size(); I != E; ++I)
+      ComputeForModule(I);
+  } else {
+    parallel::for_each_n(parallel::par, size_t(0), Modules.size(),
+                         ComputeForModule);
+  }
+
+  for (StringMap<FunctionImporter::ExportSetTy> &Exports : ModuleExportLists) {
+    for (auto &ELI : Exports)
+      ExportLists[ELI.first()].insert(ELI.second.begin(), ELI.second.end());
+    Exports.clear();
   }
 
   // When computing imports we added all GUIDs referenced by anything
@@ -635,16 +666,26 @@ void llvm::ComputeCrossModuleImport(
   // of any not defined in that module. This is more efficient than checking
   // while computing imports because some of the summary lists may be long
   // due to linkonce (comdat) copies.
-  for (auto &ELI : ExportLists) {
-    const auto &DefinedGVSummaries =
-        ModuleToDefinedGVSummaries.lookup(ELI.first());
-    for (auto EI = ELI.second.begin(); EI != ELI.second.end();) {
-      if (!DefinedGVSummaries.count(*EI))
-        EI = ELI.second.erase(EI);
-      else
-        ++EI;
-    }
-  }
+  std::vector<StringMapEntry<FunctionImporter::ExportSetTy> *> Exports;
+  for (auto &ELI : ExportLists)
+    Exports.push_back(&ELI);
+  parallel::for_each(parallel::par, Exports.begin(), Exports.end(),
+                     [&](StringMapEntry<FunctionImporter::ExportSetTy> *ELI) {
+                       auto It = ModuleToDefinedGVSummaries.find(ELI->first());
+                       FunctionImporter::ExportSetTy &ExportList =
+                           ELI->second;
+                       if (It == ModuleToDefinedGVSummaries.end()) {
+                         ExportList.clear();
+                         return;
+                       }
+                       for (auto EI = ExportList.begin();
+                            EI != ExportList.end();) {
+                         if (!It->second.count(*EI))
+                           EI = ExportList.erase(EI);
+                         else
+                           ++EI;
+                       }
+                     });
 
 #ifndef NDEBUG
   LLVM_DEBUG(dbgs() << "Import/Export lists for " << ImportLists.size()
@@ -84,6 +84,10 @@ static cl::opt<int>
                        cl::desc("Base penalty for splitting cold code (as a "
                                 "multiple of TCC_Basic)"));
 
+static cl::opt<bool> EnableColdSectionPrefix(
+    "hotcoldsplit-cold-section-prefix", cl::init(false), cl::Hidden,
+    cl::desc("Place split cold functions in .text.unlikely sections"));
+
 namespace {
 
 /// A sequence of basic blocks.
@@ -362,6 +366,11 @@ Function *HotColdSplitting::extractColdRegion(const BlockSequence &Region,
 
     markFunctionCold(*OutF, BFI != nullptr);
 
+    // Keep the split function out of the hot text, even without profile data
+    // for CodeGenPrepare to place it by.
+    if (EnableColdSectionPrefix)
+      OutF->setSectionPrefix(".unlikely");
+
     LLVM_DEBUG(llvm::dbgs() << "Outlined Region: " << *OutF);
     ORE.emit([&]() {
       return OptimizationRemark(DEBUG_TYPE, "HotColdSplit",
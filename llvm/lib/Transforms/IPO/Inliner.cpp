@@ -81,6 +81,7 @@ STATISTIC(NumMergedAllocas, "Number of allocas merged together");
 // to inline a function A into B, we analyze the callers of B in order to see
 // if those would be more profitable and blocked inline steps.
 STATISTIC(NumCallerCallersAnalyzed, "Number of caller-callers analyzed");
+STATISTIC(NumCachedInlineCosts, "Number of inline costs reused");
 
 /// Flag to disable manual alloca merging.
 ///
@@ -412,6 +413,33 @@ static std::string inlineCostStr(const InlineCost &IC) {
   return Remark.str();
 }
 
+using InlineCostCacheTy = DenseMap<const Instruction *, InlineCost>;
+
+/// Return the cost of inlining \p CS, memoized in \p Cache.
+///
+/// To decide whether to defer inlining into a local function, shouldInline
+/// asks for the cost of every call to that function again for each call site
+/// in it. The cost only depends on the IR, so the inliner keeps it until it
+/// changes the IR and then clears \p Cache. When remarks are enabled the cost
+/// is always recomputed, as the cost analysis emits them.
+static InlineCost
+getCachedInlineCost(CallSite CS, InlineCostCacheTy &Cache,
+                    function_ref<InlineCost(CallSite CS)> GetInlineCost) {
+  Instruction *Call = CS.getInstruction();
+  if (Call->getContext().getDiagHandlerPtr()->isMissedOptRemarkEnabled(
+          DEBUG_TYPE))
+    return GetInlineCost(CS);
+
+  auto It = Cache.find(Call);
+  if (It != Cache.end()) {
+    ++NumCachedInlineCosts;
+    return It->second;
+  }
+  InlineCost IC = GetInlineCost(CS);
+  Cache.insert({Call, IC});
+  return IC;
+}
+
 /// Return the cost only if the inliner should attempt to inline at the given
 /// CallSite. If we return the cost, we will emit an optimisation remark later
 /// using that cost, so we won't do so from this function.
@@ -605,6 +633,11 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
   InlinedArrayAllocasTy InlinedArrayAllocas;
   InlineFunctionInfo InlineInfo(&CG, &GetAssumptionCache, PSI);
 
+  InlineCostCacheTy InlineCostCache;
+  auto GetCachedCost = [&](CallSite CS) {
+    return getCachedInlineCost(CS, InlineCostCache, GetInlineCost);
+  };
+
   // Now that we have all of the call sites, loop over them and inline them if
   // it looks profitable to do so.
   bool Changed = false;
@@ -648,7 +681,7 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
       // just become a regular analysis dependency.
       OptimizationRemarkEmitter ORE(Caller);
 
-      Optional<InlineCost> OIC = shouldInline(CS, GetInlineCost, ORE);
+      Optional<InlineCost> OIC = shouldInline(CS, GetCachedCost, ORE);
       // If the policy determines that we should inline this function,
       // delete the call instead.
       if (!OIC.hasValue()) {
@@ -745,6 +778,8 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
       }
       --CSi;
 
+      // The IR has changed, so the cached costs may be stale.
+      InlineCostCache.clear();
       Changed = true;
       LocalChange = true;
     }
@@ -962,6 +997,9 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
   // defer deleting these to make it easier to handle the call graph updates.
   SmallVector<Function *, 4> DeadFunctions;
 
+  // Inline costs, which stay valid until the next successful inlining.
+  InlineCostCacheTy InlineCostCache;
+
   // Loop forward over all of the calls. Note that we cannot cache the size as
   // inlining can introduce new calls that need to be processed.
   for (int i = 0; i < (int)Calls.size(); ++i) {
@@ -1002,7 +1040,7 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       return FAM.getResult<BlockFrequencyAnalysis>(F);
     };
 
-    auto GetInlineCost = [&](CallSite CS) {
+    auto GetUncachedInlineCost = [&](CallSite CS) {
       Function &Callee = *CS.getCalledFunction();
       auto &CalleeTTI = FAM.getResult<TargetIRAnalysis>(Callee);
       bool RemarksEnabled =
@@ -1012,6 +1050,9 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
                            CalleeTTI, GetAssumptionCache, {GetBFI}, PSI,
                            RemarksEnabled ? &ORE : nullptr);
     };
+    auto GetInlineCost = [&](CallSite CS) {
+      return getCachedInlineCost(CS, InlineCostCache, GetUncachedInlineCost);
+    };
 
     // Now process as many calls as we have within this caller in the sequnece.
     // We bail out as soon as the caller has to change so we can update the
@@ -1082,6 +1123,7 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       }
       DidInline = true;
       InlinedCallees.insert(&Callee);
+      InlineCostCache.clear();
 
       ++NumInlined;
 
@@ -121,6 +121,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/MergeFunctions.h"
 #include "llvm/Transforms/Utils/FunctionComparator.h"
 #include <algorithm>
 #include <cassert>
@@ -177,9 +178,8 @@ class FunctionNode {
   FunctionComparator::FunctionHash Hash;
 
 public:
-  // Note the hash is recalculated potentially multiple times, but it is cheap.
-  FunctionNode(Function *F)
-    : F(F), Hash(FunctionComparator::functionHash(*F))  {}
+  FunctionNode(Function *F, FunctionComparator::FunctionHash Hash)
+      : F(F), Hash(Hash) {}
 
   Function *getFunc() const { return F; }
   FunctionComparator::FunctionHash getHash() const { return Hash; }
@@ -195,16 +195,11 @@ public:
 /// by considering all pointer types to be equivalent. Once identified,
 /// MergeFunctions will fold them by replacing a call to one to a call to a
 /// bitcast of the other.
-class MergeFunctions : public ModulePass {
+class MergeFunctions {
 public:
-  static char ID;
-
-  MergeFunctions()
-    : ModulePass(ID), FnTree(FunctionNodeCmp(&GlobalNumbers)) {
-    initializeMergeFunctionsPass(*PassRegistry::getPassRegistry());
-  }
+  MergeFunctions() : FnTree(FunctionNodeCmp(&GlobalNumbers)) {}
 
-  bool runOnModule(Module &M) override;
+  bool runOnModule(Module &M);
 
 private:
   // The function comparison operator is provided here so that FunctionNodes do
@@ -238,8 +233,9 @@ private:
 #endif
 
   /// Insert a ComparableFunction into the FnTree, or merge it away if it's
-  /// equal to one that's already present.
-  bool insert(Function *NewFunction);
+  /// equal to one that's already present. \p Hash is the functionHash() of
+  /// \p NewFunction.
+  bool insert(Function *NewFunction, FunctionComparator::FunctionHash Hash);
 
   /// Remove a Function from the FnTree and queue it up for a second sweep of
   /// analysis.
@@ -297,14 +293,39 @@ private:
   DenseMap<AssertingVH<Function>, FnTreeType::iterator> FNodesInTree;
 };
 
-} // end anonymous namespace
+class MergeFunctionsLegacyPass : public ModulePass {
+public:
+  static char ID;
+
+  MergeFunctionsLegacyPass() : ModulePass(ID) {
+    initializeMergeFunctionsLegacyPassPass(*PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &M) override {
+    if (skipModule(M))
+      return false;
 
-char MergeFunctions::ID = 0;
+    MergeFunctions MF;
+    return MF.runOnModule(M);
+  }
+};
+
+} // end anonymous namespace
 
-INITIALIZE_PASS(MergeFunctions, "mergefunc", "Merge Functions", false, false)
+char MergeFunctionsLegacyPass::ID = 0;
+INITIALIZE_PASS(MergeFunctionsLegacyPass, "mergefunc",
+                "Merge Functions", false, false)
 
 ModulePass *llvm::createMergeFunctionsPass() {
-  return new MergeFunctions();
+  return new MergeFunctionsLegacyPass();
+}
+
+PreservedAnalyses MergeFunctionsPass::run(Module &M,
+                                          ModuleAnalysisManager &AM) {
+  MergeFunctions MF;
+  if (!MF.runOnModule(M))
+    return PreservedAnalyses::all();
+  return PreservedAnalyses::none();
 }
 
 #ifndef NDEBUG
@@ -386,9 +407,6 @@ static bool isEligibleForMerging(Function &F) {
 }
 
 bool MergeFunctions::runOnModule(Module &M) {
-  if (skipModule(M))
-    return false;
-
   bool Changed = false;
 
   // All functions in the module, ordered by hash. Functions with a unique
@@ -403,6 +421,11 @@ bool MergeFunctions::runOnModule(Module &M) {
 
   llvm::stable_sort(HashedFuncs, less_first());
 
+  // The first round inserts the functions with the hashes computed here.
+  // Merging only replaces operands in the functions that are not in the FnTree
+  // yet, which does not change their hash. The functions deferred afterwards
+  // have been modified and are hashed again.
+  std::vector<FunctionComparator::FunctionHash> Hashes;
   auto S = HashedFuncs.begin();
   for (auto I = HashedFuncs.begin(), IE = HashedFuncs.end(); I != IE; ++I) {
     // If the hash value matches the previous value or the next one, we must
@@ -410,6 +433,7 @@ bool MergeFunctions::runOnModule(Module &M) {
     if ((I != S && std::prev(I)->first == I->first) ||
         (std::next(I) != IE && std::next(I)->first == I->first) ) {
       Deferred.push_back(WeakTrackingVH(I->second));
+      Hashes.push_back(I->first);
     }
   }
 
@@ -423,14 +447,19 @@ bool MergeFunctions::runOnModule(Module &M) {
     LLVM_DEBUG(dbgs() << "size of worklist: " << Worklist.size() << '\n');
 
     // Insert functions and merge them.
-    for (WeakTrackingVH &I : Worklist) {
+    for (size_t Idx = 0, E = Worklist.size(); Idx != E; ++Idx) {
+      WeakTrackingVH &I = Worklist[Idx];
       if (!I)
         continue;
       Function *F = cast<Function>(I);
       if (!F->isDeclaration() && !F->hasAvailableExternallyLinkage()) {
-        Changed |= insert(F);
+        FunctionComparator::FunctionHash Hash =
+            Idx < Hashes.size() ? Hashes[Idx]
+                                : FunctionComparator::functionHash(*F);
+        Changed |= insert(F, Hash);
       }
     }
+    Hashes.clear();
     LLVM_DEBUG(dbgs() << "size of FnTree: " << FnTree.size() << '\n');
   } while (!Deferred.empty());
 
@@ -899,9 +928,10 @@ static bool isFuncOrderCorrect(const Function *F, const Function *G) {
 
 // Insert a ComparableFunction into the FnTree, or merge it away if equal to one
 // that was already inserted.
-bool MergeFunctions::insert(Function *NewFunction) {
+bool MergeFunctions::insert(Function *NewFunction,
+                            FunctionComparator::FunctionHash Hash) {
   std::pair<FnTreeType::iterator, bool> Result =
-      FnTree.insert(FunctionNode(NewFunction));
+      FnTree.insert(FunctionNode(NewFunction, Hash));
 
   if (Result.second) {
     assert(FNodesInTree.count(NewFunction) == 0);
@@ -87,6 +87,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/IPO/FunctionAttrs.h"
 #include "llvm/Transforms/Utils/Evaluator.h"
@@ -601,9 +602,10 @@ struct DevirtIndex {
       : ExportSummary(ExportSummary), ExportedGUIDs(ExportedGUIDs),
         LocalWPDTargetsMap(LocalWPDTargetsMap) {}
 
-  bool tryFindVirtualCallTargets(std::vector<ValueInfo> &TargetsForSlot,
-                                 const TypeIdCompatibleVtableInfo TIdInfo,
-                                 uint64_t ByteOffset);
+  static bool
+  tryFindVirtualCallTargets(std::vector<ValueInfo> &TargetsForSlot,
+                            const TypeIdCompatibleVtableInfo &TIdInfo,
+                            uint64_t ByteOffset);
 
   bool trySingleImplDevirt(MutableArrayRef<ValueInfo> TargetsForSlot,
                            VTableSlotSummary &SlotSummary,
@@ -876,9 +878,9 @@ bool DevirtModule::tryFindVirtualCallTargets(
 }
 
 bool DevirtIndex::tryFindVirtualCallTargets(
-    std::vector<ValueInfo> &TargetsForSlot, const TypeIdCompatibleVtableInfo TIdInfo,
-    uint64_t ByteOffset) {
-  for (const TypeIdOffsetVtableInfo P : TIdInfo) {
+    std::vector<ValueInfo> &TargetsForSlot,
+    const TypeIdCompatibleVtableInfo &TIdInfo, uint64_t ByteOffset) {
+  for (const TypeIdOffsetVtableInfo &P : TIdInfo) {
     // VTable initializer should have only one summary, or all copies must be
     // linkonce/weak ODR.
     assert(P.VTableVI.getSummaryList().size() == 1 ||
@@ -891,7 +893,7 @@ bool DevirtIndex::tryFindVirtualCallTargets(
     const auto *VS = cast<GlobalVarSummary>(P.VTableVI.getSummaryList()[0].get());
     if (!P.VTableVI.getSummaryList()[0]->isLive())
       continue;
-    for (auto VTP : VS->vTableFuncs()) {
+    for (const VirtFuncOffset &VTP : VS->vTableFuncs()) {
       if (VTP.VTableOffset != P.AddressPointOffset + ByteOffset)
         continue;
 
@@ -1991,17 +1993,32 @@ void DevirtIndex::run() {
     }
   }
 
+  // For each (type, offset) pair, search each of the members of the type
+  // identifier for the virtual function implementation at offset
+  // S.first.ByteOffset, and add to TargetsForSlots. The search only sees the
+  // index and the slots through const references, so the slots are processed
+  // in parallel, and the resolutions are recorded in slot order below.
+  std::vector<std::vector<ValueInfo>> TargetsForSlots(CallSlots.size());
+  const ModuleSummaryIndex &Index = ExportSummary;
+  const auto &Slots = CallSlots;
+  parallel::for_each_n(parallel::par, size_t(0), Slots.size(),
+                       [&Index, &Slots, &TargetsForSlots](size_t I) {
+                         const VTableSlotSummary &Slot =
+                             (Slots.begin() + I)->first;
+                         auto *TidSummary =
+                             Index.getTypeIdCompatibleVtableSummary(
+                                 Slot.TypeID);
+                         assert(TidSummary);
+                         tryFindVirtualCallTargets(TargetsForSlots[I],
+                                                   *TidSummary,
+                                                   Slot.ByteOffset);
+                       });
+
   std::set<ValueInfo> DevirtTargets;
-  // For each (type, offset) pair:
-  for (auto &S : CallSlots) {
-    // Search each of the members of the type identifier for the virtual
-    // function implementation at offset S.first.ByteOffset, and add to
-    // TargetsForSlot.
-    std::vector<ValueInfo> TargetsForSlot;
-    auto TidSummary = ExportSummary.getTypeIdCompatibleVtableSummary(S.first.TypeID);
-    assert(TidSummary);
-    if (tryFindVirtualCallTargets(TargetsForSlot, *TidSummary,
-                                  S.first.ByteOffset)) {
+  for (size_t I = 0, E = CallSlots.size(); I != E; ++I) {
+    auto &S = *(CallSlots.begin() + I);
+    std::vector<ValueInfo> &TargetsForSlot = TargetsForSlots[I];
+    if (!TargetsForSlot.empty()) {
       WholeProgramDevirtResolution *Res =
           &ExportSummary.getOrInsertTypeIdSummary(S.first.TypeID)
                .WPDRes[S.first.ByteOffset];
@@ -32,9 +32,11 @@
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/Pass.h"
@@ -102,6 +104,21 @@ cl::opt<bool> AtomicCounterUpdateAll(
     cl::desc("Make all profile counter updates atomic (for testing only)"),
     cl::init(false));
 
+cl::opt<bool> RuntimeCounterRelocation(
+    "runtime-counter-relocation", cl::ZeroOrMore,
+    cl::desc("Add the counter bias set by the profile runtime to the address "
+             "of every counter update, so that the counters can be moved to "
+             "a mapped profile file in continuous mode"),
+    cl::init(false));
+
+cl::opt<bool> CounterShards(
+    "instrprof-counter-shards", cl::ZeroOrMore,
+    cl::desc("Give every thread its own copy of the profile counters, which "
+             "the runtime adds up when the profile is written. This avoids "
+             "contention on hot counters in multithreaded programs, and takes "
+             "precedence over -runtime-counter-relocation"),
+    cl::init(false));
+
 cl::opt<bool> AtomicCounterUpdatePromoted(
     "atomic-counter-update-promoted", cl::ZeroOrMore,
     cl::desc("Do counter update using atomic fetch add "
@@ -199,6 +216,14 @@ public:
       Value *Addr = cast<StoreInst>(Store)->getPointerOperand();
       Type *Ty = LiveInValue->getType();
       IRBuilder<> Builder(InsertPos);
+      if (auto *AddrInst = dyn_cast<IntToPtrInst>(Addr)) {
+        // With runtime counter relocation, getCounterAddress() computes the
+        // address inside the loop, which need not dominate the exit block.
+        // Recompute it here from the same (loop-invariant) operands.
+        auto *OrigBiasInst = cast<BinaryOperator>(AddrInst->getOperand(0));
+        Value *BiasInst = Builder.Insert(OrigBiasInst->clone());
+        Addr = Builder.CreateIntToPtr(BiasInst, AddrInst->getType());
+      }
       if (AtomicCounterUpdatePromoted)
         // automic update currently can only be promoted across the current
         // loop, not the whole loop nest.
@@ -402,6 +427,8 @@ static InstrProfIncrementInst *castToIncrementInst(Instruction *Instr) {
 bool InstrProfiling::lowerIntrinsics(Function *F) {
   bool MadeChange = false;
   PromotionCandidates.clear();
+  if (CounterShards)
+    emitCounterShardBias(F);
   for (BasicBlock &BB : *F) {
     for (auto I = BB.begin(), E = BB.end(); I != E;) {
       auto Instr = I++;
@@ -489,6 +516,7 @@ bool InstrProfiling::run(Module &M, const TargetLibraryInfo &TLI) {
   NamesSize = 0;
   ProfileDataMap.clear();
   UsedVars.clear();
+  FunctionToProfileBiasMap.clear();
   getMemOPSizeRangeFromOption(MemOPSizeRange, MemOPSizeRangeStart,
                               MemOPSizeRangeLast);
   TT = Triple(M.getTargetTriple());
@@ -623,14 +651,101 @@ void InstrProfiling::lowerValueProfileInst(InstrProfValueProfileInst *Ind) {
   Ind->eraseFromParent();
 }
 
-void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
-  GlobalVariable *Counters = getOrCreateRegionCounters(Inc);
+Value *InstrProfiling::getCounterAddress(InstrProfIncrementInst *I) {
+  GlobalVariable *Counters = getOrCreateRegionCounters(I);
 
-  IRBuilder<> Builder(Inc);
-  uint64_t Index = Inc->getIndex()->getZExtValue();
+  IRBuilder<> Builder(I);
+  uint64_t Index = I->getIndex()->getZExtValue();
   Value *Addr = Builder.CreateConstInBoundsGEP2_64(Counters->getValueType(),
                                                    Counters, 0, Index);
+  if (!RuntimeCounterRelocation && !CounterShards)
+    return Addr;
+
+  // Load the bias once per function, in the entry block, so that it
+  // dominates the counter updates promoted out of loops. The counter shard
+  // bias is set up by emitCounterShardBias() before lowering.
+  Type *Int64Ty = Type::getInt64Ty(M->getContext());
+  Function *Fn = I->getParent()->getParent();
+  Value *&BiasLI = FunctionToProfileBiasMap[Fn];
+  assert((BiasLI || !CounterShards) && "missing counter shard bias");
+  if (!BiasLI) {
+    IRBuilder<> EntryBuilder(&Fn->getEntryBlock(),
+                             Fn->getEntryBlock().getFirstInsertionPt());
+    auto *Bias = M->getGlobalVariable(getInstrProfCounterBiasVarName());
+    if (!Bias) {
+      Bias = new GlobalVariable(*M, Int64Ty, false,
+                                GlobalValue::LinkOnceODRLinkage,
+                                Constant::getNullValue(Int64Ty),
+                                getInstrProfCounterBiasVarName());
+      Bias->setVisibility(GlobalVariable::HiddenVisibility);
+    }
+    BiasLI = EntryBuilder.CreateLoad(Int64Ty, Bias);
+  }
+  Value *Add = Builder.CreateAdd(
+      Builder.CreatePtrToInt(Addr, BiasLI->getType()), BiasLI);
+  return Builder.CreateIntToPtr(Add, Addr->getType());
+}
 
+void InstrProfiling::emitCounterShardBias(Function *F) {
+  bool HasIncrement = any_of(instructions(F), [](Instruction &I) {
+    return castToIncrementInst(&I) != nullptr;
+  });
+  if (!HasIncrement)
+    return;
+
+  LLVMContext &Ctx = M->getContext();
+  Type *IntPtrTy = M->getDataLayout().getIntPtrType(Ctx);
+  auto *ShardBias = M->getGlobalVariable(getInstrProfCounterShardBiasVarName());
+  if (!ShardBias) {
+    // The runtime defines the variable, per-thread and zero-initialized.
+    ShardBias = new GlobalVariable(
+        *M, IntPtrTy, false, GlobalValue::ExternalLinkage, nullptr,
+        getInstrProfCounterShardBiasVarName(), nullptr,
+        GlobalVariable::GeneralDynamicTLSModel);
+    ShardBias->setVisibility(GlobalVariable::HiddenVisibility);
+  }
+
+  // Split the entry block after its allocas, so that they stay static:
+  //
+  //   %bias = load %shard.bias
+  //   br (%bias == 0), %acquire, %tail
+  // acquire:
+  //   %new.bias = call @__llvm_profile_acquire_counter_shard()
+  // tail:
+  //   phi [%bias, %new.bias]
+  //
+  // Only the first call of a thread into instrumented code takes the branch.
+  BasicBlock *Head = &F->getEntryBlock();
+  BasicBlock::iterator SplitPt = Head->getFirstInsertionPt();
+  while (isa<AllocaInst>(SplitPt))
+    ++SplitPt;
+  IRBuilder<> Builder(&*SplitPt);
+  LoadInst *Bias = Builder.CreateLoad(IntPtrTy, ShardBias);
+  Value *NoShard = Builder.CreateICmpEQ(Bias, ConstantInt::get(IntPtrTy, 0));
+  Instruction *AcquireTerm = SplitBlockAndInsertIfThen(
+      NoShard, &*SplitPt, false,
+      MDBuilder(Ctx).createBranchWeights(1, (1U << 20) - 1));
+
+  FunctionCallee Acquire = M->getOrInsertFunction(
+      getInstrProfAcquireCounterShardFuncName(),
+      AttributeList().addAttribute(Ctx, AttributeList::FunctionIndex,
+                                   Attribute::NoUnwind),
+      IntPtrTy);
+  IRBuilder<> AcquireBuilder(AcquireTerm);
+  Value *NewBias = AcquireBuilder.CreateCall(Acquire);
+
+  BasicBlock *Tail = AcquireTerm->getSuccessor(0);
+  IRBuilder<> TailBuilder(&Tail->front());
+  PHINode *Phi = TailBuilder.CreatePHI(IntPtrTy, 2);
+  Phi->addIncoming(Bias, Head);
+  Phi->addIncoming(NewBias, AcquireTerm->getParent());
+  FunctionToProfileBiasMap[F] = Phi;
+}
+
+void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
+  Value *Addr = getCounterAddress(Inc);
+
+  IRBuilder<> Builder(Inc);
   if (Options.Atomic || AtomicCounterUpdateAll) {
     Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, Inc->getStep(),
                             AtomicOrdering::Monotonic);
@@ -95,6 +95,8 @@ STATISTIC(NumGVNBlocks, "Number of blocks merged");
 STATISTIC(NumGVNSimpl,  "Number of instructions simplified");
 STATISTIC(NumGVNEqProp, "Number of equalities propagated");
 STATISTIC(NumPRELoad,   "Number of loads PRE'd");
+STATISTIC(NumGVNNonLocalLoadSkipped,
+          "Number of non-local loads skipped due to the dependence budget");
 
 static cl::opt<bool> EnablePRE("enable-pre",
                                cl::init(true), cl::Hidden);
@@ -110,6 +112,15 @@ static cl::opt<uint32_t> MaxNumDeps(
     "gvn-max-num-deps", cl::Hidden, cl::init(100), cl::ZeroOrMore,
     cl::desc("Max number of dependences to attempt Load PRE (default = 100)"));
 
+// Non-local dependence queries scan backwards through the CFG for every load,
+// which is quadratic on large functions. This bounds the total work per
+// function.
+static cl::opt<uint64_t> MaxNonLocalLoadDeps(
+    "gvn-max-nonlocal-load-deps", cl::Hidden, cl::init(0), cl::ZeroOrMore,
+    cl::desc("Max total number of non-local load dependences to compute in a "
+             "function before non-local load elimination and load PRE are "
+             "skipped for the rest of it (default = 0, unlimited)"));
+
 struct llvm::GVN::Expression {
   uint32_t opcode;
   Type *type;
@@ -1294,6 +1305,11 @@ bool GVN::processNonLocalLoad(LoadInst *LI) {
           Attribute::SanitizeHWAddress))
     return false;
 
+  if (MaxNonLocalLoadDeps && NumNonLocalLoadDeps >= MaxNonLocalLoadDeps) {
+    ++NumGVNNonLocalLoadSkipped;
+    return false;
+  }
+
   // Step 1: Find the non-local dependencies of the load.
   LoadDepVect Deps;
   MD->getNonLocalPointerDependency(LI, Deps);
@@ -1302,6 +1318,7 @@ bool GVN::processNonLocalLoad(LoadInst *LI) {
   // dependencies, this load isn't worth worrying about.  Optimizing
   // it will be too expensive.
   unsigned NumDeps = Deps.size();
+  NumNonLocalLoadDeps += std::max(NumDeps, 1u);
   if (NumDeps > MaxNumDeps)
     return false;
 
@@ -1983,6 +2000,7 @@ bool GVN::runImpl(Function &F, AssumptionCache &RunAC, DominatorTree &RunDT,
   VN.setMemDep(MD);
   ORE = RunORE;
   InvalidBlockRPONumbers = true;
+  NumNonLocalLoadDeps = 0;
 
   bool Changed = false;
   bool ShouldContinue = true;
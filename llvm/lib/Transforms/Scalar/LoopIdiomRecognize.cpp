@@ -21,7 +21,7 @@
 // TODO List:
 //
 // Future loop memory idioms to recognize:
-//   memcmp, memmove, strlen, etc.
+//   memcmp, memmove, etc.
 // Future floating point idioms to recognize in -ffast-math mode:
 //   fpowi
 // Future integer operation idioms to recognize:
@@ -77,6 +77,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
+#include "llvm/IR/PatternMatch.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/User.h"
 #include "llvm/IR/Value.h"
@@ -97,11 +98,14 @@
 #include <vector>
 
 using namespace llvm;
+using namespace llvm::PatternMatch;
 
 #define DEBUG_TYPE "loop-idiom"
 
 STATISTIC(NumMemSet, "Number of memset's formed from loop stores");
 STATISTIC(NumMemCpy, "Number of memcpy's formed from loop load+stores");
+STATISTIC(NumStrLen, "Number of strlen's formed from loop byte searches");
+STATISTIC(NumMemChr, "Number of memchr's formed from loop byte searches");
 
 static cl::opt<bool> UseLIRCodeSizeHeurs(
     "use-lir-code-size-heurs",
@@ -190,6 +194,7 @@ private:
   void transformLoopToPopcount(BasicBlock *PreCondBB, Instruction *CntInst,
                                PHINode *CntPhi, Value *Var);
   bool recognizeAndInsertFFS();  /// Find First Set: ctlz or cttz
+  bool recognizeByteSearch();
   void transformLoopToCountable(Intrinsic::ID IntrinID, BasicBlock *PreCondBB,
                                 Instruction *CntInst, PHINode *CntPhi,
                                 Value *Var, Instruction *DefX,
@@ -299,7 +304,8 @@ bool LoopIdiomRecognize::runOnLoop(Loop *L) {
 
   // Disable loop idiom recognition if the function's name is a common idiom.
   StringRef Name = L->getHeader()->getParent()->getName();
-  if (Name == "memset" || Name == "memcpy")
+  if (Name == "memset" || Name == "memcpy" || Name == "strlen" ||
+      Name == "memchr")
     return false;
 
   // Determine if code size heuristics need to be applied.
@@ -1149,7 +1155,8 @@ bool LoopIdiomRecognize::runOnNoncountableLoop() {
                     << "] Noncountable Loop %"
                     << CurLoop->getHeader()->getName() << "\n");
 
-  return recognizePopcount() || recognizeAndInsertFFS();
+  return recognizePopcount() || recognizeAndInsertFFS() ||
+         recognizeByteSearch();
 }
 
 /// Check if the given conditional branch is based on the comparison between
@@ -1823,3 +1830,166 @@ void LoopIdiomRecognize::transformLoopToPopcount(BasicBlock *PreCondBB,
   //   loop. The loop would otherwise not be deleted even if it becomes empty.
   SE->forgetLoop(CurLoop);
 }
+
+/// Recognizes a loop that scans memory for the first byte equal to a
+/// loop-invariant value, either up to a terminating zero or within a buffer of
+/// computable size:
+/// \code
+///   while (*p != 0)                   // strlen(p)
+///     ++p;
+///
+///   for (i = 0; i != n; ++i)          // memchr(p, c, n)
+///     if (p[i] == c)
+///       break;
+/// \endcode
+///
+/// If the target library provides the function, it is called in the preheader
+/// and the values that leave the loop are computed from its result. The loop
+/// is then made to exit in its first iteration, so that it is deleted by later
+/// loop passes.
+bool LoopIdiomRecognize::recognizeByteSearch() {
+  // The search is the header of the loop. A buffer search additionally has a
+  // latch that checks the bound.
+  BasicBlock *Header = CurLoop->getHeader();
+  BasicBlock *Latch = CurLoop->getLoopLatch();
+  BasicBlock *PH = CurLoop->getLoopPreheader();
+  BasicBlock *ExitBB = CurLoop->getUniqueExitBlock();
+  bool IsBounded = CurLoop->getNumBlocks() == 2;
+  if (!Latch || !ExitBB || CurLoop->getNumBlocks() > 2 ||
+      (IsBounded && Header == Latch) || !CurLoop->isLCSSAForm(*DT))
+    return false;
+
+  auto *HeaderBI = dyn_cast<BranchInst>(Header->getTerminator());
+  if (!HeaderBI || !HeaderBI->isConditional())
+    return false;
+  BasicBlock *NextBB = HeaderBI->getSuccessor(HeaderBI->getSuccessor(0) ==
+                                              ExitBB);
+  if (NextBB != (IsBounded ? Latch : Header))
+    return false;
+
+  // The header exits when the loaded byte equals the value searched for.
+  ICmpInst::Predicate Pred;
+  Value *Loaded, *Needle;
+  if (!match(HeaderBI->getCondition(),
+             m_ICmp(Pred, m_Value(Loaded), m_Value(Needle))) ||
+      !ICmpInst::isEquality(Pred))
+    return false;
+  if (!isa<LoadInst>(Loaded))
+    std::swap(Loaded, Needle);
+  auto *Load = dyn_cast<LoadInst>(Loaded);
+  if (!Load || Load->getParent() != Header || !Load->isSimple() ||
+      !Load->getType()->isIntegerTy(8) ||
+      Load->getPointerAddressSpace() != 0 ||
+      !CurLoop->isLoopInvariant(Needle))
+    return false;
+  if ((Pred == ICmpInst::ICMP_EQ) != (HeaderBI->getSuccessor(0) == ExitBB))
+    return false;
+  if (IsBounded ? !TLI->has(LibFunc_memchr)
+                : !TLI->has(LibFunc_strlen) || !match(Needle, m_Zero()))
+    return false;
+
+  // The loop must read consecutive bytes and do nothing else.
+  auto *PtrEv =
+      dyn_cast<SCEVAddRecExpr>(SE->getSCEV(Load->getPointerOperand()));
+  if (!PtrEv || PtrEv->getLoop() != CurLoop || !PtrEv->isAffine() ||
+      !PtrEv->getStepRecurrence(*SE)->isOne())
+    return false;
+  for (BasicBlock *BB : CurLoop->blocks())
+    for (Instruction &I : *BB)
+      if (&I != Load && (I.mayReadOrWriteMemory() || I.mayHaveSideEffects()))
+        return false;
+
+  const SCEV *LatchExitCount = nullptr;
+  if (IsBounded) {
+    auto *LatchBI = dyn_cast<BranchInst>(Latch->getTerminator());
+    if (!LatchBI || !LatchBI->isConditional())
+      return false;
+    LatchExitCount = SE->getExitCount(CurLoop, Latch);
+    if (isa<SCEVCouldNotCompute>(LatchExitCount))
+      return false;
+  }
+
+  // Every value used after the loop must be computable from the iteration in
+  // which the loop exits.
+  SmallDenseMap<Value *, const SCEVAddRecExpr *, 8> ExitEvs;
+  for (PHINode &PN : ExitBB->phis())
+    for (Value *V : PN.incoming_values()) {
+      if (CurLoop->isLoopInvariant(V))
+        continue;
+      if (!SE->isSCEVable(V->getType()))
+        return false;
+      auto *Ev = dyn_cast<SCEVAddRecExpr>(SE->getSCEV(V));
+      if (!Ev || Ev->getLoop() != CurLoop || !Ev->isAffine())
+        return false;
+      ExitEvs[V] = Ev;
+    }
+
+  LLVM_DEBUG(dbgs() << DEBUG_TYPE " Recognized byte search in loop %"
+                    << Header->getName() << "\n");
+
+  IRBuilder<> Builder(PH->getTerminator());
+  Builder.SetCurrentDebugLocation(HeaderBI->getDebugLoc());
+  SCEVExpander Expander(*SE, *DL, "loop-idiom");
+  Type *IntPtrTy = Builder.getIntPtrTy(*DL);
+  Value *StartPtr = Expander.expandCodeFor(
+      PtrEv->getStart(), Builder.getInt8PtrTy(), PH->getTerminator());
+  Value *StartInt = Builder.CreatePtrToInt(StartPtr, IntPtrTy);
+
+  // The iteration in which the header exits, and whether it does so before
+  // the latch does.
+  Value *Call, *FoundIdx, *Found = nullptr;
+  if (IsBounded) {
+    const SCEV *NumBytesS =
+        SE->getAddExpr(SE->getTruncateOrZeroExtend(LatchExitCount, IntPtrTy),
+                       SE->getOne(IntPtrTy));
+    Value *NumBytes =
+        Expander.expandCodeFor(NumBytesS, IntPtrTy, PH->getTerminator());
+    Value *NeedleInt = Builder.CreateZExt(Needle, Builder.getInt32Ty());
+    Call = emitMemChr(StartPtr, NeedleInt, NumBytes, Builder, *DL, TLI);
+    Found = Builder.CreateIsNotNull(Call);
+    FoundIdx =
+        Builder.CreateSub(Builder.CreatePtrToInt(Call, IntPtrTy), StartInt);
+    ++NumMemChr;
+  } else {
+    Call = emitStrLen(StartPtr, Builder, *DL, TLI);
+    FoundIdx = Call;
+    ++NumStrLen;
+  }
+
+  auto getValueAtExit = [&](Value *V, const SCEV *Iteration) -> Value * {
+    if (CurLoop->isLoopInvariant(V))
+      return V;
+    const SCEV *S = ExitEvs.lookup(V)->evaluateAtIteration(Iteration, *SE);
+    return Expander.expandCodeFor(S, V->getType(), PH->getTerminator());
+  };
+  const SCEV *FoundIdxS = SE->getSCEV(FoundIdx);
+  for (PHINode &PN : make_early_inc_range(ExitBB->phis())) {
+    Value *AtHeaderExit =
+        getValueAtExit(PN.getIncomingValueForBlock(Header), FoundIdxS);
+    Value *NewV = AtHeaderExit;
+    if (IsBounded) {
+      Value *AtLatchExit =
+          getValueAtExit(PN.getIncomingValueForBlock(Latch), LatchExitCount);
+      Builder.SetInsertPoint(PH->getTerminator());
+      NewV = Builder.CreateSelect(Found, AtHeaderExit, AtLatchExit);
+    }
+    PN.replaceAllUsesWith(NewV);
+    PN.eraseFromParent();
+  }
+
+  // Leave the loop in the first iteration. Its remaining instructions are
+  // dead.
+  Value *OldCond = HeaderBI->getCondition();
+  HeaderBI->setCondition(Builder.getInt1(HeaderBI->getSuccessor(0) == ExitBB));
+  RecursivelyDeleteTriviallyDeadInstructions(OldCond);
+  SE->forgetLoop(CurLoop);
+
+  ORE.emit([&]() {
+    return OptimizationRemark(DEBUG_TYPE, "RecognizeByteSearch",
+                              HeaderBI->getDebugLoc(), Header)
+           << "Transformed byte search loop into a call to "
+           << ore::NV("NewFunction", cast<CallInst>(Call)->getCalledFunction())
+           << "() function";
+  });
+  return true;
+}
@@ -111,6 +111,22 @@ std::unique_ptr<Module> llvm::CloneModule(
     VMap[&*I] = GA;
   }
 
+  // Loop over the ifuncs in the module. Like an alias, an ifunc whose
+  // definition is not cloned becomes a function declaration.
+  for (const GlobalIFunc &I : M.ifuncs()) {
+    if (!ShouldCloneDefinition(&I)) {
+      VMap[&I] = Function::Create(cast<FunctionType>(I.getValueType()),
+                                  GlobalValue::ExternalLinkage,
+                                  I.getAddressSpace(), I.getName(), New.get());
+      continue;
+    }
+    auto *GI = GlobalIFunc::create(I.getValueType(), I.getAddressSpace(),
+                                   I.getLinkage(), I.getName(), nullptr,
+                                   New.get());
+    GI->copyAttributesFrom(&I);
+    VMap[&I] = GI;
+  }
+
   // Now that all of the things that global variable initializer can refer to
   // have been created, loop through and copy the global variable referrers
   // over...  We also set the attributes on the global now.
@@ -180,6 +196,15 @@ std::unique_ptr<Module> llvm::CloneModule(
       GA->setAliasee(MapValue(C, VMap));
   }
 
+  // And ifuncs
+  for (const GlobalIFunc &I : M.ifuncs()) {
+    if (!ShouldCloneDefinition(&I))
+      continue;
+    GlobalIFunc *GI = cast<GlobalIFunc>(VMap[&I]);
+    if (const Constant *Resolver = I.getResolver())
+      GI->setResolver(MapValue(Resolver, VMap));
+  }
+
   // And named metadata....
   for (Module::const_named_metadata_iterator I = M.named_metadata_begin(),
                                              E = M.named_metadata_end();
@@ -91,10 +91,25 @@ static void addAllGlobalValueUsers(ClusterMapType &GVtoClusterMap,
   }
 }
 
+// Returns an estimate of the cost of code generation for GV. Codegen time is
+// roughly linear in the number of instructions, and emitting a global
+// variable is cheap compared to any function.
+static uint64_t getWeight(const GlobalValue &GV) {
+  const auto *F = dyn_cast<Function>(&GV);
+  if (!F)
+    return 1;
+  uint64_t Weight = 1;
+  for (const BasicBlock &BB : *F)
+    Weight += BB.size();
+  return Weight;
+}
+
 // Find partitions for module in the way that no locals need to be
 // globalized.
 // Try to balance pack those partitions into N files since this roughly equals
-// thread balancing for the backend codegen step.
+// thread balancing for the backend codegen step. Each cluster of globals that
+// must stay together is weighted by its estimated codegen cost, and clusters
+// are assigned, heaviest first, to the partition with the least weight so far.
 static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
                            unsigned N) {
   // At this point module should have the proper mix of globals and locals.
@@ -142,43 +157,52 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
 
     if (GV.hasLocalLinkage())
       addAllGlobalValueUsers(GVtoClusterMap, &GV, &GV);
+
+    // Make sure that every definition is in some cluster, so that all of
+    // them are assigned to partitions by weight.
+    GVtoClusterMap.insert(&GV);
   };
 
   llvm::for_each(M->functions(), recordGVSet);
   llvm::for_each(M->globals(), recordGVSet);
   llvm::for_each(M->aliases(), recordGVSet);
-
-  // Assigned all GVs to merged clusters while balancing number of objects in
-  // each.
-  auto CompareClusters = [](const std::pair<unsigned, unsigned> &a,
-                            const std::pair<unsigned, unsigned> &b) {
-    if (a.second || b.second)
+  llvm::for_each(M->ifuncs(), recordGVSet);
+
+  // Assigned all GVs to merged clusters while balancing the total weight of
+  // each. The queue yields the partition with the least weight, and among
+  // those the one with the smallest ID.
+  auto CompareClusters = [](const std::pair<unsigned, uint64_t> &a,
+                            const std::pair<unsigned, uint64_t> &b) {
+    if (a.second != b.second)
       return a.second > b.second;
-    else
-      return a.first > b.first;
+    return a.first > b.first;
   };
 
-  std::priority_queue<std::pair<unsigned, unsigned>,
-                      std::vector<std::pair<unsigned, unsigned>>,
+  std::priority_queue<std::pair<unsigned, uint64_t>,
+                      std::vector<std::pair<unsigned, uint64_t>>,
                       decltype(CompareClusters)>
       BalancinQueue(CompareClusters);
   // Pre-populate priority queue with N slot blanks.
   for (unsigned i = 0; i < N; ++i)
     BalancinQueue.push(std::make_pair(i, 0));
 
-  using SortType = std::pair<unsigned, ClusterMapType::iterator>;
+  using SortType = std::pair<uint64_t, ClusterMapType::iterator>;
 
   SmallVector<SortType, 64> Sets;
   SmallPtrSet<const GlobalValue *, 32> Visited;
 
-  // To guarantee determinism, we have to sort SCC according to size.
-  // When size is the same, use leader's name.
+  // To guarantee determinism, we have to sort SCC according to weight.
+  // When weight is the same, use leader's name.
   for (ClusterMapType::iterator I = GVtoClusterMap.begin(),
-                                E = GVtoClusterMap.end(); I != E; ++I)
-    if (I->isLeader())
-      Sets.push_back(
-          std::make_pair(std::distance(GVtoClusterMap.member_begin(I),
-                                       GVtoClusterMap.member_end()), I));
+                                E = GVtoClusterMap.end(); I != E; ++I) {
+    if (!I->isLeader())
+      continue;
+    uint64_t Weight = 0;
+    for (ClusterMapType::member_iterator MI = GVtoClusterMap.member_begin(I);
+         MI != GVtoClusterMap.member_end(); ++MI)
+      Weight += getWeight(**MI);
+    Sets.push_back(std::make_pair(Weight, I));
+  }
 
   llvm::sort(Sets, [](const SortType &a, const SortType &b) {
     if (a.first == b.first)
@@ -189,10 +213,10 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
 
   for (auto &I : Sets) {
     unsigned CurrentClusterID = BalancinQueue.top().first;
-    unsigned CurrentClusterSize = BalancinQueue.top().second;
+    uint64_t CurrentClusterWeight = BalancinQueue.top().second;
     BalancinQueue.pop();
 
-    LLVM_DEBUG(dbgs() << "Root[" << CurrentClusterID << "] cluster_size("
+    LLVM_DEBUG(dbgs() << "Root[" << CurrentClusterID << "] cluster_weight("
                       << I.first << ") ----> " << I.second->getData()->getName()
                       << "\n");
 
@@ -205,11 +229,19 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
                         << ((*MI)->hasLocalLinkage() ? " l " : " e ") << "\n");
       Visited.insert(*MI);
       ClusterIDMap[*MI] = CurrentClusterID;
-      CurrentClusterSize++;
     }
-    // Add this set size to the number of entries in this cluster.
-    BalancinQueue.push(std::make_pair(CurrentClusterID, CurrentClusterSize));
+    // Add this set weight to the weight of this partition.
+    BalancinQueue.push(
+        std::make_pair(CurrentClusterID, CurrentClusterWeight + I.first));
   }
+
+  LLVM_DEBUG({
+    std::vector<uint64_t> Weights(N);
+    for (; !BalancinQueue.empty(); BalancinQueue.pop())
+      Weights[BalancinQueue.top().first] = BalancinQueue.top().second;
+    for (unsigned I = 0; I < N; ++I)
+      dbgs() << "Partition " << I << " weight " << Weights[I] << "\n";
+  });
 }
 
 static void externalize(GlobalValue *GV) {
@@ -227,8 +227,9 @@ public:
       : OrigLoop(L), LI(LI), TLI(TLI), TTI(TTI), Legal(Legal), CM(CM) {}
 
   /// Plan how to best vectorize, return the best VF and its cost, or None if
-  /// vectorization and interleaving should be avoided up front.
-  Optional<VectorizationFactor> plan(unsigned UserVF);
+  /// vectorization and interleaving should be avoided up front. A non-zero
+  /// \p MaxVFLimit bounds the VFs considered by the cost model.
+  Optional<VectorizationFactor> plan(unsigned UserVF, unsigned MaxVFLimit = 0);
 
   /// Use the VPlan-native path to plan how to best vectorize, return the best
   /// VF and its cost.
@@ -265,6 +266,21 @@ protected:
   void buildVPlans(unsigned MinVF, unsigned MaxVF);
 
 private:
+  /// Choose the VF of an outer loop in the VPlan-native path by comparing the
+  /// expected cost per scalar iteration of every power-of-2 VF up to the
+  /// widest one the target's vector registers allow, and build the VPlan of
+  /// the chosen VF. \return Disabled if the scalar loop nest is cheapest.
+  VectorizationFactor selectOuterLoopVF();
+
+  /// \return the expected cost of one iteration of the outer loop, including
+  /// its inner loops, when every instruction in it is widened to \p VF as the
+  /// VPlan-native path does. A \p VF of 1 gives the cost of the scalar loop.
+  unsigned getOuterLoopCost(unsigned VF);
+
+  /// \return the expected cost of \p I when widened to \p VF in the
+  /// VPlan-native path.
+  unsigned getOuterLoopInstructionCost(Instruction *I, unsigned VF);
+
   /// Build a VPlan according to the information gathered by Legal. \return a
   /// VPlan for vectorization factors \p Range.Start and up to \p Range.End
   /// exclusive, possibly decreasing \p Range.End.
@@ -168,6 +168,7 @@ static const char *const LLVMLoopVectorizeFollowupEpilogue =
 
 STATISTIC(LoopsVectorized, "Number of loops vectorized");
 STATISTIC(LoopsAnalyzed, "Number of loops analyzed for vectorization");
+STATISTIC(LoopsEpilogueVectorized, "Number of epilogue loops vectorized");
 
 /// Loops with a known constant trip count below this number are vectorized only
 /// if no scalar iteration overheads are incurred.
@@ -185,6 +186,20 @@ static cl::opt<bool> PreferPredicateOverEpilog(
     cl::desc("Indicate that an epilogue is undesired, predication should be "
              "used instead."));
 
+// After a loop is vectorized with a wide VF, its scalar remainder may run for
+// up to VF * IC - 1 iterations. With this switch, the remainder is vectorized
+// again with a narrower VF chosen by the cost model, leaving only the last
+// few iterations to the scalar loop.
+static cl::opt<bool> EnableEpilogueVectorization(
+    "enable-epilogue-vectorization", cl::init(false), cl::Hidden,
+    cl::desc("Vectorize the scalar remainder of vectorized loops with a "
+             "narrower VF."));
+
+static cl::opt<unsigned> EpilogueVectorizationMinVF(
+    "epilogue-vectorization-min-vf", cl::init(16), cl::Hidden,
+    cl::desc("Only vectorize the remainder of loops whose vector loop uses "
+             "at least this VF."));
+
 static cl::opt<bool> MaximizeBandwidth(
     "vectorizer-maximize-bandwidth", cl::init(false), cl::Hidden,
     cl::desc("Maximize bandwidth when selecting vectorization factor which "
@@ -286,6 +301,12 @@ static cl::opt<bool> VPlanBuildStressTest(
         "out right after the build (stress test the VPlan H-CFG construction "
         "in the VPlan-native vectorization path)."));
 
+static cl::opt<bool> VPlanNativeCostModel(
+    "vplan-native-cost-model", cl::init(false), cl::Hidden,
+    cl::desc("Choose the VF of outer loops in the VPlan-native path by "
+             "comparing the expected cost of each candidate VF instead of "
+             "deriving it from the widest type in the loop nest."));
+
 cl::opt<bool> llvm::EnableLoopInterleaving(
     "interleave-loops", cl::init(true), cl::Hidden,
     cl::desc("Enable loop interleaving in Loop vectorization passes"));
@@ -6277,6 +6298,9 @@ LoopVectorizationPlanner::planInVPlanNativePath(unsigned UserVF) {
   if (!OrigLoop->empty()) {
     // If the user doesn't provide a vectorization factor, determine a
     // reasonable one.
+    if (!UserVF && VPlanNativeCostModel && !VPlanBuildStressTest)
+      return selectOuterLoopVF();
+
     if (!UserVF) {
       VF = determineVPlanVF(TTI->getRegisterBitWidth(true /* Vector*/), CM);
       LLVM_DEBUG(dbgs() << "LV: VPlan computed VF " << VF << ".\n");
@@ -6307,7 +6331,120 @@ LoopVectorizationPlanner::planInVPlanNativePath(unsigned UserVF) {
   return VectorizationFactor::Disabled();
 }
 
-Optional<VectorizationFactor> LoopVectorizationPlanner::plan(unsigned UserVF) {
+unsigned
+LoopVectorizationPlanner::getOuterLoopInstructionCost(Instruction *I,
+                                                      unsigned VF) {
+  // Control flow stays uniform in the VPlan-native path, and induction and
+  // address computations are folded into the widened users.
+  if (isa<BranchInst>(I) || isa<PHINode>(I) || isa<GetElementPtrInst>(I))
+    return 0;
+
+  auto getScalarCost = [&](Instruction *I) -> unsigned {
+    int Cost =
+        TTI->getInstructionCost(I, TargetTransformInfo::TCK_RecipThroughput);
+    return Cost < 0 ? 0 : Cost;
+  };
+  if (VF == 1)
+    return getScalarCost(I);
+
+  Type *VectorTy = ToVectorTy(I->getType(), VF);
+  unsigned Opcode = I->getOpcode();
+  switch (Opcode) {
+  case Instruction::Load:
+  case Instruction::Store: {
+    // The VPlan-native path emits every memory access as a gather or scatter.
+    Type *ValTy = getMemInstValueType(I);
+    Type *VectorValTy = ToVectorTy(ValTy, VF);
+    bool IsLoad = isa<LoadInst>(I);
+    if (IsLoad ? !TTI->isLegalMaskedGather(ValTy)
+               : !TTI->isLegalMaskedScatter(ValTy)) {
+      // Gathers and scatters the target doesn't support are scalarized.
+      Type *PtrTy = ToVectorTy(getLoadStorePointerOperand(I)->getType(), VF);
+      return VF * getScalarCost(I) +
+             TTI->getScalarizationOverhead(VectorValTy, IsLoad, !IsLoad) +
+             TTI->getScalarizationOverhead(PtrTy, false, true);
+    }
+    unsigned Alignment = getLoadStoreAlignment(I);
+    if (!Alignment)
+      Alignment = I->getModule()->getDataLayout().getABITypeAlignment(ValTy);
+    return TTI->getGatherScatterOpCost(Opcode, VectorValTy,
+                                       getLoadStorePointerOperand(I),
+                                       /*VariableMask=*/false, Alignment);
+  }
+  case Instruction::ICmp:
+  case Instruction::FCmp:
+    return TTI->getCmpSelInstrCost(
+        Opcode, ToVectorTy(I->getOperand(0)->getType(), VF), nullptr, I);
+  case Instruction::Select:
+    return TTI->getCmpSelInstrCost(
+        Opcode, VectorTy, ToVectorTy(I->getOperand(0)->getType(), VF), I);
+  default:
+    break;
+  }
+
+  if (isa<BinaryOperator>(I))
+    return TTI->getArithmeticInstrCost(Opcode, VectorTy);
+  if (isa<CastInst>(I))
+    return TTI->getCastInstrCost(
+        Opcode, VectorTy, ToVectorTy(I->getOperand(0)->getType(), VF), I);
+
+  // Everything else is replicated per lane.
+  return VF * getScalarCost(I);
+}
+
+unsigned LoopVectorizationPlanner::getOuterLoopCost(unsigned VF) {
+  unsigned Cost = 0;
+  for (BasicBlock *BB : OrigLoop->blocks())
+    for (Instruction &I : BB->instructionsWithoutDebug())
+      Cost += getOuterLoopInstructionCost(&I, VF);
+  return Cost;
+}
+
+VectorizationFactor LoopVectorizationPlanner::selectOuterLoopVF() {
+  unsigned SmallestType;
+  std::tie(SmallestType, std::ignore) = CM.getSmallestAndWidestTypes();
+  unsigned MaxVF = TTI->getRegisterBitWidth(true /* Vector*/) / SmallestType;
+  if (MaxVF < 2) {
+    LLVM_DEBUG(dbgs() << "LV: Not vectorizing outer loop: the widest legal "
+                         "VF is 1.\n");
+    return VectorizationFactor::Disabled();
+  }
+  MaxVF = PowerOf2Floor(MaxVF);
+
+  // Like selectVectorizationFactor, compare the cost per scalar iteration.
+  const float ScalarCost = getOuterLoopCost(1);
+  LLVM_DEBUG(dbgs() << "LV: Scalar outer loop costs: " << (int)ScalarCost
+                    << ".\n");
+  float Cost = ScalarCost;
+  unsigned Width = 1;
+  // Ignore the scalar loop when the user explicitly wants vectorization.
+  if (CM.Hints->getForce() == LoopVectorizeHints::FK_Enabled)
+    Cost = std::numeric_limits<float>::max();
+
+  for (unsigned VF = 2; VF <= MaxVF; VF *= 2) {
+    float VectorCost = getOuterLoopCost(VF) / (float)VF;
+    LLVM_DEBUG(dbgs() << "LV: Vector outer loop of width " << VF
+                      << " costs: " << (int)VectorCost << ".\n");
+    if (VectorCost < Cost) {
+      Cost = VectorCost;
+      Width = VF;
+    }
+  }
+
+  if (Width == 1) {
+    LLVM_DEBUG(dbgs() << "LV: Not vectorizing outer loop: vectorization is "
+                         "not beneficial.\n");
+    return VectorizationFactor::Disabled();
+  }
+
+  LLVM_DEBUG(dbgs() << "LV: Selecting VF " << Width
+                    << " for the outer loop.\n");
+  buildVPlans(Width, Width);
+  return {Width, (unsigned)(Width * Cost)};
+}
+
+Optional<VectorizationFactor>
+LoopVectorizationPlanner::plan(unsigned UserVF, unsigned MaxVFLimit) {
   assert(OrigLoop->empty() && "Inner loop expected.");
   Optional<unsigned> MaybeMaxVF = CM.computeMaxVF();
   if (!MaybeMaxVF) // Cases that should not to be vectorized nor interleaved.
@@ -6335,6 +6472,8 @@ Optional<VectorizationFactor> LoopVectorizationPlanner::plan(unsigned UserVF) {
   }
 
   unsigned MaxVF = MaybeMaxVF.getValue();
+  if (MaxVFLimit)
+    MaxVF = std::min(MaxVF, MaxVFLimit);
   assert(MaxVF != 0 && "MaxVF is zero.");
 
   for (unsigned VF = 1; VF <= MaxVF; VF *= 2) {
@@ -7344,9 +7483,30 @@ static bool processLoopInVPlanNativePath(
   // If we are stress testing VPlan builds, do not attempt to generate vector
   // code. Masked vector code generation support will follow soon.
   // Also, do not attempt to vectorize if no vector code will be produced.
-  if (VPlanBuildStressTest || EnableVPlanPredication ||
-      VectorizationFactor::Disabled() == VF)
+  if (VPlanBuildStressTest || EnableVPlanPredication)
+    return false;
+
+  if (VectorizationFactor::Disabled() == VF) {
+    if (!UserVF && VPlanNativeCostModel)
+      ORE->emit([&]() {
+        return OptimizationRemarkAnalysis(Hints.vectorizeAnalysisPassName(),
+                                          "OuterLoopNotBeneficial",
+                                          L->getStartLoc(), L->getHeader())
+               << "outer loop not vectorized: the cost-model indicates that "
+                  "no VF is cheaper per iteration than the scalar loop nest";
+      });
     return false;
+  }
+
+  if (!UserVF && VPlanNativeCostModel)
+    ORE->emit([&]() {
+      return OptimizationRemarkAnalysis(LV_NAME, "OuterLoopVF",
+                                        L->getStartLoc(), L->getHeader())
+             << "outer loop vectorization width "
+             << ore::NV("VectorizationFactor", VF.Width)
+             << " chosen by the cost-model (cost per vector iteration: "
+             << ore::NV("Cost", VF.Cost) << ")";
+    });
 
   LVP.setBestPlan(VF.Width, 1);
 
@@ -7363,7 +7523,7 @@ static bool processLoopInVPlanNativePath(
   return true;
 }
 
-bool LoopVectorizePass::processLoop(Loop *L) {
+bool LoopVectorizePass::processLoop(Loop *L, unsigned EpilogueMaxVF) {
   assert((EnableVPlanNativePath || L->empty()) &&
          "VPlan-native path is not enabled. Only process inner loops.");
 
@@ -7406,10 +7566,20 @@ bool LoopVectorizePass::processLoop(Loop *L) {
 
   PredicatedScalarEvolution PSE(*SE, *L);
 
+  // The cached access info of an epilogue loop describes the loop before it was
+  // vectorized, with a different start for its induction variables.
+  std::unique_ptr<LoopAccessInfo> EpilogueLAI;
+  std::function<const LoopAccessInfo &(Loop &)> GetEpilogueLAA =
+      [&](Loop &L) -> const LoopAccessInfo & {
+    EpilogueLAI = std::make_unique<LoopAccessInfo>(&L, SE, TLI, AA, DT, LI);
+    return *EpilogueLAI;
+  };
+
   // Check if it is legal to vectorize the loop.
   LoopVectorizationRequirements Requirements(*ORE);
-  LoopVectorizationLegality LVL(L, PSE, DT, TTI, TLI, AA, F, GetLAA, LI, ORE,
-                                &Requirements, &Hints, DB, AC);
+  LoopVectorizationLegality LVL(L, PSE, DT, TTI, TLI, AA, F,
+                                EpilogueMaxVF ? &GetEpilogueLAA : GetLAA, LI,
+                                ORE, &Requirements, &Hints, DB, AC);
   if (!LVL.canVectorize(EnableVPlanNativePath)) {
     LLVM_DEBUG(dbgs() << "LV: Not vectorizing: Cannot prove legality.\n");
     Hints.emitRemarkWithHints();
@@ -7522,7 +7692,7 @@ bool LoopVectorizePass::processLoop(Loop *L) {
   unsigned UserVF = Hints.getWidth();
 
   // Plan how to best vectorize, return the best VF and its cost.
-  Optional<VectorizationFactor> MaybeVF = LVP.plan(UserVF);
+  Optional<VectorizationFactor> MaybeVF = LVP.plan(UserVF, EpilogueMaxVF);
 
   VectorizationFactor VF = VectorizationFactor::Disabled();
   unsigned IC = 1;
@@ -7534,6 +7704,19 @@ bool LoopVectorizePass::processLoop(Loop *L) {
     IC = CM.selectInterleaveCount(VF.Width, VF.Cost);
   }
 
+  // An epilogue loop runs for fewer iterations than one iteration of the
+  // vector loop before it, so it is neither interleaved nor worth reporting if
+  // it stays scalar.
+  if (EpilogueMaxVF) {
+    IC = 1;
+    UserIC = 0;
+    if (VF.Width == 1) {
+      LLVM_DEBUG(dbgs() << "LV: Not vectorizing the epilogue loop: not "
+                           "beneficial.\n");
+      return false;
+    }
+  }
+
   // Identify the diagnostic messages that should be produced.
   std::pair<StringRef, std::string> VecDiagMsg, IntDiagMsg;
   bool VectorizeLoop = true, InterleaveLoop = true;
@@ -7649,6 +7832,8 @@ bool LoopVectorizePass::processLoop(Loop *L) {
                            &LVL, &CM);
     LVP.executePlan(LB, DT);
     ++LoopsVectorized;
+    if (EpilogueMaxVF)
+      ++LoopsEpilogueVectorized;
 
     // Add metadata to disable runtime unrolling a scalar loop when there are
     // no runtime checks about strides and memory. A scalar loop that is
@@ -7660,7 +7845,8 @@ bool LoopVectorizePass::processLoop(Loop *L) {
     ORE->emit([&]() {
       return OptimizationRemark(LV_NAME, "Vectorized", L->getStartLoc(),
                                 L->getHeader())
-             << "vectorized loop (vectorization width: "
+             << (EpilogueMaxVF ? "vectorized epilogue loop" : "vectorized loop")
+             << " (vectorization width: "
              << NV("VectorizationFactor", VF.Width)
              << ", interleaved count: " << NV("InterleaveCount", IC) << ")";
     });
@@ -7675,8 +7861,20 @@ bool LoopVectorizePass::processLoop(Loop *L) {
     if (DisableRuntimeUnroll)
       AddRuntimeUnrollDisableMetaData(L);
 
-    // Mark the loop as already vectorized to avoid vectorizing again.
-    Hints.setAlreadyVectorized();
+    // Leave the remainder of a wide vector loop unmarked if it may run for
+    // enough iterations to be vectorized again; runImpl revisits it.
+    unsigned Step = VF.Width * IC;
+    if (EnableEpilogueVectorization && VectorizeLoop && !EpilogueMaxVF &&
+        !UserVF && !CM.foldTailByMasking() &&
+        VF.Width >= std::max(EpilogueVectorizationMinVF.getValue(), 4U) &&
+        (!HasExpectedTC || ExpectedTC % Step >= 2)) {
+      LLVM_DEBUG(dbgs() << "LV: Vectorizing the epilogue with VF at most "
+                        << VF.Width / 2 << ".\n");
+      NextEpilogueMaxVF = VF.Width / 2;
+    } else {
+      // Mark the loop as already vectorized to avoid vectorizing again.
+      Hints.setAlreadyVectorized();
+    }
   }
 
   LLVM_DEBUG(verifyFunction(*L->getHeader()->getParent()));
@@ -7741,7 +7939,20 @@ bool LoopVectorizePass::runImpl(
     // transform.
     Changed |= formLCSSARecursively(*L, *DT, LI, SE);
 
+    NextEpilogueMaxVF = 0;
     Changed |= processLoop(L);
+
+    // Vectorize the scalar remainder of L with a narrower VF. Its exit block is
+    // now shared with the middle block of the vector loop, so put it back in
+    // simplified and LCSSA form first.
+    if (unsigned EpilogueMaxVF = NextEpilogueMaxVF) {
+      NextEpilogueMaxVF = 0;
+      simplifyLoop(L, DT, LI, SE, AC, nullptr, true /* PreserveLCSSA */);
+      formLCSSARecursively(*L, *DT, LI, SE);
+      processLoop(L, EpilogueMaxVF);
+      LoopVectorizeHints(L, InterleaveOnlyWhenForced, *ORE)
+          .setAlreadyVectorized();
+    }
   }
 
   // Process each loop nest in the function.
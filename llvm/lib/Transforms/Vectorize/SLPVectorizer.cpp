@@ -147,6 +147,11 @@ static cl::opt<unsigned> MinTreeSize(
     "slp-min-tree-size", cl::init(3), cl::Hidden,
     cl::desc("Only vectorize small trees if they are fully vectorizable"));
 
+static cl::opt<unsigned> MinReductionValues(
+    "slp-min-reduction-values", cl::init(3), cl::Hidden,
+    cl::desc("Only try to vectorize horizontal reductions of at least this "
+             "many values"));
+
 static cl::opt<bool>
     ViewSLPTree("view-slp-tree", cl::Hidden,
                 cl::desc("Display the SLP trees with Graphviz"));
@@ -6108,30 +6113,32 @@ class HorizontalReduction {
         // %4 = extractelement <2 x i32> %a, i32 1
         // %select = select i1 %cond, i32 %3, i32 %4
         CmpInst::Predicate Pred;
-        Instruction *L1;
-        Instruction *L2;
+        Value *CmpLHS;
+        Value *CmpRHS;
 
         LHS = Select->getTrueValue();
         RHS = Select->getFalseValue();
         Value *Cond = Select->getCondition();
+        if (!match(Cond, m_Cmp(Pred, m_Value(CmpLHS), m_Value(CmpRHS))))
+          return OperationData(V);
+
+        // A compare operand matches a select operand if it is the same value
+        // or an identical extractelement.
+        auto IsSameValue = [](Value *CmpOp, Value *SelOp) {
+          if (CmpOp == SelOp)
+            return true;
+          auto *CmpI = dyn_cast<Instruction>(CmpOp);
+          return CmpI && isa<ExtractElementInst>(SelOp) &&
+                 CmpI->isIdenticalTo(cast<Instruction>(SelOp));
+        };
+        // select ((cmp Inst2, Inst1), Inst1, Inst2) is the same min/max with
+        // the swapped predicate.
+        if (IsSameValue(CmpRHS, LHS) && IsSameValue(CmpLHS, RHS) &&
+            !(IsSameValue(CmpLHS, LHS) && IsSameValue(CmpRHS, RHS)))
+          Pred = CmpInst::getSwappedPredicate(Pred);
+        else if (!IsSameValue(CmpLHS, LHS) || !IsSameValue(CmpRHS, RHS))
+          return OperationData(V);
 
-        // TODO: Support inverse predicates.
-        if (match(Cond, m_Cmp(Pred, m_Specific(LHS), m_Instruction(L2)))) {
-          if (!isa<ExtractElementInst>(RHS) ||
-              !L2->isIdenticalTo(cast<Instruction>(RHS)))
-            return OperationData(V);
-        } else if (match(Cond, m_Cmp(Pred, m_Instruction(L1), m_Specific(RHS)))) {
-          if (!isa<ExtractElementInst>(LHS) ||
-              !L1->isIdenticalTo(cast<Instruction>(LHS)))
-            return OperationData(V);
-        } else {
-          if (!isa<ExtractElementInst>(LHS) || !isa<ExtractElementInst>(RHS))
-            return OperationData(V);
-          if (!match(Cond, m_Cmp(Pred, m_Instruction(L1), m_Instruction(L2))) ||
-              !L1->isIdenticalTo(cast<Instruction>(LHS)) ||
-              !L2->isIdenticalTo(cast<Instruction>(RHS)))
-            return OperationData(V);
-        }
         switch (Pred) {
         default:
           return OperationData(V);
@@ -6311,8 +6318,11 @@ public:
     // If there is a sufficient number of reduction values, reduce
     // to a nearby power-of-2. Can safely generate oversized
     // vectors and rely on the backend to split them to legal sizes.
+    // Odd-sized reductions, e.g. of 3 or 6 values, are reduced as a sequence
+    // of power-of-2 chunks down to a width of 2, and the values left over are
+    // added to the result in scalar form.
     unsigned NumReducedVals = ReducedVals.size();
-    if (NumReducedVals < 4)
+    if (NumReducedVals < std::max(MinReductionValues.getValue(), 3U))
       return false;
 
     unsigned ReduxWidth = PowerOf2Floor(NumReducedVals);
@@ -6340,7 +6350,7 @@ public:
     SmallVector<Value *, 16> IgnoreList;
     for (auto &V : ReductionOps)
       IgnoreList.append(V.begin(), V.end());
-    while (i < NumReducedVals - ReduxWidth + 1 && ReduxWidth > 2) {
+    while (i < NumReducedVals - ReduxWidth + 1 && ReduxWidth >= 2) {
       auto VL = makeArrayRef(&ReducedVals[i], ReduxWidth);
       V.buildTree(VL, ExternallyUsedValues, IgnoreList);
       Optional<ArrayRef<unsigned>> Order = V.bestOrder();
@@ -14,6 +14,8 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/XRay/BlockIndexer.h"
 #include "llvm/XRay/BlockVerifier.h"
 #include "llvm/XRay/FDRRecordConsumer.h"
@@ -22,7 +24,9 @@
 #include "llvm/XRay/FDRTraceExpander.h"
 #include "llvm/XRay/FileHeaderReader.h"
 #include "llvm/XRay/YAMLXRayRecord.h"
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 using namespace llvm;
@@ -30,6 +34,30 @@ using namespace llvm::xray;
 using llvm::yaml::Input;
 
 namespace {
+// Keeps the error of the first failing task, in task order, out of tasks that
+// run in parallel, so that the error does not depend on the scheduling.
+class FirstError {
+  std::mutex Mutex;
+  size_t Index = std::numeric_limits<size_t>::max();
+  Error Err = Error::success();
+
+public:
+  void report(size_t I, Error E) {
+    if (!E)
+      return;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (I < Index) {
+      consumeError(std::move(Err));
+      Err = std::move(E);
+      Index = I;
+    } else {
+      consumeError(std::move(E));
+    }
+  }
+
+  Error take() { return std::move(Err); }
+};
+
 using XRayRecordStorage =
     std::aligned_storage<sizeof(XRayRecord), alignof(XRayRecord)>::type;
 
@@ -264,9 +292,23 @@ Error loadNaiveFormatLog(StringRef Data, bool IsLittleEndian,
 /// what FunctionRecord instances use, and we no longer need to include the CPU
 /// id in the CustomEventRecord.
 ///
-Error loadFDRLog(StringRef Data, bool IsLittleEndian,
-                 XRayFileHeader &FileHeader, std::vector<XRayRecord> &Records) {
-
+// The bytes of one block of an FDR log: a NewBuffer record and the records
+// after it, up to the next NewBuffer record. Blocks are read again from the
+// file when their thread is expanded, so only their extents are kept when the
+// log is indexed.
+struct FDRBlockRange {
+  uint64_t Begin;
+  uint64_t End;
+  // The number of bytes left in the buffer at Begin, for the record producer.
+  uint32_t BufferBytes;
+};
+
+// Reads the records of an FDR log one at a time, and indexes the extents of
+// their blocks by process+thread pair into Threads, in the order BlockIndexer
+// would index the records themselves.
+Error indexFDRLog(StringRef Data, bool IsLittleEndian,
+                  XRayFileHeader &FileHeader,
+                  std::vector<std::vector<FDRBlockRange>> &Threads) {
   if (Data.size() < 32)
     return createStringError(std::make_error_code(std::errc::invalid_argument),
                              "Not enough bytes for an XRay FDR log.");
@@ -278,22 +320,89 @@ Error loadFDRLog(StringRef Data, bool IsLittleEndian,
     return FileHeaderOrError.takeError();
   FileHeader = std::move(FileHeaderOrError.get());
 
-  // First we load the records into memory.
-  std::vector<std::unique_ptr<Record>> FDRRecords;
+  // Like BlockIndexer, a NewBuffer record starts a new block unless the
+  // current one is still empty, and buffer extents are not part of any block.
+  DenseMap<std::pair<uint64_t, int32_t>, std::vector<FDRBlockRange>> Index;
+  FDRBlockRange Block{OffsetPtr, 0, 0};
+  std::pair<uint64_t, int32_t> Key{0, 0};
+  bool BlockIsEmpty = true;
+  FileBasedRecordProducer P(FileHeader, DE, OffsetPtr);
+  while (DE.isValidOffsetForDataOfSize(OffsetPtr, 1)) {
+    uint64_t Begin = OffsetPtr;
+    uint32_t BufferBytes = P.currentBufferBytes();
+    auto R = P.produce();
+    if (!R)
+      return R.takeError();
+    if (isa<BufferExtents>(R->get()))
+      continue;
+    if (auto *NB = dyn_cast<NewBufferRecord>(R->get())) {
+      if (!BlockIsEmpty) {
+        Block.End = Begin;
+        Index[Key].push_back(Block);
+        Block = {Begin, 0, BufferBytes};
+        Key = {0, 0};
+      }
+      Key.second = NB->tid();
+    } else if (auto *PR = dyn_cast<PIDRecord>(R->get())) {
+      Key.first = PR->pid();
+    }
+    BlockIsEmpty = false;
+  }
+  Block.End = OffsetPtr;
+  Index[Key].push_back(Block);
+
+  Threads.reserve(Index.size());
+  for (auto &PTB : Index)
+    Threads.push_back(std::move(PTB.second));
+  return Error::success();
+}
 
+// This is now the meat of the algorithm. Here we sort the blocks according to
+// the Walltime record in each of the blocks for the same thread. This allows
+// us to more consistently recreate the execution trace in temporal order.
+// After the sort, we then reconstitute `Trace` records using a stateful
+// visitor associated with a single process+thread pair.
+Error expandThreadBlocks(std::vector<BlockIndexer::Block> &Blocks,
+                         uint16_t Version, std::vector<XRayRecord> &Records) {
+  llvm::sort(Blocks, [](const BlockIndexer::Block &L,
+                        const BlockIndexer::Block &R) {
+    return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
+            L.WallclockTime->nanos() < R.WallclockTime->nanos());
+  });
+  auto Adder = [&](const XRayRecord &R) { Records.push_back(R); };
+  TraceExpander Expander(Adder, Version);
+  for (auto &B : Blocks) {
+    for (auto *R : B.Records)
+      if (auto E = R->apply(Expander))
+        return E;
+  }
+  return Expander.flush();
+}
+
+// Reads the blocks of one process+thread pair back from the log, checks that
+// every block is well formed, and expands them into Records. The records read
+// from the log are released when this returns.
+Error loadFDRThread(StringRef Data, bool IsLittleEndian,
+                    const XRayFileHeader &FileHeader,
+                    ArrayRef<FDRBlockRange> Ranges,
+                    std::vector<XRayRecord> &Records) {
+  DataExtractor DE(Data, IsLittleEndian, 8);
+  std::vector<std::unique_ptr<Record>> FDRRecords;
   {
-    FileBasedRecordProducer P(FileHeader, DE, OffsetPtr);
     LogBuilderConsumer C(FDRRecords);
-    while (DE.isValidOffsetForDataOfSize(OffsetPtr, 1)) {
-      auto R = P.produce();
-      if (!R)
-        return R.takeError();
-      if (auto E = C.consume(std::move(R.get())))
-        return E;
+    for (const FDRBlockRange &Range : Ranges) {
+      uint64_t OffsetPtr = Range.Begin;
+      FileBasedRecordProducer P(FileHeader, DE, OffsetPtr, Range.BufferBytes);
+      while (OffsetPtr < Range.End) {
+        auto R = P.produce();
+        if (!R)
+          return R.takeError();
+        if (auto E = C.consume(std::move(R.get())))
+          return E;
+      }
     }
   }
 
-  // Next we index the records into blocks.
   BlockIndexer::Index Index;
   {
     BlockIndexer Indexer(Index);
@@ -304,46 +413,56 @@ Error loadFDRLog(StringRef Data, bool IsLittleEndian,
       return E;
   }
 
-  // Then we verify the consistency of the blocks.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      for (auto &B : Blocks) {
-        BlockVerifier Verifier;
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Verifier))
-            return E;
-        if (auto E = Verifier.verify())
-          return E;
-      }
-    }
-  }
+  std::vector<BlockIndexer::Block> Blocks;
+  for (auto &PTB : Index)
+    for (auto &B : PTB.second)
+      Blocks.push_back(std::move(B));
 
-  // This is now the meat of the algorithm. Here we sort the blocks according to
-  // the Walltime record in each of the blocks for the same thread. This allows
-  // us to more consistently recreate the execution trace in temporal order.
-  // After the sort, we then reconstitute `Trace` records using a stateful
-  // visitor associated with a single process+thread pair.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      llvm::sort(Blocks, [](const BlockIndexer::Block &L,
-                            const BlockIndexer::Block &R) {
-        return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
-                L.WallclockTime->nanos() < R.WallclockTime->nanos());
-      });
-      auto Adder = [&](const XRayRecord &R) { Records.push_back(R); };
-      TraceExpander Expander(Adder, FileHeader.Version);
-      for (auto &B : Blocks) {
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Expander))
-            return E;
-      }
-      if (auto E = Expander.flush())
+  for (auto &B : Blocks) {
+    BlockVerifier Verifier;
+    for (auto *R : B.Records)
+      if (auto E = R->apply(Verifier))
         return E;
-    }
+    if (auto E = Verifier.verify())
+      return E;
   }
+  return expandThreadBlocks(Blocks, FileHeader.Version, Records);
+}
 
+// Loads the threads in Threads in parallel into one record vector per thread,
+// and reports the first error in thread order.
+Error loadFDRThreads(StringRef Data, bool IsLittleEndian,
+                     const XRayFileHeader &FileHeader,
+                     ArrayRef<std::vector<FDRBlockRange>> Threads,
+                     MutableArrayRef<std::vector<XRayRecord>> Records) {
+  assert(Threads.size() == Records.size());
+  FirstError Err;
+  parallel::for_each_n(parallel::par, size_t(0), Threads.size(), [&](size_t I) {
+    Err.report(I, loadFDRThread(Data, IsLittleEndian, FileHeader, Threads[I],
+                                Records[I]));
+  });
+  return Err.take();
+}
+
+Error loadFDRLog(StringRef Data, bool IsLittleEndian,
+                 XRayFileHeader &FileHeader, std::vector<XRayRecord> &Records) {
+  std::vector<std::vector<FDRBlockRange>> Threads;
+  if (auto E = indexFDRLog(Data, IsLittleEndian, FileHeader, Threads))
+    return E;
+
+  std::vector<std::vector<XRayRecord>> ThreadRecords(Threads.size());
+  if (auto E = loadFDRThreads(Data, IsLittleEndian, FileHeader, Threads,
+                              ThreadRecords))
+    return E;
+
+  size_t NumRecords = 0;
+  for (const auto &TR : ThreadRecords)
+    NumRecords += TR.size();
+  Records.reserve(Records.size() + NumRecords);
+  for (auto &TR : ThreadRecords) {
+    Records.insert(Records.end(), TR.begin(), TR.end());
+    std::vector<XRayRecord>().swap(TR);
+  }
   return Error::success();
 }
 
@@ -377,7 +496,9 @@ Error loadYAMLLog(StringRef Data, XRayFileHeader &FileHeader,
 }
 } // namespace
 
-Expected<Trace> llvm::xray::loadTraceFile(StringRef Filename, bool Sort) {
+// Maps |Filename| into memory, and calls |Fn| with its contents.
+static Error mapTraceFile(StringRef Filename,
+                          function_ref<Error(StringRef)> Fn) {
   Expected<sys::fs::file_t> FdOrErr = sys::fs::openNativeFileForRead(Filename);
   if (!FdOrErr)
     return FdOrErr.takeError();
@@ -403,8 +524,10 @@ Expected<Trace> llvm::xray::loadTraceFile(StringRef Filename, bool Sort) {
     return make_error<StringError>(
         Twine("Cannot read log from '") + Filename + "'", EC);
   }
-  auto Data = StringRef(MappedFile.data(), MappedFile.size());
+  return Fn(StringRef(MappedFile.data(), MappedFile.size()));
+}
 
+static Expected<Trace> loadTraceData(StringRef Data, bool Sort) {
   // TODO: Lift the endianness and implementation selection here.
   DataExtractor LittleEndianDE(Data, true, 8);
   auto TraceOrError = loadTrace(LittleEndianDE, Sort);
@@ -415,6 +538,85 @@ Expected<Trace> llvm::xray::loadTraceFile(StringRef Filename, bool Sort) {
   return TraceOrError;
 }
 
+static void sortByTSC(MutableArrayRef<XRayRecord> Records) {
+  llvm::stable_sort(Records, [&](const XRayRecord &L, const XRayRecord &R) {
+    return L.TSC < R.TSC;
+  });
+}
+
+Expected<Trace> llvm::xray::loadTraceFile(StringRef Filename, bool Sort) {
+  Trace T;
+  if (auto E = mapTraceFile(Filename, [&](StringRef Data) -> Error {
+        auto TraceOrError = loadTraceData(Data, Sort);
+        if (!TraceOrError)
+          return TraceOrError.takeError();
+        T = std::move(*TraceOrError);
+        return Error::success();
+      }))
+    return std::move(E);
+  return std::move(T);
+}
+
+Error llvm::xray::loadTraceFileByThread(StringRef Filename,
+                                        TraceChunkCallback Callback,
+                                        bool Sort) {
+  return mapTraceFile(Filename, [&](StringRef Data) -> Error {
+    DataExtractor HeaderExtractor(Data, true, 8);
+    uint64_t OffsetPtr = 0;
+    uint16_t Version = HeaderExtractor.getU16(&OffsetPtr);
+    uint16_t Type = HeaderExtractor.getU16(&OffsetPtr);
+
+    // Only FDR mode traces are indexed by thread; anything else, including
+    // versions that loadTrace rejects, goes through the whole-trace path.
+    if (Type != 1 || Version < 1 || Version > 5) {
+      auto TraceOrError = loadTraceData(Data, Sort);
+      if (!TraceOrError)
+        return TraceOrError.takeError();
+      const Trace &T = *TraceOrError;
+      if (T.empty())
+        return Error::success();
+      return Callback(T.getFileHeader(), makeArrayRef(&*T.begin(), T.size()));
+    }
+
+    XRayFileHeader FileHeader;
+    bool IsLittleEndian = true;
+    std::vector<std::vector<FDRBlockRange>> Threads;
+    if (auto E = indexFDRLog(Data, IsLittleEndian, FileHeader, Threads)) {
+      consumeError(std::move(E));
+      IsLittleEndian = false;
+      Threads.clear();
+      if (auto E = indexFDRLog(Data, IsLittleEndian, FileHeader, Threads))
+        return E;
+    }
+
+    // Only index the blocks of the log up front, and read the records of a
+    // batch of threads back from the file at a time.
+    const size_t BatchSize =
+        std::max(1u, llvm::heavyweight_hardware_concurrency());
+    std::vector<std::vector<XRayRecord>> Records(BatchSize);
+    for (size_t Begin = 0; Begin < Threads.size(); Begin += BatchSize) {
+      size_t N = std::min(BatchSize, Threads.size() - Begin);
+      MutableArrayRef<std::vector<XRayRecord>> BatchRecords =
+          MutableArrayRef<std::vector<XRayRecord>>(Records).take_front(N);
+      for (auto &R : BatchRecords)
+        R.clear();
+      if (auto E = loadFDRThreads(Data, IsLittleEndian, FileHeader,
+                                  makeArrayRef(Threads).slice(Begin, N),
+                                  BatchRecords))
+        return E;
+      for (auto &R : BatchRecords) {
+        if (R.empty())
+          continue;
+        if (Sort)
+          sortByTSC(R);
+        if (auto E = Callback(FileHeader, R))
+          return E;
+      }
+    }
+    return Error::success();
+  });
+}
+
 Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort) {
   // Attempt to detect the file type using file magic. We have a slight bias
   // towards the binary format, and we do this by making sure that the first 4
@@ -468,9 +670,7 @@ Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort) {
   }
 
   if (Sort)
-    llvm::stable_sort(T.Records, [&](const XRayRecord &L, const XRayRecord &R) {
-      return L.TSC < R.TSC;
-    });
+    sortByTSC(T.Records);
 
   return std::move(T);
 }
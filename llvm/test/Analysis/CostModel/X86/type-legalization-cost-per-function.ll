@@ -0,0 +1,39 @@
+; RUN: opt -cost-model -analyze -mtriple=x86_64-unknown-linux-gnu < %s \
+; RUN:   | FileCheck %s
+
+; The legalization costs of the types are remembered per function, so they are
+; the same for a type queried again, and each function gets those of its own
+; subtarget.
+
+define void @avx2(<16 x i32> %a, <16 x i16> %b) #0 {
+; CHECK-LABEL: 'avx2'
+; CHECK: cost of 2 for instruction: %add1 = add <16 x i32>
+; CHECK: cost of [[EXT:[0-9]+]] for instruction: %ext = sext <16 x i16>
+; CHECK: cost of 2 for instruction: %add2 = add <16 x i32>
+; CHECK: cost of [[EXT]] for instruction: %ext2 = sext <16 x i16>
+  %add1 = add <16 x i32> %a, %a
+  %ext = sext <16 x i16> %b to <16 x i32>
+  %add2 = add <16 x i32> %add1, %ext
+  %ext2 = sext <16 x i16> %b to <16 x i32>
+  ret void
+}
+
+define void @avx512(<16 x i32> %a, <16 x i16> %b) #1 {
+; CHECK-LABEL: 'avx512'
+; CHECK: cost of 1 for instruction: %add1 = add <16 x i32>
+; CHECK: cost of 1 for instruction: %add2 = add <16 x i32>
+  %add1 = add <16 x i32> %a, %a
+  %add2 = add <16 x i32> %add1, %add1
+  ret void
+}
+
+; The first function again, after the second one.
+define void @avx2.again(<16 x i32> %a) #0 {
+; CHECK-LABEL: 'avx2.again'
+; CHECK: cost of 2 for instruction: %add1 = add <16 x i32>
+  %add1 = add <16 x i32> %a, %a
+  ret void
+}
+
+attributes #0 = { "target-features"="+avx2" }
+attributes #1 = { "target-features"="+avx512f" }
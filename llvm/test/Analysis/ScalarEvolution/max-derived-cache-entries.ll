@@ -0,0 +1,40 @@
+; RUN: opt -analyze -scalar-evolution -scev-stats < %s > %t.default 2> %t.stats
+; RUN: FileCheck %s --check-prefixes=STATS,UNLIMITED < %t.stats
+; RUN: opt -analyze -scalar-evolution -scev-stats \
+; RUN:   -scalar-evolution-max-derived-cache-entries=1 < %s > %t.limited \
+; RUN:   2> %t.stats
+; RUN: FileCheck %s --check-prefixes=STATS,LIMITED < %t.stats
+
+; Dropping the memoized ranges and dispositions doesn't change the results.
+; RUN: diff %t.default %t.limited
+
+; STATS:      ScalarEvolution cache stats for function 'f':
+; STATS-NEXT:   SCEV nodes: {{[0-9]+}} ({{[0-9]+}} bytes allocated)
+; STATS-NEXT:   Predicates: {{[0-9]+}}
+; STATS-NEXT:   Value to SCEV entries: {{[0-9]+}}
+; STATS-NEXT:   SCEV to value entries: {{[0-9]+}}
+; STATS-NEXT:   Backedge-taken counts: 1 ({{[0-9]+}} predicated)
+; STATS-NEXT:   Values at scopes: {{[0-9]+}}
+; STATS-NEXT:   Loop dispositions: {{[0-9]+}}
+; STATS-NEXT:   Block dispositions: {{[0-9]+}}
+; STATS-NEXT:   Ranges: {{[0-9]+}} unsigned, {{[0-9]+}} signed
+; STATS-NEXT:   Trailing zeros: {{[0-9]+}}
+; UNLIMITED-NEXT: Derived cache trims: 0
+; LIMITED-NEXT:   Derived cache trims: {{[1-9][0-9]*}}
+
+define i32 @f(i32 %n, i32 %m) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %i.next = add nuw nsw i32 %i, 1
+  %cond = icmp slt i32 %i.next, %n
+  br i1 %cond, label %loop, label %exit
+
+exit:
+  %a = add i32 %m, 7
+  %b = mul i32 %a, 3
+  %r = add i32 %b, %i.next
+  ret i32 %r
+}
@@ -0,0 +1,35 @@
+; REQUIRES: asserts
+; RUN: llc -mtriple=x86_64-unknown-linux -stats < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DAG
+; RUN: llc -mtriple=x86_64-unknown-linux -fast-isel-trivial-blocks -stats \
+; RUN:   < %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=TRIVIAL
+
+; With -fast-isel-trivial-blocks, FastISel selects %then and %exit, which only
+; have simple scalar instructions. The entry block and the block with a call
+; still go through SelectionDAG.
+
+; DAG-NOT: Number of blocks selected entirely by fast isel
+; DAG:     4 isel - Number of blocks selected using DAG
+
+; TRIVIAL-DAG: 2 isel - Number of blocks selected entirely by fast isel
+; TRIVIAL-DAG: 2 isel - Number of blocks selected using DAG
+
+declare i32 @g(i32)
+
+define i32 @f(i32 %x, i32 %y, i1 %c) {
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %a = add i32 %x, %y
+  %b = mul i32 %a, 3
+  br label %exit
+
+else:
+  %v = call i32 @g(i32 %x)
+  br label %exit
+
+exit:
+  %p = phi i32 [ %b, %then ], [ %v, %else ]
+  ret i32 %p
+}
@@ -0,0 +1,31 @@
+; RUN: llc -mtriple=x86_64-unknown-linux -isel-report-expensive-blocks=2 \
+; RUN:   -pass-remarks-analysis=sdagisel < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s
+; RUN: llc -mtriple=x86_64-unknown-linux -pass-remarks-analysis=sdagisel \
+; RUN:   < %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=NONE --allow-empty
+
+; Only the two blocks of @f that took the longest are reported.
+; CHECK-COUNT-2: remark: <unknown>:0:0: selecting block took {{[0-9]+}}us (Build: {{[0-9]+}}us, Combine1: {{[0-9]+}}us, LegalizeTypes: {{[0-9]+}}us, Legalize: {{[0-9]+}}us, Combine2: {{[0-9]+}}us, Select: {{[0-9]+}}us, Schedule: {{[0-9]+}}us)
+; CHECK-NOT:     selecting block took
+
+; NONE-NOT: selecting block took
+
+declare i32 @g(i32)
+
+define i32 @f(i32 %x, i32 %y, i1 %c) {
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %a = add i32 %x, %y
+  %b = mul i32 %a, 3
+  br label %exit
+
+else:
+  %v = call i32 @g(i32 %x)
+  br label %exit
+
+exit:
+  %p = phi i32 [ %b, %then ], [ %v, %else ]
+  ret i32 %p
+}
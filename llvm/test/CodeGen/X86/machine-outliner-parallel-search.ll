@@ -0,0 +1,52 @@
+; RUN: llc -mtriple=x86_64-unknown-linux -enable-machine-outliner < %s \
+; RUN:   -o %t.serial
+; RUN: llc -mtriple=x86_64-unknown-linux -enable-machine-outliner < %s \
+; RUN:   -machine-outliner-parallel-search -o %t.parallel
+; RUN: FileCheck %s < %t.parallel
+
+; The candidates are evaluated in parallel but kept in the order they were
+; found, so the outlined functions are numbered the same either way.
+; RUN: diff %t.serial %t.parallel
+
+; CHECK-LABEL: f1:
+; CHECK:       jmp OUTLINED_FUNCTION_[[A:[0-9]+]]
+; CHECK-LABEL: f2:
+; CHECK:       jmp OUTLINED_FUNCTION_[[A]]
+; CHECK-LABEL: f3:
+; CHECK:       jmp OUTLINED_FUNCTION_[[B:[0-9]+]]
+; CHECK-LABEL: f4:
+; CHECK:       jmp OUTLINED_FUNCTION_[[B]]
+
+define void @f1(i32* %p) #0 {
+  store volatile i32 1, i32* %p
+  store volatile i32 2, i32* %p
+  store volatile i32 3, i32* %p
+  store volatile i32 4, i32* %p
+  ret void
+}
+
+define void @f2(i32* %p) #0 {
+  store volatile i32 1, i32* %p
+  store volatile i32 2, i32* %p
+  store volatile i32 3, i32* %p
+  store volatile i32 4, i32* %p
+  ret void
+}
+
+define void @f3(i32* %p) #0 {
+  store volatile i32 5, i32* %p
+  store volatile i32 6, i32* %p
+  store volatile i32 7, i32* %p
+  store volatile i32 8, i32* %p
+  ret void
+}
+
+define void @f4(i32* %p) #0 {
+  store volatile i32 5, i32* %p
+  store volatile i32 6, i32* %p
+  store volatile i32 7, i32* %p
+  store volatile i32 8, i32* %p
+  ret void
+}
+
+attributes #0 = { noredzone nounwind minsize }
@@ -0,0 +1,42 @@
+; The huge-function mode of the greedy register allocator is off by default.
+; RUN: llc -mtriple=x86_64-unknown-linux -O2 < %s -o /dev/null \
+; RUN:   -pass-remarks-filter=regalloc -pass-remarks-output=%t.default.yaml
+; RUN: FileCheck %s --check-prefix=OFF --allow-empty < %t.default.yaml
+
+; With a threshold, only functions with more virtual registers than that are
+; allocated in huge mode, and a remark explains why.
+; RUN: llc -mtriple=x86_64-unknown-linux -O2 < %s -o /dev/null \
+; RUN:   -regalloc-huge-function-vregs=1 \
+; RUN:   -pass-remarks-filter=regalloc -pass-remarks-output=%t.huge.yaml
+; RUN: FileCheck %s --check-prefix=HUGE < %t.huge.yaml
+
+; A threshold above the size of every function keeps the normal heuristics.
+; RUN: llc -mtriple=x86_64-unknown-linux -O2 < %s -o /dev/null \
+; RUN:   -regalloc-huge-function-vregs=100000 \
+; RUN:   -pass-remarks-filter=regalloc -pass-remarks-output=%t.big.yaml
+; RUN: FileCheck %s --check-prefix=OFF --allow-empty < %t.big.yaml
+
+; OFF-NOT: HugeFunction
+
+; HUGE-NOT:    Function: none
+; HUGE:        Name: HugeFunction
+; HUGE-NEXT:   Function: many
+; HUGE-NEXT:   Args:
+; HUGE-NEXT:     - String: 'function has more than '
+; HUGE-NEXT:     - NumVirtRegs: '1'
+; HUGE-NOT:    Function: none
+
+define void @none() {
+  ret void
+}
+
+define i64 @many(i64 %a, i64 %b, i64 %c, i64 %d) {
+  %x0 = mul i64 %a, %b
+  %x1 = mul i64 %c, %d
+  %x2 = add i64 %x0, %a
+  %x3 = add i64 %x1, %b
+  %x4 = mul i64 %x2, %x3
+  %x5 = add i64 %x4, %c
+  %x6 = xor i64 %x5, %d
+  ret i64 %x6
+}
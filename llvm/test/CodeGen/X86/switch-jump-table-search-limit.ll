@@ -0,0 +1,2110 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -relocation-model=static \
+; RUN:   | FileCheck %s --check-prefixes=CHECK,LIMIT
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -relocation-model=static \
+; RUN:   -jump-table-search-limit=1025 | FileCheck %s --check-prefixes=CHECK,FULL
+
+; The cases 0 to N-1 alternate between two destinations, so each of them is a
+; cluster of its own, and the case 1000000 keeps the whole range from being
+; dense. The full search puts the clusters 0 to N-1 in one jump table.
+
+; A switch of up to -jump-table-search-limit clusters is lowered as a full
+; search would lower it.
+; CHECK-LABEL: at_limit:
+; CHECK-LABEL: .LJTI0_0:
+; CHECK-COUNT-1024: .quad .LBB0_{{[0-9]+}}
+; CHECK-NOT:   .quad
+
+; Above the limit, a partition may span at most -jump-table-search-limit
+; clusters, so the table leaves out the last of the 1025 clusters.
+; CHECK-LABEL: above_limit:
+; CHECK-LABEL: .LJTI1_0:
+; LIMIT-COUNT-1024: .quad .LBB1_{{[0-9]+}}
+; FULL-COUNT-1025:  .quad .LBB1_{{[0-9]+}}
+; CHECK-NOT:   .quad
+
+define i32 @at_limit(i32 %x) {
+entry:
+  switch i32 %x, label %default [
+    i32 0, label %even
+    i32 1, label %odd
+    i32 2, label %even
+    i32 3, label %odd
+    i32 4, label %even
+    i32 5, label %odd
+    i32 6, label %even
+    i32 7, label %odd
+    i32 8, label %even
+    i32 9, label %odd
+    i32 10, label %even
+    i32 11, label %odd
+    i32 12, label %even
+    i32 13, label %odd
+    i32 14, label %even
+    i32 15, label %odd
+    i32 16, label %even
+    i32 17, label %odd
+    i32 18, label %even
+    i32 19, label %odd
+    i32 20, label %even
+    i32 21, label %odd
+    i32 22, label %even
+    i32 23, label %odd
+    i32 24, label %even
+    i32 25, label %odd
+    i32 26, label %even
+    i32 27, label %odd
+    i32 28, label %even
+    i32 29, label %odd
+    i32 30, label %even
+    i32 31, label %odd
+    i32 32, label %even
+    i32 33, label %odd
+    i32 34, label %even
+    i32 35, label %odd
+    i32 36, label %even
+    i32 37, label %odd
+    i32 38, label %even
+    i32 39, label %odd
+    i32 40, label %even
+    i32 41, label %odd
+    i32 42, label %even
+    i32 43, label %odd
+    i32 44, label %even
+    i32 45, label %odd
+    i32 46, label %even
+    i32 47, label %odd
+    i32 48, label %even
+    i32 49, label %odd
+    i32 50, label %even
+    i32 51, label %odd
+    i32 52, label %even
+    i32 53, label %odd
+    i32 54, label %even
+    i32 55, label %odd
+    i32 56, label %even
+    i32 57, label %odd
+    i32 58, label %even
+    i32 59, label %odd
+    i32 60, label %even
+    i32 61, label %odd
+    i32 62, label %even
+    i32 63, label %odd
+    i32 64, label %even
+    i32 65, label %odd
+    i32 66, label %even
+    i32 67, label %odd
+    i32 68, label %even
+    i32 69, label %odd
+    i32 70, label %even
+    i32 71, label %odd
+    i32 72, label %even
+    i32 73, label %odd
+    i32 74, label %even
+    i32 75, label %odd
+    i32 76, label %even
+    i32 77, label %odd
+    i32 78, label %even
+    i32 79, label %odd
+    i32 80, label %even
+    i32 81, label %odd
+    i32 82, label %even
+    i32 83, label %odd
+    i32 84, label %even
+    i32 85, label %odd
+    i32 86, label %even
+    i32 87, label %odd
+    i32 88, label %even
+    i32 89, label %odd
+    i32 90, label %even
+    i32 91, label %odd
+    i32 92, label %even
+    i32 93, label %odd
+    i32 94, label %even
+    i32 95, label %odd
+    i32 96, label %even
+    i32 97, label %odd
+    i32 98, label %even
+    i32 99, label %odd
+    i32 100, label %even
+    i32 101, label %odd
+    i32 102, label %even
+    i32 103, label %odd
+    i32 104, label %even
+    i32 105, label %odd
+    i32 106, label %even
+    i32 107, label %odd
+    i32 108, label %even
+    i32 109, label %odd
+    i32 110, label %even
+    i32 111, label %odd
+    i32 112, label %even
+    i32 113, label %odd
+    i32 114, label %even
+    i32 115, label %odd
+    i32 116, label %even
+    i32 117, label %odd
+    i32 118, label %even
+    i32 119, label %odd
+    i32 120, label %even
+    i32 121, label %odd
+    i32 122, label %even
+    i32 123, label %odd
+    i32 124, label %even
+    i32 125, label %odd
+    i32 126, label %even
+    i32 127, label %odd
+    i32 128, label %even
+    i32 129, label %odd
+    i32 130, label %even
+    i32 131, label %odd
+    i32 132, label %even
+    i32 133, label %odd
+    i32 134, label %even
+    i32 135, label %odd
+    i32 136, label %even
+    i32 137, label %odd
+    i32 138, label %even
+    i32 139, label %odd
+    i32 140, label %even
+    i32 141, label %odd
+    i32 142, label %even
+    i32 143, label %odd
+    i32 144, label %even
+    i32 145, label %odd
+    i32 146, label %even
+    i32 147, label %odd
+    i32 148, label %even
+    i32 149, label %odd
+    i32 150, label %even
+    i32 151, label %odd
+    i32 152, label %even
+    i32 153, label %odd
+    i32 154, label %even
+    i32 155, label %odd
+    i32 156, label %even
+    i32 157, label %odd
+    i32 158, label %even
+    i32 159, label %odd
+    i32 160, label %even
+    i32 161, label %odd
+    i32 162, label %even
+    i32 163, label %odd
+    i32 164, label %even
+    i32 165, label %odd
+    i32 166, label %even
+    i32 167, label %odd
+    i32 168, label %even
+    i32 169, label %odd
+    i32 170, label %even
+    i32 171, label %odd
+    i32 172, label %even
+    i32 173, label %odd
+    i32 174, label %even
+    i32 175, label %odd
+    i32 176, label %even
+    i32 177, label %odd
+    i32 178, label %even
+    i32 179, label %odd
+    i32 180, label %even
+    i32 181, label %odd
+    i32 182, label %even
+    i32 183, label %odd
+    i32 184, label %even
+    i32 185, label %odd
+    i32 186, label %even
+    i32 187, label %odd
+    i32 188, label %even
+    i32 189, label %odd
+    i32 190, label %even
+    i32 191, label %odd
+    i32 192, label %even
+    i32 193, label %odd
+    i32 194, label %even
+    i32 195, label %odd
+    i32 196, label %even
+    i32 197, label %odd
+    i32 198, label %even
+    i32 199, label %odd
+    i32 200, label %even
+    i32 201, label %odd
+    i32 202, label %even
+    i32 203, label %odd
+    i32 204, label %even
+    i32 205, label %odd
+    i32 206, label %even
+    i32 207, label %odd
+    i32 208, label %even
+    i32 209, label %odd
+    i32 210, label %even
+    i32 211, label %odd
+    i32 212, label %even
+    i32 213, label %odd
+    i32 214, label %even
+    i32 215, label %odd
+    i32 216, label %even
+    i32 217, label %odd
+    i32 218, label %even
+    i32 219, label %odd
+    i32 220, label %even
+    i32 221, label %odd
+    i32 222, label %even
+    i32 223, label %odd
+    i32 224, label %even
+    i32 225, label %odd
+    i32 226, label %even
+    i32 227, label %odd
+    i32 228, label %even
+    i32 229, label %odd
+    i32 230, label %even
+    i32 231, label %odd
+    i32 232, label %even
+    i32 233, label %odd
+    i32 234, label %even
+    i32 235, label %odd
+    i32 236, label %even
+    i32 237, label %odd
+    i32 238, label %even
+    i32 239, label %odd
+    i32 240, label %even
+    i32 241, label %odd
+    i32 242, label %even
+    i32 243, label %odd
+    i32 244, label %even
+    i32 245, label %odd
+    i32 246, label %even
+    i32 247, label %odd
+    i32 248, label %even
+    i32 249, label %odd
+    i32 250, label %even
+    i32 251, label %odd
+    i32 252, label %even
+    i32 253, label %odd
+    i32 254, label %even
+    i32 255, label %odd
+    i32 256, label %even
+    i32 257, label %odd
+    i32 258, label %even
+    i32 259, label %odd
+    i32 260, label %even
+    i32 261, label %odd
+    i32 262, label %even
+    i32 263, label %odd
+    i32 264, label %even
+    i32 265, label %odd
+    i32 266, label %even
+    i32 267, label %odd
+    i32 268, label %even
+    i32 269, label %odd
+    i32 270, label %even
+    i32 271, label %odd
+    i32 272, label %even
+    i32 273, label %odd
+    i32 274, label %even
+    i32 275, label %odd
+    i32 276, label %even
+    i32 277, label %odd
+    i32 278, label %even
+    i32 279, label %odd
+    i32 280, label %even
+    i32 281, label %odd
+    i32 282, label %even
+    i32 283, label %odd
+    i32 284, label %even
+    i32 285, label %odd
+    i32 286, label %even
+    i32 287, label %odd
+    i32 288, label %even
+    i32 289, label %odd
+    i32 290, label %even
+    i32 291, label %odd
+    i32 292, label %even
+    i32 293, label %odd
+    i32 294, label %even
+    i32 295, label %odd
+    i32 296, label %even
+    i32 297, label %odd
+    i32 298, label %even
+    i32 299, label %odd
+    i32 300, label %even
+    i32 301, label %odd
+    i32 302, label %even
+    i32 303, label %odd
+    i32 304, label %even
+    i32 305, label %odd
+    i32 306, label %even
+    i32 307, label %odd
+    i32 308, label %even
+    i32 309, label %odd
+    i32 310, label %even
+    i32 311, label %odd
+    i32 312, label %even
+    i32 313, label %odd
+    i32 314, label %even
+    i32 315, label %odd
+    i32 316, label %even
+    i32 317, label %odd
+    i32 318, label %even
+    i32 319, label %odd
+    i32 320, label %even
+    i32 321, label %odd
+    i32 322, label %even
+    i32 323, label %odd
+    i32 324, label %even
+    i32 325, label %odd
+    i32 326, label %even
+    i32 327, label %odd
+    i32 328, label %even
+    i32 329, label %odd
+    i32 330, label %even
+    i32 331, label %odd
+    i32 332, label %even
+    i32 333, label %odd
+    i32 334, label %even
+    i32 335, label %odd
+    i32 336, label %even
+    i32 337, label %odd
+    i32 338, label %even
+    i32 339, label %odd
+    i32 340, label %even
+    i32 341, label %odd
+    i32 342, label %even
+    i32 343, label %odd
+    i32 344, label %even
+    i32 345, label %odd
+    i32 346, label %even
+    i32 347, label %odd
+    i32 348, label %even
+    i32 349, label %odd
+    i32 350, label %even
+    i32 351, label %odd
+    i32 352, label %even
+    i32 353, label %odd
+    i32 354, label %even
+    i32 355, label %odd
+    i32 356, label %even
+    i32 357, label %odd
+    i32 358, label %even
+    i32 359, label %odd
+    i32 360, label %even
+    i32 361, label %odd
+    i32 362, label %even
+    i32 363, label %odd
+    i32 364, label %even
+    i32 365, label %odd
+    i32 366, label %even
+    i32 367, label %odd
+    i32 368, label %even
+    i32 369, label %odd
+    i32 370, label %even
+    i32 371, label %odd
+    i32 372, label %even
+    i32 373, label %odd
+    i32 374, label %even
+    i32 375, label %odd
+    i32 376, label %even
+    i32 377, label %odd
+    i32 378, label %even
+    i32 379, label %odd
+    i32 380, label %even
+    i32 381, label %odd
+    i32 382, label %even
+    i32 383, label %odd
+    i32 384, label %even
+    i32 385, label %odd
+    i32 386, label %even
+    i32 387, label %odd
+    i32 388, label %even
+    i32 389, label %odd
+    i32 390, label %even
+    i32 391, label %odd
+    i32 392, label %even
+    i32 393, label %odd
+    i32 394, label %even
+    i32 395, label %odd
+    i32 396, label %even
+    i32 397, label %odd
+    i32 398, label %even
+    i32 399, label %odd
+    i32 400, label %even
+    i32 401, label %odd
+    i32 402, label %even
+    i32 403, label %odd
+    i32 404, label %even
+    i32 405, label %odd
+    i32 406, label %even
+    i32 407, label %odd
+    i32 408, label %even
+    i32 409, label %odd
+    i32 410, label %even
+    i32 411, label %odd
+    i32 412, label %even
+    i32 413, label %odd
+    i32 414, label %even
+    i32 415, label %odd
+    i32 416, label %even
+    i32 417, label %odd
+    i32 418, label %even
+    i32 419, label %odd
+    i32 420, label %even
+    i32 421, label %odd
+    i32 422, label %even
+    i32 423, label %odd
+    i32 424, label %even
+    i32 425, label %odd
+    i32 426, label %even
+    i32 427, label %odd
+    i32 428, label %even
+    i32 429, label %odd
+    i32 430, label %even
+    i32 431, label %odd
+    i32 432, label %even
+    i32 433, label %odd
+    i32 434, label %even
+    i32 435, label %odd
+    i32 436, label %even
+    i32 437, label %odd
+    i32 438, label %even
+    i32 439, label %odd
+    i32 440, label %even
+    i32 441, label %odd
+    i32 442, label %even
+    i32 443, label %odd
+    i32 444, label %even
+    i32 445, label %odd
+    i32 446, label %even
+    i32 447, label %odd
+    i32 448, label %even
+    i32 449, label %odd
+    i32 450, label %even
+    i32 451, label %odd
+    i32 452, label %even
+    i32 453, label %odd
+    i32 454, label %even
+    i32 455, label %odd
+    i32 456, label %even
+    i32 457, label %odd
+    i32 458, label %even
+    i32 459, label %odd
+    i32 460, label %even
+    i32 461, label %odd
+    i32 462, label %even
+    i32 463, label %odd
+    i32 464, label %even
+    i32 465, label %odd
+    i32 466, label %even
+    i32 467, label %odd
+    i32 468, label %even
+    i32 469, label %odd
+    i32 470, label %even
+    i32 471, label %odd
+    i32 472, label %even
+    i32 473, label %odd
+    i32 474, label %even
+    i32 475, label %odd
+    i32 476, label %even
+    i32 477, label %odd
+    i32 478, label %even
+    i32 479, label %odd
+    i32 480, label %even
+    i32 481, label %odd
+    i32 482, label %even
+    i32 483, label %odd
+    i32 484, label %even
+    i32 485, label %odd
+    i32 486, label %even
+    i32 487, label %odd
+    i32 488, label %even
+    i32 489, label %odd
+    i32 490, label %even
+    i32 491, label %odd
+    i32 492, label %even
+    i32 493, label %odd
+    i32 494, label %even
+    i32 495, label %odd
+    i32 496, label %even
+    i32 497, label %odd
+    i32 498, label %even
+    i32 499, label %odd
+    i32 500, label %even
+    i32 501, label %odd
+    i32 502, label %even
+    i32 503, label %odd
+    i32 504, label %even
+    i32 505, label %odd
+    i32 506, label %even
+    i32 507, label %odd
+    i32 508, label %even
+    i32 509, label %odd
+    i32 510, label %even
+    i32 511, label %odd
+    i32 512, label %even
+    i32 513, label %odd
+    i32 514, label %even
+    i32 515, label %odd
+    i32 516, label %even
+    i32 517, label %odd
+    i32 518, label %even
+    i32 519, label %odd
+    i32 520, label %even
+    i32 521, label %odd
+    i32 522, label %even
+    i32 523, label %odd
+    i32 524, label %even
+    i32 525, label %odd
+    i32 526, label %even
+    i32 527, label %odd
+    i32 528, label %even
+    i32 529, label %odd
+    i32 530, label %even
+    i32 531, label %odd
+    i32 532, label %even
+    i32 533, label %odd
+    i32 534, label %even
+    i32 535, label %odd
+    i32 536, label %even
+    i32 537, label %odd
+    i32 538, label %even
+    i32 539, label %odd
+    i32 540, label %even
+    i32 541, label %odd
+    i32 542, label %even
+    i32 543, label %odd
+    i32 544, label %even
+    i32 545, label %odd
+    i32 546, label %even
+    i32 547, label %odd
+    i32 548, label %even
+    i32 549, label %odd
+    i32 550, label %even
+    i32 551, label %odd
+    i32 552, label %even
+    i32 553, label %odd
+    i32 554, label %even
+    i32 555, label %odd
+    i32 556, label %even
+    i32 557, label %odd
+    i32 558, label %even
+    i32 559, label %odd
+    i32 560, label %even
+    i32 561, label %odd
+    i32 562, label %even
+    i32 563, label %odd
+    i32 564, label %even
+    i32 565, label %odd
+    i32 566, label %even
+    i32 567, label %odd
+    i32 568, label %even
+    i32 569, label %odd
+    i32 570, label %even
+    i32 571, label %odd
+    i32 572, label %even
+    i32 573, label %odd
+    i32 574, label %even
+    i32 575, label %odd
+    i32 576, label %even
+    i32 577, label %odd
+    i32 578, label %even
+    i32 579, label %odd
+    i32 580, label %even
+    i32 581, label %odd
+    i32 582, label %even
+    i32 583, label %odd
+    i32 584, label %even
+    i32 585, label %odd
+    i32 586, label %even
+    i32 587, label %odd
+    i32 588, label %even
+    i32 589, label %odd
+    i32 590, label %even
+    i32 591, label %odd
+    i32 592, label %even
+    i32 593, label %odd
+    i32 594, label %even
+    i32 595, label %odd
+    i32 596, label %even
+    i32 597, label %odd
+    i32 598, label %even
+    i32 599, label %odd
+    i32 600, label %even
+    i32 601, label %odd
+    i32 602, label %even
+    i32 603, label %odd
+    i32 604, label %even
+    i32 605, label %odd
+    i32 606, label %even
+    i32 607, label %odd
+    i32 608, label %even
+    i32 609, label %odd
+    i32 610, label %even
+    i32 611, label %odd
+    i32 612, label %even
+    i32 613, label %odd
+    i32 614, label %even
+    i32 615, label %odd
+    i32 616, label %even
+    i32 617, label %odd
+    i32 618, label %even
+    i32 619, label %odd
+    i32 620, label %even
+    i32 621, label %odd
+    i32 622, label %even
+    i32 623, label %odd
+    i32 624, label %even
+    i32 625, label %odd
+    i32 626, label %even
+    i32 627, label %odd
+    i32 628, label %even
+    i32 629, label %odd
+    i32 630, label %even
+    i32 631, label %odd
+    i32 632, label %even
+    i32 633, label %odd
+    i32 634, label %even
+    i32 635, label %odd
+    i32 636, label %even
+    i32 637, label %odd
+    i32 638, label %even
+    i32 639, label %odd
+    i32 640, label %even
+    i32 641, label %odd
+    i32 642, label %even
+    i32 643, label %odd
+    i32 644, label %even
+    i32 645, label %odd
+    i32 646, label %even
+    i32 647, label %odd
+    i32 648, label %even
+    i32 649, label %odd
+    i32 650, label %even
+    i32 651, label %odd
+    i32 652, label %even
+    i32 653, label %odd
+    i32 654, label %even
+    i32 655, label %odd
+    i32 656, label %even
+    i32 657, label %odd
+    i32 658, label %even
+    i32 659, label %odd
+    i32 660, label %even
+    i32 661, label %odd
+    i32 662, label %even
+    i32 663, label %odd
+    i32 664, label %even
+    i32 665, label %odd
+    i32 666, label %even
+    i32 667, label %odd
+    i32 668, label %even
+    i32 669, label %odd
+    i32 670, label %even
+    i32 671, label %odd
+    i32 672, label %even
+    i32 673, label %odd
+    i32 674, label %even
+    i32 675, label %odd
+    i32 676, label %even
+    i32 677, label %odd
+    i32 678, label %even
+    i32 679, label %odd
+    i32 680, label %even
+    i32 681, label %odd
+    i32 682, label %even
+    i32 683, label %odd
+    i32 684, label %even
+    i32 685, label %odd
+    i32 686, label %even
+    i32 687, label %odd
+    i32 688, label %even
+    i32 689, label %odd
+    i32 690, label %even
+    i32 691, label %odd
+    i32 692, label %even
+    i32 693, label %odd
+    i32 694, label %even
+    i32 695, label %odd
+    i32 696, label %even
+    i32 697, label %odd
+    i32 698, label %even
+    i32 699, label %odd
+    i32 700, label %even
+    i32 701, label %odd
+    i32 702, label %even
+    i32 703, label %odd
+    i32 704, label %even
+    i32 705, label %odd
+    i32 706, label %even
+    i32 707, label %odd
+    i32 708, label %even
+    i32 709, label %odd
+    i32 710, label %even
+    i32 711, label %odd
+    i32 712, label %even
+    i32 713, label %odd
+    i32 714, label %even
+    i32 715, label %odd
+    i32 716, label %even
+    i32 717, label %odd
+    i32 718, label %even
+    i32 719, label %odd
+    i32 720, label %even
+    i32 721, label %odd
+    i32 722, label %even
+    i32 723, label %odd
+    i32 724, label %even
+    i32 725, label %odd
+    i32 726, label %even
+    i32 727, label %odd
+    i32 728, label %even
+    i32 729, label %odd
+    i32 730, label %even
+    i32 731, label %odd
+    i32 732, label %even
+    i32 733, label %odd
+    i32 734, label %even
+    i32 735, label %odd
+    i32 736, label %even
+    i32 737, label %odd
+    i32 738, label %even
+    i32 739, label %odd
+    i32 740, label %even
+    i32 741, label %odd
+    i32 742, label %even
+    i32 743, label %odd
+    i32 744, label %even
+    i32 745, label %odd
+    i32 746, label %even
+    i32 747, label %odd
+    i32 748, label %even
+    i32 749, label %odd
+    i32 750, label %even
+    i32 751, label %odd
+    i32 752, label %even
+    i32 753, label %odd
+    i32 754, label %even
+    i32 755, label %odd
+    i32 756, label %even
+    i32 757, label %odd
+    i32 758, label %even
+    i32 759, label %odd
+    i32 760, label %even
+    i32 761, label %odd
+    i32 762, label %even
+    i32 763, label %odd
+    i32 764, label %even
+    i32 765, label %odd
+    i32 766, label %even
+    i32 767, label %odd
+    i32 768, label %even
+    i32 769, label %odd
+    i32 770, label %even
+    i32 771, label %odd
+    i32 772, label %even
+    i32 773, label %odd
+    i32 774, label %even
+    i32 775, label %odd
+    i32 776, label %even
+    i32 777, label %odd
+    i32 778, label %even
+    i32 779, label %odd
+    i32 780, label %even
+    i32 781, label %odd
+    i32 782, label %even
+    i32 783, label %odd
+    i32 784, label %even
+    i32 785, label %odd
+    i32 786, label %even
+    i32 787, label %odd
+    i32 788, label %even
+    i32 789, label %odd
+    i32 790, label %even
+    i32 791, label %odd
+    i32 792, label %even
+    i32 793, label %odd
+    i32 794, label %even
+    i32 795, label %odd
+    i32 796, label %even
+    i32 797, label %odd
+    i32 798, label %even
+    i32 799, label %odd
+    i32 800, label %even
+    i32 801, label %odd
+    i32 802, label %even
+    i32 803, label %odd
+    i32 804, label %even
+    i32 805, label %odd
+    i32 806, label %even
+    i32 807, label %odd
+    i32 808, label %even
+    i32 809, label %odd
+    i32 810, label %even
+    i32 811, label %odd
+    i32 812, label %even
+    i32 813, label %odd
+    i32 814, label %even
+    i32 815, label %odd
+    i32 816, label %even
+    i32 817, label %odd
+    i32 818, label %even
+    i32 819, label %odd
+    i32 820, label %even
+    i32 821, label %odd
+    i32 822, label %even
+    i32 823, label %odd
+    i32 824, label %even
+    i32 825, label %odd
+    i32 826, label %even
+    i32 827, label %odd
+    i32 828, label %even
+    i32 829, label %odd
+    i32 830, label %even
+    i32 831, label %odd
+    i32 832, label %even
+    i32 833, label %odd
+    i32 834, label %even
+    i32 835, label %odd
+    i32 836, label %even
+    i32 837, label %odd
+    i32 838, label %even
+    i32 839, label %odd
+    i32 840, label %even
+    i32 841, label %odd
+    i32 842, label %even
+    i32 843, label %odd
+    i32 844, label %even
+    i32 845, label %odd
+    i32 846, label %even
+    i32 847, label %odd
+    i32 848, label %even
+    i32 849, label %odd
+    i32 850, label %even
+    i32 851, label %odd
+    i32 852, label %even
+    i32 853, label %odd
+    i32 854, label %even
+    i32 855, label %odd
+    i32 856, label %even
+    i32 857, label %odd
+    i32 858, label %even
+    i32 859, label %odd
+    i32 860, label %even
+    i32 861, label %odd
+    i32 862, label %even
+    i32 863, label %odd
+    i32 864, label %even
+    i32 865, label %odd
+    i32 866, label %even
+    i32 867, label %odd
+    i32 868, label %even
+    i32 869, label %odd
+    i32 870, label %even
+    i32 871, label %odd
+    i32 872, label %even
+    i32 873, label %odd
+    i32 874, label %even
+    i32 875, label %odd
+    i32 876, label %even
+    i32 877, label %odd
+    i32 878, label %even
+    i32 879, label %odd
+    i32 880, label %even
+    i32 881, label %odd
+    i32 882, label %even
+    i32 883, label %odd
+    i32 884, label %even
+    i32 885, label %odd
+    i32 886, label %even
+    i32 887, label %odd
+    i32 888, label %even
+    i32 889, label %odd
+    i32 890, label %even
+    i32 891, label %odd
+    i32 892, label %even
+    i32 893, label %odd
+    i32 894, label %even
+    i32 895, label %odd
+    i32 896, label %even
+    i32 897, label %odd
+    i32 898, label %even
+    i32 899, label %odd
+    i32 900, label %even
+    i32 901, label %odd
+    i32 902, label %even
+    i32 903, label %odd
+    i32 904, label %even
+    i32 905, label %odd
+    i32 906, label %even
+    i32 907, label %odd
+    i32 908, label %even
+    i32 909, label %odd
+    i32 910, label %even
+    i32 911, label %odd
+    i32 912, label %even
+    i32 913, label %odd
+    i32 914, label %even
+    i32 915, label %odd
+    i32 916, label %even
+    i32 917, label %odd
+    i32 918, label %even
+    i32 919, label %odd
+    i32 920, label %even
+    i32 921, label %odd
+    i32 922, label %even
+    i32 923, label %odd
+    i32 924, label %even
+    i32 925, label %odd
+    i32 926, label %even
+    i32 927, label %odd
+    i32 928, label %even
+    i32 929, label %odd
+    i32 930, label %even
+    i32 931, label %odd
+    i32 932, label %even
+    i32 933, label %odd
+    i32 934, label %even
+    i32 935, label %odd
+    i32 936, label %even
+    i32 937, label %odd
+    i32 938, label %even
+    i32 939, label %odd
+    i32 940, label %even
+    i32 941, label %odd
+    i32 942, label %even
+    i32 943, label %odd
+    i32 944, label %even
+    i32 945, label %odd
+    i32 946, label %even
+    i32 947, label %odd
+    i32 948, label %even
+    i32 949, label %odd
+    i32 950, label %even
+    i32 951, label %odd
+    i32 952, label %even
+    i32 953, label %odd
+    i32 954, label %even
+    i32 955, label %odd
+    i32 956, label %even
+    i32 957, label %odd
+    i32 958, label %even
+    i32 959, label %odd
+    i32 960, label %even
+    i32 961, label %odd
+    i32 962, label %even
+    i32 963, label %odd
+    i32 964, label %even
+    i32 965, label %odd
+    i32 966, label %even
+    i32 967, label %odd
+    i32 968, label %even
+    i32 969, label %odd
+    i32 970, label %even
+    i32 971, label %odd
+    i32 972, label %even
+    i32 973, label %odd
+    i32 974, label %even
+    i32 975, label %odd
+    i32 976, label %even
+    i32 977, label %odd
+    i32 978, label %even
+    i32 979, label %odd
+    i32 980, label %even
+    i32 981, label %odd
+    i32 982, label %even
+    i32 983, label %odd
+    i32 984, label %even
+    i32 985, label %odd
+    i32 986, label %even
+    i32 987, label %odd
+    i32 988, label %even
+    i32 989, label %odd
+    i32 990, label %even
+    i32 991, label %odd
+    i32 992, label %even
+    i32 993, label %odd
+    i32 994, label %even
+    i32 995, label %odd
+    i32 996, label %even
+    i32 997, label %odd
+    i32 998, label %even
+    i32 999, label %odd
+    i32 1000, label %even
+    i32 1001, label %odd
+    i32 1002, label %even
+    i32 1003, label %odd
+    i32 1004, label %even
+    i32 1005, label %odd
+    i32 1006, label %even
+    i32 1007, label %odd
+    i32 1008, label %even
+    i32 1009, label %odd
+    i32 1010, label %even
+    i32 1011, label %odd
+    i32 1012, label %even
+    i32 1013, label %odd
+    i32 1014, label %even
+    i32 1015, label %odd
+    i32 1016, label %even
+    i32 1017, label %odd
+    i32 1018, label %even
+    i32 1019, label %odd
+    i32 1020, label %even
+    i32 1021, label %odd
+    i32 1022, label %even
+    i32 1023, label %odd
+    i32 1000000, label %far
+  ]
+
+even:
+  ret i32 1
+
+odd:
+  ret i32 2
+
+far:
+  ret i32 3
+
+default:
+  ret i32 0
+}
+
+define i32 @above_limit(i32 %x) {
+entry:
+  switch i32 %x, label %default [
+    i32 0, label %even
+    i32 1, label %odd
+    i32 2, label %even
+    i32 3, label %odd
+    i32 4, label %even
+    i32 5, label %odd
+    i32 6, label %even
+    i32 7, label %odd
+    i32 8, label %even
+    i32 9, label %odd
+    i32 10, label %even
+    i32 11, label %odd
+    i32 12, label %even
+    i32 13, label %odd
+    i32 14, label %even
+    i32 15, label %odd
+    i32 16, label %even
+    i32 17, label %odd
+    i32 18, label %even
+    i32 19, label %odd
+    i32 20, label %even
+    i32 21, label %odd
+    i32 22, label %even
+    i32 23, label %odd
+    i32 24, label %even
+    i32 25, label %odd
+    i32 26, label %even
+    i32 27, label %odd
+    i32 28, label %even
+    i32 29, label %odd
+    i32 30, label %even
+    i32 31, label %odd
+    i32 32, label %even
+    i32 33, label %odd
+    i32 34, label %even
+    i32 35, label %odd
+    i32 36, label %even
+    i32 37, label %odd
+    i32 38, label %even
+    i32 39, label %odd
+    i32 40, label %even
+    i32 41, label %odd
+    i32 42, label %even
+    i32 43, label %odd
+    i32 44, label %even
+    i32 45, label %odd
+    i32 46, label %even
+    i32 47, label %odd
+    i32 48, label %even
+    i32 49, label %odd
+    i32 50, label %even
+    i32 51, label %odd
+    i32 52, label %even
+    i32 53, label %odd
+    i32 54, label %even
+    i32 55, label %odd
+    i32 56, label %even
+    i32 57, label %odd
+    i32 58, label %even
+    i32 59, label %odd
+    i32 60, label %even
+    i32 61, label %odd
+    i32 62, label %even
+    i32 63, label %odd
+    i32 64, label %even
+    i32 65, label %odd
+    i32 66, label %even
+    i32 67, label %odd
+    i32 68, label %even
+    i32 69, label %odd
+    i32 70, label %even
+    i32 71, label %odd
+    i32 72, label %even
+    i32 73, label %odd
+    i32 74, label %even
+    i32 75, label %odd
+    i32 76, label %even
+    i32 77, label %odd
+    i32 78, label %even
+    i32 79, label %odd
+    i32 80, label %even
+    i32 81, label %odd
+    i32 82, label %even
+    i32 83, label %odd
+    i32 84, label %even
+    i32 85, label %odd
+    i32 86, label %even
+    i32 87, label %odd
+    i32 88, label %even
+    i32 89, label %odd
+    i32 90, label %even
+    i32 91, label %odd
+    i32 92, label %even
+    i32 93, label %odd
+    i32 94, label %even
+    i32 95, label %odd
+    i32 96, label %even
+    i32 97, label %odd
+    i32 98, label %even
+    i32 99, label %odd
+    i32 100, label %even
+    i32 101, label %odd
+    i32 102, label %even
+    i32 103, label %odd
+    i32 104, label %even
+    i32 105, label %odd
+    i32 106, label %even
+    i32 107, label %odd
+    i32 108, label %even
+    i32 109, label %odd
+    i32 110, label %even
+    i32 111, label %odd
+    i32 112, label %even
+    i32 113, label %odd
+    i32 114, label %even
+    i32 115, label %odd
+    i32 116, label %even
+    i32 117, label %odd
+    i32 118, label %even
+    i32 119, label %odd
+    i32 120, label %even
+    i32 121, label %odd
+    i32 122, label %even
+    i32 123, label %odd
+    i32 124, label %even
+    i32 125, label %odd
+    i32 126, label %even
+    i32 127, label %odd
+    i32 128, label %even
+    i32 129, label %odd
+    i32 130, label %even
+    i32 131, label %odd
+    i32 132, label %even
+    i32 133, label %odd
+    i32 134, label %even
+    i32 135, label %odd
+    i32 136, label %even
+    i32 137, label %odd
+    i32 138, label %even
+    i32 139, label %odd
+    i32 140, label %even
+    i32 141, label %odd
+    i32 142, label %even
+    i32 143, label %odd
+    i32 144, label %even
+    i32 145, label %odd
+    i32 146, label %even
+    i32 147, label %odd
+    i32 148, label %even
+    i32 149, label %odd
+    i32 150, label %even
+    i32 151, label %odd
+    i32 152, label %even
+    i32 153, label %odd
+    i32 154, label %even
+    i32 155, label %odd
+    i32 156, label %even
+    i32 157, label %odd
+    i32 158, label %even
+    i32 159, label %odd
+    i32 160, label %even
+    i32 161, label %odd
+    i32 162, label %even
+    i32 163, label %odd
+    i32 164, label %even
+    i32 165, label %odd
+    i32 166, label %even
+    i32 167, label %odd
+    i32 168, label %even
+    i32 169, label %odd
+    i32 170, label %even
+    i32 171, label %odd
+    i32 172, label %even
+    i32 173, label %odd
+    i32 174, label %even
+    i32 175, label %odd
+    i32 176, label %even
+    i32 177, label %odd
+    i32 178, label %even
+    i32 179, label %odd
+    i32 180, label %even
+    i32 181, label %odd
+    i32 182, label %even
+    i32 183, label %odd
+    i32 184, label %even
+    i32 185, label %odd
+    i32 186, label %even
+    i32 187, label %odd
+    i32 188, label %even
+    i32 189, label %odd
+    i32 190, label %even
+    i32 191, label %odd
+    i32 192, label %even
+    i32 193, label %odd
+    i32 194, label %even
+    i32 195, label %odd
+    i32 196, label %even
+    i32 197, label %odd
+    i32 198, label %even
+    i32 199, label %odd
+    i32 200, label %even
+    i32 201, label %odd
+    i32 202, label %even
+    i32 203, label %odd
+    i32 204, label %even
+    i32 205, label %odd
+    i32 206, label %even
+    i32 207, label %odd
+    i32 208, label %even
+    i32 209, label %odd
+    i32 210, label %even
+    i32 211, label %odd
+    i32 212, label %even
+    i32 213, label %odd
+    i32 214, label %even
+    i32 215, label %odd
+    i32 216, label %even
+    i32 217, label %odd
+    i32 218, label %even
+    i32 219, label %odd
+    i32 220, label %even
+    i32 221, label %odd
+    i32 222, label %even
+    i32 223, label %odd
+    i32 224, label %even
+    i32 225, label %odd
+    i32 226, label %even
+    i32 227, label %odd
+    i32 228, label %even
+    i32 229, label %odd
+    i32 230, label %even
+    i32 231, label %odd
+    i32 232, label %even
+    i32 233, label %odd
+    i32 234, label %even
+    i32 235, label %odd
+    i32 236, label %even
+    i32 237, label %odd
+    i32 238, label %even
+    i32 239, label %odd
+    i32 240, label %even
+    i32 241, label %odd
+    i32 242, label %even
+    i32 243, label %odd
+    i32 244, label %even
+    i32 245, label %odd
+    i32 246, label %even
+    i32 247, label %odd
+    i32 248, label %even
+    i32 249, label %odd
+    i32 250, label %even
+    i32 251, label %odd
+    i32 252, label %even
+    i32 253, label %odd
+    i32 254, label %even
+    i32 255, label %odd
+    i32 256, label %even
+    i32 257, label %odd
+    i32 258, label %even
+    i32 259, label %odd
+    i32 260, label %even
+    i32 261, label %odd
+    i32 262, label %even
+    i32 263, label %odd
+    i32 264, label %even
+    i32 265, label %odd
+    i32 266, label %even
+    i32 267, label %odd
+    i32 268, label %even
+    i32 269, label %odd
+    i32 270, label %even
+    i32 271, label %odd
+    i32 272, label %even
+    i32 273, label %odd
+    i32 274, label %even
+    i32 275, label %odd
+    i32 276, label %even
+    i32 277, label %odd
+    i32 278, label %even
+    i32 279, label %odd
+    i32 280, label %even
+    i32 281, label %odd
+    i32 282, label %even
+    i32 283, label %odd
+    i32 284, label %even
+    i32 285, label %odd
+    i32 286, label %even
+    i32 287, label %odd
+    i32 288, label %even
+    i32 289, label %odd
+    i32 290, label %even
+    i32 291, label %odd
+    i32 292, label %even
+    i32 293, label %odd
+    i32 294, label %even
+    i32 295, label %odd
+    i32 296, label %even
+    i32 297, label %odd
+    i32 298, label %even
+    i32 299, label %odd
+    i32 300, label %even
+    i32 301, label %odd
+    i32 302, label %even
+    i32 303, label %odd
+    i32 304, label %even
+    i32 305, label %odd
+    i32 306, label %even
+    i32 307, label %odd
+    i32 308, label %even
+    i32 309, label %odd
+    i32 310, label %even
+    i32 311, label %odd
+    i32 312, label %even
+    i32 313, label %odd
+    i32 314, label %even
+    i32 315, label %odd
+    i32 316, label %even
+    i32 317, label %odd
+    i32 318, label %even
+    i32 319, label %odd
+    i32 320, label %even
+    i32 321, label %odd
+    i32 322, label %even
+    i32 323, label %odd
+    i32 324, label %even
+    i32 325, label %odd
+    i32 326, label %even
+    i32 327, label %odd
+    i32 328, label %even
+    i32 329, label %odd
+    i32 330, label %even
+    i32 331, label %odd
+    i32 332, label %even
+    i32 333, label %odd
+    i32 334, label %even
+    i32 335, label %odd
+    i32 336, label %even
+    i32 337, label %odd
+    i32 338, label %even
+    i32 339, label %odd
+    i32 340, label %even
+    i32 341, label %odd
+    i32 342, label %even
+    i32 343, label %odd
+    i32 344, label %even
+    i32 345, label %odd
+    i32 346, label %even
+    i32 347, label %odd
+    i32 348, label %even
+    i32 349, label %odd
+    i32 350, label %even
+    i32 351, label %odd
+    i32 352, label %even
+    i32 353, label %odd
+    i32 354, label %even
+    i32 355, label %odd
+    i32 356, label %even
+    i32 357, label %odd
+    i32 358, label %even
+    i32 359, label %odd
+    i32 360, label %even
+    i32 361, label %odd
+    i32 362, label %even
+    i32 363, label %odd
+    i32 364, label %even
+    i32 365, label %odd
+    i32 366, label %even
+    i32 367, label %odd
+    i32 368, label %even
+    i32 369, label %odd
+    i32 370, label %even
+    i32 371, label %odd
+    i32 372, label %even
+    i32 373, label %odd
+    i32 374, label %even
+    i32 375, label %odd
+    i32 376, label %even
+    i32 377, label %odd
+    i32 378, label %even
+    i32 379, label %odd
+    i32 380, label %even
+    i32 381, label %odd
+    i32 382, label %even
+    i32 383, label %odd
+    i32 384, label %even
+    i32 385, label %odd
+    i32 386, label %even
+    i32 387, label %odd
+    i32 388, label %even
+    i32 389, label %odd
+    i32 390, label %even
+    i32 391, label %odd
+    i32 392, label %even
+    i32 393, label %odd
+    i32 394, label %even
+    i32 395, label %odd
+    i32 396, label %even
+    i32 397, label %odd
+    i32 398, label %even
+    i32 399, label %odd
+    i32 400, label %even
+    i32 401, label %odd
+    i32 402, label %even
+    i32 403, label %odd
+    i32 404, label %even
+    i32 405, label %odd
+    i32 406, label %even
+    i32 407, label %odd
+    i32 408, label %even
+    i32 409, label %odd
+    i32 410, label %even
+    i32 411, label %odd
+    i32 412, label %even
+    i32 413, label %odd
+    i32 414, label %even
+    i32 415, label %odd
+    i32 416, label %even
+    i32 417, label %odd
+    i32 418, label %even
+    i32 419, label %odd
+    i32 420, label %even
+    i32 421, label %odd
+    i32 422, label %even
+    i32 423, label %odd
+    i32 424, label %even
+    i32 425, label %odd
+    i32 426, label %even
+    i32 427, label %odd
+    i32 428, label %even
+    i32 429, label %odd
+    i32 430, label %even
+    i32 431, label %odd
+    i32 432, label %even
+    i32 433, label %odd
+    i32 434, label %even
+    i32 435, label %odd
+    i32 436, label %even
+    i32 437, label %odd
+    i32 438, label %even
+    i32 439, label %odd
+    i32 440, label %even
+    i32 441, label %odd
+    i32 442, label %even
+    i32 443, label %odd
+    i32 444, label %even
+    i32 445, label %odd
+    i32 446, label %even
+    i32 447, label %odd
+    i32 448, label %even
+    i32 449, label %odd
+    i32 450, label %even
+    i32 451, label %odd
+    i32 452, label %even
+    i32 453, label %odd
+    i32 454, label %even
+    i32 455, label %odd
+    i32 456, label %even
+    i32 457, label %odd
+    i32 458, label %even
+    i32 459, label %odd
+    i32 460, label %even
+    i32 461, label %odd
+    i32 462, label %even
+    i32 463, label %odd
+    i32 464, label %even
+    i32 465, label %odd
+    i32 466, label %even
+    i32 467, label %odd
+    i32 468, label %even
+    i32 469, label %odd
+    i32 470, label %even
+    i32 471, label %odd
+    i32 472, label %even
+    i32 473, label %odd
+    i32 474, label %even
+    i32 475, label %odd
+    i32 476, label %even
+    i32 477, label %odd
+    i32 478, label %even
+    i32 479, label %odd
+    i32 480, label %even
+    i32 481, label %odd
+    i32 482, label %even
+    i32 483, label %odd
+    i32 484, label %even
+    i32 485, label %odd
+    i32 486, label %even
+    i32 487, label %odd
+    i32 488, label %even
+    i32 489, label %odd
+    i32 490, label %even
+    i32 491, label %odd
+    i32 492, label %even
+    i32 493, label %odd
+    i32 494, label %even
+    i32 495, label %odd
+    i32 496, label %even
+    i32 497, label %odd
+    i32 498, label %even
+    i32 499, label %odd
+    i32 500, label %even
+    i32 501, label %odd
+    i32 502, label %even
+    i32 503, label %odd
+    i32 504, label %even
+    i32 505, label %odd
+    i32 506, label %even
+    i32 507, label %odd
+    i32 508, label %even
+    i32 509, label %odd
+    i32 510, label %even
+    i32 511, label %odd
+    i32 512, label %even
+    i32 513, label %odd
+    i32 514, label %even
+    i32 515, label %odd
+    i32 516, label %even
+    i32 517, label %odd
+    i32 518, label %even
+    i32 519, label %odd
+    i32 520, label %even
+    i32 521, label %odd
+    i32 522, label %even
+    i32 523, label %odd
+    i32 524, label %even
+    i32 525, label %odd
+    i32 526, label %even
+    i32 527, label %odd
+    i32 528, label %even
+    i32 529, label %odd
+    i32 530, label %even
+    i32 531, label %odd
+    i32 532, label %even
+    i32 533, label %odd
+    i32 534, label %even
+    i32 535, label %odd
+    i32 536, label %even
+    i32 537, label %odd
+    i32 538, label %even
+    i32 539, label %odd
+    i32 540, label %even
+    i32 541, label %odd
+    i32 542, label %even
+    i32 543, label %odd
+    i32 544, label %even
+    i32 545, label %odd
+    i32 546, label %even
+    i32 547, label %odd
+    i32 548, label %even
+    i32 549, label %odd
+    i32 550, label %even
+    i32 551, label %odd
+    i32 552, label %even
+    i32 553, label %odd
+    i32 554, label %even
+    i32 555, label %odd
+    i32 556, label %even
+    i32 557, label %odd
+    i32 558, label %even
+    i32 559, label %odd
+    i32 560, label %even
+    i32 561, label %odd
+    i32 562, label %even
+    i32 563, label %odd
+    i32 564, label %even
+    i32 565, label %odd
+    i32 566, label %even
+    i32 567, label %odd
+    i32 568, label %even
+    i32 569, label %odd
+    i32 570, label %even
+    i32 571, label %odd
+    i32 572, label %even
+    i32 573, label %odd
+    i32 574, label %even
+    i32 575, label %odd
+    i32 576, label %even
+    i32 577, label %odd
+    i32 578, label %even
+    i32 579, label %odd
+    i32 580, label %even
+    i32 581, label %odd
+    i32 582, label %even
+    i32 583, label %odd
+    i32 584, label %even
+    i32 585, label %odd
+    i32 586, label %even
+    i32 587, label %odd
+    i32 588, label %even
+    i32 589, label %odd
+    i32 590, label %even
+    i32 591, label %odd
+    i32 592, label %even
+    i32 593, label %odd
+    i32 594, label %even
+    i32 595, label %odd
+    i32 596, label %even
+    i32 597, label %odd
+    i32 598, label %even
+    i32 599, label %odd
+    i32 600, label %even
+    i32 601, label %odd
+    i32 602, label %even
+    i32 603, label %odd
+    i32 604, label %even
+    i32 605, label %odd
+    i32 606, label %even
+    i32 607, label %odd
+    i32 608, label %even
+    i32 609, label %odd
+    i32 610, label %even
+    i32 611, label %odd
+    i32 612, label %even
+    i32 613, label %odd
+    i32 614, label %even
+    i32 615, label %odd
+    i32 616, label %even
+    i32 617, label %odd
+    i32 618, label %even
+    i32 619, label %odd
+    i32 620, label %even
+    i32 621, label %odd
+    i32 622, label %even
+    i32 623, label %odd
+    i32 624, label %even
+    i32 625, label %odd
+    i32 626, label %even
+    i32 627, label %odd
+    i32 628, label %even
+    i32 629, label %odd
+    i32 630, label %even
+    i32 631, label %odd
+    i32 632, label %even
+    i32 633, label %odd
+    i32 634, label %even
+    i32 635, label %odd
+    i32 636, label %even
+    i32 637, label %odd
+    i32 638, label %even
+    i32 639, label %odd
+    i32 640, label %even
+    i32 641, label %odd
+    i32 642, label %even
+    i32 643, label %odd
+    i32 644, label %even
+    i32 645, label %odd
+    i32 646, label %even
+    i32 647, label %odd
+    i32 648, label %even
+    i32 649, label %odd
+    i32 650, label %even
+    i32 651, label %odd
+    i32 652, label %even
+    i32 653, label %odd
+    i32 654, label %even
+    i32 655, label %odd
+    i32 656, label %even
+    i32 657, label %odd
+    i32 658, label %even
+    i32 659, label %odd
+    i32 660, label %even
+    i32 661, label %odd
+    i32 662, label %even
+    i32 663, label %odd
+    i32 664, label %even
+    i32 665, label %odd
+    i32 666, label %even
+    i32 667, label %odd
+    i32 668, label %even
+    i32 669, label %odd
+    i32 670, label %even
+    i32 671, label %odd
+    i32 672, label %even
+    i32 673, label %odd
+    i32 674, label %even
+    i32 675, label %odd
+    i32 676, label %even
+    i32 677, label %odd
+    i32 678, label %even
+    i32 679, label %odd
+    i32 680, label %even
+    i32 681, label %odd
+    i32 682, label %even
+    i32 683, label %odd
+    i32 684, label %even
+    i32 685, label %odd
+    i32 686, label %even
+    i32 687, label %odd
+    i32 688, label %even
+    i32 689, label %odd
+    i32 690, label %even
+    i32 691, label %odd
+    i32 692, label %even
+    i32 693, label %odd
+    i32 694, label %even
+    i32 695, label %odd
+    i32 696, label %even
+    i32 697, label %odd
+    i32 698, label %even
+    i32 699, label %odd
+    i32 700, label %even
+    i32 701, label %odd
+    i32 702, label %even
+    i32 703, label %odd
+    i32 704, label %even
+    i32 705, label %odd
+    i32 706, label %even
+    i32 707, label %odd
+    i32 708, label %even
+    i32 709, label %odd
+    i32 710, label %even
+    i32 711, label %odd
+    i32 712, label %even
+    i32 713, label %odd
+    i32 714, label %even
+    i32 715, label %odd
+    i32 716, label %even
+    i32 717, label %odd
+    i32 718, label %even
+    i32 719, label %odd
+    i32 720, label %even
+    i32 721, label %odd
+    i32 722, label %even
+    i32 723, label %odd
+    i32 724, label %even
+    i32 725, label %odd
+    i32 726, label %even
+    i32 727, label %odd
+    i32 728, label %even
+    i32 729, label %odd
+    i32 730, label %even
+    i32 731, label %odd
+    i32 732, label %even
+    i32 733, label %odd
+    i32 734, label %even
+    i32 735, label %odd
+    i32 736, label %even
+    i32 737, label %odd
+    i32 738, label %even
+    i32 739, label %odd
+    i32 740, label %even
+    i32 741, label %odd
+    i32 742, label %even
+    i32 743, label %odd
+    i32 744, label %even
+    i32 745, label %odd
+    i32 746, label %even
+    i32 747, label %odd
+    i32 748, label %even
+    i32 749, label %odd
+    i32 750, label %even
+    i32 751, label %odd
+    i32 752, label %even
+    i32 753, label %odd
+    i32 754, label %even
+    i32 755, label %odd
+    i32 756, label %even
+    i32 757, label %odd
+    i32 758, label %even
+    i32 759, label %odd
+    i32 760, label %even
+    i32 761, label %odd
+    i32 762, label %even
+    i32 763, label %odd
+    i32 764, label %even
+    i32 765, label %odd
+    i32 766, label %even
+    i32 767, label %odd
+    i32 768, label %even
+    i32 769, label %odd
+    i32 770, label %even
+    i32 771, label %odd
+    i32 772, label %even
+    i32 773, label %odd
+    i32 774, label %even
+    i32 775, label %odd
+    i32 776, label %even
+    i32 777, label %odd
+    i32 778, label %even
+    i32 779, label %odd
+    i32 780, label %even
+    i32 781, label %odd
+    i32 782, label %even
+    i32 783, label %odd
+    i32 784, label %even
+    i32 785, label %odd
+    i32 786, label %even
+    i32 787, label %odd
+    i32 788, label %even
+    i32 789, label %odd
+    i32 790, label %even
+    i32 791, label %odd
+    i32 792, label %even
+    i32 793, label %odd
+    i32 794, label %even
+    i32 795, label %odd
+    i32 796, label %even
+    i32 797, label %odd
+    i32 798, label %even
+    i32 799, label %odd
+    i32 800, label %even
+    i32 801, label %odd
+    i32 802, label %even
+    i32 803, label %odd
+    i32 804, label %even
+    i32 805, label %odd
+    i32 806, label %even
+    i32 807, label %odd
+    i32 808, label %even
+    i32 809, label %odd
+    i32 810, label %even
+    i32 811, label %odd
+    i32 812, label %even
+    i32 813, label %odd
+    i32 814, label %even
+    i32 815, label %odd
+    i32 816, label %even
+    i32 817, label %odd
+    i32 818, label %even
+    i32 819, label %odd
+    i32 820, label %even
+    i32 821, label %odd
+    i32 822, label %even
+    i32 823, label %odd
+    i32 824, label %even
+    i32 825, label %odd
+    i32 826, label %even
+    i32 827, label %odd
+    i32 828, label %even
+    i32 829, label %odd
+    i32 830, label %even
+    i32 831, label %odd
+    i32 832, label %even
+    i32 833, label %odd
+    i32 834, label %even
+    i32 835, label %odd
+    i32 836, label %even
+    i32 837, label %odd
+    i32 838, label %even
+    i32 839, label %odd
+    i32 840, label %even
+    i32 841, label %odd
+    i32 842, label %even
+    i32 843, label %odd
+    i32 844, label %even
+    i32 845, label %odd
+    i32 846, label %even
+    i32 847, label %odd
+    i32 848, label %even
+    i32 849, label %odd
+    i32 850, label %even
+    i32 851, label %odd
+    i32 852, label %even
+    i32 853, label %odd
+    i32 854, label %even
+    i32 855, label %odd
+    i32 856, label %even
+    i32 857, label %odd
+    i32 858, label %even
+    i32 859, label %odd
+    i32 860, label %even
+    i32 861, label %odd
+    i32 862, label %even
+    i32 863, label %odd
+    i32 864, label %even
+    i32 865, label %odd
+    i32 866, label %even
+    i32 867, label %odd
+    i32 868, label %even
+    i32 869, label %odd
+    i32 870, label %even
+    i32 871, label %odd
+    i32 872, label %even
+    i32 873, label %odd
+    i32 874, label %even
+    i32 875, label %odd
+    i32 876, label %even
+    i32 877, label %odd
+    i32 878, label %even
+    i32 879, label %odd
+    i32 880, label %even
+    i32 881, label %odd
+    i32 882, label %even
+    i32 883, label %odd
+    i32 884, label %even
+    i32 885, label %odd
+    i32 886, label %even
+    i32 887, label %odd
+    i32 888, label %even
+    i32 889, label %odd
+    i32 890, label %even
+    i32 891, label %odd
+    i32 892, label %even
+    i32 893, label %odd
+    i32 894, label %even
+    i32 895, label %odd
+    i32 896, label %even
+    i32 897, label %odd
+    i32 898, label %even
+    i32 899, label %odd
+    i32 900, label %even
+    i32 901, label %odd
+    i32 902, label %even
+    i32 903, label %odd
+    i32 904, label %even
+    i32 905, label %odd
+    i32 906, label %even
+    i32 907, label %odd
+    i32 908, label %even
+    i32 909, label %odd
+    i32 910, label %even
+    i32 911, label %odd
+    i32 912, label %even
+    i32 913, label %odd
+    i32 914, label %even
+    i32 915, label %odd
+    i32 916, label %even
+    i32 917, label %odd
+    i32 918, label %even
+    i32 919, label %odd
+    i32 920, label %even
+    i32 921, label %odd
+    i32 922, label %even
+    i32 923, label %odd
+    i32 924, label %even
+    i32 925, label %odd
+    i32 926, label %even
+    i32 927, label %odd
+    i32 928, label %even
+    i32 929, label %odd
+    i32 930, label %even
+    i32 931, label %odd
+    i32 932, label %even
+    i32 933, label %odd
+    i32 934, label %even
+    i32 935, label %odd
+    i32 936, label %even
+    i32 937, label %odd
+    i32 938, label %even
+    i32 939, label %odd
+    i32 940, label %even
+    i32 941, label %odd
+    i32 942, label %even
+    i32 943, label %odd
+    i32 944, label %even
+    i32 945, label %odd
+    i32 946, label %even
+    i32 947, label %odd
+    i32 948, label %even
+    i32 949, label %odd
+    i32 950, label %even
+    i32 951, label %odd
+    i32 952, label %even
+    i32 953, label %odd
+    i32 954, label %even
+    i32 955, label %odd
+    i32 956, label %even
+    i32 957, label %odd
+    i32 958, label %even
+    i32 959, label %odd
+    i32 960, label %even
+    i32 961, label %odd
+    i32 962, label %even
+    i32 963, label %odd
+    i32 964, label %even
+    i32 965, label %odd
+    i32 966, label %even
+    i32 967, label %odd
+    i32 968, label %even
+    i32 969, label %odd
+    i32 970, label %even
+    i32 971, label %odd
+    i32 972, label %even
+    i32 973, label %odd
+    i32 974, label %even
+    i32 975, label %odd
+    i32 976, label %even
+    i32 977, label %odd
+    i32 978, label %even
+    i32 979, label %odd
+    i32 980, label %even
+    i32 981, label %odd
+    i32 982, label %even
+    i32 983, label %odd
+    i32 984, label %even
+    i32 985, label %odd
+    i32 986, label %even
+    i32 987, label %odd
+    i32 988, label %even
+    i32 989, label %odd
+    i32 990, label %even
+    i32 991, label %odd
+    i32 992, label %even
+    i32 993, label %odd
+    i32 994, label %even
+    i32 995, label %odd
+    i32 996, label %even
+    i32 997, label %odd
+    i32 998, label %even
+    i32 999, label %odd
+    i32 1000, label %even
+    i32 1001, label %odd
+    i32 1002, label %even
+    i32 1003, label %odd
+    i32 1004, label %even
+    i32 1005, label %odd
+    i32 1006, label %even
+    i32 1007, label %odd
+    i32 1008, label %even
+    i32 1009, label %odd
+    i32 1010, label %even
+    i32 1011, label %odd
+    i32 1012, label %even
+    i32 1013, label %odd
+    i32 1014, label %even
+    i32 1015, label %odd
+    i32 1016, label %even
+    i32 1017, label %odd
+    i32 1018, label %even
+    i32 1019, label %odd
+    i32 1020, label %even
+    i32 1021, label %odd
+    i32 1022, label %even
+    i32 1023, label %odd
+    i32 1024, label %even
+    i32 1000000, label %far
+  ]
+
+even:
+  ret i32 1
+
+odd:
+  ret i32 2
+
+far:
+  ret i32 3
+
+default:
+  ret i32 0
+}
@@ -0,0 +1,59 @@
+; RUN: llc -mtriple=x86_64-unknown-linux -filetype=obj < %s -o %t.o
+; RUN: llc -mtriple=x86_64-unknown-linux -filetype=obj < %s -o %t.par.o \
+; RUN:   -dwarf-parallel-unit-layout
+; RUN: cmp %t.o %t.par.o
+; RUN: llvm-dwarfdump -debug-info -debug-abbrev %t.par.o | FileCheck %s
+
+; The abbreviations of both units are merged into one table in unit order.
+; The second unit reuses the ones of the first and numbers its own after them.
+
+; CHECK:      .debug_abbrev contents:
+; CHECK-NEXT: Abbrev table for offset: 0x00000000
+; CHECK-NEXT: [1] DW_TAG_compile_unit DW_CHILDREN_yes
+; CHECK:      [2] DW_TAG_subprogram DW_CHILDREN_no
+; CHECK-NOT:  DW_AT_type
+; CHECK:      [3] DW_TAG_subprogram DW_CHILDREN_no
+; CHECK:        DW_AT_type
+; CHECK:      [4] DW_TAG_base_type DW_CHILDREN_no
+; CHECK-NOT:  [5]
+
+; CHECK:      .debug_info contents:
+; CHECK:      Compile Unit: {{.*}} abbr_offset = 0x0000
+; CHECK:      DW_TAG_compile_unit
+; CHECK:        DW_AT_name ("a.c")
+; CHECK:      DW_TAG_subprogram
+; CHECK:        DW_AT_name ("f")
+; CHECK:      Compile Unit: {{.*}} abbr_offset = 0x0000
+; CHECK:      DW_TAG_compile_unit
+; CHECK:        DW_AT_name ("b.c")
+; CHECK:      DW_TAG_subprogram
+; CHECK:        DW_AT_name ("g")
+; CHECK:      DW_TAG_base_type
+; CHECK:        DW_AT_name ("int")
+
+define void @f() !dbg !6 {
+  ret void, !dbg !9
+}
+
+define i32 @g() !dbg !10 {
+  ret i32 0, !dbg !11
+}
+
+!llvm.dbg.cu = !{!0, !3}
+!llvm.module.flags = !{!5}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2)
+!1 = !DIFile(filename: "a.c", directory: "/tmp")
+!2 = !{}
+!3 = distinct !DICompileUnit(language: DW_LANG_C99, file: !4, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2)
+!4 = !DIFile(filename: "b.c", directory: "/tmp")
+!5 = !{i32 2, !"Debug Info Version", i32 3}
+!6 = distinct !DISubprogram(name: "f", scope: !1, file: !1, line: 1, type: !7, scopeLine: 1, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!7 = !DISubroutineType(types: !8)
+!8 = !{null}
+!9 = !DILocation(line: 1, column: 1, scope: !6)
+!10 = distinct !DISubprogram(name: "g", scope: !4, file: !4, line: 1, type: !12, scopeLine: 1, spFlags: DISPFlagDefinition, unit: !3, retainedNodes: !2)
+!11 = !DILocation(line: 1, column: 1, scope: !10)
+!12 = !DISubroutineType(types: !13)
+!13 = !{!14}
+!14 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
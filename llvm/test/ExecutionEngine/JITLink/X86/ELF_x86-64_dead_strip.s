@@ -0,0 +1,45 @@
+# RUN: rm -rf %t && mkdir -p %t
+# RUN: llvm-mc -triple=x86_64-unknown-linux -filetype=obj \
+# RUN:   -o %t/elf_dead_strip.o %s
+# RUN: llvm-jitlink -noexec -show-graph %t/elf_dead_strip.o | FileCheck %s
+#
+# Check that functions nothing refers to are dead-stripped along with their
+# FDEs, and that the eh-frame records of the live functions are kept.
+#
+# main is live and calls used. Nothing refers to unused, so its section and
+# its FDE are dropped. The eh-frame keeps its CIE, the FDEs of main and used,
+# and the terminator.
+#
+# CHECK-LABEL: Defined atoms:
+# CHECK-NOT:   section=.text.unused
+# CHECK-COUNT-4: {{^}}  0x{{[0-9a-f]+}}: <anon@0x{{[0-9a-f]+}} [ section=.eh_frame
+# CHECK-NOT:   {{^}}  0x{{[0-9a-f]+}}: <anon@0x{{[0-9a-f]+}} [ section=.eh_frame
+# CHECK-NOT:   section=.text.unused
+# CHECK:       Absolute atoms:
+
+        .section        .text.main,"ax",@progbits
+        .globl  main
+        .p2align        4, 0x90
+        .type   main,@function
+main:
+        .cfi_startproc
+        callq   used
+        xorl    %eax, %eax
+        retq
+        .cfi_endproc
+
+        .section        .text.used,"ax",@progbits
+        .p2align        4, 0x90
+        .type   used,@function
+used:
+        .cfi_startproc
+        retq
+        .cfi_endproc
+
+        .section        .text.unused,"ax",@progbits
+        .p2align        4, 0x90
+        .type   unused,@function
+unused:
+        .cfi_startproc
+        retq
+        .cfi_endproc
@@ -0,0 +1,56 @@
+# RUN: rm -rf %t && mkdir -p %t
+# RUN: llvm-mc -triple=x86_64-unknown-linux -position-independent \
+# RUN:   -filetype=obj -o %t/elf_got_relax.o %s
+# RUN: llvm-jitlink -noexec -check=%s %t/elf_got_relax.o
+#
+# Check that loads, calls and jumps through the GOT are relaxed to direct
+# references when the target is in range, and that other instructions keep
+# reading the GOT entry.
+
+        .text
+        .globl  main
+        .p2align        4, 0x90
+        .type   main,@function
+main:
+        retq
+
+# 'mov bar@GOTPCREL(%rip), %rax' becomes 'lea bar(%rip), %rax'.
+#
+# jitlink-check: *{1}(test_mov + 1) = 0x8d
+# jitlink-check: decode_operand(test_mov, 4) = bar - next_pc(test_mov)
+        .globl  test_mov
+test_mov:
+        movq    bar@GOTPCREL(%rip), %rax
+
+# 'call *bar@GOTPCREL(%rip)' becomes 'addr32 call bar'.
+#
+# jitlink-check: *{1}test_call = 0x67
+# jitlink-check: *{1}(test_call + 1) = 0xe8
+# jitlink-check: *{4}(test_call + 2) = bar - (test_call + 6)
+        .globl  test_call
+test_call:
+        callq   *bar@GOTPCREL(%rip)
+
+# 'jmp *bar@GOTPCREL(%rip)' becomes 'jmp bar; nop'.
+#
+# jitlink-check: *{1}test_jmp = 0xe9
+# jitlink-check: *{4}(test_jmp + 1) = bar - (test_jmp + 5)
+# jitlink-check: *{1}(test_jmp + 5) = 0x90
+        .globl  test_jmp
+test_jmp:
+        jmpq    *bar@GOTPCREL(%rip)
+
+# A test against the GOT entry can not be relaxed to a PC-relative form, so
+# it still reads the GOT entry.
+#
+# jitlink-check: *{1}(test_test + 1) = 0x85
+# jitlink-check: decode_operand(test_test, 3) = got_addr(elf_got_relax.o, bar) - next_pc(test_test)
+        .globl  test_test
+test_test:
+        testq   %rax, bar@GOTPCREL(%rip)
+
+        .globl  bar
+        .p2align        4, 0x90
+        .type   bar,@function
+bar:
+        retq
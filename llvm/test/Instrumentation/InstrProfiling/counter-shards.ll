@@ -0,0 +1,72 @@
+; RUN: opt < %s -S -instrprof -instrprof-counter-shards | FileCheck %s
+; RUN: opt < %s -S -passes=instrprof -instrprof-counter-shards | FileCheck %s
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@__profn_foo = private constant [3 x i8] c"foo"
+@__profn_bar = private constant [3 x i8] c"bar"
+
+; CHECK: @__llvm_profile_counter_shard_bias = external hidden thread_local global i64
+
+; The bias is loaded after the allocas of the entry block, and the shard is
+; acquired only when it is still zero.
+; CHECK-LABEL: define void @foo()
+; CHECK-NEXT:  entry:
+; CHECK-NEXT:    %x = alloca i32
+; CHECK-NEXT:    %[[BIAS:[0-9]+]] = load i64, i64* @__llvm_profile_counter_shard_bias
+; CHECK-NEXT:    %[[NOSHARD:[0-9]+]] = icmp eq i64 %[[BIAS]], 0
+; CHECK-NEXT:    br i1 %[[NOSHARD]], label %[[ACQUIRE:[0-9]+]], label %[[TAIL:[0-9]+]], !prof ![[WEIGHTS:[0-9]+]]
+; CHECK:       [[ACQUIRE]]:
+; CHECK-NEXT:    %[[NEWBIAS:[0-9]+]] = call i64 @__llvm_profile_acquire_counter_shard()
+; CHECK-NEXT:    br label %[[TAIL]]
+; CHECK:       [[TAIL]]:
+; CHECK-NEXT:    %[[PHI:[0-9]+]] = phi i64 [ %[[BIAS]], %entry ], [ %[[NEWBIAS]], %[[ACQUIRE]] ]
+; CHECK-NEXT:    %[[ADD:[0-9]+]] = add i64 ptrtoint ([1 x i64]* @__profc_foo to i64), %[[PHI]]
+; CHECK-NEXT:    %[[ADDR:[0-9]+]] = inttoptr i64 %[[ADD]] to i64*
+; CHECK-NEXT:    %pgocount = load i64, i64* %[[ADDR]]
+; CHECK-NEXT:    %[[COUNT:[0-9]+]] = add i64 %pgocount, 1
+; CHECK-NEXT:    store i64 %[[COUNT]], i64* %[[ADDR]]
+; CHECK-NEXT:    store i32 0, i32* %x
+; CHECK-NEXT:    ret void
+define void @foo() {
+entry:
+  %x = alloca i32
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_foo, i32 0, i32 0), i64 0, i32 1, i32 0)
+  store i32 0, i32* %x
+  ret void
+}
+
+; A function without counter updates does not touch the shard.
+; CHECK-LABEL: define void @baz()
+; CHECK-NEXT:  entry:
+; CHECK-NEXT:    ret void
+define void @baz() {
+entry:
+  ret void
+}
+
+; Every counter of a function uses the same bias.
+; CHECK-LABEL: define void @bar(i1 %c)
+; CHECK:         %[[BARPHI:[0-9]+]] = phi i64
+; CHECK:         add i64 ptrtoint ([2 x i64]* @__profc_bar to i64), %[[BARPHI]]
+; CHECK:       then:
+; CHECK-NEXT:    add i64 ptrtoint (i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_bar, i64 0, i64 1) to i64), %[[BARPHI]]
+define void @bar(i1 %c) {
+entry:
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_bar, i32 0, i32 0), i64 0, i32 2, i32 0)
+  br i1 %c, label %then, label %exit
+
+then:
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_bar, i32 0, i32 0), i64 0, i32 2, i32 1)
+  br label %exit
+
+exit:
+  ret void
+}
+
+; CHECK: declare i64 @__llvm_profile_acquire_counter_shard() #[[ATTRS:[0-9]+]]
+; CHECK: attributes #[[ATTRS]] = { nounwind }
+; CHECK: ![[WEIGHTS]] = !{!"branch_weights", i32 1, i32 1048575}
+
+declare void @llvm.instrprof.increment(i8*, i64, i32, i32)
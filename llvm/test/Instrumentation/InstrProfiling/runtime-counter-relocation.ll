@@ -0,0 +1,73 @@
+; RUN: opt < %s -S -instrprof | FileCheck %s --check-prefix=NORELOC
+; RUN: opt < %s -S -instrprof -runtime-counter-relocation | FileCheck %s --check-prefix=RELOC
+; RUN: opt < %s -S -instrprof -runtime-counter-relocation -do-counter-promotion \
+; RUN:   | FileCheck %s --check-prefix=PROMO
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@__profn_foo = private constant [3 x i8] c"foo"
+@__profn_bar = private constant [3 x i8] c"bar"
+
+; NORELOC-NOT: __llvm_profile_counter_bias
+; RELOC: @__llvm_profile_counter_bias = linkonce_odr hidden global i64 0
+
+; Without relocation, the counter is updated in place.
+; NORELOC-LABEL: define void @foo()
+; NORELOC-NEXT:  %pgocount = load i64, i64* getelementptr inbounds ([1 x i64], [1 x i64]* @__profc_foo, i64 0, i64 0)
+; NORELOC-NEXT:  %[[COUNT:[0-9]+]] = add i64 %pgocount, 1
+; NORELOC-NEXT:  store i64 %[[COUNT]], i64* getelementptr inbounds ([1 x i64], [1 x i64]* @__profc_foo, i64 0, i64 0)
+
+; With relocation, the bias is loaded once at the start of the function and
+; added to the address of each counter.
+; RELOC-LABEL: define void @foo()
+; RELOC-NEXT:  %[[BIAS:[0-9]+]] = load i64, i64* @__llvm_profile_counter_bias
+; RELOC-NEXT:  %[[ADD:[0-9]+]] = add i64 ptrtoint ([1 x i64]* @__profc_foo to i64), %[[BIAS]]
+; RELOC-NEXT:  %[[ADDR:[0-9]+]] = inttoptr i64 %[[ADD]] to i64*
+; RELOC-NEXT:  %pgocount = load i64, i64* %[[ADDR]]
+; RELOC-NEXT:  %[[COUNT:[0-9]+]] = add i64 %pgocount, 1
+; RELOC-NEXT:  store i64 %[[COUNT]], i64* %[[ADDR]]
+define void @foo() {
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_foo, i32 0, i32 0), i64 0, i32 1, i32 0)
+  ret void
+}
+
+; The update promoted out of the loop recomputes the relocated address in the
+; exit block, from the bias loaded in the entry block: the address computed in
+; the loop body does not dominate the exit.
+; PROMO-LABEL: define void @bar(i32 %n)
+; PROMO-NEXT:  entry:
+; PROMO-NEXT:    %[[BIAS:[0-9]+]] = load i64, i64* @__llvm_profile_counter_bias
+; PROMO:       body:
+; PROMO-NOT:     store
+; PROMO:       exit:
+; PROMO-NEXT:    %[[ADD:[0-9]+]] = add i64 ptrtoint ([1 x i64]* @__profc_bar to i64), %[[BIAS]]
+; PROMO-NEXT:    %[[ADDR:[0-9]+]] = inttoptr i64 %[[ADD]] to i64*
+; PROMO-NEXT:    %pgocount.promoted = load i64, i64* %[[ADDR]]
+; PROMO-NEXT:    %[[COUNT:[0-9]+]] = add i64 %pgocount.promoted, %{{.*}}
+; PROMO-NEXT:    store i64 %[[COUNT]], i64* %[[ADDR]]
+; PROMO-NEXT:    ret void
+define void @bar(i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %latch ]
+  %odd = and i32 %i, 1
+  %cond = icmp ne i32 %odd, 0
+  br i1 %cond, label %body, label %latch
+
+body:
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_bar, i32 0, i32 0), i64 0, i32 1, i32 0)
+  br label %latch
+
+latch:
+  %i.next = add nsw i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  ret void
+}
+
+declare void @llvm.instrprof.increment(i8*, i64, i32, i32)
@@ -0,0 +1,39 @@
+; Test -sanitizer-coverage-inline-bool-flag=1
+; RUN: opt < %s -sancov -sanitizer-coverage-level=1 -sanitizer-coverage-inline-bool-flag=1 -S | FileCheck %s
+; RUN: opt < %s -passes='module(sancov-module),function(sancov-func)' -sanitizer-coverage-level=1 -sanitizer-coverage-inline-bool-flag=1 -S | FileCheck %s
+; RUN: opt < %s -sancov -sanitizer-coverage-level=1 -sanitizer-coverage-inline-bool-flag=1 -sanitizer-coverage-pc-table=1 -S | FileCheck %s --check-prefix=PCS
+
+; CHECK-DAG: @__sancov_gen_ = private global [1 x i1] zeroinitializer, section "__sancov_bools", comdat($foo), align 1
+; CHECK-DAG: @__start___sancov_bools = external hidden global i1*
+; CHECK-DAG: @__stop___sancov_bools = external hidden global i1*
+; CHECK-DAG: @llvm.global_ctors = appending global [1 x { i32, void ()*, i8* }] [{ i32, void ()*, i8* } { i32 2, void ()* @sancov.module_ctor_bool_flag, i8* bitcast (void ()* @sancov.module_ctor_bool_flag to i8*) }]
+; CHECK-DAG: @llvm.compiler.used = appending global [1 x i8*] [i8* bitcast ([1 x i1]* @__sancov_gen_ to i8*)], section "llvm.metadata"
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; The flag is only stored to while it is still false.
+; CHECK-LABEL: define void @foo()
+; CHECK-NEXT:  entry:
+; CHECK-NEXT:    %0 = load i1, i1* getelementptr inbounds ([1 x i1], [1 x i1]* @__sancov_gen_, i64 0, i64 0), !nosanitize
+; CHECK-NEXT:    %1 = icmp eq i1 %0, false
+; CHECK-NEXT:    br i1 %1, label %2, label %3
+; CHECK:       2:
+; CHECK-NEXT:    store i1 true, i1* getelementptr inbounds ([1 x i1], [1 x i1]* @__sancov_gen_, i64 0, i64 0), !nosanitize
+; CHECK-NEXT:    br label %3
+; CHECK:       3:
+; CHECK-NEXT:    ret void
+define void @foo() {
+entry:
+  ret void
+}
+
+; CHECK-LABEL: define internal void @sancov.module_ctor_bool_flag()
+; CHECK-NEXT:    call void @__sanitizer_cov_bool_flag_init(i1* bitcast (i1** @__start___sancov_bools to i1*), i1* bitcast (i1** @__stop___sancov_bools to i1*))
+; CHECK-NEXT:    ret void
+
+; PCS:      @__sancov_gen_.1 = private constant [2 x i64*] [i64* bitcast (void ()* @foo to i64*), i64* inttoptr (i64 1 to i64*)], section "__sancov_pcs", comdat($foo), align 8
+; PCS-LABEL: define internal void @sancov.module_ctor_bool_flag()
+; PCS-NEXT:    call void @__sanitizer_cov_bool_flag_init(i1* bitcast (i1** @__start___sancov_bools to i1*), i1* bitcast (i1** @__stop___sancov_bools to i1*))
+; PCS-NEXT:    call void @__sanitizer_cov_pcs_init(i64* bitcast (i64** @__start___sancov_pcs to i64*), i64* bitcast (i64** @__stop___sancov_pcs to i64*))
+; PCS-NEXT:    ret void
@@ -0,0 +1,55 @@
+# REQUIRES: zlib
+# Encoding and compressing the sections in parallel must give the same object
+# file as doing it one section at a time.
+
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.o
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.par.o \
+# RUN:   -mc-parallel-section-data
+# RUN: cmp %t.o %t.par.o
+
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.z.o \
+# RUN:   -compress-debug-sections=zlib
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.z.par.o \
+# RUN:   -compress-debug-sections=zlib -mc-parallel-section-data
+# RUN: cmp %t.z.o %t.z.par.o
+# RUN: llvm-readelf -S %t.z.par.o | FileCheck %s --check-prefix=ZLIB
+
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.gnu.o \
+# RUN:   -compress-debug-sections=zlib-gnu
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.gnu.par.o \
+# RUN:   -compress-debug-sections=zlib-gnu -mc-parallel-section-data
+# RUN: cmp %t.gnu.o %t.gnu.par.o
+# RUN: llvm-readelf -S %t.gnu.par.o | FileCheck %s --check-prefix=GNU
+
+## .debug_str is too small to be worth compressing.
+# ZLIB: .debug_info PROGBITS {{[0-9a-f]+}} {{[0-9a-f]+}} {{[0-9a-f]+}} 00 C
+# ZLIB: .debug_str  PROGBITS {{[0-9a-f]+}} {{[0-9a-f]+}} {{[0-9a-f]+}} 01 MS
+
+# GNU: .zdebug_info PROGBITS
+# GNU: .debug_str   PROGBITS
+
+.text
+.globl foo
+foo:
+  movl $1, %eax
+  jmp bar
+  ret
+
+bar:
+  .rept 16
+  nop
+  .endr
+  ret
+
+.data
+  .quad foo
+  .long 42
+
+.section .debug_info,"",@progbits
+  .rept 64
+  .long 0x01020304
+  .endr
+  .quad bar
+
+.section .debug_str,"MS",@progbits,1
+  .asciz "str"
@@ -0,0 +1,42 @@
+# Branches back to a label earlier in the same data fragment are emitted as
+# data when their short form already fits. The output must be the same as
+# with relaxable fragments.
+
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.o
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o %t.frag.o \
+# RUN:   -mc-emit-resolved-relaxable-as-data=false
+# RUN: cmp %t.o %t.frag.o
+# RUN: llvm-objdump -d %t.o | FileCheck %s
+
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o /dev/null \
+# RUN:   -stats 2>&1 | FileCheck %s --check-prefix=STATS
+# RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o /dev/null \
+# RUN:   -mc-emit-resolved-relaxable-as-data=false -stats 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=NOSTATS
+# REQUIRES: asserts
+
+# STATS: 2 mc - Number of relaxable instructions emitted as data
+# NOSTATS-NOT: Number of relaxable instructions emitted as data
+
+# CHECK:      0: 90 nop
+# CHECK-NEXT: 1: eb fd jmp
+# CHECK-NEXT: 3: 75 fb jne
+# CHECK-NEXT: 5: eb 00 jmp
+# CHECK-NEXT: 7: 90 nop
+# CHECK:      cf: e9 33 ff ff ff jmp
+
+  .text
+.Lback:
+  nop
+  # Resolved and in range: emitted as data.
+  jmp .Lback
+  jne .Lback
+  # Forward: the target isn't known yet, so this stays relaxable.
+  jmp .Lfwd
+.Lfwd:
+.Lfar:
+  .rept 200
+  nop
+  .endr
+  # Resolved but out of range of the short form: relaxed as before.
+  jmp .Lfar
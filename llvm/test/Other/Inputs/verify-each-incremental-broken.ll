@@ -0,0 +1,13 @@
+define i32 @ok(i32 %a) {
+entry:
+  %x = add i32 %a, 1
+  ret i32 %x
+}
+
+; %y is used before it is defined.
+define i32 @broken(i32 %a) {
+entry:
+  %x = add i32 %y, 1
+  %y = add i32 %a, 1
+  ret i32 %x
+}
@@ -0,0 +1,43 @@
+; With -npm-cold-functions-at-o1, a function that the profile shows is cold
+; gets the O1 function simplification pipeline, which doesn't run GVN. A
+; function without a known entry count keeps the O2 one.
+; RUN: opt -disable-output -debug-pass-manager -passes='default<O2>' \
+; RUN:   -pgo-kind=pgo-sample-use-pipeline \
+; RUN:   -profile-file=%S/Inputs/new-pm-cold-functions-at-o1.prof \
+; RUN:   -npm-cold-functions-at-o1 %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=COLD --implicit-check-not='GVN on cold'
+; RUN: opt -disable-output -debug-pass-manager -passes='default<O2>' \
+; RUN:   -pgo-kind=pgo-sample-use-pipeline \
+; RUN:   -profile-file=%S/Inputs/new-pm-cold-functions-at-o1.prof %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DEFAULT
+
+;; Without a profile the option has no effect.
+; RUN: opt -disable-output -debug-pass-manager -passes='default<O2>' \
+; RUN:   -npm-cold-functions-at-o1 %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DEFAULT
+
+; COLD-DAG: Running pass: {{.*}}ColdFunctionPipelineSelector on cold
+; COLD-DAG: Running pass: {{.*}}ColdFunctionPipelineSelector on unknown
+; COLD-DAG: Running pass: GVN on unknown
+
+; DEFAULT-NOT: ColdFunctionPipelineSelector
+; DEFAULT-DAG: Running pass: GVN on cold
+; DEFAULT-DAG: Running pass: GVN on unknown
+
+;; The sample profile loader gives functions that are not in the profile an
+;; entry count of 0 only with profile-sample-accurate.
+define i32 @cold(i32* %p) #0 {
+  %a = load i32, i32* %p
+  %b = load i32, i32* %p
+  %c = add i32 %a, %b
+  ret i32 %c
+}
+
+define i32 @unknown(i32* %p) {
+  %a = load i32, i32* %p
+  %b = load i32, i32* %p
+  %c = add i32 %a, %b
+  ret i32 %c
+}
+
+attributes #0 = { "profile-sample-accurate" }
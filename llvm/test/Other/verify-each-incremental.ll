@@ -0,0 +1,61 @@
+; REQUIRES: asserts
+; RUN: opt -disable-verify -verify-each-incremental -debug-only=verify-each-incremental \
+; RUN:   -passes=no-op-module -disable-output %s 2>&1 | FileCheck %s --check-prefix=MODULE
+; RUN: opt -disable-verify -verify-each-incremental -debug-only=verify-each-incremental \
+; RUN:   -passes=no-op-function -disable-output %s 2>&1 | FileCheck %s --check-prefix=FUNCTION
+; RUN: opt -disable-verify -verify-each-incremental -debug-only=verify-each-incremental \
+; RUN:   -passes='cgscc(no-op-cgscc)' -disable-output %s 2>&1 | FileCheck %s --check-prefix=CGSCC
+; RUN: opt -disable-verify -verify-each-incremental -debug-only=verify-each-incremental \
+; RUN:   -passes='loop(no-op-loop)' -disable-output %s 2>&1 | FileCheck %s --check-prefix=LOOP
+
+; A broken function is still caught by the pass that ran on it.
+; RUN: not opt -disable-verify -verify-each-incremental -debug-only=verify-each-incremental \
+; RUN:   -passes=no-op-function -disable-output %p/Inputs/verify-each-incremental-broken.ll \
+; RUN:   2>&1 | FileCheck %s --check-prefix=BROKEN
+
+; MODULE:     Verifying module after NoOpModulePass
+; MODULE-NOT: Verifying function
+
+; FUNCTION-NOT:  Verifying module
+; FUNCTION:      Verifying function loop after NoOpFunctionPass
+; FUNCTION-NEXT: Verifying function noloop after NoOpFunctionPass
+; FUNCTION-NOT:  Verifying
+
+; CGSCC-NOT: Verifying module
+; CGSCC-DAG: Verifying function loop after NoOpCGSCCPass
+; CGSCC-DAG: Verifying function noloop after NoOpCGSCCPass
+
+; A loop pass only verifies the function that contains the loop.
+; LOOP-NOT: Verifying module
+; LOOP-NOT: Verifying function noloop after NoOpLoopPass
+; LOOP:     Verifying function loop after NoOpLoopPass
+; LOOP-NOT: Verifying function noloop after NoOpLoopPass
+; LOOP-NOT: Verifying module
+
+; BROKEN:      Verifying function ok after NoOpFunctionPass
+; BROKEN-NEXT: Verifying function broken after NoOpFunctionPass
+; BROKEN-NEXT: Instruction does not dominate all uses!
+; BROKEN:      LLVM ERROR: Broken function broken found after pass NoOpFunctionPass
+
+declare void @ext()
+
+define void @loop(i32 %n) {
+entry:
+  br label %header
+
+header:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %header ]
+  call void @ext()
+  %i.next = add i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %header
+
+exit:
+  ret void
+}
+
+define void @noloop() {
+entry:
+  call void @ext()
+  ret void
+}
@@ -0,0 +1,90 @@
+; Check that the index-based devirtualization, which searches the targets of
+; the call slots in parallel, resolves every slot, and resolves it the same
+; way in every run.
+
+; RUN: opt -thinlto-bc -o %t.o %s
+
+; RUN: llvm-lto2 run %t.o -o %t.run1 -thinlto-distributed-indexes \
+; RUN:   -wholeprogramdevirt-print-index-based \
+; RUN:   -r=%t.o,test,px -r=%t.o,_ZN1A1fEi,p -r=%t.o,_ZN1A1gEi,p \
+; RUN:   -r=%t.o,_ZN1B1fEi,p -r=%t.o,_ZN1B1gEi,p \
+; RUN:   -r=%t.o,_ZTV1A,px -r=%t.o,_ZTV1B,px 2>&1 | FileCheck %s
+; RUN: llvm-dis -o %t.index1.ll %t.o.thinlto.bc
+; RUN: FileCheck %s --check-prefix=INDEX < %t.index1.ll
+
+; RUN: llvm-lto2 run %t.o -o %t.run2 -thinlto-distributed-indexes \
+; RUN:   -wholeprogramdevirt-print-index-based \
+; RUN:   -r=%t.o,test,px -r=%t.o,_ZN1A1fEi,p -r=%t.o,_ZN1A1gEi,p \
+; RUN:   -r=%t.o,_ZN1B1fEi,p -r=%t.o,_ZN1B1gEi,p \
+; RUN:   -r=%t.o,_ZTV1A,px -r=%t.o,_ZTV1B,px 2>&1 | FileCheck %s
+; RUN: llvm-dis -o - %t.o.thinlto.bc | diff %t.index1.ll -
+
+; Each of the four slots has a single implementation.
+; CHECK-DAG: Devirtualized call to {{.*}} (_ZN1A1fEi)
+; CHECK-DAG: Devirtualized call to {{.*}} (_ZN1A1gEi)
+; CHECK-DAG: Devirtualized call to {{.*}} (_ZN1B1fEi)
+; CHECK-DAG: Devirtualized call to {{.*}} (_ZN1B1gEi)
+
+; INDEX-DAG: typeid: (name: "_ZTS1A", summary: (typeTestRes: (kind: {{.*}}), wpdResolutions: ((offset: 0, wpdRes: (kind: singleImpl, singleImplName: "_ZN1A1fEi")), (offset: 8, wpdRes: (kind: singleImpl, singleImplName: "_ZN1A1gEi")))))
+; INDEX-DAG: typeid: (name: "_ZTS1B", summary: (typeTestRes: (kind: {{.*}}), wpdResolutions: ((offset: 0, wpdRes: (kind: singleImpl, singleImplName: "_ZN1B1fEi")), (offset: 8, wpdRes: (kind: singleImpl, singleImplName: "_ZN1B1gEi")))))
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+%struct.A = type { i32 (...)** }
+%struct.B = type { i32 (...)** }
+
+@_ZTV1A = constant { [4 x i8*] } { [4 x i8*] [i8* null, i8* undef, i8* bitcast (i32 (%struct.A*, i32)* @_ZN1A1fEi to i8*), i8* bitcast (i32 (%struct.A*, i32)* @_ZN1A1gEi to i8*)] }, !type !0
+@_ZTV1B = constant { [4 x i8*] } { [4 x i8*] [i8* null, i8* undef, i8* bitcast (i32 (%struct.B*, i32)* @_ZN1B1fEi to i8*), i8* bitcast (i32 (%struct.B*, i32)* @_ZN1B1gEi to i8*)] }, !type !1
+
+define i32 @test(%struct.A* %a, %struct.B* %b, i32 %x) {
+entry:
+  %a.vtableptr = bitcast %struct.A* %a to i8***
+  %a.vtable = load i8**, i8*** %a.vtableptr
+  %a.vtable.i8 = bitcast i8** %a.vtable to i8*
+  %a.test = call i1 @llvm.type.test(i8* %a.vtable.i8, metadata !"_ZTS1A")
+  call void @llvm.assume(i1 %a.test)
+  %a.f.ptrptr = bitcast i8** %a.vtable to i32 (%struct.A*, i32)**
+  %a.f = load i32 (%struct.A*, i32)*, i32 (%struct.A*, i32)** %a.f.ptrptr
+  %call1 = call i32 %a.f(%struct.A* %a, i32 %x)
+  %a.g.slot = getelementptr i8*, i8** %a.vtable, i64 1
+  %a.g.ptrptr = bitcast i8** %a.g.slot to i32 (%struct.A*, i32)**
+  %a.g = load i32 (%struct.A*, i32)*, i32 (%struct.A*, i32)** %a.g.ptrptr
+  %call2 = call i32 %a.g(%struct.A* %a, i32 %call1)
+
+  %b.vtableptr = bitcast %struct.B* %b to i8***
+  %b.vtable = load i8**, i8*** %b.vtableptr
+  %b.vtable.i8 = bitcast i8** %b.vtable to i8*
+  %b.test = call i1 @llvm.type.test(i8* %b.vtable.i8, metadata !"_ZTS1B")
+  call void @llvm.assume(i1 %b.test)
+  %b.f.ptrptr = bitcast i8** %b.vtable to i32 (%struct.B*, i32)**
+  %b.f = load i32 (%struct.B*, i32)*, i32 (%struct.B*, i32)** %b.f.ptrptr
+  %call3 = call i32 %b.f(%struct.B* %b, i32 %call2)
+  %b.g.slot = getelementptr i8*, i8** %b.vtable, i64 1
+  %b.g.ptrptr = bitcast i8** %b.g.slot to i32 (%struct.B*, i32)**
+  %b.g = load i32 (%struct.B*, i32)*, i32 (%struct.B*, i32)** %b.g.ptrptr
+  %call4 = call i32 %b.g(%struct.B* %b, i32 %call3)
+  ret i32 %call4
+}
+
+define i32 @_ZN1A1fEi(%struct.A* %this, i32 %a) {
+  ret i32 0
+}
+
+define i32 @_ZN1A1gEi(%struct.A* %this, i32 %a) {
+  ret i32 1
+}
+
+define i32 @_ZN1B1fEi(%struct.B* %this, i32 %a) {
+  ret i32 2
+}
+
+define i32 @_ZN1B1gEi(%struct.B* %this, i32 %a) {
+  ret i32 3
+}
+
+declare i1 @llvm.type.test(i8*, metadata)
+declare void @llvm.assume(i1)
+
+!0 = !{i64 16, !"_ZTS1A"}
+!1 = !{i64 16, !"_ZTS1B"}
@@ -0,0 +1,45 @@
+; REQUIRES: asserts
+; Check that -import-cutoff limits the imports of all modules together, and
+; that the same functions are imported in every run, although the import
+; lists of the modules are otherwise computed in parallel.
+
+; RUN: opt -module-summary %s -o %t1.bc
+; RUN: opt -module-summary %p/Inputs/import-cutoff-parallel-2.ll -o %t2.bc
+; RUN: opt -module-summary %p/Inputs/import-cutoff-parallel-lib.ll -o %t3.bc
+
+; RUN: llvm-lto2 run %t1.bc %t2.bc %t3.bc -o %t.run1 -thinlto-threads=4 \
+; RUN:   -thinlto-distributed-indexes -import-cutoff=1 -stats \
+; RUN:   -r %t1.bc,main1,plx -r %t1.bc,foo, -r %t1.bc,bar, \
+; RUN:   -r %t2.bc,main2,plx -r %t2.bc,foo, -r %t2.bc,bar, \
+; RUN:   -r %t3.bc,foo,pl -r %t3.bc,bar,pl 2>&1 | FileCheck %s
+; RUN: cat %t1.bc.imports %t2.bc.imports > %t.imports1
+; RUN: llvm-dis -o %t.index1.ll %t1.bc.thinlto.bc
+; RUN: llvm-dis -o %t.index2.ll %t2.bc.thinlto.bc
+
+; RUN: llvm-lto2 run %t1.bc %t2.bc %t3.bc -o %t.run2 -thinlto-threads=4 \
+; RUN:   -thinlto-distributed-indexes -import-cutoff=1 -stats \
+; RUN:   -r %t1.bc,main1,plx -r %t1.bc,foo, -r %t1.bc,bar, \
+; RUN:   -r %t2.bc,main2,plx -r %t2.bc,foo, -r %t2.bc,bar, \
+; RUN:   -r %t3.bc,foo,pl -r %t3.bc,bar,pl 2>&1 | FileCheck %s
+; RUN: cat %t1.bc.imports %t2.bc.imports > %t.imports2
+; RUN: cmp %t.imports1 %t.imports2
+; RUN: llvm-dis -o - %t1.bc.thinlto.bc | diff %t.index1.ll -
+; RUN: llvm-dis -o - %t2.bc.thinlto.bc | diff %t.index2.ll -
+
+; Only one of the four calls is imported, so only one module imports from the
+; library.
+; RUN: count 1 < %t.imports1
+
+; CHECK: 1 function-import - Number of functions thin link decided to import
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @foo()
+declare void @bar()
+
+define void @main1() {
+  call void @foo()
+  call void @bar()
+  ret void
+}
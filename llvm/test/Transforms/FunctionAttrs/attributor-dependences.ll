@@ -0,0 +1,118 @@
+; RUN: opt -attributor -attributor-disable=false -attributor-verify -S < %s \
+; RUN:   | FileCheck %s
+; RUN: opt -attributor -attributor-disable=false -attributor-max-iterations=1 \
+; RUN:   -S < %s | FileCheck %s --check-prefix=LIMIT
+; RUN: opt -attributor -attributor-disable=false -stats -disable-output \
+; RUN:   < %s 2>&1 | FileCheck %s --check-prefix=STATS
+; RUN: opt -attributor -attributor-disable=false -attributor-max-iterations=1 \
+; RUN:   -stats -disable-output < %s 2>&1 | FileCheck %s --check-prefix=LIMIT-STATS
+; REQUIRES: asserts
+
+; The attributes of a cycle of calls hold if every function in it only calls
+; the others. An attribute that changes puts the ones that queried it back on
+; the worklist, which record the dependences they still have.
+
+; CHECK:      Function Attrs: nofree nosync nounwind
+; CHECK-NEXT: define void @f1(
+; CHECK:      Function Attrs: nofree nosync nounwind
+; CHECK-NEXT: define void @f2(
+; CHECK:      Function Attrs: nofree nosync nounwind
+; CHECK-NEXT: define void @f3(
+
+; A call to an unknown function in the cycle invalidates the attributes of all
+; of its functions, also when the fixpoint iteration stops early.
+
+; CHECK-NOT:  Function Attrs
+; CHECK:      define void @t1(
+; CHECK-NOT:  Function Attrs
+; CHECK:      define void @t2(
+; CHECK-NOT:  Function Attrs
+; CHECK:      define void @t3(
+
+; LIMIT:      define void @f3(
+; LIMIT-NOT:  Function Attrs: {{.*}}nounwind
+; LIMIT:      define void @t1(
+; LIMIT-NOT:  Function Attrs: {{.*}}nounwind
+; LIMIT:      define void @t2(
+; LIMIT-NOT:  Function Attrs: {{.*}}nounwind
+; LIMIT:      define void @t3(
+
+; STATS:     {{[1-9][0-9]*}} attributor - Number of fixpoint iterations{{$}}
+; STATS-NOT: attributor - Number of fixpoint iterations stopped at the iteration limit
+
+; LIMIT-STATS: 1 attributor - Number of fixpoint iterations stopped at the iteration limit
+
+define void @f1(i1 %c) {
+entry:
+  br i1 %c, label %call, label %exit
+
+call:
+  call void @f2(i1 %c)
+  br label %exit
+
+exit:
+  ret void
+}
+
+define void @f2(i1 %c) {
+entry:
+  br i1 %c, label %call, label %exit
+
+call:
+  call void @f3(i1 %c)
+  br label %exit
+
+exit:
+  ret void
+}
+
+define void @f3(i1 %c) {
+entry:
+  br i1 %c, label %call, label %exit
+
+call:
+  call void @f1(i1 %c)
+  br label %exit
+
+exit:
+  ret void
+}
+
+define void @t1(i1 %c) {
+entry:
+  br i1 %c, label %call, label %exit
+
+call:
+  call void @t2(i1 %c)
+  br label %exit
+
+exit:
+  ret void
+}
+
+define void @t2(i1 %c) {
+entry:
+  br i1 %c, label %call, label %exit
+
+call:
+  call void @t3(i1 %c)
+  br label %exit
+
+exit:
+  ret void
+}
+
+define void @t3(i1 %c) {
+entry:
+  br i1 %c, label %call, label %exit
+
+call:
+  call void @t1(i1 %c)
+  call void @unknown()
+  br label %exit
+
+exit:
+  ret void
+}
+
+declare void @unknown()
@@ -0,0 +1,50 @@
+; RUN: opt -gvn -S < %s | FileCheck %s --check-prefixes=CHECK,UNLIMITED
+; RUN: opt -gvn -gvn-max-nonlocal-load-deps=1 -S < %s \
+; RUN:   | FileCheck %s --check-prefixes=CHECK,LIMITED
+
+; Once a function has used up its budget of non-local load dependences, the
+; loads after that are left alone.
+define i32 @two_loads(i32* noalias %p, i32* noalias %q, i1 %c) {
+; CHECK-LABEL: @two_loads(
+; CHECK:       m:
+; UNLIMITED-NEXT: ret i32 3
+; LIMITED-NEXT:   [[Y:%.*]] = load i32, i32* %q
+; LIMITED-NEXT:   [[S:%.*]] = add i32 1, [[Y]]
+; LIMITED-NEXT:   ret i32 [[S]]
+entry:
+  store i32 1, i32* %p
+  store i32 2, i32* %q
+  br i1 %c, label %a, label %b
+
+a:
+  br label %m
+
+b:
+  br label %m
+
+m:
+  %x = load i32, i32* %p
+  %y = load i32, i32* %q
+  %s = add i32 %x, %y
+  ret i32 %s
+}
+
+; The budget is per function.
+define i32 @one_load(i32* %p, i1 %c) {
+; CHECK-LABEL: @one_load(
+; CHECK:       m:
+; CHECK-NEXT:    ret i32 1
+entry:
+  store i32 1, i32* %p
+  br i1 %c, label %a, label %b
+
+a:
+  br label %m
+
+b:
+  br label %m
+
+m:
+  %x = load i32, i32* %p
+  ret i32 %x
+}
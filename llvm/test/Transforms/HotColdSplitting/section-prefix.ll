@@ -0,0 +1,34 @@
+; RUN: opt -hotcoldsplit -hotcoldsplit-threshold=0 -S < %s \
+; RUN:   | FileCheck %s --check-prefix=NOPREFIX
+; RUN: opt -hotcoldsplit -hotcoldsplit-threshold=0 \
+; RUN:   -hotcoldsplit-cold-section-prefix -S < %s \
+; RUN:   | FileCheck %s --check-prefix=PREFIX
+
+; By default a split cold function gets no section prefix, so CodeGen emits it
+; into the same section as its parent. With -hotcoldsplit-cold-section-prefix
+; it is tagged .unlikely, and goes to .text.unlikely.
+
+; NOPREFIX-LABEL: define {{.*}}@foo.cold.1(
+; NOPREFIX-NOT:   !section_prefix
+
+; PREFIX-LABEL: define {{.*}}@foo(
+; PREFIX-NOT:   !section_prefix
+; PREFIX:       call {{.*}}@foo.cold.1(
+; PREFIX:       define {{.*}}@foo.cold.1() {{.*}}!section_prefix ![[PREFIX:[0-9]+]]
+; PREFIX:       ![[PREFIX]] = !{!"function_section_prefix", !".unlikely"}
+
+define void @foo(i32 %cond) {
+entry:
+  %tobool = icmp eq i32 %cond, 0
+  br i1 %tobool, label %if.end, label %if.then
+
+if.then:
+  call void @sink()
+  call void @sink()
+  br label %if.end
+
+if.end:
+  ret void
+}
+
+declare void @sink() cold
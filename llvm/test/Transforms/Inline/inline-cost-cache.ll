@@ -0,0 +1,161 @@
+; REQUIRES: asserts
+; RUN: opt -inline -stats -S < %s 2> %t.stats | FileCheck %s
+; RUN: FileCheck %s --check-prefix=STATS < %t.stats
+; RUN: opt -passes=inline -stats -S < %s 2> %t.stats | FileCheck %s
+; RUN: FileCheck %s --check-prefix=STATS < %t.stats
+
+; With missed-optimization remarks the costs are computed again, and the
+; decisions are the same.
+; RUN: opt -inline -stats -pass-remarks-missed=inline -S < %s 2> %t.stats \
+; RUN:   | FileCheck %s
+; RUN: FileCheck %s --check-prefix=REMARKS < %t.stats
+; RUN: opt -passes=inline -stats -pass-remarks-missed=inline -S < %s \
+; RUN:   2> %t.stats | FileCheck %s
+; RUN: FileCheck %s --check-prefix=REMARKS < %t.stats
+
+; Inlining @c into @b would make @b too big to inline into its callers, so
+; both calls to @c in @b are deferred. Each asks for the cost of the calls to
+; @b, which the second one reuses. @b is then inlined into its callers and @c
+; into them in turn.
+
+; CHECK-LABEL: define i32 @a1(
+; CHECK-NOT:   call
+; CHECK:       ret i32
+; CHECK-LABEL: define i32 @a2(
+; CHECK-NOT:   call
+; CHECK:       ret i32
+; CHECK-NOT:   define internal i32 @b(
+
+; STATS: {{[1-9][0-9]*}} inline - Number of inline costs reused
+
+; REMARKS-COUNT-2: Not inlining. Cost of inlining {{.*}}c{{.*}} increases the cost of inlining {{.*}}b{{.*}} in other contexts
+; REMARKS-NOT:     Number of inline costs reused
+
+define i32 @a1(i32 %x, i32 %y) {
+entry:
+  %r = call i32 @b(i32 %x, i32 %y)
+  ret i32 %r
+}
+
+define i32 @a2(i32 %x, i32 %y) {
+entry:
+  %r = call i32 @b(i32 %y, i32 %x)
+  ret i32 %r
+}
+
+define internal i32 @b(i32 %x, i32 %y) {
+entry:
+  %c1 = call i32 @c(i32 %x, i32 %y)
+  %c2 = call i32 @c(i32 %y, i32 %x)
+  %w0 = mul i32 %c1, %c2
+  %w1 = xor i32 %w0, %c2
+  %w2 = add i32 %w1, %c2
+  %w3 = sub i32 %w2, %c2
+  %w4 = mul i32 %w3, %c2
+  %w5 = xor i32 %w4, %c2
+  %w6 = add i32 %w5, %c2
+  %w7 = sub i32 %w6, %c2
+  %w8 = mul i32 %w7, %c2
+  %w9 = xor i32 %w8, %c2
+  %w10 = add i32 %w9, %c2
+  %w11 = sub i32 %w10, %c2
+  %w12 = mul i32 %w11, %c2
+  %w13 = xor i32 %w12, %c2
+  %w14 = add i32 %w13, %c2
+  %w15 = sub i32 %w14, %c2
+  %w16 = mul i32 %w15, %c2
+  %w17 = xor i32 %w16, %c2
+  %w18 = add i32 %w17, %c2
+  %w19 = sub i32 %w18, %c2
+  %w20 = mul i32 %w19, %c2
+  %w21 = xor i32 %w20, %c2
+  %w22 = add i32 %w21, %c2
+  %w23 = sub i32 %w22, %c2
+  %w24 = mul i32 %w23, %c2
+  %w25 = xor i32 %w24, %c2
+  %w26 = add i32 %w25, %c2
+  %w27 = sub i32 %w26, %c2
+  %w28 = mul i32 %w27, %c2
+  %w29 = xor i32 %w28, %c2
+  %w30 = add i32 %w29, %c2
+  %w31 = sub i32 %w30, %c2
+  %w32 = mul i32 %w31, %c2
+  %w33 = xor i32 %w32, %c2
+  %w34 = add i32 %w33, %c2
+  %w35 = sub i32 %w34, %c2
+  %w36 = mul i32 %w35, %c2
+  %w37 = xor i32 %w36, %c2
+  %w38 = add i32 %w37, %c2
+  %w39 = sub i32 %w38, %c2
+  %w40 = mul i32 %w39, %c2
+  %w41 = xor i32 %w40, %c2
+  %w42 = add i32 %w41, %c2
+  %w43 = sub i32 %w42, %c2
+  %w44 = mul i32 %w43, %c2
+  ret i32 %w44
+}
+
+define i32 @c(i32 %x, i32 %y) {
+entry:
+  %v0 = mul i32 %x, %y
+  %v1 = xor i32 %v0, %y
+  %v2 = add i32 %v1, %y
+  %v3 = sub i32 %v2, %y
+  %v4 = mul i32 %v3, %y
+  %v5 = xor i32 %v4, %y
+  %v6 = add i32 %v5, %y
+  %v7 = sub i32 %v6, %y
+  %v8 = mul i32 %v7, %y
+  %v9 = xor i32 %v8, %y
+  %v10 = add i32 %v9, %y
+  %v11 = sub i32 %v10, %y
+  %v12 = mul i32 %v11, %y
+  %v13 = xor i32 %v12, %y
+  %v14 = add i32 %v13, %y
+  %v15 = sub i32 %v14, %y
+  %v16 = mul i32 %v15, %y
+  %v17 = xor i32 %v16, %y
+  %v18 = add i32 %v17, %y
+  %v19 = sub i32 %v18, %y
+  %v20 = mul i32 %v19, %y
+  %v21 = xor i32 %v20, %y
+  %v22 = add i32 %v21, %y
+  %v23 = sub i32 %v22, %y
+  %v24 = mul i32 %v23, %y
+  %v25 = xor i32 %v24, %y
+  %v26 = add i32 %v25, %y
+  %v27 = sub i32 %v26, %y
+  %v28 = mul i32 %v27, %y
+  %v29 = xor i32 %v28, %y
+  %v30 = add i32 %v29, %y
+  %v31 = sub i32 %v30, %y
+  %v32 = mul i32 %v31, %y
+  %v33 = xor i32 %v32, %y
+  %v34 = add i32 %v33, %y
+  %v35 = sub i32 %v34, %y
+  %v36 = mul i32 %v35, %y
+  %v37 = xor i32 %v36, %y
+  %v38 = add i32 %v37, %y
+  %v39 = sub i32 %v38, %y
+  %v40 = mul i32 %v39, %y
+  %v41 = xor i32 %v40, %y
+  %v42 = add i32 %v41, %y
+  %v43 = sub i32 %v42, %y
+  %v44 = mul i32 %v43, %y
+  %v45 = xor i32 %v44, %y
+  %v46 = add i32 %v45, %y
+  %v47 = sub i32 %v46, %y
+  %v48 = mul i32 %v47, %y
+  %v49 = xor i32 %v48, %y
+  %v50 = add i32 %v49, %y
+  %v51 = sub i32 %v50, %y
+  %v52 = mul i32 %v51, %y
+  %v53 = xor i32 %v52, %y
+  %v54 = add i32 %v53, %y
+  %v55 = sub i32 %v54, %y
+  %v56 = mul i32 %v55, %y
+  %v57 = xor i32 %v56, %y
+  %v58 = add i32 %v57, %y
+  %v59 = sub i32 %v58, %y
+  ret i32 %v59
+}
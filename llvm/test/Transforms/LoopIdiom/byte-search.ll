@@ -0,0 +1,172 @@
+; RUN: opt -loop-idiom -S < %s | FileCheck %s
+; RUN: opt -passes=loop-idiom -S < %s | FileCheck %s
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; for (i = 0; s[i] != 0; ++i) ; return i;
+define i64 @strlen_loop(i8* %s) {
+; CHECK-LABEL: @strlen_loop(
+; CHECK:       entry:
+; CHECK-NEXT:    [[LEN:%.*]] = call i64 @strlen(i8* %s)
+; CHECK:       loop:
+; CHECK:         br i1 true, label %exit, label %loop
+; CHECK:         ret i64 [[LEN]]
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %i
+  %c = load i8, i8* %p, align 1
+  %i.next = add nuw i64 %i, 1
+  %z = icmp eq i8 %c, 0
+  br i1 %z, label %exit, label %loop
+
+exit:
+  %len = phi i64 [ %i, %loop ]
+  ret i64 %len
+}
+
+; for (i = 0; i != n; ++i) if (s[i] == c) return &s[i]; return 0;
+define i8* @memchr_loop(i8* %s, i8 %c, i64 %n) {
+; CHECK-LABEL: @memchr_loop(
+; CHECK:       entry:
+; CHECK:         [[CALL:%.*]] = call i8* @memchr(i8* %s, i32 {{%.*}}, i64 {{%.*}})
+; CHECK:         [[FOUND:%.*]] = icmp ne i8* [[CALL]], null
+; CHECK:         [[RES:%.*]] = select i1 [[FOUND]],
+; CHECK:       loop:
+; CHECK:         br i1 true, label %exit, label %latch
+; CHECK:         ret i8* [[RES]]
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %i
+  %v = load i8, i8* %p, align 1
+  %found = icmp eq i8 %v, %c
+  br i1 %found, label %exit, label %latch
+
+latch:
+  %i.next = add nuw i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i8* [ %p, %loop ], [ null, %latch ]
+  ret i8* %r
+}
+
+; The loop also stores, so it is not a pure search.
+define i64 @strlen_with_store(i8* %s, i8* %d) {
+; CHECK-LABEL: @strlen_with_store(
+; CHECK-NOT:     @strlen
+; CHECK:         ret i64
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %i
+  %c = load i8, i8* %p, align 1
+  store i8 %c, i8* %d, align 1
+  %i.next = add nuw i64 %i, 1
+  %z = icmp eq i8 %c, 0
+  br i1 %z, label %exit, label %loop
+
+exit:
+  %len = phi i64 [ %i, %loop ]
+  ret i64 %len
+}
+
+; Every other byte is read.
+define i64 @strlen_stride_two(i8* %s) {
+; CHECK-LABEL: @strlen_stride_two(
+; CHECK-NOT:     @strlen
+; CHECK:         ret i64
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %i
+  %c = load i8, i8* %p, align 1
+  %i.next = add nuw i64 %i, 2
+  %z = icmp eq i8 %c, 0
+  br i1 %z, label %exit, label %loop
+
+exit:
+  %len = phi i64 [ %i, %loop ]
+  ret i64 %len
+}
+
+; The value leaving the loop has a type SCEV does not model.
+define double @strlen_fp_exit_value(i8* %s) {
+; CHECK-LABEL: @strlen_fp_exit_value(
+; CHECK-NOT:     @strlen
+; CHECK:         ret double
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %f = phi double [ 0.0, %entry ], [ %f.next, %loop ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %i
+  %c = load i8, i8* %p, align 1
+  %i.next = add nuw i64 %i, 1
+  %f.next = fadd double %f, 1.0
+  %z = icmp eq i8 %c, 0
+  br i1 %z, label %exit, label %loop
+
+exit:
+  %r = phi double [ %f, %loop ]
+  ret double %r
+}
+
+; The value leaving the loop is not a recurrence.
+define i64 @strlen_non_addrec_exit_value(i8* %s) {
+; CHECK-LABEL: @strlen_non_addrec_exit_value(
+; CHECK-NOT:     @strlen
+; CHECK:         ret i64
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %i
+  %c = load i8, i8* %p, align 1
+  %x = xor i64 %i, 7
+  %i.next = add nuw i64 %i, 1
+  %z = icmp eq i8 %c, 0
+  br i1 %z, label %exit, label %loop
+
+exit:
+  %r = phi i64 [ %x, %loop ]
+  ret i64 %r
+}
+
+; The search looks for a value that changes in the loop.
+define i8* @memchr_variant_needle(i8* %s, i64 %n) {
+; CHECK-LABEL: @memchr_variant_needle(
+; CHECK-NOT:     @memchr
+; CHECK:         ret i8*
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %i
+  %v = load i8, i8* %p, align 1
+  %t = trunc i64 %i to i8
+  %found = icmp eq i8 %v, %t
+  br i1 %found, label %exit, label %latch
+
+latch:
+  %i.next = add nuw i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i8* [ %p, %loop ], [ null, %latch ]
+  ret i8* %r
+}
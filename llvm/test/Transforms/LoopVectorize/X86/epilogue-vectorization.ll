@@ -0,0 +1,115 @@
+; Test which loops get their scalar remainder vectorized again with
+; -enable-epilogue-vectorization, and the VF limit it uses.
+
+; RUN: opt -S -loop-vectorize -mattr=+avx2 -force-vector-interleave=1 \
+; RUN:   -enable-epilogue-vectorization < %s | FileCheck %s --check-prefix=EPI
+; RUN: opt -S -loop-vectorize -mattr=+avx2 -force-vector-interleave=1 \
+; RUN:   -enable-epilogue-vectorization -pass-remarks=loop-vectorize < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=REMARK
+
+; Without the option, or when the main VF is below
+; -epilogue-vectorization-min-vf, the remainder stays scalar.
+; RUN: opt -S -loop-vectorize -mattr=+avx2 -force-vector-interleave=1 \
+; RUN:   < %s | FileCheck %s --check-prefix=NOEPI
+; RUN: opt -S -loop-vectorize -mattr=+avx2 -force-vector-interleave=1 \
+; RUN:   -enable-epilogue-vectorization -epilogue-vectorization-min-vf=64 \
+; RUN:   < %s | FileCheck %s --check-prefix=NOEPI
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; The main loop uses the widest VF for i8 with AVX2, 32. Its remainder is
+; vectorized with a VF of at most half of that, and is not interleaved.
+; EPI-LABEL: @runtime_tc(
+; EPI:       vector.body:
+; EPI:         load <32 x i8>
+; EPI:         add <32 x i8>
+; EPI:         store <32 x i8>
+; EPI:       vector.body{{[0-9]+}}:
+; EPI:         load <16 x i8>
+; EPI:         add <16 x i8>
+; EPI:         store <16 x i8>
+; EPI-NOT:     store <16 x i8>
+
+; NOEPI-LABEL: @runtime_tc(
+; NOEPI:       store <32 x i8>
+; NOEPI-NOT:   <16 x i8>
+; NOEPI-LABEL: @short_remainder(
+
+; REMARK: remark: <unknown>:0:0: vectorized loop (vectorization width: 32, interleaved count: 1)
+; REMARK: remark: <unknown>:0:0: vectorized epilogue loop (vectorization width: 16, interleaved count: 1)
+; REMARK: remark: <unknown>:0:0: vectorized loop (vectorization width: 32, interleaved count: 1)
+; REMARK-NOT: epilogue
+; REMARK: remark: <unknown>:0:0: vectorized loop (vectorization width: 32, interleaved count: 1)
+; REMARK-NOT: epilogue
+; REMARK-LABEL: define void @runtime_tc(
+
+define void @runtime_tc(i8* noalias %a, i8* noalias %b, i64 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %pb = getelementptr inbounds i8, i8* %b, i64 %i
+  %vb = load i8, i8* %pb, align 1
+  %add = add i8 %vb, 1
+  %pa = getelementptr inbounds i8, i8* %a, i64 %i
+  store i8 %add, i8* %pa, align 1
+  %i.next = add nuw nsw i64 %i, 1
+  %cond = icmp eq i64 %i.next, %n
+  br i1 %cond, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+; 65 iterations leave a single remainder iteration, which is not worth a
+; vector loop.
+; EPI-LABEL: @short_remainder(
+; EPI:         store <32 x i8>
+; EPI-NOT:     <16 x i8>
+define void @short_remainder(i8* noalias %a, i8* noalias %b) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %pb = getelementptr inbounds i8, i8* %b, i64 %i
+  %vb = load i8, i8* %pb, align 1
+  %add = add i8 %vb, 1
+  %pa = getelementptr inbounds i8, i8* %a, i64 %i
+  store i8 %add, i8* %pa, align 1
+  %i.next = add nuw nsw i64 %i, 1
+  %cond = icmp eq i64 %i.next, 65
+  br i1 %cond, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+; A VF chosen by the user is taken to cover the whole loop.
+; EPI-LABEL: @user_vf(
+; EPI:         store <32 x i8>
+; EPI-NOT:     <16 x i8>
+; EPI:         ret void
+define void @user_vf(i8* noalias %a, i8* noalias %b, i64 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %pb = getelementptr inbounds i8, i8* %b, i64 %i
+  %vb = load i8, i8* %pb, align 1
+  %add = add i8 %vb, 1
+  %pa = getelementptr inbounds i8, i8* %a, i64 %i
+  store i8 %add, i8* %pa, align 1
+  %i.next = add nuw nsw i64 %i, 1
+  %cond = icmp eq i64 %i.next, %n
+  br i1 %cond, label %exit, label %loop, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+!0 = distinct !{!0, !1}
+!1 = !{!"llvm.loop.vectorize.width", i32 32}
@@ -0,0 +1,109 @@
+; Test the choice of the outer-loop VF in the VPlan-native path when
+; -vplan-native-cost-model is given. Without it, the VF is still derived from
+; the widest type in the loop nest. Outer loops without an explicit
+; vectorization hint are left to the inner-loop vectorizer either way.
+
+; RUN: opt -S -loop-vectorize -enable-vplan-native-path < %s \
+; RUN:   | FileCheck %s --check-prefixes=DEFAULT,NOHINT
+; RUN: opt -S -loop-vectorize -enable-vplan-native-path -vplan-native-cost-model \
+; RUN:   -pass-remarks-analysis=loop-vectorize < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefixes=COST,NOHINT
+; RUN: opt -S -loop-vectorize -enable-vplan-native-path -vplan-native-cost-model \
+; RUN:   -mattr=+avx512f -pass-remarks-analysis=loop-vectorize < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=COST
+; RUN: opt -S -loop-vectorize -enable-vplan-native-path -vplan-native-cost-model \
+; RUN:   -force-vector-width=2 -pass-remarks-analysis=loop-vectorize < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=USERVF
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@arr2 = external global [8 x i32], align 16
+@arr = external global [8 x [8 x i32]], align 16
+
+; DEFAULT-LABEL: @foo(
+; DEFAULT: vector.body:
+; DEFAULT: call void @llvm.masked.scatter.v4i32.v4p0i32(<4 x i32>
+
+; The outer loop is vectorized with a width the cost model picked, and the
+; choice is reported.
+; COST: remark: <unknown>:0:0: outer loop vectorization width [[VF:[0-9]+]] chosen by the cost-model (cost per vector iteration: {{[0-9]+}})
+; COST-NOT: chosen by the cost-model
+; COST-LABEL: @foo(
+; COST: vector.body:
+; COST: call void @llvm.masked.scatter.v[[VF]]i32.v[[VF]]p0i32(<[[VF]] x i32>
+
+; A user-given VF is used as is and not reported.
+; USERVF-NOT: chosen by the cost-model
+; USERVF-LABEL: @foo(
+; USERVF: vector.body:
+; USERVF: call void @llvm.masked.scatter.v2i32.v2p0i32(<2 x i32>
+
+define void @foo(i32 %n) {
+entry:
+  br label %for.body
+
+for.body:
+  %indvars.iv21 = phi i64 [ 0, %entry ], [ %indvars.iv.next22, %for.inc8 ]
+  %arrayidx = getelementptr inbounds [8 x i32], [8 x i32]* @arr2, i64 0, i64 %indvars.iv21
+  %0 = trunc i64 %indvars.iv21 to i32
+  store i32 %0, i32* %arrayidx, align 4
+  %1 = trunc i64 %indvars.iv21 to i32
+  %add = add nsw i32 %1, %n
+  br label %for.body3
+
+for.body3:
+  %indvars.iv = phi i64 [ 0, %for.body ], [ %indvars.iv.next, %for.body3 ]
+  %arrayidx7 = getelementptr inbounds [8 x [8 x i32]], [8 x [8 x i32]]* @arr, i64 0, i64 %indvars.iv, i64 %indvars.iv21
+  store i32 %add, i32* %arrayidx7, align 4
+  %indvars.iv.next = add nuw nsw i64 %indvars.iv, 1
+  %exitcond = icmp eq i64 %indvars.iv.next, 8
+  br i1 %exitcond, label %for.inc8, label %for.body3
+
+for.inc8:
+  %indvars.iv.next22 = add nuw nsw i64 %indvars.iv21, 1
+  %exitcond23 = icmp eq i64 %indvars.iv.next22, 8
+  br i1 %exitcond23, label %for.end10, label %for.body, !llvm.loop !1
+
+for.end10:
+  ret void
+}
+
+; The same loop nest without llvm.loop.vectorize.enable. The cost model does
+; not look at its outer loop, and the native path emits no scatter for it.
+; NOHINT-LABEL: @bar(
+; NOHINT-NOT: call void @llvm.masked.scatter
+; NOHINT: ret void
+
+define void @bar(i32 %n) {
+entry:
+  br label %for.body
+
+for.body:
+  %indvars.iv21 = phi i64 [ 0, %entry ], [ %indvars.iv.next22, %for.inc8 ]
+  %arrayidx = getelementptr inbounds [8 x i32], [8 x i32]* @arr2, i64 0, i64 %indvars.iv21
+  %0 = trunc i64 %indvars.iv21 to i32
+  store i32 %0, i32* %arrayidx, align 4
+  %1 = trunc i64 %indvars.iv21 to i32
+  %add = add nsw i32 %1, %n
+  br label %for.body3
+
+for.body3:
+  %indvars.iv = phi i64 [ 0, %for.body ], [ %indvars.iv.next, %for.body3 ]
+  %arrayidx7 = getelementptr inbounds [8 x [8 x i32]], [8 x [8 x i32]]* @arr, i64 0, i64 %indvars.iv, i64 %indvars.iv21
+  store i32 %add, i32* %arrayidx7, align 4
+  %indvars.iv.next = add nuw nsw i64 %indvars.iv, 1
+  %exitcond = icmp eq i64 %indvars.iv.next, 8
+  br i1 %exitcond, label %for.inc8, label %for.body3
+
+for.inc8:
+  %indvars.iv.next22 = add nuw nsw i64 %indvars.iv21, 1
+  %exitcond23 = icmp eq i64 %indvars.iv.next22, 8
+  br i1 %exitcond23, label %for.end10, label %for.body
+
+for.end10:
+  ret void
+}
+
+!1 = distinct !{!1, !2}
+!2 = !{!"llvm.loop.vectorize.enable", i1 true}
@@ -0,0 +1,78 @@
+; RUN: opt -mergefunc -S < %s | FileCheck %s --implicit-check-not=@b \
+; RUN:   --implicit-check-not=@e
+; RUN: opt -passes=mergefunc -S < %s | FileCheck %s --implicit-check-not=@b \
+; RUN:   --implicit-check-not=@e
+
+; The first round merges the functions that share a hash with the hashes used
+; to bucket them. Merging @b into @a makes its callers @ca and @cb equal, and
+; they are merged in a second round with the hashes of their new bodies. The
+; thunk that replaces @cb is emitted at the end of the module.
+
+; CHECK-LABEL: define internal i32 @a(
+; CHECK-LABEL: define internal i32 @d(
+; CHECK-LABEL: define i32 @unique(
+; CHECK-LABEL: define i32 @ca(
+; CHECK:         call i32 @a(
+; CHECK-LABEL: define i32 @cd(
+; CHECK:         call i32 @d(
+; CHECK:         call i32 @d(
+; CHECK-LABEL: define i32 @cb(
+; CHECK-NEXT:    [[R:%.*]] = tail call i32 @ca(
+; CHECK-NEXT:    ret i32 [[R]]
+
+define internal i32 @a(i32 %x) {
+  %m = mul i32 %x, 3
+  %r = add i32 %m, 7
+  ret i32 %r
+}
+
+define internal i32 @b(i32 %x) {
+  %m = mul i32 %x, 3
+  %r = add i32 %m, 7
+  ret i32 %r
+}
+
+define internal i32 @d(i32 %x) {
+  br label %next
+
+next:
+  %r = sub i32 %x, 1
+  ret i32 %r
+}
+
+define internal i32 @e(i32 %x) {
+  br label %next
+
+next:
+  %r = sub i32 %x, 1
+  ret i32 %r
+}
+
+define i32 @unique(i32 %x) {
+  %c = icmp eq i32 %x, 0
+  br i1 %c, label %zero, label %other
+
+zero:
+  ret i32 1
+
+other:
+  ret i32 %x
+}
+
+define i32 @ca(i32 %x) {
+  %c = call i32 @a(i32 %x)
+  %r = xor i32 %c, 5
+  ret i32 %r
+}
+
+define i32 @cb(i32 %x) {
+  %c = call i32 @b(i32 %x)
+  %r = xor i32 %c, 5
+  ret i32 %r
+}
+
+define i32 @cd(i32 %x) {
+  %c = call i32 @d(i32 %x)
+  %e = call i32 @e(i32 %c)
+  ret i32 %e
+}
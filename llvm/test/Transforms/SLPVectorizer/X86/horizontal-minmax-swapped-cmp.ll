@@ -0,0 +1,54 @@
+; RUN: opt -slp-vectorizer -slp-threshold=-10 -S < %s | FileCheck %s
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; Each select picks the larger of two values, but its compare has the operands
+; in the opposite order and compares copies of the extracts rather than the
+; same values, as SLP leaves behind until optimizeGatherSequence. Read with the
+; swapped predicate this is a max, so the chain is still a reduction.
+define i32 @smax_swapped_cmp(<4 x i32> %v) {
+; CHECK-LABEL: @smax_swapped_cmp(
+; CHECK:       icmp sgt <4 x i32>
+; CHECK:       select <4 x i1>
+; CHECK:       [[MAX:%.*]] = extractelement <4 x i32>
+; CHECK:       ret i32 [[MAX]]
+entry:
+  %e0 = extractelement <4 x i32> %v, i32 0
+  %e1 = extractelement <4 x i32> %v, i32 1
+  %e2 = extractelement <4 x i32> %v, i32 2
+  %e3 = extractelement <4 x i32> %v, i32 3
+  %e0.copy = extractelement <4 x i32> %v, i32 0
+  %e1.copy = extractelement <4 x i32> %v, i32 1
+  %e2.copy = extractelement <4 x i32> %v, i32 2
+  %e3.copy = extractelement <4 x i32> %v, i32 3
+  %c1 = icmp slt i32 %e0, %e1
+  %s1 = select i1 %c1, i32 %e1.copy, i32 %e0.copy
+  %c2 = icmp slt i32 %s1, %e2
+  %s2 = select i1 %c2, i32 %e2.copy, i32 %s1
+  %c3 = icmp slt i32 %s2, %e3
+  %s3 = select i1 %c3, i32 %e3.copy, i32 %s2
+  ret i32 %s3
+}
+
+; A compare of other values than the select's is not a min or max.
+define i32 @not_minmax(<4 x i32> %v, i32 %x) {
+; CHECK-LABEL: @not_minmax(
+; CHECK-NOT:   <4 x i1>
+; CHECK:       ret i32
+entry:
+  %e0 = extractelement <4 x i32> %v, i32 0
+  %e1 = extractelement <4 x i32> %v, i32 1
+  %e2 = extractelement <4 x i32> %v, i32 2
+  %e3 = extractelement <4 x i32> %v, i32 3
+  %e1.copy = extractelement <4 x i32> %v, i32 1
+  %e2.copy = extractelement <4 x i32> %v, i32 2
+  %e3.copy = extractelement <4 x i32> %v, i32 3
+  %c1 = icmp slt i32 %x, %e1
+  %s1 = select i1 %c1, i32 %e1.copy, i32 %e0
+  %c2 = icmp slt i32 %x, %e2
+  %s2 = select i1 %c2, i32 %e2.copy, i32 %s1
+  %c3 = icmp slt i32 %x, %e3
+  %s3 = select i1 %c3, i32 %e3.copy, i32 %s2
+  ret i32 %s3
+}
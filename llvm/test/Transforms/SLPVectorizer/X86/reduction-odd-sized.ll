@@ -0,0 +1,101 @@
+; Horizontal reductions of 3 values, and the trailing pair of a 6-value
+; reduction, are vectorized as chunks of width 2. The low threshold keeps the
+; result independent of small changes to the x86 costs; the last function is
+; checked with the default threshold.
+
+; RUN: opt -slp-vectorizer -slp-threshold=-10 -S < %s | FileCheck %s
+; RUN: opt -slp-vectorizer -slp-threshold=-10 -slp-min-reduction-values=4 -S < %s \
+; RUN:   | FileCheck %s --check-prefix=MIN4
+; RUN: opt -slp-vectorizer -S < %s | FileCheck %s --check-prefix=COST
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; double dot3(double *a, double *b) {
+;   return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+; }
+define double @dot3(double* %a, double* %b) {
+; CHECK-LABEL: @dot3(
+; CHECK: load <2 x double>
+; CHECK: load <2 x double>
+; CHECK: fmul fast <2 x double>
+; CHECK: extractelement <2 x double>
+; CHECK: fadd fast double
+; CHECK: ret double
+;
+; MIN4-LABEL: @dot3(
+; MIN4-NOT: <2 x double>
+; MIN4: ret double
+entry:
+  %a0 = load double, double* %a, align 8
+  %b0 = load double, double* %b, align 8
+  %m0 = fmul fast double %a0, %b0
+  %pa1 = getelementptr inbounds double, double* %a, i64 1
+  %a1 = load double, double* %pa1, align 8
+  %pb1 = getelementptr inbounds double, double* %b, i64 1
+  %b1 = load double, double* %pb1, align 8
+  %m1 = fmul fast double %a1, %b1
+  %add1 = fadd fast double %m0, %m1
+  %pa2 = getelementptr inbounds double, double* %a, i64 2
+  %a2 = load double, double* %pa2, align 8
+  %pb2 = getelementptr inbounds double, double* %b, i64 2
+  %b2 = load double, double* %pb2, align 8
+  %m2 = fmul fast double %a2, %b2
+  %add2 = fadd fast double %add1, %m2
+  ret double %add2
+}
+
+; A 6-value reduction is reduced as a chunk of 4 followed by a chunk of 2.
+define double @sum6(double* %a) {
+; CHECK-LABEL: @sum6(
+; CHECK-DAG: load <4 x double>
+; CHECK-DAG: load <2 x double>
+; CHECK: ret double
+entry:
+  %a0 = load double, double* %a, align 8
+  %pa1 = getelementptr inbounds double, double* %a, i64 1
+  %a1 = load double, double* %pa1, align 8
+  %pa2 = getelementptr inbounds double, double* %a, i64 2
+  %a2 = load double, double* %pa2, align 8
+  %pa3 = getelementptr inbounds double, double* %a, i64 3
+  %a3 = load double, double* %pa3, align 8
+  %pa4 = getelementptr inbounds double, double* %a, i64 4
+  %a4 = load double, double* %pa4, align 8
+  %pa5 = getelementptr inbounds double, double* %a, i64 5
+  %a5 = load double, double* %pa5, align 8
+  %add1 = fadd fast double %a0, %a1
+  %add2 = fadd fast double %add1, %a2
+  %add3 = fadd fast double %add2, %a3
+  %add4 = fadd fast double %add3, %a4
+  %add5 = fadd fast double %add4, %a5
+  ret double %add5
+}
+
+; The reduced values are not adjacent in memory, so the tree for each chunk
+; would only gather scalars. It is not worth vectorizing and stays scalar.
+define double @sum3_scattered(double* %a) {
+; CHECK-LABEL: @sum3_scattered(
+; CHECK-NOT: <2 x double>
+; CHECK: ret double
+entry:
+  %a0 = load double, double* %a, align 8
+  %pa5 = getelementptr inbounds double, double* %a, i64 5
+  %a5 = load double, double* %pa5, align 8
+  %pa9 = getelementptr inbounds double, double* %a, i64 9
+  %a9 = load double, double* %pa9, align 8
+  %add1 = fadd fast double %a0, %a5
+  %add2 = fadd fast double %add1, %a9
+  ret double %add2
+}
+
+; Without the threshold the cost model decides, and the scalar adds of
+; three function arguments are cheaper than building a vector of them.
+define i32 @sum3_args(i32 %x, i32 %y, i32 %z) {
+; COST-LABEL: @sum3_args(
+; COST-NOT: <2 x i32>
+; COST: ret i32
+entry:
+  %add1 = add i32 %x, %y
+  %add2 = add i32 %add1, %z
+  ret i32 %add2
+}
@@ -0,0 +1,73 @@
+# An object file with a reference to the clang module ModA and a compile unit
+# that defines _f1.
+	.section	__TEXT,__text,regular,pure_instructions
+	.globl	_f1
+_f1:
+	retq
+Lfunc_end:
+
+	.section	__DWARF,__debug_abbrev,regular,debug
+	.byte	1                       # Abbrev 1: skeleton unit of the module
+	.byte	0x11                    # DW_TAG_compile_unit
+	.byte	0                       # DW_CHILDREN_no
+	.byte	0x03                    # DW_AT_name
+	.byte	0x08                    # DW_FORM_string
+	.ascii	"\260B"                 # DW_AT_GNU_dwo_name
+	.byte	0x08                    # DW_FORM_string
+	.ascii	"\261B"                 # DW_AT_GNU_dwo_id
+	.byte	0x07                    # DW_FORM_data8
+	.byte	0
+	.byte	0
+	.byte	2                       # Abbrev 2: unit of the object
+	.byte	0x11                    # DW_TAG_compile_unit
+	.byte	1                       # DW_CHILDREN_yes
+	.byte	0x03                    # DW_AT_name
+	.byte	0x08                    # DW_FORM_string
+	.byte	0x13                    # DW_AT_language
+	.byte	0x05                    # DW_FORM_data2
+	.byte	0x11                    # DW_AT_low_pc
+	.byte	0x01                    # DW_FORM_addr
+	.byte	0x12                    # DW_AT_high_pc
+	.byte	0x06                    # DW_FORM_data4
+	.byte	0
+	.byte	0
+	.byte	3                       # Abbrev 3
+	.byte	0x2e                    # DW_TAG_subprogram
+	.byte	0                       # DW_CHILDREN_no
+	.byte	0x03                    # DW_AT_name
+	.byte	0x08                    # DW_FORM_string
+	.byte	0x11                    # DW_AT_low_pc
+	.byte	0x01                    # DW_FORM_addr
+	.byte	0x12                    # DW_AT_high_pc
+	.byte	0x06                    # DW_FORM_data4
+	.byte	0
+	.byte	0
+	.byte	0
+
+	.section	__DWARF,__debug_info,regular,debug
+Lskeleton_begin:
+	.long	Lskeleton_end-Lskeleton_begin-4 # Length of Unit
+	.short	4                       # DWARF version number
+	.long	0                       # Offset Into Abbrev. Section
+	.byte	8                       # Address Size
+	.byte	1                       # Abbrev [1] DW_TAG_compile_unit
+	.asciz	"ModA"                    # DW_AT_name
+	.asciz	"ModA.pcm"                # DW_AT_GNU_dwo_name
+	.quad	0x1111                      # DW_AT_GNU_dwo_id
+Lskeleton_end:
+Lcu_begin:
+	.long	Lcu_end-Lcu_begin-4     # Length of Unit
+	.short	4                       # DWARF version number
+	.long	0                       # Offset Into Abbrev. Section
+	.byte	8                       # Address Size
+	.byte	2                       # Abbrev [2] DW_TAG_compile_unit
+	.asciz	"_f1.c"                  # DW_AT_name
+	.short	0x0c                    # DW_AT_language: DW_LANG_C99
+	.quad	_f1                      # DW_AT_low_pc
+	.long	Lfunc_end-_f1            # DW_AT_high_pc
+	.byte	3                       # Abbrev [3] DW_TAG_subprogram
+	.asciz	"_f1"                    # DW_AT_name
+	.quad	_f1                      # DW_AT_low_pc
+	.long	Lfunc_end-_f1            # DW_AT_high_pc
+	.byte	0                       # End Of Children Mark
+Lcu_end:
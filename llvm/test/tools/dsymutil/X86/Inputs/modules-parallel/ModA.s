@@ -0,0 +1,49 @@
+# The debug info of the clang module ModA, which defines the type StructA.
+	.section	__DWARF,__debug_abbrev,regular,debug
+	.byte	1                       # Abbrev 1
+	.byte	0x11                    # DW_TAG_compile_unit
+	.byte	1                       # DW_CHILDREN_yes
+	.byte	0x03                    # DW_AT_name
+	.byte	0x08                    # DW_FORM_string
+	.byte	0x13                    # DW_AT_language
+	.byte	0x05                    # DW_FORM_data2
+	.ascii	"\261B"                 # DW_AT_GNU_dwo_id
+	.byte	0x07                    # DW_FORM_data8
+	.byte	0
+	.byte	0
+	.byte	2                       # Abbrev 2
+	.byte	0x1e                    # DW_TAG_module
+	.byte	1                       # DW_CHILDREN_yes
+	.byte	0x03                    # DW_AT_name
+	.byte	0x08                    # DW_FORM_string
+	.byte	0
+	.byte	0
+	.byte	3                       # Abbrev 3
+	.byte	0x13                    # DW_TAG_structure_type
+	.byte	0                       # DW_CHILDREN_no
+	.byte	0x03                    # DW_AT_name
+	.byte	0x08                    # DW_FORM_string
+	.byte	0x0b                    # DW_AT_byte_size
+	.byte	0x0b                    # DW_FORM_data1
+	.byte	0
+	.byte	0
+	.byte	0
+
+	.section	__DWARF,__debug_info,regular,debug
+Lcu_begin:
+	.long	Lcu_end-Lcu_begin-4     # Length of Unit
+	.short	4                       # DWARF version number
+	.long	0                       # Offset Into Abbrev. Section
+	.byte	8                       # Address Size
+	.byte	1                       # Abbrev [1] DW_TAG_compile_unit
+	.asciz	"ModA"                    # DW_AT_name
+	.short	0x0c                    # DW_AT_language: DW_LANG_C99
+	.quad	0x1111                      # DW_AT_GNU_dwo_id
+	.byte	2                       # Abbrev [2] DW_TAG_module
+	.asciz	"ModA"                    # DW_AT_name
+	.byte	3                       # Abbrev [3] DW_TAG_structure_type
+	.asciz	"StructA"                    # DW_AT_name
+	.byte	4                       # DW_AT_byte_size
+	.byte	0                       # End Of Children Mark
+	.byte	0                       # End Of Children Mark
+Lcu_end:
@@ -0,0 +1,31 @@
+; RUN: rm -f %t.s %t.s.1
+; RUN: llc -mtriple=x86_64-unknown-linux -codegen-partitions=2 %s -o %t.s
+; RUN: cat %t.s %t.s.1 \
+; RUN:   | FileCheck %s --check-prefix=BUILTIN --implicit-check-not=fabs
+
+; Every partition uses the TargetLibraryInfo that the flags select.
+; RUN: llc -mtriple=x86_64-unknown-linux -codegen-partitions=2 %s -o %t.s \
+; RUN:   -disable-simplify-libcalls
+; RUN: cat %t.s %t.s.1 \
+; RUN:   | FileCheck %s --check-prefix=NOBUILTIN --implicit-check-not=andps
+
+; RUN: not llc -mtriple=x86_64-unknown-linux -codegen-partitions=2 %s -o - \
+; RUN:   2>&1 | FileCheck %s --check-prefix=STDOUT
+
+; BUILTIN-COUNT-2: andps
+
+; NOBUILTIN-COUNT-2: callq fabs
+
+; STDOUT: error: -codegen-partitions requires an output file
+
+declare double @fabs(double) readnone
+
+define double @f(double %x) {
+  %r = call double @fabs(double %x)
+  ret double %r
+}
+
+define double @g(double %x) {
+  %r = call double @fabs(double %x)
+  ret double %r
+}
@@ -0,0 +1,50 @@
+; REQUIRES: x86-registered-target, zlib
+; RUN: rm -rf %t && mkdir -p %t && cd %t
+; RUN: sed -e s/FUNC/a/g %s | llc -mtriple=x86_64-linux -filetype=obj \
+; RUN:   -split-dwarf-file=a.dwo -split-dwarf-output=a.dwo -o a.o
+; RUN: sed -e s/FUNC/b/g %s | llc -mtriple=x86_64-linux -filetype=obj \
+; RUN:   -split-dwarf-file=b.dwo -split-dwarf-output=b.dwo -o b.o
+; RUN: sed -e s/FUNC/c/g %s | llc -mtriple=x86_64-linux -filetype=obj \
+; RUN:   -split-dwarf-file=c.dwo -split-dwarf-output=c.dwo -o c.o
+; RUN: llvm-objcopy --compress-debug-sections=zlib-gnu b.dwo b.z.dwo
+
+;; The inputs are opened and decompressed in parallel, but they are written in
+;; the order they are given in.
+; RUN: llvm-dwp a.dwo b.dwo c.dwo -o abc.dwp
+; RUN: llvm-dwp a.dwo b.z.dwo c.dwo -o abc.z.dwp
+; RUN: cmp abc.dwp abc.z.dwp
+; RUN: llvm-dwarfdump -debug-cu-index -debug-info abc.dwp | FileCheck %s
+
+; CHECK:      DW_AT_name ("a.c")
+; CHECK:      DW_AT_name ("b.c")
+; CHECK:      DW_AT_name ("c.c")
+; CHECK:      .debug_cu_index contents:
+; CHECK-NEXT: version = 2 slots = 8
+; CHECK-COUNT-3: 0x{{[0-9a-f]+}} [0x{{[0-9a-f]+}}, 0x{{[0-9a-f]+}})
+
+;; Of several inputs that can't be read, the first one in the order they are
+;; given in is reported.
+; RUN: echo garbage > garbage.dwo
+; RUN: not llvm-dwp a.dwo missing.dwo garbage.dwo -o err.dwp 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=MISSING --implicit-check-not=error:
+; RUN: not llvm-dwp a.dwo garbage.dwo missing.dwo -o err.dwp 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=GARBAGE --implicit-check-not=error:
+
+; MISSING: error: No such file or directory
+; GARBAGE: error: The file was not recognized as a valid object file
+
+define void @FUNC() !dbg !6 {
+  ret void, !dbg !9
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, splitDebugInlining: false)
+!1 = !DIFile(filename: "FUNC.c", directory: "/tmp")
+!3 = !{i32 2, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!6 = distinct !DISubprogram(name: "FUNC", scope: !1, file: !1, line: 1, type: !7, scopeLine: 1, spFlags: DISPFlagDefinition, unit: !0)
+!7 = !DISubroutineType(types: !8)
+!8 = !{null}
+!9 = !DILocation(line: 1, column: 1, scope: !6)
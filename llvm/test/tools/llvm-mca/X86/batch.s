@@ -0,0 +1,71 @@
+# NOTE: -batch simulates each code region in a pipeline of its own, and prints
+# a JSON summary of every non-empty region in the order of the input.
+
+# RUN: llvm-mca -mtriple=x86_64-unknown-unknown -mcpu=btver2 -iterations=100 -batch < %s \
+# RUN:   | FileCheck %s
+# RUN: not llvm-mca -mtriple=x86_64-unknown-unknown -mcpu=btver2 -batch -instruction-tables < %s 2>&1 \
+# RUN:   | FileCheck %s --check-prefix=TABLES
+
+# LLVM-MCA-BEGIN dependent
+addl %eax, %eax
+addl %eax, %eax
+addl %eax, %eax
+# LLVM-MCA-END
+
+# LLVM-MCA-BEGIN empty
+# LLVM-MCA-END
+
+# LLVM-MCA-BEGIN independent
+addl %eax, %ebx
+addl %ecx, %edx
+addl %esi, %edi
+# LLVM-MCA-END
+
+# CHECK:      [
+# CHECK-NEXT:   {
+# CHECK-NEXT:     "BottleneckAnalysis": {
+# CHECK-NEXT:       "BottlenecksFound": true,
+# CHECK-NEXT:       "DataDependencyCycles": [[DEPS:[1-9][0-9]*]],
+# CHECK-NEXT:       "MemoryDependencyCycles": 0,
+# CHECK-NEXT:       "PressureIncreaseCycles": [[DEPS]],
+# CHECK-NEXT:       "RegisterDependencyCycles": [[DEPS]],
+# CHECK-NEXT:       "ResourcePressure": {},
+# CHECK-NEXT:       "ResourcePressureCycles": 0,
+# CHECK-NEXT:       "TotalCycles": 303
+# CHECK-NEXT:     },
+# CHECK-NEXT:     "Index": 0,
+# CHECK-NEXT:     "Name": "dependent",
+# CHECK-NEXT:     "SummaryView": {
+# CHECK-NEXT:       "BlockRThroughput": 1.5,
+# CHECK-NEXT:       "DispatchWidth": 2,
+# CHECK-NEXT:       "IPC": {{.*}},
+# CHECK-NEXT:       "Instructions": 300,
+# CHECK-NEXT:       "Iterations": 100,
+# CHECK-NEXT:       "TotalCycles": 303,
+# CHECK-NEXT:       "TotaluOps": 300,
+# CHECK-NEXT:       "uOpsPerCycle": {{.*}}
+# CHECK-NEXT:     }
+# CHECK-NEXT:   },
+# CHECK-NEXT:   {
+# CHECK-NEXT:     "BottleneckAnalysis": {
+# CHECK-NEXT:       "BottlenecksFound": false,
+# CHECK:            "ResourcePressure": {},
+# CHECK-NEXT:       "ResourcePressureCycles": 0,
+# CHECK-NEXT:       "TotalCycles": 153
+# CHECK-NEXT:     },
+# CHECK-NEXT:     "Index": 1,
+# CHECK-NEXT:     "Name": "independent",
+# CHECK-NEXT:     "SummaryView": {
+# CHECK-NEXT:       "BlockRThroughput": 1.5,
+# CHECK-NEXT:       "DispatchWidth": 2,
+# CHECK-NEXT:       "IPC": {{.*}},
+# CHECK-NEXT:       "Instructions": 300,
+# CHECK-NEXT:       "Iterations": 100,
+# CHECK-NEXT:       "TotalCycles": 153,
+# CHECK-NEXT:       "TotaluOps": 300,
+# CHECK-NEXT:       "uOpsPerCycle": {{.*}}
+# CHECK-NEXT:     }
+# CHECK-NEXT:   }
+# CHECK-NEXT: ]
+
+# TABLES: error: -batch and -instruction-tables are incompatible.
@@ -0,0 +1,43 @@
+; An ifunc must be in the same partition as its resolver, whether or not the
+; resolver is a local.
+
+; RUN: llvm-split -j2 -preserve-locals -o %t %s
+; RUN: llvm-dis -o - %t0 | FileCheck --check-prefix=CHECK0 %s
+; RUN: llvm-dis -o - %t1 | FileCheck --check-prefix=CHECK1 %s
+
+; RUN: llvm-split -j2 -o %t.ext %s
+; RUN: llvm-dis -o - %t.ext0 | FileCheck --check-prefix=CHECK0 %s
+; RUN: llvm-dis -o - %t.ext1 | FileCheck --check-prefix=CHECK1 %s
+
+; CHECK0-NOT: ifunc
+; CHECK0:     define i32 @big
+; CHECK0-NOT: define {{.*}}@resolver
+
+; CHECK1:     @foo = ifunc void (), void ()* ()* @resolver
+; CHECK1-NOT: define {{.*}}@big
+; CHECK1:     define {{.*}}void ()* @resolver()
+; CHECK1-NOT: define {{.*}}@big
+
+@foo = ifunc void (), void ()* ()* @resolver
+
+define internal void ()* @resolver() {
+  ret void ()* @impl
+}
+
+define void @impl() {
+  ret void
+}
+
+; Heavier than everything else together, so that it gets a partition of its
+; own.
+define i32 @big(i32 %x) {
+  %a = add i32 %x, 1
+  %b = mul i32 %a, %x
+  %c = add i32 %b, 2
+  %d = mul i32 %c, %b
+  %e = add i32 %d, 3
+  %f = mul i32 %e, %d
+  %g = add i32 %f, 4
+  %h = mul i32 %g, %f
+  ret i32 %h
+}
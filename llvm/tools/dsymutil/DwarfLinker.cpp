@@ -9,10 +9,8 @@
 #include "DwarfLinker.h"
 #include "BinaryHolder.h"
 #include "DebugMap.h"
-#include "DeclContext.h"
 #include "DwarfStreamer.h"
 #include "MachOUtils.h"
-#include "NonRelocatableStringpool.h"
 #include "dsymutil.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/BitVector.h"
@@ -36,7 +34,9 @@
 #include "llvm/CodeGen/AccelTable.h"
 #include "llvm/CodeGen/AsmPrinter.h"
 #include "llvm/CodeGen/DIE.h"
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
 #include "llvm/Config/config.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
 #include "llvm/DebugInfo/DIContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFAbbreviationDeclaration.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -85,6 +85,7 @@
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cinttypes>
 #include <climits>
@@ -323,8 +324,7 @@ static bool analyzeContextInfo(
       CurrentDeclContext = PtrInvalidPair.getPointer();
       Info.Ctxt =
           PtrInvalidPair.getInt() ? nullptr : PtrInvalidPair.getPointer();
-      if (Info.Ctxt)
-        Info.Ctxt->setDefinedInClangModule(InClangModule);
+      Info.InClangModule = InClangModule;
     } else
       Info.Ctxt = CurrentDeclContext = nullptr;
   }
@@ -355,6 +355,18 @@ static bool analyzeContextInfo(
   return Info.Prune;
 } // namespace dsymutil
 
+/// Record on the ODR contexts of \p CU whether they were last seen in a clang
+/// module. The contexts are shared by all the objects of the link, so this is
+/// done when the unit is about to be cloned rather than analyzed, in order for
+/// the result not to depend on how far ahead the analysis has run.
+static void updateDefinedInClangModule(CompileUnit &CU) {
+  for (unsigned I = 0, E = CU.getOrigUnit().getNumDIEs(); I != E; ++I) {
+    CompileUnit::DIEInfo &Info = CU.getInfo(I);
+    if (Info.Ctxt)
+      Info.Ctxt->setDefinedInClangModule(Info.InClangModule);
+  }
+}
+
 static bool dieNeedsChildrenToBeMeaningful(uint32_t Tag) {
   switch (Tag) {
   default:
@@ -617,7 +629,7 @@ getAttributeOffsets(const DWARFAbbreviationDeclaration *Abbrev, unsigned Idx,
 
 /// Check if a variable describing DIE should be kept.
 /// \returns updated TraversalFlags.
-unsigned DwarfLinker::shouldKeepVariableDIE(RelocationManager &RelocMgr,
+unsigned DwarfLinker::shouldKeepVariableDIE(AddressesMap &RelocMgr,
                                             const DWARFDie &DIE,
                                             CompileUnit &Unit,
                                             CompileUnit::DIEInfo &MyInfo,
@@ -664,7 +676,7 @@ unsigned DwarfLinker::shouldKeepVariableDIE(RelocationManager &RelocMgr,
 /// Check if a function describing DIE should be kept.
 /// \returns updated TraversalFlags.
 unsigned DwarfLinker::shouldKeepSubprogramDIE(
-    RelocationManager &RelocMgr, RangesTy &Ranges, const DWARFDie &DIE,
+    AddressesMap &RelocMgr, RangesTy &Ranges, const DWARFDie &DIE,
     const DebugMapObject &DMO, CompileUnit &Unit, CompileUnit::DIEInfo &MyInfo,
     unsigned Flags) {
   const auto *Abbrev = DIE.getAbbreviationDeclarationPtr();
@@ -725,8 +737,8 @@ unsigned DwarfLinker::shouldKeepSubprogramDIE(
 
 /// Check if a DIE should be kept.
 /// \returns updated TraversalFlags.
-unsigned DwarfLinker::shouldKeepDIE(RelocationManager &RelocMgr,
-                                    RangesTy &Ranges, const DWARFDie &DIE,
+unsigned DwarfLinker::shouldKeepDIE(AddressesMap &RelocMgr, RangesTy &Ranges,
+                                    const DWARFDie &DIE,
                                     const DebugMapObject &DMO,
                                     CompileUnit &Unit,
                                     CompileUnit::DIEInfo &MyInfo,
@@ -763,7 +775,7 @@ unsigned DwarfLinker::shouldKeepDIE(RelocationManager &RelocMgr,
 /// TraversalFlags to inform it that it's not doing the primary DIE
 /// tree walk.
 void DwarfLinker::keepDIEAndDependencies(
-    RelocationManager &RelocMgr, RangesTy &Ranges, const UnitListTy &Units,
+    AddressesMap &RelocMgr, RangesTy &Ranges, const UnitListTy &Units,
     const DWARFDie &Die, CompileUnit::DIEInfo &MyInfo,
     const DebugMapObject &DMO, CompileUnit &CU, bool UseODR) {
   DWARFUnit &Unit = CU.getOrigUnit();
@@ -902,8 +914,8 @@ static void updateIncompleteness(const DWARFDie &Die,
 /// traversal we are currently doing.
 ///
 /// The return value indicates whether the DIE is incomplete.
-void DwarfLinker::lookForDIEsToKeep(RelocationManager &RelocMgr,
-                                    RangesTy &Ranges, const UnitListTy &Units,
+void DwarfLinker::lookForDIEsToKeep(AddressesMap &RelocMgr, RangesTy &Ranges,
+                                    const UnitListTy &Units,
                                     const DWARFDie &Die,
                                     const DebugMapObject &DMO, CompileUnit &CU,
                                     unsigned Flags) {
@@ -2333,6 +2345,8 @@ Error DwarfLinker::loadClangModule(
                          [&](const Twine &Warning, const DWARFDie &DIE) {
                            reportWarning(Warning, DMO, &DIE);
                          });
+      Unit->clearDeclContexts();
+      updateDefinedInClangModule(*Unit);
       // Keep everything.
       Unit->markEverythingAsKept();
     }
@@ -2565,7 +2579,7 @@ bool DwarfLinker::link(const DebugMap &Map) {
   // This Dwarf string pool which is used for emission. It must be used
   // serially as the order of calling getStringOffset matters for
   // reproducibility.
-  OffsetsStringPool OffsetsStringPool(Options.Translator);
+  OffsetsStringPool OffsetsStringPool(Options.Translator.asFunction());
 
   // ODR Contexts for the link.
   DeclContextTree ODRContexts;
@@ -2689,6 +2703,22 @@ bool DwarfLinker::link(const DebugMap &Map) {
   std::condition_variable ProcessedFilesConditionVariable;
   BitVector ProcessedFiles(NumObjects, false);
 
+  // The objects can be analyzed in any order, so give each of them a range of
+  // unit IDs upfront. Skeleton units leave holes, which is fine as the IDs are
+  // only required to be unique.
+  std::vector<unsigned> FirstUnitIDs(NumObjects);
+  for (unsigned i = 0, e = NumObjects; i != e; ++i) {
+    FirstUnitIDs[i] = UnitID;
+    if (ObjectContexts[i].ObjectFile && ObjectContexts[i].DwarfContext)
+      UnitID += ObjectContexts[i].DwarfContext->getNumCompileUnits();
+  }
+
+  // Guards the module cache that the analysis looks up, and the IDs of the
+  // units of modules that are only loaded during the analysis, which come
+  // after the ranges of all objects.
+  std::mutex ModulesMutex;
+  unsigned NextModuleUnitID = UnitID;
+
   //  Analyzing the context info is particularly expensive so it is executed in
   //  parallel with emitting the previous compile unit.
   auto AnalyzeLambda = [&](size_t i) {
@@ -2697,6 +2727,7 @@ bool DwarfLinker::link(const DebugMap &Map) {
     if (!LinkContext.ObjectFile || !LinkContext.DwarfContext)
       return;
 
+    unsigned ObjectUnitID = FirstUnitIDs[i];
     for (const auto &CU : LinkContext.DwarfContext->compile_units()) {
       updateDwarfVersion(CU->getVersion());
       // The !registerModuleReference() condition effectively skips
@@ -2706,14 +2737,17 @@ bool DwarfLinker::link(const DebugMap &Map) {
       // warnings were already displayed in the first iteration.
       bool Quiet = true;
       auto CUDie = CU->getUnitDIE(false);
-      if (!CUDie || LLVM_UNLIKELY(Options.Update) ||
-          !registerModuleReference(CUDie, *CU, ModuleMap, LinkContext.DMO,
-                                   LinkContext.Ranges, OffsetsStringPool,
-                                   UniquingStringPool, ODRContexts,
-                                   ModulesEndOffset, UnitID, Quiet)) {
-        LinkContext.CompileUnits.push_back(std::make_unique<CompileUnit>(
-            *CU, UnitID++, !Options.NoODR && !Options.Update, ""));
+      bool IsModuleReference = false;
+      if (CUDie && LLVM_LIKELY(!Options.Update)) {
+        std::lock_guard<std::mutex> Lock(ModulesMutex);
+        IsModuleReference = registerModuleReference(
+            CUDie, *CU, ModuleMap, LinkContext.DMO, LinkContext.Ranges,
+            OffsetsStringPool, UniquingStringPool, ODRContexts,
+            ModulesEndOffset, NextModuleUnitID, Quiet);
       }
+      if (!IsModuleReference)
+        LinkContext.CompileUnits.push_back(std::make_unique<CompileUnit>(
+            *CU, ObjectUnitID++, !Options.NoODR && !Options.Update, ""));
     }
 
     // Now build the DIE parent links that we will use during the next phase.
@@ -2724,10 +2758,11 @@ bool DwarfLinker::link(const DebugMap &Map) {
       analyzeContextInfo(CurrentUnit->getOrigUnit().getUnitDIE(), 0,
                          *CurrentUnit, &ODRContexts.getRoot(),
                          UniquingStringPool, ODRContexts, ModulesEndOffset,
-                         ParseableSwiftInterfaces,
+                         LinkContext.ParseableSwiftInterfaces,
                          [&](const Twine &Warning, const DWARFDie &DIE) {
                            reportWarning(Warning, LinkContext.DMO, &DIE);
                          });
+      CurrentUnit->clearDeclContexts();
     }
   };
 
@@ -2740,6 +2775,20 @@ bool DwarfLinker::link(const DebugMap &Map) {
     if (!LinkContext.ObjectFile)
       return;
 
+    // Publish what the analysis found about this object, now that all the
+    // objects before it have been cloned.
+    for (const auto &Interface : LinkContext.ParseableSwiftInterfaces) {
+      auto &Entry = ParseableSwiftInterfaces[Interface.first];
+      if (!Entry.empty() && Entry != Interface.second)
+        reportWarning(
+            Twine("Conflicting parseable interfaces for Swift Module ") +
+                Interface.first + ": " + Entry + " and " + Interface.second,
+            LinkContext.DMO);
+      Entry = Interface.second;
+    }
+    for (auto &CurrentUnit : LinkContext.CompileUnits)
+      updateDefinedInClangModule(*CurrentUnit);
+
     // Then mark all the DIEs that need to be present in the linked output
     // and collect some information about them.
     // Note that this loop can not be merged with the previous one because
@@ -2799,8 +2848,12 @@ bool DwarfLinker::link(const DebugMap &Map) {
     }
   };
 
+  // The analysis threads pick the objects in order, so that the object the
+  // clone loop waits for is always the next one to be done.
+  std::atomic<unsigned> NextObjectToAnalyze(0);
   auto AnalyzeAll = [&]() {
-    for (unsigned i = 0, e = NumObjects; i != e; ++i) {
+    for (unsigned i = NextObjectToAnalyze++; i < NumObjects;
+         i = NextObjectToAnalyze++) {
       AnalyzeLambda(i);
 
       std::unique_lock<std::mutex> LockGuard(ProcessedFilesMutex);
@@ -2834,8 +2887,14 @@ bool DwarfLinker::link(const DebugMap &Map) {
     }
     EmitLambda();
   } else {
-    ThreadPool pool(2);
-    pool.async(AnalyzeAll);
+    // Cloning assigns the output offsets and the canonical DIEs of the ODR
+    // contexts, so it stays serial to keep the output deterministic. The
+    // analysis is spread over the remaining threads, which share the ODR
+    // contexts and the uniquing string pool.
+    unsigned NumAnalysisThreads = Options.Threads - 1;
+    ThreadPool pool(NumAnalysisThreads + 1);
+    for (unsigned I = 0; I != NumAnalysisThreads; ++I)
+      pool.async(AnalyzeAll);
     pool.async(CloneAll);
     pool.wait();
   }
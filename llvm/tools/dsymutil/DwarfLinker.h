@@ -10,12 +10,14 @@
 #define LLVM_TOOLS_DSYMUTIL_DWARFLINKER_H
 
 #include "BinaryHolder.h"
-#include "CompileUnit.h"
 #include "DebugMap.h"
-#include "DeclContext.h"
 #include "DwarfStreamer.h"
 #include "LinkUtils.h"
+#include "llvm/DWARFLinker/DWARFLinker.h"
+#include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include <mutex>
 
 namespace llvm {
 namespace dsymutil {
@@ -68,6 +70,7 @@ public:
 private:
   /// Remembers the oldest and newest DWARF version we've seen in a unit.
   void updateDwarfVersion(unsigned Version) {
+    std::lock_guard<std::mutex> Lock(DwarfVersionMutex);
     MaxDwarfVersion = std::max(MaxDwarfVersion, Version);
     MinDwarfVersion = std::min(MinDwarfVersion, Version);
   }
@@ -80,7 +83,7 @@ private:
                               OffsetsStringPool &StringPool);
 
   /// Keeps track of relocations.
-  class RelocationManager {
+  class RelocationManager : public AddressesMap {
     struct ValidReloc {
       uint64_t Offset;
       uint32_t Size;
@@ -111,10 +114,10 @@ private:
   public:
     RelocationManager(DwarfLinker &Linker) : Linker(Linker) {}
 
-    bool hasValidRelocs() const { return !ValidRelocs.empty(); }
+    bool hasValidRelocs() const override { return !ValidRelocs.empty(); }
 
     /// Reset the NextValidReloc counter.
-    void resetValidRelocs() { NextValidReloc = 0; }
+    void resetValidRelocs() override { NextValidReloc = 0; }
 
     /// \defgroup FindValidRelocations Translate debug map into a list
     /// of relevant relocations
@@ -133,10 +136,10 @@ private:
     /// @}
 
     bool hasValidRelocation(uint64_t StartOffset, uint64_t EndOffset,
-                            CompileUnit::DIEInfo &Info);
+                            CompileUnit::DIEInfo &Info) override;
 
     bool applyValidRelocs(MutableArrayRef<char> Data, uint64_t BaseOffset,
-                          bool IsLittleEndian);
+                          bool IsLittleEndian) override;
   };
 
   /// Keeps track of data associated with one object during linking.
@@ -148,6 +151,11 @@ private:
     RangesTy Ranges;
     UnitListTy CompileUnits;
 
+    /// The .swiftinterface files referenced by this object. They are merged
+    /// in ParseableSwiftInterfaces when the object is cloned, so that the
+    /// result does not depend on the order the objects are analyzed in.
+    std::map<std::string, std::string> ParseableSwiftInterfaces;
+
     LinkContext(const DebugMap &Map, DwarfLinker &Linker, DebugMapObject &DMO)
         : DMO(DMO), RelocMgr(Linker) {
       // Swift ASTs are not object files.
@@ -166,6 +174,7 @@ private:
       DwarfContext.reset(nullptr);
       CompileUnits.clear();
       Ranges.clear();
+      ParseableSwiftInterfaces.clear();
     }
   };
 
@@ -182,7 +191,7 @@ private:
   /// keep. Store that information in \p CU's DIEInfo.
   ///
   /// The return value indicates whether the DIE is incomplete.
-  void lookForDIEsToKeep(RelocationManager &RelocMgr, RangesTy &Ranges,
+  void lookForDIEsToKeep(AddressesMap &RelocMgr, RangesTy &Ranges,
                          const UnitListTy &Units, const DWARFDie &DIE,
                          const DebugMapObject &DMO, CompileUnit &CU,
                          unsigned Flags);
@@ -226,25 +235,25 @@ private:
   };
 
   /// Mark the passed DIE as well as all the ones it depends on as kept.
-  void keepDIEAndDependencies(RelocationManager &RelocMgr, RangesTy &Ranges,
+  void keepDIEAndDependencies(AddressesMap &RelocMgr, RangesTy &Ranges,
                               const UnitListTy &Units, const DWARFDie &DIE,
                               CompileUnit::DIEInfo &MyInfo,
                               const DebugMapObject &DMO, CompileUnit &CU,
                               bool UseODR);
 
-  unsigned shouldKeepDIE(RelocationManager &RelocMgr, RangesTy &Ranges,
+  unsigned shouldKeepDIE(AddressesMap &RelocMgr, RangesTy &Ranges,
                          const DWARFDie &DIE, const DebugMapObject &DMO,
                          CompileUnit &Unit, CompileUnit::DIEInfo &MyInfo,
                          unsigned Flags);
 
   /// Check if a variable describing DIE should be kept.
   /// \returns updated TraversalFlags.
-  unsigned shouldKeepVariableDIE(RelocationManager &RelocMgr,
-                                 const DWARFDie &DIE, CompileUnit &Unit,
+  unsigned shouldKeepVariableDIE(AddressesMap &RelocMgr, const DWARFDie &DIE,
+                                 CompileUnit &Unit,
                                  CompileUnit::DIEInfo &MyInfo, unsigned Flags);
 
-  unsigned shouldKeepSubprogramDIE(RelocationManager &RelocMgr,
-                                   RangesTy &Ranges, const DWARFDie &DIE,
+  unsigned shouldKeepSubprogramDIE(AddressesMap &RelocMgr, RangesTy &Ranges,
+                                   const DWARFDie &DIE,
                                    const DebugMapObject &DMO, CompileUnit &Unit,
                                    CompileUnit::DIEInfo &MyInfo,
                                    unsigned Flags);
@@ -259,7 +268,7 @@ private:
 
   class DIECloner {
     DwarfLinker &Linker;
-    RelocationManager &RelocMgr;
+    AddressesMap &RelocMgr;
 
     /// Allocator used for all the DIEValue objects.
     BumpPtrAllocator &DIEAlloc;
@@ -268,7 +277,7 @@ private:
     LinkOptions Options;
 
   public:
-    DIECloner(DwarfLinker &Linker, RelocationManager &RelocMgr,
+    DIECloner(DwarfLinker &Linker, AddressesMap &RelocMgr,
               BumpPtrAllocator &DIEAlloc,
               std::vector<std::unique_ptr<CompileUnit>> &CompileUnits,
               LinkOptions &Options)
@@ -469,6 +478,7 @@ private:
   std::unique_ptr<DwarfStreamer> Streamer;
   uint64_t OutputDebugInfoSize;
 
+  std::mutex DwarfVersionMutex;
   unsigned MaxDwarfVersion = 0;
   unsigned MinDwarfVersion = std::numeric_limits<unsigned>::max();
 
@@ -10,7 +10,7 @@
 #include "BinaryHolder.h"
 #include "DebugMap.h"
 #include "LinkUtils.h"
-#include "NonRelocatableStringpool.h"
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
 #include "llvm/MC/MCAsmLayout.h"
 #include "llvm/MC/MCMachObjectWriter.h"
 #include "llvm/MC/MCObjectStreamer.h"
@@ -442,7 +442,7 @@ bool generateDsymCompanion(const DebugMap &DM, SymbolMapTranslator &Translator,
   }
 
   SmallString<0> NewSymtab;
-  NonRelocatableStringpool NewStrings(Translator);
+  NonRelocatableStringpool NewStrings(Translator.asFunction());
   unsigned NListSize = Is64Bit ? sizeof(MachO::nlist_64) : sizeof(MachO::nlist);
   unsigned NumSyms = 0;
   uint64_t NewStringsSize = 0;
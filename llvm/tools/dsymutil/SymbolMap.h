@@ -11,6 +11,7 @@
 
 #include "llvm/ADT/StringRef.h"
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,14 @@ public:
 
   operator bool() const { return !UnobfuscatedStrings.empty(); }
 
+  /// \returns a function forwarding to this translator, as expected by the
+  /// string pools, or an empty function if there is nothing to translate.
+  std::function<StringRef(StringRef)> asFunction() {
+    if (!*this)
+      return nullptr;
+    return [this](StringRef Input) { return (*this)(Input); };
+  }
+
 private:
   std::vector<std::string> UnobfuscatedStrings;
   bool MangleNames;
@@ -117,7 +117,7 @@ static cl::opt<AccelTableKind> AcceleratorTable(
 static opt<unsigned> NumThreads(
     "num-threads",
     desc("Specifies the maximum number (n) of simultaneous threads to use\n"
-         "when linking multiple architectures."),
+         "when linking multiple architectures or object files."),
     value_desc("n"), init(0), cat(DsymCategory));
 static alias NumThreadsA("j", desc("Alias for --num-threads"),
                          aliasopt(NumThreads));
@@ -532,6 +532,11 @@ int main(int argc, char **argv) {
         std::min<unsigned>(OptionsOrErr->Threads, DebugMapPtrsOrErr->size());
     llvm::ThreadPool Threads(ThreadCount);
 
+    // Each link analyzes its object files on threads of its own, so share
+    // the threads between the architectures that are linked concurrently.
+    if (ThreadCount > 1)
+      OptionsOrErr->Threads = std::max(1U, OptionsOrErr->Threads / ThreadCount);
+
     // If there is more than one link to execute, we need to generate
     // temporary files.
     bool NeedsTempFiles =
@@ -13,6 +13,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/CodeGen/CommandFlags.inc"
@@ -21,6 +22,7 @@
 #include "llvm/CodeGen/MIRParser/MIRParser.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/AutoUpgrade.h"
@@ -126,6 +128,13 @@ static cl::opt<bool>
                           "manager and verify the result is the same."),
                  cl::init(false));
 
+static cl::opt<unsigned> CodeGenPartitions(
+    "codegen-partitions", cl::init(1), cl::value_desc("N"),
+    cl::desc("Split the module into N partitions and generate code for them "
+             "in parallel. Partition 0 is written to the output file and "
+             "partition I to the output file name followed by '.I'. The "
+             "outputs have to be linked together"));
+
 static cl::opt<bool> DiscardValueNames(
     "discard-value-names",
     cl::desc("Discard names from Value (other than GlobalValue)."),
@@ -388,6 +397,54 @@ static bool addPass(PassManagerBase &PM, const char *argv0,
   return false;
 }
 
+// Generate code for M in CodeGenPartitions partitions, each on its own thread
+// with its own LLVMContext and TargetMachine, the same way LTO parallel code
+// generation does.
+static int compileModuleInPartitions(const char *argv0,
+                                     std::unique_ptr<Module> M,
+                                     const Target *TheTarget,
+                                     const Triple &TheTriple,
+                                     const std::string &CPUStr,
+                                     const std::string &FeaturesStr,
+                                     const TargetOptions &Options,
+                                     CodeGenOpt::Level OLvl,
+                                     const TargetLibraryInfoImpl &TLII,
+                                     ToolOutputFile &Out) {
+  if (OutputFilename == "-") {
+    WithColor::error(errs(), argv0)
+        << "-codegen-partitions requires an output file\n";
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<ToolOutputFile>> PartOuts;
+  SmallVector<raw_pwrite_stream *, 8> OSs = {&Out.os()};
+  for (unsigned I = 1; I != CodeGenPartitions; ++I) {
+    std::error_code EC;
+    std::string Filename = OutputFilename + "." + utostr(I);
+    PartOuts.push_back(std::make_unique<ToolOutputFile>(
+        Filename, EC,
+        FileType == TargetMachine::CGFT_AssemblyFile ? sys::fs::OF_Text
+                                                     : sys::fs::OF_None));
+    if (EC) {
+      WithColor::error(errs(), argv0) << EC.message() << '\n';
+      return 1;
+    }
+    OSs.push_back(&PartOuts.back()->os());
+  }
+
+  auto TMFactory = [&]() {
+    return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
+        TheTriple.getTriple(), CPUStr, FeaturesStr, Options, getRelocModel(),
+        getCodeModel(), OLvl));
+  };
+  splitCodeGen(std::move(M), OSs, {}, TMFactory, FileType,
+               /*PreserveLocals=*/false, &TLII);
+
+  for (auto &PartOut : PartOuts)
+    PartOut->keep();
+  return 0;
+}
+
 static int compileModule(char **argv, LLVMContext &Context) {
   // Load the module to be compiled...
   SMDiagnostic Err;
@@ -523,6 +580,21 @@ static int compileModule(char **argv, LLVMContext &Context) {
     WithColor::warning(errs(), argv[0])
         << ": warning: ignoring -mc-relax-all because filetype != obj";
 
+  if (CodeGenPartitions > 1) {
+    if (MIR || !RunPassNames->empty() || CompileTwice || DwoOut) {
+      WithColor::error(errs(), argv[0])
+          << "-codegen-partitions cannot be used with MIR input, -run-pass, "
+             "-compile-twice or -split-dwarf-output\n";
+      return 1;
+    }
+    if (int Ret = compileModuleInPartitions(argv[0], std::move(M), TheTarget,
+                                            TheTriple, CPUStr, FeaturesStr,
+                                            Options, OLvl, TLII, *Out))
+      return Ret;
+    Out->keep();
+    return 0;
+  }
+
   {
     raw_pwrite_stream *OS = &Out->os();
 
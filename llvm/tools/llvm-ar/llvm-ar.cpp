@@ -11,6 +11,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/IR/LLVMContext.h"
@@ -585,6 +587,44 @@ static void performReadOperation(ArchiveOperation Operation,
   exit(1);
 }
 
+// The symbol table entries of the archives read so far, as the
+// NUL-terminated names that each member defines, keyed by member offset. None
+// if the symbol table could not be read.
+static DenseMap<const object::Archive *,
+                Optional<DenseMap<uint64_t, std::string>>>
+    ArchiveSymbols;
+
+// Return the names of the symbols the symbol table of its archive lists for
+// \p M, or None if the member has to be read to find them.
+static Optional<std::string>
+getOldSymbolNames(const object::Archive::Child &M) {
+  const object::Archive *Parent = M.getParent();
+  // The members of a thin archive may have changed since it was written.
+  if (Parent->isThin() || !Parent->hasSymbolTable())
+    return None;
+
+  auto Inserted = ArchiveSymbols.try_emplace(Parent);
+  Optional<DenseMap<uint64_t, std::string>> &Symbols = Inserted.first->second;
+  if (Inserted.second) {
+    Symbols.emplace();
+    for (const object::Archive::Symbol &S : Parent->symbols()) {
+      Expected<object::Archive::Child> ChildOrErr = S.getMember();
+      if (!ChildOrErr) {
+        consumeError(ChildOrErr.takeError());
+        Symbols = None;
+        break;
+      }
+      std::string &Names = (*Symbols)[ChildOrErr->getChildOffset()];
+      Names += S.getName();
+      Names += '\0';
+    }
+  }
+  if (!Symbols)
+    return None;
+  auto It = Symbols->find(M.getChildOffset());
+  return It == Symbols->end() ? std::string() : It->second;
+}
+
 static void addChildMember(std::vector<NewArchiveMember> &Members,
                            const object::Archive::Child &M,
                            bool FlattenArchive = false) {
@@ -625,6 +665,9 @@ static void addChildMember(std::vector<NewArchiveMember> &Members,
       return;
     }
   }
+  // Unchanged members keep their symbol table entries, which saves reading
+  // them again.
+  NMOrErr->SymbolNames = getOldSymbolNames(M);
   Members.push_back(std::move(*NMOrErr));
 }
 
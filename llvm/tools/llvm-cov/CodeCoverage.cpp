@@ -21,13 +21,17 @@
 #include "RenderingSupport.h"
 #include "SourceCoverageView.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/ProfileData/Coverage/CoverageMapping.h"
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
@@ -112,6 +116,21 @@ private:
   void writeSourceFileView(StringRef SourceFile, CoverageMapping *Coverage,
                            CoveragePrinter *Printer, bool ShowFilenames);
 
+  /// Compute a digest of what the view of \p SourceFile displays, or return
+  /// an empty string if its source can't be read.
+  std::string getSourceFileViewFingerprint(StringRef SourceFile,
+                                           const CoverageMapping &Coverage);
+
+  /// Get the path of the list of view fingerprints in the output directory.
+  std::string getViewFingerprintsPath() const;
+
+  /// Load the view fingerprints of the previous -incremental run, unless it
+  /// used other options, and remove them until this run is complete.
+  void readViewFingerprints(StringRef OptionsFingerprint);
+
+  /// Save the fingerprints of the views of this run.
+  void writeViewFingerprints(StringRef OptionsFingerprint);
+
   typedef llvm::function_ref<int(int, const char **)> CommandLineParserType;
 
   int doShow(int argc, const char **argv,
@@ -151,13 +170,21 @@ private:
   /// A lock which guards printing to stderr.
   std::mutex ErrsLock;
 
-  /// A container for input source file buffers.
+  /// A container for input source file buffers, keyed by the unique ID of the
+  /// file so that different paths to the same file share a buffer.
   std::mutex LoadedSourceFilesLock;
-  std::vector<std::pair<std::string, std::unique_ptr<MemoryBuffer>>>
-      LoadedSourceFiles;
+  std::map<sys::fs::UniqueID, std::unique_ptr<MemoryBuffer>> LoadedSourceFiles;
 
   /// Whitelist from -name-whitelist to be used for filtering.
   std::unique_ptr<SpecialCaseList> NameWhitelist;
+
+  /// In -incremental mode, the views which are unchanged since the previous
+  /// run are not rendered again. Both maps go from source files to the
+  /// fingerprints of their views.
+  bool IncrementalShow = false;
+  StringMap<std::string> PreviousViewFingerprints;
+  std::mutex ViewFingerprintsLock;
+  StringMap<std::string> ViewFingerprints;
 };
 }
 
@@ -236,16 +263,20 @@ CodeCoverageTool::getSourceFile(StringRef SourceFile) {
     if (Loc != RemappedFilenames.end())
       SourceFile = Loc->second;
   }
-  for (const auto &Files : LoadedSourceFiles)
-    if (sys::fs::equivalent(SourceFile, Files.first))
-      return *Files.second;
+  sys::fs::UniqueID ID;
+  if (auto EC = sys::fs::getUniqueID(SourceFile, ID)) {
+    error(EC.message(), SourceFile);
+    return EC;
+  }
+  auto Loaded = LoadedSourceFiles.find(ID);
+  if (Loaded != LoadedSourceFiles.end())
+    return *Loaded->second;
   auto Buffer = MemoryBuffer::getFile(SourceFile);
   if (auto EC = Buffer.getError()) {
     error(EC.message(), SourceFile);
     return EC;
   }
-  LoadedSourceFiles.emplace_back(SourceFile, std::move(Buffer.get()));
-  return *LoadedSourceFiles.back().second;
+  return *LoadedSourceFiles.emplace(ID, std::move(Buffer.get())).first->second;
 }
 
 void CodeCoverageTool::attachExpansionSubViews(
@@ -352,7 +383,8 @@ std::unique_ptr<CoverageMapping> CodeCoverageTool::load() {
       warning("profile data may be out of date - object is newer",
               ObjectFilename);
   auto CoverageOrErr =
-      CoverageMapping::load(ObjectFilenames, PGOFilename, CoverageArches);
+      CoverageMapping::load(ObjectFilenames, PGOFilename, CoverageArches,
+                            ViewOpts.NumThreads);
   if (Error E = CoverageOrErr.takeError()) {
     error("Failed to load coverage: " + toString(std::move(E)),
           join(ObjectFilenames.begin(), ObjectFilenames.end(), ", "));
@@ -516,6 +548,21 @@ void CodeCoverageTool::writeSourceFileView(StringRef SourceFile,
                                            CoverageMapping *Coverage,
                                            CoveragePrinter *Printer,
                                            bool ShowFilenames) {
+  std::string Fingerprint;
+  auto recordFingerprint = [&] {
+    std::lock_guard<std::mutex> Guard(ViewFingerprintsLock);
+    ViewFingerprints[SourceFile] = Fingerprint;
+  };
+  if (IncrementalShow) {
+    Fingerprint = getSourceFileViewFingerprint(SourceFile, *Coverage);
+    if (!Fingerprint.empty() &&
+        Fingerprint == PreviousViewFingerprints.lookup(SourceFile) &&
+        Printer->hasViewFile(SourceFile, /*InToplevel=*/false)) {
+      recordFingerprint();
+      return;
+    }
+  }
+
   auto View = createSourceFileView(SourceFile, *Coverage);
   if (!View) {
     warning("The file '" + SourceFile + "' isn't covered.");
@@ -533,6 +580,134 @@ void CodeCoverageTool::writeSourceFileView(StringRef SourceFile,
               /*ShowSourceName=*/ShowFilenames,
               /*ShowTitle=*/ViewOpts.hasOutputDirectory());
   Printer->closeViewFile(std::move(OS));
+  if (!Fingerprint.empty())
+    recordFingerprint();
+}
+
+std::string
+CodeCoverageTool::getSourceFileViewFingerprint(
+    StringRef SourceFile, const CoverageMapping &Coverage) {
+  MD5 Hash;
+  auto addInt = [&](uint64_t Value) {
+    uint8_t Bytes[sizeof(Value)];
+    support::endian::write64le(Bytes, Value);
+    Hash.update(Bytes);
+  };
+  auto addString = [&](StringRef Str) {
+    addInt(Str.size());
+    Hash.update(Str);
+  };
+  // The view displays the source of the file and of the files it expands.
+  StringSet<> HashedSources;
+  auto addSource = [&](StringRef Filename) {
+    if (!HashedSources.insert(Filename).second)
+      return true;
+    auto SourceBuffer = getSourceFile(Filename);
+    if (!SourceBuffer)
+      return false;
+    addString(Filename);
+    addString(SourceBuffer->getBuffer());
+    return true;
+  };
+  auto addFunction = [&](const FunctionRecord &Function) {
+    addString(Function.Name);
+    addInt(Function.ExecutionCount);
+    for (const std::string &Filename : Function.Filenames)
+      addString(Filename);
+    for (const CountedRegion &CR : Function.CountedRegions) {
+      for (uint64_t Field : {CR.LineStart, CR.ColumnStart, CR.LineEnd,
+                             CR.ColumnEnd, CR.FileID, CR.ExpandedFileID})
+        addInt(Field);
+      addInt(CR.Kind);
+      addInt(CR.ExecutionCount);
+      if (CR.Kind == CounterMappingRegion::ExpansionRegion)
+        addSource(Function.Filenames[CR.ExpandedFileID]);
+    }
+  };
+
+  if (!addSource(SourceFile))
+    return "";
+  CoverageData FileCoverage = Coverage.getCoverageForFile(SourceFile);
+  for (const CoverageSegment &Segment : FileCoverage)
+    for (uint64_t Field :
+         {uint64_t(Segment.Line), uint64_t(Segment.Col), Segment.Count,
+          uint64_t(Segment.HasCount), uint64_t(Segment.IsRegionEntry),
+          uint64_t(Segment.IsGapRegion)})
+      addInt(Field);
+  for (const ExpansionRecord &Expansion : FileCoverage.getExpansions()) {
+    addInt(Expansion.FileID);
+    addFunction(Expansion.Function);
+  }
+  if (ViewOpts.ShowFunctionInstantiations)
+    for (const auto &Group : Coverage.getInstantiationGroups(SourceFile)) {
+      addInt(Group.size());
+      for (const FunctionRecord *Function : Group.getInstantiations())
+        addFunction(*Function);
+    }
+
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  return Result.digest().str();
+}
+
+/// Compute a digest of the options which affect how source file views are
+/// rendered in -output-dir mode.
+static std::string getViewOptionsFingerprint(const CoverageViewOptions &Opts,
+                                             bool ShowFilenames) {
+  std::string Options;
+  raw_string_ostream OS(Options);
+  OS << LLVM_VERSION_STRING << ',' << int(Opts.Format) << ',' << Opts.Colors
+     << Opts.ShowLineNumbers << Opts.ShowLineStats << Opts.ShowRegionMarkers
+     << Opts.ShowExpandedRegions << Opts.ShowFunctionInstantiations
+     << ShowFilenames << ',' << Opts.TabSize << ',' << Opts.ProjectTitle;
+  for (const std::string &Arg : Opts.DemanglerOpts)
+    OS << ',' << Arg;
+  return toHex(MD5::hash(arrayRefFromStringRef(OS.str())), /*LowerCase=*/true);
+}
+
+std::string CodeCoverageTool::getViewFingerprintsPath() const {
+  SmallString<256> Path(ViewOpts.ShowOutputDirectory);
+  sys::path::append(Path, ".llvm-cov-fingerprints");
+  return Path.str();
+}
+
+void CodeCoverageTool::readViewFingerprints(StringRef OptionsFingerprint) {
+  std::string Path = getViewFingerprintsPath();
+  auto BufferOrErr = MemoryBuffer::getFile(Path);
+  if (!BufferOrErr)
+    return;
+  // Views rendered from here on are not described by the old fingerprints.
+  sys::fs::remove(Path);
+
+  // The first line holds the options fingerprint, and each other line the
+  // fingerprint of a view followed by the name of its source file.
+  SmallVector<StringRef, 0> Lines;
+  BufferOrErr.get()->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1,
+                                       /*KeepEmpty=*/false);
+  if (Lines.empty() || Lines.front() != OptionsFingerprint)
+    return;
+  for (StringRef Line : makeArrayRef(Lines).drop_front()) {
+    StringRef Fingerprint, SourceFile;
+    std::tie(Fingerprint, SourceFile) = Line.split(' ');
+    PreviousViewFingerprints[SourceFile] = Fingerprint;
+  }
+}
+
+void CodeCoverageTool::writeViewFingerprints(StringRef OptionsFingerprint) {
+  std::string Path = getViewFingerprintsPath();
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_Text);
+  if (EC) {
+    warning("Could not save view fingerprints: " + EC.message(), Path);
+    return;
+  }
+  std::vector<StringRef> SourceFiles;
+  for (const auto &Entry : ViewFingerprints)
+    SourceFiles.push_back(Entry.getKey());
+  llvm::sort(SourceFiles);
+  OS << OptionsFingerprint << '\n';
+  for (StringRef SourceFile : SourceFiles)
+    OS << ViewFingerprints[SourceFile] << ' ' << SourceFile << '\n';
 }
 
 int CodeCoverageTool::run(Command Cmd, int argc, const char **argv) {
@@ -836,6 +1011,13 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
       "project-title", cl::Optional,
       cl::desc("Set project title for the coverage report"));
 
+  cl::opt<bool> Incremental(
+      "incremental", cl::Optional,
+      cl::desc("Only render the source files whose views changed since the "
+               "last -incremental run into the same output directory. The "
+               "fingerprints of the views are kept in the file "
+               ".llvm-cov-fingerprints of the output directory"));
+
   auto Err = commandLineParser(argc, argv);
   if (Err)
     return Err;
@@ -862,6 +1044,16 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
     }
   }
 
+  IncrementalShow = Incremental;
+  if (IncrementalShow && !ViewOpts.hasOutputDirectory()) {
+    error("-incremental requires -output-dir.");
+    return 1;
+  }
+  if (IncrementalShow && !Filters.empty()) {
+    error("-incremental can't be used with function filters.");
+    return 1;
+  }
+
   sys::fs::file_status Status;
   if (sys::fs::status(PGOFilename, Status)) {
     error("profdata file error: can not get the file status. \n");
@@ -947,6 +1139,14 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
         std::max(1U, std::min(llvm::heavyweight_hardware_concurrency(),
                               unsigned(SourceFiles.size())));
 
+  // Only the views whose fingerprints changed get rendered in -incremental
+  // mode. The "Created" time shown by the others stays that of their profile.
+  std::string OptionsFingerprint;
+  if (IncrementalShow) {
+    OptionsFingerprint = getViewOptionsFingerprint(ViewOpts, ShowFilenames);
+    readViewFingerprints(OptionsFingerprint);
+  }
+
   if (!ViewOpts.hasOutputDirectory() || NumThreads == 1) {
     for (const std::string &SourceFile : SourceFiles)
       writeSourceFileView(SourceFile, Coverage.get(), Printer.get(),
@@ -960,6 +1160,9 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
     Pool.wait();
   }
 
+  if (IncrementalShow)
+    writeViewFingerprints(OptionsFingerprint);
+
   return 0;
 }
 
@@ -0,0 +1,57 @@
+//===- CoverageExporter.cpp - Code coverage exporter ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the parts shared by the code coverage exporters.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CoverageExporter.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
+
+using namespace llvm;
+
+void CoverageExporter::renderFilesInOrder(
+    unsigned NumFiles,
+    function_ref<void(unsigned FileIndex, raw_ostream &OS)> RenderFile,
+    function_ref<void(StringRef Rendered)> EmitFile) const {
+  auto NumThreads = Options.NumThreads;
+  if (NumThreads == 0)
+    NumThreads = std::max(1U, std::min(llvm::heavyweight_hardware_concurrency(),
+                                       NumFiles));
+
+  if (NumThreads == 1) {
+    std::string Rendered;
+    for (unsigned I = 0; I < NumFiles; ++I) {
+      Rendered.clear();
+      raw_string_ostream RenderedOS(Rendered);
+      RenderFile(I, RenderedOS);
+      EmitFile(RenderedOS.str());
+    }
+    return;
+  }
+
+  ThreadPool Pool(NumThreads);
+  const unsigned WindowSize = 4 * NumThreads;
+  std::vector<std::string> Window(WindowSize);
+  for (unsigned Begin = 0; Begin < NumFiles; Begin += WindowSize) {
+    unsigned End = std::min(NumFiles, Begin + WindowSize);
+    for (unsigned I = Begin; I < End; ++I)
+      Pool.async([&, I, Begin] {
+        raw_string_ostream RenderedOS(Window[I - Begin]);
+        RenderFile(I, RenderedOS);
+        RenderedOS.flush();
+      });
+    Pool.wait();
+    for (unsigned I = Begin; I < End; ++I) {
+      EmitFile(Window[I - Begin]);
+      Window[I - Begin].clear();
+    }
+  }
+}
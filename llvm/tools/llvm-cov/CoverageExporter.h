@@ -36,6 +36,16 @@ protected:
                    const CoverageViewOptions &Options, raw_ostream &OS)
       : Coverage(CoverageMapping), Options(Options), OS(OS) {}
 
+  /// Render \p NumFiles files with \p RenderFile, on up to Options.NumThreads
+  /// threads, and pass each rendered file to \p EmitFile in order.
+  ///
+  /// Files are rendered a few per thread at a time, so that the memory needed
+  /// does not grow with the number of files.
+  void renderFilesInOrder(
+      unsigned NumFiles,
+      function_ref<void(unsigned FileIndex, raw_ostream &OS)> RenderFile,
+      function_ref<void(StringRef Rendered)> EmitFile) const;
+
 public:
   virtual ~CoverageExporter(){};
 
@@ -43,12 +43,10 @@
 #include "CoverageExporterJson.h"
 #include "CoverageReport.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/JSON.h"
-#include "llvm/Support/ThreadPool.h"
-#include "llvm/Support/Threading.h"
-#include <algorithm>
-#include <mutex>
+#include <numeric>
 #include <utility>
 
 /// The semantic version combined as a string.
@@ -148,44 +146,11 @@ json::Object renderFile(const coverage::CoverageMapping &Coverage,
   return File;
 }
 
-json::Array renderFiles(const coverage::CoverageMapping &Coverage,
-                        ArrayRef<std::string> SourceFiles,
-                        ArrayRef<FileCoverageSummary> FileReports,
-                        const CoverageViewOptions &Options) {
-  auto NumThreads = Options.NumThreads;
-  if (NumThreads == 0) {
-    NumThreads = std::max(1U, std::min(llvm::heavyweight_hardware_concurrency(),
-                                       unsigned(SourceFiles.size())));
-  }
-  ThreadPool Pool(NumThreads);
-  json::Array FileArray;
-  std::mutex FileArrayMutex;
-
-  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I) {
-    auto &SourceFile = SourceFiles[I];
-    auto &FileReport = FileReports[I];
-    Pool.async([&] {
-      auto File = renderFile(Coverage, SourceFile, FileReport, Options);
-      {
-        std::lock_guard<std::mutex> Lock(FileArrayMutex);
-        FileArray.push_back(std::move(File));
-      }
-    });
-  }
-  Pool.wait();
-  return FileArray;
-}
-
-json::Array renderFunctions(
-    const iterator_range<coverage::FunctionRecordIterator> &Functions) {
-  json::Array FunctionArray;
-  for (const auto &F : Functions)
-    FunctionArray.push_back(
-        json::Object({{"name", F.Name},
-                      {"count", int64_t(F.ExecutionCount)},
-                      {"regions", renderRegions(F.CountedRegions)},
-                      {"filenames", json::Array(F.Filenames)}}));
-  return FunctionArray;
+json::Object renderFunction(const coverage::FunctionRecord &F) {
+  return json::Object({{"name", F.Name},
+                       {"count", int64_t(F.ExecutionCount)},
+                       {"regions", renderRegions(F.CountedRegions)},
+                       {"filenames", json::Array(F.Filenames)}});
 }
 
 } // end anonymous namespace
@@ -203,27 +168,40 @@ void CoverageExporterJson::renderRoot(ArrayRef<std::string> SourceFiles) {
   FileCoverageSummary Totals = FileCoverageSummary("Totals");
   auto FileReports = CoverageReport::prepareFileReports(Coverage, Totals,
                                                         SourceFiles, Options);
-  auto Files = renderFiles(Coverage, SourceFiles, FileReports, Options);
-  // Sort files in order of their names.
-  std::sort(Files.begin(), Files.end(),
-    [](const json::Value &A, const json::Value &B) {
-      const json::Object *ObjA = A.getAsObject();
-      const json::Object *ObjB = B.getAsObject();
-      assert(ObjA != nullptr && "Value A was not an Object");
-      assert(ObjB != nullptr && "Value B was not an Object");
-      const StringRef FilenameA = ObjA->getString("filename").getValue();
-      const StringRef FilenameB = ObjB->getString("filename").getValue();
-      return FilenameA.compare(FilenameB) < 0;
-    });
-  auto Export = json::Object(
-      {{"files", std::move(Files)}, {"totals", renderSummary(Totals)}});
-  // Skip functions-level information  if necessary.
-  if (!Options.ExportSummaryOnly && !Options.SkipFunctions)
-    Export["functions"] = renderFunctions(Coverage.getCoveredFunctions());
 
-  auto ExportArray = json::Array({std::move(Export)});
-
-  OS << json::Object({{"version", LLVM_COVERAGE_EXPORT_JSON_STR},
-                      {"type", LLVM_COVERAGE_EXPORT_JSON_TYPE_STR},
-                      {"data", std::move(ExportArray)}});
+  // Files are listed in order of their names.
+  std::vector<unsigned> FileOrder(SourceFiles.size());
+  std::iota(FileOrder.begin(), FileOrder.end(), 0);
+  llvm::stable_sort(FileOrder, [&](unsigned A, unsigned B) {
+    return SourceFiles[A] < SourceFiles[B];
+  });
+
+  // Stream the export instead of building it in memory, emitting attributes
+  // in the sorted order in which a json::Object would print them.
+  json::OStream J(OS);
+  J.object([&] {
+    J.attributeArray("data", [&] {
+      J.object([&] {
+        J.attributeArray("files", [&] {
+          renderFilesInOrder(
+              FileOrder.size(),
+              [&](unsigned I, raw_ostream &FileOS) {
+                unsigned File = FileOrder[I];
+                FileOS << json::Value(renderFile(Coverage, SourceFiles[File],
+                                                 FileReports[File], Options));
+              },
+              [&](StringRef Rendered) { J.rawValue(Rendered); });
+        });
+        // Skip functions-level information if necessary.
+        if (!Options.ExportSummaryOnly && !Options.SkipFunctions)
+          J.attributeArray("functions", [&] {
+            for (const auto &F : Coverage.getCoveredFunctions())
+              J.value(renderFunction(F));
+          });
+        J.attribute("totals", renderSummary(Totals));
+      });
+    });
+    J.attribute("type", LLVM_COVERAGE_EXPORT_JSON_TYPE_STR);
+    J.attribute("version", LLVM_COVERAGE_EXPORT_JSON_STR);
+  });
 }
@@ -96,14 +96,6 @@ void renderFile(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
   OS << "end_of_record\n";
 }
 
-void renderFiles(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
-                 ArrayRef<std::string> SourceFiles,
-                 ArrayRef<FileCoverageSummary> FileReports,
-                 bool ExportSummaryOnly) {
-  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
-    renderFile(OS, Coverage, SourceFiles[I], FileReports[I], ExportSummaryOnly);
-}
-
 } // end anonymous namespace
 
 void CoverageExporterLcov::renderRoot(const CoverageFilters &IgnoreFilters) {
@@ -119,6 +111,12 @@ void CoverageExporterLcov::renderRoot(ArrayRef<std::string> SourceFiles) {
   FileCoverageSummary Totals = FileCoverageSummary("Totals");
   auto FileReports = CoverageReport::prepareFileReports(Coverage, Totals,
                                                         SourceFiles, Options);
-  renderFiles(OS, Coverage, SourceFiles, FileReports,
-              Options.ExportSummaryOnly);
+  // Render the files in parallel, but emit them in the order given.
+  renderFilesInOrder(
+      SourceFiles.size(),
+      [&](unsigned I, raw_ostream &FileOS) {
+        renderFile(FileOS, Coverage, SourceFiles[I], FileReports[I],
+                   Options.ExportSummaryOnly);
+      },
+      [&](StringRef Rendered) { OS << Rendered; });
 }
@@ -111,6 +111,9 @@ public:
   /// Close a file which has been used to print a coverage view.
   virtual void closeViewFile(OwnedStream OS) = 0;
 
+  /// Check if the output directory holds the view file for \p Path.
+  virtual bool hasViewFile(StringRef Path, bool InToplevel) const = 0;
+
   /// Create an index which lists reports for the given source files.
   virtual Error createIndexFile(ArrayRef<std::string> SourceFiles,
                                 const CoverageMapping &Coverage,
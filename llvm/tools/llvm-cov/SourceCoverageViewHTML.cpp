@@ -15,6 +15,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/Path.h"
 
@@ -302,6 +303,11 @@ void CoveragePrinterHTML::closeViewFile(OwnedStream OS) {
   emitEpilog(*OS.get());
 }
 
+bool CoveragePrinterHTML::hasViewFile(StringRef Path, bool InToplevel) const {
+  return sys::fs::exists(getOutputPath(Path, "html", InToplevel,
+                                       /*Relative=*/false));
+}
+
 /// Emit column labels for the table in the index.
 static void emitColumnLabelsForIndex(raw_ostream &OS,
                                      const CoverageViewOptions &Opts) {
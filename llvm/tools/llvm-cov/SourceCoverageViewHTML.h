@@ -29,6 +29,8 @@ public:
 
   void closeViewFile(OwnedStream OS) override;
 
+  bool hasViewFile(StringRef Path, bool InToplevel) const override;
+
   Error createIndexFile(ArrayRef<std::string> SourceFiles,
                         const coverage::CoverageMapping &Coverage,
                         const CoverageFiltersMatchAll &Filters) override;
@@ -5,6 +5,8 @@
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFDebugLoc.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/ThreadPool.h"
+#include <atomic>
 
 #define DEBUG_TYPE "dwarfdump"
 using namespace llvm;
@@ -71,6 +73,43 @@ struct GlobalStats {
   uint64_t InlineFunctionSize = 0;
 };
 
+/// Merge the statistics \p From, collected over some compile units, into
+/// \p Into, collected over others.
+static void mergeStats(StringMap<PerFunctionStats> &Into,
+                       GlobalStats &IntoGlobal,
+                       const StringMap<PerFunctionStats> &From,
+                       const GlobalStats &FromGlobal) {
+  for (const auto &Entry : From) {
+    const PerFunctionStats &Src = Entry.getValue();
+    PerFunctionStats &Dst = Into[Entry.getKey()];
+    Dst.NumFnInlined += Src.NumFnInlined;
+    Dst.NumAbstractOrigins += Src.NumAbstractOrigins;
+    Dst.TotalVarWithLoc += Src.TotalVarWithLoc;
+    Dst.ConstantMembers += Src.ConstantMembers;
+    for (const auto &Var : Src.VarsInFunction)
+      Dst.VarsInFunction.insert(Var.getKey());
+    Dst.IsFunction |= Src.IsFunction;
+    Dst.HasPCAddresses |= Src.HasPCAddresses;
+    Dst.HasSourceLocation |= Src.HasSourceLocation;
+    Dst.NumParams += Src.NumParams;
+    Dst.NumParamSourceLocations += Src.NumParamSourceLocations;
+    Dst.NumParamTypes += Src.NumParamTypes;
+    Dst.NumParamLocations += Src.NumParamLocations;
+    Dst.NumVars += Src.NumVars;
+    Dst.NumVarSourceLocations += Src.NumVarSourceLocations;
+    Dst.NumVarTypes += Src.NumVarTypes;
+    Dst.NumVarLocations += Src.NumVarLocations;
+  }
+  IntoGlobal.ScopeBytesCovered += FromGlobal.ScopeBytesCovered;
+  IntoGlobal.ScopeBytesFromFirstDefinition +=
+      FromGlobal.ScopeBytesFromFirstDefinition;
+  IntoGlobal.CallSiteEntries += FromGlobal.CallSiteEntries;
+  IntoGlobal.CallSiteDIEs += FromGlobal.CallSiteDIEs;
+  IntoGlobal.CallSiteParamDIEs += FromGlobal.CallSiteParamDIEs;
+  IntoGlobal.FunctionSize += FromGlobal.FunctionSize;
+  IntoGlobal.InlineFunctionSize += FromGlobal.InlineFunctionSize;
+}
+
 /// Extract the low pc from a Die.
 static uint64_t getLowPC(DWARFDie Die) {
   auto RangesOrError = Die.getAddressRanges();
@@ -327,14 +366,42 @@ static void printDatum(raw_ostream &OS, const char *Key, uint64_t Value) {
 /// of particular optimizations. The raw numbers themselves are not particularly
 /// useful, only the delta between compiling the same program with different
 /// compilers is.
+///
+/// If \p DICtx is thread-safe, the compile units are visited by \p NumThreads
+/// threads, each collecting its own statistics, which are merged at the end.
 bool collectStatsForObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
-                               Twine Filename, raw_ostream &OS) {
+                               Twine Filename, raw_ostream &OS,
+                               unsigned NumThreads) {
   StringRef FormatName = Obj.getFileFormatName();
   GlobalStats GlobalStats;
   StringMap<PerFunctionStats> Statistics;
-  for (const auto &CU : static_cast<DWARFContext *>(&DICtx)->compile_units())
-    if (DWARFDie CUDie = CU->getNonSkeletonUnitDIE(false))
-      collectStatsRecursive(CUDie, "/", "g", 0, 0, 0, Statistics, GlobalStats);
+  std::vector<DWARFUnit *> CUs;
+  for (const auto &CU : DICtx.compile_units())
+    CUs.push_back(CU.get());
+  NumThreads = DICtx.isThreadSafe() ? std::min<size_t>(NumThreads, CUs.size())
+                                    : 1;
+  if (NumThreads <= 1) {
+    for (DWARFUnit *CU : CUs)
+      if (DWARFDie CUDie = CU->getNonSkeletonUnitDIE(false))
+        collectStatsRecursive(CUDie, "/", "g", 0, 0, 0, Statistics,
+                              GlobalStats);
+  } else {
+    std::vector<StringMap<PerFunctionStats>> ThreadStatistics(NumThreads);
+    std::vector<struct GlobalStats> ThreadGlobalStats(NumThreads);
+    std::atomic<size_t> NextCU(0);
+    ThreadPool Pool(NumThreads);
+    for (unsigned I = 0; I != NumThreads; ++I)
+      Pool.async([&, I]() {
+        for (size_t CU = NextCU++; CU < CUs.size(); CU = NextCU++)
+          if (DWARFDie CUDie = CUs[CU]->getNonSkeletonUnitDIE(false))
+            collectStatsRecursive(CUDie, "/", "g", 0, 0, 0,
+                                  ThreadStatistics[I], ThreadGlobalStats[I]);
+      });
+    Pool.wait();
+    for (unsigned I = 0; I != NumThreads; ++I)
+      mergeStats(Statistics, GlobalStats, ThreadStatistics[I],
+                 ThreadGlobalStats[I]);
+  }
 
   /// The version number should be increased every time the algorithm is changed
   /// (including bug fixes). New metrics may be added without increasing the
@@ -26,6 +26,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
@@ -212,6 +213,13 @@ static opt<bool> Verify("verify", desc("Verify the DWARF debug info."),
                         cat(DwarfDumpCategory));
 static opt<bool> Quiet("quiet", desc("Use with -verify to not emit to STDOUT."),
                        cat(DwarfDumpCategory));
+static opt<unsigned>
+    NumThreads("num-threads",
+               desc("Number of threads to use with -verify and -statistics "
+                    "(0 = one per hardware thread)."),
+               cat(DwarfDumpCategory), init(1), value_desc("N"));
+static alias NumThreadsAlias("j", desc("Alias for -num-threads."),
+                             aliasopt(NumThreads));
 static opt<bool> DumpUUID("uuid", desc("Show the UUID for each architecture."),
                           cat(DwarfDumpCategory));
 static alias DumpUUIDAlias("u", desc("Alias for -uuid."), aliasopt(DumpUUID));
@@ -233,6 +241,12 @@ static void error(StringRef Prefix, std::error_code EC) {
   exit(1);
 }
 
+static unsigned getNumThreads() {
+  if (!Verify && !Statistics)
+    return 1;
+  return NumThreads ? NumThreads : llvm::hardware_concurrency();
+}
+
 static DIDumpOptions getDumpOpts() {
   DIDumpOptions DumpOpts;
   DumpOpts.DumpType = DumpType;
@@ -244,6 +258,7 @@ static DIDumpOptions getDumpOpts() {
   DumpOpts.ShowForm = ShowForm;
   DumpOpts.SummarizeTypes = SummarizeTypes;
   DumpOpts.Verbose = Verbose;
+  DumpOpts.VerifyThreads = getNumThreads();
   // In -verify mode, print DIEs without children in error messages.
   if (Verify)
     return DumpOpts.noImplicitRecursion();
@@ -335,9 +350,16 @@ static void getDies(DWARFContext &DICtx, const AppleAcceleratorTable &Accel,
 
 static DWARFDie toDie(const DWARFDebugNames::Entry &Entry,
                       DWARFContext &DICtx) {
-  llvm::Optional<uint64_t> CUOff = Entry.getCUOffset();
   llvm::Optional<uint64_t> Off = Entry.getDIEUnitOffset();
-  if (!CUOff || !Off)
+  if (!Off)
+    return DWARFDie();
+
+  // The DIE is in a type unit in .debug_info.
+  if (llvm::Optional<uint64_t> TUOff = Entry.getLocalTUOffset())
+    return DICtx.getDIEForOffset(*TUOff + *Off);
+
+  llvm::Optional<uint64_t> CUOff = Entry.getCUOffset();
+  if (!CUOff)
     return DWARFDie();
 
   DWARFCompileUnit *CU = DICtx.getCompileUnitForOffset(*CUOff);
@@ -411,7 +433,13 @@ static bool lookup(ObjectFile &Obj, DWARFContext &DICtx, uint64_t Address,
 }
 
 bool collectStatsForObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
-                               Twine Filename, raw_ostream &OS);
+                               Twine Filename, raw_ostream &OS,
+                               unsigned NumThreads);
+
+static bool collectStats(ObjectFile &Obj, DWARFContext &DICtx, Twine Filename,
+                         raw_ostream &OS) {
+  return collectStatsForObjectFile(Obj, DICtx, Filename, OS, getNumThreads());
+}
 
 static bool dumpObjectFile(ObjectFile &Obj, DWARFContext &DICtx, Twine Filename,
                            raw_ostream &OS) {
@@ -482,6 +510,13 @@ static bool handleArchive(StringRef Filename, Archive &Arch,
   return Result;
 }
 
+/// Create the DWARF context of \p Obj, thread-safe if it is going to be
+/// processed by several threads.
+static std::unique_ptr<DWARFContext> createContext(const ObjectFile &Obj) {
+  return DWARFContext::create(Obj, nullptr, DWARFContext::defaultErrorHandler,
+                              "", /*ThreadSafe=*/getNumThreads() > 1);
+}
+
 static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
                          HandlerFn HandleObj, raw_ostream &OS) {
   Expected<std::unique_ptr<Binary>> BinOrErr = object::createBinary(Buffer);
@@ -490,7 +525,7 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
   bool Result = true;
   if (auto *Obj = dyn_cast<ObjectFile>(BinOrErr->get())) {
     if (filterArch(*Obj)) {
-      std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(*Obj);
+      std::unique_ptr<DWARFContext> DICtx = createContext(*Obj);
       Result = HandleObj(*Obj, *DICtx, Filename, OS);
     }
   }
@@ -501,7 +536,7 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
       if (auto MachOOrErr = ObjForArch.getAsObjectFile()) {
         auto &Obj = **MachOOrErr;
         if (filterArch(Obj)) {
-          std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(Obj);
+          std::unique_ptr<DWARFContext> DICtx = createContext(Obj);
           Result &= HandleObj(Obj, *DICtx, ObjName, OS);
         }
         continue;
@@ -637,7 +672,7 @@ int main(int argc, char **argv) {
       return 1;
   } else if (Statistics)
     for (auto Object : Objects)
-      handleFile(Object, collectStatsForObjectFile, OutputFile.os());
+      handleFile(Object, collectStats, OutputFile.os());
   else
     for (auto Object : Objects)
       handleFile(Object, dumpObjectFile, OutputFile.os());
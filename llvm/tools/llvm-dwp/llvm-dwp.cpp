@@ -15,6 +15,7 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFFormValue.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnitIndex.h"
@@ -36,6 +37,7 @@
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
@@ -393,34 +395,13 @@ static Error handleSection(
     const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
     const MCSection *StrSection, const MCSection *StrOffsetSection,
     const MCSection *TypesSection, const MCSection *CUIndexSection,
-    const MCSection *TUIndexSection, const SectionRef &Section, MCStreamer &Out,
-    std::deque<SmallString<32>> &UncompressedSections,
-    uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
+    const MCSection *TUIndexSection, StringRef Name, StringRef Contents,
+    MCStreamer &Out, uint32_t (&ContributionOffsets)[8],
+    UnitIndexEntry &CurEntry,
     StringRef &CurStrSection, StringRef &CurStrOffsetSection,
     std::vector<StringRef> &CurTypesSection, StringRef &InfoSection,
     StringRef &AbbrevSection, StringRef &CurCUIndexSection,
     StringRef &CurTUIndexSection) {
-  if (Section.isBSS())
-    return Error::success();
-
-  if (Section.isVirtual())
-    return Error::success();
-
-  Expected<StringRef> NameOrErr = Section.getName();
-  if (!NameOrErr)
-    return NameOrErr.takeError();
-  StringRef Name = *NameOrErr;
-
-  Expected<StringRef> ContentsOrErr = Section.getContents();
-  if (!ContentsOrErr)
-    return ContentsOrErr.takeError();
-  StringRef Contents = *ContentsOrErr;
-
-  if (auto Err = handleCompressedSection(UncompressedSections, Name, Contents))
-    return Err;
-
-  Name = Name.substr(Name.find_first_not_of("._"));
-
   auto SectionPair = KnownSections.find(Name);
   if (SectionPair == KnownSections.end())
     return Error::success();
@@ -463,6 +444,45 @@ static Error handleSection(
   return Error::success();
 }
 
+// An input file, with the names and the decompressed contents of the sections
+// it has data for.
+struct InputFile {
+  OwningBinary<object::ObjectFile> Obj;
+  std::vector<std::pair<StringRef, StringRef>> Sections;
+  std::deque<SmallString<32>> UncompressedSections;
+};
+
+static Expected<std::unique_ptr<InputFile>> readInput(StringRef Input) {
+  auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
+  if (!ErrOrObj)
+    return ErrOrObj.takeError();
+
+  auto In = std::make_unique<InputFile>();
+  In->Obj = std::move(*ErrOrObj);
+  for (const auto &Section : In->Obj.getBinary()->sections()) {
+    if (Section.isBSS() || Section.isVirtual())
+      continue;
+
+    Expected<StringRef> NameOrErr = Section.getName();
+    if (!NameOrErr)
+      return NameOrErr.takeError();
+    StringRef Name = *NameOrErr;
+
+    Expected<StringRef> ContentsOrErr = Section.getContents();
+    if (!ContentsOrErr)
+      return ContentsOrErr.takeError();
+    StringRef Contents = *ContentsOrErr;
+
+    if (auto Err =
+            handleCompressedSection(In->UncompressedSections, Name, Contents))
+      return std::move(Err);
+
+    Name = Name.substr(Name.find_first_not_of("._"));
+    In->Sections.emplace_back(Name, Contents);
+  }
+  return std::move(In);
+}
+
 static Error
 buildDuplicateError(const std::pair<uint64_t, UnitIndexEntry> &PrevE,
                     const CompileUnitIdentifiers &ID, StringRef DWPName) {
@@ -527,18 +547,27 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
 
   DWPStringPool Strings(Out, StrSection);
 
-  SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
-  Objects.reserve(Inputs.size());
-
-  std::deque<SmallString<32>> UncompressedSections;
-
-  for (const auto &Input : Inputs) {
-    auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
-    if (!ErrOrObj)
-      return ErrOrObj.takeError();
-
-    auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+  // Opening the inputs and decompressing their sections is independent for
+  // each input, so it is done in parallel. The sections are then written in
+  // the order of the inputs, which keeps the output deterministic.
+  std::vector<Optional<Expected<std::unique_ptr<InputFile>>>> Files(
+      Inputs.size());
+  parallel::for_each_n(parallel::par, size_t(0), Inputs.size(),
+                       [&](size_t I) { Files[I].emplace(readInput(Inputs[I])); });
+  // Only the first failure is reported; drop those of the inputs after it.
+  auto ConsumeErrors = make_scope_exit([&] {
+    for (auto &ErrOrFile : Files)
+      if (!*ErrOrFile)
+        consumeError(ErrOrFile->takeError());
+  });
+
+  for (size_t I = 0; I != Inputs.size(); ++I) {
+    const std::string &Input = Inputs[I];
+    Expected<std::unique_ptr<InputFile>> &ErrOrFile = *Files[I];
+    if (!ErrOrFile)
+      return ErrOrFile.takeError();
+
+    auto &Obj = *(*ErrOrFile)->Obj.getBinary();
 
     UnitIndexEntry CurEntry = {};
 
@@ -550,13 +579,13 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
     StringRef CurCUIndexSection;
     StringRef CurTUIndexSection;
 
-    for (const auto &Section : Obj.sections())
+    for (const auto &Section : (*ErrOrFile)->Sections)
       if (auto Err = handleSection(
               KnownSections, StrSection, StrOffsetSection, TypesSection,
-              CUIndexSection, TUIndexSection, Section, Out,
-              UncompressedSections, ContributionOffsets, CurEntry,
-              CurStrSection, CurStrOffsetSection, CurTypesSection, InfoSection,
-              AbbrevSection, CurCUIndexSection, CurTUIndexSection))
+              CUIndexSection, TUIndexSection, Section.first, Section.second,
+              Out, ContributionOffsets, CurEntry, CurStrSection,
+              CurStrOffsetSection, CurTypesSection, InfoSection, AbbrevSection,
+              CurCUIndexSection, CurTUIndexSection))
         return Err;
 
     if (InfoSection.empty())
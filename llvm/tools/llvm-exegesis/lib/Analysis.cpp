@@ -215,6 +215,25 @@ Analysis::ResolvedSchedClassAndPoints::ResolvedSchedClassAndPoints(
     ResolvedSchedClass &&RSC)
     : RSC(std::move(RSC)) {}
 
+void Analysis::setBaseline(llvm::ArrayRef<InstructionBenchmark> Baseline) {
+  Baseline_.clear();
+  for (const InstructionBenchmark &Point : Baseline)
+    if (Point.Error.empty() && !Point.Key.Instructions.empty())
+      Baseline_.emplace(Point.Mode, Point.keyInstruction().getOpcode());
+}
+
+bool Analysis::isInBaseline(
+    const ResolvedSchedClassAndPoints &RSCAndPoints) const {
+  if (Baseline_.empty())
+    return false;
+  const auto &Points = Clustering_.getPoints();
+  return llvm::all_of(RSCAndPoints.PointIds, [this, &Points](size_t PointId) {
+    const InstructionBenchmark &Point = Points[PointId];
+    return Baseline_.count(
+        {Point.Mode, Point.keyInstruction().getOpcode()}) != 0;
+  });
+}
+
 std::vector<Analysis::ResolvedSchedClassAndPoints>
 Analysis::makePointsPerSchedClass() const {
   std::vector<ResolvedSchedClassAndPoints> Entries;
@@ -514,6 +533,8 @@ llvm::Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
     if (!RSCAndPoints.RSC.SCDesc)
       continue;
+    if (isInBaseline(RSCAndPoints))
+      continue; // Already analyzed with the baseline.
     // Bucket sched class points into sched class clusters.
     std::vector<SchedClassCluster> SchedClassClusters;
     for (const size_t PointId : RSCAndPoints.PointIds) {
@@ -49,6 +49,11 @@ public:
 
   template <typename Pass> llvm::Error run(llvm::raw_ostream &OS) const;
 
+  // Only report the sched classes of instructions that were measured anew,
+  // i.e. that have a point in the clustering but not in `Baseline`, in the
+  // inconsistency analysis.
+  void setBaseline(llvm::ArrayRef<InstructionBenchmark> Baseline);
+
 private:
   using ClusterId = InstructionBenchmarkClustering::ClusterId;
 
@@ -99,6 +104,10 @@ private:
     std::vector<size_t> PointIds;
   };
 
+  // Returns true if all the points of the sched class were already measured
+  // in the baseline.
+  bool isInBaseline(const ResolvedSchedClassAndPoints &RSCAndPoints) const;
+
   // Builds a list of ResolvedSchedClassAndPoints.
   std::vector<ResolvedSchedClassAndPoints> makePointsPerSchedClass() const;
 
@@ -117,6 +126,8 @@ private:
   std::unique_ptr<llvm::MCDisassembler> Disasm_;
   const double AnalysisInconsistencyEpsilonSquared_;
   const bool AnalysisDisplayUnstableOpcodes_;
+  // The (mode, opcode) pairs of the key instructions of the baseline.
+  std::set<std::pair<InstructionBenchmark::ModeE, unsigned>> Baseline_;
 };
 
 } // namespace exegesis
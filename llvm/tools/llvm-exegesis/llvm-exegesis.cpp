@@ -30,13 +30,20 @@
 #include "llvm/MC/MCSubtargetInfo.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include <algorithm>
+#include <set>
 #include <string>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 namespace llvm {
 namespace exegesis {
@@ -85,6 +92,13 @@ static cl::opt<unsigned>
                    cl::desc("number of time to repeat the asm snippet"),
                    cl::cat(BenchmarkOptions), cl::init(10000));
 
+static cl::opt<std::string> BenchmarkCpus(
+    "benchmark-cpus",
+    cl::desc("comma-separated list of cpus or cpu ranges (e.g. '2,4-7') to "
+             "distribute the benchmarks over, with one process pinned to each "
+             "cpu (linux only)"),
+    cl::cat(BenchmarkOptions), cl::init(""));
+
 static cl::opt<bool> IgnoreInvalidSchedClass(
     "ignore-invalid-sched-class",
     cl::desc("ignore instructions that do not define a sched class"),
@@ -124,6 +138,14 @@ static cl::opt<std::string>
                                       cl::desc(""), cl::cat(AnalysisOptions),
                                       cl::init(""));
 
+static cl::opt<std::string> AnalysisBaselineFile(
+    "analysis-baseline-file",
+    cl::desc("benchmark results that were analyzed before. only the sched "
+             "classes with opcodes that are not in this file are checked for "
+             "inconsistencies, e.g. to check each new batch of benchmarks "
+             "as it completes"),
+    cl::cat(AnalysisOptions), cl::init(""));
+
 static cl::opt<bool> AnalysisDisplayUnstableOpcodes(
     "analysis-display-unstable-clusters",
     cl::desc("if there is more than one benchmark for an opcode, said "
@@ -355,6 +377,100 @@ readSnippets(const LLVMState &State, llvm::StringRef Filename) {
   return std::vector<BenchmarkCode>{std::move(Result)};
 }
 
+// Parses a list of cpus such as "2,4-7".
+static std::vector<unsigned> parseCpuListOrDie(llvm::StringRef List) {
+  std::vector<unsigned> Cpus;
+  llvm::SmallVector<llvm::StringRef, 4> Pieces;
+  List.split(Pieces, ",", /* MaxSplit */ -1, /* KeepEmpty */ false);
+  for (llvm::StringRef Piece : Pieces) {
+    llvm::StringRef First, Last;
+    std::tie(First, Last) = Piece.trim().split('-');
+    unsigned FirstCpu, LastCpu;
+    if (First.getAsInteger(10, FirstCpu))
+      llvm::report_fatal_error("invalid cpu list: " + List);
+    LastCpu = FirstCpu;
+    if (!Last.empty() && (Last.getAsInteger(10, LastCpu) || LastCpu < FirstCpu))
+      llvm::report_fatal_error("invalid cpu list: " + List);
+    for (unsigned Cpu = FirstCpu; Cpu <= LastCpu; ++Cpu)
+      Cpus.push_back(Cpu);
+  }
+  return Cpus;
+}
+
+#ifdef __linux__
+static void pinToCpuOrDie(unsigned Cpu) {
+  cpu_set_t CpuSet;
+  CPU_ZERO(&CpuSet);
+  CPU_SET(Cpu, &CpuSet);
+  if (sched_setaffinity(0, sizeof(CpuSet), &CpuSet))
+    llvm::report_fatal_error("cannot pin the benchmarks to cpu " +
+                             llvm::Twine(Cpu));
+}
+
+// Runs configuration I of `Configurations` in the process pinned to
+// Cpus[I % Cpus.size()], and writes all the results to `OS` in order.
+static void
+runConfigurationsOnCpus(const LLVMState &State, const BenchmarkRunner &Runner,
+                        llvm::ArrayRef<BenchmarkCode> Configurations,
+                        llvm::ArrayRef<unsigned> Cpus, llvm::raw_ostream &OS) {
+  const size_t NumShards = Cpus.size();
+  std::vector<llvm::SmallString<128>> ShardFiles(NumShards);
+  std::vector<pid_t> Pids(NumShards);
+  for (size_t Shard = 0; Shard < NumShards; ++Shard) {
+    if (std::error_code EC = llvm::sys::fs::createTemporaryFile(
+            "llvm-exegesis", "yaml", ShardFiles[Shard]))
+      llvm::report_fatal_error("cannot create a temporary file: " +
+                               EC.message());
+    // Do not let the children inherit buffered output.
+    OS.flush();
+    llvm::outs().flush();
+    Pids[Shard] = fork();
+    if (Pids[Shard] < 0)
+      llvm::report_fatal_error("cannot start the benchmark processes");
+    if (Pids[Shard] != 0)
+      continue;
+
+    pinToCpuOrDie(Cpus[Shard]);
+    std::error_code EC;
+    llvm::raw_fd_ostream ShardOS(ShardFiles[Shard], EC, llvm::sys::fs::OF_Text);
+    if (EC)
+      llvm::report_fatal_error("cannot open " + ShardFiles[Shard] + ": " +
+                               EC.message());
+    for (size_t I = Shard; I < Configurations.size(); I += NumShards) {
+      InstructionBenchmark Result = Runner.runConfiguration(
+          Configurations[I], NumRepetitions, DumpObjectToDisk);
+      ExitOnErr(Result.writeYamlTo(State, ShardOS));
+    }
+    ShardOS.close();
+    llvm::outs().flush();
+    _exit(ShardOS.has_error() ? EXIT_FAILURE : EXIT_SUCCESS);
+  }
+
+  bool Failed = false;
+  for (size_t Shard = 0; Shard < NumShards; ++Shard) {
+    int Status;
+    if (waitpid(Pids[Shard], &Status, 0) != Pids[Shard] ||
+        !WIFEXITED(Status) || WEXITSTATUS(Status) != EXIT_SUCCESS) {
+      llvm::errs() << "the benchmarks on cpu " << Cpus[Shard] << " failed\n";
+      Failed = true;
+    }
+  }
+
+  // Merge the results back in the order of the configurations.
+  std::vector<std::vector<InstructionBenchmark>> Shards;
+  for (const llvm::SmallString<128> &ShardFile : ShardFiles) {
+    if (!Failed)
+      Shards.push_back(
+          ExitOnErr(InstructionBenchmark::readYamls(State, ShardFile)));
+    llvm::sys::fs::remove(ShardFile);
+  }
+  if (Failed)
+    llvm::report_fatal_error("cannot run all the benchmarks");
+  for (size_t I = 0; I < Configurations.size(); ++I)
+    ExitOnErr(Shards[I % NumShards][I / NumShards].writeYamlTo(State, OS));
+}
+#endif
+
 void benchmarkMain() {
 #ifndef HAVE_LIBPFM
   llvm::report_fatal_error(
@@ -409,11 +525,37 @@ void benchmarkMain() {
   // Write to standard output if file is not set.
   if (BenchmarkFile.empty())
     BenchmarkFile = "-";
-
-  for (const BenchmarkCode &Conf : Configurations) {
-    InstructionBenchmark Result =
-        Runner->runConfiguration(Conf, NumRepetitions, DumpObjectToDisk);
-    ExitOnErr(Result.writeYaml(State, BenchmarkFile));
+  std::unique_ptr<llvm::raw_fd_ostream> FileOS;
+  if (BenchmarkFile != "-") {
+    std::error_code EC;
+    FileOS = std::make_unique<llvm::raw_fd_ostream>(BenchmarkFile, EC,
+                                                    llvm::sys::fs::OF_Text);
+    if (EC)
+      llvm::report_fatal_error("cannot open " + BenchmarkFile + ": " +
+                               EC.message());
+  }
+  llvm::raw_ostream &OS = FileOS ? *FileOS : llvm::outs();
+
+  const std::vector<unsigned> Cpus = parseCpuListOrDie(BenchmarkCpus);
+  if (Cpus.size() > 1) {
+#ifdef __linux__
+    runConfigurationsOnCpus(State, *Runner, Configurations, Cpus, OS);
+#else
+    llvm::report_fatal_error("--benchmark-cpus is only supported on linux");
+#endif
+  } else {
+    if (!Cpus.empty()) {
+#ifdef __linux__
+      pinToCpuOrDie(Cpus.front());
+#else
+      llvm::report_fatal_error("--benchmark-cpus is only supported on linux");
+#endif
+    }
+    for (const BenchmarkCode &Conf : Configurations) {
+      InstructionBenchmark Result =
+          Runner->runConfiguration(Conf, NumRepetitions, DumpObjectToDisk);
+      ExitOnErr(Result.writeYamlTo(State, OS));
+    }
   }
   exegesis::pfm::pfmTerminate();
 }
@@ -479,9 +621,12 @@ static void analysisMain() {
       Points, AnalysisClusteringAlgorithm, AnalysisDbscanNumPoints,
       AnalysisClusteringEpsilon, InstrInfo->getNumOpcodes()));
 
-  const Analysis Analyzer(*TheTarget, std::move(InstrInfo), Clustering,
-                          AnalysisInconsistencyEpsilon,
-                          AnalysisDisplayUnstableOpcodes);
+  Analysis Analyzer(*TheTarget, std::move(InstrInfo), Clustering,
+                    AnalysisInconsistencyEpsilon,
+                    AnalysisDisplayUnstableOpcodes);
+  if (!AnalysisBaselineFile.empty())
+    Analyzer.setBaseline(ExitOnErr(
+        InstructionBenchmark::readYamls(State, AnalysisBaselineFile)));
 
   maybeRunAnalysis<Analysis::PrintClusters>(Analyzer, "analysis clusters",
                                             AnalysisClustersOutputFile);
@@ -249,6 +249,8 @@ void Session::modifyPassConfig(const Triple &FTT,
     PassConfig.PostFixupPasses.push_back([this](AtomGraph &G) {
       if (TT.getObjectFormat() == Triple::MachO)
         return registerMachOStubsAndGOT(*this, G);
+      if (TT.getObjectFormat() == Triple::ELF)
+        return registerELFStubsAndGOT(*this, G);
       return make_error<StringError>("Unsupported object format for GOT/stub "
                                      "registration",
                                      inconvertibleErrorCode());
@@ -66,6 +66,7 @@ struct Session {
 };
 
 Error registerMachOStubsAndGOT(Session &S, jitlink::AtomGraph &G);
+Error registerELFStubsAndGOT(Session &S, jitlink::AtomGraph &G);
 
 } // end namespace llvm
 
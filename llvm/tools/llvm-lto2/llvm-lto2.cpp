@@ -277,7 +277,7 @@ static int run(int argc, char **argv) {
                                             /* NewPrefix */ "",
                                             /* ShouldEmitImportsFiles */ true,
                                             /* LinkedObjectsFile */ nullptr,
-                                            /* OnWrite */ {});
+                                            /* OnWrite */ {}, Threads);
   else
     Backend = createInProcessThinBackend(Threads);
   LTO Lto(std::move(Conf), std::move(Backend));
@@ -21,5 +21,15 @@ void PipelinePrinter::printReport(llvm::raw_ostream &OS) const {
   for (const auto &V : Views)
     V->printView(OS);
 }
+
+json::Object PipelinePrinter::toJSON() const {
+  json::Object JO;
+  for (const auto &V : Views) {
+    StringRef Name = V->getNameAsString();
+    if (!Name.empty())
+      JO[Name] = V->toJSON();
+  }
+  return JO;
+}
 } // namespace mca.
 } // namespace llvm
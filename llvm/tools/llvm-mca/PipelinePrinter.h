@@ -46,6 +46,9 @@ public:
   }
 
   void printReport(llvm::raw_ostream &OS) const;
+
+  // Returns an object with the JSON value of every named view.
+  llvm::json::Object toJSON() const;
 };
 } // namespace mca
 } // namespace llvm
@@ -620,5 +620,25 @@ void BottleneckAnalysis::printView(raw_ostream &OS) const {
   printCriticalSequence(OS);
 }
 
+json::Value BottleneckAnalysis::toJSON() const {
+  // The cycles in which each processor resource increased backend pressure.
+  json::Object Resources;
+  ArrayRef<unsigned> Distribution = Tracker.getResourcePressureDistribution();
+  const MCSchedModel &SM = STI.getSchedModel();
+  for (unsigned I = 0, E = Distribution.size(); I < E; ++I)
+    if (Distribution[I])
+      Resources[SM.getProcResource(I)->Name] = Distribution[I];
+
+  return json::Object(
+      {{"BottlenecksFound", SeenStallCycles && BPI.PressureIncreaseCycles},
+       {"TotalCycles", TotalCycles},
+       {"PressureIncreaseCycles", BPI.PressureIncreaseCycles},
+       {"ResourcePressureCycles", BPI.ResourcePressureCycles},
+       {"DataDependencyCycles", BPI.DataDependencyCycles},
+       {"RegisterDependencyCycles", BPI.RegisterDependencyCycles},
+       {"MemoryDependencyCycles", BPI.MemoryDependencyCycles},
+       {"ResourcePressure", std::move(Resources)}});
+}
+
 } // namespace mca.
 } // namespace llvm
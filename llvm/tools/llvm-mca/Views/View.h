@@ -15,7 +15,9 @@
 #ifndef LLVM_TOOLS_LLVM_MCA_VIEW_H
 #define LLVM_TOOLS_LLVM_MCA_VIEW_H
 
+#include "llvm/ADT/StringRef.h"
 #include "llvm/MCA/HWEventListener.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
@@ -24,6 +26,12 @@ namespace mca {
 class View : public HWEventListener {
 public:
   virtual void printView(llvm::raw_ostream &OS) const = 0;
+
+  /// The name of this view in machine-readable reports. Views without a name
+  /// are left out of them.
+  virtual llvm::StringRef getNameAsString() const { return ""; }
+  virtual llvm::json::Value toJSON() const { return nullptr; }
+
   virtual ~View() = default;
   void anchor() override;
 };
@@ -53,12 +53,15 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
+#include <deque>
 
 using namespace llvm;
 
@@ -179,6 +182,12 @@ static cl::opt<unsigned> StoreQueueSize("squeue",
                                         cl::desc("Size of the store queue"),
                                         cl::cat(ToolOptions), cl::init(0));
 
+static cl::opt<bool>
+    BatchMode("batch",
+              cl::desc("Simulate the code regions in parallel, and print a "
+                       "JSON summary of each instead of the views"),
+              cl::cat(ToolOptions), cl::init(false));
+
 static cl::opt<bool>
     PrintInstructionTables("instruction-tables",
                            cl::desc("Print instruction tables"),
@@ -268,6 +277,22 @@ static void processViewOptions() {
   processOptionImpl(PrintRetireStats, Default);
 }
 
+static void reportInstructionError(Error E, MCInstPrinter &IP,
+                                   const MCSubtargetInfo &STI) {
+  if (auto NewE = handleErrors(
+          std::move(E), [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
+            std::string InstructionStr;
+            raw_string_ostream SS(InstructionStr);
+            WithColor::error() << IE.Message << '\n';
+            IP.printInst(&IE.Inst, SS, "", STI);
+            SS.flush();
+            WithColor::note() << "instruction: " << InstructionStr << '\n';
+          })) {
+    // Default case.
+    WithColor::error() << toString(std::move(NewE));
+  }
+}
+
 // Returns true on success.
 static bool runPipeline(mca::Pipeline &P) {
   // Handle pipeline errors here.
@@ -279,6 +304,87 @@ static bool runPipeline(mca::Pipeline &P) {
   return true;
 }
 
+namespace {
+// A code region lowered for the batch mode, and its report.
+struct BatchRegion {
+  StringRef Description;
+  ArrayRef<MCInst> Insts;
+  std::vector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+  json::Object Report;
+  std::string Error;
+};
+} // end of anonymous namespace
+
+// Simulate every non-empty region in a pipeline of its own, in parallel, and
+// print a JSON array with the summary and the bottlenecks of each to OS.
+// Returns true on success.
+static bool runBatch(const mca::CodeRegions &Regions, mca::InstrBuilder &IB,
+                     const MCSubtargetInfo &STI, const MCRegisterInfo &MRI,
+                     MCInstPrinter &IP, const mca::PipelineOptions &PO,
+                     raw_ostream &OS) {
+  // Lower all the regions up front. The descriptors that IB caches are shared
+  // by all the regions, and are read-only from here on. IB is not cleared in
+  // between regions, so that the variant descriptors of the earlier regions
+  // stay alive; they are keyed by MCInst, which are distinct for each region.
+  std::deque<BatchRegion> Batch;
+  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions) {
+    if (Region->empty())
+      continue;
+    Batch.emplace_back();
+    BatchRegion &BR = Batch.back();
+    BR.Description = Region->getDescription();
+    BR.Insts = Region->getInstructions();
+    for (const MCInst &MCI : BR.Insts) {
+      Expected<std::unique_ptr<mca::Instruction>> Inst =
+          IB.createInstruction(MCI);
+      if (!Inst) {
+        reportInstructionError(Inst.takeError(), IP, STI);
+        return false;
+      }
+      BR.LoweredSequence.emplace_back(std::move(Inst.get()));
+    }
+  }
+
+  // The hardware units of a pipeline are stateful, so every region gets its
+  // own mca::Context. Everything else they use is only read.
+  const MCSchedModel &SM = STI.getSchedModel();
+  parallel::for_each_n(parallel::par, size_t(0), Batch.size(), [&](size_t I) {
+    BatchRegion &BR = Batch[I];
+    mca::Context MCA(MRI, STI);
+    mca::SourceMgr S(BR.LoweredSequence, Iterations);
+    auto P = MCA.createDefaultPipeline(PO, S);
+    mca::PipelinePrinter Printer(*P);
+    Printer.addView(
+        std::make_unique<mca::SummaryView>(SM, BR.Insts, DispatchWidth));
+    Printer.addView(std::make_unique<mca::BottleneckAnalysis>(
+        STI, IP, BR.Insts, S.getNumIterations()));
+    Expected<unsigned> Cycles = P->run();
+    if (!Cycles) {
+      BR.Error = toString(Cycles.takeError());
+      return;
+    }
+    BR.Report = Printer.toJSON();
+  });
+
+  bool Success = true;
+  json::OStream J(OS, 2);
+  J.array([&] {
+    for (unsigned I = 0, E = Batch.size(); I != E; ++I) {
+      BatchRegion &BR = Batch[I];
+      if (!BR.Error.empty()) {
+        WithColor::error() << "code region " << I << ": " << BR.Error;
+        Success = false;
+        continue;
+      }
+      BR.Report["Index"] = I;
+      BR.Report["Name"] = BR.Description;
+      J.value(std::move(BR.Report));
+    }
+  });
+  OS << '\n';
+  return Success;
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
 
@@ -318,6 +424,11 @@ int main(int argc, char **argv) {
   // Apply overrides to llvm-mca specific options.
   processViewOptions();
 
+  if (BatchMode && PrintInstructionTables) {
+    WithColor::error() << "-batch and -instruction-tables are incompatible.\n";
+    return 1;
+  }
+
   if (!MCPU.compare("native"))
     MCPU = llvm::sys::getHostCPUName();
 
@@ -427,7 +538,14 @@ int main(int argc, char **argv) {
 
   mca::PipelineOptions PO(MicroOpQueue, DecoderThroughput, DispatchWidth,
                           RegisterFileSize, LoadQueueSize, StoreQueueSize,
-                          AssumeNoAlias, EnableBottleneckAnalysis);
+                          AssumeNoAlias, EnableBottleneckAnalysis || BatchMode);
+
+  if (BatchMode) {
+    if (!runBatch(Regions, IB, *STI, *MRI, *IP, PO, TOF->os()))
+      return 1;
+    TOF->keep();
+    return 0;
+  }
 
   // Number each region in the sequence.
   unsigned RegionIdx = 0;
@@ -461,20 +579,7 @@ int main(int argc, char **argv) {
       Expected<std::unique_ptr<mca::Instruction>> Inst =
           IB.createInstruction(MCI);
       if (!Inst) {
-        if (auto NewE = handleErrors(
-                Inst.takeError(),
-                [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
-                  std::string InstructionStr;
-                  raw_string_ostream SS(InstructionStr);
-                  WithColor::error() << IE.Message << '\n';
-                  IP->printInst(&IE.Inst, SS, "", *STI);
-                  SS.flush();
-                  WithColor::note()
-                      << "instruction: " << InstructionStr << '\n';
-                })) {
-          // Default case.
-          WithColor::error() << toString(std::move(NewE));
-        }
+        reportInstructionError(Inst.takeError(), *IP, *STI);
         return 1;
       }
 
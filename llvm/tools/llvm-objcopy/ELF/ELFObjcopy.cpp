@@ -33,6 +33,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -310,22 +311,43 @@ static bool isCompressable(const SectionBase &Section) {
          StringRef(Section.Name).startswith(".debug");
 }
 
-static void replaceDebugSections(
+static Error replaceDebugSections(
     Object &Obj, SectionPred &RemovePred,
     function_ref<bool(const SectionBase &)> shouldReplace,
-    function_ref<SectionBase *(const SectionBase *)> addSection) {
+    function_ref<Expected<std::unique_ptr<SectionBase>>(const SectionBase *)>
+        createSection) {
   // Build a list of the debug sections we are going to replace.
-  // We can't call `addSection` while iterating over sections,
+  // We can't add sections while iterating over sections,
   // because it would mutate the sections array.
   SmallVector<SectionBase *, 13> ToReplace;
   for (auto &Sec : Obj.sections())
     if (shouldReplace(Sec))
       ToReplace.push_back(&Sec);
 
+  // (De)compressing the sections is the expensive part, and independent for
+  // each section, so create the new sections in parallel. The errors are
+  // reported here, in section order, once all the workers are done.
+  std::vector<std::unique_ptr<SectionBase>> Replacements(ToReplace.size());
+  std::vector<Optional<Error>> Errors(ToReplace.size());
+  parallel::for_each_n(parallel::par, size_t(0), ToReplace.size(),
+                       [&](size_t I) {
+                         auto SecOrErr = createSection(ToReplace[I]);
+                         if (SecOrErr)
+                           Replacements[I] = std::move(*SecOrErr);
+                         else
+                           Errors[I] = SecOrErr.takeError();
+                       });
+  Error Err = Error::success();
+  for (Optional<Error> &E : Errors)
+    if (E)
+      Err = joinErrors(std::move(Err), std::move(*E));
+  if (Err)
+    return Err;
+
   // Build a mapping from original section to a new one.
   DenseMap<SectionBase *, SectionBase *> FromTo;
-  for (SectionBase *S : ToReplace)
-    FromTo[S] = addSection(S);
+  for (size_t I = 0, E = ToReplace.size(); I != E; ++I)
+    FromTo[ToReplace[I]] = &Obj.addSection(std::move(Replacements[I]));
 
   // Now we want to update the target sections of relocation
   // sections. Also we will update the relocations themselves
@@ -336,6 +358,7 @@ static void replaceDebugSections(
   RemovePred = [shouldReplace, RemovePred](const SectionBase &Sec) {
     return shouldReplace(Sec) || RemovePred(Sec);
   };
+  return Error::success();
 }
 
 static bool isUnneededSymbol(const Symbol &Sym) {
@@ -566,20 +589,24 @@ static Error replaceAndRemoveSections(const CopyConfig &Config, Object &Obj) {
     };
   }
 
-  if (Config.CompressionType != DebugCompressionType::None)
-    replaceDebugSections(Obj, RemovePred, isCompressable, 
-                         [&Config, &Obj](const SectionBase *S) {
-                           return &Obj.addSection<CompressedSection>(
-                                *S, Config.CompressionType);
-                        });
-  else if (Config.DecompressDebugSections)
-    replaceDebugSections(
-        Obj, RemovePred,
-        [](const SectionBase &S) { return isa<CompressedSection>(&S); },
-        [&Obj](const SectionBase *S) {
-          auto CS = cast<CompressedSection>(S);
-          return &Obj.addSection<DecompressedSection>(*CS);
-        });
+  if (Config.CompressionType != DebugCompressionType::None) {
+    if (Error E = replaceDebugSections(
+            Obj, RemovePred, isCompressable,
+            [&Config](const SectionBase *S)
+                -> Expected<std::unique_ptr<SectionBase>> {
+              return CompressedSection::create(*S, Config.CompressionType);
+            }))
+      return E;
+  } else if (Config.DecompressDebugSections) {
+    if (Error E = replaceDebugSections(
+            Obj, RemovePred,
+            [](const SectionBase &S) { return isa<CompressedSection>(&S); },
+            [](const SectionBase *S) -> Expected<std::unique_ptr<SectionBase>> {
+              auto CS = cast<CompressedSection>(S);
+              return std::make_unique<DecompressedSection>(*CS);
+            }))
+      return E;
+  }
 
   return Obj.removeSections(Config.AllowBrokenLinks, RemovePred);
 }
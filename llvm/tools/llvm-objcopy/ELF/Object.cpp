@@ -20,6 +20,7 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <cstddef>
@@ -430,13 +431,12 @@ void ELFSectionWriter<ELFT>::visit(const DecompressedSection &Sec) {
       reinterpret_cast<const char *>(Sec.OriginalData.data()) + DataOffset,
       Sec.OriginalData.size() - DataOffset);
 
-  SmallVector<char, 128> DecompressedContent;
-  if (Error E = zlib::uncompress(CompressedContent, DecompressedContent,
-                                 static_cast<size_t>(Sec.Size)))
-    reportError(Sec.Name, std::move(E));
-
-  uint8_t *Buf = Out.getBufferStart() + Sec.Offset;
-  std::copy(DecompressedContent.begin(), DecompressedContent.end(), Buf);
+  // Decompress straight into the output, rather than through a temporary
+  // copy of the (possibly very large) section.
+  char *Buf = reinterpret_cast<char *>(Out.getBufferStart() + Sec.Offset);
+  size_t DecompressedSize = Sec.Size;
+  if (Error E = zlib::uncompress(CompressedContent, Buf, DecompressedSize))
+    addError(Sec, std::move(E));
 }
 
 void BinarySectionWriter::visit(const DecompressedSection &Sec) {
@@ -500,15 +500,30 @@ void ELFSectionWriter<ELFT>::visit(const CompressedSection &Sec) {
   std::copy(Sec.CompressedData.begin(), Sec.CompressedData.end(), Buf);
 }
 
+Expected<std::unique_ptr<CompressedSection>>
+CompressedSection::create(const SectionBase &Sec,
+                          DebugCompressionType CompressionType) {
+  Error Err = Error::success();
+  std::unique_ptr<CompressedSection> Section(
+      new CompressedSection(Sec, CompressionType, Err));
+  if (Err)
+    return createFileError(Sec.Name, std::move(Err));
+  return std::move(Section);
+}
+
 CompressedSection::CompressedSection(const SectionBase &Sec,
-                                     DebugCompressionType CompressionType)
+                                     DebugCompressionType CompressionType,
+                                     Error &Err)
     : SectionBase(Sec), CompressionType(CompressionType),
       DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align) {
+  ErrorAsOutParameter EAO(&Err);
   if (Error E = zlib::compress(
           StringRef(reinterpret_cast<const char *>(OriginalData.data()),
                     OriginalData.size()),
-          CompressedData))
-    reportError(Name, std::move(E));
+          CompressedData)) {
+    Err = std::move(E);
+    return;
+  }
 
   size_t ChdrSize;
   if (CompressionType == DebugCompressionType::GNU) {
@@ -1757,13 +1772,38 @@ template <class ELFT> void ELFWriter<ELFT>::writeShdrs() {
     writeShdr(Sec);
 }
 
-template <class ELFT> void ELFWriter<ELFT>::writeSectionData() {
-  for (SectionBase &Sec : Obj.sections())
-    // Segments are responsible for writing their contents, so only write the
-    // section data if the section is not in a segment. Note that this renders
-    // sections in segments effectively immutable.
-    if (Sec.ParentSegment == nullptr)
-      Sec.accept(*SecWriter);
+void SectionWriter::addError(const SectionBase &Sec, Error E) {
+  std::lock_guard<std::mutex> Lock(ErrorsLock);
+  Errors.emplace_back(Sec.Index, createFileError(Sec.Name, std::move(E)));
+}
+
+Error SectionWriter::takeErrors() {
+  llvm::sort(Errors, [](const std::pair<uint32_t, Error> &LHS,
+                        const std::pair<uint32_t, Error> &RHS) {
+    return LHS.first < RHS.first;
+  });
+  Error Err = Error::success();
+  for (auto &E : Errors)
+    Err = joinErrors(std::move(Err), std::move(E.second));
+  Errors.clear();
+  return Err;
+}
+
+template <class ELFT> Error ELFWriter<ELFT>::writeSectionData() {
+  // Sections occupy disjoint parts of the output and the section writer has
+  // no state of its own, so sections can be written in parallel. This mainly
+  // helps with decompressing large debug sections.
+  SectionTableRef Sections = Obj.sections();
+  parallel::for_each(parallel::par, Sections.begin(), Sections.end(),
+                     [&](SectionBase &Sec) {
+                       // Segments are responsible for writing their contents,
+                       // so only write the section data if the section is not
+                       // in a segment. Note that this renders sections in
+                       // segments effectively immutable.
+                       if (Sec.ParentSegment == nullptr)
+                         Sec.accept(*SecWriter);
+                     });
+  return SecWriter->takeErrors();
 }
 
 template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
@@ -1989,7 +2029,8 @@ template <class ELFT> Error ELFWriter<ELFT>::write() {
   writeSegmentData();
   writeEhdr();
   writePhdrs();
-  writeSectionData();
+  if (Error E = writeSectionData())
+    return E;
   if (WriteSectionHeaders)
     writeShdrs();
   return Buf.commit();
@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -107,9 +108,17 @@ class SectionWriter : public SectionVisitor {
 protected:
   Buffer &Out;
 
+  /// Record an error of writing \p Sec. Sections may be written in parallel,
+  /// so the errors are only reported once all of them are written, by
+  /// takeErrors().
+  void addError(const SectionBase &Sec, Error E);
+
 public:
   virtual ~SectionWriter() = default;
 
+  /// Return the errors recorded while writing sections, in section order.
+  Error takeErrors();
+
   void visit(const Section &Sec) override;
   void visit(const OwnedDataSection &Sec) override;
   void visit(const StringTableSection &Sec) override;
@@ -123,6 +132,10 @@ public:
   virtual void visit(const DecompressedSection &Sec) override = 0;
 
   explicit SectionWriter(Buffer &Buf) : Out(Buf) {}
+
+private:
+  std::mutex ErrorsLock;
+  std::vector<std::pair<uint32_t, Error>> Errors;
 };
 
 template <class ELFT> class ELFSectionWriter : public SectionWriter {
@@ -329,7 +342,7 @@ private:
 
   void writePhdrs();
   void writeShdrs();
-  void writeSectionData();
+  Error writeSectionData();
   void writeSegmentData();
 
   void assignOffsets();
@@ -517,9 +530,15 @@ class CompressedSection : public SectionBase {
   uint64_t DecompressedAlign;
   SmallVector<char, 128> CompressedData;
 
-public:
   CompressedSection(const SectionBase &Sec,
-                    DebugCompressionType CompressionType);
+                    DebugCompressionType CompressionType, Error &Err);
+
+public:
+  /// Compress the contents of \p Sec. This doesn't change any shared state, so
+  /// sections can be compressed in parallel.
+  static Expected<std::unique_ptr<CompressedSection>>
+  create(const SectionBase &Sec, DebugCompressionType CompressionType);
+
   CompressedSection(ArrayRef<uint8_t> CompressedData, uint64_t DecompressedSize,
                     uint64_t DecompressedAlign);
 
@@ -1043,6 +1062,11 @@ public:
   Error removeSymbols(function_ref<bool(const Symbol &)> ToRemove);
   template <class T, class... Ts> T &addSection(Ts &&... Args) {
     auto Sec = std::make_unique<T>(std::forward<Ts>(Args)...);
+    auto Ptr = Sec.get();
+    addSection(std::move(Sec));
+    return *Ptr;
+  }
+  SectionBase &addSection(std::unique_ptr<SectionBase> Sec) {
     auto Ptr = Sec.get();
     MustBeRelocatable |= isa<RelocationSection>(*Ptr);
     Sections.emplace_back(std::move(Sec));
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -226,6 +227,27 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
+/// Add the record \p I of \p Input to the writer of \p WC, and report the
+/// problems merging it as warnings. The caller holds the lock of \p WC.
+static void addInputRecord(WriterContext *WC, const WeightedFile &Input,
+                           NamedInstrProfRecord &&I) {
+  const StringRef FuncName = I.Name;
+  bool Reported = false;
+  WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
+    if (Reported) {
+      consumeError(std::move(E));
+      return;
+    }
+    Reported = true;
+    // Only show hint the first time an error occurs.
+    instrprof_error IPE = InstrProfError::take(std::move(E));
+    std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
+    bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
+    handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
+                           FuncName, firstTime);
+  });
+}
+
 /// Load an input into a writer context.
 static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
                       WriterContext *WC) {
@@ -262,21 +284,7 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   for (auto &I : *Reader) {
     if (Remapper)
       I.Name = (*Remapper)(I.Name);
-    const StringRef FuncName = I.Name;
-    bool Reported = false;
-    WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
-      if (Reported) {
-        consumeError(std::move(E));
-        return;
-      }
-      Reported = true;
-      // Only show hint the first time an error occurs.
-      instrprof_error IPE = InstrProfError::take(std::move(E));
-      std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
-      bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
-      handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
-                             FuncName, firstTime);
-    });
+    addInputRecord(WC, Input, std::move(I));
   }
   if (Reader->hasError()) {
     if (Error E = Reader->getError()) {
@@ -287,22 +295,93 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   }
 }
 
-/// Merge the \p Src writer context into \p Dst.
-static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
-  // If we've already seen a hard error, continuing with the merge would
-  // clobber it.
-  if (Dst->Err || Src->Err)
+/// Record the hard error \p E of \p Input in \p WC, unless there is one
+/// pending already.
+static void setInputError(WriterContext *WC, const WeightedFile &Input,
+                          Error E) {
+  std::lock_guard<std::mutex> CtxGuard{WC->Lock};
+  if (WC->Err) {
+    consumeError(std::move(E));
     return;
+  }
+  WC->Err = std::move(E);
+  WC->ErrWhence = Input.Filename;
+}
 
-  bool Reported = false;
-  Dst->Writer.mergeRecordsFromWriter(std::move(Src->Writer), [&](Error E) {
-    if (Reported) {
-      consumeError(std::move(E));
+/// Load an input into the writer contexts in \p Shards, which each get the
+/// records of the functions whose name hashes to them. Errors about the input
+/// as a whole are kept by the first shard.
+static void loadInputSharded(const WeightedFile &Input,
+                             SymbolRemapper *Remapper,
+                             ArrayRef<std::unique_ptr<WriterContext>> Shards) {
+  WriterContext *ErrWC = Shards[0].get();
+  {
+    // If there's a pending hard error, don't do more work.
+    std::lock_guard<std::mutex> CtxGuard{ErrWC->Lock};
+    if (ErrWC->Err)
       return;
+  }
+
+  auto ReaderOrErr = InstrProfReader::create(Input.Filename);
+  if (Error E = ReaderOrErr.takeError()) {
+    // Skip the empty profiles by returning sliently.
+    instrprof_error IPE = InstrProfError::take(std::move(E));
+    if (IPE != instrprof_error::empty_raw_profile)
+      setInputError(ErrWC, Input, make_error<InstrProfError>(IPE));
+    return;
+  }
+
+  auto Reader = std::move(ReaderOrErr.get());
+  bool IsIRProfile = Reader->isIRLevelProfile();
+  bool HasCSIRProfile = Reader->hasCSIRLevelProfile();
+  bool Mismatch = false;
+  for (const std::unique_ptr<WriterContext> &WC : Shards) {
+    std::lock_guard<std::mutex> CtxGuard{WC->Lock};
+    if (Error E = WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile)) {
+      consumeError(std::move(E));
+      Mismatch = true;
     }
-    Reported = true;
-    Dst->Err = std::move(E);
-  });
+  }
+  if (Mismatch) {
+    setInputError(
+        ErrWC, Input,
+        make_error<StringError>(
+            "Merge IR generated profile with Clang generated profile.",
+            std::error_code()));
+    return;
+  }
+
+  // Hand the records over to the shards in batches, to take their locks once
+  // per batch rather than once per record. The names of the records point
+  // into the reader, so all batches are flushed before it goes away.
+  const size_t BatchSize = 256;
+  std::vector<std::vector<NamedInstrProfRecord>> Batches(Shards.size());
+  auto Flush = [&](size_t Shard) {
+    WriterContext *WC = Shards[Shard].get();
+    std::lock_guard<std::mutex> CtxGuard{WC->Lock};
+    for (NamedInstrProfRecord &I : Batches[Shard])
+      addInputRecord(WC, Input, std::move(I));
+    Batches[Shard].clear();
+  };
+  for (auto &I : *Reader) {
+    if (Remapper)
+      I.Name = (*Remapper)(I.Name);
+    size_t Shard = hash_value(I.Name) % Shards.size();
+    Batches[Shard].push_back(std::move(I));
+    if (Batches[Shard].size() == BatchSize)
+      Flush(Shard);
+  }
+  for (size_t Shard = 0, E = Shards.size(); Shard != E; ++Shard)
+    if (!Batches[Shard].empty())
+      Flush(Shard);
+
+  if (Reader->hasError()) {
+    if (Error E = Reader->getError()) {
+      instrprof_error IPE = InstrProfError::take(std::move(E));
+      if (isFatalError(IPE))
+        setInputError(ErrWC, Input, make_error<InstrProfError>(IPE));
+    }
+  }
 }
 
 static void mergeInstrProfile(const WeightedFileVector &Inputs,
@@ -337,31 +416,20 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   } else {
     ThreadPool Pool(NumThreads);
 
-    // Load the inputs in parallel (N/NumThreads serial steps).
-    unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
-      Pool.async(loadInput, Input, Remapper, Contexts[Ctx].get());
-      Ctx = (Ctx + 1) % NumThreads;
-    }
+    // Load the inputs in parallel, sharding the records by function name.
+    // Every function is merged by exactly one context, so the merged profile
+    // is held once rather than once per context.
+    for (const auto &Input : Inputs)
+      Pool.async(loadInputSharded, Input, Remapper,
+                 ArrayRef<std::unique_ptr<WriterContext>>(Contexts));
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
-      }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    // The shards hold disjoint sets of functions, so gathering them into the
+    // first one only moves the records.
+    for (unsigned I = 1; I < NumThreads; ++I)
+      Contexts[0]->Writer.mergeRecordsFromWriter(
+          std::move(Contexts[I]->Writer),
+          [](Error E) { consumeError(std::move(E)); });
   }
 
   // Handle deferred hard errors encountered during merging.
@@ -428,45 +496,120 @@ static sampleprof::SampleProfileFormat FormatMap[] = {
     sampleprof::SPF_None, sampleprof::SPF_Text, sampleprof::SPF_Compact_Binary,
     sampleprof::SPF_GCC, sampleprof::SPF_Binary};
 
+/// A part of a merged sample profile, with the functions whose name hashes
+/// to it.
+struct SampleProfileShard {
+  std::mutex Lock;
+  StringMap<sampleprof::FunctionSamples> Profiles;
+};
+
+/// Merge the profiles read by \p Reader from \p Input into \p Shards.
+static void
+mergeSampleInput(sampleprof::SampleProfileReader &Reader,
+                 const WeightedFile &Input, SymbolRemapper *Remapper,
+                 ArrayRef<std::unique_ptr<SampleProfileShard>> Shards,
+                 std::mutex &ErrLock) {
+  using namespace sampleprof;
+  StringMap<FunctionSamples> &Profiles = Reader.getProfiles();
+  for (StringMap<FunctionSamples>::iterator I = Profiles.begin(),
+                                            E = Profiles.end();
+       I != E; ++I) {
+    sampleprof_error Result = sampleprof_error::success;
+    FunctionSamples Remapped =
+        Remapper ? remapSamples(I->second, *Remapper, Result)
+                 : FunctionSamples();
+    FunctionSamples &Samples = Remapper ? Remapped : I->second;
+    StringRef FName = Samples.getName();
+    SampleProfileShard &Shard = *Shards[hash_value(FName) % Shards.size()];
+    {
+      std::lock_guard<std::mutex> ShardGuard{Shard.Lock};
+      MergeResult(Result, Shard.Profiles[FName].merge(Samples, Input.Weight));
+    }
+    if (Result != sampleprof_error::success) {
+      std::error_code EC = make_error_code(Result);
+      std::lock_guard<std::mutex> ErrGuard{ErrLock};
+      handleMergeWriterError(errorCodeToError(EC), Input.Filename, FName);
+    }
+  }
+}
+
 static void mergeSampleProfile(const WeightedFileVector &Inputs,
                                SymbolRemapper *Remapper,
                                StringRef OutputFilename,
-                               ProfileFormat OutputFormat) {
+                               ProfileFormat OutputFormat,
+                               unsigned NumThreads) {
   using namespace sampleprof;
-  StringMap<FunctionSamples> ProfileMap;
-  SmallVector<std::unique_ptr<sampleprof::SampleProfileReader>, 5> Readers;
+  // If NumThreads is not specified, auto-detect a good default.
+  if (NumThreads == 0)
+    NumThreads =
+        std::min(hardware_concurrency(), unsigned((Inputs.size() + 1) / 2));
+
+  // We need to keep the readers around until after all the files are read so
+  // that we do not lose the function names stored in each reader's memory.
+  // The function names are needed to write out the merged profile map.
+  std::vector<std::unique_ptr<SampleProfileReader>> Readers(Inputs.size());
+  std::vector<std::error_code> ReadErrors(Inputs.size());
+  SmallVector<std::unique_ptr<SampleProfileShard>, 4> Shards;
+  for (unsigned I = 0; I < NumThreads; ++I)
+    Shards.push_back(std::make_unique<SampleProfileShard>());
+  std::mutex ErrLock;
+  // The readers only use the context to report malformed profiles, which
+  // does not change it.
   LLVMContext Context;
-  for (const auto &Input : Inputs) {
-    auto ReaderOrErr = SampleProfileReader::create(Input.Filename, Context);
-    if (std::error_code EC = ReaderOrErr.getError())
-      exitWithErrorCode(EC, Input.Filename);
-
-    // We need to keep the readers around until after all the files are
-    // read so that we do not lose the function names stored in each
-    // reader's memory. The function names are needed to write out the
-    // merged profile map.
-    Readers.push_back(std::move(ReaderOrErr.get()));
-    const auto Reader = Readers.back().get();
-    if (std::error_code EC = Reader->read())
-      exitWithErrorCode(EC, Input.Filename);
-
-    StringMap<FunctionSamples> &Profiles = Reader->getProfiles();
-    for (StringMap<FunctionSamples>::iterator I = Profiles.begin(),
-                                              E = Profiles.end();
-         I != E; ++I) {
-      sampleprof_error Result = sampleprof_error::success;
-      FunctionSamples Remapped =
-          Remapper ? remapSamples(I->second, *Remapper, Result)
-                   : FunctionSamples();
-      FunctionSamples &Samples = Remapper ? Remapped : I->second;
-      StringRef FName = Samples.getName();
-      MergeResult(Result, ProfileMap[FName].merge(Samples, Input.Weight));
-      if (Result != sampleprof_error::success) {
-        std::error_code EC = make_error_code(Result);
-        handleMergeWriterError(errorCodeToError(EC), Input.Filename, FName);
-      }
+
+  // Creating a reader sets FunctionSamples::Format, which reading and merging
+  // its profiles rely on. So the readers are created serially, before any
+  // input is read.
+  for (size_t I = 0, E = Inputs.size(); I != E; ++I) {
+    auto ReaderOrErr = SampleProfileReader::create(Inputs[I].Filename, Context);
+    if (std::error_code EC = ReaderOrErr.getError()) {
+      ReadErrors[I] = EC;
+      break;
     }
+    Readers[I] = std::move(ReaderOrErr.get());
   }
+
+  auto ReadAndMerge = [&](size_t I) {
+    if (std::error_code EC = Readers[I]->read()) {
+      ReadErrors[I] = EC;
+      return;
+    }
+    mergeSampleInput(*Readers[I], Inputs[I], Remapper, Shards, ErrLock);
+  };
+  // Only inputs of a single format are read in parallel, as then the global
+  // format is already right for all of them. Otherwise, set it for each input
+  // in turn, as if it had just been created.
+  bool SameFormat = llvm::all_of(Readers, [&](const auto &Reader) {
+    return !Reader || Reader->getFormat() == Readers[0]->getFormat();
+  });
+  if (SameFormat && NumThreads > 1) {
+    ThreadPool Pool(NumThreads);
+    for (size_t I = 0, E = Inputs.size(); I != E && Readers[I]; ++I)
+      Pool.async(ReadAndMerge, I);
+    Pool.wait();
+  } else {
+    for (size_t I = 0, E = Inputs.size(); I != E && Readers[I]; ++I) {
+      FunctionSamples::Format = Readers[I]->getFormat();
+      ReadAndMerge(I);
+    }
+  }
+  for (size_t I = 0, E = Inputs.size(); I != E; ++I)
+    if (ReadErrors[I])
+      exitWithErrorCode(ReadErrors[I], Inputs[I].Filename);
+
+  // The shards hold disjoint sets of functions. Gather them in name order, so
+  // that the merged profile doesn't depend on how the names were sharded.
+  std::vector<std::pair<StringRef, FunctionSamples *>> Merged;
+  for (std::unique_ptr<SampleProfileShard> &Shard : Shards)
+    for (auto &I : Shard->Profiles)
+      Merged.emplace_back(I.getKey(), &I.getValue());
+  llvm::sort(Merged, less_first());
+  StringMap<FunctionSamples> ProfileMap;
+  for (const auto &I : Merged)
+    ProfileMap.try_emplace(I.first, std::move(*I.second));
+  Merged.clear();
+  Shards.clear();
+
   auto WriterOrErr =
       SampleProfileWriter::create(OutputFilename, FormatMap[OutputFormat]);
   if (std::error_code EC = WriterOrErr.getError())
@@ -629,7 +772,7 @@ static int merge_main(int argc, const char *argv[]) {
                       OutputFormat, OutputSparse, NumThreads);
   else
     mergeSampleProfile(WeightedInputs, Remapper.get(), OutputFilename,
-                       OutputFormat);
+                       OutputFormat, NumThreads);
 
   return 0;
 }
@@ -14,6 +14,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/DebugInfo/Symbolize/DIPrinter.h"
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
@@ -23,6 +24,8 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdio>
 #include <cstring>
@@ -150,6 +153,31 @@ static cl::opt<std::string>
     ClFallbackDebugPath("fallback-debug-path", cl::init(""),
                         cl::desc("Fallback path for debug binaries."));
 
+static cl::list<std::string>
+    ClDebugFileDirectory("debug-file-directory", cl::ZeroOrMore,
+                         cl::value_desc("dir"),
+                         cl::desc("Path to directory where to look for debug "
+                                  "files by build ID, e.g. /usr/lib/debug"));
+
+static cl::opt<std::string>
+    ClIndexDir("index-dir", cl::init(""), cl::value_desc("dir"),
+               cl::desc("Directory of precomputed symbolizer indexes, which "
+                        "are used instead of the DWARF of binaries with a "
+                        "build ID or UUID. Missing indexes are built"));
+
+static cl::opt<uint64_t>
+    ClCacheSize("cache-size", cl::init(0), cl::value_desc("bytes"),
+                cl::desc("Maximum total size of the binaries kept open "
+                         "between inputs (0 = no limit)"));
+
+static cl::opt<unsigned>
+    ClNumThreads("num-threads", cl::init(1), cl::value_desc("N"),
+                 cl::desc("Number of threads to symbolize batches of inputs "
+                          "with (0 = one per hardware thread). Inputs read "
+                          "from stdin are batched until an empty line"));
+static cl::alias ClNumThreadsShort("j", cl::desc("Alias for -num-threads"),
+                                   cl::NotHidden, cl::aliasopt(ClNumThreads));
+
 static cl::opt<DIPrinter::OutputStyle>
     ClOutputStyle("output-style", cl::init(DIPrinter::OutputStyle::LLVM),
                   cl::desc("Specify print style"),
@@ -162,10 +190,10 @@ static cl::extrahelp
     HelpResponse("\nPass @FILE as argument to read options from FILE.\n");
 
 template<typename T>
-static bool error(Expected<T> &ResOrErr) {
+static bool error(Expected<T> &ResOrErr, raw_ostream &ErrOS) {
   if (ResOrErr)
     return false;
-  logAllUnhandledErrors(ResOrErr.takeError(), errs(),
+  logAllUnhandledErrors(ResOrErr.takeError(), ErrOS,
                         "LLVMSymbolizer: error reading file: ");
   return true;
 }
@@ -216,40 +244,67 @@ static bool parseCommand(StringRef InputString, Command &Cmd,
   return !StringRef(pos, offset_length).getAsInteger(0, ModuleOffset);
 }
 
+// Resolve a module given as BUILDID:<hex> to the debug file with that build
+// ID. Other module names are paths and are left alone.
+static bool resolveBuildID(std::string &ModuleName,
+                           const LLVMSymbolizer &Symbolizer,
+                           raw_ostream &ErrOS) {
+  StringRef BuildIDStr = ModuleName;
+  if (!BuildIDStr.consume_front("BUILDID:"))
+    return true;
+  std::string Path;
+  if (all_of(BuildIDStr, isHexDigit))
+    Path = Symbolizer.lookUpBuildIDPath(
+        arrayRefFromStringRef(fromHex(BuildIDStr)));
+  if (Path.empty()) {
+    ErrOS << "LLVMSymbolizer: error reading file: could not find build ID '"
+          << BuildIDStr << "'\n";
+    return false;
+  }
+  ModuleName = Path;
+  return true;
+}
+
 static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
-                           DIPrinter &Printer) {
+                           raw_ostream &OS, raw_ostream &ErrOS) {
   Command Cmd;
   std::string ModuleName;
   uint64_t Offset = 0;
   if (!parseCommand(StringRef(InputString), Cmd, ModuleName, Offset)) {
-    outs() << InputString;
+    OS << InputString;
     return;
   }
 
+  DIPrinter Printer(OS, ClPrintFunctions != FunctionNameKind::None,
+                    ClPrettyPrint, ClPrintSourceContextLines, ClVerbose,
+                    ClBasenames, ClOutputStyle);
   if (ClPrintAddress) {
-    outs() << "0x";
-    outs().write_hex(Offset);
+    OS << "0x";
+    OS.write_hex(Offset);
     StringRef Delimiter = ClPrettyPrint ? ": " : "\n";
-    outs() << Delimiter;
+    OS << Delimiter;
   }
+  bool Resolved = resolveBuildID(ModuleName, Symbolizer, ErrOS);
   Offset -= ClAdjustVMA;
   if (Cmd == Command::Data) {
     auto ResOrErr = Symbolizer.symbolizeData(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DIGlobal() : ResOrErr.get());
+    Printer << (!Resolved || error(ResOrErr, ErrOS) ? DIGlobal()
+                                                    : ResOrErr.get());
   } else if (Cmd == Command::Frame) {
     auto ResOrErr = Symbolizer.symbolizeFrame(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    if (!error(ResOrErr)) {
+    if (Resolved && !error(ResOrErr, ErrOS)) {
       for (DILocal Local : *ResOrErr)
         Printer << Local;
       if (ResOrErr->empty())
-        outs() << "??\n";
+        OS << "??\n";
     }
   } else if (ClPrintInlining) {
     auto ResOrErr = Symbolizer.symbolizeInlinedCode(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DIInliningInfo() : ResOrErr.get());
+    Printer << (!Resolved || error(ResOrErr, ErrOS) ? DIInliningInfo()
+                                                    : ResOrErr.get());
   } else if (ClOutputStyle == DIPrinter::OutputStyle::GNU) {
     // With ClPrintFunctions == FunctionNameKind::LinkageName (default)
     // and ClUseSymbolTable == true (also default), Symbolizer.symbolizeCode()
@@ -259,14 +314,36 @@ static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
     // the topmost function, which suits our needs better.
     auto ResOrErr = Symbolizer.symbolizeInlinedCode(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get().getFrame(0));
+    Printer << (!Resolved || error(ResOrErr, ErrOS)
+                    ? DILineInfo()
+                    : ResOrErr.get().getFrame(0));
   } else {
     auto ResOrErr = Symbolizer.symbolizeCode(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get());
+    Printer << (!Resolved || error(ResOrErr, ErrOS) ? DILineInfo()
+                                                    : ResOrErr.get());
   }
   if (ClOutputStyle == DIPrinter::OutputStyle::LLVM)
-    outs() << "\n";
+    OS << "\n";
+}
+
+// Symbolize a batch of inputs over the thread pool. The results are printed
+// in input order once the whole batch is done, then the cache is pruned.
+static void symbolizeBatch(ArrayRef<std::string> Batch,
+                           LLVMSymbolizer &Symbolizer, ThreadPool &Pool) {
+  std::vector<std::string> Outputs(Batch.size()), Errors(Batch.size());
+  for (size_t I = 0, E = Batch.size(); I != E; ++I)
+    Pool.async([&, I]() {
+      raw_string_ostream OS(Outputs[I]), ErrOS(Errors[I]);
+      symbolizeInput(Batch[I], Symbolizer, OS, ErrOS);
+    });
+  Pool.wait();
+  for (size_t I = 0, E = Batch.size(); I != E; ++I) {
+    errs() << Errors[I];
+    outs() << Outputs[I];
+  }
+  outs().flush();
+  Symbolizer.pruneCache();
 }
 
 int main(int argc, char **argv) {
@@ -299,6 +376,12 @@ int main(int argc, char **argv) {
   Opts.DefaultArch = ClDefaultArch;
   Opts.FallbackDebugPath = ClFallbackDebugPath;
   Opts.DWPName = ClDwpName;
+  Opts.DebugFileDirectory = ClDebugFileDirectory;
+  Opts.MaxCacheSize = ClCacheSize;
+  Opts.IndexDirectory = ClIndexDir;
+  unsigned NumThreads =
+      ClNumThreads ? ClNumThreads.getValue() : llvm::hardware_concurrency();
+  Opts.ThreadSafe = NumThreads > 1;
 
   for (const auto &hint : ClDsymHint) {
     if (sys::path::extension(hint) == ".dSYM") {
@@ -310,21 +393,43 @@ int main(int argc, char **argv) {
   }
   LLVMSymbolizer Symbolizer(Opts);
 
-  DIPrinter Printer(outs(), ClPrintFunctions != FunctionNameKind::None,
-                    ClPrettyPrint, ClPrintSourceContextLines, ClVerbose,
-                    ClBasenames, ClOutputStyle);
-
-  if (ClInputAddresses.empty()) {
+  if (NumThreads > 1) {
+    ThreadPool Pool(NumThreads);
+    if (ClInputAddresses.empty()) {
+      const int kMaxInputStringLength = 1024;
+      const size_t kMaxBatchSize = 4096;
+      char InputString[kMaxInputStringLength];
+      std::vector<std::string> Batch;
+
+      while (fgets(InputString, sizeof(InputString), stdin)) {
+        Batch.push_back(InputString);
+        // An empty line ends the batch early, so that a client can wait for
+        // the results of what it sent so far. It is echoed like any
+        // unparsable input.
+        if (StringRef(InputString).trim().empty() ||
+            Batch.size() == kMaxBatchSize) {
+          symbolizeBatch(Batch, Symbolizer, Pool);
+          Batch.clear();
+        }
+      }
+      symbolizeBatch(Batch, Symbolizer, Pool);
+    } else {
+      symbolizeBatch(ClInputAddresses, Symbolizer, Pool);
+    }
+  } else if (ClInputAddresses.empty()) {
     const int kMaxInputStringLength = 1024;
     char InputString[kMaxInputStringLength];
 
     while (fgets(InputString, sizeof(InputString), stdin)) {
-      symbolizeInput(InputString, Symbolizer, Printer);
+      symbolizeInput(InputString, Symbolizer, outs(), errs());
       outs().flush();
+      Symbolizer.pruneCache();
     }
   } else {
-    for (StringRef Address : ClInputAddresses)
-      symbolizeInput(Address, Symbolizer, Printer);
+    for (StringRef Address : ClInputAddresses) {
+      symbolizeInput(Address, Symbolizer, outs(), errs());
+      Symbolizer.pruneCache();
+    }
   }
 
   return 0;
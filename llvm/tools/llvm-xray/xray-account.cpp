@@ -431,48 +431,59 @@ static CommandRegistration Unused(&Account, []() -> Error {
   llvm::xray::FuncIdConversionHelper FuncIdHelper(AccountInstrMap, Symbolizer,
                                                   FunctionAddresses);
   xray::LatencyAccountant FCA(FuncIdHelper, AccountDeduceSiblingCalls);
-  auto TraceOrErr = loadTraceFile(AccountInput);
-  if (!TraceOrErr)
+  // The accountant keeps per-thread state, so the trace is fed to it one
+  // thread at a time instead of being loaded whole.
+  XRayFileHeader Header{};
+  bool AccountingFailed = false;
+  auto AccountRecords = [&](const XRayFileHeader &FH,
+                            ArrayRef<XRayRecord> Records) -> Error {
+    Header = FH;
+    for (const auto &Record : Records) {
+      if (FCA.accountRecord(Record))
+        continue;
+      errs()
+          << "Error processing record: "
+          << llvm::formatv(
+                 R"({{type: {0}; cpu: {1}; record-type: {2}; function-id: {3}; tsc: {4}; thread-id: {5}; process-id: {6}}})",
+                 Record.RecordType, Record.CPU, Record.Type, Record.FuncId,
+                 Record.TSC, Record.TId, Record.PId)
+          << '\n';
+      for (const auto &ThreadStack : FCA.getPerThreadFunctionStack()) {
+        errs() << "Thread ID: " << ThreadStack.first << "\n";
+        if (ThreadStack.second.empty()) {
+          errs() << "  (empty stack)\n";
+          continue;
+        }
+        auto Level = ThreadStack.second.size();
+        for (const auto &Entry : llvm::reverse(ThreadStack.second))
+          errs() << "  #" << Level-- << "\t"
+                 << FuncIdHelper.SymbolOrNumber(Entry.first) << '\n';
+      }
+      if (!AccountKeepGoing) {
+        AccountingFailed = true;
+        return make_error<StringError>(
+            Twine("Failed accounting function calls in file '") +
+                AccountInput + "'.",
+            std::make_error_code(std::errc::executable_format_error));
+      }
+    }
+    return Error::success();
+  };
+  if (auto E = loadTraceFileByThread(AccountInput, AccountRecords)) {
+    if (AccountingFailed)
+      return E;
     return joinErrors(
         make_error<StringError>(
             Twine("Failed loading input file '") + AccountInput + "'",
             std::make_error_code(std::errc::executable_format_error)),
-        TraceOrErr.takeError());
-
-  auto &T = *TraceOrErr;
-  for (const auto &Record : T) {
-    if (FCA.accountRecord(Record))
-      continue;
-    errs()
-        << "Error processing record: "
-        << llvm::formatv(
-               R"({{type: {0}; cpu: {1}; record-type: {2}; function-id: {3}; tsc: {4}; thread-id: {5}; process-id: {6}}})",
-               Record.RecordType, Record.CPU, Record.Type, Record.FuncId,
-               Record.TSC, Record.TId, Record.PId)
-        << '\n';
-    for (const auto &ThreadStack : FCA.getPerThreadFunctionStack()) {
-      errs() << "Thread ID: " << ThreadStack.first << "\n";
-      if (ThreadStack.second.empty()) {
-        errs() << "  (empty stack)\n";
-        continue;
-      }
-      auto Level = ThreadStack.second.size();
-      for (const auto &Entry : llvm::reverse(ThreadStack.second))
-        errs() << "  #" << Level-- << "\t"
-               << FuncIdHelper.SymbolOrNumber(Entry.first) << '\n';
-    }
-    if (!AccountKeepGoing)
-      return make_error<StringError>(
-          Twine("Failed accounting function calls in file '") + AccountInput +
-              "'.",
-          std::make_error_code(std::errc::executable_format_error));
+        std::move(E));
   }
   switch (AccountOutputFormat) {
   case AccountOutputFormats::TEXT:
-    FCA.exportStatsAsText(OS, T.getFileHeader());
+    FCA.exportStatsAsText(OS, Header);
     break;
   case AccountOutputFormats::CSV:
-    FCA.exportStatsAsCSV(OS, T.getFileHeader());
+    FCA.exportStatsAsCSV(OS, Header);
     break;
   }
 
@@ -77,6 +77,13 @@ static cl::opt<bool> ConvertSortInput(
 static cl::alias ConvertSortInput2("s", cl::aliasopt(ConvertSortInput),
                                    cl::desc("Alias for -sort"),
                                    cl::sub(Convert));
+static cl::opt<bool> ConvertStream(
+    "stream",
+    cl::desc("convert the trace one thread at a time, sorting the records of "
+             "each thread rather than the whole trace, to bound the memory "
+             "used on large FDR mode traces; only with "
+             "-output-format=trace_event"),
+    cl::sub(Convert), cl::init(false));
 
 using llvm::yaml::Output;
 
@@ -265,22 +272,38 @@ void writeTraceViewerRecord(uint16_t Version, raw_ostream &OS, int32_t FuncId,
   }
 }
 
-} // namespace
-
-void TraceConverter::exportAsChromeTraceEventFormat(const Trace &Records,
-                                                    raw_ostream &OS) {
-  const auto &FH = Records.getFileHeader();
-  auto Version = FH.Version;
-  auto CycleFreq = FH.CycleFrequency;
+// Writes records in Chrome's trace event format as they come, keeping the
+// stack tries of all the threads to emit the stack frames at the end.
+class ChromeTraceEventWriter {
+  raw_ostream &OS;
+  const FuncIdConversionHelper &FuncIdHelper;
+  bool Symbolize;
 
   unsigned id_counter = 0;
-
-  OS << "{\n  \"traceEvents\": [";
   DenseMap<uint32_t, StackTrieNode *> StackCursorByThreadId{};
   DenseMap<uint32_t, SmallVector<StackTrieNode *, 4>> StackRootsByThreadId{};
   DenseMap<unsigned, StackTrieNode *> StacksByStackId{};
   std::forward_list<StackTrieNode> NodeStore{};
   int loop_count = 0;
+
+public:
+  ChromeTraceEventWriter(raw_ostream &OS,
+                         const FuncIdConversionHelper &FuncIdHelper,
+                         bool Symbolize)
+      : OS(OS), FuncIdHelper(FuncIdHelper), Symbolize(Symbolize) {
+    OS << "{\n  \"traceEvents\": [";
+  }
+
+  void writeRecords(const XRayFileHeader &FH, ArrayRef<XRayRecord> Records);
+  void finish();
+};
+
+} // namespace
+
+void ChromeTraceEventWriter::writeRecords(const XRayFileHeader &FH,
+                                          ArrayRef<XRayRecord> Records) {
+  auto Version = FH.Version;
+  auto CycleFreq = FH.CycleFrequency;
   for (const auto &R : Records) {
     if (loop_count++ == 0)
       OS << "\n";
@@ -335,6 +358,9 @@ void TraceConverter::exportAsChromeTraceEventFormat(const Trace &Records,
       break;
     }
   }
+}
+
+void ChromeTraceEventWriter::finish() {
   OS << "\n  ],\n"; // Close the Trace Events array.
   OS << "  "
      << "\"displayTimeUnit\": \"ns\",\n";
@@ -362,6 +388,30 @@ void TraceConverter::exportAsChromeTraceEventFormat(const Trace &Records,
   OS << "}\n";     // Close the JSON entry.
 }
 
+void TraceConverter::exportAsChromeTraceEventFormat(const Trace &Records,
+                                                    raw_ostream &OS) {
+  ChromeTraceEventWriter Writer(OS, FuncIdHelper, Symbolize);
+  if (!Records.empty())
+    Writer.writeRecords(Records.getFileHeader(),
+                        makeArrayRef(&*Records.begin(), Records.size()));
+  Writer.finish();
+}
+
+Error TraceConverter::streamAsChromeTraceEventFormat(StringRef Filename,
+                                                     bool Sort,
+                                                     raw_ostream &OS) {
+  ChromeTraceEventWriter Writer(OS, FuncIdHelper, Symbolize);
+  auto Err = loadTraceFileByThread(
+      Filename,
+      [&](const XRayFileHeader &FH, ArrayRef<XRayRecord> Records) {
+        Writer.writeRecords(FH, Records);
+        return Error::success();
+      },
+      Sort);
+  Writer.finish();
+  return Err;
+}
+
 namespace llvm {
 namespace xray {
 
@@ -393,6 +443,21 @@ static CommandRegistration Unused(&Convert, []() -> Error {
     return make_error<StringError>(
         Twine("Cannot open file '") + ConvertOutput + "' for writing.", EC);
 
+  if (ConvertStream) {
+    if (ConvertOutputFormat != ConvertFormats::CHROME_TRACE_EVENT)
+      return make_error<StringError>(
+          "-stream is only supported with -output-format=trace_event",
+          std::make_error_code(std::errc::invalid_argument));
+    if (auto E = TC.streamAsChromeTraceEventFormat(ConvertInput,
+                                                   ConvertSortInput, OS))
+      return joinErrors(
+          make_error<StringError>(
+              Twine("Failed loading input file '") + ConvertInput + "'.",
+              std::make_error_code(std::errc::executable_format_error)),
+          std::move(E));
+    return Error::success();
+  }
+
   auto TraceOrErr = loadTraceFile(ConvertInput, ConvertSortInput);
   if (!TraceOrErr)
     return joinErrors(
@@ -35,6 +35,12 @@ public:
   /// to be in sorted TSC order. The trace event format encodes stack traces, so
   /// the linear history is essential for correct output.
   void exportAsChromeTraceEventFormat(const Trace &Records, raw_ostream &OS);
+
+  /// Same as above, but loads the trace from \p Filename and writes it out
+  /// one thread at a time, without holding all the records in memory. With
+  /// \p Sort, the records of each thread are sorted by TSC.
+  Error streamAsChromeTraceEventFormat(StringRef Filename, bool Sort,
+                                       raw_ostream &OS);
 };
 
 } // namespace xray
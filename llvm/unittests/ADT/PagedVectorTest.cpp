@@ -0,0 +1,80 @@
+//===- llvm/unittest/ADT/PagedVectorTest.cpp ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/PagedVector.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+TEST(PagedVectorTest, EmptyVector) {
+  PagedVector<int, 10> V;
+  EXPECT_TRUE(V.empty());
+  EXPECT_EQ(0U, V.size());
+  EXPECT_EQ(0U, V.capacity());
+  EXPECT_TRUE(V.materialized_begin() == V.materialized_end());
+}
+
+TEST(PagedVectorTest, ResizeDoesNotAllocate) {
+  PagedVector<int, 10> V;
+  V.resize(25);
+  EXPECT_EQ(25U, V.size());
+  EXPECT_EQ(30U, V.capacity());
+  EXPECT_TRUE(V.materialized_begin() == V.materialized_end());
+}
+
+TEST(PagedVectorTest, AccessAllocatesPage) {
+  PagedVector<int, 10> V;
+  V.resize(25);
+  EXPECT_EQ(0, V[12]);
+  V[12] = 42;
+  EXPECT_EQ(42, V[12]);
+
+  // Only the second page is allocated.
+  std::vector<size_t> Indices;
+  for (auto I = V.materialized_begin(), E = V.materialized_end(); I != E; ++I)
+    Indices.push_back(I.getIndex());
+  ASSERT_EQ(10U, Indices.size());
+  EXPECT_EQ(10U, Indices.front());
+  EXPECT_EQ(19U, Indices.back());
+
+  // The last page is partially used.
+  V[24] = 7;
+  unsigned NumMaterialized = 0;
+  int Sum = 0;
+  for (int Element : V.materialized()) {
+    ++NumMaterialized;
+    Sum += Element;
+  }
+  EXPECT_EQ(15U, NumMaterialized);
+  EXPECT_EQ(49, Sum);
+}
+
+TEST(PagedVectorTest, ShrinkResetsElements) {
+  PagedVector<int, 10> V;
+  V.resize(20);
+  V[15] = 1;
+  V[5] = 2;
+  V.resize(12);
+  EXPECT_EQ(12U, V.size());
+  V.resize(20);
+  EXPECT_EQ(0, V[15]);
+  EXPECT_EQ(2, V[5]);
+
+  V.resize(5);
+  EXPECT_EQ(10U, V.capacity());
+  V.resize(10);
+  EXPECT_EQ(0, V[5]);
+
+  V.clear();
+  EXPECT_TRUE(V.empty());
+  EXPECT_EQ(0U, V.capacity());
+}
+
+} // end anonymous namespace
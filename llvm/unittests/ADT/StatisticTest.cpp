@@ -156,4 +156,37 @@ TEST(StatisticTest, API) {
 #endif
 }
 
+TEST(StatisticTest, Scopes) {
+  EnableStatistics();
+  ResetStatistics();
+
+  Counter++;
+  {
+    StatisticScope A("a.o");
+    Counter += 2;
+    {
+      StatisticScope B("b\\c.o");
+      Counter2++;
+    }
+    Counter--;
+  }
+
+#if LLVM_ENABLE_STATS
+  std::string S;
+  raw_string_ostream OS(S);
+  PrintStatisticsJSON(OS);
+  OS.str();
+  EXPECT_NE(std::string::npos, S.find("\t\"unittest.Counter\": 2,\n"));
+  EXPECT_NE(std::string::npos,
+            S.find("\t\t{\"name\": \"b\\\\c.o\", \"thread\": 1, "
+                   "\"stats\": {\"unittest.Counter2\": 1}},\n"
+                   "\t\t{\"name\": \"a.o\", \"thread\": 1, "
+                   "\"stats\": {\"unittest.Counter\": 1}}\n"));
+  EXPECT_NE(std::string::npos,
+            S.find("\t\t\"1\": {\"unittest.Counter\": 1, "
+                   "\"unittest.Counter2\": 1}\n"));
+#endif
+  ResetStatistics();
+}
+
 } // end anonymous namespace
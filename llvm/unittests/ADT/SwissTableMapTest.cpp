@@ -0,0 +1,173 @@
+//===- llvm/unittest/ADT/SwissTableMapTest.cpp - SwissTableMap unit tests -===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SwissTableMap.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <random>
+
+using namespace llvm;
+
+namespace {
+
+TEST(SwissTableMapTest, EmptyMap) {
+  SwissTableMap<int, int> M;
+  EXPECT_TRUE(M.empty());
+  EXPECT_EQ(0u, M.size());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_EQ(0u, M.count(1));
+  EXPECT_TRUE(M.find(1) == M.end());
+  EXPECT_EQ(0, M.lookup(1));
+  EXPECT_FALSE(M.erase(1));
+  EXPECT_EQ(0u, M.getMemorySize());
+}
+
+TEST(SwissTableMapTest, InsertFindErase) {
+  SwissTableMap<int, int> M;
+  auto R = M.insert(std::make_pair(1, 2));
+  EXPECT_TRUE(R.second);
+  EXPECT_EQ(1, R.first->first);
+  EXPECT_EQ(2, R.first->second);
+
+  R = M.insert(std::make_pair(1, 3));
+  EXPECT_FALSE(R.second);
+  EXPECT_EQ(2, R.first->second);
+
+  EXPECT_EQ(1u, M.size());
+  EXPECT_EQ(1u, M.count(1));
+  EXPECT_EQ(2, M.lookup(1));
+  EXPECT_EQ(2, M[1]);
+  M[2] = 4;
+  EXPECT_EQ(2u, M.size());
+
+  EXPECT_TRUE(M.erase(1));
+  EXPECT_FALSE(M.erase(1));
+  EXPECT_EQ(1u, M.size());
+  EXPECT_TRUE(M.find(1) == M.end());
+
+  auto I = M.find(2);
+  ASSERT_TRUE(I != M.end());
+  M.erase(I);
+  EXPECT_TRUE(M.empty());
+}
+
+TEST(SwissTableMapTest, TryEmplaceMoveOnly) {
+  SwissTableMap<int, std::unique_ptr<int>> M;
+  auto R = M.try_emplace(1, std::make_unique<int>(5));
+  EXPECT_TRUE(R.second);
+  std::unique_ptr<int> P(new int(6));
+  R = M.try_emplace(1, std::move(P));
+  EXPECT_FALSE(R.second);
+  EXPECT_TRUE(P);
+  EXPECT_EQ(5, *R.first->second);
+
+  // Growing must move the values.
+  for (int I = 2; I < 1000; ++I)
+    M.try_emplace(I, std::make_unique<int>(I));
+  for (int I = 2; I < 1000; ++I)
+    EXPECT_EQ(I, *M.find(I)->second);
+  EXPECT_EQ(5, *M.find(1)->second);
+}
+
+TEST(SwissTableMapTest, Iteration) {
+  SwissTableMap<unsigned, unsigned> M;
+  for (unsigned I = 0; I < 100; ++I)
+    M[I] = I * 2;
+
+  std::vector<bool> Seen(100);
+  for (auto &KV : M) {
+    EXPECT_EQ(KV.first * 2, KV.second);
+    EXPECT_FALSE(Seen[KV.first]);
+    Seen[KV.first] = true;
+  }
+  EXPECT_EQ(100u, size_t(std::count(Seen.begin(), Seen.end(), true)));
+
+  const auto &CM = M;
+  unsigned N = 0;
+  for (auto I = CM.begin(), E = CM.end(); I != E; ++I)
+    ++N;
+  EXPECT_EQ(100u, N);
+}
+
+TEST(SwissTableMapTest, CopyMoveSwap) {
+  SwissTableMap<int, int> A = {{1, 10}, {2, 20}, {3, 30}};
+  SwissTableMap<int, int> B(A);
+  EXPECT_EQ(3u, B.size());
+  EXPECT_TRUE(A == B);
+
+  B[4] = 40;
+  EXPECT_TRUE(A != B);
+
+  SwissTableMap<int, int> C(std::move(B));
+  EXPECT_TRUE(B.empty());
+  EXPECT_EQ(4u, C.size());
+  EXPECT_EQ(40, C.lookup(4));
+
+  A.swap(C);
+  EXPECT_EQ(4u, A.size());
+  EXPECT_EQ(3u, C.size());
+
+  C = A;
+  EXPECT_TRUE(A == C);
+  B = std::move(C);
+  EXPECT_TRUE(A == B);
+  EXPECT_TRUE(C.empty());
+}
+
+TEST(SwissTableMapTest, ReserveAndClear) {
+  SwissTableMap<int, int> M;
+  M.reserve(1000);
+  size_t MemorySize = M.getMemorySize();
+  for (int I = 0; I < 1000; ++I)
+    M[I] = I;
+  EXPECT_EQ(MemorySize, M.getMemorySize());
+
+  M.clear();
+  EXPECT_TRUE(M.empty());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_EQ(0u, M.count(5));
+  M[5] = 6;
+  EXPECT_EQ(6, M.lookup(5));
+}
+
+TEST(SwissTableMapTest, PointerKeys) {
+  std::vector<int> V(4096);
+  SwissTableMap<int *, unsigned> M;
+  for (unsigned I = 0; I < V.size(); ++I)
+    M[&V[I]] = I;
+  for (unsigned I = 0; I < V.size(); ++I)
+    EXPECT_EQ(I, M.lookup(&V[I]));
+  EXPECT_EQ(0u, M.count(nullptr));
+}
+
+// Erasing must not break the probe sequences of the remaining entries, and
+// the space of erased entries must be reused.
+TEST(SwissTableMapTest, RandomOperations) {
+  std::mt19937 Rng(0);
+  SwissTableMap<unsigned, unsigned> M;
+  std::map<unsigned, unsigned> Ref;
+  for (unsigned Step = 0; Step < 200000; ++Step) {
+    unsigned Key = Rng() % 2000;
+    if (Rng() % 2) {
+      EXPECT_EQ(Ref.insert({Key, Step}).second,
+                M.insert({Key, Step}).second);
+    } else {
+      EXPECT_EQ(Ref.erase(Key) != 0, M.erase(Key));
+    }
+  }
+  EXPECT_EQ(Ref.size(), M.size());
+  for (auto &KV : Ref)
+    EXPECT_EQ(KV.second, M.lookup(KV.first));
+  for (auto &KV : M)
+    EXPECT_EQ(KV.second, Ref[KV.first]);
+  // The table should not have grown much beyond what 2000 entries need.
+  EXPECT_LT(M.getMemorySize(), 4096 * (sizeof(unsigned) * 2 + 1) + 64);
+}
+
+} // namespace
@@ -17,6 +17,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/DataTypes.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
@@ -83,5 +84,85 @@ TEST_F(BranchProbabilityInfoTest, StressUnreachableHeuristic) {
   EXPECT_TRUE(BPI.isEdgeHot(EntryBB, ExitBB));
 }
 
+TEST(BranchProbabilityInfoCacheTest, ReuseAcrossModules) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("bpi-cache", CacheDir));
+
+  const char *Source = R"(
+    define void @f(i32 %n, i1 %c) {
+    entry:
+      br i1 %c, label %loop, label %exit, !prof !0
+    loop:
+      %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+      %i.next = add i32 %i, 1
+      %done = icmp eq i32 %i.next, %n
+      br i1 %done, label %exit, label %loop
+    exit:
+      ret void
+    }
+    !0 = !{!"branch_weights", i32 3, i32 5}
+  )";
+
+  // Computes the probabilities of @f of a fresh module for the source, and
+  // returns those of its edges and whether LoopInfo was needed.
+  auto Run = [&](StringRef Src, bool &Computed) {
+    LLVMContext C;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(Src, Err, C);
+    EXPECT_TRUE(M);
+    Function &F = *M->getFunction("f");
+    DominatorTree DT(F);
+    LoopInfo LI(DT);
+    Computed = false;
+    BranchProbabilityInfo BPI;
+    BPI.calculateCached(F,
+                        [&]() -> const LoopInfo & {
+                          Computed = true;
+                          return LI;
+                        },
+                        nullptr, CacheDir);
+    std::vector<uint32_t> Probs;
+    for (BasicBlock &BB : F)
+      for (unsigned I = 0, E = BB.getTerminator()->getNumSuccessors(); I != E;
+           ++I)
+        Probs.push_back(BPI.getEdgeProbability(&BB, I).getNumerator());
+    return Probs;
+  };
+
+  bool Computed;
+  std::vector<uint32_t> First = Run(Source, Computed);
+  EXPECT_TRUE(Computed);
+  std::vector<uint32_t> Second = Run(Source, Computed);
+  EXPECT_FALSE(Computed);
+  EXPECT_EQ(First, Second);
+
+  // Other branch weights are another function.
+  std::string Changed = Source;
+  Changed.replace(Changed.find("i32 3, i32 5"), 12, "i32 5, i32 3");
+  std::vector<uint32_t> Third = Run(Changed, Computed);
+  EXPECT_TRUE(Computed);
+  EXPECT_NE(First, Third);
+
+  // The key doesn't depend on value names or on metadata the heuristics
+  // don't look at.
+  std::string Renamed = Source;
+  Renamed.replace(Renamed.find("%done = icmp"), 5, "%cond");
+  Renamed.replace(Renamed.find("%done, label"), 5, "%cond");
+  Renamed.replace(Renamed.find("add i32 %i, 1"), 13,
+                  "add i32 %i, 1, !dbg.unrelated !1");
+  Renamed += "!1 = !{}\n";
+  std::vector<uint32_t> Fourth = Run(Renamed, Computed);
+  EXPECT_FALSE(Computed);
+  EXPECT_EQ(First, Fourth);
+
+  // Another comparison is another function.
+  std::string OtherCmp = Source;
+  OtherCmp.replace(OtherCmp.find("icmp eq"), 7, "icmp ne");
+  Run(OtherCmp, Computed);
+  EXPECT_TRUE(Computed);
+
+  EXPECT_FALSE(sys::fs::remove_directories(CacheDir));
+}
+
 } // end anonymous namespace
 } // end namespace llvm
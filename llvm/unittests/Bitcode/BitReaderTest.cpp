@@ -11,13 +11,16 @@
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -190,4 +193,111 @@ TEST(BitReaderTest, MaterializeFunctionsForBlockAddrInFunctionAfter) {
   EXPECT_FALSE(verifyModule(*M, &dbgs()));
 }
 
+TEST(BitReaderTest, ParallelFunctionParsing) {
+  // Function blocks with local constants, value names, metadata attachments
+  // and a blockaddress forward reference.
+  const char *Assembly = "define i32 @f(i32 %x) {\n"
+                         "entry:\n"
+                         "  %c = icmp eq i32 %x, 42\n"
+                         "  br i1 %c, label %a, label %b, !prof !0\n"
+                         "a:\n"
+                         "  %y = add i32 %x, 7, !foo !1\n"
+                         "  br label %b\n"
+                         "b:\n"
+                         "  %r = phi i32 [ 0, %entry ], [ %y, %a ]\n"
+                         "  ret i32 %r\n"
+                         "}\n"
+                         "define i8* @g() {\n"
+                         "  ret i8* blockaddress(@h, %bb)\n"
+                         "}\n"
+                         "define void @h() {\n"
+                         "  unreachable\n"
+                         "bb:\n"
+                         "  unreachable\n"
+                         "}\n"
+                         "!0 = !{!\"branch_weights\", i32 1, i32 2}\n"
+                         "!1 = !{!\"bar\"}\n";
+
+  auto Print = [&](bool Parallel) {
+    cl::opt<bool> *Opt = static_cast<cl::opt<bool> *>(
+        cl::getRegisteredOptions()["bitcode-parallel-function-parsing"]);
+    *Opt = Parallel;
+
+    LLVMContext Context;
+    SmallString<1024> Mem;
+    writeModuleToBuffer(parseAssembly(Context, Assembly), Mem);
+    Expected<std::unique_ptr<Module>> ModuleOrErr =
+        parseBitcodeFile(MemoryBufferRef(Mem.str(), "test"), Context);
+    *Opt = false;
+    if (!ModuleOrErr)
+      report_fatal_error("Could not parse bitcode module");
+    EXPECT_FALSE(verifyModule(**ModuleOrErr, &dbgs()));
+
+    std::string Str;
+    raw_string_ostream OS(Str);
+    (*ModuleOrErr)->print(OS, nullptr);
+    return OS.str();
+  };
+
+  EXPECT_EQ(Print(false), Print(true));
+}
+
+TEST(BitReaderTest, LazyLoadDebugInfoForImporting) {
+  // Write an index for lazy-loading even though there are few nodes.
+  cl::opt<unsigned> *IndexThreshold = static_cast<cl::opt<unsigned> *>(
+      cl::getRegisteredOptions()["bitcode-mdindex-threshold"]);
+  unsigned OldIndexThreshold = *IndexThreshold;
+  *IndexThreshold = 0;
+
+  SmallString<1024> Mem;
+  LLVMContext Context;
+  writeModuleToBuffer(
+      parseAssembly(
+          Context,
+          "@g = global i32 0, !dbg !0\n"
+          "define void @f() !dbg !9 {\n"
+          "  ret void\n"
+          "}\n"
+          "!llvm.dbg.cu = !{!2}\n"
+          "!llvm.module.flags = !{!8}\n"
+          "!0 = !DIGlobalVariableExpression(var: !1, expr: !DIExpression())\n"
+          "!1 = distinct !DIGlobalVariable(name: \"g\", scope: !2, file: !3, "
+          "type: !6, isDefinition: true)\n"
+          "!2 = distinct !DICompileUnit(language: DW_LANG_C99, file: !3, "
+          "retainedTypes: !4, globals: !5)\n"
+          "!3 = !DIFile(filename: \"t.c\", directory: \"/\")\n"
+          "!4 = !{!7}\n"
+          "!5 = !{!0}\n"
+          "!6 = !DIBasicType(name: \"int\", size: 32, encoding: "
+          "DW_ATE_signed)\n"
+          "!7 = !DICompositeType(tag: DW_TAG_structure_type, name: \"S\", "
+          "file: !3, size: 32, elements: !{})\n"
+          "!8 = !{i32 2, !\"Debug Info Version\", i32 3}\n"
+          "!9 = distinct !DISubprogram(name: \"f\", scope: !3, file: !3, "
+          "unit: !2, spFlags: DISPFlagDefinition)\n"),
+      Mem);
+  *IndexThreshold = OldIndexThreshold;
+
+  Expected<std::unique_ptr<Module>> ModuleOrErr = getLazyBitcodeModule(
+      MemoryBufferRef(Mem.str(), "test"), Context,
+      /*ShouldLazyLoadMetadata=*/true, /*IsImporting=*/true);
+  ASSERT_TRUE(!!ModuleOrErr);
+  Module &M = **ModuleOrErr;
+  ASSERT_FALSE(M.materializeMetadata());
+
+  // The lists the importer drops are not loaded, and neither is the debug
+  // info of global variables until they are materialized.
+  auto *CU = cast<DICompileUnit>(
+      M.getNamedMetadata("llvm.dbg.cu")->getOperand(0));
+  EXPECT_EQ(CU->getRawRetainedTypes(), nullptr);
+  EXPECT_EQ(CU->getRawGlobalVariables(), nullptr);
+  GlobalVariable *G = M.getGlobalVariable("g");
+  EXPECT_EQ(G->getMetadata(LLVMContext::MD_dbg), nullptr);
+
+  ASSERT_FALSE(G->materialize());
+  EXPECT_NE(G->getMetadata(LLVMContext::MD_dbg), nullptr);
+  ASSERT_FALSE(M.getFunction("f")->materialize());
+  EXPECT_EQ(M.getFunction("f")->getSubprogram()->getUnit(), CU);
+}
+
 } // end namespace
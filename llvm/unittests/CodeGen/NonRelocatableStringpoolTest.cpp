@@ -0,0 +1,76 @@
+//===- llvm/unittest/CodeGen/NonRelocatableStringpoolTest.cpp -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+using namespace llvm;
+
+namespace {
+
+TEST(NonRelocatableStringpoolTest, OffsetsFollowInsertionOrder) {
+  NonRelocatableStringpool Pool;
+  // The empty string is always at offset 0.
+  EXPECT_EQ(Pool.getStringOffset(""), 0U);
+  EXPECT_EQ(Pool.getStringOffset("foo"), 1U);
+  EXPECT_EQ(Pool.getStringOffset("bar"), 5U);
+  EXPECT_EQ(Pool.getStringOffset("foo"), 1U);
+  EXPECT_EQ(Pool.getSize(), 9U);
+
+  // Interned strings only get an offset once they are asked for one.
+  StringRef Baz = Pool.internString("baz");
+  EXPECT_EQ(Pool.getSize(), 9U);
+  EXPECT_EQ(Pool.internString("baz").data(), Baz.data());
+  EXPECT_EQ(Pool.getStringOffset("baz"), 9U);
+
+  auto Entries = Pool.getEntriesForEmission();
+  ASSERT_EQ(Entries.size(), 4U);
+  EXPECT_EQ(Entries[1].getString(), "foo");
+  EXPECT_EQ(Entries[2].getString(), "bar");
+  EXPECT_EQ(Entries[3].getString(), "baz");
+}
+
+TEST(NonRelocatableStringpoolTest, Translator) {
+  NonRelocatableStringpool Pool(
+      [](StringRef S) { return S == "hidden" ? "visible" : S; });
+  EXPECT_EQ(Pool.getEntry("hidden").getString(), "visible");
+  EXPECT_EQ(Pool.getStringOffset("visible"), 1U);
+}
+
+TEST(UniquingStringPoolTest, EqualStringsShareStorage) {
+  UniquingStringPool Pool;
+  std::string Foo = "foo";
+  StringRef Interned = Pool.internString(Foo);
+  EXPECT_EQ(Interned, "foo");
+  EXPECT_NE(Interned.data(), Foo.data());
+  EXPECT_EQ(Pool.internString("foo").data(), Interned.data());
+  EXPECT_NE(Pool.internString("bar").data(), Interned.data());
+  EXPECT_EQ(Pool.internString(""), "");
+}
+
+TEST(UniquingStringPoolTest, ConcurrentInterning) {
+  UniquingStringPool Pool;
+  const unsigned NumThreads = 4, NumStrings = 1000;
+  std::vector<std::vector<const char *>> Interned(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T]() {
+      for (unsigned I = 0; I != NumStrings; ++I)
+        Interned[T].push_back(Pool.internString(std::to_string(I)).data());
+    });
+  for (auto &Thread : Threads)
+    Thread.join();
+
+  for (unsigned T = 1; T != NumThreads; ++T)
+    EXPECT_EQ(Interned[T], Interned[0]) << "Thread " << T
+                                        << " got different storage";
+}
+
+} // end anonymous namespace
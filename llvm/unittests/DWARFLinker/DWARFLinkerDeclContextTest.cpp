@@ -0,0 +1,148 @@
+//===- DWARFLinkerDeclContextTest.cpp -------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
+#include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/ObjectYAML/DWARFEmitter.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// Three units of one abbreviation table. The first two are C++ and each
+// declare a 'struct S' of 4 bytes, the third one is C and declares a 'struct
+// S' of 8 bytes.
+const char *YamlData = R"(
+debug_str:
+  - ''
+  - S
+debug_abbrev:
+  - Code:            0x00000001
+    Tag:             DW_TAG_compile_unit
+    Children:        DW_CHILDREN_yes
+    Attributes:
+      - Attribute:       DW_AT_language
+        Form:            DW_FORM_data2
+  - Code:            0x00000002
+    Tag:             DW_TAG_structure_type
+    Children:        DW_CHILDREN_no
+    Attributes:
+      - Attribute:       DW_AT_name
+        Form:            DW_FORM_strp
+      - Attribute:       DW_AT_byte_size
+        Form:            DW_FORM_data1
+debug_info:
+  - Length:
+      TotalLength:     17
+    Version:         4
+    AbbrOffset:      0
+    AddrSize:        8
+    Entries:
+      - AbbrCode:        0x00000001
+        Values:
+          - Value:           0x0000000000000004
+      - AbbrCode:        0x00000002
+        Values:
+          - Value:           0x0000000000000001
+          - Value:           0x0000000000000004
+      - AbbrCode:        0x00000000
+        Values:
+  - Length:
+      TotalLength:     17
+    Version:         4
+    AbbrOffset:      0
+    AddrSize:        8
+    Entries:
+      - AbbrCode:        0x00000001
+        Values:
+          - Value:           0x0000000000000004
+      - AbbrCode:        0x00000002
+        Values:
+          - Value:           0x0000000000000001
+          - Value:           0x0000000000000004
+      - AbbrCode:        0x00000000
+        Values:
+  - Length:
+      TotalLength:     17
+    Version:         4
+    AbbrOffset:      0
+    AddrSize:        8
+    Entries:
+      - AbbrCode:        0x00000001
+        Values:
+          - Value:           0x000000000000000C
+      - AbbrCode:        0x00000002
+        Values:
+          - Value:           0x0000000000000001
+          - Value:           0x0000000000000008
+      - AbbrCode:        0x00000000
+        Values:
+)";
+
+class DWARFLinkerDeclContextTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto ErrOrSections = DWARFYAML::EmitDebugSections(StringRef(YamlData),
+                                                      /*ApplyFixups=*/true);
+    ASSERT_TRUE((bool)ErrOrSections);
+    Context = DWARFContext::create(*ErrOrSections, 8);
+    ASSERT_EQ(Context->getNumCompileUnits(), 3u);
+    for (unsigned I = 0; I != 3; ++I)
+      Units.push_back(std::make_unique<CompileUnit>(
+          *Context->getUnitAtIndex(I), I, /*CanUseODR=*/true, ""));
+  }
+
+  // The 'struct S' of the unit at Idx.
+  DWARFDie getStruct(unsigned Idx) {
+    DWARFDie CUDie = Units[Idx]->getOrigUnit().getUnitDIE(false);
+    return CUDie.getFirstChild();
+  }
+
+  PointerIntPair<DeclContext *, 1> getContext(unsigned Idx) {
+    return Tree.getChildDeclContext(Tree.getRoot(), getStruct(Idx),
+                                    *Units[Idx], StringPool,
+                                    /*InClangModule=*/false);
+  }
+
+  std::unique_ptr<DWARFContext> Context;
+  std::vector<std::unique_ptr<CompileUnit>> Units;
+  DeclContextTree Tree;
+  UniquingStringPool StringPool;
+};
+
+TEST_F(DWARFLinkerDeclContextTest, ODR) {
+  EXPECT_TRUE(Units[0]->hasODR());
+  EXPECT_TRUE(Units[1]->hasODR());
+  EXPECT_FALSE(Units[2]->hasODR());
+}
+
+TEST_F(DWARFLinkerDeclContextTest, SameTypeInTwoUnits) {
+  // The same type in two units gets the same context, so that the second
+  // copy can be replaced by a reference to the first one.
+  auto First = getContext(0);
+  auto Second = getContext(1);
+  ASSERT_NE(First.getPointer(), nullptr);
+  EXPECT_FALSE(First.getInt());
+  EXPECT_FALSE(Second.getInt());
+  EXPECT_EQ(First.getPointer(), Second.getPointer());
+  EXPECT_EQ(First.getPointer()->getTag(), dwarf::DW_TAG_structure_type);
+  EXPECT_EQ(First.getPointer()->getQualifiedNameHash(),
+            Second.getPointer()->getQualifiedNameHash());
+}
+
+TEST_F(DWARFLinkerDeclContextTest, DifferentSize) {
+  // A type of the same name but another size is a different type.
+  auto First = getContext(0);
+  auto Third = getContext(2);
+  ASSERT_NE(Third.getPointer(), nullptr);
+  EXPECT_NE(First.getPointer(), Third.getPointer());
+}
+
+} // end anonymous namespace
@@ -32,6 +32,7 @@
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
 #include <string>
+#include <thread>
 
 using namespace llvm;
 using namespace dwarf;
@@ -3158,4 +3159,172 @@ TEST(DWARFDebugInfo, TestDWARFDieRangeInfoIntersects) {
   AssertRangesIntersect(Ranges, {{0x20, 0x21}, {0x2f, 0x31}});
 }
 
+TEST(DWARFDebugInfo, TestThreadSafeContext) {
+  // Look up the subprograms of a compile unit from several threads at once,
+  // then drop the DIEs and look them up again.
+  StringRef yamldata = R"(
+    debug_str:
+      - ''
+      - /tmp/main.c
+      - foo
+      - bar
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_low_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_high_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+      - Code:            0x00000002
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_low_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_high_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+    debug_info:
+      - Length:
+          TotalLength:     71
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000001000
+              - Value:           0x0000000000003000
+              - Value:           0x0000000000000001
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x0000000000001000
+              - Value:           0x0000000000002000
+              - Value:           0x000000000000000D
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x0000000000002000
+              - Value:           0x0000000000003000
+              - Value:           0x0000000000000011
+          - AbbrCode:        0x00000000
+            Values:
+  )";
+  auto ErrOrSections = DWARFYAML::EmitDebugSections(yamldata);
+  ASSERT_TRUE((bool)ErrOrSections);
+  std::unique_ptr<DWARFContext> DwarfContext = DWARFContext::create(
+      *ErrOrSections, 8, sys::IsLittleEndianHost, /*ThreadSafe=*/true);
+  ASSERT_TRUE(DwarfContext->isThreadSafe());
+
+  auto GetFunctionName = [&](uint64_t Address) -> const char * {
+    DWARFContext::DIEsForAddress DIEs =
+        DwarfContext->getDIEsForAddress(Address);
+    if (!DIEs.FunctionDIE)
+      return nullptr;
+    return DIEs.FunctionDIE.getName(DINameKind::ShortName);
+  };
+
+  const unsigned NumThreads = 4;
+  std::vector<unsigned> Mismatches(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T]() {
+      for (unsigned I = 0; I != 100; ++I) {
+        const char *Name = GetFunctionName(I % 2 ? 0x1800 : 0x2800);
+        if (!Name || StringRef(Name) != (I % 2 ? "foo" : "bar"))
+          ++Mismatches[T];
+      }
+    });
+  for (auto &Thread : Threads)
+    Thread.join();
+  for (unsigned T = 0; T != NumThreads; ++T)
+    EXPECT_EQ(Mismatches[T], 0U) << "Thread " << T << " found wrong DIEs";
+
+  DWARFUnit *U = DwarfContext->getUnitAtIndex(0);
+  ASSERT_NE(U, nullptr);
+  EXPECT_EQ(U->getNumDIEs(), 4U);
+  U->clearDIEs(/*KeepCUDie=*/false);
+  EXPECT_STREQ(GetFunctionName(0x2800), "bar");
+  EXPECT_EQ(U->getNumDIEs(), 4U);
+}
+
+TEST(DWARFDebugInfo, TestDwarfVerifyParallel) {
+  // Create two compile units with a single function each, whose DW_AT_type
+  // is an invalid CU relative offset. Verifying the units concurrently must
+  // report the same errors, in the same order, as verifying them serially.
+  const char *yamldata = R"(
+    debug_str:
+      - ''
+      - /tmp/main.c
+      - main
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+      - Code:            0x00000002
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+          - Attribute:       DW_AT_type
+            Form:            DW_FORM_ref4
+    debug_info:
+      - Length:
+          TotalLength:     22
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000001
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x000000000000000D
+              - Value:           0x0000000000001234
+          - AbbrCode:        0x00000000
+            Values:
+      - Length:
+          TotalLength:     22
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000001
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x000000000000000D
+              - Value:           0x0000000000005678
+          - AbbrCode:        0x00000000
+            Values:
+  )";
+  auto ErrOrSections = DWARFYAML::EmitDebugSections(StringRef(yamldata));
+  ASSERT_TRUE((bool)ErrOrSections);
+
+  auto Verify = [&](bool ThreadSafe, unsigned Threads) {
+    std::unique_ptr<DWARFContext> DwarfContext = DWARFContext::create(
+        *ErrOrSections, 8, sys::IsLittleEndianHost, ThreadSafe);
+    DIDumpOptions DumpOpts;
+    DumpOpts.VerifyThreads = Threads;
+    std::string Str;
+    raw_string_ostream Strm(Str);
+    EXPECT_FALSE(DwarfContext->verify(Strm, DumpOpts));
+    return Strm.str();
+  };
+  std::string Serial = Verify(/*ThreadSafe=*/false, 1);
+  EXPECT_TRUE(StringRef(Serial).contains("CU offset 0x00001234 is invalid"));
+  EXPECT_TRUE(StringRef(Serial).contains("CU offset 0x00005678 is invalid"));
+  EXPECT_EQ(Verify(/*ThreadSafe=*/true, 4), Serial);
+}
+
 } // end anonymous namespace
@@ -0,0 +1,245 @@
+//===- llvm/unittest/DebugInfo/Symbolize/SymbolizerIndexTest.cpp ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/Symbolize/SymbolizerIndex.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/ObjectYAML/DWARFEmitter.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::symbolize;
+
+namespace {
+
+// A compile unit for /tmp/main.c with main() at [0x1000, 0x1030), into which
+// inl() is inlined at [0x1010, 0x1020) from line 5.
+const char *const IndexTestYAML = R"(
+    debug_str:
+      - ''
+      - /tmp/main.c
+      - main
+      - inl
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+          - Attribute:       DW_AT_stmt_list
+            Form:            DW_FORM_sec_offset
+          - Attribute:       DW_AT_low_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_high_pc
+            Form:            DW_FORM_data4
+      - Code:            0x00000002
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+          - Attribute:       DW_AT_inline
+            Form:            DW_FORM_data1
+      - Code:            0x00000003
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+          - Attribute:       DW_AT_low_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_high_pc
+            Form:            DW_FORM_data4
+      - Code:            0x00000004
+        Tag:             DW_TAG_inlined_subroutine
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_abstract_origin
+            Form:            DW_FORM_ref4
+          - Attribute:       DW_AT_low_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_high_pc
+            Form:            DW_FORM_data4
+          - Attribute:       DW_AT_call_file
+            Form:            DW_FORM_data1
+          - Attribute:       DW_AT_call_line
+            Form:            DW_FORM_data1
+    debug_info:
+      - Length:
+          TotalLength:     72
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000001
+              - Value:           0x0000000000000000
+              - Value:           0x0000000000001000
+              - Value:           0x0000000000000030
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x0000000000000012
+              - Value:           0x0000000000000003
+          - AbbrCode:        0x00000003
+            Values:
+              - Value:           0x000000000000000D
+              - Value:           0x0000000000001000
+              - Value:           0x0000000000000030
+          - AbbrCode:        0x00000004
+            Values:
+              - Value:           0x0000000000000020
+              - Value:           0x0000000000001010
+              - Value:           0x0000000000000010
+              - Value:           0x0000000000000001
+              - Value:           0x0000000000000005
+          - AbbrCode:        0x00000000
+            Values:
+          - AbbrCode:        0x00000000
+            Values:
+    debug_line:
+      - Length:
+          TotalLength:     69
+        Version:         2
+        PrologueLength:  34
+        MinInstLength:   1
+        DefaultIsStmt:   1
+        LineBase:        251
+        LineRange:       14
+        OpcodeBase:      13
+        StandardOpcodeLengths: [ 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1 ]
+        IncludeDirs:
+          - /tmp
+        Files:
+          - Name:            main.c
+            DirIdx:          1
+            ModTime:         0
+            Length:          0
+        Opcodes:
+          - Opcode:          DW_LNS_extended_op
+            ExtLen:          9
+            SubOpcode:       DW_LNE_set_address
+            Data:            4096
+          - Opcode:          DW_LNS_advance_line
+            SData:           2
+            Data:            0
+          - Opcode:          DW_LNS_copy
+            Data:            0
+          - Opcode:          DW_LNS_advance_pc
+            Data:            16
+          - Opcode:          DW_LNS_advance_line
+            SData:           7
+            Data:            0
+          - Opcode:          DW_LNS_copy
+            Data:            0
+          - Opcode:          DW_LNS_advance_pc
+            Data:            16
+          - Opcode:          DW_LNS_advance_line
+            SData:           -4
+            Data:            0
+          - Opcode:          DW_LNS_copy
+            Data:            0
+          - Opcode:          DW_LNS_advance_pc
+            Data:            16
+          - Opcode:          DW_LNS_extended_op
+            ExtLen:          1
+            SubOpcode:       DW_LNE_end_sequence
+            Data:            0
+)";
+
+const uint8_t Identity[] = {0xde, 0xad, 0xbe, 0xef, 0x01};
+
+class SymbolizerIndexTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto ErrOrSections = DWARFYAML::EmitDebugSections(IndexTestYAML);
+    ASSERT_TRUE((bool)ErrOrSections);
+    // The context refers to the section buffers, which must outlive it.
+    Sections = std::move(*ErrOrSections);
+    DICtx = DWARFContext::create(Sections, 8);
+  }
+
+  StringMap<std::unique_ptr<MemoryBuffer>> Sections;
+  std::unique_ptr<DWARFContext> DICtx;
+};
+
+std::string writeIndex(DWARFContext &DICtx) {
+  std::string Data;
+  raw_string_ostream OS(Data);
+  EXPECT_THAT_ERROR(SymbolizerIndex::write(DICtx, Identity, OS), Succeeded());
+  return OS.str();
+}
+
+void expectSameInfo(const DILineInfo &Expected, const DILineInfo &Actual,
+                    uint64_t Address) {
+  EXPECT_EQ(Expected, Actual) << "at address " << Address;
+  EXPECT_EQ(Expected.StartLine, Actual.StartLine) << "at address " << Address;
+}
+
+TEST_F(SymbolizerIndexTest, MatchesDWARF) {
+  Expected<std::unique_ptr<SymbolizerIndex>> Index = SymbolizerIndex::create(
+      MemoryBuffer::getMemBufferCopy(writeIndex(*DICtx)), Identity);
+  ASSERT_THAT_EXPECTED(Index, Succeeded());
+
+  DILineInfoSpecifier Spec(
+      DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath,
+      DINameKind::LinkageName);
+  for (uint64_t Address = 0xff0; Address != 0x1040; ++Address) {
+    object::SectionedAddress SA = {Address,
+                                   object::SectionedAddress::UndefSection};
+    expectSameInfo(DICtx->getLineInfoForAddress(SA, Spec),
+                   (*Index)->getLineInfoForAddress(SA, Spec), Address);
+
+    DIInliningInfo Expected = DICtx->getInliningInfoForAddress(SA, Spec);
+    DIInliningInfo Actual = (*Index)->getInliningInfoForAddress(SA, Spec);
+    ASSERT_EQ(Expected.getNumberOfFrames(), Actual.getNumberOfFrames())
+        << "at address " << Address;
+    for (uint32_t I = 0; I != Expected.getNumberOfFrames(); ++I)
+      expectSameInfo(Expected.getFrame(I), Actual.getFrame(I), Address);
+  }
+
+  DIInliningInfo Inlined = (*Index)->getInliningInfoForAddress(
+      {0x1018, object::SectionedAddress::UndefSection}, Spec);
+  ASSERT_EQ(Inlined.getNumberOfFrames(), 2U);
+  EXPECT_EQ(Inlined.getFrame(0).FunctionName, "inl");
+  EXPECT_EQ(Inlined.getFrame(0).Line, 10U);
+  EXPECT_EQ(Inlined.getFrame(1).FunctionName, "main");
+  EXPECT_EQ(Inlined.getFrame(1).FileName, "/tmp/main.c");
+  EXPECT_EQ(Inlined.getFrame(1).Line, 5U);
+
+  // Addresses outside of the debug info get no answer.
+  EXPECT_EQ((*Index)
+                ->getInliningInfoForAddress(
+                    {0x1030, object::SectionedAddress::UndefSection}, Spec)
+                .getNumberOfFrames(),
+            0U);
+}
+
+TEST_F(SymbolizerIndexTest, RejectsMismatchedOrTruncatedIndex) {
+  std::string Data = writeIndex(*DICtx);
+
+  const uint8_t OtherIdentity[] = {0xde, 0xad, 0xbe, 0xef, 0x02};
+  EXPECT_THAT_EXPECTED(
+      SymbolizerIndex::create(MemoryBuffer::getMemBufferCopy(Data),
+                              OtherIdentity),
+      Failed());
+  EXPECT_THAT_EXPECTED(
+      SymbolizerIndex::create(
+          MemoryBuffer::getMemBufferCopy(StringRef(Data).drop_back()),
+          Identity),
+      Failed());
+  EXPECT_THAT_EXPECTED(
+      SymbolizerIndex::create(MemoryBuffer::getMemBufferCopy(
+                                  StringRef(Data).take_front(8)),
+                              Identity),
+      Failed());
+}
+
+} // end anonymous namespace
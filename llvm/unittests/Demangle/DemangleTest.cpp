@@ -8,6 +8,7 @@
 
 #include "llvm/Demangle/Demangle.h"
 #include "gmock/gmock.h"
+#include <cstdlib>
 
 using namespace llvm;
 
@@ -22,3 +23,27 @@ TEST(Demangle, demangleTest) {
   EXPECT_EQ(demangle("?foo@@YAXH@Z"), "void __cdecl foo(int)");
   EXPECT_EQ(demangle("foo"), "foo");
 }
+
+TEST(Demangle, itaniumDemangleBatchTest) {
+  // A name whose AST needs more than the initial block of the arena, between
+  // names which fit in it, and one that needs a grown output buffer.
+  std::string Long = "_Z1f" + std::string(1000, 'P') + "i";
+  std::string Wide = "_Z1fI" + std::string(300, 'i') + "Evv";
+  const char *Names[] = {"_Z3fooi", "foo",       Long.c_str(), nullptr,
+                         "_Z3barv", Wide.c_str(), "_ZN1a1bEv"};
+  const size_t Count = sizeof(Names) / sizeof(Names[0]);
+  std::string Results[Count];
+  EXPECT_EQ(itaniumDemangleBatch(Names, Count, Results), 5u);
+  for (size_t I = 0; I != Count; ++I) {
+    if (!Names[I]) {
+      EXPECT_EQ(Results[I], "");
+      continue;
+    }
+    int Status;
+    char *Demangled = itaniumDemangle(Names[I], nullptr, nullptr, &Status);
+    EXPECT_EQ(Results[I], Demangled ? Demangled : "");
+    std::free(Demangled);
+  }
+  EXPECT_EQ(Results[0], "foo(int)");
+  EXPECT_EQ(Results[6], "a::b()");
+}
@@ -0,0 +1,416 @@
+//===---- ELF_x86_64_Tests.cpp - Tests for JITLink ELF/x86-64 -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "JITLinkTestCommon.h"
+
+#include "llvm/ExecutionEngine/JITLink/ELF_x86_64.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::jitlink::ELF_x86_64_Edges;
+
+namespace {
+
+class JITLinkTest_ELF_x86_64 : public JITLinkTestCommon,
+                               public testing::Test {
+public:
+  using BasicVerifyGraphFunction =
+      std::function<void(AtomGraph &, const MCDisassembler &)>;
+
+  void runBasicVerifyGraphTest(StringRef AsmSrc, StringRef Triple,
+                               StringMap<JITEvaluatedSymbol> Externals,
+                               bool PIC, bool LargeCodeModel,
+                               MCTargetOptions Options,
+                               BasicVerifyGraphFunction RunGraphTest) {
+    auto TR = getTestResources(AsmSrc, Triple, PIC, LargeCodeModel,
+                               std::move(Options));
+    if (!TR) {
+      dbgs() << "Skipping JITLInk unit test: " << toString(TR.takeError())
+             << "\n";
+      return;
+    }
+
+    auto JTCtx = std::make_unique<TestJITLinkContext>(
+        **TR, [&](AtomGraph &G) { RunGraphTest(G, (*TR)->getDisassembler()); });
+
+    JTCtx->externals() = std::move(Externals);
+
+    jitLink_ELF_x86_64(std::move(JTCtx));
+  }
+
+protected:
+  // The atoms of an ELF section are chained together by layout-next and
+  // keep-alive edges, so only look at relocations.
+  static Edge *getSingleRelocation(DefinedAtom &A) {
+    Edge *Reloc = nullptr;
+    size_t NumRelocs = 0;
+    for (auto &E : A.edges())
+      if (E.isRelocation() && !NumRelocs++)
+        Reloc = &E;
+    EXPECT_EQ(NumRelocs, 1U) << "Unexpected number of relocations";
+    return NumRelocs == 1 ? Reloc : nullptr;
+  }
+
+  static void verifyIsPointerTo(AtomGraph &G, DefinedAtom &A, Atom &Target) {
+    auto *E = getSingleRelocation(A);
+    if (!E)
+      return;
+    EXPECT_EQ(E->getKind(), Pointer64)
+        << "Expected pointer to have a pointer64 relocation";
+    EXPECT_EQ(&E->getTarget(), &Target) << "Expected edge to point at target";
+    EXPECT_THAT_EXPECTED(readInt<uint64_t>(G, A), HasValue(Target.getAddress()))
+        << "Pointer does not point to target";
+  }
+
+  static void verifyGOTLoad(AtomGraph &G, Edge &E, Atom &Target) {
+    EXPECT_EQ(E.getKind(), PCRel32GOTEntryRelaxable)
+        << "Expected a relaxable GOT load";
+    EXPECT_EQ(E.getAddend(), -4) << "Expected GOT load to have a -4 addend";
+    EXPECT_TRUE(E.getTarget().isDefined())
+        << "GOT entry should be a defined atom";
+    if (!E.getTarget().isDefined())
+      return;
+
+    verifyIsPointerTo(G, static_cast<DefinedAtom &>(E.getTarget()), Target);
+  }
+
+  static void verifyCall(const MCDisassembler &Dis, DefinedAtom &Caller,
+                         Edge &E, Atom &Callee) {
+    EXPECT_EQ(E.getKind(), Branch32) << "Edge is not a Branch32";
+    EXPECT_EQ(E.getAddend(), -4) << "Expected a -4 addend on call";
+    EXPECT_EQ(&E.getTarget(), &Callee)
+        << "Edge does not point at expected callee";
+
+    JITTargetAddress FixupAddress = Caller.getAddress() + E.getOffset();
+    uint64_t PCRelDelta = Callee.getAddress() - (FixupAddress + 4);
+
+    EXPECT_THAT_EXPECTED(
+        decodeImmediateOperand(Dis, Caller, 0, E.getOffset() - 1),
+        HasValue(PCRelDelta));
+  }
+
+  static void verifyCallViaStub(const MCDisassembler &Dis, AtomGraph &G,
+                                DefinedAtom &Caller, Edge &E, Atom &Callee) {
+    verifyCall(Dis, Caller, E, E.getTarget());
+
+    if (!E.getTarget().isDefined()) {
+      ADD_FAILURE() << "Edge target is not a stub";
+      return;
+    }
+
+    auto &StubAtom = static_cast<DefinedAtom &>(E.getTarget());
+    EXPECT_EQ(StubAtom.edges_size(), 1U)
+        << "Expected one edge from stub to target";
+    auto &StubEdge = *StubAtom.edges().begin();
+    EXPECT_EQ(StubEdge.getKind(), PCRel32) << "Stub edge is not a PCRel32";
+    EXPECT_TRUE(StubEdge.getTarget().isDefined())
+        << "Stub target is not a defined atom";
+    if (!StubEdge.getTarget().isDefined())
+      return;
+    verifyIsPointerTo(G, static_cast<DefinedAtom &>(StubEdge.getTarget()),
+                      Callee);
+
+    JITTargetAddress FixupAddress =
+        StubAtom.getAddress() + StubEdge.getOffset();
+    uint64_t PCRelDelta =
+        StubEdge.getTarget().getAddress() - (FixupAddress + 4);
+
+    EXPECT_THAT_EXPECTED(
+        decodeImmediateOperand(Dis, StubAtom, 3, StubEdge.getOffset() - 2),
+        HasValue(PCRelDelta));
+  }
+};
+
+} // end anonymous namespace
+
+TEST_F(JITLinkTest_ELF_x86_64, BasicRelocations) {
+  runBasicVerifyGraphTest(
+      R"(
+            .text
+            .globl  bar
+            .p2align        4, 0x90
+            .type   bar,@function
+    bar:
+            callq   baz@PLT
+
+            .globl  foo
+            .p2align        4, 0x90
+            .type   foo,@function
+    foo:
+            callq   bar@PLT
+    foo.1:
+            movq    y@GOTPCREL(%rip), %rcx
+    foo.2:
+            movq    x@GOTPCREL(%rip), %rdx
+    foo.3:
+            movq    p(%rip), %rdx
+
+            .data
+            .globl  x
+            .p2align        2
+    x:
+            .long   42
+
+            .globl  p
+            .p2align        3
+    p:
+            .quad   x)",
+      "x86_64-unknown-linux",
+      {{"y", JITEvaluatedSymbol(0xdeadbeef, JITSymbolFlags::Exported)},
+       {"baz", JITEvaluatedSymbol(0xcafef00d, JITSymbolFlags::Exported)}},
+      true, false, MCTargetOptions(),
+      [](AtomGraph &G, const MCDisassembler &Dis) {
+        // Name the atoms in the asm above.
+        auto &Baz = atom(G, "baz");
+        auto &Y = atom(G, "y");
+
+        auto &Bar = definedAtom(G, "bar");
+        auto &Foo = definedAtom(G, "foo");
+        auto &Foo_1 = definedAtom(G, "foo.1");
+        auto &Foo_2 = definedAtom(G, "foo.2");
+        auto &Foo_3 = definedAtom(G, "foo.3");
+        auto &X = definedAtom(G, "x");
+        auto &P = definedAtom(G, "p");
+
+        // Check the absolute relocation for p.
+        verifyIsPointerTo(G, P, X);
+
+        // Check that bar is a call-via-stub to baz.
+        if (auto *E = getSingleRelocation(Bar))
+          verifyCallViaStub(Dis, G, Bar, *E, Baz);
+
+        // Check that foo is a direct call to bar.
+        if (auto *E = getSingleRelocation(Foo))
+          verifyCall(Dis, Foo, *E, Bar);
+
+        // Check the GOT load in foo.1.
+        if (auto *E = getSingleRelocation(Foo_1))
+          verifyGOTLoad(G, *E, Y);
+
+        // Check that the GOT load of x in foo.2, which is in range, was
+        // relaxed to a lea of x.
+        if (auto *E = getSingleRelocation(Foo_2)) {
+          verifyGOTLoad(G, *E, X);
+
+          JITTargetAddress FixupAddress = Foo_2.getAddress() + E->getOffset();
+          int32_t PCRelDelta = X.getAddress() - (FixupAddress + 4);
+
+          EXPECT_THAT_EXPECTED(readInt<uint8_t>(G, Foo_2, E->getOffset() - 2),
+                               HasValue(0x8d))
+              << "GOT load was not relaxed to a lea";
+          EXPECT_THAT_EXPECTED(readInt<int32_t>(G, Foo_2, E->getOffset()),
+                               HasValue(PCRelDelta))
+              << "Relaxed GOT load does not reference expected target";
+        }
+
+        // Check the PCRel ref to p in foo.3.
+        if (auto *E = getSingleRelocation(Foo_3)) {
+          EXPECT_EQ(E->getKind(), PCRel32);
+
+          JITTargetAddress FixupAddress = Foo_3.getAddress() + E->getOffset();
+          uint64_t PCRelDelta = P.getAddress() - (FixupAddress + 4);
+
+          EXPECT_THAT_EXPECTED(decodeImmediateOperand(Dis, Foo_3, 4, 0),
+                               HasValue(PCRelDelta))
+              << "PCRel load does not reference expected target";
+        }
+      });
+}
+
+TEST_F(JITLinkTest_ELF_x86_64, EHFrame) {
+  runBasicVerifyGraphTest(
+      R"(
+            .text
+            .globl  foo
+            .p2align        4, 0x90
+            .type   foo,@function
+    foo:
+            .cfi_startproc
+            pushq   %rbp
+            .cfi_def_cfa_offset 16
+            popq    %rbp
+            .cfi_def_cfa_offset 8
+            retq
+            .cfi_endproc)",
+      "x86_64-unknown-linux", {}, true, false, MCTargetOptions(),
+      [](AtomGraph &G, const MCDisassembler &Dis) {
+        auto &Foo = definedAtom(G, "foo");
+
+        auto *EHFrame = G.findSectionByName(".eh_frame");
+        ASSERT_NE(EHFrame, nullptr) << "No .eh_frame section in the graph";
+
+        // The eh-frame section is kept alive, ends in a zero terminator, and
+        // its FDE refers to foo.
+        DefinedAtom *Last = nullptr;
+        size_t NumRefsToFoo = 0;
+        for (auto *DA : EHFrame->atoms()) {
+          EXPECT_TRUE(DA->isLive()) << "eh-frame atom is not live";
+          if (!Last || DA->getAddress() > Last->getAddress())
+            Last = DA;
+          for (auto &E : DA->edges()) {
+            if (!E.isRelocation() || &E.getTarget() != &Foo)
+              continue;
+            ++NumRefsToFoo;
+            EXPECT_EQ(E.getKind(), PCRel32);
+            JITTargetAddress FixupAddress = DA->getAddress() + E.getOffset();
+            EXPECT_THAT_EXPECTED(
+                readInt<int32_t>(G, *DA, E.getOffset()),
+                HasValue(static_cast<int32_t>(
+                    Foo.getAddress() + E.getAddend() - FixupAddress)))
+                << "FDE pc-begin does not point at foo";
+          }
+        }
+        EXPECT_EQ(NumRefsToFoo, 1U) << "Expected one FDE for foo";
+        ASSERT_NE(Last, nullptr);
+        EXPECT_EQ(Last->getContent(), StringRef("\0\0\0\0", 4))
+            << "eh-frame section is not terminated";
+        EXPECT_TRUE(Foo.isLive()) << "foo was dead-stripped";
+
+        // foo keeps its FDE alive, and the FDE's CIE pointer is fixed up to
+        // point back at its CIE.
+        auto KeepAliveItr =
+            std::find_if(Foo.edges().begin(), Foo.edges().end(),
+                         [](Edge &E) { return E.getKind() == Edge::KeepAlive; });
+        ASSERT_NE(KeepAliveItr, Foo.edges().end())
+            << "foo does not keep its FDE alive";
+        auto &FDE = static_cast<DefinedAtom &>(KeepAliveItr->getTarget());
+        EXPECT_EQ(&FDE.getSection(), EHFrame);
+        auto CIEPtrItr =
+            std::find_if(FDE.edges().begin(), FDE.edges().end(),
+                         [](Edge &E) { return E.getKind() == NegDelta32; });
+        ASSERT_NE(CIEPtrItr, FDE.edges().end()) << "FDE has no CIE pointer";
+        EXPECT_EQ(CIEPtrItr->getOffset(), 4U);
+        auto &CIE = CIEPtrItr->getTarget();
+        EXPECT_THAT_EXPECTED(
+            readInt<uint32_t>(G, FDE, 4),
+            HasValue(static_cast<uint32_t>(FDE.getAddress() + 4 -
+                                           CIE.getAddress())))
+            << "FDE CIE pointer does not point at its CIE";
+      });
+}
+
+TEST_F(JITLinkTest_ELF_x86_64, RelaxedGOTCallAndJump) {
+  runBasicVerifyGraphTest(
+      R"(
+            .text
+            .globl  foo
+            .p2align        4, 0x90
+            .type   foo,@function
+    foo:
+            callq   *bar@GOTPCREL(%rip)
+    foo.1:
+            jmpq    *bar@GOTPCREL(%rip)
+    foo.2:
+            testq   %rax, bar@GOTPCREL(%rip)
+
+            .globl  bar
+            .p2align        4, 0x90
+            .type   bar,@function
+    bar:
+            retq)",
+      "x86_64-unknown-linux", {}, true, false, MCTargetOptions(),
+      [](AtomGraph &G, const MCDisassembler &Dis) {
+        auto &Foo = definedAtom(G, "foo");
+        auto &Foo_1 = definedAtom(G, "foo.1");
+        auto &Foo_2 = definedAtom(G, "foo.2");
+        auto &Bar = definedAtom(G, "bar");
+
+        // The call through the GOT becomes 'addr32 call bar'.
+        if (auto *E = getSingleRelocation(Foo)) {
+          verifyGOTLoad(G, *E, Bar);
+          JITTargetAddress FixupAddress = Foo.getAddress() + E->getOffset();
+          EXPECT_THAT_EXPECTED(readInt<uint8_t>(G, Foo, E->getOffset() - 2),
+                               HasValue(0x67));
+          EXPECT_THAT_EXPECTED(readInt<uint8_t>(G, Foo, E->getOffset() - 1),
+                               HasValue(0xe8));
+          EXPECT_THAT_EXPECTED(
+              readInt<int32_t>(G, Foo, E->getOffset()),
+              HasValue(static_cast<int32_t>(Bar.getAddress() -
+                                            (FixupAddress + 4))))
+              << "Relaxed call does not call bar";
+        }
+
+        // The jump through the GOT becomes 'jmp bar; nop'.
+        if (auto *E = getSingleRelocation(Foo_1)) {
+          verifyGOTLoad(G, *E, Bar);
+          JITTargetAddress FixupAddress = Foo_1.getAddress() + E->getOffset();
+          EXPECT_THAT_EXPECTED(readInt<uint8_t>(G, Foo_1, E->getOffset() - 2),
+                               HasValue(0xe9));
+          EXPECT_THAT_EXPECTED(
+              readInt<int32_t>(G, Foo_1, E->getOffset() - 1),
+              HasValue(static_cast<int32_t>(Bar.getAddress() -
+                                            (FixupAddress + 3))))
+              << "Relaxed jump does not jump to bar";
+          EXPECT_THAT_EXPECTED(readInt<uint8_t>(G, Foo_1, E->getOffset() + 3),
+                               HasValue(0x90));
+        }
+
+        // The test can not be relaxed, so it still reads the GOT entry.
+        if (auto *E = getSingleRelocation(Foo_2)) {
+          verifyGOTLoad(G, *E, Bar);
+          JITTargetAddress FixupAddress = Foo_2.getAddress() + E->getOffset();
+          EXPECT_THAT_EXPECTED(readInt<uint8_t>(G, Foo_2, E->getOffset() - 2),
+                               HasValue(0x85));
+          EXPECT_THAT_EXPECTED(
+              readInt<int32_t>(G, Foo_2, E->getOffset()),
+              HasValue(static_cast<int32_t>(E->getTarget().getAddress() -
+                                            (FixupAddress + 4))))
+              << "Unrelaxed load does not read the GOT entry";
+        }
+      });
+}
+
+TEST_F(JITLinkTest_ELF_x86_64, Aliases) {
+  runBasicVerifyGraphTest(
+      R"(
+            .text
+            .globl  foo
+            .p2align        4, 0x90
+            .type   foo,@function
+    foo:
+            movq    alias(%rip), %rax
+            retq
+
+            .data
+            .p2align        3
+            .type   x,@object
+    x:
+            .globl  alias
+    alias:
+            .quad   3)",
+      "x86_64-unknown-linux", {}, true, false, MCTargetOptions(),
+      [](AtomGraph &G, const MCDisassembler &Dis) {
+        auto &Foo = definedAtom(G, "foo");
+        auto &Alias = definedAtom(G, "alias");
+        auto &X = definedAtom(G, "x");
+
+        // One of x and alias owns the content, the other is an empty atom at
+        // the same address.
+        EXPECT_EQ(Alias.getAddress(), X.getAddress());
+        EXPECT_EQ(Alias.getSize() + X.getSize(), 8U);
+
+        if (auto *E = getSingleRelocation(Foo)) {
+          EXPECT_EQ(&E->getTarget(), &Alias);
+          JITTargetAddress FixupAddress = Foo.getAddress() + E->getOffset();
+          EXPECT_THAT_EXPECTED(
+              readInt<int32_t>(G, Foo, E->getOffset()),
+              HasValue(static_cast<int32_t>(Alias.getAddress() -
+                                            (FixupAddress + 4))));
+        }
+
+        // Address lookups find the atom that owns the content, even after
+        // the address map has been rebuilt.
+        G.invalidateAddrToAtomMap();
+        auto *Owner = G.getAtomByAddress(Alias.getAddress());
+        ASSERT_NE(Owner, nullptr);
+        EXPECT_EQ(Owner->getSize(), 8U);
+      });
+}
@@ -0,0 +1,116 @@
+//===- CallSequenceSpeculatorTest.cpp - Profile-driven speculation tests --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/Speculation.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class CallSequenceSpeculatorTest : public CoreAPIsBasedStandardTest {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createTemporaryFile("orc-speculation", "profile",
+                                              ProfilePath));
+  }
+
+  void TearDown() override { sys::fs::remove(ProfilePath); }
+
+  // Define Name in JD lazily, and track it as its own implementation so that
+  // the speculator can find it. Sets Materialized when it is compiled.
+  void defineLazy(SymbolStringPtr Name, JITEvaluatedSymbol Sym,
+                  bool &Materialized) {
+    SymbolFlagsMap Flags({{Name, Sym.getFlags()}});
+    cantFail(JD.define(std::make_unique<SimpleMaterializationUnit>(
+        Flags, [Name, Sym, &Materialized](MaterializationResponsibility R) {
+          Materialized = true;
+          R.notifyResolved({{Name, Sym}});
+          R.notifyEmitted();
+        })));
+    Imps.trackImpls({{Name, SymbolAliasMapEntry(Name, Sym.getFlags())}}, &JD);
+  }
+
+  SmallString<128> ProfilePath;
+  ImplSymbolMap Imps;
+};
+
+TEST_F(CallSequenceSpeculatorTest, ProfileRoundTrip) {
+  {
+    CallSequenceSpeculator S(Imps, ES, /*Lookahead=*/2);
+    S.notifyCallThrough(Foo);
+    S.notifyCallThrough(Bar);
+    S.notifyCallThrough(Baz);
+    S.notifyCallThrough(Qux);
+    // Repeated call throughs of the same function are only recorded once.
+    S.notifyCallThrough(Foo);
+    EXPECT_THAT_ERROR(S.writeProfile(ProfilePath), Succeeded());
+  }
+
+  auto Buffer = MemoryBuffer::getFile(ProfilePath);
+  ASSERT_TRUE(!!Buffer);
+  StringRef Contents = (*Buffer)->getBuffer();
+  EXPECT_TRUE(Contents.contains("foo\tbar\t1\n"));
+  EXPECT_TRUE(Contents.contains("foo\tbaz\t1\n"));
+  EXPECT_TRUE(Contents.contains("bar\tqux\t1\n"));
+  EXPECT_FALSE(Contents.contains("foo\tqux"))
+      << "Recorded a successor beyond the lookahead";
+
+  // Reading the profile back and writing it again accumulates the counts.
+  CallSequenceSpeculator S(Imps, ES, /*Lookahead=*/2);
+  EXPECT_THAT_ERROR(S.readProfile(ProfilePath), Succeeded());
+  S.notifyCallThrough(Foo);
+  S.notifyCallThrough(Bar);
+  EXPECT_THAT_ERROR(S.writeProfile(ProfilePath), Succeeded());
+  Buffer = MemoryBuffer::getFile(ProfilePath);
+  ASSERT_TRUE(!!Buffer);
+  EXPECT_TRUE((*Buffer)->getBuffer().contains("foo\tbar\t2\n"));
+}
+
+TEST_F(CallSequenceSpeculatorTest, CompilesLikelySuccessors) {
+  {
+    std::error_code EC;
+    raw_fd_ostream OS(ProfilePath, EC, sys::fs::OF_Text);
+    ASSERT_FALSE(EC);
+    OS << "foo\tbar\t10\n"
+       << "foo\tbaz\t1\n";
+  }
+
+  bool BarMaterialized = false;
+  bool BazMaterialized = false;
+  defineLazy(Bar, BarSym, BarMaterialized);
+  defineLazy(Baz, BazSym, BazMaterialized);
+
+  CallSequenceSpeculator S(Imps, ES, /*Lookahead=*/4, /*MaxCandidates=*/1);
+  EXPECT_THAT_ERROR(S.readProfile(ProfilePath), Succeeded());
+
+  // The default dispatcher materializes on the calling thread, so the
+  // speculative compile has finished by the time the notification returns.
+  S.notifyCallThrough(Foo);
+  EXPECT_TRUE(BarMaterialized) << "Likely successor was not compiled";
+  EXPECT_FALSE(BazMaterialized) << "Compiled more than MaxCandidates";
+}
+
+TEST_F(CallSequenceSpeculatorTest, MalformedProfile) {
+  {
+    std::error_code EC;
+    raw_fd_ostream OS(ProfilePath, EC, sys::fs::OF_Text);
+    ASSERT_FALSE(EC);
+    OS << "foo\tbar\n";
+  }
+
+  CallSequenceSpeculator S(Imps, ES);
+  EXPECT_THAT_ERROR(S.readProfile(ProfilePath), Failed());
+}
+
+} // namespace
@@ -0,0 +1,230 @@
+//===- MaterializationDispatcherTest.cpp - Unit tests for MU dispatchers --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/MaterializationDispatcher.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include <future>
+#include <map>
+#include <thread>
+#include <utility>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class PriorityMaterializationDispatcherTest
+    : public CoreAPIsBasedStandardTest {
+protected:
+  // Define Name in JD with a unit that runs Body and then emits Sym.
+  void define(SymbolStringPtr Name, JITEvaluatedSymbol Sym,
+              std::function<void()> Body) {
+    cantFail(JD.define(std::make_unique<SimpleMaterializationUnit>(
+        SymbolFlagsMap({{Name, Sym.getFlags()}}),
+        [=](MaterializationResponsibility R) {
+          Body();
+          R.notifyResolved({{Name, Sym}});
+          R.notifyEmitted();
+        })));
+  }
+
+  // Look up Name, which dispatches its unit, without waiting for it.
+  void lookupAsync(SymbolStringPtr Name) {
+    ES.lookup(JITDylibSearchList({{&JD, false}}), {Name}, SymbolState::Ready,
+              [](Expected<SymbolMap> Result) {
+                EXPECT_THAT_EXPECTED(Result, Succeeded());
+              },
+              NoDependenciesToRegister);
+  }
+};
+
+#if LLVM_ENABLE_THREADS
+
+TEST_F(PriorityMaterializationDispatcherTest, HighestPriorityFirst) {
+  std::map<SymbolStringPtr, int> Priorities = {
+      {Foo, 10}, {Bar, 0}, {Baz, 2}, {Qux, 1}};
+  PriorityMaterializationDispatcher::Options Opts;
+  Opts.NumThreads = 1;
+  Opts.GetPriority = [&](const JITDylib &, const MaterializationUnit &MU) {
+    return Priorities[MU.getSymbols().begin()->first];
+  };
+  PriorityMaterializationDispatcher D(std::move(Opts));
+  ES.setDispatchMaterialization(D.getDispatchFunction());
+
+  // Occupy the only thread with foo until the other units are dispatched.
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  std::vector<int> Order;
+  define(Foo, FooSym, [&, Released]() {
+    Released.wait();
+    Order.push_back(10);
+  });
+  define(Bar, BarSym, [&]() { Order.push_back(0); });
+  define(Baz, BazSym, [&]() { Order.push_back(2); });
+  define(Qux, QuxSym, [&]() { Order.push_back(1); });
+  for (SymbolStringPtr Name : {Foo, Bar, Baz, Qux})
+    lookupAsync(Name);
+
+  Release.set_value();
+  D.wait();
+  EXPECT_EQ(Order, std::vector<int>({10, 2, 1, 0}));
+  EXPECT_EQ(D.getStatistics().NumMaterialized, 4U);
+  EXPECT_EQ(D.getStatistics().QueueDepth, 0U);
+}
+
+TEST_F(PriorityMaterializationDispatcherTest, CancelledUnitIsHandedBack) {
+  PriorityMaterializationDispatcher::Options Opts;
+  Opts.NumThreads = 1;
+  Opts.GetPriority = [&](const JITDylib &, const MaterializationUnit &MU) {
+    return MU.getSymbols().count(Bar) ? 1 : 0;
+  };
+  // Cancel foo the first time it is picked up, after the failure of bar has
+  // failed the query that needed it.
+  bool CancelFoo = true;
+  Opts.IsCancelled = [&](const JITDylib &, const MaterializationUnit &MU) {
+    if (!MU.getSymbols().count(Foo))
+      return false;
+    return std::exchange(CancelFoo, false);
+  };
+  PriorityMaterializationDispatcher D(std::move(Opts));
+  ES.setDispatchMaterialization(D.getDispatchFunction());
+
+  // Occupy the only thread with baz until foo and bar are both queued.
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  define(Baz, BazSym, [Released]() { Released.wait(); });
+  lookupAsync(Baz);
+
+  int NumFooMaterialized = 0;
+  define(Foo, FooSym, [&]() { ++NumFooMaterialized; });
+  cantFail(JD.define(std::make_unique<SimpleMaterializationUnit>(
+      SymbolFlagsMap({{Bar, BarSym.getFlags()}}),
+      [](MaterializationResponsibility R) { R.failMaterialization(); })));
+
+  std::promise<bool> FirstLookupFailed;
+  ES.lookup(JITDylibSearchList({{&JD, false}}), {Foo, Bar}, SymbolState::Ready,
+            [&](Expected<SymbolMap> Result) {
+              FirstLookupFailed.set_value(!Result);
+              consumeError(Result.takeError());
+            },
+            NoDependenciesToRegister);
+  Release.set_value();
+  EXPECT_TRUE(FirstLookupFailed.get_future().get());
+  D.wait();
+  EXPECT_EQ(NumFooMaterialized, 0) << "Cancelled unit was materialized";
+  EXPECT_EQ(D.getStatistics().NumCancelled, 1U);
+
+  // foo is still defined, and a new lookup materializes it.
+  auto Result = ES.lookup(JITDylibSearchList({{&JD, false}}), Foo);
+  ASSERT_THAT_EXPECTED(Result, Succeeded());
+  EXPECT_EQ(Result->getAddress(), FooSym.getAddress());
+  EXPECT_EQ(NumFooMaterialized, 1);
+}
+
+TEST_F(PriorityMaterializationDispatcherTest, CancelledUnitWithQueriesRuns) {
+  PriorityMaterializationDispatcher::Options Opts;
+  Opts.IsCancelled = [](const JITDylib &, const MaterializationUnit &) {
+    return true;
+  };
+  PriorityMaterializationDispatcher D(std::move(Opts));
+  ES.setDispatchMaterialization(D.getDispatchFunction());
+
+  // Queries can't be withdrawn, so the lookup waiting on foo still gets it.
+  bool Materialized = false;
+  define(Foo, FooSym, [&]() { Materialized = true; });
+  EXPECT_THAT_EXPECTED(ES.lookup(JITDylibSearchList({{&JD, false}}), Foo),
+                       Succeeded());
+  D.wait();
+  EXPECT_TRUE(Materialized);
+  EXPECT_EQ(D.getStatistics().NumCancelled, 0U);
+  EXPECT_EQ(D.getStatistics().NumMaterialized, 1U);
+}
+
+TEST_F(PriorityMaterializationDispatcherTest, ExpiredUnitIsHandedBack) {
+  PriorityMaterializationDispatcher::Options Opts;
+  Opts.NumThreads = 1;
+  // Only the first dispatch of foo has a deadline, which has already passed.
+  bool FooExpired = true;
+  Opts.GetDeadline = [&](const JITDylib &, const MaterializationUnit &MU)
+      -> Optional<PriorityMaterializationDispatcher::Clock::time_point> {
+    if (!MU.getSymbols().count(Foo) || !std::exchange(FooExpired, false))
+      return None;
+    return PriorityMaterializationDispatcher::Clock::now() -
+           std::chrono::seconds(1);
+  };
+  Opts.GetPriority = [&](const JITDylib &, const MaterializationUnit &MU) {
+    return MU.getSymbols().count(Bar) ? 1 : 0;
+  };
+  PriorityMaterializationDispatcher D(std::move(Opts));
+  ES.setDispatchMaterialization(D.getDispatchFunction());
+
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  define(Baz, BazSym, [Released]() { Released.wait(); });
+  lookupAsync(Baz);
+
+  bool Materialized = false;
+  define(Foo, FooSym, [&]() { Materialized = true; });
+  cantFail(JD.define(std::make_unique<SimpleMaterializationUnit>(
+      SymbolFlagsMap({{Bar, BarSym.getFlags()}}),
+      [](MaterializationResponsibility R) { R.failMaterialization(); })));
+  ES.lookup(JITDylibSearchList({{&JD, false}}), {Foo, Bar}, SymbolState::Ready,
+            [](Expected<SymbolMap> Result) {
+              EXPECT_THAT_EXPECTED(Result, Failed());
+            },
+            NoDependenciesToRegister);
+  Release.set_value();
+  D.wait();
+  EXPECT_FALSE(Materialized) << "Expired unit was materialized";
+  EXPECT_EQ(D.getStatistics().NumExpired, 1U);
+
+  EXPECT_THAT_EXPECTED(ES.lookup(JITDylibSearchList({{&JD, false}}), Foo),
+                       Succeeded());
+  EXPECT_TRUE(Materialized);
+}
+
+TEST_F(PriorityMaterializationDispatcherTest, FullQueueRunsInline) {
+  PriorityMaterializationDispatcher::Options Opts;
+  Opts.NumThreads = 1;
+  Opts.MaxQueueDepth = 1;
+  PriorityMaterializationDispatcher D(std::move(Opts));
+  ES.setDispatchMaterialization(D.getDispatchFunction());
+
+  std::promise<void> Started, Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  define(Foo, FooSym, [&, Released]() {
+    Started.set_value();
+    Released.wait();
+  });
+  lookupAsync(Foo);
+  Started.get_future().wait();
+
+  // bar fills the queue, so baz has to be materialized right here.
+  std::thread::id BarThread, BazThread;
+  define(Bar, BarSym, [&]() { BarThread = std::this_thread::get_id(); });
+  define(Baz, BazSym, [&]() { BazThread = std::this_thread::get_id(); });
+  lookupAsync(Bar);
+  lookupAsync(Baz);
+  EXPECT_EQ(BazThread, std::this_thread::get_id());
+
+  Release.set_value();
+  D.wait();
+  EXPECT_NE(BarThread, std::this_thread::get_id());
+
+  auto Stats = D.getStatistics();
+  EXPECT_EQ(Stats.NumDispatched, 3U);
+  EXPECT_EQ(Stats.NumMaterializedInline, 1U);
+  EXPECT_EQ(Stats.MaxQueueDepth, 1U);
+}
+
+#endif
+
+} // namespace
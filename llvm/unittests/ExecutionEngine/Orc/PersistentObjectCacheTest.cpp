@@ -0,0 +1,100 @@
+//===- PersistentObjectCacheTest.cpp - Unit tests for the object cache ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class PersistentObjectCacheTest : public testing::Test,
+                                  public OrcExecutionTest {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("orc-object-cache", CacheDir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  // Build the same module on a fresh context each time, as a new process
+  // would.
+  std::unique_ptr<Module> createModule(LLVMContext &Ctx) {
+    ModuleBuilder MB(Ctx, TM->getTargetTriple().str(), "answer");
+    MB.getModule()->setDataLayout(TM->createDataLayout());
+    Function *F = MB.createFunctionDecl(
+        FunctionType::get(Type::getInt32Ty(Ctx), {}, false), "answer");
+    IRBuilder<> B(BasicBlock::Create(Ctx, "entry", F));
+    B.CreateRet(B.getInt32(42));
+    return MB.takeModule();
+  }
+
+  std::unique_ptr<PersistentObjectCache>
+  createCache(const JITTargetMachineBuilder &JTMB) {
+    auto Cache = PersistentObjectCache::Create(CacheDir, JTMB);
+    EXPECT_THAT_EXPECTED(Cache, Succeeded());
+    return Cache ? std::move(*Cache) : nullptr;
+  }
+
+  SmallString<128> CacheDir;
+};
+
+TEST_F(PersistentObjectCacheTest, ObjectsAreReusedAcrossCaches) {
+  if (!TM)
+    return;
+
+  JITTargetMachineBuilder JTMB(TM->getTargetTriple());
+  std::string FirstObj;
+  {
+    auto Cache = createCache(JTMB);
+    ASSERT_TRUE(Cache);
+    LLVMContext Ctx;
+    auto M = createModule(Ctx);
+    auto Obj = SimpleCompiler(*TM, Cache.get())(*M);
+    ASSERT_TRUE(Obj);
+    FirstObj = Obj->getBuffer();
+    EXPECT_EQ(Cache->getStatistics().NumMisses, 1U);
+    EXPECT_EQ(Cache->getStatistics().NumStored, 1U);
+  }
+
+  auto Cache = createCache(JTMB);
+  ASSERT_TRUE(Cache);
+  LLVMContext Ctx;
+  auto M = createModule(Ctx);
+  auto Obj = Cache->getObject(M.get());
+  ASSERT_TRUE(Obj) << "Object was not found in a new cache instance";
+  EXPECT_EQ(Obj->getBuffer(), FirstObj);
+  EXPECT_EQ(Cache->getStatistics().NumHits, 1U);
+}
+
+TEST_F(PersistentObjectCacheTest, TargetConfigurationIsPartOfTheKey) {
+  if (!TM)
+    return;
+
+  JITTargetMachineBuilder JTMB(TM->getTargetTriple());
+  auto Cache = createCache(JTMB);
+  ASSERT_TRUE(Cache);
+  LLVMContext Ctx;
+  auto M = createModule(Ctx);
+  ASSERT_TRUE(SimpleCompiler(*TM, Cache.get())(*M));
+
+  JTMB.setCodeGenOptLevel(CodeGenOpt::Aggressive);
+  auto OtherCache = createCache(JTMB);
+  ASSERT_TRUE(OtherCache);
+  EXPECT_FALSE(OtherCache->getObject(M.get()))
+      << "Object compiled for a different configuration was reused";
+  EXPECT_EQ(OtherCache->getStatistics().NumMisses, 1U);
+}
+
+} // namespace
@@ -0,0 +1,126 @@
+//===- SharedMemoryJITLinkMemoryManagerTest.cpp - Shared memory JIT tests -===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "QueueChannel.h"
+#include "llvm/ExecutionEngine/Orc/OrcABISupport.h"
+#include "llvm/ExecutionEngine/Orc/OrcRemoteTargetClient.h"
+#include "llvm/ExecutionEngine/Orc/OrcRemoteTargetServer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <thread>
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::orc;
+using namespace llvm::orc::remote;
+
+namespace {
+
+using TestServer = OrcRemoteTargetServer<rpc::RawByteChannel, OrcGenericABI>;
+
+class SharedMemoryJITLinkMemoryManagerTest : public testing::Test {
+protected:
+  void SetUp() override {
+    Channels = createPairedQueueChannels();
+    Server = std::make_unique<TestServer>(
+        *Channels.second,
+        [](const std::string &Name) -> JITTargetAddress { return 0; },
+        [](uint8_t *Addr, uint32_t Size) {},
+        [](uint8_t *Addr, uint32_t Size) {});
+    ServerThread = std::thread([this]() {
+      while (!Server->receivedTerminate())
+        cantFail(Server->handleOne());
+    });
+
+    auto C = OrcRemoteTargetClient::Create(*Channels.first, ES);
+    ASSERT_THAT_EXPECTED(C, Succeeded());
+    Client = std::move(*C);
+  }
+
+  void TearDown() override {
+    if (Client)
+      cantFail(Client->terminateSession());
+    ServerThread.join();
+  }
+
+  static JITLinkMemoryManager::SegmentsRequestMap
+  makeRequest(unsigned Prot, uint64_t ContentSize, uint64_t ZeroFillSize) {
+    JITLinkMemoryManager::SegmentsRequestMap Request;
+    Request[Prot] = JITLinkMemoryManager::SegmentRequest(ContentSize, 16,
+                                                         ZeroFillSize, 16);
+    return Request;
+  }
+
+  ExecutionSession ES;
+  std::pair<std::unique_ptr<QueueChannel>, std::unique_ptr<QueueChannel>>
+      Channels;
+  std::unique_ptr<TestServer> Server;
+  std::thread ServerThread;
+  std::unique_ptr<OrcRemoteTargetClient> Client;
+};
+
+TEST_F(SharedMemoryJITLinkMemoryManagerTest, ContentIsSharedWithRemote) {
+  auto MemMgr = Client->createSharedMemoryJITLinkMemoryManager(1 << 20);
+  ASSERT_THAT_EXPECTED(MemMgr, Succeeded());
+
+  const auto ReadOnly = sys::Memory::MF_READ;
+  auto Alloc = (*MemMgr)->allocate(makeRequest(ReadOnly, 16, 16));
+  ASSERT_THAT_EXPECTED(Alloc, Succeeded());
+
+  // The server runs in this process, so the target address is directly
+  // readable: it is the remote's view of the same pages.
+  auto WorkingMem = (*Alloc)->getWorkingMemory(ReadOnly);
+  ASSERT_GE(WorkingMem.size(), 32U);
+  strcpy(WorkingMem.data(), "shared memory");
+  const char *TargetMem = reinterpret_cast<const char *>(
+      static_cast<uintptr_t>((*Alloc)->getTargetMemory(ReadOnly)));
+  EXPECT_NE(TargetMem, WorkingMem.data())
+      << "Expected separate mappings for the client and the server";
+
+  bool Finalized = false;
+  (*Alloc)->finalizeAsync([&](Error Err) {
+    EXPECT_THAT_ERROR(std::move(Err), Succeeded());
+    Finalized = true;
+  });
+  EXPECT_TRUE(Finalized);
+  EXPECT_STREQ(TargetMem, "shared memory");
+  for (unsigned I = 16; I != 32; ++I)
+    EXPECT_EQ(TargetMem[I], 0) << "Zero-fill byte " << I << " is not zero";
+
+  EXPECT_THAT_ERROR((*Alloc)->deallocate(), Succeeded());
+}
+
+TEST_F(SharedMemoryJITLinkMemoryManagerTest, DeallocatedMemoryIsReused) {
+  auto MemMgr = Client->createSharedMemoryJITLinkMemoryManager(1 << 16);
+  ASSERT_THAT_EXPECTED(MemMgr, Succeeded());
+
+  const auto ReadWrite = static_cast<sys::Memory::ProtectionFlags>(
+      sys::Memory::MF_READ | sys::Memory::MF_WRITE);
+  auto Alloc = (*MemMgr)->allocate(makeRequest(ReadWrite, 1 << 16, 0));
+  ASSERT_THAT_EXPECTED(Alloc, Succeeded());
+  JITTargetAddress FirstAddr = (*Alloc)->getTargetMemory(ReadWrite);
+  memset((*Alloc)->getWorkingMemory(ReadWrite).data(), 0xff, 1 << 16);
+
+  EXPECT_THAT_EXPECTED((*MemMgr)->allocate(makeRequest(ReadWrite, 16, 0)),
+                       Failed())
+      << "Expected the arena to be exhausted";
+
+  EXPECT_THAT_ERROR((*Alloc)->deallocate(), Succeeded());
+
+  auto Reused = (*MemMgr)->allocate(makeRequest(ReadWrite, 16, 16));
+  ASSERT_THAT_EXPECTED(Reused, Succeeded());
+  EXPECT_EQ((*Reused)->getTargetMemory(ReadWrite), FirstAddr);
+  auto WorkingMem = (*Reused)->getWorkingMemory(ReadWrite);
+  for (unsigned I = 16; I != 32; ++I)
+    EXPECT_EQ(WorkingMem[I], 0) << "Reused zero-fill byte " << I
+                                << " is not zero";
+}
+
+} // end anonymous namespace
@@ -0,0 +1,80 @@
+//===- TieredCompilationTest.cpp - Unit tests for tiered compilation ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/TieredCompilation.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class TieredCompilationTest : public testing::Test, public OrcExecutionTest {};
+
+TEST_F(TieredCompilationTest, HotPartitionsAreReoptimized) {
+  if (!SupportsJIT || !SupportsIndirection)
+    return;
+
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    return;
+  }
+
+  // Poll by hand so that the test decides when to re-optimize.
+  TieredCompilationManager::Options Opts;
+  Opts.HotCallCount = 3;
+  Opts.PollInterval = std::chrono::milliseconds(0);
+  auto J = LLLazyJITBuilder()
+               .setJITTargetMachineBuilder(std::move(*JTMB))
+               .setTieredCompilation(Opts)
+               .create();
+  ASSERT_THAT_EXPECTED(J, Succeeded());
+  auto *TC = (*J)->getTieredCompilationManager();
+  ASSERT_NE(TC, nullptr);
+
+  ThreadSafeContext TSCtx(std::make_unique<LLVMContext>());
+  ModuleBuilder MB(*TSCtx.getContext(), TM->getTargetTriple().str(), "inc");
+  {
+    Type *Int32Ty = Type::getInt32Ty(*TSCtx.getContext());
+    Function *Inc = MB.createFunctionDecl(
+        FunctionType::get(Int32Ty, {Int32Ty}, false), "inc");
+    IRBuilder<> B(BasicBlock::Create(*TSCtx.getContext(), "entry", Inc));
+    B.CreateRet(B.CreateAdd(&*Inc->arg_begin(), B.getInt32(1)));
+  }
+  cantFail((*J)->addLazyIRModule(ThreadSafeModule(MB.takeModule(), TSCtx)));
+
+  auto IncSym = (*J)->lookup("inc");
+  ASSERT_THAT_EXPECTED(IncSym, Succeeded());
+  auto *IncFn = reinterpret_cast<int (*)(int)>(
+      static_cast<uintptr_t>(IncSym->getAddress()));
+
+  EXPECT_EQ(IncFn(1), 2);
+  EXPECT_EQ(IncFn(2), 3);
+  EXPECT_THAT_ERROR(TC->reoptimizeHotPartitions(), Succeeded());
+  EXPECT_EQ(TC->getStatistics().NumInstrumented, 1U);
+  EXPECT_EQ(TC->getStatistics().NumReoptimized, 0U)
+      << "Partition re-optimized before it was hot";
+
+  EXPECT_EQ(IncFn(3), 4);
+  EXPECT_THAT_ERROR(TC->reoptimizeHotPartitions(), Succeeded());
+  EXPECT_EQ(TC->getStatistics().NumReoptimized, 1U);
+  EXPECT_EQ(TC->getStatistics().NumFailed, 0U);
+
+  // The stub now leads to the optimized body, which must behave the same.
+  EXPECT_EQ(IncFn(41), 42);
+  EXPECT_THAT_ERROR(TC->reoptimizeHotPartitions(), Succeeded());
+  EXPECT_EQ(TC->getStatistics().NumReoptimized, 1U)
+      << "Partition re-optimized twice";
+}
+
+} // namespace
@@ -346,6 +346,46 @@ TEST(ConstantsTest, ConstantArrayReplaceWithConstant) {
   ASSERT_EQ(A01, RefArray->getInitializer());
 }
 
+TEST(ConstantsTest, DropTriviallyDeadConstantArrays) {
+  LLVMContext Context;
+  std::unique_ptr<Module> M(new Module("MyModule", Context));
+
+  Type *IntTy = Type::getInt8Ty(Context);
+  auto *Dead = new GlobalVariable(*M, IntTy, false,
+                                  GlobalValue::ExternalLinkage, nullptr);
+  auto *Live = new GlobalVariable(*M, IntTy, false,
+                                  GlobalValue::ExternalLinkage, nullptr);
+
+  // Arrays of arrays of a global, which only die one level at a time.
+  auto Nest = [](Constant *C, unsigned Depth) {
+    for (unsigned I = 0; I < Depth; ++I)
+      C = ConstantArray::get(ArrayType::get(C->getType(), 1), C);
+    return C;
+  };
+  Constant *DeadArray = Nest(Dead, 4);
+  Constant *LiveArray = Nest(Live, 4);
+  // An array used by both a dead and a live array stays.
+  Constant *SharedArray = Nest(Live, 2);
+  Constant *Pair[2] = {SharedArray, SharedArray};
+  Constant *DeadUser =
+      Nest(ConstantArray::get(ArrayType::get(SharedArray->getType(), 2), Pair),
+           1);
+  ASSERT_TRUE(isa<ConstantArray>(DeadArray));
+  ASSERT_TRUE(isa<ConstantArray>(DeadUser));
+
+  auto *Holder = new GlobalVariable(*M, DeadArray->getType(), false,
+                                    GlobalValue::ExternalLinkage, DeadArray);
+  new GlobalVariable(*M, LiveArray->getType(), false,
+                     GlobalValue::ExternalLinkage, LiveArray);
+  Holder->eraseFromParent();
+  ASSERT_FALSE(Dead->use_empty());
+
+  M->dropTriviallyDeadConstantArrays();
+  EXPECT_TRUE(Dead->use_empty());
+  EXPECT_FALSE(Live->use_empty());
+  EXPECT_FALSE(SharedArray->use_empty());
+}
+
 TEST(ConstantsTest, ConstantExprReplaceWithConstant) {
   LLVMContext Context;
   std::unique_ptr<Module> M(new Module("MyModule", Context));
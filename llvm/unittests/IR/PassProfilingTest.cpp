@@ -0,0 +1,113 @@
+//===- unittests/IR/PassProfilingTest.cpp - Pass profiling tests ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+using namespace llvm;
+
+namespace {
+
+// The profiles of all the tests go to the same records, so each test uses its
+// own passes.
+class OuterPass : public PassInfoMixin<OuterPass> {};
+class SkippedPass : public PassInfoMixin<SkippedPass> {};
+class ThreadPass1 : public PassInfoMixin<ThreadPass1> {};
+class ThreadPass2 : public PassInfoMixin<ThreadPass2> {};
+
+// Points -pass-profile-output at a temporary file during each test.
+class PassProfilingTest : public testing::Test {
+protected:
+  SmallString<128> Path;
+
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createTemporaryFile("pass-profile", "json", Path));
+    setOutput(Path);
+  }
+
+  void TearDown() override {
+    setOutput("");
+    sys::fs::remove(Path);
+  }
+
+  static void setOutput(StringRef Output) {
+    auto &Opts = cl::getRegisteredOptions();
+    static_cast<cl::opt<std::string> *>(Opts["pass-profile-output"])
+        ->setValue(Output.str());
+  }
+
+  std::string readOutput() {
+    auto Buf = MemoryBuffer::getFile(Path);
+    EXPECT_TRUE(bool(Buf));
+    return Buf ? (*Buf)->getBuffer().str() : std::string();
+  }
+};
+
+TEST_F(PassProfilingTest, SkippedPass) {
+  LLVMContext Context;
+  Module M("TestModule", Context);
+  {
+    PassInstrumentationCallbacks PIC;
+    PassInstrumentation PI(&PIC);
+    PassProfilingInstrumentation Profiling;
+    Profiling.registerCallbacks(PIC);
+    // Skip the second pass, as e.g. opt-bisect would.
+    PIC.registerBeforePassCallback(
+        [](StringRef P, Any) { return !P.contains("SkippedPass"); });
+
+    OuterPass Outer;
+    SkippedPass Skipped;
+    PI.runBeforePass(Outer, M);
+    EXPECT_FALSE(PI.runBeforePass(Skipped, M));
+    PI.runAfterPass(Outer, M);
+  }
+
+  // The outer pass is not confused with the skipped one.
+  std::string Output = readOutput();
+  EXPECT_NE(Output.find("OuterPass"), std::string::npos);
+  EXPECT_EQ(Output.find("SkippedPass"), std::string::npos);
+}
+
+TEST_F(PassProfilingTest, ConcurrentProfilers) {
+  auto RunPass = [](auto Pass) {
+    LLVMContext Context;
+    Module M("TestModule", Context);
+    PassInstrumentationCallbacks PIC;
+    PassInstrumentation PI(&PIC);
+    PassProfilingInstrumentation Profiling;
+    Profiling.registerCallbacks(PIC);
+    PI.runBeforePass(Pass, M);
+    PI.runAfterPass(Pass, M);
+  };
+  {
+    PassProfilingInstrumentation MainProfiling;
+    PassInstrumentationCallbacks MainPIC;
+    MainProfiling.registerCallbacks(MainPIC);
+    std::thread T1([&] { RunPass(ThreadPass1()); });
+    std::thread T2([&] { RunPass(ThreadPass2()); });
+    T1.join();
+    T2.join();
+  }
+
+  // The file written when the last profiler went away holds the runs of all
+  // the threads.
+  std::string Output = readOutput();
+  EXPECT_NE(Output.find("ThreadPass1"), std::string::npos);
+  EXPECT_NE(Output.find("ThreadPass2"), std::string::npos);
+  EXPECT_NE(Output.find("\"tid\":1"), std::string::npos);
+}
+
+} // end anonymous namespace
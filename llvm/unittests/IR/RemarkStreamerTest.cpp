@@ -0,0 +1,96 @@
+//===- unittests/IR/RemarkStreamerTest.cpp - Remark streamer tests --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/RemarkStreamer.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// Streams the remarks of a context as YAML to a string.
+class RemarkStreamerTest : public testing::Test {
+protected:
+  LLVMContext C;
+  Module M{"M", C};
+  Function *F;
+  std::string Output;
+  raw_string_ostream OS{Output};
+  RemarkStreamer *RS = nullptr;
+
+  void SetUp() override {
+    FunctionType *FTy = FunctionType::get(Type::getVoidTy(C), false);
+    F = Function::Create(FTy, Function::ExternalLinkage, "f", M);
+    Expected<std::unique_ptr<remarks::RemarkSerializer>> Serializer =
+        remarks::createRemarkSerializer(remarks::Format::YAML,
+                                        remarks::SerializerMode::Separate, OS);
+    ASSERT_THAT_EXPECTED(Serializer, Succeeded());
+    C.setRemarkStreamer(
+        std::make_unique<RemarkStreamer>("", std::move(*Serializer)));
+    RS = C.getRemarkStreamer();
+  }
+};
+
+TEST_F(RemarkStreamerTest, NoFilter) {
+  EXPECT_TRUE(RS->matchesFilter("inline"));
+  EXPECT_TRUE(RS->matchesFilter("licm"));
+}
+
+TEST_F(RemarkStreamerTest, Filter) {
+  ASSERT_THAT_ERROR(RS->setFilter("inline|gvn"), Succeeded());
+  // The second query of a pass name gives the result of the first one.
+  for (int I = 0; I < 2; ++I) {
+    EXPECT_TRUE(RS->matchesFilter("inline"));
+    EXPECT_TRUE(RS->matchesFilter("gvn"));
+    EXPECT_FALSE(RS->matchesFilter("licm"));
+  }
+
+  // A new filter replaces the results of the previous one.
+  ASSERT_THAT_ERROR(RS->setFilter("licm"), Succeeded());
+  EXPECT_FALSE(RS->matchesFilter("inline"));
+  EXPECT_TRUE(RS->matchesFilter("licm"));
+
+  EXPECT_THAT_ERROR(RS->setFilter("("), Failed());
+}
+
+TEST_F(RemarkStreamerTest, EmitFiltered) {
+  ASSERT_THAT_ERROR(RS->setFilter("inline"), Succeeded());
+  for (int I = 0; I < 2; ++I) {
+    RS->emit(OptimizationRemark("inline", "Inlined", F));
+    RS->emit(OptimizationRemark("licm", "Hoisted", F));
+  }
+  OS.flush();
+
+  SmallVector<StringRef, 32> Lines;
+  StringRef(Output).split(Lines, '\n');
+  size_t NumInlined = 0;
+  for (StringRef Line : Lines) {
+    if (!Line.startswith("Pass:"))
+      continue;
+    EXPECT_EQ(Line, "Pass:            inline");
+    ++NumInlined;
+  }
+  EXPECT_EQ(NumInlined, 2u);
+}
+
+TEST_F(RemarkStreamerTest, AllowExtraAnalysis) {
+  ASSERT_THAT_ERROR(RS->setFilter("inline"), Succeeded());
+  OptimizationRemarkEmitter ORE(F);
+  // Only the passes whose remarks go to the remark file need the extra
+  // analysis, as no remark is enabled on the diagnostic handler.
+  EXPECT_TRUE(ORE.allowExtraAnalysis("inline"));
+  EXPECT_FALSE(ORE.allowExtraAnalysis("licm"));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,137 @@
+//===- ThroughputEstimatorTest.cpp - Tests for mca::ThroughputEstimator ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/MCA/ThroughputEstimator.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+class ThroughputEstimatorTest : public testing::Test {
+protected:
+  void SetUp() override {
+    InitializeAllTargetInfos();
+    InitializeAllTargetMCs();
+
+    std::string Error;
+    const char *TripleName = "x86_64-unknown-unknown";
+    const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+    // The test needs the X86 target.
+    if (!T)
+      return;
+
+    MRI.reset(T->createMCRegInfo(TripleName));
+    MCII.reset(T->createMCInstrInfo());
+    STI.reset(T->createMCSubtargetInfo(TripleName, "btver2", ""));
+    MCIA.reset(T->createMCInstrAnalysis(MCII.get()));
+  }
+
+  bool hasTarget() const { return STI != nullptr; }
+
+  unsigned getOpcode(StringRef Name) const {
+    for (unsigned I = 0, E = MCII->getNumOpcodes(); I != E; ++I)
+      if (Name == MCII->getName(I))
+        return I;
+    llvm_unreachable("Unknown opcode");
+  }
+
+  unsigned getReg(StringRef Name) const {
+    for (unsigned I = 1, E = MRI->getNumRegs(); I != E; ++I)
+      if (Name == MRI->getName(I))
+        return I;
+    llvm_unreachable("Unknown register");
+  }
+
+  // Dst = Dst + Src.
+  MCInst add(StringRef Dst, StringRef Src) const {
+    MCInst Inst;
+    Inst.setOpcode(getOpcode("ADD32rr"));
+    Inst.addOperand(MCOperand::createReg(getReg(Dst)));
+    Inst.addOperand(MCOperand::createReg(getReg(Dst)));
+    Inst.addOperand(MCOperand::createReg(getReg(Src)));
+    return Inst;
+  }
+
+  std::unique_ptr<MCRegisterInfo> MRI;
+  std::unique_ptr<MCInstrInfo> MCII;
+  std::unique_ptr<MCSubtargetInfo> STI;
+  std::unique_ptr<MCInstrAnalysis> MCIA;
+};
+
+} // end anonymous namespace
+
+TEST_F(ThroughputEstimatorTest, DependencyChain) {
+  if (!hasTarget())
+    return;
+
+  mca::PipelineOptions PO(0, 0, 0, 0, 0, 0, true);
+  mca::ThroughputEstimator Estimator(*STI, *MCII, *MRI, MCIA.get(), PO, 100);
+
+  // Four adds into the same register, which have to run one after the other.
+  MCInst Chain[] = {add("EAX", "ECX"), add("EAX", "ECX"), add("EAX", "ECX"),
+                    add("EAX", "ECX")};
+  // Four adds into different registers, which the two ALUs of btver2 can run
+  // two at a time.
+  MCInst Parallel[] = {add("EAX", "ECX"), add("EBX", "ECX"),
+                       add("EDX", "ECX"), add("ESI", "ECX")};
+
+  Expected<mca::ThroughputEstimate> ChainEstimate = Estimator.estimate(Chain);
+  ASSERT_THAT_EXPECTED(ChainEstimate, Succeeded());
+  Expected<mca::ThroughputEstimate> ParallelEstimate =
+      Estimator.estimate(Parallel);
+  ASSERT_THAT_EXPECTED(ParallelEstimate, Succeeded());
+
+  EXPECT_EQ(ChainEstimate->Iterations, 100U);
+  EXPECT_EQ(ParallelEstimate->Iterations, 100U);
+  EXPECT_EQ(ChainEstimate->NumMicroOps, 4U);
+  EXPECT_EQ(ParallelEstimate->NumMicroOps, 4U);
+
+  // The static bound only looks at the resources, which both use alike.
+  EXPECT_EQ(ChainEstimate->BlockRThroughput,
+            ParallelEstimate->BlockRThroughput);
+  EXPECT_GE(ChainEstimate->getCyclesPerIteration(), 4.0);
+  EXPECT_LT(ParallelEstimate->getCyclesPerIteration(), 3.0);
+}
+
+TEST_F(ThroughputEstimatorTest, Memoization) {
+  if (!hasTarget())
+    return;
+
+  mca::PipelineOptions PO(0, 0, 0, 0, 0, 0, true);
+  mca::ThroughputEstimator Estimator(*STI, *MCII, *MRI, MCIA.get(), PO, 10);
+
+  MCInst Insts[] = {add("EAX", "ECX"), add("EAX", "EDX")};
+  Expected<mca::ThroughputEstimate> First = Estimator.estimate(Insts);
+  ASSERT_THAT_EXPECTED(First, Succeeded());
+
+  // The same sequence, in different MCInst objects, gets the same estimate.
+  MCInst Copy[] = {add("EAX", "ECX"), add("EAX", "EDX")};
+  Expected<mca::ThroughputEstimate> Second = Estimator.estimate(Copy);
+  ASSERT_THAT_EXPECTED(Second, Succeeded());
+  EXPECT_EQ(First->Iterations, Second->Iterations);
+  EXPECT_EQ(First->TotalCycles, Second->TotalCycles);
+  EXPECT_EQ(First->NumMicroOps, Second->NumMicroOps);
+  EXPECT_EQ(First->BlockRThroughput, Second->BlockRThroughput);
+
+  // A different operand is a different sequence.
+  MCInst Other[] = {add("EAX", "ECX"), add("EDX", "EAX")};
+  Expected<mca::ThroughputEstimate> Third = Estimator.estimate(Other);
+  ASSERT_THAT_EXPECTED(Third, Succeeded());
+  EXPECT_EQ(Third->NumMicroOps, 2U);
+
+  // Estimates computed again after clearing the cache match.
+  Estimator.clearCache();
+  Expected<mca::ThroughputEstimate> Fourth = Estimator.estimate(Insts);
+  ASSERT_THAT_EXPECTED(Fourth, Succeeded());
+  EXPECT_EQ(First->TotalCycles, Fourth->TotalCycles);
+}
@@ -228,7 +228,8 @@ struct CoverageMappingTest : ::testing::TestWithParam<std::pair<bool, bool>> {
     ProfileReader = std::move(ReaderOrErr.get());
   }
 
-  Expected<std::unique_ptr<CoverageMapping>> readOutputFunctions() {
+  Expected<std::unique_ptr<CoverageMapping>>
+  readOutputFunctions(unsigned NumThreads = 1) {
     std::vector<std::unique_ptr<CoverageMappingReader>> CoverageReaders;
     if (UseMultipleReaders) {
       for (const auto &OF : OutputFunctions) {
@@ -241,7 +242,7 @@ struct CoverageMappingTest : ::testing::TestWithParam<std::pair<bool, bool>> {
       CoverageReaders.push_back(
           std::make_unique<CoverageMappingReaderMock>(Funcs));
     }
-    return CoverageMapping::load(CoverageReaders, *ProfileReader);
+    return CoverageMapping::load(CoverageReaders, *ProfileReader, NumThreads);
   }
 
   Error loadCoverageMapping(bool EmitFilenames = true) {
@@ -888,6 +889,62 @@ TEST_P(CoverageMappingTest, skip_duplicate_function_record) {
   ASSERT_EQ(3U, NumFuncs);
 }
 
+TEST_P(CoverageMappingTest, load_with_threads_matches_serial_load) {
+  const unsigned N = 12;
+  for (unsigned I = 0; I < N; ++I) {
+    std::string Name = "func" + std::to_string(I);
+    ProfileWriter.addRecord({Name, 0x1234, {I}}, Err);
+    startFunction(Name, 0x1234);
+    addCMR(Counter::getCounter(0), "file" + std::to_string(I % 3), 1, 1, 9, 9);
+    addCMR(Counter::getCounter(0), "shared", I + 1, 1, I + 1, 9);
+  }
+  // A duplicate of func0, and a function whose regions are hash mismatches.
+  startFunction("func0", 0x1234);
+  addCMR(Counter::getCounter(0), "file0", 1, 1, 9, 9);
+  addCMR(Counter::getCounter(0), "shared", 1, 1, 1, 9);
+  ProfileWriter.addRecord({"stale", 0x1234, {1}}, Err);
+  startFunction("stale", 0x2345);
+  addCMR(Counter::getCounter(0), "file0", 1, 1, 9, 9);
+  EXPECT_THAT_ERROR(loadCoverageMapping(), Succeeded());
+
+  auto ThreadedOrErr = readOutputFunctions(/*NumThreads=*/4);
+  ASSERT_THAT_EXPECTED(ThreadedOrErr, Succeeded());
+  const CoverageMapping &Threaded = **ThreadedOrErr;
+
+  auto getNames = [](iterator_range<FunctionRecordIterator> Functions) {
+    std::vector<std::string> Names;
+    for (const auto &Function : Functions)
+      Names.push_back(Function.Name);
+    return Names;
+  };
+  std::vector<std::string> Names =
+      getNames(LoadedCoverage->getCoveredFunctions());
+  ASSERT_EQ(N, Names.size());
+  EXPECT_EQ(Names, getNames(Threaded.getCoveredFunctions()));
+  EXPECT_EQ(1U, Threaded.getMismatchedCount());
+
+  for (StringRef File : {"file0", "file1", "file2", "shared"}) {
+    std::vector<std::string> FileNames =
+        getNames(LoadedCoverage->getCoveredFunctions(File));
+    EXPECT_EQ(FileNames, getNames(Threaded.getCoveredFunctions(File)));
+    // Only the functions whose first file is File belong to it.
+    for (unsigned I = 0; I < N; ++I)
+      EXPECT_EQ(File == "file" + std::to_string(I % 3),
+                is_contained(FileNames, "func" + std::to_string(I)))
+          << File << " and func" << I;
+
+    CoverageData Serial = LoadedCoverage->getCoverageForFile(File);
+    CoverageData Parallel = Threaded.getCoverageForFile(File);
+    EXPECT_EQ(std::vector<CoverageSegment>(Serial.begin(), Serial.end()),
+              std::vector<CoverageSegment>(Parallel.begin(), Parallel.end()));
+  }
+
+  CoverageData Shared = Threaded.getCoverageForFile("shared");
+  std::vector<CoverageSegment> Segments(Shared.begin(), Shared.end());
+  ASSERT_EQ(2 * N, Segments.size());
+  EXPECT_EQ(CoverageSegment(3, 1, 2, true), Segments[4]);
+}
+
 // FIXME: Use ::testing::Combine() when llvm updates its copy of googletest.
 INSTANTIATE_TEST_CASE_P(ParameterizedCovMapTest, CoverageMappingTest,
                         ::testing::Values(std::pair<bool, bool>({false, false}),
@@ -13,6 +13,9 @@
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/ProfileData/InstrProfWriter.h"
 #include "llvm/Support/Compression.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Testing/Support/Error.h"
 #include "llvm/Testing/Support/SupportHelpers.h"
 #include "gtest/gtest.h"
@@ -219,6 +222,11 @@ TEST_F(InstrProfTest, test_writer_merge) {
   ASSERT_EQ(2U, R->Counts.size());
   ASSERT_EQ(0U, R->Counts[0]);
   ASSERT_EQ(0U, R->Counts[1]);
+
+  // The records were moved out of Writer2.
+  readProfile(Writer2.writeBuffer());
+  R = Reader->getInstrProfRecord("func2", 0x1234);
+  ASSERT_TRUE(ErrorEquals(instrprof_error::unknown_function, R.takeError()));
 }
 
 static const char callee1[] = "callee1";
@@ -1041,6 +1049,54 @@ TEST_F(SparseInstrProfTest, preserve_no_records) {
   ASSERT_TRUE(I == E);
 }
 
+static void writeProfileFile(InstrProfWriter &Writer, StringRef Path) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_None);
+  ASSERT_FALSE(EC);
+  Writer.write(OS);
+}
+
+TEST(IndexedInstrProfReaderTest, shared_file_mapping) {
+  SmallString<128> Dir, Path, NewPath;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("instrprof-shared", Dir));
+  sys::path::append(Path, Dir, "default.profdata");
+  sys::path::append(NewPath, Dir, "new.profdata");
+
+  InstrProfWriter Writer;
+  Writer.addRecord({"foo", 0x1234, {1, 2}}, Err);
+  writeProfileFile(Writer, Path);
+
+  auto Reader1 = IndexedInstrProfReader::create(Path);
+  ASSERT_THAT_EXPECTED(Reader1, Succeeded());
+  auto Reader2 = IndexedInstrProfReader::create(Path);
+  ASSERT_THAT_EXPECTED(Reader2, Succeeded());
+  EXPECT_THAT_EXPECTED((*Reader1)->getInstrProfRecord("foo", 0x1234),
+                       Succeeded());
+  EXPECT_THAT_EXPECTED((*Reader2)->getInstrProfRecord("foo", 0x1234),
+                       Succeeded());
+
+  // Replacing the file while it is mapped must not hand out the old mapping.
+  InstrProfWriter NewWriter;
+  NewWriter.addRecord({"bar", 0x1234, {3}}, Err);
+  writeProfileFile(NewWriter, NewPath);
+  ASSERT_FALSE(sys::fs::rename(NewPath, Path));
+  auto Reader3 = IndexedInstrProfReader::create(Path);
+  ASSERT_THAT_EXPECTED(Reader3, Succeeded());
+  EXPECT_TRUE(ErrorEquals(instrprof_error::unknown_function,
+                          (*Reader3)->getInstrProfRecord("foo", 0x1234)
+                              .takeError()));
+  EXPECT_THAT_EXPECTED((*Reader3)->getInstrProfRecord("bar", 0x1234),
+                       Succeeded());
+  EXPECT_THAT_EXPECTED((*Reader1)->getInstrProfRecord("foo", 0x1234),
+                       Succeeded());
+
+  Reader1->reset();
+  Reader2->reset();
+  Reader3->reset();
+  ASSERT_FALSE(sys::fs::remove(Path));
+  ASSERT_FALSE(sys::fs::remove(Dir));
+}
+
 INSTANTIATE_TEST_CASE_P(MaybeSparse, MaybeSparseInstrProfTest,
                         ::testing::Bool(),);
 
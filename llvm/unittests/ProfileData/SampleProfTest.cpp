@@ -285,6 +285,44 @@ TEST_F(SampleProfTest, roundtrip_compact_binary_profile) {
   testRoundTrip(SampleProfileFormat::SPF_Compact_Binary, false);
 }
 
+TEST_F(SampleProfTest, compact_binary_profile_reads_module_functions) {
+  SmallVector<char, 128> ProfilePath;
+  ASSERT_TRUE(NoError(
+      llvm::sys::fs::createTemporaryFile("profile", "", ProfilePath)));
+  StringRef Profile(ProfilePath.data(), ProfilePath.size());
+  createWriter(SampleProfileFormat::SPF_Compact_Binary, Profile);
+
+  // Only the functions of the module are decoded, out of many.
+  StringMap<FunctionSamples> Profiles;
+  for (unsigned I = 0; I < 100; ++I) {
+    std::string Name = "func" + std::to_string(I);
+    FunctionSamples &Samples = Profiles[Name];
+    Samples.setName(Profiles.find(Name)->getKey());
+    Samples.addTotalSamples(I + 1);
+    Samples.addHeadSamples(1);
+    Samples.addBodySamples(1, 0, I + 1);
+  }
+  ASSERT_TRUE(NoError(Writer->write(Profiles)));
+  Writer->getOutputStream().flush();
+
+  Module M("my_module", Context);
+  FunctionType *FnType = FunctionType::get(Type::getVoidTy(Context), {}, false);
+  M.getOrInsertFunction("func7", FnType);
+  M.getOrInsertFunction("func42", FnType);
+  M.getOrInsertFunction("not_in_profile", FnType);
+  readProfile(M, Profile);
+  ASSERT_TRUE(NoError(Reader->read()));
+
+  ASSERT_EQ(2u, Reader->getProfiles().size());
+  FunctionSamples *Samples = Reader->getSamplesFor("func7");
+  ASSERT_TRUE(Samples != nullptr);
+  ASSERT_EQ(8u, Samples->getTotalSamples());
+  Samples = Reader->getSamplesFor("func42");
+  ASSERT_TRUE(Samples != nullptr);
+  ASSERT_EQ(43u, Samples->getTotalSamples());
+  ASSERT_TRUE(Reader->getSamplesFor("func8") == nullptr);
+}
+
 TEST_F(SampleProfTest, remap_text_profile) {
   testRoundTrip(SampleProfileFormat::SPF_Text, true);
 }
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
 
@@ -184,4 +185,87 @@ TEST(AllocatorTest, TestBigAlignment) {
   EXPECT_GT(MockSlabAllocator::GetLastSlabSize(), 4096u);
 }
 
+// Test that slabs allocated after enableHugePages() bypass the underlying
+// allocator and are at least 2 MiB.
+TEST(AllocatorTest, TestHugePages) {
+  BumpPtrAllocatorImpl<MockSlabAllocator> Alloc;
+  Alloc.Allocate(4000, 1);
+  EXPECT_EQ(4096u, MockSlabAllocator::GetLastSlabSize());
+
+  Alloc.enableHugePages();
+  // The first slab has no room left, so this starts a huge page slab.
+  void *P = Alloc.Allocate(4000, 1);
+  memset(P, 0, 4000);
+  EXPECT_EQ(2u, Alloc.GetNumSlabs());
+  EXPECT_EQ(4096u + 2 * 1024 * 1024, Alloc.getTotalMemory());
+  EXPECT_EQ(4096u, MockSlabAllocator::GetLastSlabSize());
+
+  // Objects bigger than a slab still use the underlying allocator.
+  Alloc.Allocate(4 * 1024 * 1024, 1);
+  EXPECT_EQ(4u * 1024 * 1024, MockSlabAllocator::GetLastSlabSize());
+
+  Alloc.Reset();
+  EXPECT_EQ(1u, Alloc.GetNumSlabs());
+  Alloc.Allocate(4000, 1);
+  Alloc.Allocate(4000, 1);
+  EXPECT_EQ(2u, Alloc.GetNumSlabs());
+  EXPECT_EQ(4096u + 2 * 1024 * 1024, Alloc.getTotalMemory());
+}
+
+TEST(AllocatorTest, TestStats) {
+  enableAllocatorStats();
+  {
+    BumpPtrAllocator Alloc;
+    Alloc.setName("AllocatorTest.TestStats");
+    // Two slabs, the first of which has 96 unused bytes at the end.
+    Alloc.Allocate(4000, 1);
+    Alloc.Allocate(4000, 1);
+    // A custom-sized slab.
+    Alloc.Allocate(10000, 1);
+
+    std::string S;
+    raw_string_ostream OS(S);
+    printAllocatorStats(OS);
+    EXPECT_NE(std::string::npos,
+              OS.str().find("        18192          18192        3            96  "
+                            "AllocatorTest.TestStats\n"));
+  }
+
+  // Freed slabs are no longer counted as current.
+  std::string S;
+  raw_string_ostream OS(S);
+  printAllocatorStats(OS);
+  EXPECT_NE(std::string::npos,
+            OS.str().find("        18192              0        3            96  "
+                          "AllocatorTest.TestStats\n"));
+}
+
+#if defined(__GNUC__)
+// Allocates a new slab every time, so that each call records a site.
+LLVM_ATTRIBUTE_NOINLINE void allocateSlab(BumpPtrAllocator &Alloc) {
+  Alloc.Allocate(4000, 1);
+}
+
+// A site is the code that allocates from the allocator, not its callers.
+TEST(AllocatorTest, TestStatsSites) {
+  enableAllocatorStats();
+  BumpPtrAllocator Alloc;
+  Alloc.setName("AllocatorTest.TestStatsSites");
+  allocateSlab(Alloc);
+  allocateSlab(Alloc);
+
+  std::string S;
+  raw_string_ostream OS(S);
+  printAllocatorStats(OS);
+  StringRef Stats = OS.str();
+  size_t Pos = Stats.find("AllocatorTest.TestStatsSites\n");
+  ASSERT_NE(StringRef::npos, Pos);
+  SmallVector<StringRef, 4> Lines;
+  Stats.substr(Pos).split(Lines, '\n');
+  ASSERT_LE(3u, Lines.size());
+  EXPECT_TRUE(Lines[1].startswith("         8192  from "));
+  EXPECT_FALSE(Lines[2].contains(" from "));
+}
+#endif
+
 }  // anonymous namespace
@@ -71,6 +71,80 @@ TEST(CompressionTest, ZlibCRC32) {
       zlib::crc32(StringRef("The quick brown fox jumps over the lazy dog")));
 }
 
+TEST(CompressionTest, ZlibRawShards) {
+  std::string Input;
+  for (int I = 0; I < 5000; ++I)
+    Input += "shard " + std::to_string(I % 37) + " ";
+  StringRef InputStr = Input;
+
+  // Compress three pieces independently and concatenate them into a single
+  // zlib stream with a header and a combined checksum.
+  size_t Cuts[] = {0, InputStr.size() / 3, InputStr.size() / 2,
+                   InputStr.size()};
+  SmallString<32> Compressed;
+  Compressed.push_back(0x78);
+  Compressed.push_back(0x01);
+  uint32_t Checksum = zlib::adler32("");
+  for (int I = 0; I < 3; ++I) {
+    StringRef Piece = InputStr.slice(Cuts[I], Cuts[I + 1]);
+    SmallString<32> Shard;
+    Error E = zlib::compressRaw(Piece, Shard, zlib::BestSpeedCompression,
+                                /*IsLast=*/I == 2);
+    EXPECT_FALSE(E);
+    consumeError(std::move(E));
+    Compressed += Shard;
+    Checksum = zlib::adler32Combine(Checksum, zlib::adler32(Piece),
+                                    Piece.size());
+  }
+  EXPECT_EQ(zlib::adler32(InputStr), Checksum);
+  for (int Shift = 24; Shift >= 0; Shift -= 8)
+    Compressed.push_back((Checksum >> Shift) & 0xff);
+
+  SmallString<32> Uncompressed;
+  Error E = zlib::uncompress(Compressed, Uncompressed, InputStr.size());
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  EXPECT_EQ(InputStr, Uncompressed);
+}
+
+// Stored blocks make the size of a sync-flushed shard predictable, so that
+// some of these sizes fill the output buffer exactly before the flush is done.
+TEST(CompressionTest, ZlibRawShardSizes) {
+  std::string Input;
+  uint32_t Seed = 1;
+  for (int I = 0; I < 300; ++I) {
+    Seed = Seed * 1103515245 + 12345;
+    Input.push_back(Seed >> 24);
+  }
+  StringRef InputStr = Input;
+
+  for (size_t Size = 0; Size <= InputStr.size(); ++Size) {
+    StringRef Piece = InputStr.take_front(Size);
+    SmallString<32> Shard;
+    Error E = zlib::compressRaw(Piece, Shard, zlib::NoCompression,
+                                /*IsLast=*/false);
+    EXPECT_FALSE(E) << "size " << Size;
+    consumeError(std::move(E));
+    SmallString<32> Last;
+    E = zlib::compressRaw("", Last, zlib::NoCompression, /*IsLast=*/true);
+    EXPECT_FALSE(E);
+    consumeError(std::move(E));
+
+    SmallString<32> Stream("\x78\x01");
+    Stream += Shard;
+    Stream += Last;
+    uint32_t Checksum = zlib::adler32(Piece);
+    for (int Shift = 24; Shift >= 0; Shift -= 8)
+      Stream.push_back((Checksum >> Shift) & 0xff);
+
+    SmallString<32> Uncompressed;
+    E = zlib::uncompress(Stream, Uncompressed, Piece.size());
+    EXPECT_FALSE(E) << "size " << Size;
+    consumeError(std::move(E));
+    EXPECT_EQ(Piece, Uncompressed);
+  }
+}
+
 #endif
 
 }
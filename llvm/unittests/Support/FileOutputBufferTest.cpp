@@ -118,6 +118,38 @@ TEST(FileOutputBuffer, Test) {
   EXPECT_TRUE(IsExecutable);
   ASSERT_NO_ERROR(fs::remove(File4.str()));
 
+  // TEST 5: Verify that a buffer created without mmap replaces an existing
+  // file only when committed.
+  SmallString<128> File5(TestDirectory);
+  File5.append("/file5");
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File5, 8192);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    memset(Buffer->getBufferStart(), 'a', 8192);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File5, 4096, FileOutputBuffer::F_no_mmap);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    memset(Buffer->getBufferStart(), 'b', 4096);
+    // Verify the existing file is untouched before commit.
+    uint64_t File5Size;
+    ASSERT_NO_ERROR(fs::file_size(Twine(File5), File5Size));
+    ASSERT_EQ(File5Size, 8192ULL);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+  {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        MemoryBuffer::getFile(File5);
+    ASSERT_NO_ERROR(MBOrErr.getError());
+    ASSERT_EQ((*MBOrErr)->getBuffer(), std::string(4096, 'b'));
+  }
+  ASSERT_NO_ERROR(fs::remove(File5.str()));
+
   // Clean up.
   ASSERT_NO_ERROR(fs::remove(TestDirectory.str()));
 }
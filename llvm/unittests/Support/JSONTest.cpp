@@ -422,6 +422,18 @@ TEST(JSONTest, Stream) {
   EXPECT_EQ(Pretty, StreamStuff(2));
 }
 
+TEST(JSONTest, StreamRawValue) {
+  std::string S;
+  llvm::raw_string_ostream OS(S);
+  OStream J(OS);
+  J.array([&] {
+    J.value(1);
+    J.rawValue(StringRef(R"({"pre":"serialized"})"));
+    J.rawValue([](raw_ostream &OS) { OS << "[2,3]"; });
+  });
+  EXPECT_EQ(R"([1,{"pre":"serialized"},[2,3]])", OS.str());
+}
+
 } // namespace
 } // namespace json
 } // namespace llvm
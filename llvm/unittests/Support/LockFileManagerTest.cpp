@@ -43,6 +43,29 @@ TEST(LockFileManagerTest, Basic) {
   ASSERT_FALSE(EC);
 }
 
+TEST(LockFileManagerTest, WaitForUnlockTimeout) {
+  SmallString<64> TmpDir;
+  std::error_code EC;
+  EC = sys::fs::createUniqueDirectory("LockFileManagerTestDir", TmpDir);
+  ASSERT_FALSE(EC);
+
+  SmallString<64> LockedFile(TmpDir);
+  sys::path::append(LockedFile, "file");
+
+  {
+    LockFileManager Locked1(LockedFile);
+    EXPECT_EQ(LockFileManager::LFS_Owned, Locked1.getState());
+
+    // The owner is alive and keeps the lock, so waiting times out.
+    LockFileManager Locked2(LockedFile);
+    ASSERT_EQ(LockFileManager::LFS_Shared, Locked2.getState());
+    EXPECT_EQ(LockFileManager::Res_Timeout, Locked2.waitForUnlock(1));
+  }
+
+  EC = sys::fs::remove(StringRef(TmpDir));
+  ASSERT_FALSE(EC);
+}
+
 TEST(LockFileManagerTest, LinkLockExists) {
   SmallString<64> TmpDir;
   std::error_code EC;
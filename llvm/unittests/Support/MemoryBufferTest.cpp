@@ -14,6 +14,7 @@
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
@@ -339,4 +340,47 @@ TEST_F(MemoryBufferTest, writeThroughFile) {
   ASSERT_EQ(16u, MB.getBufferSize());
   EXPECT_EQ("xxxxxxxxxxxxxxxx", MB.getBuffer());
 }
+
+TEST_F(MemoryBufferTest, getFilesAsync) {
+  // One small file, one file that is big enough to be mapped, and one file
+  // that doesn't exist.
+  SmallString<64> SmallPath, BigPath;
+  int FD;
+  sys::fs::createTemporaryFile("MemoryBufferTest_GetFilesAsync", "temp", FD,
+                               SmallPath);
+  FileRemover SmallCleanup(SmallPath);
+  {
+    raw_fd_ostream OF(FD, true);
+    OF << "0123456789abcdef";
+  }
+  sys::fs::createTemporaryFile("MemoryBufferTest_GetFilesAsync", "temp", FD,
+                               BigPath);
+  FileRemover BigCleanup(BigPath);
+  {
+    raw_fd_ostream OF(FD, true);
+    for (unsigned i = 0; i < 64 * 1024 / 16; ++i)
+      OF << "0123456789abcdef";
+  }
+  std::string MissingPath = (SmallPath + ".missing").str();
+
+  ThreadPool Pool;
+  std::vector<std::string> Paths = {SmallPath.str(), BigPath.str(),
+                                    MissingPath};
+  auto Futures = MemoryBuffer::getFilesAsync(Pool, Paths);
+  ASSERT_EQ(3u, Futures.size());
+
+  ErrorOr<OwningBuffer> Small = Futures[0].get();
+  ASSERT_FALSE(Small.getError());
+  EXPECT_EQ("0123456789abcdef", (*Small)->getBuffer());
+  EXPECT_EQ(SmallPath, (*Small)->getBufferIdentifier());
+
+  ErrorOr<OwningBuffer> Big = Futures[1].get();
+  ASSERT_FALSE(Big.getError());
+  EXPECT_EQ(64u * 1024, (*Big)->getBufferSize());
+  EXPECT_EQ('f', (*Big)->getBufferStart()[64 * 1024 - 1]);
+  EXPECT_EQ('\0', (*Big)->getBufferStart()[64 * 1024]);
+
+  ErrorOr<OwningBuffer> Missing = Futures[2].get();
+  EXPECT_EQ(std::errc::no_such_file_or_directory, Missing.getError());
+}
 }
@@ -14,7 +14,13 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
 #include <random>
+#include <string>
+#include <vector>
 
 uint32_t array[1024 * 1024];
 
@@ -49,4 +55,118 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, nested_parallel_for) {
+  // Nested loops spawn more tasks than there are threads, and the threads
+  // running the outer loop must not block the inner loops.
+  std::atomic<uint32_t> count(0);
+  for_each_n(parallel::par, 0, 64, [&](size_t) {
+    for_each_n(parallel::par, 0, 1024, [&](size_t) { ++count; });
+  });
+  ASSERT_EQ(count, 64u * 1024u);
+}
+
+TEST(Parallel, stable_sort) {
+  // Sort by the key in the upper bits and check that elements with the same
+  // key keep their original order, which is stored in the lower bits.
+  std::mt19937 randEngine;
+  std::uniform_int_distribution<uint32_t> dist(0, 255);
+  std::vector<uint32_t> v(100000);
+  for (size_t I = 0; I != v.size(); ++I)
+    v[I] = (dist(randEngine) << 24) | I;
+
+  auto less = [](uint32_t A, uint32_t B) { return (A >> 24) < (B >> 24); };
+  stable_sort(parallel::par, v.begin(), v.end(), less);
+  ASSERT_TRUE(std::is_sorted(v.begin(), v.end()));
+}
+
+TEST(Parallel, for_each_chunk) {
+  std::vector<uint32_t> v(5000, 1);
+  std::atomic<uint32_t> numChunks(0);
+  for_each_chunk(parallel::par, v.begin(), v.end(), 100,
+                 [&](std::vector<uint32_t>::iterator B,
+                     std::vector<uint32_t>::iterator E) {
+                   EXPECT_GE(E - B, 100);
+                   for (; B != E; ++B)
+                     ++*B;
+                   ++numChunks;
+                 });
+  ASSERT_EQ(numChunks, 50u);
+  ASSERT_TRUE(
+      std::all_of(v.begin(), v.end(), [](uint32_t X) { return X == 2; }));
+}
+
+// Returns the (offset, size) of the chunks for_each_chunk passes to Fn, in
+// order.
+static std::vector<std::pair<size_t, size_t>> getChunks(size_t N,
+                                                        size_t GrainSize) {
+  std::vector<uint32_t> v(N, 1);
+  std::mutex M;
+  std::vector<std::pair<size_t, size_t>> chunks;
+  for_each_chunk(parallel::par, v.begin(), v.end(), GrainSize,
+                 [&](std::vector<uint32_t>::iterator B,
+                     std::vector<uint32_t>::iterator E) {
+                   std::lock_guard<std::mutex> Lock(M);
+                   chunks.emplace_back(B - v.begin(), E - B);
+                 });
+  std::sort(chunks.begin(), chunks.end());
+  return chunks;
+}
+
+TEST(Parallel, for_each_chunk_uneven) {
+  // The last chunk holds the remaining elements, even if they are fewer than
+  // the grain size.
+  auto chunks = getChunks(5050, 100);
+  ASSERT_EQ(chunks.size(), 51u);
+  for (size_t I = 0; I != 50; ++I)
+    EXPECT_EQ(chunks[I], std::make_pair(I * 100, size_t(100)));
+  EXPECT_EQ(chunks.back(), std::make_pair(size_t(5000), size_t(50)));
+
+  // A range smaller than the grain size is a single chunk.
+  chunks = getChunks(42, 100);
+  ASSERT_EQ(chunks.size(), 1u);
+  EXPECT_EQ(chunks[0], std::make_pair(size_t(0), size_t(42)));
+
+  // No chunk for an empty range.
+  EXPECT_TRUE(getChunks(0, 100).empty());
+
+  // Small grain sizes are raised so that there are at most 1024 chunks.
+  chunks = getChunks(300001, 1);
+  ASSERT_EQ(chunks.size(), 1024u);
+  size_t offset = 0;
+  for (auto &chunk : chunks) {
+    EXPECT_EQ(chunk.first, offset);
+    offset += chunk.second;
+  }
+  EXPECT_EQ(offset, 300001u);
+  EXPECT_EQ(chunks[0].second, 293u);
+  EXPECT_EQ(chunks.back().second, 300001u - 1023u * 293u);
+}
+
+TEST(Parallel, transform_reduce) {
+  std::vector<uint64_t> v(10000);
+  std::iota(v.begin(), v.end(), 0);
+  uint64_t sum = transform_reduce(
+      parallel::par, v.begin(), v.end(), uint64_t(0), std::plus<uint64_t>(),
+      [](uint64_t X) { return X * 2; });
+  ASSERT_EQ(sum, 9999u * 10000u);
+
+  // Partial results must be combined in order.
+  std::vector<std::string> strs(3000, "a");
+  strs[0] = "b";
+  strs.back() = "c";
+  std::string str = transform_reduce(
+      parallel::par, strs.begin(), strs.end(), std::string(),
+      [](std::string A, std::string B) { return A + B; },
+      [](const std::string &S) { return S; });
+  ASSERT_EQ(str, "b" + std::string(2998, 'a') + "c");
+}
+
+TEST(Parallel, exclusive_scan) {
+  std::vector<uint32_t> v(100000, 3);
+  auto end = exclusive_scan(parallel::par, v.begin(), v.end(), v.begin(), 1u);
+  ASSERT_EQ(end, v.end());
+  for (size_t I = 0; I != v.size(); ++I)
+    ASSERT_EQ(v[I], 1 + 3 * I);
+}
+
 #endif
@@ -0,0 +1,67 @@
+//===- llvm/unittest/Support/StringSaverTest.cpp - StringSaver tests ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/Parallel.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentUniqueStringSaverTest, Save) {
+  ConcurrentUniqueStringSaver Saver;
+  std::string Foo = "foo";
+  StringRef S1 = Saver.save(Foo);
+  StringRef S2 = Saver.save(StringRef("foo"));
+  StringRef S3 = Saver.save("bar");
+  EXPECT_EQ("foo", S1);
+  EXPECT_EQ(S1.data(), S2.data());
+  EXPECT_NE(Foo.data(), S1.data());
+  EXPECT_EQ("bar", S3);
+  EXPECT_EQ('\0', *S1.end());
+  EXPECT_EQ("", Saver.save(""));
+}
+
+TEST(ConcurrentUniqueStringSaverTest, BulkSave) {
+  ConcurrentUniqueStringSaver Saver(4);
+  StringRef Foo = Saver.save("foo");
+
+  std::vector<std::string> Storage;
+  for (unsigned I = 0; I < 100; ++I)
+    Storage.push_back("str" + std::to_string(I % 10));
+  Storage.push_back("foo");
+
+  std::vector<StringRef> Strings(Storage.begin(), Storage.end());
+  Saver.save(Strings);
+  for (size_t I = 0, E = Strings.size(); I != E; ++I) {
+    EXPECT_EQ(Storage[I], Strings[I]);
+    EXPECT_NE(Storage[I].data(), Strings[I].data());
+    EXPECT_EQ(Saver.save(Storage[I]).data(), Strings[I].data());
+  }
+  EXPECT_EQ(Foo.data(), Strings.back().data());
+}
+
+TEST(ConcurrentUniqueStringSaverTest, Threads) {
+  ConcurrentUniqueStringSaver Saver;
+  std::vector<std::string> Storage;
+  for (unsigned I = 0; I < 4096; ++I)
+    Storage.push_back("str" + std::to_string(I % 256));
+
+  std::vector<StringRef> Saved(Storage.size());
+  parallel::for_each_n(parallel::par, size_t(0), Storage.size(),
+                       [&](size_t I) { Saved[I] = Saver.save(Storage[I]); });
+  for (size_t I = 0, E = Storage.size(); I != E; ++I) {
+    EXPECT_EQ(Storage[I], Saved[I]);
+    EXPECT_EQ(Saved[I % 256].data(), Saved[I].data());
+  }
+}
+
+} // end anonymous namespace
@@ -18,6 +18,7 @@
 #include "gtest/gtest.h"
 #include <map>
 #include <string>
+#include <thread>
 
 using namespace llvm;
 using llvm::sys::fs::UniqueID;
@@ -916,6 +917,130 @@ TEST(ProxyFileSystemTest, Basic) {
   EXPECT_FALSE(Local);
 }
 
+namespace {
+/// Counts the calls that reach the underlying file system.
+class CountingFileSystem : public vfs::ProxyFileSystem {
+public:
+  CountingFileSystem(IntrusiveRefCntPtr<vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  ErrorOr<vfs::Status> status(const Twine &Path) override {
+    ++Stats;
+    return ProxyFileSystem::status(Path);
+  }
+  ErrorOr<std::unique_ptr<vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    ++Opens;
+    return ProxyFileSystem::openFileForRead(Path);
+  }
+  vfs::directory_iterator dir_begin(const Twine &Dir,
+                                    std::error_code &EC) override {
+    ++Listings;
+    return ProxyFileSystem::dir_begin(Dir, EC);
+  }
+
+  unsigned Stats = 0;
+  unsigned Opens = 0;
+  unsigned Listings = 0;
+};
+} // namespace
+
+TEST(CachingFileSystemTest, Basic) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Mem(
+      new vfs::InMemoryFileSystem());
+  Mem->addFile("/dir/a", 0, MemoryBuffer::getMemBuffer("test"));
+  Mem->setCurrentWorkingDirectory("/dir");
+  IntrusiveRefCntPtr<CountingFileSystem> Base(new CountingFileSystem(Mem));
+  IntrusiveRefCntPtr<vfs::CachingFileSystemCache> Cache(
+      new vfs::CachingFileSystemCache());
+  vfs::CachingFileSystem FS(Base, Cache);
+
+  // Statuses, including failed ones, are cached and keep the spelling of
+  // the path they were asked for.
+  for (int I = 0; I < 2; ++I) {
+    auto Stat = FS.status("a");
+    ASSERT_FALSE(Stat.getError());
+    EXPECT_EQ("a", Stat->getName());
+    EXPECT_EQ(4u, Stat->getSize());
+    Stat = FS.status("/dir/a");
+    ASSERT_FALSE(Stat.getError());
+    EXPECT_EQ("/dir/a", Stat->getName());
+    EXPECT_EQ(std::errc::no_such_file_or_directory,
+              FS.status("/dir/b").getError());
+  }
+  EXPECT_EQ(2u, Base->Stats);
+
+  // Small files are read once.
+  for (int I = 0; I < 2; ++I) {
+    auto File = FS.openFileForRead("/dir/a");
+    ASSERT_FALSE(File.getError());
+    EXPECT_EQ("test", (*(*File)->getBuffer("name"))->getBuffer());
+    EXPECT_EQ("name", (*(*File)->getBuffer("name"))->getBufferIdentifier());
+  }
+  EXPECT_EQ(1u, Base->Opens);
+  EXPECT_EQ(std::errc::no_such_file_or_directory,
+            FS.openFileForRead("/dir/b").getError());
+  EXPECT_EQ(1u, Base->Opens);
+
+  // Directory listings are cached.
+  for (int I = 0; I < 2; ++I) {
+    std::error_code EC;
+    vfs::directory_iterator It = FS.dir_begin(".", EC);
+    ASSERT_FALSE(EC);
+    ASSERT_NE(vfs::directory_iterator(), It);
+    EXPECT_EQ("./a", It->path());
+    EXPECT_EQ(sys::fs::file_type::regular_file, It->type());
+    It.increment(EC);
+    ASSERT_FALSE(EC);
+    EXPECT_EQ(vfs::directory_iterator(), It);
+  }
+  EXPECT_EQ(1u, Base->Listings);
+
+  // A new file shows up once it is invalidated.
+  Mem->addFile("/dir/b", 0, MemoryBuffer::getMemBuffer("new"));
+  EXPECT_TRUE(FS.status("/dir/b").getError());
+  Cache->invalidate("/dir/b");
+  EXPECT_FALSE(FS.status("/dir/b").getError());
+  std::error_code EC;
+  vfs::directory_iterator It = FS.dir_begin("/dir", EC), End;
+  std::vector<std::string> Names;
+  for (; !EC && It != End; It.increment(EC))
+    Names.push_back(It->path());
+  EXPECT_THAT(Names, testing::ElementsAre("/dir/a", "/dir/b"));
+  EXPECT_EQ(2u, Base->Listings);
+
+  Cache->invalidateAll();
+  EXPECT_FALSE(FS.status("/dir/a").getError());
+  EXPECT_EQ(4u, Base->Stats);
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(CachingFileSystemTest, SharedBetweenThreads) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Mem(
+      new vfs::InMemoryFileSystem());
+  for (int I = 0; I < 16; ++I)
+    Mem->addFile("/f" + Twine(I), 0,
+                 MemoryBuffer::getMemBufferCopy(std::to_string(I)));
+  IntrusiveRefCntPtr<vfs::CachingFileSystemCache> Cache(
+      new vfs::CachingFileSystemCache());
+
+  std::vector<std::thread> Threads;
+  for (int T = 0; T < 4; ++T)
+    Threads.emplace_back([&] {
+      vfs::CachingFileSystem FS(Mem, Cache);
+      for (int N = 0; N < 100; ++N) {
+        int I = N % 16;
+        auto File = FS.openFileForRead("/f" + Twine(I));
+        ASSERT_FALSE(File.getError());
+        EXPECT_EQ(std::to_string(I),
+                  (*(*File)->getBuffer("f"))->getBuffer());
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+}
+#endif
+
 class InMemoryFileSystemTest : public ::testing::Test {
 protected:
   llvm::vfs::InMemoryFileSystem FS;
@@ -17,3 +17,33 @@ TEST(xxhashTest, Basic) {
   EXPECT_EQ(0x69196c1b3af0bff9U,
             xxHash64("0123456789abcdefghijklmnopqrstuvwxyz"));
 }
+
+TEST(xxhashTest, xxh3) {
+  EXPECT_EQ(0x2d06800538d394c2U, xxh3_64bits(StringRef()));
+  EXPECT_EQ(0xab6e5f64077e7d8aU, xxh3_64bits("foo"));
+  EXPECT_EQ(0xd463c860a032d362U, xxh3_64bits("bar"));
+  EXPECT_EQ(0xffb92a87c6306d55U,
+            xxh3_64bits("0123456789abcdefghijklmnopqrstuvwxyz"));
+
+  // Cover each of the length ranges that XXH3 handles differently.
+  uint8_t a[2048];
+  for (size_t i = 0; i < sizeof(a); ++i)
+    a[i] = uint8_t(i * 7);
+
+#define F(len, expected)                                                       \
+  EXPECT_EQ(uint64_t(expected), xxh3_64bits(makeArrayRef(a, size_t(len))))
+  F(1, 0xc44bdff4074eecdb);
+  F(3, 0xc3489259e968ad9e);
+  F(4, 0xd3d60c1519014e89);
+  F(8, 0xb88dee77f6bf6980);
+  F(9, 0x03688dcad730d826);
+  F(16, 0x9da23836adf2be1e);
+  F(17, 0xf34c3c9cf5a112d1);
+  F(128, 0x65f3c2c00fa93185);
+  F(129, 0x28065c6ec25f5b25);
+  F(240, 0x4917a75c0ef8eed7);
+  F(241, 0x541b19226f0052e8);
+  F(1024, 0xdc5acf0b043c445b);
+  F(2048, 0x848d24cc268f7498);
+#undef F
+}
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include "llvm/XRay/FDRTraceWriter.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/XRay/FDRLogBuilder.h"
 #include "llvm/XRay/FDRRecords.h"
@@ -177,6 +178,158 @@ TEST(FDRTraceWriterTest, WriteToStringBufferVersion1) {
                           Field(&XRayRecord::Type, Eq(RecordTypes::EXIT))));
 }
 
+// Loading a trace file a thread at a time yields the records of each thread
+// in the same order as loading it whole.
+TEST(FDRTraceWriterTest, LoadTraceFileByThread) {
+  SmallString<128> Path;
+  int FD;
+  ASSERT_FALSE(
+      sys::fs::createTemporaryFile("xray-by-thread", "xray", FD, Path));
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    XRayFileHeader H;
+    H.Version = 3;
+    H.Type = 1;
+    H.ConstantTSC = true;
+    H.NonstopTSC = true;
+    H.CycleFrequency = 3e9;
+    FDRTraceWriter Writer(OS, H);
+    auto L = LogBuilder()
+                 .add<BufferExtents>(80)
+                 .add<NewBufferRecord>(1)
+                 .add<WallclockRecord>(1, 1)
+                 .add<PIDRecord>(1)
+                 .add<NewCPUIDRecord>(1, 2)
+                 .add<FunctionRecord>(RecordTypes::ENTER, 1, 1)
+                 .add<FunctionRecord>(RecordTypes::EXIT, 1, 100)
+                 .add<BufferExtents>(80)
+                 .add<NewBufferRecord>(2)
+                 .add<WallclockRecord>(1, 1)
+                 .add<PIDRecord>(1)
+                 .add<NewCPUIDRecord>(2, 2)
+                 .add<FunctionRecord>(RecordTypes::ENTER, 2, 1)
+                 .add<FunctionRecord>(RecordTypes::EXIT, 2, 100)
+                 .consume();
+    for (auto &P : L)
+      ASSERT_FALSE(errorToBool(P->apply(Writer)));
+  }
+
+  auto TraceOrErr = loadTraceFile(Path);
+  if (!TraceOrErr)
+    FAIL() << TraceOrErr.takeError();
+  auto &Trace = TraceOrErr.get();
+
+  std::vector<std::vector<XRayRecord>> Chunks;
+  auto Err = loadTraceFileByThread(
+      Path, [&](const XRayFileHeader &FH, ArrayRef<XRayRecord> Records) {
+        EXPECT_THAT(FH.Version, Eq(3));
+        Chunks.emplace_back(Records.begin(), Records.end());
+        return Error::success();
+      });
+  sys::fs::remove(Path);
+  if (Err)
+    FAIL() << std::move(Err);
+
+  ASSERT_THAT(Chunks.size(), Eq(2u));
+  for (const auto &Chunk : Chunks) {
+    ASSERT_THAT(Chunk.size(), Eq(2u));
+    EXPECT_THAT(Chunk[0].TId, Eq(Chunk[1].TId));
+  }
+  EXPECT_THAT(Chunks[0][0].TId, Not(Eq(Chunks[1][0].TId)));
+
+  std::vector<XRayRecord> Joined(Chunks[0]);
+  Joined.insert(Joined.end(), Chunks[1].begin(), Chunks[1].end());
+  ASSERT_THAT(Joined.size(), Eq(Trace.size()));
+  auto It = Trace.begin();
+  for (const auto &R : Joined) {
+    EXPECT_THAT(R.FuncId, Eq(It->FuncId));
+    EXPECT_THAT(R.TId, Eq(It->TId));
+    EXPECT_THAT(R.TSC, Eq(It->TSC));
+    ++It;
+  }
+}
+
+// The buffers of a thread need not be adjacent in the file; each thread is
+// read back from all of its buffers when it is loaded.
+TEST(FDRTraceWriterTest, LoadTraceFileByThreadInterleaved) {
+  SmallString<128> Path;
+  int FD;
+  ASSERT_FALSE(
+      sys::fs::createTemporaryFile("xray-by-thread", "xray", FD, Path));
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    XRayFileHeader H;
+    H.Version = 3;
+    H.Type = 1;
+    H.ConstantTSC = true;
+    H.NonstopTSC = true;
+    H.CycleFrequency = 3e9;
+    FDRTraceWriter Writer(OS, H);
+    auto L = LogBuilder()
+                 .add<BufferExtents>(80)
+                 .add<NewBufferRecord>(1)
+                 .add<WallclockRecord>(1, 1)
+                 .add<PIDRecord>(1)
+                 .add<NewCPUIDRecord>(1, 2)
+                 .add<FunctionRecord>(RecordTypes::ENTER, 1, 1)
+                 .add<FunctionRecord>(RecordTypes::EXIT, 1, 100)
+                 .add<BufferExtents>(80)
+                 .add<NewBufferRecord>(2)
+                 .add<WallclockRecord>(1, 1)
+                 .add<PIDRecord>(1)
+                 .add<NewCPUIDRecord>(2, 2)
+                 .add<FunctionRecord>(RecordTypes::ENTER, 2, 1)
+                 .add<FunctionRecord>(RecordTypes::EXIT, 2, 100)
+                 .add<BufferExtents>(80)
+                 .add<NewBufferRecord>(1)
+                 .add<WallclockRecord>(2, 2)
+                 .add<PIDRecord>(1)
+                 .add<NewCPUIDRecord>(1, 200)
+                 .add<FunctionRecord>(RecordTypes::ENTER, 3, 1)
+                 .add<FunctionRecord>(RecordTypes::EXIT, 3, 100)
+                 .consume();
+    for (auto &P : L)
+      ASSERT_FALSE(errorToBool(P->apply(Writer)));
+  }
+
+  auto TraceOrErr = loadTraceFile(Path);
+  if (!TraceOrErr)
+    FAIL() << TraceOrErr.takeError();
+  auto &Trace = TraceOrErr.get();
+
+  std::vector<std::vector<XRayRecord>> Chunks;
+  auto Err = loadTraceFileByThread(
+      Path, [&](const XRayFileHeader &, ArrayRef<XRayRecord> Records) {
+        Chunks.emplace_back(Records.begin(), Records.end());
+        return Error::success();
+      });
+  sys::fs::remove(Path);
+  if (Err)
+    FAIL() << std::move(Err);
+
+  ASSERT_THAT(Chunks.size(), Eq(2u));
+  std::vector<XRayRecord> Joined;
+  for (const auto &Chunk : Chunks) {
+    for (const XRayRecord &R : Chunk)
+      EXPECT_THAT(R.TId, Eq(Chunk[0].TId));
+    Joined.insert(Joined.end(), Chunk.begin(), Chunk.end());
+  }
+  const auto &Thread1 = Chunks[0][0].TId == 1 ? Chunks[0] : Chunks[1];
+  EXPECT_THAT(Thread1, ElementsAre(Field(&XRayRecord::FuncId, Eq(1)),
+                                   Field(&XRayRecord::FuncId, Eq(1)),
+                                   Field(&XRayRecord::FuncId, Eq(3)),
+                                   Field(&XRayRecord::FuncId, Eq(3))));
+
+  ASSERT_THAT(Joined.size(), Eq(Trace.size()));
+  auto It = Trace.begin();
+  for (const XRayRecord &R : Joined) {
+    EXPECT_THAT(R.FuncId, Eq(It->FuncId));
+    EXPECT_THAT(R.TId, Eq(It->TId));
+    EXPECT_THAT(R.TSC, Eq(It->TSC));
+    ++It;
+  }
+}
+
 } // namespace
 } // namespace xray
 } // namespace llvm
@@ -399,31 +399,40 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
 
   case Matcher::CheckPatternPredicate: {
     StringRef Pred =cast<CheckPatternPredicateMatcher>(N)->getPredicate();
-    OS << "OPC_CheckPatternPredicate, " << getPatternPredicate(Pred) << ',';
+    unsigned PredNo = getPatternPredicate(Pred);
+    if (PredNo < 8)
+      OS << "OPC_CheckPatternPredicate" << PredNo << ',';
+    else
+      OS << "OPC_CheckPatternPredicate, " << PredNo << ',';
     if (!OmitComments)
       OS << " // " << Pred;
     OS << '\n';
-    return 2;
+    return PredNo < 8 ? 1 : 2;
   }
   case Matcher::CheckPredicate: {
     TreePredicateFn Pred = cast<CheckPredicateMatcher>(N)->getPredicate();
-    unsigned OperandBytes = 0;
+    unsigned PredNo = getNodePredicate(Pred);
+    unsigned Size;
 
     if (Pred.usesOperands()) {
       unsigned NumOps = cast<CheckPredicateMatcher>(N)->getNumOperands();
       OS << "OPC_CheckPredicateWithOperands, " << NumOps << "/*#Ops*/, ";
       for (unsigned i = 0; i < NumOps; ++i)
         OS << cast<CheckPredicateMatcher>(N)->getOperandNo(i) << ", ";
-      OperandBytes = 1 + NumOps;
+      OS << PredNo << ',';
+      Size = 3 + NumOps;
+    } else if (PredNo < 8) {
+      OS << "OPC_CheckPredicate" << PredNo << ',';
+      Size = 1;
     } else {
-      OS << "OPC_CheckPredicate, ";
+      OS << "OPC_CheckPredicate, " << PredNo << ',';
+      Size = 2;
     }
 
-    OS << getNodePredicate(Pred) << ',';
     if (!OmitComments)
       OS << " // " << Pred.getFnName();
     OS << '\n';
-    return 2 + OperandBytes;
+    return Size;
   }
 
   case Matcher::CheckOpcode:
@@ -716,19 +725,35 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
       }
     }
     const EmitNodeMatcherCommon *EN = cast<EmitNodeMatcherCommon>(N);
-    OS << (isa<EmitNodeMatcher>(EN) ? "OPC_EmitNode" : "OPC_MorphNodeTo");
+    bool IsEmitNode = isa<EmitNodeMatcher>(EN);
+    OS << (IsEmitNode ? "OPC_EmitNode" : "OPC_MorphNodeTo");
     bool CompressVTs = EN->getNumVTs() < 3;
     if (CompressVTs)
       OS << EN->getNumVTs();
 
-    OS << ", TARGET_VAL(" << EN->getOpcodeName() << "), 0";
-
-    if (EN->hasChain())   OS << "|OPFL_Chain";
-    if (EN->hasInFlag())  OS << "|OPFL_GlueInput";
-    if (EN->hasOutFlag()) OS << "|OPFL_GlueOutput";
-    if (EN->hasMemRefs()) OS << "|OPFL_MemRefs";
-    if (EN->getNumFixedArityOperands() != -1)
-      OS << "|OPFL_Variadic" << EN->getNumFixedArityOperands();
+    // The most common flag combinations are encoded in the opcode.
+    bool HasNoFlags = !EN->hasChain() && !EN->hasInFlag() &&
+                      !EN->hasOutFlag() && !EN->hasMemRefs() &&
+                      EN->getNumFixedArityOperands() == -1;
+    bool HasChainMemRefsOnly = EN->hasChain() && !EN->hasInFlag() &&
+                               !EN->hasOutFlag() && EN->hasMemRefs() &&
+                               EN->getNumFixedArityOperands() == -1;
+    bool CompressFlags =
+        CompressVTs && (HasNoFlags || (!IsEmitNode && HasChainMemRefsOnly));
+    if (CompressFlags)
+      OS << (HasNoFlags ? "None" : "ChainMemRefs");
+
+    OS << ", TARGET_VAL(" << EN->getOpcodeName() << ")";
+
+    if (!CompressFlags) {
+      OS << ", 0";
+      if (EN->hasChain())   OS << "|OPFL_Chain";
+      if (EN->hasInFlag())  OS << "|OPFL_GlueInput";
+      if (EN->hasOutFlag()) OS << "|OPFL_GlueOutput";
+      if (EN->hasMemRefs()) OS << "|OPFL_MemRefs";
+      if (EN->getNumFixedArityOperands() != -1)
+        OS << "|OPFL_Variadic" << EN->getNumFixedArityOperands();
+    }
     OS << ",\n";
 
     OS.indent(FullIndexWidth + Indent*2+4);
@@ -771,8 +796,8 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
     } else
       OS << '\n';
 
-    return 5 + !CompressVTs + EN->getNumVTs() + NumOperandBytes +
-           NumCoveredBytes;
+    return 5 - CompressFlags + !CompressVTs + EN->getNumVTs() +
+           NumOperandBytes + NumCoveredBytes;
   }
   case Matcher::CompleteMatch: {
     const CompleteMatchMatcher *CM = cast<CompleteMatchMatcher>(N);
@@ -260,7 +260,9 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &LLVMTableGenMain);
+  return TableGenMain(argv[0], &LLVMTableGenMain, [](StringRef Name) {
+    return selectTableGenAction(Action, Name);
+  });
 }
 
 #ifdef __has_feature
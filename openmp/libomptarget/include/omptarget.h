@@ -111,6 +111,15 @@ struct __tgt_target_table {
       *EntriesEnd; // End of the table with all the entries (non inclusive)
 };
 
+/// This struct is a record of the device operations issued without waiting
+/// for their completion, so that they can overlap each other. The operations
+/// of a record run in the order they were issued.
+struct __tgt_async_info {
+  // The queue the operations are issued on (a CUstream for CUDA). It is null
+  // until the first operation, and after the synchronization that ends them.
+  void *Queue = nullptr;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
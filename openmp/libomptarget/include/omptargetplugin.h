@@ -87,6 +87,38 @@ int32_t __tgt_rtl_run_target_team_region(int32_t ID, void *Entry, void **Args,
                                          int32_t NumTeams, int32_t ThreadLimit,
                                          uint64_t loop_tripcount);
 
+// The asynchronous versions of the functions above, which are optional: an
+// RTL provides either all of them and __tgt_rtl_synchronize, or none. They
+// queue the operation on the queue of AsyncInfoPtr, creating it if needed,
+// and return without waiting for its completion. The operations of a queue
+// run in order. HostPtr may be reused by the caller as soon as
+// __tgt_rtl_data_submit_async returns when it is not page-locked memory, and
+// must stay valid otherwise, as the HostPtr of a retrieval, until the queue
+// is synchronized. In case of success, return zero. Otherwise, return an
+// error code.
+int32_t __tgt_rtl_data_submit_async(int32_t ID, void *TargetPtr, void *HostPtr,
+                                    int64_t Size,
+                                    __tgt_async_info *AsyncInfoPtr);
+
+int32_t __tgt_rtl_data_retrieve_async(int32_t ID, void *HostPtr,
+                                      void *TargetPtr, int64_t Size,
+                                      __tgt_async_info *AsyncInfoPtr);
+
+int32_t __tgt_rtl_run_target_region_async(int32_t ID, void *Entry, void **Args,
+                                          ptrdiff_t *Offsets, int32_t NumArgs,
+                                          __tgt_async_info *AsyncInfoPtr);
+
+int32_t __tgt_rtl_run_target_team_region_async(
+    int32_t ID, void *Entry, void **Args, ptrdiff_t *Offsets, int32_t NumArgs,
+    int32_t NumTeams, int32_t ThreadLimit, uint64_t loop_tripcount,
+    __tgt_async_info *AsyncInfoPtr);
+
+// Wait for the completion of all the operations on the queue of AsyncInfoPtr,
+// if any, and release the queue. In case of success, return zero. Otherwise,
+// return an error code, which is also the way the errors of the kernels run
+// asynchronously are reported.
+int32_t __tgt_rtl_synchronize(int32_t ID, __tgt_async_info *AsyncInfoPtr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,7 +14,10 @@
 #include <cstddef>
 #include <cuda.h>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "omptargetplugin.h"
@@ -87,6 +90,35 @@ struct omptarget_device_environmentTy {
 /// FIXME: we may need this to be per device and per library.
 std::list<KernelTy> KernelsList;
 
+/// Streams of a device that are not in use by an __tgt_async_info. Streams are
+/// created on demand and reused, as creating one is expensive.
+struct StreamPoolTy {
+  std::mutex Mtx;
+  std::vector<CUstream> Streams;
+};
+
+/// Device memory that is kept for reuse instead of being released with
+/// cuMemFree, which is expensive and synchronizes the device. Blocks of up to
+/// Threshold bytes are allocated with their size rounded up to a power of two
+/// and kept on the free list of their size class when deleted.
+struct MemoryPoolTy {
+  static const int MinSizeClass = 8; // 256 bytes
+
+  std::mutex Mtx;
+  // Free blocks of each size class, the blocks of class C having 2^C bytes.
+  std::vector<std::vector<CUdeviceptr>> FreeLists;
+  // Size class of every pooled block in use.
+  std::unordered_map<CUdeviceptr, int> SizeClasses;
+
+  // Return the size class of a block of Size bytes.
+  static int getSizeClass(int64_t Size) {
+    int C = MinSizeClass;
+    while (((int64_t)1 << C) < Size)
+      ++C;
+    return C;
+  }
+};
+
 /// Class containing all the device information.
 class RTLDeviceInfoTy {
   std::vector<std::list<FuncOrGblEntryTy>> FuncGblEntries;
@@ -112,6 +144,14 @@ public:
   // OpenMP Requires Flags
   int64_t RequiresFlags;
 
+  // Reuse of streams and device memory, per device
+  std::vector<std::unique_ptr<StreamPoolTy>> StreamPools;
+  std::vector<std::unique_ptr<MemoryPoolTy>> MemoryPools;
+
+  // Largest size of the allocations served by the memory pool, 0 to disable it
+  int64_t MemoryPoolThreshold;
+  static const int64_t DefaultMemoryPoolThreshold = 1 << 20; // 1 MiB
+
   //static int EnvNumThreads;
   static const int HardTeamLimit = 1<<16; // 64k
   static const int HardThreadLimit = 1024;
@@ -173,6 +213,103 @@ public:
     E.Table.EntriesBegin = E.Table.EntriesEnd = 0;
   }
 
+  // Return the stream of AsyncInfoPtr, taking one from the pool of the device
+  // if it has none yet. The context of the device must be current.
+  CUstream getStream(int32_t device_id, __tgt_async_info *AsyncInfoPtr) {
+    if (AsyncInfoPtr->Queue)
+      return (CUstream)AsyncInfoPtr->Queue;
+
+    StreamPoolTy &Pool = *StreamPools[device_id];
+    CUstream Stream = nullptr;
+    {
+      std::lock_guard<std::mutex> Lock(Pool.Mtx);
+      if (!Pool.Streams.empty()) {
+        Stream = Pool.Streams.back();
+        Pool.Streams.pop_back();
+      }
+    }
+    if (!Stream) {
+      // The stream must not synchronize with the default stream, on which
+      // the synchronous operations of the other threads run.
+      CUresult err = cuStreamCreate(&Stream, CU_STREAM_NON_BLOCKING);
+      if (err != CUDA_SUCCESS) {
+        DP("Error when creating a CUDA stream\n");
+        CUDA_ERR_STRING(err);
+        return nullptr;
+      }
+    }
+    AsyncInfoPtr->Queue = Stream;
+    return Stream;
+  }
+
+  // Give the stream of AsyncInfoPtr back to the pool of the device.
+  void releaseStream(int32_t device_id, __tgt_async_info *AsyncInfoPtr) {
+    StreamPoolTy &Pool = *StreamPools[device_id];
+    std::lock_guard<std::mutex> Lock(Pool.Mtx);
+    Pool.Streams.push_back((CUstream)AsyncInfoPtr->Queue);
+    AsyncInfoPtr->Queue = nullptr;
+  }
+
+  // Allocate Size bytes on the device, from the memory pool if possible. The
+  // context of the device must be current.
+  CUresult allocate(int32_t device_id, int64_t Size, CUdeviceptr *Ptr) {
+    if (Size > MemoryPoolThreshold)
+      return cuMemAlloc(Ptr, Size);
+
+    MemoryPoolTy &Pool = *MemoryPools[device_id];
+    int C = MemoryPoolTy::getSizeClass(Size);
+    std::lock_guard<std::mutex> Lock(Pool.Mtx);
+    if ((size_t)C < Pool.FreeLists.size() && !Pool.FreeLists[C].empty()) {
+      *Ptr = Pool.FreeLists[C].back();
+      Pool.FreeLists[C].pop_back();
+    } else {
+      CUresult err = cuMemAlloc(Ptr, (size_t)1 << C);
+      if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+        // Give the free blocks back to the device and try again.
+        DP("Releasing the memory pool of device %d\n", device_id);
+        releaseFreeBlocks(Pool);
+        err = cuMemAlloc(Ptr, (size_t)1 << C);
+      }
+      if (err != CUDA_SUCCESS)
+        return err;
+    }
+    Pool.SizeClasses[*Ptr] = C;
+    return CUDA_SUCCESS;
+  }
+
+  // Deallocate a block returned by allocate. The context of the device must
+  // be current.
+  CUresult deallocate(int32_t device_id, CUdeviceptr Ptr) {
+    MemoryPoolTy &Pool = *MemoryPools[device_id];
+    {
+      std::lock_guard<std::mutex> Lock(Pool.Mtx);
+      auto It = Pool.SizeClasses.find(Ptr);
+      if (It != Pool.SizeClasses.end()) {
+        int C = It->second;
+        Pool.SizeClasses.erase(It);
+        if ((size_t)C >= Pool.FreeLists.size())
+          Pool.FreeLists.resize(C + 1);
+        Pool.FreeLists[C].push_back(Ptr);
+        return CUDA_SUCCESS;
+      }
+    }
+    return cuMemFree(Ptr);
+  }
+
+  // Free the blocks on the free lists of a pool, whose mutex must be held.
+  static void releaseFreeBlocks(MemoryPoolTy &Pool) {
+    for (auto &FreeList : Pool.FreeLists) {
+      for (CUdeviceptr Ptr : FreeList) {
+        CUresult err = cuMemFree(Ptr);
+        if (err != CUDA_SUCCESS) {
+          DP("Error when freeing CUDA memory\n");
+          CUDA_ERR_STRING(err);
+        }
+      }
+      FreeList.clear();
+    }
+  }
+
   RTLDeviceInfoTy() {
 #ifdef OMPTARGET_DEBUG
     if (char *envStr = getenv("LIBOMPTARGET_DEBUG")) {
@@ -210,6 +347,12 @@ public:
     WarpSize.resize(NumberOfDevices);
     NumTeams.resize(NumberOfDevices);
     NumThreads.resize(NumberOfDevices);
+    StreamPools.resize(NumberOfDevices);
+    MemoryPools.resize(NumberOfDevices);
+    for (int I = 0; I < NumberOfDevices; ++I) {
+      StreamPools[I].reset(new StreamPoolTy());
+      MemoryPools[I].reset(new MemoryPoolTy());
+    }
 
     // Get environment variables regarding teams
     char *envStr = getenv("OMP_TEAM_LIMIT");
@@ -228,12 +371,35 @@ public:
     } else {
       EnvNumTeams = -1;
     }
+    envStr = getenv("LIBOMPTARGET_MEMORY_POOL_THRESHOLD");
+    if (envStr) {
+      // LIBOMPTARGET_MEMORY_POOL_THRESHOLD has been set
+      MemoryPoolThreshold = std::stoll(envStr);
+      DP("Parsed LIBOMPTARGET_MEMORY_POOL_THRESHOLD=%" PRId64 "\n",
+         MemoryPoolThreshold);
+    } else {
+      MemoryPoolThreshold = DefaultMemoryPoolThreshold;
+    }
 
     // Default state.
     RequiresFlags = OMP_REQ_UNDEFINED;
   }
 
   ~RTLDeviceInfoTy() {
+    // Destroy the pooled streams and memory, in the context they belong to
+    for (int I = 0; I < (int)Contexts.size(); ++I) {
+      if (!Contexts[I] || cuCtxSetCurrent(Contexts[I]) != CUDA_SUCCESS)
+        continue;
+      for (CUstream Stream : StreamPools[I]->Streams) {
+        CUresult err = cuStreamDestroy(Stream);
+        if (err != CUDA_SUCCESS) {
+          DP("Error when destroying CUDA stream\n");
+          CUDA_ERR_STRING(err);
+        }
+      }
+      releaseFreeBlocks(*MemoryPools[I]);
+    }
+
     // Close modules
     for (auto &module : Modules)
       if (module) {
@@ -586,7 +752,7 @@ void *__tgt_rtl_data_alloc(int32_t device_id, int64_t size, void *hst_ptr) {
   }
 
   CUdeviceptr ptr;
-  err = cuMemAlloc(&ptr, size);
+  err = DeviceInfo.allocate(device_id, size, &ptr);
   if (err != CUDA_SUCCESS) {
     DP("Error while trying to allocate %d\n", err);
     CUDA_ERR_STRING(err);
@@ -639,7 +805,8 @@ int32_t __tgt_rtl_data_retrieve(int32_t device_id, void *hst_ptr, void *tgt_ptr,
   return OFFLOAD_SUCCESS;
 }
 
-int32_t __tgt_rtl_data_delete(int32_t device_id, void *tgt_ptr) {
+int32_t __tgt_rtl_data_submit_async(int32_t device_id, void *tgt_ptr,
+    void *hst_ptr, int64_t size, __tgt_async_info *async_info_ptr) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
   if (err != CUDA_SUCCESS) {
@@ -648,18 +815,25 @@ int32_t __tgt_rtl_data_delete(int32_t device_id, void *tgt_ptr) {
     return OFFLOAD_FAIL;
   }
 
-  err = cuMemFree((CUdeviceptr)tgt_ptr);
+  CUstream stream = DeviceInfo.getStream(device_id, async_info_ptr);
+  if (!stream)
+    return OFFLOAD_FAIL;
+
+  // A copy from pageable memory returns once the data is staged, so hst_ptr
+  // may be a temporary of the caller.
+  err = cuMemcpyHtoDAsync((CUdeviceptr)tgt_ptr, hst_ptr, size, stream);
   if (err != CUDA_SUCCESS) {
-    DP("Error when freeing CUDA memory\n");
+    DP("Error when copying data from host to device. Pointers: host = " DPxMOD
+       ", device = " DPxMOD ", size = %" PRId64 "\n", DPxPTR(hst_ptr),
+       DPxPTR(tgt_ptr), size);
     CUDA_ERR_STRING(err);
     return OFFLOAD_FAIL;
   }
   return OFFLOAD_SUCCESS;
 }
 
-int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
-    void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num, int32_t team_num,
-    int32_t thread_limit, uint64_t loop_tripcount) {
+int32_t __tgt_rtl_data_retrieve_async(int32_t device_id, void *hst_ptr,
+    void *tgt_ptr, int64_t size, __tgt_async_info *async_info_ptr) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
   if (err != CUDA_SUCCESS) {
@@ -668,6 +842,46 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
     return OFFLOAD_FAIL;
   }
 
+  CUstream stream = DeviceInfo.getStream(device_id, async_info_ptr);
+  if (!stream)
+    return OFFLOAD_FAIL;
+
+  err = cuMemcpyDtoHAsync(hst_ptr, (CUdeviceptr)tgt_ptr, size, stream);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when copying data from device to host. Pointers: host = " DPxMOD
+        ", device = " DPxMOD ", size = %" PRId64 "\n", DPxPTR(hst_ptr),
+        DPxPTR(tgt_ptr), size);
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+  return OFFLOAD_SUCCESS;
+}
+
+int32_t __tgt_rtl_data_delete(int32_t device_id, void *tgt_ptr) {
+  // Set the context we are using.
+  CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when setting CUDA context\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+
+  err = DeviceInfo.deallocate(device_id, (CUdeviceptr)tgt_ptr);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when freeing CUDA memory\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+  return OFFLOAD_SUCCESS;
+}
+
+// Launch the kernel of a target region on stream, without waiting for it. The
+// context of the device must be current.
+static int32_t launchTargetTeamRegion(int32_t device_id, void *tgt_entry_ptr,
+    void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num, int32_t team_num,
+    int32_t thread_limit, uint64_t loop_tripcount, CUstream stream) {
+  CUresult err;
+
   // All args are references.
   std::vector<void *> args(arg_num);
   std::vector<void *> ptrs(arg_num);
@@ -756,7 +970,8 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
      cudaThreadsPerBlock);
 
   err = cuLaunchKernel(KernelInfo->Func, cudaBlocksPerGrid, 1, 1,
-      cudaThreadsPerBlock, 1, 1, 0 /*bytes of shared memory*/, 0, &args[0], 0);
+      cudaThreadsPerBlock, 1, 1, 0 /*bytes of shared memory*/, stream,
+      &args[0], 0);
   if (err != CUDA_SUCCESS) {
     DP("Device kernel launch failed!\n");
     CUDA_ERR_STRING(err);
@@ -765,6 +980,24 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
 
   DP("Launch of entry point at " DPxMOD " successful!\n",
       DPxPTR(tgt_entry_ptr));
+  return OFFLOAD_SUCCESS;
+}
+
+int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
+    void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num, int32_t team_num,
+    int32_t thread_limit, uint64_t loop_tripcount) {
+  // Set the context we are using.
+  CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when setting CUDA context\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+
+  int32_t rc = launchTargetTeamRegion(device_id, tgt_entry_ptr, tgt_args,
+      tgt_offsets, arg_num, team_num, thread_limit, loop_tripcount, 0);
+  if (rc != OFFLOAD_SUCCESS)
+    return rc;
 
   CUresult sync_err = cuCtxSynchronize();
   if (sync_err != CUDA_SUCCESS) {
@@ -787,6 +1020,55 @@ int32_t __tgt_rtl_run_target_region(int32_t device_id, void *tgt_entry_ptr,
       tgt_offsets, arg_num, team_num, thread_limit, 0);
 }
 
+int32_t __tgt_rtl_run_target_team_region_async(int32_t device_id,
+    void *tgt_entry_ptr, void **tgt_args, ptrdiff_t *tgt_offsets,
+    int32_t arg_num, int32_t team_num, int32_t thread_limit,
+    uint64_t loop_tripcount, __tgt_async_info *async_info_ptr) {
+  // Set the context we are using.
+  CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when setting CUDA context\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+
+  CUstream stream = DeviceInfo.getStream(device_id, async_info_ptr);
+  if (!stream)
+    return OFFLOAD_FAIL;
+
+  // The errors of the kernel are reported by __tgt_rtl_synchronize.
+  return launchTargetTeamRegion(device_id, tgt_entry_ptr, tgt_args,
+      tgt_offsets, arg_num, team_num, thread_limit, loop_tripcount, stream);
+}
+
+int32_t __tgt_rtl_run_target_region_async(int32_t device_id,
+    void *tgt_entry_ptr, void **tgt_args, ptrdiff_t *tgt_offsets,
+    int32_t arg_num, __tgt_async_info *async_info_ptr) {
+  // use one team and the default number of threads.
+  const int32_t team_num = 1;
+  const int32_t thread_limit = 0;
+  return __tgt_rtl_run_target_team_region_async(device_id, tgt_entry_ptr,
+      tgt_args, tgt_offsets, arg_num, team_num, thread_limit, 0,
+      async_info_ptr);
+}
+
+int32_t __tgt_rtl_synchronize(int32_t device_id,
+    __tgt_async_info *async_info_ptr) {
+  // Nothing was issued on this async info.
+  if (!async_info_ptr->Queue)
+    return OFFLOAD_SUCCESS;
+
+  CUresult err = cuStreamSynchronize((CUstream)async_info_ptr->Queue);
+  // The stream is reusable even after an error of the operations on it.
+  DeviceInfo.releaseStream(device_id, async_info_ptr);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when synchronizing CUDA stream\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+  return OFFLOAD_SUCCESS;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,6 +16,7 @@
 
 #include <cassert>
 #include <climits>
+#include <iterator>
 #include <string>
 
 /// Map between Device ID (i.e. openmp device id) and its DeviceTy.
@@ -25,22 +26,21 @@ int DeviceTy::associatePtr(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size) {
   DataMapMtx.lock();
 
   // Check if entry exists
-  for (auto &HT : HostDataToTargetMap) {
-    if ((uintptr_t)HstPtrBegin == HT.HstPtrBegin) {
-      // Mapping already exists
-      bool isValid = HT.HstPtrBegin == (uintptr_t) HstPtrBegin &&
-                     HT.HstPtrEnd == (uintptr_t) HstPtrBegin + Size &&
-                     HT.TgtPtrBegin == (uintptr_t) TgtPtrBegin;
-      DataMapMtx.unlock();
-      if (isValid) {
-        DP("Attempt to re-associate the same device ptr+offset with the same "
-            "host ptr, nothing to do\n");
-        return OFFLOAD_SUCCESS;
-      } else {
-        DP("Not allowed to re-associate a different device ptr+offset with the "
-            "same host ptr\n");
-        return OFFLOAD_FAIL;
-      }
+  auto search = HostDataToTargetMap.find((uintptr_t)HstPtrBegin);
+  if (search != HostDataToTargetMap.end()) {
+    // Mapping already exists
+    auto &HT = *search;
+    bool isValid = HT.HstPtrEnd == (uintptr_t) HstPtrBegin + Size &&
+                   HT.TgtPtrBegin == (uintptr_t) TgtPtrBegin;
+    DataMapMtx.unlock();
+    if (isValid) {
+      DP("Attempt to re-associate the same device ptr+offset with the same "
+          "host ptr, nothing to do\n");
+      return OFFLOAD_SUCCESS;
+    } else {
+      DP("Not allowed to re-associate a different device ptr+offset with the "
+          "same host ptr\n");
+      return OFFLOAD_FAIL;
     }
   }
 
@@ -59,7 +59,7 @@ int DeviceTy::associatePtr(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size) {
       DPxMOD ", TgtBegin=" DPxMOD "\n", DPxPTR(newEntry.HstPtrBase),
       DPxPTR(newEntry.HstPtrBegin), DPxPTR(newEntry.HstPtrEnd),
       DPxPTR(newEntry.TgtPtrBegin));
-  HostDataToTargetMap.push_front(newEntry);
+  insertMapping(newEntry);
 
   DataMapMtx.unlock();
 
@@ -70,20 +70,18 @@ int DeviceTy::disassociatePtr(void *HstPtrBegin) {
   DataMapMtx.lock();
 
   // Check if entry exists
-  for (HostDataToTargetListTy::iterator ii = HostDataToTargetMap.begin();
-      ii != HostDataToTargetMap.end(); ++ii) {
-    if ((uintptr_t)HstPtrBegin == ii->HstPtrBegin) {
-      // Mapping exists
-      if (CONSIDERED_INF(ii->RefCount)) {
-        DP("Association found, removing it\n");
-        HostDataToTargetMap.erase(ii);
-        DataMapMtx.unlock();
-        return OFFLOAD_SUCCESS;
-      } else {
-        DP("Trying to disassociate a pointer which was not mapped via "
-            "omp_target_associate_ptr\n");
-        break;
-      }
+  auto search = HostDataToTargetMap.find((uintptr_t)HstPtrBegin);
+  if (search != HostDataToTargetMap.end()) {
+    // Mapping exists
+    if (CONSIDERED_INF(search->RefCount)) {
+      DP("Association found, removing it\n");
+      HostDataToTargetMap.erase(search);
+      ++MappingStats.Removals;
+      DataMapMtx.unlock();
+      return OFFLOAD_SUCCESS;
+    } else {
+      DP("Trying to disassociate a pointer which was not mapped via "
+          "omp_target_associate_ptr\n");
     }
   }
 
@@ -99,11 +97,13 @@ long DeviceTy::getMapEntryRefCnt(void *HstPtrBegin) {
   long RefCnt = -1;
 
   DataMapMtx.lock();
-  for (auto &HT : HostDataToTargetMap) {
-    if (hp >= HT.HstPtrBegin && hp < HT.HstPtrEnd) {
+  ++MappingStats.Lookups;
+  auto upper = HostDataToTargetMap.upper_bound(hp);
+  if (upper != HostDataToTargetMap.begin()) {
+    auto &HT = *std::prev(upper);
+    if (hp < HT.HstPtrEnd) {
       DP("DeviceTy::getMapEntry: requested entry found\n");
       RefCnt = HT.RefCount;
-      break;
     }
   }
   DataMapMtx.unlock();
@@ -121,21 +121,31 @@ LookupResult DeviceTy::lookupMapping(void *HstPtrBegin, int64_t Size) {
 
   DP("Looking up mapping(HstPtrBegin=" DPxMOD ", Size=%ld)...\n", DPxPTR(hp),
       Size);
-  for (lr.Entry = HostDataToTargetMap.begin();
-      lr.Entry != HostDataToTargetMap.end(); ++lr.Entry) {
-    auto &HT = *lr.Entry;
+  ++MappingStats.Lookups;
+  lr.Entry = HostDataToTargetMap.end();
+
+  // The first entry that begins after hp.
+  auto upper = HostDataToTargetMap.upper_bound(hp);
+  // Only the entry before it may contain hp.
+  if (upper != HostDataToTargetMap.begin()) {
+    auto prev = std::prev(upper);
+    auto &HT = *prev;
     // Is it contained?
     lr.Flags.IsContained = hp >= HT.HstPtrBegin && hp < HT.HstPtrEnd &&
         (hp+Size) <= HT.HstPtrEnd;
-    // Does it extend into an already mapped region?
-    lr.Flags.ExtendsBefore = hp < HT.HstPtrBegin && (hp+Size) > HT.HstPtrBegin;
     // Does it extend beyond the mapped region?
     lr.Flags.ExtendsAfter = hp < HT.HstPtrEnd && (hp+Size) > HT.HstPtrEnd;
-
-    if (lr.Flags.IsContained || lr.Flags.ExtendsBefore ||
-        lr.Flags.ExtendsAfter) {
-      break;
-    }
+    if (lr.Flags.IsContained || lr.Flags.ExtendsAfter)
+      lr.Entry = prev;
+  }
+  // Only the entry after it may begin inside the section.
+  if (lr.Entry == HostDataToTargetMap.end() &&
+      upper != HostDataToTargetMap.end()) {
+    auto &HT = *upper;
+    // Does it extend into an already mapped region?
+    lr.Flags.ExtendsBefore = hp < HT.HstPtrBegin && (hp+Size) > HT.HstPtrBegin;
+    if (lr.Flags.ExtendsBefore)
+      lr.Entry = upper;
   }
 
   if (lr.Flags.ExtendsBefore) {
@@ -150,6 +160,17 @@ LookupResult DeviceTy::lookupMapping(void *HstPtrBegin, int64_t Size) {
   return lr;
 }
 
+void DeviceTy::insertMapping(const HostDataToTargetTy &Entry) {
+  // Callers insert an entry only after a lookup found no entry containing its
+  // begin address, and entries are never empty, so no entry begins there.
+  bool Inserted = HostDataToTargetMap.insert(Entry).second;
+  (void)Inserted;
+  assert(Inserted && "host address already begins a mapping");
+  ++MappingStats.Insertions;
+  if (HostDataToTargetMap.size() > MappingStats.MaxEntries)
+    MappingStats.MaxEntries = HostDataToTargetMap.size();
+}
+
 // Used by target_data_begin
 // Return the target pointer begin (where the data will be moved).
 // Allocate memory if this is the first occurrence of this mapping.
@@ -206,7 +227,7 @@ void *DeviceTy::getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase,
       DP("Creating new map entry: HstBase=" DPxMOD ", HstBegin=" DPxMOD ", "
          "HstEnd=" DPxMOD ", TgtBegin=" DPxMOD "\n", DPxPTR(HstPtrBase),
          DPxPTR(HstPtrBegin), DPxPTR((uintptr_t)HstPtrBegin + Size), DPxPTR(tp));
-      HostDataToTargetMap.push_front(HostDataToTargetTy((uintptr_t)HstPtrBase,
+      insertMapping(HostDataToTargetTy((uintptr_t)HstPtrBase,
           (uintptr_t)HstPtrBegin, (uintptr_t)HstPtrBegin + Size, tp));
       rc = (void *)tp;
     }
@@ -290,6 +311,7 @@ int DeviceTy::deallocTgtPtr(void *HstPtrBegin, int64_t Size, bool ForceDelete,
           ", Size=%ld\n", (ForceDelete ? " (forced)" : ""),
           DPxPTR(HT.HstPtrBegin), DPxPTR(HT.TgtPtrBegin), Size);
       HostDataToTargetMap.erase(lr.Entry);
+      ++MappingStats.Removals;
     }
     rc = OFFLOAD_SUCCESS;
   } else {
@@ -339,19 +361,29 @@ __tgt_target_table *DeviceTy::load_binary(void *Img) {
 
 // Submit data to device.
 int32_t DeviceTy::data_submit(void *TgtPtrBegin, void *HstPtrBegin,
-    int64_t Size) {
+    int64_t Size, __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->data_submit_async)
+    return RTL->data_submit_async(RTLDeviceID, TgtPtrBegin, HstPtrBegin, Size,
+        AsyncInfoPtr);
   return RTL->data_submit(RTLDeviceID, TgtPtrBegin, HstPtrBegin, Size);
 }
 
 // Retrieve data from device.
 int32_t DeviceTy::data_retrieve(void *HstPtrBegin, void *TgtPtrBegin,
-    int64_t Size) {
+    int64_t Size, __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->data_retrieve_async)
+    return RTL->data_retrieve_async(RTLDeviceID, HstPtrBegin, TgtPtrBegin,
+        Size, AsyncInfoPtr);
   return RTL->data_retrieve(RTLDeviceID, HstPtrBegin, TgtPtrBegin, Size);
 }
 
 // Run region on device
 int32_t DeviceTy::run_region(void *TgtEntryPtr, void **TgtVarsPtr,
-    ptrdiff_t *TgtOffsets, int32_t TgtVarsSize) {
+    ptrdiff_t *TgtOffsets, int32_t TgtVarsSize,
+    __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->run_region_async)
+    return RTL->run_region_async(RTLDeviceID, TgtEntryPtr, TgtVarsPtr,
+        TgtOffsets, TgtVarsSize, AsyncInfoPtr);
   return RTL->run_region(RTLDeviceID, TgtEntryPtr, TgtVarsPtr, TgtOffsets,
       TgtVarsSize);
 }
@@ -359,11 +391,23 @@ int32_t DeviceTy::run_region(void *TgtEntryPtr, void **TgtVarsPtr,
 // Run team region on device.
 int32_t DeviceTy::run_team_region(void *TgtEntryPtr, void **TgtVarsPtr,
     ptrdiff_t *TgtOffsets, int32_t TgtVarsSize, int32_t NumTeams,
-    int32_t ThreadLimit, uint64_t LoopTripCount) {
+    int32_t ThreadLimit, uint64_t LoopTripCount,
+    __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->run_team_region_async)
+    return RTL->run_team_region_async(RTLDeviceID, TgtEntryPtr, TgtVarsPtr,
+        TgtOffsets, TgtVarsSize, NumTeams, ThreadLimit, LoopTripCount,
+        AsyncInfoPtr);
   return RTL->run_team_region(RTLDeviceID, TgtEntryPtr, TgtVarsPtr, TgtOffsets,
       TgtVarsSize, NumTeams, ThreadLimit, LoopTripCount);
 }
 
+// Wait for the operations issued asynchronously on device.
+int32_t DeviceTy::synchronize(__tgt_async_info *AsyncInfoPtr) {
+  if (RTL->synchronize)
+    return RTL->synchronize(RTLDeviceID, AsyncInfoPtr);
+  return OFFLOAD_SUCCESS;
+}
+
 /// Check whether a device has an associated RTL and initialize it if it's not
 /// already initialized.
 bool device_is_ready(int device_num) {
@@ -18,12 +18,14 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
 #include <vector>
 
 // Forward declarations.
 struct RTLInfoTy;
 struct __tgt_bin_desc;
 struct __tgt_target_table;
+struct __tgt_async_info;
 
 #define INF_REF_CNT (LONG_MAX>>1) // leave room for additions/subtractions
 #define CONSIDERED_INF(x) (x > (INF_REF_CNT>>1))
@@ -36,7 +38,8 @@ struct HostDataToTargetTy {
 
   uintptr_t TgtPtrBegin; // target info.
 
-  long RefCount;
+  // The only field that changes while the entry is in the mapping table.
+  mutable long RefCount;
 
   HostDataToTargetTy()
       : HstPtrBase(0), HstPtrBegin(0), HstPtrEnd(0),
@@ -48,9 +51,33 @@ struct HostDataToTargetTy {
       long RF)
       : HstPtrBase(BP), HstPtrBegin(B), HstPtrEnd(E),
         TgtPtrBegin(TB), RefCount(RF) {}
+
+  bool operator<(const HostDataToTargetTy &other) const {
+    return HstPtrBegin < other.HstPtrBegin;
+  }
 };
 
-typedef std::list<HostDataToTargetTy> HostDataToTargetListTy;
+inline bool operator<(const HostDataToTargetTy &lhs, uintptr_t rhs) {
+  return lhs.HstPtrBegin < rhs;
+}
+inline bool operator<(uintptr_t lhs, const HostDataToTargetTy &rhs) {
+  return lhs < rhs.HstPtrBegin;
+}
+
+/// The mapping table, ordered by the host begin address. The mapped host
+/// ranges do not overlap, so the only entry that may contain an address is the
+/// last one that begins at or before it.
+typedef std::set<HostDataToTargetTy, std::less<>> HostDataToTargetListTy;
+
+/// Statistics on the operations on a mapping table.
+struct MappingStatsTy {
+  uint64_t Lookups;
+  uint64_t Insertions;
+  uint64_t Removals;
+  uint64_t MaxEntries;
+
+  MappingStatsTy() : Lookups(0), Insertions(0), Removals(0), MaxEntries(0) {}
+};
 
 struct LookupResult {
   struct {
@@ -90,6 +117,7 @@ struct DeviceTy {
   bool HasPendingGlobals;
 
   HostDataToTargetListTy HostDataToTargetMap;
+  MappingStatsTy MappingStats; // protected by DataMapMtx
   PendingCtorsDtorsPerLibrary PendingCtorsDtors;
 
   ShadowPtrListTy ShadowPtrMap;
@@ -102,7 +130,8 @@ struct DeviceTy {
 
   DeviceTy(RTLInfoTy *RTL)
       : DeviceID(-1), RTL(RTL), RTLDeviceID(-1), IsInit(false), InitFlag(),
-        HasPendingGlobals(false), HostDataToTargetMap(), PendingCtorsDtors(),
+        HasPendingGlobals(false), HostDataToTargetMap(), MappingStats(),
+        PendingCtorsDtors(),
         ShadowPtrMap(), DataMapMtx(), PendingGlobalsMtx(), ShadowMtx() {}
 
   // The existence of mutexes makes DeviceTy non-copyable. We need to
@@ -111,7 +140,8 @@ struct DeviceTy {
       : DeviceID(d.DeviceID), RTL(d.RTL), RTLDeviceID(d.RTLDeviceID),
         IsInit(d.IsInit), InitFlag(), HasPendingGlobals(d.HasPendingGlobals),
         HostDataToTargetMap(d.HostDataToTargetMap),
-        PendingCtorsDtors(d.PendingCtorsDtors), ShadowPtrMap(d.ShadowPtrMap),
+        MappingStats(d.MappingStats), PendingCtorsDtors(d.PendingCtorsDtors),
+        ShadowPtrMap(d.ShadowPtrMap),
         DataMapMtx(), PendingGlobalsMtx(), ShadowMtx(),
         LoopTripCnt(d.LoopTripCnt) {}
 
@@ -122,6 +152,7 @@ struct DeviceTy {
     IsInit = d.IsInit;
     HasPendingGlobals = d.HasPendingGlobals;
     HostDataToTargetMap = d.HostDataToTargetMap;
+    MappingStats = d.MappingStats;
     PendingCtorsDtors = d.PendingCtorsDtors;
     ShadowPtrMap = d.ShadowPtrMap;
     LoopTripCnt = d.LoopTripCnt;
@@ -131,6 +162,8 @@ struct DeviceTy {
 
   long getMapEntryRefCnt(void *HstPtrBegin);
   LookupResult lookupMapping(void *HstPtrBegin, int64_t Size);
+  // Insert an entry in the mapping table, whose lock must be held.
+  void insertMapping(const HostDataToTargetTy &Entry);
   void *getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase, int64_t Size,
       bool &IsNew, bool &IsHostPtr, bool IsImplicit, bool UpdateRefCount = true,
       bool HasCloseModifier = false);
@@ -146,14 +179,22 @@ struct DeviceTy {
   int32_t initOnce();
   __tgt_target_table *load_binary(void *Img);
 
-  int32_t data_submit(void *TgtPtrBegin, void *HstPtrBegin, int64_t Size);
-  int32_t data_retrieve(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size);
+  // The calls below are asynchronous when given an AsyncInfoPtr and the RTL
+  // supports it; synchronize() then waits for their completion.
+  int32_t data_submit(void *TgtPtrBegin, void *HstPtrBegin, int64_t Size,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
+  int32_t data_retrieve(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
 
   int32_t run_region(void *TgtEntryPtr, void **TgtVarsPtr,
-      ptrdiff_t *TgtOffsets, int32_t TgtVarsSize);
+      ptrdiff_t *TgtOffsets, int32_t TgtVarsSize,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
   int32_t run_team_region(void *TgtEntryPtr, void **TgtVarsPtr,
       ptrdiff_t *TgtOffsets, int32_t TgtVarsSize, int32_t NumTeams,
-      int32_t ThreadLimit, uint64_t LoopTripCount);
+      int32_t ThreadLimit, uint64_t LoopTripCount,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
+
+  int32_t synchronize(__tgt_async_info *AsyncInfoPtr);
 
 private:
   // Call to RTL
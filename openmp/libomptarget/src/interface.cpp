@@ -118,8 +118,14 @@ EXTERN void __tgt_target_data_begin(int64_t device_id, int32_t arg_num,
   }
 #endif
 
+  // The transfers are waited for even if issuing one of them failed, so that
+  // none is left reading the pointer values owned by AsyncInfo.
+  AsyncInfoTy AsyncInfo;
   int rc = target_data_begin(Device, arg_num, args_base,
-      args, arg_sizes, arg_types);
+      args, arg_sizes, arg_types, &AsyncInfo);
+  int SyncRc = Device.synchronize(&AsyncInfo.Info);
+  if (rc == OFFLOAD_SUCCESS)
+    rc = SyncRc;
   HandleTargetOutcome(rc == OFFLOAD_SUCCESS);
 }
 
@@ -171,8 +177,9 @@ EXTERN void __tgt_target_data_end(int64_t device_id, int32_t arg_num,
   }
 #endif
 
+  __tgt_async_info AsyncInfo;
   int rc = target_data_end(Device, arg_num, args_base,
-      args, arg_sizes, arg_types);
+      args, arg_sizes, arg_types, &AsyncInfo);
   HandleTargetOutcome(rc == OFFLOAD_SUCCESS);
 }
 
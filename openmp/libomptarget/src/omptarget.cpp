@@ -134,7 +134,7 @@ static int InitLibrary(DeviceTy& Device) {
         DP("Add mapping from host " DPxMOD " to device " DPxMOD " with size %zu"
             "\n", DPxPTR(CurrHostEntry->addr), DPxPTR(CurrDeviceEntry->addr),
             CurrDeviceEntry->size);
-        Device.HostDataToTargetMap.push_front(HostDataToTargetTy(
+        Device.insertMapping(HostDataToTargetTy(
             (uintptr_t)CurrHostEntry->addr /*HstPtrBase*/,
             (uintptr_t)CurrHostEntry->addr /*HstPtrBegin*/,
             (uintptr_t)CurrHostEntry->addr + CurrHostEntry->size /*HstPtrEnd*/,
@@ -209,9 +209,13 @@ static int32_t member_of(int64_t type) {
   return ((type & OMP_TGT_MAPTYPE_MEMBER_OF) >> 48) - 1;
 }
 
-/// Internal function to do the mapping and transfer the data to the device
+/// Internal function to do the mapping and transfer the data to the device.
+/// The transfers are issued on AsyncInfo when it is not null, and the caller
+/// synchronizes it whether or not this succeeds.
 int target_data_begin(DeviceTy &Device, int32_t arg_num,
-    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types) {
+    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types,
+    AsyncInfoTy *AsyncInfo) {
+  __tgt_async_info *AsyncInfoPtr = AsyncInfo ? &AsyncInfo->Info : nullptr;
   // process each input.
   for (int32_t i = 0; i < arg_num; ++i) {
     // Ignore private variables and arrays - there is no mapping for them.
@@ -312,7 +316,8 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
       if (copy && !IsHostPtr) {
         DP("Moving %" PRId64 " bytes (hst:" DPxMOD ") -> (tgt:" DPxMOD ")\n",
             data_size, DPxPTR(HstPtrBegin), DPxPTR(TgtPtrBegin));
-        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, data_size);
+        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, data_size,
+            AsyncInfoPtr);
         if (rt != OFFLOAD_SUCCESS) {
           DP("Copying data to device failed.\n");
           return OFFLOAD_FAIL;
@@ -325,8 +330,10 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
           DPxPTR(Pointer_TgtPtrBegin), DPxPTR(TgtPtrBegin));
       uint64_t Delta = (uint64_t)HstPtrBegin - (uint64_t)HstPtrBase;
       void *TgtPtrBase = (void *)((uint64_t)TgtPtrBegin - Delta);
-      int rt = Device.data_submit(Pointer_TgtPtrBegin, &TgtPtrBase,
-          sizeof(void *));
+      void **TgtPtrBaseAddr =
+          AsyncInfo ? AsyncInfo->copyPointerValue(TgtPtrBase) : &TgtPtrBase;
+      int rt = Device.data_submit(Pointer_TgtPtrBegin, TgtPtrBaseAddr,
+          sizeof(void *), AsyncInfoPtr);
       if (rt != OFFLOAD_SUCCESS) {
         DP("Copying data to device failed.\n");
         return OFFLOAD_FAIL;
@@ -343,8 +350,22 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
 }
 
 /// Internal function to undo the mapping and retrieve the data from the device.
+/// The retrievals are issued on AsyncInfo when it is not null, and waited for
+/// before the shadow pointers are restored and the target data deallocated.
 int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
-    void **args, int64_t *arg_sizes, int64_t *arg_types) {
+    void **args, int64_t *arg_sizes, int64_t *arg_types,
+    __tgt_async_info *AsyncInfo) {
+  // Entries to finish once their data is back on the host.
+  struct PostProcessingInfo {
+    void *HstPtrBegin;
+    int64_t DataSize;
+    int64_t ArgType;
+    bool DelEntry;
+    bool ForceDelete;
+    bool HasCloseModifier;
+  };
+  std::vector<PostProcessingInfo> PostProcessing;
+
   // process each input.
   for (int32_t i = arg_num - 1; i >= 0; --i) {
     // Ignore private variables and arrays - there is no mapping for them.
@@ -415,59 +436,75 @@ int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
               TgtPtrBegin == HstPtrBegin)) {
           DP("Moving %" PRId64 " bytes (tgt:" DPxMOD ") -> (hst:" DPxMOD ")\n",
               data_size, DPxPTR(TgtPtrBegin), DPxPTR(HstPtrBegin));
-          int rt = Device.data_retrieve(HstPtrBegin, TgtPtrBegin, data_size);
+          int rt = Device.data_retrieve(HstPtrBegin, TgtPtrBegin, data_size,
+              AsyncInfo);
           if (rt != OFFLOAD_SUCCESS) {
             DP("Copying data from device failed.\n");
+            // Do not leave the retrievals issued so far writing to the host.
+            if (AsyncInfo)
+              Device.synchronize(AsyncInfo);
             return OFFLOAD_FAIL;
           }
         }
       }
 
-      // If we copied back to the host a struct/array containing pointers, we
-      // need to restore the original host pointer values from their shadow
-      // copies. If the struct is going to be deallocated, remove any remaining
-      // shadow pointer entries for this struct.
-      uintptr_t lb = (uintptr_t) HstPtrBegin;
-      uintptr_t ub = (uintptr_t) HstPtrBegin + data_size;
-      Device.ShadowMtx.lock();
-      for (ShadowPtrListTy::iterator it = Device.ShadowPtrMap.begin();
-           it != Device.ShadowPtrMap.end();) {
-        void **ShadowHstPtrAddr = (void**) it->first;
+      PostProcessing.push_back({HstPtrBegin, data_size, arg_types[i], DelEntry,
+                                ForceDelete, HasCloseModifier});
+    }
+  }
 
-        // An STL map is sorted on its keys; use this property
-        // to quickly determine when to break out of the loop.
-        if ((uintptr_t) ShadowHstPtrAddr < lb) {
-          ++it;
-          continue;
-        }
-        if ((uintptr_t) ShadowHstPtrAddr >= ub)
-          break;
+  // The retrievals must be complete before the host pointers they copied are
+  // restored and the target data they read is deallocated.
+  if (AsyncInfo && Device.synchronize(AsyncInfo) != OFFLOAD_SUCCESS) {
+    DP("Copying data from device failed.\n");
+    return OFFLOAD_FAIL;
+  }
 
-        // If we copied the struct to the host, we need to restore the pointer.
-        if (arg_types[i] & OMP_TGT_MAPTYPE_FROM) {
-          DP("Restoring original host pointer value " DPxMOD " for host "
-              "pointer " DPxMOD "\n", DPxPTR(it->second.HstPtrVal),
-              DPxPTR(ShadowHstPtrAddr));
-          *ShadowHstPtrAddr = it->second.HstPtrVal;
-        }
-        // If the struct is to be deallocated, remove the shadow entry.
-        if (DelEntry) {
-          DP("Removing shadow pointer " DPxMOD "\n", DPxPTR(ShadowHstPtrAddr));
-          it = Device.ShadowPtrMap.erase(it);
-        } else {
-          ++it;
-        }
+  for (PostProcessingInfo &Info : PostProcessing) {
+    // If we copied back to the host a struct/array containing pointers, we
+    // need to restore the original host pointer values from their shadow
+    // copies. If the struct is going to be deallocated, remove any remaining
+    // shadow pointer entries for this struct.
+    uintptr_t lb = (uintptr_t) Info.HstPtrBegin;
+    uintptr_t ub = (uintptr_t) Info.HstPtrBegin + Info.DataSize;
+    Device.ShadowMtx.lock();
+    for (ShadowPtrListTy::iterator it = Device.ShadowPtrMap.begin();
+         it != Device.ShadowPtrMap.end();) {
+      void **ShadowHstPtrAddr = (void**) it->first;
+
+      // An STL map is sorted on its keys; use this property
+      // to quickly determine when to break out of the loop.
+      if ((uintptr_t) ShadowHstPtrAddr < lb) {
+        ++it;
+        continue;
       }
-      Device.ShadowMtx.unlock();
+      if ((uintptr_t) ShadowHstPtrAddr >= ub)
+        break;
 
-      // Deallocate map
-      if (DelEntry) {
-        int rt = Device.deallocTgtPtr(HstPtrBegin, data_size, ForceDelete,
-                                      HasCloseModifier);
-        if (rt != OFFLOAD_SUCCESS) {
-          DP("Deallocating data from device failed.\n");
-          return OFFLOAD_FAIL;
-        }
+      // If we copied the struct to the host, we need to restore the pointer.
+      if (Info.ArgType & OMP_TGT_MAPTYPE_FROM) {
+        DP("Restoring original host pointer value " DPxMOD " for host "
+            "pointer " DPxMOD "\n", DPxPTR(it->second.HstPtrVal),
+            DPxPTR(ShadowHstPtrAddr));
+        *ShadowHstPtrAddr = it->second.HstPtrVal;
+      }
+      // If the struct is to be deallocated, remove the shadow entry.
+      if (Info.DelEntry) {
+        DP("Removing shadow pointer " DPxMOD "\n", DPxPTR(ShadowHstPtrAddr));
+        it = Device.ShadowPtrMap.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    Device.ShadowMtx.unlock();
+
+    // Deallocate map
+    if (Info.DelEntry) {
+      int rt = Device.deallocTgtPtr(Info.HstPtrBegin, Info.DataSize,
+                                    Info.ForceDelete, Info.HasCloseModifier);
+      if (rt != OFFLOAD_SUCCESS) {
+        DP("Deallocating data from device failed.\n");
+        return OFFLOAD_FAIL;
       }
     }
   }
@@ -633,12 +670,23 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
   TrlTblMtx.unlock();
   assert(TargetTable && "Global data has not been mapped\n");
 
+  // The transfers to the device and the kernel are issued asynchronously, and
+  // waited for once the kernel is launched. Every return below that follows
+  // an issued operation must synchronize AsyncInfo first, both so that no
+  // operation is left reading freed host memory and so that the plugin gets
+  // its queue back.
+  AsyncInfoTy AsyncInfo;
+  auto AbortTarget = [&]() {
+    Device.synchronize(&AsyncInfo.Info);
+    return OFFLOAD_FAIL;
+  };
+
   // Move data to device.
   int rc = target_data_begin(Device, arg_num, args_base, args, arg_sizes,
-      arg_types);
+      arg_types, &AsyncInfo);
   if (rc != OFFLOAD_SUCCESS) {
     DP("Call to target_data_begin failed, abort target.\n");
-    return OFFLOAD_FAIL;
+    return AbortTarget();
   }
 
   std::vector<void *> tgt_args;
@@ -685,11 +733,12 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
         }
         DP("Update lambda reference (" DPxMOD ") -> [" DPxMOD "]\n",
            DPxPTR(Pointer_TgtPtrBegin), DPxPTR(TgtPtrBegin));
-        int rt = Device.data_submit(TgtPtrBegin, &Pointer_TgtPtrBegin,
-                                    sizeof(void *));
+        int rt = Device.data_submit(
+            TgtPtrBegin, AsyncInfo.copyPointerValue(Pointer_TgtPtrBegin),
+            sizeof(void *), &AsyncInfo.Info);
         if (rt != OFFLOAD_SUCCESS) {
           DP("Copying data to device failed.\n");
-          return OFFLOAD_FAIL;
+          return AbortTarget();
         }
       }
       continue;
@@ -713,7 +762,7 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
             "abort target.\n",
             (arg_types[i] & OMP_TGT_MAPTYPE_TO ? "first-" : ""),
             DPxPTR(HstPtrBegin));
-        return OFFLOAD_FAIL;
+        return AbortTarget();
       }
       fpArrays.push_back(TgtPtrBegin);
       TgtBaseOffset = (intptr_t)HstPtrBase - (intptr_t)HstPtrBegin;
@@ -727,10 +776,11 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
 #endif
       // If first-private, copy data from host
       if (arg_types[i] & OMP_TGT_MAPTYPE_TO) {
-        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, arg_sizes[i]);
+        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, arg_sizes[i],
+            &AsyncInfo.Info);
         if (rt != OFFLOAD_SUCCESS) {
           DP ("Copying data to device failed, failed.\n");
-          return OFFLOAD_FAIL;
+          return AbortTarget();
         }
       }
     } else if (arg_types[i] & OMP_TGT_MAPTYPE_PTR_AND_OBJ) {
@@ -776,32 +826,39 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
   if (IsTeamConstruct) {
     rc = Device.run_team_region(TargetTable->EntriesBegin[TM->Index].addr,
         &tgt_args[0], &tgt_offsets[0], tgt_args.size(), team_num,
-        thread_limit, ltc);
+        thread_limit, ltc, &AsyncInfo.Info);
   } else {
     rc = Device.run_region(TargetTable->EntriesBegin[TM->Index].addr,
-        &tgt_args[0], &tgt_offsets[0], tgt_args.size());
+        &tgt_args[0], &tgt_offsets[0], tgt_args.size(), &AsyncInfo.Info);
   }
   if (rc != OFFLOAD_SUCCESS) {
     DP ("Executing target region abort target.\n");
-    return OFFLOAD_FAIL;
+    return AbortTarget();
   }
 
-  // Deallocate (first-)private arrays
-  for (auto it : fpArrays) {
-    int rt = Device.RTL->data_delete(Device.RTLDeviceID, it);
-    if (rt != OFFLOAD_SUCCESS) {
-      DP("Deallocation of (first-)private arrays failed.\n");
-      return OFFLOAD_FAIL;
-    }
+  // Wait for the kernel here rather than in target_data_end, so that a
+  // failure of the kernel is reported as one.
+  if (Device.synchronize(&AsyncInfo.Info) != OFFLOAD_SUCCESS) {
+    DP("Executing target region abort target.\n");
+    return OFFLOAD_FAIL;
   }
 
   // Move data from device.
   int rt = target_data_end(Device, arg_num, args_base, args, arg_sizes,
-      arg_types);
+      arg_types, &AsyncInfo.Info);
   if (rt != OFFLOAD_SUCCESS) {
     DP("Call to target_data_end failed, abort targe.\n");
     return OFFLOAD_FAIL;
   }
 
+  // Deallocate (first-)private arrays, now that the kernel is done with them.
+  for (auto it : fpArrays) {
+    int rt = Device.RTL->data_delete(Device.RTLDeviceID, it);
+    if (rt != OFFLOAD_SUCCESS) {
+      DP("Deallocation of (first-)private arrays failed.\n");
+      return OFFLOAD_FAIL;
+    }
+  }
+
   return OFFLOAD_SUCCESS;
 }
@@ -16,12 +16,32 @@
 #include <omptarget.h>
 
 #include <cstdint>
+#include <deque>
+
+// The operations a construct issues asynchronously on a device, and the host
+// copies of the device pointer values they transfer. A transfer reads its
+// source when it runs, after the function that issued it may have returned,
+// so the copies are owned here until the operations are synchronized.
+struct AsyncInfoTy {
+  __tgt_async_info Info;
+  // A deque does not move its elements when it grows.
+  std::deque<void *> PointerValues;
+
+  // Return the address of a copy of Ptr that stays valid as long as this
+  // record.
+  void **copyPointerValue(void *Ptr) {
+    PointerValues.push_back(Ptr);
+    return &PointerValues.back();
+  }
+};
 
 extern int target_data_begin(DeviceTy &Device, int32_t arg_num,
-    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types);
+    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types,
+    AsyncInfoTy *AsyncInfo = nullptr);
 
 extern int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
-    void **args, int64_t *arg_sizes, int64_t *arg_types);
+    void **args, int64_t *arg_sizes, int64_t *arg_types,
+    __tgt_async_info *AsyncInfo = nullptr);
 
 extern int target_data_update(DeviceTy &Device, int32_t arg_num,
     void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types);
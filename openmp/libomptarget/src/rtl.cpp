@@ -110,6 +110,26 @@ void RTLsTy::LoadRTLs() {
     // Optional functions
     *((void**) &R.init_requires) = dlsym(
         dynlib_handle, "__tgt_rtl_init_requires");
+    *((void**) &R.data_submit_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_data_submit_async");
+    *((void**) &R.data_retrieve_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_data_retrieve_async");
+    *((void**) &R.run_region_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_run_target_region_async");
+    *((void**) &R.run_team_region_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_run_target_team_region_async");
+    *((void**) &R.synchronize) = dlsym(
+        dynlib_handle, "__tgt_rtl_synchronize");
+
+    // The asynchronous functions are used only if the RTL has all of them.
+    if (!R.data_submit_async || !R.data_retrieve_async ||
+        !R.run_region_async || !R.run_team_region_async || !R.synchronize) {
+      R.data_submit_async = 0;
+      R.data_retrieve_async = 0;
+      R.run_region_async = 0;
+      R.run_team_region_async = 0;
+      R.synchronize = 0;
+    }
 
     // No devices are supported by this RTL?
     if (!(R.NumberOfDevices = R.number_of_devices())) {
@@ -362,6 +382,17 @@ void RTLsTy::UnregisterLib(__tgt_bin_desc *desc) {
           Device.PendingCtorsDtors.erase(desc);
         }
         Device.PendingGlobalsMtx.unlock();
+
+#ifdef OMPTARGET_DEBUG
+        Device.DataMapMtx.lock();
+        DP("Mapping table of device %d: %" PRIu64 " lookups, %" PRIu64
+           " insertions, %" PRIu64 " removals, at most %" PRIu64 " entries, "
+           "%zu entries left\n", Device.DeviceID,
+           Device.MappingStats.Lookups, Device.MappingStats.Insertions,
+           Device.MappingStats.Removals, Device.MappingStats.MaxEntries,
+           Device.HostDataToTargetMap.size());
+        Device.DataMapMtx.unlock();
+#endif
       }
 
       DP("Unregistered image " DPxMOD " from RTL " DPxMOD "!\n",
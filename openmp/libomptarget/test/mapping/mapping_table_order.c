@@ -0,0 +1,81 @@
+// RUN: %libomptarget-compile-aarch64-unknown-linux-gnu && %libomptarget-run-aarch64-unknown-linux-gnu | %fcheck-aarch64-unknown-linux-gnu
+// RUN: %libomptarget-compile-powerpc64-ibm-linux-gnu && %libomptarget-run-powerpc64-ibm-linux-gnu | %fcheck-powerpc64-ibm-linux-gnu
+// RUN: %libomptarget-compile-powerpc64le-ibm-linux-gnu && %libomptarget-run-powerpc64le-ibm-linux-gnu | %fcheck-powerpc64le-ibm-linux-gnu
+// RUN: %libomptarget-compile-x86_64-pc-linux-gnu && %libomptarget-run-x86_64-pc-linux-gnu | %fcheck-x86_64-pc-linux-gnu
+
+// The mapping table of a device is ordered by host address. Map adjacent
+// sections of an array out of order, and check that every section is found
+// from its begin and end addresses and from inside, that the elements between
+// mapped sections are not, and that an association of a host address that
+// already begins a mapping is only accepted with the same device address.
+
+#include <omp.h>
+#include <stdio.h>
+
+#define SECTIONS 16
+#define LEN 8
+
+int main() {
+  int dev = omp_get_default_device();
+  static int a[SECTIONS * LEN];
+
+  // Map every other section, in a scattered order.
+  for (int k = 0; k < SECTIONS / 2; ++k) {
+    int s = (k * 5) % (SECTIONS / 2) * 2;
+#pragma omp target enter data map(to : a[s * LEN : LEN]) device(dev)
+  }
+
+  int found = 0, missing = 0;
+  for (int s = 0; s < SECTIONS; ++s) {
+    int expected = s % 2 == 0;
+    int first = omp_target_is_present(&a[s * LEN], dev) != 0;
+    int inner = omp_target_is_present(&a[s * LEN + LEN / 2], dev) != 0;
+    int last = omp_target_is_present(&a[s * LEN + LEN - 1], dev) != 0;
+    if (first == expected && inner == expected && last == expected)
+      ++found;
+    else
+      ++missing;
+  }
+  // CHECK: found 16 missing 0
+  printf("found %d missing %d\n", found, missing);
+
+  // Map the sections in between, which are adjacent to mapped ones on both
+  // sides, and check that every element is then found.
+  for (int s = 1; s < SECTIONS; s += 2) {
+#pragma omp target enter data map(to : a[s * LEN : LEN]) device(dev)
+  }
+  int present = 0;
+  for (int i = 0; i < SECTIONS * LEN; ++i)
+    present += omp_target_is_present(&a[i], dev) != 0;
+  // CHECK: present 128
+  printf("present %d\n", present);
+
+  for (int s = 0; s < SECTIONS; ++s) {
+#pragma omp target exit data map(release : a[s * LEN : LEN]) device(dev)
+  }
+  int left = 0;
+  for (int i = 0; i < SECTIONS * LEN; ++i)
+    left += omp_target_is_present(&a[i], dev) != 0;
+  // CHECK: left 0
+  printf("left %d\n", left);
+
+  // Associations are keyed by the host begin address.
+  int b[LEN];
+  void *d1 = omp_target_alloc(sizeof(b), dev);
+  void *d2 = omp_target_alloc(sizeof(b), dev);
+  // CHECK: associate 0
+  printf("associate %d\n", omp_target_associate_ptr(b, d1, sizeof(b), 0, dev));
+  // CHECK: same 0
+  printf("same %d\n", omp_target_associate_ptr(b, d1, sizeof(b), 0, dev));
+  // CHECK: different 1
+  printf("different %d\n",
+         omp_target_associate_ptr(b, d2, sizeof(b), 0, dev) != 0);
+  // CHECK: disassociate 0
+  printf("disassociate %d\n", omp_target_disassociate_ptr(b, dev));
+  // CHECK: after 0
+  printf("after %d\n", omp_target_is_present(b, dev) != 0);
+  omp_target_free(d1, dev);
+  omp_target_free(d2, dev);
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+// RUN: %libomptarget-compile-aarch64-unknown-linux-gnu && %libomptarget-run-aarch64-unknown-linux-gnu | %fcheck-aarch64-unknown-linux-gnu
+// RUN: %libomptarget-compile-powerpc64-ibm-linux-gnu && %libomptarget-run-powerpc64-ibm-linux-gnu | %fcheck-powerpc64-ibm-linux-gnu
+// RUN: %libomptarget-compile-powerpc64le-ibm-linux-gnu && %libomptarget-run-powerpc64le-ibm-linux-gnu | %fcheck-powerpc64le-ibm-linux-gnu
+// RUN: %libomptarget-compile-x86_64-pc-linux-gnu && %libomptarget-run-x86_64-pc-linux-gnu | %fcheck-x86_64-pc-linux-gnu
+// RUN: %libomptarget-compile-nvptx64-nvidia-cuda && %libomptarget-run-nvptx64-nvidia-cuda | %fcheck-nvptx64-nvidia-cuda
+
+// The device copy of a mapped pointer is written by a transfer that is issued
+// asynchronously, from a value the runtime computes. Check that the value the
+// device sees is the target address of the pointee, both for a target region
+// and for a target data construct, and that many constructs in a row do not
+// run out of device queues.
+
+#include <stdio.h>
+
+#define N 64
+#define ITERS 2000
+
+struct S {
+  int *p;
+  int n;
+};
+
+int main() {
+  int data[N];
+  struct S s = {data, N};
+
+  for (int i = 0; i < N; ++i)
+    data[i] = i;
+
+  // PTR_AND_OBJ entries of a target region.
+  for (int it = 0; it < ITERS; ++it) {
+#pragma omp target map(to : s) map(tofrom : s.p[0 : N])
+    for (int i = 0; i < s.n; ++i)
+      s.p[i] += 1;
+  }
+
+  int sum = 0;
+  for (int i = 0; i < N; ++i)
+    sum += data[i] - i;
+  // CHECK: target: 128000
+  printf("target: %d\n", sum);
+
+  // PTR_AND_OBJ entries of a target data construct.
+  for (int it = 0; it < ITERS; ++it) {
+#pragma omp target enter data map(to : s) map(to : s.p[0 : N])
+#pragma omp target
+    for (int i = 0; i < s.n; ++i)
+      s.p[i] -= 1;
+#pragma omp target exit data map(from : s.p[0 : N]) map(release : s)
+  }
+
+  sum = 0;
+  for (int i = 0; i < N; ++i)
+    sum += data[i] - i;
+  // CHECK: target data: 0
+  printf("target data: %d\n", sum);
+
+  // The host pointer is restored after the device copy is retrieved.
+  // CHECK: pointer restored: 1
+  printf("pointer restored: %d\n", s.p == data);
+
+  return 0;
+}
@@ -357,6 +357,9 @@ enum sched_type : kmp_int32 {
   kmp_sch_guided_simd = 46, /**< guided with chunk adjustment */
   kmp_sch_runtime_simd = 47, /**< runtime with chunk adjustment */
 
+  /* accessible only through OMP_SCHEDULE environment variable */
+  kmp_sch_adaptive = 48, /**< batches of chunks sized by their run time */
+
   /* accessible only through KMP_SCHEDULE environment variable */
   kmp_sch_upper, /**< upper bound for unordered values */
 
@@ -1745,6 +1748,9 @@ typedef struct kmp_disp {
 #define KMP_BARRIER_UNUSED_STATE (1 << KMP_BARRIER_UNUSED_BIT)
 #define KMP_BARRIER_STATE_BUMP (1 << KMP_BARRIER_BUMP_BIT)
 
+/* rounds of the dissemination gather, enough for teams of 2^16 threads */
+#define KMP_DISSEMINATION_ROUNDS 16
+
 #if (KMP_BARRIER_SLEEP_BIT >= KMP_BARRIER_BUMP_BIT)
 #error "Barrier sleep bit must be smaller than barrier bump bit"
 #endif
@@ -1791,6 +1797,9 @@ typedef enum kmp_bar_pat { /* Barrier communication patterns */
                                2, /* Hypercube-embedded tree with min branching
                                      factor 2^n */
                            bp_hierarchical_bar = 3, /* Machine hierarchy tree */
+                           bp_dissemination_bar =
+                               4, /* Dissemination gather, the release is the
+                                     hypercube-embedded tree one */
                            bp_last_bar /* Placeholder to mark the end */
 } kmp_bar_pat_e;
 
@@ -1850,6 +1859,11 @@ typedef struct KMP_ALIGN_CACHE kmp_bstate {
   kmp_uint8 offset;
   kmp_uint8 wait_flag;
   kmp_uint8 use_oncore_barrier;
+  // Signals of the rounds of the dissemination gather, for the even and the odd
+  // barriers of the team. Each round is signaled by one thread and reset by
+  // this thread once it has seen the signal.
+  KMP_ALIGN_CACHE volatile kmp_uint64
+      b_round_arrived[2][KMP_DISSEMINATION_ROUNDS];
 #if USE_DEBUGGER
   // The following field is intended for the debugger solely. Only the worker
   // thread itself accesses this field: the worker increases it by 1 when it
@@ -2321,6 +2335,9 @@ typedef struct kmp_base_thread_data {
   kmp_int32 td_deque_ntasks; // Number of tasks in deque
   // GEH: shouldn't this be volatile since used in while-spin?
   kmp_int32 td_deque_last_stolen; // Thread number of last successful steal
+  // Number of levels of the machine hierarchy above the nearest threads the
+  // next random victim is picked from, -1 once the whole team was tried
+  kmp_int32 td_deque_steal_level;
 #ifdef BUILD_TIED_TASK_STACK
   kmp_task_stack_t td_susp_tied_tasks; // Stack of suspended tied tasks for task
 // scheduling constraint
@@ -2340,6 +2357,10 @@ typedef union KMP_ALIGN_CACHE kmp_thread_data {
 } kmp_thread_data_t;
 
 // Data for task teams which are used when tasking is enabled for the team
+// Maximum number of levels of the machine hierarchy that task stealing tells
+// apart; the levels above are treated like the whole team
+#define KMP_STEAL_MAX_LEVELS 8
+
 typedef struct kmp_base_task_team {
   kmp_bootstrap_lock_t
       tt_threads_lock; /* Lock used to allocate per-thread part of task team */
@@ -2355,6 +2376,11 @@ typedef struct kmp_base_task_team {
   kmp_int32 tt_max_threads; // # entries allocated for threads_data array
   kmp_int32 tt_found_proxy_tasks; // found proxy tasks since last barrier
   kmp_int32 tt_untied_task_encountered;
+  // Thread ids under a node of each level of the machine hierarchy above the
+  // leaves, up to the first level that holds the whole team; set up with
+  // tt_threads_data and used to pick steal victims
+  kmp_int32 tt_steal_levels;
+  kmp_uint32 tt_steal_span[KMP_STEAL_MAX_LEVELS];
 
   KMP_ALIGN_CACHE
   std::atomic<kmp_int32> tt_unfinished_threads; /* #threads still active */
@@ -3355,6 +3381,7 @@ extern void __kmp_aux_display_affinity(int gtid, const char *format);
 
 extern void __kmp_cleanup_hierarchy();
 extern void __kmp_get_hierarchy(kmp_uint32 nproc, kmp_bstate_t *thr_bar);
+extern kmp_uint32 __kmp_get_hierarchy_span(kmp_uint32 nproc, kmp_uint32 level);
 
 #if KMP_USE_FUTEX
 
@@ -44,6 +44,19 @@ void __kmp_get_hierarchy(kmp_uint32 nproc, kmp_bstate_t *thr_bar) {
   thr_bar->skip_per_level = machine_hierarchy.skipPerLevel;
 }
 
+// Number of consecutive thread ids under a node at the given level of the
+// hierarchy, which maps the thread ids to the leaves like the hierarchical
+// barrier does. Used by the task stealing to prefer the nearest victims.
+kmp_uint32 __kmp_get_hierarchy_span(kmp_uint32 nproc, kmp_uint32 level) {
+  if (TCR_1(machine_hierarchy.uninitialized))
+    machine_hierarchy.init(NULL, nproc);
+  if (nproc > machine_hierarchy.base_num_threads)
+    machine_hierarchy.resize(nproc);
+  if (level >= machine_hierarchy.depth)
+    return nproc;
+  return machine_hierarchy.skipPerLevel[level];
+}
+
 #if KMP_AFFINITY_SUPPORTED
 
 bool KMPAffinity::picked_api = false;
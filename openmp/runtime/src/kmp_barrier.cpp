@@ -1249,6 +1249,118 @@ static void __kmp_hierarchical_barrier_release(
                 gtid, team->t.t_id, tid, bt));
 }
 
+// Dissemination Barrier
+
+/* In round k of the gather each thread signals the thread 2^k after it and
+   waits for the thread 2^k before it, modulo the number of threads. After
+   ceil(log2(nproc)) rounds every thread knows that all the threads have
+   arrived: no thread waits for more than one signal per round, and each thread
+   only polls the flags of its own barrier data. A thread may be signaled for
+   the next barrier before it has seen the signals of the current one, so the
+   even and the odd barriers of the team use separate flags, and every flag is
+   reset by the thread that waited for it. The reductions need a tree, so they
+   go through the hypercube-embedded tree gather instead, as do the teams larger
+   than the flags allow and the nested teams, whose master could otherwise see
+   the early signals of its outer team. So does the join barrier: the master may
+   leave the gather while a worker still waits for its last rounds, and after a
+   join the master hands the workers to other teams, which reinitializes their
+   barrier data. After the other barriers the workers wait for the release, so
+   they finish their rounds before the team moves on. */
+static void __kmp_dissemination_barrier_gather(
+    enum barrier_type bt, kmp_info_t *this_thr, int gtid, int tid,
+    void (*reduce)(void *, void *) USE_ITT_BUILD_ARG(void *itt_sync_obj)) {
+  KMP_TIME_DEVELOPER_PARTITIONED_BLOCK(KMP_dissem_gather);
+  kmp_team_t *team = this_thr->th.th_team;
+  kmp_bstate_t *thr_bar = &this_thr->th.th_bar[bt].bb;
+  kmp_info_t **other_threads = team->t.t_threads;
+  kmp_uint32 nproc = this_thr->th.th_team_nproc;
+  kmp_info_t *partners[KMP_DISSEMINATION_ROUNDS];
+  kmp_uint64 new_state;
+  kmp_uint32 rounds;
+  kmp_uint32 round;
+  kmp_uint32 offset;
+  int parity;
+
+  int level = team->t.t_level;
+  if (other_threads[0]
+          ->th.th_teams_microtask) // are we inside the teams construct?
+    if (this_thr->th.th_teams_size.nteams > 1)
+      ++level; // level was not increased in teams construct for team_of_masters
+  if (reduce != NULL || level != 1 || bt == bs_forkjoin_barrier ||
+      nproc > (1U << KMP_DISSEMINATION_ROUNDS)) {
+    if (__kmp_barrier_gather_branch_bits[bt])
+      __kmp_hyper_barrier_gather(bt, this_thr, gtid, tid,
+                                 reduce USE_ITT_BUILD_ARG(itt_sync_obj));
+    else
+      __kmp_linear_barrier_gather(bt, this_thr, gtid, tid,
+                                  reduce USE_ITT_BUILD_ARG(itt_sync_obj));
+    return;
+  }
+
+  KA_TRACE(20, ("__kmp_dissemination_barrier_gather: T#%d(%d:%d) enter for "
+                "barrier type %d\n",
+                gtid, team->t.t_id, tid, bt));
+  KMP_DEBUG_ASSERT(this_thr == other_threads[this_thr->th.th_info.ds.ds_tid]);
+
+#if USE_ITT_BUILD && USE_ITT_NOTIFY
+  // Barrier imbalance - save arrive time to the thread
+  if (__kmp_forkjoin_frames_mode == 3 || __kmp_forkjoin_frames_mode == 2) {
+    this_thr->th.th_bar_arrive_time = this_thr->th.th_bar_min_time =
+        __itt_get_timestamp();
+  }
+#endif
+  /* Look up the partners first: once this thread has signaled its first
+     partner, it may not assume that the team is valid any more - it could be
+     deallocated by the master thread at any time.  */
+  new_state = team->t.t_bar[bt].b_arrived + KMP_BARRIER_STATE_BUMP;
+  parity = (int)((new_state >> KMP_BARRIER_BUMP_BIT) & 1);
+  for (rounds = 0, offset = 1; offset < nproc; ++rounds, offset <<= 1)
+    partners[rounds] = other_threads[(tid + offset) % nproc];
+
+  for (round = 0; round < rounds; ++round) {
+    kmp_info_t *partner_thr = partners[round];
+    kmp_bstate_t *partner_bar = &partner_thr->th.th_bar[bt].bb;
+    volatile kmp_uint64 *partner_loc =
+        &partner_bar->b_round_arrived[parity][round];
+    volatile kmp_uint64 *loc = &thr_bar->b_round_arrived[parity][round];
+
+    KA_TRACE(20, ("__kmp_dissemination_barrier_gather: T#%d(%d) round %u "
+                  "releasing T#%d arrived(%p): %llu => %llu\n",
+                  gtid, tid, round, __kmp_gtid_from_thread(partner_thr),
+                  partner_loc, *partner_loc,
+                  *partner_loc + KMP_BARRIER_STATE_BUMP));
+    // Signal the partner 2^round after this thread
+    ANNOTATE_BARRIER_BEGIN(partner_loc);
+    kmp_flag_64 p_flag(partner_loc, partner_thr);
+    p_flag.release();
+
+    KA_TRACE(20, ("__kmp_dissemination_barrier_gather: T#%d(%d) round %u "
+                  "wait arrived(%p) == %u\n",
+                  gtid, tid, round, loc, KMP_BARRIER_STATE_BUMP));
+    // Wait for the thread 2^round before this thread
+    kmp_flag_64 flag(loc, KMP_BARRIER_STATE_BUMP);
+    flag.wait(this_thr, FALSE USE_ITT_BUILD_ARG(itt_sync_obj));
+    ANNOTATE_BARRIER_END(loc);
+    // The next signal of this round is for the barrier after the next one,
+    // which cannot start before this thread has arrived at the next one.
+    TCW_8(*loc, KMP_INIT_BARRIER_STATE);
+  }
+
+  // Keep the arrived count in step for the other gather patterns
+  thr_bar->b_arrived = new_state;
+  if (KMP_MASTER_TID(tid)) {
+    // Need to update the team arrived pointer if we are the master thread
+    team->t.t_bar[bt].b_arrived = new_state;
+    KA_TRACE(20, ("__kmp_dissemination_barrier_gather: T#%d(%d:%d) set team %d "
+                  "arrived(%p) = %llu\n",
+                  gtid, team->t.t_id, tid, team->t.t_id,
+                  &team->t.t_bar[bt].b_arrived, team->t.t_bar[bt].b_arrived));
+  }
+  KA_TRACE(20, ("__kmp_dissemination_barrier_gather: T#%d(%d) exit for "
+                "barrier type %d\n",
+                gtid, tid, bt));
+}
+
 // End of Barrier Algorithms
 
 // type traits for cancellable value
@@ -1394,6 +1506,11 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
             bt, this_thr, gtid, tid, reduce USE_ITT_BUILD_ARG(itt_sync_obj));
         break;
       }
+      case bp_dissemination_bar: {
+        __kmp_dissemination_barrier_gather(
+            bt, this_thr, gtid, tid, reduce USE_ITT_BUILD_ARG(itt_sync_obj));
+        break;
+      }
       case bp_tree_bar: {
         // don't set branch bits to 0; use linear
         KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]);
@@ -1494,6 +1611,7 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
             bt, this_thr, gtid, tid, FALSE USE_ITT_BUILD_ARG(itt_sync_obj));
       } else {
         switch (__kmp_barrier_release_pattern[bt]) {
+        case bp_dissemination_bar: // released through the hypercube
         case bp_hyper_bar: {
           KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
           __kmp_hyper_barrier_release(bt, this_thr, gtid, tid,
@@ -1624,6 +1742,7 @@ void __kmp_end_split_barrier(enum barrier_type bt, int gtid) {
   if (!team->t.t_serialized) {
     if (KMP_MASTER_GTID(gtid)) {
       switch (__kmp_barrier_release_pattern[bt]) {
+      case bp_dissemination_bar: // released through the hypercube
       case bp_hyper_bar: {
         KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
         __kmp_hyper_barrier_release(bt, this_thr, gtid, tid,
@@ -1781,6 +1900,11 @@ void __kmp_join_barrier(int gtid) {
                                       NULL USE_ITT_BUILD_ARG(itt_sync_obj));
     break;
   }
+  case bp_dissemination_bar: {
+    __kmp_dissemination_barrier_gather(bs_forkjoin_barrier, this_thr, gtid,
+                                       tid, NULL USE_ITT_BUILD_ARG(itt_sync_obj));
+    break;
+  }
   case bp_tree_bar: {
     KMP_ASSERT(__kmp_barrier_gather_branch_bits[bs_forkjoin_barrier]);
     __kmp_tree_barrier_gather(bs_forkjoin_barrier, this_thr, gtid, tid,
@@ -1960,6 +2084,7 @@ void __kmp_fork_barrier(int gtid, int tid) {
   } // master
 
   switch (__kmp_barrier_release_pattern[bs_forkjoin_barrier]) {
+  case bp_dissemination_bar: // released through the hypercube
   case bp_hyper_bar: {
     KMP_ASSERT(__kmp_barrier_release_branch_bits[bs_forkjoin_barrier]);
     __kmp_hyper_barrier_release(bs_forkjoin_barrier, this_thr, gtid, tid,
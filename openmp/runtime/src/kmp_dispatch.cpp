@@ -39,6 +39,21 @@
 /* ------------------------------------------------------------------------ */
 /* ------------------------------------------------------------------------ */
 
+// Time stamps of the adaptive schedule
+#if KMP_OS_UNIX && (KMP_ARCH_X86 || KMP_ARCH_X86_64)
+extern kmp_uint64 __kmp_ticks_per_msec;
+#define KMP_ADAPTIVE_NOW() __kmp_hardware_timestamp()
+#define KMP_ADAPTIVE_TICKS_PER_MSEC __kmp_ticks_per_msec
+#else
+extern kmp_uint64 __kmp_now_nsec();
+#define KMP_ADAPTIVE_NOW() __kmp_now_nsec()
+#define KMP_ADAPTIVE_TICKS_PER_MSEC (KMP_NSEC_PER_SEC / 1000)
+#endif
+// The adaptive schedule sizes its batches to run for about 20 usec: long
+// enough to make the updates of the shared chunk index rare, short enough to
+// balance the load.
+#define KMP_ADAPTIVE_BATCH_TICKS (KMP_ADAPTIVE_TICKS_PER_MSEC / 50)
+
 void __kmp_dispatch_deo_error(int *gtid_ref, int *cid_ref, ident_t *loc_ref) {
   kmp_info_t *th;
 
@@ -640,6 +655,27 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
                    "kmp_sch_static_chunked/kmp_sch_dynamic_chunked cases\n",
                    gtid));
     break;
+  case kmp_sch_adaptive: {
+    KD_TRACE(100,
+             ("__kmp_dispatch_init_algorithm: T#%d kmp_sch_adaptive case\n",
+              gtid));
+    if (pr->u.p.parm1 <= 0) {
+      pr->u.p.parm1 = KMP_DEFAULT_CHUNK;
+    }
+    if (nproc > 1) {
+      // parm2 is the number of chunks of the previous batch (none yet), and
+      // parm3 (with parm4) the time the previous batch was claimed at
+      pr->u.p.parm2 = 0;
+      *(kmp_uint64 *)&pr->u.p.parm3 = 0;
+    } else {
+      KD_TRACE(100, ("__kmp_dispatch_init_algorithm: T#%d falling-through to "
+                     "kmp_sch_static_greedy\n",
+                     gtid));
+      schedule = kmp_sch_static_greedy;
+      pr->u.p.parm1 = tc;
+    }
+  } // case
+  break;
   case kmp_sch_trapezoidal: {
     /* TSS: trapezoid self-scheduling, minimum chunk_size = parm1 */
 
@@ -917,6 +953,7 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
         cur_chunk = pr->u.p.parm1;
         break;
       case kmp_sch_dynamic_chunked:
+      case kmp_sch_adaptive:
         schedtype = 1;
         break;
       case kmp_sch_guided_iterative_chunked:
@@ -1513,6 +1550,71 @@ int __kmp_dispatch_next_algorithm(int gtid,
   } // case
   break;
 
+  case kmp_sch_adaptive: {
+    T chunk = pr->u.p.parm1;
+    UT nchunks = (pr->u.p.tc - 1) / chunk + 1;
+    UT batch = pr->u.p.parm2;
+    kmp_uint64 *stamp = (kmp_uint64 *)&pr->u.p.parm3;
+    kmp_uint64 now = KMP_ADAPTIVE_NOW();
+
+    KD_TRACE(100,
+             ("__kmp_dispatch_next_algorithm: T#%d kmp_sch_adaptive case\n",
+              gtid));
+
+    // The shared index counts chunks, as under dynamic. A thread claims a
+    // batch of chunks at once, sized so that it runs for about
+    // KMP_ADAPTIVE_BATCH_TICKS according to the time the previous batch took.
+    if (batch == 0) {
+      batch = 1;
+    } else {
+      kmp_uint64 elapsed = now - *stamp;
+      kmp_uint64 target = (kmp_uint64)batch * KMP_ADAPTIVE_BATCH_TICKS /
+                          (elapsed ? elapsed : 1);
+      // Go halfway to the target, so that a single slow or fast batch does
+      // not swing the size, and at most double it.
+      target = (batch + target) / 2;
+      if (target > 2 * (kmp_uint64)batch)
+        target = 2 * (kmp_uint64)batch;
+      batch = target ? (UT)target : 1;
+    }
+    // Like guided, leave enough chunks for the other threads at the end
+    init = sh->u.s.iteration;
+    if (init < nchunks) {
+      UT share = (nchunks - init) / (2 * (UT)nproc);
+      if (batch > share)
+        batch = share ? share : 1;
+    }
+    pr->u.p.parm2 = batch;
+    *stamp = now;
+
+    init = test_then_add<ST>(RCAST(volatile ST *, &sh->u.s.iteration),
+                             (ST)batch);
+    if ((status = (init < nchunks)) == 0) {
+      *p_lb = 0;
+      *p_ub = 0;
+      if (p_st != NULL)
+        *p_st = 0;
+    } else {
+      trip = pr->u.p.tc - 1;
+      if ((last = (batch >= nchunks - init)) != 0)
+        limit = trip;
+      else
+        limit = (init + batch) * chunk - 1;
+      init *= chunk;
+      start = pr->u.p.lb;
+      incr = pr->u.p.st;
+      if (p_st != NULL)
+        *p_st = incr;
+      *p_lb = start + init * incr;
+      *p_ub = start + limit * incr;
+      if (pr->flags.ordered) {
+        pr->u.p.ordered_lower = init;
+        pr->u.p.ordered_upper = limit;
+      } // if
+    } // if
+  } // case
+  break;
+
   case kmp_sch_guided_iterative_chunked: {
     T chunkspec = pr->u.p.parm1;
     KD_TRACE(100, ("__kmp_dispatch_next_algorithm: T#%d kmp_sch_guided_chunked "
@@ -2819,6 +2819,7 @@ void __kmp_get_schedule(int gtid, kmp_sched_t *kind, int *chunk) {
     *kind = kmp_sched_static;
     break;
   case kmp_sch_dynamic_chunked:
+  case kmp_sch_adaptive: // a dynamic schedule with adaptive chunks
     *kind = kmp_sched_dynamic;
     break;
   case kmp_sch_guided_chunked:
@@ -3682,6 +3682,8 @@ static const char *__kmp_parse_single_omp_schedule(const char *name,
   else if (!__kmp_strcasecmp_with_sentinel("static_steal", ptr, *delim))
     sched = kmp_sch_static_steal;
 #endif
+  else if (!__kmp_strcasecmp_with_sentinel("adaptive", ptr, *delim))
+    sched = kmp_sch_adaptive;
   else {
     // If there is no proper schedule kind, then this schedule is invalid
     KMP_WARNING(StgInvalidValue, name, value);
@@ -3816,6 +3818,9 @@ static void __kmp_stg_print_omp_schedule(kmp_str_buf_t *buffer,
     case kmp_sch_static_steal:
       __kmp_str_buf_print(buffer, "%s,%d'\n", "static_steal", __kmp_chunk);
       break;
+    case kmp_sch_adaptive:
+      __kmp_str_buf_print(buffer, "%s,%d'\n", "adaptive", __kmp_chunk);
+      break;
     case kmp_sch_auto:
       __kmp_str_buf_print(buffer, "%s,%d'\n", "auto", __kmp_chunk);
       break;
@@ -3841,6 +3846,9 @@ static void __kmp_stg_print_omp_schedule(kmp_str_buf_t *buffer,
     case kmp_sch_static_steal:
       __kmp_str_buf_print(buffer, "%s'\n", "static_steal");
       break;
+    case kmp_sch_adaptive:
+      __kmp_str_buf_print(buffer, "%s'\n", "adaptive");
+      break;
     case kmp_sch_auto:
       __kmp_str_buf_print(buffer, "%s'\n", "auto");
       break;
@@ -112,7 +112,9 @@ enum stats_state_e {
   macro(OMP_TASKLOOP, 0, arg)                                                  \
   macro(TASK_executed, 0, arg)                                                 \
   macro(TASK_cancelled, 0, arg)                                                \
-  macro(TASK_stolen, 0, arg)
+  macro(TASK_stolen, 0, arg)                                                   \
+  macro(TASK_stolen_near, 0, arg)                                              \
+  macro(TASK_stolen_far, 0, arg)
 // clang-format on
 
 /*!
@@ -243,11 +245,13 @@ enum stats_state_e {
 // KMP_tree_release       -- time in __kmp_tree_barrier_release
 // KMP_hyper_gather       -- time in __kmp_hyper_barrier_gather
 // KMP_hyper_release      -- time in __kmp_hyper_barrier_release
+// KMP_dissem_gather      -- time in __kmp_dissemination_barrier_gather
 // clang-format off
 #define KMP_FOREACH_DEVELOPER_TIMER(macro, arg)                                \
   macro(KMP_fork_call, 0, arg)                                                 \
   macro(KMP_join_call, 0, arg)                                                 \
   macro(KMP_end_split_barrier, 0, arg)                                         \
+  macro(KMP_dissem_gather, 0, arg)                                             \
   macro(KMP_hier_gather, 0, arg)                                               \
   macro(KMP_hier_release, 0, arg)                                              \
   macro(KMP_hyper_gather, 0, arg)                                              \
@@ -2770,6 +2770,46 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_get_steal_victim: pick a random thread of the team, other than tid, to
+// steal a task from. The victim is picked in the smallest subtree of the
+// machine hierarchy that holds other threads of the team, widened by
+// td_deque_steal_level levels, so that the tasks move between the threads of a
+// core or a socket before they move across sockets. *nearest is set if the
+// victim is in that smallest subtree.
+static kmp_int32 __kmp_get_steal_victim(kmp_info_t *thread,
+                                        kmp_task_team_t *task_team,
+                                        kmp_thread_data_t *thread_data,
+                                        kmp_int32 tid, int *nearest) {
+  kmp_int32 nthreads = task_team->tt.tt_nproc;
+  kmp_int32 widen = thread_data->td.td_deque_steal_level;
+  kmp_int32 first = 0, count = nthreads, level;
+  *nearest = TRUE;
+  for (level = 0; level < task_team->tt.tt_steal_levels; ++level) {
+    kmp_int32 span = (kmp_int32)task_team->tt.tt_steal_span[level];
+    first = tid - tid % span;
+    count = KMP_MIN(span, nthreads - first);
+    if (count > 1) {
+      if (widen <= 0)
+        break;
+      --widen;
+      *nearest = FALSE;
+    }
+  }
+  if (level == task_team->tt.tt_steal_levels) {
+    // The whole team; the next failed steal starts over from the nearest
+    // threads.
+    thread_data->td.td_deque_steal_level = -1;
+    first = 0;
+    count = nthreads;
+  }
+  KMP_DEBUG_ASSERT(count > 1 && first <= tid && tid < first + count);
+  kmp_int32 victim_tid = first + __kmp_get_random(thread) % (count - 1);
+  if (victim_tid >= tid) {
+    ++victim_tid; // Adjusts random distribution to exclude self
+  }
+  return victim_tid;
+}
+
 // __kmp_execute_tasks_template: Choose and execute tasks until either the
 // condition is statisfied (return true) or there are none left (return false).
 //
@@ -2792,6 +2832,7 @@ static inline int __kmp_execute_tasks_template(
   std::atomic<kmp_int32> *unfinished_threads;
   kmp_int32 nthreads, victim_tid = -2, use_own_tasks = 1, new_victim = 0,
                       tid = thread->th.th_info.ds.ds_tid;
+  int nearest_victim = TRUE, random_victim = FALSE;
 
   KMP_DEBUG_ASSERT(__kmp_tasking_mode != tskm_immediate_exec);
   KMP_DEBUG_ASSERT(thread == __kmp_threads[gtid]);
@@ -2831,16 +2872,18 @@ static inline int __kmp_execute_tasks_template(
         }
         if (victim_tid != -1) { // found last victim
           asleep = 0;
+          random_victim = FALSE;
         } else if (!new_victim) { // no recent steals and we haven't already
           // used a new victim; select a random thread
+          random_victim = TRUE;
           do { // Find a different thread to steal work from.
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
-            // and failed.  Arch says that's not such a great idea.
-            victim_tid = __kmp_get_random(thread) % (nthreads - 1);
-            if (victim_tid >= tid) {
-              ++victim_tid; // Adjusts random distribution to exclude self
-            }
+            // and failed.  Arch says that's not such a great idea. The random
+            // threads are the nearest ones first, and farther ones after each
+            // failed steal.
+            victim_tid = __kmp_get_steal_victim(
+                thread, task_team, &threads_data[tid], tid, &nearest_victim);
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
             // There is a slight chance that __kmp_enable_tasking() did not wake
@@ -2876,6 +2919,12 @@ static inline int __kmp_execute_tasks_template(
                                   is_constrained);
         }
         if (task != NULL) { // set last stolen to victim
+          if (nearest_victim) {
+            KMP_COUNT_BLOCK(TASK_stolen_near);
+          } else {
+            KMP_COUNT_BLOCK(TASK_stolen_far);
+          }
+          threads_data[tid].td.td_deque_steal_level = 0;
           if (threads_data[tid].td.td_deque_last_stolen != victim_tid) {
             threads_data[tid].td.td_deque_last_stolen = victim_tid;
             // The pre-refactored code did not try more than 1 successful new
@@ -2885,6 +2934,8 @@ static inline int __kmp_execute_tasks_template(
           }
         } else { // No tasks found; unset last_stolen
           KMP_CHECK_UPDATE(threads_data[tid].td.td_deque_last_stolen, -1);
+          if (random_victim && !asleep) // widen the next random steal
+            ++threads_data[tid].td.td_deque_steal_level;
           victim_tid = -2; // no successful victim found
         }
       }
@@ -3129,6 +3180,7 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
 
   // Initialize last stolen task field to "none"
   thread_data->td.td_deque_last_stolen = -1;
+  thread_data->td.td_deque_steal_level = 0;
 
   KMP_DEBUG_ASSERT(TCR_4(thread_data->td.td_deque_ntasks) == 0);
   KMP_DEBUG_ASSERT(thread_data->td.td_deque_head == 0);
@@ -3268,6 +3320,17 @@ static int __kmp_realloc_task_threads_data(kmp_info_t *thread,
       }
     }
 
+    // The spans of the machine hierarchy only depend on the team size, so the
+    // steals don't look them up.
+    task_team->tt.tt_steal_levels = 0;
+    for (kmp_uint32 level = 1;
+         task_team->tt.tt_steal_levels < KMP_STEAL_MAX_LEVELS; ++level) {
+      kmp_uint32 span = __kmp_get_hierarchy_span(nthreads, level);
+      if (span >= (kmp_uint32)nthreads)
+        break;
+      task_team->tt.tt_steal_span[task_team->tt.tt_steal_levels++] = span;
+    }
+
     KMP_MB();
     TCW_SYNC_4(task_team->tt.tt_found_tasks, TRUE);
   }
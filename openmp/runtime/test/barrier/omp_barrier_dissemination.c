@@ -0,0 +1,80 @@
+// RUN: %libomp-compile
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=dissemination,dissemination KMP_FORKJOIN_BARRIER_PATTERN=dissemination,hyper KMP_REDUCTION_BARRIER_PATTERN=dissemination,dissemination %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=dissemination,dissemination KMP_FORKJOIN_BARRIER_PATTERN=dissemination,dissemination KMP_BLOCKTIME=0 %libomp-run
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define MAX_THREADS 9
+#define PHASES 200
+
+// Every thread writes its phase before the barrier and reads the phases of
+// all the threads after it.
+int test_barrier_phases(int nthreads) {
+  int phase[MAX_THREADS];
+  int errors = 0;
+
+  #pragma omp parallel num_threads(nthreads) shared(phase, errors)
+  {
+    int i, p;
+    int rank = omp_get_thread_num();
+    int n = omp_get_num_threads();
+    for (p = 0; p < PHASES; p++) {
+      phase[rank] = p;
+      #pragma omp barrier
+      for (i = 0; i < n; i++) {
+        if (phase[i] != p) {
+          #pragma omp atomic
+          errors++;
+        }
+      }
+      #pragma omp barrier
+    }
+  }
+  return errors == 0;
+}
+
+// The reductions go through the reduction barrier, and the parallel regions
+// through the fork/join one, with a different team size each time.
+int test_reduction(int nthreads) {
+  int sum = 0;
+  int i;
+  #pragma omp parallel for num_threads(nthreads) reduction(+:sum)
+  for (i = 1; i <= LOOPCOUNT; i++)
+    sum += i;
+  return sum == LOOPCOUNT * (LOOPCOUNT + 1) / 2;
+}
+
+// The barriers of a nested team do not see the signals of the outer team.
+int test_nested() {
+  int errors = 0;
+  #pragma omp parallel num_threads(3) shared(errors)
+  {
+    if (omp_get_thread_num() == 0) {
+      if (!test_barrier_phases(5)) {
+        #pragma omp atomic
+        errors++;
+      }
+    }
+    #pragma omp barrier
+  }
+  return errors == 0;
+}
+
+int main() {
+  int i, n;
+  int num_failed = 0;
+
+  omp_set_dynamic(0);
+  omp_set_nested(1);
+  for (i = 0; i < REPETITIONS; i++) {
+    for (n = 1; n <= MAX_THREADS; n++) {
+      if (!test_barrier_phases(n) || !test_reduction(n))
+        num_failed++;
+    }
+    if (!test_nested())
+      num_failed++;
+  }
+  if (num_failed)
+    printf("failed %d times\n", num_failed);
+  return num_failed;
+}
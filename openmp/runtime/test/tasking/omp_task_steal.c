@@ -0,0 +1,59 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_BLOCKTIME=0 %libomp-run
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define MAX_THREADS 9
+#define NUM_TASKS 2000
+
+// One thread of the team creates all the tasks, so the others have to steal
+// them. The steals prefer the nearest threads of the machine hierarchy and
+// widen to the whole team, which is cut off at the last thread for team sizes
+// that don't fill the hierarchy.
+int test_task_steal(int nthreads, int producer) {
+  int ran[NUM_TASKS];
+  int i, errors = 0;
+
+  for (i = 0; i < NUM_TASKS; i++)
+    ran[i] = 0;
+
+  #pragma omp parallel num_threads(nthreads) shared(ran)
+  {
+    if (omp_get_thread_num() == producer % omp_get_num_threads()) {
+      int t;
+      for (t = 0; t < NUM_TASKS; t++) {
+        #pragma omp task firstprivate(t)
+        {
+          int j;
+          volatile int work = 0;
+          for (j = 0; j < 100; j++)
+            work += j;
+          #pragma omp atomic
+          ran[t]++;
+        }
+      }
+    }
+  }
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    if (ran[i] != 1) {
+      fprintf(stderr, "task %d ran %d times with %d threads\n", i, ran[i],
+              nthreads);
+      errors++;
+    }
+  }
+  return errors == 0;
+}
+
+int main() {
+  int n, p;
+  int num_failed = 0;
+
+  for (n = 2; n <= MAX_THREADS; n++) {
+    for (p = 0; p < n; p += n - 1) {
+      if (!test_task_steal(n, p))
+        num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,87 @@
+// RUN: %libomp-compile
+// RUN: env OMP_SCHEDULE=adaptive %libomp-run
+// RUN: env OMP_SCHEDULE=adaptive,7 %libomp-run
+// RUN: env OMP_SCHEDULE=adaptive,7 OMP_NUM_THREADS=1 %libomp-run
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define N 20011
+
+int counts[N];
+
+// Iterations of very different lengths, so that the batches of chunks change
+// size while the loop runs.
+static int work(int i) {
+  int j, x = 0;
+  for (j = 0; j < (i % 97) * (i % 13); j++)
+    x += j ^ i;
+  return x;
+}
+
+// Every iteration runs exactly once, whatever the sizes of the batches.
+int test_adaptive_once(int lb, int st) {
+  int i, errors = 0;
+  volatile int sink = 0;
+  for (i = 0; i < N; i++)
+    counts[i] = 0;
+  #pragma omp parallel
+  {
+    long long x;
+    #pragma omp for schedule(runtime)
+    for (x = lb; x < lb + (long long)N * st; x += st) {
+      int k = (int)((x - lb) / st);
+      sink += work(k);
+      #pragma omp atomic
+      counts[k]++;
+    }
+  }
+  for (i = 0; i < N; i++) {
+    if (counts[i] != 1) {
+      printf("iteration %d ran %d times\n", i, counts[i]);
+      errors++;
+    }
+  }
+  return errors == 0;
+}
+
+// The ordered regions of the loop still run in the order of the iterations.
+int test_adaptive_ordered() {
+  int i, last = -1, errors = 0;
+  volatile int sink = 0;
+  #pragma omp parallel for schedule(runtime) ordered
+  for (i = 0; i < N; i++) {
+    sink += work(i);
+    #pragma omp ordered
+    {
+      if (last != i - 1)
+        errors++;
+      last = i;
+    }
+  }
+  return errors == 0 && last == N - 1;
+}
+
+// The schedule is parsed from OMP_SCHEDULE and reported as dynamic.
+int test_adaptive_kind() {
+  omp_sched_t kind;
+  int chunk;
+  omp_get_schedule(&kind, &chunk);
+  if (kind != omp_sched_dynamic) {
+    printf("schedule kind %d is not dynamic\n", (int)kind);
+    return 0;
+  }
+  return 1;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+  if (!test_adaptive_kind())
+    num_failed++;
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_adaptive_once(0, 1) || !test_adaptive_once(-5, 3) ||
+        !test_adaptive_ordered())
+      num_failed++;
+  }
+  return num_failed;
+}
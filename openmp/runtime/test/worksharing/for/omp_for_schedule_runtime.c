@@ -10,6 +10,8 @@
 // RUN: env OMP_SCHEDULE=trapezoidal,13 %libomp-run 101 13
 // RUN: env OMP_SCHEDULE=static_steal %libomp-run 102 1
 // RUN: env OMP_SCHEDULE=static_steal,14 %libomp-run 102 14
+// RUN: env OMP_SCHEDULE=adaptive %libomp-run 2 1
+// RUN: env OMP_SCHEDULE=adaptive,15 %libomp-run 2 15
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
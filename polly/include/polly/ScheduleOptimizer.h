@@ -135,10 +135,44 @@ private:
   ///                        tiling.
   /// @param DefaultTileSize A default tile size that is used for dimensions
   ///                        that are not covered by the TileSizes vector.
-  static isl::schedule_node tileNode(isl::schedule_node Node,
-                                     const char *Identifier,
-                                     llvm::ArrayRef<int> TileSizes,
-                                     int DefaultTileSize);
+  /// @param WavefrontDeps   If not nullptr, the tile loops are skewed into
+  ///                        wavefronts as far as these dependences allow.
+  static isl::schedule_node
+  tileNode(isl::schedule_node Node, const char *Identifier,
+           llvm::ArrayRef<int> TileSizes, int DefaultTileSize,
+           const polly::Dependences *WavefrontDeps = nullptr);
+
+  /// Skew the tile loops of a band into wavefronts.
+  ///
+  /// If none of the members of the permutable band @p Node is parallel, its
+  /// outer member is replaced by the sum of all its members. The tiles of a
+  /// wavefront do not depend on each other, which makes the other members
+  /// parallel.
+  ///
+  /// Example (Dims=2):
+  ///
+  /// | Before transformation:
+  /// |
+  /// | for (it = 0; it < 32; it++)
+  /// |   for (jt = 0; jt < 32; jt++)
+  /// |     Tile(it, jt);
+  ///
+  /// | After transformation:
+  /// |
+  /// | for (w = 0; w < 63; w++)
+  /// |   #pragma omp parallel for
+  /// |   for (jt = max(0, w - 31); jt <= min(31, w); jt++)
+  /// |     Tile(w - jt, jt);
+  ///
+  /// Only the members that @p D shows to be parallel within a wavefront are
+  /// marked coincident.
+  ///
+  /// @param Node The tile band of a tiled, permutable band.
+  /// @param D    The dependences of the SCoP.
+  /// @return The skewed band, or @p Node if it is already parallel or the
+  ///         skewing would not make any member parallel.
+  static isl::schedule_node applyWavefront(isl::schedule_node Node,
+                                           const polly::Dependences *D);
 
   /// Tile a schedule node and unroll point loops.
   ///
@@ -267,6 +301,8 @@ private:
   /// transformations:
   ///
   ///  - Tile the band
+  ///      - Skew the tile loops into wavefronts, if the band has no parallel
+  ///        member and -polly-wavefront is given
   ///  - Prevectorize the schedule of the band (or the point loop in case of
   ///    tiling).
   ///      - if vectorization is enabled
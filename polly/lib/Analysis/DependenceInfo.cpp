@@ -25,7 +25,10 @@
 #include "polly/ScopInfo.h"
 #include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLTools.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/PassTimingInfo.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Timer.h"
 #include "isl/aff.h"
 #include "isl/ctx.h"
 #include "isl/flow.h"
@@ -46,6 +49,9 @@ static cl::opt<int> OptComputeOut(
              "computational steps (0 means no bound)"),
     cl::Hidden, cl::init(500000), cl::ZeroOrMore, cl::cat(PollyCategory));
 
+STATISTIC(DependencesComputeOut,
+          "Number of dependence analyses that exceeded max_operations");
+
 static cl::opt<bool> LegalityCheckDisabled(
     "disable-polly-legality", cl::desc("Disable polly legality check"),
     cl::Hidden, cl::init(false), cl::ZeroOrMore, cl::cat(PollyCategory));
@@ -410,6 +416,9 @@ void Dependences::calculateDependences(Scop &S) {
   isl_schedule *Schedule;
   isl_union_set *TaggedStmtDomain;
 
+  NamedRegionTimer T("dependences", "Dependence analysis", "polly", "Polly",
+                     TimePassesIsEnabled);
+
   LLVM_DEBUG(dbgs() << "Scop: \n" << S << "\n");
 
   collectInfo(S, Read, MustWrite, MayWrite, ReductionTagMap, TaggedStmtDomain,
@@ -577,6 +586,8 @@ void Dependences::calculateDependences(Scop &S) {
   }
 
   if (isl_ctx_last_error(IslCtx.get()) == isl_error_quota) {
+    DependencesComputeOut++;
+    LLVM_DEBUG(dbgs() << "Dependence analysis exceeded max_operations\n");
     isl_union_map_free(RAW);
     isl_union_map_free(WAW);
     isl_union_map_free(WAR);
@@ -54,12 +54,17 @@
 #include "polly/ScopInfo.h"
 #include "polly/ScopPass.h"
 #include "polly/Simplify.h"
+#include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLOStream.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/PassTimingInfo.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "isl/ctx.h"
 #include "isl/options.h"
@@ -129,6 +134,12 @@ static cl::opt<bool> FirstLevelTiling("polly-tiling",
                                       cl::init(true), cl::ZeroOrMore,
                                       cl::cat(PollyCategory));
 
+static cl::opt<bool> Wavefront(
+    "polly-wavefront",
+    cl::desc("Skew the tile loops of bands without a parallel member into "
+             "wavefronts, whose tiles can be executed in parallel"),
+    cl::Hidden, cl::init(false), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 static cl::opt<int> LatencyVectorFma(
     "polly-target-latency-vector-fma",
     cl::desc("The minimal number of cycles between issuing two "
@@ -267,7 +278,18 @@ static cl::opt<bool> OptimizedScops(
              "transformations is applied on the schedule tree"),
     cl::init(false), cl::ZeroOrMore, cl::cat(PollyCategory));
 
+// Unbounded by default, so that no SCoP loses its optimization unless asked
+// to. There is no value yet that is known to only cut off the SCoPs whose
+// scheduling would stall the compilation.
+static cl::opt<int> ScheduleComputeOut(
+    "polly-schedule-computeout",
+    cl::desc("Bound the scheduler by a maximal amount of computational steps "
+             "(0 means no bound)"),
+    cl::Hidden, cl::init(0), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 STATISTIC(ScopsProcessed, "Number of scops processed");
+STATISTIC(ScopsComputeOut,
+          "Number of scops whose scheduling exceeded max_operations");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
 
@@ -289,6 +311,7 @@ THREE_STATISTICS(NumExtension, "Number of extension nodes");
 
 STATISTIC(FirstLevelTileOpts, "Number of first level tiling applied");
 STATISTIC(SecondLevelTileOpts, "Number of second level tiling applied");
+STATISTIC(WavefrontOpts, "Number of wavefront skewings applied");
 STATISTIC(RegisterTileOpts, "Number of register tiling applied");
 STATISTIC(PrevectOpts, "Number of strip-mining for prevectorization applied");
 STATISTIC(MatMulOpts,
@@ -430,10 +453,10 @@ isl::schedule_node ScheduleTreeOptimizer::prevectSchedBand(
   return Node.insert_mark(LoopMarker);
 }
 
-isl::schedule_node ScheduleTreeOptimizer::tileNode(isl::schedule_node Node,
-                                                   const char *Identifier,
-                                                   ArrayRef<int> TileSizes,
-                                                   int DefaultTileSize) {
+isl::schedule_node
+ScheduleTreeOptimizer::tileNode(isl::schedule_node Node, const char *Identifier,
+                                ArrayRef<int> TileSizes, int DefaultTileSize,
+                                const Dependences *WavefrontDeps) {
   auto Space = isl::manage(isl_schedule_node_band_get_space(Node.get()));
   auto Dims = Space.dim(isl::dim::set);
   auto Sizes = isl::multi_val::zero(Space);
@@ -449,6 +472,8 @@ isl::schedule_node ScheduleTreeOptimizer::tileNode(isl::schedule_node Node,
   Node = Node.child(0);
   Node =
       isl::manage(isl_schedule_node_band_tile(Node.release(), Sizes.release()));
+  if (WavefrontDeps)
+    Node = applyWavefront(Node, WavefrontDeps);
   Node = Node.child(0);
   auto PointLoopMarkerStr = IdentifierString + " - Points";
   auto PointLoopMarker =
@@ -457,6 +482,59 @@ isl::schedule_node ScheduleTreeOptimizer::tileNode(isl::schedule_node Node,
   return Node.child(0);
 }
 
+isl::schedule_node
+ScheduleTreeOptimizer::applyWavefront(isl::schedule_node Node,
+                                      const Dependences *D) {
+  assert(isl_schedule_node_get_type(Node.get()) == isl_schedule_node_band);
+
+  if (!D->hasValidDependences())
+    return Node;
+
+  auto Space = isl::manage(isl_schedule_node_band_get_space(Node.get()));
+  unsigned Dims = Space.dim(isl::dim::set);
+  if (Dims <= 1)
+    return Node;
+
+  // If one of the members is parallel already, there is nothing to gain.
+  for (unsigned i = 0; i < Dims; i++)
+    if (Node.band_member_get_coincident(i))
+      return Node;
+
+  // The band is permutable, hence all the dependences have non-negative
+  // distances in each of its members and the sum of the members is a valid
+  // outer member.
+  auto Schedule = isl::manage(
+      isl_schedule_node_band_get_partial_schedule(Node.get()));
+  auto Sum = Schedule.get_union_pw_aff(0);
+  for (unsigned i = 1; i < Dims; i++)
+    Sum = Sum.add(Schedule.get_union_pw_aff(i));
+  Schedule = Schedule.set_union_pw_aff(0, Sum);
+
+  // Within a wavefront, only mark the members coincident that the dependences
+  // show to be parallel.
+  auto Prefix = Node.get_prefix_schedule_union_map();
+  auto Deps = D->getDependences(Dependences::TYPE_RAW | Dependences::TYPE_WAW |
+                                Dependences::TYPE_WAR);
+  SmallVector<bool, 4> Coincident(Dims, false);
+  bool HasCoincident = false;
+  for (unsigned i = 1; i < Dims; i++) {
+    auto Members = Schedule.drop_dims(isl::dim::set, i + 1, Dims - i - 1);
+    auto Map = Prefix.flat_range_product(isl::union_map::from(Members));
+    Coincident[i] = D->isParallel(Map.get(), Deps.copy());
+    HasCoincident |= Coincident[i];
+  }
+  if (!HasCoincident)
+    return Node;
+
+  Node = isl::manage(isl_schedule_node_delete(Node.release()));
+  Node = Node.insert_partial_schedule(Schedule);
+  Node = isl::manage(isl_schedule_node_band_set_permutable(Node.release(), 1));
+  for (unsigned i = 1; i < Dims; i++)
+    Node = Node.band_member_set_coincident(i, Coincident[i]);
+  WavefrontOpts++;
+  return Node;
+}
+
 isl::schedule_node ScheduleTreeOptimizer::applyRegisterTiling(
     isl::schedule_node Node, ArrayRef<int> TileSizes, int DefaultTileSize) {
   Node = tileNode(Node, "Register tiling", TileSizes, DefaultTileSize);
@@ -512,8 +590,10 @@ bool ScheduleTreeOptimizer::isTileableBandNode(isl::schedule_node Node) {
 __isl_give isl::schedule_node
 ScheduleTreeOptimizer::standardBandOpts(isl::schedule_node Node, void *User) {
   if (FirstLevelTiling) {
+    auto *OAI = static_cast<const OptimizerAdditionalInfoTy *>(User);
+    const Dependences *WavefrontDeps = Wavefront && OAI ? OAI->D : nullptr;
     Node = tileNode(Node, "1st level tiling", FirstLevelTileSizes,
-                    FirstLevelDefaultTileSize);
+                    FirstLevelDefaultTileSize, WavefrontDeps);
     FirstLevelTileOpts++;
   }
 
@@ -1592,7 +1672,27 @@ bool IslScheduleOptimizer::runOnScop(Scop &S) {
   SC = SC.set_proximity(Proximity);
   SC = SC.set_validity(Validity);
   SC = SC.set_coincidence(Validity);
-  auto Schedule = SC.compute_schedule();
+  isl::schedule Schedule;
+  {
+    NamedRegionTimer T("scheduler", "isl scheduler", "polly", "Polly",
+                       TimePassesIsEnabled);
+    IslMaxOperationsGuard MaxOpGuard(Ctx, ScheduleComputeOut);
+    Schedule = SC.compute_schedule();
+
+    // The scheduler may need an exponential amount of time on large SCoPs.
+    // Keep the original schedule rather than stalling the compilation.
+    if (MaxOpGuard.hasQuotaExceeded()) {
+      ScopsComputeOut++;
+      LLVM_DEBUG(dbgs() << "Schedule computation exceeded max_operations\n");
+      DebugLoc Begin, End;
+      getDebugLocations(getBBPairForRegion(&S.getRegion()), Begin, End);
+      OptimizationRemarkAnalysis R(DEBUG_TYPE, "OutOfQuota", Begin,
+                                   S.getEntry());
+      R << "maximal number of operations exceeded during scheduling";
+      S.getFunction().getContext().diagnose(R);
+      Schedule = isl::schedule();
+    }
+  }
   isl_options_set_on_error(Ctx, OnErrorStatus);
 
   walkScheduleTreeForStatistics(Schedule, 1);
@@ -1617,8 +1717,13 @@ bool IslScheduleOptimizer::runOnScop(Scop &S) {
   Function &F = S.getFunction();
   auto *TTI = &getAnalysis<TargetTransformInfoWrapperPass>().getTTI(F);
   const OptimizerAdditionalInfoTy OAI = {TTI, const_cast<Dependences *>(&D)};
-  auto NewSchedule = ScheduleTreeOptimizer::optimizeSchedule(Schedule, &OAI);
-  NewSchedule = hoistExtensionNodes(NewSchedule);
+  isl::schedule NewSchedule;
+  {
+    NamedRegionTimer T("optimizer", "schedule tree optimizer", "polly",
+                       "Polly", TimePassesIsEnabled);
+    NewSchedule = ScheduleTreeOptimizer::optimizeSchedule(Schedule, &OAI);
+    NewSchedule = hoistExtensionNodes(NewSchedule);
+  }
   walkScheduleTreeForStatistics(NewSchedule, 2);
 
   if (!ScheduleTreeOptimizer::isProfitableSchedule(S, NewSchedule))
@@ -0,0 +1,48 @@
+; RUN: opt %loadPolly -polly-opt-isl -polly-ast -analyze < %s \
+; RUN:   | FileCheck %s --check-prefix=OPT
+; RUN: opt %loadPolly -polly-opt-isl -polly-schedule-computeout=1 \
+; RUN:   -pass-remarks-analysis=polly-opt-isl -polly-ast -analyze < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=QUOTA
+;
+; If the scheduler runs out of its quota, the SCoP keeps its original
+; schedule, so the loops are neither tiled nor interchanged.
+;
+;    for (i = 0; i < 1024; i++)
+;      for (j = 0; j < 1024; j++)
+;        A[j][i] = 1.0;
+;
+; OPT:         // 1st level tiling - Tiles
+;
+; QUOTA:       remark: <unknown>:0:0: maximal number of operations exceeded during scheduling
+; QUOTA-NOT:   Tiles
+; QUOTA:       for (int c0 = 0; c0 <= 1023; c0 += 1)
+; QUOTA-NEXT:    for (int c1 = 0; c1 <= 1023; c1 += 1)
+; QUOTA-NEXT:      Stmt_for_body3(c0, c1);
+; QUOTA-NOT:   Tiles
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+define void @f([1024 x double]* %A) {
+entry:
+  br label %for.cond1.preheader
+
+for.cond1.preheader:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %for.inc ]
+  br label %for.body3
+
+for.body3:
+  %j = phi i64 [ 0, %for.cond1.preheader ], [ %j.next, %for.body3 ]
+  %arrayidx = getelementptr inbounds [1024 x double], [1024 x double]* %A, i64 %j, i64 %i
+  store double 1.000000e+00, double* %arrayidx
+  %j.next = add nuw nsw i64 %j, 1
+  %exitcond = icmp ne i64 %j.next, 1024
+  br i1 %exitcond, label %for.body3, label %for.inc
+
+for.inc:
+  %i.next = add nuw nsw i64 %i, 1
+  %exitcond2 = icmp ne i64 %i.next, 1024
+  br i1 %exitcond2, label %for.cond1.preheader, label %for.end
+
+for.end:
+  ret void
+}
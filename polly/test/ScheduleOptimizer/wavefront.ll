@@ -0,0 +1,60 @@
+; RUN: opt %loadPolly -polly-opt-isl -polly-wavefront -polly-parallel \
+; RUN:   -polly-ast -analyze < %s | FileCheck %s
+; RUN: opt %loadPolly -polly-opt-isl -polly-parallel -polly-ast -analyze < %s \
+; RUN:   | FileCheck %s --check-prefix=NOWAVEFRONT
+;
+; Both loops carry a dependence, so no tile loop is parallel. Skewed into
+; wavefronts, the tiles on the same anti-diagonal can run in parallel.
+;
+;    for (i = 1; i < 1025; i++)
+;      for (j = 1; j < 1025; j++)
+;        A[i][j] = A[i - 1][j] + A[i][j - 1];
+;
+; CHECK:      // 1st level tiling - Tiles
+; CHECK-NEXT: for (int c0 = 0; c0 <= 62; c0 += 1)
+; CHECK-NEXT:   #pragma omp parallel for
+; CHECK-NEXT:   for (int c1 = max(0, c0 - 31); c1 <= min(31, c0); c1 += 1)
+; CHECK-NEXT:     // 1st level tiling - Points
+; CHECK-NEXT:     for (int c2 = 0; c2 <= 31; c2 += 1)
+; CHECK-NEXT:       for (int c3 = 0; c3 <= 31; c3 += 1)
+; CHECK-NEXT:         Stmt_for_body4(32 * c0 - 32 * c1 + c2, 32 * c1 + c3);
+;
+; NOWAVEFRONT:     // 1st level tiling - Tiles
+; NOWAVEFRONT-NOT: #pragma omp parallel for
+; NOWAVEFRONT:     for (int c0 = 0; c0 <= 31; c0 += 1)
+; NOWAVEFRONT-NEXT:  for (int c1 = 0; c1 <= 31; c1 += 1)
+; NOWAVEFRONT-NOT: #pragma omp parallel for
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+define void @f([1025 x double]* %A) {
+entry:
+  br label %for.cond1.preheader
+
+for.cond1.preheader:
+  %i = phi i64 [ 1, %entry ], [ %i.next, %for.inc ]
+  %i.prev = add nsw i64 %i, -1
+  br label %for.body4
+
+for.body4:
+  %j = phi i64 [ 1, %for.cond1.preheader ], [ %j.next, %for.body4 ]
+  %j.prev = add nsw i64 %j, -1
+  %up.addr = getelementptr inbounds [1025 x double], [1025 x double]* %A, i64 %i.prev, i64 %j
+  %up = load double, double* %up.addr
+  %left.addr = getelementptr inbounds [1025 x double], [1025 x double]* %A, i64 %i, i64 %j.prev
+  %left = load double, double* %left.addr
+  %sum = fadd double %up, %left
+  %arrayidx = getelementptr inbounds [1025 x double], [1025 x double]* %A, i64 %i, i64 %j
+  store double %sum, double* %arrayidx
+  %j.next = add nuw nsw i64 %j, 1
+  %exitcond = icmp ne i64 %j.next, 1025
+  br i1 %exitcond, label %for.body4, label %for.inc
+
+for.inc:
+  %i.next = add nuw nsw i64 %i, 1
+  %exitcond2 = icmp ne i64 %i.next, 1025
+  br i1 %exitcond2, label %for.cond1.preheader, label %for.end
+
+for.end:
+  ret void
+}
@@ -0,0 +1,137 @@
+// -*- C++ -*-
+//===-- execution_defs.h --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_EXECUTION_POLICY_DEFS_H
+#define _PSTL_EXECUTION_POLICY_DEFS_H
+
+#include <iterator>
+#include <type_traits>
+
+namespace __pstl
+{
+namespace execution
+{
+inline namespace v1
+{
+
+// 2.4, Sequential execution policy
+class sequenced_policy
+{
+};
+
+// 2.5, Parallel execution policy
+class parallel_policy
+{
+};
+
+// 2.6, Parallel+Vector execution policy
+class parallel_unsequenced_policy
+{
+};
+
+class unsequenced_policy
+{
+};
+
+// 2.8, Execution policy objects
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+constexpr unsequenced_policy unseq{};
+
+// 2.3, Execution policy type trait
+template <class _Tp>
+struct is_execution_policy : std::false_type
+{
+};
+
+template <>
+struct is_execution_policy<__pstl::execution::sequenced_policy> : std::true_type
+{
+};
+template <>
+struct is_execution_policy<__pstl::execution::parallel_policy> : std::true_type
+{
+};
+template <>
+struct is_execution_policy<__pstl::execution::parallel_unsequenced_policy> : std::true_type
+{
+};
+template <>
+struct is_execution_policy<__pstl::execution::unsequenced_policy> : std::true_type
+{
+};
+
+template <class _Tp>
+constexpr bool is_execution_policy_v = __pstl::execution::is_execution_policy<_Tp>::value;
+
+} // namespace v1
+} // namespace execution
+
+namespace __internal
+{
+template <class _ExecPolicy, class _Tp>
+using __enable_if_execution_policy =
+    typename std::enable_if<__pstl::execution::is_execution_policy<typename std::decay<_ExecPolicy>::type>::value,
+                            _Tp>::type;
+
+// The policies which let an algorithm run on several threads.
+template <class _ExecPolicy>
+struct __is_parallel_policy : std::false_type
+{
+};
+template <>
+struct __is_parallel_policy<__pstl::execution::parallel_policy> : std::true_type
+{
+};
+template <>
+struct __is_parallel_policy<__pstl::execution::parallel_unsequenced_policy> : std::true_type
+{
+};
+
+template <class _Iterator>
+using __is_random_access_iterator =
+    std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_Iterator>::iterator_category>;
+
+// Whether an algorithm called with a policy and iterators runs in parallel.
+// The backends split the ranges by their indices, so the other iterators fall
+// back to the serial algorithms.
+template <class _ExecPolicy, class... _Iterators>
+struct __use_parallel
+    : std::integral_constant<bool, __is_parallel_policy<typename std::decay<_ExecPolicy>::type>::value &&
+                                       std::conjunction<__is_random_access_iterator<_Iterators>...>::value>
+{
+};
+
+} // namespace __internal
+} // namespace __pstl
+
+namespace std
+{
+// Type trait
+using __pstl::execution::is_execution_policy;
+using __pstl::execution::is_execution_policy_v;
+
+namespace execution
+{
+// Standard C++ policy classes
+using __pstl::execution::parallel_policy;
+using __pstl::execution::parallel_unsequenced_policy;
+using __pstl::execution::sequenced_policy;
+using __pstl::execution::unsequenced_policy;
+
+// Standard predefined policy instances
+using __pstl::execution::par;
+using __pstl::execution::par_unseq;
+using __pstl::execution::seq;
+using __pstl::execution::unseq;
+} // namespace execution
+} // namespace std
+
+#endif /* _PSTL_EXECUTION_POLICY_DEFS_H */
@@ -0,0 +1,334 @@
+// -*- C++ -*-
+//===-- glue_algorithm_impl.h ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_GLUE_ALGORITHM_IMPL_H
+#define _PSTL_GLUE_ALGORITHM_IMPL_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+
+#include "execution_defs.h"
+#include "parallel_impl.h"
+
+// The overloads of the algorithms which take an execution policy. They run in
+// parallel with std::execution::par and par_unseq when all their iterators are
+// random access, and call the serial algorithms otherwise.
+
+namespace std
+{
+
+// [alg.find]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+find_if(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator>::value)
+        return __first + __pstl::__internal::__parallel_find_if(
+                             __last - __first, [&](std::size_t __i) -> bool { return __pred(__first[__i]); });
+    else
+        return std::find_if(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+find_if_not(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    return std::find_if(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+                        [&](auto&& __x) -> bool { return !__pred(std::forward<decltype(__x)>(__x)); });
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+find(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    return std::find_if(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+                        [&](auto&& __x) -> bool { return __x == __value; });
+}
+
+// [alg.any_of]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+any_of(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    return std::find_if(std::forward<_ExecutionPolicy>(__exec), __first, __last, __pred) != __last;
+}
+
+// [alg.all_of]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Pred>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+all_of(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Pred __pred)
+{
+    return std::find_if_not(std::forward<_ExecutionPolicy>(__exec), __first, __last, __pred) == __last;
+}
+
+// [alg.none_of]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+none_of(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    return !std::any_of(std::forward<_ExecutionPolicy>(__exec), __first, __last, __pred);
+}
+
+// [alg.foreach]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Function>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+for_each(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Function __f)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator>::value)
+        __pstl::__internal::__parallel_for(__last - __first, [&](std::size_t __i, std::size_t __j) {
+            std::for_each(__first + __i, __first + __j, __f);
+        });
+    else
+        std::for_each(__first, __last, __f);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Function>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+for_each_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __n, _Function __f)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__n <= 0)
+            return __first;
+        _ForwardIterator __last = __first + __n;
+        std::for_each(std::forward<_ExecutionPolicy>(__exec), __first, __last, __f);
+        return __last;
+    }
+    else
+    {
+        for (; __n > 0; ++__first, (void)--__n)
+            __f(*__first);
+        return __first;
+    }
+}
+
+// [alg.count]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy,
+                                                 typename iterator_traits<_ForwardIterator>::difference_type>
+count_if(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    typedef typename iterator_traits<_ForwardIterator>::difference_type _DifferenceType;
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__parallel_reduce(
+            __last - __first, _DifferenceType(0), std::plus<_DifferenceType>(),
+            [&](std::size_t __i, std::size_t __j) { return std::count_if(__first + __i, __first + __j, __pred); });
+    else
+        return std::count_if(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy,
+                                                 typename iterator_traits<_ForwardIterator>::difference_type>
+count(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    return std::count_if(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+                         [&](auto&& __x) -> bool { return __x == __value; });
+}
+
+// [alg.copy]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+copy(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+    {
+        __pstl::__internal::__parallel_for(__last - __first, [&](std::size_t __i, std::size_t __j) {
+            std::copy(__first + __i, __first + __j, __result + __i);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::copy(__first, __last, __result);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _Size, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+copy_n(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _Size __n, _ForwardIterator2 __result)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+        return __n <= 0 ? __result : std::copy(std::forward<_ExecutionPolicy>(__exec), __first, __first + __n, __result);
+    else
+        return std::copy_n(__first, __n, __result);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+move(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+    {
+        __pstl::__internal::__parallel_for(__last - __first, [&](std::size_t __i, std::size_t __j) {
+            std::move(__first + __i, __first + __j, __result + __i);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::move(__first, __last, __result);
+}
+
+// [alg.transform]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result,
+          _UnaryOperation __op)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+    {
+        __pstl::__internal::__parallel_for(__last - __first, [&](std::size_t __i, std::size_t __j) {
+            std::transform(__first + __i, __first + __j, __result + __i, __op);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::transform(__first, __last, __result, __op);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator,
+          class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+transform(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+          _ForwardIterator __result, _BinaryOperation __op)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2,
+                                                     _ForwardIterator>::value)
+    {
+        __pstl::__internal::__parallel_for(__last1 - __first1, [&](std::size_t __i, std::size_t __j) {
+            std::transform(__first1 + __i, __first1 + __j, __first2 + __i, __result + __i, __op);
+        });
+        return __result + (__last1 - __first1);
+    }
+    else
+        return std::transform(__first1, __last1, __first2, __result, __op);
+}
+
+// [alg.replace]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _UnaryPredicate, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+replace_if(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _UnaryPredicate __pred,
+           const _Tp& __new_value)
+{
+    std::for_each(std::forward<_ExecutionPolicy>(__exec), __first, __last, [&](auto&& __x) {
+        if (__pred(__x))
+            __x = __new_value;
+    });
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+replace(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __old_value,
+        const _Tp& __new_value)
+{
+    std::replace_if(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+                    [&](const auto& __x) -> bool { return __x == __old_value; }, __new_value);
+}
+
+// [alg.fill]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+fill(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator>::value)
+        __pstl::__internal::__parallel_for(__last - __first, [&](std::size_t __i, std::size_t __j) {
+            std::fill(__first + __i, __first + __j, __value);
+        });
+    else
+        std::fill(__first, __last, __value);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+fill_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __count, const _Tp& __value)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__count <= 0)
+            return __first;
+        std::fill(std::forward<_ExecutionPolicy>(__exec), __first, __first + __count, __value);
+        return __first + __count;
+    }
+    else
+        return std::fill_n(__first, __count, __value);
+}
+
+// [alg.generate]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Generator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+generate(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Generator __g)
+{
+    std::for_each(std::forward<_ExecutionPolicy>(__exec), __first, __last, [&](auto&& __x) { __x = __g(); });
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Generator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+generate_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __count, _Generator __g)
+{
+    return std::for_each_n(std::forward<_ExecutionPolicy>(__exec), __first, __count, [&](auto&& __x) { __x = __g(); });
+}
+
+// [alg.sort]
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+sort(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _RandomAccessIterator>::value)
+        __pstl::__internal::__parallel_merge_sort(
+            __first, __last, __comp, [](_RandomAccessIterator __i, _RandomAccessIterator __j, _Compare& __c) {
+                std::sort(__i, __j, __c);
+            });
+    else
+        std::sort(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+sort(_ExecutionPolicy&& __exec, _RandomAccessIterator __first, _RandomAccessIterator __last)
+{
+    std::sort(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+// [stable.sort]
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+stable_sort(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _RandomAccessIterator>::value)
+        __pstl::__internal::__parallel_merge_sort(
+            __first, __last, __comp, [](_RandomAccessIterator __i, _RandomAccessIterator __j, _Compare& __c) {
+                std::stable_sort(__i, __j, __c);
+            });
+    else
+        std::stable_sort(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+stable_sort(_ExecutionPolicy&& __exec, _RandomAccessIterator __first, _RandomAccessIterator __last)
+{
+    std::stable_sort(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+} // namespace std
+
+#endif /* _PSTL_GLUE_ALGORITHM_IMPL_H */
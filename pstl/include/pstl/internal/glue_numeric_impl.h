@@ -0,0 +1,198 @@
+// -*- C++ -*-
+//===-- glue_numeric_impl.h -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_GLUE_NUMERIC_IMPL_H
+#define _PSTL_GLUE_NUMERIC_IMPL_H
+
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+
+#include "execution_defs.h"
+#include "parallel_impl.h"
+
+namespace std
+{
+
+// [transform.reduce]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp, class _BinaryOperation, class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+transform_reduce(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Tp __init,
+                 _BinaryOperation __binary_op, _UnaryOperation __unary_op)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__parallel_reduce(
+            __last - __first, std::move(__init), __binary_op, [&](std::size_t __i, std::size_t __j) {
+                _Tp __sum = __unary_op(__first[__i]);
+                for (++__i; __i < __j; ++__i)
+                    __sum = __binary_op(std::move(__sum), __unary_op(__first[__i]));
+                return __sum;
+            });
+    else
+        return std::transform_reduce(__first, __last, std::move(__init), __binary_op, __unary_op);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp, class _BinaryOperation1,
+          class _BinaryOperation2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+transform_reduce(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+                 _Tp __init, _BinaryOperation1 __binary_op1, _BinaryOperation2 __binary_op2)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+        return __pstl::__internal::__parallel_reduce(
+            __last1 - __first1, std::move(__init), __binary_op1, [&](std::size_t __i, std::size_t __j) {
+                _Tp __sum = __binary_op2(__first1[__i], __first2[__i]);
+                for (++__i; __i < __j; ++__i)
+                    __sum = __binary_op1(std::move(__sum), __binary_op2(__first1[__i], __first2[__i]));
+                return __sum;
+            });
+    else
+        return std::transform_reduce(__first1, __last1, __first2, std::move(__init), __binary_op1, __binary_op2);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+transform_reduce(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                 _ForwardIterator2 __first2, _Tp __init)
+{
+    return std::transform_reduce(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2,
+                                 std::move(__init), std::plus<>(), std::multiplies<>());
+}
+
+// [reduce]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp, class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+reduce(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Tp __init,
+       _BinaryOperation __binary_op)
+{
+    return std::transform_reduce(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::move(__init),
+                                 __binary_op, __pstl::__internal::__no_op());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+reduce(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Tp __init)
+{
+    return std::reduce(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::move(__init), std::plus<>());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy,
+                                                 typename iterator_traits<_ForwardIterator>::value_type>
+reduce(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    typedef typename iterator_traits<_ForwardIterator>::value_type _ValueType;
+    return std::reduce(std::forward<_ExecutionPolicy>(__exec), __first, __last, _ValueType{}, std::plus<>());
+}
+
+// [transform.inclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation,
+          class _UnaryOperation, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform_inclusive_scan(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                         _ForwardIterator2 __result, _BinaryOperation __binary_op, _UnaryOperation __unary_op,
+                         _Tp __init)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+        return __pstl::__internal::__parallel_transform_scan(__first, __last, __result, __unary_op,
+                                                             std::optional<_Tp>(std::move(__init)), __binary_op,
+                                                             /*__inclusive=*/true);
+    else
+        return std::transform_inclusive_scan(__first, __last, __result, __binary_op, __unary_op, std::move(__init));
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation,
+          class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform_inclusive_scan(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                         _ForwardIterator2 __result, _BinaryOperation __binary_op, _UnaryOperation __unary_op)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+    {
+        typedef typename std::decay<decltype(__unary_op(*__first))>::type _ValueType;
+        return __pstl::__internal::__parallel_transform_scan(__first, __last, __result, __unary_op,
+                                                             std::optional<_ValueType>(), __binary_op,
+                                                             /*__inclusive=*/true);
+    }
+    else
+        return std::transform_inclusive_scan(__first, __last, __result, __binary_op, __unary_op);
+}
+
+// [transform.exclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp, class _BinaryOperation,
+          class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform_exclusive_scan(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                         _ForwardIterator2 __result, _Tp __init, _BinaryOperation __binary_op,
+                         _UnaryOperation __unary_op)
+{
+    if constexpr (__pstl::__internal::__use_parallel<_ExecutionPolicy, _ForwardIterator1, _ForwardIterator2>::value)
+        return __pstl::__internal::__parallel_transform_scan(__first, __last, __result, __unary_op,
+                                                             std::optional<_Tp>(std::move(__init)), __binary_op,
+                                                             /*__inclusive=*/false);
+    else
+        return std::transform_exclusive_scan(__first, __last, __result, std::move(__init), __binary_op, __unary_op);
+}
+
+// [inclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+inclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _BinaryOperation __binary_op, _Tp __init)
+{
+    return std::transform_inclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result,
+                                         __binary_op, __pstl::__internal::__no_op(), std::move(__init));
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+inclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _BinaryOperation __binary_op)
+{
+    return std::transform_inclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result,
+                                         __binary_op, __pstl::__internal::__no_op());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+inclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result)
+{
+    return std::inclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result, std::plus<>());
+}
+
+// [exclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp, class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+exclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _Tp __init, _BinaryOperation __binary_op)
+{
+    return std::transform_exclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result,
+                                         std::move(__init), __binary_op, __pstl::__internal::__no_op());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+exclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _Tp __init)
+{
+    return std::exclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result, std::move(__init),
+                               std::plus<>());
+}
+
+} // namespace std
+
+#endif /* _PSTL_GLUE_NUMERIC_IMPL_H */
@@ -0,0 +1,31 @@
+// -*- C++ -*-
+//===-- parallel_backend.h ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_H
+#define _PSTL_PARALLEL_BACKEND_H
+
+// A backend provides, in namespace __pstl::__par_backend:
+//   unsigned __concurrency();
+//     The number of threads which may run the tasks of an algorithm,
+//     including the calling thread.
+//   template <class _Fp> void __parallel_invoke_n(std::size_t __n, _Fp& __f);
+//     Calls __f(0), ..., __f(__n - 1), possibly concurrently, and returns when
+//     all the calls returned. __f doesn't throw.
+
+#if defined(_PSTL_PAR_BACKEND_SERIAL)
+#    include "parallel_backend_serial.h"
+#elif defined(_PSTL_PAR_BACKEND_TBB)
+#    include "parallel_backend_tbb.h"
+#elif defined(_PSTL_PAR_BACKEND_THREAD)
+#    include "parallel_backend_thread.h"
+#else
+#    error "Parallel backend was not specified"
+#endif
+
+#endif /* _PSTL_PARALLEL_BACKEND_H */
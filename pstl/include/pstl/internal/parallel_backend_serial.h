@@ -0,0 +1,37 @@
+// -*- C++ -*-
+//===-- parallel_backend_serial.h -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_SERIAL_H
+#define _PSTL_PARALLEL_BACKEND_SERIAL_H
+
+#include <cstddef>
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+inline unsigned
+__concurrency()
+{
+    return 1;
+}
+
+template <class _Fp>
+void
+__parallel_invoke_n(std::size_t __n, _Fp& __f)
+{
+    for (std::size_t __i = 0; __i < __n; ++__i)
+        __f(__i);
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+#endif /* _PSTL_PARALLEL_BACKEND_SERIAL_H */
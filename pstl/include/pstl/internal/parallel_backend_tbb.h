@@ -0,0 +1,39 @@
+// -*- C++ -*-
+//===-- parallel_backend_tbb.h --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_TBB_H
+#define _PSTL_PARALLEL_BACKEND_TBB_H
+
+#include <cstddef>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+inline unsigned
+__concurrency()
+{
+    return static_cast<unsigned>(tbb::this_task_arena::max_concurrency());
+}
+
+template <class _Fp>
+void
+__parallel_invoke_n(std::size_t __n, _Fp& __f)
+{
+    tbb::this_task_arena::isolate([&]() { tbb::parallel_for(std::size_t(0), __n, [&](std::size_t __i) { __f(__i); }); });
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+#endif /* _PSTL_PARALLEL_BACKEND_TBB_H */
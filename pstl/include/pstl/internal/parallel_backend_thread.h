@@ -0,0 +1,203 @@
+// -*- C++ -*-
+//===-- parallel_backend_thread.h -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_THREAD_H
+#define _PSTL_PARALLEL_BACKEND_THREAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// A backend on the threads of the standard library: a pool of workers, started
+// by the first parallel algorithm of the process, runs the tasks of all the
+// algorithms along with the threads which called them.
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+class __thread_pool
+{
+  public:
+    static __thread_pool&
+    __instance()
+    {
+        static __thread_pool __pool;
+        return __pool;
+    }
+
+    unsigned
+    __concurrency() const
+    {
+        return static_cast<unsigned>(__workers_.size()) + 1;
+    }
+
+    template <class _Fp>
+    void
+    __run(std::size_t __n, _Fp& __f)
+    {
+        // The workers don't wait for the tasks of other algorithms, so the
+        // algorithms called by a task run on the worker itself.
+        if (__in_worker() || __workers_.empty() || __n <= 1)
+        {
+            for (std::size_t __i = 0; __i < __n; ++__i)
+                __f(__i);
+            return;
+        }
+
+        __job __j(__n, &__call<_Fp>, &__f);
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __jobs_.push_back(&__j);
+        }
+        __work_cv_.notify_all();
+
+        std::size_t __finished = __execute(__j);
+
+        std::unique_lock<std::mutex> __lock(__mutex_);
+        __j.__finished_ += __finished;
+        __remove(&__j);
+        __done_cv_.wait(__lock, [&]() { return __j.__finished_ == __j.__n_ && __j.__users_ == 0; });
+    }
+
+  private:
+    // The tasks of one algorithm, which are picked by index by the threads
+    // which run them, so that the faster threads run more of them.
+    struct __job
+    {
+        __job(std::size_t __n, void (*__call)(void*, std::size_t), void* __f) : __n_(__n), __call_(__call), __f_(__f) {}
+
+        const std::size_t __n_;
+        void (*const __call_)(void*, std::size_t);
+        void* const __f_;
+        std::atomic<std::size_t> __next_{0};
+        // Guarded by __mutex_.
+        std::size_t __finished_ = 0;
+        std::size_t __users_ = 0;
+    };
+
+    template <class _Fp>
+    static void
+    __call(void* __f, std::size_t __i)
+    {
+        (*static_cast<_Fp*>(__f))(__i);
+    }
+
+    // Runs the tasks of __j until there are none left. Returns how many ran.
+    static std::size_t
+    __execute(__job& __j)
+    {
+        std::size_t __count = 0;
+        for (std::size_t __i; (__i = __j.__next_.fetch_add(1, std::memory_order_relaxed)) < __j.__n_; ++__count)
+            __j.__call_(__j.__f_, __i);
+        return __count;
+    }
+
+    static bool&
+    __in_worker()
+    {
+        static thread_local bool __flag = false;
+        return __flag;
+    }
+
+    __thread_pool()
+    {
+        unsigned __threads = std::thread::hardware_concurrency();
+        try
+        {
+            for (unsigned __i = 1; __i < __threads; ++__i)
+                __workers_.emplace_back([this]() { __work(); });
+        }
+        catch (const std::system_error&)
+        {
+            // The algorithms run on the workers which could be started.
+        }
+    }
+
+    ~__thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __stop_ = true;
+        }
+        __work_cv_.notify_all();
+        for (std::thread& __worker : __workers_)
+            __worker.join();
+    }
+
+    __thread_pool(const __thread_pool&) = delete;
+    __thread_pool&
+    operator=(const __thread_pool&) = delete;
+
+    // Requires __mutex_.
+    void
+    __remove(__job* __j)
+    {
+        auto __it = std::find(__jobs_.begin(), __jobs_.end(), __j);
+        if (__it != __jobs_.end())
+            __jobs_.erase(__it);
+    }
+
+    void
+    __work()
+    {
+        __in_worker() = true;
+        std::unique_lock<std::mutex> __lock(__mutex_);
+        while (true)
+        {
+            __work_cv_.wait(__lock, [this]() { return __stop_ || !__jobs_.empty(); });
+            if (__jobs_.empty())
+                return;
+            __job* __j = __jobs_.front();
+            ++__j->__users_;
+            __lock.unlock();
+            std::size_t __finished = __execute(*__j);
+            __lock.lock();
+            // The job can't be released by its caller while it has users.
+            --__j->__users_;
+            __j->__finished_ += __finished;
+            __remove(__j);
+            if (__j->__finished_ == __j->__n_ && __j->__users_ == 0)
+                __done_cv_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> __workers_;
+    std::mutex __mutex_;
+    std::condition_variable __work_cv_;
+    std::condition_variable __done_cv_;
+    // Guarded by __mutex_.
+    std::deque<__job*> __jobs_;
+    bool __stop_ = false;
+};
+
+inline unsigned
+__concurrency()
+{
+    return __thread_pool::__instance().__concurrency();
+}
+
+template <class _Fp>
+void
+__parallel_invoke_n(std::size_t __n, _Fp& __f)
+{
+    __thread_pool::__instance().__run(__n, __f);
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+#endif /* _PSTL_PARALLEL_BACKEND_THREAD_H */
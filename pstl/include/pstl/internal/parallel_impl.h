@@ -0,0 +1,240 @@
+// -*- C++ -*-
+//===-- parallel_impl.h ---------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_IMPL_H
+#define _PSTL_PARALLEL_IMPL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "parallel_backend.h"
+
+// The parallel algorithms split their ranges into chunks of consecutive
+// indices, which the backend runs as independent tasks.
+
+namespace __pstl
+{
+namespace __internal
+{
+
+struct __no_op
+{
+    template <class _Tp>
+    _Tp&&
+    operator()(_Tp&& __a) const
+    {
+        return std::forward<_Tp>(__a);
+    }
+};
+
+// Below this size, the cost of a task is larger than the work of the chunk.
+constexpr std::size_t __min_chunk_size = 2048;
+
+// Calls __f(0), ..., __f(__n - 1) on the threads of the backend. An exception
+// thrown by __f calls std::terminate, as for the standard execution policies.
+template <class _Fp>
+void
+__parallel_invoke_n(std::size_t __n, _Fp __f)
+{
+    auto __task = [&__f](std::size_t __i) noexcept { __f(__i); };
+    __par_backend::__parallel_invoke_n(__n, __task);
+}
+
+// The number of chunks of a range of __n elements: a few per thread, so that
+// their work is balanced when the elements don't all cost the same.
+inline std::size_t
+__chunk_count(std::size_t __n)
+{
+    std::size_t __threads = __par_backend::__concurrency();
+    if (__threads <= 1 || __n < 2 * __min_chunk_size)
+        return 1;
+    return std::min(__n / __min_chunk_size, 4 * std::size_t(__threads));
+}
+
+inline std::size_t
+__chunk_begin(std::size_t __n, std::size_t __chunks, std::size_t __i)
+{
+    return __i * __n / __chunks;
+}
+
+// Calls __f(__i, __j) on subranges [__i, __j), which cover [0, __n).
+template <class _Fp>
+void
+__parallel_for(std::size_t __n, _Fp __f)
+{
+    std::size_t __chunks = __chunk_count(__n);
+    if (__chunks <= 1)
+    {
+        if (__n)
+            __f(std::size_t(0), __n);
+        return;
+    }
+    __internal::__parallel_invoke_n(__chunks, [&](std::size_t __i) {
+        __f(__chunk_begin(__n, __chunks, __i), __chunk_begin(__n, __chunks, __i + 1));
+    });
+}
+
+// Returns __init combined with the results of __f(__i, __j) on nonempty
+// subranges [__i, __j) which cover [0, __n). __combine must be associative and
+// commutative.
+template <class _Tp, class _Combine, class _Fp>
+_Tp
+__parallel_reduce(std::size_t __n, _Tp __init, _Combine __combine, _Fp __f)
+{
+    std::size_t __chunks = __chunk_count(__n);
+    if (__chunks <= 1)
+        return __n ? __combine(std::move(__init), __f(std::size_t(0), __n)) : __init;
+    std::vector<std::optional<_Tp>> __partials(__chunks);
+    __internal::__parallel_invoke_n(__chunks, [&](std::size_t __i) {
+        __partials[__i].emplace(__f(__chunk_begin(__n, __chunks, __i), __chunk_begin(__n, __chunks, __i + 1)));
+    });
+    for (std::optional<_Tp>& __partial : __partials)
+        __init = __combine(std::move(__init), std::move(*__partial));
+    return __init;
+}
+
+// Returns the smallest index in [0, __n) for which __pred is true, or __n.
+template <class _Pred>
+std::size_t
+__parallel_find_if(std::size_t __n, _Pred __pred)
+{
+    std::atomic<std::size_t> __found(__n);
+    __internal::__parallel_for(__n, [&](std::size_t __i, std::size_t __j) {
+        for (; __i < __j; ++__i)
+        {
+            // A chunk stops once a match is known before its next element.
+            if (__found.load(std::memory_order_relaxed) < __i)
+                return;
+            if (__pred(__i))
+            {
+                std::size_t __current = __found.load(std::memory_order_relaxed);
+                while (__i < __current && !__found.compare_exchange_weak(__current, __i, std::memory_order_relaxed))
+                {
+                }
+                return;
+            }
+        }
+    });
+    return __found.load(std::memory_order_relaxed);
+}
+
+// A scan in three passes: the sums of the chunks in parallel, the prefix of
+// each chunk from them, then the scan of each chunk from its prefix in
+// parallel. __u is applied twice to each element. The output may be the input.
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _Tp, class _BinaryOperation,
+          class _UnaryOperation>
+_RandomAccessIterator2
+__parallel_transform_scan(_RandomAccessIterator1 __first, _RandomAccessIterator1 __last,
+                          _RandomAccessIterator2 __result, _UnaryOperation __u, std::optional<_Tp> __init,
+                          _BinaryOperation __binary_op, bool __inclusive)
+{
+    std::size_t __n = static_cast<std::size_t>(__last - __first);
+    std::size_t __chunks = __chunk_count(__n);
+    std::vector<std::optional<_Tp>> __prefixes(__chunks);
+
+    if (__chunks > 1)
+    {
+        std::vector<std::optional<_Tp>> __sums(__chunks - 1);
+        __internal::__parallel_invoke_n(__chunks - 1, [&](std::size_t __i) {
+            std::size_t __j = __chunk_begin(__n, __chunks, __i), __end = __chunk_begin(__n, __chunks, __i + 1);
+            _Tp __sum = __u(__first[__j]);
+            for (++__j; __j < __end; ++__j)
+                __sum = __binary_op(std::move(__sum), __u(__first[__j]));
+            __sums[__i].emplace(std::move(__sum));
+        });
+        __prefixes[0] = __init;
+        for (std::size_t __i = 1; __i < __chunks; ++__i)
+        {
+            if (__prefixes[__i - 1])
+                __prefixes[__i].emplace(__binary_op(*__prefixes[__i - 1], std::move(*__sums[__i - 1])));
+            else
+                __prefixes[__i] = std::move(__sums[__i - 1]);
+        }
+    }
+    else
+        __prefixes[0] = std::move(__init);
+
+    auto __scan_chunk = [&](std::size_t __i) {
+        std::size_t __j = __chunk_begin(__n, __chunks, __i), __end = __chunk_begin(__n, __chunks, __i + 1);
+        if (__j == __end)
+            return;
+        std::optional<_Tp>& __prefix = __prefixes[__i];
+        if (__inclusive)
+        {
+            // The sum is a local, which the writes to the output can't alias.
+            _Tp __sum = __prefix ? _Tp(__binary_op(std::move(*__prefix), __u(__first[__j]))) : _Tp(__u(__first[__j]));
+            __result[__j] = __sum;
+            for (++__j; __j < __end; ++__j)
+            {
+                __sum = __binary_op(std::move(__sum), __u(__first[__j]));
+                __result[__j] = __sum;
+            }
+        }
+        else
+        {
+            _Tp __sum = std::move(*__prefix);
+            for (; __j < __end; ++__j)
+            {
+                // The element is read before it may be overwritten.
+                auto __value = __u(__first[__j]);
+                __result[__j] = __sum;
+                __sum = __binary_op(std::move(__sum), std::move(__value));
+            }
+        }
+    };
+    if (__chunks > 1)
+        __internal::__parallel_invoke_n(__chunks, __scan_chunk);
+    else
+        __scan_chunk(0);
+    return __result + __n;
+}
+
+// Sorts a chunk per thread, then merges pairs of adjacent runs until there is
+// one left. The merges keep the order of equivalent elements, so the sort is
+// stable if the chunks are sorted with std::stable_sort.
+template <class _RandomAccessIterator, class _Compare, class _LeafSort>
+void
+__parallel_merge_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp,
+                      _LeafSort __leaf_sort)
+{
+    std::size_t __n = static_cast<std::size_t>(__last - __first);
+    std::size_t __chunks = std::min(__chunk_count(__n), std::size_t(__par_backend::__concurrency()));
+    if (__chunks <= 1)
+    {
+        __leaf_sort(__first, __last, __comp);
+        return;
+    }
+    __internal::__parallel_invoke_n(__chunks, [&](std::size_t __i) {
+        __leaf_sort(__first + __chunk_begin(__n, __chunks, __i), __first + __chunk_begin(__n, __chunks, __i + 1),
+                    __comp);
+    });
+    for (std::size_t __width = 1; __width < __chunks; __width *= 2)
+    {
+        std::size_t __merges = (__chunks + 2 * __width - 1) / (2 * __width);
+        __internal::__parallel_invoke_n(__merges, [&](std::size_t __i) {
+            std::size_t __lo = 2 * __i * __width;
+            std::size_t __mid = std::min(__lo + __width, __chunks);
+            std::size_t __hi = std::min(__lo + 2 * __width, __chunks);
+            if (__mid < __hi)
+                std::inplace_merge(__first + __chunk_begin(__n, __chunks, __lo),
+                                   __first + __chunk_begin(__n, __chunks, __mid),
+                                   __first + __chunk_begin(__n, __chunks, __hi), __comp);
+        });
+    }
+}
+
+} // namespace __internal
+} // namespace __pstl
+
+#endif /* _PSTL_PARALLEL_IMPL_H */
@@ -0,0 +1,29 @@
+// -*- C++ -*-
+//===-- pstl_config.h -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_CONFIG_H
+#define _PSTL_CONFIG_H
+
+#include <__pstl_config_site>
+
+// The version is XYYZ, where X is major, YY is minor, and Z is patch (i.e. X.YY.Z)
+#define _PSTL_VERSION 10000
+#define _PSTL_VERSION_MAJOR (_PSTL_VERSION / 1000)
+#define _PSTL_VERSION_MINOR ((_PSTL_VERSION % 1000) / 10)
+#define _PSTL_VERSION_PATCH (_PSTL_VERSION % 10)
+
+#if !defined(_PSTL_PAR_BACKEND_SERIAL) && !defined(_PSTL_PAR_BACKEND_TBB) && !defined(_PSTL_PAR_BACKEND_THREAD)
+#    error "The parallel backend is neither serial, TBB, nor thread"
+#endif
+
+#if defined(_PSTL_PAR_BACKEND_THREAD) && defined(_LIBCPP_HAS_NO_THREADS)
+#    error "The thread backend of the Parallel STL requires the threads of the standard library"
+#endif
+
+#endif /* _PSTL_CONFIG_H */
@@ -0,0 +1,72 @@
+// -*- C++ -*-
+//===-- transform_fill_copy.pass.cpp --------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+template <class Policy>
+void
+test(Policy&& exec, std::size_t n)
+{
+    std::vector<long> in(n);
+    std::iota(in.begin(), in.end(), 0);
+
+    std::vector<long> out(n, -1);
+    EXPECT_TRUE(std::transform(exec, in.begin(), in.end(), out.begin(), [](long x) { return 2 * x; }) == out.end(),
+                "wrong return value from transform");
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(long(2 * i), out[i], "wrong effect from transform");
+
+    EXPECT_TRUE(std::transform(exec, in.begin(), in.end(), out.begin(), out.begin(), std::minus<long>()) == out.end(),
+                "wrong return value from the binary transform");
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(-long(i), out[i], "wrong effect from the binary transform");
+
+    std::fill(exec, out.begin(), out.end(), 7);
+    EXPECT_EQ(n, std::size_t(std::count(out.begin(), out.end(), 7)), "wrong effect from fill");
+    EXPECT_TRUE(std::fill_n(exec, out.begin(), n / 2, 8) == out.begin() + n / 2, "wrong return value from fill_n");
+    EXPECT_EQ(n / 2, std::size_t(std::count(out.begin(), out.end(), 8)), "wrong effect from fill_n");
+
+    std::replace(exec, out.begin(), out.end(), 8L, 9L);
+    EXPECT_EQ(n / 2, std::size_t(std::count(out.begin(), out.end(), 9)), "wrong effect from replace");
+
+    std::generate(exec, out.begin(), out.end(), []() { return 5L; });
+    EXPECT_EQ(n, std::size_t(std::count(out.begin(), out.end(), 5)), "wrong effect from generate");
+
+    EXPECT_TRUE(std::copy(exec, in.begin(), in.end(), out.begin()) == out.end(), "wrong return value from copy");
+    EXPECT_TRUE(out == in, "wrong effect from copy");
+    std::fill(out.begin(), out.end(), 0);
+    EXPECT_TRUE(std::copy_n(exec, in.begin(), n, out.begin()) == out.end(), "wrong return value from copy_n");
+    EXPECT_TRUE(out == in, "wrong effect from copy_n");
+
+    std::vector<std::unique_ptr<long>> from(n), to(n);
+    for (std::size_t i = 0; i < n; ++i)
+        from[i].reset(new long(i));
+    EXPECT_TRUE(std::move(exec, from.begin(), from.end(), to.begin()) == to.end(), "wrong return value from move");
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_TRUE(!from[i] && to[i] && *to[i] == long(i), "wrong effect from move");
+}
+
+int
+main()
+{
+    invoke_on_all_policies([](auto&& exec) {
+        for (std::size_t n : test_sizes)
+            test(exec, n);
+    });
+    done();
+    return 0;
+}
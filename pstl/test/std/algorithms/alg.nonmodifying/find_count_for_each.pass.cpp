@@ -0,0 +1,95 @@
+// -*- C++ -*-
+//===-- find_count_for_each.pass.cpp --------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <list>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+template <class Policy>
+void
+test_for_each(Policy&& exec, std::size_t n)
+{
+    std::vector<int> v(n, 1);
+    std::for_each(exec, v.begin(), v.end(), [](int& x) { x *= 3; });
+    EXPECT_EQ(std::size_t(std::count(v.begin(), v.end(), 3)), n, "wrong effect from for_each");
+
+    std::vector<int>::iterator last = std::for_each_n(exec, v.begin(), n / 2, [](int& x) { x = 0; });
+    EXPECT_TRUE(last == v.begin() + n / 2, "wrong return value from for_each_n");
+    EXPECT_EQ(std::size_t(std::count(v.begin(), v.end(), 0)), n / 2, "wrong effect from for_each_n");
+
+    // Each element is visited exactly once.
+    std::atomic<std::size_t> visits(0);
+    std::for_each(exec, v.begin(), v.end(), [&](int&) { visits.fetch_add(1, std::memory_order_relaxed); });
+    EXPECT_EQ(n, visits.load(), "for_each visited the wrong number of elements");
+}
+
+template <class Policy>
+void
+test_find_count(Policy&& exec, std::size_t n)
+{
+    std::vector<std::size_t> v(n);
+    for (std::size_t i = 0; i < n; ++i)
+        v[i] = i % 7;
+    std::size_t expected_sixes = std::count(v.begin(), v.end(), 6);
+    EXPECT_EQ(expected_sixes, std::size_t(std::count(exec, v.begin(), v.end(), std::size_t(6))), "wrong result from count");
+    EXPECT_EQ(expected_sixes, std::size_t(std::count_if(exec, v.begin(), v.end(), [](std::size_t x) { return x == 6; })),
+              "wrong result from count_if");
+
+    // The first of several matches is found, wherever the matches are.
+    for (std::size_t pos : {std::size_t(0), n / 3, n / 2, n - 1})
+    {
+        if (pos >= n)
+            continue;
+        std::vector<std::size_t> w(n, 0);
+        for (std::size_t i = pos; i < n; i += 1 + n / 5)
+            w[i] = 1;
+        EXPECT_TRUE(std::find(exec, w.begin(), w.end(), std::size_t(1)) == w.begin() + pos, "wrong result from find");
+        EXPECT_TRUE(std::find_if_not(exec, w.begin(), w.end(), [](std::size_t x) { return x == 0; }) == w.begin() + pos,
+                    "wrong result from find_if_not");
+        EXPECT_TRUE(std::any_of(exec, w.begin(), w.end(), [](std::size_t x) { return x == 1; }),
+                    "wrong result from any_of");
+        EXPECT_TRUE(!std::none_of(exec, w.begin(), w.end(), [](std::size_t x) { return x == 1; }),
+                    "wrong result from none_of");
+    }
+    EXPECT_TRUE(std::find(exec, v.begin(), v.end(), std::size_t(7)) == v.end(), "find found a missing value");
+    EXPECT_TRUE(std::all_of(exec, v.begin(), v.end(), [](std::size_t x) { return x < 7; }),
+                "wrong result from all_of");
+}
+
+// The algorithms take forward iterators too.
+template <class Policy>
+void
+test_forward_iterators(Policy&& exec)
+{
+    std::list<int> l = {1, 2, 3, 4, 5};
+    std::for_each(exec, l.begin(), l.end(), [](int& x) { ++x; });
+    EXPECT_EQ(2, std::count_if(exec, l.begin(), l.end(), [](int x) { return x % 2; }), "wrong result on a list");
+    EXPECT_TRUE(std::find(exec, l.begin(), l.end(), 4) == std::next(l.begin(), 2), "wrong result on a list");
+}
+
+int
+main()
+{
+    invoke_on_all_policies([](auto&& exec) {
+        for (std::size_t n : test_sizes)
+        {
+            test_for_each(exec, n);
+            test_find_count(exec, n);
+        }
+        test_forward_iterators(exec);
+    });
+    done();
+    return 0;
+}
@@ -0,0 +1,83 @@
+// -*- C++ -*-
+//===-- sort.pass.cpp -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+template <class Policy>
+void
+test_sort(Policy&& exec, std::size_t n)
+{
+    std::mt19937 rng(n);
+    std::vector<unsigned> v(n);
+    for (unsigned& x : v)
+        x = rng() % (n + 1);
+    std::vector<unsigned> expected = v;
+    std::sort(expected.begin(), expected.end());
+
+    std::sort(exec, v.begin(), v.end());
+    EXPECT_TRUE(v == expected, "wrong effect from sort");
+
+    // Sorted input, in both orders.
+    std::sort(exec, v.begin(), v.end());
+    EXPECT_TRUE(v == expected, "wrong effect from sort on a sorted range");
+    std::sort(exec, v.begin(), v.end(), std::greater<unsigned>());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.rbegin()), "wrong effect from sort with a comparator");
+
+    std::vector<std::string> s(n);
+    for (std::string& x : s)
+        x = std::to_string(rng() % 1000);
+    std::vector<std::string> expected_s = s;
+    std::sort(expected_s.begin(), expected_s.end());
+    std::sort(exec, s.begin(), s.end());
+    EXPECT_TRUE(s == expected_s, "wrong effect from sort on strings");
+}
+
+template <class Policy>
+void
+test_stable_sort(Policy&& exec, std::size_t n)
+{
+    // Few keys, so that there are many equivalent elements, numbered in their
+    // original order.
+    std::mt19937 rng(n);
+    std::vector<std::pair<unsigned, std::size_t>> v(n);
+    for (std::size_t i = 0; i < n; ++i)
+        v[i] = {unsigned(rng() % 16), i};
+    auto by_key = [](const std::pair<unsigned, std::size_t>& a, const std::pair<unsigned, std::size_t>& b) {
+        return a.first < b.first;
+    };
+    std::vector<std::pair<unsigned, std::size_t>> expected = v;
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    std::stable_sort(exec, v.begin(), v.end(), by_key);
+    EXPECT_TRUE(v == expected, "wrong effect from stable_sort");
+}
+
+int
+main()
+{
+    invoke_on_all_policies([](auto&& exec) {
+        for (std::size_t n : test_sizes)
+        {
+            test_sort(exec, n);
+            test_stable_sort(exec, n);
+        }
+    });
+    done();
+    return 0;
+}
@@ -0,0 +1,123 @@
+// -*- C++ -*-
+//===-- reduce_scan.pass.cpp ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+// The affine functions x -> a * x + b, composed from left to right: an
+// associative operation which isn't commutative, to check the order of the
+// scans.
+struct Affine
+{
+    unsigned a, b;
+
+    bool
+    operator==(const Affine& other) const
+    {
+        return a == other.a && b == other.b;
+    }
+};
+
+struct Compose
+{
+    Affine
+    operator()(const Affine& f, const Affine& g) const
+    {
+        return {f.a * g.a, f.b * g.a + g.b};
+    }
+};
+
+template <class Policy>
+void
+test_reduce(Policy&& exec, std::size_t n)
+{
+    std::vector<unsigned long long> v(n);
+    std::iota(v.begin(), v.end(), 1);
+    unsigned long long sum = n * (n + 1) / 2;
+    EXPECT_EQ(sum, std::reduce(exec, v.begin(), v.end()), "wrong result from reduce");
+    EXPECT_EQ(sum + 5, std::reduce(exec, v.begin(), v.end(), 5ULL), "wrong result from reduce with init");
+    EXPECT_EQ(2 * sum + 5,
+              std::transform_reduce(exec, v.begin(), v.end(), 5ULL, std::plus<>(),
+                                    [](unsigned long long x) { return 2 * x; }),
+              "wrong result from the unary transform_reduce");
+    EXPECT_EQ(std::inner_product(v.begin(), v.end(), v.begin(), 3ULL),
+              std::transform_reduce(exec, v.begin(), v.end(), v.begin(), 3ULL), "wrong result from transform_reduce");
+}
+
+template <class Policy>
+void
+test_scan(Policy&& exec, std::size_t n)
+{
+    std::vector<Affine> in(n);
+    for (std::size_t i = 0; i < n; ++i)
+        in[i] = {unsigned(2 * i + 1), unsigned(i)};
+    const Affine init = {3, 4};
+    std::vector<Affine> expected(n), out(n);
+
+    std::inclusive_scan(in.begin(), in.end(), expected.begin(), Compose(), init);
+    EXPECT_TRUE(std::inclusive_scan(exec, in.begin(), in.end(), out.begin(), Compose(), init) == out.end(),
+                "wrong return value from inclusive_scan");
+    EXPECT_TRUE(out == expected, "wrong effect from inclusive_scan with init");
+
+    std::inclusive_scan(in.begin(), in.end(), expected.begin(), Compose());
+    std::inclusive_scan(exec, in.begin(), in.end(), out.begin(), Compose());
+    EXPECT_TRUE(out == expected, "wrong effect from inclusive_scan");
+
+    std::exclusive_scan(in.begin(), in.end(), expected.begin(), init, Compose());
+    EXPECT_TRUE(std::exclusive_scan(exec, in.begin(), in.end(), out.begin(), init, Compose()) == out.end(),
+                "wrong return value from exclusive_scan");
+    EXPECT_TRUE(out == expected, "wrong effect from exclusive_scan");
+
+    auto twice = [](const Affine& f) { return Affine{f.a, 2 * f.b}; };
+    std::transform_inclusive_scan(in.begin(), in.end(), expected.begin(), Compose(), twice);
+    std::transform_inclusive_scan(exec, in.begin(), in.end(), out.begin(), Compose(), twice);
+    EXPECT_TRUE(out == expected, "wrong effect from transform_inclusive_scan");
+
+    std::transform_exclusive_scan(in.begin(), in.end(), expected.begin(), init, Compose(), twice);
+    std::transform_exclusive_scan(exec, in.begin(), in.end(), out.begin(), init, Compose(), twice);
+    EXPECT_TRUE(out == expected, "wrong effect from transform_exclusive_scan");
+
+    // In place.
+    std::exclusive_scan(in.begin(), in.end(), expected.begin(), init, Compose());
+    out = in;
+    std::exclusive_scan(exec, out.begin(), out.end(), out.begin(), init, Compose());
+    EXPECT_TRUE(out == expected, "wrong effect from exclusive_scan in place");
+    std::inclusive_scan(in.begin(), in.end(), expected.begin(), Compose());
+    out = in;
+    std::inclusive_scan(exec, out.begin(), out.end(), out.begin(), Compose());
+    EXPECT_TRUE(out == expected, "wrong effect from inclusive_scan in place");
+
+    std::vector<long> ints(n, 1), sums(n);
+    std::inclusive_scan(exec, ints.begin(), ints.end(), sums.begin());
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(long(i + 1), sums[i], "wrong effect from inclusive_scan with std::plus");
+    std::exclusive_scan(exec, ints.begin(), ints.end(), sums.begin(), 0L);
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(long(i), sums[i], "wrong effect from exclusive_scan with std::plus");
+}
+
+int
+main()
+{
+    invoke_on_all_policies([](auto&& exec) {
+        for (std::size_t n : test_sizes)
+        {
+            test_reduce(exec, n);
+            test_scan(exec, n);
+        }
+    });
+    done();
+    return 0;
+}
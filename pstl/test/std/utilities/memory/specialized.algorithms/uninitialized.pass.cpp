@@ -0,0 +1,73 @@
+// -*- C++ -*-
+//===-- uninitialized.pass.cpp --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <execution>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+std::atomic<long> live_objects(0);
+
+struct Counted
+{
+    long value;
+
+    Counted() : value(42) { ++live_objects; }
+    Counted(long v) : value(v) { ++live_objects; }
+    Counted(const Counted& other) : value(other.value) { ++live_objects; }
+    ~Counted() { --live_objects; }
+};
+
+template <class Policy>
+void
+test(Policy&& exec, std::size_t n)
+{
+    std::allocator<Counted> alloc;
+    Counted* p = alloc.allocate(n + 1);
+
+    std::uninitialized_fill(exec, p, p + n, Counted(7));
+    EXPECT_EQ(long(n), live_objects.load(), "wrong count of objects after uninitialized_fill");
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(7, p[i].value, "wrong effect from uninitialized_fill");
+    std::destroy(exec, p, p + n);
+    EXPECT_EQ(0, live_objects.load(), "wrong count of objects after destroy");
+
+    std::vector<Counted> in(n);
+    for (std::size_t i = 0; i < n; ++i)
+        in[i].value = long(i);
+    EXPECT_TRUE(std::uninitialized_copy(exec, in.begin(), in.end(), p) == p + n,
+                "wrong return value from uninitialized_copy");
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(long(i), p[i].value, "wrong effect from uninitialized_copy");
+    EXPECT_TRUE(std::destroy_n(exec, p, n) == p + n, "wrong return value from destroy_n");
+
+    std::uninitialized_default_construct_n(exec, p, n);
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(42, p[i].value, "wrong effect from uninitialized_default_construct_n");
+    std::destroy(exec, p, p + n);
+    EXPECT_EQ(long(n), live_objects.load(), "wrong count of objects after uninitialized_default_construct_n");
+
+    alloc.deallocate(p, n + 1);
+}
+
+int
+main()
+{
+    invoke_on_all_policies([](auto&& exec) {
+        for (std::size_t n : test_sizes)
+            test(exec, n);
+    });
+    done();
+    return 0;
+}
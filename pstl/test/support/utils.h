@@ -0,0 +1,57 @@
+// -*- C++ -*-
+//===-- utils.h -----------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_TEST_UTILS_H
+#define _PSTL_TEST_UTILS_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <execution>
+
+namespace TestUtils
+{
+
+#define EXPECT_TRUE(condition, message) TestUtils::expect(condition, __FILE__, __LINE__, message)
+#define EXPECT_EQ(expected, actual, message) TestUtils::expect((expected) == (actual), __FILE__, __LINE__, message)
+
+inline void
+expect(bool condition, const char* file, int line, const char* message)
+{
+    if (!condition)
+    {
+        std::fprintf(stderr, "error at %s:%d - %s\n", file, line, message);
+        std::exit(1);
+    }
+}
+
+// The sizes of the ranges of the tests: the small ones run on the calling
+// thread, the large ones are split between the threads of the backend.
+constexpr std::size_t test_sizes[] = {0, 1, 2, 17, 1000, 4095, 4096, 10007, 100000, 1000003};
+
+// Calls op(policy) with each of the standard execution policies.
+template <class Op>
+void
+invoke_on_all_policies(Op op)
+{
+    op(std::execution::seq);
+    op(std::execution::unseq);
+    op(std::execution::par);
+    op(std::execution::par_unseq);
+}
+
+inline void
+done()
+{
+    std::fprintf(stdout, "done\n");
+}
+
+} // namespace TestUtils
+
+#endif /* _PSTL_TEST_UTILS_H */